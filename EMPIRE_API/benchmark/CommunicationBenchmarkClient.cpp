@@ -0,0 +1,317 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file CommunicationBenchmarkClient.cpp
+ * This file holds a dummy client measuring the cost of the transport of EMPIRE: the latency of
+ * signals (ping-pong), the bandwidth of data fields of growing size (a data field bounced by the
+ * Emperor) and the gathering of the data fields of all clients (fan-in). The client runs with the
+ * Emperor input emperorCommunicationBenchmark.xml, its role is set in the user defined block of
+ * its client input file. The client with the role "ping" writes the results to a JSON file.
+ * \date 10/15/2026
+ **************************************************************************************************/
+#include <time.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "EMPIRE_API.h"
+
+using namespace std;
+
+/********//**
+ * \brief Struct Statistics holds the statistics of the wall times of the repetitions of a transfer
+ ***********/
+struct Statistics {
+    /// the number of timed repetitions
+    int numRepetitions;
+    /// the shortest time [s]
+    double min;
+    /// the median [s]
+    double median;
+    /// the mean [s]
+    double mean;
+    /// the longest time [s]
+    double max;
+};
+
+/***********************************************************************************************
+ * \brief Get the wall time
+ * \return the time in seconds
+ ***********/
+static double getTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + 1e-9 * now.tv_nsec;
+}
+
+/***********************************************************************************************
+ * \brief Get a user defined text of the client input file
+ * \param[in] elementName the name of the XML element in the user defined block
+ * \return the text
+ ***********/
+static string getText(const char *elementName) {
+    return EMPIRE_API_getUserDefinedText(const_cast<char*>(elementName));
+}
+
+/***********************************************************************************************
+ * \brief Get a user defined integer of the client input file
+ * \param[in] elementName the name of the XML element in the user defined block
+ * \param[in] defaultValue the value if the element is missing
+ * \return the integer
+ ***********/
+static int getInt(const char *elementName, int defaultValue) {
+    string text = getText(elementName);
+    return text.empty() ? defaultValue : atoi(text.c_str());
+}
+
+/***********************************************************************************************
+ * \brief Get a user defined list of integers separated by blanks of the client input file
+ * \param[in] elementName the name of the XML element in the user defined block
+ * \return the integers
+ ***********/
+static vector<int> getIntList(const char *elementName) {
+    stringstream text(getText(elementName));
+    vector<int> list;
+    int value;
+    while (text >> value)
+        list.push_back(value);
+    return list;
+}
+
+/***********************************************************************************************
+ * \brief Send a strip of quads (2 rows of nodes) as mesh, so that a vector data field on the mesh has
+ *        3 * numNodes doubles
+ * \param[in] name the name of the mesh
+ * \param[in] numNodes the number of nodes, even and at least 4
+ ***********/
+static void sendStripMesh(const char *name, int numNodes) {
+    assert(numNodes % 2 == 0 && numNodes >= 4);
+    int numColumns = numNodes / 2;
+    int numElems = numColumns - 1;
+    vector<double> nodes(3 * numNodes);
+    vector<int> nodeIDs(numNodes);
+    vector<int> numNodesPerElem(numElems, 4);
+    vector<int> elems(4 * numElems);
+    for (int i = 0; i < numColumns; i++) {
+        for (int j = 0; j < 2; j++) {
+            int node = 2 * i + j;
+            nodes[3 * node + 0] = i;
+            nodes[3 * node + 1] = j;
+            nodes[3 * node + 2] = 0.0;
+            nodeIDs[node] = node + 1;
+        }
+    }
+    for (int i = 0; i < numElems; i++) {
+        elems[4 * i + 0] = 2 * i + 1;
+        elems[4 * i + 1] = 2 * i + 3;
+        elems[4 * i + 2] = 2 * i + 4;
+        elems[4 * i + 3] = 2 * i + 2;
+    }
+    EMPIRE_API_sendMesh(const_cast<char*>(name), numNodes, numElems, &nodes[0], &nodeIDs[0],
+            &numNodesPerElem[0], &elems[0]);
+}
+
+/***********************************************************************************************
+ * \brief Compute the statistics of the wall times, the first repetition warms up the connection and
+ *        is left out if there are more
+ * \param[in] times the wall times of the repetitions
+ * \return the statistics
+ ***********/
+static Statistics computeStatistics(const vector<double> &times) {
+    vector<double> sorted(times.size() > 1 ? times.begin() + 1 : times.begin(), times.end());
+    sort(sorted.begin(), sorted.end());
+    Statistics statistics;
+    statistics.numRepetitions = sorted.size();
+    statistics.min = statistics.median = statistics.mean = statistics.max = 0.0;
+    if (sorted.empty())
+        return statistics;
+    int n = sorted.size();
+    statistics.min = sorted.front();
+    statistics.max = sorted.back();
+    statistics.median = (n % 2 == 1) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    for (int i = 0; i < n; i++)
+        statistics.mean += sorted[i];
+    statistics.mean /= n;
+    return statistics;
+}
+
+/***********************************************************************************************
+ * \brief Write the statistics as members of a JSON object in microseconds
+ * \param[in] out the stream
+ * \param[in] statistics the statistics
+ ***********/
+static void writeStatistics(ostream &out, const Statistics &statistics) {
+    out << "\"numRepetitions\": " << statistics.numRepetitions << ", \"min_us\": "
+            << 1e6 * statistics.min << ", \"median_us\": " << 1e6 * statistics.median
+            << ", \"mean_us\": " << 1e6 * statistics.mean << ", \"max_us\": " << 1e6 * statistics.max;
+}
+
+/***********************************************************************************************
+ * \brief Run the ping-pong: the signal "ping" goes over the Emperor to the client "pong", which
+ *        returns it as the signal "pong"
+ * \param[in] isPing true for the client "ping", false for the client "pong"
+ * \param[in] numPingPongs the number of round trips
+ * \return the wall times of the round trips (client "ping" only)
+ ***********/
+static vector<double> runPingPong(bool isPing, int numPingPongs) {
+    vector<double> times;
+    double signal = 0.0;
+    for (int i = 0; i < numPingPongs; i++) {
+        if (isPing) {
+            double start = getTime();
+            EMPIRE_API_sendSignal_double(const_cast<char*>("ping"), 1, &signal);
+            EMPIRE_API_recvSignal_double(const_cast<char*>("pong"), 1, &signal);
+            times.push_back(getTime() - start);
+        } else {
+            EMPIRE_API_recvSignal_double(const_cast<char*>("ping"), 1, &signal);
+            signal += 1.0;
+            EMPIRE_API_sendSignal_double(const_cast<char*>("pong"), 1, &signal);
+        }
+    }
+    return times;
+}
+
+/***********************************************************************************************
+ * \brief Bounce a data field over the Emperor, which returns every received field unchanged
+ * \param[in] numNodes the number of nodes of the mesh "bandwidthMesh<numNodes>"
+ * \param[in] numRepetitions the number of round trips
+ * \return the wall times of the round trips
+ ***********/
+static vector<double> runBounce(int numNodes, int numRepetitions) {
+    vector<double> times;
+    vector<double> field(3 * numNodes, 1.0);
+    for (int i = 0; i < numRepetitions; i++) {
+        double start = getTime();
+        EMPIRE_API_sendDataField(const_cast<char*>("bandwidthField"), field.size(), &field[0]);
+        EMPIRE_API_recvDataField(const_cast<char*>("bandwidthField"), field.size(), &field[0]);
+        times.push_back(getTime() - start);
+    }
+    return times;
+}
+
+/***********************************************************************************************
+ * \brief Run the fan-in: the Emperor starts every repetition by the signal "go" to all clients,
+ *        receives the data fields of all clients in one connection and acknowledges by the
+ *        signal "ack". A repetition is timed from the send of the data field to the "ack".
+ * \param[in] numNodes the number of nodes of the mesh "fanInMesh"
+ * \param[in] numFanIns the number of repetitions
+ * \return the wall times of the repetitions
+ ***********/
+static vector<double> runFanIn(int numNodes, int numFanIns) {
+    vector<double> times;
+    vector<double> field(3 * numNodes, 1.0);
+    double signal = 0.0;
+    for (int i = 0; i < numFanIns; i++) {
+        EMPIRE_API_recvSignal_double(const_cast<char*>("go"), 1, &signal);
+        double start = getTime();
+        EMPIRE_API_sendDataField(const_cast<char*>("fanInField"), field.size(), &field[0]);
+        EMPIRE_API_recvSignal_double(const_cast<char*>("ack"), 1, &signal);
+        times.push_back(getTime() - start);
+    }
+    return times;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        cerr << "Usage: " << argv[0] << " <client input file>" << endl;
+        return EXIT_FAILURE;
+    }
+    EMPIRE_API_Connect(argv[1]);
+
+    // the parameters must match the number of time steps of the loops in the Emperor input
+    string role = getText("role");
+    bool isPing = (role == "ping");
+    bool isPong = (role == "pong");
+    if (!isPing && !isPong && role != "fanIn") {
+        cerr << "Error: unknown role \"" << role << "\" (ping, pong or fanIn)" << endl;
+        EMPIRE_API_Disconnect();
+        return EXIT_FAILURE;
+    }
+    int numPingPongs = getInt("numPingPongs", 1000);
+    vector<int> bandwidthNumNodes = getIntList("bandwidthNumNodes");
+    vector<int> bandwidthNumRepetitions = getIntList("bandwidthNumRepetitions");
+    int fanInNumNodes = getInt("fanInNumNodes", 4096);
+    int numFanIns = getInt("numFanIns", 100);
+    int numFanInClients = getInt("numFanInClients", 4);
+    string resultFile = getText("resultFile");
+    if (resultFile.empty())
+        resultFile = "communicationBenchmark.json";
+    if (bandwidthNumNodes.size() != bandwidthNumRepetitions.size()) {
+        cerr << "Error: bandwidthNumNodes and bandwidthNumRepetitions differ in length" << endl;
+        EMPIRE_API_Disconnect();
+        return EXIT_FAILURE;
+    }
+
+    // the meshes in the order of the Emperor input
+    if (isPing) {
+        for (int i = 0; i < bandwidthNumNodes.size(); i++) {
+            stringstream meshName;
+            meshName << "bandwidthMesh" << bandwidthNumNodes[i];
+            sendStripMesh(meshName.str().c_str(), bandwidthNumNodes[i]);
+        }
+    }
+    sendStripMesh("fanInMesh", fanInNumNodes);
+
+    vector<double> pingPongTimes;
+    if (isPing || isPong)
+        pingPongTimes = runPingPong(isPing, numPingPongs);
+    vector<vector<double> > bounceTimes;
+    if (isPing)
+        for (int i = 0; i < bandwidthNumNodes.size(); i++)
+            bounceTimes.push_back(runBounce(bandwidthNumNodes[i], bandwidthNumRepetitions[i]));
+    vector<double> fanInTimes = runFanIn(fanInNumNodes, numFanIns);
+
+    if (isPing) {
+        ofstream out(resultFile.c_str());
+        out << fixed << setprecision(3);
+        out << "{\n";
+        out << "  \"pingPong\": {";
+        writeStatistics(out, computeStatistics(pingPongTimes));
+        out << "},\n";
+        out << "  \"bandwidth\": [";
+        for (int i = 0; i < bandwidthNumNodes.size(); i++) {
+            Statistics statistics = computeStatistics(bounceTimes[i]);
+            long bytes = 3L * bandwidthNumNodes[i] * sizeof(double);
+            // a round trip moves the data field twice
+            double bandwidth = (statistics.median > 0.0) ? 2.0 * bytes / statistics.median / 1e6 : 0.0;
+            out << (i == 0 ? "\n" : ",\n") << "    {\"numNodes\": " << bandwidthNumNodes[i]
+                    << ", \"bytes\": " << bytes << ", ";
+            writeStatistics(out, statistics);
+            out << ", \"bandwidth_MBps\": " << bandwidth << "}";
+        }
+        out << "\n  ],\n";
+        out << "  \"fanIn\": {\"numClients\": " << numFanInClients << ", \"numNodes\": "
+                << fanInNumNodes << ", \"bytesPerClient\": " << 3L * fanInNumNodes * sizeof(double)
+                << ", ";
+        writeStatistics(out, computeStatistics(fanInTimes));
+        out << "}\n";
+        out << "}\n";
+        cout << "Results of the communication benchmark written to " << resultFile << endl;
+    }
+
+    EMPIRE_API_Disconnect();
+    return EXIT_SUCCESS;
+}
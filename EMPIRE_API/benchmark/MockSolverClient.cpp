@@ -0,0 +1,196 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file MockSolverClient.cpp
+ * This file holds a mock solver for the measurement of the overhead of the Emperor per coupling
+ * iteration. Two mock solvers couple a flat plate by a linear spring model instead of a CFD and a
+ * CSM code: the "structure" computes the displacements w = f / (k * a) from the nodal forces f
+ * (a is the area of a node), the "fluid" computes the forces f = a * (p - c * w) from the
+ * displacements. The fixed point is w = p / (k + c), for c > k the iteration without relaxation
+ * diverges, so the coupling algorithm is needed. With the coupling "dataField" the mock solvers
+ * exchange the fields of their own meshes (mapped by the Emperor), with the coupling "signal" one
+ * lumped displacement and force. The Emperor inputs are emperorMockSolver*.xml, the Emperor side
+ * time per iteration and subsystem is written by its profiler.
+ * \date 10/15/2026
+ **************************************************************************************************/
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "EMPIRE_API.h"
+
+using namespace std;
+
+/***********************************************************************************************
+ * \brief Get a user defined text of the client input file
+ * \param[in] elementName the name of the XML element in the user defined block
+ * \param[in] defaultValue the text if the element is missing
+ * \return the text
+ ***********/
+static string getText(const char *elementName, const char *defaultValue) {
+    string text = EMPIRE_API_getUserDefinedText(const_cast<char*>(elementName));
+    return text.empty() ? defaultValue : text;
+}
+
+/***********************************************************************************************
+ * \brief Get a user defined number of the client input file
+ * \param[in] elementName the name of the XML element in the user defined block
+ * \param[in] defaultValue the text if the element is missing
+ * \return the number
+ ***********/
+static double getNumber(const char *elementName, const char *defaultValue) {
+    return atof(getText(elementName, defaultValue).c_str());
+}
+
+/***********************************************************************************************
+ * \brief Create the unit square plate in the x-y plane meshed by quads
+ * \param[in] numElemsX the number of elements in x
+ * \param[in] numElemsY the number of elements in y
+ * \param[out] nodes the coordinates of the nodes
+ * \param[out] nodeIDs the ids of the nodes
+ * \param[out] elems the node ids of the quads
+ * \param[out] areas the area of every node (a quarter of each adjacent quad)
+ ***********/
+static void createPlate(int numElemsX, int numElemsY, vector<double> &nodes, vector<int> &nodeIDs,
+        vector<int> &elems, vector<double> &areas) {
+    int numNodesX = numElemsX + 1;
+    int numNodesY = numElemsY + 1;
+    int numNodes = numNodesX * numNodesY;
+    nodes.resize(3 * numNodes);
+    nodeIDs.resize(numNodes);
+    areas.assign(numNodes, 0.0);
+    for (int j = 0; j < numNodesY; j++) {
+        for (int i = 0; i < numNodesX; i++) {
+            int node = j * numNodesX + i;
+            nodes[3 * node + 0] = (double) i / numElemsX;
+            nodes[3 * node + 1] = (double) j / numElemsY;
+            nodes[3 * node + 2] = 0.0;
+            nodeIDs[node] = node + 1;
+        }
+    }
+    double quarterArea = 0.25 / numElemsX / numElemsY;
+    elems.resize(4 * numElemsX * numElemsY);
+    for (int j = 0; j < numElemsY; j++) {
+        for (int i = 0; i < numElemsX; i++) {
+            int elem = j * numElemsX + i;
+            int corners[4] = { j * numNodesX + i, j * numNodesX + i + 1, (j + 1) * numNodesX + i + 1,
+                    (j + 1) * numNodesX + i };
+            for (int k = 0; k < 4; k++) {
+                elems[4 * elem + k] = nodeIDs[corners[k]];
+                areas[corners[k]] += quarterArea;
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        cerr << "Usage: " << argv[0] << " <client input file>" << endl;
+        return EXIT_FAILURE;
+    }
+    EMPIRE_API_Connect(argv[1]);
+
+    string role = getText("role", "");
+    string coupling = getText("coupling", "dataField");
+    bool isStructure = (role == "structure");
+    bool isSignalCoupling = (coupling == "signal");
+    if ((!isStructure && role != "fluid") || (!isSignalCoupling && coupling != "dataField")) {
+        cerr << "Error: unknown role \"" << role << "\" (structure or fluid) or coupling \""
+                << coupling << "\" (dataField or signal)" << endl;
+        EMPIRE_API_Disconnect();
+        return EXIT_FAILURE;
+    }
+    int numElemsX = (int) getNumber("numElemsX", "40");
+    int numElemsY = (int) getNumber("numElemsY", "40");
+    int numTimeSteps = (int) getNumber("numTimeSteps", "10");
+    double stiffness = getNumber("stiffness", "1.0");
+    double fluidStiffness = getNumber("fluidStiffness", "2.0");
+    double pressure = getNumber("pressure", "1.0");
+
+    vector<double> nodes;
+    vector<int> nodeIDs;
+    vector<int> elems;
+    vector<double> areas;
+    createPlate(numElemsX, numElemsY, nodes, nodeIDs, elems, areas);
+    int numNodes = nodeIDs.size();
+    int numElems = elems.size() / 4;
+    if (!isSignalCoupling) {
+        vector<int> numNodesPerElem(numElems, 4);
+        EMPIRE_API_sendMesh(const_cast<char*>("plate"), numNodes, numElems, &nodes[0], &nodeIDs[0],
+                &numNodesPerElem[0], &elems[0]);
+    }
+
+    // the fields are vectors, only the z component is loaded
+    vector<double> displacements(3 * numNodes, 0.0);
+    vector<double> forces(3 * numNodes, 0.0);
+    double displacement = 0.0; // the lumped values of the signal coupling
+    double force = 0.0;
+    int totalNumIterations = 0;
+    for (int timeStep = 1; timeStep <= numTimeSteps; timeStep++) {
+        double load = pressure * timeStep / numTimeSteps;
+        int numIterations = 0;
+        do {
+            numIterations++;
+            if (isStructure && isSignalCoupling) {
+                EMPIRE_API_recvSignal_double(const_cast<char*>("force"), 1, &force);
+                displacement = force / stiffness; // the area of the plate is 1
+                EMPIRE_API_sendSignal_double(const_cast<char*>("displacement"), 1, &displacement);
+            } else if (isSignalCoupling) {
+                EMPIRE_API_recvSignal_double(const_cast<char*>("displacement"), 1, &displacement);
+                force = load - fluidStiffness * displacement;
+                EMPIRE_API_sendSignal_double(const_cast<char*>("force"), 1, &force);
+            } else if (isStructure) {
+                EMPIRE_API_recvDataField(const_cast<char*>("forces"), forces.size(), &forces[0]);
+                for (int i = 0; i < numNodes; i++)
+                    displacements[3 * i + 2] = forces[3 * i + 2] / (stiffness * areas[i]);
+                EMPIRE_API_sendDataField(const_cast<char*>("displacements"), displacements.size(),
+                        &displacements[0]);
+            } else {
+                EMPIRE_API_recvDataField(const_cast<char*>("displacements"), displacements.size(),
+                        &displacements[0]);
+                for (int i = 0; i < numNodes; i++)
+                    forces[3 * i + 2] = areas[i] * (load - fluidStiffness * displacements[3 * i + 2]);
+                EMPIRE_API_sendDataField(const_cast<char*>("forces"), forces.size(), &forces[0]);
+            }
+        } while (EMPIRE_API_recvConvergenceSignal() == 0);
+        totalNumIterations += numIterations;
+
+        // the deviation from the fixed point shows that the coupling converged to the right solution
+        double exactDisplacement = load / (stiffness + fluidStiffness);
+        double error = 0.0;
+        if (isSignalCoupling) {
+            error = fabs(displacement - exactDisplacement);
+        } else {
+            for (int i = 0; i < numNodes; i++)
+                error = max(error, fabs(displacements[3 * i + 2] - exactDisplacement));
+        }
+        cout << "time step " << timeStep << ": " << numIterations << " iterations, error of the "
+                << "displacement " << error << endl;
+    }
+    cout << role << ": " << totalNumIterations << " iterations in " << numTimeSteps << " time steps"
+            << endl;
+
+    EMPIRE_API_Disconnect();
+    return EXIT_SUCCESS;
+}
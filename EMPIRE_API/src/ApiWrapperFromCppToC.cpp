@@ -24,6 +24,7 @@
  * \date 2/22/2012
  **************************************************************************************************/
 #include "Empire.h"
+#include "ClientCommunication.h"
 #include "EMPIRE_API.h"
 #include <assert.h>
 #include <string.h>
@@ -55,6 +56,15 @@ void EMPIRE_API_sendMesh(char *name, int numNodes, int numElems, double *nodes,
     empire->sendMesh(numNodes, numElems, nodes, nodeIDs, numNodesPerElem, elems);
 }
 
+void EMPIRE_API_sendMeshCoordinates(char *name, int numNodes, double *nodes) {
+    empire->sendMeshCoordinates(numNodes, nodes);
+}
+
+void EMPIRE_API_sendMeshPartitioned(char *name, int numNodes, int numElems, double *nodes,
+        int *nodeIDs, int *numNodesPerElem, int *elems) {
+    empire->sendMeshPartitioned(numNodes, numElems, nodes, nodeIDs, numNodesPerElem, elems);
+}
+
 void EMPIRE_API_sendSectionMesh(char *name, int numNodes, int numElems, double *nodes, int *nodeIDs,
         int *numNodesPerElem, int *elems, int numSections, int numRootSectionNodes,
         int numNormalSectionNodes, int numTipSectionNodes, double *rotationGlobal2Root,
@@ -69,6 +79,13 @@ void EMPIRE_API_recvMesh(char *name, int *numNodes, int *numElems, double **node
     empire->recvMesh(numNodes, numElems, nodes, nodeIDs, numNodesPerElem, elem);
 }
 
+void EMPIRE_API_recvMeshInPlace(char *name, int maxNumNodes, int maxNumElems, int maxSizeOfElems,
+        int *numNodes, int *numElems, double *nodes, int *nodeIDs, int *numNodesPerElem,
+        int *elems) {
+    empire->recvMesh(maxNumNodes, maxNumElems, maxSizeOfElems, numNodes, numElems, nodes, nodeIDs,
+            numNodesPerElem, elems);
+}
+
 void EMPIRE_API_sendIGAPatch(int _pDegree, int _uNumKnots, double* _uKnotVector, int _qDegree,
         int _vNumKnots, double* _vKnotVector, int _uNumControlPoints, int _vNumControlPoints,
         double* _cpNet, int* _nodeNet) {
@@ -152,11 +169,65 @@ void EMPIRE_API_sendIGADirichletDofs(int numberOfClampedDofs, int* clampedDofs,
 }
 
 void EMPIRE_API_sendDataField(char *name, int sizeOfArray, double *dataField) {
-    empire->sendDataField(sizeOfArray, dataField);
+    empire->sendDataField(name, sizeOfArray, dataField);
 }
 
 void EMPIRE_API_recvDataField(char *name, int sizeOfArray, double *dataField) {
-    empire->recvDataField(sizeOfArray, dataField);
+    empire->recvDataField(name, sizeOfArray, dataField);
+}
+
+int EMPIRE_API_registerDataField(char *name) {
+    return empire->registerDataField(name);
+}
+
+int EMPIRE_API_registerDataFieldBuffer(char *name, int sizeOfArray, double *dataField) {
+    return empire->registerDataField(name, sizeOfArray, dataField);
+}
+
+void EMPIRE_API_sendRegisteredDataField(int handle) {
+    empire->sendRegisteredDataField(handle);
+}
+
+void EMPIRE_API_recvRegisteredDataField(int handle) {
+    empire->recvRegisteredDataField(handle);
+}
+
+void EMPIRE_API_sendDataFieldByHandle(int handle, int sizeOfArray, double *dataField) {
+    empire->sendDataField(handle, sizeOfArray, dataField);
+}
+
+void EMPIRE_API_recvDataFieldByHandle(int handle, int sizeOfArray, double *dataField) {
+    empire->recvDataField(handle, sizeOfArray, dataField);
+}
+
+void EMPIRE_API_sendDataFieldPartitioned(char *name, int sizeOfArray, double *dataField) {
+    empire->sendDataFieldPartitioned(name, sizeOfArray, dataField);
+}
+
+void EMPIRE_API_recvDataFieldPartitioned(char *name, int sizeOfArray, double *dataField) {
+    empire->recvDataFieldPartitioned(name, sizeOfArray, dataField);
+}
+
+void EMPIRE_API_sendDataFields(int numFields, char **names, int *sizesOfArrays,
+        double **dataFields) {
+    empire->sendDataFields(numFields, names, sizesOfArrays, dataFields);
+}
+
+void EMPIRE_API_recvDataFields(int numFields, char **names, int *sizesOfArrays,
+        double **dataFields) {
+    empire->recvDataFields(numFields, names, sizesOfArrays, dataFields);
+}
+
+void EMPIRE_API_isendDataField(char *name, int sizeOfArray, double *dataField) {
+    empire->isendDataField(name, sizeOfArray, dataField);
+}
+
+void EMPIRE_API_irecvDataField(char *name, int sizeOfArray, double *dataField) {
+    empire->irecvDataField(name, sizeOfArray, dataField);
+}
+
+void EMPIRE_API_wait() {
+    empire->wait();
 }
 
 void EMPIRE_API_sendSignal_double(char *name, int sizeOfArray, double *signal) {
@@ -167,6 +238,28 @@ void EMPIRE_API_recvSignal_double(char *name, int sizeOfArray, double *signal) {
     empire->recvSignal_double(name, sizeOfArray, signal);
 }
 
+void EMPIRE_API_sendSignals(int numSignals, char **names, int *sizesOfArrays, double **signals) {
+    empire->sendSignals(numSignals, names, sizesOfArrays, signals);
+}
+
+void EMPIRE_API_recvSignals(int numSignals, char **names, int *sizesOfArrays, double **signals) {
+    empire->recvSignals(numSignals, names, sizesOfArrays, signals);
+}
+
+void EMPIRE_API_sendInterfaceJacobian(char *name, int numRows, int numColumns, int *rowPointers,
+        int *columnIndices, double *values) {
+    empire->sendInterfaceJacobian(name, numRows, numColumns, rowPointers, columnIndices, values);
+}
+
+void EMPIRE_API_recvMappingOperator(char *name, int *numRows, int *numColumns) {
+    empire->recvMappingOperator(name, numRows, numColumns);
+}
+
+void EMPIRE_API_applyMappingOperator(char *name, int transpose, int numComponents, double *fieldIn,
+        double *fieldOut) {
+    empire->applyMappingOperator(name, transpose, numComponents, fieldIn, fieldOut);
+}
+
 void EMPIRE_API_sendConvergenceSignal(int signal) {
     empire->sendConvergenceSignal(signal);
 }
@@ -175,6 +268,10 @@ int EMPIRE_API_recvConvergenceSignal() {
     return empire->recvConvergenceSignal();
 }
 
+int EMPIRE_API_recvDataFieldAndConvergence(char *name, int sizeOfArray, double *dataField) {
+    return empire->recvDataFieldAndConvergence(name, sizeOfArray, dataField);
+}
+
 void EMPIRE_API_printDataField(char *name, int sizeOfArray, double *dataField) {
     empire->printDataField(name, sizeOfArray, dataField);
 }
@@ -183,3 +280,9 @@ void EMPIRE_API_Disconnect() {
     empire->disconnect();
     delete empire;
 }
+
+void EMPIRE_API_setInProcessLink(void *channel,
+        void (*sendToServer)(void *channel, const void *message, int numBytes),
+        void (*receiveFromServer)(void *channel, void *message, int numBytes)) {
+    ClientCommunication::setInProcessLink(channel, sendToServer, receiveFromServer);
+}
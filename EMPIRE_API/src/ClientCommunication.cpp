@@ -20,14 +20,44 @@
  */
 #include "ClientCommunication.h"
 #include "ClientMetaDatabase.h"
+#include "DataFieldCodec.h"
+#include "EMPIRE_API_Enum.h"
 #include <assert.h>
+#include <algorithm>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <math.h>
 #include "EMPIRE_API.h"
 using namespace std;
 
 namespace EMPIRE {
 
 ClientCommunication *ClientCommunication::clientComm = NULL;
+void *ClientCommunication::inProcessChannel = NULL;
+void (*ClientCommunication::inProcessSend)(void*, const void*, int) = NULL;
+void (*ClientCommunication::inProcessReceive)(void*, void*, int) = NULL;
+
+/***********************************************************************************************
+ * \brief Check whether values differ from the ones last sent by more than the relative tolerance
+ *        in the 2-norm, a tolerance of 0 compares them bitwise
+ ***********/
+static bool isChanged(const double *values, int size, const vector<double> &lastSent,
+        double tolerance) {
+    if (lastSent.size() != size)
+        return true;
+    if (tolerance == 0.0)
+        return size > 0 && memcmp(values, &lastSent[0], size * sizeof(double)) != 0;
+    double deltaSquare = 0.0;
+    double lastSentSquare = 0.0;
+    for (int i = 0; i < size; i++) {
+        deltaSquare += (values[i] - lastSent[i]) * (values[i] - lastSent[i]);
+        lastSentSquare += lastSent[i] * lastSent[i];
+    }
+    return sqrt(deltaSquare) > tolerance * sqrt(lastSentSquare);
+}
 
 ClientCommunication *ClientCommunication::getSingleton() {
     if (clientComm == NULL)
@@ -40,7 +70,24 @@ void ClientCommunication::free() {
     clientComm = NULL;
 }
 
-ClientCommunication::ClientCommunication() {
+void ClientCommunication::setInProcessLink(void *channel,
+        void (*sendToServer)(void *channel, const void *message, int numBytes),
+        void (*receiveFromServer)(void *channel, void *message, int numBytes)) {
+    assert(clientComm == NULL);
+    inProcessChannel = channel;
+    inProcessSend = sendToServer;
+    inProcessReceive = receiveFromServer;
+}
+
+ClientCommunication::ClientCommunication() :
+        isSharedMemoryOfferPending(false) {
+    if (inProcessChannel != NULL) {
+        // the Emperor owns MPI in this process, the client does not make any MPI call
+        myRank = 0;
+        isMpiInitCalledByClient = 1;
+        isMpiCallLegal = 0;
+        return;
+    }
 
     portFile.open((const char*) (ClientMetaDatabase::getSingleton()->getServerPortFile().c_str()));
     MPI_Initialized(&isMpiInitCalledByClient);
@@ -61,6 +108,10 @@ ClientCommunication::~ClientCommunication() {
 }
 
 void ClientCommunication::connect() {
+    if (inProcessChannel != NULL) {
+        cout << "EMPIRE_INFO: Client runs inside the Emperor process" << endl;
+        return;
+    }
     MPI_Status status;
     int connectionSuccessful = 0;
     if (portFile.is_open()) {
@@ -107,6 +158,10 @@ void ClientCommunication::disconnect() {
 			cout << "EMPIRE_INFO: COMM size server: " << size << endl;
 			MPI_Comm_remote_size(server, &size);
 			cout << "EMPIRE_INFO: COMM size remote server: " << size << endl;
+			freePersistentRequests(persistentSends);
+			freePersistentRequests(persistentReceives);
+			unmapSharedMemorySegments(sharedMemorySends);
+			unmapSharedMemorySegments(sharedMemoryReceives);
 			MPI_Comm_disconnect(&server);
 		}
 		if (!isMpiInitCalledByClient) {
@@ -116,4 +171,334 @@ void ClientCommunication::disconnect() {
 
 }
 
+void ClientCommunication::waitForAllRequests(int count, MPI_Request *requests) {
+    if (isMpiCallLegal)
+        MPI_Waitall(count, requests, MPI_STATUSES_IGNORE);
+}
+
+void ClientCommunication::startSendDataField(const string &name, int size, double* dataField) {
+    if (writeSharedMemorySegment(name, size, dataField))
+        return;
+    EncodedDataField *encoded = getEncodedDataField(encodedSends, name, size);
+    int chunkSize = ClientMetaDatabase::getSingleton()->getDataFieldChunkSize(name);
+    double tolerance = 0.0;
+    if (encoded != NULL) {
+        PendingDataField &pending = addPendingDataField(name, size, dataField, true, false);
+        pending.transfer = PendingDataField::ENCODED_TRANSFER;
+        pending.header = DataFieldCodec::encode(encoded->wireFormat, size, dataField,
+                &encoded->history[0], &encoded->buffer[0]);
+        sendToServerNonBlocking<int>(1, &pending.header, &pending.requests[0]);
+        sendToServerNonBlocking<unsigned char>(pending.header, &encoded->buffer[0],
+                &pending.requests[1]);
+    } else if (chunkSize > 0) {
+        // never bound to a persistent request or a shared memory segment
+        PendingDataField &pending = addPendingDataField(name, size, dataField, true, false);
+        pending.transfer = PendingDataField::CHUNKED_TRANSFER;
+        pending.header = size;
+        sendToServerNonBlocking<int>(1, &pending.header, &pending.requests[0]);
+        pending.requests[1] = MPI_REQUEST_NULL;
+        postDataFieldChunks(pending, chunkSize);
+    } else if (ClientMetaDatabase::getSingleton()->isDataFieldSkipUnchanged(name, tolerance)) {
+        // never bound to a persistent request or a shared memory segment
+        PendingDataField &pending = addPendingDataField(name, size, dataField, true, false);
+        pending.transfer = PendingDataField::SKIP_UNCHANGED_TRANSFER;
+        vector<double> &lastSent = lastSentDataFields[name];
+        if (isChanged(dataField, size, lastSent, tolerance)) {
+            lastSent.assign(dataField, dataField + size);
+            pending.header = size;
+            sendToServerNonBlocking<int>(1, &pending.header, &pending.requests[0]);
+            sendToServerNonBlocking<double>(size, dataField, &pending.requests[1]);
+        } else { // only the flag and an empty message are sent, the Emperor keeps the values
+            pending.header = UNCHANGED_DATA_FIELD;
+            sendToServerNonBlocking<int>(1, &pending.header, &pending.requests[0]);
+            sendToServerNonBlocking<double>(0, dataField, &pending.requests[1]);
+        }
+    } else if (startPersistentRequest(persistentSends, true, name, size, dataField)) {
+        PendingDataField &pending = addPendingDataField(name, size, dataField, true, false);
+        pending.transfer = PendingDataField::PERSISTENT_TRANSFER;
+    } else {
+        PendingDataField &pending = addPendingDataField(name, size, dataField, true, true);
+        pending.transfer = PendingDataField::FIRST_TRANSFER;
+        pending.header = size;
+        // post the size and the data together, the Emperor receives both without a round trip
+        sendToServerNonBlocking<int>(1, &pending.header, &pending.requests[0]);
+        sendToServerNonBlocking<double>(size, dataField, &pending.requests[1]);
+    }
+}
+
+void ClientCommunication::startReceiveDataField(const string &name, int size, double* dataField,
+        const int *receivedHeader) {
+    if (readSharedMemorySegment(name, size, dataField)) {
+        assert(receivedHeader == NULL); // no size header is sent through shared memory
+        return;
+    }
+    EncodedDataField *encoded = getEncodedDataField(encodedReceives, name, size);
+    int chunkSize = ClientMetaDatabase::getSingleton()->getDataFieldChunkSize(name);
+    double tolerance = 0.0;
+    if (encoded != NULL) {
+        PendingDataField &pending = addPendingDataField(name, size, dataField, false, false);
+        pending.transfer = PendingDataField::ENCODED_TRANSFER;
+        receiveSizeHeader(pending, receivedHeader);
+        receiveFromServerNonBlocking<unsigned char>(encoded->buffer.size(), &encoded->buffer[0],
+                &pending.requests[1]);
+    } else if (chunkSize > 0) {
+        PendingDataField &pending = addPendingDataField(name, size, dataField, false, false);
+        pending.transfer = PendingDataField::CHUNKED_TRANSFER;
+        receiveSizeHeader(pending, receivedHeader);
+        pending.requests[1] = MPI_REQUEST_NULL;
+        postDataFieldChunks(pending, chunkSize);
+    } else if (ClientMetaDatabase::getSingleton()->isDataFieldSkipUnchanged(name, tolerance)) {
+        PendingDataField &pending = addPendingDataField(name, size, dataField, false, false);
+        pending.transfer = PendingDataField::SKIP_UNCHANGED_TRANSFER;
+        // unchanged values are sent as an empty message, which leaves the data field as it is
+        receiveSizeHeader(pending, receivedHeader);
+        receiveFromServerNonBlocking<double>(size, dataField, &pending.requests[1]);
+    } else if (startPersistentRequest(persistentReceives, false, name, size, dataField)) {
+        assert(receivedHeader == NULL); // no size header after the first transfer
+        PendingDataField &pending = addPendingDataField(name, size, dataField, false, false);
+        pending.transfer = PendingDataField::PERSISTENT_TRANSFER;
+    } else {
+        PendingDataField &pending = addPendingDataField(name, size, dataField, false, true);
+        pending.transfer = PendingDataField::FIRST_TRANSFER;
+        receiveSizeHeader(pending, receivedHeader);
+        receiveFromServerNonBlocking<double>(size, dataField, &pending.requests[1]);
+    }
+}
+
+void ClientCommunication::receiveSizeHeader(PendingDataField &pending, const int *receivedHeader) {
+    if (receivedHeader != NULL) {
+        pending.header = *receivedHeader;
+        pending.requests[0] = MPI_REQUEST_NULL;
+    } else {
+        receiveFromServerNonBlocking<int>(1, &pending.header, &pending.requests[0]);
+    }
+}
+
+void ClientCommunication::finishDataFieldTransfers() {
+    for (list<PendingDataField>::iterator it = pendingDataFields.begin();
+            it != pendingDataFields.end(); it++) {
+        if (it->transfer == PendingDataField::PERSISTENT_TRANSFER) {
+            map<string, PersistentRequest> &requests =
+                    it->isSend ? persistentSends : persistentReceives;
+            MPI_Wait(&requests[it->name].request, &status);
+            continue;
+        }
+        waitForAllRequests(2, it->requests);
+        if (it->transfer == PendingDataField::CHUNKED_TRANSFER) {
+            if (!it->chunkRequests.empty())
+                waitForAllRequests(it->chunkRequests.size(), &it->chunkRequests[0]);
+            assert(it->header == it->size);
+        } else if (it->transfer == PendingDataField::SKIP_UNCHANGED_TRANSFER) {
+            assert(it->header == it->size || it->header == UNCHANGED_DATA_FIELD);
+        } else if (it->transfer == PendingDataField::ENCODED_TRANSFER) {
+            if (!it->isSend) {
+                EncodedDataField &encoded = encodedReceives[it->name];
+                DataFieldCodec::decode(encoded.wireFormat, it->size, &encoded.buffer[0],
+                        it->header, &encoded.history[0], it->dataField);
+            }
+        } else if (it->isSend) {
+            // a shared memory segment with an Emperor on the same node replaces the persistent request
+            if (!initSharedMemorySend(it->name, it->size))
+                initPersistentSend(it->name, it->size, it->dataField);
+        } else {
+            assert(it->header == it->size);
+            if (!initSharedMemoryReceive(it->name, it->size))
+                initPersistentReceive(it->name, it->size, it->dataField);
+        }
+    }
+    pendingDataFields.clear();
+    isSharedMemoryOfferPending = false;
+}
+
+ClientCommunication::PendingDataField &ClientCommunication::addPendingDataField(
+        const string &name, int size, double* dataField, bool isSend, bool isFirstTransfer) {
+    // the Emperor completes the first transfer of a data field, including the offer, before it
+    // posts the next one, so nothing else may be posted while an offer is awaited
+    if (isSharedMemoryOfferPending)
+        finishDataFieldTransfers();
+    if (isFirstTransfer && ClientMetaDatabase::getSingleton()->isSharedMemoryDataFieldTransfer())
+        isSharedMemoryOfferPending = true;
+    PendingDataField pending;
+    pending.name = name;
+    pending.size = size;
+    pending.dataField = dataField;
+    pending.isSend = isSend;
+    pending.header = 0;
+    pendingDataFields.push_back(pending);
+    return pendingDataFields.back();
+}
+
+void ClientCommunication::postDataFieldChunks(PendingDataField &pending, int chunkSize) {
+    assert(chunkSize > 0);
+    for (int begin = 0; begin < pending.size; begin += chunkSize) {
+        int size = min(chunkSize, pending.size - begin);
+        pending.chunkRequests.push_back(MPI_REQUEST_NULL);
+        if (pending.isSend)
+            sendToServerNonBlocking<double>(size, pending.dataField + begin,
+                    &pending.chunkRequests.back());
+        else
+            receiveFromServerNonBlocking<double>(size, pending.dataField + begin,
+                    &pending.chunkRequests.back());
+    }
+}
+
+bool ClientCommunication::writeSharedMemorySegment(const string &name, int size,
+        double* dataField) {
+    map<string, SharedMemorySegment>::iterator segment = sharedMemorySends.find(name);
+    if (segment == sharedMemorySends.end())
+        return false;
+    SharedMemoryHeader *header = segment->second.header;
+    assert(header->size == size);
+    while (header->numRead != header->numWritten)
+        sched_yield();
+    __sync_synchronize();
+    memcpy(header + 1, dataField, size * sizeof(double));
+    // the data must be visible before the counter
+    __sync_synchronize();
+    header->numWritten++;
+    return true;
+}
+
+bool ClientCommunication::readSharedMemorySegment(const string &name, int size,
+        double* dataField) {
+    map<string, SharedMemorySegment>::iterator segment = sharedMemoryReceives.find(name);
+    if (segment == sharedMemoryReceives.end())
+        return false;
+    SharedMemoryHeader *header = segment->second.header;
+    assert(header->size == size);
+    while (header->numRead == header->numWritten)
+        sched_yield();
+    __sync_synchronize();
+    memcpy(dataField, header + 1, size * sizeof(double));
+    // the copy must be finished before the Emperor may overwrite the data
+    __sync_synchronize();
+    header->numRead++;
+    return true;
+}
+
+bool ClientCommunication::startPersistentRequest(map<string, PersistentRequest> &requests,
+        bool isSend, const string &name, int size, double* dataField) {
+    map<string, PersistentRequest>::iterator it = requests.find(name);
+    if (!isMpiCallLegal || it == requests.end())
+        return false;
+    if (it->second.buffer != dataField || it->second.size != size) {
+        MPI_Request_free(&it->second.request);
+        requests.erase(it);
+        if (isSend)
+            initPersistentSend(name, size, dataField);
+        else
+            initPersistentReceive(name, size, dataField);
+        it = requests.find(name);
+    }
+    MPI_Start(&it->second.request);
+    return true;
+}
+
+void ClientCommunication::initPersistentSend(const string &name, int size, double* message) {
+    if (!isMpiCallLegal || !ClientMetaDatabase::getSingleton()->isPersistentDataFieldTransfer())
+        return;
+    assert(persistentSends.find(name) == persistentSends.end());
+    PersistentRequest &persistent = persistentSends[name];
+    persistent.buffer = message;
+    persistent.size = size;
+    MPI_Send_init(message, size, MPI_DOUBLE, 0, 0, server, &persistent.request);
+}
+
+void ClientCommunication::initPersistentReceive(const string &name, int size, double* message) {
+    if (!isMpiCallLegal || !ClientMetaDatabase::getSingleton()->isPersistentDataFieldTransfer())
+        return;
+    assert(persistentReceives.find(name) == persistentReceives.end());
+    PersistentRequest &persistent = persistentReceives[name];
+    persistent.buffer = message;
+    persistent.size = size;
+    MPI_Recv_init(message, size, MPI_DOUBLE, MPI_ANY_SOURCE, DEFAULT_TAG, server,
+            &persistent.request);
+}
+
+bool ClientCommunication::initSharedMemorySend(const string &name, int size) {
+    if ((!isMpiCallLegal && inProcessChannel == NULL)
+            || !ClientMetaDatabase::getSingleton()->isSharedMemoryDataFieldTransfer())
+        return false;
+    assert(sharedMemorySends.find(name) == sharedMemorySends.end());
+    SharedMemorySegment segment;
+    if (!mapSharedMemorySegment(size, segment))
+        return false;
+    sharedMemorySends[name] = segment;
+    return true;
+}
+
+bool ClientCommunication::initSharedMemoryReceive(const string &name, int size) {
+    if ((!isMpiCallLegal && inProcessChannel == NULL)
+            || !ClientMetaDatabase::getSingleton()->isSharedMemoryDataFieldTransfer())
+        return false;
+    assert(sharedMemoryReceives.find(name) == sharedMemoryReceives.end());
+    SharedMemorySegment segment;
+    if (!mapSharedMemorySegment(size, segment))
+        return false;
+    sharedMemoryReceives[name] = segment;
+    return true;
+}
+
+ClientCommunication::EncodedDataField *ClientCommunication::getEncodedDataField(
+        map<string, EncodedDataField> &encodings, const string &name, int size) {
+    map<string, EncodedDataField>::iterator it = encodings.find(name);
+    if (it == encodings.end()) {
+        int wireFormat = ClientMetaDatabase::getSingleton()->getDataFieldWireFormat(name);
+        if (wireFormat == EMPIRE_DataField_float64)
+            return NULL;
+        EncodedDataField &encoded = encodings[name];
+        encoded.wireFormat = wireFormat;
+        encoded.buffer.resize(DataFieldCodec::getMaxEncodedSize(wireFormat, size));
+        encoded.history.assign(size, 0.0);
+        return &encoded;
+    }
+    assert(it->second.history.size() == size);
+    return &it->second;
+}
+
+bool ClientCommunication::mapSharedMemorySegment(int size, SharedMemorySegment &segment) {
+    char segmentName[EMPIRE_API_NAME_STRING_LENGTH];
+    int token = 0;
+    receiveFromServerBlocking<char>(EMPIRE_API_NAME_STRING_LENGTH, segmentName);
+    receiveFromServerBlocking<int>(1, &token);
+
+    int isMapped = 0;
+    segment.header = NULL;
+    segment.numBytes = sizeof(SharedMemoryHeader) + size * sizeof(double);
+    // a segment of that name does not exist on another node, or it is a stale one of an earlier run
+    int fd = segmentName[0] == '\0' ? -1 : shm_open(segmentName, O_RDWR, 0);
+    if (fd >= 0) {
+        void *address = mmap(NULL, segment.numBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address != MAP_FAILED) {
+            segment.header = static_cast<SharedMemoryHeader*>(address);
+            if (segment.header->token == token && segment.header->size == size) {
+                isMapped = 1;
+            } else {
+                munmap(address, segment.numBytes);
+                segment.header = NULL;
+            }
+        }
+    }
+    sendToServerBlocking<int>(1, &isMapped);
+    if (isMapped)
+        cout << "EMPIRE_INFO: data field is transferred through shared memory " << segmentName
+                << endl;
+    return isMapped;
+}
+
+void ClientCommunication::unmapSharedMemorySegments(map<string, SharedMemorySegment> &segments) {
+    for (map<string, SharedMemorySegment>::iterator it = segments.begin(); it != segments.end();
+            it++)
+        munmap(it->second.header, it->second.numBytes);
+    segments.clear();
+}
+
+void ClientCommunication::freePersistentRequests(map<string, PersistentRequest> &requests) {
+    for (map<string, PersistentRequest>::iterator it = requests.begin(); it != requests.end();
+            it++)
+        MPI_Request_free(&it->second.request);
+    requests.clear();
+}
+
 } /* namespace EMPIRE */
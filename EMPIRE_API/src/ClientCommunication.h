@@ -31,6 +31,9 @@
 #include <fstream>
 #include <string>
 #include <typeinfo>
+#include <map>
+#include <vector>
+#include <list>
 
 namespace EMPIRE {
 class ClientMetaDatabase;
@@ -50,6 +53,16 @@ public:
      * \author Tianyang Wang
      ***********/
     static void free();
+    /***********************************************************************************************
+     * \brief Let the client communicate with an Emperor running in the same process, must be
+     *        called before the singleton is created
+     * \param[in] channel the channel of the Emperor, passed to both functions
+     * \param[in] sendToServer copies a message to the Emperor
+     * \param[in] receiveFromServer copies a message from the Emperor
+     ***********/
+    static void setInProcessLink(void *channel,
+            void (*sendToServer)(void *channel, const void *message, int numBytes),
+            void (*receiveFromServer)(void *channel, void *message, int numBytes));
 	/***********************************************************************************************
 	 * \brief This does the communication initiation
 	 *
@@ -74,24 +87,26 @@ public:
          #define MPI_BYTE           ...
          #define MPI_PACKED         ...
 		 */
-		if (isMpiCallLegal) {
+		if (inProcessChannel != NULL) {
+			inProcessReceive(inProcessChannel, message, size * sizeof(T));
+		} else if (isMpiCallLegal) {
 
 			if (typeid(T) == typeid(int)) {
-				MPI_Recv(message, size, MPI_INTEGER, MPI_ANY_SOURCE, MPI_ANY_TAG, server, &status);
+				MPI_Recv(message, size, MPI_INTEGER, MPI_ANY_SOURCE, DEFAULT_TAG, server, &status);
 			} else if (typeid(T) == typeid(double)) {
-				MPI_Recv(message, size, MPI_DOUBLE, MPI_ANY_SOURCE, MPI_ANY_TAG, server, &status);
+				MPI_Recv(message, size, MPI_DOUBLE, MPI_ANY_SOURCE, DEFAULT_TAG, server, &status);
 			} else if (typeid(T) == typeid(float)) {
-				MPI_Recv(message, size, MPI_FLOAT, MPI_ANY_SOURCE, MPI_ANY_TAG, server, &status);
+				MPI_Recv(message, size, MPI_FLOAT, MPI_ANY_SOURCE, DEFAULT_TAG, server, &status);
 			} else if (typeid(T) == typeid(unsigned char)) {
-				MPI_Recv(message, size, MPI_UNSIGNED_CHAR, MPI_ANY_SOURCE, MPI_ANY_TAG, server,
+				MPI_Recv(message, size, MPI_UNSIGNED_CHAR, MPI_ANY_SOURCE, DEFAULT_TAG, server,
 						&status);
 			} else if (typeid(T) == typeid(long double)) {
-				MPI_Recv(message, size, MPI_LONG_DOUBLE, MPI_ANY_SOURCE, MPI_ANY_TAG, server,
+				MPI_Recv(message, size, MPI_LONG_DOUBLE, MPI_ANY_SOURCE, DEFAULT_TAG, server,
 						&status);
 			} else if (typeid(T) == typeid(short)) {
-				MPI_Recv(message, size, MPI_SHORT, MPI_ANY_SOURCE, MPI_ANY_TAG, server, &status);
+				MPI_Recv(message, size, MPI_SHORT, MPI_ANY_SOURCE, DEFAULT_TAG, server, &status);
 			} else if (typeid(T) == typeid(char)) {
-				MPI_Recv(message, size, MPI_CHAR, MPI_ANY_SOURCE, MPI_ANY_TAG, server, &status);
+				MPI_Recv(message, size, MPI_CHAR, MPI_ANY_SOURCE, DEFAULT_TAG, server, &status);
 			}
 		}
 	}
@@ -108,7 +123,9 @@ public:
          #define MPI_BYTE           ...
          #define MPI_PACKED         ...
 		 */
-		if (isMpiCallLegal) {
+		if (inProcessChannel != NULL) {
+			inProcessSend(inProcessChannel, message, size * sizeof(T));
+		} else if (isMpiCallLegal) {
 			if (typeid(T) == typeid(int)) {
 				MPI_Ssend(message, size, MPI_INT, 0, 0, server);
 			} else if (typeid(T) == typeid(double)) {
@@ -127,7 +144,286 @@ public:
 		}
 	}
 
+	/***********************************************************************************************
+	 * \brief Template function for starting a non-blocking send of data to server. The message
+	 *        must not be modified until the request is completed by waitForAllRequests
+	 * \param[in] size is the length of the message
+	 * \param[in] message is a pointer to the message which is going to be sent
+	 * \param[out] request is the request of the send
+	 ***********/
+	template<class T> void sendToServerNonBlocking(int size, T* message, MPI_Request *request) {
+		*request = MPI_REQUEST_NULL;
+		// in-process, the Emperor has posted its buffer already or will do so without blocking
+		if (inProcessChannel != NULL)
+			inProcessSend(inProcessChannel, message, size * sizeof(T));
+		else if (isMpiCallLegal)
+			MPI_Isend(message, size, getMPIDatatype<T>(), 0, 0, server, request);
+	}
+
+	/***********************************************************************************************
+	 * \brief Template function for starting a non-blocking receive of data from server
+	 * \param[in] size is the length of the message
+	 * \param[out] message is a pointer to the message which is going to be received
+	 * \param[out] request is the request of the receive
+	 ***********/
+	template<class T> void receiveFromServerNonBlocking(int size, T* message, MPI_Request *request) {
+		*request = MPI_REQUEST_NULL;
+		if (inProcessChannel != NULL)
+			inProcessReceive(inProcessChannel, message, size * sizeof(T));
+		else if (isMpiCallLegal)
+			MPI_Irecv(message, size, getMPIDatatype<T>(), MPI_ANY_SOURCE, DEFAULT_TAG, server,
+					request);
+	}
+
+	/***********************************************************************************************
+	 * \brief Template function for starting a non-blocking send of the partition of this process,
+	 *        which every process of the client does for a partitioned mesh and its data fields
+	 * \param[in] size is the length of the message
+	 * \param[in] message is a pointer to the message which is going to be sent
+	 * \param[out] request is the request of the send
+	 ***********/
+	template<class T> void sendPartitionToServer(int size, T* message, MPI_Request *request) {
+		*request = MPI_REQUEST_NULL;
+		if (inProcessChannel != NULL)
+			inProcessSend(inProcessChannel, message, size * sizeof(T));
+		else if (isMpiCallLegal)
+			MPI_Isend(message, size, getMPIDatatype<T>(), 0, PARTITION_TAG, server, request);
+	}
+
+	/***********************************************************************************************
+	 * \brief Template function for starting a non-blocking receive of the partition of this
+	 *        process, the counterpart of sendPartitionToServer
+	 * \param[in] size is the length of the message
+	 * \param[out] message is a pointer to the message which is going to be received
+	 * \param[out] request is the request of the receive
+	 ***********/
+	template<class T> void receivePartitionFromServer(int size, T* message, MPI_Request *request) {
+		*request = MPI_REQUEST_NULL;
+		if (inProcessChannel != NULL)
+			inProcessReceive(inProcessChannel, message, size * sizeof(T));
+		else if (isMpiCallLegal)
+			MPI_Irecv(message, size, getMPIDatatype<T>(), 0, PARTITION_TAG, server, request);
+	}
+
+	/***********************************************************************************************
+	 * \brief Wait until all requests of non-blocking calls are completed
+	 * \param[in] count is the number of requests
+	 * \param[in/out] requests are the requests
+	 ***********/
+	void waitForAllRequests(int count, MPI_Request *requests);
+
+	/***********************************************************************************************
+	 * \brief Start sending a data field by the shared memory segment, the persistent request,
+	 *        the wire format, the chunk size or the skipping of unchanged values bound to its
+	 *        name, at its first transfer with its size as header. The data field must not be modified until finishDataFieldTransfers is
+	 *        called
+	 * \param[in] name is the name of the data field
+	 * \param[in] size is the length of the data field
+	 * \param[in] dataField is the data field
+	 ***********/
+	void startSendDataField(const std::string &name, int size, double* dataField);
+
+	/***********************************************************************************************
+	 * \brief Start receiving a data field, the counterpart of startSendDataField. If unchanged
+	 *        values are skipped, the Emperor sends them as an empty message and the values are
+	 *        kept
+	 * \param[in] name is the name of the data field
+	 * \param[in] size is the length of the data field
+	 * \param[out] dataField is the data field, valid after finishDataFieldTransfers
+	 * \param[in] receivedHeader the size header if it is already received, e.g. together with the
+	 *            convergence signal, NULL to receive it here
+	 ***********/
+	void startReceiveDataField(const std::string &name, int size, double* dataField,
+			const int *receivedHeader = NULL);
+
+	/***********************************************************************************************
+	 * \brief Complete all data field transfers started, in the order they were started. After the
+	 *        first transfer of a data field, its shared memory segment or persistent request is set
+	 *        up here
+	 ***********/
+	void finishDataFieldTransfers();
+
 private:
+	/// A persistent request and the buffer it is bound to
+	struct PersistentRequest {
+		MPI_Request request;
+		double *buffer;
+		int size;
+	};
+	/// Name of data field <=> persistent send request
+	std::map<std::string, PersistentRequest> persistentSends;
+	/// Name of data field <=> persistent receive request
+	std::map<std::string, PersistentRequest> persistentReceives;
+	/***********************************************************************************************
+	 * \brief Free all requests of the map
+	 * \param[in/out] requests the persistent requests
+	 ***********/
+	void freePersistentRequests(std::map<std::string, PersistentRequest> &requests);
+	/// The header of a shared memory segment, the same layout as SharedMemorySegment::Header of
+	/// the Emperor, followed by the data field
+	struct SharedMemoryHeader {
+		int token;
+		int size;
+		volatile int numWritten;
+		volatile int numRead;
+	};
+	/// A shared memory segment mapped by the client
+	struct SharedMemorySegment {
+		SharedMemoryHeader *header;
+		size_t numBytes;
+	};
+	/// Name of data field <=> segment, which the client writes into
+	std::map<std::string, SharedMemorySegment> sharedMemorySends;
+	/// Name of data field <=> segment, which the client reads from
+	std::map<std::string, SharedMemorySegment> sharedMemoryReceives;
+	/***********************************************************************************************
+	 * \brief Receive the name of the segment offered by the Emperor and try to map it
+	 * \param[in] size size of the data field
+	 * \param[out] segment the mapped segment
+	 * \return true if the segment is mapped
+	 ***********/
+	bool mapSharedMemorySegment(int size, SharedMemorySegment &segment);
+	/***********************************************************************************************
+	 * \brief Unmap all segments of the map
+	 * \param[in] segments the segments
+	 ***********/
+	void unmapSharedMemorySegments(std::map<std::string, SharedMemorySegment> &segments);
+	/// The encoding of a data field in one direction, see DataFieldCodec
+	struct EncodedDataField {
+		int wireFormat;
+		std::vector<unsigned char> buffer;
+		std::vector<double> history;
+	};
+	/// Name of data field <=> encoding of its sends
+	std::map<std::string, EncodedDataField> encodedSends;
+	/// Name of data field <=> encoding of its receives
+	std::map<std::string, EncodedDataField> encodedReceives;
+	/// A data field in a transfer started but not finished
+	struct PendingDataField {
+		std::string name;
+		int size;
+		double *dataField;
+		bool isSend;
+		/// how the data field is transferred
+		enum {
+			PERSISTENT_TRANSFER, ENCODED_TRANSFER, FIRST_TRANSFER, CHUNKED_TRANSFER,
+			SKIP_UNCHANGED_TRANSFER
+		} transfer;
+		/// the size header, or the number of bytes if encoded
+		int header;
+		MPI_Request requests[2];
+		/// the requests of the chunks of a chunked transfer, which follow the size header
+		std::vector<MPI_Request> chunkRequests;
+	};
+	/// Name of data field <=> values last sent, only of the data fields whose unchanged values are
+	/// skipped
+	std::map<std::string, std::vector<double> > lastSentDataFields;
+	/// Data fields in a transfer, a list keeps the headers at fixed addresses
+	std::list<PendingDataField> pendingDataFields;
+	/// Whether a pending data field is offered a shared memory segment when it is finished. The
+	/// Emperor completes such a transfer before any other, so it is never pending with others
+	bool isSharedMemoryOfferPending;
+	/***********************************************************************************************
+	 * \brief Add a data field to the pending ones
+	 * \param[in] name is the name of the data field
+	 * \param[in] size is the length of the data field
+	 * \param[in] dataField is the data field
+	 * \param[in] isSend true if the data field is sent
+	 * \param[in] isFirstTransfer true if it is the first transfer of the data field
+	 * \return the pending data field
+	 ***********/
+	PendingDataField &addPendingDataField(const std::string &name, int size, double* dataField,
+			bool isSend, bool isFirstTransfer);
+	/***********************************************************************************************
+	 * \brief Post the chunks of a chunked transfer after its size header, every chunk is a message
+	 *        of its own. The Emperor matches them in order
+	 * \param[in/out] pending the pending data field
+	 * \param[in] chunkSize the number of values of a chunk, the last one may be shorter
+	 ***********/
+	void postDataFieldChunks(PendingDataField &pending, int chunkSize);
+	/***********************************************************************************************
+	 * \brief Post the receive of the size header of a data field, or take the one already received
+	 * \param[in/out] pending the pending data field
+	 * \param[in] receivedHeader the size header if it is already received, NULL to post the receive
+	 ***********/
+	void receiveSizeHeader(PendingDataField &pending, const int *receivedHeader);
+	/***********************************************************************************************
+	 * \brief Write a data field into the shared memory segment bound to its name
+	 * \param[in] name is the name of the data field
+	 * \param[in] size is the length of the data field
+	 * \param[in] dataField is the data field
+	 * \return false if no segment is bound to the name
+	 ***********/
+	bool writeSharedMemorySegment(const std::string &name, int size, double* dataField);
+	/***********************************************************************************************
+	 * \brief Read a data field from the shared memory segment bound to its name
+	 * \param[in] name is the name of the data field
+	 * \param[in] size is the length of the data field
+	 * \param[out] dataField is the data field
+	 * \return false if no segment is bound to the name
+	 ***********/
+	bool readSharedMemorySegment(const std::string &name, int size, double* dataField);
+	/***********************************************************************************************
+	 * \brief Start the persistent request bound to the name of a data field, which is rebound if
+	 *        the buffer has changed
+	 * \param[in/out] requests the persistent requests of one direction
+	 * \param[in] isSend true if the requests are sends
+	 * \param[in] name is the name of the data field
+	 * \param[in] size is the length of the data field
+	 * \param[in] dataField is the data field
+	 * \return false if no request is bound to the name
+	 ***********/
+	bool startPersistentRequest(std::map<std::string, PersistentRequest> &requests, bool isSend,
+			const std::string &name, int size, double* dataField);
+	/***********************************************************************************************
+	 * \brief Bind a persistent send request to the data field after its first transfer, if the
+	 *        persistent data field transfer is enabled
+	 * \param[in] name is the name of the data field
+	 * \param[in] size is the length of the message
+	 * \param[in] message is a pointer to the message
+	 ***********/
+	void initPersistentSend(const std::string &name, int size, double* message);
+	/***********************************************************************************************
+	 * \brief Bind a persistent receive request to the data field after its first transfer, if the
+	 *        persistent data field transfer is enabled
+	 * \param[in] name is the name of the data field
+	 * \param[in] size is the length of the message
+	 * \param[out] message is a pointer to the message
+	 ***********/
+	void initPersistentReceive(const std::string &name, int size, double* message);
+	/***********************************************************************************************
+	 * \brief Map the shared memory segment offered by the Emperor after the first send of a data
+	 *        field, which then replaces the persistent request
+	 * \param[in] name name of the data field
+	 * \param[in] size size of the data field
+	 * \return true if the segment is mapped, false if the Emperor runs on another node or the
+	 *         shared memory transfer is disabled
+	 ***********/
+	bool initSharedMemorySend(const std::string &name, int size);
+	/***********************************************************************************************
+	 * \brief Map the shared memory segment offered by the Emperor after the first receive of a
+	 *        data field
+	 * \param[in] name name of the data field
+	 * \param[in] size size of the data field
+	 * \return true if the segment is mapped
+	 ***********/
+	bool initSharedMemoryReceive(const std::string &name, int size);
+	/***********************************************************************************************
+	 * \brief Get the encoding of a data field, which is set up at its first transfer
+	 * \param[in/out] encodings the encodings of one direction
+	 * \param[in] name name of the data field
+	 * \param[in] size size of the data field
+	 * \return the encoding, NULL if the data field is transferred as float64
+	 ***********/
+	EncodedDataField *getEncodedDataField(std::map<std::string, EncodedDataField> &encodings,
+			const std::string &name, int size);
+	/// tag of the messages exchanged by the first process with the Emperor
+	static const int DEFAULT_TAG = 0;
+	/// tag of the partitions of a partitioned mesh and its data fields, see the Emperor
+	static const int PARTITION_TAG = 1;
+	/// size header of a data field whose values are skipped as they have not changed, see the
+	/// Emperor
+	static const int UNCHANGED_DATA_FIELD = -1;
 	/// This holds a intercommunicator to the server
 	MPI_Comm server;
 	/// MPI status for the MPI calls
@@ -146,6 +442,35 @@ private:
 	static ClientCommunication* clientComm;
 	/// The Rank of the current process
     int myRank;
+	/// The channel of an Emperor running in the same process, NULL if connected by MPI
+	static void *inProcessChannel;
+	/// Copies a message to the in-process Emperor
+	static void (*inProcessSend)(void *channel, const void *message, int numBytes);
+	/// Copies a message from the in-process Emperor
+	static void (*inProcessReceive)(void *channel, void *message, int numBytes);
+
+	/***********************************************************************************************
+	 * \brief Return the MPI datatype of T
+	 * \return the MPI datatype
+	 ***********/
+	template<class T> static MPI_Datatype getMPIDatatype() {
+		if (typeid(T) == typeid(int)) {
+			return MPI_INT;
+		} else if (typeid(T) == typeid(double)) {
+			return MPI_DOUBLE;
+		} else if (typeid(T) == typeid(float)) {
+			return MPI_FLOAT;
+		} else if (typeid(T) == typeid(unsigned char)) {
+			return MPI_UNSIGNED_CHAR;
+		} else if (typeid(T) == typeid(long double)) {
+			return MPI_LONG_DOUBLE;
+		} else if (typeid(T) == typeid(short)) {
+			return MPI_SHORT;
+		} else if (typeid(T) == typeid(char)) {
+			return MPI_CHAR;
+		}
+		return MPI_DATATYPE_NULL;
+	}
 
 	/***********************************************************************************************
 	 * \brief disallow public constructor
@@ -23,6 +23,7 @@
 #include <iostream>
 #include <algorithm>
 #include "ClientMetaDatabase.h"
+#include "EMPIRE_API_Enum.h"
 #include "ticpp.h"
 using namespace std;
 using namespace ticpp;
@@ -54,6 +55,11 @@ ClientMetaDatabase::ClientMetaDatabase(char *inputFileName) {
         fillServerPortFile();
         fillVerbosity();
         fillrunTimeModifiableUserDefinedText();
+        fillPersistentDataFieldTransfer();
+        fillSharedMemoryDataFieldTransfer();
+        fillDataFieldWireFormats();
+        fillDataFieldChunkSizes();
+        fillDataFieldSkipUnchanged();
     } catch (ticpp::Exception& ex) {
         cerr << "ERROR Parser: " << ex.what() << endl;
         exit (EXIT_FAILURE);
@@ -129,6 +135,140 @@ void ClientMetaDatabase::fillrunTimeModifiableUserDefinedText() {
     cout << "EMPIRE_INFO: runTimeModifiableUserDefinedText is enabled." << endl;
 }
 
+void ClientMetaDatabase::fillPersistentDataFieldTransfer() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "persistentDataFieldTransfer", false);
+    persistentDataFieldTransfer = false;
+    if (pXMLElement == NULL)
+        return;
+    if (CompareStringInsensitive(pXMLElement->GetText(false), "YES")) {
+        persistentDataFieldTransfer = true;
+        cout << "EMPIRE_INFO: persistentDataFieldTransfer is enabled." << endl;
+    }
+}
+
+bool ClientMetaDatabase::isPersistentDataFieldTransfer() {
+    return persistentDataFieldTransfer;
+}
+
+void ClientMetaDatabase::fillSharedMemoryDataFieldTransfer() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "sharedMemoryDataFieldTransfer", false);
+    sharedMemoryDataFieldTransfer = false;
+    if (pXMLElement == NULL)
+        return;
+    if (CompareStringInsensitive(pXMLElement->GetText(false), "YES")) {
+        sharedMemoryDataFieldTransfer = true;
+        cout << "EMPIRE_INFO: sharedMemoryDataFieldTransfer is enabled." << endl;
+    }
+}
+
+bool ClientMetaDatabase::isSharedMemoryDataFieldTransfer() {
+    return sharedMemoryDataFieldTransfer;
+}
+
+void ClientMetaDatabase::fillDataFieldWireFormats() {
+    Element *general = inputFile->FirstChildElement()->FirstChildElement("general");
+    Iterator<Element> pXMLElement("dataFieldWireFormat");
+    for (pXMLElement = pXMLElement.begin(general); pXMLElement != pXMLElement.end();
+            pXMLElement++) {
+        string dataFieldName = pXMLElement->GetAttribute("dataFieldName");
+        string wireFormat = pXMLElement->GetText(false);
+        if (CompareStringInsensitive(wireFormat, "float64"))
+            continue;
+        else if (CompareStringInsensitive(wireFormat, "float32"))
+            dataFieldWireFormats[dataFieldName] = EMPIRE_DataField_float32;
+        else if (CompareStringInsensitive(wireFormat, "lossless"))
+            dataFieldWireFormats[dataFieldName] = EMPIRE_DataField_lossless;
+        else if (CompareStringInsensitive(wireFormat, "deltaLossless"))
+            dataFieldWireFormats[dataFieldName] = EMPIRE_DataField_deltaLossless;
+        else {
+            cerr << "ERROR Parser: unknown wire format " << wireFormat << " of data field "
+                    << dataFieldName << endl;
+            exit (EXIT_FAILURE);
+        }
+        cout << "EMPIRE_INFO: data field " << dataFieldName << " is transferred as " << wireFormat
+                << "." << endl;
+    }
+}
+
+void ClientMetaDatabase::fillDataFieldChunkSizes() {
+    Element *general = inputFile->FirstChildElement()->FirstChildElement("general");
+    Iterator<Element> pXMLElement("dataFieldChunkSize");
+    for (pXMLElement = pXMLElement.begin(general); pXMLElement != pXMLElement.end();
+            pXMLElement++) {
+        string dataFieldName = pXMLElement->GetAttribute("dataFieldName");
+        int chunkSize = 0;
+        pXMLElement->GetText(&chunkSize);
+        if (chunkSize < 0) {
+            cerr << "ERROR Parser: negative chunk size of data field " << dataFieldName << endl;
+            exit (EXIT_FAILURE);
+        }
+        if (chunkSize == 0)
+            continue;
+        if (getDataFieldWireFormat(dataFieldName) != EMPIRE_DataField_float64) {
+            cerr << "ERROR Parser: data field " << dataFieldName
+                    << " cannot be transferred both encoded and in chunks" << endl;
+            exit (EXIT_FAILURE);
+        }
+        dataFieldChunkSizes[dataFieldName] = chunkSize;
+        cout << "EMPIRE_INFO: data field " << dataFieldName << " is transferred in chunks of "
+                << chunkSize << " values." << endl;
+    }
+}
+
+int ClientMetaDatabase::getDataFieldChunkSize(const string &dataFieldName) {
+    map<string, int>::iterator it = dataFieldChunkSizes.find(dataFieldName);
+    if (it == dataFieldChunkSizes.end())
+        return 0;
+    return it->second;
+}
+
+void ClientMetaDatabase::fillDataFieldSkipUnchanged() {
+    Element *general = inputFile->FirstChildElement()->FirstChildElement("general");
+    Iterator<Element> pXMLElement("dataFieldSkipUnchanged");
+    for (pXMLElement = pXMLElement.begin(general); pXMLElement != pXMLElement.end();
+            pXMLElement++) {
+        string dataFieldName = pXMLElement->GetAttribute("dataFieldName");
+        if (!CompareStringInsensitive(pXMLElement->GetText(false), "YES"))
+            continue;
+        double tolerance = 0.0;
+        pXMLElement->GetAttributeOrDefault<double, double>("tolerance", &tolerance, 0.0);
+        if (tolerance < 0.0) {
+            cerr << "ERROR Parser: negative tolerance of data field " << dataFieldName << endl;
+            exit (EXIT_FAILURE);
+        }
+        if (getDataFieldWireFormat(dataFieldName) != EMPIRE_DataField_float64
+                || getDataFieldChunkSize(dataFieldName) > 0) {
+            cerr << "ERROR Parser: data field " << dataFieldName
+                    << " cannot skip unchanged values if it is encoded or transferred in chunks"
+                    << endl;
+            exit (EXIT_FAILURE);
+        }
+        dataFieldSkipUnchanged[dataFieldName] = tolerance;
+        cout << "EMPIRE_INFO: data field " << dataFieldName
+                << " skips unchanged values, tolerance " << tolerance << "." << endl;
+    }
+}
+
+bool ClientMetaDatabase::isDataFieldSkipUnchanged(const string &dataFieldName,
+        double &tolerance) {
+    map<string, double>::iterator it = dataFieldSkipUnchanged.find(dataFieldName);
+    if (it == dataFieldSkipUnchanged.end())
+        return false;
+    tolerance = it->second;
+    return true;
+}
+
+int ClientMetaDatabase::getDataFieldWireFormat(const string &dataFieldName) {
+    map<string, int>::iterator it = dataFieldWireFormats.find(dataFieldName);
+    if (it == dataFieldWireFormats.end())
+        return EMPIRE_DataField_float64;
+    return it->second;
+}
+
 bool ClientMetaDatabase::CompareStringInsensitive(string strFirst, string strSecond) {
     /// Convert both strings to upper case by transfrom() before compare.
     std::transform(strFirst.begin(), strFirst.end(), strFirst.begin(), ::toupper);
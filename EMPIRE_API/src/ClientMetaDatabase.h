@@ -69,6 +69,50 @@ public:
 	 * \author Stefan Sicklinger
 	 ***********/
 	std::string getClientName();
+	/***********************************************************************************************
+	 * \brief Return whether data fields are transferred by persistent requests after the first
+	 *        transfer, i.e. without the size header. The Emperor must use the same setting
+	 *
+	 * \return true if the persistent transfer is enabled
+	 ***********/
+	bool isPersistentDataFieldTransfer();
+	/***********************************************************************************************
+	 * \brief Return whether data fields are transferred through shared memory when the client
+	 *        runs on the node of the Emperor. The Emperor must use the same setting
+	 *
+	 * \return true if the shared memory transfer is enabled
+	 ***********/
+	bool isSharedMemoryDataFieldTransfer();
+	/***********************************************************************************************
+	 * \brief Return the wire format of a data field, a value of EMPIRE_DataField_wireFormat.
+	 *        The Emperor must use the same format at all connections of the data field
+	 *
+	 * \param[in] dataFieldName name of the data field
+	 * \return the wire format, EMPIRE_DataField_float64 if none is given
+	 ***********/
+	int getDataFieldWireFormat(const std::string &dataFieldName);
+	/***********************************************************************************************
+	 * \brief Return the chunk size of a data field. A data field with a chunk size is transferred
+	 *        as consecutive messages of at most that many values, such that the Emperor maps the
+	 *        chunks which have arrived while the others are in transfer. The Emperor must use the
+	 *        same chunk size at all connections of the data field
+	 *
+	 * \param[in] dataFieldName name of the data field
+	 * \return the number of values of a chunk, 0 if the data field is transferred at once
+	 ***********/
+	int getDataFieldChunkSize(const std::string &dataFieldName);
+	/***********************************************************************************************
+	 * \brief Return whether the unchanged values of a data field are skipped. A send then
+	 *        transfers only a flag if the values have not changed by more than the tolerance since
+	 *        the last send, and a receive keeps the values if the Emperor sends the flag. The
+	 *        Emperor must skip the unchanged values of the data field as well
+	 *
+	 * \param[in] dataFieldName name of the data field
+	 * \param[out] tolerance the relative change in the 2-norm up to which the values of a send are
+	 *             unchanged, 0 to skip only bit-identical values
+	 * \return true if the unchanged values are skipped
+	 ***********/
+	bool isDataFieldSkipUnchanged(const std::string &dataFieldName, double &tolerance);
 
 	std::string getUserDefinedText(std::string elementName);
 private:
@@ -118,6 +162,26 @@ private:
      * \author Stefan Sicklinger
      ***********/
     void fillrunTimeModifiableUserDefinedText();
+    /***********************************************************************************************
+     * \brief Fill persistentDataFieldTransfer
+     ***********/
+    void fillPersistentDataFieldTransfer();
+    /***********************************************************************************************
+     * \brief Fill sharedMemoryDataFieldTransfer
+     ***********/
+    void fillSharedMemoryDataFieldTransfer();
+    /***********************************************************************************************
+     * \brief Fill dataFieldWireFormats
+     ***********/
+    void fillDataFieldWireFormats();
+    /***********************************************************************************************
+     * \brief Fill dataFieldChunkSizes
+     ***********/
+    void fillDataFieldChunkSizes();
+    /***********************************************************************************************
+     * \brief Fill dataFieldSkipUnchanged
+     ***********/
+    void fillDataFieldSkipUnchanged();
     /***********************************************************************************************
      * \brief Compare two string case insensitive
      * \return true or false
@@ -134,6 +198,16 @@ private:
 	std::string clientName;
 	///boolean ifgetUserDefinedText is runTimeModifiable
 	bool runTimeModifiableUserDefinedText;
+	/// whether data fields are transferred by persistent requests after the first transfer
+	bool persistentDataFieldTransfer;
+	/// whether data fields are transferred through shared memory on the node of the Emperor
+	bool sharedMemoryDataFieldTransfer;
+	/// name of data field <=> wire format, only the ones other than float64
+	std::map<std::string, int> dataFieldWireFormats;
+	/// name of data field <=> chunk size, only the ones transferred in chunks
+	std::map<std::string, int> dataFieldChunkSizes;
+	/// name of data field <=> tolerance, only the ones whose unchanged values are skipped
+	std::map<std::string, double> dataFieldSkipUnchanged;
     /// verbosity
     std::string verbosity;
 };
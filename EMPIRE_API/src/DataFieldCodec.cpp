@@ -0,0 +1,131 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include "DataFieldCodec.h"
+
+namespace EMPIRE {
+
+/// values of EMPIRE_DataField_wireFormat, the EMPIRE API does not know EMPEROR_Enum.h
+const int WIRE_FORMAT_FLOAT64 = 0;
+const int WIRE_FORMAT_FLOAT32 = 1;
+const int WIRE_FORMAT_LOSSLESS = 2;
+const int WIRE_FORMAT_DELTA_LOSSLESS = 3;
+
+/***********************************************************************************************
+ * \brief Get the bit pattern of a double
+ ***********/
+static inline uint64_t toBits(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/***********************************************************************************************
+ * \brief Get the double of a bit pattern
+ ***********/
+static inline double fromBits(uint64_t bits) {
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int DataFieldCodec::getMaxEncodedSize(int wireFormat, int size) {
+    if (wireFormat == WIRE_FORMAT_FLOAT32)
+        return size * sizeof(float);
+    if (wireFormat == WIRE_FORMAT_LOSSLESS || wireFormat == WIRE_FORMAT_DELTA_LOSSLESS)
+        return (size + 1) / 2 + size * sizeof(double);
+    return size * sizeof(double);
+}
+
+int DataFieldCodec::encode(int wireFormat, int size, const double *data, double *history,
+        unsigned char *encoded) {
+    if (wireFormat == WIRE_FORMAT_FLOAT32) {
+        float *values = reinterpret_cast<float*>(encoded);
+        for (int i = 0; i < size; i++)
+            values[i] = (float) data[i];
+        return size * sizeof(float);
+    }
+    if (wireFormat == WIRE_FORMAT_FLOAT64) {
+        memcpy(encoded, data, size * sizeof(double));
+        return size * sizeof(double);
+    }
+    // the byte counts of two values share a byte, the significant bytes follow all counts
+    unsigned char *numBytesOfValues = encoded;
+    memset(numBytesOfValues, 0, (size + 1) / 2);
+    unsigned char *bytes = encoded + (size + 1) / 2;
+    uint64_t previous = 0;
+    for (int i = 0; i < size; i++) {
+        uint64_t bits = toBits(data[i]);
+        uint64_t residual;
+        if (wireFormat == WIRE_FORMAT_DELTA_LOSSLESS) {
+            residual = bits ^ toBits(history[i]);
+            history[i] = data[i];
+        } else {
+            residual = bits ^ previous;
+            previous = bits;
+        }
+        // the leading bytes of the residual are zero if the prediction is close
+        int numBytes = 0;
+        for (uint64_t rest = residual; rest != 0; rest >>= 8)
+            bytes[numBytes++] = (unsigned char) (rest & 0xFF);
+        bytes += numBytes;
+        numBytesOfValues[i / 2] |= (unsigned char) (numBytes << (4 * (i % 2)));
+    }
+    return bytes - encoded;
+}
+
+void DataFieldCodec::decode(int wireFormat, int size, const unsigned char *encoded, int numBytes,
+        double *history, double *data) {
+    if (wireFormat == WIRE_FORMAT_FLOAT32) {
+        assert(numBytes == size * (int) sizeof(float));
+        const float *values = reinterpret_cast<const float*>(encoded);
+        for (int i = 0; i < size; i++)
+            data[i] = values[i];
+        return;
+    }
+    if (wireFormat == WIRE_FORMAT_FLOAT64) {
+        assert(numBytes == size * (int) sizeof(double));
+        memcpy(data, encoded, size * sizeof(double));
+        return;
+    }
+    const unsigned char *numBytesOfValues = encoded;
+    const unsigned char *bytes = encoded + (size + 1) / 2;
+    uint64_t previous = 0;
+    for (int i = 0; i < size; i++) {
+        int numBytesOfValue = (numBytesOfValues[i / 2] >> (4 * (i % 2))) & 0xF;
+        uint64_t residual = 0;
+        for (int k = 0; k < numBytesOfValue; k++)
+            residual |= ((uint64_t) bytes[k]) << (8 * k);
+        bytes += numBytesOfValue;
+        if (wireFormat == WIRE_FORMAT_DELTA_LOSSLESS) {
+            data[i] = fromBits(residual ^ toBits(history[i]));
+            history[i] = data[i];
+        } else {
+            previous ^= residual;
+            data[i] = fromBits(previous);
+        }
+    }
+    assert(bytes - encoded == numBytes);
+}
+
+} /* namespace EMPIRE */
@@ -24,11 +24,16 @@
 #include <assert.h>
 #include <string.h>
 #include <iostream>
+#include <algorithm>
 #include "EMPIRE_API.h"
 using namespace std;
 
 namespace EMPIRE {
 
+/// a size header which carries a non-convergence signal is NON_CONVERGENT_HEADER - header, see
+/// the Emperor
+static const int NON_CONVERGENT_HEADER = -2;
+
 Empire::Empire() {
 
 }
@@ -56,17 +61,58 @@ void Empire::disconnect() {
 
 void Empire::sendMesh(int numNodes, int numElems, double *nodes, int *nodeIDs, int *numNodesPerElem,
         int *elems) {
-    const int BUFFER_SIZE = 2;
+    const int BUFFER_SIZE = 3;
+    const int DIMENSION = 3;
+    int count = 0;
+    for (int i = 0; i < numElems; i++)
+        count += numNodesPerElem[i];
+    int meshInfo[BUFFER_SIZE] = { numNodes, numElems, count };
+    ClientCommunication *clientComm = ClientCommunication::getSingleton();
+    clientComm->sendToServerBlocking<int>(BUFFER_SIZE, meshInfo);
+    // the Emperor has posted the receives of all arrays after the header
+    MPI_Request requests[4];
+    int numRequests = 0;
+    clientComm->sendToServerNonBlocking<double>(numNodes * DIMENSION, nodes,
+            &requests[numRequests++]);
+    clientComm->sendToServerNonBlocking<int>(numNodes, nodeIDs, &requests[numRequests++]);
+    clientComm->sendToServerNonBlocking<int>(numElems, numNodesPerElem, &requests[numRequests++]);
+    if (count > 0)
+        clientComm->sendToServerNonBlocking<int>(count, elems, &requests[numRequests++]);
+    clientComm->waitForAllRequests(numRequests, requests);
+}
+
+void Empire::sendMeshCoordinates(int numNodes, double *nodes) {
+    const int DIMENSION = 3;
+    ClientCommunication *clientComm = ClientCommunication::getSingleton();
+    clientComm->sendToServerBlocking<int>(1, &numNodes);
+    clientComm->sendToServerBlocking<double>(numNodes * DIMENSION, nodes);
+}
+
+void Empire::sendMeshPartitioned(int numNodes, int numElems, double *nodes, int *nodeIDs,
+        int *numNodesPerElem, int *elems) {
+    const int BUFFER_SIZE = 3;
     const int DIMENSION = 3;
-    int meshInfo[BUFFER_SIZE] = { numNodes, numElems };
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(BUFFER_SIZE, meshInfo);
-    ClientCommunication::getSingleton()->sendToServerBlocking<double>(numNodes * DIMENSION, nodes);
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(numNodes, nodeIDs);
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(numElems, numNodesPerElem);
     int count = 0;
     for (int i = 0; i < numElems; i++)
         count += numNodesPerElem[i];
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(count, elems);
+    int meshInfo[BUFFER_SIZE] = { numNodes, numElems, count };
+    ClientCommunication *clientComm = ClientCommunication::getSingleton();
+    // the Emperor posts the receives of the arrays after the headers of all processes, an empty
+    // array is not sent
+    MPI_Request requests[5];
+    int numRequests = 0;
+    clientComm->sendPartitionToServer<int>(BUFFER_SIZE, meshInfo, &requests[numRequests++]);
+    if (numNodes > 0) {
+        clientComm->sendPartitionToServer<double>(numNodes * DIMENSION, nodes,
+                &requests[numRequests++]);
+        clientComm->sendPartitionToServer<int>(numNodes, nodeIDs, &requests[numRequests++]);
+    }
+    if (numElems > 0)
+        clientComm->sendPartitionToServer<int>(numElems, numNodesPerElem,
+                &requests[numRequests++]);
+    if (count > 0)
+        clientComm->sendPartitionToServer<int>(count, elems, &requests[numRequests++]);
+    clientComm->waitForAllRequests(numRequests, requests);
 }
 
 void Empire::sendSectionMesh(int numNodes, int numElems, double *nodes, int *nodeIDs,
@@ -109,10 +155,32 @@ void Empire::recvMesh(int *numNodes, int *numElems, double **nodes, int **nodeID
     ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(count, *elems);
 }
 
+void Empire::recvMesh(int maxNumNodes, int maxNumElems, int maxSizeOfElems, int *numNodes,
+        int *numElems, double *nodes, int *nodeIDs, int *numNodesPerElem, int *elems) {
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(1, numNodes);
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(1, numElems);
+    assert(*numNodes <= maxNumNodes);
+    assert(*numElems <= maxNumElems);
+    const int DIMENSION = 3;
+
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<double>((*numNodes) * DIMENSION,
+            nodes);
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<int>((*numNodes), nodeIDs);
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<int>((*numElems),
+            numNodesPerElem);
+    int count = 0;
+    for (int i = 0; i < *numElems; i++)
+        count += numNodesPerElem[i];
+    assert(count <= maxSizeOfElems);
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(count, elems);
+}
+
 void Empire::sendIGAMesh(int _numPatches, int _numNodes) {
     const int BUFFER_SIZE = 2;
     int meshInfo[BUFFER_SIZE] = { _numPatches, _numNodes };
     ClientCommunication::getSingleton()->sendToServerBlocking<int>(BUFFER_SIZE, meshInfo);
+    igaPatchInts.clear();
+    igaPatchDoubles.clear();
 }
 
 void Empire::sendIGAPatch(int _pDegree, int _uNumKnots, double* _uKnotVector, int _qDegree,
@@ -121,39 +189,51 @@ void Empire::sendIGAPatch(int _pDegree, int _uNumKnots, double* _uKnotVector, in
     const int BUFFER_SIZE = 6;
     int meshInfo[BUFFER_SIZE] = { _pDegree, _uNumKnots, _qDegree, _vNumKnots, _uNumControlPoints,
             _vNumControlPoints };
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(BUFFER_SIZE, meshInfo);
-    ClientCommunication::getSingleton()->sendToServerBlocking<double>(_uNumKnots, _uKnotVector);
-    ClientCommunication::getSingleton()->sendToServerBlocking<double>(_vNumKnots, _vKnotVector);
-    ClientCommunication::getSingleton()->sendToServerBlocking<double>(
-            _uNumControlPoints * _vNumControlPoints * 4, _cpNet);
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(
-            _uNumControlPoints * _vNumControlPoints, _nodeNet);
+    igaPatchInts.insert(igaPatchInts.end(), meshInfo, meshInfo + BUFFER_SIZE);
+    igaPatchDoubles.insert(igaPatchDoubles.end(), _uKnotVector, _uKnotVector + _uNumKnots);
+    igaPatchDoubles.insert(igaPatchDoubles.end(), _vKnotVector, _vKnotVector + _vNumKnots);
+    igaPatchDoubles.insert(igaPatchDoubles.end(), _cpNet,
+            _cpNet + _uNumControlPoints * _vNumControlPoints * 4);
+    igaPatchInts.insert(igaPatchInts.end(), _nodeNet,
+            _nodeNet + _uNumControlPoints * _vNumControlPoints);
 }
 
 void Empire::sendIGATrimmingInfo(int _isTrimmed, int _numLoops) {
     const int BUFFER_SIZE = 2;
     int trimInfo[BUFFER_SIZE] = { _isTrimmed, _numLoops };
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(BUFFER_SIZE, trimInfo);
-
+    igaPatchInts.insert(igaPatchInts.end(), trimInfo, trimInfo + BUFFER_SIZE);
 }
 
 void Empire::sendIGATrimmingLoopInfo(int _inner, int _numCurves) {
     const int BUFFER_SIZE = 2;
     int trimInfo[BUFFER_SIZE] = { _inner, _numCurves };
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(BUFFER_SIZE, trimInfo);
+    igaPatchInts.insert(igaPatchInts.end(), trimInfo, trimInfo + BUFFER_SIZE);
 }
 
 void Empire::sendIGATrimmingCurve(int _direction, int _pDegree, int _uNumKnots,
         double* _uKnotVector, int _uNumControlPoints, double* _cpNet) {
     const int BUFFER_SIZE = 4;
     int trimInfo[BUFFER_SIZE] = { _direction, _pDegree, _uNumKnots, _uNumControlPoints };
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(BUFFER_SIZE, trimInfo);
-    ClientCommunication::getSingleton()->sendToServerBlocking<double>(_uNumKnots, _uKnotVector);
-    ClientCommunication::getSingleton()->sendToServerBlocking<double>(_uNumControlPoints * 4,
-            _cpNet);
+    igaPatchInts.insert(igaPatchInts.end(), trimInfo, trimInfo + BUFFER_SIZE);
+    igaPatchDoubles.insert(igaPatchDoubles.end(), _uKnotVector, _uKnotVector + _uNumKnots);
+    igaPatchDoubles.insert(igaPatchDoubles.end(), _cpNet, _cpNet + _uNumControlPoints * 4);
 }
 
 void Empire::sendIGANumDirichletConditions(int _numDirichletConditions){
+    // the Dirichlet conditions follow the last patch, so the packed patches are complete
+    if (!igaPatchInts.empty()) {
+        ClientCommunication *clientComm = ClientCommunication::getSingleton();
+        int packInfo[2] = { (int) igaPatchInts.size(), (int) igaPatchDoubles.size() };
+        clientComm->sendToServerBlocking<int>(2, packInfo);
+        igaPatchDoubles.push_back(0.0); // the buffer must exist even without doubles
+        MPI_Request requests[2];
+        clientComm->sendToServerNonBlocking<int>(packInfo[0], &igaPatchInts[0], &requests[0]);
+        clientComm->sendToServerNonBlocking<double>(packInfo[1], &igaPatchDoubles[0],
+                &requests[1]);
+        clientComm->waitForAllRequests(2, requests);
+        igaPatchInts.clear();
+        igaPatchDoubles.clear();
+    }
     ClientCommunication::getSingleton()->sendToServerBlocking<int>(1,&_numDirichletConditions);
 }
 
@@ -236,16 +316,137 @@ void Empire::sendIGADirichletDofs(int numberOfClampedDofs, int* clampedDofs, int
     ClientCommunication::getSingleton()->sendToServerBlocking<int>(numberOfClampedDofs, clampedDofs);
 }
 
-void Empire::sendDataField(int sizeOfArray, double *dataField) {
-    ClientCommunication::getSingleton()->sendToServerBlocking<int>(1, &sizeOfArray);
-    ClientCommunication::getSingleton()->sendToServerBlocking<double>(sizeOfArray, dataField);
+void Empire::sendDataField(char *name, int sizeOfArray, double *dataField) {
+    ClientCommunication::getSingleton()->startSendDataField(name, sizeOfArray, dataField);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
 }
 
-void Empire::recvDataField(int sizeOfArray, double *dataField) {
-    int sizeOfArrayRecv = 0;
-    ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(1, &sizeOfArrayRecv);
-    assert(sizeOfArray == sizeOfArrayRecv);
-    ClientCommunication::getSingleton()->receiveFromServerBlocking<double>(sizeOfArray, dataField);
+void Empire::recvDataField(char *name, int sizeOfArray, double *dataField) {
+    ClientCommunication::getSingleton()->startReceiveDataField(name, sizeOfArray, dataField);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+}
+
+int Empire::registerDataField(char *name) {
+    for (int i = 0; i < registeredDataFields.size(); i++)
+        if (registeredDataFields[i].name == name)
+            return i;
+    RegisteredDataField registered;
+    registered.name = name;
+    registered.sizeOfArray = 0;
+    registered.dataField = NULL;
+    registeredDataFields.push_back(registered);
+    return registeredDataFields.size() - 1;
+}
+
+int Empire::registerDataField(char *name, int sizeOfArray, double *dataField) {
+    int handle = registerDataField(name);
+    registeredDataFields[handle].sizeOfArray = sizeOfArray;
+    registeredDataFields[handle].dataField = dataField;
+    return handle;
+}
+
+void Empire::sendDataField(int handle, int sizeOfArray, double *dataField) {
+    assert(handle >= 0 && handle < registeredDataFields.size());
+    ClientCommunication::getSingleton()->startSendDataField(registeredDataFields[handle].name,
+            sizeOfArray, dataField);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+}
+
+void Empire::recvDataField(int handle, int sizeOfArray, double *dataField) {
+    assert(handle >= 0 && handle < registeredDataFields.size());
+    ClientCommunication::getSingleton()->startReceiveDataField(registeredDataFields[handle].name,
+            sizeOfArray, dataField);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+}
+
+void Empire::sendRegisteredDataField(int handle) {
+    assert(handle >= 0 && handle < registeredDataFields.size());
+    const RegisteredDataField &registered = registeredDataFields[handle];
+    assert(registered.dataField != NULL);
+    // the array never changes, thus a persistent request is started without rebinding
+    ClientCommunication::getSingleton()->startSendDataField(registered.name,
+            registered.sizeOfArray, registered.dataField);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+}
+
+void Empire::recvRegisteredDataField(int handle) {
+    assert(handle >= 0 && handle < registeredDataFields.size());
+    const RegisteredDataField &registered = registeredDataFields[handle];
+    assert(registered.dataField != NULL);
+    ClientCommunication::getSingleton()->startReceiveDataField(registered.name,
+            registered.sizeOfArray, registered.dataField);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+}
+
+void Empire::sendDataFieldPartitioned(char *name, int sizeOfArray, double *dataField) {
+    ClientCommunication *clientComm = ClientCommunication::getSingleton();
+    MPI_Request requests[2];
+    int numRequests = 0;
+    clientComm->sendPartitionToServer<int>(1, &sizeOfArray, &requests[numRequests++]);
+    if (sizeOfArray > 0)
+        clientComm->sendPartitionToServer<double>(sizeOfArray, dataField,
+                &requests[numRequests++]);
+    clientComm->waitForAllRequests(numRequests, requests);
+}
+
+void Empire::recvDataFieldPartitioned(char *name, int sizeOfArray, double *dataField) {
+    ClientCommunication *clientComm = ClientCommunication::getSingleton();
+    int size = -1;
+    MPI_Request requests[2];
+    int numRequests = 0;
+    clientComm->receivePartitionFromServer<int>(1, &size, &requests[numRequests++]);
+    if (sizeOfArray > 0)
+        clientComm->receivePartitionFromServer<double>(sizeOfArray, dataField,
+                &requests[numRequests++]);
+    clientComm->waitForAllRequests(numRequests, requests);
+    assert(size == sizeOfArray);
+}
+
+void Empire::sendDataFields(int numFields, char **names, int *sizesOfArrays, double **dataFields) {
+    // all data fields are in flight at once, the Emperor has posted the receives of a connection
+    for (int i = 0; i < numFields; i++)
+        ClientCommunication::getSingleton()->startSendDataField(names[i], sizesOfArrays[i],
+                dataFields[i]);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+}
+
+void Empire::recvDataFields(int numFields, char **names, int *sizesOfArrays, double **dataFields) {
+    for (int i = 0; i < numFields; i++)
+        ClientCommunication::getSingleton()->startReceiveDataField(names[i], sizesOfArrays[i],
+                dataFields[i]);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+}
+
+void Empire::isendDataField(char *name, int sizeOfArray, double *dataField) {
+    // the buffer of a data field is reused, a send of the same data field must be completed first
+    if (pendingAsyncSends.find(name) != pendingAsyncSends.end())
+        wait();
+    std::vector<double> &buffer = asyncSendBuffers[name];
+    buffer.resize(sizeOfArray);
+    std::copy(dataField, dataField + sizeOfArray, buffer.begin());
+    ClientCommunication::getSingleton()->startSendDataField(name, sizeOfArray, &buffer[0]);
+    pendingAsyncSends.insert(name);
+}
+
+void Empire::irecvDataField(char *name, int sizeOfArray, double *dataField) {
+    if (pendingAsyncReceives.find(name) != pendingAsyncReceives.end())
+        wait();
+    std::vector<double> &buffer = asyncReceiveBuffers[name];
+    buffer.resize(sizeOfArray);
+    ClientCommunication::getSingleton()->startReceiveDataField(name, sizeOfArray, &buffer[0]);
+    pendingAsyncReceives[name] = dataField;
+}
+
+void Empire::wait() {
+    // a blocking transfer in between has completed the pending ones already
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+    for (std::map<std::string, double*>::iterator it = pendingAsyncReceives.begin();
+            it != pendingAsyncReceives.end(); it++) {
+        const std::vector<double> &buffer = asyncReceiveBuffers[it->first];
+        std::copy(buffer.begin(), buffer.end(), it->second);
+    }
+    pendingAsyncReceives.clear();
+    pendingAsyncSends.clear();
 }
 
 void Empire::sendSignal_double(char *name, int sizeOfArray, double *signal) {
@@ -271,6 +472,151 @@ void Empire::recvSignal_double(char *name, int sizeOfArray, double *signal) {
     ClientCommunication::getSingleton()->receiveFromServerBlocking<double>(sizeOfArray, signal);
 }
 
+void Empire::sendSignals(int numSignals, char **names, int *sizesOfArrays, double **signals) {
+    vector<string> signalNames(names, names + numSignals);
+    int size = 0;
+    for (int i = 0; i < numSignals; i++)
+        size += sizesOfArrays[i];
+    map<vector<string>, vector<double> >::iterator it = sendSignalBundles.find(signalNames);
+    if (it == sendSignalBundles.end()) { // the layout is sent once
+        vector<int> layout(1, numSignals);
+        layout.insert(layout.end(), sizesOfArrays, sizesOfArrays + numSignals);
+        vector<char> nameBuffer(numSignals * EMPIRE_API_NAME_STRING_LENGTH, '\0');
+        for (int i = 0; i < numSignals; i++)
+            strcpy(&nameBuffer[i * EMPIRE_API_NAME_STRING_LENGTH], names[i]);
+        ClientCommunication::getSingleton()->sendToServerBlocking<int>(numSignals + 1, &layout[0]);
+        ClientCommunication::getSingleton()->sendToServerBlocking<char>(nameBuffer.size(),
+                &nameBuffer[0]);
+        it = sendSignalBundles.insert(make_pair(signalNames, vector<double>(size))).first;
+    }
+    vector<double> &buffer = it->second;
+    assert(size == buffer.size());
+    int offset = 0;
+    for (int i = 0; i < numSignals; i++) {
+        copy(signals[i], signals[i] + sizesOfArrays[i], &buffer[offset]);
+        offset += sizesOfArrays[i];
+    }
+    ClientCommunication::getSingleton()->sendToServerBlocking<double>(size, &buffer[0]);
+}
+
+void Empire::recvSignals(int numSignals, char **names, int *sizesOfArrays, double **signals) {
+    vector<string> signalNames(names, names + numSignals);
+    int size = 0;
+    for (int i = 0; i < numSignals; i++)
+        size += sizesOfArrays[i];
+    map<vector<string>, vector<double> >::iterator it = recvSignalBundles.find(signalNames);
+    if (it == recvSignalBundles.end()) { // the layout is received once
+        vector<int> layout(numSignals + 1, -1);
+        vector<char> nameBuffer(numSignals * EMPIRE_API_NAME_STRING_LENGTH);
+        ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(numSignals + 1,
+                &layout[0]);
+        ClientCommunication::getSingleton()->receiveFromServerBlocking<char>(nameBuffer.size(),
+                &nameBuffer[0]);
+        assert(layout[0] == numSignals);
+        for (int i = 0; i < numSignals; i++) {
+            if (strcmp(names[i], &nameBuffer[i * EMPIRE_API_NAME_STRING_LENGTH]) != 0) {
+                cout << "Error: signal names are not matching: " << names[i] << " and, "
+                        << &nameBuffer[i * EMPIRE_API_NAME_STRING_LENGTH] << endl;
+                assert(false);
+            }
+            assert(sizesOfArrays[i] == layout[i + 1]);
+        }
+        it = recvSignalBundles.insert(make_pair(signalNames, vector<double>(size))).first;
+    }
+    vector<double> &buffer = it->second;
+    assert(size == buffer.size());
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<double>(size, &buffer[0]);
+    int offset = 0;
+    for (int i = 0; i < numSignals; i++) {
+        copy(&buffer[offset], &buffer[offset] + sizesOfArrays[i], signals[i]);
+        offset += sizesOfArrays[i];
+    }
+}
+
+void Empire::sendInterfaceJacobian(char *name, int numRows, int numColumns, int *rowPointers,
+        int *columnIndices, double *values) {
+    char nameBuffer[EMPIRE_API_NAME_STRING_LENGTH];
+    strcpy(nameBuffer, name);
+    ClientCommunication::getSingleton()->sendToServerBlocking<char>(EMPIRE_API_NAME_STRING_LENGTH,
+            nameBuffer);
+    int numEntries = rowPointers[numRows];
+    map<string, int>::iterator it = sentInterfaceJacobians.find(name);
+    if (it == sentInterfaceJacobians.end()) { // the sparsity pattern is sent once
+        int header[3] = { numRows, numColumns, numEntries };
+        ClientCommunication::getSingleton()->sendToServerBlocking<int>(3, header);
+        ClientCommunication::getSingleton()->sendToServerBlocking<int>(numRows + 1, rowPointers);
+        if (numEntries > 0)
+            ClientCommunication::getSingleton()->sendToServerBlocking<int>(numEntries,
+                    columnIndices);
+        sentInterfaceJacobians[name] = numEntries;
+    } else if (it->second != numEntries) {
+        cout << "Error: the sparsity pattern of the interface Jacobian " << name
+                << " has changed" << endl;
+        assert(false);
+    }
+    if (numEntries > 0)
+        ClientCommunication::getSingleton()->sendToServerBlocking<double>(numEntries, values);
+}
+
+void Empire::recvMappingOperator(char *name, int *numRows, int *numColumns) {
+    char nameRecv[EMPIRE_API_NAME_STRING_LENGTH];
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<char>(
+            EMPIRE_API_NAME_STRING_LENGTH, nameRecv);
+    if (strcmp(name, nameRecv) != 0) {
+        cout << "Error: mapper names are not matching: " << name << " and, " << nameRecv << endl;
+        assert(false);
+    }
+    int header[3];
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(3, header);
+    MappingOperator &mappingOperator = mappingOperators[name];
+    mappingOperator.numRows = header[0];
+    mappingOperator.numColumns = header[1];
+    mappingOperator.rowPointers.resize(header[0] + 1);
+    mappingOperator.columnIndices.resize(header[2]);
+    mappingOperator.values.resize(header[2]);
+    ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(header[0] + 1,
+            &mappingOperator.rowPointers[0]);
+    if (header[2] > 0) {
+        ClientCommunication::getSingleton()->receiveFromServerBlocking<int>(header[2],
+                &mappingOperator.columnIndices[0]);
+        ClientCommunication::getSingleton()->receiveFromServerBlocking<double>(header[2],
+                &mappingOperator.values[0]);
+    }
+    *numRows = header[0];
+    *numColumns = header[1];
+}
+
+void Empire::applyMappingOperator(char *name, int transpose, int numComponents,
+        const double *fieldIn, double *fieldOut) {
+    map<string, MappingOperator>::const_iterator it = mappingOperators.find(name);
+    if (it == mappingOperators.end()) {
+        cout << "Error: the mapping operator " << name << " has not been received" << endl;
+        assert(false);
+    }
+    const MappingOperator &mappingOperator = it->second;
+    const int *rowPtr = &mappingOperator.rowPointers[0];
+    const int *cols =
+            mappingOperator.columnIndices.empty() ? NULL : &mappingOperator.columnIndices[0];
+    const double *values = mappingOperator.values.empty() ? NULL : &mappingOperator.values[0];
+    const int n = numComponents;
+    if (!transpose) { // fieldOut = M * fieldIn
+        for (int i = 0; i < mappingOperator.numRows; i++) {
+            for (int k = 0; k < n; k++)
+                fieldOut[i * n + k] = 0.0;
+            for (int j = rowPtr[i]; j < rowPtr[i + 1]; j++)
+                for (int k = 0; k < n; k++)
+                    fieldOut[i * n + k] += values[j] * fieldIn[cols[j] * n + k];
+        }
+    } else { // fieldOut = M^T * fieldIn
+        for (int i = 0; i < mappingOperator.numColumns * n; i++)
+            fieldOut[i] = 0.0;
+        for (int i = 0; i < mappingOperator.numRows; i++)
+            for (int j = rowPtr[i]; j < rowPtr[i + 1]; j++)
+                for (int k = 0; k < n; k++)
+                    fieldOut[cols[j] * n + k] += values[j] * fieldIn[i * n + k];
+    }
+}
+
 void Empire::sendConvergenceSignal(int signal) {
     ClientCommunication::getSingleton()->sendToServerBlocking<int>(1, &signal);
 }
@@ -281,6 +627,23 @@ int Empire::recvConvergenceSignal() {
     return signal;
 }
 
+int Empire::recvDataFieldAndConvergence(char *name, int sizeOfArray, double *dataField) {
+    // 1 or 0 is a convergence signal sent on its own, anything else is the size header of the
+    // data field carrying a non-convergence signal
+    int header = recvConvergenceSignal();
+    if (header == 1)
+        return 1;
+    if (header == 0) {
+        recvDataField(name, sizeOfArray, dataField);
+        return 0;
+    }
+    header = NON_CONVERGENT_HEADER - header;
+    ClientCommunication::getSingleton()->startReceiveDataField(name, sizeOfArray, dataField,
+            &header);
+    ClientCommunication::getSingleton()->finishDataFieldTransfers();
+    return 0;
+}
+
 void Empire::printDataField(char *name, int sizeOfArray, double *dataField) {
     std::cout << name << std::endl;
     for (int i = 0; i < sizeOfArray; i++)
@@ -29,6 +29,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
 // how do I include cfloat, #include <cfloat> doesnt seem to work
 // check ManagePortability.h in carat
 
@@ -89,6 +91,26 @@ public:
      ***********/
     void sendMesh(int numNodes, int numElems, double *nodes, int *nodeIDs, int *numNodesPerElem,
             int *elems);
+    /***********************************************************************************************
+     * \brief Send the partition of this process of a mesh which is partitioned="true" in the
+     *        input of the Emperor. All processes of the client call it, the Emperor merges the
+     *        partitions by the node IDs, so that no process has to gather the mesh
+     * \param[in] numNodes number of nodes of the partition, including nodes shared with others
+     * \param[in] numElems number of elements of the partition, no element is in two partitions
+     * \param[in] nodes coordinates of the nodes
+     * \param[in] nodeIDs global IDs of the nodes
+     * \param[in] numNodesPerElem number of nodes per element
+     * \param[in] elems connectivity table of the elements by the global node IDs
+     ***********/
+    void sendMeshPartitioned(int numNodes, int numElems, double *nodes, int *nodeIDs,
+            int *numNodesPerElem, int *elems);
+    /***********************************************************************************************
+     * \brief Send the moved node coordinates of a mesh sent before, the node IDs and the elements
+     *        are kept by the Emperor
+     * \param[in] numNodes number of nodes, the same as sent with the mesh
+     * \param[in] nodes coordinates of all nodes
+     ***********/
+    void sendMeshCoordinates(int numNodes, double *nodes);
 
     /***********************************************************************************************
      * \brief Send the section mesh to the server (for mapping with beam elements)
@@ -124,6 +146,21 @@ public:
     void recvMesh(int *numNodes, int *numElems, double **nodes, int **nodeIDs,
             int **numNodesPerElem, int **elems);
 
+    /***********************************************************************************************
+     * \brief Receive mesh from the server into arrays of the caller, nothing is allocated
+     * \param[in] maxNumNodes capacity of nodeIDs, nodes holds 3 times as many values
+     * \param[in] maxNumElems capacity of numNodesPerElem
+     * \param[in] maxSizeOfElems capacity of elems
+     * \param[out] numNodes number of nodes
+     * \param[out] numElems number of elements
+     * \param[out] nodes coordinates of all nodes
+     * \param[out] nodeIDs IDs of all nodes
+     * \param[out] numNodesPerElem number of nodes per element
+     * \param[out] elems connectivity table of all elements
+     ***********/
+    void recvMesh(int maxNumNodes, int maxNumElems, int maxSizeOfElems, int *numNodes,
+            int *numElems, double *nodes, int *nodeIDs, int *numNodesPerElem, int *elems);
+
     /***********************************************************************************************
      * \brief Send the IGA patch to the server
      * \param[in] _pDegree The polynomial degree of the IGA 2D patch in the u-direction
@@ -180,7 +217,8 @@ public:
             int _uNumControlPoints, double* _cpNet);
 
     /***********************************************************************************************
-     * \brief Send the information of the current Dirichlet condition to the server
+     * \brief Send the information of the current Dirichlet condition to the server. The patches and
+     *        their trimming are packed until here and sent before it
      * \param[in] _numDirichletConditions Number of connections between patches in the multipatch geometry
      * \author Andreas Apostolatos, Altug Emiroglu
      ************/
@@ -282,18 +320,114 @@ public:
 
     /***********************************************************************************************
      * \brief Send data field to the server
+     * \param[in] name name of the data field
      * \param[in] sizeOfArray size of the array (data field)
      * \param[in] dataField the data field to be sent
      * \author Tianyang Wang
      ***********/
-    void sendDataField(int sizeOfArray, double *dataField);
+    void sendDataField(char *name, int sizeOfArray, double *dataField);
     /***********************************************************************************************
      * \brief Receive data field from the server
+     * \param[in] name name of the data field
      * \param[in] sizeOfArray size of the array (data field)
      * \param[out] dataField the data field to be received
      * \author Tianyang Wang
      ***********/
-    void recvDataField(int sizeOfArray, double *dataField);
+    void recvDataField(char *name, int sizeOfArray, double *dataField);
+    /***********************************************************************************************
+     * \brief Send the values of this process of a data field of a partitioned mesh. All processes
+     *        of the client call it, the values of a shared node are taken from the lowest rank
+     * \param[in] name name of the data field
+     * \param[in] sizeOfArray size of the array, the number of nodes or elements of the partition
+     *            times the dimension
+     * \param[in] dataField the values in the order of the partition
+     ***********/
+    void sendDataFieldPartitioned(char *name, int sizeOfArray, double *dataField);
+    /***********************************************************************************************
+     * \brief Receive the values of this process of a data field of a partitioned mesh, every
+     *        process receives the values of all its nodes or elements
+     * \param[in] name name of the data field
+     * \param[in] sizeOfArray size of the array
+     * \param[out] dataField the values in the order of the partition
+     ***********/
+    void recvDataFieldPartitioned(char *name, int sizeOfArray, double *dataField);
+    /***********************************************************************************************
+     * \brief Register the name of a data field once, such that it can be transferred by the
+     *        returned handle without handling its name at every transfer
+     * \param[in] name name of the data field
+     * \return the handle of the data field, the same for the same name
+     ***********/
+    int registerDataField(char *name);
+    /***********************************************************************************************
+     * \brief Register a data field together with the array it is always transferred from or into,
+     *        see sendRegisteredDataField and recvRegisteredDataField. Registering a name again
+     *        rebinds the array
+     * \param[in] name name of the data field
+     * \param[in] sizeOfArray size of the array (data field)
+     * \param[in] dataField the array, which must stay valid while the data field is transferred
+     * \return the handle of the data field, the same for the same name
+     ***********/
+    int registerDataField(char *name, int sizeOfArray, double *dataField);
+    /***********************************************************************************************
+     * \brief Send the array registered with a data field to the server
+     * \param[in] handle the handle of the data field returned by registerDataField
+     ***********/
+    void sendRegisteredDataField(int handle);
+    /***********************************************************************************************
+     * \brief Receive a data field from the server into the array registered with it
+     * \param[in] handle the handle of the data field returned by registerDataField
+     ***********/
+    void recvRegisteredDataField(int handle);
+    /***********************************************************************************************
+     * \brief Send data field to the server, see sendDataField
+     * \param[in] handle the handle of the data field returned by registerDataField
+     * \param[in] sizeOfArray size of the array (data field)
+     * \param[in] dataField the data field to be sent
+     ***********/
+    void sendDataField(int handle, int sizeOfArray, double *dataField);
+    /***********************************************************************************************
+     * \brief Receive data field from the server, see recvDataField
+     * \param[in] handle the handle of the data field returned by registerDataField
+     * \param[in] sizeOfArray size of the array (data field)
+     * \param[out] dataField the data field to be received
+     ***********/
+    void recvDataField(int handle, int sizeOfArray, double *dataField);
+    /***********************************************************************************************
+     * \brief Send several data fields to the server, which are in flight at the same time
+     * \param[in] numFields number of data fields
+     * \param[in] names names of the data fields
+     * \param[in] sizesOfArrays sizes of the arrays (data fields)
+     * \param[in] dataFields the data fields to be sent
+     ***********/
+    void sendDataFields(int numFields, char **names, int *sizesOfArrays, double **dataFields);
+    /***********************************************************************************************
+     * \brief Receive several data fields from the server, which are in flight at the same time
+     * \param[in] numFields number of data fields
+     * \param[in] names names of the data fields
+     * \param[in] sizesOfArrays sizes of the arrays (data fields)
+     * \param[out] dataFields the data fields to be received
+     ***********/
+    void recvDataFields(int numFields, char **names, int *sizesOfArrays, double **dataFields);
+    /***********************************************************************************************
+     * \brief Start sending a data field to the server, which is completed by wait. The data field
+     *        is copied into a buffer of its name first, such that the array can be reused at once
+     * \param[in] name name of the data field
+     * \param[in] sizeOfArray size of the array (data field)
+     * \param[in] dataField the data field to be sent
+     ***********/
+    void isendDataField(char *name, int sizeOfArray, double *dataField);
+    /***********************************************************************************************
+     * \brief Start receiving a data field from the server into a buffer of its name, which is
+     *        copied into the array by wait. Until then the array keeps its values
+     * \param[in] name name of the data field
+     * \param[in] sizeOfArray size of the array (data field)
+     * \param[out] dataField the data field to be received, valid after wait
+     ***********/
+    void irecvDataField(char *name, int sizeOfArray, double *dataField);
+    /***********************************************************************************************
+     * \brief Complete the transfers started by isendDataField and irecvDataField
+     ***********/
+    void wait();
     /***********************************************************************************************
      * \brief Send signal to the server
      * \param[in] name name of the signal
@@ -308,6 +442,53 @@ public:
      * \param[in] signal the signal
      ***********/
     void recvSignal_double(char *name, int sizeOfArray, double *signal);
+    /***********************************************************************************************
+     * \brief Send several signals to the server in one message, the names and sizes of the
+     *        signals are sent at the first call with these names only
+     * \param[in] numSignals number of signals
+     * \param[in] names names of the signals
+     * \param[in] sizesOfArrays sizes of the arrays (signals)
+     * \param[in] signals the signals
+     ***********/
+    void sendSignals(int numSignals, char **names, int *sizesOfArrays, double **signals);
+    /***********************************************************************************************
+     * \brief Receive several signals from the server in one message, see sendSignals
+     * \param[in] numSignals number of signals
+     * \param[in] names names of the signals
+     * \param[in] sizesOfArrays sizes of the arrays (signals)
+     * \param[out] signals the signals
+     ***********/
+    void recvSignals(int numSignals, char **names, int *sizesOfArrays, double **signals);
+    /***********************************************************************************************
+     * \brief Send a block of the interface Jacobian in compressed sparse row format (zero-based),
+     *        the sparsity pattern is sent at the first call with this name only
+     * \param[in] name name of the block
+     * \param[in] numRows number of rows of the block
+     * \param[in] numColumns number of columns of the block
+     * \param[in] rowPointers the first entry of every row, numRows+1 integers
+     * \param[in] columnIndices the column of every entry
+     * \param[in] values the value of every entry
+     ***********/
+    void sendInterfaceJacobian(char *name, int numRows, int numColumns, int *rowPointers,
+            int *columnIndices, double *values);
+    /***********************************************************************************************
+     * \brief Receive the mapping operator of a mapper of the Emperor and keep it
+     * \param[in] name name of the mapper
+     * \param[out] numRows number of rows (nodes of mesh B of the mapper)
+     * \param[out] numColumns number of columns (nodes of mesh A of the mapper)
+     ***********/
+    void recvMappingOperator(char *name, int *numRows, int *numColumns);
+    /***********************************************************************************************
+     * \brief Apply a mapping operator received by recvMappingOperator to every component of an
+     *        interleaved field
+     * \param[in] name name of the mapper
+     * \param[in] transpose 0 for consistent mapping (A to B), 1 for conservative mapping (B to A)
+     * \param[in] numComponents number of components per node
+     * \param[in] fieldIn the field to be mapped
+     * \param[out] fieldOut the mapped field
+     ***********/
+    void applyMappingOperator(char *name, int transpose, int numComponents, const double *fieldIn,
+            double *fieldOut);
     /***********************************************************************************************
      * \brief Send the convergence signal of an loop
      * \param[in] signal 1 means convergence, 0 means non-convergence
@@ -319,6 +500,17 @@ public:
      * \author Tianyang Wang
      ***********/
     int recvConvergenceSignal();
+    /***********************************************************************************************
+     * \brief Receive the convergence signal of a loop together with the next data field, in one
+     *        message if the Emperor piggybacks the non-convergence signal in the size header of the
+     *        data field (see piggybackConvergenceSignal). It replaces recvConvergenceSignal
+     *        followed by the first recvDataField of the next iteration
+     * \param[in] name name of the data field
+     * \param[in] sizeOfArray size of the array (data field)
+     * \param[out] dataField the data field, only received on non-convergence
+     * \return 1 means convergence, 0 means non-convergence
+     ***********/
+    int recvDataFieldAndConvergence(char *name, int sizeOfArray, double *dataField);
     /***********************************************************************************************
      * \brief A simple debug function showing the content of the data field
      * \param[in] name name of the data field
@@ -327,6 +519,53 @@ public:
      * \author Tianyang Wang
      ***********/
     void printDataField(char *name, int sizeOfArray, double *dataField);
+
+private:
+    /// ints of the patches and their trimming, packed into one message after the last patch
+    std::vector<int> igaPatchInts;
+    /// doubles of the patches and their trimming, packed into one message after the last patch
+    std::vector<double> igaPatchDoubles;
+    /********//**
+     * \brief A data field registered by registerDataField
+     ***********/
+    struct RegisteredDataField {
+        std::string name;
+        /// size of the registered array, 0 if none is registered
+        int sizeOfArray;
+        /// the registered array, NULL if none is registered
+        double *dataField;
+    };
+    /// the registered data fields, the handle is the index
+    std::vector<RegisteredDataField> registeredDataFields;
+    /// the buffers of isendDataField by the name of the data field, which keep their address, such
+    /// that a persistent request stays bound to them
+    std::map<std::string, std::vector<double> > asyncSendBuffers;
+    /// the buffers of irecvDataField by the name of the data field
+    std::map<std::string, std::vector<double> > asyncReceiveBuffers;
+    /// the data fields sent by isendDataField and not completed by wait
+    std::set<std::string> pendingAsyncSends;
+    /// the arrays of the data fields received by irecvDataField, which wait copies the buffers into
+    std::map<std::string, double*> pendingAsyncReceives;
+    /// the buffers of the signal bundles sent and received by the names of their signals, a
+    /// bundle is added once its layout is exchanged
+    std::map<std::vector<std::string>, std::vector<double> > sendSignalBundles;
+    std::map<std::vector<std::string>, std::vector<double> > recvSignalBundles;
+    /// the number of entries of the interface Jacobian blocks sent by their names, a block is
+    /// added once its sparsity pattern is sent
+    std::map<std::string, int> sentInterfaceJacobians;
+    /********//**
+     * \brief A mapping operator received from the Emperor in compressed sparse row format
+     ***********/
+    struct MappingOperator {
+        int numRows;
+        int numColumns;
+        /// the first entry of every row, numRows+1 integers
+        std::vector<int> rowPointers;
+        std::vector<int> columnIndices;
+        std::vector<double> values;
+    };
+    /// the mapping operators received by the names of their mappers
+    std::map<std::string, MappingOperator> mappingOperators;
 };
 
 }/* namespace EMPIRE */
@@ -85,6 +85,34 @@ const char *EMPIRE_API_getUserDefinedText(char *elementName);
 void EMPIRE_API_sendMesh(char *name, int numNodes, int numElems, double *nodes, int *nodeIDs,
         int *numNodesPerElem, int *elems);
 
+/***********************************************************************************************
+ * \brief Send the moved node coordinates of a mesh which has been sent before. Only the
+ *        coordinates are sent, the Emperor updates them in place and keeps the node IDs and the
+ *        elements. The mesh must be the meshRef input of a connection, the mappers of the mesh
+ *        are updated when the nodes have moved. Not for partitioned meshes
+ * \param[in] name name of the mesh
+ * \param[in] numNodes number of nodes, the same as sent with the mesh
+ * \param[in] nodes coordinates of all nodes in the order they were sent with the mesh
+ ***********/
+void EMPIRE_API_sendMeshCoordinates(char *name, int numNodes, double *nodes);
+
+/***********************************************************************************************
+ * \brief Send the partition of this process of a mesh which is partitioned="true" in the input
+ *        of the Emperor. Every process of the client calls it with its own partition, which is
+ *        sent directly to the Emperor instead of being gathered on the first process. The
+ *        Emperor merges the partitions by the node IDs, a node shared by several partitions is
+ *        owned by the lowest rank. Each element must be in one partition only
+ * \param[in] name name of the mesh
+ * \param[in] numNodes number of nodes of the partition
+ * \param[in] numElems number of elements of the partition
+ * \param[in] nodes coordinates of the nodes
+ * \param[in] nodeIDs global IDs of the nodes
+ * \param[in] numNodesPerElem number of nodes per element
+ * \param[in] elems connectivity table of the elements by the global node IDs
+ ***********/
+void EMPIRE_API_sendMeshPartitioned(char *name, int numNodes, int numElems, double *nodes,
+        int *nodeIDs, int *numNodesPerElem, int *elems);
+
 /***********************************************************************************************
  * \brief Send the section mesh to the server (for mapping with beam elements)
  * \param[in] name name of the mesh
@@ -119,6 +147,24 @@ void EMPIRE_API_sendSectionMesh(char *name, int numNodes, int numElems, double *
 void EMPIRE_API_recvMesh(char *name, int *numNodes, int *numElems, double **nodes, int **nodeIDs,
         int **numNodesPerElem, int **elem);
 
+/***********************************************************************************************
+ * \brief Receive mesh from the server into arrays of the caller, e.g. the arrays of the solver,
+ *        instead of arrays allocated by EMPIRE_API_recvMesh
+ * \param[in] name name of the mesh
+ * \param[in] maxNumNodes capacity of nodeIDs, nodes holds 3 times as many values
+ * \param[in] maxNumElems capacity of numNodesPerElem
+ * \param[in] maxSizeOfElems capacity of elems
+ * \param[out] numNodes number of nodes
+ * \param[out] numElems number of elements
+ * \param[out] nodes coordinates of all nodes
+ * \param[out] nodeIDs IDs of all nodes
+ * \param[out] numNodesPerElem number of nodes per element
+ * \param[out] elems connectivity table of all elements
+ ***********/
+void EMPIRE_API_recvMeshInPlace(char *name, int maxNumNodes, int maxNumElems, int maxSizeOfElems,
+        int *numNodes, int *numElems, double *nodes, int *nodeIDs, int *numNodesPerElem,
+        int *elems);
+
 /***********************************************************************************************
  * \brief Send the IGA patch to the server
  * \param[in] _name name of the field
@@ -175,7 +221,9 @@ void EMPIRE_API_sendIGATrimmingCurve(int _direction, int _pDegree, int _uNumKnot
         double* _uKnotVector, int _uNumControlPoints, double* _cpNet);
 
 /***********************************************************************************************
- * \brief Send the information of the current Dirichlet condition to the server
+ * \brief Send the information of the current Dirichlet condition to the server. The patches and
+ *        their trimming are packed until here and sent before it, so it has to be called after the
+ *        last patch even without Dirichlet conditions
  * \param[in] _numDirichletConditions Number of connections between patches in the multipatch geometry
  * \author Andreas Apostolatos, Altug Emiroglu
  ************/
@@ -276,7 +324,8 @@ void EMPIRE_API_sendIGAPatchCouplingGaussPointsTest(int numPatches, int* numBRep
 void EMPIRE_API_sendIGADirichletDofs(int numberOfClampedDofs, int* clampedDofs, int clampedDirections);
 
 /***********************************************************************************************
- * \brief Send data field to the server
+ * \brief Send data field to the server. If persistentDataFieldTransfer is enabled, the name
+ *        identifies the data field, so each data field must be sent with its own name
  * \param[in] name name of the field
  * \param[in] sizeOfArray size of the array (data field)
  * \param[in] dataField the data field to be sent
@@ -284,13 +333,136 @@ void EMPIRE_API_sendIGADirichletDofs(int numberOfClampedDofs, int* clampedDofs,
 void EMPIRE_API_sendDataField(char *name, int sizeOfArray, double *dataField);
 
 /***********************************************************************************************
- * \brief Receive data field from the server
+ * \brief Receive data field from the server. If persistentDataFieldTransfer is enabled, the name
+ *        identifies the data field, so each data field must be received with its own name
  * \param[in] name name of the field
  * \param[in] sizeOfArray size of the array (data field)
  * \param[out] dataField the data field to be received
  ***********/
 void EMPIRE_API_recvDataField(char *name, int sizeOfArray, double *dataField);
 
+/***********************************************************************************************
+ * \brief Register the name of a data field once before the time loop. The returned handle
+ *        replaces the name in EMPIRE_API_sendDataFieldByHandle and
+ *        EMPIRE_API_recvDataFieldByHandle, which do no string handling, e.g. for Fortran clients
+ * \param[in] name name of the field
+ * \return the handle of the field, registering a name again returns the same handle
+ ***********/
+int EMPIRE_API_registerDataField(char *name);
+
+/***********************************************************************************************
+ * \brief Register a data field together with the array of the solver it is transferred from
+ *        and into in every iteration. EMPIRE_API_sendRegisteredDataField and
+ *        EMPIRE_API_recvRegisteredDataField then only take the handle. With
+ *        persistentDataFieldTransfer the transfers are pre-matched persistent requests on the
+ *        registered array. Registering a name again rebinds the array
+ * \param[in] name name of the field
+ * \param[in] sizeOfArray size of the array (data field)
+ * \param[in] dataField the array, which must stay valid while the field is transferred
+ * \return the handle of the field, the same as of EMPIRE_API_registerDataField
+ ***********/
+int EMPIRE_API_registerDataFieldBuffer(char *name, int sizeOfArray, double *dataField);
+
+/***********************************************************************************************
+ * \brief Send the array registered with a data field to the server
+ * \param[in] handle handle of the field returned by EMPIRE_API_registerDataFieldBuffer
+ ***********/
+void EMPIRE_API_sendRegisteredDataField(int handle);
+
+/***********************************************************************************************
+ * \brief Receive a data field from the server into the array registered with it
+ * \param[in] handle handle of the field returned by EMPIRE_API_registerDataFieldBuffer
+ ***********/
+void EMPIRE_API_recvRegisteredDataField(int handle);
+
+/***********************************************************************************************
+ * \brief Send data field to the server, as EMPIRE_API_sendDataField
+ * \param[in] handle handle of the field returned by EMPIRE_API_registerDataField
+ * \param[in] sizeOfArray size of the array (data field)
+ * \param[in] dataField the data field to be sent
+ ***********/
+void EMPIRE_API_sendDataFieldByHandle(int handle, int sizeOfArray, double *dataField);
+
+/***********************************************************************************************
+ * \brief Receive data field from the server, as EMPIRE_API_recvDataField
+ * \param[in] handle handle of the field returned by EMPIRE_API_registerDataField
+ * \param[in] sizeOfArray size of the array (data field)
+ * \param[out] dataField the data field to be received
+ ***********/
+void EMPIRE_API_recvDataFieldByHandle(int handle, int sizeOfArray, double *dataField);
+
+/***********************************************************************************************
+ * \brief Send the values of this process of a data field of a partitioned mesh. Every process
+ *        of the client calls it, the values of a shared node are taken from the lowest rank.
+ *        Partitioned data fields are always transferred as float64, without persistent or shared
+ *        memory transfer
+ * \param[in] name name of the field
+ * \param[in] sizeOfArray number of nodes (or elements) of the partition times the dimension
+ * \param[in] dataField the values in the order of the partition
+ ***********/
+void EMPIRE_API_sendDataFieldPartitioned(char *name, int sizeOfArray, double *dataField);
+
+/***********************************************************************************************
+ * \brief Receive the values of this process of a data field of a partitioned mesh. Every process
+ *        of the client calls it and receives the values of all nodes (or elements) of its
+ *        partition, including the shared ones
+ * \param[in] name name of the field
+ * \param[in] sizeOfArray number of nodes (or elements) of the partition times the dimension
+ * \param[out] dataField the values in the order of the partition
+ ***********/
+void EMPIRE_API_recvDataFieldPartitioned(char *name, int sizeOfArray, double *dataField);
+
+/***********************************************************************************************
+ * \brief Send several data fields to the server at once. Instead of one transfer after the
+ *        other, all data fields are in flight at the same time. The order of the names must be
+ *        the order in which the Emperor receives them, as for consecutive EMPIRE_API_sendDataField
+ * \param[in] numFields number of data fields
+ * \param[in] names names of the fields
+ * \param[in] sizesOfArrays sizes of the arrays (data fields)
+ * \param[in] dataFields the data fields to be sent
+ ***********/
+void EMPIRE_API_sendDataFields(int numFields, char **names, int *sizesOfArrays,
+        double **dataFields);
+
+/***********************************************************************************************
+ * \brief Receive several data fields from the server at once, the counterpart of
+ *        EMPIRE_API_sendDataFields
+ * \param[in] numFields number of data fields
+ * \param[in] names names of the fields
+ * \param[in] sizesOfArrays sizes of the arrays (data fields)
+ * \param[out] dataFields the data fields to be received
+ ***********/
+void EMPIRE_API_recvDataFields(int numFields, char **names, int *sizesOfArrays,
+        double **dataFields);
+
+/***********************************************************************************************
+ * \brief Start sending a data field to the server and return at once. The data field is copied
+ *        into an internal buffer, such that the array can be modified right away, e.g. by the
+ *        next time step, while the transfer overlaps with the work of the client. The transfer is
+ *        completed by EMPIRE_API_wait. The data fields are received by the Emperor in the order
+ *        they are sent, as for EMPIRE_API_sendDataField
+ * \param[in] name name of the field
+ * \param[in] sizeOfArray size of the array (data field)
+ * \param[in] dataField the data field to be sent
+ ***********/
+void EMPIRE_API_isendDataField(char *name, int sizeOfArray, double *dataField);
+
+/***********************************************************************************************
+ * \brief Start receiving a data field from the server and return at once. The data field is
+ *        received into an internal buffer and copied into the array by EMPIRE_API_wait, until
+ *        then the array keeps its values
+ * \param[in] name name of the field
+ * \param[in] sizeOfArray size of the array (data field)
+ * \param[out] dataField the data field to be received, valid after EMPIRE_API_wait
+ ***********/
+void EMPIRE_API_irecvDataField(char *name, int sizeOfArray, double *dataField);
+
+/***********************************************************************************************
+ * \brief Complete all transfers started by EMPIRE_API_isendDataField and
+ *        EMPIRE_API_irecvDataField
+ ***********/
+void EMPIRE_API_wait(void);
+
 /***********************************************************************************************
  * \brief Send signal to the server
  * \param[in] name name of the signal
@@ -307,12 +479,87 @@ void EMPIRE_API_sendSignal_double(char *name, int sizeOfArray, double *signal);
  ***********/
 void EMPIRE_API_recvSignal_double(char *name, int sizeOfArray, double *signal);
 
+/***********************************************************************************************
+ * \brief Send several signals to the server in one message. The connection transferring them
+ *        has bundleSignals="true" and lists them in the same order. The names and sizes are
+ *        checked at the first call with these names only, later calls send the values only
+ * \param[in] numSignals number of signals
+ * \param[in] names names of the signals
+ * \param[in] sizesOfArrays sizes of the arrays (signals)
+ * \param[in] signals the signals
+ ***********/
+void EMPIRE_API_sendSignals(int numSignals, char **names, int *sizesOfArrays, double **signals);
+
+/***********************************************************************************************
+ * \brief Receive several signals from the server in one message, see EMPIRE_API_sendSignals
+ * \param[in] numSignals number of signals
+ * \param[in] names names of the signals
+ * \param[in] sizesOfArrays sizes of the arrays (signals)
+ * \param[out] signals the signals
+ ***********/
+void EMPIRE_API_recvSignals(int numSignals, char **names, int *sizesOfArrays, double **signals);
+
+/***********************************************************************************************
+ * \brief Send a block of the interface Jacobian of an IJCSA coupling algorithm in compressed
+ *        sparse row format (zero-based). The coupling algorithm lists the block by its name in an
+ *        interfaceJacobianBlock and receives it after the outputs of the client, at the first
+ *        iteration of every time step or at every iteration. The sparsity pattern is sent at the
+ *        first call with this name only and must not change, later calls send the values only
+ * \param[in] name name of the block
+ * \param[in] numRows number of rows of the block
+ * \param[in] numColumns number of columns of the block
+ * \param[in] rowPointers the first entry of every row, numRows+1 integers
+ * \param[in] columnIndices the column of every entry
+ * \param[in] values the value of every entry
+ ***********/
+void EMPIRE_API_sendInterfaceJacobian(char *name, int numRows, int numColumns, int *rowPointers,
+        int *columnIndices, double *values);
+
+/***********************************************************************************************
+ * \brief Receive the mapping operator M of a mapper of the Emperor which lists this client as an
+ *        operatorReceiver. The Emperor sends it once after the mappers are built, so it is
+ *        received after the meshes are sent. The client can then map its fields by
+ *        EMPIRE_API_applyMappingOperator instead of having the Emperor map them, e.g. to send a
+ *        mapped field as a signal which the Emperor only copies
+ * \param[in] name name of the mapper
+ * \param[out] numRows number of rows of M, the number of nodes of mesh B of the mapper
+ * \param[out] numColumns number of columns of M, the number of nodes of mesh A of the mapper
+ ***********/
+void EMPIRE_API_recvMappingOperator(char *name, int *numRows, int *numColumns);
+
+/***********************************************************************************************
+ * \brief Map a field by a mapping operator received by EMPIRE_API_recvMappingOperator, the nodes
+ *        are in the order the meshes were sent in
+ * \param[in] name name of the mapper
+ * \param[in] transpose 0 for consistent mapping fieldB = M * fieldA (e.g. displacements), 1 for
+ *            conservative mapping fieldA = M^T * fieldB (e.g. forces)
+ * \param[in] numComponents number of interleaved components per node (e.g. 3 for a vector)
+ * \param[in] fieldIn the field to be mapped
+ * \param[out] fieldOut the mapped field
+ ***********/
+void EMPIRE_API_applyMappingOperator(char *name, int transpose, int numComponents, double *fieldIn,
+        double *fieldOut);
+
 /***********************************************************************************************
  * \brief Receive the convergence signal of an loop
  * \return 1 means convergence, 0 means non-convergence
  ***********/
 int EMPIRE_API_recvConvergenceSignal();
 
+/***********************************************************************************************
+ * \brief Receive the convergence signal of a loop together with the next data field, in one
+ *        message if the Emperor piggybacks the non-convergence signal in the size header of the
+ *        data field (<piggybackConvergenceSignal>yes). Use it in place of
+ *        EMPIRE_API_recvConvergenceSignal, the client loop then reads
+ *        recvDataField; do { solve; sendDataField; } while (!recvDataFieldAndConvergence);
+ *        Further data fields of the iteration are received by EMPIRE_API_recvDataField
+ * \param[in] name name of the data field
+ * \param[in] sizeOfArray size of the array (data field)
+ * \param[out] dataField the data field, only received on non-convergence
+ * \return 1 means convergence, 0 means non-convergence
+ ***********/
+int EMPIRE_API_recvDataFieldAndConvergence(char *name, int sizeOfArray, double *dataField);
+
 /***********************************************************************************************
  * \brief Send the convergence signal of an loop
  * \param[in] signal 1 means convergence, 0 means non-convergence
@@ -332,6 +579,18 @@ void EMPIRE_API_printDataField(char *name, int sizeOfArray, double *dataField);
  ***********/
 void EMPIRE_API_Disconnect(void);
 
+/***********************************************************************************************
+ * \brief Called by the Emperor before it runs the client as a thread inside its own process. All
+ *        messages of the client are then copied by the given functions instead of being sent by
+ *        MPI, the client needs to define int EMPIRE_inProcessClientMain(int argc, char **argv)
+ * \param[in] channel the channel of the Emperor, passed to both functions
+ * \param[in] sendToServer copies a message of numBytes bytes to the Emperor
+ * \param[in] receiveFromServer copies a message of at most numBytes bytes from the Emperor
+ ***********/
+void EMPIRE_API_setInProcessLink(void *channel,
+        void (*sendToServer)(void *channel, const void *message, int numBytes),
+        void (*receiveFromServer)(void *channel, void *message, int numBytes));
+
 /// maximum length of a name string
 static const int EMPIRE_API_NAME_STRING_LENGTH = 80;
 
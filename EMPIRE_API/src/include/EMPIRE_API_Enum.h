@@ -33,6 +33,16 @@ enum EMPIRE_DataField_dimension {
     EMPIRE_DataField_vector = 3
 };
 
+/*
+ * The format a data field is transferred in, the same values as in EMPEROR_Enum.h.
+ */
+enum EMPIRE_DataField_wireFormat {
+    EMPIRE_DataField_float64 = 0,
+    EMPIRE_DataField_float32 = 1,
+    EMPIRE_DataField_lossless = 2,
+    EMPIRE_DataField_deltaLossless = 3
+};
+
 
 
 
@@ -0,0 +1,338 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <math.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include "CAGDBenchmark.h"
+#include "IGAPatchSurface.h"
+#include "IGAControlPoint.h"
+#include "BSplineBasis1D.h"
+#include "BSplineBasis2D.h"
+#include "NurbsBasis2D.h"
+#include "AuxiliaryParameters.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+const int CAGDBenchmark::NUM_SAMPLES = 1024;
+
+/// the number of timed batches of a kernel, the fastest one is the result
+static const int NUM_REPETITIONS = 5;
+/// the derivative order of the basis functions, as needed by the Newton-Raphson projections
+static const int DERIV_DEGREE = 2;
+
+/********//**
+ * \brief Struct Sample is a random point of the benchmark patch with its projection problems
+ ***********/
+struct Sample {
+    /// the surface parameters of the point
+    double u, v;
+    /// the knot spans of the surface parameters
+    int spanU, spanV;
+    /// a point above the surface point
+    double P[3];
+    /// the center of the knot span, the initial guess of the projection
+    double uGuess, vGuess;
+    /// a line from a surface point near the edge u = 1 to a point outside of the patch
+    double Pin[3], Pout[3];
+    /// the surface parameter u of Pin
+    double uIn;
+};
+
+/***********************************************************************************************
+ * \brief Create a NURBS patch on [0,1]x[0,1] with a wavy surface and varying weights, the control
+ *        points are at the Greville abscissae
+ * \param[in] degree the polynomial degree in both directions
+ * \param[in] numKnotSpans the number of knot spans in both directions
+ * \param[out] controlPoints the control points, to be deleted after the patch
+ * \return the patch
+ ***********/
+static IGAPatchSurface *createPatch(int degree, int numKnotSpans, vector<IGAControlPoint*> &controlPoints) {
+    int numKnots = numKnotSpans + 2 * degree + 1;
+    vector<double> knots(numKnots);
+    for (int i = 0; i < numKnots; i++)
+        knots[i] = min(max((double) (i - degree) / numKnotSpans, 0.0), 1.0);
+    int numCPs1D = numKnotSpans + degree;
+    vector<double> greville(numCPs1D, 0.0);
+    for (int i = 0; i < numCPs1D; i++)
+        for (int k = 1; k <= degree; k++)
+            greville[i] += knots[i + k] / degree;
+
+    controlPoints.resize(numCPs1D * numCPs1D);
+    IGAControlPoint **controlPointNet = new IGAControlPoint*[numCPs1D * numCPs1D];
+    for (int j = 0; j < numCPs1D; j++) {
+        for (int i = 0; i < numCPs1D; i++) {
+            int cp = j * numCPs1D + i;
+            double z = 0.1 * sin(2.0 * M_PI * greville[i]) * sin(2.0 * M_PI * greville[j]);
+            double w = 1.0 + 0.2 * sin(1.0 + i + 2.0 * j);
+            controlPoints[cp] = new IGAControlPoint(cp, greville[i], greville[j], z, w);
+            controlPointNet[cp] = controlPoints[cp];
+        }
+    }
+    return new IGAPatchSurface(0, degree, numKnots, &knots[0], degree, numKnots, &knots[0],
+            numCPs1D, numCPs1D, controlPointNet);
+}
+
+/***********************************************************************************************
+ * \brief Create the random samples on a patch, the same for every run
+ ***********/
+static void createSamples(const IGAPatchSurface *patch, int numKnotSpans, vector<Sample> &samples) {
+    srand(1);
+    samples.resize(CAGDBenchmark::NUM_SAMPLES);
+    for (int i = 0; i < samples.size(); i++) {
+        Sample &s = samples[i];
+        s.u = (double) rand() / RAND_MAX;
+        s.v = (double) rand() / RAND_MAX;
+        s.spanU = patch->findSpanU(s.u);
+        s.spanV = patch->findSpanV(s.v);
+        double normal[3];
+        patch->computeCartesianCoordinatesAndNormalVector(s.P, normal, s.u, s.v);
+        for (int k = 0; k < 3; k++)
+            s.P[k] += 1e-3 * normal[k];
+        s.uGuess = (floor(s.u * numKnotSpans) + 0.5) / numKnotSpans;
+        s.vGuess = (floor(s.v * numKnotSpans) + 0.5) / numKnotSpans;
+        s.uIn = 0.8 + 0.15 * rand() / RAND_MAX;
+        patch->computeCartesianCoordinatesAndNormalVector(s.Pin, normal, s.uIn, s.v);
+        patch->computeCartesianCoordinatesAndNormalVector(s.Pout, normal, 1.0, s.v);
+        s.Pout[0] += 0.2;
+    }
+}
+
+/********//**
+ * \brief Struct FindKnotSpan benchmarks BSplineBasis1D::findKnotSpan
+ ***********/
+struct FindKnotSpan: public CAGDBenchmark::Kernel {
+    const BSplineBasis1D *basis;
+    const vector<Sample> &samples;
+    FindKnotSpan(const BSplineBasis1D *_basis, const vector<Sample> &_samples) :
+            basis(_basis), samples(_samples) {
+    }
+    double call(int sample) {
+        return basis->findKnotSpan(samples[sample].u);
+    }
+};
+
+/********//**
+ * \brief Struct BSplineBasis1DDerivatives benchmarks
+ *        BSplineBasis1D::computeLocalBasisFunctionsAndDerivatives
+ ***********/
+struct BSplineBasis1DDerivatives: public CAGDBenchmark::Kernel {
+    const BSplineBasis1D *basis;
+    const vector<Sample> &samples;
+    vector<double> basisFcts;
+    BSplineBasis1DDerivatives(const BSplineBasis1D *_basis, const vector<Sample> &_samples) :
+            basis(_basis), samples(_samples),
+            basisFcts((DERIV_DEGREE + 1) * (_basis->getPolynomialDegree() + 1)) {
+    }
+    double call(int sample) {
+        basis->computeLocalBasisFunctionsAndDerivatives(&basisFcts[0], DERIV_DEGREE,
+                samples[sample].u, samples[sample].spanU);
+        return basisFcts[0];
+    }
+};
+
+/********//**
+ * \brief Struct NurbsBasis2DDerivatives benchmarks
+ *        NurbsBasis2D::computeLocalBasisFunctionsAndDerivatives
+ ***********/
+struct NurbsBasis2DDerivatives: public CAGDBenchmark::Kernel {
+    NurbsBasis2D *basis;
+    const vector<Sample> &samples;
+    vector<double> basisFcts;
+    NurbsBasis2DDerivatives(NurbsBasis2D *_basis, int degree, const vector<Sample> &_samples) :
+            basis(_basis), samples(_samples),
+            basisFcts((DERIV_DEGREE + 1) * (DERIV_DEGREE + 1) * (degree + 1) * (degree + 1)) {
+    }
+    double call(int sample) {
+        const Sample &s = samples[sample];
+        basis->computeLocalBasisFunctionsAndDerivatives(&basisFcts[0], DERIV_DEGREE, s.u, s.spanU,
+                s.v, s.spanV);
+        return basisFcts[0];
+    }
+};
+
+/********//**
+ * \brief Struct CartesianCoordinates benchmarks IGAPatchSurface::computeCartesianCoordinates
+ ***********/
+struct CartesianCoordinates: public CAGDBenchmark::Kernel {
+    const IGAPatchSurface *patch;
+    const vector<Sample> &samples;
+    CartesianCoordinates(const IGAPatchSurface *_patch, const vector<Sample> &_samples) :
+            patch(_patch), samples(_samples) {
+    }
+    double call(int sample) {
+        const Sample &s = samples[sample];
+        double X[3];
+        patch->computeCartesianCoordinates(X, s.u, s.spanU, s.v, s.spanV);
+        return X[2];
+    }
+};
+
+/********//**
+ * \brief Struct PointProjection benchmarks IGAPatchSurface::computePointProjectionOnPatch from
+ *        the center of the knot span of the solution
+ ***********/
+struct PointProjection: public CAGDBenchmark::Kernel {
+    IGAPatchSurface *patch;
+    const vector<Sample> &samples;
+    PointProjection(IGAPatchSurface *_patch, const vector<Sample> &_samples) :
+            patch(_patch), samples(_samples) {
+    }
+    double call(int sample) {
+        const Sample &s = samples[sample];
+        double u = s.uGuess;
+        double v = s.vGuess;
+        double P[3] = { s.P[0], s.P[1], s.P[2] };
+        bool isConverged;
+        patch->computePointProjectionOnPatch(u, v, P, isConverged);
+        return u + v;
+    }
+};
+
+/********//**
+ * \brief Struct BoundaryProjection benchmarks
+ *        IGAPatchSurface::computePointProjectionOnPatchBoundaryNewtonRhapson on lines crossing
+ *        the edge u = 1, as the IGA mortar mapper clips elements at the patch boundary
+ ***********/
+struct BoundaryProjection: public CAGDBenchmark::Kernel {
+    IGAPatchSurface *patch;
+    const vector<Sample> &samples;
+    BoundaryProjection(IGAPatchSurface *_patch, const vector<Sample> &_samples) :
+            patch(_patch), samples(_samples) {
+    }
+    double call(int sample) {
+        const Sample &s = samples[sample];
+        double u = s.uIn;
+        double v = s.v;
+        double lambda = 0.0;
+        double distance = 1e-2;
+        double Pin[3] = { s.Pin[0], s.Pin[1], s.Pin[2] };
+        double Pout[3] = { s.Pout[0], s.Pout[1], s.Pout[2] };
+        patch->computePointProjectionOnPatchBoundaryNewtonRhapson(u, v, lambda, distance, Pin, Pout);
+        return lambda;
+    }
+};
+
+CAGDBenchmark::CAGDBenchmark(const std::vector<int> &_degrees, const std::vector<int> &_numKnotSpans,
+        double _minTime) :
+        degrees(_degrees), numKnotSpans(_numKnotSpans), minTime(_minTime), checksum(0.0) {
+}
+
+CAGDBenchmark::~CAGDBenchmark() {
+}
+
+void CAGDBenchmark::run() {
+    cout << left << setw(70) << "kernel" << right << setw(8) << "degree" << setw(10) << "spans"
+            << setw(14) << "time [ns]" << endl;
+    for (int d = 0; d < degrees.size(); d++) {
+        for (int n = 0; n < numKnotSpans.size(); n++) {
+            int degree = degrees[d];
+            vector<IGAControlPoint*> controlPoints;
+            IGAPatchSurface *patch = createPatch(degree, numKnotSpans[n], controlPoints);
+            vector<Sample> samples;
+            createSamples(patch, numKnotSpans[n], samples);
+            NurbsBasis2D *nurbsBasis = dynamic_cast<NurbsBasis2D*>(patch->getIGABasis());
+            assert(nurbsBasis != NULL);
+
+            FindKnotSpan findKnotSpan(patch->getIGABasis(0), samples);
+            measure("BSplineBasis1D::findKnotSpan", degree, numKnotSpans[n], findKnotSpan);
+            BSplineBasis1DDerivatives bSplineBasis1D(patch->getIGABasis(0), samples);
+            measure("BSplineBasis1D::computeLocalBasisFunctionsAndDerivatives", degree,
+                    numKnotSpans[n], bSplineBasis1D);
+            NurbsBasis2DDerivatives nurbsBasis2D(nurbsBasis, degree, samples);
+            measure("NurbsBasis2D::computeLocalBasisFunctionsAndDerivatives", degree,
+                    numKnotSpans[n], nurbsBasis2D);
+            CartesianCoordinates cartesianCoordinates(patch, samples);
+            measure("IGAPatchSurface::computeCartesianCoordinates", degree, numKnotSpans[n],
+                    cartesianCoordinates);
+            PointProjection pointProjection(patch, samples);
+            measure("IGAPatchSurface::computePointProjectionOnPatch", degree, numKnotSpans[n],
+                    pointProjection);
+            BoundaryProjection boundaryProjection(patch, samples);
+            measure("IGAPatchSurface::computePointProjectionOnPatchBoundaryNewtonRhapson", degree,
+                    numKnotSpans[n], boundaryProjection);
+
+            delete patch;
+            for (int i = 0; i < controlPoints.size(); i++)
+                delete controlPoints[i];
+        }
+    }
+    cout << "checksum " << checksum << endl;
+}
+
+void CAGDBenchmark::measure(const std::string &kernelName, int degree, int numKnotSpans,
+        Kernel &kernel) {
+    // double the batch until it can be timed, then keep the fastest of the repetitions
+    long batchSize = 1;
+    double bestTime = -1.0;
+    int repetition = 0;
+    int sample = 0;
+    while (repetition < NUM_REPETITIONS) {
+        double startTime = omp_get_wtime();
+        for (long i = 0; i < batchSize; i++) {
+            checksum += kernel.call(sample);
+            if (++sample == NUM_SAMPLES)
+                sample = 0;
+        }
+        double time = omp_get_wtime() - startTime;
+        if (time < minTime && repetition == 0) {
+            batchSize *= 2;
+            continue;
+        }
+        if (bestTime < 0.0 || time < bestTime)
+            bestTime = time;
+        repetition++;
+    }
+
+    Result result;
+    result.kernelName = kernelName;
+    result.degree = degree;
+    result.numKnotSpans = numKnotSpans;
+    result.timePerCall = 1e9 * bestTime / batchSize;
+    results.push_back(result);
+    cout << left << setw(70) << kernelName << right << setw(8) << degree << setw(10)
+            << numKnotSpans << setw(14) << fixed << setprecision(1) << result.timePerCall << endl;
+}
+
+void CAGDBenchmark::writeJSON(const std::string &fileName) const {
+    ofstream file(fileName.c_str());
+    file << "{\n";
+    file << "  \"gitSHA1\": \"" << AuxiliaryParameters::gitSHA1 << "\",\n";
+    file << "  \"gitTAG\": \"" << AuxiliaryParameters::gitTAG << "\",\n";
+    file << "  \"numSamples\": " << NUM_SAMPLES << ",\n";
+    file << "  \"results\": [";
+    for (int i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    {\"kernel\": \"" << result.kernelName << "\", \"degree\": " << result.degree
+                << ", \"numKnotSpans\": " << result.numKnotSpans << ", \"nsPerCall\": " << fixed
+                << setprecision(2) << result.timePerCall << ", \"callsPerSecond\": "
+                << setprecision(0) << 1e9 / result.timePerCall << "}";
+    }
+    file << "\n  ]\n}\n";
+}
+
+} /* namespace EMPIRE */
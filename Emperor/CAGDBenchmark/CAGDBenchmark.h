@@ -0,0 +1,119 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file CAGDBenchmark.h
+ * This file holds the class CAGDBenchmark
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef CAGDBENCHMARK_H_
+#define CAGDBENCHMARK_H_
+
+#include <string>
+#include <vector>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class CAGDBenchmark measures the time per call of the CAGD kernels (knot span search,
+ *        B-Spline and NURBS basis functions, surface evaluation and point projections) on a curved
+ *        NURBS patch, swept over the polynomial degree and the number of knot spans.
+ *        Every kernel is called on a fixed set of random samples in batches whose size grows until
+ *        a batch takes long enough to be timed, the fastest of several batches is the result.
+ ***********/
+class CAGDBenchmark {
+public:
+    /********//**
+     * \brief Struct Kernel is one kernel of the benchmark bound to a patch and its samples
+     ***********/
+    struct Kernel {
+        virtual ~Kernel() {
+        }
+        /***********************************************************************************************
+         * \brief Call the kernel on a sample
+         * \param[in] sample the index of the sample
+         * \return a value of the result, summed up so that the call cannot be optimized away
+         ***********/
+        virtual double call(int sample) = 0;
+    };
+
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _degrees the polynomial degrees of the patches
+     * \param[in] _numKnotSpans the numbers of knot spans of the patches in each direction
+     * \param[in] _minTime the minimum time in seconds of a timed batch
+     ***********/
+    CAGDBenchmark(const std::vector<int> &_degrees, const std::vector<int> &_numKnotSpans,
+            double _minTime);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~CAGDBenchmark();
+    /***********************************************************************************************
+     * \brief Run all kernels on all patches
+     ***********/
+    void run();
+    /***********************************************************************************************
+     * \brief Write the results to a JSON file
+     * \param[in] fileName the name of the file
+     ***********/
+    void writeJSON(const std::string &fileName) const;
+
+    /// the number of random samples every kernel cycles through
+    static const int NUM_SAMPLES;
+
+private:
+    /***********************************************************************************************
+     * \brief Measure the time per call of a kernel and store the result
+     * \param[in] kernelName the name of the kernel
+     * \param[in] degree the polynomial degree of the patch
+     * \param[in] numKnotSpans the number of knot spans of the patch in each direction
+     * \param[in] kernel the kernel
+     ***********/
+    void measure(const std::string &kernelName, int degree, int numKnotSpans, Kernel &kernel);
+
+    /********//**
+     * \brief Struct Result is the time per call of one kernel on one patch
+     ***********/
+    struct Result {
+        /// the name of the kernel
+        std::string kernelName;
+        /// the polynomial degree
+        int degree;
+        /// the number of knot spans in each direction
+        int numKnotSpans;
+        /// the wall time per call in nanoseconds
+        double timePerCall;
+    };
+
+    /// the polynomial degrees
+    std::vector<int> degrees;
+    /// the numbers of knot spans
+    std::vector<int> numKnotSpans;
+    /// the minimum time of a timed batch
+    double minTime;
+    /// the results in the order of the runs
+    std::vector<Result> results;
+    /// the sum of the values returned by the kernels
+    double checksum;
+};
+
+} /* namespace EMPIRE */
+#endif /* CAGDBENCHMARK_H_ */
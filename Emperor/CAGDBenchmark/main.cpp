@@ -0,0 +1,48 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+#include "CAGDBenchmark.h"
+
+using namespace EMPIRE;
+using namespace std;
+
+/***********************************************************************************************
+ * Usage: CAGDBenchmark [result.json [minBatchTime]]
+ * The kernels are run on patches of the degrees 1 to 4 with 4 to 256 knot spans in each direction.
+ ***********/
+int main(int argc, char** argv) {
+    string fileName = (argc > 1) ? argv[1] : "CAGDBenchmark.json";
+    double minTime = (argc > 2) ? atof(argv[2]) : 0.05;
+    vector<int> degrees;
+    for (int degree = 1; degree <= 4; degree++)
+        degrees.push_back(degree);
+    vector<int> numKnotSpans;
+    for (int n = 4; n <= 256; n *= 4)
+        numKnotSpans.push_back(n);
+    CAGDBenchmark *benchmark = new CAGDBenchmark(degrees, numKnotSpans, minTime);
+    benchmark->run();
+    benchmark->writeJSON(fileName);
+    delete benchmark;
+    cout << endl << "================================================" << endl;
+    cout << "Results written to " << fileName << endl;
+}
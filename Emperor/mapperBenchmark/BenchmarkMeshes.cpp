@@ -0,0 +1,163 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <assert.h>
+#include <vector>
+#include "BenchmarkMeshes.h"
+#include "FEMesh.h"
+#include "IGAMesh.h"
+#include "IGAPatchSurface.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+const double BenchmarkMeshes::TRIMMED_HEIGHT = 0.7071;
+
+/***********************************************************************************************
+ * \brief Create a mesh on a structured grid of nodes, the elements are the cells (i,j) of the grid
+ * \param[in] name the name of the mesh
+ * \param[in] numElemsU the number of cells in u-direction
+ * \param[in] numElemsV the number of cells in v-direction
+ * \param[in] isPeriodicU whether the last column of cells is connected to the first column of nodes
+ * \param[in] triangles split every cell into two triangles
+ * \param[in] coordinates the coordinates of node (i,j) are at 3 * (j * numNodesU + i)
+ * \return the mesh
+ ***********/
+static FEMesh *createStructuredMesh(const string &name, int numElemsU, int numElemsV,
+        bool isPeriodicU, bool triangles, const vector<double> &coordinates) {
+    int numNodesU = isPeriodicU ? numElemsU : numElemsU + 1;
+    int numNodes = numNodesU * (numElemsV + 1);
+    int numCells = numElemsU * numElemsV;
+    assert(coordinates.size() == 3 * numNodes);
+
+    FEMesh *mesh = new FEMesh(name, numNodes, triangles ? 2 * numCells : numCells);
+    for (int i = 0; i < 3 * numNodes; i++)
+        mesh->nodes[i] = coordinates[i];
+    for (int i = 0; i < numNodes; i++)
+        mesh->nodeIDs[i] = i + 1;
+    for (int i = 0; i < mesh->numElems; i++)
+        mesh->numNodesPerElem[i] = triangles ? 3 : 4;
+    mesh->initElems();
+
+    int *elem = mesh->elems;
+    for (int j = 0; j < numElemsV; j++) {
+        for (int i = 0; i < numElemsU; i++) {
+            int iNext = (isPeriodicU && i == numElemsU - 1) ? 0 : i + 1;
+            // counter-clockwise in the (u,v)-plane
+            int n0 = j * numNodesU + i + 1;
+            int n1 = j * numNodesU + iNext + 1;
+            int n2 = (j + 1) * numNodesU + iNext + 1;
+            int n3 = (j + 1) * numNodesU + i + 1;
+            if (triangles) {
+                elem[0] = n0; elem[1] = n1; elem[2] = n2;
+                elem[3] = n0; elem[4] = n2; elem[5] = n3;
+                elem += 6;
+            } else {
+                elem[0] = n0; elem[1] = n1; elem[2] = n2; elem[3] = n3;
+                elem += 4;
+            }
+        }
+    }
+    return mesh;
+}
+
+FEMesh *BenchmarkMeshes::createPlate(std::string name, int numElemsX, int numElemsY, double height,
+        bool triangles) {
+    vector<double> coordinates;
+    for (int j = 0; j <= numElemsY; j++) {
+        for (int i = 0; i <= numElemsX; i++) {
+            coordinates.push_back((double) i / numElemsX);
+            coordinates.push_back(height * j / numElemsY);
+            coordinates.push_back(0.0);
+        }
+    }
+    return createStructuredMesh(name, numElemsX, numElemsY, false, triangles, coordinates);
+}
+
+FEMesh *BenchmarkMeshes::createCylinder(std::string name, int numElemsCircumferential,
+        int numElemsAxial, bool isTube, bool triangles) {
+    const double RADIUS = 1.0;
+    const double LENGTH = 2.0;
+    double angle = isTube ? 2.0 * M_PI : M_PI;
+    int numNodesCircumferential = isTube ? numElemsCircumferential : numElemsCircumferential + 1;
+    vector<double> coordinates;
+    for (int j = 0; j <= numElemsAxial; j++) {
+        for (int i = 0; i < numNodesCircumferential; i++) {
+            double theta = angle * i / numElemsCircumferential;
+            coordinates.push_back(RADIUS * cos(theta));
+            coordinates.push_back(RADIUS * sin(theta));
+            coordinates.push_back(LENGTH * j / numElemsAxial);
+        }
+    }
+    return createStructuredMesh(name, numElemsCircumferential, numElemsAxial, isTube, triangles,
+            coordinates);
+}
+
+IGAMesh *BenchmarkMeshes::createIGAPlate(std::string name, int numKnotSpans, bool isTrimmed) {
+    const int DEGREE = 2;
+    // open uniform knot vector on [0,1]
+    int numKnots = numKnotSpans + 2 * DEGREE + 1;
+    vector<double> knots(numKnots);
+    for (int i = 0; i < numKnots; i++)
+        knots[i] = min(max((double) (i - DEGREE) / numKnotSpans, 0.0), 1.0);
+    // the control points at the Greville abscissae reproduce the parameter space as geometry
+    int numCPs1D = numKnotSpans + DEGREE;
+    vector<double> greville(numCPs1D);
+    for (int i = 0; i < numCPs1D; i++) {
+        greville[i] = 0.0;
+        for (int k = 1; k <= DEGREE; k++)
+            greville[i] += knots[i + k] / DEGREE;
+    }
+    int numCPs = numCPs1D * numCPs1D;
+    vector<double> controlPoints(4 * numCPs);
+    vector<int> dofIndices(numCPs);
+    for (int j = 0; j < numCPs1D; j++) {
+        for (int i = 0; i < numCPs1D; i++) {
+            int cp = j * numCPs1D + i;
+            controlPoints[4 * cp + 0] = greville[i];
+            controlPoints[4 * cp + 1] = greville[j];
+            controlPoints[4 * cp + 2] = 0.0;
+            controlPoints[4 * cp + 3] = 1.0;
+            dofIndices[cp] = cp;
+        }
+    }
+
+    IGAMesh *mesh = new IGAMesh(name, numCPs);
+    IGAPatchSurface *patch = mesh->addPatch(DEGREE, numKnots, &knots[0], DEGREE, numKnots,
+            &knots[0], numCPs1D, numCPs1D, &controlPoints[0], &dofIndices[0]);
+    if (isTrimmed) {
+        // outer loop of four linear curves, counter-clockwise in the parameter space
+        double corners[5][2] = { { 0.0, 0.0 }, { 1.0, 0.0 }, { 1.0, TRIMMED_HEIGHT },
+                { 0.0, TRIMMED_HEIGHT }, { 0.0, 0.0 } };
+        double curveKnots[4] = { 0.0, 0.0, 1.0, 1.0 };
+        patch->addTrimLoop(0, 4);
+        for (int i = 0; i < 4; i++) {
+            double curveCPs[8] = { corners[i][0], corners[i][1], 0.0, 1.0, corners[i + 1][0],
+                    corners[i + 1][1], 0.0, 1.0 };
+            patch->addTrimCurve(1, 1, 4, curveKnots, 2, curveCPs);
+        }
+    }
+    mesh->preparePatches();
+    return mesh;
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,82 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file BenchmarkMeshes.h
+ * This file holds the class BenchmarkMeshes
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef BENCHMARKMESHES_H_
+#define BENCHMARKMESHES_H_
+
+#include <string>
+
+namespace EMPIRE {
+
+class FEMesh;
+class IGAMesh;
+
+/********//**
+ * \brief Class BenchmarkMeshes creates the synthetic meshes of the mapper benchmark. All surfaces
+ *        are parameterized by their number of elements, so that the same geometry can be meshed
+ *        at increasing resolution and with non-matching meshes on both sides of the interface.
+ *        The node IDs start from 1, the surface normals of all meshes of one geometry agree.
+ ***********/
+class BenchmarkMeshes {
+public:
+    /***********************************************************************************************
+     * \brief Create a mesh of the plate [0,1]x[0,height] in the x-y plane
+     * \param[in] name the name of the mesh
+     * \param[in] numElemsX the number of elements in x-direction
+     * \param[in] numElemsY the number of elements in y-direction
+     * \param[in] height the length of the plate in y-direction
+     * \param[in] triangles split every quadrilateral into two triangles
+     * \return the mesh
+     ***********/
+    static FEMesh *createPlate(std::string name, int numElemsX, int numElemsY, double height,
+            bool triangles);
+    /***********************************************************************************************
+     * \brief Create a mesh of a cylinder of radius 1 and length 2 around the z-axis, either of the
+     *        open half cylinder or of the closed tube
+     * \param[in] name the name of the mesh
+     * \param[in] numElemsCircumferential the number of elements in circumferential direction
+     * \param[in] numElemsAxial the number of elements in axial direction
+     * \param[in] isTube the full circumference (closed tube) or the half of it (open cylinder)
+     * \param[in] triangles split every quadrilateral into two triangles
+     * \return the mesh
+     ***********/
+    static FEMesh *createCylinder(std::string name, int numElemsCircumferential, int numElemsAxial,
+            bool isTube, bool triangles);
+    /***********************************************************************************************
+     * \brief Create a single biquadratic B-Spline patch of the plate [0,1]x[0,1] in the x-y plane, the
+     *        patch is prepared for the mapping
+     * \param[in] name the name of the mesh
+     * \param[in] numKnotSpans the number of knot spans in each direction
+     * \param[in] isTrimmed trim the patch to [0,1]x[0,TRIMMED_HEIGHT], cutting a row of knot spans
+     * \return the mesh
+     ***********/
+    static IGAMesh *createIGAPlate(std::string name, int numKnotSpans, bool isTrimmed);
+
+    /// the height of the trimmed IGA plate, no knot of the benchmark patches lies on it
+    static const double TRIMMED_HEIGHT;
+};
+
+} /* namespace EMPIRE */
+#endif /* BENCHMARKMESHES_H_ */
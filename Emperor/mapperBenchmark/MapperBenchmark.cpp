@@ -0,0 +1,312 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <math.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "MapperBenchmark.h"
+#include "BenchmarkMeshes.h"
+#include "MapperAdapter.h"
+#include "FEMesh.h"
+#include "IGAMesh.h"
+#include "FEMeshSpatialIndex.h"
+#include "DataField.h"
+#include "AuxiliaryParameters.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/// the number of elements per edge of the coarsest meshes
+static const int NUM_ELEMS_LEVEL_0 = 16;
+
+/***********************************************************************************************
+ * \brief Get the name of a mapper type as in the input file of Emperor
+ ***********/
+static const char *getMapperName(MapperBenchmark::MapperType mapperType) {
+    switch (mapperType) {
+    case MapperBenchmark::NEAREST_NEIGHBOR:
+        return "nearestNeighborMapper";
+    case MapperBenchmark::NEAREST_ELEMENT:
+        return "nearestElementMapper";
+    case MapperBenchmark::BARYCENTRIC_INTERPOLATION:
+        return "barycentricInterpolationMapper";
+    case MapperBenchmark::MORTAR:
+        return "mortarMapper";
+    case MapperBenchmark::DUAL_MORTAR:
+        return "dualMortarMapper";
+    case MapperBenchmark::IGA_MORTAR:
+        return "IGAMortarMapper";
+    case MapperBenchmark::IGA_BARYCENTRIC:
+        return "IGABarycentricMapper";
+    }
+    return "";
+}
+
+/***********************************************************************************************
+ * \brief Get the resident memory of the process in kB, -1 if unknown
+ ***********/
+static long getResidentMemory() {
+    ifstream statm("/proc/self/statm");
+    long size, resident;
+    if (!(statm >> size >> resident))
+        return -1;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/***********************************************************************************************
+ * \brief Get the peak resident memory of the process in kB
+ ***********/
+static long getPeakMemory() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // kB on Linux
+}
+
+/***********************************************************************************************
+ * \brief Get the number of nodes of a finite element or IGA mesh
+ ***********/
+static int getNumNodes(AbstractMesh *mesh) {
+    if (mesh->type == EMPIRE_Mesh_IGAMesh)
+        return dynamic_cast<IGAMesh *>(mesh)->getNumNodes();
+    return dynamic_cast<FEMesh *>(mesh)->numNodes;
+}
+
+/***********************************************************************************************
+ * \brief Build the search trees of a finite element mesh, so that they are not part of the build
+ *        time of the first mapper
+ ***********/
+static void prepareFEMesh(FEMesh *mesh) {
+    mesh->getSpatialIndex()->getNodesTree();
+    mesh->getSpatialIndex()->getElemAABBTree();
+}
+
+/***********************************************************************************************
+ * \brief Map a field repeatedly for at least a given time
+ * \return the number of mappings per second
+ ***********/
+static double measureMappings(MapperAdapter *mapper, const DataField *fieldFrom, DataField *fieldTo,
+        bool isConsistent, double minTime) {
+    const int MIN_NUM_MAPPINGS = 3;
+    int numMappings = 0;
+    double startTime = omp_get_wtime();
+    double time;
+    do {
+        if (isConsistent)
+            mapper->consistentMapping(fieldFrom, fieldTo);
+        else
+            mapper->conservativeMapping(fieldFrom, fieldTo);
+        numMappings++;
+        time = omp_get_wtime() - startTime;
+    } while (numMappings < MIN_NUM_MAPPINGS || time < minTime);
+    return numMappings / time;
+}
+
+MapperBenchmark::MapperBenchmark(int _numLevels, const std::vector<int> &_threadCounts,
+        double _minMappingTime) :
+        numLevels(_numLevels), threadCounts(_threadCounts), minMappingTime(_minMappingTime) {
+    assert(numLevels > 0);
+    assert(!threadCounts.empty());
+}
+
+MapperBenchmark::~MapperBenchmark() {
+}
+
+void MapperBenchmark::run() {
+    for (int level = 0; level < numLevels; level++) {
+        int n = NUM_ELEMS_LEVEL_0 << level;
+        // the non-matching mesh B is finer by 3/2 and of triangles
+        int nB = 3 * n / 2 + 1;
+        for (int geometry = 0; geometry < 3; geometry++) {
+            for (int matching = 1; matching >= 0; matching--) {
+                FEMesh *meshA, *meshB;
+                Case theCase;
+                theCase.level = level;
+                theCase.isMatching = matching;
+                if (geometry == 0) {
+                    theCase.geometry = "plate";
+                    meshA = BenchmarkMeshes::createPlate("A", n, n, 1.0, false);
+                    meshB = matching ? BenchmarkMeshes::createPlate("B", n, n, 1.0, false) :
+                            BenchmarkMeshes::createPlate("B", nB, nB, 1.0, true);
+                } else {
+                    bool isTube = (geometry == 2);
+                    theCase.geometry = isTube ? "tube" : "cylinder";
+                    int nCircumferential = isTube ? 4 * n : 2 * n;
+                    int nBCircumferential = isTube ? 4 * nB : 2 * nB;
+                    meshA = BenchmarkMeshes::createCylinder("A", nCircumferential, n, isTube, false);
+                    meshB = matching ?
+                            BenchmarkMeshes::createCylinder("B", nCircumferential, n, isTube, false) :
+                            BenchmarkMeshes::createCylinder("B", nBCircumferential, nB, isTube, true);
+                }
+                theCase.numNodesA = meshA->numNodes;
+                theCase.numElemsA = meshA->numElems;
+                theCase.numNodesB = meshB->numNodes;
+                theCase.numElemsB = meshB->numElems;
+                runFECase(theCase, meshA, meshB);
+                delete meshA;
+                delete meshB;
+            }
+        }
+        for (int trimmed = 0; trimmed <= 1; trimmed++) {
+            // the finite element mesh is finer than the knot spans, it only covers the trimmed domain
+            double height = trimmed ? BenchmarkMeshes::TRIMMED_HEIGHT : 1.0;
+            int nBY = (int) ceil(height * nB);
+            IGAMesh *meshA = BenchmarkMeshes::createIGAPlate("A", n, trimmed);
+            FEMesh *meshB = BenchmarkMeshes::createPlate("B", nB, nBY, height, false);
+            Case theCase;
+            theCase.geometry = trimmed ? "trimmedIGAPlate" : "IGAPlate";
+            theCase.level = level;
+            theCase.isMatching = false;
+            theCase.numNodesA = meshA->getNumNodes();
+            theCase.numElemsA = n * n;
+            theCase.numNodesB = meshB->numNodes;
+            theCase.numElemsB = meshB->numElems;
+            runIGACase(theCase, meshA, meshB);
+            delete meshA;
+            delete meshB;
+        }
+    }
+}
+
+void MapperBenchmark::runFECase(const Case &theCase, AbstractMesh *meshA, AbstractMesh *meshB) {
+    prepareFEMesh(dynamic_cast<FEMesh *>(meshA));
+    prepareFEMesh(dynamic_cast<FEMesh *>(meshB));
+    runMapper(theCase, NEAREST_NEIGHBOR, meshA, meshB);
+    runMapper(theCase, NEAREST_ELEMENT, meshA, meshB);
+    runMapper(theCase, BARYCENTRIC_INTERPOLATION, meshA, meshB);
+    runMapper(theCase, MORTAR, meshA, meshB);
+    runMapper(theCase, DUAL_MORTAR, meshA, meshB);
+}
+
+void MapperBenchmark::runIGACase(const Case &theCase, AbstractMesh *meshA, AbstractMesh *meshB) {
+    prepareFEMesh(dynamic_cast<FEMesh *>(meshB));
+    runMapper(theCase, IGA_MORTAR, meshA, meshB);
+    runMapper(theCase, IGA_BARYCENTRIC, meshA, meshB);
+}
+
+void MapperBenchmark::runMapper(const Case &theCase, MapperType mapperType, AbstractMesh *meshA,
+        AbstractMesh *meshB) {
+    int numNodesA = getNumNodes(meshA);
+    int numNodesB = getNumNodes(meshB);
+    DataField fieldA("fieldA", EMPIRE_DataField_atNode, numNodesA, EMPIRE_DataField_scalar,
+            EMPIRE_DataField_field);
+    DataField fieldB("fieldB", EMPIRE_DataField_atNode, numNodesB, EMPIRE_DataField_scalar,
+            EMPIRE_DataField_field);
+    for (int i = 0; i < numNodesA; i++)
+        fieldA.data[i] = sin(0.1 * i);
+    for (int i = 0; i < numNodesB; i++)
+        fieldB.data[i] = 0.0;
+
+    double firstBuildTime = 0.0;
+    for (int t = 0; t < threadCounts.size(); t++) {
+        Result result;
+        result.theCase = theCase;
+        result.mapperType = mapperType;
+        result.numThreads = threadCounts[t];
+        cout << "mapperBenchmark: " << theCase.geometry << " level " << theCase.level
+                << (theCase.isMatching ? " matching " : " non-matching ")
+                << getMapperName(mapperType) << " with " << result.numThreads << " threads"
+                << endl;
+        omp_set_num_threads(result.numThreads);
+
+        long memoryBefore = getResidentMemory();
+        double startTime = omp_get_wtime();
+        MapperAdapter *mapper = new MapperAdapter(getMapperName(mapperType), meshA, meshB);
+        mapper->setNumThreads(result.numThreads);
+        switch (mapperType) {
+        case NEAREST_NEIGHBOR:
+            mapper->initNearestNeighborMapper();
+            break;
+        case NEAREST_ELEMENT:
+            mapper->initNearestElementMapper();
+            break;
+        case BARYCENTRIC_INTERPOLATION:
+            mapper->initBarycentricInterpolationMapper();
+            break;
+        case MORTAR:
+            mapper->initMortarMapper(false, false, false);
+            break;
+        case DUAL_MORTAR:
+            mapper->initMortarMapper(false, true, false);
+            break;
+        case IGA_MORTAR: // the defaults of the input file of Emperor
+            mapper->initIGAMortarMapper(false, 0.0, 1e-2, 10, 1e-3, 20, 1e-9, 20, 1e-9, 40, 1e-6,
+                    true, 16, true, 25, false, 1e-6,
+                    false, false, false, false, false, 0.0, 0.0, 0.0,
+                    false, false, false, 0.0,
+                    false, false, false, false, false, 0.0, 0.0, 0.0,
+                    false,
+                    false, false, false, false);
+            break;
+        case IGA_BARYCENTRIC:
+            mapper->initIGABarycentricMapper(1e-2, 10, 1e-3, 20, 1e-9);
+            break;
+        }
+        result.buildTime = omp_get_wtime() - startTime;
+        long memoryAfter = getResidentMemory();
+        result.memoryIncrease = (memoryBefore < 0 || memoryAfter < 0) ? -1 : memoryAfter - memoryBefore;
+        if (t == 0)
+            firstBuildTime = result.buildTime;
+        result.buildSpeedup = firstBuildTime / result.buildTime;
+
+        result.consistentMappingsPerSecond = measureMappings(mapper, &fieldA, &fieldB, true,
+                minMappingTime);
+        result.conservativeMappingsPerSecond = measureMappings(mapper, &fieldB, &fieldA, false,
+                minMappingTime);
+        delete mapper;
+        result.peakMemory = getPeakMemory();
+        results.push_back(result);
+    }
+}
+
+void MapperBenchmark::writeJSON(const std::string &fileName) const {
+    ofstream file(fileName.c_str());
+    file << "{\n";
+    file << "  \"gitSHA1\": \"" << AuxiliaryParameters::gitSHA1 << "\",\n";
+    file << "  \"gitTAG\": \"" << AuxiliaryParameters::gitTAG << "\",\n";
+    file << "  \"numProcessors\": " << omp_get_num_procs() << ",\n";
+    file << "  \"results\": [";
+    for (int i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        const Case &theCase = result.theCase;
+        file << (i == 0 ? "\n" : ",\n");
+        file << "    {\"geometry\": \"" << theCase.geometry << "\", \"level\": " << theCase.level
+                << ", \"matching\": " << (theCase.isMatching ? "true" : "false")
+                << ", \"mapper\": \"" << getMapperName(result.mapperType) << "\""
+                << ", \"numNodesA\": " << theCase.numNodesA << ", \"numElemsA\": "
+                << theCase.numElemsA << ", \"numNodesB\": " << theCase.numNodesB
+                << ", \"numElemsB\": " << theCase.numElemsB << ", \"numThreads\": "
+                << result.numThreads << setprecision(6) << ", \"buildTime\": " << result.buildTime
+                << ", \"buildSpeedup\": " << result.buildSpeedup
+                << ", \"consistentMappingsPerSecond\": " << result.consistentMappingsPerSecond
+                << ", \"conservativeMappingsPerSecond\": " << result.conservativeMappingsPerSecond
+                << ", \"memoryIncreaseKB\": " << result.memoryIncrease << ", \"peakMemoryKB\": "
+                << result.peakMemory << "}";
+    }
+    file << "\n  ]\n}\n";
+}
+
+} /* namespace EMPIRE */
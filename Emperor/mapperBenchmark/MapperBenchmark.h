@@ -0,0 +1,156 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file MapperBenchmark.h
+ * This file holds the class MapperBenchmark
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef MAPPERBENCHMARK_H_
+#define MAPPERBENCHMARK_H_
+
+#include <string>
+#include <vector>
+
+namespace EMPIRE {
+
+class AbstractMesh;
+
+/********//**
+ * \brief Class MapperBenchmark runs every mapper type on the synthetic meshes of BenchmarkMeshes at
+ *        increasing resolution and with several numbers of threads. For every run it records the
+ *        time to build the coupling matrices, the number of scalar fields mapped per second and
+ *        the memory, the results are written as JSON to compare releases.
+ ***********/
+class MapperBenchmark {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _numLevels the number of mesh resolutions, each level doubles the elements per edge
+     * \param[in] _threadCounts the numbers of threads every mapper is built and run with
+     * \param[in] _minMappingTime the minimum time in seconds spent in repeated mappings of one run
+     ***********/
+    MapperBenchmark(int _numLevels, const std::vector<int> &_threadCounts, double _minMappingTime);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~MapperBenchmark();
+    /***********************************************************************************************
+     * \brief Run all cases of the benchmark
+     ***********/
+    void run();
+    /***********************************************************************************************
+     * \brief Write the results to a JSON file
+     * \param[in] fileName the name of the file
+     ***********/
+    void writeJSON(const std::string &fileName) const;
+
+    /// the mapper types of the benchmark
+    enum MapperType {
+        NEAREST_NEIGHBOR,
+        NEAREST_ELEMENT,
+        BARYCENTRIC_INTERPOLATION,
+        MORTAR,
+        DUAL_MORTAR,
+        IGA_MORTAR,
+        IGA_BARYCENTRIC
+    };
+
+    /********//**
+     * \brief Struct Case is a pair of meshes of one geometry at one resolution
+     ***********/
+    struct Case {
+        /// the name of the geometry
+        std::string geometry;
+        /// the level of the resolution
+        int level;
+        /// whether mesh B is a copy of mesh A
+        bool isMatching;
+        /// the number of nodes (control points of an IGA mesh) of mesh A
+        int numNodesA;
+        /// the number of elements (knot spans of an IGA mesh) of mesh A
+        int numElemsA;
+        /// the number of nodes of mesh B
+        int numNodesB;
+        /// the number of elements of mesh B
+        int numElemsB;
+    };
+
+    /********//**
+     * \brief Struct Result is the measurement of one mapper on one case with one number of threads
+     ***********/
+    struct Result {
+        /// the case
+        Case theCase;
+        /// the mapper type
+        MapperType mapperType;
+        /// the number of threads
+        int numThreads;
+        /// the wall time of building the coupling matrices in seconds
+        double buildTime;
+        /// the build time with the first number of threads divided by buildTime
+        double buildSpeedup;
+        /// the number of consistent mappings of a scalar field per second
+        double consistentMappingsPerSecond;
+        /// the number of conservative mappings of a scalar field per second
+        double conservativeMappingsPerSecond;
+        /// the increase of the resident memory by building the mapper in kB, -1 if unknown
+        long memoryIncrease;
+        /// the peak resident memory of the process after the run in kB
+        long peakMemory;
+    };
+
+private:
+    /***********************************************************************************************
+     * \brief Run the finite element mappers on a case
+     * \param[in] theCase the case
+     * \param[in] meshA mesh A
+     * \param[in] meshB mesh B
+     ***********/
+    void runFECase(const Case &theCase, AbstractMesh *meshA, AbstractMesh *meshB);
+    /***********************************************************************************************
+     * \brief Run the IGA mappers on a case
+     * \param[in] theCase the case
+     * \param[in] meshA mesh A, an IGA mesh
+     * \param[in] meshB mesh B, a finite element mesh
+     ***********/
+    void runIGACase(const Case &theCase, AbstractMesh *meshA, AbstractMesh *meshB);
+    /***********************************************************************************************
+     * \brief Build and run one mapper with every number of threads
+     * \param[in] theCase the case
+     * \param[in] mapperType the mapper type
+     * \param[in] meshA mesh A
+     * \param[in] meshB mesh B
+     ***********/
+    void runMapper(const Case &theCase, MapperType mapperType, AbstractMesh *meshA,
+            AbstractMesh *meshB);
+
+    /// the number of mesh resolutions
+    int numLevels;
+    /// the numbers of threads
+    std::vector<int> threadCounts;
+    /// the minimum time spent in repeated mappings of one run
+    double minMappingTime;
+    /// the results in the order of the runs
+    std::vector<Result> results;
+};
+
+} /* namespace EMPIRE */
+#endif /* MAPPERBENCHMARK_H_ */
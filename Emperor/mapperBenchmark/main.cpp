@@ -0,0 +1,52 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <stdlib.h>
+#include <iostream>
+#include <vector>
+#include "MapperBenchmark.h"
+
+using namespace EMPIRE;
+using namespace std;
+
+/***********************************************************************************************
+ * Usage: mapperBenchmark [result.json [numLevels [numThreads ...]]]
+ * By default the results are written to mapperBenchmark.json, 3 mesh resolutions are run with one
+ * thread and with all processors.
+ ***********/
+int main(int argc, char** argv) {
+    string fileName = (argc > 1) ? argv[1] : "mapperBenchmark.json";
+    int numLevels = (argc > 2) ? atoi(argv[2]) : 3;
+    vector<int> threadCounts;
+    for (int i = 3; i < argc; i++)
+        threadCounts.push_back(atoi(argv[i]));
+    if (threadCounts.empty()) {
+        threadCounts.push_back(1);
+        if (omp_get_num_procs() > 1)
+            threadCounts.push_back(omp_get_num_procs());
+    }
+    MapperBenchmark *benchmark = new MapperBenchmark(numLevels, threadCounts, 0.5);
+    benchmark->run();
+    benchmark->writeJSON(fileName);
+    delete benchmark;
+    cout << endl << "================================================" << endl;
+    cout << "Results written to " << fileName << endl;
+}
@@ -24,7 +24,9 @@
  * \date 5/12/2014
  **************************************************************************************************/
 #include <assert.h>
+#include <pthread.h>
 #include <string>
+#include <algorithm>
 
 #include "AbstractMesh.h"
 #include "FEMesh.h"
@@ -40,6 +42,8 @@
 #include "MortarMapper.h"
 #include "IGAMortarMapper.h"
 #include "MapperLib.h"
+#include "NumaMemory.h"
+#include "CouplingMatricesCache.h"
 
 using namespace EMPIRE;
 using namespace std;
@@ -49,8 +53,213 @@ std::map <std::string, AbstractMapper*> mapperList;
 /// AbstractMesh object map in the global scope
 std::map <std::string, AbstractMesh*> meshList;
 
+/********//**
+ * \brief A mapper as seen through the handle API, owned by the library
+ ***********/
+struct mapper_handle {
+    /// the mapper, owned by mapperList
+    AbstractMapper *mapper;
+    /// the name of the mapper in mapperList
+    std::string name;
+    /// serializes the mappings done with this mapper, the mappers keep work arrays and solver states
+    pthread_mutex_t mutex;
+};
+
+/// the handles given out for the mappers in mapperList
+std::map <AbstractMapper*, mapper_handle*> handleList;
+
+/********//**
+ * \brief The meshes and parameters a mapper is built from, they identify the files of saveMapper
+ ***********/
+struct mapper_origin {
+    /// name of mesh A in meshList
+    std::string meshNameA;
+    /// name of mesh B in meshList
+    std::string meshNameB;
+    /// the parameters set through the API by the name of the setter, the last call of a setter wins
+    std::map<std::string, std::vector<double> > parameters;
+    /// whether the coupling matrices are built or loaded
+    bool isBuilt;
+};
+
+/// the origins of the mappers in mapperList which are created from meshes in meshList
+std::map <std::string, mapper_origin> originList;
+
+/// all accesses of mapperList, meshList and handleList are serialized by this mutex
+static pthread_mutex_t registryMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/********//**
+ * \brief Class RegistryLock locks registryMutex during its lifetime
+ ***********/
+class RegistryLock {
+public:
+    RegistryLock() {
+        pthread_mutex_lock(&registryMutex);
+    }
+    ~RegistryLock() {
+        pthread_mutex_unlock(&registryMutex);
+    }
+};
+
+/********//**
+ * \brief Class MapperLock locks the mutex of a mapper handle during its lifetime
+ ***********/
+class MapperLock {
+public:
+    MapperLock(mapper_handle *_handle) :
+            handle(_handle) {
+        pthread_mutex_lock(&handle->mutex);
+    }
+    ~MapperLock() {
+        pthread_mutex_unlock(&handle->mutex);
+    }
+private:
+    mapper_handle *handle;
+};
+
+/***********************************************************************************************
+ * \brief Get the handle of a mapper, the handle is created at the first call. registryMutex must be locked.
+ * \param[in] mapperName name of the mapper
+ * \return the handle or NULL if no mapper with this name exists
+ ***********/
+static mapper_handle *findMapperHandle(const std::string &mapperName) {
+    std::map<std::string, AbstractMapper*>::iterator iter = mapperList.find(mapperName);
+    if (iter == mapperList.end())
+        return NULL;
+    mapper_handle *&handle = handleList[iter->second];
+    if (handle == NULL) {
+        handle = new mapper_handle;
+        handle->mapper = iter->second;
+        handle->name = mapperName;
+        pthread_mutex_init(&handle->mutex, NULL);
+    }
+    return handle;
+}
+
+/***********************************************************************************************
+ * \brief Delete the handle of a mapper if one was given out. registryMutex must be locked.
+ * \param[in] mapper the mapper
+ ***********/
+static void deleteMapperHandle(AbstractMapper *mapper) {
+    std::map<AbstractMapper*, mapper_handle*>::iterator iter = handleList.find(mapper);
+    if (iter == handleList.end())
+        return;
+    pthread_mutex_destroy(&iter->second->mutex);
+    delete iter->second;
+    handleList.erase(iter);
+}
+
+/***********************************************************************************************
+ * \brief Record the parameters a mapper is built with, if its origin is known. registryMutex must be locked.
+ * \param[in] mapperName name of the mapper
+ * \param[in] setter name of the function setting the parameters
+ * \param[in] values the parameters
+ * \param[in] numValues number of parameters
+ ***********/
+static void recordParameters(const std::string &mapperName, const std::string &setter, const double *values, int numValues) {
+    std::map<std::string, mapper_origin>::iterator iter = originList.find(mapperName);
+    if (iter != originList.end())
+        iter->second.parameters[setter].assign(values, values + numValues);
+}
+
+/***********************************************************************************************
+ * \brief Add the type, the content of the meshes and the parameters of a mapper to the key of a
+ *        cache. registryMutex must be locked.
+ * \param[in] mapperName name of the mapper
+ * \param[in] cache the cache
+ * \return false if the mapper is not created from meshes in meshList or they were deleted
+ ***********/
+static bool addMapperToKey(const std::string &mapperName, CouplingMatricesCache &cache) {
+    std::map<std::string, mapper_origin>::iterator iter = originList.find(mapperName);
+    if (iter == originList.end()) {
+        ERROR_OUT(mapperName + " is not created from meshes of the library");
+        return false;
+    }
+    const mapper_origin &origin = iter->second;
+    if (!meshList.count( origin.meshNameA ) || !meshList.count( origin.meshNameB )) {
+        ERROR_OUT("The meshes of " + mapperName + " have been deleted");
+        return false;
+    }
+    cache.addToKey((int) mapperList[mapperName]->mapperType);
+    cache.addMeshToKey(meshList[origin.meshNameA]);
+    cache.addMeshToKey(meshList[origin.meshNameB]);
+    for (std::map<std::string, std::vector<double> >::const_iterator it = origin.parameters.begin();
+            it != origin.parameters.end(); it++) {
+        cache.addToKey(it->first);
+        for (size_t i = 0; i < it->second.size(); i++)
+            cache.addToKey(it->second[i]);
+    }
+    return true;
+}
+
+/***********************************************************************************************
+ * \brief Consistent mapping of an interleaved field, the caller holds the lock of the mapper
+ ***********/
+static void consistentMapping(AbstractMapper *mapper, int dimension, int dataSizeA, const double* dataA, int dataSizeB, double* dataB){
+    if (dynamic_cast<IGAMortarMapper *>(mapper) != NULL && dynamic_cast<IGAMortarMapper *>(mapper)->getIsExpanded() ) {
+        // if the matrices contain coupling entries between x,y,z components then the fields are mapped as they are
+        mapper->consistentMapping(dataA, dataB);
+    }
+    else {
+        // else the field is mapped componentwise
+        int numLocationsA = dataSizeA/dimension;
+        int numLocationsB = dataSizeB/dimension;
+
+        double *fieldADOFi = new double[numLocationsA];
+        double *fieldBDOFi = new double[numLocationsB];
+        for (int i = 0; i < dimension; i++) {
+            for (int j = 0; j < numLocationsA; j++)
+                fieldADOFi[j] = dataA[j * dimension + i];
+            mapper->consistentMapping(fieldADOFi, fieldBDOFi);
+            for (int j = 0; j < numLocationsB; j++)
+                dataB[j * dimension + i] = fieldBDOFi[j];
+        }
+        delete[] fieldADOFi;
+        delete[] fieldBDOFi;
+    }
+}
+
+/***********************************************************************************************
+ * \brief Conservative mapping of an interleaved field, the caller holds the lock of the mapper
+ ***********/
+static void conservativeMapping(AbstractMapper *mapper, int dimension, int dataSizeB, const double* dataB, int dataSizeA, double* dataA){
+    // if a vector field is to be mapped x, y, z components are extracted
+    if (dimension == 3){
+        int sizeDataToMap = dataSizeB/dimension;
+        int sizeDataToWrite = dataSizeA/dimension;
+
+        double** dataBtoMap = new double*[dimension];
+        double** dataAtoWrite = new double*[dimension];
+
+        for (int i=0; i<dimension ; i++){
+            dataBtoMap[i]=new double[sizeDataToMap];
+            dataAtoWrite[i]=new double[sizeDataToWrite];
+        }
+        for (int i=0 ; i<dimension ; i++){
+            for (int j=0 ; j<sizeDataToMap; j++){
+                dataBtoMap[i][j] = dataB[j*dimension+i];
+            }
+            mapper->conservativeMapping(dataBtoMap[i], dataAtoWrite[i]);
+            for (int j=0 ; j<sizeDataToWrite; j++){
+                dataA[j*dimension+i] = dataAtoWrite[i][j];
+            }
+        }
+        for (int i = 0; i<dimension; i++){
+            delete[] dataBtoMap[i];
+            delete[] dataAtoWrite[i];
+        }
+        delete[] dataBtoMap;
+        delete[] dataAtoWrite;
+    }
+    // else field is mapped as it is
+    else {
+        mapper->conservativeMapping(dataB, dataA);
+    }
+}
+
 void init_FE_NearestNeighborMapper(char* mapperName, 
                                    int AnumNodes, const double *Anodes, int BnumNodes, const double *Bnodes){
+    RegistryLock lock;
 
     WARNING_OUT("In \"init_FE_NearestNeighborMapper\": This interface function of the mapper library is going to be removed!");
     WARNING_OUT("Please check \"initFEMNearestNeighborMapper\" for the new declaration.");
@@ -71,6 +280,7 @@ void init_FE_NearestNeighborMapper(char* mapperName,
 void init_FE_NearestElementMapper(char* mapperName,
                                   int AnumNodes, int AnumElems, const int *AnumNodesPerElem, const double *Anodes, const int *AnodeIDs, const int *Aelems,
                                   int BnumNodes, int BnumElems, const int *BnumNodesPerElem, const double *Bnodes, const int *BnodeIDs, const int *Belems){
+    RegistryLock lock;
     
     WARNING_OUT("In \"init_FE_NearestElementMapper\": This interface function of the mapper library is going to be removed!");
     WARNING_OUT("Please check \"initFEMNearestElementMapper\" for the new declaration.");
@@ -91,6 +301,7 @@ void init_FE_NearestElementMapper(char* mapperName,
 
 void init_FE_BarycentricInterpolationMapper(char* mapperName, 
                                             int AnumNodes, const double *Anodes, int BnumNodes, const double *Bnodes){
+    RegistryLock lock;
 
     WARNING_OUT("In \"init_FE_BarycentricInterpolationMapper\": This interface function of the mapper library is going to be removed!");
     WARNING_OUT("Please check \"initFEMBarycentricInterpolationMapper\" for the new declaration.");
@@ -111,6 +322,7 @@ void init_FE_MortarMapper(char* mapperName,
                           int AnumNodes, int AnumElems, const int* AnumNodesPerElem, const double* Anodes, const int* AnodeIDs, const int* Aelems,
                           int BnumNodes, int BnumElems, const int* BnumNodesPerElem, const double* Bnodes, const int* BnodeIDs, const int* Belems,
                           int oppositeSurfaceNormal, int dual, int enforceConsistency){
+    RegistryLock lock;
 
     WARNING_OUT("In \"init_FE_MortarMapper\": This interface function of the mapper library is going to be removed!");
     WARNING_OUT("Please check \"initFEMMortarMapper\" for the new declaration.");
@@ -140,6 +352,7 @@ void init_FE_MortarMapper(char* mapperName,
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
 void initFEMesh(char* meshName, int numNodes, int numElems, bool triangulateAll = false){
+    RegistryLock lock;
 
     std::string meshNameToMap = std::string(meshName);
 
@@ -155,6 +368,7 @@ void initFEMesh(char* meshName, int numNodes, int numElems, bool triangulateAll
 }
 
 void setNodesToFEMesh(char* meshName, int* nodeIDs, double* nodes){
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -171,6 +385,7 @@ void setNodesToFEMesh(char* meshName, int* nodeIDs, double* nodes){
 }
 
 void setElementsToFEMesh(char* meshName, int* numNodesPerElem, int* elems){
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -189,6 +404,7 @@ void setElementsToFEMesh(char* meshName, int* numNodesPerElem, int* elems){
 }
 
 void initIGAMesh(char* meshName){
+    RegistryLock lock;
 
     std::string meshNameToMap = std::string(meshName);
 
@@ -207,6 +423,7 @@ void addPatchToIGAMesh(char* meshName,
                        int qDegree, int vNoKnots, double* vKnotVector,
                        int uNoControlPoints, int vNoControlPoints,
                        double* controlPointNet, int* dofIndexNet){
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -226,6 +443,7 @@ void addPatchToIGAMesh(char* meshName,
 
 void addTrimmingLoopToPatch(char* meshName, int patchIndex,
                             int inner, int numCurves){
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -243,6 +461,7 @@ void addTrimmingLoopToPatch(char* meshName, int patchIndex,
 void addTrimmingCurveToTrimmingLoop(char* meshName, int patchIndex,
                                     int direction, int pDegree, int uNoKnots, double* uKnotVector,
                                     int uNoControlPoints, double* controlPoints){
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -259,6 +478,7 @@ void addTrimmingCurveToTrimmingLoop(char* meshName, int patchIndex,
 }
 
 void linearizeTrimmingLoops(char* meshName, int patchIndex){
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -268,8 +488,13 @@ void linearizeTrimmingLoops(char* meshName, int patchIndex){
         return;
     } else if (meshList[meshNameInMap]->type == EMPIRE_Mesh_IGAMesh){
         IGAMesh *tmpIGAMesh = dynamic_cast<IGAMesh *>(meshList[meshNameInMap]);
-        tmpIGAMesh->getSurfacePatch(patchIndex)->linearizeTrimming();
-        INFO_OUT()<<"Linearized trimming curves of \"" << meshNameInMap << "\" patch index " << patchIndex <<  std::endl;
+        if (patchIndex < 0) {
+            tmpIGAMesh->preparePatches();
+            INFO_OUT()<<"Linearized trimming curves of all patches of \"" << meshNameInMap << "\"" <<  std::endl;
+        } else {
+            tmpIGAMesh->getSurfacePatch(patchIndex)->linearizeTrimming();
+            INFO_OUT()<<"Linearized trimming curves of \"" << meshNameInMap << "\" patch index " << patchIndex <<  std::endl;
+        }
     }
 }
 
@@ -277,6 +502,7 @@ void addDirichletCurveConditionToIGAMesh(char* meshName,
                                          int conditionID, int patchIndex,
                                          int pDegree, int uNoKnots, double* uKnotVector,
                                          int uNoControlPoints, double* controlPointNet) {
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -295,6 +521,7 @@ void addDirichletCurveConditionToIGAMesh(char* meshName,
 void addDirichletBoundaryConditionToIGAMesh(char* meshName,
                                             int conditionID,
                                             int patchIndex, int patchBLIndex, int patchBLTrCurveIndex) {
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -314,6 +541,7 @@ void addPatchContinuityConditionToIGAMesh(char* meshName,
                                           int connectionID,
                                           int masterPatchIndex, int masterPatchBLIndex, int masterPatchBLTrCurveIndex,
                                           int slavePatchIndex,  int slavePatchBLIndex,  int slavePatchBLTrCurveIndex) {
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -335,6 +563,7 @@ void addPatchContinuityConditionOnCurvesToIGAMesh(char* meshName,
                                                   int connectionID,
                                                   int masterPatchIndex, int pMaster, int uNoKnotsMaster, double* uKnotVectorMaster, int uNoControlPointsMaster, double* controlPointNetMaster,
                                                   int slavePatchIndex,  int pSlave, int uNoKnotsSlave, double* uKnotVectorSlave, int uNoControlPointsSlave, double* controlPointNetSlave) {
+    RegistryLock lock;
 
     std::string meshNameInMap = std::string(meshName);
 
@@ -355,6 +584,7 @@ void addPatchContinuityConditionOnCurvesToIGAMesh(char* meshName,
 
 void initFEMMortarMapper(char* mapperName, char* AmeshName, char* BmeshName,
                          int oppositeSurfaceNormal, int dual, int enforceConsistency){
+    RegistryLock lock;
 
     std::string mapperNameToMap = std::string(mapperName);
     std::string aFEMeshNameInMap = std::string(AmeshName);
@@ -409,12 +639,19 @@ void initFEMMortarMapper(char* mapperName, char* AmeshName, char* BmeshName,
         mapperList[mapperNameToMap] = new MortarMapper(tmpaFEMesh->numNodes, tmpaFEMesh->numElems, tmpaFEMesh->numNodesPerElem, tmpaFEMesh->nodes, tmpaFEMesh->nodeIDs, tmpaFEMesh->elems,
                                                        tmpbFEMesh->numNodes, tmpbFEMesh->numElems, tmpbFEMesh->numNodesPerElem, tmpbFEMesh->nodes, tmpbFEMesh->nodeIDs, tmpbFEMesh->elems,
                                                        _oppositeSurfaceNormal, _dual, _enforceConsistency);
+        mapper_origin &origin = originList[mapperNameToMap];
+        origin.meshNameA = aFEMeshNameInMap;
+        origin.meshNameB = bFEMeshNameInMap;
+        origin.isBuilt = false;
+        double parameters[] = {(double) _oppositeSurfaceNormal, (double) _dual, (double) _enforceConsistency};
+        recordParameters(mapperNameToMap, "initFEMMortarMapper", parameters, 3);
         INFO_OUT("Generated \"" +  mapperNameToMap);
     }
 
 }
 
 void initFEMNearestNeighborMapper(char* mapperName, char* AmeshName, char* BmeshName){
+    RegistryLock lock;
 
     std::string mapperNameToMap = std::string(mapperName);
     std::string aFEMeshNameInMap = std::string(AmeshName);
@@ -466,6 +703,7 @@ void initFEMNearestNeighborMapper(char* mapperName, char* AmeshName, char* Bmesh
 }
 
 void initFEMNearestElementMapper(char* mapperName, char* AmeshName, char* BmeshName){
+    RegistryLock lock;
 
     std::string mapperNameToMap = std::string(mapperName);
     std::string aFEMeshNameInMap = std::string(AmeshName);
@@ -516,6 +754,7 @@ void initFEMNearestElementMapper(char* mapperName, char* AmeshName, char* BmeshN
 }
 
 void initFEMBarycentricInterpolationMapper(char* mapperName, char* AmeshName, char* BmeshName){
+    RegistryLock lock;
 
     std::string mapperNameToMap = std::string(mapperName);
     std::string aFEMeshNameInMap = std::string(AmeshName);
@@ -566,6 +805,7 @@ void initFEMBarycentricInterpolationMapper(char* mapperName, char* AmeshName, ch
 }
 
 void initIGAMortarMapper(char* _mapperName, char* _meshNameA, char* _meshNameB){
+    RegistryLock lock;
 
     std::string mapperNameToMap = std::string(_mapperName);
     std::string meshNameAInMap = std::string(_meshNameA);
@@ -600,12 +840,17 @@ void initIGAMortarMapper(char* _mapperName, char* _meshNameA, char* _meshNameB){
         if (!meshB->boundingBox.isComputed()) meshB->computeBoundingBox();
 
         mapperList[mapperNameToMap] = new IGAMortarMapper(mapperNameToMap, meshA, meshB);
+        mapper_origin &origin = originList[mapperNameToMap];
+        origin.meshNameA = meshNameAInMap;
+        origin.meshNameB = meshNameBInMap;
+        origin.isBuilt = false;
         INFO_OUT("Generated \"" +  mapperNameToMap + "\"");
     }
 }
 
 void setParametersConsistency(char* mapperName,
                               bool _enforceConsistency, double _tolConsistency){
+    RegistryLock lock;
 
     std::string mapperNameInMap = std::string(mapperName);
 
@@ -623,6 +868,8 @@ void setParametersConsistency(char* mapperName,
     } else {
         tmpIGAMortarMapper = dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]);
         tmpIGAMortarMapper->setParametersConsistency(_enforceConsistency, _tolConsistency);
+        double parameters[] = {(double) _enforceConsistency, _tolConsistency};
+        recordParameters(mapperNameInMap, "setParametersConsistency", parameters, 2);
         INFO_OUT("Enforce consistency parameter is set for \"" +  mapperNameInMap + "\"");
     }
 }
@@ -630,6 +877,7 @@ void setParametersConsistency(char* mapperName,
 void setParametersProjection(char* mapperName,
                              double maxProjectionDistance, int numRefinementForIntialGuess,
                              double maxDistanceForProjectedPointsOnDifferentPatches){
+    RegistryLock lock;
 
     std::string mapperNameInMap = std::string(mapperName);
 
@@ -648,6 +896,8 @@ void setParametersProjection(char* mapperName,
     else{
         tmpIGAMortarMapper = dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]);
         tmpIGAMortarMapper->setParametersProjection(maxProjectionDistance, numRefinementForIntialGuess, maxDistanceForProjectedPointsOnDifferentPatches);
+        double parameters[] = {maxProjectionDistance, (double) numRefinementForIntialGuess, maxDistanceForProjectedPointsOnDifferentPatches};
+        recordParameters(mapperNameInMap, "setParametersProjection", parameters, 3);
         INFO_OUT("Point projection parameters are set for \"" +  mapperNameInMap + "\"");
     }
 
@@ -655,6 +905,7 @@ void setParametersProjection(char* mapperName,
 
 void setParametersNewtonRaphson(char* mapperName,
                                 int maxNumOfIterations, double tolerance){
+    RegistryLock lock;
 
     std::string mapperNameInMap = std::string(mapperName);
 
@@ -673,12 +924,15 @@ void setParametersNewtonRaphson(char* mapperName,
     else{
         tmpIGAMortarMapper = dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]);
         tmpIGAMortarMapper->setParametersNewtonRaphson(maxNumOfIterations, tolerance);
+        double parameters[] = {(double) maxNumOfIterations, tolerance};
+        recordParameters(mapperNameInMap, "setParametersNewtonRaphson", parameters, 2);
         INFO_OUT("Point projection Newton Raphson parameters are set for \"" +  mapperNameInMap + "\"");
     }
 }
 
 void setParametersNewtonRaphsonBoundary(char* mapperName,
                                         int maxNumOfIterations, double tolerance){
+    RegistryLock lock;
 
     std::string mapperNameInMap = std::string(mapperName);
 
@@ -697,12 +951,15 @@ void setParametersNewtonRaphsonBoundary(char* mapperName,
     else{
         tmpIGAMortarMapper = dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]);
         tmpIGAMortarMapper->setParametersNewtonRaphsonBoundary(maxNumOfIterations, tolerance);
+        double parameters[] = {(double) maxNumOfIterations, tolerance};
+        recordParameters(mapperNameInMap, "setParametersNewtonRaphsonBoundary", parameters, 2);
         INFO_OUT("Line projection parameters using Newton-Raphson are set for \"" +  mapperNameInMap + "\"");
     }
 }
 
 void setParametersBisection(char* mapperName,
                             int maxNumOfIterations, double tolerance){
+    RegistryLock lock;
 
     std::string mapperNameInMap = std::string(mapperName);
 
@@ -720,12 +977,15 @@ void setParametersBisection(char* mapperName,
     } else {
         tmpIGAMortarMapper = dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]);
         tmpIGAMortarMapper->setParametersBisection(maxNumOfIterations, tolerance);
+        double parameters[] = {(double) maxNumOfIterations, tolerance};
+        recordParameters(mapperNameInMap, "setParametersBisection", parameters, 2);
         INFO_OUT("Line projection parameters using Bisection are set for \"" +  mapperNameInMap + "\"");
     }
 }
 
 void setParametersIntegration(char* mapperName,
                               int numGPTriangle, int numGPQuad){
+    RegistryLock lock;
 
     std::string mapperNameInMap = std::string(mapperName);
 
@@ -744,6 +1004,8 @@ void setParametersIntegration(char* mapperName,
     else{
         tmpIGAMortarMapper = dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]);
         tmpIGAMortarMapper->setParametersIntegration(numGPTriangle, numGPQuad);
+        double parameters[] = {(double) numGPTriangle, (double) numGPQuad};
+        recordParameters(mapperNameInMap, "setParametersIntegration", parameters, 2);
         INFO_OUT("Integration parameters are set for \"" +  mapperNameInMap + "\"");
     }
 }
@@ -752,6 +1014,8 @@ void setParametersWeakDirichletConditions(char* mapperName,
                                           bool _isCurveConditions, bool _isSurfaceConditions,
                                           bool _isAutomaticPenaltyFactors,
                                           double _alphaPrim, double _alphaSecBending, double _alphaSecTwisting) {
+    RegistryLock lock;
+
     std::string mapperNameInMap = std::string(mapperName);
 
     IGAMortarMapper *tmpIGAMortarMapper;
@@ -774,6 +1038,9 @@ void setParametersWeakDirichletConditions(char* mapperName,
                                                                       isPrimPrescribed, isSecBendingPrescribed, isSecTwistingPrescribed,
                                                                       _alphaPrim, _alphaSecBending, _alphaSecTwisting);
         tmpIGAMortarMapper->setParametersWeakSurfaceDirichletConditions(_isSurfaceConditions, _isAutomaticPenaltyFactors, _alphaPrim);
+        double parameters[] = {(double) _isCurveConditions, (double) _isSurfaceConditions, (double) _isAutomaticPenaltyFactors,
+                               _alphaPrim, _alphaSecBending, _alphaSecTwisting};
+        recordParameters(mapperNameInMap, "setParametersWeakDirichletConditions", parameters, 6);
         INFO_OUT("Dirichlet condition parameters are set for \"" +  mapperNameInMap + "\"");
     }
 }
@@ -783,6 +1050,8 @@ void setParametersWeakPatchContinuityConditions(char* mapperName,
                                                 bool _isAutomaticPenaltyFactors,
                                                 double _alphaPrim,
                                                 double _alphaSecBending, double _alphaSecTwisting) {
+    RegistryLock lock;
+
     std::string mapperNameInMap = std::string(mapperName);
 
     IGAMortarMapper *tmpIGAMortarMapper;
@@ -804,12 +1073,18 @@ void setParametersWeakPatchContinuityConditions(char* mapperName,
         tmpIGAMortarMapper->setParametersWeakPatchContinuityConditions(_isWeakPatchContinuityConditions, _isAutomaticPenaltyFactors,
                                                                        isPrimCoupled, isSecBendingCoupled, isSecTwistingCoupled,
                                                                        _alphaPrim, _alphaSecBending, _alphaSecTwisting);
+        double parameters[] = {(double) _isWeakPatchContinuityConditions, (double) _isAutomaticPenaltyFactors,
+                               _alphaPrim, _alphaSecBending, _alphaSecTwisting};
+        recordParameters(mapperNameInMap, "setParametersWeakPatchContinuityConditions", parameters, 5);
         INFO_OUT("Patch coupling parameters are set for \"" +  mapperNameInMap + "\"");
     }
 }
 
 void setParametersErrorComputation(char* mapperName,
-                                   bool _isErrorComputation, bool _isDomainError, bool _isInterfaceError, bool _isCurveError) {
+                                   bool _isErrorComputation, bool _isDomainError, bool _isInterfaceError, bool _isCurveError,
+                                   bool _isCompactStorage) {
+    RegistryLock lock;
+
     std::string mapperNameInMap = std::string(mapperName);
 
     IGAMortarMapper *tmpIGAMortarMapper;
@@ -825,12 +1100,38 @@ void setParametersErrorComputation(char* mapperName,
         return;
     } else {
         tmpIGAMortarMapper = dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]);
-        tmpIGAMortarMapper->setParametersErrorComputation(_isErrorComputation, _isDomainError, _isInterfaceError, _isCurveError);
+        tmpIGAMortarMapper->setParametersErrorComputation(_isErrorComputation, _isDomainError, _isInterfaceError, _isCurveError,
+                                                          _isCompactStorage);
         INFO_OUT("Error computation parameters are set for \"" +  mapperNameInMap + "\"");
     }
 }
 
+void setParametersCompactAfterBuild(char* mapperName, bool _isCompactAfterBuild) {
+    RegistryLock lock;
+
+    std::string mapperNameInMap = std::string(mapperName);
+
+    IGAMortarMapper *tmpIGAMortarMapper;
+
+    // check if the mapper with the given name is generated and is of correct type
+    if (!mapperList.count( mapperNameInMap )){
+        ERROR_OUT("A mapper with name : " + mapperNameInMap + " does not exist!");
+        ERROR_OUT("Did nothing!");
+        return;
+    } else if (mapperList[mapperNameInMap]->mapperType != EMPIRE_IGAMortarMapper){
+        ERROR_OUT(mapperNameInMap + " is not a type of IGAMortarMapper");
+        ERROR_OUT("Did nothing!");
+        return;
+    } else {
+        tmpIGAMortarMapper = dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]);
+        tmpIGAMortarMapper->setCompactAfterBuild(_isCompactAfterBuild);
+        INFO_OUT("Compact after build parameter is set for \"" +  mapperNameInMap + "\"");
+    }
+}
+
 void initialize(char *mapperName) {
+    RegistryLock lock;
+
     std::string mapperNameInMap = std::string(mapperName);
     // check if the mapper with the given name is generated
     if (!mapperList.count( mapperNameInMap )){
@@ -844,11 +1145,13 @@ void initialize(char *mapperName) {
     } else{
         dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap])->initialize();
         INFO_OUT("Generated coupling matrices for \"" +  mapperNameInMap );
+        mapperList[mapperNameInMap]->getMemoryUsage().print("mapper \"" + mapperNameInMap + "\"");
     }
 
 }
 
 void buildCouplingMatrices(char *mapperName){
+    RegistryLock lock;
 
     std::string mapperNameInMap = std::string(mapperName);
 
@@ -859,42 +1162,107 @@ void buildCouplingMatrices(char *mapperName){
         return;
     } else{
         mapperList[mapperNameInMap]->buildCouplingMatrices();
+        if (originList.count( mapperNameInMap ))
+            originList[mapperNameInMap].isBuilt = true;
         INFO_OUT("Generated coupling matrices for \"" +  mapperNameInMap );
+        mapperList[mapperNameInMap]->getMemoryUsage().print("mapper \"" + mapperNameInMap + "\"");
+    }
+
+}
+
+void saveMapper(char* mapperName, char* path){
+    RegistryLock lock;
+
+    std::string mapperNameInMap = std::string(mapperName);
+    std::string fileName = std::string(path);
+
+    // check if the mapper with the given name is generated, built and can be stored
+    if (!mapperList.count( mapperNameInMap )){
+        ERROR_OUT("A mapper with name : " + mapperNameInMap + " does not exist!");
+        ERROR_OUT("Did nothing!");
+        return;
+    } else if (!mapperList[mapperNameInMap]->isCouplingMatricesCacheSupported()){
+        ERROR_OUT(mapperNameInMap + " cannot be saved, only mortar mappers without error computation can");
+        ERROR_OUT("Did nothing!");
+        return;
+    } else if (!originList.count( mapperNameInMap ) || !originList[mapperNameInMap].isBuilt){
+        ERROR_OUT("The coupling matrices of " + mapperNameInMap + " have not been built!");
+        ERROR_OUT("Did nothing!");
+        return;
+    }
+
+    CouplingMatricesCache cache(".", mapperNameInMap);
+    if (!addMapperToKey(mapperNameInMap, cache)){
+        ERROR_OUT("Did nothing!");
+        return;
+    }
+    mapperList[mapperNameInMap]->writeCouplingMatricesToCache(&cache);
+    if (!cache.saveFile(fileName)){
+        ERROR_OUT("Mapper not saved!");
+        return;
+    }
+    INFO_OUT("Saved \"" + mapperNameInMap + "\" to \"" + fileName + "\"");
+}
+
+void loadMapper(char* mapperName, char* path){
+    RegistryLock lock;
+
+    std::string mapperNameInMap = std::string(mapperName);
+    std::string fileName = std::string(path);
+
+    // check if the mapper with the given name is generated and can be read
+    if (!mapperList.count( mapperNameInMap )){
+        ERROR_OUT("A mapper with name : " + mapperNameInMap + " does not exist!");
+        ERROR_OUT("Did nothing!");
+        return;
+    } else if (!mapperList[mapperNameInMap]->isCouplingMatricesCacheSupported()){
+        ERROR_OUT(mapperNameInMap + " cannot be loaded, only mortar mappers without error computation can");
+        ERROR_OUT("Did nothing!");
+        return;
+    } else if (originList.count( mapperNameInMap ) && originList[mapperNameInMap].isBuilt){
+        ERROR_OUT("The coupling matrices of " + mapperNameInMap + " have already been built!");
+        ERROR_OUT("Did nothing!");
+        return;
+    } else if (dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap]) != NULL
+            && !dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameInMap])->getIsCouplingMatrices()){
+        ERROR_OUT(mapperNameInMap + " must be initialized before it is loaded!");
+        ERROR_OUT("Did nothing!");
+        return;
     }
 
+    // the key of the file must match the meshes and parameters of this mapper
+    CouplingMatricesCache cache(".", mapperNameInMap);
+    if (!addMapperToKey(mapperNameInMap, cache)){
+        ERROR_OUT("Did nothing!");
+        return;
+    }
+    if (!cache.loadFile(fileName) || !mapperList[mapperNameInMap]->readCouplingMatricesFromCache(&cache)){
+        ERROR_OUT("\"" + fileName + "\" does not hold " + mapperNameInMap + " with its meshes and parameters");
+        ERROR_OUT("Mapper not loaded!");
+        return;
+    }
+    originList[mapperNameInMap].isBuilt = true;
+    INFO_OUT("Loaded \"" + mapperNameInMap + "\" from \"" + fileName + "\"");
+    mapperList[mapperNameInMap]->getMemoryUsage().print("mapper \"" + mapperNameInMap + "\"");
 }
 
 void doConsistentMapping(char* mapperName, int dimension, int dataSizeA, const double* dataA, int dataSizeB, double* dataB){
     assert(dimension == 1 || dimension == 3);
 
     std::string mapperNameToMap = std::string(mapperName);
+    mapper_handle *handle;
+    {
+        RegistryLock lock;
+        handle = findMapperHandle(mapperNameToMap);
+    }
 
-    if (!mapperList.count( mapperNameToMap )){
+    if (handle == NULL){
         ERROR_OUT("This mapper does not exist : " + mapperNameToMap);
         ERROR_OUT("Mapping not performed!");
         return;
     } else {
-        if (dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameToMap]) != NULL && dynamic_cast<IGAMortarMapper *>(mapperList[mapperNameToMap])->getIsExpanded() ) {
-            // if the matrices contain coupling entries between x,y,z components then the fields are mapped as they are
-            mapperList[mapperNameToMap]->consistentMapping(dataA, dataB);
-        }
-        else {
-            // else the field is mapped componentwise
-            int numLocationsA = dataSizeA/dimension;
-            int numLocationsB = dataSizeB/dimension;
-
-            double *fieldADOFi = new double[numLocationsA];
-            double *fieldBDOFi = new double[numLocationsB];
-            for (int i = 0; i < dimension; i++) {
-                for (int j = 0; j < numLocationsA; j++)
-                    fieldADOFi[j] = dataA[j * dimension + i];
-                mapperList[mapperNameToMap]->consistentMapping(fieldADOFi, fieldBDOFi);
-                for (int j = 0; j < numLocationsB; j++)
-                    dataB[j * dimension + i] = fieldBDOFi[j];
-            }
-            delete[] fieldADOFi;
-            delete[] fieldBDOFi;
-        }
+        MapperLock lock(handle);
+        consistentMapping(handle->mapper, dimension, dataSizeA, dataA, dataSizeB, dataB);
     }
 }
 
@@ -902,47 +1270,92 @@ void doConservativeMapping(char* mapperName, int dimension, int dataSizeB, const
     assert(dimension == 1 || dimension == 3);
 
     std::string mapperNameToMap = std::string(mapperName);
-    if (!mapperList.count( mapperNameToMap )){
+    mapper_handle *handle;
+    {
+        RegistryLock lock;
+        handle = findMapperHandle(mapperNameToMap);
+    }
+
+    if (handle == NULL){
         ERROR_OUT("This mapper does not exist : " + mapperNameToMap);
         ERROR_OUT("Mapping not performed!");
         return;
     } else {
-        // if a vector field is to be mapped x, y, z components are extracted
-        if (dimension == 3){
-            int sizeDataToMap = dataSizeB/dimension;
-            int sizeDataToWrite = dataSizeA/dimension;
+        MapperLock lock(handle);
+        conservativeMapping(handle->mapper, dimension, dataSizeB, dataB, dataSizeA, dataA);
+    }
+}
 
-            double** dataBtoMap = new double*[dimension];
-            double** dataAtoWrite = new double*[dimension];
+mapper_handle* getMapperHandle(char* mapperName){
+    RegistryLock lock;
 
-            for (int i=0; i<dimension ; i++){
-                dataBtoMap[i]=new double[sizeDataToMap];
-                dataAtoWrite[i]=new double[sizeDataToWrite];
-            }
-            for (int i=0 ; i<dimension ; i++){
-                for (int j=0 ; j<sizeDataToMap; j++){
-                    dataBtoMap[i][j] = dataB[j*dimension+i];
-                }
-                mapperList[mapperNameToMap]->conservativeMapping(dataBtoMap[i], dataAtoWrite[i]);
-                for (int j=0 ; j<sizeDataToWrite; j++){
-                    dataA[j*dimension+i] = dataAtoWrite[i][j];
-                }
-            }
-            for (int i = 0; i<dimension; i++){
-                delete[] dataBtoMap[i];
-                delete[] dataAtoWrite[i];
-            }
-            delete[] dataBtoMap;
-            delete[] dataAtoWrite;
-        }
-        // else field is mapped as it is
-        else {
-            mapperList[mapperNameToMap]->conservativeMapping(dataB, dataA);
-        }
+    std::string mapperNameInMap = std::string(mapperName);
+    mapper_handle *handle = findMapperHandle(mapperNameInMap);
+    if (handle == NULL){
+        ERROR_OUT("This mapper does not exist : " + mapperNameInMap);
+        ERROR_OUT("No handle given out!");
+    }
+    return handle;
+}
+
+void doConsistentMappingByHandle(mapper_handle* handle, int dimension, int dataSizeA, const double* dataA, int dataSizeB, double* dataB){
+    assert(handle != NULL);
+    assert(dimension == 1 || dimension == 3);
+
+    MapperLock lock(handle);
+    consistentMapping(handle->mapper, dimension, dataSizeA, dataA, dataSizeB, dataB);
+}
+
+void doConservativeMappingByHandle(mapper_handle* handle, int dimension, int dataSizeB, const double* dataB, int dataSizeA, double* dataA){
+    assert(handle != NULL);
+    assert(dimension == 1 || dimension == 3);
+
+    MapperLock lock(handle);
+    conservativeMapping(handle->mapper, dimension, dataSizeB, dataB, dataSizeA, dataA);
+}
+
+void doConsistentMappingBatch(mapper_handle* handle, int dimension, int numFields, int dataSizeA, const double* dataA, int dataSizeB, double* dataB){
+    assert(handle != NULL);
+    assert(dimension == 1 || dimension == 3);
+    assert(numFields > 0);
+
+    MapperLock lock(handle);
+    AbstractMapper *mapper = handle->mapper;
+
+    if (mapper->isBlockMappingSupported()) {
+        // all components of all fields are the right hand sides of one block mapping
+        int numComponents = numFields * dimension;
+        int numLocationsA = dataSizeA / dimension;
+        int numLocationsB = dataSizeB / dimension;
+        double *blockA = NumaMemory::allocateArray<double>((size_t) numLocationsA * numComponents);
+        double *blockB = NumaMemory::allocateArray<double>((size_t) numLocationsB * numComponents);
+
+#pragma omp parallel for
+        for (int j = 0; j < numLocationsA; j++)
+            for (int f = 0; f < numFields; f++)
+                for (int i = 0; i < dimension; i++)
+                    blockA[j * numComponents + f * dimension + i] = dataA[f * dataSizeA + j * dimension + i];
+
+        mapper->consistentBlockMapping(blockA, blockB, numComponents);
+
+#pragma omp parallel for
+        for (int j = 0; j < numLocationsB; j++)
+            for (int f = 0; f < numFields; f++)
+                for (int i = 0; i < dimension; i++)
+                    dataB[f * dataSizeB + j * dimension + i] = blockB[j * numComponents + f * dimension + i];
+
+        NumaMemory::deallocate(blockA);
+        NumaMemory::deallocate(blockB);
+    } else {
+        // the mapper solves one right hand side after the other and parallelizes each solve itself
+        for (int f = 0; f < numFields; f++)
+            consistentMapping(mapper, dimension, dataSizeA, dataA + f * dataSizeA, dataSizeB, dataB + f * dataSizeB);
     }
 }
 
 void printMesh(char* meshName){
+    RegistryLock lock;
+
     std::string meshNameInMap = std::string(meshName);
     if (!meshList.count( meshNameInMap )){
         ERROR_OUT("Mesh with name: \"" + meshNameInMap + "\" does not exist : ");
@@ -955,33 +1368,91 @@ void printMesh(char* meshName){
     }
 }
 
+long getMapperMemoryUsage(char* mapperName){
+    RegistryLock lock;
+
+    std::string mapperNameInMap = std::string(mapperName);
+    if (!mapperList.count( mapperNameInMap ))
+        return -1;
+    return mapperList[mapperNameInMap]->getMemoryUsage().getTotal();
+}
+
+int getMapperBuildStatistics(char* mapperName, char* buffer, int bufferSize){
+    RegistryLock lock;
+
+    std::string mapperNameInMap = std::string(mapperName);
+    if (!mapperList.count( mapperNameInMap ))
+        return -1;
+    std::string json = mapperList[mapperNameInMap]->getBuildStatistics().toJSON(mapperNameInMap);
+    if (bufferSize > 0) {
+        size_t length = std::min(json.size(), (size_t) bufferSize - 1);
+        json.copy(buffer, length);
+        buffer[length] = '\0';
+    }
+    return json.size();
+}
+
+long getMeshMemoryUsage(char* meshName){
+    RegistryLock lock;
+
+    std::string meshNameInMap = std::string(meshName);
+    if (!meshList.count( meshNameInMap ))
+        return -1;
+    return meshList[meshNameInMap]->getMemoryUsage().getTotal();
+}
+
+void printMemoryUsage(char* name){
+    RegistryLock lock;
+
+    std::string nameInMap = std::string(name);
+    if (mapperList.count( nameInMap )) {
+        mapperList[nameInMap]->getMemoryUsage().print("mapper \"" + nameInMap + "\"");
+    } else if (meshList.count( nameInMap )) {
+        meshList[nameInMap]->getMemoryUsage().print("mesh \"" + nameInMap + "\"");
+    } else {
+        ERROR_OUT("Neither a mapper nor a mesh with name: \"" + nameInMap + "\" exists : ");
+        ERROR_OUT("Did nothing!");
+    }
+}
+
 void deleteMesh(char* meshName){
+    RegistryLock lock;
+
     std::string meshNameInMap = std::string(meshName);
     if (!meshList.count( meshNameInMap )){
         ERROR_OUT("Mesh with name: \"" + meshNameInMap + "\" does not exist : ");
         ERROR_OUT("Did nothing!");
     } else {
         delete meshList[meshNameInMap];
+        meshList.erase(meshNameInMap);
     }
 }
 
 void deleteMapper(char* mapperName){
+    RegistryLock lock;
+
     std::string mapperNameInMap = std::string(mapperName);
     if (!mapperList.count( mapperNameInMap )){
         ERROR_OUT("Mapper with name: \"" + mapperNameInMap + "\" does not exist : ");
         ERROR_OUT("Did nothing!");
         return;
     } else {
+        deleteMapperHandle(mapperList[mapperNameInMap]);
         delete mapperList[mapperNameInMap];
+        mapperList.erase(mapperNameInMap);
+        originList.erase(mapperNameInMap);
     }
 }
 
 void deleteAllMappers(){
+    RegistryLock lock;
 
     std::map<std::string, AbstractMapper*>::iterator iter = mapperList.begin();
 
-    if(iter!=mapperList.end()){
+    while(iter!=mapperList.end()){
+        deleteMapperHandle(iter->second);
         delete iter->second;
-        mapperList.erase(iter);
+        mapperList.erase(iter++);
     }
+    originList.clear();
 }
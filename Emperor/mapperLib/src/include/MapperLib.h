@@ -31,6 +31,9 @@
 extern "C" { ///Define extern C if C++ compiler is used
 #endif
 
+/// Opaque handle of an initialized mapper, see getMapperHandle
+typedef struct mapper_handle mapper_handle;
+
 /***********************************************************************************************
  * \brief Initializes and inserts a MortarMapper to the mapper list
  * \param[in] mapperName name of the mapper
@@ -190,7 +193,8 @@ void addTrimmingCurveToTrimmingLoop(char* meshName, int patchIndex,
 /***********************************************************************************************
  * \brief Linearize all the trimming loops and curves of the given mesh and patch
  * \param[in] meshName name of the mesh
- * \param[in] patchIndex index of the surface patch that is previously added to the mesh
+ * \param[in] patchIndex index of the surface patch that is previously added to the mesh, or -1 to
+ *            linearize all patches of the mesh concurrently once all of them are added
  * \author Altug Emiroglu
  ***********/
 void linearizeTrimmingLoops(char* meshName, int patchIndex);
@@ -413,9 +417,18 @@ void setParametersWeakPatchContinuityConditions(char* mapperName, bool _isWeakPa
  * \param[in] _isDomainError Flag on the computation of the error from the mapping in the domain
  * \param[in] _isInterfaceError Flag on the computation of the interface error between the patches
  * \param[in] _isCurveError Flag on the computation of the error along trimming curves where constraints are to be applied
+ * \param[in] _isCompactStorage Flag on storing the Gauss points of the domain error packed in single precision
  ***********/
 void setParametersErrorComputation(char* mapperName,
-                                   bool _isErrorComputation, bool _isDomainError = 0, bool _isInterfaceError = 0, bool _isCurveError = 0);
+                                   bool _isErrorComputation, bool _isDomainError = 0, bool _isInterfaceError = 0, bool _isCurveError = 0,
+                                   bool _isCompactStorage = 0);
+
+/***********************************************************************************************
+ * \brief Release the data only needed for building the coupling matrices after the build, must be
+ *        called before buildCouplingMatrices
+ * \param[in] _isCompactAfterBuild Flag on whether the build data is released
+ ***********/
+void setParametersCompactAfterBuild(char* mapperName, bool _isCompactAfterBuild);
 
 void initialize(char *mapperName);
 
@@ -426,6 +439,26 @@ void initialize(char *mapperName);
  ***********/
 void buildCouplingMatrices(char* mapperName);
 
+/***********************************************************************************************
+ * \brief Save the built coupling matrices of a mortar mapper (initFEMMortarMapper or
+ *        initIGAMortarMapper) together with a hash of the mapper type, the content of its meshes
+ *        and the parameters set through this library, so that other processes load them instead
+ *        of building them again
+ * \param[in] mapperName name of the mapper
+ * \param[in] path the file, it is replaced at once after it has been written completely
+ ***********/
+void saveMapper(char* mapperName, char* path);
+
+/***********************************************************************************************
+ * \brief Load the coupling matrices saved by saveMapper instead of calling buildCouplingMatrices.
+ *        The mapper must be created from meshes with the same content and with the same
+ *        parameters as the saved one, an IGAMortarMapper must be initialized. The matrices are
+ *        factorized again after loading.
+ * \param[in] mapperName name of the mapper
+ * \param[in] path the file written by saveMapper
+ ***********/
+void loadMapper(char* mapperName, char* path);
+
 /***********************************************************************************************
  * \brief Performs consistent mapping on fields (e.g. displacements or tractions) with the previously initialized mapper with name mapperName
  * \param[in] mapperName name of the mapper
@@ -452,6 +485,51 @@ void doConsistentMapping(char* mapperName, int dimension, int dataSizeA, const d
 ***********/
 void doConservativeMapping(char* mapperName, int dimension, int dataSizeB, const double* dataB, int dataSizeA, double* dataA);
 
+/***********************************************************************************************
+ * \brief Gets the handle of a previously initialized mapper. Mapping by handle skips the lookup by name.
+ *        Different mappers can map concurrently from several threads, the mappings of one mapper are
+ *        serialized. The handle becomes invalid when the mapper is deleted.
+ * \param[in] mapperName name of the mapper
+ * \return the handle or NULL if the mapper does not exist
+ ***********/
+mapper_handle* getMapperHandle(char* mapperName);
+
+/***********************************************************************************************
+ * \brief Performs consistent mapping like doConsistentMapping with the mapper of the handle
+ * \param[in] handle handle of the mapper
+ * \param[in] dimension 1 or 3 dimensional data
+ * \param[in] dataSizeA size of data for fieldA
+ * \param[in] dataA the field of mesh A
+ * \param[in] dataSizeB size of data for fieldB
+ * \param[out] dataB the field of mesh B
+***********/
+void doConsistentMappingByHandle(mapper_handle* handle, int dimension, int dataSizeA, const double* dataA, int dataSizeB, double* dataB);
+
+/***********************************************************************************************
+ * \brief Performs conservative mapping like doConservativeMapping with the mapper of the handle
+ * \param[in] handle handle of the mapper
+ * \param[in] dimension 1 or 3 dimensional data
+ * \param[in] dataSizeB size of data for fieldB
+ * \param[in] dataB the field of mesh B
+ * \param[in] dataSizeA size of data for fieldA
+ * \param[out] dataA the field of mesh A
+***********/
+void doConservativeMappingByHandle(mapper_handle* handle, int dimension, int dataSizeB, const double* dataB, int dataSizeA, double* dataA);
+
+/***********************************************************************************************
+ * \brief Performs consistent mapping on several fields (e.g. the displacements of several time steps)
+ *        in one call. If the mapper supports block mapping all fields are mapped as the right hand
+ *        sides of a single mapping.
+ * \param[in] handle handle of the mapper
+ * \param[in] dimension 1 or 3 dimensional data
+ * \param[in] numFields number of fields
+ * \param[in] dataSizeA size of data of one field of mesh A
+ * \param[in] dataA the fields of mesh A one after the other, field f starts at dataA[f * dataSizeA]
+ * \param[in] dataSizeB size of data of one field of mesh B
+ * \param[out] dataB the fields of mesh B one after the other, field f starts at dataB[f * dataSizeB]
+***********/
+void doConsistentMappingBatch(mapper_handle* handle, int dimension, int numFields, int dataSizeA, const double* dataA, int dataSizeB, double* dataB);
+
 /***********************************************************************************************
  * \brief Calculates and prints the bounding box of the mesh
  * \param[in] meshName name of the mesh
@@ -459,6 +537,38 @@ void doConservativeMapping(char* mapperName, int dimension, int dataSizeB, const
 ***********/
 void printMesh(char* meshName);
 
+/***********************************************************************************************
+ * \brief Gets the heap memory held by a mapper (coupling matrices, search structures and tables),
+ *        the meshes are not included
+ * \param[in] mapperName name of the mapper
+ * \return the number of bytes, -1 if the mapper does not exist
+***********/
+long getMapperMemoryUsage(char* mapperName);
+
+/***********************************************************************************************
+ * \brief Gets the statistics of the last build of the coupling matrices of a mapper as a JSON
+ *        object (projections, Newton-Raphson iterations, clipped polygons, Gauss points, sizes of
+ *        the coupling matrices and time of the build stages)
+ * \param[in] mapperName name of the mapper
+ * \param[out] buffer the JSON object terminated by zero, truncated to bufferSize - 1 characters
+ * \param[in] bufferSize the size of buffer
+ * \return the length of the whole JSON object, -1 if the mapper does not exist
+***********/
+int getMapperBuildStatistics(char* mapperName, char* buffer, int bufferSize);
+
+/***********************************************************************************************
+ * \brief Gets the heap memory held by a mesh (geometry, data fields and spatial index)
+ * \param[in] meshName name of the mesh
+ * \return the number of bytes, -1 if the mesh does not exist
+***********/
+long getMeshMemoryUsage(char* meshName);
+
+/***********************************************************************************************
+ * \brief Prints the heap memory of a mapper or a mesh broken down by its components
+ * \param[in] name name of the mapper or the mesh
+***********/
+void printMemoryUsage(char* name);
+
 /***********************************************************************************************
  * \brief Deletes a previously initialized mesh
  * \param[in] meshName name of the mesh to be deleted from the mesh list
@@ -0,0 +1,53 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <iostream>
+#include <string>
+#include <stdlib.h>
+#include "BinaryResultFileIO.h"
+
+using namespace std;
+
+/***********************************************************************************************
+ * \brief Convert a binary result file written by EMPIRE to GiD .res or to legacy VTK files
+ *        Usage: EmperorResultConverter <file.bin> gid
+ *               EmperorResultConverter <file.bin> vtk <file.msh>
+ ***********/
+int main(int argc, char** argv) {
+    if (argc < 3 || (string(argv[2]) != "gid" && string(argv[2]) != "vtk")
+            || (string(argv[2]) == "vtk" && argc != 4)) {
+        cerr << "Usage: " << argv[0] << " <file.bin> gid" << endl;
+        cerr << "       " << argv[0] << " <file.bin> vtk <file.msh>" << endl;
+        exit(EXIT_FAILURE);
+    }
+    string binFileName(argv[1]);
+    string baseName = binFileName;
+    if (baseName.size() > 4 && baseName.substr(baseName.size() - 4) == ".bin")
+        baseName.erase(baseName.size() - 4);
+
+    if (string(argv[2]) == "gid") {
+        BinaryResultFileIO::convertToDotRes(binFileName, baseName + ".res");
+        cout << "Written: " << baseName << ".res" << endl;
+    } else {
+        BinaryResultFileIO::convertToVTK(binFileName, string(argv[3]), baseName);
+        cout << "Written: " << baseName << "_<step>.vtk" << endl;
+    }
+    return 0;
+}
@@ -23,10 +23,12 @@
 #include <stdlib.h>
 #include <math.h>
 #include <assert.h>
+#include <algorithm>
 
 // Inclusion of user defined libraries
 #include "Message.h"
 #include "BSplineBasis1D.h"
+#include "ScratchArray.h"
 
 using namespace std;
 
@@ -58,6 +60,8 @@ BSplineBasis1D::BSplineBasis1D(int _ID = 0, int _pDegree = 0, int _noKnots = 0,
             exit(EXIT_FAILURE);
         }
     }
+    computeExtractionOperators();
+    computeUniformity();
 }
 
 BSplineBasis1D::BSplineBasis1D(const BSplineBasis1D& _bsplineBasis1D) :
@@ -70,6 +74,9 @@ BSplineBasis1D::BSplineBasis1D(const BSplineBasis1D& _bsplineBasis1D) :
     for (int i = 0; i < NoKnots; i++) {
         KnotVector[i] = _bsplineBasis1D.KnotVector[i];
     }
+    extractionOperators = _bsplineBasis1D.extractionOperators;
+    isUniform = _bsplineBasis1D.isUniform;
+    inverseKnotSpanLength = _bsplineBasis1D.inverseKnotSpanLength;
 }
 
 BSplineBasis1D& BSplineBasis1D::operator=(const BSplineBasis1D& _bsplineBasis1D) {
@@ -82,6 +89,9 @@ BSplineBasis1D& BSplineBasis1D::operator=(const BSplineBasis1D& _bsplineBasis1D)
         for (int i = 0; i < NoKnots; i++) {
             KnotVector[i] = _bsplineBasis1D.KnotVector[i];
         }
+        extractionOperators = _bsplineBasis1D.extractionOperators;
+        isUniform = _bsplineBasis1D.isUniform;
+        inverseKnotSpanLength = _bsplineBasis1D.inverseKnotSpanLength;
     }
     return *this;
 }
@@ -90,6 +100,132 @@ BSplineBasis1D::~BSplineBasis1D() {
     delete[] KnotVector;
 }
 
+void BSplineBasis1D::computeExtractionOperators() {
+    /*
+     * Bezier extraction by inserting every interior knot until its multiplicity is PDegree, see
+     * Borden, Scott, Evans and Hughes, Isogeometric finite element data structures based on Bezier
+     * extraction of NURBS, Int. J. Numer. Meth. Engng 2011, Algorithm 1. The indices of the
+     * algorithm are one-based as there, U(k) is the knot k and C(i,j) the entry of the operator
+     */
+    const int p = PDegree;
+    const int size = (p + 1) * (p + 1);
+    const int numSpans = computeNoBasisFunctions() - p;
+    extractionOperators.assign(numSpans > 0 ? (size_t) numSpans * size : 0, 0.0);
+    if (numSpans <= 0)
+        return;
+    vector<double> identity(size, 0.0);
+    for (int i = 0; i <= p; i++)
+        identity[i * (p + 1) + i] = 1.0;
+    for (int span = 0; span < numSpans; span++)
+        std::copy(identity.begin(), identity.end(), extractionOperators.begin() + (size_t) span * size);
+#define U(k) KnotVector[(k) - 1]
+#define C(i, j) current[((i) - 1) * (p + 1) + (j) - 1]
+#define C_NEXT(i, j) next[((i) - 1) * (p + 1) + (j) - 1]
+    const int m = NoKnots;
+    vector<double> current(identity), next(size), alphas(p + 2);
+    int a = p + 1;
+    int b = a + 1;
+    while (b < m) {
+        next = identity;
+        int i = b;
+        // The multiplicity of the knot at the end of the span
+        while (b < m && U(b + 1) == U(b))
+            b++;
+        int mult = b - i + 1;
+        if (mult < p) {
+            double numer = U(b) - U(a);
+            for (int j = p; j > mult; j--)
+                alphas[j - mult] = numer / (U(a + j) - U(a));
+            int r = p - mult;
+            // Insert the knot r times
+            for (int j = 1; j <= r; j++) {
+                int save = r - j + 1;
+                int s = mult + j;
+                for (int k = p + 1; k > s; k--) {
+                    double alpha = alphas[k - s];
+                    for (int row = 1; row <= p + 1; row++)
+                        C(row, k) = alpha * C(row, k) + (1.0 - alpha) * C(row, k - 1);
+                }
+                // The overlapping coefficients of the next span
+                if (b < m)
+                    for (int l = 0; l <= j; l++)
+                        C_NEXT(save + l, save) = C(p - j + 1 + l, p + 1);
+            }
+        }
+        // The span a-1 (zero-based) is complete
+        std::copy(current.begin(), current.end(), extractionOperators.begin() + (size_t) (a - 1 - p) * size);
+        if (b < m) {
+            current = next;
+            a = b;
+            b++;
+        }
+    }
+#undef U
+#undef C
+#undef C_NEXT
+}
+
+void BSplineBasis1D::computeBernsteinPolynomialsAndFirstDerivatives(double* _bernsteinAndDerivs,
+        double _uPrm, int _KnotSpanIndex) const {
+    // The parameter of the span in [0,1]
+    const double spanLength = KnotVector[_KnotSpanIndex + 1] - KnotVector[_KnotSpanIndex];
+    const double t = (_uPrm - KnotVector[_KnotSpanIndex]) / spanLength;
+    const double oneMinusT = 1.0 - t;
+    double* bernstein = _bernsteinAndDerivs;
+    double* derivs = _bernsteinAndDerivs + PDegree + 1;
+
+    // The Bernstein polynomials of degree PDegree-1 by the triangular scheme, The NURBS Book A1.3
+    bernstein[0] = 1.0;
+    for (int k = 1; k < PDegree; k++) {
+        double saved = 0.0;
+        for (int j = 0; j < k; j++) {
+            double temp = bernstein[j];
+            bernstein[j] = saved + oneMinusT * temp;
+            saved = t * temp;
+        }
+        bernstein[k] = saved;
+    }
+    if (PDegree == 0) {
+        derivs[0] = 0.0;
+        return;
+    }
+
+    // The last step gives both the polynomials of degree PDegree and their derivatives
+    // dB_j/du = PDegree * (B_{j-1} - B_j) / spanLength with the polynomials of degree PDegree-1
+    const double factor = PDegree / spanLength;
+    double saved = 0.0;
+    double savedDeriv = 0.0;
+    for (int j = 0; j < PDegree; j++) {
+        double temp = bernstein[j];
+        bernstein[j] = saved + oneMinusT * temp;
+        derivs[j] = factor * (savedDeriv - temp);
+        saved = t * temp;
+        savedDeriv = temp;
+    }
+    bernstein[PDegree] = saved;
+    derivs[PDegree] = factor * savedDeriv;
+}
+
+void BSplineBasis1D::computeLocalBasisFunctionsAndFirstDerivativesByExtraction(
+        double* _basisFctsAndDerivs, double _uPrm, int _KnotSpanIndex) const {
+    const int n = PDegree + 1;
+    ScratchArray<double, 2 * SCRATCH_SIZE_1D> bernsteinAndDerivs(2 * n);
+    computeBernsteinPolynomialsAndFirstDerivatives(bernsteinAndDerivs, _uPrm, _KnotSpanIndex);
+    const double* bernstein = bernsteinAndDerivs;
+    const double* derivs = bernstein + n;
+    const double* C = getExtractionOperator(_KnotSpanIndex);
+    for (int i = 0; i < n; i++) {
+        double value = 0.0;
+        double deriv = 0.0;
+        for (int j = 0; j < n; j++) {
+            value += C[i * n + j] * bernstein[j];
+            deriv += C[i * n + j] * derivs[j];
+        }
+        _basisFctsAndDerivs[i] = value;
+        _basisFctsAndDerivs[n + i] = deriv;
+    }
+}
+
 double BSplineBasis1D::computeGrevilleAbscissae(const int _controlPointIndex) const {
 	double GrevilleAbscissae=0;
 	for(int i=0;i<PDegree;i++) {
@@ -130,21 +266,39 @@ bool BSplineBasis1D::clampKnot(double& _uPrm, double _tol) const {
     return isInside;
 }
 
-int BSplineBasis1D::findKnotSpan(double _uPrm) const {
-    // Check input
-	double uPrm = _uPrm;
-    if(!clampKnot(_uPrm)) {
-        stringstream sstream;
-        sstream << "Given parameter "<<uPrm<<" out of knot bounds ["<<getFirstKnot()<<", "<<getLastKnot()<<"]"<<endl;
-        WARNING_BLOCK_OUT("BSplineBasis1D","findKnotSpan",sstream.str());
-    }
+void BSplineBasis1D::computeUniformity() {
+    const int n = computeNoBasisFunctions();
+    isUniform = n > PDegree;
+    inverseKnotSpanLength = 0.0;
+    if (!isUniform)
+        return;
+    const double length = (KnotVector[n] - KnotVector[PDegree]) / (n - PDegree);
+    const double tolerance = 1e-12 * (KnotVector[n] - KnotVector[PDegree]);
+    for (int i = PDegree; i < n && isUniform; i++)
+        isUniform = fabs(KnotVector[i + 1] - KnotVector[i] - length) <= tolerance;
+    if (isUniform)
+        inverseKnotSpanLength = 1.0 / length;
+}
 
+int BSplineBasis1D::searchKnotSpan(double _uPrm) const {
     // Compute the number of basis functions
-    int n = computeNoBasisFunctions();
+    const int n = computeNoBasisFunctions();
 
     // Special case, for the last knot
-    if (_uPrm == KnotVector[n + 1])
+    if (_uPrm >= KnotVector[n])
         return n - 1;
+
+    // Arithmetic lookup for uniform knot vectors, corrected by one span against round-off
+    if (isUniform) {
+        int span = PDegree + (int) ((_uPrm - KnotVector[PDegree]) * inverseKnotSpanLength);
+        span = std::min(std::max(span, PDegree), n - 1);
+        if (_uPrm < KnotVector[span])
+            span--;
+        else if (_uPrm >= KnotVector[span + 1])
+            span++;
+        return span;
+    }
+
     // Do binary search
     int low = PDegree;
     int high = n + 1;
@@ -160,6 +314,54 @@ int BSplineBasis1D::findKnotSpan(double _uPrm) const {
     return mid;
 }
 
+int BSplineBasis1D::findKnotSpan(double _uPrm) const {
+    // Check input, only parameters outside the knot vector are clamped
+    if (_uPrm < KnotVector[0] || _uPrm > KnotVector[NoKnots - 1]) {
+        double uPrm = _uPrm;
+        if (!clampKnot(_uPrm)) {
+            stringstream sstream;
+            sstream << "Given parameter " << uPrm << " out of knot bounds [" << getFirstKnot() << ", "
+                    << getLastKnot() << "]" << endl;
+            WARNING_BLOCK_OUT("BSplineBasis1D", "findKnotSpan", sstream.str());
+        }
+    }
+    return searchKnotSpan(_uPrm);
+}
+
+int BSplineBasis1D::findKnotSpan(double _uPrm, int _spanHint) const {
+    const int n = computeNoBasisFunctions();
+    if (_spanHint < PDegree || _spanHint >= n || _uPrm < KnotVector[0] || _uPrm >= KnotVector[n])
+        return findKnotSpan(_uPrm);
+
+    // Check the hinted span and its neighbours
+    if (_uPrm >= KnotVector[_spanHint]) {
+        if (_uPrm < KnotVector[_spanHint + 1])
+            return _spanHint;
+        if (_uPrm < KnotVector[_spanHint + 2])
+            return _spanHint + 1;
+    } else if (_spanHint > PDegree && _uPrm >= KnotVector[_spanHint - 1]) {
+        return _spanHint - 1;
+    }
+    return searchKnotSpan(_uPrm);
+}
+
+void BSplineBasis1D::findKnotSpans(int _noParameters, const double* _uPrms, int* _spans) const {
+    const int lastSpan = computeNoBasisFunctions() - 1;
+    int span = PDegree;
+    for (int i = 0; i < _noParameters; i++) {
+        const double uPrm = _uPrms[i];
+        assert(i == 0 || uPrm >= _uPrms[i - 1]);
+        if (uPrm < KnotVector[0] || uPrm > KnotVector[NoKnots - 1]) {
+            _spans[i] = findKnotSpan(uPrm);
+            continue;
+        }
+        // The spans of sorted parameters are ascending
+        while (span < lastSpan && uPrm >= KnotVector[span + 1])
+            span++;
+        _spans[i] = span;
+    }
+}
+
 void BSplineBasis1D::computeLocalBasisFunctions(double* _localBasisFunctions, double _uPrm,
         int _KnotSpanIndex) const {
 
@@ -169,6 +371,24 @@ void BSplineBasis1D::computeLocalBasisFunctions(double* _localBasisFunctions, do
      * e.g.  _localBasisFunctions = |N1 	    N2		 ... 	    Nn|
      */
 
+    // Use the kernels unrolled at compile time for the most common polynomial degrees
+    switch (PDegree) {
+    case 1:
+        computeLocalBasisFunctionsFixedDegree<1>(_localBasisFunctions, _uPrm, _KnotSpanIndex);
+        return;
+    case 2:
+        computeLocalBasisFunctionsFixedDegree<2>(_localBasisFunctions, _uPrm, _KnotSpanIndex);
+        return;
+    case 3:
+        computeLocalBasisFunctionsFixedDegree<3>(_localBasisFunctions, _uPrm, _KnotSpanIndex);
+        return;
+    case 4:
+        computeLocalBasisFunctionsFixedDegree<4>(_localBasisFunctions, _uPrm, _KnotSpanIndex);
+        return;
+    default:
+        break;
+    }
+
     // Initialize the first element of the output array
     _localBasisFunctions[0] = 1.0;
 
@@ -176,9 +396,9 @@ void BSplineBasis1D::computeLocalBasisFunctions(double* _localBasisFunctions, do
     double saved = 0.0;
     double temp = 0.0;
 
-    // Initialize auxiliary arrays
-    double* left = new double[PDegree + 1];
-    double* right = new double[PDegree + 1];
+    // Initialize auxiliary arrays, kept on the stack for the common polynomial degrees
+    ScratchArray<double, SCRATCH_SIZE_1D> left(PDegree + 1);
+    ScratchArray<double, SCRATCH_SIZE_1D> right(PDegree + 1);
 
     for (int j = 1; j <= PDegree; j++) {
         left[j - 1] = _uPrm - KnotVector[_KnotSpanIndex + 1 - j];
@@ -191,10 +411,6 @@ void BSplineBasis1D::computeLocalBasisFunctions(double* _localBasisFunctions, do
         }
         _localBasisFunctions[j] = saved;
     }
-
-    // Clean up the heap from the auxiliary pointers
-    delete[] left;
-    delete[] right;
 }
 
 void BSplineBasis1D::computeLocalBasisFunctionsAndDerivatives(double* _localBasisFctsAndDerivs,
@@ -211,6 +427,30 @@ void BSplineBasis1D::computeLocalBasisFunctionsAndDerivatives(double* _localBasi
      *
      */
 
+    // Use the kernels unrolled at compile time for the first derivatives of the most common polynomial degrees
+    if (_derivDegree == 1) {
+        switch (PDegree) {
+        case 1:
+            computeLocalBasisFunctionsAndFirstDerivativesFixedDegree<1>(_localBasisFctsAndDerivs,
+                    _uPrm, _KnotSpanIndex);
+            return;
+        case 2:
+            computeLocalBasisFunctionsAndFirstDerivativesFixedDegree<2>(_localBasisFctsAndDerivs,
+                    _uPrm, _KnotSpanIndex);
+            return;
+        case 3:
+            computeLocalBasisFunctionsAndFirstDerivativesFixedDegree<3>(_localBasisFctsAndDerivs,
+                    _uPrm, _KnotSpanIndex);
+            return;
+        case 4:
+            computeLocalBasisFunctionsAndFirstDerivativesFixedDegree<4>(_localBasisFctsAndDerivs,
+                    _uPrm, _KnotSpanIndex);
+            return;
+        default:
+            break;
+        }
+    }
+
     // Initialize auxiliary variables
     double saved = 0.0;
     double temp = 0.0;
@@ -224,11 +464,11 @@ void BSplineBasis1D::computeLocalBasisFunctionsAndDerivatives(double* _localBasi
     int jTemp = 0;
     int rTemp = 0;
 
-    // Initialize auxiliary arrays
-    double* ndu = new double[(PDegree + 1) * (PDegree + 1)];
-    double* left = new double[PDegree + 1];
-    double* right = new double[PDegree + 1];
-    double* a = new double[2 * (PDegree + 1)];
+    // Initialize auxiliary arrays, kept on the stack for the common polynomial degrees
+    ScratchArray<double, SCRATCH_SIZE_2D> ndu((PDegree + 1) * (PDegree + 1));
+    ScratchArray<double, SCRATCH_SIZE_1D> left(PDegree + 1);
+    ScratchArray<double, SCRATCH_SIZE_1D> right(PDegree + 1);
+    ScratchArray<double, 2 * SCRATCH_SIZE_1D> a(2 * (PDegree + 1));
 
     // Initialize the first element of the output array
     ndu[0] = 1.0;
@@ -309,12 +549,6 @@ void BSplineBasis1D::computeLocalBasisFunctionsAndDerivatives(double* _localBasi
 
         rTemp *= (PDegree - k);
     }
-
-    // Delete auxiliary arrays
-    delete[] ndu;
-    delete[] left;
-    delete[] right;
-    delete[] a;
 }
 
 void BSplineBasis1D::setKnotVector(int _noKnots, double* _knotVector) {
@@ -322,6 +556,8 @@ void BSplineBasis1D::setKnotVector(int _noKnots, double* _knotVector) {
     delete[] KnotVector;
     NoKnots = _noKnots;
     KnotVector = _knotVector;
+    computeExtractionOperators();
+    computeUniformity();
 }
 
 
@@ -27,6 +27,10 @@
 #ifndef BSPLINEBASIS1D_H_
 #define BSPLINEBASIS1D_H_
 
+// Inclusion of standard libraries
+#include <stddef.h>
+#include <vector>
+
 // Inclusion of user defined libraries
 #include "AbstractBSplineBasis1D.h"
 
@@ -49,6 +53,35 @@ protected:
     /// The knot vector
     double* KnotVector;
 
+    /// The Bezier extraction operator C of every knot span PDegree, ..., n-1 as a (PDegree+1)x(PDegree+1) row major matrix,
+    /// the non-zero basis functions of the span are N_i = sum_j C_ij * B_j with the Bernstein polynomials B_j of the span.
+    /// Spans of zero length, which are never evaluated, keep the identity
+    std::vector<double> extractionOperators;
+
+    /// Whether all interior knots are simple and equally spaced, then the knot span is found arithmetically
+    bool isUniform;
+
+    /// The inverse length of the knot spans of a uniform knot vector
+    double inverseKnotSpanLength;
+
+    /***********************************************************************************************
+     * \brief Compute the Bezier extraction operators of all knot spans by knot insertion
+     ***********/
+    void computeExtractionOperators();
+
+    /***********************************************************************************************
+     * \brief Check whether the knot vector is uniform
+     ***********/
+    void computeUniformity();
+
+    /***********************************************************************************************
+     * \brief Find the knot span of a parameter inside the knot vector, arithmetically for uniform knot
+     *        vectors and by binary search otherwise
+     * \param[in] _uPrm The parameter inside the knot vector bounds
+     * \return The knot span index
+     ***********/
+    int searchKnotSpan(double) const;
+
     /// The constructor, the destructor, the copy constructor and the copy assignment
 public:
     /***********************************************************************************************
@@ -114,6 +147,23 @@ public:
      ***********/
     int findKnotSpan(double) const;
 
+    /***********************************************************************************************
+     * \brief Find the knot span of the parameter, checking the hinted span and its neighbours first
+     * \param[in] _uPrm The parameter on which the knot span is searched
+     * \param[in] _spanHint The knot span of a nearby parameter, e.g. of the previous Newton iteration,
+     *            any invalid index falls back to the search
+     * \return The knot span index
+     ***********/
+    int findKnotSpan(double, int) const;
+
+    /***********************************************************************************************
+     * \brief Find the knot spans of parameters sorted in ascending order by walking along the knot vector
+     * \param[in] _noParameters The number of parameters
+     * \param[in] _uPrms The parameters in ascending order
+     * \param[out] _spans The knot span index of every parameter
+     ***********/
+    void findKnotSpans(int, const double*, int*) const;
+
     /***********************************************************************************************
      * \brief Compute the non-zero B-Spline basis functions at the given parameter
      * \param[in/out] _basisFcts The non-zero basis functions at the given parameter
@@ -133,8 +183,116 @@ public:
      ***********/
     void computeLocalBasisFunctionsAndDerivatives(double*, int, double, int) const;
 
+    /***********************************************************************************************
+     * \brief Compute the non-zero B-Spline basis functions for a polynomial degree P known at compile
+     * time, such that all loops can be unrolled. P must be equal to PDegree
+     * \param[in/out] _basisFcts The non-zero basis functions at the given parameter
+     * \param[in] _uPrm The parameter where the basis functions are evaluated
+     * \param[in] _KnotSpanIndex The index of the knot span where _uPrm lives in
+     ***********/
+    template<int P>
+    inline void computeLocalBasisFunctionsFixedDegree(double* _basisFcts, double _uPrm,
+            int _KnotSpanIndex) const {
+        double left[P];
+        double right[P];
+        double saved = 0.0;
+        double temp = 0.0;
+
+        _basisFcts[0] = 1.0;
+        for (int j = 1; j <= P; j++) {
+            left[j - 1] = _uPrm - KnotVector[_KnotSpanIndex + 1 - j];
+            right[j - 1] = KnotVector[_KnotSpanIndex + j] - _uPrm;
+            saved = 0.0;
+            for (int r = 0; r < j; r++) {
+                temp = _basisFcts[r] / (right[r] + left[j - r - 1]);
+                _basisFcts[r] = saved + right[r] * temp;
+                saved = left[j - r - 1] * temp;
+            }
+            _basisFcts[j] = saved;
+        }
+    }
+
+    /***********************************************************************************************
+     * \brief Compute the non-zero B-Spline basis functions and their first derivatives for a
+     * polynomial degree P known at compile time. The output is sorted as in
+     * computeLocalBasisFunctionsAndDerivatives, that is |N1 ... Nn dN1 ... dNn|. P must be equal to PDegree
+     * \param[in/out] _basisFctsAndDerivs The non-zero basis functions and their first derivatives
+     * \param[in] _uPrm The parameter where the basis functions are evaluated
+     * \param[in] _KnotSpanIndex The index of the knot span where _uPrm lives in
+     ***********/
+    template<int P>
+    inline void computeLocalBasisFunctionsAndFirstDerivativesFixedDegree(
+            double* _basisFctsAndDerivs, double _uPrm, int _KnotSpanIndex) const {
+        double left[P];
+        double right[P];
+        double lowerDegreeFcts[P];
+        double saved = 0.0;
+        double savedDeriv = 0.0;
+        double temp = 0.0;
+
+        // Compute the basis functions of degree P-1
+        lowerDegreeFcts[0] = 1.0;
+        for (int j = 1; j < P; j++) {
+            left[j - 1] = _uPrm - KnotVector[_KnotSpanIndex + 1 - j];
+            right[j - 1] = KnotVector[_KnotSpanIndex + j] - _uPrm;
+            saved = 0.0;
+            for (int r = 0; r < j; r++) {
+                temp = lowerDegreeFcts[r] / (right[r] + left[j - r - 1]);
+                lowerDegreeFcts[r] = saved + right[r] * temp;
+                saved = left[j - r - 1] * temp;
+            }
+            lowerDegreeFcts[j] = saved;
+        }
+
+        // The last recursion step gives both the basis functions of degree P and their derivatives
+        left[P - 1] = _uPrm - KnotVector[_KnotSpanIndex + 1 - P];
+        right[P - 1] = KnotVector[_KnotSpanIndex + P] - _uPrm;
+        saved = 0.0;
+        for (int r = 0; r < P; r++) {
+            temp = lowerDegreeFcts[r] / (right[r] + left[P - r - 1]);
+            _basisFctsAndDerivs[r] = saved + right[r] * temp;
+            _basisFctsAndDerivs[P + 1 + r] = P * (savedDeriv - temp);
+            saved = left[P - r - 1] * temp;
+            savedDeriv = temp;
+        }
+        _basisFctsAndDerivs[P] = saved;
+        _basisFctsAndDerivs[2 * P + 1] = P * savedDeriv;
+    }
+
+    /***********************************************************************************************
+     * \brief Compute the Bernstein polynomials of the knot span and their first derivatives with
+     * respect to the parameter at the given parameter, sorted as |B1 ... Bn dB1 ... dBn|
+     * \param[in/out] _bernsteinAndDerivs The Bernstein polynomials and their first derivatives
+     * \param[in] _uPrm The parameter where the polynomials are evaluated
+     * \param[in] _KnotSpanIndex The index of the knot span where _uPrm lives in
+     ***********/
+    void computeBernsteinPolynomialsAndFirstDerivatives(double* _bernsteinAndDerivs, double _uPrm,
+            int _KnotSpanIndex) const;
+
+    /***********************************************************************************************
+     * \brief Compute the non-zero basis functions and their first derivatives as the Bernstein
+     * polynomials of the knot span times its extraction operator. The cost is fixed and there are
+     * no divisions but the one by the span length. The output is sorted as in
+     * computeLocalBasisFunctionsAndDerivatives, that is |N1 ... Nn dN1 ... dNn|
+     * \param[in/out] _basisFctsAndDerivs The non-zero basis functions and their first derivatives
+     * \param[in] _uPrm The parameter where the basis functions are evaluated
+     * \param[in] _KnotSpanIndex The index of the knot span where _uPrm lives in
+     ***********/
+    void computeLocalBasisFunctionsAndFirstDerivativesByExtraction(double* _basisFctsAndDerivs,
+            double _uPrm, int _KnotSpanIndex) const;
+
     /// Get and set functions
 public:
+    /***********************************************************************************************
+     * \brief Returns the Bezier extraction operator of a knot span as a row major
+     * (PDegree+1)x(PDegree+1) matrix, row i holds the Bernstein coefficients of the i-th non-zero
+     * basis function of the span
+     * \param[in] _KnotSpanIndex The index of the knot span
+     ***********/
+    inline const double* getExtractionOperator(int _KnotSpanIndex) const {
+        return &extractionOperators[(size_t) (_KnotSpanIndex - PDegree) * (PDegree + 1) * (PDegree + 1)];
+    }
+
     /***********************************************************************************************
      * \brief Returns the polynomial degree of the B-Spline 1D basis
      * \author Andreas Apostolatos
@@ -26,6 +26,7 @@
 
 // Inclusion of user defined libraries
 #include "BSplineBasis2D.h"
+#include "ScratchArray.h"
 #include "Message.h"
 
 using namespace std;
@@ -126,11 +127,13 @@ void BSplineBasis2D::computeLocalBasisFunctions(double* _basisFcts, double _uPrm
     assert(_basisFcts!=NULL);
 
     // Compute the local B-Spline basis functions in u-direction
-    double* uBSplinebasis1DFcts = new double[uBSplineBasis1D->getPolynomialDegree() + 1];
+    ScratchArray<double, SCRATCH_SIZE_1D> uBSplinebasis1DFcts(
+            uBSplineBasis1D->getPolynomialDegree() + 1);
     uBSplineBasis1D->computeLocalBasisFunctions(uBSplinebasis1DFcts, _uPrm, _KnotSpanIndexU);
 
     // Compute the local B-Spline basis functions in v-direction
-    double* vBSplinebasis1DFcts = new double[vBSplineBasis1D->getPolynomialDegree() + 1];
+    ScratchArray<double, SCRATCH_SIZE_1D> vBSplinebasis1DFcts(
+            vBSplineBasis1D->getPolynomialDegree() + 1);
     vBSplineBasis1D->computeLocalBasisFunctions(vBSplinebasis1DFcts, _vPrm, _KnotSpanIndexV);
 
     // Initialize counter
@@ -146,10 +149,6 @@ void BSplineBasis2D::computeLocalBasisFunctions(double* _basisFcts, double _uPrm
             counter += 1;
         }
     }
-
-    // Free the memory from the heap
-    delete[] uBSplinebasis1DFcts;
-    delete[] vBSplinebasis1DFcts;
 }
 
 void BSplineBasis2D::getBasisFunctionsIndex(int _KnotSpanIndexU, int _KnotSpanIndexV,
@@ -225,12 +224,14 @@ void BSplineBasis2D::computeLocalBasisFunctionsAndDerivatives(double* _basisFcts
     int index = 0;
 
     // Compute the derivatives of the local B-Spline basis functions in u-direction
-    double* uBSplinebasis1DFctsDerivs = new double[(_derivDegree + 1) * (pDegree + 1)];
+    ScratchArray<double, (SCRATCH_MAX_DERIV + 1) * SCRATCH_SIZE_1D> uBSplinebasis1DFctsDerivs(
+            (_derivDegree + 1) * (pDegree + 1));
     uBSplineBasis1D->computeLocalBasisFunctionsAndDerivatives(uBSplinebasis1DFctsDerivs,
             _derivDegree, _uPrm, _KnotSpanIndexU);
 
     // Compute the derivatives of the local B-Spline basis functions in v-direction
-    double* vBSplinebasis1DFctsDerivs = new double[(_derivDegree + 1) * (qDegree + 1)];
+    ScratchArray<double, (SCRATCH_MAX_DERIV + 1) * SCRATCH_SIZE_1D> vBSplinebasis1DFctsDerivs(
+            (_derivDegree + 1) * (qDegree + 1));
     vBSplineBasis1D->computeLocalBasisFunctionsAndDerivatives(vBSplinebasis1DFctsDerivs,
             _derivDegree, _vPrm, _KnotSpanIndexV);
 
@@ -283,10 +284,35 @@ void BSplineBasis2D::computeLocalBasisFunctionsAndDerivatives(double* _basisFcts
             counterBasis++;
         }
     }
+}
 
-    // Free the memory from the heap
-    delete[] uBSplinebasis1DFctsDerivs;
-    delete[] vBSplinebasis1DFctsDerivs;
+void BSplineBasis2D::computeBezierControlPoints(int _KnotSpanIndexU, int _KnotSpanIndexV,
+        int _noComponents, const double* _controlPoints, double* _bezierPoints) const {
+    const int nU = uBSplineBasis1D->getPolynomialDegree() + 1;
+    const int nV = vBSplineBasis1D->getPolynomialDegree() + 1;
+    const double* Cu = uBSplineBasis1D->getExtractionOperator(_KnotSpanIndexU);
+    const double* Cv = vBSplineBasis1D->getExtractionOperator(_KnotSpanIndexV);
+
+    // Extract in u-direction, temp_kj = sum_i Cu_ij P_ik
+    ScratchArray<double, 4 * SCRATCH_SIZE_2D> temp(nU * nV * _noComponents);
+    for (int k = 0; k < nV; k++)
+        for (int j = 0; j < nU; j++)
+            for (int c = 0; c < _noComponents; c++) {
+                double sum = 0.0;
+                for (int i = 0; i < nU; i++)
+                    sum += Cu[i * nU + j] * _controlPoints[(k * nU + i) * _noComponents + c];
+                temp[(k * nU + j) * _noComponents + c] = sum;
+            }
+
+    // Extract in v-direction, Q_jl = sum_k Cv_kl temp_kj
+    for (int l = 0; l < nV; l++)
+        for (int j = 0; j < nU; j++)
+            for (int c = 0; c < _noComponents; c++) {
+                double sum = 0.0;
+                for (int k = 0; k < nV; k++)
+                    sum += Cv[k * nV + l] * temp[(k * nU + j) * _noComponents + c];
+                _bezierPoints[(l * nU + j) * _noComponents + c] = sum;
+            }
 }
 
 Message &operator<<(Message &message, BSplineBasis2D &bSplineBasis2D) {
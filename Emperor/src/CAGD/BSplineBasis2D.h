@@ -127,6 +127,18 @@ public:
 	void computeLocalBasisFunctionsAndDerivatives(double*, int, double, int,
 			double, int);
 
+	/***********************************************************************************************
+	 * \brief Compute the Bezier control points of a knot span from the control points of its non-zero
+	 * basis functions by the extraction operators of both directions, Q_jl = sum_ik Cu_ij Cv_kl P_ik
+	 * \param[in] _KnotSpanIndexU The index of the knot span in u-direction
+	 * \param[in] _KnotSpanIndexV The index of the knot span in v-direction
+	 * \param[in] _noComponents The number of components of a control point, e.g. 4 for homogeneous coordinates
+	 * \param[in] _controlPoints The control points sorted as the basis functions in computeLocalBasisFunctions
+	 * \param[out] _bezierPoints The Bezier control points of the knot span in the same order
+	 ***********/
+	void computeBezierControlPoints(int _KnotSpanIndexU, int _KnotSpanIndexV, int _noComponents,
+			const double* _controlPoints, double* _bezierPoints) const;
+
 	/// Get and set functions
 public:
 	/***********************************************************************************************
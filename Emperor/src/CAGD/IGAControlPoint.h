@@ -27,6 +27,9 @@
 #ifndef IGACONTROLPOINT_H_
 #define IGACONTROLPOINT_H_
 
+// Inclusion of standard libraries
+#include <cstddef>
+
 // Inclusion of user defined libraries
 
 namespace EMPIRE {
@@ -54,6 +57,9 @@ protected:
     /// Weight of the Control Point
     double W;
 
+    /// The packed [X Y Z W] of the Control Point in the array of its patch, kept up to date by the set functions, NULL if not bound
+    double* packedCoordinates;
+
     /// The constructor and the desctructor
 public:
     /***********************************************************************************************
@@ -71,7 +77,7 @@ public:
      * \author Andreas Apostolatos
      ***********/
     IGAControlPoint(int _dofIndex, double _X, double _Y, double _Z, double _W) :
-        dofIndex(_dofIndex), X(_X), Y(_Y), Z(_Z), W(_W) {
+        dofIndex(_dofIndex), X(_X), Y(_Y), Z(_Z), W(_W), packedCoordinates(NULL) {
     }
 
     /***********************************************************************************************
@@ -80,7 +86,7 @@ public:
      * \param[in] _X The Cartesian coordinate of the Control Point and its weight
      * \author Andreas Apostolatos
      ***********/
-    IGAControlPoint(int _dofIndex, double *_X):dofIndex(_dofIndex),X(_X[0]),Y(_X[1]),Z(_X[2]),W(_X[3]) {}
+    IGAControlPoint(int _dofIndex, double *_X):dofIndex(_dofIndex),X(_X[0]),Y(_X[1]),Z(_X[2]),W(_X[3]),packedCoordinates(NULL) {}
 
     /***********************************************************************************************
      * \brief Copy Constructor
@@ -89,7 +95,7 @@ public:
      ***********/
     IGAControlPoint(IGAControlPoint *_CP) :
         dofIndex(_CP->getDofIndex()), X(_CP->getX()), Y(_CP->getY()), Z(_CP->getZ()), W(
-                    _CP->getW()) {
+                    _CP->getW()), packedCoordinates(NULL) {
     }
 
     /***********************************************************************************************
@@ -155,6 +161,8 @@ public:
      ***********/
     inline void setX(double _X) {
         X = _X;
+        if (packedCoordinates != NULL)
+            packedCoordinates[0] = _X;
     }
     ;
 
@@ -164,6 +172,8 @@ public:
      ***********/
     inline void setY(double _Y) {
         Y = _Y;
+        if (packedCoordinates != NULL)
+            packedCoordinates[1] = _Y;
     }
     ;
 
@@ -173,6 +183,8 @@ public:
      ***********/
     inline void setZ(double _Z) {
         Z = _Z;
+        if (packedCoordinates != NULL)
+            packedCoordinates[2] = _Z;
     }
     ;
 
@@ -183,9 +195,25 @@ public:
      ***********/
     inline void setW(double _W) {
         W = _W;
+        if (packedCoordinates != NULL)
+            packedCoordinates[3] = _W;
     }
     ;
 
+    /***********************************************************************************************
+     * \brief Bind the point to its slot in the packed Control Point array of a patch and copy its coordinates there
+     * \param[in] _packedCoordinates The slot of 4 doubles [X Y Z W], NULL to release the point from the array
+     ***********/
+    inline void setPackedCoordinates(double* _packedCoordinates) {
+        packedCoordinates = _packedCoordinates;
+        if (packedCoordinates != NULL) {
+            packedCoordinates[0] = X;
+            packedCoordinates[1] = Y;
+            packedCoordinates[2] = Z;
+            packedCoordinates[3] = W;
+        }
+    }
+
 };
 
 }
@@ -21,10 +21,12 @@
 
 #include <assert.h>
 #include "IGAPatchCurve.h"
+#include "ScratchArray.h"
 #include "MathLibrary.h"
 #include "MatrixVectorMath.h"
 #include "Message.h"
 #include <math.h>
+#include <algorithm>
 
 using namespace std;
 
@@ -35,6 +37,8 @@ double IGAPatchCurve::TOL_CONVERGENCE = 1e-6;
 int IGAPatchCurve::MAX_NUM_ITERATIONS_NEWTONRAPHSON = 20;
 double IGAPatchCurve::TOL_CONVERGENCE_NEWTONRAPHSON = 1e-9;
 double IGAPatchCurve::TOL_LINEARIZATION = 1e-6;
+double IGAPatchCurve::TOL_ADAPTIVE_LINEARIZATION = 1e-3;
+int IGAPatchCurve::MAX_DEPTH_ADAPTIVE_LINEARIZATION = 16;
 
 IGAPatchCurve::IGAPatchCurve(int _IDBasis, int _pDegree, int _uNoKnots, double* _uKnotVector,
 		int _uNoControlPoints, double* _controlPointNet):
@@ -468,7 +472,7 @@ bool IGAPatchCurve::computePointProjectionOn2DCurve(double& _uPrm, double* _P, i
      */
 
     // Initialize auxiliary variables
-    int noCoord = 3;
+    const int noCoord = 3;
     int knotSpanIndex;
     double normEuclideanDistance;
     double jacobian;
@@ -507,8 +511,9 @@ bool IGAPatchCurve::computePointProjectionOn2DCurve(double& _uPrm, double* _P, i
     int noDeriv = 2;
 
     // Initialize the basis functions and their derivatives as well as the base vector and its derivative
-    double* locBasisFunctionsAndDerivatives = new double[noLocBasisFunctions*(noDeriv + 1)];
-    double* baseVectorAndDerivatives = new double[noDeriv*noCoord];
+    ScratchArray<double, SCRATCH_SIZE_1D * 3> locBasisFunctionsAndDerivatives(
+            noLocBasisFunctions * (noDeriv + 1));
+    ScratchArray<double, 2 * 3> baseVectorAndDerivatives(noDeriv * noCoord);
 
     // Initialize convergence flag
     bool isConvergent = false;
@@ -532,7 +537,7 @@ bool IGAPatchCurve::computePointProjectionOn2DCurve(double& _uPrm, double* _P, i
             euclideanDistance[iCoord] = P[iCoord] - cartesianCoordinates[iCoord];
 
         // Compute the norm of the Euclidean distance between the two points
-        normEuclideanDistance = MathLibrary::vector2norm(euclideanDistance, noCoord);
+        normEuclideanDistance = MathLibrary::vector2norm<noCoord>(euclideanDistance);
 
         // Check for point coincidence
         if(normEuclideanDistance < _tol){
@@ -545,14 +550,14 @@ bool IGAPatchCurve::computePointProjectionOn2DCurve(double& _uPrm, double* _P, i
             baseVector[iCoord] = baseVectorAndDerivatives[0*noCoord + iCoord];
             curvatureVector[iCoord] = baseVectorAndDerivatives[1*noCoord + iCoord];
         }
-        normBaseVectorSquare = MathLibrary::computeDenseDotProduct(noCoord, baseVector, baseVector);
-        distanceTimesCurvatureVector = MathLibrary::computeDenseDotProduct(noCoord, euclideanDistance, curvatureVector);
+        normBaseVectorSquare = MathLibrary::computeDenseDotProduct<noCoord>(baseVector, baseVector);
+        distanceTimesCurvatureVector = MathLibrary::computeDenseDotProduct<noCoord>(euclideanDistance, curvatureVector);
 
         // Compute the Jacobian of the system
         jacobian = - normBaseVectorSquare + distanceTimesCurvatureVector;
 
         // Compute the residual of the system
-        residual = MathLibrary::computeDenseDotProduct(noCoord, euclideanDistance, baseVector);
+        residual = MathLibrary::computeDenseDotProduct<noCoord>(euclideanDistance, baseVector);
 
         // Check the orthogonality condition
         if(fabs(residual) < _tol){
@@ -577,21 +582,18 @@ bool IGAPatchCurve::computePointProjectionOn2DCurve(double& _uPrm, double* _P, i
     for(int iCoord = 0; iCoord < _noCoord; iCoord++)
         _P[iCoord] = cartesianCoordinates[iCoord];
 
-    // Delete pointers
-    delete[] locBasisFunctionsAndDerivatives;
-    delete[] baseVectorAndDerivatives;
-
     // Return the convergence flag
     return isConvergent;
 }
 
 void IGAPatchCurve::linearize(int _type, bool _dir) {
     // Check if the linearization type is given correctly
-    if (_type != 0 && _type != 1 && _type != 2) assert(false);
+    if (_type != 0 && _type != 1 && _type != 2 && _type != 3) assert(false);
 
     if (_type == 0) linearizeUsingGreville(_dir);
     else if (_type == 1) linearizeUsingNCPxP(_dir);
     else if (_type == 2) linearizeCombined(_dir);
+    else if (_type == 3) linearizeAdaptive(_dir);
 
 }
 
@@ -744,4 +746,88 @@ void IGAPatchCurve::linearizeCombined(bool _dir) {
 
 }
 
+void IGAPatchCurve::linearizeAdaptive(bool _dir) {
+    /*
+     * Linear approximation of the nurbs curves
+     *
+     * Function layout :
+     *
+     * 1. Compute the tolerance from the extent of the control polygon
+     * 2. For every knot span of non-zero length
+     * 2.1. Split the knot span into p segments, such that symmetric arcs are not missed
+     * 2.2. Bisect every segment until its midpoint is within the tolerance of the chord
+     * 3. Store the points in data structure of polylines in the given direction
+     */
+
+    // 1. Compute the tolerance from the extent of the control polygon
+    double box[4] = {ControlPointNet[0].getX(), ControlPointNet[0].getX(),
+                     ControlPointNet[0].getY(), ControlPointNet[0].getY()};
+    for (int cpIndex = 1; cpIndex < uNoControlPoints; cpIndex++) {
+        box[0] = std::min(box[0], ControlPointNet[cpIndex].getX());
+        box[1] = std::max(box[1], ControlPointNet[cpIndex].getX());
+        box[2] = std::min(box[2], ControlPointNet[cpIndex].getY());
+        box[3] = std::max(box[3], ControlPointNet[cpIndex].getY());
+    }
+    const double tol = TOL_ADAPTIVE_LINEARIZATION
+            * sqrt((box[1] - box[0]) * (box[1] - box[0]) + (box[3] - box[2]) * (box[3] - box[2]));
+
+    // 2. For every knot span of non-zero length
+    const int p = IGABasis->getPolynomialDegree();
+    const double* knotVector = IGABasis->getKnotVector();
+    std::vector<double> knots;
+    std::vector<double> points;
+    double pointA[2], pointB[2];
+    computeCartesianCoordinates(pointA, knotVector[p]);
+    knots.push_back(knotVector[p]);
+    points.push_back(pointA[0]);
+    points.push_back(pointA[1]);
+    for (int span = p; span < IGABasis->getNoKnots() - p - 1; span++) {
+        if (knotVector[span] == knotVector[span + 1])
+            continue;
+        // 2.1. Split the knot span into p segments
+        for (int segment = 1; segment <= p; segment++) {
+            double uA = knots.back();
+            double uB = knotVector[span] + segment * (knotVector[span + 1] - knotVector[span]) / p;
+            pointA[0] = points[points.size() - 2];
+            pointA[1] = points[points.size() - 1];
+            computeCartesianCoordinates(pointB, uB);
+            // 2.2. Bisect the segment
+            bisectAdaptive(uA, pointA, uB, pointB, tol, 0, knots, points);
+        }
+    }
+
+    // 3. Store the points in data structure of polylines in the given direction
+    if (_dir) {
+        for (int i = 0; i < knots.size(); i++)
+            addPolylineVertex(knots[i], points[2 * i], points[2 * i + 1]);
+    } else {
+        for (int i = knots.size() - 1; i >= 0; i--)
+            addPolylineVertex(knots[i], points[2 * i], points[2 * i + 1]);
+    }
+}
+
+void IGAPatchCurve::bisectAdaptive(double _uA, const double* _pA, double _uB, const double* _pB,
+        double _tol, int _depth, std::vector<double>& _knots, std::vector<double>& _points) const {
+    // The distance of the midpoint from the chord, or from the first point for a closed segment
+    const double uM = 0.5 * (_uA + _uB);
+    double pM[2];
+    computeCartesianCoordinates(pM, uM);
+    const double chord[2] = {_pB[0] - _pA[0], _pB[1] - _pA[1]};
+    const double chordLength = sqrt(chord[0] * chord[0] + chord[1] * chord[1]);
+    double deviation;
+    if (chordLength > 0.0)
+        deviation = fabs(chord[0] * (pM[1] - _pA[1]) - chord[1] * (pM[0] - _pA[0])) / chordLength;
+    else
+        deviation = sqrt((pM[0] - _pA[0]) * (pM[0] - _pA[0]) + (pM[1] - _pA[1]) * (pM[1] - _pA[1]));
+
+    if (deviation > _tol && _depth < MAX_DEPTH_ADAPTIVE_LINEARIZATION) {
+        bisectAdaptive(_uA, _pA, uM, pM, _tol, _depth + 1, _knots, _points);
+        bisectAdaptive(uM, pM, _uB, _pB, _tol, _depth + 1, _knots, _points);
+    } else {
+        _knots.push_back(_uB);
+        _points.push_back(_pB[0]);
+        _points.push_back(_pB[1]);
+    }
+}
+
 } /* namespace EMPIRE */
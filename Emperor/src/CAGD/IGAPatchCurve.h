@@ -167,7 +167,7 @@ public:
 
     /***********************************************************************************************
      * \brief Create a linear approximation for the curve (Implementation migrated from IGAPatchSurfaceTrimming object)
-     * \param[in] _type (0: NCPxP, 1: Greville, 2: Combined) Type of linearization
+     * \param[in] _type (0: Greville, 1: NCPxP, 2: Combined, 3: Adaptive) Type of linearization
      * \param[in] _dir Direction of the linearization. True starts from beginning, False starts from the end
      * \author Altug Emiroglu
      ***********/
@@ -197,6 +197,31 @@ public:
      ***********/
     void linearizeCombined(bool _dir = true);
 
+    /***********************************************************************************************
+     * \brief Create a linear approximation for the curve whose deviation from the curve is bounded,
+     * the segments are bisected only where the midpoint deviates from the chord by more than
+     * TOL_ADAPTIVE_LINEARIZATION times the extent of the control polygon. Nearly straight parts
+     * of the curve get few vertices independently of the number of Control Points
+     * \param[in] _dir Direction of the linearization. True starts from beginning, False starts from the end
+     ***********/
+    void linearizeAdaptive(bool _dir = true);
+
+private:
+    /***********************************************************************************************
+     * \brief Bisect the segment between two curve points recursively until its midpoint is within
+     * the tolerance of the chord, and append the points after the first one
+     * \param[in] _uA The curve parameter of the first point
+     * \param[in] _pA The first point in the patch parameter space
+     * \param[in] _uB The curve parameter of the last point
+     * \param[in] _pB The last point in the patch parameter space
+     * \param[in] _tol The maximum distance of the curve from the chord
+     * \param[in] _depth The number of bisections so far
+     * \param[in/out] _knots The curve parameters of the points
+     * \param[in/out] _points The points in the patch parameter space
+     ***********/
+    void bisectAdaptive(double _uA, const double* _pA, double _uB, const double* _pB, double _tol,
+            int _depth, std::vector<double>& _knots, std::vector<double>& _points) const;
+
     /// get functions
 public:
     /***********************************************************************************************
@@ -279,6 +304,12 @@ public:
     /// The tolerance in the curve parameter space for the linearization of the trimming loops
     static double TOL_LINEARIZATION;
 
+    /// The chord deviation of the adaptive linearization relative to the extent of the control polygon
+    static double TOL_ADAPTIVE_LINEARIZATION;
+
+    /// The maximum number of bisections of a segment of the adaptive linearization
+    static int MAX_DEPTH_ADAPTIVE_LINEARIZATION;
+
 };
 
 } /* namespace EMPIRE */
@@ -28,10 +28,14 @@
 
 // Inclusion of user defined libraries
 #include "IGAPatchSurface.h"
+#include "ScratchArray.h"
 #include "MathLibrary.h"
 #include "MatrixVectorMath.h"
 #include "DataField.h"
 #include "Message.h"
+#include "ClipperAdapter.h"
+#include "TriangulatorAdaptor.h"
+#include "MonotonicArena.h"
 
 using namespace std;
 
@@ -58,7 +62,8 @@ const char IGAPatchSurface::EDGES[4] = {EDGE_U0, EDGE_UN, EDGE_V0, EDGE_VN};
 IGAPatchSurface::IGAPatchSurface(int _IDBasis, int _pDegree, int _uNoKnots, double* _uKnotVector,
         int _qDegree, int _vNoKnots, double* _vKnotVector, int _uNoControlPoints,
         int _vNoControlPoints, IGAControlPoint** _controlPointNet) :
-        uNoControlPoints(_uNoControlPoints), vNoControlPoints(_vNoControlPoints) {
+        uNoControlPoints(_uNoControlPoints), vNoControlPoints(_vNoControlPoints),
+        areIntegrationCellsComputed(false) {
 
     // Read input
     bool ucondition = _uNoControlPoints != _uNoKnots - _pDegree - 1;
@@ -101,26 +106,35 @@ IGAPatchSurface::IGAPatchSurface(int _IDBasis, int _pDegree, int _uNoKnots, doub
     // On the Control Point net
     assert(_controlPointNet != NULL);
     ControlPointNet = _controlPointNet;
+    controlPointCoordinates = new double[4 * uNoControlPoints * vNoControlPoints];
+    for (int i = 0; i < uNoControlPoints * vNoControlPoints; i++)
+        ControlPointNet[i]->setPackedCoordinates(&controlPointCoordinates[4 * i]);
+
+    // Select the evaluation kernel specialized on the polynomial degrees of the patch
+    fixedDegreeKernel = getFixedDegreeKernel(_pDegree, _qDegree);
 }
 
 IGAPatchSurface::~IGAPatchSurface() {
     delete IGABasis;
+    for (int i = 0; i < uNoControlPoints * vNoControlPoints; i++)
+        ControlPointNet[i]->setPackedCoordinates(NULL);
     delete[] ControlPointNet;
+    delete[] controlPointCoordinates;
 }
 
 void IGAPatchSurface::computeBoundingBox() {
     if (boundingBox.isComputed())
         return;
-    boundingBox[0] = getControlPointNet()[0]->getX();
-    boundingBox[1] = getControlPointNet()[0]->getX();
-    boundingBox[2] = getControlPointNet()[0]->getY();
-    boundingBox[3] = getControlPointNet()[0]->getY();
-    boundingBox[4] = getControlPointNet()[0]->getZ();
-    boundingBox[5] = getControlPointNet()[0]->getZ();
+    boundingBox[0] = controlPointCoordinates[0];
+    boundingBox[1] = controlPointCoordinates[0];
+    boundingBox[2] = controlPointCoordinates[1];
+    boundingBox[3] = controlPointCoordinates[1];
+    boundingBox[4] = controlPointCoordinates[2];
+    boundingBox[5] = controlPointCoordinates[2];
     for (int cpCount = 0; cpCount < getNoControlPoints(); cpCount++) {
-        double x = getControlPointNet()[cpCount]->getX();
-        double y = getControlPointNet()[cpCount]->getY();
-        double z = getControlPointNet()[cpCount]->getZ();
+        double x = controlPointCoordinates[4 * cpCount + 0];
+        double y = controlPointCoordinates[4 * cpCount + 1];
+        double z = controlPointCoordinates[4 * cpCount + 2];
         if (x < boundingBox[0])
             boundingBox[0] = x;
         else if (x > boundingBox[1])
@@ -135,6 +149,51 @@ void IGAPatchSurface::computeBoundingBox() {
             boundingBox[5] = z;
     }
     boundingBox.isComputed(true);
+
+    // The bounding boxes of the knot spans from their Bezier control points in homogeneous coordinates
+    BSplineBasis1D* uBasis = IGABasis->getUBSplineBasis1D();
+    BSplineBasis1D* vBasis = IGABasis->getVBSplineBasis1D();
+    const int pDegree = uBasis->getPolynomialDegree();
+    const int qDegree = vBasis->getPolynomialDegree();
+    const int noLocalControlPoints = (pDegree + 1) * (qDegree + 1);
+    const int numSpansU = uBasis->getNoKnots() - 1;
+    const double* knotU = uBasis->getKnotVector();
+    const double* knotV = vBasis->getKnotVector();
+    knotSpanBoundingBoxes.assign((size_t) numSpansU * (vBasis->getNoKnots() - 1), AABB());
+    vector<int> localIndices(noLocalControlPoints);
+    vector<double> localControlPoints(4 * noLocalControlPoints);
+    vector<double> bezierPoints(4 * noLocalControlPoints);
+    vector<double> bezierCoordinates(3 * noLocalControlPoints);
+    for (int spanV = qDegree; spanV < vBasis->computeNoBasisFunctions(); spanV++) {
+        if (knotV[spanV] == knotV[spanV + 1])
+            continue;
+        for (int spanU = pDegree; spanU < uBasis->computeNoBasisFunctions(); spanU++) {
+            if (knotU[spanU] == knotU[spanU + 1])
+                continue;
+            IGABasis->getBasisFunctionsIndex(spanU, spanV, &localIndices[0]);
+            for (int i = 0; i < noLocalControlPoints; i++) {
+                const double* controlPoint = &controlPointCoordinates[4 * localIndices[i]];
+                for (int k = 0; k < 3; k++)
+                    localControlPoints[4 * i + k] = controlPoint[3] * controlPoint[k];
+                localControlPoints[4 * i + 3] = controlPoint[3];
+            }
+            IGABasis->computeBezierControlPoints(spanU, spanV, 4, &localControlPoints[0], &bezierPoints[0]);
+            // The rational Bezier surface lies in the convex hull of its projected control points
+            for (int i = 0; i < noLocalControlPoints; i++)
+                for (int k = 0; k < 3; k++)
+                    bezierCoordinates[3 * i + k] = bezierPoints[4 * i + k] / bezierPoints[4 * i + 3];
+            knotSpanBoundingBoxes[spanV * numSpansU + spanU].computeFromPoints(&bezierCoordinates[0],
+                    noLocalControlPoints);
+        }
+    }
+}
+
+const AABB& IGAPatchSurface::getKnotSpanBoundingBox(int _spanU, int _spanV) const {
+    const int numSpansU = IGABasis->getUBSplineBasis1D()->getNoKnots() - 1;
+    assert(!knotSpanBoundingBoxes.empty());
+    assert(_spanU >= 0 && _spanU < numSpansU);
+    assert(_spanV >= 0 && _spanV < IGABasis->getVBSplineBasis1D()->getNoKnots() - 1);
+    return knotSpanBoundingBoxes[_spanV * numSpansU + _spanU];
 }
 
 double IGAPatchSurface::computePostprocessingScalarValue(double _u, double _v,
@@ -153,7 +212,7 @@ double IGAPatchSurface::computePostprocessingScalarValue(double _u, double _v,
     int pDegree = IGABasis->getUBSplineBasis1D()->getPolynomialDegree();
     int qDegree = IGABasis->getVBSplineBasis1D()->getPolynomialDegree();
     int noLocalBasisFunctions = (pDegree + 1) * (qDegree + 1);
-    double* localBasisFunctions = new double[noLocalBasisFunctions];
+    ScratchArray<double, SCRATCH_SIZE_2D> localBasisFunctions(noLocalBasisFunctions);
 
     IGABasis->computeLocalBasisFunctions(localBasisFunctions, _u, spanU, _v, spanV);
 
@@ -180,9 +239,6 @@ double IGAPatchSurface::computePostprocessingScalarValue(double _u, double _v,
         }
     }
 
-    // Free the memory from the heap
-    delete[] localBasisFunctions;
-
     return result;
 }
 
@@ -198,6 +254,287 @@ void IGAPatchSurface::addTrimCurve(int _direction, int _pDegree, int _uNoKnots,
                                                _uNoControlPoints, _controlPointNet);
 }
 
+void IGAPatchSurface::linearizeTrimming(int _type) {
+    Trimming.linearizeLoops(_type);
+
+    // Classify the knot spans once, so that the projected elements are clipped by few polygons
+    knotSpanTrimming.clear();
+    knotSpanTrimmedPolygons.clear();
+    integrationCells.clear();
+    areIntegrationCellsComputed = false;
+    if (!Trimming.isTrimmed())
+        return;
+    const BSplineBasis1D* uBasis = IGABasis->getUBSplineBasis1D();
+    const BSplineBasis1D* vBasis = IGABasis->getVBSplineBasis1D();
+    const double* knotVectorU = uBasis->getKnotVector();
+    const double* knotVectorV = vBasis->getKnotVector();
+    const int numSpansU = uBasis->getNoKnots() - 1;
+    const int numSpansV = vBasis->getNoKnots() - 1;
+    knotSpanTrimming.resize(numSpansU * numSpansV, KNOTSPAN_TRIMMED);
+    std::vector<std::pair<double,double> > knotSpanWindow(4);
+    std::vector<std::vector<std::pair<double,double> > > trimmedPolygons;
+    for (int spanV = 0; spanV < numSpansV; spanV++) {
+        if (knotVectorV[spanV] == knotVectorV[spanV + 1])
+            continue;
+        for (int spanU = 0; spanU < numSpansU; spanU++) {
+            if (knotVectorU[spanU] == knotVectorU[spanU + 1])
+                continue;
+            knotSpanWindow[0] = make_pair(knotVectorU[spanU], knotVectorV[spanV]);
+            knotSpanWindow[1] = make_pair(knotVectorU[spanU + 1], knotVectorV[spanV]);
+            knotSpanWindow[2] = make_pair(knotVectorU[spanU + 1], knotVectorV[spanV + 1]);
+            knotSpanWindow[3] = make_pair(knotVectorU[spanU], knotVectorV[spanV + 1]);
+            const int index = spanV * numSpansU + spanU;
+            bool isCut = Trimming.clip(knotSpanWindow, trimmedPolygons);
+            if (trimmedPolygons.empty())
+                knotSpanTrimming[index] = KNOTSPAN_TRIMMED;
+            else if (!isCut)
+                knotSpanTrimming[index] = KNOTSPAN_UNTRIMMED;
+            else {
+                knotSpanTrimming[index] = KNOTSPAN_CUT;
+                knotSpanTrimmedPolygons[index].swap(trimmedPolygons);
+            }
+        }
+    }
+}
+
+IGAPatchSurface::KnotSpanTrimming IGAPatchSurface::getKnotSpanTrimming(int _spanU, int _spanV) const {
+    if (knotSpanTrimming.empty())
+        return KNOTSPAN_UNTRIMMED;
+    const int numSpansU = IGABasis->getUBSplineBasis1D()->getNoKnots() - 1;
+    assert(_spanU >= 0 && _spanU < numSpansU);
+    assert(_spanV >= 0 && _spanV < IGABasis->getVBSplineBasis1D()->getNoKnots() - 1);
+    return (KnotSpanTrimming) knotSpanTrimming[_spanV * numSpansU + _spanU];
+}
+
+MemoryUsage IGAPatchSurface::getMemoryUsage() const {
+    MemoryUsage usage;
+    const size_t numControlPoints = (size_t) uNoControlPoints * vNoControlPoints;
+    usage.add("control points", numControlPoints * (sizeof(IGAControlPoint*) + sizeof(IGAControlPoint)
+            + 4 * sizeof(double)));
+    usage.add("knot vectors", (IGABasis->getUBSplineBasis1D()->getNoKnots()
+            + IGABasis->getVBSplineBasis1D()->getNoKnots()) * sizeof(double));
+    usage.add("trimming", Trimming.getMemory());
+    size_t knotSpanBytes = MemoryUsage::ofVector(knotSpanTrimming);
+    for (std::map<int, std::vector<std::vector<std::pair<double, double> > > >::const_iterator it =
+            knotSpanTrimmedPolygons.begin(); it != knotSpanTrimmedPolygons.end(); it++) {
+        knotSpanBytes += sizeof(*it) + MemoryUsage::MAP_NODE_OVERHEAD + MemoryUsage::ofVector(it->second);
+        for (size_t i = 0; i < it->second.size(); i++)
+            knotSpanBytes += MemoryUsage::ofVector(it->second[i]);
+    }
+    usage.add("knot span trimming", knotSpanBytes);
+    usage.add("knot span bounding boxes", MemoryUsage::ofVector(knotSpanBoundingBoxes));
+    size_t integrationCellBytes = MemoryUsage::ofVector(integrationCells);
+    for (size_t i = 0; i < integrationCells.size(); i++) {
+        const IntegrationCell& cell = integrationCells[i];
+        integrationCellBytes += MemoryUsage::ofVector(cell.polygons)
+                + MemoryUsage::ofVector(cell.triangles) + MemoryUsage::ofVector(cell.triangulationPaths);
+        for (size_t j = 0; j < cell.polygons.size(); j++)
+            integrationCellBytes += MemoryUsage::ofVector(cell.polygons[j]);
+        for (size_t j = 0; j < cell.triangles.size(); j++)
+            integrationCellBytes += MemoryUsage::ofVector(cell.triangles[j]);
+    }
+    usage.add("integration cells", integrationCellBytes);
+    return usage;
+}
+
+void IGAPatchSurface::clipByKnotSpanTrimming(int _spanU, int _spanV,
+        const std::vector<std::pair<double,double> >& _polygonUV,
+        std::vector<std::vector<std::pair<double,double> > >& _listPolygonUV) const {
+    if (knotSpanTrimming.empty() && Trimming.isTrimmed()) { // the knot spans are not classified
+        Trimming.clip(_polygonUV, _listPolygonUV);
+        return;
+    }
+    KnotSpanTrimming state = getKnotSpanTrimming(_spanU, _spanV);
+    _listPolygonUV.clear();
+    if (state == KNOTSPAN_UNTRIMMED) {
+        _listPolygonUV.push_back(_polygonUV);
+        return;
+    }
+    if (state == KNOTSPAN_TRIMMED || _polygonUV.size() < 3)
+        return;
+    const int index = _spanV * (IGABasis->getUBSplineBasis1D()->getNoKnots() - 1) + _spanU;
+    const std::vector<std::vector<std::pair<double,double> > >& trimmedPolygons =
+            knotSpanTrimmedPolygons.find(index)->second;
+    ClipperAdapter c;
+    for (int i = 0; i < trimmedPolygons.size(); i++)
+        c.addPathClipper(trimmedPolygons[i]);
+    // The holes of the trimmed polygons are clockwise
+    c.setFilling(ClipperAdapter::POSITIVE, 0);
+    c.clip(_polygonUV, _listPolygonUV);
+}
+
+void IGAPatchSurface::computeIntegrationCells(int _numThreads) {
+    if (areIntegrationCellsComputed)
+        return;
+    const BSplineBasis1D* uBasis = IGABasis->getUBSplineBasis1D();
+    const BSplineBasis1D* vBasis = IGABasis->getVBSplineBasis1D();
+    const double* knotVectorU = uBasis->getKnotVector();
+    const double* knotVectorV = vBasis->getKnotVector();
+    const int numSpansU = uBasis->getNoKnots() - 1;
+    const int numSpansV = vBasis->getNoKnots() - 1;
+
+    // The knot spans of non-zero area which are not trimmed away
+    std::vector<std::pair<int, int> > spans;
+    for (int spanV = 0; spanV < numSpansV; spanV++) {
+        if (knotVectorV[spanV] == knotVectorV[spanV + 1])
+            continue;
+        for (int spanU = 0; spanU < numSpansU; spanU++) {
+            if (knotVectorU[spanU] == knotVectorU[spanU + 1])
+                continue;
+            if (getKnotSpanTrimming(spanU, spanV) != KNOTSPAN_TRIMMED)
+                spans.push_back(make_pair(spanU, spanV));
+        }
+    }
+
+    // Clip and triangulate the knot spans independently of each other
+    std::vector<IntegrationCell> cells(spans.size());
+    const int numSpans = spans.size();
+#pragma omp parallel for num_threads(_numThreads) schedule(dynamic, 16)
+    for (int i = 0; i < numSpans; i++) {
+        IntegrationCell& cell = cells[i];
+        cell.spanU = spans[i].first;
+        cell.spanV = spans[i].second;
+
+        // The clipping and triangulation temporaries of the knot span are released at its end
+        MonotonicArena::Scope arenaScope(MonotonicArena::getThreadArena());
+        std::vector<std::pair<double,double> > knotSpanWindow(4);
+        knotSpanWindow[0] = make_pair(knotVectorU[cell.spanU], knotVectorV[cell.spanV]);
+        knotSpanWindow[1] = make_pair(knotVectorU[cell.spanU + 1], knotVectorV[cell.spanV]);
+        knotSpanWindow[2] = make_pair(knotVectorU[cell.spanU + 1], knotVectorV[cell.spanV + 1]);
+        knotSpanWindow[3] = make_pair(knotVectorU[cell.spanU], knotVectorV[cell.spanV + 1]);
+        std::vector<std::vector<std::pair<double,double> > > trimmedPolygons;
+        clipByKnotSpanTrimming(cell.spanU, cell.spanV, knotSpanWindow, trimmedPolygons);
+        for (int j = 0; j < trimmedPolygons.size(); j++) {
+            ClipperAdapter::cleanPolygon(trimmedPolygons[j]);
+            if (trimmedPolygons[j].size() < 3)
+                continue;
+            std::vector<std::vector<std::pair<double,double> > > triangles;
+            TriangulatorAdaptor::TriangulationPath path = TriangulatorAdaptor::triangulatePolygon(
+                    trimmedPolygons[j], triangles);
+            cell.polygons.push_back(trimmedPolygons[j]);
+            cell.triangulationPaths.push_back(path);
+            cell.triangles.insert(cell.triangles.end(), triangles.begin(), triangles.end());
+        }
+    }
+
+    // Keep the cells with a part inside the trimmed domain
+    integrationCells.clear();
+    for (int i = 0; i < numSpans; i++) {
+        if (cells[i].polygons.empty())
+            continue;
+        integrationCells.push_back(IntegrationCell());
+        integrationCells.back().spanU = cells[i].spanU;
+        integrationCells.back().spanV = cells[i].spanV;
+        integrationCells.back().polygons.swap(cells[i].polygons);
+        integrationCells.back().triangles.swap(cells[i].triangles);
+        integrationCells.back().triangulationPaths.swap(cells[i].triangulationPaths);
+    }
+    areIntegrationCellsComputed = true;
+}
+
+const std::vector<IGAPatchSurface::IntegrationCell>& IGAPatchSurface::getIntegrationCells() const {
+    assert(areIntegrationCellsComputed);
+    return integrationCells;
+}
+
+template<int P, int Q>
+void IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree(double* _coords,
+        double* _baseVectors, double _u, int _spanU, double _v, int _spanV) const {
+    /*
+     *  Evaluates the surface S = A / W with A = Sum_(i,j) N_i(u) * M_j(v) * w_ij * P_ij and W = Sum_(i,j) N_i(u) * M_j(v) * w_ij
+     *  and, if requested, its base vectors g1 = (A_,u - W_,u * S) / W and g2 = (A_,v - W_,v * S) / W. The weights of B-Spline
+     *  patches are all equal to one. With P and Q known at compile time all loops over the basis functions can be unrolled.
+     */
+
+    // Compute the 1D basis functions (and their first derivatives) in both parametric directions
+    double uBasisFcts[2 * (P + 1)];
+    double vBasisFcts[2 * (Q + 1)];
+    if (_baseVectors != NULL) {
+        IGABasis->getUBSplineBasis1D()->computeLocalBasisFunctionsAndFirstDerivativesFixedDegree<P>(
+                uBasisFcts, _u, _spanU);
+        IGABasis->getVBSplineBasis1D()->computeLocalBasisFunctionsAndFirstDerivativesFixedDegree<Q>(
+                vBasisFcts, _v, _spanV);
+    } else {
+        IGABasis->getUBSplineBasis1D()->computeLocalBasisFunctionsFixedDegree<P>(uBasisFcts, _u,
+                _spanU);
+        IGABasis->getVBSplineBasis1D()->computeLocalBasisFunctionsFixedDegree<Q>(vBasisFcts, _v,
+                _spanV);
+    }
+
+    // Contract the tensor product basis with the weighted Control Points
+    double A[3] = { 0.0, 0.0, 0.0 };
+    double dAdu[3] = { 0.0, 0.0, 0.0 };
+    double dAdv[3] = { 0.0, 0.0, 0.0 };
+    double W = 0.0;
+    double dWdu = 0.0;
+    double dWdv = 0.0;
+    for (int j = 0; j <= Q; j++) {
+        int CPindex = (_spanV - Q + j) * uNoControlPoints + _spanU - P;
+        for (int i = 0; i <= P; i++, CPindex++) {
+            const double* CP = &controlPointCoordinates[4 * CPindex];
+            double w = CP[3];
+            double wX = w * CP[0];
+            double wY = w * CP[1];
+            double wZ = w * CP[2];
+            double NM = uBasisFcts[i] * vBasisFcts[j];
+            A[0] += NM * wX;
+            A[1] += NM * wY;
+            A[2] += NM * wZ;
+            W += NM * w;
+            if (_baseVectors != NULL) {
+                double dNM = uBasisFcts[P + 1 + i] * vBasisFcts[j];
+                double NdM = uBasisFcts[i] * vBasisFcts[Q + 1 + j];
+                dAdu[0] += dNM * wX;
+                dAdu[1] += dNM * wY;
+                dAdu[2] += dNM * wZ;
+                dWdu += dNM * w;
+                dAdv[0] += NdM * wX;
+                dAdv[1] += NdM * wY;
+                dAdv[2] += NdM * wZ;
+                dWdv += NdM * w;
+            }
+        }
+    }
+
+    // Divide through by the weight function
+    double S[3];
+    for (int k = 0; k < 3; k++)
+        S[k] = A[k] / W;
+    if (_coords != NULL)
+        for (int k = 0; k < 3; k++)
+            _coords[k] = S[k];
+    if (_baseVectors != NULL)
+        for (int k = 0; k < 3; k++) {
+            _baseVectors[k] = (dAdu[k] - dWdu * S[k]) / W;
+            _baseVectors[3 + k] = (dAdv[k] - dWdv * S[k]) / W;
+        }
+}
+
+IGAPatchSurface::FixedDegreeKernel IGAPatchSurface::getFixedDegreeKernel(int _pDegree,
+        int _qDegree) {
+    static const FixedDegreeKernel kernels[MAX_FIXED_DEGREE][MAX_FIXED_DEGREE] = {
+        { &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<1, 1>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<1, 2>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<1, 3>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<1, 4> },
+        { &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<2, 1>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<2, 2>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<2, 3>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<2, 4> },
+        { &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<3, 1>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<3, 2>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<3, 3>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<3, 4> },
+        { &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<4, 1>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<4, 2>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<4, 3>,
+          &IGAPatchSurface::computeCartesianCoordinatesAndBaseVectorsFixedDegree<4, 4> } };
+
+    if (_pDegree < 1 || _pDegree > MAX_FIXED_DEGREE || _qDegree < 1 || _qDegree > MAX_FIXED_DEGREE)
+        return NULL;
+    return kernels[_pDegree - 1][_qDegree - 1];
+}
+
 void IGAPatchSurface::computeCartesianCoordinates(double* _cartesianCoordinates, double _uPrm,
         int _uKnotSpanIndex, double _vPrm, int _vKnotSpanIndex) const{
 
@@ -209,6 +546,13 @@ void IGAPatchSurface::computeCartesianCoordinates(double* _cartesianCoordinates,
     // Read input
     assert(_cartesianCoordinates != NULL);
 
+    // Use the kernel specialized on the polynomial degrees if there is one
+    if (fixedDegreeKernel != NULL) {
+        (this->*fixedDegreeKernel)(_cartesianCoordinates, NULL, _uPrm, _uKnotSpanIndex, _vPrm,
+                _vKnotSpanIndex);
+        return;
+    }
+
     // Initialize the coordinates of the point
     for (int i = 0; i < 3; i++)
         _cartesianCoordinates[i] = 0;
@@ -217,7 +561,7 @@ void IGAPatchSurface::computeCartesianCoordinates(double* _cartesianCoordinates,
     int pDegree = IGABasis->getUBSplineBasis1D()->getPolynomialDegree();
     int qDegree = IGABasis->getVBSplineBasis1D()->getPolynomialDegree();
     int noLocalBasisFunctions = (pDegree + 1) * (qDegree + 1);
-    double* localBasisFunctions = new double[noLocalBasisFunctions];
+    ScratchArray<double, SCRATCH_SIZE_2D> localBasisFunctions(noLocalBasisFunctions);
 
     IGABasis->computeLocalBasisFunctions(localBasisFunctions, _uPrm, _uKnotSpanIndex, _vPrm,
             _vKnotSpanIndex);
@@ -238,21 +582,18 @@ void IGAPatchSurface::computeCartesianCoordinates(double* _cartesianCoordinates,
 
             // Compute iteratively the x-coordinate of the point
             _cartesianCoordinates[0] += localBasisFunctions[counter_basis]
-                    * ControlPointNet[CPindex]->getX();
+                    * controlPointCoordinates[4 * CPindex + 0];
             // Compute iteratively the y-coordinate of the point
             _cartesianCoordinates[1] += localBasisFunctions[counter_basis]
-                    * ControlPointNet[CPindex]->getY();
+                    * controlPointCoordinates[4 * CPindex + 1];
             // Compute iteratively the z-coordinate of the point
             _cartesianCoordinates[2] += localBasisFunctions[counter_basis]
-                    * ControlPointNet[CPindex]->getZ();
+                    * controlPointCoordinates[4 * CPindex + 2];
 
             // Update basis function's counter
             counter_basis++;
         }
     }
-
-    // Free the memory from the heap
-    delete[] localBasisFunctions;
 }
 
 void IGAPatchSurface::computeCartesianCoordinates(double* _cartesianCoordinates,
@@ -293,13 +634,13 @@ void IGAPatchSurface::computeCartesianCoordinates(double* _cartesianCoordinates,
 
             // Compute iteratively the x-coordinate of the point
             _cartesianCoordinates[0] += _localBasisFunctions[counter_basis]
-                    * ControlPointNet[CPindex]->getX();
+                    * controlPointCoordinates[4 * CPindex + 0];
             // Compute iteratively the y-coordinate of the point
             _cartesianCoordinates[1] += _localBasisFunctions[counter_basis]
-                    * ControlPointNet[CPindex]->getY();
+                    * controlPointCoordinates[4 * CPindex + 1];
             // Compute iteratively the z-coordinate of the point
             _cartesianCoordinates[2] += _localBasisFunctions[counter_basis]
-                    * ControlPointNet[CPindex]->getZ();
+                    * controlPointCoordinates[4 * CPindex + 2];
 
             // Update basis function's counter
             counter_basis++;
@@ -364,13 +705,13 @@ void IGAPatchSurface::computeCartesianCoordinates(double* _cartesianCoordinates,
                     derivIndex, counter_basis);
             // Compute iteratively the x-coordinate of the point
             _cartesianCoordinates[0] += _localBasisFctsAndDerivs[indexBasis]
-                    * ControlPointNet[CPindex]->getX();
+                    * controlPointCoordinates[4 * CPindex + 0];
             // Compute iteratively the y-coordinate of the point
             _cartesianCoordinates[1] += _localBasisFctsAndDerivs[indexBasis]
-                    * ControlPointNet[CPindex]->getY();
+                    * controlPointCoordinates[4 * CPindex + 1];
             // Compute iteratively the z-coordinate of the point
             _cartesianCoordinates[2] += _localBasisFctsAndDerivs[indexBasis]
-                    * ControlPointNet[CPindex]->getZ();
+                    * controlPointCoordinates[4 * CPindex + 2];
             // Update basis function's counter
             counter_basis++;
         }
@@ -495,15 +836,15 @@ void IGAPatchSurface::computeBaseVectors(double* _baseVectors,
                     // Compute iteratively the x-coordinate of the point
                     _baseVectors[counterBaseVector * noCoordinates + 0] +=
                             _localBasisFunctionsAndDerivatives[indexBasis]
-                                    * ControlPointNet[CPindex]->getX();
+                                    * controlPointCoordinates[4 * CPindex + 0];
                     // Compute iteratively the y-coordinate of the point
                     _baseVectors[counterBaseVector * noCoordinates + 1] +=
                             _localBasisFunctionsAndDerivatives[indexBasis]
-                                    * ControlPointNet[CPindex]->getY();
+                                    * controlPointCoordinates[4 * CPindex + 1];
                     // Compute iteratively the z-coordinate of the point
                     _baseVectors[counterBaseVector * noCoordinates + 2] +=
                             _localBasisFunctionsAndDerivatives[indexBasis]
-                                    * ControlPointNet[CPindex]->getZ();
+                                    * controlPointCoordinates[4 * CPindex + 2];
 
                     // Update the base vector counter
                     counterBaseVector++;
@@ -519,6 +860,12 @@ void IGAPatchSurface::computeBaseVectors(double* _baseVectors,
 void IGAPatchSurface::computeBaseVectors(double* _baseVectors, double _u, int _spanU, double _v,
         int _spanV) const {
 
+    // Use the kernel specialized on the polynomial degrees if there is one
+    if (fixedDegreeKernel != NULL) {
+        (this->*fixedDegreeKernel)(NULL, _baseVectors, _u, _spanU, _v, _spanV);
+        return;
+    }
+
     // Get the polynomial degree of the basis in each direction
     int pDegree = IGABasis->getUBSplineBasis1D()->getPolynomialDegree();
     int qDegree = IGABasis->getVBSplineBasis1D()->getPolynomialDegree();
@@ -528,8 +875,8 @@ void IGAPatchSurface::computeBaseVectors(double* _baseVectors, double _u, int _s
     int derivDegree = 1;
 
     // Compute the local basis functions and their derivatives
-    double* localBasisFunctionsAndDerivatives = new double[(derivDegree + 1) * (derivDegree + 2)
-            * noLocalBasisFunctions / 2];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * SCRATCH_SIZE_2D> localBasisFunctionsAndDerivatives(
+            (derivDegree + 1) * (derivDegree + 2) * noLocalBasisFunctions / 2);
     IGABasis->computeLocalBasisFunctionsAndDerivatives(localBasisFunctionsAndDerivatives,
             derivDegree, _u, _spanU, _v, _spanV);
 
@@ -657,11 +1004,11 @@ void IGAPatchSurface::computeBaseVectorsAndDerivatives(double* _baseVectorsAndDe
 
                             // Factor by which to multiply the derivative of the basis function
                             if (k == 0)
-                                factor = ControlPointNet[indexCP]->getX();
+                                factor = controlPointCoordinates[4 * indexCP + 0];
                             else if (k == 1)
-                                factor = ControlPointNet[indexCP]->getY();
+                                factor = controlPointCoordinates[4 * indexCP + 1];
                             else
-                                factor = ControlPointNet[indexCP]->getZ();
+                                factor = controlPointCoordinates[4 * indexCP + 2];
 
                             // Add the contribution from each basis function in the interval
                             _baseVectorsAndDerivatives[indexBaseVct] +=
@@ -692,7 +1039,7 @@ void IGAPatchSurface::computeSurfaceNormalVectorAndDerivatives(double* _surfNorm
     int indexBaseVct;
 
     // Number of Cartesian coodinates
-    int noCoord = 3;
+    const int noCoord = 3;
 
     // Get the base vector along u
     double baseVctU[noCoord];
@@ -741,7 +1088,7 @@ void IGAPatchSurface::computeSurfaceNormalVectorAndDerivatives(double* _surfNorm
     MathLibrary::crossProduct(surfNormalVctTilde, baseVctU, baseVctV);
 
     // Compute the differential area
-    double dA = MathLibrary::vector2norm(surfNormalVctTilde,noCoord);
+    double dA = MathLibrary::vector2norm<noCoord>(surfNormalVctTilde);
 
     // Compute the surface normal vector
     for(int i = 0; i < noCoord; i++){
@@ -754,9 +1101,9 @@ void IGAPatchSurface::computeSurfaceNormalVectorAndDerivatives(double* _surfNorm
     MathLibrary::crossProduct(dBaseVctUdUTimesBaseVctV, dBaseVctUdU, baseVctV);
     MathLibrary::crossProduct(baseVctUTimesdBaseVctVdU, baseVctU, dBaseVctVdU);
     // A1TimesA2Komma1 = cross(dGCovariant(:,1),GCovariant(:,2)) + cross(GCovariant(:,1),dGCovariant(:,3));
-    MathLibrary::computeDenseVectorAddition(dBaseVctUdUTimesBaseVctV, baseVctUTimesdBaseVctVdU,1.0,noCoord);
+    MathLibrary::computeDenseVectorAddition<noCoord>(dBaseVctUdUTimesBaseVctV, baseVctUTimesdBaseVctVdU, 1.0);
     // A3TildeDotA1TimesA2Komma1 = A3Tilde'*A1TimesA2Komma1
-    double A3TildeDotA1TimesA2Komma1 = MathLibrary::computeDenseDotProduct(noCoord,surfNormalVctTilde,dBaseVctUdUTimesBaseVctV);
+    double A3TildeDotA1TimesA2Komma1 = MathLibrary::computeDenseDotProduct<noCoord>(surfNormalVctTilde,dBaseVctUdUTimesBaseVctV);
     // dA3Komma1 = (1/dA)*A1TimesA2Komma1 - (1/dA^3)*(A3Tilde'*A1TimesA2Komma1)*A3Tilde;
     for(int i = 0; i < noCoord; i++){
         _surfNormalVctAndDervs[1*noCoord + i] = (1/dA)*dBaseVctUdUTimesBaseVctV[i] - (1/(dA*dA*dA))*A3TildeDotA1TimesA2Komma1*surfNormalVctTilde[i];
@@ -768,8 +1115,8 @@ void IGAPatchSurface::computeSurfaceNormalVectorAndDerivatives(double* _surfNorm
     MathLibrary::crossProduct(dBaseVctUdVTimesBaseVctV, dBaseVctUdV, baseVctV);
     MathLibrary::crossProduct(baseVctUTimesdBaseVctVdV, baseVctU, dBaseVctVdV);
     // A1TimesA2Komma2 = cross(dGCovariant(:,3),GCovariant(:,2)) + cross(GCovariant(:,1),dGCovariant(:,2));
-    MathLibrary::computeDenseVectorAddition(dBaseVctUdVTimesBaseVctV, baseVctUTimesdBaseVctVdV,1.0,noCoord);
-    double A3TildeDotA1TimesA2Komma2 = MathLibrary::computeDenseDotProduct(noCoord,surfNormalVctTilde,dBaseVctUdVTimesBaseVctV);
+    MathLibrary::computeDenseVectorAddition<noCoord>(dBaseVctUdVTimesBaseVctV, baseVctUTimesdBaseVctVdV, 1.0);
+    double A3TildeDotA1TimesA2Komma2 = MathLibrary::computeDenseDotProduct<noCoord>(surfNormalVctTilde,dBaseVctUdVTimesBaseVctV);
     // dA3Komma2 = (1/dA)*A1TimesA2Komma2 - (1/dA^3)*(A3Tilde'*A1TimesA2Komma2)*A3Tilde;
     for(int i = 0; i < noCoord; i++){
         _surfNormalVctAndDervs[2*noCoord + i] = (1/dA)*dBaseVctUdVTimesBaseVctV[i] - (1/(dA*dA*dA))*A3TildeDotA1TimesA2Komma2*surfNormalVctTilde[i];
@@ -788,7 +1135,7 @@ void IGAPatchSurface::computeCovariantMetricTensor(double* _covariantMetricTenso
     int indexBaseVct;
 
     // Number of Cartesian coodinates
-    int noCoord = 3;
+    const int noCoord = 3;
 
     // Get the base vector along u
     double baseVctU[noCoord];
@@ -805,10 +1152,10 @@ void IGAPatchSurface::computeCovariantMetricTensor(double* _covariantMetricTenso
     }
 
     // Compute the entries of the covariant metric tensor
-    _covariantMetricTensor[0] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,baseVctU,baseVctU);
-    _covariantMetricTensor[1] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,baseVctU,baseVctV);
-    _covariantMetricTensor[2] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,baseVctV,baseVctU);
-    _covariantMetricTensor[3] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,baseVctV,baseVctV);
+    _covariantMetricTensor[0] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(baseVctU,baseVctU);
+    _covariantMetricTensor[1] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(baseVctU,baseVctV);
+    _covariantMetricTensor[2] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(baseVctV,baseVctU);
+    _covariantMetricTensor[3] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(baseVctV,baseVctV);
 }
 
 void IGAPatchSurface::computeContravariantBaseVectors(double* _contravariantBaseVcts, double* _covariantMetricTensor, double* _baseVctsAndDerivs, int _derivDegreeBaseVec) {
@@ -875,7 +1222,7 @@ void IGAPatchSurface::computeContravariantCurvatureTensor(double* _contravariant
     int indexBaseVct;
 
     // Number of Cartesian coodinates
-    int noCoord = 3;
+    const int noCoord = 3;
 
     // Get the derivative of base vector along u with respect to u parametric direction
     double dBaseVctUdU[noCoord];
@@ -906,14 +1253,14 @@ void IGAPatchSurface::computeContravariantCurvatureTensor(double* _contravariant
     }
 
     // Compute the components of the curvature tensor in the contravariant basis
-    _contravariantCurvatureTensor[0] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,dBaseVctUdU,_surfNormalVctAndDervs);
-    _contravariantCurvatureTensor[1] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,dBaseVctUdV,_surfNormalVctAndDervs);
-    _contravariantCurvatureTensor[2] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,dBaseVctVdU,_surfNormalVctAndDervs);
-    _contravariantCurvatureTensor[3] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,dBaseVctVdV,_surfNormalVctAndDervs);
+    _contravariantCurvatureTensor[0] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(dBaseVctUdU,_surfNormalVctAndDervs);
+    _contravariantCurvatureTensor[1] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(dBaseVctUdV,_surfNormalVctAndDervs);
+    _contravariantCurvatureTensor[2] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(dBaseVctVdU,_surfNormalVctAndDervs);
+    _contravariantCurvatureTensor[3] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(dBaseVctVdV,_surfNormalVctAndDervs);
 }
 
 bool IGAPatchSurface::computePointProjectionOnPatch(double& _u, double& _v, double* _P,
-        bool& _flagConverge, int _maxIt, double _orthoTol, double _distTol) {
+        bool& _flagConverge, int _maxIt, double _orthoTol, double _distTol, int* _numIterations) {
 
     /*
      * Returns the projection of a point _P on the NURBS patch given an initial guess for the surface parameters _u, _v via references:
@@ -971,7 +1318,7 @@ bool IGAPatchSurface::computePointProjectionOnPatch(double& _u, double& _v, doub
     //bool fixV = false;
 
     // Initialize number of spatial dimensions
-    int noSpatialDimensions = 3;
+    const int noSpatialDimensions = 3;
 
     // Save the location of the point to be projected
     double point[noSpatialDimensions];
@@ -1044,15 +1391,16 @@ bool IGAPatchSurface::computePointProjectionOnPatch(double& _u, double& _v, doub
     int noBaseVcts = 2;
 
     // Initialize the array of the IGA basis functions and their derivatives
-    double* basisFctsAndDerivs = new double[(derivDegreeBasis + 1) * (derivDegreeBasis + 2)
-            * noLocalBasisFcts / 2];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * SCRATCH_SIZE_2D> basisFctsAndDerivs(
+            (derivDegreeBasis + 1) * (derivDegreeBasis + 2) * noLocalBasisFcts / 2);
 
     // Number of derivatives for the base vectors
     int derivDegreeBaseVcts = derivDegreeBasis - 1;
 
     // Initialize the array of the base vectors and their derivatives
-    double* baseVecAndDerivs = new double[(derivDegreeBaseVcts + 1) * (derivDegreeBaseVcts + 2)
-            * noSpatialDimensions * noBaseVcts / 2];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * 3 * 2> baseVecAndDerivs(
+            (derivDegreeBaseVcts + 1) * (derivDegreeBaseVcts + 2) * noSpatialDimensions
+                    * noBaseVcts / 2);
 
     // 2. Loop over all the Newton-Raphson iterations
     while (counter <= _maxIt) {
@@ -1060,8 +1408,8 @@ bool IGAPatchSurface::computePointProjectionOnPatch(double& _u, double& _v, doub
         counter++;
 
         // 2ii. Find the span of the given surface parameters
-        uKnotSpan = IGABasis->getUBSplineBasis1D()->findKnotSpan(_u);
-        vKnotSpan = IGABasis->getVBSplineBasis1D()->findKnotSpan(_v);
+        uKnotSpan = IGABasis->getUBSplineBasis1D()->findKnotSpan(_u, uKnotSpan);
+        vKnotSpan = IGABasis->getVBSplineBasis1D()->findKnotSpan(_v, vKnotSpan);
 
         // 2iii. Compute the IGA basis functions and their derivatives at current (_u,_v) pair of surface parameters
         IGABasis->computeLocalBasisFunctionsAndDerivatives(basisFctsAndDerivs, derivDegreeBasis, _u,
@@ -1074,7 +1422,7 @@ bool IGAPatchSurface::computePointProjectionOnPatch(double& _u, double& _v, doub
             distanceVector[i] = _P[i] - point[i];
 
         // 2vi. Compute the 2-norm of the distance vector
-        distanceVector2norm = EMPIRE::MathLibrary::vector2norm(distanceVector, noSpatialDimensions);
+        distanceVector2norm = EMPIRE::MathLibrary::vector2norm<noSpatialDimensions>(distanceVector);
 
         if (distanceVector2norm < _distTol)
             break;
@@ -1107,14 +1455,14 @@ bool IGAPatchSurface::computePointProjectionOnPatch(double& _u, double& _v, doub
         }
 
         // 2ix. Compute the cosine of the angle with respect to u-parametric line
-        GuXdistanceVector = MathLibrary::computeDenseDotProduct(noSpatialDimensions, Gu, distanceVector);
-        Gu2norm = MathLibrary::vector2norm(Gu, noSpatialDimensions);
+        GuXdistanceVector = MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gu, distanceVector);
+        Gu2norm = MathLibrary::vector2norm<noSpatialDimensions>(Gu);
         squareGu2norm = Gu2norm * Gu2norm;
         cosu = fabs(GuXdistanceVector) / Gu2norm / distanceVector2norm;
 
         // 2x. Compute the cosine of the angle with respect to v-parametric line
-        GvXdistanceVector = MathLibrary::computeDenseDotProduct(noSpatialDimensions, Gv, distanceVector);
-        Gv2norm = MathLibrary::vector2norm(Gv,noSpatialDimensions);
+        GvXdistanceVector = MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gv, distanceVector);
+        Gv2norm = MathLibrary::vector2norm<noSpatialDimensions>(Gv);
         squareGv2norm = Gv2norm*Gv2norm;
         cosv = fabs(GvXdistanceVector) / Gv2norm / distanceVector2norm;
 
@@ -1124,16 +1472,16 @@ bool IGAPatchSurface::computePointProjectionOnPatch(double& _u, double& _v, doub
 
         // 2xii. Compute the entries of the Jacobian matrix
         dR[0] = squareGu2norm
-                + EMPIRE::MathLibrary::computeDenseDotProduct(noSpatialDimensions, DGuDu, distanceVector);
-        dR[1] = EMPIRE::MathLibrary::computeDenseDotProduct(noSpatialDimensions, Gu, Gv)
-                + EMPIRE::MathLibrary::computeDenseDotProduct(noSpatialDimensions, DGuDv, distanceVector);
+                + EMPIRE::MathLibrary::computeDenseDotProduct<noSpatialDimensions>(DGuDu, distanceVector);
+        dR[1] = EMPIRE::MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gu, Gv)
+                + EMPIRE::MathLibrary::computeDenseDotProduct<noSpatialDimensions>(DGuDv, distanceVector);
         dR[2] = dR[1];
         dR[3] = squareGv2norm
-                + EMPIRE::MathLibrary::computeDenseDotProduct(noSpatialDimensions, DGvDv, distanceVector);
+                + EMPIRE::MathLibrary::computeDenseDotProduct<noSpatialDimensions>(DGvDv, distanceVector);
 
         // 2xiii. Compute the entries of the right-hand side vector
-        R[0] = -EMPIRE::MathLibrary::computeDenseDotProduct(noSpatialDimensions, Gu, distanceVector);
-        R[1] = -EMPIRE::MathLibrary::computeDenseDotProduct(noSpatialDimensions, Gv, distanceVector);
+        R[0] = -EMPIRE::MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gu, distanceVector);
+        R[1] = -EMPIRE::MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gv, distanceVector);
 
 
         conditionFirstRowZero = false;
@@ -1253,13 +1601,10 @@ bool IGAPatchSurface::computePointProjectionOnPatch(double& _u, double& _v, doub
     if (!isSystemSolved) {
 		flagNewtonRaphson = false;
 	}
+    if (_numIterations != NULL)
+        *_numIterations = counter;
     
-    // 4. Function appendix (Clear the memory from the dynamically allocated variables and return the flag on convergence)
-    // Clear the memory on the heap
-    delete[] basisFctsAndDerivs;
-    delete[] baseVecAndDerivs;
-
-    // Return the flag
+    // 4. Function appendix (Return the flag on convergence)
     return flagNewtonRaphson;
 }
 
@@ -1316,6 +1661,243 @@ bool IGAPatchSurface::computeForcedPointProjectionOnPatch(double& _u, double& _v
     return isProjected;
 }
 
+bool IGAPatchSurface::computeClosestPointProjectionOnPatch(double& _u, double& _v, double* _P, int _maxIt, double _orthoTol, double _distTol) {
+    /*
+     * Returns the closest point of the patch to _P. The knot spans are visited by the distance of their bounding
+     * boxes, every point found on the patch bounds the distance of the closest point from above, thus the knot
+     * spans whose bounding box is farther are skipped. The iterations start from the initial guess and from the
+     * centre of every visited knot span
+     */
+    const int noSpatialDimensions = 3;
+    const BSplineBasis1D* uBasis = IGABasis->getUBSplineBasis1D();
+    const BSplineBasis1D* vBasis = IGABasis->getVBSplineBasis1D();
+    const double* knotU = uBasis->getKnotVector();
+    const double* knotV = vBasis->getKnotVector();
+    const int numSpansU = uBasis->getNoKnots() - 1;
+    double point[3];
+    for (int k = 0; k < noSpatialDimensions; k++)
+        point[k] = _P[k];
+
+    // 1. Sort the knot spans by the distance of their bounding boxes, without bounding boxes none is skipped
+    vector<pair<double, int> > knotSpans;
+    for (int spanV = vBasis->getPolynomialDegree(); spanV < vBasis->computeNoBasisFunctions(); spanV++) {
+        if (knotV[spanV] == knotV[spanV + 1])
+            continue;
+        for (int spanU = uBasis->getPolynomialDegree(); spanU < uBasis->computeNoBasisFunctions(); spanU++) {
+            if (knotU[spanU] == knotU[spanU + 1])
+                continue;
+            double distance = knotSpanBoundingBoxes.empty() ? 0.0 :
+                    getKnotSpanBoundingBox(spanU, spanV).computeDistanceToPoint(point);
+            knotSpans.push_back(make_pair(distance, spanV * numSpansU + spanU));
+        }
+    }
+    sort(knotSpans.begin(), knotSpans.end());
+
+    // The points on the patch may leave the bounding boxes by round-off
+    double tolerance = 0.0;
+    if (!knotSpanBoundingBoxes.empty()) {
+        for (int k = 0; k < noSpatialDimensions; k++)
+            tolerance += (boundingBox[2 * k + 1] - boundingBox[2 * k]) * (boundingBox[2 * k + 1] - boundingBox[2 * k]);
+        tolerance = 1e-10 * sqrt(tolerance);
+    }
+
+    // 2. Start from the initial guess
+    uBasis->clampKnot(_u);
+    vBasis->clampKnot(_v);
+    int spanU = uBasis->findKnotSpan(_u);
+    int spanV = vBasis->findKnotSpan(_v);
+    double u = _u;
+    double v = _v;
+    double distance;
+    bool isConverged = computeTrustRegionPointProjection(u, v, distance, point,
+            max(knotU[spanU + 1] - knotU[spanU], knotV[spanV + 1] - knotV[spanV]), _maxIt, _orthoTol, _distTol);
+    double minDistance = distance;
+    double bestDistance = distance;
+    _u = u;
+    _v = v;
+
+    // 3. Start from the centres of the knot spans which may contain a closer point, unless the point lies on the patch
+    for (int i = 0; i < knotSpans.size() && !(isConverged && bestDistance < _distTol); i++) {
+        if (knotSpans[i].first - tolerance > minDistance)
+            break;
+        spanU = knotSpans[i].second % numSpansU;
+        spanV = knotSpans[i].second / numSpansU;
+        u = 0.5 * (knotU[spanU] + knotU[spanU + 1]);
+        v = 0.5 * (knotV[spanV] + knotV[spanV + 1]);
+        bool isSpanConverged = computeTrustRegionPointProjection(u, v, distance, point,
+                max(knotU[spanU + 1] - knotU[spanU], knotV[spanV + 1] - knotV[spanV]), _maxIt, _orthoTol, _distTol);
+        minDistance = min(minDistance, distance);
+        // A converged projection is preferred over a closer unconverged one
+        if ((isSpanConverged && !isConverged) || (isSpanConverged == isConverged && distance < bestDistance)) {
+            isConverged = isSpanConverged;
+            bestDistance = distance;
+            _u = u;
+            _v = v;
+        }
+    }
+
+    // 4. Return the Cartesian coordinates of the closest point
+    double uv[2] = { _u, _v };
+    computeCartesianCoordinates(_P, uv);
+    return isConverged;
+}
+
+void IGAPatchSurface::computeSquaredDistanceDerivatives(double* _distanceVector, double* _gradient, double* _hessian,
+        double* _baseVectorNorms, double _u, double _v, const double* _P) {
+    const int noSpatialDimensions = 3;
+    // The derivatives of the basis functions up to second order give the base vectors and their first derivatives
+    const int derivDegreeBasis = 2;
+    const int derivDegreeBaseVcts = derivDegreeBasis - 1;
+    const int noBaseVcts = 2;
+    int pDegree = IGABasis->getUBSplineBasis1D()->getPolynomialDegree();
+    int qDegree = IGABasis->getVBSplineBasis1D()->getPolynomialDegree();
+    int noLocalBasisFcts = (pDegree + 1) * (qDegree + 1);
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * SCRATCH_SIZE_2D> basisFctsAndDerivs(
+            (derivDegreeBasis + 1) * (derivDegreeBasis + 2) * noLocalBasisFcts / 2);
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * 3 * 2> baseVecAndDerivs(
+            (derivDegreeBaseVcts + 1) * (derivDegreeBaseVcts + 2) * noSpatialDimensions * noBaseVcts / 2);
+
+    int uKnotSpan = IGABasis->getUBSplineBasis1D()->findKnotSpan(_u);
+    int vKnotSpan = IGABasis->getVBSplineBasis1D()->findKnotSpan(_v);
+    IGABasis->computeLocalBasisFunctionsAndDerivatives(basisFctsAndDerivs, derivDegreeBasis, _u, uKnotSpan, _v,
+            vKnotSpan);
+    computeCartesianCoordinates(_distanceVector, basisFctsAndDerivs, derivDegreeBasis, uKnotSpan, vKnotSpan);
+    computeBaseVectorsAndDerivatives(baseVecAndDerivs, basisFctsAndDerivs, derivDegreeBaseVcts, uKnotSpan,
+            vKnotSpan);
+
+    double Gu[3], Gv[3], DGuDu[3], DGvDv[3], DGuDv[3];
+    for (int i = 0; i < noSpatialDimensions; i++) {
+        _distanceVector[i] -= _P[i];
+        Gu[i] = baseVecAndDerivs[indexDerivativeBaseVector(derivDegreeBaseVcts, 0, 0, i, 0)];
+        Gv[i] = baseVecAndDerivs[indexDerivativeBaseVector(derivDegreeBaseVcts, 0, 0, i, 1)];
+        DGuDu[i] = baseVecAndDerivs[indexDerivativeBaseVector(derivDegreeBaseVcts, 1, 0, i, 0)];
+        DGvDv[i] = baseVecAndDerivs[indexDerivativeBaseVector(derivDegreeBaseVcts, 0, 1, i, 1)];
+        DGuDv[i] = baseVecAndDerivs[indexDerivativeBaseVector(derivDegreeBaseVcts, 0, 1, i, 0)];
+    }
+    _gradient[0] = MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gu, _distanceVector);
+    _gradient[1] = MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gv, _distanceVector);
+    _hessian[0] = MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gu, Gu)
+            + MathLibrary::computeDenseDotProduct<noSpatialDimensions>(DGuDu, _distanceVector);
+    _hessian[1] = MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gu, Gv)
+            + MathLibrary::computeDenseDotProduct<noSpatialDimensions>(DGuDv, _distanceVector);
+    _hessian[2] = _hessian[1];
+    _hessian[3] = MathLibrary::computeDenseDotProduct<noSpatialDimensions>(Gv, Gv)
+            + MathLibrary::computeDenseDotProduct<noSpatialDimensions>(DGvDv, _distanceVector);
+    _baseVectorNorms[0] = MathLibrary::vector2norm<noSpatialDimensions>(Gu);
+    _baseVectorNorms[1] = MathLibrary::vector2norm<noSpatialDimensions>(Gv);
+}
+
+bool IGAPatchSurface::computeTrustRegionPointProjection(double& _u, double& _v, double& _distance, const double* _P,
+        double _trustRadius, int _maxIt, double _orthoTol, double _distTol) {
+    /*
+     * Minimizes f(u,v) = |S(u,v) - P|^2 / 2 on the parameter domain of the patch. The Newton steps are shifted
+     * towards steepest descent where the Hessian is not positive definite, restricted to the trust region and
+     * projected on the parameter domain. A parameter on the boundary of the domain whose gradient points outwards
+     * is kept fixed, thus the iterations also converge to closest points on the boundary of the patch
+     */
+    const int noSpatialDimensions = 3;
+    const double lower[2] = { IGABasis->getUBSplineBasis1D()->getFirstKnot(),
+            IGABasis->getVBSplineBasis1D()->getFirstKnot() };
+    const double upper[2] = { IGABasis->getUBSplineBasis1D()->getLastKnot(),
+            IGABasis->getVBSplineBasis1D()->getLastKnot() };
+    const double minTrustRadius = 1e-14 * max(upper[0] - lower[0], upper[1] - lower[1]);
+    double uv[2] = { min(max(_u, lower[0]), upper[0]), min(max(_v, lower[1]), upper[1]) };
+
+    double distanceVector[3], gradient[2], hessian[4], baseVectorNorms[2];
+    computeSquaredDistanceDerivatives(distanceVector, gradient, hessian, baseVectorNorms, uv[0], uv[1], _P);
+    double f = 0.5 * MathLibrary::computeDenseDotProduct<noSpatialDimensions>(distanceVector, distanceVector);
+
+    bool isConverged = false;
+    for (int counter = 0; counter < _maxIt; counter++) {
+        // 1. Check whether the point lies on the patch
+        _distance = sqrt(2.0 * f);
+        if (_distance < _distTol) {
+            isConverged = true;
+            break;
+        }
+
+        // 2. Check the orthogonality in the directions not blocked by the boundary of the parameter domain
+        bool isFree[2];
+        bool isOrthogonal = true;
+        for (int k = 0; k < 2; k++) {
+            isFree[k] = !((uv[k] <= lower[k] && gradient[k] > 0.0) || (uv[k] >= upper[k] && gradient[k] < 0.0));
+            if (isFree[k] && fabs(gradient[k]) > _orthoTol * baseVectorNorms[k] * _distance)
+                isOrthogonal = false;
+        }
+        if (isOrthogonal) {
+            isConverged = true;
+            break;
+        }
+        if (_trustRadius < minTrustRadius)
+            break;
+
+        // 3. Compute the Newton step of the free parameters with the Hessian shifted to be positive definite
+        double scale = baseVectorNorms[0] * baseVectorNorms[0] + baseVectorNorms[1] * baseVectorNorms[1];
+        double reducedHessian[4] = { isFree[0] ? hessian[0] : scale, isFree[0] && isFree[1] ? hessian[1] : 0.0,
+                isFree[0] && isFree[1] ? hessian[2] : 0.0, isFree[1] ? hessian[3] : scale };
+        double reducedGradient[2] = { isFree[0] ? gradient[0] : 0.0, isFree[1] ? gradient[1] : 0.0 };
+        double minEigenvalue = 0.5 * (reducedHessian[0] + reducedHessian[3])
+                - sqrt(0.25 * (reducedHessian[0] - reducedHessian[3]) * (reducedHessian[0] - reducedHessian[3])
+                        + reducedHessian[1] * reducedHessian[1]);
+        if (minEigenvalue < 1e-8 * scale) {
+            reducedHessian[0] += 1e-8 * scale - minEigenvalue;
+            reducedHessian[3] += 1e-8 * scale - minEigenvalue;
+        }
+        double determinant = reducedHessian[0] * reducedHessian[3] - reducedHessian[1] * reducedHessian[2];
+        double step[2];
+        step[0] = -(reducedHessian[3] * reducedGradient[0] - reducedHessian[1] * reducedGradient[1]) / determinant;
+        step[1] = -(reducedHessian[0] * reducedGradient[1] - reducedHessian[2] * reducedGradient[0]) / determinant;
+
+        // 4. Restrict the step to the trust region and to the parameter domain
+        double stepLength = sqrt(step[0] * step[0] + step[1] * step[1]);
+        if (stepLength > _trustRadius) {
+            step[0] *= _trustRadius / stepLength;
+            step[1] *= _trustRadius / stepLength;
+        }
+        double trial[2];
+        for (int k = 0; k < 2; k++) {
+            trial[k] = min(max(uv[k] + step[k], lower[k]), upper[k]);
+            step[k] = trial[k] - uv[k];
+        }
+        stepLength = sqrt(step[0] * step[0] + step[1] * step[1]);
+        if (stepLength == 0.0)
+            break;
+
+        // 5. Compare the actual with the predicted decrease to accept the step and to adapt the trust region
+        double predicted = -(gradient[0] * step[0] + gradient[1] * step[1])
+                - 0.5 * (hessian[0] * step[0] * step[0] + 2.0 * hessian[1] * step[0] * step[1]
+                        + hessian[3] * step[1] * step[1]);
+        double trialDistanceVector[3], trialGradient[2], trialHessian[4], trialBaseVectorNorms[2];
+        computeSquaredDistanceDerivatives(trialDistanceVector, trialGradient, trialHessian, trialBaseVectorNorms,
+                trial[0], trial[1], _P);
+        double trialF = 0.5 * MathLibrary::computeDenseDotProduct<noSpatialDimensions>(trialDistanceVector,
+                trialDistanceVector);
+        double actual = f - trialF;
+        double ratio = predicted > 0.0 ? actual / predicted : (actual > 0.0 ? 1.0 : -1.0);
+        if (ratio < 0.25)
+            _trustRadius = 0.25 * stepLength;
+        else if (ratio > 0.75)
+            _trustRadius = max(_trustRadius, 2.0 * stepLength);
+        if (actual > 0.0) {
+            uv[0] = trial[0];
+            uv[1] = trial[1];
+            f = trialF;
+            for (int k = 0; k < noSpatialDimensions; k++)
+                distanceVector[k] = trialDistanceVector[k];
+            for (int k = 0; k < 2; k++) {
+                gradient[k] = trialGradient[k];
+                baseVectorNorms[k] = trialBaseVectorNorms[k];
+            }
+            for (int k = 0; k < 4; k++)
+                hessian[k] = trialHessian[k];
+        }
+    }
+    _distance = sqrt(2.0 * f);
+    _u = uv[0];
+    _v = uv[1];
+    return isConverged;
+}
+
 bool IGAPatchSurface::computePointProjectionOnTrimmingCurve(double& _projectedUTilde,
                                                             double* _P, int _patchBLIndex, int _patchBLTrCurveIndex){
 
@@ -1398,7 +1980,7 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryBisection(
        assert(_P2 != NULL);
 
        // Initialize variables
-       int numCoord = 3;
+       const int numCoord = 3;
        bool isIn;
        bool isConverged = false;
        double UV1[2] = { _u, _v };
@@ -1431,7 +2013,7 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryBisection(
            }
 
            // Check convergence based on whether the segment P1P is small enough
-           if (MathLibrary::vector2norm(P1P,numCoord) <= _tol) {
+           if (MathLibrary::vector2norm<numCoord>(P1P) <= _tol) {
                isConverged = true;
                break;
            }
@@ -1465,9 +2047,9 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryBisection(
            }
            _u = UV1[0];
            _v = UV1[1];
-           _distance = MathLibrary::vector2norm(QP,numCoord);
-           _lambda =  MathLibrary::computeDenseDotProduct(numCoord, P1P2, P1P)
-                   / MathLibrary::computeDenseDotProduct(numCoord, P1P2, P1P2);
+           _distance = MathLibrary::vector2norm<numCoord>(QP);
+           _lambda =  MathLibrary::computeDenseDotProduct<numCoord>(P1P2, P1P)
+                   / MathLibrary::computeDenseDotProduct<numCoord>(P1P2, P1P2);
        }
 
        // Return the convergence flag
@@ -1539,7 +2121,7 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphson(
     bool isConverged = false;
 
     // Initialize number of spatial dimensions
-    int noCoord = 3;
+    const int noCoord = 3;
 
     // Initialize the distance vector
     double P1Q[3];
@@ -1586,15 +2168,15 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphson(
     int noBaseVcts = 2;
 
     // Initialize the array of the NURBS basis functions and their derivatives
-    double* basisFctsAndDerivs = new double[(derivDegreeBasis + 1)
-            * (derivDegreeBasis + 2) * noLocalBasisFcts / 2];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * SCRATCH_SIZE_2D> basisFctsAndDerivs(
+            (derivDegreeBasis + 1) * (derivDegreeBasis + 2) * noLocalBasisFcts / 2);
 
     // Number of derivatives for the base vectors
     int derivDegreeBaseVcts = derivDegreeBasis - 1;
 
     // Initialize the array of the base vectors and their derivatives
-    double* baseVecAndDerivs = new double[(derivDegreeBaseVcts + 1)
-            * (derivDegreeBaseVcts + 2) * noCoord * noBaseVcts / 2];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * 3 * 2> baseVecAndDerivs(
+            (derivDegreeBaseVcts + 1) * (derivDegreeBaseVcts + 2) * noCoord * noBaseVcts / 2);
 
     int direction;
     double u;
@@ -1631,8 +2213,8 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphson(
         // 2i. Update the iteration counter
         counter++;
         // 2ii. Find the span of the given surface parameters
-        uKnotSpan = IGABasis->getUBSplineBasis1D()->findKnotSpan(u);
-        vKnotSpan = IGABasis->getVBSplineBasis1D()->findKnotSpan(v);
+        uKnotSpan = IGABasis->getUBSplineBasis1D()->findKnotSpan(u, uKnotSpan);
+        vKnotSpan = IGABasis->getVBSplineBasis1D()->findKnotSpan(v, vKnotSpan);
         // 2iii. Compute the NURBS basis functions and their derivatives at current (_u,_v) pair of surface parameters
         IGABasis->computeLocalBasisFunctionsAndDerivatives(basisFctsAndDerivs,
                 derivDegreeBasis, u, uKnotSpan, v, vKnotSpan);
@@ -1661,7 +2243,7 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphson(
         MathLibrary::crossProduct(n, P1P2, normalSurface);
         R_previous2 = R_previous1;
         R_previous1 = R;
-        R = MathLibrary::computeDenseDotProduct(noCoord, P1Q, n);
+        R = MathLibrary::computeDenseDotProduct<noCoord>(P1Q, n);
         // 2vii. Compute the stopping criteria
         // If the residual is low enough stop and set the flag
         if(fabs(R) < _tol) {
@@ -1681,16 +2263,16 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphson(
         if (direction == 0) {
             MathLibrary::crossProduct(product1, DGuDu, Gv);
             MathLibrary::crossProduct(product2, Gu, DGuDv);
-            dR = MathLibrary::computeDenseDotProduct(noCoord, Gu, n);
+            dR = MathLibrary::computeDenseDotProduct<noCoord>(Gu, n);
         } else {
             MathLibrary::crossProduct(product1, DGuDv, Gv);
             MathLibrary::crossProduct(product2, Gu, DGvDv);
-            dR = MathLibrary::computeDenseDotProduct(noCoord, Gv, n);
+            dR = MathLibrary::computeDenseDotProduct<noCoord>(Gv, n);
         }
         for (int i = 0; i < noCoord; i++)
             product1[i] += product2[i];
         MathLibrary::crossProduct(product3, P1P2, product1);
-        dR += MathLibrary::computeDenseDotProduct(noCoord, P1Q, product3);
+        dR += MathLibrary::computeDenseDotProduct<noCoord>(P1Q, product3);
 
         // Apply the variation dw on parameter and check if going outside of knot span then break
         double dw=-R/dR;
@@ -1710,13 +2292,13 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphson(
         _t = v;
 
     // Compute point on the line and thus get the ratio of P1P/P1P2
-    double normNormalSurface = MathLibrary::vector2norm(normalSurface,noCoord);
+    double normNormalSurface = MathLibrary::vector2norm<noCoord>(normalSurface);
     double unitNormalSurface[3];
     double P1P[3];
     for (int i = 0; i < noCoord; i++)
         unitNormalSurface[i] = normalSurface[i]/normNormalSurface;
     // Project P1Q onto the normal of the patch
-    double h10 = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, P1Q, unitNormalSurface);
+    double h10 = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(P1Q, unitNormalSurface);
     for (int i = 0; i < noCoord; i++) {
         P1P[i] = P1Q[i];
         P1P[i] -= h10 * unitNormalSurface[i];
@@ -1724,13 +2306,13 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphson(
 
     // Compute the collinearity of P1P and P1P2
     double unitP1P[3], unitP1P2[3];
-    double normP1P = MathLibrary::vector2norm(P1P,noCoord);
-    double normP1P2 = MathLibrary::vector2norm(P1P2,noCoord);
+    double normP1P = MathLibrary::vector2norm<noCoord>(P1P);
+    double normP1P2 = MathLibrary::vector2norm<noCoord>(P1P2);
     for (int i = 0; i < noCoord; i++) {
         unitP1P[i] = P1P[i] / normP1P;
         unitP1P2[i] = P1P2[i] / normP1P2;
     }
-    double collinearity = fabs(EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, unitP1P, unitP1P2));
+    double collinearity = fabs(EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(unitP1P, unitP1P2));
 
     // Update the flag depending on the collinearity.
     // This check is performed here since the point P is reconstructed and not returned to the upper level
@@ -1744,15 +2326,10 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphson(
         for (int i = 0; i < noCoord; i++) {
             QP[i] = _P1[i] + _lambda * (_P2[i] - _P1[i]) - Q[i];
         }
-        _distance = MathLibrary::vector2norm(QP,noCoord);
+        _distance = MathLibrary::vector2norm<noCoord>(QP);
     }
 
-    // 4. Function appendix (Clear the memory from the dynamically allocated variables and return the flag on convergence)
-    // Clear the memory on the heap
-    delete[] basisFctsAndDerivs;
-    delete[] baseVecAndDerivs;
-
-    // Return the flag
+    // 4. Function appendix (Return the flag on convergence)
     return isConverged;
 }
 
@@ -1773,7 +2350,7 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphsonClosestDis
     double distance;
 
     // Initialize number of spatial dimensions
-    int dim = 3;
+    const int dim = 3;
 
     // Line to be projected vector
     double P1P2[3];
@@ -1809,14 +2386,15 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphsonClosestDis
     int noBaseVcts = 2;
 
     // Initialize the array of the NURBS basis functions and their derivatives
-    double* basisFctsAndDerivs = new double[(derivDegreeBasis + 1) * (derivDegreeBasis + 2) * noLocalBasisFcts / 2];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * SCRATCH_SIZE_2D> basisFctsAndDerivs(
+            (derivDegreeBasis + 1) * (derivDegreeBasis + 2) * noLocalBasisFcts / 2);
 
     // Number of derivatives for the base vectors
     int derivDegreeBaseVcts = derivDegreeBasis - 1;
 
     // Initialize the array of the base vectors and their derivatives
-    double* baseVecAndDerivs = new double[(derivDegreeBaseVcts + 1)
-            * (derivDegreeBaseVcts + 2) * dim * noBaseVcts / 2];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * 3 * 2> baseVecAndDerivs(
+            (derivDegreeBaseVcts + 1) * (derivDegreeBaseVcts + 2) * dim * noBaseVcts / 2);
 
     // Get the fixed and the running parameters on the edge
     switch (_edge) {
@@ -1857,7 +2435,7 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphsonClosestDis
     double PQ[3];
     double R[2];
     double J[4];
-    J[3] = EMPIRE::MathLibrary::computeDenseDotProduct(dim, P1P2, P1P2);
+    J[3] = EMPIRE::MathLibrary::computeDenseDotProduct<dim>(P1P2, P1P2);
     bool isLinearEquationSolved = false;
 
     // 2. Loop over the Newton-Raphson iterations
@@ -1867,11 +2445,11 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphsonClosestDis
 
         // 2ii. Compute the NURBS basis functions and their derivatives at current (u,v) pair of surface parameters
         if (isOnU) {
-            uKnotSpan = IGABasis->getUBSplineBasis1D()->findKnotSpan(u);
+            uKnotSpan = IGABasis->getUBSplineBasis1D()->findKnotSpan(u, uKnotSpan);
             vKnotSpan = knotSpanIndexFixed;
         } else {
             uKnotSpan = knotSpanIndexFixed;
-            vKnotSpan = IGABasis->getVBSplineBasis1D()->findKnotSpan(v);
+            vKnotSpan = IGABasis->getVBSplineBasis1D()->findKnotSpan(v, vKnotSpan);
         }
         IGABasis->computeLocalBasisFunctionsAndDerivatives(basisFctsAndDerivs,
                 derivDegreeBasis, u, uKnotSpan, v, vKnotSpan);
@@ -1915,20 +2493,20 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphsonClosestDis
         }
 
         // Compute the residual vector
-        R[0] = -EMPIRE::MathLibrary::computeDenseDotProduct(dim, G, PQ);
-        R[1] = -EMPIRE::MathLibrary::computeDenseDotProduct(dim, P1P2, PQ);
-        distance = EMPIRE::MathLibrary::vector2norm(PQ, dim);
+        R[0] = -EMPIRE::MathLibrary::computeDenseDotProduct<dim>(G, PQ);
+        R[1] = -EMPIRE::MathLibrary::computeDenseDotProduct<dim>(P1P2, PQ);
+        distance = EMPIRE::MathLibrary::vector2norm<dim>(PQ);
 
         // Check convergence
-        if ((distance <=  _tol || EMPIRE::MathLibrary::vector2norm(R, 2) <=  _tol) && counter > 1){
+        if ((distance <=  _tol || EMPIRE::MathLibrary::vector2norm<2>(R) <=  _tol) && counter > 1){
             isNRConverged = true;
             break;
         }
 
         // Compute the Jacobian
-        J[0] = EMPIRE::MathLibrary::computeDenseDotProduct(dim, PQ, DG) + EMPIRE::MathLibrary::computeDenseDotProduct(dim, G, G);
-        J[1] = EMPIRE::MathLibrary::computeDenseDotProduct(dim, P1P2, G);
-        J[2] = EMPIRE::MathLibrary::computeDenseDotProduct(dim, G, P1P2);
+        J[0] = EMPIRE::MathLibrary::computeDenseDotProduct<dim>(PQ, DG) + EMPIRE::MathLibrary::computeDenseDotProduct<dim>(G, G);
+        J[1] = EMPIRE::MathLibrary::computeDenseDotProduct<dim>(P1P2, G);
+        J[2] = EMPIRE::MathLibrary::computeDenseDotProduct<dim>(G, P1P2);
 
         // Solve the 2x2 system
         isLinearEquationSolved = EMPIRE::MathLibrary::solve2x2LinearSystem(J, R);
@@ -1963,10 +2541,6 @@ bool IGAPatchSurface::solvePointProjectionOnPatchBoundaryNewtonRaphsonClosestDis
     _lambda = lambda;
     _distance = distance;
 
-    // Delete pointers
-    delete[] basisFctsAndDerivs;
-    delete[] baseVecAndDerivs;
-
     // Return convergence flag
     return isNRConverged;
 }
@@ -2121,22 +2695,89 @@ void IGAPatchSurface::findInitialGuess4PointProjection(double& _u, double& _v, d
     double dv = (vEnd - v0) / _vDiv;
     double uv[2];
 
-    for (int i = 1; i < _uDiv - 1; i++)
-        for (int j = 1; j < _vDiv - 1; j++) {
-            uv[0] = u0 + du * i;
-            uv[1] = v0 + dv * j;
-            computeCartesianCoordinates(coords, uv);
-
-            for (int k = 0; k < noSpatialDimensions; k++)
-                coords[k] -= _P[k];
-            Dis = MathLibrary::vector2norm(coords, noSpatialDimensions);
-            if (Dis < minDis) {
-                minDis = Dis;
-                _u = uv[0];
-                _v = uv[1];
+    // Without the bounding boxes of the knot spans all samples are evaluated
+    if (knotSpanBoundingBoxes.empty()) {
+        for (int i = 1; i < _uDiv - 1; i++)
+            for (int j = 1; j < _vDiv - 1; j++) {
+                uv[0] = u0 + du * i;
+                uv[1] = v0 + dv * j;
+                computeCartesianCoordinates(coords, uv);
+
+                for (int k = 0; k < noSpatialDimensions; k++)
+                    coords[k] -= _P[k];
+                Dis = MathLibrary::vector2norm<noSpatialDimensions>(coords);
+                if (Dis < minDis) {
+                    minDis = Dis;
+                    _u = uv[0];
+                    _v = uv[1];
+                }
             }
+        return;
+    }
 
+    // The samples of a knot span are consecutive, every block of them is given by its knot span and its first sample
+    vector<int> uBlockSpans, uBlockFirst, vBlockSpans, vBlockFirst;
+    for (int i = 1; i < _uDiv - 1; i++) {
+        int span = IGABasis->getUBSplineBasis1D()->findKnotSpan(u0 + du * i,
+                uBlockSpans.empty() ? -1 : uBlockSpans.back());
+        if (uBlockSpans.empty() || uBlockSpans.back() != span) {
+            uBlockSpans.push_back(span);
+            uBlockFirst.push_back(i);
         }
+    }
+    uBlockFirst.push_back(_uDiv - 1);
+    for (int j = 1; j < _vDiv - 1; j++) {
+        int span = IGABasis->getVBSplineBasis1D()->findKnotSpan(v0 + dv * j,
+                vBlockSpans.empty() ? -1 : vBlockSpans.back());
+        if (vBlockSpans.empty() || vBlockSpans.back() != span) {
+            vBlockSpans.push_back(span);
+            vBlockFirst.push_back(j);
+        }
+    }
+    vBlockFirst.push_back(_vDiv - 1);
+
+    // The blocks sorted by the distance of the bounding box of their knot span to the point
+    const int numBlocksU = uBlockSpans.size();
+    vector<pair<double, int> > blocks;
+    blocks.reserve(numBlocksU * vBlockSpans.size());
+    for (int bv = 0; bv < vBlockSpans.size(); bv++)
+        for (int bu = 0; bu < numBlocksU; bu++)
+            blocks.push_back(make_pair(getKnotSpanBoundingBox(uBlockSpans[bu], vBlockSpans[bv]).computeDistanceToPoint(_P),
+                    bv * numBlocksU + bu));
+    sort(blocks.begin(), blocks.end());
+
+    // The evaluated points may leave the bounding boxes by round-off
+    double diagonal = 0.0;
+    for (int k = 0; k < noSpatialDimensions; k++)
+        diagonal += (boundingBox[2 * k + 1] - boundingBox[2 * k]) * (boundingBox[2 * k + 1] - boundingBox[2 * k]);
+    const double tolerance = 1e-10 * sqrt(diagonal);
+
+    // Of samples at the same distance the first one in the order of the grid is taken
+    int minI = _uDiv;
+    int minJ = _vDiv;
+    for (int b = 0; b < blocks.size(); b++) {
+        if (blocks[b].first - tolerance > minDis)
+            break;
+        int bu = blocks[b].second % numBlocksU;
+        int bv = blocks[b].second / numBlocksU;
+        for (int i = uBlockFirst[bu]; i < uBlockFirst[bu + 1]; i++)
+            for (int j = vBlockFirst[bv]; j < vBlockFirst[bv + 1]; j++) {
+                uv[0] = u0 + du * i;
+                uv[1] = v0 + dv * j;
+                computeCartesianCoordinates(coords, uv);
+
+                for (int k = 0; k < noSpatialDimensions; k++)
+                    coords[k] -= _P[k];
+                Dis = MathLibrary::vector2norm<noSpatialDimensions>(coords);
+                if (Dis < minDis || (Dis == minDis && (i < minI || (i == minI && j < minJ)))) {
+                    minDis = Dis;
+                    minI = i;
+                    minJ = j;
+                    _u = uv[0];
+                    _v = uv[1];
+                }
+            }
+    }
 }
 
 bool IGAPatchSurface::findInitialGuess4PointProjectionOnTrimmingCurve(double& _uTilde, double& _u, double& _v,
@@ -2197,7 +2838,7 @@ bool IGAPatchSurface::findInitialGuess4PointProjectionOnTrimmingCurve(double& _u
             xyzCoord[xyzCtr] = xyzCoord[xyzCtr] - _P[xyzCtr];
 
         // Compute the length of the distance vector
-        tmpDistance = MathLibrary::vector2norm(xyzCoord,noCoord);
+        tmpDistance = MathLibrary::vector2norm<noCoord>(xyzCoord);
 
         // Update the distance and the patch parameters
         if (tmpDistance<distance) {
@@ -2273,7 +2914,7 @@ bool IGAPatchSurface::findInitialGuess4PointProjectionOnTrimmingCurve(double& _u
             xyzCoord[xyzCtr] = xyzCoord[xyzCtr] - _P[xyzCtr];
 
         // Compute the length of the distance vector
-        tmpDistance = MathLibrary::vector2norm(xyzCoord,noCoord);
+        tmpDistance = MathLibrary::vector2norm<noCoord>(xyzCoord);
 
         // Update the distance and the patch parameters
         if (tmpDistance<distance) {
@@ -2298,12 +2939,14 @@ void IGAPatchSurface::computeCartesianCoordinatesAndNormalVector(double* _coords
     int spanU = IGABasis->getUBSplineBasis1D()->findKnotSpan(_u);
     int spanV = IGABasis->getVBSplineBasis1D()->findKnotSpan(_v);
 
-    // Compute the Cartesian coordinates of (_u,_v)
-    computeCartesianCoordinates(_coords, _u, spanU, _v, spanV);
-
-    // Compute the base vectors
+    // Compute the Cartesian coordinates of (_u,_v) and the base vectors
     double baseVec[6];
-    computeBaseVectors(baseVec, _u, spanU, _v, spanV);
+    if (fixedDegreeKernel != NULL) {
+        (this->*fixedDegreeKernel)(_coords, baseVec, _u, spanU, _v, spanV);
+    } else {
+        computeCartesianCoordinates(_coords, _u, spanU, _v, spanV);
+        computeBaseVectors(baseVec, _u, spanU, _v, spanV);
+    }
 
     // Compute the cross product of the surface base vectors to get the surface normal
     _normal[0] = baseVec[1] * baseVec[5] - baseVec[2] * baseVec[4];
@@ -2312,17 +2955,141 @@ void IGAPatchSurface::computeCartesianCoordinatesAndNormalVector(double* _coords
 }
 void IGAPatchSurface::computeCartesianCoordinatesAndNormalVector(double* _coords, double* _normal,
         double _u, double _v, int _spanU, int _spanV) const {
-    // Compute the Cartesian coordinates of (_u,_v)
-    computeCartesianCoordinates(_coords, _u, _spanU, _v, _spanV);
-
-    // Compute the base vectors
+    // Compute the Cartesian coordinates of (_u,_v) and the base vectors
     double baseVec[6];
-    computeBaseVectors(baseVec, _u, _spanU, _v, _spanV);
+    if (fixedDegreeKernel != NULL) {
+        (this->*fixedDegreeKernel)(_coords, baseVec, _u, _spanU, _v, _spanV);
+    } else {
+        computeCartesianCoordinates(_coords, _u, _spanU, _v, _spanV);
+        computeBaseVectors(baseVec, _u, _spanU, _v, _spanV);
+    }
 
     // Compute the cross product of the surface base vectors to get the surface normal
     MathLibrary::computeVectorCrossProduct(&baseVec[0], &baseVec[3],_normal);
 }
 
+void IGAPatchSurface::computeCartesianCoordinatesAndNormalVectors(int _noPoints,
+        const double* _uv, double* _coords, double* _baseVectors, double* _normals) const {
+    /*
+     *  1. Find the knot spans of all points and sort the points by knot span
+     *  2. For each knot span, gather the weighted Control Points [w*X w*Y w*Z w] into a contiguous array
+     *  3. For each point in the knot span, compute the 1D basis functions and contract them with the gathered Control Points,
+     *     first in u-direction row by row and then in v-direction
+     *  4. Divide through by the weight function to obtain the coordinates and the base vectors
+     */
+
+    // Read input
+    assert(_uv != NULL);
+
+    const BSplineBasis1D* uBasis = IGABasis->getUBSplineBasis1D();
+    const BSplineBasis1D* vBasis = IGABasis->getVBSplineBasis1D();
+    int pDegree = uBasis->getPolynomialDegree();
+    int qDegree = vBasis->getPolynomialDegree();
+    int noLocalBasisFunctions = (pDegree + 1) * (qDegree + 1);
+    bool computeDerivatives = _baseVectors != NULL || _normals != NULL;
+    const int noHomogeneousCoord = 4;
+
+    // 1. Find the knot spans of all points and sort the points by knot span
+    // Consecutive points mostly lie in the same knot spans
+    std::vector<std::pair<int, int> > spanKeys(_noPoints);
+    int lastSpanU = -1;
+    int lastSpanV = -1;
+    for (int iPoint = 0; iPoint < _noPoints; iPoint++) {
+        lastSpanU = uBasis->findKnotSpan(_uv[2 * iPoint], lastSpanU);
+        lastSpanV = vBasis->findKnotSpan(_uv[2 * iPoint + 1], lastSpanV);
+        spanKeys[iPoint] = std::make_pair(lastSpanV * uBasis->getNoKnots() + lastSpanU, iPoint);
+    }
+    std::sort(spanKeys.begin(), spanKeys.end());
+
+    ScratchArray<double, noHomogeneousCoord * SCRATCH_SIZE_2D> weightedCPs(
+            noHomogeneousCoord * noLocalBasisFunctions);
+    ScratchArray<double, 2 * SCRATCH_SIZE_1D> uBasisFcts(2 * (pDegree + 1));
+    ScratchArray<double, 2 * SCRATCH_SIZE_1D> vBasisFcts(2 * (qDegree + 1));
+
+    int iKey = 0;
+    while (iKey < _noPoints) {
+        int spanKey = spanKeys[iKey].first;
+        int spanU = spanKey % uBasis->getNoKnots();
+        int spanV = spanKey / uBasis->getNoKnots();
+
+        // 2. Gather the weighted Control Points of the knot span
+        for (int j = 0; j <= qDegree; j++) {
+            for (int i = 0; i <= pDegree; i++) {
+                int CPindex = (spanV - qDegree + j) * uNoControlPoints + spanU - pDegree + i;
+                double w = controlPointCoordinates[4 * CPindex + 3];
+                double* weightedCP = &weightedCPs[(j * (pDegree + 1) + i) * noHomogeneousCoord];
+                weightedCP[0] = w * controlPointCoordinates[4 * CPindex + 0];
+                weightedCP[1] = w * controlPointCoordinates[4 * CPindex + 1];
+                weightedCP[2] = w * controlPointCoordinates[4 * CPindex + 2];
+                weightedCP[3] = w;
+            }
+        }
+
+        // 3. Loop over all the points in the knot span
+        for (; iKey < _noPoints && spanKeys[iKey].first == spanKey; iKey++) {
+            int iPoint = spanKeys[iKey].second;
+            double u = _uv[2 * iPoint];
+            double v = _uv[2 * iPoint + 1];
+            if (computeDerivatives) {
+                uBasis->computeLocalBasisFunctionsAndDerivatives(uBasisFcts, 1, u, spanU);
+                vBasis->computeLocalBasisFunctionsAndDerivatives(vBasisFcts, 1, v, spanV);
+            } else {
+                uBasis->computeLocalBasisFunctions(uBasisFcts, u, spanU);
+                vBasis->computeLocalBasisFunctions(vBasisFcts, v, spanV);
+            }
+
+            double A[noHomogeneousCoord] = { 0.0, 0.0, 0.0, 0.0 };
+            double dAdu[noHomogeneousCoord] = { 0.0, 0.0, 0.0, 0.0 };
+            double dAdv[noHomogeneousCoord] = { 0.0, 0.0, 0.0, 0.0 };
+            for (int j = 0; j <= qDegree; j++) {
+                const double* weightedCPRow = &weightedCPs[j * (pDegree + 1) * noHomogeneousCoord];
+
+                // Contract in u-direction
+                double rowA[noHomogeneousCoord] = { 0.0, 0.0, 0.0, 0.0 };
+                double rowdAdu[noHomogeneousCoord] = { 0.0, 0.0, 0.0, 0.0 };
+                for (int i = 0; i <= pDegree; i++)
+                    for (int k = 0; k < noHomogeneousCoord; k++)
+                        rowA[k] += uBasisFcts[i] * weightedCPRow[i * noHomogeneousCoord + k];
+                if (computeDerivatives)
+                    for (int i = 0; i <= pDegree; i++)
+                        for (int k = 0; k < noHomogeneousCoord; k++)
+                            rowdAdu[k] += uBasisFcts[pDegree + 1 + i]
+                                    * weightedCPRow[i * noHomogeneousCoord + k];
+
+                // Contract in v-direction
+                for (int k = 0; k < noHomogeneousCoord; k++)
+                    A[k] += vBasisFcts[j] * rowA[k];
+                if (computeDerivatives)
+                    for (int k = 0; k < noHomogeneousCoord; k++) {
+                        dAdu[k] += vBasisFcts[j] * rowdAdu[k];
+                        dAdv[k] += vBasisFcts[qDegree + 1 + j] * rowA[k];
+                    }
+            }
+
+            // 4. Divide through by the weight function
+            double S[3];
+            for (int k = 0; k < 3; k++)
+                S[k] = A[k] / A[3];
+            if (_coords != NULL)
+                for (int k = 0; k < 3; k++)
+                    _coords[3 * iPoint + k] = S[k];
+            if (computeDerivatives) {
+                double baseVec[6];
+                for (int k = 0; k < 3; k++) {
+                    baseVec[k] = (dAdu[k] - dAdu[3] * S[k]) / A[3];
+                    baseVec[3 + k] = (dAdv[k] - dAdv[3] * S[k]) / A[3];
+                }
+                if (_baseVectors != NULL)
+                    for (int k = 0; k < 6; k++)
+                        _baseVectors[6 * iPoint + k] = baseVec[k];
+                if (_normals != NULL)
+                    MathLibrary::computeVectorCrossProduct(&baseVec[0], &baseVec[3],
+                            &_normals[3 * iPoint]);
+            }
+        }
+    }
+}
+
 void IGAPatchSurface::computeKnotIntersectionsWithTrimmingCurve(std::vector<double>& _uTilde,
                                                                 int _patchBLIndex, int _patchBLTrCurveIndex){
 
@@ -33,7 +33,9 @@
 #include "NurbsBasis2D.h"
 #include "IGAControlPoint.h"
 #include "IGAPatchSurfaceTrimming.h"
+#include "MemoryUsage.h"
 #include <limits>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -47,6 +49,24 @@ class Message;
 
 class IGAPatchSurface {
 
+public:
+    /********//**
+     * \brief The integration cell of a knot span, i.e. the knot span clipped by the trimming and
+     *        triangulated, which is shared by all integrations over the patch
+     ***********/
+    struct IntegrationCell {
+        /// The index of the knot span in u-direction
+        int spanU;
+        /// The index of the knot span in v-direction
+        int spanV;
+        /// The cleaned parts of the knot span inside the trimmed domain
+        std::vector<std::vector<std::pair<double,double> > > polygons;
+        /// The triangles of all parts
+        std::vector<std::vector<std::pair<double,double> > > triangles;
+        /// The TriangulatorAdaptor::TriangulationPath each part was triangulated by
+        std::vector<char> triangulationPaths;
+    };
+
 protected:
     /// The basis functions of the 2D NURBS patch
     BSplineBasis2D* IGABasis;
@@ -60,12 +80,37 @@ protected:
     /// The set of the Control Points of the patch
     IGAControlPoint** ControlPointNet;
 
+    /// The coordinates and the weights of the Control Points packed contiguously as [X Y Z W] per Control Point, read by the evaluation kernels and kept in sync by the Control Points
+    double* controlPointCoordinates;
+
     /// The class holding the trimming information
     IGAPatchSurfaceTrimming Trimming;
 
     /// The bounding box of the patch
     AABB boundingBox;
 
+    /// The trimming state of every knot span, stored as spanV * (number of u knots - 1) + spanU, empty if the patch is not trimmed
+    std::vector<char> knotSpanTrimming;
+
+    /// The bounding box of every knot span by the convex hull of its Bezier control points, by the same index, empty before computeBoundingBox
+    std::vector<AABB> knotSpanBoundingBoxes;
+
+    /// The trimmed polygons of the knot spans cut by the trimming, by the same index
+    std::map<int, std::vector<std::vector<std::pair<double,double> > > > knotSpanTrimmedPolygons;
+
+    /// The integration cells of the knot spans which are not trimmed away, empty before computeIntegrationCells
+    std::vector<IntegrationCell> integrationCells;
+
+    /// Whether the integration cells are computed
+    bool areIntegrationCellsComputed;
+
+    /// Evaluation kernel of the Cartesian coordinates and the base vectors specialized at compile time on the polynomial degrees
+    typedef void (IGAPatchSurface::*FixedDegreeKernel)(double*, double*, double, int, double,
+            int) const;
+
+    /// The kernel specialized on the polynomial degrees of this patch, NULL if the degrees are not covered
+    FixedDegreeKernel fixedDegreeKernel;
+
     /// The constructor and the destructor and the copy constructor
 public:
     /***********************************************************************************************
@@ -90,7 +135,18 @@ public:
      ***********/
     ~IGAPatchSurface();
 
+    /***********************************************************************************************
+     * \brief Compute the bounding box of the patch from its control points and the bounding boxes of
+     *        its knot spans from their Bezier control points, which bound the surface over the span tightly
+     ***********/
     void computeBoundingBox();
+
+    /***********************************************************************************************
+     * \brief Get the bounding box of a knot span of non-zero length, computed by computeBoundingBox
+     * \param[in] _spanU The index of the knot span in u-direction
+     * \param[in] _spanV The index of the knot span in v-direction
+     ***********/
+    const AABB& getKnotSpanBoundingBox(int _spanU, int _spanV) const;
     /// Trimming related functions
 public:
     /***********************************************************************************************
@@ -113,13 +169,56 @@ public:
     void addTrimCurve(int _direction, int _pDegree, int _uNoKnots, double* _uKnotVector,
                       int _uNoControlPoints, double* _controlPointNet);
 
+    /// Trimming state of a knot span
+    enum KnotSpanTrimming {KNOTSPAN_UNTRIMMED = 0, KNOTSPAN_TRIMMED, KNOTSPAN_CUT};
+
     /***********************************************************************************************
-     * \brief Linearize all the trimming loops and curves of the given mesh and patch
+     * \brief Linearize all the trimming loops and curves of the given mesh and patch, and classify
+     *        all knot spans by the trimming
+     * \param[in] _type Type of linearization, see IGAPatchCurve::linearize
      * \author Fabien Pean
      ***********/
-    inline void linearizeTrimming() {
-        Trimming.linearizeLoops();
-    }
+    void linearizeTrimming(int _type = 2);
+
+    /***********************************************************************************************
+     * \brief Get the trimming state of a knot span, computed by linearizeTrimming
+     * \param[in] _spanU The index of the knot span in u-direction
+     * \param[in] _spanV The index of the knot span in v-direction
+     * \return KNOTSPAN_UNTRIMMED, KNOTSPAN_TRIMMED if the whole knot span is trimmed away or KNOTSPAN_CUT
+     ***********/
+    KnotSpanTrimming getKnotSpanTrimming(int _spanU, int _spanV) const;
+
+    /***********************************************************************************************
+     * \brief Get the heap memory of the patch broken down by the Control Points, the knot vectors
+     *        and the trimming with its knot span classification
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+    /***********************************************************************************************
+     * \brief Clip a polygon lying in a knot span by the trimming. Only the polygons of a cut knot span
+     *        are given to the clipper, instead of the whole trimming loops
+     * \param[in] _spanU The index of the knot span in u-direction
+     * \param[in] _spanV The index of the knot span in v-direction
+     * \param[in] _polygonUV The polygon in the knot span
+     * \param[out] _listPolygonUV The parts of the polygon inside the trimmed domain
+     ***********/
+    void clipByKnotSpanTrimming(int _spanU, int _spanV,
+            const std::vector<std::pair<double,double> >& _polygonUV,
+            std::vector<std::vector<std::pair<double,double> > >& _listPolygonUV) const;
+
+    /***********************************************************************************************
+     * \brief Clip all knot spans of non-zero area by the trimming and triangulate them once, such
+     *        that the mass matrix and the conditions on the patch integrate the same cells. Nothing
+     *        is done if the cells are already computed, linearizeTrimming discards them
+     * \param[in] _numThreads The number of threads the knot spans are processed by
+     ***********/
+    void computeIntegrationCells(int _numThreads);
+
+    /***********************************************************************************************
+     * \brief Get the integration cells computed by computeIntegrationCells
+     * \return The cells of the knot spans which are not trimmed away completely
+     ***********/
+    const std::vector<IntegrationCell>& getIntegrationCells() const;
 
     /// Basis related functions
 public:
@@ -273,10 +372,12 @@ public:
      * \param[in/out] _flagConverge Flag indicating whether the Newton iterations have converged true/false
      * \param[in]	  _maxIt The number of iteration to do in the scheme
      * \param[in]	  _tol The tolerance for which the scheme stops
+     * \param[out]	  _numIterations If not NULL, the number of Newton-Raphson iterations done
      * \return The flag on whether or not the Newton-Raphson iterations have converged for the defined set of parameters
      * \author Andreas Apostolatos
      ***********/
-    bool computePointProjectionOnPatch(double&, double&, double*, bool&, const int _maxIt=MAX_NUM_ITERATIONS, const double _tol=TOL_ORTHOGONALITY, const double _distTol=TOL_DISTANCE);
+    bool computePointProjectionOnPatch(double&, double&, double*, bool&, const int _maxIt=MAX_NUM_ITERATIONS, const double _tol=TOL_ORTHOGONALITY, const double _distTol=TOL_DISTANCE,
+            int* _numIterations=NULL);
 
     /***********************************************************************************************
      * \brief Computes the orthogonal projection of point of the 3D Euclidean space onto the NURBS pacth (overloaded)
@@ -302,6 +403,22 @@ public:
      ***********/
     bool computeForcedPointProjectionOnPatch(double& _u, double& _v, double* _P, const int _relMaxIt=REL_MAX_NUM_ITERATIONS, const double _relTol=REL_TOL_ORTHOGONALITY, const double _distTol=REL_TOL_DISTANCE);
 
+    /***********************************************************************************************
+     * \brief Computes the closest point of the NURBS patch to a point of the 3D Euclidean space.
+     *        The knot spans are visited by the distance of their bounding boxes, the knot spans farther
+     *        than the closest point found are skipped. From the initial guess and from the centre of
+     *        every visited knot span a damped Newton iteration with a trust region is run, which keeps
+     *        the parameters on the patch and converges also to closest points on the patch boundary
+     * \param[in/out] _u Given is the initial guess and returned the u-surface parameter of the closest point
+     * \param[in/out] _v Given is the initial guess and returned the v-surface parameter of the closest point
+     * \param[in/out] _P Given the Cartesian components of the point it is returned the Cartesian components of the closest point
+     * \param[in] _maxIt The maximum number of iterations from every starting point
+     * \param[in] _tol The orthogonality tolerance in the directions not blocked by the patch boundary
+     * \param[in] _distTol The distance below which the point is considered on the patch
+     * \return Whether the iterations have converged
+     ***********/
+    bool computeClosestPointProjectionOnPatch(double& _u, double& _v, double* _P, const int _maxIt=MAX_NUM_ITERATIONS, const double _tol=TOL_ORTHOGONALITY, const double _distTol=TOL_DISTANCE);
+
     /***********************************************************************************************
      * \brief Computes the orthogonal projection of point of the 3D Euclidean space onto the trimming curve
      * \param[in/out] _projectedUTilde Curve parameter of the projected point on the trimming curve
@@ -414,7 +531,9 @@ public:
             const int _maxIt=MAX_NUM_ITERATIONS, const double _tol=TOL_ORTHOGONALITY);
 
     /***********************************************************************************************
-     * \brief Find the nearest knot intersection on the patch as an initial guess for the projection
+     * \brief Find the nearest knot intersection on the patch as an initial guess for the projection.
+     *        The samples are visited by the distance of the bounding boxes of their knot spans, and the
+     *        knot spans farther than the nearest sample found are skipped
      * \param[in/out] _u Given is the u-surface parameter of the nearest knot intersection.
      * \param[in/out] _v Given is the v-surface parameter of the nearest knot intersection.
      * \param[in] _P Given the Cartesian components of the point to be projected on the NURBS patch
@@ -460,6 +579,19 @@ public:
     void computeCartesianCoordinatesAndNormalVector(double* _coords, double* _normal,
             double _u, double _v, int _spanU, int _spanV)const;
 
+    /***********************************************************************************************
+     * \brief Evaluates the patch at many pairs of surface parameters at once. The points are grouped
+     * by knot span such that the knot span search and the gathering of the Control Points are shared
+     * and the contraction runs over a contiguous array of weighted Control Points
+     * \param[in] _noPoints The number of points
+     * \param[in] _uv The surface parameters of the points [u0 v0 u1 v1 ...]
+     * \param[in/out] _coords The Cartesian coordinates of the points [x0 y0 z0 x1 ...], not computed if NULL
+     * \param[in/out] _baseVectors The base vectors of the points [g1x g1y g1z g2x g2y g2z]_0 ..., not computed if NULL
+     * \param[in/out] _normals The (non-normalized) normal vectors of the points [n0x n0y n0z n1x ...], not computed if NULL
+     ***********/
+    void computeCartesianCoordinatesAndNormalVectors(int _noPoints, const double* _uv,
+            double* _coords, double* _baseVectors, double* _normals) const;
+
     /// Intersection related functions
 public:
     /***********************************************************************************************
@@ -561,6 +693,13 @@ public:
         return ControlPointNet[i];
     }
 
+    /***********************************************************************************************
+     * \brief Get the coordinates and the weights of the Control Points packed as [X Y Z W] per Control Point
+     ***********/
+    inline const double* getControlPointCoordinates() const {
+        return controlPointCoordinates;
+    }
+
     /***********************************************************************************************
      * \brief Find know span on u direction
      * \author Chenshen Wu
@@ -626,6 +765,63 @@ public:
     static const char EDGE_VN;
     static const char EDGES[4];
 
+    /// The maximum polynomial degree per direction for which the evaluation kernels are specialized at compile time
+    static const int MAX_FIXED_DEGREE = 4;
+
+    /// Evaluation kernels specialized on the polynomial degrees
+private:
+    /***********************************************************************************************
+     * \brief Returns the Cartesian coordinates and the base vectors at a given pair of surface
+     * parameters for the polynomial degrees P and Q known at compile time
+     * \param[in/out] _coords The Cartesian coordinates of the point on the patch
+     * \param[in/out] _baseVectors The base vectors [g1x g1y g1z g2x g2y g2z], not computed if NULL
+     * \param[in] _u The parameter on the u-coordinate line
+     * \param[in] _spanU The index of the knot span where _u lives in
+     * \param[in] _v The parameter on the v-coordinate line
+     * \param[in] _spanV The index of the knot span where _v lives in
+     ***********/
+    template<int P, int Q>
+    void computeCartesianCoordinatesAndBaseVectorsFixedDegree(double* _coords,
+            double* _baseVectors, double _u, int _spanU, double _v, int _spanV) const;
+
+    /***********************************************************************************************
+     * \brief Returns the evaluation kernel specialized on the given polynomial degrees
+     * \param[in] _pDegree The polynomial degree in u-direction
+     * \param[in] _qDegree The polynomial degree in v-direction
+     * \return The kernel or NULL if the degrees exceed MAX_FIXED_DEGREE
+     ***********/
+    static FixedDegreeKernel getFixedDegreeKernel(int _pDegree, int _qDegree);
+
+    /// Closest point projection
+private:
+    /***********************************************************************************************
+     * \brief Computes the distance vector from a point to the patch and the gradient and the Hessian
+     *        of half its squared length with respect to the surface parameters
+     * \param[out] _distanceVector The distance vector S(u,v) - P
+     * \param[out] _gradient The gradient [Gu*d Gv*d]
+     * \param[out] _hessian The Hessian, row major 2x2
+     * \param[out] _baseVectorNorms The lengths of the base vectors Gu and Gv
+     * \param[in] _u The u-surface parameter
+     * \param[in] _v The v-surface parameter
+     * \param[in] _P The Cartesian components of the point
+     ***********/
+    void computeSquaredDistanceDerivatives(double* _distanceVector, double* _gradient, double* _hessian,
+            double* _baseVectorNorms, double _u, double _v, const double* _P);
+
+    /***********************************************************************************************
+     * \brief Runs the damped Newton iteration with a trust region for the closest point projection
+     * \param[in/out] _u Given is the starting point and returned the u-surface parameter of the last iterate
+     * \param[in/out] _v Given is the starting point and returned the v-surface parameter of the last iterate
+     * \param[out] _distance The distance of the last iterate to the point
+     * \param[in] _P The Cartesian components of the point
+     * \param[in] _trustRadius The initial radius of the trust region in the parameter space
+     * \param[in] _maxIt The maximum number of iterations
+     * \param[in] _tol The orthogonality tolerance
+     * \param[in] _distTol The distance below which the point is considered on the patch
+     * \return Whether the iterations have converged
+     ***********/
+    bool computeTrustRegionPointProjection(double& _u, double& _v, double& _distance, const double* _P,
+            double _trustRadius, int _maxIt, double _tol, double _distTol);
 };
 
 /***********************************************************************************************
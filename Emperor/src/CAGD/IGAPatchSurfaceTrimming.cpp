@@ -37,6 +37,21 @@ using namespace std;
 
 namespace EMPIRE {
 
+/***********************************************************************************************
+ * \brief Compute the signed area of a polygon in 2D, positive if it is counterclockwise
+ * \param[in] _polyline The polygon, stored as u, v for each vertex
+ * \return The signed area
+ ***********/
+static double computeSignedArea(const std::vector<double>& _polyline) {
+    const int numVertices = _polyline.size() / 2;
+    double area = 0.0;
+    for(int i = 0; i < numVertices; i++) {
+        const int j = (i + 1) % numVertices;
+        area += _polyline[2 * i] * _polyline[2 * j + 1] - _polyline[2 * j] * _polyline[2 * i + 1];
+    }
+    return 0.5 * area;
+}
+
 IGAPatchSurfaceTrimming::IGAPatchSurfaceTrimming():outter() {
 }
 
@@ -45,6 +60,13 @@ IGAPatchSurfaceTrimming::~IGAPatchSurfaceTrimming() {
 		delete loops[i];
 }
 
+size_t IGAPatchSurfaceTrimming::getMemory() const {
+    size_t bytes = 0;
+    for (int i = 0; i < loops.size(); i++)
+        bytes += loops[i]->getMemory();
+    return bytes;
+}
+
 void IGAPatchSurfaceTrimming::addTrimLoop(int _inner, int _numCurves) {
     if(_inner) {
         loops.push_back(new IGAPatchSurfaceTrimmingLoop(_numCurves));
@@ -79,13 +101,84 @@ void IGAPatchSurfaceTrimming::addTrimCurve(int _direction,int _IDBasis, int _pDe
     loop.IGACurves.push_back(new IGAPatchCurve(_IDBasis, _pDegree, _uNoKnots, _uKnotVector,_uNoControlPoints,_controlPointNet));
 }
 
-void IGAPatchSurfaceTrimming::linearizeLoops() {
+void IGAPatchSurfaceTrimming::linearizeLoops(int _type) {
      for(int i=0;i<loops.size();i++) {
-    	loops[i]->linearize();
+    	loops[i]->linearize(_type);
+    }
+}
+
+bool IGAPatchSurfaceTrimming::clip(const std::vector<std::pair<double,double> >& _polygonUV,
+                                   std::vector<std::vector<std::pair<double,double> > >& _listPolygonUV) const {
+    // Bounding box of the polygon, enlarged so that its boundary stays apart from the polygon
+    double box[4] = {numeric_limits<double>::max(), -numeric_limits<double>::max(),
+                     numeric_limits<double>::max(), -numeric_limits<double>::max()};
+    for(int i = 0; i < _polygonUV.size(); i++) {
+        box[0] = min(box[0], _polygonUV[i].first);
+        box[1] = max(box[1], _polygonUV[i].first);
+        box[2] = min(box[2], _polygonUV[i].second);
+        box[3] = max(box[3], _polygonUV[i].second);
+    }
+    const double offset = 1e-3 * max(box[1] - box[0], box[3] - box[2]) + 1e-8;
+    box[0] -= offset;
+    box[1] += offset;
+    box[2] -= offset;
+    box[3] += offset;
+
+    // Loops containing the whole box add their orientation to the winding number of the polygon,
+    // only the loops crossing the box have to be clipped
+    ClipperAdapter c;
+    int winding = 0;
+    bool isCrossed = false;
+    std::vector<double> localPolyline;
+    for(int i = 0; i < loops.size(); i++) {
+        IGAPatchSurfaceTrimmingLoop::BoxLocation location = loops[i]->locateBox(box);
+        if(location == IGAPatchSurfaceTrimmingLoop::BOX_INSIDE) {
+            winding += loops[i]->getOrientation();
+        } else if(location == IGAPatchSurfaceTrimmingLoop::BOX_CROSSED) {
+            loops[i]->clipByBox(box, localPolyline);
+            // A degenerated remainder does not cover any part of the box
+            if(fabs(computeSignedArea(localPolyline)) > offset * offset * 1e-6) {
+                c.addPathClipper(localPolyline);
+                isCrossed = true;
+            }
+        }
     }
+    if(!isCrossed) {
+        _listPolygonUV.clear();
+        if(winding > 0) {
+            // Same orientation as the solution of the clipper
+            _listPolygonUV.push_back(_polygonUV);
+            if(!ClipperAdapter::isCounterclockwise(_listPolygonUV[0]))
+                reverse(_listPolygonUV[0].begin(), _listPolygonUV[0].end());
+        }
+        return false;
+    }
+    // The winding number of the loops containing the box is given by copies of the box
+    std::vector<double> boxPolyline(8);
+    boxPolyline[0] = box[0]; boxPolyline[1] = box[2];
+    boxPolyline[2] = box[1]; boxPolyline[3] = box[2];
+    boxPolyline[4] = box[1]; boxPolyline[5] = box[3];
+    boxPolyline[6] = box[0]; boxPolyline[7] = box[3];
+    for(int i = 0; i < winding; i++)
+        c.addPathClipper(boxPolyline);
+    if(winding < 0) {
+        std::vector<double> reversedBoxPolyline(8);
+        for(int k = 0; k < 4; k++) {
+            reversedBoxPolyline[2 * k] = boxPolyline[2 * (3 - k)];
+            reversedBoxPolyline[2 * k + 1] = boxPolyline[2 * (3 - k) + 1];
+        }
+        for(int i = 0; i < -winding; i++)
+            c.addPathClipper(reversedBoxPolyline);
+    }
+    // Setup filling rule to have for sure clockwise loop as hole and counterclockwise as boundaries
+    c.setFilling(ClipperAdapter::POSITIVE, 0);
+    c.clip(_polygonUV, _listPolygonUV);
+    return true;
 }
 
-IGAPatchSurfaceTrimmingLoop::IGAPatchSurfaceTrimmingLoop(int _numCurves) {
+IGAPatchSurfaceTrimmingLoop::IGAPatchSurfaceTrimmingLoop(int _numCurves):orientation(1) {
+     gridNumCells[0] = 0;
+     gridNumCells[1] = 0;
 	 // Reserve the place for the vectors
      IGACurves.reserve(_numCurves);
 	 direction.reserve(_numCurves);
@@ -98,6 +191,14 @@ IGAPatchSurfaceTrimmingLoop::~IGAPatchSurfaceTrimmingLoop() {
         delete IGACurves[i];
 }
 
+size_t IGAPatchSurfaceTrimmingLoop::getMemory() const {
+    size_t bytes = polylines.capacity() * sizeof(double) + isGridCellInside.capacity() / 8
+            + gridCellSegments.capacity() * sizeof(std::vector<int>);
+    for (int i = 0; i < gridCellSegments.size(); i++)
+        bytes += gridCellSegments[i].capacity() * sizeof(int);
+    return bytes;
+}
+
 void IGAPatchSurfaceTrimmingLoop::addTrimCurve(int _direction, IGAPatchCurve* _trimCurve) {
     direction.push_back(_direction);
     IGACurves.push_back(_trimCurve);
@@ -119,6 +220,147 @@ void IGAPatchSurfaceTrimmingLoop::linearize(int _type) {
         }
     }
     ClipperAdapter::cleanPolygon(polylines);
+    buildGrid();
+}
+
+void IGAPatchSurfaceTrimmingLoop::buildGrid() {
+    const int numSegments = polylines.size() / 2;
+    gridCellSegments.clear();
+    isGridCellInside.clear();
+    gridNumCells[0] = 0;
+    gridNumCells[1] = 0;
+    if(numSegments < 3)
+        return;
+    orientation = (computeSignedArea(polylines) >= 0.0) ? 1 : -1;
+
+    gridBox[0] = gridBox[1] = polylines[0];
+    gridBox[2] = gridBox[3] = polylines[1];
+    for(int i = 1; i < numSegments; i++) {
+        gridBox[0] = min(gridBox[0], polylines[2 * i]);
+        gridBox[1] = max(gridBox[1], polylines[2 * i]);
+        gridBox[2] = min(gridBox[2], polylines[2 * i + 1]);
+        gridBox[3] = max(gridBox[3], polylines[2 * i + 1]);
+    }
+    // About one segment per cell, a row then holds about the square root of the segments
+    const int numCellsPerDirection = max(1, (int)sqrt((double)numSegments));
+    for(int k = 0; k < 2; k++) {
+        gridNumCells[k] = numCellsPerDirection;
+        gridCellSize[k] = (gridBox[2 * k + 1] - gridBox[2 * k]) / gridNumCells[k];
+        if(gridCellSize[k] <= 0.0)
+            gridCellSize[k] = 1.0;
+    }
+    gridCellSegments.resize(gridNumCells[0] * gridNumCells[1]);
+    for(int i = 0; i < numSegments; i++) {
+        const int j = (i + 1) % numSegments;
+        const int column0 = getGridColumn(min(polylines[2 * i], polylines[2 * j]));
+        const int column1 = getGridColumn(max(polylines[2 * i], polylines[2 * j]));
+        const int row0 = getGridRow(min(polylines[2 * i + 1], polylines[2 * j + 1]));
+        const int row1 = getGridRow(max(polylines[2 * i + 1], polylines[2 * j + 1]));
+        for(int row = row0; row <= row1; row++)
+            for(int column = column0; column <= column1; column++)
+                gridCellSegments[row * gridNumCells[0] + column].push_back(i);
+    }
+    // No segment crosses a cell without segments, so its center tells whether it is inside. The
+    // centers are located by casting rays, as long as isGridCellInside is empty
+    std::vector<bool> isCellInside(gridCellSegments.size(), false);
+    for(int row = 0; row < gridNumCells[1]; row++)
+        for(int column = 0; column < gridNumCells[0]; column++) {
+            if(!gridCellSegments[row * gridNumCells[0] + column].empty())
+                continue;
+            double center[2] = {gridBox[0] + (column + 0.5) * gridCellSize[0],
+                                gridBox[2] + (row + 0.5) * gridCellSize[1]};
+            isCellInside[row * gridNumCells[0] + column] = isPointInside(center);
+        }
+    isGridCellInside.swap(isCellInside);
+}
+
+bool IGAPatchSurfaceTrimmingLoop::isPointInside(const double* _uv) const {
+    if(gridNumCells[0] == 0)
+        return false;
+    if(_uv[0] < gridBox[0] || _uv[0] > gridBox[1] || _uv[1] < gridBox[2] || _uv[1] > gridBox[3])
+        return false;
+    const int numSegments = polylines.size() / 2;
+    const int row = getGridRow(_uv[1]);
+    const int firstColumn = getGridColumn(_uv[0]);
+    const std::vector<int>& pointCell = gridCellSegments[row * gridNumCells[0] + firstColumn];
+    if(pointCell.empty() && !isGridCellInside.empty())
+        return isGridCellInside[row * gridNumCells[0] + firstColumn];
+    // Count the crossings of the ray in +u direction, each one in the cell where it happens, so that
+    // a segment registered in several cells is counted once
+    bool isInside = false;
+    for(int column = firstColumn; column < gridNumCells[0]; column++) {
+        const std::vector<int>& cell = gridCellSegments[row * gridNumCells[0] + column];
+        for(int k = 0; k < cell.size(); k++) {
+            const int i = cell[k];
+            const int j = (i + 1) % numSegments;
+            const double ui = polylines[2 * i], vi = polylines[2 * i + 1];
+            const double uj = polylines[2 * j], vj = polylines[2 * j + 1];
+            if((vi > _uv[1]) == (vj > _uv[1]))
+                continue;
+            const double uCrossing = (uj - ui) * (_uv[1] - vi) / (vj - vi) + ui;
+            if(_uv[0] < uCrossing && getGridColumn(uCrossing) == column)
+                isInside = !isInside;
+        }
+    }
+    return isInside;
+}
+
+IGAPatchSurfaceTrimmingLoop::BoxLocation IGAPatchSurfaceTrimmingLoop::locateBox(const double* _box) const {
+    if(gridNumCells[0] == 0)
+        return BOX_OUTSIDE;
+    if(_box[1] < gridBox[0] || _box[0] > gridBox[1] || _box[3] < gridBox[2] || _box[2] > gridBox[3])
+        return BOX_OUTSIDE;
+    const int numSegments = polylines.size() / 2;
+    const int column0 = getGridColumn(_box[0]);
+    const int column1 = getGridColumn(_box[1]);
+    const int row0 = getGridRow(_box[2]);
+    const int row1 = getGridRow(_box[3]);
+    for(int row = row0; row <= row1; row++)
+        for(int column = column0; column <= column1; column++) {
+            const std::vector<int>& cell = gridCellSegments[row * gridNumCells[0] + column];
+            for(int k = 0; k < cell.size(); k++) {
+                const int i = cell[k];
+                const int j = (i + 1) % numSegments;
+                if(max(polylines[2 * i], polylines[2 * j]) >= _box[0]
+                        && min(polylines[2 * i], polylines[2 * j]) <= _box[1]
+                        && max(polylines[2 * i + 1], polylines[2 * j + 1]) >= _box[2]
+                        && min(polylines[2 * i + 1], polylines[2 * j + 1]) <= _box[3])
+                    return BOX_CROSSED;
+            }
+        }
+    // The box is connected and not crossed by the loop, so any of its points locates it
+    double center[2] = {0.5 * (_box[0] + _box[1]), 0.5 * (_box[2] + _box[3])};
+    return isPointInside(center) ? BOX_INSIDE : BOX_OUTSIDE;
+}
+
+void IGAPatchSurfaceTrimmingLoop::clipByBox(const double* _box, std::vector<double>& _polyline) const {
+    // Clip by the four half planes u >= uMin, u <= uMax, v >= vMin, v <= vMax one after the other.
+    // The part of the loop outside a half plane is replaced by a segment on its boundary, which
+    // does not change the winding number of the points inside
+    _polyline = polylines;
+    std::vector<double> input;
+    for(int plane = 0; plane < 4; plane++) {
+        const int k = plane / 2;
+        const double bound = _box[plane];
+        const double sign = (plane % 2 == 0) ? 1.0 : -1.0;
+        input.swap(_polyline);
+        _polyline.clear();
+        const int numVertices = input.size() / 2;
+        for(int i = 0; i < numVertices; i++) {
+            const int j = (i + 1) % numVertices;
+            const double di = sign * (input[2 * i + k] - bound);
+            const double dj = sign * (input[2 * j + k] - bound);
+            if(di >= 0.0) {
+                _polyline.push_back(input[2 * i]);
+                _polyline.push_back(input[2 * i + 1]);
+            }
+            if((di >= 0.0) != (dj >= 0.0)) {
+                const double t = di / (di - dj);
+                _polyline.push_back(input[2 * i] + t * (input[2 * j] - input[2 * i]));
+                _polyline.push_back(input[2 * i + 1] + t * (input[2 * j + 1] - input[2 * i + 1]));
+            }
+        }
+    }
 }
 
 Message &operator<<(Message &message, const IGAPatchSurfaceTrimming &trim) {
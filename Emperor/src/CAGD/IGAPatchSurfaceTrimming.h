@@ -32,6 +32,7 @@
  #include "IGAControlPoint.h"
  #include <vector>
  #include <utility>
+ #include <algorithm>
  #include <assert.h>
 
  
@@ -91,9 +92,21 @@
          /***********************************************************************************************
           * \brief Create a linear approximation for every loop using position computed at Greville abscissae
           * 	   And remove non-unique points or aligned points from the set
+          * \param[in] _type Type of linearization, see IGAPatchCurve::linearize
           * \author Fabien Pean
           ***********/
-         void linearizeLoops();
+         void linearizeLoops(int _type = 2);
+
+         /***********************************************************************************************
+          * \brief Clip a polygon in the parameter space by all loops, where counterclockwise loops are
+          *        boundaries and clockwise loops are holes. Only the loops crossing the polygon, cut
+          *        down to its bounding box, are given to the clipper
+          * \param[in] _polygonUV The polygon to be clipped
+          * \param[out] _listPolygonUV The parts of the polygon inside the trimmed domain
+          * \return false if no loop crosses the polygon, so that it is kept or dropped as a whole
+          ***********/
+         bool clip(const std::vector<std::pair<double,double> >& _polygonUV,
+                   std::vector<std::vector<std::pair<double,double> > >& _listPolygonUV) const;
          
          /// Get and set functions
      public:
@@ -154,6 +167,10 @@
          inline int getNumOfLoops() const {
         	 return loops.size();
          }
+         /***********************************************************************************************
+          * \brief Get the heap memory of the linearized loops and of their search grids
+          ***********/
+         size_t getMemory() const;
      };
 
      /********//**
@@ -198,12 +215,81 @@
      public:
          /***********************************************************************************************
           * \brief Create a linear approximation for this loop
-          * \param[in] _type Type of linearization 0: NCPxP, 1: Greville, 2: Combined
+          * \param[in] _type Type of linearization 0: Greville, 1: NCPxP, 2: Combined, 3: Adaptive
           * \author Fabien Pean
           * \edit Altug Emiroglu: the function is migrated from the trimming loop to the underlying curve
           ***********/
          void linearize(int _type = 2);
 
+         /// Location of a box relative to the loop
+         enum BoxLocation {BOX_OUTSIDE = 0, BOX_INSIDE, BOX_CROSSED};
+
+         /// Search functions on the linearized loop, accelerated by a uniform grid over its segments
+     public:
+         /***********************************************************************************************
+          * \brief Find whether a point lies inside the linearized loop, regardless of its orientation.
+          *        Only the segments in the row of grid cells on the right of the point are tested
+          * \param[in] _uv The point in the parameter space
+          * \return true if the point is inside
+          ***********/
+         bool isPointInside(const double* _uv) const;
+         /***********************************************************************************************
+          * \brief Locate an axis aligned box relative to the linearized loop
+          * \param[in] _box The box, stored as uMin, uMax, vMin, vMax
+          * \return BOX_INSIDE or BOX_OUTSIDE if no segment of the loop may cross the box, BOX_CROSSED else
+          ***********/
+         BoxLocation locateBox(const double* _box) const;
+         /***********************************************************************************************
+          * \brief Clip the linearized loop by an axis aligned box (Sutherland-Hodgman). Inside the box,
+          *        the result winds around every point as often as the loop
+          * \param[in] _box The box, stored as uMin, uMax, vMin, vMax
+          * \param[out] _polyline The clipped loop, stored as u, v for each vertex
+          ***********/
+         void clipByBox(const double* _box, std::vector<double>& _polyline) const;
+         /***********************************************************************************************
+          * \brief Get the orientation of the linearized loop
+          * \return 1 if the loop is counterclockwise, -1 if it is clockwise
+          ***********/
+         inline int getOrientation() const {
+             return orientation;
+         }
+         /***********************************************************************************************
+          * \brief Get the heap memory of the linearized loop and of its search grid
+          ***********/
+         size_t getMemory() const;
+
+     private:
+         /***********************************************************************************************
+          * \brief Build the grid over the segments of the linearized loop and classify its empty cells
+          ***********/
+         void buildGrid();
+         /***********************************************************************************************
+          * \brief Get the grid column of a u coordinate, clamped to the grid
+          ***********/
+         inline int getGridColumn(double _u) const {
+             int column = (int)((_u - gridBox[0]) / gridCellSize[0]);
+             return std::max(0, std::min(gridNumCells[0] - 1, column));
+         }
+         /***********************************************************************************************
+          * \brief Get the grid row of a v coordinate, clamped to the grid
+          ***********/
+         inline int getGridRow(double _v) const {
+             int row = (int)((_v - gridBox[2]) / gridCellSize[1]);
+             return std::max(0, std::min(gridNumCells[1] - 1, row));
+         }
+         /// 1 if the linearized loop is counterclockwise, -1 else
+         int orientation;
+         /// Bounding box of the linearized loop, stored as uMin, uMax, vMin, vMax
+         double gridBox[4];
+         /// Size of a grid cell in u and v
+         double gridCellSize[2];
+         /// Number of grid cells in u and v
+         int gridNumCells[2];
+         /// Indices of the segments whose bounding box overlaps the cell, row by row
+         std::vector<std::vector<int> > gridCellSegments;
+         /// Whether a cell without segments is inside the loop
+         std::vector<bool> isGridCellInside;
+
          /// get functions
 	 public:
          /***********************************************************************************************
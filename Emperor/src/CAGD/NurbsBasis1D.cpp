@@ -24,6 +24,7 @@
 
 // Inclusion of user defined libraries
 #include "NurbsBasis1D.h"
+#include "ScratchArray.h"
 //#include "IGAMath.h"
 // Edit Aditya
 #include "MathLibrary.h"
@@ -78,7 +79,7 @@ void NurbsBasis1D::computeLocalBasisFunctions(double* _localBasisFunctions, doub
     assert(_localBasisFunctions!=NULL);
 
     // Compute the non-zero B-Spline basis functions at the given knot span
-    double* BSplineBasisFunctions = new double[getPolynomialDegree() + 1];
+    ScratchArray<double, SCRATCH_SIZE_1D> BSplineBasisFunctions(getPolynomialDegree() + 1);
     BSplineBasis1D::computeLocalBasisFunctions(BSplineBasisFunctions, _uPrm, _KnotSpanIndex);
 
     // Initialize auxiliary variable
@@ -95,9 +96,6 @@ void NurbsBasis1D::computeLocalBasisFunctions(double* _localBasisFunctions, doub
     for (int i = 0; i <= getPolynomialDegree(); i++) {
         _localBasisFunctions[i] /= sum;
     }
-
-    // Clear the memory on the heap
-    delete[] BSplineBasisFunctions;
 }
 
 void NurbsBasis1D::computeDenominatorFunctionAndDerivatives(double* _denominatorFctAndDerivs,
@@ -170,12 +168,13 @@ void NurbsBasis1D::computeLocalBasisFunctionsAndDerivatives(double* _basisFctsAn
         _basisFctsAndDerivs[i] = 0.0;
 
     // Compute the non-zero B-Spline basis functions at the given knot span
-    double* BSplineBasisFunctionsAndDerivs = new double[(_derivDegree + 1) * (pDegree + 1)];
+    ScratchArray<double, (SCRATCH_MAX_DERIV + 1) * SCRATCH_SIZE_1D> BSplineBasisFunctionsAndDerivs(
+            (_derivDegree + 1) * (pDegree + 1));
     BSplineBasis1D::computeLocalBasisFunctionsAndDerivatives(BSplineBasisFunctionsAndDerivs,
             _derivDegree, _uPrm, _knotSpanIndex);
 
     // Initialize and compute the denominator function the w(u) = Sum_(i=1)^n N^(i,p)*w_i and its derivatives
-    double* denominatorFunction = new double[_derivDegree + 1];
+    ScratchArray<double, SCRATCH_MAX_DERIV + 1> denominatorFunction(_derivDegree + 1);
     computeDenominatorFunctionAndDerivatives(denominatorFunction, BSplineBasisFunctionsAndDerivs,
             _derivDegree, _knotSpanIndex);
 
@@ -206,10 +205,6 @@ void NurbsBasis1D::computeLocalBasisFunctionsAndDerivatives(double* _basisFctsAn
             _basisFctsAndDerivs[j * (pDegree + 1) + i] = v / denominatorFunction[0];
         }
     }
-
-    // Free the memory from the heap
-    delete[] BSplineBasisFunctionsAndDerivs;
-    delete[] denominatorFunction;
 }
 
 void NurbsBasis1D::computeLocalBasisFunctionsAndDerivatives(double* _basisFctsAndDerivs,
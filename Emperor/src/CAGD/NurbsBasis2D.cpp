@@ -26,6 +26,7 @@
 
 // Inclusion of user defined libraries
 #include "NurbsBasis2D.h"
+#include "ScratchArray.h"
 //#include "IGAMath.h"
 // Edit Aditya
 #include "MathLibrary.h"
@@ -102,11 +103,13 @@ void NurbsBasis2D::computeLocalBasisFunctions(double* _basisFcts, double _uPrm,
     assert(_basisFcts!=NULL);
 
     // Compute the B-Spline basis functions at each surface parameter
-    double* uBSplinebasis1DFcts = new double[uBSplineBasis1D->getPolynomialDegree() + 1];
+    ScratchArray<double, SCRATCH_SIZE_1D> uBSplinebasis1DFcts(
+            uBSplineBasis1D->getPolynomialDegree() + 1);
     uBSplineBasis1D->computeLocalBasisFunctions(uBSplinebasis1DFcts, _uPrm, _KnotSpanIndexU);
 
     // Compute the local B-Spline basis functions in v-direction
-    double* vBSplinebasis1DFcts = new double[vBSplineBasis1D->getPolynomialDegree() + 1];
+    ScratchArray<double, SCRATCH_SIZE_1D> vBSplinebasis1DFcts(
+            vBSplineBasis1D->getPolynomialDegree() + 1);
     vBSplineBasis1D->computeLocalBasisFunctions(vBSplinebasis1DFcts, _vPrm, _KnotSpanIndexV);
 
     int noLocalBasisFunctions = (uBSplineBasis1D->getPolynomialDegree() + 1)
@@ -146,10 +149,6 @@ void NurbsBasis2D::computeLocalBasisFunctions(double* _basisFcts, double _uPrm,
     for (int i = 0; i < noLocalBasisFunctions; i++) {
         _basisFcts[i] /= sum;
     }
-
-    // Clear the memory on the heap from the pointers
-    delete[] uBSplinebasis1DFcts;
-    delete[] vBSplinebasis1DFcts;
 }
 
 void NurbsBasis2D::computeDenominatorFunctionAndDerivatives(double* _denominatorFctAndDerivs,
@@ -309,8 +308,8 @@ void NurbsBasis2D::computeLocalBasisFunctionsAndDerivatives(double* _basisFctsAn
             }
 
     // Compute the B-Spline basis functions and their partial derivatives up to _derivDegree absolute order
-    double* bSplineBasisFctAndDeriv = new double[(_derivDegree + 1) * (_derivDegree + 2)
-            * noBasisFcts / 2];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * SCRATCH_SIZE_2D> bSplineBasisFctAndDeriv(
+            (_derivDegree + 1) * (_derivDegree + 2) * noBasisFcts / 2);
     BSplineBasis2D::computeLocalBasisFunctionsAndDerivatives(bSplineBasisFctAndDeriv, _derivDegree,
             _uPrm, _KnotSpanIndexU, _vPrm, _KnotSpanIndexV);
 
@@ -322,7 +321,8 @@ void NurbsBasis2D::computeLocalBasisFunctionsAndDerivatives(double* _basisFctsAn
     int vIndexCP = 0;
 
     // Compute the denominator function
-    double* denominatorFct = new double[(_derivDegree + 1) * (_derivDegree + 1)];
+    ScratchArray<double, (SCRATCH_MAX_DERIV + 1) * (SCRATCH_MAX_DERIV + 1)> denominatorFct(
+            (_derivDegree + 1) * (_derivDegree + 1));
     computeDenominatorFunctionAndDerivatives(denominatorFct, bSplineBasisFctAndDeriv, _derivDegree,
             _KnotSpanIndexU, _KnotSpanIndexV);
 
@@ -398,10 +398,6 @@ void NurbsBasis2D::computeLocalBasisFunctionsAndDerivatives(double* _basisFctsAn
             counterBasis++;
         }
     }
-
-    // Free the memory from the heap
-    delete[] bSplineBasisFctAndDeriv;
-    delete[] denominatorFct;
 }
 
 Message &operator<<(Message &message, NurbsBasis2D &nurbsBasis2D) {
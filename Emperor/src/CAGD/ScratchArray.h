@@ -0,0 +1,109 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Andreas Apostolatos, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file ScratchArray.h
+ * This file holds the class template ScratchArray
+ * \date 10/14/2026
+ **************************************************************************************************/
+
+#ifndef SCRATCHARRAY_H_
+#define SCRATCHARRAY_H_
+
+#include "MonotonicArena.h"
+
+namespace EMPIRE {
+
+/// Maximum polynomial degree per parametric direction for which the basis scratch arrays live on the stack
+const int SCRATCH_MAX_DEGREE = 7;
+
+/// Stack capacity needed for the non-zero 1D basis functions of degree up to SCRATCH_MAX_DEGREE
+const int SCRATCH_SIZE_1D = SCRATCH_MAX_DEGREE + 1;
+
+/// Stack capacity needed for the non-zero 2D basis functions of degrees up to SCRATCH_MAX_DEGREE
+const int SCRATCH_SIZE_2D = SCRATCH_SIZE_1D * SCRATCH_SIZE_1D;
+
+/// Maximum absolute derivative order for which the derivative tables live on the stack
+const int SCRATCH_MAX_DERIV = 3;
+
+/// Number of partial derivatives of a 2D function up to absolute order SCRATCH_MAX_DERIV
+const int SCRATCH_NO_DERIVS_2D = (SCRATCH_MAX_DERIV + 1) * (SCRATCH_MAX_DERIV + 2) / 2;
+
+/********//**
+ * \brief class ScratchArray is a temporary array which lives on the stack if it contains at most
+ * N entries and otherwise in the scratch arena of the calling thread. It replaces the new/delete
+ * pairs of the basis function evaluations, which are called at every quadrature point. The arena
+ * keeps its blocks, such that the arrays of high degree patches are allocated once per thread and
+ * reused afterwards. T must not need construction nor destruction.
+ ***********/
+template<class T, int N>
+class ScratchArray {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _size The number of entries needed
+     ***********/
+    explicit ScratchArray(int _size) :
+            data(stackData), arena(NULL) {
+        if (_size > N) {
+            arena = &MonotonicArena::getThreadScratchArena();
+            marker = arena->getMarker();
+            data = arena->allocate<T>(_size);
+        }
+    }
+
+    /***********************************************************************************************
+     * \brief Destructor, gives the memory back to the arena if the stack storage was not large
+     *        enough. Scratch arrays are automatic variables, so they are released in the reverse
+     *        order of their construction.
+     ***********/
+    ~ScratchArray() {
+        if (arena != NULL)
+            arena->rewind(marker);
+    }
+
+    /***********************************************************************************************
+     * \brief Access to the underlying array
+     ***********/
+    inline operator T*() {
+        return data;
+    }
+
+private:
+    /// The storage on the stack
+    T stackData[N];
+
+    /// The array in use, either stackData or memory of the arena
+    T* data;
+
+    /// The scratch arena of the thread if the array does not fit on the stack
+    MonotonicArena* arena;
+
+    /// The position of the arena before the array was allocated
+    MonotonicArena::Marker marker;
+
+    /// Not copyable
+    ScratchArray(const ScratchArray&);
+    ScratchArray& operator=(const ScratchArray&);
+};
+
+} /* namespace EMPIRE */
+
+#endif /* SCRATCHARRAY_H_ */
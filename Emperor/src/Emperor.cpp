@@ -21,10 +21,19 @@
 #include <assert.h>
 #include <mpi.h>
 #include <time.h>
+#include <omp.h>
+#include <algorithm>
+#ifdef USE_INTEL_MKL
+#include <mkl.h>
+#endif
 #include <sstream>
+#include <fstream>
+#include <set>
+#include <unistd.h>
 
 #include "Emperor.h"
 #include "ServerCommunication.h"
+#include "ServerRanks.h"
 #include "ClientCode.h"
 #include "DataOutput.h"
 #include "Connection.h"
@@ -40,52 +49,263 @@
 #include "DataFieldIntegrationFilter.h"
 #include "AdditionFilter.h"
 #include "MapperAdapter.h"
+#include "IGAMortarMapperTuning.h"
+#include "CouplingMatricesCache.h"
 #include "NearestNeighborMapper.h"
 #include "BarycentricInterpolationMapper.h"
 #include "FEMesh.h"
 #include "AbstractMesh.h"
 #include "Message.h"
+#include "Profiler.h"
+#include "BuildProgress.h"
+#include "LiveMetrics.h"
+#include "BufferPool.h"
 #include "DataField.h"
 #include "MapperAdapter.h"
 #include "Aitken.h"
 #include "ConstantRelaxation.h"
 #include "IJCSA.h"
+#include "IQNILS.h"
 #include "GMRES.h"
 #include "AbstractCouplingLogic.h"
 #include "LinearExtrapolator.h"
+#include "PolynomialExtrapolator.h"
+#include "AdamsBashforthExtrapolator.h"
 #include "CouplingLogicSequence.h"
 #include "IterativeCouplingLoop.h"
 #include "TimeStepLoop.h"
 #include "OptimizationLoop.h"
+#include "CouplingStateCheckpoint.h"
 #include "PseudoCodeOutput.h"
 #include "ConvergenceChecker.h"
 #include "AuxiliaryParameters.h"
+#include "TaskPool.h"
 #include "Residual.h"
 
 using namespace std;
 
 namespace EMPIRE {
 
+static void findBuiltMappingDirections(const structMapper &settingMapper, bool &consistent,
+        bool &conservative);
+static void findSharedMappers(vector<int> &sharedMappers, vector<bool> &isMirrored);
+
+/***********************************************************************************************
+ * \brief Hash the settings a mapper is built with, i.e. all settings but its name, its meshes
+ *        and its cache directory, including the directions its operators are built for
+ * \param[in] settingMapper the settings of the mapper
+ * \param[in] isDirectionsHashed whether the directions are part of the hash
+ * \param[in] isMirrored hash the settings as if mesh A and mesh B were swapped
+ * \return the hash
+ ***********/
+static uint64_t getMapperSettingsKey(const structMapper &settingMapper,
+        bool isDirectionsHashed = true, bool isMirrored = false) {
+    CouplingMatricesCache hash(".", "");
+    if (isDirectionsHashed) {
+        bool consistent, conservative;
+        findBuiltMappingDirections(settingMapper, consistent, conservative);
+        hash.addToKey(consistent);
+        hash.addToKey(conservative);
+    }
+    hash.addToKey((int) settingMapper.type);
+    hash.addToKey(settingMapper.writeMode);
+    hash.addToKey(settingMapper.iterativeSolverTolerance);
+    hash.addToKey(settingMapper.iterativeSolverMaxIterations);
+    hash.addToKey(settingMapper.inexactSolveForcing);
+    hash.addToKey(settingMapper.inexactSolveMaxTolerance);
+    hash.addToKey(settingMapper.linearSolver);
+    hash.addToKey(settingMapper.pardiso.numThreads);
+    hash.addToKey((int) settingMapper.pardiso.ordering);
+    hash.addToKey((int) settingMapper.pardiso.outOfCoreMode);
+    hash.addToKey(settingMapper.pardiso.outOfCoreDirectory);
+    hash.addToKey(settingMapper.pardiso.outOfCoreMaxCoreSize);
+    hash.addToKey(settingMapper.pardiso.twoLevelFactorization);
+    hash.addToKey(settingMapper.compactAfterBuild);
+    hash.addToKey(settingMapper.reorderCouplingMatrices);
+    hash.addToKey(settingMapper.singlePrecisionWeights);
+    hash.addToKey(settingMapper.explicitMappingOperator);
+    hash.addToKey(isMirrored ? settingMapper.meshMotionB : settingMapper.meshMotionA);
+    hash.addToKey(isMirrored ? settingMapper.meshMotionA : settingMapper.meshMotionB);
+    hash.addToKey(settingMapper.meshMotionThreshold);
+    if (settingMapper.type == EMPIRE_MortarMapper) {
+        const structMapper::structMortarMapper &mortar = settingMapper.mortarMapper;
+        hash.addToKey(mortar.oppositeSurfaceNormal);
+        hash.addToKey(mortar.dual);
+        hash.addToKey(mortar.enforceConsistency);
+    } else if (settingMapper.type == EMPIRE_IGAMortarMapper) {
+        const structMapper::structIGAMortarMapper &iga = settingMapper.IGAMortarMapper;
+        hash.addToKey(iga.propConsistency.enforceConsistency);
+        hash.addToKey(iga.propConsistency.tolConsistency);
+        hash.addToKey(iga.propProjection.maxProjectionDistance);
+        hash.addToKey(iga.propProjection.noInitialGuess);
+        hash.addToKey(iga.propProjection.maxProjectionDistanceOnDifferentPatches);
+        const struct structMapper::structIGAMortarMapper::propNonlinearScheme *schemes[3] = {
+                &iga.propNewtonRaphson, &iga.propNewtonRaphsonBoundary, &iga.propBisection };
+        for (int i = 0; i < 3; i++) {
+            hash.addToKey(schemes[i]->noIterations);
+            hash.addToKey(schemes[i]->tolProjection);
+        }
+        hash.addToKey(iga.propIntegration.isAutomaticNoGPTriangle);
+        hash.addToKey(iga.propIntegration.noGPTriangle);
+        hash.addToKey(iga.propIntegration.isAutomaticNoGPQuadrilateral);
+        hash.addToKey(iga.propIntegration.noGPQuadrilateral);
+        hash.addToKey(iga.propIntegration.isAdaptive);
+        hash.addToKey(iga.propIntegration.tolAdaptive);
+        hash.addToKey(iga.propWeakCurveDirichletConditions.isWeakCurveDirichletConditions);
+        hash.addToKey(iga.propWeakCurveDirichletConditions.isAutomaticPenaltyParameters);
+        hash.addToKey(iga.propWeakCurveDirichletConditions.isPrimPrescribed);
+        hash.addToKey(iga.propWeakCurveDirichletConditions.isSecBendingPrescribed);
+        hash.addToKey(iga.propWeakCurveDirichletConditions.isSecTwistingPrescribed);
+        hash.addToKey(iga.propWeakCurveDirichletConditions.alphaPrim);
+        hash.addToKey(iga.propWeakCurveDirichletConditions.alphaSecBending);
+        hash.addToKey(iga.propWeakCurveDirichletConditions.alphaSecTwisting);
+        hash.addToKey(iga.propWeakSurfaceDirichletConditions.isWeakSurfaceDirichletConditions);
+        hash.addToKey(iga.propWeakSurfaceDirichletConditions.isPrimPrescribed);
+        hash.addToKey(iga.propWeakSurfaceDirichletConditions.isSecBendingPrescribed);
+        hash.addToKey(iga.propWeakSurfaceDirichletConditions.isAutomaticPenaltyParameters);
+        hash.addToKey(iga.propWeakSurfaceDirichletConditions.alphaPrim);
+        hash.addToKey(iga.propWeakPatchContinuityConditions.isWeakPatchContinuityConditions);
+        hash.addToKey(iga.propWeakPatchContinuityConditions.isAutomaticPenaltyParameters);
+        hash.addToKey(iga.propWeakPatchContinuityConditions.isPrimCoupled);
+        hash.addToKey(iga.propWeakPatchContinuityConditions.isSecBendingCoupled);
+        hash.addToKey(iga.propWeakPatchContinuityConditions.isSecTwistingCoupled);
+        hash.addToKey(iga.propWeakPatchContinuityConditions.alphaPrim);
+        hash.addToKey(iga.propWeakPatchContinuityConditions.alphaSecBending);
+        hash.addToKey(iga.propWeakPatchContinuityConditions.alphaSecTwisting);
+        hash.addToKey(iga.propStrongCurveDirichletConditions.isStrongCurveDirichletConditions);
+        hash.addToKey(iga.propErrorComputation.isErrorComputation);
+        hash.addToKey(iga.propErrorComputation.isDomainError);
+        hash.addToKey(iga.propErrorComputation.isCurveError);
+        hash.addToKey(iga.propErrorComputation.isInterfaceError);
+        hash.addToKey(iga.propErrorComputation.isCompactStorage);
+        hash.addToKey(iga.propTuning.isTuning);
+        if (iga.propTuning.isTuning) {
+            hash.addToKey(iga.propTuning.sampleSize);
+            hash.addToKey(iga.propTuning.targetProjectionSuccessRate);
+            hash.addToKey(iga.propTuning.targetMappingError);
+            hash.addToKey(iga.propTuning.isApplied);
+        }
+    } else if (settingMapper.type == EMPIRE_IGABarycentricMapper) {
+        const structMapper::structIGABarycentricMapper &iga = settingMapper.IGABarycentricMapper;
+        hash.addToKey(iga.propProjection.maxProjectionDistance);
+        hash.addToKey(iga.propProjection.noInitialGuess);
+        hash.addToKey(iga.propProjection.maxProjectionDistanceOnDifferentPatches);
+        hash.addToKey(iga.propNewtonRaphson.noIterations);
+        hash.addToKey(iga.propNewtonRaphson.tolProjection);
+    } else if (settingMapper.type == EMPIRE_CurveSurfaceMapper) {
+        hash.addToKey((int) settingMapper.curveSurfaceMapper.type);
+    } else if (settingMapper.type == EMPIRE_RBFMapper) {
+        hash.addToKey(settingMapper.RBFMapper.numNodesPerPatch);
+    }
+    return hash.getKey();
+}
+
+/***********************************************************************************************
+ * \brief Sweep the projection and integration parameters of an IGAMortarMapper on a sample of its
+ *        FE elements, report the cheapest ones and write them to the file of the tuning
+ * \param[in] name the name of the mapper
+ * \param[in] meshA mesh A of the mapper
+ * \param[in] meshB mesh B of the mapper
+ * \param[in] numThreads number of threads of the trial builds
+ * \param[in,out] iga the settings of the mapper, the tuned parameters replace the configured ones
+ *                 if the tuning is applied
+ ***********/
+static void tuneIGAMortarMapper(const string &name, AbstractMesh *meshA, AbstractMesh *meshB,
+        int numThreads, structMapper::structIGAMortarMapper &iga) {
+    IGAMortarMapperTuning::Parameters configured;
+    configured.maxProjectionDistance = iga.propProjection.maxProjectionDistance;
+    configured.noInitialGuess = iga.propProjection.noInitialGuess;
+    configured.maxProjectionDistanceOnDifferentPatches =
+            iga.propProjection.maxProjectionDistanceOnDifferentPatches;
+    configured.noIterationsNewtonRaphson = iga.propNewtonRaphson.noIterations;
+    configured.tolProjectionNewtonRaphson = iga.propNewtonRaphson.tolProjection;
+    configured.noIterationsNewtonRaphsonBoundary = iga.propNewtonRaphsonBoundary.noIterations;
+    configured.tolProjectionNewtonRaphsonBoundary = iga.propNewtonRaphsonBoundary.tolProjection;
+    configured.noIterationsBisection = iga.propBisection.noIterations;
+    configured.tolProjectionBisection = iga.propBisection.tolProjection;
+    configured.isAutomaticNoGPTriangle = iga.propIntegration.isAutomaticNoGPTriangle;
+    configured.noGPTriangle = iga.propIntegration.noGPTriangle;
+    configured.isAutomaticNoGPQuadrilateral = iga.propIntegration.isAutomaticNoGPQuadrilateral;
+    configured.noGPQuadrilateral = iga.propIntegration.noGPQuadrilateral;
+    configured.isAdaptiveIntegration = iga.propIntegration.isAdaptive;
+    configured.tolAdaptiveIntegration = iga.propIntegration.tolAdaptive;
+
+    IGAMortarMapperTuning tuning(name, meshA, meshB, iga.propTuning.sampleSize,
+            iga.propTuning.targetProjectionSuccessRate, iga.propTuning.targetMappingError,
+            numThreads);
+    IGAMortarMapperTuning::Parameters suggested = tuning.tune(configured);
+    tuning.print(suggested);
+    if (iga.propTuning.file != "") {
+        ofstream out(iga.propTuning.file.c_str());
+        if (!out) {
+            ERROR_OUT() << "Cannot write the tuning of mapper \"" << name << "\" to \""
+                    << iga.propTuning.file << "\"" << endl;
+            exit(EXIT_FAILURE);
+        }
+        out << "<!-- the tuned parameters of the IGAMortarMapper block of mapper \"" << name
+                << "\" -->" << endl;
+        IGAMortarMapperTuning::writeXML(out, suggested);
+        INFO_OUT() << "The tuned parameters of mapper \"" << name << "\" are written to \""
+                << iga.propTuning.file << "\"" << endl;
+    }
+    if (!iga.propTuning.isApplied)
+        return;
+    iga.propProjection.noInitialGuess = suggested.noInitialGuess;
+    iga.propNewtonRaphson.noIterations = suggested.noIterationsNewtonRaphson;
+    iga.propNewtonRaphsonBoundary.noIterations = suggested.noIterationsNewtonRaphsonBoundary;
+    iga.propBisection.noIterations = suggested.noIterationsBisection;
+    iga.propIntegration.noGPTriangle = suggested.noGPTriangle;
+    iga.propIntegration.noGPQuadrilateral = suggested.noGPQuadrilateral;
+}
+
 Emperor::Emperor() {
     globalCouplingLogic = NULL;
+    checkpoint = NULL;
+    mapperBuildSchedule = NULL;
+    isDaemon = false;
+    numSessions = 0;
+    replica = 0;
+    primary = NULL;
+    areMappersShared = false;
+    numReplicasRegistered = 0;
+    pthread_mutex_init(&replicasMutex, NULL);
+    pthread_cond_init(&mappersShared, NULL);
 }
 
 Emperor::~Emperor() {
-    for (map<string, ClientCode*>::iterator it = nameToClientCodeMap.begin();
-            it != nameToClientCodeMap.end(); it++) {
-        delete it->second;
-    }
+    assert(replicas.empty());
+    deleteSessionObjects();
+    deleteKeptMappers();
+    pthread_cond_destroy(&mappersShared);
+    pthread_mutex_destroy(&replicasMutex);
+}
+
+void Emperor::deleteSessionObjects() {
+    // the pending checkpoints are written from copies of the coupling state
+    delete checkpoint;
+    checkpoint = NULL;
+    // data outputs first, their pending steps are written from the meshes of the client codes
     for (map<string, DataOutput*>::iterator it = nameToDataOutputMap.begin();
             it != nameToDataOutputMap.end(); it++) {
         delete it->second;
     }
+    for (int i = 0; i < replicaDataOutputSettings.size(); i++)
+        delete replicaDataOutputSettings[i];
+    replicaDataOutputSettings.clear();
+    for (map<string, ClientCode*>::iterator it = nameToClientCodeMap.begin();
+            it != nameToClientCodeMap.end(); it++) {
+        delete it->second;
+    }
     for (map<string, Connection*>::iterator it = nameToConnetionMap.begin();
             it != nameToConnetionMap.end(); it++) {
         delete it->second;
     }
+    // mappers sharing their operators share the MapperAdapter
+    set<MapperAdapter*> deletedMappers;
     for (map<string, MapperAdapter*>::iterator it = nameToMapperMap.begin();
             it != nameToMapperMap.end(); it++) {
-        delete it->second;
+        if (deletedMappers.insert(it->second).second)
+            delete it->second;
     }
     for (map<string, AbstractCouplingAlgorithm*>::iterator it = nameToCouplingAlgorithmMap.begin();
             it != nameToCouplingAlgorithmMap.end(); it++) {
@@ -97,21 +317,48 @@ Emperor::~Emperor() {
     }
     for (int i = 0; i < couplingLogicVec.size(); i++)
         delete couplingLogicVec[i];
+    nameToDataOutputMap.clear();
+    nameToClientCodeMap.clear();
+    nameToConnetionMap.clear();
+    nameToMapperMap.clear();
+    nameToCouplingAlgorithmMap.clear();
+    nameToExtrapolatorMap.clear();
+    couplingLogicVec.clear();
+    globalCouplingLogic = NULL;
 }
 
 void Emperor::initEnvironment(int *argc, char ***argv) {
     /// Check for command line arguments
-    if (*argc != 2) {
+    if (*argc == 4 && string((*argv)[2]) == "-daemon") {
+        isDaemon = true;
+        sessionsFileName = (*argv)[3];
+    }
+    if (*argc != 2 && !isDaemon) {
         ERROR_BLOCK_OUT("Emperor", "initEnvironment", "Please provide a valid input file.");
     } else {
         /// Generate MetaDatabase in order give it to ServerCommunication::getSingleton()
         MetaDatabase::init((*argv)[1]);
+        // the thread budget of all mappers, filters and outputs
+        AuxiliaryParameters::mapperSetNumThreads = MetaDatabase::getSingleton()->numThreads;
+        AuxiliaryParameters::mklSetNumThreads = MetaDatabase::getSingleton()->mklNumThreads;
+        AuxiliaryParameters::threadPinning = MetaDatabase::getSingleton()->threadPinning;
+        AuxiliaryParameters::numaInterleave = MetaDatabase::getSingleton()->numaInterleave;
+        AuxiliaryParameters::hugePages = MetaDatabase::getSingleton()->hugePages;
+        AuxiliaryParameters::reproducible = MetaDatabase::getSingleton()->reproducible;
+        BufferPool::setMaxPooledBytes(
+                (size_t) MetaDatabase::getSingleton()->bufferPoolMaxMegaBytes * 1024 * 1024);
+#ifdef USE_INTEL_MKL
+        mkl_set_dynamic(0);
+        mkl_set_num_threads(AuxiliaryParameters::mklSetNumThreads);
+#endif
         ServerCommunication::init(argc, argv);
     }
     ASCIIART_BLOCK();
     HEADING_OUT(1, "Emperor", "Emperor version " + AuxiliaryParameters::gitTAG + " started!",
             infoOut);
 
+    if (ServerRanks::getRank() > 0) // the workers only execute the commands of rank 0
+        return;
     PseudoCodeOutput *pcOutput = new PseudoCodeOutput(MetaDatabase::getSingleton(),
             "pseudocode.txt");
     pcOutput->writePseudoCode();
@@ -123,7 +370,42 @@ void Emperor::startServerListening() {
 }
 
 void Emperor::startServerCoupling() {
-    connectAllClients();
+    // the coupling thread runs in a section of main's parallel region, it writes the messages
+    Message::setSinkThread();
+    // the transfers of the clients progress in the background while the coupling thread maps
+    bool progressThread = MetaDatabase::getSingleton()->progressThread;
+    if (progressThread)
+        ServerCommunication::getSingleton()->startProgressThread();
+    runSession();
+    // the daemon keeps the port open and its mappers built for the sessions of the sessions file
+    while (isDaemon) {
+        endSession();
+        if (!startNextSession())
+            break;
+        runSession();
+    }
+    if (progressThread)
+        ServerCommunication::getSingleton()->stopProgressThread();
+    LiveMetrics::stop();
+    disconnectAllClients();
+}
+
+void Emperor::runSession() {
+    Profiler::setEnabled(MetaDatabase::getSingleton()->profiling);
+    if (Profiler::isEnabled()) {
+        Profiler::setCSVFile(MetaDatabase::getSingleton()->profilingCSVFile);
+        Profiler::setTraceFile(MetaDatabase::getSingleton()->profilingTraceFile);
+        Profiler::setHardwareCounters(MetaDatabase::getSingleton()->profilingHardwareCounters,
+                MetaDatabase::getSingleton()->profilingFPOpsEvent,
+                AuxiliaryParameters::mapperSetNumThreads);
+    }
+    BuildProgress::setInterval(MetaDatabase::getSingleton()->buildProgressInterval);
+    BuildProgress::setFile(MetaDatabase::getSingleton()->buildProgressFile);
+    LiveMetrics::start(MetaDatabase::getSingleton()->metricsFile,
+            MetaDatabase::getSingleton()->metricsInterval, MetaDatabase::getSingleton()->metricsPort);
+    ServerCommunication::getSingleton()->startInProcessClients();
+    // the other replicas of an ensemble receive their meshes while the mappers are built
+    startReplicas();
     // Start time stamps
     time_t timeStart, timeEnd;
     // Get start time
@@ -133,7 +415,12 @@ void Emperor::startServerCoupling() {
     // Get start time
     time(&timeStart);
     HEADING_OUT(4, "Emperor", "initClientCodes", infoOut);
-    initClientCodes();
+    {
+        PROFILER_SCOPE("initClientCodes");
+        // the mappers are built on worker threads as soon as their meshes have arrived
+        startMapperBuilds();
+        initClientCodes();
+    }
     time(&timeEnd);
     timeMessage.str(""); /// delete old message
     timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for initClientCodes";
@@ -141,26 +428,38 @@ void Emperor::startServerCoupling() {
 
     // Get start time
     time(&timeStart);
-    HEADING_OUT(4, "Emperor", "initDataOutputs", infoOut);
-    initDataOutputs();
+    HEADING_OUT(4, "Emperor", "initMappers", infoOut);
+    {
+        PROFILER_SCOPE("initMappers");
+        initMappers();
+        shareMappers();
+        sendMappingOperators();
+    }
     time(&timeEnd);
-    timeMessage.str(""); /// delete old message
-    timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for initDataOutputs";
+    timeMessage.str("");
+    timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for initMappers";
     INDENT_OUT(1, timeMessage.str(), infoOut);
 
-    // Get start time
+    // Get start time, the data outputs are created after the mapper builds, since both use the
+    // lazily built triangulations of the meshes
     time(&timeStart);
-    HEADING_OUT(4, "Emperor", "initMappers", infoOut);
-    initMappers();
+    HEADING_OUT(4, "Emperor", "initDataOutputs", infoOut);
+    {
+        PROFILER_SCOPE("initDataOutputs");
+        initDataOutputs();
+    }
     time(&timeEnd);
-    timeMessage.str("");
-    timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for initMappers";
+    timeMessage.str(""); /// delete old message
+    timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for initDataOutputs";
     INDENT_OUT(1, timeMessage.str(), infoOut);
 
     // Get start time
     time(&timeStart);
     HEADING_OUT(4, "Emperor", "initCouplingAlgorithms", infoOut);
-    initCouplingAlgorithms();
+    {
+        PROFILER_SCOPE("initCouplingAlgorithms");
+        initCouplingAlgorithms();
+    }
     time(&timeEnd);
     timeMessage.str("");
     timeMessage << "It took " << difftime(timeEnd, timeStart)
@@ -170,7 +469,10 @@ void Emperor::startServerCoupling() {
     // Get start time
     time(&timeStart);
     HEADING_OUT(4, "Emperor", "initExtrapolators", infoOut);
-    initExtrapolators();
+    {
+        PROFILER_SCOPE("initExtrapolators");
+        initExtrapolators();
+    }
     time(&timeEnd);
     timeMessage.str("");
     timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for initExtrapolators";
@@ -179,7 +481,10 @@ void Emperor::startServerCoupling() {
     // Get start time
     time(&timeStart);
     HEADING_OUT(4, "Emperor", "initConnections", infoOut);
-    initConnections();
+    {
+        PROFILER_SCOPE("initConnections");
+        initConnections();
+    }
     time(&timeEnd);
     timeMessage.str("");
     timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for initConnections";
@@ -188,32 +493,282 @@ void Emperor::startServerCoupling() {
     // Get start time
     time(&timeStart);
     HEADING_OUT(4, "Emperor", "initGlobalCouplingLogic", infoOut);
-    initGlobalCouplingLogic();
+    {
+        PROFILER_SCOPE("initGlobalCouplingLogic");
+        initGlobalCouplingLogic();
+    }
     time(&timeEnd);
     timeMessage.str("");
     timeMessage << "It took " << difftime(timeEnd, timeStart)
             << " seconds for initGlobalCouplingLogic";
     INDENT_OUT(1, timeMessage.str(), infoOut);
 
+    initCheckpoint();
+
     // Get start time
     time(&timeStart);
     HEADING_OUT(4, "Emperor", "doCoSimulation", infoOut);
-    doCoSimulation();
+    {
+        PROFILER_SCOPE("doCoSimulation");
+        doCoSimulation();
+        finishReplica();
+        joinReplicas();
+    }
     time(&timeEnd);
     timeMessage.str("");
     timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for doCoSimulation";
     INDENT_OUT(1, timeMessage.str(), infoOut);
 
-    disconnectAllClients();
+    Profiler::printSummary();
+    Profiler::setTraceFile("");
 }
 
-void Emperor::connectAllClients() {
-    while (1) {
-        if (ServerCommunication::getSingleton()->allClientsConnected()) {
-            INFO_OUT() << "All clients successfully connected!" << endl;
-            break;
+void Emperor::endSession() {
+    ServerCommunication::getSingleton()->endSession();
+    // the mappers not taken over by this session were deleted after its mappers were built
+    assert(keptMappers.empty() && keptMeshes.empty());
+    const vector<structMapper> &settingMapperVec = MetaDatabase::getSingleton()->settingMapperVec;
+    vector<int> sharedMappers;
+    vector<bool> isMirrored;
+    findSharedMappers(sharedMappers, isMirrored);
+    for (int i = 0; i < settingMapperVec.size(); i++) {
+        if (sharedMappers[i] >= 0)
+            continue;
+        KeptMapper keptMapper;
+        keptMapper.mapper = nameToMapperMap.at(settingMapperVec[i].name);
+        keptMapper.settingsKey = getMapperSettingsKey(settingMapperVec[i]);
+        keptMapper.meshA = keepMesh(settingMapperVec[i].meshRefA);
+        keptMapper.meshB = keepMesh(settingMapperVec[i].meshRefB);
+        keptMappers.push_back(keptMapper);
+    }
+    nameToMapperMap.clear();
+    deleteSessionObjects();
+    stringstream message;
+    message << "Session ends, " << keptMappers.size() << " mappers are kept!";
+    HEADING_OUT(1, "Emperor", message.str(), infoOut);
+}
+
+bool Emperor::startNextSession() {
+    INFO_OUT() << "Waiting for the next session in " << sessionsFileName << endl;
+    Message::flush();
+    string inputFileName;
+    while (!readNextSession(inputFileName))
+        sleep(1);
+    if (inputFileName == "exit") {
+        deleteKeptMappers();
+        return false;
+    }
+    // the MetaDatabase is replaced before the port file is written, such that the connecting
+    // clients are checked against the new session
+    MetaDatabase::reinit((char*) (inputFileName.c_str()));
+    ServerCommunication::getSingleton()->beginSession();
+    stringstream message;
+    message << "Session " << numSessions << " started with " << inputFileName;
+    HEADING_OUT(1, "Emperor", message.str(), infoOut);
+    return true;
+}
+
+bool Emperor::readNextSession(std::string &inputFileName) {
+    ifstream sessionsFile(sessionsFileName.c_str());
+    if (!sessionsFile.is_open())
+        return false;
+    int numLines = 0;
+    string line;
+    while (getline(sessionsFile, line)) {
+        // a line without line break may still be written
+        if (sessionsFile.eof())
+            return false;
+        if (line.empty())
+            continue;
+        if (numLines++ == numSessions) {
+            inputFileName = line;
+            numSessions++;
+            return true;
         }
     }
+    return false;
+}
+
+AbstractMesh *Emperor::keepMesh(const structMeshRef &meshRef) {
+    for (int i = 0; i < keptMeshes.size(); i++)
+        if (keptMeshes[i].clientCodeName == meshRef.clientCodeName
+                && keptMeshes[i].meshName == meshRef.meshName)
+            return keptMeshes[i].mesh;
+    KeptMesh keptMesh;
+    keptMesh.clientCodeName = meshRef.clientCodeName;
+    keptMesh.meshName = meshRef.meshName;
+    keptMesh.mesh = nameToClientCodeMap.at(meshRef.clientCodeName)->releaseMesh(meshRef.meshName);
+    // the key is computed again, a mesh moved during the session matches a moved mesh only
+    keptMesh.mesh->updateContentHash();
+    keptMesh.key = keptMesh.mesh->getContentHash();
+    keptMeshes.push_back(keptMesh);
+    return keptMesh.mesh;
+}
+
+AbstractMesh *Emperor::adoptKeptMesh(const std::string &clientCodeName,
+        const std::string &meshName) {
+    ClientCode *clientCode = nameToClientCodeMap.at(clientCodeName);
+    AbstractMesh *mesh = clientCode->getMeshByName(meshName);
+    for (int i = 0; i < keptMeshes.size(); i++) {
+        if (keptMeshes[i].clientCodeName != clientCodeName || keptMeshes[i].meshName != meshName)
+            continue;
+        if (keptMeshes[i].mesh->type != mesh->type || keptMeshes[i].key != mesh->getContentHash())
+            return mesh;
+        mesh = keptMeshes[i].mesh;
+        clientCode->replaceMesh(meshName, mesh);
+        keptMeshes.erase(keptMeshes.begin() + i);
+        INFO_OUT() << "Mesh \"" << clientCodeName << "/" << meshName
+                << "\" is unchanged, the mesh of the last session is used" << endl;
+        return mesh;
+    }
+    return mesh;
+}
+
+MapperAdapter *Emperor::adoptKeptMapper(const structMapper &settingMapper, AbstractMesh *meshA,
+        AbstractMesh *meshB) {
+    if (keptMappers.empty())
+        return NULL;
+    uint64_t settingsKey = getMapperSettingsKey(settingMapper);
+    for (int i = 0; i < keptMappers.size(); i++) {
+        if (keptMappers[i].meshA != meshA || keptMappers[i].meshB != meshB
+                || keptMappers[i].settingsKey != settingsKey)
+            continue;
+        MapperAdapter *mapper = keptMappers[i].mapper;
+        keptMappers.erase(keptMappers.begin() + i);
+        INFO_OUT() << "Mapper \"" << settingMapper.name << "\" is taken over from the last session"
+                << endl;
+        return mapper;
+    }
+    return NULL;
+}
+
+void Emperor::deleteKeptMappers() {
+    for (int i = 0; i < keptMappers.size(); i++)
+        delete keptMappers[i].mapper;
+    keptMappers.clear();
+    for (int i = 0; i < keptMeshes.size(); i++)
+        delete keptMeshes[i].mesh;
+    keptMeshes.clear();
+}
+
+void Emperor::startReplicas() {
+    int ensembleSize = MetaDatabase::getSingleton()->ensembleSize;
+    if (ensembleSize == 1)
+        return;
+    // all Emperors exist before the first thread starts, since the threads count them
+    for (int r = 1; r < ensembleSize; r++) {
+        Emperor *replicaEmperor = new Emperor();
+        replicaEmperor->replica = r;
+        replicaEmperor->primary = this;
+        replicas.push_back(replicaEmperor);
+    }
+    replicaThreads.resize(replicas.size());
+    for (int i = 0; i < replicas.size(); i++)
+        pthread_create(&replicaThreads[i], NULL, &Emperor::runReplicaThread, replicas[i]);
+    INFO_OUT() << "Started " << replicas.size() << " further replicas of the ensemble" << endl;
+}
+
+void Emperor::joinReplicas() {
+    if (replicas.empty())
+        return;
+    for (int i = 0; i < replicas.size(); i++) {
+        pthread_join(replicaThreads[i], NULL);
+        delete replicas[i];
+    }
+    replicas.clear();
+    replicaThreads.clear();
+    // the meshes of the replicas are deleted, the daemon may keep the mappers for another session
+    for (map<string, MapperAdapter*>::iterator it = nameToMapperMap.begin();
+            it != nameToMapperMap.end(); it++)
+        it->second->setEnsemble(1, 0.0);
+    areMappersShared = false;
+    numReplicasRegistered = 0;
+}
+
+void *Emperor::runReplicaThread(void *emperor) {
+    static_cast<Emperor*>(emperor)->runReplica();
+    return NULL;
+}
+
+void Emperor::runReplica() {
+    initClientCodes();
+    shareMappers();
+    sendMappingOperators();
+    initDataOutputs();
+    initCouplingAlgorithms();
+    initExtrapolators();
+    initConnections();
+    initGlobalCouplingLogic();
+    doCoSimulation();
+    finishReplica();
+    INFO_OUT() << "Replica " << replica << " of the ensemble finished" << endl;
+}
+
+void Emperor::shareMappers() {
+    if (primary == NULL) {
+        if (replicas.empty())
+            return;
+        for (map<string, MapperAdapter*>::iterator it = nameToMapperMap.begin();
+                it != nameToMapperMap.end(); it++)
+            it->second->setEnsemble(replicas.size() + 1,
+                    MetaDatabase::getSingleton()->ensembleBatchWindow);
+        pthread_mutex_lock(&replicasMutex);
+        areMappersShared = true;
+        pthread_cond_broadcast(&mappersShared);
+        // the mappers must not be used until all replicas are registered
+        while (numReplicasRegistered < replicas.size())
+            pthread_cond_wait(&mappersShared, &replicasMutex);
+        pthread_mutex_unlock(&replicasMutex);
+        return;
+    }
+    pthread_mutex_lock(&primary->replicasMutex);
+    while (!primary->areMappersShared)
+        pthread_cond_wait(&primary->mappersShared, &primary->replicasMutex);
+    const vector<structMapper> &settingMapperVec = MetaDatabase::getSingleton()->settingMapperVec;
+    vector<int> sharedMappers;
+    vector<bool> isMirrored;
+    findSharedMappers(sharedMappers, isMirrored);
+    for (int i = 0; i < settingMapperVec.size(); i++) {
+        const structMeshRef *meshRefs[2] = { &settingMapperVec[i].meshRefA,
+                &settingMapperVec[i].meshRefB };
+        AbstractMesh *meshes[2];
+        for (int j = 0; j < 2; j++) {
+            meshes[j] = nameToClientCodeMap.at(meshRefs[j]->clientCodeName)->getMeshByName(
+                    meshRefs[j]->meshName);
+            AbstractMesh *primaryMesh = primary->nameToClientCodeMap.at(
+                    meshRefs[j]->clientCodeName)->getMeshByName(meshRefs[j]->meshName);
+            if (meshes[j]->type != primaryMesh->type
+                    || meshes[j]->getContentHash() != primaryMesh->getContentHash()) {
+                ERROR_OUT() << "Mesh \"" << meshRefs[j]->clientCodeName << "/"
+                        << meshRefs[j]->meshName << "\" of replica " << replica
+                        << " differs from the one of replica 0, the replicas of an ensemble "
+                        << "must send identical meshes" << endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        MapperAdapter *mapper = primary->nameToMapperMap.at(settingMapperVec[i].name);
+        if (sharedMappers[i] < 0)
+            mapper->addReplicaMeshes(meshes[0], meshes[1]);
+        nameToMapperMap.insert(pair<string, MapperAdapter*>(settingMapperVec[i].name, mapper));
+    }
+    primary->numReplicasRegistered++;
+    pthread_cond_broadcast(&primary->mappersShared);
+    while (primary->numReplicasRegistered < primary->replicas.size())
+        pthread_cond_wait(&primary->mappersShared, &primary->replicasMutex);
+    pthread_mutex_unlock(&primary->replicasMutex);
+}
+
+void Emperor::finishReplica() {
+    if (primary == NULL && replicas.empty())
+        return;
+    set<MapperAdapter*> finishedMappers;
+    for (map<string, MapperAdapter*>::iterator it = nameToMapperMap.begin();
+            it != nameToMapperMap.end(); it++)
+        if (finishedMappers.insert(it->second).second)
+            it->second->replicaFinished();
+    // the mappers are owned by the first replica
+    if (primary != NULL)
+        nameToMapperMap.clear();
 }
 
 void Emperor::disconnectAllClients() {
@@ -222,77 +777,178 @@ void Emperor::disconnectAllClients() {
 }
 
 void Emperor::initClientCodes() {
-    //set<string> clientNames;
-    //ServerCommunication::getSingleton()->getClientNames(&clientNames);
     const vector<structClientCode> &settingClientCodesVec =
             MetaDatabase::getSingleton()->settingClientCodeVec;
-    for (int i = 0; i < settingClientCodesVec.size(); i++) {
+    const int numClients = settingClientCodesVec.size();
+    // the clients of a replica are connected under the name of the replica
+    map<string, int> unconnectedClients;
+    for (int i = 0; i < numClients; i++) {
         const structClientCode &settingClientCode = settingClientCodesVec[i];
-        string name = settingClientCode.name;
-        //assert(clientNames.find(name)!=clientNames.end());
-        const vector<structClientCode::structMesh> &settingMeshes = settingClientCode.meshes;
-        const vector<structClientCode::structSignal> &settingSignals = settingClientCode.signals;
-        const vector<std::string> &initialDataFields = settingClientCode.initialDataFields;
-
-        ClientCode *clientCode = new ClientCode(name);
-        nameToClientCodeMap.insert(pair<string, ClientCode*>(name, clientCode));
+        ClientCode *clientCode = new ClientCode(
+                ServerCommunication::getReplicaName(settingClientCode.name, replica));
+        nameToClientCodeMap.insert(pair<string, ClientCode*>(settingClientCode.name, clientCode));
         clientCode->setServerCommunication(ServerCommunication::getSingleton());
-        for (int j = 0; j < settingMeshes.size(); j++) {
-            const structClientCode::structMesh &settingMesh = settingMeshes[j];
-            if (settingMesh.type == EMPIRE_Mesh_FEMesh) {
-                clientCode->recvFEMesh(settingMesh.name, settingMesh.triangulateAll);
-            } else if (settingMesh.type == EMPIRE_Mesh_IGAMesh) {
-                clientCode->recvIGAMesh(settingMesh.name);
-            } else if (settingMesh.type == EMPIRE_Mesh_SectionMesh) {
-                clientCode->recvSectionMesh(settingMesh.name, settingMesh.triangulateAll);
-            } else if (settingMesh.type == EMPIRE_Mesh_copyFEMesh) {
-                ClientCode *clientToCopyFrom = nameToClientCodeMap[settingMesh.clientNameToCopyFrom];
-                AbstractMesh *meshToCopyFrom = clientToCopyFrom->getMeshByName(
-                        settingMesh.meshNameToCopyFrom);
-                clientCode->copyMesh(settingMesh.name, meshToCopyFrom);
-                if (settingMesh.sendMeshToClient) {
-                    clientCode->sendMesh(settingMesh.name);
-                } else {
-                    INFO_OUT() << "FEMesh copied but not sent" << endl;
-                }
-            } else if (settingMesh.type == EMPIRE_Mesh_copyIGAMesh) {
-                ClientCode *clientToCopyFrom = nameToClientCodeMap[settingMesh.clientNameToCopyFrom];
-                AbstractMesh *meshToCopyFrom = clientToCopyFrom->getMeshByName(
-                        settingMesh.meshNameToCopyFrom);
-                clientCode->copyMesh(settingMesh.name, meshToCopyFrom);
-                if (settingMesh.sendMeshToClient) {
-                    assert(false);
-                    clientCode->sendMesh(settingMesh.name);
-                } else {
-                    INFO_OUT() << "IGAMesh copied but not sent" << endl;
-                }
+        clientCode->setPersistentDataFieldTransfer(
+                MetaDatabase::getSingleton()->persistentDataFieldTransfer);
+        clientCode->setSharedMemoryDataFieldTransfer(
+                MetaDatabase::getSingleton()->sharedMemoryDataFieldTransfer);
+        clientCode->setPiggybackConvergenceSignal(
+                MetaDatabase::getSingleton()->piggybackConvergenceSignal);
+        unconnectedClients[clientCode->getName()] = i;
+    }
+    // The clients are served in the order in which they connect. The first meshes of all connected
+    // clients are in flight at once, the others are received one client after the other, while
+    // the remaining clients are still connecting. A client copying meshes of other clients waits
+    // for them
+    vector<int> startedClients;
+    vector<bool> isReceived(numClients, false);
+    int numReceived = 0;
+    while (numReceived < numClients) {
+        int next = -1;
+        for (int i = 0; i < startedClients.size() && next < 0; i++)
+            if (!isReceived[startedClients[i]]
+                    && areMeshesToCopyReceived(startedClients[i], isReceived))
+                next = startedClients[i];
+        // start the clients connected by now, wait only if no started client can be received
+        set<string> names;
+        for (map<string, int>::iterator it = unconnectedClients.begin();
+                it != unconnectedClients.end(); it++)
+            names.insert(it->first);
+        string connected = names.empty() ? "" :
+                ServerCommunication::getSingleton()->waitForClientConnection(names, next < 0);
+        if (!connected.empty()) {
+            startedClients.push_back(unconnectedClients[connected]);
+            unconnectedClients.erase(connected);
+            startClientCode(startedClients.back());
+            if (unconnectedClients.empty())
+                INFO_OUT() << "All clients successfully connected!" << endl;
+            continue;
+        }
+        assert(next >= 0); // otherwise the clients copy meshes from each other
+        recvClientCode(next);
+        isReceived[next] = true;
+        numReceived++;
+    }
+}
+
+void Emperor::startClientCode(int clientIndex) {
+    const structClientCode &settingClientCode =
+            MetaDatabase::getSingleton()->settingClientCodeVec[clientIndex];
+    ClientCode *clientCode = nameToClientCodeMap[settingClientCode.name];
+    if (!settingClientCode.meshes.empty()
+            && settingClientCode.meshes[0].type == EMPIRE_Mesh_FEMesh)
+        clientCode->startRecvFEMesh(settingClientCode.meshes[0].name,
+                settingClientCode.meshes[0].triangulateAll,
+                settingClientCode.meshes[0].renumbering,
+                settingClientCode.meshes[0].partitioned);
+}
+
+bool Emperor::areMeshesToCopyReceived(int clientIndex, const vector<bool> &isReceived) const {
+    const vector<structClientCode> &settingClientCodesVec =
+            MetaDatabase::getSingleton()->settingClientCodeVec;
+    const vector<structClientCode::structMesh> &settingMeshes =
+            settingClientCodesVec[clientIndex].meshes;
+    for (int j = 0; j < settingMeshes.size(); j++) {
+        if (settingMeshes[j].type != EMPIRE_Mesh_copyFEMesh
+                && settingMeshes[j].type != EMPIRE_Mesh_copyIGAMesh)
+            continue;
+        for (int i = 0; i < settingClientCodesVec.size(); i++)
+            if (i != clientIndex && settingClientCodesVec[i].name
+                    == settingMeshes[j].clientNameToCopyFrom && !isReceived[i])
+                return false;
+    }
+    return true;
+}
+
+void Emperor::recvClientCode(int clientIndex) {
+    const structClientCode &settingClientCode =
+            MetaDatabase::getSingleton()->settingClientCodeVec[clientIndex];
+    string name = settingClientCode.name;
+    const vector<structClientCode::structMesh> &settingMeshes = settingClientCode.meshes;
+    const vector<structClientCode::structSignal> &settingSignals = settingClientCode.signals;
+    const vector<std::string> &initialDataFields = settingClientCode.initialDataFields;
+
+    ClientCode *clientCode = nameToClientCodeMap[name];
+    for (int j = 0; j < settingMeshes.size(); j++) {
+        const structClientCode::structMesh &settingMesh = settingMeshes[j];
+        if (settingMesh.type == EMPIRE_Mesh_FEMesh && j == 0) {
+            clientCode->finishRecvFEMesh(settingMesh.name);
+        } else if (settingMesh.type == EMPIRE_Mesh_FEMesh) {
+            clientCode->recvFEMesh(settingMesh.name, settingMesh.triangulateAll,
+                    settingMesh.renumbering, settingMesh.partitioned);
+        } else if (settingMesh.type == EMPIRE_Mesh_IGAMesh) {
+            clientCode->recvIGAMesh(settingMesh.name, settingMesh.conditionGPDataCache,
+                    settingMesh.trimmingLinearizationType);
+        } else if (settingMesh.type == EMPIRE_Mesh_SectionMesh) {
+            clientCode->recvSectionMesh(settingMesh.name, settingMesh.triangulateAll);
+        } else if (settingMesh.type == EMPIRE_Mesh_copyFEMesh) {
+            ClientCode *clientToCopyFrom = nameToClientCodeMap[settingMesh.clientNameToCopyFrom];
+            AbstractMesh *meshToCopyFrom = clientToCopyFrom->getMeshByName(
+                    settingMesh.meshNameToCopyFrom);
+            clientCode->copyMesh(settingMesh.name, meshToCopyFrom);
+            if (settingMesh.sendMeshToClient) {
+                clientCode->sendMesh(settingMesh.name);
             } else {
-                assert(false);
+                INFO_OUT() << "FEMesh copied but not sent" << endl;
             }
-            const vector<structClientCode::structMesh::structDataField> &settingDataFields =
-                    settingMesh.dataFields;
-            AbstractMesh *mesh = clientCode->getMeshByName(settingMesh.name);
-            for (int k = 0; k < settingDataFields.size(); k++) {
-                const structClientCode::structMesh::structDataField &settingDataField =
-                        settingDataFields[k];
-                mesh->addDataField(settingDataFields[k].name, settingDataFields[k].location,
-                        settingDataFields[k].dimension, settingDataFields[k].typeOfQuantity);
+        } else if (settingMesh.type == EMPIRE_Mesh_copyIGAMesh) {
+            ClientCode *clientToCopyFrom = nameToClientCodeMap[settingMesh.clientNameToCopyFrom];
+            AbstractMesh *meshToCopyFrom = clientToCopyFrom->getMeshByName(
+                    settingMesh.meshNameToCopyFrom);
+            clientCode->copyMesh(settingMesh.name, meshToCopyFrom);
+            if (settingMesh.sendMeshToClient) {
+                assert(false);
+                clientCode->sendMesh(settingMesh.name);
+            } else {
+                INFO_OUT() << "IGAMesh copied but not sent" << endl;
             }
+        } else {
+            assert(false);
+        }
+        const vector<structClientCode::structMesh::structDataField> &settingDataFields =
+                settingMesh.dataFields;
+        AbstractMesh *mesh = clientCode->getMeshByName(settingMesh.name);
+        for (int k = 0; k < settingDataFields.size(); k++) {
+            const structClientCode::structMesh::structDataField &settingDataField =
+                    settingDataFields[k];
+            mesh->addDataField(settingDataFields[k].name, settingDataFields[k].location,
+                    settingDataFields[k].dimension, settingDataFields[k].typeOfQuantity);
+        }
 
-            // Receiving the initial values of the data fields specified. // Aditya
-            for (int k = 0; k < initialDataFields.size(); k++) {
-            	clientCode->recvDataField(settingMesh.name, initialDataFields.at(k));
+        // The wire formats, chunk sizes and skipping of unchanged values are given by the
+        // connections, but are needed by all transfers
+        const vector<structConnection> &settingConnectionVec =
+                MetaDatabase::getSingleton()->settingConnectionVec;
+        for (int k = 0; k < settingConnectionVec.size(); k++) {
+            vector<structConnectionIO> ios = settingConnectionVec[k].inputs;
+            ios.insert(ios.end(), settingConnectionVec[k].outputs.begin(),
+                    settingConnectionVec[k].outputs.end());
+            for (int l = 0; l < ios.size(); l++) {
+                const structDataFieldRef &ref = ios[l].dataFieldRef;
+                if (ios[l].type == EMPIRE_ConnectionIO_DataField && ref.clientCodeName == name
+                        && ref.meshName == settingMesh.name) {
+                    clientCode->setDataFieldWireFormat(ref.meshName, ref.dataFieldName,
+                            ref.wireFormat);
+                    clientCode->setDataFieldChunkSize(ref.meshName, ref.dataFieldName,
+                            ref.chunkSize);
+                    clientCode->setDataFieldSkipUnchanged(ref.meshName, ref.dataFieldName,
+                            ref.skipUnchanged);
+                }
             }
         }
 
-
-        for (int j = 0; j < settingSignals.size(); j++) {
-            const structClientCode::structSignal &settingSignal = settingSignals[j];
-            clientCode->addSignal(settingSignal.name, settingSignal.size3D[0],
-                    settingSignal.size3D[1], settingSignal.size3D[2]);
+        // Receiving the initial values of the data fields specified. // Aditya
+        for (int k = 0; k < initialDataFields.size(); k++) {
+        	clientCode->recvDataField(settingMesh.name, initialDataFields.at(k));
         }
-//        nameToClientCodeMap.insert(pair<string, ClientCode*>(name, clientCode));
+        meshArrived(name, settingMesh.name);
+    }
 
+
+    for (int j = 0; j < settingSignals.size(); j++) {
+        const structClientCode::structSignal &settingSignal = settingSignals[j];
+        clientCode->addSignal(settingSignal.name, settingSignal.size3D[0],
+                settingSignal.size3D[1], settingSignal.size3D[2]);
     }
 }
 
@@ -301,97 +957,549 @@ void Emperor::initDataOutputs() {
             MetaDatabase::getSingleton()->settingDataOutputVec;
     int numDataOutputs = settingDataOutputVec.size();
     for (int i = 0; i < numDataOutputs; i++) {
-        DataOutput *dataOutput = new DataOutput(settingDataOutputVec[i], nameToClientCodeMap);
+        const structDataOutput *settingDataOutput = &settingDataOutputVec[i];
+        if (replica > 0) { // the files of a replica are named after it
+            structDataOutput *replicaSetting = new structDataOutput(settingDataOutputVec[i]);
+            stringstream replicaName;
+            replicaName << replicaSetting->name << "_replica" << replica;
+            replicaSetting->name = replicaName.str();
+            replicaDataOutputSettings.push_back(replicaSetting);
+            settingDataOutput = replicaSetting;
+        }
+        DataOutput *dataOutput = new DataOutput(*settingDataOutput, nameToClientCodeMap);
         nameToDataOutputMap.insert(
                 pair<string, DataOutput*>(settingDataOutputVec[i].name, dataOutput));
     }
 }
 
+/***********************************************************************************************
+ * \brief Find the directions the mapping filters of all connections use a mapper in, a filter with
+ *        its input on mesh A maps consistently, one with its input on mesh B conservatively
+ * \param[in] settingMapper the settings of the mapper
+ * \param[out] consistent whether a filter maps consistently
+ * \param[out] conservative whether a filter maps conservatively
+ ***********/
+static void findMappingDirections(const structMapper &settingMapper, bool &consistent,
+        bool &conservative) {
+    consistent = false;
+    conservative = false;
+    const vector<structConnection> &settingConnectionVec =
+            MetaDatabase::getSingleton()->settingConnectionVec;
+    for (int i = 0; i < settingConnectionVec.size(); i++) {
+        const vector<structFilter> &filterSequence = settingConnectionVec[i].filterSequence;
+        for (int j = 0; j < filterSequence.size(); j++) {
+            const structFilter &settingFilter = filterSequence[j];
+            if (settingFilter.type != EMPIRE_MappingFilter
+                    || settingFilter.mappingFilter.mapperName != settingMapper.name)
+                continue;
+            for (int k = 0; k < settingFilter.inputs.size(); k++) {
+                const structDataFieldRef &input = settingFilter.inputs[k].dataFieldRef;
+                if (input.clientCodeName == settingMapper.meshRefA.clientCodeName
+                        && input.meshName == settingMapper.meshRefA.meshName)
+                    consistent = true;
+                else if (input.clientCodeName == settingMapper.meshRefB.clientCodeName
+                        && input.meshName == settingMapper.meshRefB.meshName)
+                    conservative = true;
+            }
+        }
+    }
+}
+
+/***********************************************************************************************
+ * \brief Find the root of the group of a mapper, the groups are merged by pointing a root to another
+ ***********/
+static int findMapperGroup(vector<int> &groupParent, int i) {
+    while (groupParent[i] != i) {
+        groupParent[i] = groupParent[groupParent[i]];
+        i = groupParent[i];
+    }
+    return i;
+}
+
+/***********************************************************************************************
+ * \brief Get the key of a mesh in the MapperBuildSchedule
+ ***********/
+static string getMeshKey(const structMeshRef &meshRef) {
+    return meshRef.clientCodeName + "/" + meshRef.meshName;
+}
+
+/***********************************************************************************************
+ * \brief Find the mappers which use the operators of an earlier mapper instead of being built.
+ *        A mapper with the same meshes and settings as an earlier one is equivalent to it. A
+ *        mapper with mesh A and mesh B swapped is its mirror if both opt in by shareMirrored,
+ *        it maps consistently by the conservative operator of the earlier one, i.e. by the
+ *        transpose, and vice versa.
+ * \param[out] sharedMappers for every mapper the mapper whose operators it uses, -1 if it is
+ *             built itself
+ * \param[out] isMirrored for every mapper whether it is the mirror of the mapper it shares
+ ***********/
+static void findSharedMappers(vector<int> &sharedMappers, vector<bool> &isMirrored) {
+    const vector<structMapper> &settingMapperVec = MetaDatabase::getSingleton()->settingMapperVec;
+    int numMappers = settingMapperVec.size();
+    sharedMappers.assign(numMappers, -1);
+    isMirrored.assign(numMappers, false);
+    for (int i = 0; i < numMappers; i++) {
+        const structMapper &mapperI = settingMapperVec[i];
+        for (int j = 0; j < i; j++) {
+            const structMapper &mapperJ = settingMapperVec[j];
+            if (mapperJ.type != mapperI.type
+                    || mapperJ.conservationMonitorInterval != mapperI.conservationMonitorInterval
+                    || mapperJ.conservationMonitorTolerance != mapperI.conservationMonitorTolerance
+                    || mapperJ.buildStatisticsReport != mapperI.buildStatisticsReport)
+                continue;
+            bool isSame = getMeshKey(mapperJ.meshRefA) == getMeshKey(mapperI.meshRefA)
+                    && getMeshKey(mapperJ.meshRefB) == getMeshKey(mapperI.meshRefB);
+            // the operator sent to a client is the one from mesh A to mesh B
+            bool isMirror = getMeshKey(mapperJ.meshRefA) == getMeshKey(mapperI.meshRefB)
+                    && getMeshKey(mapperJ.meshRefB) == getMeshKey(mapperI.meshRefA)
+                    && mapperI.shareMirrored && mapperJ.shareMirrored
+                    && mapperI.operatorReceivers.empty() && mapperJ.operatorReceivers.empty();
+            if (!isSame && !isMirror)
+                continue;
+            if (getMapperSettingsKey(mapperI, false, isMirror)
+                    != getMapperSettingsKey(mapperJ, false, false))
+                continue;
+            // a chain of shares ends at the mapper which is built
+            sharedMappers[i] = j;
+            isMirrored[i] = isMirror;
+            if (sharedMappers[j] >= 0) {
+                sharedMappers[i] = sharedMappers[j];
+                isMirrored[i] = (isMirror != isMirrored[j]);
+            }
+            break;
+        }
+    }
+}
+
+/***********************************************************************************************
+ * \brief Find the directions the operators of a mapper are built for, i.e. the directions of its
+ *        own filters and of the filters of the mappers sharing its operators
+ * \param[in] settingMapper the settings of the mapper
+ * \param[out] consistent whether the consistent operator is needed
+ * \param[out] conservative whether the conservative operator is needed
+ ***********/
+static void findBuiltMappingDirections(const structMapper &settingMapper, bool &consistent,
+        bool &conservative) {
+    const vector<structMapper> &settingMapperVec = MetaDatabase::getSingleton()->settingMapperVec;
+    vector<int> sharedMappers;
+    vector<bool> isMirrored;
+    findSharedMappers(sharedMappers, isMirrored);
+    int index = -1;
+    for (int i = 0; i < settingMapperVec.size(); i++)
+        if (settingMapperVec[i].name == settingMapper.name)
+            index = i;
+    consistent = false;
+    conservative = false;
+    for (int i = 0; i < settingMapperVec.size(); i++) {
+        if (i != index && sharedMappers[i] != index)
+            continue;
+        bool consistentI, conservativeI;
+        findMappingDirections(settingMapperVec[i], consistentI, conservativeI);
+        if (isMirrored[i])
+            swap(consistentI, conservativeI);
+        consistent = consistent || consistentI;
+        conservative = conservative || conservativeI;
+    }
+}
+
+/***********************************************************************************************
+ * \brief Check whether the node coordinates of a mesh are the input of a connection, i.e. the
+ *        mesh is moved by its client code
+ ***********/
+static bool isMeshCoordinatesInput(const structMeshRef &meshRef) {
+    const vector<structConnection> &settingConnectionVec =
+            MetaDatabase::getSingleton()->settingConnectionVec;
+    for (int i = 0; i < settingConnectionVec.size(); i++) {
+        const vector<structConnectionIO> &inputs = settingConnectionVec[i].inputs;
+        for (int j = 0; j < inputs.size(); j++)
+            if (inputs[j].type == EMPIRE_ConnectionIO_MeshCoordinates
+                    && getMeshKey(inputs[j].meshRef) == getMeshKey(meshRef))
+                return true;
+    }
+    return false;
+}
+
+/********//**
+ * \brief Struct MapperBuildSchedule holds the mappers waiting for their meshes while the meshes are
+ *        received and the results of the builds
+ ***********/
+struct MapperBuildSchedule {
+    /// the mappers of every group, mappers sharing a mesh are in one group and built one after another
+    vector<vector<int> > groups;
+    /// for every group the number of its meshes which have not arrived yet
+    vector<int> numMissingMeshes;
+    /// for every mesh the groups using it
+    map<string, vector<int> > meshToGroups;
+    /// the meshes which have arrived
+    set<string> arrivedMeshes;
+    /// mesh A of every mapper, set when it has arrived
+    vector<AbstractMesh*> meshesA;
+    /// mesh B of every mapper, set when it has arrived
+    vector<AbstractMesh*> meshesB;
+    /// the number of threads of every build
+    int numThreadsPerMapper;
+    /// the number of MKL threads of every build
+    int numMklThreadsPerMapper;
+    /// executes the builds of the groups
+    TaskPool *pool;
+    /// the mappers
+    vector<MapperAdapter*> mappers;
+    /// for every mapper the earlier mapper whose operators it uses, -1 if it is built itself
+    vector<int> sharedMappers;
+    /// for every mapper whether it is the mirror of the mapper it shares
+    vector<bool> isMirrored;
+    /// the build time of every mapper
+    vector<double> buildTimes;
+};
+
+/********//**
+ * \brief Class Emperor::MapperBuildTask builds the mappers of a group one after another
+ ***********/
+class Emperor::MapperBuildTask: public AbstractTask {
+public:
+    MapperBuildTask(Emperor *_emperor, int _group) :
+            emperor(_emperor), group(_group) {
+    }
+    void execute() {
+        MapperBuildSchedule *schedule = emperor->mapperBuildSchedule;
+        const vector<structMapper> &settingMapperVec =
+                MetaDatabase::getSingleton()->settingMapperVec;
+#ifdef USE_INTEL_MKL
+        mkl_set_num_threads_local(schedule->numMklThreadsPerMapper);
+#endif
+        for (int k = 0; k < schedule->groups[group].size(); k++) {
+            int i = schedule->groups[group][k];
+            // the shared mapper has the same meshes, it is in this group and built before
+            if (schedule->sharedMappers[i] >= 0) {
+                schedule->mappers[i] = schedule->mappers[schedule->sharedMappers[i]];
+                continue;
+            }
+            if (schedule->mappers[i] != NULL) // taken over from the last session of the daemon
+                continue;
+            double startTime = omp_get_wtime();
+            schedule->mappers[i] = emperor->initMapper(settingMapperVec[i], schedule->meshesA[i],
+                    schedule->meshesB[i], schedule->numThreadsPerMapper);
+            schedule->buildTimes[i] = omp_get_wtime() - startTime;
+        }
+    }
+private:
+    /// the Emperor holding the schedule
+    Emperor *emperor;
+    /// the group of mappers
+    int group;
+};
+
+void Emperor::startMapperBuilds() {
+    assert(mapperBuildSchedule == NULL);
+    const vector<structMapper> &settingMapperVec = MetaDatabase::getSingleton()->settingMapperVec;
+    int numMappers = settingMapperVec.size();
+    MapperBuildSchedule *schedule = new MapperBuildSchedule;
+
+    // Mappers sharing a mesh share its spatial index and triangulation, which are built lazily.
+    // They are put into one group and built one after another, the groups are built concurrently.
+    vector<int> groupParent(numMappers);
+    map<string, int> meshToMapper;
+    for (int i = 0; i < numMappers; i++) {
+        groupParent[i] = i;
+        string meshKeys[2] = { getMeshKey(settingMapperVec[i].meshRefA), getMeshKey(
+                settingMapperVec[i].meshRefB) };
+        for (int j = 0; j < 2; j++) {
+            map<string, int>::iterator it = meshToMapper.find(meshKeys[j]);
+            if (it == meshToMapper.end())
+                meshToMapper.insert(pair<string, int>(meshKeys[j], i));
+            else
+                groupParent[findMapperGroup(groupParent, i)] = findMapperGroup(groupParent, it->second);
+        }
+    }
+    // Mappers of the same type caching into the same directory are built one after another, so that a
+    // mapper with the same meshes and parameters as an earlier one, e.g. of another design of an
+    // optimization loop with concurrent designs, reads its coupling matrices instead of building them
+    for (int i = 0; i < numMappers; i++) {
+        if (settingMapperVec[i].couplingMatricesCache.empty())
+            continue;
+        for (int j = 0; j < i; j++) {
+            if (settingMapperVec[j].type == settingMapperVec[i].type
+                    && settingMapperVec[j].couplingMatricesCache == settingMapperVec[i].couplingMatricesCache) {
+                groupParent[findMapperGroup(groupParent, i)] = findMapperGroup(groupParent, j);
+                break;
+            }
+        }
+    }
+    map<int, int> rootToGroup;
+    for (int i = 0; i < numMappers; i++) {
+        int root = findMapperGroup(groupParent, i);
+        if (rootToGroup.find(root) == rootToGroup.end()) {
+            rootToGroup.insert(pair<int, int>(root, schedule->groups.size()));
+            schedule->groups.push_back(vector<int>());
+        }
+        schedule->groups[rootToGroup[root]].push_back(i);
+    }
+    int numGroups = schedule->groups.size();
+    schedule->numMissingMeshes.assign(numGroups, 0);
+    for (int g = 0; g < numGroups; g++) {
+        set<string> groupMeshes;
+        for (int k = 0; k < schedule->groups[g].size(); k++) {
+            groupMeshes.insert(getMeshKey(settingMapperVec[schedule->groups[g][k]].meshRefA));
+            groupMeshes.insert(getMeshKey(settingMapperVec[schedule->groups[g][k]].meshRefB));
+        }
+        for (set<string>::iterator it = groupMeshes.begin(); it != groupMeshes.end(); it++)
+            schedule->meshToGroups[*it].push_back(g);
+        schedule->numMissingMeshes[g] = groupMeshes.size();
+    }
+    schedule->meshesA.assign(numMappers, (AbstractMesh*) NULL);
+    schedule->meshesB.assign(numMappers, (AbstractMesh*) NULL);
+    schedule->mappers.assign(numMappers, (MapperAdapter*) NULL);
+    schedule->buildTimes.assign(numMappers, 0.0);
+    findSharedMappers(schedule->sharedMappers, schedule->isMirrored);
+
+    // The thread budgets of the mappers and of MKL are split evenly between the concurrent builds. Since every
+    // mapper gets the same number of threads, the static thread numbers of the mapper classes set by
+    // the MapperAdapter are the same for all builds. The builds run on worker threads, such that
+    // the coupling thread goes on receiving the meshes.
+    int numConcurrentBuilds = min(numGroups, AuxiliaryParameters::mapperSetNumThreads);
+    if (numConcurrentBuilds < 1)
+        numConcurrentBuilds = 1;
+    schedule->numThreadsPerMapper = max(1,
+            AuxiliaryParameters::mapperSetNumThreads / numConcurrentBuilds);
+    schedule->numMklThreadsPerMapper = max(1,
+            AuxiliaryParameters::mklSetNumThreads / numConcurrentBuilds);
+    schedule->pool = new TaskPool(numConcurrentBuilds,
+            AuxiliaryParameters::threadPinning ? schedule->numThreadsPerMapper : 0);
+    if (numGroups > 0) {
+        INFO_OUT() << "Building " << numGroups << " groups of independent mappers as soon as their "
+                << "meshes have arrived, " << numConcurrentBuilds << " at a time with "
+                << schedule->numThreadsPerMapper << " threads each" << endl;
+    }
+    mapperBuildSchedule = schedule;
+}
+
+void Emperor::meshArrived(const std::string &clientCodeName, const std::string &meshName) {
+    MapperBuildSchedule *schedule = mapperBuildSchedule;
+    if (schedule == NULL)
+        return;
+    string meshKey = clientCodeName + "/" + meshName;
+    map<string, vector<int> >::const_iterator it = schedule->meshToGroups.find(meshKey);
+    if (it == schedule->meshToGroups.end() || !schedule->arrivedMeshes.insert(meshKey).second)
+        return;
+    // the mesh is looked up here, the map of the meshes of the client is still growing
+    assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
+    AbstractMesh *mesh = adoptKeptMesh(clientCodeName, meshName);
+    const vector<structMapper> &settingMapperVec = MetaDatabase::getSingleton()->settingMapperVec;
+    for (int l = 0; l < it->second.size(); l++) {
+        int g = it->second[l];
+        for (int k = 0; k < schedule->groups[g].size(); k++) {
+            int i = schedule->groups[g][k];
+            if (getMeshKey(settingMapperVec[i].meshRefA) == meshKey)
+                schedule->meshesA[i] = mesh;
+            if (getMeshKey(settingMapperVec[i].meshRefB) == meshKey)
+                schedule->meshesB[i] = mesh;
+        }
+        if (--schedule->numMissingMeshes[g] != 0)
+            continue;
+        for (int k = 0; k < schedule->groups[g].size(); k++) {
+            int i = schedule->groups[g][k];
+            if (schedule->sharedMappers[i] >= 0)
+                continue;
+            schedule->mappers[i] = adoptKeptMapper(settingMapperVec[i], schedule->meshesA[i],
+                    schedule->meshesB[i]);
+        }
+        schedule->pool->push(new MapperBuildTask(this, g));
+    }
+}
+
 void Emperor::initMappers() {
     const vector<structMapper> &settingMapperVec = MetaDatabase::getSingleton()->settingMapperVec;
     int numMappers = settingMapperVec.size();
+    if (mapperBuildSchedule == NULL)
+        startMapperBuilds();
+    // the builds of the mappers whose meshes have not been announced by initClientCodes start now
+    for (int i = 0; i < numMappers; i++) {
+        meshArrived(settingMapperVec[i].meshRefA.clientCodeName, settingMapperVec[i].meshRefA.meshName);
+        meshArrived(settingMapperVec[i].meshRefB.clientCodeName, settingMapperVec[i].meshRefB.meshName);
+    }
+    MapperBuildSchedule *schedule = mapperBuildSchedule;
+    schedule->pool->wait();
+    delete schedule->pool;
+
     for (int i = 0; i < numMappers; i++) {
+        assert(schedule->mappers[i] != NULL);
+        nameToMapperMap.insert(
+                pair<string, MapperAdapter*>(settingMapperVec[i].name, schedule->mappers[i]));
+        int shared = schedule->sharedMappers[i];
+        if (shared >= 0)
+            INFO_OUT() << "Mapper \"" << settingMapperVec[i].name << "\" uses the operators of "
+                    << (schedule->isMirrored[i] ? "its mirror " : "the equivalent mapper ") << "\""
+                    << settingMapperVec[shared].name << "\"" << endl;
+        else
+            INFO_OUT() << "Mapper \"" << settingMapperVec[i].name << "\" built in "
+                    << schedule->buildTimes[i] << " s" << endl;
+    }
+    delete schedule;
+    mapperBuildSchedule = NULL;
+    // the mappers of the last session of the daemon which have not been taken over
+    deleteKeptMappers();
+
+    // the meshes are logged after all mappers are built, since the mappers share their spatial indices
+    set<AbstractMesh*> loggedMeshes;
+    for (int i = 0; i < numMappers; i++) {
+        const structMeshRef *meshRefs[2] = { &settingMapperVec[i].meshRefA,
+                &settingMapperVec[i].meshRefB };
+        for (int j = 0; j < 2; j++) {
+            AbstractMesh *mesh = nameToClientCodeMap.at(meshRefs[j]->clientCodeName)->getMeshByName(
+                    meshRefs[j]->meshName);
+            if (loggedMeshes.insert(mesh).second)
+                mesh->getMemoryUsage().print("mesh \"" + meshRefs[j]->clientCodeName + "/"
+                        + meshRefs[j]->meshName + "\"");
+        }
+    }
+}
+
+void Emperor::sendMappingOperators() {
+    const vector<structMapper> &settingMapperVec = MetaDatabase::getSingleton()->settingMapperVec;
+    for (int i = 0; i < settingMapperVec.size(); i++) {
         const structMapper &settingMapper = settingMapperVec[i];
-        string name = settingMapper.name;
-        const structMeshRef &meshRefA = settingMapper.meshRefA;
-        const structMeshRef &meshRefB = settingMapper.meshRefB;
-
-        assert(nameToClientCodeMap.find(meshRefA.clientCodeName) != nameToClientCodeMap.end());
-        assert(nameToClientCodeMap.find(meshRefB.clientCodeName) != nameToClientCodeMap.end());
-        AbstractMesh *meshA = nameToClientCodeMap.at(meshRefA.clientCodeName)->getMeshByName(
-                meshRefA.meshName);
-        AbstractMesh *meshB = nameToClientCodeMap.at(meshRefB.clientCodeName)->getMeshByName(
-                meshRefB.meshName);
-
-        MapperAdapter *mapper = new MapperAdapter(name, meshA, meshB);
-        mapper->setWriteMode(settingMapper.writeMode);
-        if (settingMapper.type == EMPIRE_MortarMapper) {
-            mapper->initMortarMapper(settingMapper.mortarMapper.oppositeSurfaceNormal,
-                    settingMapper.mortarMapper.dual, settingMapper.mortarMapper.enforceConsistency);
-        } else if (settingMapper.type == EMPIRE_NearestNeighborMapper) {
-            mapper->initNearestNeighborMapper();
-        } else if (settingMapper.type == EMPIRE_BarycentricInterpolationMapper) {
-            mapper->initBarycentricInterpolationMapper();
-        } else if (settingMapper.type == EMPIRE_NearestElementMapper) {
-            mapper->initNearestElementMapper();
-        } else if (settingMapper.type == EMPIRE_IGAMortarMapper) {
-            mapper->initIGAMortarMapper(
-                    settingMapper.IGAMortarMapper.propConsistency.enforceConsistency,
-                    settingMapper.IGAMortarMapper.propConsistency.tolConsistency,
-                    settingMapper.IGAMortarMapper.propProjection.maxProjectionDistance,
-                    settingMapper.IGAMortarMapper.propProjection.noInitialGuess,
-                    settingMapper.IGAMortarMapper.propProjection.maxProjectionDistanceOnDifferentPatches,
-                    settingMapper.IGAMortarMapper.propNewtonRaphson.noIterations,
-                    settingMapper.IGAMortarMapper.propNewtonRaphson.tolProjection,
-                    settingMapper.IGAMortarMapper.propNewtonRaphsonBoundary.noIterations,
-                    settingMapper.IGAMortarMapper.propNewtonRaphsonBoundary.tolProjection,
-                    settingMapper.IGAMortarMapper.propBisection.noIterations,
-                    settingMapper.IGAMortarMapper.propBisection.tolProjection,
-                    settingMapper.IGAMortarMapper.propIntegration.isAutomaticNoGPTriangle,
-                    settingMapper.IGAMortarMapper.propIntegration.noGPTriangle,
-                    settingMapper.IGAMortarMapper.propIntegration.isAutomaticNoGPQuadrilateral,
-                    settingMapper.IGAMortarMapper.propIntegration.noGPQuadrilateral,
-                    settingMapper.IGAMortarMapper.propWeakCurveDirichletConditions.isWeakCurveDirichletConditions,
-                    settingMapper.IGAMortarMapper.propWeakCurveDirichletConditions.isAutomaticPenaltyParameters,
-                    settingMapper.IGAMortarMapper.propWeakCurveDirichletConditions.isPrimPrescribed,
-                    settingMapper.IGAMortarMapper.propWeakCurveDirichletConditions.isSecBendingPrescribed,
-                    settingMapper.IGAMortarMapper.propWeakCurveDirichletConditions.isSecTwistingPrescribed,
-                    settingMapper.IGAMortarMapper.propWeakCurveDirichletConditions.alphaPrim,
-                    settingMapper.IGAMortarMapper.propWeakCurveDirichletConditions.alphaSecBending,
-                    settingMapper.IGAMortarMapper.propWeakCurveDirichletConditions.alphaSecTwisting,
-                    settingMapper.IGAMortarMapper.propWeakSurfaceDirichletConditions.isWeakSurfaceDirichletConditions,
-                    settingMapper.IGAMortarMapper.propWeakSurfaceDirichletConditions.isAutomaticPenaltyParameters,
-                    settingMapper.IGAMortarMapper.propWeakSurfaceDirichletConditions.isPrimPrescribed,
-                    settingMapper.IGAMortarMapper.propWeakSurfaceDirichletConditions.alphaPrim,
-                    settingMapper.IGAMortarMapper.propWeakPatchContinuityConditions.isWeakPatchContinuityConditions,
-                    settingMapper.IGAMortarMapper.propWeakPatchContinuityConditions.isAutomaticPenaltyParameters,
-                    settingMapper.IGAMortarMapper.propWeakPatchContinuityConditions.isPrimCoupled,
-                    settingMapper.IGAMortarMapper.propWeakPatchContinuityConditions.isSecBendingCoupled,
-                    settingMapper.IGAMortarMapper.propWeakPatchContinuityConditions.isSecTwistingCoupled,
-                    settingMapper.IGAMortarMapper.propWeakPatchContinuityConditions.alphaPrim,
-                    settingMapper.IGAMortarMapper.propWeakPatchContinuityConditions.alphaSecBending,
-                    settingMapper.IGAMortarMapper.propWeakPatchContinuityConditions.alphaSecTwisting,
-                    settingMapper.IGAMortarMapper.propStrongCurveDirichletConditions.isStrongCurveDirichletConditions,
-                    settingMapper.IGAMortarMapper.propErrorComputation.isErrorComputation,
-                    settingMapper.IGAMortarMapper.propErrorComputation.isDomainError,
-                    settingMapper.IGAMortarMapper.propErrorComputation.isCurveError,
-                    settingMapper.IGAMortarMapper.propErrorComputation.isInterfaceError);
-	} else if (settingMapper.type == EMPIRE_IGABarycentricMapper) {
-            mapper->initIGABarycentricMapper(
-                    settingMapper.IGABarycentricMapper.propProjection.maxProjectionDistance,
-                    settingMapper.IGABarycentricMapper.propProjection.noInitialGuess,
-                    settingMapper.IGABarycentricMapper.propProjection.maxProjectionDistanceOnDifferentPatches,
-                    settingMapper.IGABarycentricMapper.propNewtonRaphson.noIterations,
-                    settingMapper.IGABarycentricMapper.propNewtonRaphson.tolProjection);
-        } else if (settingMapper.type == EMPIRE_CurveSurfaceMapper) {
-            mapper->initCurveSurfaceMapper(settingMapper.curveSurfaceMapper.type);
-        } else {
-            assert(false);
+        if (settingMapper.operatorReceivers.empty())
+            continue;
+        const MapperAdapter *mapper = nameToMapperMap.at(settingMapper.name);
+        if (!mapper->isMappingOperatorExportSupported()) {
+            ERROR_OUT() << "Mapper \"" << settingMapper.name << "\" cannot send its mapping "
+                    << "operator, only the nearest neighbor, nearest element, barycentric "
+                    << "interpolation and dual mortar mapper with explicitMappingOperator on "
+                    << "meshes which do not move can" << endl;
+            exit(EXIT_FAILURE);
+        }
+        int numRows, numColumns;
+        vector<int> rowPointers;
+        vector<int> columnIndices;
+        vector<double> values;
+        mapper->getMappingOperator(numRows, numColumns, rowPointers, columnIndices, values);
+        for (int j = 0; j < settingMapper.operatorReceivers.size(); j++) {
+            map<string, ClientCode*>::iterator it = nameToClientCodeMap.find(
+                    settingMapper.operatorReceivers[j]);
+            if (it == nameToClientCodeMap.end()) {
+                ERROR_OUT() << "Mapper \"" << settingMapper.name << "\" sends its mapping operator "
+                        << "to the unknown client code \"" << settingMapper.operatorReceivers[j]
+                        << "\"" << endl;
+                exit(EXIT_FAILURE);
+            }
+            it->second->sendMappingOperator(settingMapper.name, numRows, numColumns, rowPointers,
+                    columnIndices, values);
         }
-        nameToMapperMap.insert(pair<string, MapperAdapter*>(name, mapper));
     }
 }
 
+MapperAdapter *Emperor::initMapper(const structMapper &settingMapper, AbstractMesh *meshA,
+        AbstractMesh *meshB, int numThreads) {
+    string name = settingMapper.name;
+    assert(meshA != NULL && meshB != NULL);
+
+    MapperAdapter *mapper = new MapperAdapter(name, meshA, meshB);
+    mapper->setNumThreads(numThreads);
+    mapper->setWriteMode(settingMapper.writeMode);
+    mapper->setCouplingMatricesCache(settingMapper.couplingMatricesCache);
+    mapper->setIterativeSolver(settingMapper.iterativeSolverTolerance,
+            settingMapper.iterativeSolverMaxIterations);
+    mapper->setInexactSolve(settingMapper.inexactSolveForcing, settingMapper.inexactSolveMaxTolerance);
+    mapper->setLinearSolver(settingMapper.linearSolver);
+    mapper->setPardisoSettings(settingMapper.pardiso);
+    mapper->setCompactAfterBuild(settingMapper.compactAfterBuild);
+    mapper->setReorderCouplingMatrices(settingMapper.reorderCouplingMatrices);
+    mapper->setSinglePrecisionWeights(settingMapper.singlePrecisionWeights);
+    mapper->setExplicitMappingOperator(settingMapper.explicitMappingOperator);
+    mapper->setBuildStatisticsReport(settingMapper.buildStatisticsReport);
+    // build only the operators the filters need, a mapper without filters is built completely
+    bool consistent, conservative;
+    findBuiltMappingDirections(settingMapper, consistent, conservative);
+    if (consistent != conservative)
+        mapper->setMappingDirections(consistent, conservative);
+    if (settingMapper.type == EMPIRE_MortarMapper) {
+        mapper->initMortarMapper(settingMapper.mortarMapper.oppositeSurfaceNormal,
+                settingMapper.mortarMapper.dual, settingMapper.mortarMapper.enforceConsistency);
+    } else if (settingMapper.type == EMPIRE_NearestNeighborMapper) {
+        mapper->initNearestNeighborMapper();
+    } else if (settingMapper.type == EMPIRE_BarycentricInterpolationMapper) {
+        mapper->initBarycentricInterpolationMapper();
+    } else if (settingMapper.type == EMPIRE_NearestElementMapper) {
+        mapper->initNearestElementMapper();
+    } else if (settingMapper.type == EMPIRE_RBFMapper) {
+        mapper->initRBFMapper(settingMapper.RBFMapper.numNodesPerPatch);
+    } else if (settingMapper.type == EMPIRE_IGAMortarMapper) {
+        structMapper::structIGAMortarMapper iga = settingMapper.IGAMortarMapper;
+        if (iga.propTuning.isTuning)
+            tuneIGAMortarMapper(name, meshA, meshB, numThreads, iga);
+        mapper->initIGAMortarMapper(
+                iga.propConsistency.enforceConsistency,
+                iga.propConsistency.tolConsistency,
+                iga.propProjection.maxProjectionDistance,
+                iga.propProjection.noInitialGuess,
+                iga.propProjection.maxProjectionDistanceOnDifferentPatches,
+                iga.propNewtonRaphson.noIterations,
+                iga.propNewtonRaphson.tolProjection,
+                iga.propNewtonRaphsonBoundary.noIterations,
+                iga.propNewtonRaphsonBoundary.tolProjection,
+                iga.propBisection.noIterations,
+                iga.propBisection.tolProjection,
+                iga.propIntegration.isAutomaticNoGPTriangle,
+                iga.propIntegration.noGPTriangle,
+                iga.propIntegration.isAutomaticNoGPQuadrilateral,
+                iga.propIntegration.noGPQuadrilateral,
+                iga.propIntegration.isAdaptive,
+                iga.propIntegration.tolAdaptive,
+                iga.propWeakCurveDirichletConditions.isWeakCurveDirichletConditions,
+                iga.propWeakCurveDirichletConditions.isAutomaticPenaltyParameters,
+                iga.propWeakCurveDirichletConditions.isPrimPrescribed,
+                iga.propWeakCurveDirichletConditions.isSecBendingPrescribed,
+                iga.propWeakCurveDirichletConditions.isSecTwistingPrescribed,
+                iga.propWeakCurveDirichletConditions.alphaPrim,
+                iga.propWeakCurveDirichletConditions.alphaSecBending,
+                iga.propWeakCurveDirichletConditions.alphaSecTwisting,
+                iga.propWeakSurfaceDirichletConditions.isWeakSurfaceDirichletConditions,
+                iga.propWeakSurfaceDirichletConditions.isAutomaticPenaltyParameters,
+                iga.propWeakSurfaceDirichletConditions.isPrimPrescribed,
+                iga.propWeakSurfaceDirichletConditions.alphaPrim,
+                iga.propWeakPatchContinuityConditions.isWeakPatchContinuityConditions,
+                iga.propWeakPatchContinuityConditions.isAutomaticPenaltyParameters,
+                iga.propWeakPatchContinuityConditions.isPrimCoupled,
+                iga.propWeakPatchContinuityConditions.isSecBendingCoupled,
+                iga.propWeakPatchContinuityConditions.isSecTwistingCoupled,
+                iga.propWeakPatchContinuityConditions.alphaPrim,
+                iga.propWeakPatchContinuityConditions.alphaSecBending,
+                iga.propWeakPatchContinuityConditions.alphaSecTwisting,
+                iga.propStrongCurveDirichletConditions.isStrongCurveDirichletConditions,
+                iga.propErrorComputation.isErrorComputation,
+                iga.propErrorComputation.isDomainError,
+                iga.propErrorComputation.isCurveError,
+                iga.propErrorComputation.isInterfaceError,
+                iga.propErrorComputation.isCompactStorage);
+        mapper->setErrorComputationSampling(
+                iga.propErrorComputation.samplingInterval,
+                iga.propErrorComputation.isAtTimeStepEnd,
+                iga.propErrorComputation.isBackground);
+    } else if (settingMapper.type == EMPIRE_IGABarycentricMapper) {
+        mapper->initIGABarycentricMapper(
+                settingMapper.IGABarycentricMapper.propProjection.maxProjectionDistance,
+                settingMapper.IGABarycentricMapper.propProjection.noInitialGuess,
+                settingMapper.IGABarycentricMapper.propProjection.maxProjectionDistanceOnDifferentPatches,
+                settingMapper.IGABarycentricMapper.propNewtonRaphson.noIterations,
+                settingMapper.IGABarycentricMapper.propNewtonRaphson.tolProjection);
+    } else if (settingMapper.type == EMPIRE_CurveSurfaceMapper) {
+        mapper->initCurveSurfaceMapper(settingMapper.curveSurfaceMapper.type);
+    } else {
+        assert(false);
+    }
+    if (settingMapper.meshMotionA != "" || settingMapper.meshMotionB != "")
+        mapper->setMeshMotion(settingMapper.meshMotionA, settingMapper.meshMotionB,
+                settingMapper.meshMotionThreshold);
+    bool isMeshAMovedByClient = isMeshCoordinatesInput(settingMapper.meshRefA);
+    bool isMeshBMovedByClient = isMeshCoordinatesInput(settingMapper.meshRefB);
+    if (isMeshAMovedByClient || isMeshBMovedByClient)
+        mapper->setMeshMovedByClient(isMeshAMovedByClient, isMeshBMovedByClient,
+                settingMapper.meshMotionThreshold);
+    mapper->setConservationMonitor(settingMapper.conservationMonitorInterval,
+            settingMapper.conservationMonitorTolerance);
+    return mapper;
+}
+
 void Emperor::initCouplingAlgorithms() {
     const std::vector<structCouplingAlgorithm> &settingCouplingAlgorithmVec =
             MetaDatabase::getSingleton()->settingCouplingAlgorithmVec;
@@ -408,8 +1516,16 @@ void Emperor::initCouplingAlgorithms() {
         } else if (settingCouplingAlgorithm.type == EMPIRE_ConstantRelaxation) {
             double relaxationFactor = settingCouplingAlgorithm.constantRelaxation.relaxationFactor;
             couplingAlgorithm = new ConstantRelaxation(name, relaxationFactor);
+        } else if (settingCouplingAlgorithm.type == EMPIRE_IQNILS) {
+            couplingAlgorithm = new IQNILS(name, settingCouplingAlgorithm.iqnils.initialRelaxationFactor,
+                    settingCouplingAlgorithm.iqnils.reuseTimeSteps,
+                    settingCouplingAlgorithm.iqnils.filterTolerance);
         } else if (settingCouplingAlgorithm.type == EMPIRE_IJCSA) {
             couplingAlgorithm = new IJCSA(name);
+            dynamic_cast<IJCSA*>(couplingAlgorithm)->setMaxRankOfUpdate(
+                    settingCouplingAlgorithm.ijcsa.maxRankOfUpdate);
+            dynamic_cast<IJCSA*>(couplingAlgorithm)->setLinearSolver(
+                    settingCouplingAlgorithm.ijcsa.linearSolver);
             // add interfaceJacobianConsts
             for (int j = 0; j < settingCouplingAlgorithm.interfaceJacobians.size(); j++) {
                 const structCouplingAlgorithm::structInterfaceJacobian &settingInterfaceJacobian =
@@ -435,12 +1551,23 @@ void Emperor::initCouplingAlgorithms() {
                 }
 
             }
+            for (int j = 0; j < settingCouplingAlgorithm.interfaceJacobianBlocks.size(); j++) {
+                const structCouplingAlgorithm::structInterfaceJacobianBlock &settingBlock =
+                        settingCouplingAlgorithm.interfaceJacobianBlocks[j];
+                assert(nameToClientCodeMap.find(settingBlock.clientCodeName)
+                        != nameToClientCodeMap.end());
+                dynamic_cast<IJCSA*>(couplingAlgorithm)->addInterfaceJacobianBlock(
+                        settingBlock.indexRow, settingBlock.indexColumn,
+                        nameToClientCodeMap[settingBlock.clientCodeName],
+                        settingBlock.jacobianName, settingBlock.isUpdatedEveryIteration);
+            }
         }else if(settingCouplingAlgorithm.type == EMPIRE_GMRES){
 
         	int maxOuterItter = settingCouplingAlgorithm.gmres.maxOuterItter;
         	int maxInnerItter = settingCouplingAlgorithm.gmres.maxInnerItter;
         	double residual = settingCouplingAlgorithm.gmres.residualTolerance;
-        	couplingAlgorithm = new GMRES(name, maxOuterItter, maxInnerItter, residual);
+        	int recycleDimension = settingCouplingAlgorithm.gmres.recycleDimension;
+        	couplingAlgorithm = new GMRES(name, maxOuterItter, maxInnerItter, residual, recycleDimension);
         	int j;
         	for(j=0; j<settingCouplingAlgorithm.gmres.inputs.size(); j++){
 
@@ -489,6 +1616,11 @@ void Emperor::initExtrapolators() {
         AbstractExtrapolator *extrapolator = NULL;
         if (settingExtrapolator.type == EMPIRE_LinearExtrapolator) {
             extrapolator = new LinearExtrapolator(name);
+        } else if (settingExtrapolator.type == EMPIRE_PolynomialExtrapolator) {
+            extrapolator = new PolynomialExtrapolator(name, settingExtrapolator.degree,
+                    settingExtrapolator.historyLength);
+        } else if (settingExtrapolator.type == EMPIRE_AdamsBashforthExtrapolator) {
+            extrapolator = new AdamsBashforthExtrapolator(name, settingExtrapolator.degree);
         } else {
             assert(false);
         }
@@ -501,19 +1633,50 @@ void Emperor::initExtrapolators() {
     }
 }
 
+/***********************************************************************************************
+ * \brief Insert the data field of a connection input/output into a set
+ ***********/
+static void insertDataField(map<string, ClientCode*> &nameToClientCodeMap,
+        const structConnectionIO &io, set<const DataField*> &dataFields) {
+    if (io.type != EMPIRE_ConnectionIO_DataField)
+        return;
+    const structDataFieldRef &ref = io.dataFieldRef;
+    AbstractMesh *mesh = nameToClientCodeMap.at(ref.clientCodeName)->getMeshByName(ref.meshName);
+    dataFields.insert(mesh->getDataFieldByName(ref.dataFieldName));
+}
+
+/***********************************************************************************************
+ * \brief Insert the data fields of connection inputs/outputs into a set
+ ***********/
+static void insertDataFields(map<string, ClientCode*> &nameToClientCodeMap,
+        const vector<structConnectionIO> &ios, set<const DataField*> &dataFields) {
+    for (unsigned i = 0; i < ios.size(); i++)
+        insertDataField(nameToClientCodeMap, ios[i], dataFields);
+}
+
 void Emperor::initConnections() {
     const std::vector<structConnection> &settingConnectionVec =
             MetaDatabase::getSingleton()->settingConnectionVec;
     int numConnections = settingConnectionVec.size();
+    // the copy filters whose output shares the storage of the input, and the number of writers of
+    // every data field: receiving it from its client or being the output of a filter
+    vector<CopyFilter*> aliasingCopyFilters;
+    map<const DataField*, int> numWritersOfDataField;
     for (int i = 0; i < numConnections; i++) {
         Connection *connection;
         const structConnection &settingConnection = settingConnectionVec[i];
         string name = settingConnection.name;
         connection = new Connection(name);
+        connection->setExchangeInterval(settingConnection.exchangeInterval);
+        connection->setSignalBundling(settingConnection.bundleSignals);
+        connection->setChangeDetection(settingConnection.skipUnchangedInputs,
+                settingConnection.changeTolerance);
         for (int j = 0; j < settingConnection.inputs.size(); j++) {
             const structConnectionIO &settingConnectionIO = settingConnection.inputs[j];
-            connection->addInput(constructConnectionIO(settingConnectionIO));
-
+            ConnectionIO *input = constructConnectionIO(settingConnectionIO);
+            connection->addInput(input);
+            if (input->type == EMPIRE_ConnectionIO_DataField)
+                numWritersOfDataField[input->dataField]++;
         }
         for (int j = 0; j < settingConnection.outputs.size(); j++) {
             const structConnectionIO &settingConnectionIO = settingConnection.outputs[j];
@@ -530,7 +1693,11 @@ void Emperor::initConnections() {
                 string mapperName = settingFilter.mappingFilter.mapperName;
                 assert(nameToMapperMap.find(mapperName) != nameToMapperMap.end());
                 MapperAdapter *mapper = nameToMapperMap.at(mapperName);
-                filter = new MappingFilter(mapper);
+                MappingFilter *mappingFilter = new MappingFilter(mapper);
+                if (settingFilter.mappingFilter.incremental)
+                    mappingFilter->setIncrementalMapping(
+                            settingFilter.mappingFilter.incrementTolerance);
+                filter = mappingFilter;
             } else if (settingFilter.type == EMPIRE_LocationFilter) {
                 filter = new LocationFilter();
             } else if (settingFilter.type == EMPIRE_ScalingFilter) {
@@ -540,7 +1707,11 @@ void Emperor::initConnections() {
             } else if (settingFilter.type == EMPIRE_SetFilter) {
                 filter = new SetFilter(settingFilter.setFilter.value);
             } else if (settingFilter.type == EMPIRE_CopyFilter) {
-                filter = new CopyFilter(settingFilter.copyFilter.signalOffset);
+                CopyFilter *copyFilter = new CopyFilter(settingFilter.copyFilter.signalOffset,
+                        settingFilter.copyFilter.alias);
+                if (copyFilter->isAliasing())
+                    aliasingCopyFilters.push_back(copyFilter);
+                filter = copyFilter;
             } else if (settingFilter.type == EMPIRE_DataFieldIntegrationFilter) {
                 const structMeshRef &meshRef = settingFilter.dataFieldIntegrationFilter.meshRef;
                 assert(
@@ -548,7 +1719,11 @@ void Emperor::initConnections() {
                                 != nameToClientCodeMap.end());
                 AbstractMesh *mesh = nameToClientCodeMap.at(meshRef.clientCodeName)->getMeshByName(
                         meshRef.meshName);
-                filter = new DataFieldIntegrationFilter(mesh);
+                DataFieldIntegrationFilter *integrationFilter = new DataFieldIntegrationFilter(
+                        mesh, settingFilter.dataFieldIntegrationFilter.lumped);
+                integrationFilter->setLinearSolver(
+                        settingFilter.dataFieldIntegrationFilter.linearSolver);
+                filter = integrationFilter;
             } else if (settingFilter.type == EMPIRE_AdditionFilter) {
                 double a = settingFilter.additionFilter.a;
                 double b = settingFilter.additionFilter.b;
@@ -562,12 +1737,124 @@ void Emperor::initConnections() {
             }
             for (int k = 0; k < settingFilter.outputs.size(); k++) {
                 const structConnectionIO &settingConnectionIO = settingFilter.outputs[k];
-                filter->addOutput(constructConnectionIO(settingConnectionIO));
+                ConnectionIO *output = constructConnectionIO(settingConnectionIO);
+                filter->addOutput(output);
+                if (output->type == EMPIRE_ConnectionIO_DataField)
+                    numWritersOfDataField[output->dataField]++;
             }
             filter->init(); // initialize something after the inputs and outputs are set
             connection->addFilter(filter);
         }
     }
+
+    // An aliased data field must be written by its copy filter only, otherwise the input would be
+    // overwritten
+    for (unsigned i = 0; i < aliasingCopyFilters.size(); i++) {
+        const ConnectionIO *output = aliasingCopyFilters[i]->getOutputs()[0];
+        if (numWritersOfDataField[output->dataField] > 1) {
+            ERROR_OUT() << "The data field \"" << output->dataField->name << "\" of client \""
+                    << output->clientCode->getName() << "\" is the output of an aliasing copy filter, "
+                    << "it must not be received or written by another filter" << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    // Alias a data field after the data field it is copied from, if that is aliased itself
+    while (!aliasingCopyFilters.empty()) {
+        vector<CopyFilter*> pendingCopyFilters;
+        for (unsigned i = 0; i < aliasingCopyFilters.size(); i++) {
+            const DataField *input = aliasingCopyFilters[i]->getInputs()[0]->dataField;
+            bool isInputPending = false;
+            for (unsigned j = 0; j < aliasingCopyFilters.size(); j++)
+                if (j != i && aliasingCopyFilters[j]->getOutputs()[0]->dataField == input)
+                    isInputPending = true;
+            if (isInputPending)
+                pendingCopyFilters.push_back(aliasingCopyFilters[i]);
+            else
+                aliasingCopyFilters[i]->aliasOutput();
+        }
+        if (pendingCopyFilters.size() == aliasingCopyFilters.size()) {
+            ERROR_OUT() << "The aliasing copy filters form a cycle" << endl;
+            exit(EXIT_FAILURE);
+        }
+        aliasingCopyFilters.swap(pendingCopyFilters);
+    }
+
+    // The data fields between chained mappings are not written, so those read outside of their
+    // connection are kept: by data outputs, extrapolators, coupling algorithms, mesh motions and
+    // the other connections
+    const MetaDatabase *metaDatabase = MetaDatabase::getSingleton();
+    set<const DataField*> externalDataFields;
+    for (unsigned i = 0; i < metaDatabase->settingDataOutputVec.size(); i++)
+        insertDataFields(nameToClientCodeMap, metaDatabase->settingDataOutputVec[i].connectionIOs,
+                externalDataFields);
+    for (unsigned i = 0; i < metaDatabase->settingExtrapolatorVec.size(); i++)
+        insertDataFields(nameToClientCodeMap, metaDatabase->settingExtrapolatorVec[i].connectionIOs,
+                externalDataFields);
+    for (unsigned i = 0; i < metaDatabase->settingCouplingAlgorithmVec.size(); i++) {
+        const structCouplingAlgorithm &settingCouplingAlgorithm =
+                metaDatabase->settingCouplingAlgorithmVec[i];
+        for (unsigned j = 0; j < settingCouplingAlgorithm.outputs.size(); j++)
+            insertDataField(nameToClientCodeMap, settingCouplingAlgorithm.outputs[j].connectionIO,
+                    externalDataFields);
+        for (unsigned j = 0; j < settingCouplingAlgorithm.residuals.size(); j++)
+            for (unsigned k = 0; k < settingCouplingAlgorithm.residuals[j].components.size(); k++)
+                insertDataField(nameToClientCodeMap,
+                        settingCouplingAlgorithm.residuals[j].components[k].connectionIO,
+                        externalDataFields);
+        for (unsigned j = 0; j < settingCouplingAlgorithm.interfaceJacobians.size(); j++) {
+            insertDataField(nameToClientCodeMap,
+                    settingCouplingAlgorithm.interfaceJacobians[j].functionInput,
+                    externalDataFields);
+            insertDataField(nameToClientCodeMap,
+                    settingCouplingAlgorithm.interfaceJacobians[j].functionOutput,
+                    externalDataFields);
+        }
+        insertDataFields(nameToClientCodeMap, settingCouplingAlgorithm.gmres.inputs,
+                externalDataFields);
+        insertDataFields(nameToClientCodeMap, settingCouplingAlgorithm.gmres.outputs,
+                externalDataFields);
+    }
+    for (unsigned i = 0; i < metaDatabase->settingMapperVec.size(); i++) {
+        const structMapper &settingMapper = metaDatabase->settingMapperVec[i];
+        if (settingMapper.meshMotionA != "")
+            externalDataFields.insert(
+                    nameToClientCodeMap.at(settingMapper.meshRefA.clientCodeName)->getMeshByName(
+                            settingMapper.meshRefA.meshName)->getDataFieldByName(
+                            settingMapper.meshMotionA));
+        if (settingMapper.meshMotionB != "")
+            externalDataFields.insert(
+                    nameToClientCodeMap.at(settingMapper.meshRefB.clientCodeName)->getMeshByName(
+                            settingMapper.meshRefB.meshName)->getDataFieldByName(
+                            settingMapper.meshMotionB));
+    }
+    vector<set<const DataField*> > connectionDataFields(numConnections);
+    for (int i = 0; i < numConnections; i++) {
+        const structConnection &settingConnection = settingConnectionVec[i];
+        insertDataFields(nameToClientCodeMap, settingConnection.inputs, connectionDataFields[i]);
+        insertDataFields(nameToClientCodeMap, settingConnection.outputs, connectionDataFields[i]);
+        for (unsigned j = 0; j < settingConnection.filterSequence.size(); j++) {
+            insertDataFields(nameToClientCodeMap, settingConnection.filterSequence[j].inputs,
+                    connectionDataFields[i]);
+            insertDataFields(nameToClientCodeMap, settingConnection.filterSequence[j].outputs,
+                    connectionDataFields[i]);
+        }
+    }
+    for (int i = 0; i < numConnections; i++) {
+        Connection *connection = nameToConnetionMap.at(settingConnectionVec[i].name);
+        connection->setMappingChaining(settingConnectionVec[i].chainMappings);
+        if (!settingConnectionVec[i].chainMappings)
+            continue;
+        for (set<const DataField*>::iterator it = externalDataFields.begin();
+                it != externalDataFields.end(); it++)
+            connection->keepDataField(*it);
+        for (int j = 0; j < numConnections; j++) {
+            if (j == i)
+                continue;
+            for (set<const DataField*>::iterator it = connectionDataFields[j].begin();
+                    it != connectionDataFields[j].end(); it++)
+                connection->keepDataField(*it);
+        }
+    }
 }
 
 void Emperor::initGlobalCouplingLogic() {
@@ -575,6 +1862,42 @@ void Emperor::initGlobalCouplingLogic() {
             MetaDatabase::getSingleton()->settingGlobalCouplingLogic);
 }
 
+void Emperor::initCheckpoint() {
+    const MetaDatabase *metaDatabase = MetaDatabase::getSingleton();
+    if (metaDatabase->checkpointInterval == 0 && !metaDatabase->restartFromCheckpoint)
+        return;
+    checkpoint = new CouplingStateCheckpoint(metaDatabase->checkpointDirectory,
+            metaDatabase->checkpointInterval, metaDatabase->checkpointNumKept,
+            metaDatabase->checkpointQueueDepth);
+    for (map<string, AbstractCouplingAlgorithm*>::iterator it = nameToCouplingAlgorithmMap.begin();
+            it != nameToCouplingAlgorithmMap.end(); it++)
+        checkpoint->addObject("couplingAlgorithm " + it->first, it->second);
+    for (map<string, AbstractExtrapolator*>::iterator it = nameToExtrapolatorMap.begin();
+            it != nameToExtrapolatorMap.end(); it++)
+        checkpoint->addObject("extrapolator " + it->first, it->second);
+    for (map<string, Connection*>::iterator it = nameToConnetionMap.begin();
+            it != nameToConnetionMap.end(); it++) {
+        const vector<AbstractFilter*> &filters = it->second->getFilters();
+        for (unsigned i = 0; i < filters.size(); i++) {
+            stringstream objectName;
+            objectName << "connection " << it->first << " filter " << i;
+            checkpoint->addObject(objectName.str(), filters[i]);
+        }
+    }
+
+    // the time steps of a checkpoint identify it, so only one time step loop is checkpointed
+    TimeStepLoop *timeStepLoop = NULL;
+    const vector<AbstractCouplingLogic*> &sequence = globalCouplingLogic->getCouplingLogicSequence();
+    for (unsigned i = 0; i < sequence.size() && timeStepLoop == NULL; i++)
+        timeStepLoop = dynamic_cast<TimeStepLoop*>(sequence[i]);
+    if (timeStepLoop == NULL) {
+        WARNING_OUT() << "Emperor: the coSimulation block has no time step loop, no checkpoint of "
+                << "the coupling state is written" << endl;
+        return;
+    }
+    timeStepLoop->setCheckpoint(checkpoint, metaDatabase->restartFromCheckpoint);
+}
+
 AbstractCouplingLogic *Emperor::parseStructCouplingLogic(
         structCouplingLogic &settingCouplingLogic) {
     vector<structCouplingLogic> &settingCouplingLogicSequence = settingCouplingLogic.sequence;
@@ -595,6 +1918,7 @@ AbstractCouplingLogic *Emperor::parseStructCouplingLogic(
         vector < string > &couplingAlgorithmRefs = settingIterCoupLoop.couplingAlgorithmRefs;
 
         IterativeCouplingLoop *iterativeCouplingLoop = new IterativeCouplingLoop();
+        iterativeCouplingLoop->setCouplingSchema(settingIterCoupLoop.couplingSchema);
         { // convergence checker
             double maxNumOfIterations = settingConvgChecker.maxNumOfIterations;
             ConvergenceChecker *checker = new ConvergenceChecker(maxNumOfIterations);
@@ -666,12 +1990,20 @@ AbstractCouplingLogic *Emperor::parseStructCouplingLogic(
                 timeStepLoop->addDataOutput(dataOutput);
             }
         }
+        // the mappers computing their errors at the end of the time steps
+        set<MapperAdapter*> addedMappers;
+        for (map<string, MapperAdapter*>::iterator it = nameToMapperMap.begin();
+                it != nameToMapperMap.end(); it++)
+            if (it->second->isErrorComputationAtTimeStepEnd()
+                    && addedMappers.insert(it->second).second)
+                timeStepLoop->addMapperWithErrorsAtTimeStepEnd(it->second);
         couplingLogic = timeStepLoop;
     } else if (settingCouplingLogic.type == EMPIRE_OptimizationLoop) {
         structCouplingLogic::structOptimizationLoop &settingOptLoop =
                 settingCouplingLogic.optimizationLoop;
         OptimizationLoop *optimizationLoop = new OptimizationLoop(
                 settingOptLoop.maxNumOfIterations);
+        optimizationLoop->setConcurrentDesigns(settingOptLoop.concurrentDesigns);
         { // convergence signal sender
             assert(
                     nameToClientCodeMap.find(settingOptLoop.convergenceSignalSender)
@@ -728,6 +2060,10 @@ ConnectionIO *Emperor::constructConnectionIO(const structConnectionIO &settingCo
     } else if (settingConnectionIO.type == EMPIRE_ConnectionIO_Signal) {
         io = new ConnectionIO(nameToClientCodeMap, settingConnectionIO.signalRef.clientCodeName,
                 settingConnectionIO.signalRef.signalName);
+    } else if (settingConnectionIO.type == EMPIRE_ConnectionIO_MeshCoordinates) {
+        ClientCode *clientCode = nameToClientCodeMap[settingConnectionIO.meshRef.clientCodeName];
+        io = new ConnectionIO(clientCode,
+                clientCode->getMeshByName(settingConnectionIO.meshRef.meshName));
     } else {
         assert(false);
     }
@@ -29,6 +29,8 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <stdint.h>
+#include <pthread.h>
 
 namespace EMPIRE {
 
@@ -41,10 +43,16 @@ class MapperAdapter;
 class AbstractCouplingAlgorithm;
 class AbstractExtrapolator;
 class AbstractCouplingLogic;
+class CouplingStateCheckpoint;
 class ConnectionIO;
 struct structCouplingLogic;
 struct structDataFieldRef;
 struct structConnectionIO;
+struct structMapper;
+struct structMeshRef;
+struct structDataOutput;
+struct MapperBuildSchedule;
+class AbstractMesh;
 /********//**
  * \brief This class manages the program, provides the interface functions of the program
  *        which are called in the main function
@@ -62,7 +70,10 @@ public:
      ***********/
     virtual ~Emperor();
     /***********************************************************************************************
-     * \brief Initializes Meta database (parsing done) and ServerCommunication
+     * \brief Initializes Meta database (parsing done) and ServerCommunication. The command line is
+     *        "Emperor input.xml", or "Emperor input.xml -daemon sessionsFile" for the daemon, which
+     *        keeps running after the co-simulation of input.xml and runs the sessions whose input
+     *        files are appended to sessionsFile, one per line, until the line "exit".
      * \param[in] argc pointer to number of command line arguments
      * \param[in] argv pointer to char array which holds the command line arguments
      * \author Tianyang Wang, Stefan Sicklinger
@@ -74,27 +85,121 @@ public:
      ***********/
     void startServerListening();
     /***********************************************************************************************
-     * \brief Executes the complete EMPEROR Co-Simulation.
+     * \brief Executes the complete EMPEROR Co-Simulation, the daemon executes all its sessions.
      * \author Tianyang Wang
      ***********/
     void startServerCoupling();
 
 private:
     /***********************************************************************************************
-     * \brief Wait until all clients specified in the XML input file are connected
-     * \author Stefan Sicklinger
+     * \brief Executes the co-simulation of the current MetaDatabase
+     ***********/
+    void runSession();
+    /***********************************************************************************************
+     * \brief End a session of the daemon: disconnect its clients, keep its mappers with their
+     *        meshes and delete all other objects of the session
+     ***********/
+    void endSession();
+    /***********************************************************************************************
+     * \brief Wait for the next line of the sessions file and begin its session
+     * \return false if the line is "exit"
+     ***********/
+    bool startNextSession();
+    /***********************************************************************************************
+     * \brief Read the input file of the next session from the sessions file
+     * \param[out] inputFileName the input file
+     * \return false if the sessions file has no further complete line yet
+     ***********/
+    bool readNextSession(std::string &inputFileName);
+    /***********************************************************************************************
+     * \brief Release a mesh from its client code and keep it for the next session, once for all
+     *        mappers using it
+     * \param[in] meshRef the mesh
+     * \return the mesh
+     ***********/
+    AbstractMesh *keepMesh(const structMeshRef &meshRef);
+    /***********************************************************************************************
+     * \brief Replace a received mesh by the kept mesh of the same name and content, such that the
+     *        kept mappers of the mesh can be taken over
+     * \param[in] clientCodeName the name of the client code of the mesh
+     * \param[in] meshName the name of the mesh
+     * \return the mesh the client code holds afterwards
+     ***********/
+    AbstractMesh *adoptKeptMesh(const std::string &clientCodeName, const std::string &meshName);
+    /***********************************************************************************************
+     * \brief Take over a kept mapper with the same settings and meshes instead of building it
+     * \param[in] settingMapper the settings of the mapper
+     * \param[in] meshA mesh A of the mapper
+     * \param[in] meshB mesh B of the mapper
+     * \return the mapper, NULL if there is none
+     ***********/
+    MapperAdapter *adoptKeptMapper(const structMapper &settingMapper, AbstractMesh *meshA,
+            AbstractMesh *meshB);
+    /***********************************************************************************************
+     * \brief Delete the kept mappers and meshes which have not been taken over
+     ***********/
+    void deleteKeptMappers();
+    /***********************************************************************************************
+     * \brief Delete the objects of the session, i.e. all objects created from the MetaDatabase
+     ***********/
+    void deleteSessionObjects();
+    /***********************************************************************************************
+     * \brief Start the other replicas of an ensemble, each on its own thread with its own client
+     *        codes, data outputs, coupling algorithms, extrapolators and connections
+     ***********/
+    void startReplicas();
+    /***********************************************************************************************
+     * \brief Wait for the co-simulations of the other replicas and delete them
      ***********/
-    void connectAllClients();
+    void joinReplicas();
+    /***********************************************************************************************
+     * \brief Entry of the thread of a replica
+     * \param[in] emperor the Emperor of the replica
+     * \return NULL
+     ***********/
+    static void *runReplicaThread(void *emperor);
+    /***********************************************************************************************
+     * \brief Execute the co-simulation of a replica, with the mappers of the first replica
+     ***********/
+    void runReplica();
+    /***********************************************************************************************
+     * \brief Share the mappers of the first replica with the other replicas once they are built,
+     *        returns when the meshes of all replicas are registered at the mappers
+     ***********/
+    void shareMappers();
+    /***********************************************************************************************
+     * \brief Tell the shared mappers that the co-simulation of this replica has finished
+     ***********/
+    void finishReplica();
     /***********************************************************************************************
      * \brief Disconnect all clients
      * \author Stefan Sicklinger
      ***********/
     void disconnectAllClients();
     /***********************************************************************************************
-     * \brief Initialize ClientCode instances by the info sent by the real clients
+     * \brief Initialize ClientCode instances by the info sent by the real clients. The clients
+     *        are served in the order in which they connect, the meshes of a connected client are
+     *        received while the other clients are still starting
      * \author Tianyang Wang
      ***********/
     void initClientCodes();
+    /***********************************************************************************************
+     * \brief Start receiving the first mesh of a client which has connected, such that the first
+     *        meshes of all connected clients are transferred concurrently
+     * \param[in] clientIndex the index of the client in the input file
+     ***********/
+    void startClientCode(int clientIndex);
+    /***********************************************************************************************
+     * \brief Whether the meshes a client copies from other clients have been received
+     * \param[in] clientIndex the index of the client in the input file
+     * \param[in] isReceived whether the meshes of a client have been received, by index
+     ***********/
+    bool areMeshesToCopyReceived(int clientIndex, const std::vector<bool> &isReceived) const;
+    /***********************************************************************************************
+     * \brief Receive the meshes, their initial data fields and the signals of a started client
+     * \param[in] clientIndex the index of the client in the input file
+     ***********/
+    void recvClientCode(int clientIndex);
     /***********************************************************************************************
      * \brief Initialize DataOutput instances
      * \author Tianyang Wang
@@ -105,6 +210,32 @@ private:
      * \author Tianyang Wang
      ***********/
     void initMappers();
+    /***********************************************************************************************
+     * \brief Send the mapping operators to the client codes listed as their operatorReceivers,
+     *        after the mappers are built
+     ***********/
+    void sendMappingOperators();
+    /***********************************************************************************************
+     * \brief Plan the builds of the mappers, the mappers are built on worker threads as soon as
+     *        their meshes have arrived (see meshArrived), initMappers waits for the builds
+     ***********/
+    void startMapperBuilds();
+    /***********************************************************************************************
+     * \brief Start the builds of the mappers which have been waiting only for this mesh
+     * \param[in] clientCodeName the name of the client code of the mesh
+     * \param[in] meshName the name of the mesh
+     ***********/
+    void meshArrived(const std::string &clientCodeName, const std::string &meshName);
+    /***********************************************************************************************
+     * \brief Create a mapper and build its coupling matrices
+     * \param[in] settingMapper the settings of the mapper
+     * \param[in] meshA mesh A of the mapper
+     * \param[in] meshB mesh B of the mapper
+     * \param[in] numThreads the number of threads of the build
+     * \return the mapper
+     ***********/
+    MapperAdapter *initMapper(const structMapper &settingMapper, AbstractMesh *meshA,
+            AbstractMesh *meshB, int numThreads);
     /***********************************************************************************************
      * \brief Initialize coupling algorithms
      * \author Tianyang Wang
@@ -125,6 +256,12 @@ private:
      * \author Tianyang Wang
      ***********/
     void initGlobalCouplingLogic();
+    /***********************************************************************************************
+     * \brief Initialize the checkpoint of the coupling state if it is enabled, it holds the
+     *        coupling algorithms, extrapolators and filters and is written by the time step loop
+     *        of the coSimulation block
+     ***********/
+    void initCheckpoint();
     /***********************************************************************************************
      * \brief Parse StructCouplingLogic which is called by initCouplingLogicSequence()
      * \param[in] couplingLogicStruct pointer to structCouplingLogic coming from MetaDatabase
@@ -159,6 +296,60 @@ private:
     AbstractCouplingLogic *globalCouplingLogic;
     /// Collection of coupling logics which is only used for destruction
     std::vector<AbstractCouplingLogic*> couplingLogicVec;
+    /// the checkpoint of the coupling state, NULL if disabled
+    CouplingStateCheckpoint *checkpoint;
+    /// the mapper builds running while the meshes are received, NULL outside of the start-up
+    MapperBuildSchedule *mapperBuildSchedule;
+    /// whether the Emperor runs as daemon, one session after another
+    bool isDaemon;
+    /// the file to which the input files of the sessions of the daemon are appended
+    std::string sessionsFileName;
+    /// the number of sessions read from the sessions file
+    int numSessions;
+    /********//**
+     * \brief A mesh kept from the last session of the daemon for its mappers
+     ***********/
+    struct KeptMesh {
+        std::string clientCodeName;
+        std::string meshName;
+        /// the content hash of the mesh when it was kept, see AbstractMesh::getContentHash
+        uint64_t key;
+        AbstractMesh *mesh;
+    };
+    /********//**
+     * \brief A mapper kept from the last session of the daemon
+     ***********/
+    struct KeptMapper {
+        MapperAdapter *mapper;
+        /// the hash of the settings of the mapper
+        uint64_t settingsKey;
+        /// the kept meshes of the mapper
+        AbstractMesh *meshA;
+        AbstractMesh *meshB;
+    };
+    /// the meshes kept from the last session which have not been taken over
+    std::vector<KeptMesh> keptMeshes;
+    /// the mappers kept from the last session which have not been taken over
+    std::vector<KeptMapper> keptMappers;
+    /// the replica of an ensemble this Emperor runs, 0 for the Emperor of the main thread
+    int replica;
+    /// the Emperor of replica 0, which owns the mappers, NULL for replica 0 itself
+    Emperor *primary;
+    /// the Emperors of the other replicas, owned by replica 0
+    std::vector<Emperor*> replicas;
+    /// the threads of the other replicas
+    std::vector<pthread_t> replicaThreads;
+    /// the settings of the data outputs of a replica, whose files are named after the replica
+    std::vector<structDataOutput*> replicaDataOutputSettings;
+    /// whether the mappers of replica 0 are built and can be shared
+    bool areMappersShared;
+    /// the number of other replicas whose meshes are registered at the mappers
+    int numReplicasRegistered;
+    /// protects areMappersShared, numReplicasRegistered and the registration of the meshes
+    pthread_mutex_t replicasMutex;
+    /// signaled when the mappers can be shared and when a replica has registered its meshes
+    pthread_cond_t mappersShared;
+    class MapperBuildTask;
     /// the unit test class
     friend class TestEmperor;
     /// the unit test class
@@ -22,6 +22,8 @@
 #include <string.h>
 #include "ClientCode.h"
 #include "ServerCommunication.h"
+#include "SharedMemorySegment.h"
+#include "DataFieldCodec.h"
 #include "DataField.h"
 #include "AbstractMesh.h"
 #include "FEMesh.h"
@@ -32,15 +34,44 @@
 #include "WeakIGAPatchContinuityCondition.h"
 #include "Signal.h"
 #include "Message.h"
+#include "Profiler.h"
 #include <stdlib.h>
 #include <algorithm>
+#include <omp.h>
 
 namespace EMPIRE {
 
 using namespace std;
 
+/***********************************************************************************************
+ * \brief Get the number of chunks a data field of the given size is transferred in
+ ***********/
+static int getNumChunks(int size, int chunkSize) {
+    return (size + chunkSize - 1) / chunkSize;
+}
+
+/// the size header of a data field whose values are skipped as they have not changed, the same
+/// value as the one of the client
+static const int UNCHANGED_DATA_FIELD = -1;
+/// a size header carrying a non-convergence signal is NON_CONVERGENT_HEADER - header. It is
+/// negative and never 0 or 1, which are the values of a convergence signal sent on its own
+static const int NON_CONVERGENT_HEADER = -2;
+
+/***********************************************************************************************
+ * \brief Get the names of the signals of a bundle for the output, e.g. "(a, b)"
+ ***********/
+static string joinSignalNames(const vector<string> &signalNames) {
+    string names = "(";
+    for (int i = 0; i < signalNames.size(); i++)
+        names += (i == 0 ? "" : ", ") + signalNames[i];
+    return names + ")";
+}
+
 ClientCode::ClientCode(string _name) :
-        name(_name), serverComm(NULL), nameToMeshMap(), nameToSignalMap() {
+        name(_name), serverComm(NULL), nameToMeshMap(), nameToSignalMap(),
+        persistentDataFieldTransfer(false), sharedMemoryDataFieldTransfer(false),
+        piggybackConvergenceSignal(false), hasPendingConvergenceSignal(false),
+        profilerRecvName("receive from [" + _name + "]"), profilerSendName("send to [" + _name + "]") {
 }
 
 ClientCode::~ClientCode() {
@@ -52,6 +83,8 @@ ClientCode::~ClientCode() {
             it++) {
         delete it->second;
     }
+    for (int i = 0; i < sharedMemorySegments.size(); i++)
+        delete sharedMemorySegments[i];
 }
 
 void ClientCode::setServerCommunication(ServerCommunication *_serverComm) {
@@ -59,40 +92,244 @@ void ClientCode::setServerCommunication(ServerCommunication *_serverComm) {
     serverComm = _serverComm;
 }
 
-void ClientCode::recvFEMesh(std::string meshName, bool triangulateAll) {
+void ClientCode::setPersistentDataFieldTransfer(bool _persistentDataFieldTransfer) {
+    persistentDataFieldTransfer = _persistentDataFieldTransfer;
+}
+
+void ClientCode::setSharedMemoryDataFieldTransfer(bool _sharedMemoryDataFieldTransfer) {
+    sharedMemoryDataFieldTransfer = _sharedMemoryDataFieldTransfer;
+}
+
+void ClientCode::setPiggybackConvergenceSignal(bool _piggybackConvergenceSignal) {
+    piggybackConvergenceSignal = _piggybackConvergenceSignal;
+}
+
+void ClientCode::setDataFieldWireFormat(std::string meshName, std::string dataFieldName,
+        EMPIRE_DataField_wireFormat wireFormat) {
+    DataField *df = getDataField(meshName, dataFieldName);
+    map<DataField*, EncodedDataField>::iterator it = encodedDataFields.find(df);
+    if (it != encodedDataFields.end()) {
+        if (it->second.wireFormat != wireFormat) {
+            ERROR_OUT() << "Different wire formats of (" << meshName << ": " << dataFieldName
+                    << ") of [" << name << "]" << endl;
+            exit(-1);
+        }
+        return;
+    }
+    int size = df->numLocations * df->dimension;
+    EncodedDataField &encoded = encodedDataFields[df];
+    encoded.wireFormat = wireFormat;
+    if (wireFormat == EMPIRE_DataField_float64)
+        return;
+    encoded.buffer.resize(DataFieldCodec::getMaxEncodedSize(wireFormat, size));
+    encoded.sendHistory.assign(size, 0.0);
+    encoded.recvHistory.assign(size, 0.0);
+}
+
+void ClientCode::setDataFieldChunkSize(std::string meshName, std::string dataFieldName,
+        int chunkSize) {
+    assert(chunkSize >= 0);
+    DataField *df = getDataField(meshName, dataFieldName);
+    map<DataField*, int>::iterator it = dataFieldChunkSizes.find(df);
+    if (it != dataFieldChunkSizes.end()) {
+        if (it->second != chunkSize) {
+            ERROR_OUT() << "Different chunk sizes of (" << meshName << ": " << dataFieldName
+                    << ") of [" << name << "]" << endl;
+            exit(-1);
+        }
+        return;
+    }
+    dataFieldChunkSizes[df] = chunkSize;
+}
+
+int ClientCode::getDataFieldChunkSize(std::string meshName, std::string dataFieldName) {
+    return getDataFieldChunkSize(meshName, getDataField(meshName, dataFieldName));
+}
+
+void ClientCode::setDataFieldSkipUnchanged(std::string meshName, std::string dataFieldName,
+        bool skipUnchanged) {
+    DataField *df = getDataField(meshName, dataFieldName);
+    map<DataField*, bool>::iterator it = dataFieldSkipUnchanged.find(df);
+    if (it != dataFieldSkipUnchanged.end()) {
+        if (it->second != skipUnchanged) {
+            ERROR_OUT() << "Different skipping of unchanged values of (" << meshName << ": "
+                    << dataFieldName << ") of [" << name << "]" << endl;
+            exit(-1);
+        }
+        return;
+    }
+    dataFieldSkipUnchanged[df] = skipUnchanged;
+}
+
+bool ClientCode::isDataFieldPipelined(std::string meshName, std::string dataFieldName) {
+    return getDataFieldChunkSize(meshName, dataFieldName) > 0
+            && getRenumberedMesh(meshName) == NULL;
+}
+
+void ClientCode::recvFEMesh(std::string meshName, bool triangulateAll,
+        EMPIRE_Mesh_renumbering renumbering, bool partitioned) {
+    startRecvFEMesh(meshName, triangulateAll, renumbering, partitioned);
+    finishRecvFEMesh(meshName);
+}
+
+void ClientCode::startRecvFEMesh(std::string meshName, bool triangulateAll,
+        EMPIRE_Mesh_renumbering renumbering, bool partitioned) {
     assert(serverComm != NULL);
     assert(nameToMeshMap.find(meshName) == nameToMeshMap.end());
+    assert(pendingMeshTransfers.find(meshName) == pendingMeshTransfers.end());
 
-    const int BUFFER_SIZE = 2;
-    int meshInfo[BUFFER_SIZE]; // number of nodes, number of elements, number of nodes per element
+    const int BUFFER_SIZE = 3;
+    int meshInfo[BUFFER_SIZE]; // number of nodes, number of elements, size of the elements array
     { // output to shell
         HEADING_OUT(3, "ClientCode", "receiving mesh (" + meshName + ") from [" + name + "]...",
                 infoOut);
     }
+    if (partitioned) {
+        PendingMeshTransfer &transfer = pendingMeshTransfers[meshName];
+        transfer.mesh = NULL;
+        transfer.renumbering = renumbering;
+        transfer.triangulateAll = triangulateAll;
+        transfer.partitions.resize(serverComm->getClientSize(name));
+        int numPartitions = transfer.partitions.size();
+        vector<int> headerRequests(numPartitions);
+        for (int r = 0; r < numPartitions; r++)
+            headerRequests[r] = serverComm->receiveFromClientRankNonBlocking<int>(name, r,
+                    BUFFER_SIZE, transfer.partitions[r].meshInfo);
+        for (int r = 0; r < numPartitions; r++)
+            serverComm->waitForRequest(headerRequests[r]);
+        // the arrays of all processes are posted at once, an empty array is not sent
+        for (int r = 0; r < numPartitions; r++) {
+            MeshPartition &partition = transfer.partitions[r];
+            partition.nodes.resize(partition.meshInfo[0] * 3);
+            partition.nodeIDs.resize(partition.meshInfo[0]);
+            partition.numNodesPerElem.resize(partition.meshInfo[1]);
+            partition.elems.resize(partition.meshInfo[2]);
+            if (!partition.nodes.empty()) {
+                transfer.requests.push_back(
+                        serverComm->receiveFromClientRankNonBlocking<double>(name, r,
+                                partition.nodes.size(), &partition.nodes[0]));
+                transfer.requests.push_back(
+                        serverComm->receiveFromClientRankNonBlocking<int>(name, r,
+                                partition.nodeIDs.size(), &partition.nodeIDs[0]));
+            }
+            if (!partition.numNodesPerElem.empty())
+                transfer.requests.push_back(
+                        serverComm->receiveFromClientRankNonBlocking<int>(name, r,
+                                partition.numNodesPerElem.size(), &partition.numNodesPerElem[0]));
+            if (!partition.elems.empty())
+                transfer.requests.push_back(
+                        serverComm->receiveFromClientRankNonBlocking<int>(name, r,
+                                partition.elems.size(), &partition.elems[0]));
+        }
+        return;
+    }
     serverComm->receiveFromClientBlocking<int>(name, BUFFER_SIZE, meshInfo);
     int numNodes = meshInfo[0];
     int numElems = meshInfo[1];
 
-    FEMesh *mesh = new FEMesh(meshName, numNodes, numElems, triangulateAll);
-    serverComm->receiveFromClientBlocking<double>(name, numNodes * 3, mesh->nodes);
-	serverComm->receiveFromClientBlocking<int>(name, numNodes, mesh->nodeIDs);
-    serverComm->receiveFromClientBlocking<int>(name, numElems, mesh->numNodesPerElem);
+    PendingMeshTransfer &transfer = pendingMeshTransfers[meshName];
+    transfer.mesh = new FEMesh(meshName, numNodes, numElems, triangulateAll);
+    transfer.renumbering = renumbering;
+    transfer.elems.resize(meshInfo[2]);
+    // all arrays are posted at once, the client sends them without waiting in between
+    transfer.requests.push_back(
+            serverComm->receiveFromClientNonBlocking<double>(name, numNodes * 3,
+                    transfer.mesh->nodes));
+    transfer.requests.push_back(
+            serverComm->receiveFromClientNonBlocking<int>(name, numNodes, transfer.mesh->nodeIDs));
+    transfer.requests.push_back(
+            serverComm->receiveFromClientNonBlocking<int>(name, numElems,
+                    transfer.mesh->numNodesPerElem));
+    if (!transfer.elems.empty())
+        transfer.requests.push_back(
+                serverComm->receiveFromClientNonBlocking<int>(name, transfer.elems.size(),
+                        &transfer.elems[0]));
+}
+
+void ClientCode::finishRecvFEMesh(std::string meshName) {
+    assert(serverComm != NULL);
+    map<string, PendingMeshTransfer>::iterator it = pendingMeshTransfers.find(meshName);
+    assert(it != pendingMeshTransfers.end());
+
+    for (int i = 0; i < it->second.requests.size(); i++)
+        serverComm->waitForRequest(it->second.requests[i]);
+    if (!it->second.partitions.empty())
+        mergeMeshPartitions(meshName, it->second);
+    FEMesh *mesh = it->second.mesh;
     mesh->initElems();
-    serverComm->receiveFromClientBlocking<int>(name, mesh->elemsArraySize, mesh->elems);
-	nameToMeshMap.insert(pair<string, AbstractMesh*>(meshName, mesh));
+    assert(mesh->elemsArraySize == it->second.elems.size());
+    if (mesh->elemsArraySize > 0)
+        memcpy(mesh->elems, &it->second.elems[0], mesh->elemsArraySize * sizeof(int));
+    mesh->renumber(it->second.renumbering);
+    pendingMeshTransfers.erase(it);
+    // the node IDs are fixed from now on, the index, connectivity and geometry of the mesh are
+    // computed once here and shared by the mappers and filters
+    mesh->prepare();
+    // the hash identifies the mesh if it is sent again unchanged
+    mesh->updateContentHash();
+    nameToMeshMap.insert(pair<string, AbstractMesh*>(meshName, mesh));
     { // output to shell
         DEBUG_OUT() << (*mesh) << endl;
-        mesh->computeBoundingBox();
         INFO_OUT() << mesh->boundingBox << endl;
     }
 }
 
+void ClientCode::mergeMeshPartitions(std::string meshName, PendingMeshTransfer &transfer) {
+    int numPartitions = transfer.partitions.size();
+    MeshPartitions &meshPartitions = partitionedMeshes[meshName];
+    meshPartitions.nodePositions.resize(numPartitions);
+    meshPartitions.elemOffsets.assign(numPartitions + 1, 0);
+    // a node shared by several partitions is kept at its first occurrence, i.e. the lowest rank
+    map<int, int> nodeIDToPosition;
+    vector<int> nodeIDs;
+    int elemsArraySize = 0;
+    for (int r = 0; r < numPartitions; r++) {
+        const MeshPartition &partition = transfer.partitions[r];
+        vector<int> &positions = meshPartitions.nodePositions[r];
+        positions.resize(partition.meshInfo[0]);
+        for (int i = 0; i < partition.meshInfo[0]; i++) {
+            pair<map<int, int>::iterator, bool> inserted = nodeIDToPosition.insert(
+                    pair<int, int>(partition.nodeIDs[i], nodeIDs.size()));
+            if (inserted.second) {
+                nodeIDs.push_back(partition.nodeIDs[i]);
+                meshPartitions.nodeOwners.push_back(r);
+            }
+            positions[i] = inserted.first->second;
+        }
+        meshPartitions.elemOffsets[r + 1] = meshPartitions.elemOffsets[r] + partition.meshInfo[1];
+        elemsArraySize += partition.meshInfo[2];
+    }
+
+    int numNodes = nodeIDs.size();
+    int numElems = meshPartitions.elemOffsets[numPartitions];
+    FEMesh *mesh = new FEMesh(meshName, numNodes, numElems, transfer.triangulateAll);
+    if (numNodes > 0)
+        memcpy(mesh->nodeIDs, &nodeIDs[0], numNodes * sizeof(int));
+    // the elements refer to the node IDs, so that they are concatenated as they are
+    transfer.elems.reserve(elemsArraySize);
+    for (int r = 0; r < numPartitions; r++) {
+        const MeshPartition &partition = transfer.partitions[r];
+        const vector<int> &positions = meshPartitions.nodePositions[r];
+        for (int i = 0; i < positions.size(); i++)
+            if (meshPartitions.nodeOwners[positions[i]] == r)
+                for (int j = 0; j < 3; j++)
+                    mesh->nodes[positions[i] * 3 + j] = partition.nodes[i * 3 + j];
+        for (int i = 0; i < partition.meshInfo[1]; i++)
+            mesh->numNodesPerElem[meshPartitions.elemOffsets[r] + i] = partition.numNodesPerElem[i];
+        transfer.elems.insert(transfer.elems.end(), partition.elems.begin(),
+                partition.elems.end());
+    }
+    transfer.mesh = mesh;
+    transfer.partitions.clear();
+    INFO_OUT() << "merged " << numPartitions << " partitions of mesh (" << meshName << ")" << endl;
+}
+
 void ClientCode::recvSectionMesh(std::string meshName, bool triangulateAll) {
     assert(serverComm != NULL);
     assert(nameToMeshMap.find(meshName) == nameToMeshMap.end());
 
-    const int BUFFER_SIZE = 2;
-    int meshInfo[BUFFER_SIZE]; // number of nodes, number of elements, number of nodes per element
+    const int BUFFER_SIZE = 3;
+    int meshInfo[BUFFER_SIZE]; // number of nodes, number of elements, size of the elements array
     { // output to shell
         HEADING_OUT(3, "ClientCode", "receiving mesh (" + meshName + ") from [" + name + "]...",
                 infoOut);
@@ -107,6 +344,7 @@ void ClientCode::recvSectionMesh(std::string meshName, bool triangulateAll) {
     serverComm->receiveFromClientBlocking<int>(name, numElems, mesh->numNodesPerElem);
     mesh->initElems();
     serverComm->receiveFromClientBlocking<int>(name, mesh->elemsArraySize, mesh->elems);
+    mesh->getNodeIndex();
 
     const int SECTION_INFO_SIZE = 4;
     int sectionInfo[4]; // number of sections, number of root section nodes, number of normal section nodes, number of tip section nodes
@@ -122,6 +360,7 @@ void ClientCode::recvSectionMesh(std::string meshName, bool triangulateAll) {
     serverComm->receiveFromClientBlocking<double>(name, 3, translationGlobal2Root);
     mesh->setRotationGlobal2Root(rotationGlobal2Root);
     mesh->setTranslationGlobal2Root(translationGlobal2Root);
+    mesh->updateContentHash();
 
     nameToMeshMap.insert(pair<string, AbstractMesh*>(meshName, mesh));
     { // output to shell
@@ -131,8 +370,43 @@ void ClientCode::recvSectionMesh(std::string meshName, bool triangulateAll) {
     }
 }
 
+void ClientCode::recvMeshCoordinates(std::string meshName) {
+    assert(serverComm != NULL);
+    FEMesh *mesh = dynamic_cast<FEMesh*>(getMeshByName(meshName));
+    if (mesh == NULL || partitionedMeshes.find(meshName) != partitionedMeshes.end()) {
+        ERROR_OUT() << "The coordinates of (" << meshName << ") of [" << name
+                << "] cannot be received, it is no FE mesh or partitioned" << endl;
+        exit(-1);
+    }
+    { // output to shell
+        string info = "Emperor is receiving the coordinates of (" + meshName + ") from [" + name
+                + "] ...";
+        INDENT_OUT(1, info, infoOut);
+    }
+    int numNodes = -1;
+    serverComm->receiveFromClientBlocking<int>(name, 1, &numNodes);
+    if (numNodes != mesh->numNodes) {
+        ERROR_OUT() << "The number of nodes of (" << meshName << ") of [" << name
+                << "] must not change, received " << numNodes << " instead of " << mesh->numNodes
+                << endl;
+        exit(-1);
+    }
+    const FEMesh *renumberedMesh = getRenumberedMesh(meshName);
+    if (renumberedMesh == NULL) {
+        serverComm->receiveFromClientBlocking<double>(name, numNodes * 3, mesh->nodes);
+    } else { // the coordinates arrive in the order of the client
+        vector<double> clientOrderNodes(numNodes * 3);
+        serverComm->receiveFromClientBlocking<double>(name, numNodes * 3, &clientOrderNodes[0]);
+        renumberedMesh->fromClientOrder(EMPIRE_DataField_atNode, 3, &clientOrderNodes[0],
+                mesh->nodes);
+    }
+    mesh->invalidateSpatialIndex(); // also copies the nodes to the triangulated mesh
+    mesh->updateContentHash();
+}
+
 void ClientCode::sendMesh(std::string meshName){
     assert(serverComm != NULL);
+    sendPendingConvergenceSignal();
 //    assert(nameToMeshMap.find(meshName) == nameToMeshMap.end());
 
     AbstractMesh *mesh = this->getMeshByName(meshName);
@@ -181,10 +455,11 @@ void ClientCode::copyMesh(std::string meshName, AbstractMesh *meshToCopyFrom) {
         for (int i = 0; i < copyMesh->elemsArraySize; i++){
             copyMesh->elems[i] = femesh->elems[i];
         }
+        copyMesh->prepare();
+        copyMesh->updateContentHash();
         nameToMeshMap.insert(pair<string, AbstractMesh*>(meshName, copyMesh));
         { // output to shell
             DEBUG_OUT() << (*copyMesh) << endl;
-            copyMesh->computeBoundingBox();
             INFO_OUT() << copyMesh->boundingBox << endl;
         }
     } else if (meshToCopyFrom->type == EMPIRE_Mesh_IGAMesh) {
@@ -273,9 +548,33 @@ void ClientCode::copyMesh(std::string meshName, AbstractMesh *meshToCopyFrom) {
 
                     } // end curve
                 } // end trimming loops
-                thePatch->linearizeTrimming();
             } // end isTrimmed
         } // end patch
+        copyMesh->setTrimmingLinearizationType(igaMesh->getTrimmingLinearizationType());
+        copyMesh->preparePatches();
+
+        // The weak conditions share the GP data of the mesh copied from instead of creating them again
+        const std::vector<WeakIGADirichletCurveCondition*>& curveConditions = igaMesh->getWeakIGADirichletCurveConditions();
+        for (int i = 0; i < curveConditions.size(); i++) {
+            const WeakIGADirichletCurveCondition* condition = curveConditions[i];
+            assert(condition->getPatchBLIndex() >= 0);
+            copyMesh->addWeakDirichletCurveCondition(i, condition->getPatchIndex(), condition->getPatchBLIndex(),
+                    condition->getPatchBLTrCurveIndex())->addWeakDirichletCurveConditionGPData(
+                    condition->getCurveNumGP(), condition->getCurveGPs(), condition->getCurveGPWeights(),
+                    condition->getCurveGPTangents(), condition->getCurveGPJacobianProducts());
+        }
+        const std::vector<WeakIGAPatchContinuityCondition*>& continuityConditions = igaMesh->getWeakIGAPatchContinuityConditions();
+        for (int i = 0; i < continuityConditions.size(); i++) {
+            const WeakIGAPatchContinuityCondition* condition = continuityConditions[i];
+            copyMesh->addWeakContinuityCondition(i,
+                    condition->getMasterPatchIndex(), condition->getMasterPatchBLIndex(), condition->getMasterPatchBLTrCurveIndex(),
+                    condition->getSlavePatchIndex(), condition->getSlavePatchBLIndex(), condition->getSlavePatchBLTrCurveIndex())
+                    ->addWeakContinuityConditionGPData(condition->getTrCurveNumGP(),
+                    condition->getTrCurveMasterGPs(), condition->getTrCurveSlaveGPs(), condition->getTrCurveGPWeights(),
+                    condition->getTrCurveMasterGPTangents(), condition->getTrCurveSlaveGPTangents(),
+                    condition->getTrCurveGPJacobianProducts());
+        }
+        copyMesh->updateContentHash();
         nameToMeshMap.insert(pair<string, AbstractMesh*>(meshName, copyMesh));
         { // output to shell
             DEBUG_OUT() << (*copyMesh) << endl;
@@ -287,7 +586,8 @@ void ClientCode::copyMesh(std::string meshName, AbstractMesh *meshToCopyFrom) {
     }
 }
 
-void ClientCode::recvIGAMesh(std::string meshName) {
+void ClientCode::recvIGAMesh(std::string meshName, std::string conditionGPDataCache,
+        int trimmingLinearizationType) {
     assert(serverComm != NULL);
     assert(nameToMeshMap.find(meshName) == nameToMeshMap.end());
 
@@ -304,11 +604,29 @@ void ClientCode::recvIGAMesh(std::string meshName) {
 
     IGAMesh* theIGAMesh = new IGAMesh(meshName, numNodes);
 
+    // all patches and their trimming come as one packed message of ints and one of doubles
+    int packInfo[2] = { 0, 0 }; // number of ints, number of doubles
+    vector<int> intPack(1);
+    vector<double> doublePack(1);
+    if (numPatches > 0) {
+        serverComm->receiveFromClientBlocking<int>(name, 2, packInfo);
+        intPack.resize(packInfo[0] + 1);
+        doublePack.resize(packInfo[1] + 1);
+        int packRequests[2];
+        packRequests[0] = serverComm->receiveFromClientNonBlocking<int>(name, packInfo[0],
+                &intPack[0]);
+        packRequests[1] = serverComm->receiveFromClientNonBlocking<double>(name, packInfo[1],
+                &doublePack[0]);
+        serverComm->waitForRequest(packRequests[0]);
+        serverComm->waitForRequest(packRequests[1]);
+    }
+    int *ints = &intPack[0];
+    double *doubles = &doublePack[0];
+
     const int BUFFER_SIZE_PATCH = 6;
-    int patchInfo[BUFFER_SIZE_PATCH];
     for (int patchCount = 0; patchCount < numPatches; patchCount++) {
-
-        serverComm->receiveFromClientBlocking<int>(name, BUFFER_SIZE_PATCH, patchInfo);
+        int *patchInfo = ints;
+        ints += BUFFER_SIZE_PATCH;
 
         int pDegree = patchInfo[0];
         int uNoKnots = patchInfo[1];
@@ -317,30 +635,21 @@ void ClientCode::recvIGAMesh(std::string meshName) {
         int uNoControlPoints = patchInfo[4];
         int vNoControlPoints = patchInfo[5];
 
-        double* uKnotVector = new double[uNoKnots];
-        double* vKnotVector = new double[vNoKnots];
-        double* controlPointNet = new double[uNoControlPoints * vNoControlPoints * 4];
-        int* dofIndexNet = new int[uNoControlPoints * vNoControlPoints];
-
-        serverComm->receiveFromClientBlocking<double>(name, uNoKnots, uKnotVector);
-        serverComm->receiveFromClientBlocking<double>(name, vNoKnots, vKnotVector);
-        serverComm->receiveFromClientBlocking<double>(name, uNoControlPoints * vNoControlPoints * 4,
-                controlPointNet);
-        serverComm->receiveFromClientBlocking<int>(name, uNoControlPoints * vNoControlPoints,
-                dofIndexNet);
+        double* uKnotVector = doubles;
+        doubles += uNoKnots;
+        double* vKnotVector = doubles;
+        doubles += vNoKnots;
+        double* controlPointNet = doubles;
+        doubles += uNoControlPoints * vNoControlPoints * 4;
+        int* dofIndexNet = ints;
+        ints += uNoControlPoints * vNoControlPoints;
 
         IGAPatchSurface* thePatch = theIGAMesh->addPatch(pDegree, uNoKnots, uKnotVector, qDegree, vNoKnots, vKnotVector,
                 uNoControlPoints, vNoControlPoints, controlPointNet, dofIndexNet);
 
-        // deleting the pointers after object creation
-        delete uKnotVector;
-        delete vKnotVector;
-        delete controlPointNet;
-        delete dofIndexNet;
-
         // Add and linearize the trimming curves
-        int trimInfo[2];
-        serverComm->receiveFromClientBlocking<int>(name, 2, trimInfo);
+        int *trimInfo = ints;
+        ints += 2;
         int isTrimmed = trimInfo[0];
         int numLoops = trimInfo[1];
         if(isTrimmed) {
@@ -348,41 +657,45 @@ void ClientCode::recvIGAMesh(std::string meshName) {
             //Get every loop
             for(int loopCount = 0; loopCount < numLoops; loopCount++) {
                 const int BUFFER_SIZE_TRIM = 2;
-                int loopInfo[BUFFER_SIZE_TRIM];
-                serverComm->receiveFromClientBlocking<int>(name, BUFFER_SIZE_TRIM, loopInfo);
+                int *loopInfo = ints;
+                ints += BUFFER_SIZE_TRIM;
 
                 int inner = loopInfo[0];
                 int numCurves = loopInfo[1];
                 thePatch->addTrimLoop(inner, numCurves);
                 
                 const int BUFFER_SIZE_CURVE = 4;
-                int curveInfo[BUFFER_SIZE_CURVE];
                 //Get every curve
                 for(int curveCount = 0; curveCount < numCurves; curveCount++) {
-                    serverComm->receiveFromClientBlocking<int>(name, BUFFER_SIZE_CURVE, curveInfo);
+                    int *curveInfo = ints;
+                    ints += BUFFER_SIZE_CURVE;
                     
                     int direction = curveInfo[0];
                     int pDegree = curveInfo[1];
                     int uNoKnots = curveInfo[2];
                     int uNoControlPoints = curveInfo[3];
                     
-                    double* uKnotVector = new double[uNoKnots];
-                    double controlPointNet[uNoControlPoints * 4];
-
-                    serverComm->receiveFromClientBlocking<double>(name, uNoKnots, uKnotVector);
-                    serverComm->receiveFromClientBlocking<double>(name, uNoControlPoints * 4, controlPointNet);
+                    double* uKnotVector = doubles;
+                    doubles += uNoKnots;
+                    double* controlPointNet = doubles;
+                    doubles += uNoControlPoints * 4;
 
                     thePatch->addTrimCurve(direction, pDegree, uNoKnots, uKnotVector,
                     		uNoControlPoints, controlPointNet);
 
-                    // deleting the pointers after object creation
-                    delete uKnotVector;
-
                 } // end curve
             } // end trimming loops
-            thePatch->linearizeTrimming();
         } // end isTrimmed
     } // end patch
+    assert(ints - &intPack[0] == packInfo[0]);
+    assert(doubles - &doublePack[0] == packInfo[1]);
+
+    // Linearize the trimming and compute the bounding boxes of all patches concurrently
+    theIGAMesh->setTrimmingLinearizationType(trimmingLinearizationType);
+    theIGAMesh->preparePatches();
+
+    // The conditions without Gauss point data are created concurrently once all are received
+    std::vector<AbstractCondition*> conditionsWithoutGPData;
 
     // weak dirichlet condition data
     int numWeakDirichletCond;
@@ -430,7 +743,7 @@ void ClientCode::recvIGAMesh(std::string meshName) {
             delete trCurveGPJacobianProducts;
 
         } else {
-            theIGAMesh->createWeakDirichletCurveConditionGPData(wDCCtr);
+            conditionsWithoutGPData.push_back(theWeakDirichletCurveCond);
         }
     }
 
@@ -490,10 +803,11 @@ void ClientCode::recvIGAMesh(std::string meshName) {
             delete trCurveGPJacobianProducts;
 
         } else {
-            theIGAMesh->createWeakContinuityConditionGPData(wPCCCtr);
+            conditionsWithoutGPData.push_back(theWeakContCond);
         }
 
     }
+    theIGAMesh->createConditionsGPData(conditionsWithoutGPData, conditionGPDataCache);
 
 //    // get the dirichlet boundary conditions
 //    int dirichletBCInfo[2];
@@ -515,14 +829,25 @@ void ClientCode::recvIGAMesh(std::string meshName) {
         INFO_OUT() << theIGAMesh->boundingBox << endl;
     }
 
+    // the hash covers the weak conditions, so it is computed after they have arrived
+    theIGAMesh->updateContentHash();
     nameToMeshMap.insert(pair<string, AbstractMesh*>(meshName, theIGAMesh));
 }
 
 void ClientCode::recvDataField(std::string meshName, std::string dataFieldName) {
+    if (startRecvDataField(meshName, dataFieldName) >= 0)
+        finishRecvDataField(meshName, dataFieldName);
+}
+
+void ClientCode::sendDataField(std::string meshName, std::string dataFieldName) {
+    if (startSendDataField(meshName, dataFieldName) >= 0)
+        finishSendDataField(meshName, dataFieldName);
+}
+
+int ClientCode::startRecvDataField(std::string meshName, std::string dataFieldName) {
     assert(serverComm != NULL);
-    assert(nameToMeshMap.find(meshName) != nameToMeshMap.end());
-    AbstractMesh *mesh = nameToMeshMap[meshName];
-    DataField *df = mesh->getDataFieldByName(dataFieldName);
+    DataField *df = getDataField(meshName, dataFieldName);
+    assert(pendingDataFieldTransfers.find(df) == pendingDataFieldTransfers.end());
 
     { // output to shell
         string info = "Emperor is receiving (" + meshName + ": " + dataFieldName + ") from [" + name
@@ -530,20 +855,202 @@ void ClientCode::recvDataField(std::string meshName, std::string dataFieldName)
         INDENT_OUT(1, info, infoOut);
     }
 
-    int sizeClientSay = -1;
-    serverComm->receiveFromClientBlocking<int>(name, 1, &sizeClientSay);
-    int bufferSize = df->numLocations * df->dimension;
-    assert(bufferSize == sizeClientSay);
+    PendingDataFieldTransfer &transfer = pendingDataFieldTransfers[df];
+    vector<vector<double> > *buffers = getPartitionBuffers(meshName, df);
+    if (buffers != NULL) { // every process sends its values with their size as header
+        transfer.size = df->numLocations * df->dimension;
+        transfer.sizeRequest = -1;
+        transfer.partitionSizes.assign(buffers->size(), -1);
+        for (int r = 0; r < buffers->size(); r++) {
+            vector<double> &buffer = (*buffers)[r];
+            transfer.partitionRequests.push_back(
+                    serverComm->receiveFromClientRankNonBlocking<int>(name, r, 1,
+                            &transfer.partitionSizes[r]));
+            if (!buffer.empty())
+                transfer.partitionRequests.push_back(
+                        serverComm->receiveFromClientRankNonBlocking<double>(name, r,
+                                buffer.size(), &buffer[0]));
+        }
+        transfer.dataRequest = transfer.partitionRequests.back();
+        return transfer.dataRequest;
+    }
+    EncodedDataField *encoded = getEncodedDataField(df);
+    if (encoded != NULL) { // the size header holds the number of bytes
+        transfer.size = -1;
+        transfer.sizeRequest = serverComm->receiveFromClientNonBlocking<int>(name, 1,
+                &transfer.size);
+        transfer.dataRequest = serverComm->receiveFromClientNonBlocking<unsigned char>(name,
+                encoded->buffer.size(), &encoded->buffer[0]);
+        return transfer.dataRequest;
+    }
+    int chunkSize = getDataFieldChunkSize(meshName, df);
+    if (chunkSize > 0) { // all chunks are posted behind the size header, they arrive in order
+        int size = df->numLocations * df->dimension;
+        transfer.size = -1;
+        transfer.sizeRequest = serverComm->receiveFromClientNonBlocking<int>(name, 1,
+                &transfer.size);
+        postDataFieldChunks(transfer, false, getClientOrderData(meshName, df), size, chunkSize,
+                getNumChunks(size, chunkSize));
+        transfer.dataRequest = transfer.chunkRequests.empty() ?
+                transfer.sizeRequest : transfer.chunkRequests.back();
+        return transfer.dataRequest;
+    }
+    if (isDataFieldSkipUnchanged(meshName, df)) {
+        // unchanged values are sent as an empty message, which leaves the buffer as it is
+        transfer.size = -1;
+        transfer.sizeRequest = serverComm->receiveFromClientNonBlocking<int>(name, 1,
+                &transfer.size);
+        transfer.dataRequest = serverComm->receiveFromClientNonBlocking<double>(name,
+                df->numLocations * df->dimension, getClientOrderData(meshName, df));
+        return transfer.dataRequest;
+    }
+    map<DataField*, int>::iterator persistent = persistentRecvRequests.find(df);
+    if (persistent != persistentRecvRequests.end()) { // no size header after the first transfer
+        transfer.size = df->numLocations * df->dimension;
+        transfer.sizeRequest = -1;
+        transfer.dataRequest = persistent->second;
+        serverComm->startRequest(transfer.dataRequest);
+        return transfer.dataRequest;
+    }
+    transfer.size = -1;
+    transfer.sizeRequest = serverComm->receiveFromClientNonBlocking<int>(name, 1, &transfer.size);
+    transfer.dataRequest = serverComm->receiveFromClientNonBlocking<double>(name,
+            df->numLocations * df->dimension, getClientOrderData(meshName, df));
+    if (sharedMemoryDataFieldTransfer) {
+        // the segment offer must not be matched by a receive posted for another data field, so
+        // the first transfer is completed before the next one is posted
+        finishRecvDataField(meshName, dataFieldName);
+        return -1;
+    }
+    return transfer.dataRequest;
+}
 
-    serverComm->receiveFromClientBlocking<double>(name, bufferSize, df->data);
+void ClientCode::finishRecvDataField(std::string meshName, std::string dataFieldName) {
+    assert(serverComm != NULL);
+    DataField *df = getDataField(meshName, dataFieldName);
+    map<DataField*, PendingDataFieldTransfer>::iterator it = pendingDataFieldTransfers.find(df);
+    assert(it != pendingDataFieldTransfers.end());
+
+    double startTime = ServerCommunication::isTransferProfiled() ? omp_get_wtime() : 0.0;
+    vector<vector<double> > *buffers = getPartitionBuffers(meshName, df);
+    if (buffers != NULL) {
+        {
+            PROFILER_SCOPE(profilerRecvName);
+            for (int i = 0; i < it->second.partitionRequests.size(); i++)
+                serverComm->waitForRequest(it->second.partitionRequests[i]);
+        }
+        if (ServerCommunication::isTransferProfiled())
+            serverComm->profileTransfer(name, "(" + meshName + ": " + dataFieldName + ")", false,
+                    startTime, -1.0, df->numLocations * df->dimension * sizeof(double));
+        // every value is set by the process which owns its location
+        const MeshPartitions &partitions = partitionedMeshes[meshName];
+        double *clientOrderData = getClientOrderData(meshName, df);
+        int dimension = df->dimension;
+        for (int r = 0; r < buffers->size(); r++) {
+            const vector<double> &buffer = (*buffers)[r];
+            assert(it->second.partitionSizes[r] == buffer.size());
+            if (df->location == EMPIRE_DataField_atNode) {
+                const vector<int> &positions = partitions.nodePositions[r];
+                for (int i = 0; i < positions.size(); i++)
+                    if (partitions.nodeOwners[positions[i]] == r)
+                        for (int j = 0; j < dimension; j++)
+                            clientOrderData[positions[i] * dimension + j] = buffer[i * dimension
+                                    + j];
+            } else if (!buffer.empty()) {
+                memcpy(clientOrderData + partitions.elemOffsets[r] * dimension, &buffer[0],
+                        buffer.size() * sizeof(double));
+            }
+        }
+        const FEMesh *renumberedMesh = getRenumberedMesh(meshName);
+        if (renumberedMesh != NULL)
+            renumberedMesh->fromClientOrder(df->location, df->dimension, clientOrderData, df->data);
+        pendingDataFieldTransfers.erase(it);
+        DEBUG_OUT() << (*df) << endl;
+        return;
+    }
+    if (getDataFieldChunkSize(meshName, df) > 0) {
+        {
+            PROFILER_SCOPE(profilerRecvName);
+            waitForDataFieldChunks(it->second, it->second.chunkRequests.size());
+        }
+        assert(it->second.size == df->numLocations * df->dimension);
+        if (ServerCommunication::isTransferProfiled())
+            serverComm->profileTransfer(name, "(" + meshName + ": " + dataFieldName + ")", false,
+                    startTime, -1.0, df->numLocations * df->dimension * sizeof(double));
+        const FEMesh *renumberedMesh = getRenumberedMesh(meshName);
+        if (renumberedMesh != NULL)
+            renumberedMesh->fromClientOrder(df->location, df->dimension,
+                    getClientOrderData(meshName, df), df->data);
+        pendingDataFieldTransfers.erase(it);
+        DEBUG_OUT() << (*df) << endl;
+        return;
+    }
+    if (getEncodedDataField(df) == NULL && isDataFieldSkipUnchanged(meshName, df)) {
+        {
+            PROFILER_SCOPE(profilerRecvName);
+            serverComm->waitForRequest(it->second.sizeRequest);
+            serverComm->waitForRequest(it->second.dataRequest);
+        }
+        if (it->second.size == UNCHANGED_DATA_FIELD) {
+            INDENT_OUT(1, "... unchanged, the values are kept", infoOut);
+            pendingDataFieldTransfers.erase(it);
+            return;
+        }
+        assert(it->second.size == df->numLocations * df->dimension);
+        if (ServerCommunication::isTransferProfiled())
+            serverComm->profileTransfer(name, "(" + meshName + ": " + dataFieldName + ")", false,
+                    startTime, -1.0, df->numLocations * df->dimension * sizeof(double));
+        const FEMesh *renumberedMesh = getRenumberedMesh(meshName);
+        if (renumberedMesh != NULL)
+            renumberedMesh->fromClientOrder(df->location, df->dimension,
+                    getClientOrderData(meshName, df), df->data);
+        pendingDataFieldTransfers.erase(it);
+        DEBUG_OUT() << (*df) << endl;
+        return;
+    }
+    {
+        PROFILER_SCOPE(profilerRecvName);
+        if (it->second.sizeRequest >= 0)
+            serverComm->waitForRequest(it->second.sizeRequest);
+        serverComm->waitForRequest(it->second.dataRequest);
+    }
+    EncodedDataField *encoded = getEncodedDataField(df);
+    if (ServerCommunication::isTransferProfiled()) // the size of an encoded data field is in bytes
+        serverComm->profileTransfer(name, "(" + meshName + ": " + dataFieldName + ")", false,
+                startTime, -1.0,
+                encoded != NULL ? it->second.size : df->numLocations * df->dimension * sizeof(double));
+    // the data arrive in the order of the client
+    double *clientOrderData = getClientOrderData(meshName, df);
+    const FEMesh *renumberedMesh = getRenumberedMesh(meshName);
+    if (encoded != NULL) {
+        DataFieldCodec::decode(encoded->wireFormat, df->numLocations * df->dimension,
+                &encoded->buffer[0], it->second.size, &encoded->recvHistory[0], clientOrderData);
+        if (renumberedMesh != NULL)
+            renumberedMesh->fromClientOrder(df->location, df->dimension, clientOrderData, df->data);
+        pendingDataFieldTransfers.erase(it);
+        DEBUG_OUT() << (*df) << endl;
+        return;
+    }
+    assert(df->numLocations * df->dimension == it->second.size);
+    if (renumberedMesh != NULL)
+        renumberedMesh->fromClientOrder(df->location, df->dimension, clientOrderData, df->data);
+    SharedMemorySegment *segment = NULL;
+    if (sharedMemoryDataFieldTransfer && it->second.sizeRequest >= 0)
+        segment = offerSharedMemorySegment(it->second.size);
+    if (segment != NULL)
+        persistentRecvRequests[df] = serverComm->initReceiveFromClientBySharedMemory(segment,
+                clientOrderData);
+    else if (persistentDataFieldTransfer && it->second.sizeRequest >= 0)
+        persistentRecvRequests[df] = serverComm->initReceiveFromClient<double>(name,
+                df->numLocations * df->dimension, clientOrderData);
+    pendingDataFieldTransfers.erase(it);
     DEBUG_OUT() << (*df) << endl;
 }
 
-void ClientCode::sendDataField(std::string meshName, std::string dataFieldName) {
+int ClientCode::startSendDataField(std::string meshName, std::string dataFieldName) {
     assert(serverComm != NULL);
-    assert(nameToMeshMap.find(meshName) != nameToMeshMap.end());
-    AbstractMesh *mesh = nameToMeshMap[meshName];
-    DataField *df = mesh->getDataFieldByName(dataFieldName);
+    DataField *df = getDataField(meshName, dataFieldName);
+    assert(pendingDataFieldTransfers.find(df) == pendingDataFieldTransfers.end());
 
     { // output to shell
         string info = "Emperor is sending (" + meshName + ": " + dataFieldName + ") to [" + name
@@ -551,14 +1058,333 @@ void ClientCode::sendDataField(std::string meshName, std::string dataFieldName)
         INDENT_OUT(1, info, infoOut);
     }
 
-    int bufferSize = df->numLocations * df->dimension;
-    serverComm->sendToClientBlocking<int>(name, 1, &bufferSize);
-    serverComm->sendToClientBlocking<double>(name, bufferSize, df->data);
-    // debug
-    // (*df).writeToFile("sentData.dat","sent data from empire", "end");
+    PendingDataFieldTransfer &transfer = pendingDataFieldTransfers[df];
+    transfer.size = df->numLocations * df->dimension;
+    // all transfers below, including the persistent ones, send the buffer in the client order
+    double *clientOrderData = getClientOrderData(meshName, df);
+    const FEMesh *renumberedMesh = getRenumberedMesh(meshName);
+    if (renumberedMesh != NULL)
+        renumberedMesh->toClientOrder(df->location, df->dimension, df->data, clientOrderData);
+    vector<vector<double> > *buffers = getPartitionBuffers(meshName, df);
+    if (buffers != NULL) { // every process receives the values of its locations
+        sendPendingConvergenceSignal(); // the partition headers cannot carry it
+        const MeshPartitions &partitions = partitionedMeshes[meshName];
+        int dimension = df->dimension;
+        transfer.sizeRequest = -1;
+        transfer.partitionSizes.resize(buffers->size());
+        for (int r = 0; r < buffers->size(); r++) {
+            vector<double> &buffer = (*buffers)[r];
+            if (df->location == EMPIRE_DataField_atNode) {
+                const vector<int> &positions = partitions.nodePositions[r];
+                for (int i = 0; i < positions.size(); i++)
+                    for (int j = 0; j < dimension; j++)
+                        buffer[i * dimension + j] = clientOrderData[positions[i] * dimension + j];
+            } else if (!buffer.empty()) {
+                memcpy(&buffer[0], clientOrderData + partitions.elemOffsets[r] * dimension,
+                        buffer.size() * sizeof(double));
+            }
+            transfer.partitionSizes[r] = buffer.size();
+            transfer.partitionRequests.push_back(
+                    serverComm->sendToClientRankNonBlocking<int>(name, r, 1,
+                            &transfer.partitionSizes[r]));
+            if (!buffer.empty())
+                transfer.partitionRequests.push_back(
+                        serverComm->sendToClientRankNonBlocking<double>(name, r, buffer.size(),
+                                &buffer[0]));
+        }
+        transfer.dataRequest = transfer.partitionRequests.back();
+        return transfer.dataRequest;
+    }
+    EncodedDataField *encoded = getEncodedDataField(df);
+    if (encoded != NULL) { // the size header holds the number of bytes
+        transfer.size = DataFieldCodec::encode(encoded->wireFormat, transfer.size, clientOrderData,
+                &encoded->sendHistory[0], &encoded->buffer[0]);
+        transfer.header = getSizeHeader(transfer.size);
+        transfer.sizeRequest = serverComm->sendToClientNonBlocking<int>(name, 1, &transfer.header);
+        transfer.dataRequest = serverComm->sendToClientNonBlocking<unsigned char>(name,
+                transfer.size, &encoded->buffer[0]);
+        return transfer.dataRequest;
+    }
+    int chunkSize = getDataFieldChunkSize(meshName, df);
+    if (chunkSize > 0) {
+        transfer.header = getSizeHeader(transfer.size);
+        transfer.sizeRequest = serverComm->sendToClientNonBlocking<int>(name, 1, &transfer.header);
+        postDataFieldChunks(transfer, true, clientOrderData, transfer.size, chunkSize,
+                getNumChunks(transfer.size, chunkSize));
+        transfer.dataRequest = transfer.chunkRequests.empty() ?
+                transfer.sizeRequest : transfer.chunkRequests.back();
+        return transfer.dataRequest;
+    }
+    if (isDataFieldSkipUnchanged(meshName, df)) { // only the flag is sent if nothing has changed
+        vector<double> &lastSent = lastSentDataFields[df];
+        if (lastSent.size() == transfer.size && (transfer.size == 0
+                || memcmp(&lastSent[0], clientOrderData, transfer.size * sizeof(double)) == 0)) {
+            transfer.size = UNCHANGED_DATA_FIELD;
+            transfer.header = getSizeHeader(transfer.size);
+            transfer.sizeRequest = serverComm->sendToClientNonBlocking<int>(name, 1,
+                    &transfer.header);
+            // the empty message completes the receive the client has posted for the values
+            transfer.dataRequest = serverComm->sendToClientNonBlocking<double>(name, 0,
+                    clientOrderData);
+            INDENT_OUT(1, "... unchanged, only the flag is sent", infoOut);
+            return transfer.dataRequest;
+        }
+        lastSent.assign(clientOrderData, clientOrderData + transfer.size);
+        transfer.header = getSizeHeader(transfer.size);
+        transfer.sizeRequest = serverComm->sendToClientNonBlocking<int>(name, 1, &transfer.header);
+        transfer.dataRequest = serverComm->sendToClientNonBlocking<double>(name, transfer.size,
+                clientOrderData);
+        return transfer.dataRequest;
+    }
+    map<DataField*, int>::iterator persistent = persistentSendRequests.find(df);
+    if (persistent != persistentSendRequests.end()) { // no size header after the first transfer
+        sendPendingConvergenceSignal();
+        transfer.sizeRequest = -1;
+        transfer.dataRequest = persistent->second;
+        serverComm->startRequest(transfer.dataRequest);
+        return transfer.dataRequest;
+    }
+    transfer.header = getSizeHeader(transfer.size);
+    transfer.sizeRequest = serverComm->sendToClientNonBlocking<int>(name, 1, &transfer.header);
+    transfer.dataRequest = serverComm->sendToClientNonBlocking<double>(name, transfer.size,
+            clientOrderData);
+    if (sharedMemoryDataFieldTransfer) { // see startRecvDataField
+        finishSendDataField(meshName, dataFieldName);
+        return -1;
+    }
+    return transfer.dataRequest;
+}
+
+void ClientCode::finishSendDataField(std::string meshName, std::string dataFieldName) {
+    assert(serverComm != NULL);
+    DataField *df = getDataField(meshName, dataFieldName);
+    map<DataField*, PendingDataFieldTransfer>::iterator it = pendingDataFieldTransfers.find(df);
+    assert(it != pendingDataFieldTransfers.end());
+
+    double startTime = ServerCommunication::isTransferProfiled() ? omp_get_wtime() : 0.0;
+    if (getPartitionBuffers(meshName, df) != NULL) {
+        {
+            PROFILER_SCOPE(profilerSendName);
+            for (int i = 0; i < it->second.partitionRequests.size(); i++)
+                serverComm->waitForRequest(it->second.partitionRequests[i]);
+        }
+        if (ServerCommunication::isTransferProfiled())
+            serverComm->profileTransfer(name, "(" + meshName + ": " + dataFieldName + ")", true,
+                    startTime, -1.0, it->second.size * sizeof(double));
+        pendingDataFieldTransfers.erase(it);
+        DEBUG_OUT() << (*df) << endl;
+        return;
+    }
+    int chunkSize = getDataFieldChunkSize(meshName, df);
+    if (chunkSize > 0) {
+        assert(it->second.chunkRequests.size() == getNumChunks(it->second.size, chunkSize));
+        {
+            PROFILER_SCOPE(profilerSendName);
+            waitForDataFieldChunks(it->second, it->second.chunkRequests.size());
+        }
+        if (ServerCommunication::isTransferProfiled())
+            serverComm->profileTransfer(name, "(" + meshName + ": " + dataFieldName + ")", true,
+                    startTime, -1.0, it->second.size * sizeof(double));
+        pendingDataFieldTransfers.erase(it);
+        DEBUG_OUT() << (*df) << endl;
+        return;
+    }
+    if (it->second.size == UNCHANGED_DATA_FIELD) { // only the flag and an empty message are sent
+        {
+            PROFILER_SCOPE(profilerSendName);
+            serverComm->waitForRequest(it->second.sizeRequest);
+            serverComm->waitForRequest(it->second.dataRequest);
+        }
+        pendingDataFieldTransfers.erase(it);
+        return;
+    }
+    {
+        PROFILER_SCOPE(profilerSendName);
+        if (it->second.sizeRequest >= 0)
+            serverComm->waitForRequest(it->second.sizeRequest);
+        serverComm->waitForRequest(it->second.dataRequest);
+    }
+    if (ServerCommunication::isTransferProfiled()) // the size of an encoded data field is in bytes
+        serverComm->profileTransfer(name, "(" + meshName + ": " + dataFieldName + ")", true,
+                startTime, -1.0, getEncodedDataField(df) != NULL ?
+                        it->second.size : it->second.size * sizeof(double));
+    if (getEncodedDataField(df) != NULL || isDataFieldSkipUnchanged(meshName, df)) {
+        pendingDataFieldTransfers.erase(it);
+        DEBUG_OUT() << (*df) << endl;
+        return;
+    }
+    SharedMemorySegment *segment = NULL;
+    if (sharedMemoryDataFieldTransfer && it->second.sizeRequest >= 0)
+        segment = offerSharedMemorySegment(it->second.size);
+    if (segment != NULL)
+        persistentSendRequests[df] = serverComm->initSendToClientBySharedMemory(segment,
+                getClientOrderData(meshName, df));
+    else if (persistentDataFieldTransfer && it->second.sizeRequest >= 0)
+        persistentSendRequests[df] = serverComm->initSendToClient<double>(name, it->second.size,
+                getClientOrderData(meshName, df));
+    pendingDataFieldTransfers.erase(it);
     DEBUG_OUT() << (*df) << endl;
 }
 
+void ClientCode::waitForDataFieldChunks(std::string meshName, std::string dataFieldName,
+        int numChunks) {
+    DataField *df = getDataField(meshName, dataFieldName);
+    map<DataField*, PendingDataFieldTransfer>::iterator it = pendingDataFieldTransfers.find(df);
+    assert(it != pendingDataFieldTransfers.end());
+    assert(isDataFieldPipelined(meshName, dataFieldName));
+    PROFILER_SCOPE(profilerRecvName);
+    waitForDataFieldChunks(it->second, numChunks);
+}
+
+void ClientCode::startPipelinedSendDataField(std::string meshName, std::string dataFieldName) {
+    assert(serverComm != NULL);
+    assert(isDataFieldPipelined(meshName, dataFieldName));
+    DataField *df = getDataField(meshName, dataFieldName);
+    assert(pendingDataFieldTransfers.find(df) == pendingDataFieldTransfers.end());
+
+    { // output to shell
+        string info = "Emperor is sending (" + meshName + ": " + dataFieldName + ") to [" + name
+                + "] in chunks ...";
+        INDENT_OUT(1, info, infoOut);
+    }
+
+    PendingDataFieldTransfer &transfer = pendingDataFieldTransfers[df];
+    transfer.size = df->numLocations * df->dimension;
+    transfer.header = getSizeHeader(transfer.size);
+    transfer.sizeRequest = serverComm->sendToClientNonBlocking<int>(name, 1, &transfer.header);
+    transfer.dataRequest = transfer.sizeRequest;
+}
+
+void ClientCode::sendDataFieldChunks(std::string meshName, std::string dataFieldName,
+        int numChunks) {
+    DataField *df = getDataField(meshName, dataFieldName);
+    map<DataField*, PendingDataFieldTransfer>::iterator it = pendingDataFieldTransfers.find(df);
+    assert(it != pendingDataFieldTransfers.end());
+    // the mesh is in the order of the client, so the data are sent directly
+    postDataFieldChunks(it->second, true, df->data, it->second.size,
+            getDataFieldChunkSize(meshName, df), numChunks);
+}
+
+int ClientCode::getDataFieldChunkSize(std::string meshName, DataField *df) {
+    // the data fields of a partitioned mesh are split into the partitions already
+    if (partitionedMeshes.find(meshName) != partitionedMeshes.end())
+        return 0;
+    map<DataField*, int>::iterator it = dataFieldChunkSizes.find(df);
+    if (it == dataFieldChunkSizes.end())
+        return 0;
+    return it->second;
+}
+
+bool ClientCode::isDataFieldSkipUnchanged(std::string meshName, DataField *df) {
+    // the data fields of a partitioned mesh have a size header per process
+    if (partitionedMeshes.find(meshName) != partitionedMeshes.end())
+        return false;
+    map<DataField*, bool>::iterator it = dataFieldSkipUnchanged.find(df);
+    return it != dataFieldSkipUnchanged.end() && it->second;
+}
+
+void ClientCode::postDataFieldChunks(PendingDataFieldTransfer &transfer, bool isSend,
+        double *data, int size, int chunkSize, int numChunks) {
+    assert(chunkSize > 0 && numChunks <= getNumChunks(size, chunkSize));
+    for (int chunk = transfer.chunkRequests.size(); chunk < numChunks; chunk++) {
+        int begin = chunk * chunkSize;
+        int chunkLength = min(chunkSize, size - begin);
+        if (isSend)
+            transfer.chunkRequests.push_back(
+                    serverComm->sendToClientNonBlocking<double>(name, chunkLength, data + begin));
+        else
+            transfer.chunkRequests.push_back(
+                    serverComm->receiveFromClientNonBlocking<double>(name, chunkLength,
+                            data + begin));
+    }
+}
+
+void ClientCode::waitForDataFieldChunks(PendingDataFieldTransfer &transfer, int numChunks) {
+    assert(numChunks <= transfer.chunkRequests.size());
+    if (transfer.sizeRequest >= 0) {
+        serverComm->waitForRequest(transfer.sizeRequest);
+        transfer.sizeRequest = -1;
+    }
+    for (; transfer.numCompletedChunks < numChunks; transfer.numCompletedChunks++)
+        serverComm->waitForRequest(transfer.chunkRequests[transfer.numCompletedChunks]);
+}
+
+SharedMemorySegment *ClientCode::offerSharedMemorySegment(int size) {
+    SharedMemorySegment *segment = SharedMemorySegment::create(size);
+    char segmentName[ServerCommunication::NAME_STRING_LENGTH];
+    int token = 0;
+    segmentName[0] = '\0';
+    if (segment != NULL) {
+        assert(segment->getName().size() < ServerCommunication::NAME_STRING_LENGTH);
+        strcpy(segmentName, segment->getName().c_str());
+        token = segment->getToken();
+    }
+    // an empty name tells the client that no segment is offered
+    serverComm->sendToClientBlocking<char>(name, ServerCommunication::NAME_STRING_LENGTH,
+            segmentName);
+    serverComm->sendToClientBlocking<int>(name, 1, &token);
+    int isMapped = 0;
+    serverComm->receiveFromClientBlocking<int>(name, 1, &isMapped);
+    if (!isMapped) {
+        // the client runs on another node
+        delete segment;
+        return NULL;
+    }
+    segment->unlink();
+    sharedMemorySegments.push_back(segment);
+    return segment;
+}
+
+ClientCode::EncodedDataField *ClientCode::getEncodedDataField(DataField *df) {
+    map<DataField*, EncodedDataField>::iterator it = encodedDataFields.find(df);
+    if (it == encodedDataFields.end() || it->second.wireFormat == EMPIRE_DataField_float64)
+        return NULL;
+    return &it->second;
+}
+
+vector<vector<double> > *ClientCode::getPartitionBuffers(std::string meshName, DataField *df) {
+    map<string, MeshPartitions>::iterator partitions = partitionedMeshes.find(meshName);
+    if (partitions == partitionedMeshes.end())
+        return NULL;
+    vector<vector<double> > &buffers = partitionBuffers[df];
+    if (buffers.empty()) { // the buffers are kept, the values of every transfer overwrite them
+        int numPartitions = partitions->second.nodePositions.size();
+        buffers.resize(numPartitions);
+        for (int r = 0; r < numPartitions; r++) {
+            int numLocations = (df->location == EMPIRE_DataField_atNode) ?
+                    partitions->second.nodePositions[r].size() :
+                    partitions->second.elemOffsets[r + 1] - partitions->second.elemOffsets[r];
+            buffers[r].resize(numLocations * df->dimension);
+        }
+    }
+    return &buffers;
+}
+
+const FEMesh *ClientCode::getRenumberedMesh(std::string meshName) {
+    assert(nameToMeshMap.find(meshName) != nameToMeshMap.end());
+    AbstractMesh *mesh = nameToMeshMap[meshName];
+    if (mesh->type != EMPIRE_Mesh_FEMesh)
+        return NULL;
+    const FEMesh *feMesh = dynamic_cast<FEMesh*>(mesh);
+    return (feMesh != NULL && feMesh->isRenumbered()) ? feMesh : NULL;
+}
+
+double *ClientCode::getClientOrderData(std::string meshName, DataField *df) {
+    map<DataField*, vector<double> >::iterator it = clientOrderDataFields.find(df);
+    if (it != clientOrderDataFields.end())
+        return &it->second[0];
+    if (df->numLocations == 0 || getRenumberedMesh(meshName) == NULL)
+        return df->data;
+    vector<double> &clientOrderData = clientOrderDataFields[df];
+    clientOrderData.resize(df->numLocations * df->dimension);
+    return &clientOrderData[0];
+}
+
+DataField *ClientCode::getDataField(std::string meshName, std::string dataFieldName) {
+    assert(nameToMeshMap.find(meshName) != nameToMeshMap.end());
+    return nameToMeshMap[meshName]->getDataFieldByName(dataFieldName);
+}
+
 void ClientCode::sendConvergenceSignal(bool convergent) {
     assert(serverComm != NULL);
     int tmpInt = (int) convergent;
@@ -574,7 +1400,27 @@ void ClientCode::sendConvergenceSignal(bool convergent) {
         INDENT_OUT(1, info, infoOut);
     }
 
+    if (piggybackConvergenceSignal && !convergent) { // the next message to the client follows
+        hasPendingConvergenceSignal = true;
+        return;
+    }
+    hasPendingConvergenceSignal = false;
+    serverComm->sendToClientBlocking<int>(name, 1, &tmpInt);
+}
+
+void ClientCode::sendPendingConvergenceSignal() {
+    if (!hasPendingConvergenceSignal)
+        return;
+    int tmpInt = 0;
     serverComm->sendToClientBlocking<int>(name, 1, &tmpInt);
+    hasPendingConvergenceSignal = false;
+}
+
+int ClientCode::getSizeHeader(int header) {
+    if (!hasPendingConvergenceSignal)
+        return header;
+    hasPendingConvergenceSignal = false;
+    return NON_CONVERGENT_HEADER - header;
 }
 
 bool ClientCode::recvConvergenceSignal() {
@@ -600,6 +1446,29 @@ AbstractMesh *ClientCode::getMeshByName(std::string meshName) {
     return nameToMeshMap[meshName];
 }
 
+AbstractMesh *ClientCode::releaseMesh(std::string meshName) {
+    map<string, AbstractMesh*>::iterator it = nameToMeshMap.find(meshName);
+    assert(it != nameToMeshMap.end());
+    AbstractMesh *mesh = it->second;
+    nameToMeshMap.erase(it);
+    return mesh;
+}
+
+void ClientCode::replaceMesh(std::string meshName, AbstractMesh *mesh) {
+    map<string, AbstractMesh*>::iterator it = nameToMeshMap.find(meshName);
+    assert(it != nameToMeshMap.end());
+    AbstractMesh *receivedMesh = it->second;
+    assert(mesh != receivedMesh && mesh->type == receivedMesh->type);
+    for (map<string, DataField*>::iterator df = mesh->nameToDataFieldMap.begin();
+            df != mesh->nameToDataFieldMap.end(); df++)
+        delete df->second;
+    // the data fields keep their addresses, which identify them in the transfers
+    mesh->nameToDataFieldMap = receivedMesh->nameToDataFieldMap;
+    receivedMesh->nameToDataFieldMap.clear();
+    it->second = mesh;
+    delete receivedMesh;
+}
+
 void ClientCode::addSignal(std::string signalName, int size0, int size1, int size2) {
 
     if (nameToSignalMap.find(signalName) != nameToSignalMap.end()) {
@@ -648,6 +1517,7 @@ void ClientCode::sendSignal(std::string signalName) {
         string info = "Emperor is sending (" + signalName + ") to [" + name + "] ...";
         INDENT_OUT(1, info, infoOut);
     }
+    sendPendingConvergenceSignal();
     const Signal *signal = nameToSignalMap[signalName];
     const int NAME_STRING_LENGTH = ServerCommunication::NAME_STRING_LENGTH;
     char signalNameSend[NAME_STRING_LENGTH];
@@ -660,6 +1530,182 @@ void ClientCode::sendSignal(std::string signalName) {
     DEBUG_OUT() << *(const_cast<Signal*>(signal)) << endl;
 }
 
+void ClientCode::recvSignals(const std::vector<std::string> &signalNames) {
+    { // output to shell
+        string info = "Emperor is receiving " + joinSignalNames(signalNames) + " from [" + name
+                + "] ...";
+        INDENT_OUT(1, info, infoOut);
+    }
+    SignalBundle &bundle = getSignalBundle(recvSignalBundles, signalNames);
+    const int numSignals = bundle.signals.size();
+    if (!bundle.isLayoutExchanged) {
+        const int NAME_STRING_LENGTH = ServerCommunication::NAME_STRING_LENGTH;
+        vector<int> layoutReceive(numSignals + 1, -1);
+        vector<char> namesReceive(numSignals * NAME_STRING_LENGTH);
+        serverComm->receiveFromClientBlocking<int>(name, numSignals + 1, &layoutReceive[0]);
+        serverComm->receiveFromClientBlocking<char>(name, namesReceive.size(), &namesReceive[0]);
+        if (layoutReceive[0] != numSignals) {
+            ERROR_OUT() << "Signal bundle of " << layoutReceive[0] << " signals received, however "
+                    << numSignals << " expected!" << endl;
+            assert(false);
+        }
+        for (int i = 0; i < numSignals; i++) {
+            string nameReceive(&namesReceive[i * NAME_STRING_LENGTH]);
+            if (signalNames[i] != nameReceive || layoutReceive[i + 1] != bundle.signals[i]->size) {
+                ERROR_OUT() << "Signal " << nameReceive << " of size " << layoutReceive[i + 1]
+                        << " received, however " << signalNames[i] << " of size "
+                        << bundle.signals[i]->size << " expected!" << endl;
+                assert(false);
+            }
+        }
+        bundle.isLayoutExchanged = true;
+    }
+    serverComm->receiveFromClientBlocking<double>(name, bundle.buffer.size(), &bundle.buffer[0]);
+    int offset = 0;
+    for (int i = 0; i < numSignals; i++) {
+        Signal *signal = bundle.signals[i];
+        memcpy(signal->array, &bundle.buffer[offset], signal->size * sizeof(double));
+        offset += signal->size;
+        DEBUG_OUT() << (*signal) << endl;
+    }
+}
+
+void ClientCode::sendSignals(const std::vector<std::string> &signalNames) {
+    { // output to shell
+        string info = "Emperor is sending " + joinSignalNames(signalNames) + " to [" + name
+                + "] ...";
+        INDENT_OUT(1, info, infoOut);
+    }
+    sendPendingConvergenceSignal();
+    SignalBundle &bundle = getSignalBundle(sendSignalBundles, signalNames);
+    const int numSignals = bundle.signals.size();
+    if (!bundle.isLayoutExchanged) {
+        const int NAME_STRING_LENGTH = ServerCommunication::NAME_STRING_LENGTH;
+        vector<int> layoutSend(1, numSignals);
+        vector<char> namesSend(numSignals * NAME_STRING_LENGTH, '\0');
+        for (int i = 0; i < numSignals; i++) {
+            layoutSend.push_back(bundle.signals[i]->size);
+            strcpy(&namesSend[i * NAME_STRING_LENGTH], signalNames[i].c_str());
+        }
+        serverComm->sendToClientBlocking<int>(name, numSignals + 1, &layoutSend[0]);
+        serverComm->sendToClientBlocking<char>(name, namesSend.size(), &namesSend[0]);
+        bundle.isLayoutExchanged = true;
+    }
+    int offset = 0;
+    for (int i = 0; i < numSignals; i++) {
+        const Signal *signal = bundle.signals[i];
+        memcpy(&bundle.buffer[offset], signal->array, signal->size * sizeof(double));
+        offset += signal->size;
+    }
+    serverComm->sendToClientBlocking<double>(name, bundle.buffer.size(), &bundle.buffer[0]);
+}
+
+ClientCode::SignalBundle &ClientCode::getSignalBundle(
+        std::map<std::vector<std::string>, SignalBundle> &bundles,
+        const std::vector<std::string> &signalNames) {
+    map<vector<string>, SignalBundle>::iterator it = bundles.find(signalNames);
+    if (it != bundles.end())
+        return it->second;
+    assert(!signalNames.empty());
+    SignalBundle &bundle = bundles[signalNames];
+    int size = 0;
+    for (int i = 0; i < signalNames.size(); i++) {
+        assert(signalNames[i].size() < ServerCommunication::NAME_STRING_LENGTH);
+        Signal *signal = getSignalByName(signalNames[i]);
+        assert(signal->size != 0);
+        bundle.signals.push_back(signal);
+        size += signal->size;
+    }
+    bundle.buffer.resize(size);
+    bundle.isLayoutExchanged = false;
+    return bundle;
+}
+
+const ClientCode::InterfaceJacobian &ClientCode::recvInterfaceJacobian(std::string jacobianName) {
+    { // output to shell
+        string info = "Emperor is receiving interface Jacobian (" + jacobianName + ") from [" + name
+                + "] ...";
+        INDENT_OUT(1, info, infoOut);
+    }
+    const int NAME_STRING_LENGTH = ServerCommunication::NAME_STRING_LENGTH;
+    char jacobianNameReceive[NAME_STRING_LENGTH];
+    serverComm->receiveFromClientBlocking<char>(name, NAME_STRING_LENGTH, jacobianNameReceive);
+    string tmp(jacobianNameReceive);
+    if (jacobianName.compare(tmp) != 0) {
+        ERROR_OUT() << "Interface Jacobian name received is " << tmp << ", however "
+                << jacobianName << " expected!" << endl;
+        assert(false);
+    }
+    map<string, InterfaceJacobian>::iterator it = nameToInterfaceJacobianMap.find(jacobianName);
+    if (it == nameToInterfaceJacobianMap.end()) { // the sparsity pattern is received once
+        InterfaceJacobian &jacobian = nameToInterfaceJacobianMap[jacobianName];
+        int header[3] = { -1, -1, -1 };
+        serverComm->receiveFromClientBlocking<int>(name, 3, header);
+        if (header[0] < 0 || header[1] < 0 || header[2] < 0) {
+            ERROR_OUT() << "Interface Jacobian " << jacobianName << " of " << header[0] << " x "
+                    << header[1] << " with " << header[2] << " entries received!" << endl;
+            exit(EXIT_FAILURE);
+        }
+        jacobian.numRows = header[0];
+        jacobian.numColumns = header[1];
+        jacobian.rowPointers.resize(jacobian.numRows + 1);
+        jacobian.columnIndices.resize(header[2]);
+        jacobian.values.resize(header[2]);
+        serverComm->receiveFromClientBlocking<int>(name, jacobian.numRows + 1,
+                &jacobian.rowPointers[0]);
+        if (header[2] > 0)
+            serverComm->receiveFromClientBlocking<int>(name, header[2],
+                    &jacobian.columnIndices[0]);
+        if (jacobian.rowPointers[0] != 0 || jacobian.rowPointers[jacobian.numRows] != header[2]) {
+            ERROR_OUT() << "Interface Jacobian " << jacobianName
+                    << " received has invalid row pointers!" << endl;
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < jacobian.numRows; i++) {
+            bool isValid = jacobian.rowPointers[i] <= jacobian.rowPointers[i + 1];
+            for (int j = jacobian.rowPointers[i]; isValid && j < jacobian.rowPointers[i + 1]; j++)
+                isValid = jacobian.columnIndices[j] >= 0
+                        && jacobian.columnIndices[j] < jacobian.numColumns;
+            if (!isValid) {
+                ERROR_OUT() << "Interface Jacobian " << jacobianName
+                        << " received has an invalid row " << i << "!" << endl;
+                exit(EXIT_FAILURE);
+            }
+        }
+        it = nameToInterfaceJacobianMap.find(jacobianName);
+    }
+    InterfaceJacobian &jacobian = it->second;
+    if (!jacobian.values.empty())
+        serverComm->receiveFromClientBlocking<double>(name, jacobian.values.size(),
+                &jacobian.values[0]);
+    return jacobian;
+}
+
+void ClientCode::sendMappingOperator(std::string mapperName, int numRows, int numColumns,
+        const std::vector<int> &rowPointers, const std::vector<int> &columnIndices,
+        const std::vector<double> &values) {
+    { // output to shell
+        string info = "Emperor is sending mapping operator (" + mapperName + ") to [" + name
+                + "] ...";
+        INDENT_OUT(1, info, infoOut);
+    }
+    sendPendingConvergenceSignal();
+    const int NAME_STRING_LENGTH = ServerCommunication::NAME_STRING_LENGTH;
+    char mapperNameSend[NAME_STRING_LENGTH];
+    strcpy(mapperNameSend, mapperName.c_str());
+    serverComm->sendToClientBlocking<char>(name, NAME_STRING_LENGTH, mapperNameSend);
+    int numEntries = values.size();
+    int header[3] = { numRows, numColumns, numEntries };
+    serverComm->sendToClientBlocking<int>(name, 3, header);
+    serverComm->sendToClientBlocking<int>(name, numRows + 1, const_cast<int*>(&rowPointers[0]));
+    if (numEntries > 0) {
+        serverComm->sendToClientBlocking<int>(name, numEntries,
+                const_cast<int*>(&columnIndices[0]));
+        serverComm->sendToClientBlocking<double>(name, numEntries,
+                const_cast<double*>(&values[0]));
+    }
+}
+
 Signal *ClientCode::getSignalByName(std::string signalName) {
     if (nameToSignalMap.find(signalName) == nameToSignalMap.end()) {
         ERROR_OUT("Signal name: "+signalName+" not found!");
@@ -37,7 +37,10 @@ namespace EMPIRE {
 
 class ServerCommunication;
 class AbstractMesh;
+class FEMesh;
 class Signal;
+class DataField;
+class SharedMemorySegment;
 
 class IGAPatchCouplingCaratData;
 
@@ -71,13 +74,113 @@ public:
      * \author Tianyang Wang
      ***********/
     void setServerCommunication(ServerCommunication *_serverComm);
+    /***********************************************************************************************
+     * \brief Enable the transfer of data fields by persistent requests. After the first transfer
+     *        of a data field with its size header, a persistent request is bound to its buffer and
+     *        reused without the header. The client must use the same setting
+     * \param[in] _persistentDataFieldTransfer true to enable the persistent transfer
+     ***********/
+    void setPersistentDataFieldTransfer(bool _persistentDataFieldTransfer);
+    /***********************************************************************************************
+     * \brief Enable the transfer of data fields through shared memory if the client runs on the
+     *        same node. After the first transfer of a data field, the Emperor offers a segment to
+     *        the client, and if the client can map it, the data field is transferred through it
+     *        instead of MPI. The client must use the same setting
+     * \param[in] _sharedMemoryDataFieldTransfer true to enable the shared memory transfer
+     ***********/
+    void setSharedMemoryDataFieldTransfer(bool _sharedMemoryDataFieldTransfer);
+    /***********************************************************************************************
+     * \brief Enable piggybacking of the convergence signal. A non-convergence signal is not sent
+     *        on its own, but folded into the size header of the next data field sent to the client,
+     *        which receives both in one message by EMPIRE_API_recvDataFieldAndConvergence. If a
+     *        signal, a mesh, a mapping operator or a data field without a size header follows, the
+     *        signal is sent on its own before it. A convergence signal is sent at once, since no
+     *        data follows it in the loop
+     * \param[in] _piggybackConvergenceSignal true to enable piggybacking
+     ***********/
+    void setPiggybackConvergenceSignal(bool _piggybackConvergenceSignal);
+    /***********************************************************************************************
+     * \brief Set the wire format of a data field. All its transfers are encoded in this format,
+     *        a format other than float64 disables the persistent and the shared memory transfer
+     *        of the data field. The client must use the same format
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \param[in] wireFormat the wire format
+     ***********/
+    void setDataFieldWireFormat(std::string meshName, std::string dataFieldName,
+            EMPIRE_DataField_wireFormat wireFormat);
+    /***********************************************************************************************
+     * \brief Set the chunk size of a data field. All its transfers are split into messages of at
+     *        most this many values after the size header, which disables the persistent and the
+     *        shared memory transfer of the data field. The data fields of partitioned meshes are
+     *        not split. The client must use the same chunk size
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \param[in] chunkSize the number of values of a chunk, 0 to transfer the data field at once
+     ***********/
+    void setDataFieldChunkSize(std::string meshName, std::string dataFieldName, int chunkSize);
+    /***********************************************************************************************
+     * \brief Get the chunk size of a data field
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \return the number of values of a chunk, 0 if the data field is transferred at once
+     ***********/
+    int getDataFieldChunkSize(std::string meshName, std::string dataFieldName);
+    /***********************************************************************************************
+     * \brief Whether the chunks of a data field can be mapped while the others are in transfer,
+     *        i.e. the data field is transferred in chunks and its mesh is in the order of the client
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \return true if the chunks are the consecutive values of the data field
+     ***********/
+    bool isDataFieldPipelined(std::string meshName, std::string dataFieldName);
+    /***********************************************************************************************
+     * \brief Let the transfers of a data field skip the values if they have not changed since its
+     *        last transfer in the same direction. The size header is then replaced by a flag and
+     *        the values by an empty message, which completes the receive posted for them and
+     *        leaves the values of the receiver as they are. The data field is never transferred by
+     *        a persistent request or shared memory. The data fields of partitioned meshes always carry their values. The client
+     *        must skip the unchanged values of the data field as well
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \param[in] skipUnchanged true to skip unchanged values
+     ***********/
+    void setDataFieldSkipUnchanged(std::string meshName, std::string dataFieldName,
+            bool skipUnchanged);
     /***********************************************************************************************
      * \brief Receive the mesh from a real client
      * \param[in] meshName name of the mesh to be received
      * \param[in] _triangulateAll triangulate all elements
+     * \param[in] renumbering the space-filling curve along which the mesh is reordered
+     * \param[in] partitioned whether every process of the client sends its own partition of the
+     *            mesh instead of a mesh gathered on its first process. The partitions are merged
+     *            by their node IDs, a node shared by several partitions is owned by the lowest rank.
+     *            The data fields of the mesh are then exchanged with every process as well, always
+     *            as float64 with a size header, i.e. without persistent or shared memory transfer
      * \author Tianyang Wang
      ***********/
-    void recvFEMesh(std::string meshName, bool triangulateAll);
+    void recvFEMesh(std::string meshName, bool triangulateAll,
+            EMPIRE_Mesh_renumbering renumbering = EMPIRE_Mesh_noRenumbering,
+            bool partitioned = false);
+    /***********************************************************************************************
+     * \brief Start receiving the mesh from a real client. After its header, all arrays of the
+     *        mesh are received without waiting for them, such that the meshes of several clients
+     *        are transferred concurrently. The transfer has to be completed by finishRecvFEMesh
+     * \param[in] meshName name of the mesh to be received
+     * \param[in] triangulateAll triangulate all elements
+     * \param[in] renumbering the space-filling curve along which the mesh is reordered when it
+     *            has arrived, the data fields are transferred in the order of the client
+     * \param[in] partitioned whether every process of the client sends its own partition of the
+     *            mesh, see recvFEMesh
+     ***********/
+    void startRecvFEMesh(std::string meshName, bool triangulateAll,
+            EMPIRE_Mesh_renumbering renumbering = EMPIRE_Mesh_noRenumbering,
+            bool partitioned = false);
+    /***********************************************************************************************
+     * \brief Wait until the mesh started by startRecvFEMesh has arrived
+     * \param[in] meshName name of the mesh
+     ***********/
+    void finishRecvFEMesh(std::string meshName);
     /***********************************************************************************************
      * \brief Receive the section mesh from a real client
      * \param[in] meshName name of the mesh to be received
@@ -85,6 +188,15 @@ public:
      * \author Tianyang Wang
      ***********/
     void recvSectionMesh(std::string meshName, bool triangulateAll);
+    /***********************************************************************************************
+     * \brief Receive new coordinates of the nodes of an FE mesh, which are written into the mesh
+     *        in place. The node IDs, the elements and the node index are kept, only what is
+     *        computed from the coordinates is discarded. The mappers of the mesh update their
+     *        matrices at the next mapping, see MapperAdapter::setMeshMovedByClient. The mesh must
+     *        not be partitioned
+     * \param[in] meshName name of the mesh
+     ***********/
+    void recvMeshCoordinates(std::string meshName);
     /***********************************************************************************************
      * \brief Send mesh to a real client
      * \param[in] meshName name of the mesh to be received
@@ -100,9 +212,14 @@ public:
     /***********************************************************************************************
      * \brief Receive the mesh from a real client
      * \param[in] meshName name of the mesh to be received
+     * \param[in] conditionGPDataCache directory of the cache of the GP data of the weak conditions,
+     *            no cache if empty
+     * \param[in] trimmingLinearizationType type of the linearization of the trimming curves, see
+     *            IGAPatchCurve::linearize
      * \author Fabien Pean, Chenshen Wu
      ***********/
-    void recvIGAMesh(std::string meshName);
+    void recvIGAMesh(std::string meshName, std::string conditionGPDataCache = "",
+            int trimmingLinearizationType = 2);
     /***********************************************************************************************
      * \brief Receive the data field from a real client
      * \param[in] meshName name of the mesh which owns the data field
@@ -117,6 +234,60 @@ public:
      * \author Tianyang Wang
      ***********/
     void sendDataField(std::string meshName, std::string dataFieldName);
+    /***********************************************************************************************
+     * \brief Start receiving the data field from a real client without waiting for it, the
+     *        transfer has to be completed by finishRecvDataField
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \return the handle of the request which completes when the data field has arrived, or -1
+     *         if the data field has arrived already and finishRecvDataField must not be called
+     ***********/
+    int startRecvDataField(std::string meshName, std::string dataFieldName);
+    /***********************************************************************************************
+     * \brief Wait until the data field started by startRecvDataField has arrived
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     ***********/
+    void finishRecvDataField(std::string meshName, std::string dataFieldName);
+    /***********************************************************************************************
+     * \brief Wait until the first chunks of the pipelined data field started by startRecvDataField
+     *        have arrived, the transfer is still completed by finishRecvDataField
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \param[in] numChunks the number of leading chunks to wait for
+     ***********/
+    void waitForDataFieldChunks(std::string meshName, std::string dataFieldName, int numChunks);
+    /***********************************************************************************************
+     * \brief Start sending the data field to a real client without waiting for it, the data field
+     *        must not be modified until finishSendDataField is called
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \return the handle of the request which completes when the data field has been sent, or -1
+     *         if the data field has been sent already and finishSendDataField must not be called
+     ***********/
+    int startSendDataField(std::string meshName, std::string dataFieldName);
+    /***********************************************************************************************
+     * \brief Wait until the data field started by startSendDataField has been sent
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     ***********/
+    void finishSendDataField(std::string meshName, std::string dataFieldName);
+    /***********************************************************************************************
+     * \brief Start sending the pipelined data field to a real client by its size header only, its
+     *        chunks are sent by sendDataFieldChunks as soon as they are computed. The transfer has
+     *        to be completed by finishSendDataField after all chunks are sent
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     ***********/
+    void startPipelinedSendDataField(std::string meshName, std::string dataFieldName);
+    /***********************************************************************************************
+     * \brief Send the chunks of a pipelined data field up to the given one, which must not be
+     *        modified until finishSendDataField is called
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \param[in] numChunks the number of leading chunks which are sent now or have been before
+     ***********/
+    void sendDataFieldChunks(std::string meshName, std::string dataFieldName, int numChunks);
     /***********************************************************************************************
      * \brief Send the convergence signal to the client
      * \param[in] convergent true if convergent, false otherwise
@@ -135,6 +306,21 @@ public:
      * \author Tianyang Wang
      ***********/
     AbstractMesh *getMeshByName(std::string meshName);
+    /***********************************************************************************************
+     * \brief Remove a mesh from the client code without deleting it, e.g. to keep it with its
+     *        mapper for the next session of the Emperor daemon
+     * \param[in] meshName name of the mesh
+     * \return the mesh, which is owned by the caller afterwards
+     ***********/
+    AbstractMesh *releaseMesh(std::string meshName);
+    /***********************************************************************************************
+     * \brief Replace a received mesh by a mesh of the same name and content, e.g. a mesh kept from
+     *        an earlier session. The data fields of the received mesh are moved to the replacing
+     *        mesh, whose own data fields are deleted, and the received mesh is deleted.
+     * \param[in] meshName name of the mesh
+     * \param[in] mesh the replacing mesh, which is owned by the client code afterwards
+     ***********/
+    void replaceMesh(std::string meshName, AbstractMesh *mesh);
     /***********************************************************************************************
      * \brief Initialize the array
      * \param[in] signalName name of the signal
@@ -156,6 +342,52 @@ public:
      * \author Tianyang Wang
      ***********/
     void sendSignal(std::string signalName);
+    /***********************************************************************************************
+     * \brief Receive several signals as one bundle, i.e. one message holding their arrays one
+     *        after another, from EMPIRE_API_sendSignals. The layout of the bundle (the names and
+     *        sizes of its signals) is sent by the client and checked at the first transfer only.
+     * \param[in] signalNames the names of the signals in the order of the client
+     ***********/
+    void recvSignals(const std::vector<std::string> &signalNames);
+    /***********************************************************************************************
+     * \brief Send several signals as one bundle to EMPIRE_API_recvSignals, the layout is sent at
+     *        the first transfer only
+     * \param[in] signalNames the names of the signals in the order of the client
+     ***********/
+    void sendSignals(const std::vector<std::string> &signalNames);
+    /********//**
+     * \brief Struct InterfaceJacobian holds a block of the interface Jacobian in compressed sparse
+     *        row format (zero-based), sent by EMPIRE_API_sendInterfaceJacobian
+     ***********/
+    struct InterfaceJacobian {
+        int numRows;
+        int numColumns;
+        /// the first entry of every row, numRows+1 integers
+        std::vector<int> rowPointers;
+        std::vector<int> columnIndices;
+        std::vector<double> values;
+    };
+    /***********************************************************************************************
+     * \brief Receive a block of the interface Jacobian from EMPIRE_API_sendInterfaceJacobian. The
+     *        sparsity pattern is received at the first call, later calls receive the values only
+     *        and overwrite them in place.
+     * \param[in] jacobianName name of the block
+     * \return the block, kept by the client code
+     ***********/
+    const InterfaceJacobian &recvInterfaceJacobian(std::string jacobianName);
+    /***********************************************************************************************
+     * \brief Send the mapping operator of a mapper to EMPIRE_API_recvMappingOperator, so that the
+     *        client can apply it on its own
+     * \param[in] mapperName name of the mapper
+     * \param[in] numRows number of rows (nodes of mesh B)
+     * \param[in] numColumns number of columns (nodes of mesh A)
+     * \param[in] rowPointers the first entry of every row, numRows+1 integers
+     * \param[in] columnIndices the column of every entry
+     * \param[in] values the value of every entry
+     ***********/
+    void sendMappingOperator(std::string mapperName, int numRows, int numColumns,
+            const std::vector<int> &rowPointers, const std::vector<int> &columnIndices,
+            const std::vector<double> &values);
     /***********************************************************************************************
      * \brief Get array by its name
      * \return a pointer to the signal
@@ -173,6 +405,207 @@ private:
     std::map<std::string, AbstractMesh*> nameToMeshMap;
     /// name to array map
     std::map<std::string, Signal*> nameToSignalMap;
+    /********//**
+     * \brief Struct SignalBundle holds the signals transferred in one message
+     ***********/
+    struct SignalBundle {
+        std::vector<Signal*> signals;
+        /// the arrays of the signals one after another
+        std::vector<double> buffer;
+        /// whether the layout has been exchanged with the client
+        bool isLayoutExchanged;
+    };
+    /// the bundles received and the bundles sent by the names of their signals
+    std::map<std::vector<std::string>, SignalBundle> recvSignalBundles;
+    std::map<std::vector<std::string>, SignalBundle> sendSignalBundles;
+    /// the blocks of the interface Jacobian received by their names
+    std::map<std::string, InterfaceJacobian> nameToInterfaceJacobianMap;
+    /***********************************************************************************************
+     * \brief Get a bundle, it is created at the first call
+     * \param[in] bundles the received or the sent bundles
+     * \param[in] signalNames the names of the signals of the bundle
+     ***********/
+    SignalBundle &getSignalBundle(std::map<std::vector<std::string>, SignalBundle> &bundles,
+            const std::vector<std::string> &signalNames);
+    /// the partition of a mesh sent by one process of the client
+    struct MeshPartition {
+        /// number of nodes, number of elements, size of the elements array
+        int meshInfo[3];
+        std::vector<double> nodes;
+        std::vector<int> nodeIDs;
+        std::vector<int> numNodesPerElem;
+        std::vector<int> elems;
+    };
+    /// a mesh in a non-blocking transfer, the elements arrive before numNodesPerElem is known
+    struct PendingMeshTransfer {
+        FEMesh *mesh;
+        EMPIRE_Mesh_renumbering renumbering;
+        std::vector<int> elems;
+        std::vector<int> requests;
+        /// the partitions of a partitioned mesh, which is created when all have arrived
+        std::vector<MeshPartition> partitions;
+        bool triangulateAll;
+    };
+    /// meshes in a non-blocking transfer
+    std::map<std::string, PendingMeshTransfer> pendingMeshTransfers;
+    /// where the partitions of the processes of the client are in a partitioned mesh, positions
+    /// are in the order of the client, i.e. before renumbering
+    struct MeshPartitions {
+        /// position of the i-th node of process r is nodePositions[r][i]
+        std::vector<std::vector<int> > nodePositions;
+        /// the process which owns a node and sends its values
+        std::vector<int> nodeOwners;
+        /// the elements of process r are at the positions elemOffsets[r] to elemOffsets[r+1]-1
+        std::vector<int> elemOffsets;
+    };
+    /// name of a partitioned mesh <=> its partitions
+    std::map<std::string, MeshPartitions> partitionedMeshes;
+    /// the size header and the request handles of a data field in a non-blocking transfer
+    struct PendingDataFieldTransfer {
+        int size;
+        /// the size header as sent, which may carry a non-convergence signal
+        int header;
+        int sizeRequest;
+        int dataRequest;
+        /// the size headers and the requests of all processes of a partitioned data field
+        std::vector<int> partitionSizes;
+        std::vector<int> partitionRequests;
+        /// the requests of the chunks posted so far of a data field transferred in chunks, and the
+        /// number of leading ones which are completed
+        std::vector<int> chunkRequests;
+        int numCompletedChunks;
+    };
+    /// data fields of partitioned meshes <=> the values of each process of the client
+    std::map<DataField*, std::vector<std::vector<double> > > partitionBuffers;
+    /// data fields in a non-blocking transfer, the map keeps the size headers at fixed addresses
+    std::map<DataField*, PendingDataFieldTransfer> pendingDataFieldTransfers;
+    /// whether data fields are transferred by persistent requests after the first transfer
+    bool persistentDataFieldTransfer;
+    /// data field <=> handle of the persistent receive request bound to it
+    std::map<DataField*, int> persistentRecvRequests;
+    /// data field <=> handle of the persistent send request bound to it
+    std::map<DataField*, int> persistentSendRequests;
+    /// whether data fields are transferred through shared memory with a client on the same node
+    bool sharedMemoryDataFieldTransfer;
+    /// whether a non-convergence signal is sent in the size header of the next data field
+    bool piggybackConvergenceSignal;
+    /// whether a non-convergence signal waits for the next data field
+    bool hasPendingConvergenceSignal;
+    /***********************************************************************************************
+     * \brief Send the pending non-convergence signal on its own before a message which has no
+     *        size header to carry it
+     ***********/
+    void sendPendingConvergenceSignal();
+    /***********************************************************************************************
+     * \brief Get the size header of a data field, which carries the pending non-convergence signal
+     *        if there is one. The pending signal is cleared
+     * \param[in] header the size header
+     * \return the header, or NON_CONVERGENT_HEADER - header if a non-convergence signal is pending
+     ***********/
+    int getSizeHeader(int header);
+    /// shared memory segments of the persistent requests, which are owned by the client code
+    std::vector<SharedMemorySegment*> sharedMemorySegments;
+    /// the wire format of a data field, with the buffer and the histories of its encoding
+    struct EncodedDataField {
+        EMPIRE_DataField_wireFormat wireFormat;
+        std::vector<unsigned char> buffer;
+        std::vector<double> sendHistory;
+        std::vector<double> recvHistory;
+    };
+    /// data fields with a wire format set, the float64 ones are only kept to detect conflicts
+    std::map<DataField*, EncodedDataField> encodedDataFields;
+    /// data fields with a chunk size set, the ones transferred at once are only kept to detect
+    /// conflicts
+    std::map<DataField*, int> dataFieldChunkSizes;
+    /// data fields whose unchanged values are skipped, the others are only kept to detect
+    /// conflicts
+    std::map<DataField*, bool> dataFieldSkipUnchanged;
+    /// data fields whose unchanged values are skipped <=> the values last sent in the order of the
+    /// client
+    std::map<DataField*, std::vector<double> > lastSentDataFields;
+    /// data fields of renumbered meshes <=> their values in the order of the client, which are
+    /// transferred instead of the data (the buffers are never resized, see persistent requests)
+    std::map<DataField*, std::vector<double> > clientOrderDataFields;
+    /// names of the timers of the data field transfers in the profile
+    std::string profilerRecvName;
+    std::string profilerSendName;
+    /***********************************************************************************************
+     * \brief Offer a shared memory segment for a data field to the client, after the first
+     *        transfer of the data field
+     * \param[in] size number of doubles of the data field
+     * \return the segment if the client has mapped it, otherwise NULL
+     ***********/
+    SharedMemorySegment *offerSharedMemorySegment(int size);
+    /***********************************************************************************************
+     * \brief Get the encoding of a data field
+     * \param[in] df the data field
+     * \return the encoding, NULL if the data field is transferred as float64
+     ***********/
+    EncodedDataField *getEncodedDataField(DataField *df);
+    /***********************************************************************************************
+     * \brief Get the chunk size of a data field
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] df the data field
+     * \return the number of values of a chunk, 0 if the data field is transferred at once
+     ***********/
+    int getDataFieldChunkSize(std::string meshName, DataField *df);
+    /***********************************************************************************************
+     * \brief Check whether the unchanged values of a data field are skipped
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] df the data field
+     * \return true if the unchanged values are skipped
+     ***********/
+    bool isDataFieldSkipUnchanged(std::string meshName, DataField *df);
+    /***********************************************************************************************
+     * \brief Post the transfers of the chunks of a data field which are not posted yet
+     * \param[in/out] transfer the transfer, which holds the requests of the posted chunks
+     * \param[in] isSend true for a send, false for a receive
+     * \param[in/out] data the values of the data field in the order of the client
+     * \param[in] size the number of values
+     * \param[in] chunkSize the number of values of a chunk, the last one may be shorter
+     * \param[in] numChunks the number of leading chunks which are posted afterwards
+     ***********/
+    void postDataFieldChunks(PendingDataFieldTransfer &transfer, bool isSend, double *data,
+            int size, int chunkSize, int numChunks);
+    /***********************************************************************************************
+     * \brief Wait for the size header and the leading chunks of a data field transferred in chunks
+     * \param[in/out] transfer the transfer
+     * \param[in] numChunks the number of leading chunks which are completed afterwards
+     ***********/
+    void waitForDataFieldChunks(PendingDataFieldTransfer &transfer, int numChunks);
+    /***********************************************************************************************
+     * \brief Merge the partitions of a partitioned mesh which have arrived into the mesh
+     * \param[in] meshName name of the mesh
+     * \param[in/out] transfer the transfer, whose partitions are released
+     ***********/
+    void mergeMeshPartitions(std::string meshName, PendingMeshTransfer &transfer);
+    /***********************************************************************************************
+     * \brief Get the buffers of the processes of the client for a data field of a partitioned mesh
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] df the data field
+     * \return the buffers, NULL if the mesh is not partitioned
+     ***********/
+    std::vector<std::vector<double> > *getPartitionBuffers(std::string meshName, DataField *df);
+    /***********************************************************************************************
+     * \brief Get the renumbered mesh of a data field
+     * \param[in] meshName name of the mesh which owns the data field
+     * \return the mesh, NULL if the mesh is in the order of the client
+     ***********/
+    const FEMesh *getRenumberedMesh(std::string meshName);
+    /***********************************************************************************************
+     * \brief Get the values of a data field in the order of the client, which are transferred
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] df the data field
+     * \return the buffer in the order of the client if the mesh is renumbered, otherwise the data
+     ***********/
+    double *getClientOrderData(std::string meshName, DataField *df);
+    /***********************************************************************************************
+     * \brief Get the data field by the names of its mesh and itself
+     * \param[in] meshName name of the mesh which owns the data field
+     * \param[in] dataFieldName name of the data field
+     * \return a pointer to the data field
+     ***********/
+    DataField *getDataField(std::string meshName, std::string dataFieldName);
     /// the unit test class
     friend class TestClientCode;
     /// the unit test class
@@ -0,0 +1,69 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file AbstractLocalRequest.h
+ * This file holds the class AbstractLocalRequest
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef ABSTRACTLOCALREQUEST_H_
+#define ABSTRACTLOCALREQUEST_H_
+
+#include <sched.h>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class AbstractLocalRequest is a request of ServerCommunication which is completed without
+ *        MPI, by a client on the same node or inside the Emperor process. As a persistent MPI
+ *        request, it can be started again after it is completed, and it counts as completed
+ *        until it is started for the first time
+ ***********/
+class AbstractLocalRequest {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     ***********/
+    AbstractLocalRequest() {
+    }
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~AbstractLocalRequest() {
+    }
+    /***********************************************************************************************
+     * \brief Start the request
+     ***********/
+    virtual void start() = 0;
+    /***********************************************************************************************
+     * \brief Progress the request without blocking
+     * \return true if the request is completed
+     ***********/
+    virtual bool test() = 0;
+    /***********************************************************************************************
+     * \brief Wait until the request is completed
+     ***********/
+    virtual void wait() {
+        while (!test())
+            sched_yield();
+    }
+};
+
+} /* namespace EMPIRE */
+#endif /* ABSTRACTLOCALREQUEST_H_ */
@@ -62,6 +62,14 @@ ConnectionIO::ConnectionIO(ClientCode *_clientCode, Signal *_signal) {
     dataField = NULL;
 }
 
+ConnectionIO::ConnectionIO(ClientCode *_clientCode, AbstractMesh *_mesh) {
+    type = EMPIRE_ConnectionIO_MeshCoordinates;
+    clientCode = _clientCode;
+    mesh = _mesh;
+    dataField = NULL;
+    signal = NULL;
+}
+
 ConnectionIO::ConnectionIO() {
     clientCode = NULL;
     signal = NULL;
@@ -86,8 +94,52 @@ void ConnectionIO::receive() {
         clientCode->recvDataField(mesh->name, dataField->name);
     else if (type == EMPIRE_ConnectionIO_Signal)
         clientCode->recvSignal(signal->name);
+    else if (type == EMPIRE_ConnectionIO_MeshCoordinates)
+        clientCode->recvMeshCoordinates(mesh->name);
+    else
+        assert(false);
+}
+
+int ConnectionIO::startReceive() {
+    if (type == EMPIRE_ConnectionIO_DataField)
+        return clientCode->startRecvDataField(mesh->name, dataField->name);
+    else if (type == EMPIRE_ConnectionIO_Signal)
+        clientCode->recvSignal(signal->name);
+    else if (type == EMPIRE_ConnectionIO_MeshCoordinates)
+        clientCode->recvMeshCoordinates(mesh->name);
+    else
+        assert(false);
+    return -1;
+}
+
+void ConnectionIO::finishReceive() {
+    if (type == EMPIRE_ConnectionIO_DataField)
+        clientCode->finishRecvDataField(mesh->name, dataField->name);
+}
+
+int ConnectionIO::startSend() {
+    if (type == EMPIRE_ConnectionIO_DataField)
+        return clientCode->startSendDataField(mesh->name, dataField->name);
+    else if (type == EMPIRE_ConnectionIO_Signal)
+        clientCode->sendSignal(signal->name);
+    else
+        assert(false);
+    return -1;
+}
+
+void ConnectionIO::finishSend() {
+    if (type == EMPIRE_ConnectionIO_DataField)
+        clientCode->finishSendDataField(mesh->name, dataField->name);
+}
+
+DataHistory *ConnectionIO::getHistory(DataHistory::Rate rate) const {
+    if (type == EMPIRE_ConnectionIO_DataField)
+        return dataField->getHistory(rate);
+    else if (type == EMPIRE_ConnectionIO_Signal)
+        return signal->getHistory(rate);
     else
         assert(false);
+    return NULL;
 }
 
 } /* namespace EMPIRE */
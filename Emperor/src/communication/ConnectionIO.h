@@ -27,6 +27,7 @@
 #define CONNECTIONIO_H_
 
 #include "EMPEROR_Enum.h"
+#include "DataHistory.h"
 #include <map>
 #include <string>
 
@@ -76,6 +77,12 @@ public:
      * \author Tianyang Wang
      ***********/
     ConnectionIO(ClientCode *_clientCode, Signal *_signal);
+    /***********************************************************************************************
+     * \brief Constructor of the node coordinates of a mesh, which can only be received
+     * \param[in] _clientCode reference to the client code
+     * \param[in] _mesh reference to the mesh
+     ***********/
+    ConnectionIO(ClientCode *_clientCode, AbstractMesh *_mesh);
     /***********************************************************************************************
      * \brief Destructor
      * \author Tianyang Wang
@@ -91,7 +98,33 @@ public:
      * \author Tianyang Wang
      ***********/
     void receive();
-    /// type of the connectionIO (dataField or signal)
+    /***********************************************************************************************
+     * \brief Start receiving from the external client without waiting. A signal is received
+     *        blocking here, since it is small and has no overlap to gain, and so are the
+     *        coordinates of a mesh, which the mappers need before anything else
+     * \return the handle of the request to wait for, or -1 if the receive is already complete
+     ***********/
+    int startReceive();
+    /***********************************************************************************************
+     * \brief Complete the receive started by startReceive
+     ***********/
+    void finishReceive();
+    /***********************************************************************************************
+     * \brief Start sending to the external client without waiting. A signal is sent blocking here
+     * \return the handle of the request to wait for, or -1 if the send is already complete
+     ***********/
+    int startSend();
+    /***********************************************************************************************
+     * \brief Complete the send started by startSend
+     ***********/
+    void finishSend();
+    /***********************************************************************************************
+     * \brief Get the history of the data field or signal taken at the given rate
+     * \param[in] rate the rate of the snapshots
+     * \return the history shared by all consumers of the data field or signal
+     ***********/
+    DataHistory *getHistory(DataHistory::Rate rate) const;
+    /// type of the connectionIO (dataField, signal or mesh coordinates)
     EMPIRE_ConnectionIO_Type type;
     /// reference to the clientCode
     ClientCode *clientCode;
@@ -0,0 +1,75 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file DataFieldCodec.h
+ * This file holds the class DataFieldCodec
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef DATAFIELDCODEC_H_
+#define DATAFIELDCODEC_H_
+
+namespace EMPIRE {
+/********//**
+ * \brief Class DataFieldCodec encodes a data field into the wire format of its transfer and
+ *        decodes it back. The formats are the values of EMPIRE_DataField_wireFormat:
+ *        - float32 sends single precision values
+ *        - lossless XORs each value with its predecessor in the array and sends only the
+ *          significant bytes of the result, with a 4 bit byte count per value
+ *        - deltaLossless does the same with the value of the previous transfer, which is small
+ *          for fields changing slowly between subiterations
+ *        The EMPIRE API holds a copy of this class, both must stay identical.
+ ***********/
+class DataFieldCodec {
+public:
+    /***********************************************************************************************
+     * \brief Get the largest size of an encoded data field
+     * \param[in] wireFormat the wire format
+     * \param[in] size number of doubles of the data field
+     * \return the size in bytes
+     ***********/
+    static int getMaxEncodedSize(int wireFormat, int size);
+    /***********************************************************************************************
+     * \brief Encode a data field
+     * \param[in] wireFormat the wire format
+     * \param[in] size number of doubles of the data field
+     * \param[in] data the data field
+     * \param[in,out] history the data field of the previous transfer, updated to this one. Only
+     *                used by deltaLossless, starts with zeros
+     * \param[out] encoded the encoded data field, of getMaxEncodedSize bytes
+     * \return the size of the encoded data field in bytes
+     ***********/
+    static int encode(int wireFormat, int size, const double *data, double *history,
+            unsigned char *encoded);
+    /***********************************************************************************************
+     * \brief Decode a data field
+     * \param[in] wireFormat the wire format
+     * \param[in] size number of doubles of the data field
+     * \param[in] encoded the encoded data field
+     * \param[in] numBytes size of the encoded data field in bytes
+     * \param[in,out] history the data field of the previous transfer, updated to this one
+     * \param[out] data the data field
+     ***********/
+    static void decode(int wireFormat, int size, const unsigned char *encoded, int numBytes,
+            double *history, double *data);
+};
+
+} /* namespace EMPIRE */
+#endif /* DATAFIELDCODEC_H_ */
@@ -0,0 +1,224 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <mpi.h>
+#include "DistributedCSRMatrix.h"
+#include "ServerRanks.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+int DistributedCSRMatrix::nextId = 0;
+map<int, MathLibrary::CSRMatrix*> DistributedCSRMatrix::workerBlocks;
+
+/// the length of the header of a row block sent to a worker
+static const int BLOCK_HEADER_SIZE = 6;
+
+MathLibrary::CSRMatrix *DistributedCSRMatrix::create(int numRows, int numCols,
+        const std::vector<int> &rowPtr, const std::vector<int> &cols,
+        const std::vector<double> &values, int numThreads, bool isSinglePrecision,
+        Products products) {
+    int numRanks = ServerRanks::getNumRanks();
+    if (numRanks == 1 || rowPtr[numRows] < MIN_NUM_ENTRIES)
+        return new MathLibrary::CSRMatrix(numRows, numCols, rowPtr, cols, values, numThreads,
+                isSinglePrecision, products);
+    assert(ServerRanks::getRank() == 0);
+    // the first row after the share of entries of the ranks before
+    vector<int> rowOffsets(numRanks + 1, 0);
+    int row = 0;
+    for (int r = 1; r < numRanks; r++) {
+        long target = (long) rowPtr[numRows] * r / numRanks;
+        while (row < numRows && rowPtr[row] < target)
+            row++;
+        rowOffsets[r] = row;
+    }
+    rowOffsets[numRanks] = numRows;
+    for (int r = 0; r < numRanks; r++)
+        if (rowOffsets[r + 1] == rowOffsets[r]) // too few rows to give every rank a block
+            return new MathLibrary::CSRMatrix(numRows, numCols, rowPtr, cols, values, numThreads,
+                    isSinglePrecision, products);
+
+    MPI_Comm comm = ServerRanks::getComm();
+    ServerRanks::lock();
+    int id = nextId++;
+    int command[ServerRanks::COMMAND_SIZE] = { ServerRanks::CREATE_MATRIX, id, 0, 0 };
+    ServerRanks::broadcastCommand(command);
+    for (int r = 1; r < numRanks; r++) {
+        int firstEntry = rowPtr[rowOffsets[r]];
+        int numBlockRows = rowOffsets[r + 1] - rowOffsets[r];
+        int numEntries = rowPtr[rowOffsets[r + 1]] - firstEntry;
+        int header[BLOCK_HEADER_SIZE] = { numBlockRows, numCols, numEntries, numThreads,
+                isSinglePrecision, products };
+        vector<int> blockRowPtr(numBlockRows + 1);
+        for (int i = 0; i <= numBlockRows; i++)
+            blockRowPtr[i] = rowPtr[rowOffsets[r] + i] - firstEntry;
+        MPI_Send(header, BLOCK_HEADER_SIZE, MPI_INT, r, 0, comm);
+        MPI_Send(&blockRowPtr[0], numBlockRows + 1, MPI_INT, r, 0, comm);
+        if (numEntries > 0) {
+            MPI_Send(const_cast<int*>(&cols[firstEntry]), numEntries, MPI_INT, r, 0, comm);
+            MPI_Send(const_cast<double*>(&values[firstEntry]), numEntries, MPI_DOUBLE, r, 0,
+                    comm);
+        }
+    }
+    ServerRanks::unlock();
+    // the block of rank 0 is the beginning of the arrays
+    int numEntries = rowPtr[rowOffsets[1]];
+    return new DistributedCSRMatrix(id, rowOffsets, numCols,
+            vector<int>(rowPtr.begin(), rowPtr.begin() + rowOffsets[1] + 1),
+            vector<int>(cols.begin(), cols.begin() + numEntries),
+            vector<double>(values.begin(), values.begin() + numEntries), numThreads,
+            isSinglePrecision, products);
+}
+
+DistributedCSRMatrix::DistributedCSRMatrix(int _id, const std::vector<int> &_rowOffsets,
+        int _numCols, const std::vector<int> &_rowPtr, const std::vector<int> &_cols,
+        const std::vector<double> &_values, int _numThreads, bool _isSinglePrecision,
+        Products _products) :
+        MathLibrary::CSRMatrix(_rowOffsets[1], _numCols, _rowPtr, _cols, _values, _numThreads,
+                _isSinglePrecision, _products), id(_id), rowOffsets(_rowOffsets) {
+}
+
+DistributedCSRMatrix::~DistributedCSRMatrix() {
+    ServerRanks::lock();
+    int command[ServerRanks::COMMAND_SIZE] = { ServerRanks::DELETE_MATRIX, id, 0, 0 };
+    ServerRanks::broadcastCommand(command);
+    ServerRanks::unlock();
+}
+
+void DistributedCSRMatrix::multiply(bool transpose, const double *x, double *y) const {
+    multiplyBlock(transpose, x, y, 1);
+}
+
+void DistributedCSRMatrix::multiplyBlock(bool transpose, const double *X, double *Y,
+        int numVecs) const {
+    int numRanks = rowOffsets.size() - 1;
+    // the values of rank r are at the rows of its block
+    vector<int> counts(numRanks);
+    vector<int> displacements(numRanks);
+    for (int r = 0; r < numRanks; r++) {
+        counts[r] = (rowOffsets[r + 1] - rowOffsets[r]) * numVecs;
+        displacements[r] = rowOffsets[r] * numVecs;
+    }
+    MPI_Comm comm = ServerRanks::getComm();
+    ServerRanks::lock();
+    int command[ServerRanks::COMMAND_SIZE] = { ServerRanks::MULTIPLY_MATRIX, id, transpose,
+            numVecs };
+    ServerRanks::broadcastCommand(command);
+    if (!transpose) {
+        MPI_Bcast(const_cast<double*>(X), getNumCols() * numVecs, MPI_DOUBLE, 0, comm);
+        // the block of rank 0 holds the first rows
+        MathLibrary::CSRMatrix::multiplyBlock(false, X, Y, numVecs);
+        MPI_Gatherv(MPI_IN_PLACE, counts[0], MPI_DOUBLE, Y, &counts[0], &displacements[0],
+                MPI_DOUBLE, 0, comm);
+    } else {
+        MPI_Scatterv(const_cast<double*>(X), &counts[0], &displacements[0], MPI_DOUBLE,
+                MPI_IN_PLACE, counts[0], MPI_DOUBLE, 0, comm);
+        MathLibrary::CSRMatrix::multiplyBlock(true, X, Y, numVecs);
+        MPI_Reduce(MPI_IN_PLACE, Y, getNumCols() * numVecs, MPI_DOUBLE, MPI_SUM, 0, comm);
+    }
+    ServerRanks::unlock();
+}
+
+void DistributedCSRMatrix::getEntries(std::vector<int> &rowPtr, std::vector<int> &cols,
+        std::vector<double> &values) const {
+    MathLibrary::CSRMatrix::getEntries(rowPtr, cols, values);
+    int numRanks = rowOffsets.size() - 1;
+    MPI_Comm comm = ServerRanks::getComm();
+    ServerRanks::lock();
+    int command[ServerRanks::COMMAND_SIZE] = { ServerRanks::GATHER_MATRIX, id, 0, 0 };
+    ServerRanks::broadcastCommand(command);
+    // the blocks are appended in the order of the ranks, their row pointers shifted by the entries
+    // before them
+    rowPtr.resize(rowOffsets[numRanks] + 1);
+    for (int r = 1; r < numRanks; r++) {
+        int numBlockRows = rowOffsets[r + 1] - rowOffsets[r];
+        int firstEntry = rowPtr[rowOffsets[r]];
+        MPI_Recv(&rowPtr[rowOffsets[r]], numBlockRows + 1, MPI_INT, r, 0, comm,
+                MPI_STATUS_IGNORE);
+        for (int i = rowOffsets[r]; i <= rowOffsets[r + 1]; i++)
+            rowPtr[i] += firstEntry;
+        int numEntries = rowPtr[rowOffsets[r + 1]] - firstEntry;
+        cols.resize(firstEntry + numEntries);
+        values.resize(firstEntry + numEntries);
+        if (numEntries > 0) {
+            MPI_Recv(&cols[firstEntry], numEntries, MPI_INT, r, 0, comm, MPI_STATUS_IGNORE);
+            MPI_Recv(&values[firstEntry], numEntries, MPI_DOUBLE, r, 0, comm, MPI_STATUS_IGNORE);
+        }
+    }
+    ServerRanks::unlock();
+}
+
+void DistributedCSRMatrix::executeCommand(const int *command) {
+    MPI_Comm comm = ServerRanks::getComm();
+    int id = command[1];
+    if (command[0] == ServerRanks::CREATE_MATRIX) {
+        int header[BLOCK_HEADER_SIZE];
+        MPI_Recv(header, BLOCK_HEADER_SIZE, MPI_INT, 0, 0, comm, MPI_STATUS_IGNORE);
+        int numBlockRows = header[0];
+        int numEntries = header[2];
+        vector<int> rowPtr(numBlockRows + 1);
+        vector<int> cols(numEntries);
+        vector<double> values(numEntries);
+        MPI_Recv(&rowPtr[0], numBlockRows + 1, MPI_INT, 0, 0, comm, MPI_STATUS_IGNORE);
+        if (numEntries > 0) {
+            MPI_Recv(&cols[0], numEntries, MPI_INT, 0, 0, comm, MPI_STATUS_IGNORE);
+            MPI_Recv(&values[0], numEntries, MPI_DOUBLE, 0, 0, comm, MPI_STATUS_IGNORE);
+        }
+        workerBlocks[id] = new MathLibrary::CSRMatrix(numBlockRows, header[1], rowPtr, cols,
+                values, header[3], header[4] != 0, (Products) header[5]);
+    } else if (command[0] == ServerRanks::MULTIPLY_MATRIX) {
+        assert(workerBlocks.find(id) != workerBlocks.end());
+        const MathLibrary::CSRMatrix *block = workerBlocks[id];
+        bool transpose = command[2] != 0;
+        int numVecs = command[3];
+        vector<double> X((transpose ? block->getNumRows() : block->getNumCols()) * numVecs);
+        vector<double> Y((transpose ? block->getNumCols() : block->getNumRows()) * numVecs);
+        if (!transpose) {
+            MPI_Bcast(&X[0], X.size(), MPI_DOUBLE, 0, comm);
+            block->multiplyBlock(false, &X[0], &Y[0], numVecs);
+            MPI_Gatherv(&Y[0], Y.size(), MPI_DOUBLE, NULL, NULL, NULL, MPI_DOUBLE, 0, comm);
+        } else {
+            MPI_Scatterv(NULL, NULL, NULL, MPI_DOUBLE, &X[0], X.size(), MPI_DOUBLE, 0, comm);
+            block->multiplyBlock(true, &X[0], &Y[0], numVecs);
+            MPI_Reduce(&Y[0], NULL, Y.size(), MPI_DOUBLE, MPI_SUM, 0, comm);
+        }
+    } else if (command[0] == ServerRanks::GATHER_MATRIX) {
+        assert(workerBlocks.find(id) != workerBlocks.end());
+        vector<int> rowPtr;
+        vector<int> cols;
+        vector<double> values;
+        workerBlocks[id]->getEntries(rowPtr, cols, values);
+        MPI_Send(&rowPtr[0], rowPtr.size(), MPI_INT, 0, 0, comm);
+        if (!cols.empty()) {
+            MPI_Send(&cols[0], cols.size(), MPI_INT, 0, 0, comm);
+            MPI_Send(&values[0], values.size(), MPI_DOUBLE, 0, 0, comm);
+        }
+    } else if (command[0] == ServerRanks::DELETE_MATRIX) {
+        assert(workerBlocks.find(id) != workerBlocks.end());
+        delete workerBlocks[id];
+        workerBlocks.erase(id);
+    } else {
+        assert(false);
+    }
+}
+
+} /* namespace EMPIRE */
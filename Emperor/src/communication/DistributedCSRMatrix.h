@@ -0,0 +1,119 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file DistributedCSRMatrix.h
+ * This file holds the class DistributedCSRMatrix
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef DISTRIBUTEDCSRMATRIX_H_
+#define DISTRIBUTEDCSRMATRIX_H_
+
+#include <vector>
+#include <map>
+#include "CSRMatrix.h"
+
+namespace EMPIRE {
+/********//**
+ * \brief Class DistributedCSRMatrix is a coupling matrix whose rows are split into blocks of
+ *        about equal numbers of entries over the ranks of the Emperor (see ServerRanks). Rank 0
+ *        keeps the first block, each worker rank keeps one of the others, so that the memory and
+ *        the work of the products are divided by the number of ranks. Since the mappers number the
+ *        rows by the nodes of their mesh, a mesh renumbered along a space-filling curve gives
+ *        spatial partitions.
+ *        A product x -> A * x broadcasts x and gathers the rows, a product x -> A^T * x scatters
+ *        x by the row blocks and sums the contributions of the blocks.
+ ***********/
+class DistributedCSRMatrix: public MathLibrary::CSRMatrix {
+public:
+    /// matrices with fewer entries are not distributed, their products are cheaper than the messages
+    static const int MIN_NUM_ENTRIES = 100000;
+    /***********************************************************************************************
+     * \brief Create a coupling matrix, distributed if the Emperor runs on several ranks and the
+     *        matrix is large enough, otherwise a CSRMatrix. Called by rank 0 only, the arguments
+     *        are those of the constructor of CSRMatrix
+     * \return the matrix, which is deleted by the caller
+     ***********/
+    static MathLibrary::CSRMatrix *create(int numRows, int numCols, const std::vector<int> &rowPtr,
+            const std::vector<int> &cols, const std::vector<double> &values, int numThreads,
+            bool isSinglePrecision = false, Products products = BOTH_PRODUCTS);
+    /***********************************************************************************************
+     * \brief Destructor, deletes the row blocks of the workers
+     ***********/
+    virtual ~DistributedCSRMatrix();
+    /***********************************************************************************************
+     * \brief Compute y = A * x or y = A^T * x together with the workers
+     * \param[in] transpose whether the transpose is multiplied
+     * \param[in] x the vector of size numCols (numRows if transposed)
+     * \param[out] y the vector of size numRows (numCols if transposed)
+     ***********/
+    virtual void multiply(bool transpose, const double *x, double *y) const;
+    /***********************************************************************************************
+     * \brief Multiply several interleaved vectors at once together with the workers
+     * \param[in] transpose whether the transpose is multiplied
+     * \param[in] X interleaved vectors, entry i of vector k is X[i * numVecs + k]
+     * \param[out] Y interleaved result vectors
+     * \param[in] numVecs number of vectors
+     ***********/
+    virtual void multiplyBlock(bool transpose, const double *X, double *Y, int numVecs) const;
+    /***********************************************************************************************
+     * \brief Get a copy of the whole matrix in CSR format, the row blocks of the workers are
+     *        gathered on rank 0
+     * \param[out] rowPtr the row pointers of all rows
+     * \param[out] cols the column of every entry
+     * \param[out] values the value of every entry
+     ***********/
+    virtual void getEntries(std::vector<int> &rowPtr, std::vector<int> &cols,
+            std::vector<double> &values) const;
+    /***********************************************************************************************
+     * \brief The rows of the workers are not on rank 0, so no row ranges are multiplied
+     ***********/
+    virtual bool isRowRangeProductSupported() const {
+        return false;
+    }
+    /***********************************************************************************************
+     * \brief Execute a command of rank 0 on the row block of a worker
+     * \param[in] command the command of ServerRanks and its arguments
+     ***********/
+    static void executeCommand(const int *command);
+
+private:
+    /***********************************************************************************************
+     * \brief Constructor, the arguments of CSRMatrix hold the row block of rank 0
+     * \param[in] _id the number of the matrix known to the workers
+     * \param[in] _rowOffsets the rows of rank r are rowOffsets[r] to rowOffsets[r+1]-1
+     ***********/
+    DistributedCSRMatrix(int _id, const std::vector<int> &_rowOffsets, int _numCols,
+            const std::vector<int> &_rowPtr, const std::vector<int> &_cols,
+            const std::vector<double> &_values, int _numThreads, bool _isSinglePrecision,
+            Products _products);
+    /// the number of the matrix known to the workers
+    int id;
+    /// the rows of rank r are rowOffsets[r] to rowOffsets[r+1]-1
+    std::vector<int> rowOffsets;
+    /// the number of the next matrix
+    static int nextId;
+    /// the row blocks of a worker by the numbers of their matrices
+    static std::map<int, MathLibrary::CSRMatrix*> workerBlocks;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* DISTRIBUTEDCSRMATRIX_H_ */
@@ -0,0 +1,137 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <string.h>
+#include "InProcessChannel.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+InProcessChannel::InProcessChannel() {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&changed, NULL);
+}
+
+InProcessChannel::~InProcessChannel() {
+    assert(sendsToClient.empty() && receivesFromClient.empty());
+    pthread_cond_destroy(&changed);
+    pthread_mutex_destroy(&mutex);
+}
+
+void InProcessChannel::postSendToClient(Transfer *transfer) {
+    pthread_mutex_lock(&mutex);
+    transfer->isCompleted = false;
+    sendsToClient.push_back(transfer);
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&mutex);
+}
+
+void InProcessChannel::postReceiveFromClient(Transfer *transfer) {
+    pthread_mutex_lock(&mutex);
+    transfer->isCompleted = false;
+    receivesFromClient.push_back(transfer);
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&mutex);
+}
+
+void InProcessChannel::waitForTransfer(Transfer *transfer) {
+    pthread_mutex_lock(&mutex);
+    while (!transfer->isCompleted)
+        pthread_cond_wait(&changed, &mutex);
+    pthread_mutex_unlock(&mutex);
+}
+
+bool InProcessChannel::isTransferCompleted(Transfer *transfer) {
+    pthread_mutex_lock(&mutex);
+    bool isCompleted = transfer->isCompleted;
+    pthread_mutex_unlock(&mutex);
+    return isCompleted;
+}
+
+void InProcessChannel::sendToServer(const void *message, int numBytes) {
+    Transfer *transfer = takeTransfer(receivesFromClient);
+    // as MPI, the receive buffer may be larger than the message but not smaller
+    assert(numBytes <= transfer->numBytes);
+    memcpy(transfer->buffer, message, numBytes);
+    completeTransfer(transfer);
+}
+
+void InProcessChannel::receiveFromServer(void *message, int numBytes) {
+    Transfer *transfer = takeTransfer(sendsToClient);
+    assert(transfer->numBytes <= numBytes);
+    memcpy(message, transfer->buffer, transfer->numBytes);
+    completeTransfer(transfer);
+}
+
+void InProcessChannel::sendToServerCallback(void *channel, const void *message, int numBytes) {
+    static_cast<InProcessChannel*>(channel)->sendToServer(message, numBytes);
+}
+
+void InProcessChannel::receiveFromServerCallback(void *channel, void *message, int numBytes) {
+    static_cast<InProcessChannel*>(channel)->receiveFromServer(message, numBytes);
+}
+
+InProcessChannel::Transfer *InProcessChannel::takeTransfer(deque<Transfer*> &queue) {
+    pthread_mutex_lock(&mutex);
+    while (queue.empty())
+        pthread_cond_wait(&changed, &mutex);
+    Transfer *transfer = queue.front();
+    queue.pop_front();
+    pthread_mutex_unlock(&mutex);
+    // the buffer is copied outside the lock, only this thread owns the transfer until it completes
+    return transfer;
+}
+
+void InProcessChannel::completeTransfer(Transfer *transfer) {
+    pthread_mutex_lock(&mutex);
+    transfer->isCompleted = true;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&mutex);
+}
+
+InProcessRequest::InProcessRequest(InProcessChannel *_channel, bool _isSend, void *buffer,
+        int numBytes) :
+        channel(_channel), isSend(_isSend) {
+    transfer.buffer = buffer;
+    transfer.numBytes = numBytes;
+    transfer.isCompleted = true;
+}
+
+InProcessRequest::~InProcessRequest() {
+}
+
+void InProcessRequest::start() {
+    if (isSend)
+        channel->postSendToClient(&transfer);
+    else
+        channel->postReceiveFromClient(&transfer);
+}
+
+bool InProcessRequest::test() {
+    return channel->isTransferCompleted(&transfer);
+}
+
+void InProcessRequest::wait() {
+    channel->waitForTransfer(&transfer);
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,177 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file InProcessChannel.h
+ * This file holds the class InProcessChannel
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef INPROCESSCHANNEL_H_
+#define INPROCESSCHANNEL_H_
+
+#include <pthread.h>
+#include <deque>
+#include "AbstractLocalRequest.h"
+
+namespace EMPIRE {
+/********//**
+ * \brief Class InProcessChannel replaces the MPI inter-communicator of a client which runs as a
+ *        thread inside the Emperor process. The Emperor side posts its sends and receives without
+ *        blocking, the client side blocks until the matching transfer of the Emperor is posted
+ *        and copies the message directly between the two buffers. Transfers of each direction
+ *        are matched in the order they are posted, as the messages of an MPI communicator.
+ ***********/
+class InProcessChannel {
+public:
+    /********//**
+     * \brief A buffer posted by the Emperor side
+     ***********/
+    struct Transfer {
+        /// the message to be sent or the buffer to receive into
+        void *buffer;
+        /// size of buffer in bytes
+        int numBytes;
+        /// set by the client side when the message is copied
+        bool isCompleted;
+    };
+    /***********************************************************************************************
+     * \brief Constructor
+     ***********/
+    InProcessChannel();
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~InProcessChannel();
+    /***********************************************************************************************
+     * \brief Post a message to the client, the buffer must not be modified until it is completed
+     * \param[in] transfer the transfer holding the message
+     ***********/
+    void postSendToClient(Transfer *transfer);
+    /***********************************************************************************************
+     * \brief Post a buffer which receives the next message of the client
+     * \param[in] transfer the transfer holding the buffer
+     ***********/
+    void postReceiveFromClient(Transfer *transfer);
+    /***********************************************************************************************
+     * \brief Wait until the client side has completed the transfer
+     * \param[in] transfer the transfer
+     ***********/
+    void waitForTransfer(Transfer *transfer);
+    /***********************************************************************************************
+     * \brief Check whether the client side has completed the transfer
+     * \param[in] transfer the transfer
+     * \return true if the transfer is completed
+     ***********/
+    bool isTransferCompleted(Transfer *transfer);
+    /***********************************************************************************************
+     * \brief Client side, copy the message into the next buffer posted by postReceiveFromClient
+     * \param[in] message the message
+     * \param[in] numBytes size of the message in bytes
+     ***********/
+    void sendToServer(const void *message, int numBytes);
+    /***********************************************************************************************
+     * \brief Client side, copy the next message posted by postSendToClient into the buffer
+     * \param[out] message the buffer
+     * \param[in] numBytes size of the buffer in bytes
+     ***********/
+    void receiveFromServer(void *message, int numBytes);
+    /***********************************************************************************************
+     * \brief C callback of sendToServer, which is handed to the EMPIRE API of the client
+     * \param[in] channel the channel
+     * \param[in] message the message
+     * \param[in] numBytes size of the message in bytes
+     ***********/
+    static void sendToServerCallback(void *channel, const void *message, int numBytes);
+    /***********************************************************************************************
+     * \brief C callback of receiveFromServer, which is handed to the EMPIRE API of the client
+     * \param[in] channel the channel
+     * \param[out] message the buffer
+     * \param[in] numBytes size of the buffer in bytes
+     ***********/
+    static void receiveFromServerCallback(void *channel, void *message, int numBytes);
+
+private:
+    /// protects the queues and the completion flags
+    pthread_mutex_t mutex;
+    /// signaled whenever a transfer is posted or completed
+    pthread_cond_t changed;
+    /// messages posted to the client and not yet received by it
+    std::deque<Transfer*> sendsToClient;
+    /// buffers posted for the client and not yet filled by it
+    std::deque<Transfer*> receivesFromClient;
+    /***********************************************************************************************
+     * \brief Take the first transfer of the queue, waiting until there is one
+     * \param[in] queue the queue
+     * \return the transfer
+     ***********/
+    Transfer *takeTransfer(std::deque<Transfer*> &queue);
+    /***********************************************************************************************
+     * \brief Mark the transfer completed and wake up its waiter
+     * \param[in] transfer the transfer
+     ***********/
+    void completeTransfer(Transfer *transfer);
+    /// disallow copy constructor
+    InProcessChannel(const InProcessChannel&);
+    /// disallow assignment operator
+    InProcessChannel& operator=(const InProcessChannel&);
+};
+
+/********//**
+ * \brief Class InProcessRequest is a non-blocking send to or receive from an in-process client
+ ***********/
+class InProcessRequest: public AbstractLocalRequest {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _channel the channel of the client
+     * \param[in] _isSend whether the request sends to the client or receives from it
+     * \param[in] buffer the message or the receive buffer
+     * \param[in] numBytes the size of buffer in bytes
+     ***********/
+    InProcessRequest(InProcessChannel *_channel, bool _isSend, void *buffer, int numBytes);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~InProcessRequest();
+    /***********************************************************************************************
+     * \brief Post the buffer to the channel
+     ***********/
+    void start();
+    /***********************************************************************************************
+     * \brief Check whether the client has completed the transfer
+     * \return true if the transfer is completed
+     ***********/
+    bool test();
+    /***********************************************************************************************
+     * \brief Wait until the client has completed the transfer
+     ***********/
+    void wait();
+
+private:
+    /// the channel of the client
+    InProcessChannel *channel;
+    /// whether the request sends to the client or receives from it
+    bool isSend;
+    /// the posted buffer
+    InProcessChannel::Transfer transfer;
+};
+
+} /* namespace EMPIRE */
+#endif /* INPROCESSCHANNEL_H_ */
@@ -22,8 +22,16 @@
 #include "Message.h"
 #include "MetaDatabase.h"
 #include "MPIErrorHandling.h"
+#include "TraceWriter.h"
+#include "ServerRanks.h"
 
 #include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <sstream>
+#include <sched.h>
+#include <unistd.h>
+#include <dlfcn.h>
 using namespace std;
 
 namespace EMPIRE {
@@ -42,19 +50,34 @@ ServerCommunication *ServerCommunication::getSingleton() {
 
 ServerCommunication::ServerCommunication(int *argc, char ***argv) {
     terminateListening = false;
+    isProgressThreadRunning = false;
+    terminateProgress = false;
     clientNameCommMap = new map<string, MPI_Comm>;
+    pthread_mutex_init(&requestPoolMutex, NULL);
+    pthread_cond_init(&requestActivatedCondition, NULL);
+    pthread_cond_init(&requestCompletedCondition, NULL);
+    pthread_mutex_init(&connectionMutex, NULL);
+    pthread_cond_init(&connectionCondition, NULL);
     int providedThreadSupport;
     assert(MetaDatabase::getSingleton() != NULL);
-    totalNumClients = MetaDatabase::getSingleton()->settingClientCodeVec.size();
+    countClients();
     MPI_Init_thread(argc, argv, MPI_THREAD_MULTIPLE, &providedThreadSupport);
     if (MPI_THREAD_MULTIPLE != providedThreadSupport) {
         WARNING_OUT() << "Requested MPI thread support is not guaranteed." << endl;
     }
+    ServerRanks::init();
+    // the clients connect to rank 0 only, the other ranks are workers
+    if (ServerRanks::getRank() > 0)
+        return;
+    char portNameChar[MPI_MAX_PORT_NAME];
+    MPI_Open_port(MPI_INFO_NULL, portNameChar);
+    portName = portNameChar;
+    writePortFile();
+}
+
+void ServerCommunication::writePortFile() {
     portFile.open((const char*) (MetaDatabase::getSingleton()->serverPortFile.c_str()));
     if (portFile.is_open()) {
-        char portNameChar[MPI_MAX_PORT_NAME];
-        MPI_Open_port(MPI_INFO_NULL, portNameChar);
-        portName = portNameChar;
         portFile << portName << endl;
         portFile.close();
     } else {
@@ -63,7 +86,46 @@ ServerCommunication::ServerCommunication(int *argc, char ***argv) {
     }
 }
 
+void ServerCommunication::countClients() {
+    ensembleSize = MetaDatabase::getSingleton()->ensembleSize;
+    totalNumClients = MetaDatabase::getSingleton()->settingClientCodeVec.size() * ensembleSize;
+}
+
+string ServerCommunication::getReplicaName(const string &clientName, int replica) {
+    if (replica == 0)
+        return clientName;
+    stringstream replicaName;
+    replicaName << clientName << "#" << replica;
+    return replicaName.str();
+}
+
+string ServerCommunication::findConnectionName(const string &clientName) {
+    MetaDatabase *metaDatabase = MetaDatabase::getSingleton();
+    if (metaDatabase->checkForClientCodeName(clientName)) {
+        // the first replica without this client, the first one again if all replicas have it
+        for (int replica = 0; replica < ensembleSize; replica++) {
+            string replicaName = getReplicaName(clientName, replica);
+            if (clientNameCommMap->find(replicaName) == clientNameCommMap->end())
+                return replicaName;
+        }
+        return clientName;
+    }
+    size_t separator = clientName.rfind('#');
+    if (separator == string::npos || ensembleSize == 1)
+        return "";
+    string baseName = clientName.substr(0, separator);
+    int replica = atoi(clientName.c_str() + separator + 1);
+    if (!metaDatabase->checkForClientCodeName(baseName) || replica < 0 || replica >= ensembleSize)
+        return "";
+    return getReplicaName(baseName, replica);
+}
+
 ServerCommunication::~ServerCommunication() {
+    pthread_mutex_destroy(&requestPoolMutex);
+    pthread_cond_destroy(&requestActivatedCondition);
+    pthread_cond_destroy(&requestCompletedCondition);
+    pthread_mutex_destroy(&connectionMutex);
+    pthread_cond_destroy(&connectionCondition);
     delete clientNameCommMap;
 }
 
@@ -75,8 +137,8 @@ void ServerCommunication::startListening() {
         /// set up inter-communicator for a connecting client
         MPI_Status status;
         MPI_Comm interClient = MPI_COMM_NULL;
-        MPI_Comm world = MPI_COMM_NULL; // a duplication of MPI_COMM_WORLD
-        MPI_Comm_dup(MPI_COMM_WORLD, &world);
+        MPI_Comm world = MPI_COMM_NULL; // a duplication of MPI_COMM_SELF, only rank 0 accepts
+        MPI_Comm_dup(MPI_COMM_SELF, &world);
         MPI_Comm_set_errhandler(world, MPI_ERRORS_RETURN); // we set the error handler of it to MPI_ERRORS_RETURN
         MPI_Comm_accept((char*) (portName.c_str()), MPI_INFO_NULL, 0, world, &interClient);
         if (terminateListening == true) {
@@ -94,29 +156,36 @@ void ServerCommunication::startListening() {
         MPI_Recv(clientName, NAME_STRING_LENGTH, MPI_CHAR, MPI_ANY_SOURCE, MPI_ANY_TAG, interClient,
                 &status);
         string clientNameS(clientName);
+        // the clients connected before are served by the coupling thread meanwhile
+        pthread_mutex_lock(&connectionMutex);
+        // the name of the replica of an ensemble, empty if the client is not in the input file
+        string connectionName = findConnectionName(clientNameS);
 
         /// Add client into clientNameCommMap
-        if (MetaDatabase::getSingleton()->checkForClientCodeName(clientNameS)) { /// Check if client code is defined in input file
+        if (!connectionName.empty()) { /// Check if client code is defined in input file
             bool inserted = clientNameCommMap->insert(
-                    pair<string, MPI_Comm>(clientNameS, interClient)).second;
+                    pair<string, MPI_Comm>(connectionName, interClient)).second;
             if (!inserted) { // this means the client with the same name has been connected
-                WARNING_OUT() << "Client " << clientNameS << " is connected again!!!" << " The old connection is removed!!!" << endl;
-                int MPIerror = MPI_Comm_free(&(clientNameCommMap->at(clientNameS)));
+                WARNING_OUT() << "Client " << connectionName << " is connected again!!!" << " The old connection is removed!!!" << endl;
+                int MPIerror = MPI_Comm_free(&(clientNameCommMap->at(connectionName)));
                 if (MPIerror != MPI_SUCCESS) {
                     WARNING_OUT() << "MPI_Comm_free fails!" << endl;
                 } else {
                     WARNING_OUT() << "MPI_Comm_free done!" << endl;
                 }
-                clientNameCommMap->erase(clientNameS);
+                clientNameCommMap->erase(connectionName);
                 inserted = clientNameCommMap->insert(
-                        pair<string, MPI_Comm>(clientNameS, interClient)).second;
+                        pair<string, MPI_Comm>(connectionName, interClient)).second;
                 assert(inserted == true);
             }
+            pthread_cond_broadcast(&connectionCondition);
+            pthread_mutex_unlock(&connectionMutex);
             /// Tell client that everything is okay
             connectionSuccessful = 1;
             MPI_Send(&connectionSuccessful, 1, MPI_INT, 0, 0, interClient);
-            INFO_OUT() << "Client " << clientNameS << " connected" << ", inter-communicator: " << hex << interClient << ", intra-communicator: " << hex << world << endl;
+            INFO_OUT() << "Client " << connectionName << " connected" << ", inter-communicator: " << hex << interClient << ", intra-communicator: " << hex << world << endl;
         } else {
+            pthread_mutex_unlock(&connectionMutex);
             /// Tell client to disconnect
             connectionSuccessful = 0;
             MPI_Send(&connectionSuccessful, 1, MPI_INT, 0, 0, interClient);
@@ -132,31 +201,416 @@ void ServerCommunication::startListening() {
     }
 }
 
-void ServerCommunication::disconnectAllClients() {
-    for (map<string, MPI_Comm>::iterator it = clientNameCommMap->begin();
-            it != clientNameCommMap->end(); it++) {
-        MPI_Comm_disconnect(&(it->second));
+void ServerCommunication::startInProcessClients() {
+    typedef void (*SetInProcessLink)(void*, void (*)(void*, const void*, int),
+            void (*)(void*, void*, int));
+    const vector<structClientCode> &settingClientCodeVec =
+            MetaDatabase::getSingleton()->settingClientCodeVec;
+    for (unsigned i = 0; i < settingClientCodeVec.size(); i++) {
+        const structClientCode &settingClientCode = settingClientCodeVec[i];
+        if (settingClientCode.inProcessLibrary.empty())
+            continue;
+        if (ensembleSize > 1) {
+            ERROR_OUT() << "In-process client " << settingClientCode.name
+                    << " cannot be replicated by an ensemble" << endl;
+            exit(-1);
+        }
+        InProcessClient &inProcessClient = inProcessClients[settingClientCode.name];
+        inProcessClient.libraryPath = settingClientCode.inProcessLibrary;
+        inProcessClient.library = dlopen(inProcessClient.libraryPath.c_str(),
+                RTLD_NOW | RTLD_LOCAL);
+        if (inProcessClient.library == NULL) {
+            ERROR_OUT() << "Unable to load in-process client " << settingClientCode.name << ": "
+                    << dlerror() << endl;
+            exit(-1);
+        }
+        SetInProcessLink setInProcessLink = (SetInProcessLink) dlsym(inProcessClient.library,
+                "EMPIRE_API_setInProcessLink");
+        inProcessClient.entry = (int (*)(int, char**)) dlsym(inProcessClient.library,
+                "EMPIRE_inProcessClientMain");
+        if (setInProcessLink == NULL || inProcessClient.entry == NULL) {
+            ERROR_OUT() << "In-process client " << settingClientCode.name
+                    << " has to be linked to the EMPIRE API and define "
+                    << "int EMPIRE_inProcessClientMain(int argc, char **argv)" << endl;
+            exit(-1);
+        }
+        inProcessClient.channel = new InProcessChannel();
+        setInProcessLink(inProcessClient.channel, &InProcessChannel::sendToServerCallback,
+                &InProcessChannel::receiveFromServerCallback);
+        pthread_create(&inProcessClient.thread, NULL, &ServerCommunication::runInProcessClient,
+                &inProcessClient);
+        INFO_OUT() << "Client " << settingClientCode.name << " connected in-process from "
+                << inProcessClient.libraryPath << endl;
     }
+}
+
+void *ServerCommunication::runInProcessClient(void *inProcessClient) {
+    InProcessClient *client = static_cast<InProcessClient*>(inProcessClient);
+    char *argv[2] = { const_cast<char*>(client->libraryPath.c_str()), NULL };
+    client->entry(1, argv);
+    return NULL;
+}
+
+void ServerCommunication::disconnectAllClients() {
+    disconnectClients();
     terminateListening = true;
     /// Connect to your self in order to terminate listening
     MPI_Comm dummy;
-    MPI_Comm_connect((char*) (portName.c_str()), MPI_INFO_NULL, 0, MPI_COMM_WORLD, &dummy);
+    MPI_Comm_connect((char*) (portName.c_str()), MPI_INFO_NULL, 0, MPI_COMM_SELF, &dummy);
     MPI_Comm_disconnect(&dummy);
     MPI_Close_port((char*) (portName.c_str()));
 }
 
+void ServerCommunication::endSession() {
+    remove(MetaDatabase::getSingleton()->serverPortFile.c_str());
+    disconnectClients();
+}
+
+void ServerCommunication::beginSession() {
+    assert(clientNameCommMap->empty() && inProcessClients.empty());
+    countClients();
+    writePortFile();
+}
+
+void ServerCommunication::disconnectClients() {
+    for (unsigned i = 0; i < requestPool.size(); i++)
+        if (isPersistentRequest[i])
+            freeRequest(i);
+    for (map<string, InProcessClient>::iterator it = inProcessClients.begin();
+            it != inProcessClients.end(); it++) {
+        pthread_join(it->second.thread, NULL);
+        dlclose(it->second.library);
+        delete it->second.channel;
+    }
+    inProcessClients.clear();
+    pthread_mutex_lock(&connectionMutex);
+    for (map<string, MPI_Comm>::iterator it = clientNameCommMap->begin();
+            it != clientNameCommMap->end(); it++) {
+        MPI_Comm_disconnect(&(it->second));
+    }
+    clientNameCommMap->clear();
+    pthread_mutex_unlock(&connectionMutex);
+}
+
 bool ServerCommunication::allClientsConnected() {
-    if (totalNumClients == clientNameCommMap->size()) {
-        return (true);
+    pthread_mutex_lock(&connectionMutex);
+    bool allConnected = totalNumClients == clientNameCommMap->size() + inProcessClients.size();
+    pthread_mutex_unlock(&connectionMutex);
+    return allConnected;
+}
+
+string ServerCommunication::waitForClientConnection(const set<string> &clientNames, bool wait) {
+    pthread_mutex_lock(&connectionMutex);
+    string connected;
+    while (true) {
+        for (set<string>::const_iterator it = clientNames.begin(); it != clientNames.end(); it++) {
+            if (clientNameCommMap->find(*it) != clientNameCommMap->end()
+                    || inProcessClients.find(*it) != inProcessClients.end()) {
+                connected = *it;
+                break;
+            }
+        }
+        if (!connected.empty() || !wait)
+            break;
+        pthread_cond_wait(&connectionCondition, &connectionMutex);
+    }
+    pthread_mutex_unlock(&connectionMutex);
+    return connected;
+}
+
+int ServerCommunication::addRequest(MPI_Request request, bool persistent) {
+    pthread_mutex_lock(&requestPoolMutex);
+    int requestHandle;
+    if (freeRequestHandles.empty()) {
+        requestPool.push_back(request);
+        isPersistentRequest.push_back(persistent);
+        localRequestPool.push_back(NULL);
+        requestHandle = requestPool.size() - 1;
+    } else {
+        requestHandle = freeRequestHandles.back();
+        freeRequestHandles.pop_back();
+        requestPool[requestHandle] = request;
+        isPersistentRequest[requestHandle] = persistent;
+        assert(localRequestPool[requestHandle] == NULL);
+    }
+    if (!persistent && request != MPI_REQUEST_NULL)
+        activateRequest(requestHandle);
+    pthread_mutex_unlock(&requestPoolMutex);
+    return requestHandle;
+}
+
+void ServerCommunication::activateRequest(int requestHandle) {
+    if (!isProgressThreadRunning)
+        return;
+    activeRequests.insert(requestHandle);
+    pthread_cond_signal(&requestActivatedCondition);
+}
+
+void ServerCommunication::startProgressThread() {
+    pthread_mutex_lock(&requestPoolMutex);
+    assert(!isProgressThreadRunning);
+    isProgressThreadRunning = true;
+    terminateProgress = false;
+    pthread_mutex_unlock(&requestPoolMutex);
+    pthread_create(&progressThread, NULL, &ServerCommunication::runProgressThread, this);
+}
+
+void ServerCommunication::stopProgressThread() {
+    pthread_mutex_lock(&requestPoolMutex);
+    if (!isProgressThreadRunning) {
+        pthread_mutex_unlock(&requestPoolMutex);
+        return;
+    }
+    terminateProgress = true;
+    pthread_cond_signal(&requestActivatedCondition);
+    pthread_mutex_unlock(&requestPoolMutex);
+    pthread_join(progressThread, NULL);
+    // the requests which are still pending stay in the pool and are waited for by MPI again
+    pthread_mutex_lock(&requestPoolMutex);
+    isProgressThreadRunning = false;
+    activeRequests.clear();
+    pthread_mutex_unlock(&requestPoolMutex);
+}
+
+void *ServerCommunication::runProgressThread(void *serverCommunication) {
+    static_cast<ServerCommunication*>(serverCommunication)->progressRequests();
+    return NULL;
+}
+
+void ServerCommunication::progressRequests() {
+    // The requests are tested on copies outside of the lock, such that the coupling thread can
+    // start new requests meanwhile. Only this thread calls MPI on a request while it is active.
+    vector<int> handles;
+    vector<MPI_Request> requests;
+    vector<int> completed;
+    pthread_mutex_lock(&requestPoolMutex);
+    while (!terminateProgress) {
+        if (activeRequests.empty()) {
+            pthread_cond_wait(&requestActivatedCondition, &requestPoolMutex);
+            continue;
+        }
+        handles.assign(activeRequests.begin(), activeRequests.end());
+        int numRequests = handles.size();
+        requests.resize(numRequests);
+        completed.resize(numRequests);
+        for (int i = 0; i < numRequests; i++)
+            requests[i] = requestPool[handles[i]];
+        pthread_mutex_unlock(&requestPoolMutex);
+        int numCompleted = 0;
+        MPI_Testsome(numRequests, &requests[0], &numCompleted, &completed[0],
+                MPI_STATUSES_IGNORE);
+        if (numCompleted == 0 || numCompleted == MPI_UNDEFINED)
+            usleep(PROGRESS_POLLING_INTERVAL);
+        pthread_mutex_lock(&requestPoolMutex);
+        if (numCompleted == 0 || numCompleted == MPI_UNDEFINED)
+            continue;
+        // the completed requests are now null or inactive, as after a wait
+        for (int i = 0; i < numCompleted; i++) {
+            requestPool[handles[completed[i]]] = requests[completed[i]];
+            activeRequests.erase(handles[completed[i]]);
+        }
+        pthread_cond_broadcast(&requestCompletedCondition);
+    }
+    pthread_mutex_unlock(&requestPoolMutex);
+}
+
+int ServerCommunication::addLocalRequest(AbstractLocalRequest *request, bool persistent) {
+    int requestHandle = addRequest(MPI_REQUEST_NULL, persistent);
+    pthread_mutex_lock(&requestPoolMutex);
+    localRequestPool[requestHandle] = request;
+    pthread_mutex_unlock(&requestPoolMutex);
+    if (!persistent)
+        request->start();
+    return requestHandle;
+}
+
+int ServerCommunication::initSendToClientBySharedMemory(SharedMemorySegment *segment,
+        double *message) {
+    return addLocalRequest(new SharedMemoryRequest(segment, true, message), true);
+}
+
+int ServerCommunication::initReceiveFromClientBySharedMemory(SharedMemorySegment *segment,
+        double *message) {
+    return addLocalRequest(new SharedMemoryRequest(segment, false, message), true);
+}
+
+// The pool may grow while a request is waited for, so the request is copied out of the pool for
+// the wait and stored back afterwards. A handle is used by one thread only.
+
+void ServerCommunication::startRequest(int requestHandle) {
+    pthread_mutex_lock(&requestPoolMutex);
+    assert(requestHandle >= 0 && requestHandle < requestPool.size());
+    assert(isPersistentRequest[requestHandle]);
+    AbstractLocalRequest *localRequest = localRequestPool[requestHandle];
+    if (localRequest == NULL) {
+        MPI_Start(&requestPool[requestHandle]);
+        activateRequest(requestHandle);
+    }
+    pthread_mutex_unlock(&requestPoolMutex);
+    if (localRequest != NULL)
+        localRequest->start();
+}
+
+void ServerCommunication::freeRequest(int requestHandle) {
+    pthread_mutex_lock(&requestPoolMutex);
+    assert(requestHandle >= 0 && requestHandle < requestPool.size());
+    assert(isPersistentRequest[requestHandle]);
+    if (localRequestPool[requestHandle] != NULL) {
+        delete localRequestPool[requestHandle];
+        localRequestPool[requestHandle] = NULL;
+    } else {
+        MPI_Request_free(&requestPool[requestHandle]);
+    }
+    isPersistentRequest[requestHandle] = false;
+    freeRequestHandles.push_back(requestHandle);
+    pthread_mutex_unlock(&requestPoolMutex);
+}
+
+void ServerCommunication::waitForRequest(int requestHandle) {
+    pthread_mutex_lock(&requestPoolMutex);
+    assert(requestHandle >= 0 && requestHandle < requestPool.size());
+    AbstractLocalRequest *localRequest = localRequestPool[requestHandle];
+    MPI_Request request = requestPool[requestHandle];
+    bool isPersistent = isPersistentRequest[requestHandle];
+    if (localRequest == NULL && isProgressThreadRunning) { // the progress thread completes it
+        while (activeRequests.find(requestHandle) != activeRequests.end())
+            pthread_cond_wait(&requestCompletedCondition, &requestPoolMutex);
+        if (!isPersistent)
+            freeRequestHandles.push_back(requestHandle);
+        pthread_mutex_unlock(&requestPoolMutex);
+        return;
+    }
+    pthread_mutex_unlock(&requestPoolMutex);
+    if (localRequest != NULL)
+        localRequest->wait();
+    else
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
+    pthread_mutex_lock(&requestPoolMutex);
+    if (localRequest != NULL) {
+        if (!isPersistent) {
+            delete localRequest;
+            localRequestPool[requestHandle] = NULL;
+        }
+    } else {
+        requestPool[requestHandle] = request;
+    }
+    if (!isPersistent)
+        freeRequestHandles.push_back(requestHandle);
+    pthread_mutex_unlock(&requestPoolMutex);
+}
+
+int ServerCommunication::waitForAnyRequest(const vector<int> &requestHandles) {
+    assert(!requestHandles.empty());
+    int numRequests = requestHandles.size();
+    MPI_Request *requests = new MPI_Request[numRequests];
+    bool isLocal = false;
+    pthread_mutex_lock(&requestPoolMutex);
+    for (int i = 0; i < numRequests; i++) {
+        requests[i] = requestPool[requestHandles[i]];
+        if (localRequestPool[requestHandles[i]] != NULL)
+            isLocal = true;
+    }
+    if (!isLocal && isProgressThreadRunning) { // wait for the progress thread
+        delete[] requests;
+        int completed = -1;
+        while (completed < 0) {
+            for (int i = 0; i < numRequests && completed < 0; i++)
+                if (activeRequests.find(requestHandles[i]) == activeRequests.end())
+                    completed = i;
+            if (completed < 0)
+                pthread_cond_wait(&requestCompletedCondition, &requestPoolMutex);
+        }
+        pthread_mutex_unlock(&requestPoolMutex);
+        return completed;
+    }
+    pthread_mutex_unlock(&requestPoolMutex);
+    if (isLocal) {
+        delete[] requests;
+        return pollForAnyRequest(requestHandles);
+    }
+    int completed = MPI_UNDEFINED;
+    MPI_Waitany(numRequests, requests, &completed, MPI_STATUS_IGNORE);
+    assert(completed != MPI_UNDEFINED);
+    // the completed request is now null or inactive, so that waiting on it again returns at once
+    pthread_mutex_lock(&requestPoolMutex);
+    requestPool[requestHandles[completed]] = requests[completed];
+    pthread_mutex_unlock(&requestPoolMutex);
+    delete[] requests;
+    return completed;
+}
+
+int ServerCommunication::pollForAnyRequest(const vector<int> &requestHandles) {
+    while (true) {
+        for (unsigned i = 0; i < requestHandles.size(); i++) {
+            pthread_mutex_lock(&requestPoolMutex);
+            AbstractLocalRequest *localRequest = localRequestPool[requestHandles[i]];
+            int isCompleted = 0;
+            if (localRequest == NULL && isProgressThreadRunning)
+                isCompleted = activeRequests.find(requestHandles[i]) == activeRequests.end();
+            else if (localRequest == NULL)
+                MPI_Test(&requestPool[requestHandles[i]], &isCompleted, MPI_STATUS_IGNORE);
+            pthread_mutex_unlock(&requestPoolMutex);
+            if (localRequest != NULL)
+                isCompleted = localRequest->test();
+            if (isCompleted)
+                return i;
+        }
+        sched_yield();
+    }
+}
+
+void ServerCommunication::profileTransfer(const string &clientName, const string &item,
+        bool isSend, double startTime, double arrivalTime, long bytes) {
+    double endTime = omp_get_wtime();
+    double blockedTime = (arrivalTime < 0.0 ? endTime : arrivalTime) - startTime;
+    double transferTime = arrivalTime < 0.0 ? 0.0 : endTime - arrivalTime;
+    string labels = LiveMetrics::label("client", clientName) + ","
+            + LiveMetrics::label("direction", isSend ? "send" : "receive");
+    LiveMetrics::add(LiveMetrics::CLIENT_BYTES, labels, bytes);
+    LiveMetrics::add(LiveMetrics::CLIENT_WAIT_SECONDS, labels, blockedTime);
+    string counter = (isSend ? "send to [" : "receive from [") + clientName + "]";
+    for (int i = 0; i < (item.empty() ? 1 : 2); i++) {
+        if (i == 1)
+            counter += " " + item;
+        Profiler::addCount(counter + " bytes", bytes);
+        Profiler::addCount(counter + " blocked time", blockedTime);
+        if (arrivalTime >= 0.0)
+            Profiler::addCount(counter + " transfer time", transferTime);
+    }
+
+    if (!TraceWriter::isOpen())
+        return;
+    int track = TraceWriter::getTrack("[" + clientName + "]");
+    string name = isSend ? "send" : "receive";
+    if (!item.empty())
+        name += " " + item;
+    if (arrivalTime < 0.0) {
+        TraceWriter::addEvent(track, name, "wait", startTime, endTime, bytes);
+    } else {
+        TraceWriter::addEvent(track, "wait for " + name, "wait", startTime, arrivalTime);
+        TraceWriter::addEvent(track, name, "transfer", arrivalTime, endTime, bytes);
     }
-    return (false);
 }
 
 void ServerCommunication::getClientNames(set<string> *names) {
+    pthread_mutex_lock(&connectionMutex);
     for (map<string, MPI_Comm>::iterator it = clientNameCommMap->begin();
             it != clientNameCommMap->end(); it++) {
         names->insert(it->first);
     }
+    pthread_mutex_unlock(&connectionMutex);
+    for (map<string, InProcessClient>::iterator it = inProcessClients.begin();
+            it != inProcessClients.end(); it++) {
+        names->insert(it->first);
+    }
+}
+
+int ServerCommunication::getClientSize(const std::string &clientName) {
+    if (getInProcessChannel(clientName) != NULL)
+        return 1;
+    int size;
+    MPI_Comm_remote_size(getClientComm(clientName), &size);
+    return size;
 }
 
 } /* namespace EMPIRE */
@@ -31,7 +31,15 @@
 #include <string>
 #include <set>
 #include <map>
+#include <vector>
 #include <typeinfo>
+#include <assert.h>
+#include <pthread.h>
+#include <omp.h>
+#include "InProcessChannel.h"
+#include "Profiler.h"
+#include "LiveMetrics.h"
+#include "SharedMemorySegment.h"
 
 namespace EMPIRE {
 /********//**
@@ -67,12 +75,41 @@ public:
      * \author Stefan Sicklinger
      ***********/
     void disconnectAllClients();
+    /***********************************************************************************************
+     * \brief End a session of the Emperor daemon: disconnect all clients but keep the port open
+     *        and the listening thread running. The port file is removed, such that the clients of
+     *        the next session wait until it is written by beginSession.
+     ***********/
+    void endSession();
+    /***********************************************************************************************
+     * \brief Begin the next session of the Emperor daemon after the MetaDatabase has been replaced
+     *        by the one of the session: take over its number of clients and write the port file
+     ***********/
+    void beginSession();
+    /***********************************************************************************************
+     * \brief Get the name a client of a replica of an ensemble is connected under. A client gives
+     *        its replica by connecting as "name#replica", a client connecting with the plain name
+     *        again is taken as the client of the next replica without it.
+     * \param[in] clientName the name of the client code in the input file
+     * \param[in] replica the replica, 0 for the first one
+     * \return the name, clientName itself for the first replica
+     ***********/
+    static std::string getReplicaName(const std::string &clientName, int replica);
     /***********************************************************************************************
      * \brief Return status of clients connections
      * \return True if all clients are connected
      * \author Stefan Sicklinger
      ***********/
     bool allClientsConnected();
+    /***********************************************************************************************
+     * \brief Wait until one of the given clients is connected. The listening thread accepts the
+     *        clients in the order in which they connect, such that the Emperor can receive the
+     *        meshes of a connected client while the others are still starting
+     * \param[in] clientNames the names the clients are connected under
+     * \param[in] wait whether to wait if none of the clients is connected yet
+     * \return the name of a connected client, empty if none is connected and wait is false
+     ***********/
+    std::string waitForClientConnection(const std::set<std::string> &clientNames, bool wait);
     /***********************************************************************************************
      * \brief Template function for sending data to client
      * \param[in] clientName is a string which holds the name of the receiver client
@@ -82,7 +119,17 @@ public:
      ***********/
     template<class T>
     void sendToClientBlocking(const std::string &clientName, int size, T* message) {
-        MPI_Comm client = clientNameCommMap->at(clientName);
+        double startTime = isTransferProfiled() ? omp_get_wtime() : 0.0;
+        InProcessChannel *channel = getInProcessChannel(clientName);
+        if (channel != NULL) {
+            InProcessChannel::Transfer transfer = { message, size * (int) sizeof(T), false };
+            channel->postSendToClient(&transfer);
+            channel->waitForTransfer(&transfer);
+            if (isTransferProfiled())
+                profileTransfer(clientName, "", true, startTime, -1.0, size * sizeof(T));
+            return;
+        }
+        MPI_Comm client = getClientComm(clientName);
         /*
          #define MPI_BYTE           ...
          #define MPI_PACKED         ...
@@ -103,6 +150,9 @@ public:
         } else if (typeid(T) == typeid(char)) {
             MPI_Ssend(message, size, MPI_CHAR, 0, 0, client);
         }
+        // a synchronous send cannot tell the wait for the matching receive from the transfer
+        if (isTransferProfiled())
+            profileTransfer(clientName, "", true, startTime, -1.0, size * sizeof(T));
     }
     /***********************************************************************************************
      * \brief Template function for sending data to client
@@ -117,32 +167,265 @@ public:
          #define MPI_BYTE           ...
          #define MPI_PACKED         ...
          */
-        MPI_Comm client = clientNameCommMap->at(clientName);
+        double startTime = isTransferProfiled() ? omp_get_wtime() : 0.0;
+        InProcessChannel *channel = getInProcessChannel(clientName);
+        if (channel != NULL) {
+            InProcessChannel::Transfer transfer = { message, size * (int) sizeof(T), false };
+            channel->postReceiveFromClient(&transfer);
+            channel->waitForTransfer(&transfer);
+            if (isTransferProfiled())
+                profileTransfer(clientName, "", false, startTime, -1.0, size * sizeof(T));
+            return;
+        }
+        MPI_Comm client = getClientComm(clientName);
+        // the probe returns when the message has arrived, the receive is then the transfer only
+        double arrivalTime = -1.0;
+        if (isTransferProfiled()) {
+            MPI_Probe(MPI_ANY_SOURCE, DEFAULT_TAG, client, &status);
+            arrivalTime = omp_get_wtime();
+        }
         if (typeid(T) == typeid(int)) {
-            MPI_Recv(message, size, MPI_INTEGER, MPI_ANY_SOURCE, MPI_ANY_TAG, client, &status);
+            MPI_Recv(message, size, MPI_INTEGER, MPI_ANY_SOURCE, DEFAULT_TAG, client, &status);
         } else if (typeid(T) == typeid(double)) {
-            MPI_Recv(message, size, MPI_DOUBLE, MPI_ANY_SOURCE, MPI_ANY_TAG, client, &status);
+            MPI_Recv(message, size, MPI_DOUBLE, MPI_ANY_SOURCE, DEFAULT_TAG, client, &status);
         } else if (typeid(T) == typeid(float)) {
-            MPI_Recv(message, size, MPI_FLOAT, MPI_ANY_SOURCE, MPI_ANY_TAG, client, &status);
+            MPI_Recv(message, size, MPI_FLOAT, MPI_ANY_SOURCE, DEFAULT_TAG, client, &status);
         } else if (typeid(T) == typeid(unsigned char)) {
-            MPI_Recv(message, size, MPI_UNSIGNED_CHAR, MPI_ANY_SOURCE, MPI_ANY_TAG, client,
+            MPI_Recv(message, size, MPI_UNSIGNED_CHAR, MPI_ANY_SOURCE, DEFAULT_TAG, client,
                     &status);
         } else if (typeid(T) == typeid(long double)) {
-            MPI_Recv(message, size, MPI_LONG_DOUBLE, MPI_ANY_SOURCE, MPI_ANY_TAG, client, &status);
+            MPI_Recv(message, size, MPI_LONG_DOUBLE, MPI_ANY_SOURCE, DEFAULT_TAG, client, &status);
         } else if (typeid(T) == typeid(short)) {
-            MPI_Recv(message, size, MPI_SHORT, MPI_ANY_SOURCE, MPI_ANY_TAG, client, &status);
+            MPI_Recv(message, size, MPI_SHORT, MPI_ANY_SOURCE, DEFAULT_TAG, client, &status);
         } else if (typeid(T) == typeid(char)) {
-            MPI_Recv(message, size, MPI_CHAR, MPI_ANY_SOURCE, MPI_ANY_TAG, client, &status);
+            MPI_Recv(message, size, MPI_CHAR, MPI_ANY_SOURCE, DEFAULT_TAG, client, &status);
         }
+        if (isTransferProfiled())
+            profileTransfer(clientName, "", false, startTime, arrivalTime, size * sizeof(T));
+    }
+    /***********************************************************************************************
+     * \brief Template function for starting a non-blocking send of data to client. The message
+     *        must not be modified until the returned request is completed by waitForRequest
+     * \param[in] clientName is a string which holds the name of the receiver client
+     * \param[in] size is the length of the message
+     * \param[in] message is a pointer to the message which is going to be sent
+     * \return the handle of the request
+     ***********/
+    template<class T>
+    int sendToClientNonBlocking(const std::string &clientName, int size, T* message) {
+        InProcessChannel *channel = getInProcessChannel(clientName);
+        if (channel != NULL)
+            return addLocalRequest(
+                    new InProcessRequest(channel, true, message, size * sizeof(T)), false);
+        MPI_Comm client = getClientComm(clientName);
+        MPI_Request request;
+        MPI_Isend(message, size, getMPIDatatype<T>(), 0, 0, client, &request);
+        return addRequest(request);
     }
+    /***********************************************************************************************
+     * \brief Template function for starting a non-blocking receive of data from client. Messages
+     *        of the same client are matched in the order the receives are started
+     * \param[in] clientName is a string which holds the name of the sender client
+     * \param[in] size is the length of the message
+     * \param[out] message is a pointer to the message which is going to be received
+     * \return the handle of the request
+     ***********/
+    template<class T>
+    int receiveFromClientNonBlocking(const std::string &clientName, int size, T* message) {
+        InProcessChannel *channel = getInProcessChannel(clientName);
+        if (channel != NULL)
+            return addLocalRequest(
+                    new InProcessRequest(channel, false, message, size * sizeof(T)), false);
+        MPI_Comm client = getClientComm(clientName);
+        MPI_Request request;
+        MPI_Irecv(message, size, getMPIDatatype<T>(), MPI_ANY_SOURCE, DEFAULT_TAG, client,
+                &request);
+        return addRequest(request);
+    }
+    /***********************************************************************************************
+     * \brief Get the number of processes of a client, each of which may send its own partition of
+     *        a partitioned mesh and its data fields
+     * \param[in] clientName is a string which holds the name of the client
+     * \return the number of processes, 1 for a client running inside the Emperor process
+     ***********/
+    int getClientSize(const std::string &clientName);
+    /***********************************************************************************************
+     * \brief Template function for starting a non-blocking send of a partition to one process of
+     *        a client. The message is matched only by the partition receives of that process
+     * \param[in] clientName is a string which holds the name of the receiver client
+     * \param[in] rank is the rank of the receiver process in the client
+     * \param[in] size is the length of the message
+     * \param[in] message is a pointer to the message which is going to be sent
+     * \return the handle of the request
+     ***********/
+    template<class T>
+    int sendToClientRankNonBlocking(const std::string &clientName, int rank, int size,
+            T* message) {
+        InProcessChannel *channel = getInProcessChannel(clientName);
+        if (channel != NULL) {
+            assert(rank == 0);
+            return addLocalRequest(
+                    new InProcessRequest(channel, true, message, size * sizeof(T)), false);
+        }
+        MPI_Comm client = getClientComm(clientName);
+        MPI_Request request;
+        MPI_Isend(message, size, getMPIDatatype<T>(), rank, PARTITION_TAG, client, &request);
+        return addRequest(request);
+    }
+    /***********************************************************************************************
+     * \brief Template function for starting a non-blocking receive of a partition from one
+     *        process of a client. Partitions of the same process are matched in the order the
+     *        receives are started
+     * \param[in] clientName is a string which holds the name of the sender client
+     * \param[in] rank is the rank of the sender process in the client
+     * \param[in] size is the length of the message
+     * \param[out] message is a pointer to the message which is going to be received
+     * \return the handle of the request
+     ***********/
+    template<class T>
+    int receiveFromClientRankNonBlocking(const std::string &clientName, int rank, int size,
+            T* message) {
+        InProcessChannel *channel = getInProcessChannel(clientName);
+        if (channel != NULL) {
+            assert(rank == 0);
+            return addLocalRequest(
+                    new InProcessRequest(channel, false, message, size * sizeof(T)), false);
+        }
+        MPI_Comm client = getClientComm(clientName);
+        MPI_Request request;
+        MPI_Irecv(message, size, getMPIDatatype<T>(), rank, PARTITION_TAG, client, &request);
+        return addRequest(request);
+    }
+    /***********************************************************************************************
+     * \brief Template function for creating a persistent send of data to client, which is bound
+     *        to the message and started by startRequest as often as needed
+     * \param[in] clientName is a string which holds the name of the receiver client
+     * \param[in] size is the length of the message
+     * \param[in] message is a pointer to the message which is going to be sent
+     * \return the handle of the request
+     ***********/
+    template<class T>
+    int initSendToClient(const std::string &clientName, int size, T* message) {
+        InProcessChannel *channel = getInProcessChannel(clientName);
+        if (channel != NULL)
+            return addLocalRequest(
+                    new InProcessRequest(channel, true, message, size * sizeof(T)), true);
+        MPI_Comm client = getClientComm(clientName);
+        MPI_Request request;
+        MPI_Send_init(message, size, getMPIDatatype<T>(), 0, 0, client, &request);
+        return addRequest(request, true);
+    }
+    /***********************************************************************************************
+     * \brief Template function for creating a persistent receive of data from client
+     * \param[in] clientName is a string which holds the name of the sender client
+     * \param[in] size is the length of the message
+     * \param[out] message is a pointer to the message which is going to be received
+     * \return the handle of the request
+     ***********/
+    template<class T>
+    int initReceiveFromClient(const std::string &clientName, int size, T* message) {
+        InProcessChannel *channel = getInProcessChannel(clientName);
+        if (channel != NULL)
+            return addLocalRequest(
+                    new InProcessRequest(channel, false, message, size * sizeof(T)), true);
+        MPI_Comm client = getClientComm(clientName);
+        MPI_Request request;
+        MPI_Recv_init(message, size, getMPIDatatype<T>(), MPI_ANY_SOURCE, DEFAULT_TAG, client,
+                &request);
+        return addRequest(request, true);
+    }
+    /***********************************************************************************************
+     * \brief Create a persistent send of a data field to a client on the same node, through a
+     *        segment the client has mapped
+     * \param[in] segment the segment
+     * \param[in] message the data field, of the size of the segment
+     * \return the handle of the request
+     ***********/
+    int initSendToClientBySharedMemory(SharedMemorySegment *segment, double *message);
+    /***********************************************************************************************
+     * \brief Create a persistent receive of a data field from a client on the same node
+     * \param[in] segment the segment
+     * \param[out] message the data field, of the size of the segment
+     * \return the handle of the request
+     ***********/
+    int initReceiveFromClientBySharedMemory(SharedMemorySegment *segment, double *message);
+    /***********************************************************************************************
+     * \brief Start a persistent request
+     * \param[in] requestHandle the handle returned by initSendToClient or initReceiveFromClient
+     ***********/
+    void startRequest(int requestHandle);
+    /***********************************************************************************************
+     * \brief Free a persistent request and release its handle
+     * \param[in] requestHandle the handle returned by initSendToClient or initReceiveFromClient
+     ***********/
+    void freeRequest(int requestHandle);
+    /***********************************************************************************************
+     * \brief Wait until the request is completed and release its handle. The handle of a persistent
+     *        request is kept, such that the request can be started again
+     * \param[in] requestHandle the handle returned by the non-blocking send or receive
+     ***********/
+    void waitForRequest(int requestHandle);
+    /***********************************************************************************************
+     * \brief Wait until one of the requests is completed. The handle is not released, such that
+     *        waitForRequest has to be called on it afterwards, which then returns immediately
+     * \param[in] requestHandles the handles of the requests to wait for
+     * \return the position of the completed request in requestHandles
+     ***********/
+    int waitForAnyRequest(const std::vector<int> &requestHandles);
+    /***********************************************************************************************
+     * \brief Start the progress thread, which from now on completes the pending non-blocking MPI
+     *        requests in the background, such that a transfer of a slow client progresses while
+     *        the coupling thread is mapping. waitForRequest and waitForAnyRequest then wait for the
+     *        signal of the progress thread instead of calling MPI themselves. Must be called
+     *        while no request is pending
+     ***********/
+    void startProgressThread();
+    /***********************************************************************************************
+     * \brief Stop the progress thread, the pending requests are waited for by MPI again. Must not
+     *        be called while a request is waited for
+     ***********/
+    void stopProgressThread();
     /***********************************************************************************************
      * \brief Get names of all clients
      * \param[out] names is the container of names of all client codes.
      * \author Tianyang Wang
      ***********/
     void getClientNames(std::set<std::string> *names);
+    /***********************************************************************************************
+     * \brief Load the shared libraries of all clients which run inside the Emperor process and
+     *        start each of them in its own thread. Such a client is connected at once, its
+     *        messages are copied between the buffers of both sides instead of being sent by MPI
+     ***********/
+    void startInProcessClients();
+    /***********************************************************************************************
+     * \brief Whether the transfers are timed, for the profiler or the live metrics
+     ***********/
+    static bool isTransferProfiled() {
+        return Profiler::isEnabled() || LiveMetrics::isEnabled();
+    }
+    /***********************************************************************************************
+     * \brief Add a transfer which ends now to the counters of the profiler (per client, and per
+     *        item if given), to the live metrics of the client and to the track of the client in
+     *        the trace
+     * \param[in] clientName the name of the client
+     * \param[in] item the transferred item, e.g. "(mesh: dataField)", empty for plain messages
+     * \param[in] isSend true for a send, false for a receive
+     * \param[in] startTime the start of the wait
+     * \param[in] arrivalTime the arrival of the message, negative if the whole time is counted as
+     *            blocked since waiting and transfer cannot be distinguished
+     * \param[in] bytes the number of bytes transferred
+     ***********/
+    void profileTransfer(const std::string &clientName, const std::string &item, bool isSend,
+            double startTime, double arrivalTime, long bytes);
     /// length of the name string
     static const int NAME_STRING_LENGTH = 80;
+    /// tag of the messages exchanged with the first process of a client
+    static const int DEFAULT_TAG = 0;
+    /// tag of the partitions of a partitioned mesh and its data fields, which every process of a
+    /// client exchanges with the Emperor directly
+    static const int PARTITION_TAG = 1;
+    /// sleep of the progress thread in microseconds after a test completed none of the requests
+    static const int PROGRESS_POLLING_INTERVAL = 50;
 private:
     /// The singleton of this class
     static ServerCommunication* serverComm;
@@ -156,10 +439,169 @@ private:
     std::string portName;
     /// Flag which stores the result if a communicator is a intercommunicator
     int isInterComm;
-    /// Total number of clients
+    /// Total number of clients, of all replicas of an ensemble
     unsigned int totalNumClients;
+    /// the number of replicas of an ensemble, 1 without ensemble
+    int ensembleSize;
     /// Listening termination signal
     bool terminateListening;
+    /// protects the request pool, the replicas of an ensemble communicate on their own threads
+    pthread_mutex_t requestPoolMutex;
+    /// protects clientNameCommMap, which the listening thread fills while the clients connected
+    /// before are already served
+    pthread_mutex_t connectionMutex;
+    /// signalled by the listening thread whenever a client has connected
+    pthread_cond_t connectionCondition;
+    /// The requests of the non-blocking calls, the handle of a request is its position
+    std::vector<MPI_Request> requestPool;
+    /// Flags of the requests in requestPool which are persistent
+    std::vector<bool> isPersistentRequest;
+    /// Handles of completed requests which can be reused
+    std::vector<int> freeRequestHandles;
+    /// The requests of requestPool which are completed without MPI, NULL for MPI requests
+    std::vector<AbstractLocalRequest*> localRequestPool;
+    /// whether the progress thread is running, protected by requestPoolMutex
+    bool isProgressThreadRunning;
+    /// termination signal of the progress thread, protected by requestPoolMutex
+    bool terminateProgress;
+    /// the thread completing the requests of activeRequests
+    pthread_t progressThread;
+    /// Handles of the started MPI requests the progress thread has not completed yet, only filled
+    /// while it is running
+    std::set<int> activeRequests;
+    /// signalled whenever a request is added to activeRequests
+    pthread_cond_t requestActivatedCondition;
+    /// signalled by the progress thread whenever it has completed requests
+    pthread_cond_t requestCompletedCondition;
+    /********//**
+     * \brief A client running as a thread inside the Emperor process
+     ***********/
+    struct InProcessClient {
+        /// the channel replacing the inter-communicator
+        InProcessChannel *channel;
+        /// the handle of the loaded shared library
+        void *library;
+        /// the thread running the entry function of the library
+        pthread_t thread;
+        /// the entry function of the library
+        int (*entry)(int, char**);
+        /// the path of the library, passed as the only command line argument of the entry
+        std::string libraryPath;
+    };
+    /// This holds a map of ClientName <=> in-process clients
+    std::map<std::string, InProcessClient> inProcessClients;
+    /***********************************************************************************************
+     * \brief Return the inter-communicator of a client connected by MPI
+     * \param[in] clientName the name of the client
+     * \return the inter-communicator
+     ***********/
+    MPI_Comm getClientComm(const std::string &clientName) {
+        pthread_mutex_lock(&connectionMutex);
+        MPI_Comm client = clientNameCommMap->at(clientName);
+        pthread_mutex_unlock(&connectionMutex);
+        return client;
+    }
+    /***********************************************************************************************
+     * \brief Return the channel of a client running inside the Emperor process
+     * \param[in] clientName the name of the client
+     * \return the channel, NULL if the client is connected by MPI
+     ***********/
+    InProcessChannel *getInProcessChannel(const std::string &clientName) {
+        if (inProcessClients.empty())
+            return NULL;
+        std::map<std::string, InProcessClient>::iterator it = inProcessClients.find(clientName);
+        if (it == inProcessClients.end())
+            return NULL;
+        return it->second.channel;
+    }
+    /***********************************************************************************************
+     * \brief Store a request which is completed without MPI, a non-persistent request is started
+     *        at once
+     * \param[in] request the request, which is deleted when its handle is released
+     * \param[in] persistent whether the request is persistent
+     * \return the handle of the request
+     ***********/
+    int addLocalRequest(AbstractLocalRequest *request, bool persistent);
+    /***********************************************************************************************
+     * \brief Disconnect the in-process and the MPI clients and free the persistent requests
+     ***********/
+    void disconnectClients();
+    /***********************************************************************************************
+     * \brief Write the port name to the port file of the MetaDatabase
+     ***********/
+    void writePortFile();
+    /***********************************************************************************************
+     * \brief Take over the number of clients and replicas of the MetaDatabase
+     ***********/
+    void countClients();
+    /***********************************************************************************************
+     * \brief Get the name a connecting client is registered under
+     * \param[in] clientName the name the client sent
+     * \return the name, empty if the client is not defined in the input file. If all replicas of
+     *         the client are connected, the name of the first one, whose connection is replaced
+     ***********/
+    std::string findConnectionName(const std::string &clientName);
+    /***********************************************************************************************
+     * \brief Entry of the thread of an in-process client
+     * \param[in] inProcessClient the client
+     * \return NULL
+     ***********/
+    static void *runInProcessClient(void *inProcessClient);
+    /***********************************************************************************************
+     * \brief Store a request of a non-blocking call
+     * \param[in] request the request
+     * \param[in] persistent whether the request is persistent
+     * \return the handle of the request
+     ***********/
+    int addRequest(MPI_Request request, bool persistent = false);
+    /***********************************************************************************************
+     * \brief Hand a started MPI request over to the progress thread, if it is running. Called
+     *        with requestPoolMutex locked
+     * \param[in] requestHandle the handle of the request
+     ***********/
+    void activateRequest(int requestHandle);
+    /***********************************************************************************************
+     * \brief Entry of the progress thread
+     * \param[in] serverCommunication the singleton
+     * \return NULL
+     ***********/
+    static void *runProgressThread(void *serverCommunication);
+    /***********************************************************************************************
+     * \brief Test the requests of activeRequests until the progress thread is stopped, sleeping
+     *        while none of them completes and waiting while there are none
+     ***********/
+    void progressRequests();
+    /***********************************************************************************************
+     * \brief Wait until one of the requests is completed, by polling, since some of them are
+     *        local requests
+     * \param[in] requestHandles the handles of the requests to wait for
+     * \return the position of the completed request in requestHandles
+     ***********/
+    int pollForAnyRequest(const std::vector<int> &requestHandles);
+    /***********************************************************************************************
+     * \brief Return the MPI datatype of T
+     * \return the MPI datatype
+     ***********/
+    template<class T>
+    static MPI_Datatype getMPIDatatype() {
+        if (typeid(T) == typeid(int)) {
+            return MPI_INT;
+        } else if (typeid(T) == typeid(double)) {
+            return MPI_DOUBLE;
+        } else if (typeid(T) == typeid(float)) {
+            return MPI_FLOAT;
+        } else if (typeid(T) == typeid(unsigned char)) {
+            return MPI_UNSIGNED_CHAR;
+        } else if (typeid(T) == typeid(long double)) {
+            return MPI_LONG_DOUBLE;
+        } else if (typeid(T) == typeid(short)) {
+            return MPI_SHORT;
+        } else if (typeid(T) == typeid(char)) {
+            return MPI_CHAR;
+        }
+        assert(false);
+        return MPI_DATATYPE_NULL;
+    }
     /***********************************************************************************************
      * \brief Disallow public constructor
      *        This does also the communication initialization
@@ -0,0 +1,81 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include "ServerRanks.h"
+#include "DistributedCSRMatrix.h"
+#include "Message.h"
+
+namespace EMPIRE {
+
+int ServerRanks::rank = 0;
+int ServerRanks::numRanks = 1;
+MPI_Comm ServerRanks::comm = MPI_COMM_NULL;
+bool ServerRanks::isLockInitialized = false;
+omp_lock_t ServerRanks::commandLock;
+
+void ServerRanks::init() {
+    MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &numRanks);
+    omp_init_lock(&commandLock);
+    isLockInitialized = true;
+    if (rank == 0 && numRanks > 1) {
+        INFO_OUT() << "Emperor runs on " << numRanks
+                << " ranks, the coupling matrices are distributed" << std::endl;
+    }
+}
+
+void ServerRanks::serveCommands() {
+    assert(rank > 0);
+    int command[COMMAND_SIZE];
+    while (true) {
+        MPI_Bcast(command, COMMAND_SIZE, MPI_INT, 0, comm);
+        if (command[0] == TERMINATE)
+            break;
+        DistributedCSRMatrix::executeCommand(command);
+    }
+}
+
+void ServerRanks::broadcastCommand(int command[COMMAND_SIZE]) {
+    assert(rank == 0 && numRanks > 1);
+    MPI_Bcast(command, COMMAND_SIZE, MPI_INT, 0, comm);
+}
+
+void ServerRanks::terminateWorkers() {
+    if (rank != 0 || numRanks == 1)
+        return;
+    int command[COMMAND_SIZE] = { TERMINATE, 0, 0, 0 };
+    lock();
+    broadcastCommand(command);
+    unlock();
+}
+
+void ServerRanks::lock() {
+    if (isLockInitialized)
+        omp_set_lock(&commandLock);
+}
+
+void ServerRanks::unlock() {
+    if (isLockInitialized)
+        omp_unset_lock(&commandLock);
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,120 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file ServerRanks.h
+ * This file holds the class ServerRanks
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef SERVERRANKS_H_
+#define SERVERRANKS_H_
+
+#include <mpi.h>
+#include <omp.h>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class ServerRanks holds the processes of an Emperor started on several MPI ranks. Rank 0
+ *        connects the clients and runs the coupling, the other ranks are workers which execute the
+ *        commands broadcast by rank 0 until they are terminated, e.g. the products of the
+ *        distributed coupling matrices (see DistributedCSRMatrix). Without MPI or with one rank,
+ *        rank 0 is the only process and no command is ever broadcast.
+ ***********/
+class ServerRanks {
+public:
+    /// the commands of rank 0 to the workers
+    enum Command {
+        /// receive a row block of a distributed matrix
+        CREATE_MATRIX,
+        /// multiply with the row block of a distributed matrix
+        MULTIPLY_MATRIX,
+        /// delete the row block of a distributed matrix
+        DELETE_MATRIX,
+        /// send the entries of the row block of a distributed matrix to rank 0
+        GATHER_MATRIX,
+        /// leave the command loop
+        TERMINATE
+    };
+    /// the length of a command, its type followed by its arguments
+    static const int COMMAND_SIZE = 4;
+    /***********************************************************************************************
+     * \brief Set up the communicator of the ranks, after MPI is initialized
+     ***********/
+    static void init();
+    /***********************************************************************************************
+     * \brief Get the rank of this process
+     ***********/
+    static int getRank() {
+        return rank;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of processes of the Emperor
+     ***********/
+    static int getNumRanks() {
+        return numRanks;
+    }
+    /***********************************************************************************************
+     * \brief Get the communicator of the processes of the Emperor, which is used for the commands
+     *        and their data only
+     ***********/
+    static MPI_Comm getComm() {
+        return comm;
+    }
+    /***********************************************************************************************
+     * \brief Execute the commands of rank 0 until it terminates the workers, called by the other
+     *        ranks instead of the coupling
+     ***********/
+    static void serveCommands();
+    /***********************************************************************************************
+     * \brief Broadcast a command from rank 0 to the workers. The broadcast and the communication
+     *        of the command must be done under lock(), since several threads of rank 0 may run
+     *        mappers at the same time
+     * \param[in] command the command and its arguments
+     ***********/
+    static void broadcastCommand(int command[COMMAND_SIZE]);
+    /***********************************************************************************************
+     * \brief Terminate the workers, called by rank 0 after all distributed matrices are deleted
+     ***********/
+    static void terminateWorkers();
+    /***********************************************************************************************
+     * \brief Serialize the commands of the threads of rank 0
+     ***********/
+    static void lock();
+    /***********************************************************************************************
+     * \brief Release the lock of a command
+     ***********/
+    static void unlock();
+
+private:
+    /// the rank of this process
+    static int rank;
+    /// the number of processes
+    static int numRanks;
+    /// the duplicate of MPI_COMM_WORLD for the commands
+    static MPI_Comm comm;
+    /// whether the lock is initialized
+    static bool isLockInitialized;
+    /// the lock of the commands
+    static omp_lock_t commandLock;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* SERVERRANKS_H_ */
@@ -0,0 +1,132 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sstream>
+#include "SharedMemorySegment.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+int SharedMemorySegment::numCreated = 0;
+
+SharedMemorySegment *SharedMemorySegment::create(int size) {
+    // the replicas of an ensemble create their segments concurrently
+    int number;
+#pragma omp atomic capture
+    number = numCreated++;
+    stringstream nameStream;
+    nameStream << "/EMPIRE_" << getpid() << "_" << number;
+    string name = nameStream.str();
+    size_t numBytes = sizeof(Header) + size * sizeof(double);
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        WARNING_OUT() << "Unable to create shared memory segment " << name << endl;
+        return NULL;
+    }
+    void *address = MAP_FAILED;
+    if (ftruncate(fd, numBytes) == 0)
+        address = mmap(NULL, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        WARNING_OUT() << "Unable to map shared memory segment " << name << endl;
+        shm_unlink(name.c_str());
+        return NULL;
+    }
+
+    SharedMemorySegment *segment = new SharedMemorySegment(name, address, numBytes);
+    // differs from any stale segment of the same name on another node or from an earlier run
+    segment->header->token = (int) ((unsigned) (time(NULL) ^ getpid()) * 2654435761u
+            + number);
+    segment->header->size = size;
+    segment->header->numWritten = 0;
+    segment->header->numRead = 0;
+    return segment;
+}
+
+SharedMemorySegment::SharedMemorySegment(const string &_name, void *address, size_t _numBytes) :
+        name(_name), isUnlinked(false), header(static_cast<Header*>(address)), data(
+                reinterpret_cast<double*>(static_cast<Header*>(address) + 1)), numBytes(_numBytes) {
+}
+
+SharedMemorySegment::~SharedMemorySegment() {
+    unlink();
+    munmap(header, numBytes);
+}
+
+void SharedMemorySegment::unlink() {
+    if (!isUnlinked)
+        shm_unlink(name.c_str());
+    isUnlinked = true;
+}
+
+void SharedMemorySegment::write(const double *message) {
+    while (header->numRead != header->numWritten)
+        sched_yield();
+    __sync_synchronize();
+    memcpy(data, message, header->size * sizeof(double));
+    // the data must be visible before the counter
+    __sync_synchronize();
+    header->numWritten++;
+}
+
+bool SharedMemorySegment::tryRead(double *message) {
+    if (header->numRead == header->numWritten)
+        return false;
+    __sync_synchronize();
+    memcpy(message, data, header->size * sizeof(double));
+    // the copy must be finished before the writer may overwrite the data
+    __sync_synchronize();
+    header->numRead++;
+    return true;
+}
+
+SharedMemoryRequest::SharedMemoryRequest(SharedMemorySegment *_segment, bool _isSend,
+        double *_buffer) :
+        segment(_segment), isSend(_isSend), buffer(_buffer), isCompleted(true) {
+}
+
+SharedMemoryRequest::~SharedMemoryRequest() {
+}
+
+void SharedMemoryRequest::start() {
+    assert(isCompleted);
+    if (isSend) {
+        segment->write(buffer);
+    } else {
+        isCompleted = false;
+    }
+}
+
+bool SharedMemoryRequest::test() {
+    if (!isCompleted)
+        isCompleted = segment->tryRead(buffer);
+    return isCompleted;
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,160 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file SharedMemorySegment.h
+ * This file holds the class SharedMemorySegment
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef SHAREDMEMORYSEGMENT_H_
+#define SHAREDMEMORYSEGMENT_H_
+
+#include <string>
+#include "AbstractLocalRequest.h"
+
+namespace EMPIRE {
+/********//**
+ * \brief Class SharedMemorySegment is a POSIX shared memory segment through which a data field is
+ *        transferred in one direction between the Emperor and a client on the same node. The
+ *        writer copies the data field in and increments a counter, the reader waits for the counter
+ *        to change, copies the data field out and increments its own counter.
+ ***********/
+class SharedMemorySegment {
+public:
+    /********//**
+     * \brief The header at the beginning of the segment, the client maps the same layout
+     ***********/
+    struct Header {
+        /// random number written by the Emperor, the client checks it to detect co-location
+        int token;
+        /// number of doubles of the data field
+        int size;
+        /// number of data fields written
+        volatile int numWritten;
+        /// number of data fields read
+        volatile int numRead;
+    };
+    /***********************************************************************************************
+     * \brief Create and map a new segment
+     * \param[in] size number of doubles of the data field
+     * \return the segment, NULL if the segment cannot be created
+     ***********/
+    static SharedMemorySegment *create(int size);
+    /***********************************************************************************************
+     * \brief Destructor, unmaps the segment
+     ***********/
+    virtual ~SharedMemorySegment();
+    /***********************************************************************************************
+     * \brief Get the name under which the client opens the segment
+     * \return the name
+     ***********/
+    const std::string &getName() const {
+        return name;
+    }
+    /***********************************************************************************************
+     * \brief Get the token written into the header
+     * \return the token
+     ***********/
+    int getToken() const {
+        return header->token;
+    }
+    /***********************************************************************************************
+     * \brief Remove the name of the segment, after the client has mapped it. The memory is then
+     *        released as soon as both sides have unmapped it, even if a side crashes
+     ***********/
+    void unlink();
+    /***********************************************************************************************
+     * \brief Write a data field, waiting until the previous one has been read
+     * \param[in] message the data field
+     ***********/
+    void write(const double *message);
+    /***********************************************************************************************
+     * \brief Read a data field if a new one has been written
+     * \param[out] message the data field
+     * \return true if a data field has been read
+     ***********/
+    bool tryRead(double *message);
+
+private:
+    /// the name of the segment
+    std::string name;
+    /// whether the name has been removed
+    bool isUnlinked;
+    /// the mapped header
+    Header *header;
+    /// the mapped data field, following the header
+    double *data;
+    /// the size of the mapping in bytes
+    size_t numBytes;
+    /// the number of segments created by this process, to make their names unique
+    static int numCreated;
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _name the name of the segment
+     * \param[in] address the mapped address
+     * \param[in] _numBytes the size of the mapping in bytes
+     ***********/
+    SharedMemorySegment(const std::string &_name, void *address, size_t _numBytes);
+    /// disallow copy constructor
+    SharedMemorySegment(const SharedMemorySegment&);
+    /// disallow assignment operator
+    SharedMemorySegment& operator=(const SharedMemorySegment&);
+};
+
+/********//**
+ * \brief Class SharedMemoryRequest is a persistent send or receive of a data field through a
+ *        SharedMemorySegment
+ ***********/
+class SharedMemoryRequest: public AbstractLocalRequest {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _segment the segment
+     * \param[in] _isSend whether the request sends to the client or receives from it
+     * \param[in] _buffer the data field
+     ***********/
+    SharedMemoryRequest(SharedMemorySegment *_segment, bool _isSend, double *_buffer);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~SharedMemoryRequest();
+    /***********************************************************************************************
+     * \brief Start the request, a send is written at once
+     ***********/
+    void start();
+    /***********************************************************************************************
+     * \brief Progress the request, a receive is read as soon as the client has written it
+     * \return true if the request is completed
+     ***********/
+    bool test();
+
+private:
+    /// the segment
+    SharedMemorySegment *segment;
+    /// whether the request sends to the client or receives from it
+    bool isSend;
+    /// the data field
+    double *buffer;
+    /// whether the request is completed
+    bool isCompleted;
+};
+
+} /* namespace EMPIRE */
+#endif /* SHAREDMEMORYSEGMENT_H_ */
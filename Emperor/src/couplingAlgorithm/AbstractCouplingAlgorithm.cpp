@@ -28,7 +28,9 @@
 #include "ConnectionIO.h"
 #include "Residual.h"
 #include "EMPEROR_Enum.h"
+#include "MathLibrary.h"
 #include <iostream>
+#include <vector>
 
 using namespace std;
 
@@ -36,44 +38,45 @@ namespace EMPIRE {
 
 AbstractCouplingAlgorithm::CouplingAlgorithmOutput::CouplingAlgorithmOutput(
         ConnectionIO *_reference) :
-        reference(_reference) {
+        reference(_reference), outputCopyAtIterationBeginning(NULL) {
     if (reference->type == EMPIRE_ConnectionIO_DataField) {
         size = reference->dataField->dimension * reference->dataField->numLocations;
-        outputCopyAtIterationBeginning = new double[size];
     } else if (reference->type == EMPIRE_ConnectionIO_Signal) {
         size = reference->signal->size;
-        outputCopyAtIterationBeginning = new double[size];
     } else {
         assert(false);
     }
+    reference->getHistory(DataHistory::ITERATION)->reserve(1);
 }
 
 AbstractCouplingAlgorithm::CouplingAlgorithmOutput::~CouplingAlgorithmOutput() {
     delete reference;
-    delete[] outputCopyAtIterationBeginning;
 }
 
-void AbstractCouplingAlgorithm::CouplingAlgorithmOutput::updateAtIterationBeginning() {
-    if (reference->type == EMPIRE_ConnectionIO_DataField) {
-        for (int i = 0; i < size; i++)
-            outputCopyAtIterationBeginning[i] = reference->dataField->data[i];
-    } else if (reference->type == EMPIRE_ConnectionIO_Signal) {
-        for (int i = 0; i < size; i++)
-            outputCopyAtIterationBeginning[i] = reference->signal->array[i];
-    } else {
-        assert(false);
-    }
+void AbstractCouplingAlgorithm::CouplingAlgorithmOutput::updateAtIterationBeginning(long long tag) {
+    outputCopyAtIterationBeginning = reference->getHistory(DataHistory::ITERATION)->snapshot(
+            getArray(), tag);
 }
 
-void AbstractCouplingAlgorithm::CouplingAlgorithmOutput::overwrite(double *newData) {
+void AbstractCouplingAlgorithm::CouplingAlgorithmOutput::restore(const double *data) {
+    outputCopyAtIterationBeginning = reference->getHistory(DataHistory::ITERATION)->snapshot(data,
+            DataHistory::newTag());
+}
+
+void AbstractCouplingAlgorithm::CouplingAlgorithmOutput::overwrite(const double *newData) {
+    double *array = getArray();
+    for (int i = 0; i < size; i++)
+        array[i] = newData[i];
+}
+
+double *AbstractCouplingAlgorithm::CouplingAlgorithmOutput::getArray() {
     if (reference->type == EMPIRE_ConnectionIO_DataField) {
-        for (int i = 0; i < size; i++)
-            reference->dataField->data[i] = newData[i];
+        return reference->dataField->data;
     } else if (reference->type == EMPIRE_ConnectionIO_Signal) {
-        for (int i = 0; i < size; i++)
-            reference->signal->array[i] = newData[i];
+        return reference->signal->array;
     } else {
         assert(false);
+        return NULL;
     }
 }
 
@@ -99,20 +102,24 @@ void AbstractCouplingAlgorithm::addOutput(ConnectionIO *output, int index) {
 }
 
 void AbstractCouplingAlgorithm::updateAtIterationBeginning() {
+    // one tag for all copies, such that the residual components and the outputs which copy the
+    // same data field share a single snapshot
+    long long tag = DataHistory::newTag();
     // update residuals
     for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++)
-        it->second->updateAtIterationBeginning();
+        it->second->updateAtIterationBeginning(tag);
     // update output copies
     for (map<int, CouplingAlgorithmOutput*>::iterator it = outputs.begin(); it != outputs.end();
             it++) {
-        it->second->updateAtIterationBeginning();
+        it->second->updateAtIterationBeginning(tag);
     }
 }
 
 void AbstractCouplingAlgorithm::updateAtIterationEnd() {
     // update residuals
+    long long tag = DataHistory::newTag();
     for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++)
-        it->second->updateAtIterationEnd();
+        it->second->updateAtIterationEnd(tag);
 }
 
 void AbstractCouplingAlgorithm::setNewTimeStep() {
@@ -123,15 +130,47 @@ double AbstractCouplingAlgorithm::getResidualL2Norm(int index) {
     return residuals[index]->residualVectorL2Norm;
 }
 
+void AbstractCouplingAlgorithm::writeCheckpoint(CheckpointArchive &archive) const {
+    archive.write(newTimeStep);
+    archive.write(currentTimeStep);
+    archive.write(currentIteration);
+    for (map<int, CouplingAlgorithmOutput*>::const_iterator it = outputs.begin();
+            it != outputs.end(); it++) {
+        archive.write(it->second->getArray(), it->second->size);
+        archive.write(it->second->outputCopyAtIterationBeginning != NULL);
+        if (it->second->outputCopyAtIterationBeginning != NULL)
+            archive.write(it->second->outputCopyAtIterationBeginning, it->second->size);
+    }
+    for (map<int, Residual*>::const_iterator it = residuals.begin(); it != residuals.end(); it++)
+        it->second->writeCheckpoint(archive);
+}
+
+void AbstractCouplingAlgorithm::readCheckpoint(CheckpointArchive &archive) {
+    vector<double> outputCopy;
+    archive.read(newTimeStep);
+    archive.read(currentTimeStep);
+    archive.read(currentIteration);
+    for (map<int, CouplingAlgorithmOutput*>::iterator it = outputs.begin(); it != outputs.end();
+            it++) {
+        archive.read(it->second->getArray(), it->second->size);
+        bool hasCopy;
+        archive.read(hasCopy);
+        if (hasCopy) {
+            outputCopy.resize(it->second->size);
+            archive.read(&outputCopy[0], outputCopy.size());
+            it->second->restore(&outputCopy[0]);
+        }
+    }
+    for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++)
+        it->second->readCheckpoint(archive);
+}
+
 std::string AbstractCouplingAlgorithm::getName() {
     return name;
 }
 
 double AbstractCouplingAlgorithm::vecL2Norm(const double *vec, int size) {
-    double sum = 0.0;
-    for (int i = 0; i < size; i++) {
-        sum += vec[i] * vec[i];
-    }
+    double sum = MathLibrary::computeReproducibleSquaredNorm(vec, size);
     sum /= size;
     sum = sqrt(sum);
     return sum;
@@ -29,6 +29,7 @@
 
 #include <string>
 #include <map>
+#include "CheckpointArchive.h"
 
 namespace EMPIRE {
 
@@ -38,7 +39,7 @@ class Residual;
  * \brief Class AbstractCouplingAlgorithm is the mother class of all coupling algorithms. A
  *              coupling algorithm must be attached to an iterative coupling loop
  ***********/
-class AbstractCouplingAlgorithm {
+class AbstractCouplingAlgorithm : public AbstractCheckpointable {
 public:
     /***********************************************************************************************
      * \brief Constructor, set input and output (the input and output could be the same memory)
@@ -117,6 +118,17 @@ public:
      * \author Tianyang Wang
      ***********/
     void setCurrentIteration(int _currentIteration){currentIteration=_currentIteration;}
+    /***********************************************************************************************
+     * \brief Write the counters, the outputs with their copies and the residuals, a coupling
+     *        algorithm with a history extends it
+     * \param[in] archive the archive
+     ***********/
+    virtual void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    virtual void readCheckpoint(CheckpointArchive &archive);
 
 
 
@@ -140,21 +152,35 @@ protected:
         virtual ~CouplingAlgorithmOutput();
         /***********************************************************************************************
          * \brief Update at the iteration beginning
+         * \param[in] tag the tag of the snapshot, shared with the residual components which copy
+         *            the same output at the iteration beginning
          * \author Tianyang Wang
          ***********/
-        void updateAtIterationBeginning();
+        void updateAtIterationBeginning(long long tag);
+        /***********************************************************************************************
+         * \brief Restore the copy at the iteration beginning from the given data
+         * \param[in] data the data, size values
+         ***********/
+        void restore(const double *data);
         /***********************************************************************************************
          * \brief overwrite the output (the reference)
          * \param[in] newData the new data for the output
          * \author Tianyang Wang
          ***********/
-        void overwrite(double *newData);
+        void overwrite(const double *newData);
+        /***********************************************************************************************
+         * \brief Get the array of the output (the reference), so that the new output can be
+         *        computed in place instead of in a temporary which is then copied by overwrite
+         * \return the array of the data field or signal
+         ***********/
+        double *getArray();
         /// reference to the output instance
         ConnectionIO* reference;
         /// size of the array
         int size;
-        /// the array
-        double *outputCopyAtIterationBeginning;
+        /// the copy at the iteration beginning, a snapshot in the iteration history of the
+        /// reference, NULL before the first iteration
+        const double *outputCopyAtIterationBeginning;
     };
 
     /// name of the coupling algorithm
@@ -41,7 +41,6 @@ Aitken::Aitken(std::string _name, double _initRelaxationFactor) :
     debugMe = false;
     globalResidual = NULL;
     globalResidualOld = NULL;
-    tmpVec = NULL;
     
     string filename = "outputEmperor_" + _name + ".dat";
     file.open (filename.c_str());
@@ -50,7 +49,6 @@ Aitken::Aitken(std::string _name, double _initRelaxationFactor) :
 Aitken::~Aitken() {
     delete[] globalResidual;
     delete[] globalResidualOld;
-    delete[] tmpVec;
     
     file.close();
 }
@@ -95,14 +93,11 @@ void Aitken::calcNewValue() {
         CouplingAlgorithmOutput *output = outputs.find(it->first)->second;
 
         assert(residual->size == output->size);
-        double *newOuput = new double[residual->size];
-        // U_i_n+1 = U_i_n + alpha R_i_n
+        // U_i_n+1 = U_i_n + alpha R_i_n, computed in place
+        double *newOutput = output->getArray();
         for (int i=0; i<residual->size; i++) {
-            newOuput[i] = output->outputCopyAtIterationBeginning[i]+ relaxationFactor*residual->residualVector[i] ;
+            newOutput[i] = output->outputCopyAtIterationBeginning[i]+ relaxationFactor*residual->residualVector[i] ;
         }
-
-        output->overwrite(newOuput);
-        delete[] newOuput;
     }
 
     /// save old values
@@ -116,15 +111,11 @@ void Aitken::calcNewValue() {
 }
 
 void Aitken::computeRelaxationFactor() {
-	MathLibrary::copyDenseVector(tmpVec,globalResidual,globalResidualSize);
-	MathLibrary::computeDenseVectorMultiplicationScalar(tmpVec,-1.0,globalResidualSize);
-	MathLibrary::computeDenseVectorAddition(tmpVec,globalResidualOld,1.0,globalResidualSize);
-	/// tmpVec holds now globalResidualOld - globalResidual
-	double denominator = MathLibrary::vector2norm(tmpVec,globalResidualSize);
-	denominator*=denominator;
-	//double numerator = MathLibrary::computeDenseDotProduct(globalResidualOld, tmpVec, globalResidualSize);
-	// Edit Aditya
-	double numerator = MathLibrary::computeDenseDotProduct(globalResidualSize,globalResidualOld,tmpVec);
+	/// denominator = |globalResidualOld - globalResidual|^2,
+	/// numerator = globalResidualOld * (globalResidualOld - globalResidual), computed in one pass
+	double denominator, numerator;
+	MathLibrary::computeReproducibleDifferenceProducts(globalResidual, globalResidualOld,
+	        globalResidualSize, &denominator, &numerator);
     if (denominator>1e-30){
         relaxationFactor = relaxationFactorOld * (numerator/denominator);
     }else{
@@ -155,7 +146,6 @@ void Aitken::init() {
     }
     globalResidual    = new double [globalResidualSize];
     globalResidualOld = new double [globalResidualSize];
-    tmpVec            = new double [globalResidualSize];
     startNewTimeStep();
 }
 
@@ -166,6 +156,22 @@ void Aitken::calcCurrentResidual() {
     }
 }
 
+void Aitken::writeCheckpoint(CheckpointArchive &archive) const {
+    AbstractCouplingAlgorithm::writeCheckpoint(archive);
+    archive.write(relaxationFactor);
+    archive.write(relaxationFactorOld);
+    archive.write(globalResidual, globalResidualSize);
+    archive.write(globalResidualOld, globalResidualSize);
+}
+
+void Aitken::readCheckpoint(CheckpointArchive &archive) {
+    AbstractCouplingAlgorithm::readCheckpoint(archive);
+    archive.read(relaxationFactor);
+    archive.read(relaxationFactorOld);
+    archive.read(globalResidual, globalResidualSize);
+    archive.read(globalResidualOld, globalResidualSize);
+}
+
 
 
 
@@ -63,6 +63,16 @@ public:
      * \author Stefan Sicklinger
      ***********/
     void init();
+    /***********************************************************************************************
+     * \brief Write the relaxation factors and the global residuals in addition
+     * \param[in] archive the archive
+     ***********/
+    void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    void readCheckpoint(CheckpointArchive &archive);
 private:
     /***********************************************************************************************
      * \brief Reset in order to start new time step
@@ -88,8 +98,6 @@ private:
     double *globalResidual   ;
     /// old global residual vector
     double *globalResidualOld;
-    /// temp vector of size globalResidualSize
-    double *tmpVec;
     /// output file
     std::ofstream file;
     /// friend class in unit test
@@ -54,13 +54,11 @@ void ConstantRelaxation::calcNewValue() {
         CouplingAlgorithmOutput *output = outputs.find(it->first)->second;
 
         assert(residual->size == output->size);
-        double *newOuput = new double[residual->size];
-        // U_i_n+1 = U_i_n + alpha R_i_n
+        // U_i_n+1 = U_i_n + alpha R_i_n, computed in place
+        double *newOutput = output->getArray();
         for (int i=0; i<residual->size; i++) {
-            newOuput[i] = output->outputCopyAtIterationBeginning[i]+ RELAXATION_FACTOR*residual->residualVector[i] ;
+            newOutput[i] = output->outputCopyAtIterationBeginning[i]+ RELAXATION_FACTOR*residual->residualVector[i] ;
         }
-        output->overwrite(newOuput);
-        delete[] newOuput;
 
     }
 }
@@ -25,6 +25,8 @@
 #include "Signal.h"
 #include "Residual.h"
 #include "MathLibrary.h"
+#include "Message.h"
+#include "BufferPool.h"
 
 #include <assert.h>
 #include <math.h>
@@ -36,15 +38,19 @@ using namespace std;
 
 namespace EMPIRE {
 
-GMRES::GMRES(std::string _name, int maxOuterItter, int maxInnerItter, double tolerance) :
+GMRES::GMRES(std::string _name, int maxOuterItter, int maxInnerItter, double tolerance,
+		int recycleDimension) :
 						AbstractCouplingAlgorithm(_name) {
 
+	assert(maxInnerItter > 0);
+	assert(recycleDimension >= 0);
 	this->maxOuterItter = maxOuterItter;
 	this->maxInnerItter =  maxInnerItter;
 	this->tolerance = tolerance;
-	this->rhsDone = false;
+	this->recycleDimension = recycleDimension;
 	this->count = 0;
 	this->oneSize = 0;
+	this->numParticipants = 0;
 	this->sysSize = 0;
 	this->gmresUpdate = NULL;
 	this->rhs = NULL;
@@ -58,196 +64,196 @@ GMRES::~GMRES(){
 	delete []gmresUpdate;
 }
 
-// TODO :: Check all the indices and initialization of the vectors.
 void GMRES::calcNewValue(){
+	assert(sysSize > 0);
+	const unsigned long int m = this->maxInnerItter;
 
-	// Loop for obtaining the GMRES size of the system and computing the residual.
-
-	for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++) {
-		this->sysSize += it->second->size;
-		oneSize = it->second->size;
-		// Computing the residual for the current state.
-        it->second->computeCurrentResidual();
-	}
-	// Adding size for the lambdas
-	this->sysSize += oneSize;
+	// Computing the residual for the current state.
+	for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++)
+		it->second->computeCurrentResidual();
 
 	//// Necessary vectors and for GMRES.
 	//// Here we are not doing any pre-conditioning for the system
+	formulateRHS();
 
-	if(count <= 0){
-		// RHS vector
-		this->rhs = (double *) calloc(this->sysSize,  sizeof(double));
-		// Solution vector
-		this->solutionUpdate = (double *) calloc(this->sysSize,  sizeof(double));
-		// GMRES update
-		gmresUpdate = (double *) calloc(this->sysSize,  sizeof(double));
+	// Global residual vector, the solution update starts from zero, so the residual is the RHS
+	BufferPool::Buffer residual(this->sysSize);
+	for(unsigned long int i=0; i<this->sysSize; i++){
+		residual[i] = rhs[i];
+		solutionUpdate[i] = 0.0;
 	}
 
-	// Global residual vector
-	double *residual = (double *) calloc(this->sysSize,  sizeof(double));
-	// Vector for storing the intermediate orthogonal vectors
-	double *w = (double *) calloc(this->sysSize,  sizeof(double));
-	// Vector storing the orthogonal Vectors
-	double *V = (double *) calloc(this->sysSize * (this->maxInnerItter+1),  sizeof(double));
+	// Seed the solve by the recycled directions of the previous solves, that is the initial guess
+	// minimizes the residual over their span: x = U C^T r, r = r - C C^T r
+	updateRecycleSpace();
+	for(unsigned long int k=0; k<recycleC.size(); k++){
+		double dum = EMPIRE::MathLibrary::computeDenseDotProduct(this->sysSize, &recycleC[k][0], &residual[0]);
+		for(unsigned long int i=0; i<this->sysSize; i++){
+			solutionUpdate[i] += dum * recycleU[k][i];
+			residual[i] -= dum * recycleC[k][i];
+		}
+	}
 
-	// Reduced system system matrix
-	EMPIRE::MathLibrary::SparseMatrix<double> H((this->maxInnerItter), (this->maxInnerItter+1));
+	// Vector for storing the intermediate orthogonal vectors
+	BufferPool::Buffer w(this->sysSize);
+	// Vector storing the orthogonal Vectors, the large work vectors are recycled over the solves
+	BufferPool::Buffer V(this->sysSize * (m+1));
+	// Reduced system matrix, the Hessenberg matrix (m+1 x m, row major) reduced by the rotations
+	vector<double> H((m+1) * m);
 	// Vectors for storing the rotations
-	double *cs = (double *) calloc(this->maxInnerItter,  sizeof(double));
-	double *sn = (double *) calloc(this->maxInnerItter,  sizeof(double));
-	double *s  = (double *) calloc(this->maxInnerItter+1,  sizeof(double));
+	vector<double> cs(m), sn(m), s(m+1);
 	// Vector y
-	double *y = (double *) calloc(this->maxInnerItter,  sizeof(double));
-
-	double err = 10.0;
+	vector<double> y(m);
 
-	// Calculating the initial Residue
-	constructResidualVector(residual);
+	double err = EMPIRE::MathLibrary::vector2norm(&residual[0], this->sysSize);
 
 	//// Actual GMRES algorithm.
 	// GMRES outer Iterations
 	int oi;
-	for(oi=0; oi<this->maxOuterItter; oi++){ // oi -- Outer Iterations
+	for(oi=0; oi<this->maxOuterItter && err > this->tolerance; oi++){ // oi -- Outer Iterations
 
 		// Calculating the norm of initial residue
-		double beta = EMPIRE::MathLibrary::vector2norm(residual,this->sysSize);
-		s[1] = beta;
-
-		// Defining the initial Krylov vector
-		EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(residual,1/beta,this->sysSize);
-		// Storing the krylov vector in V
-		for(int i=0; i<this->sysSize; i++){
-			V[i] = residual[i];
+		double beta = err;
+		for(unsigned long int i=0; i<m+1; i++)
+			s[i] = 0.0;
+		s[0] = beta;
+		for(unsigned long int i=0; i<H.size(); i++)
+			H[i] = 0.0;
+
+		// Defining the initial Krylov vector and storing it in V
+		for(unsigned long int i=0; i<this->sysSize; i++){
+			V[i] = residual[i] / beta;
 		}
 
 		//// GMRES inner iterations
 		// Also includes Gram-Schmidt orthogonalization.
-		for(int ii=0; ii<this->maxInnerItter; ii++){ // ii -- Inner Iterations
-
-			getEffectFromClients(residual,w);
-
-			// Orthogonalization
-			for (int k=0; k<ii; k++){
-				double dum = EMPIRE::MathLibrary::computeDenseDotProduct(this->sysSize,w,&V[this->sysSize*k]);
-				H(k,ii) = dum;
-				double h_ki = dum;
-				EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(&V[this->sysSize*k], h_ki, this->sysSize);
-				for(int l=0; l<this->sysSize; l++){
-					w[l] = w[l] - V[this->sysSize*k + l];
-				}
-			}
+		unsigned long int numInner = 0;
+		for(unsigned long int ii=0; ii<m; ii++){ // ii -- Inner Iterations
 
-			// Calculating and Storing the next Krylov vector
-			H(ii+1,ii) = EMPIRE::MathLibrary::vector2norm(w,this->sysSize);
-			double h_ii = H(ii,ii);
-			EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(w, 1/h_ii, this->sysSize);
-			for(int i=0; i<this->sysSize; i++){
-				V[this->sysSize*(ii+1) +i] = w[i];
+			getEffectFromClients(&V[this->sysSize*ii], &w[0]);
+
+			// Orthogonalization (modified Gram-Schmidt)
+			for(unsigned long int k=0; k<=ii; k++){
+				double dum = EMPIRE::MathLibrary::computeDenseDotProduct(this->sysSize, &w[0], &V[this->sysSize*k]);
+				H[k*m + ii] = dum;
+				for(unsigned long int l=0; l<this->sysSize; l++)
+					w[l] -= dum * V[this->sysSize*k + l];
 			}
 
-			// Applying rotations
-			for (int k=0; k<ii-1; k++){
-				double temp = cs[k]*H(k,ii) + sn[k]*H(k+1,ii);
-				H(k+1,ii) = -sn[k]*H(k,ii) + cs[k]*H(k+1,ii);
-				H(k,ii) = temp;
+			// Calculating and Storing the next Krylov vector
+			double h_next = EMPIRE::MathLibrary::vector2norm(&w[0], this->sysSize);
+			H[(ii+1)*m + ii] = h_next;
+			if(h_next > 0.0)
+				for(unsigned long int i=0; i<this->sysSize; i++)
+					V[this->sysSize*(ii+1) + i] = w[i] / h_next;
+
+			// Applying the previous rotations to the new column
+			for(unsigned long int k=0; k<ii; k++){
+				double temp = cs[k]*H[k*m + ii] + sn[k]*H[(k+1)*m + ii];
+				H[(k+1)*m + ii] = -sn[k]*H[k*m + ii] + cs[k]*H[(k+1)*m + ii];
+				H[k*m + ii] = temp;
 			}
 
 			// Calulating the (ii+1)th Rotations
-			calculateNextRotations(H(ii,ii), H(ii+1,ii), &cs[ii], &sn[ii]);
+			calculateNextRotations(H[ii*m + ii], H[(ii+1)*m + ii], &cs[ii], &sn[ii]);
 			double temp = cs[ii] * s[ii];
 			s[ii + 1] = -sn[ii] * s[ii];
 			s[ii] = temp;
-			H(ii, ii) = cs[ii]*H(ii,ii) + sn[ii]*H(ii+1,ii);
-			H(ii+1, ii) = 0.0;
-			double err = std::abs(s[ii+1]);
-
-			if(err <= this->tolerance){
-				// Before solving, we have to resize the matrix to suit the dimension
-				H.resize(0,0,ii,ii);
-				// Solve the system and update the solution.
-				H.solve(y,s);
-				// get update for the update of solution : multiply krylov vector matrix V with y.
-				for(unsigned long int n=0; n<this->sysSize; n++)
-					for(unsigned long int a=0; a<ii; a++)
-						gmresUpdate[n] += V[n*this->sysSize + this->maxInnerItter]*y[a];
-
-				// Applying gmres update to the solution update
-				for(unsigned long int n=0; n<this->sysSize; n++)
-					solutionUpdate[n] += gmresUpdate[n];
+			H[ii*m + ii] = cs[ii]*H[ii*m + ii] + sn[ii]*H[(ii+1)*m + ii];
+			H[(ii+1)*m + ii] = 0.0;
+			err = std::abs(s[ii+1]);
+			numInner = ii+1;
 
+			// Stop at convergence or at a lucky breakdown
+			if(err <= this->tolerance || h_next == 0.0)
 				break;
-			}
-
 		}
 
-		if(err <= this->tolerance){
-			break;
+		// Solve the reduced upper triangular system H y = s
+		for(int a=numInner-1; a>=0; a--){
+			double dum = s[a];
+			for(unsigned long int b=a+1; b<numInner; b++)
+				dum -= H[a*m + b] * y[b];
+			y[a] = dum / H[a*m + a];
 		}
 
-		// Solve the system and update the solution.
-		H.resize(0,0,this->maxInnerItter, this->maxInnerItter);
-		H.solve(y,s);
 		// get update for the update of solution : multiply krylov vector matrix V with y.
-		for(unsigned long int n=0; n<this->sysSize; n++)
-			for(unsigned long int a=0; a<this->maxInnerItter; a++)
-				gmresUpdate[n] += V[n*this->sysSize + this->maxInnerItter]*y[a];
+		for(unsigned long int n=0; n<this->sysSize; n++){
+			gmresUpdate[n] = 0.0;
+			for(unsigned long int a=0; a<numInner; a++)
+				gmresUpdate[n] += V[this->sysSize*a + n] * y[a];
+		}
 
 		// Applying gmres update to the solution update
 		for(unsigned long int n=0; n<this->sysSize; n++)
 			solutionUpdate[n] += gmresUpdate[n];
 
 		// Calculate residue vector with the new updated solution.
-		constructResidualVector(residual);
-		s[this->maxInnerItter+1] = EMPIRE::MathLibrary::vector2norm(residual,this->sysSize);
+		constructResidualVector(&residual[0]);
+		err = EMPIRE::MathLibrary::vector2norm(&residual[0], this->sysSize);
 
 	} // End of GMRES iterations
 
+	// Keep the solution to seed the next solve, its effect is A x = b - r
+	if(recycleDimension > 0){
+		vector<double> x(solutionUpdate, solutionUpdate + this->sysSize);
+		vector<double> Ax(this->sysSize);
+		for(unsigned long int i=0; i<this->sysSize; i++)
+			Ax[i] = rhs[i] - residual[i];
+		addRecycleDirection(x, Ax);
+	}
+
 	/// Information output
     stringstream toOutput;
     toOutput << scientific;
-    toOutput << "GMRES iterations converged after ::  "<<oi;
+    toOutput << "GMRES iterations converged after ::  "<<oi<<" with residual "<<err<<" and "<<recycleC.size()<<" recycled directions";
     INDENT_OUT(1, toOutput.str(), infoOut);
     cout.unsetf(ios_base::floatfield);
 
 
 	//// Updating the output
-    //// TODO :: this is wrong. We do not have equal number of residuals and outputs in the case of GMRES.
-	assert(outputs.size() == residuals.size());
-	int oldResidualSize=0;
+	//// The outputs are the participant blocks of the interface system, the lambdas are not output.
+	assert(outputs.size() <= numParticipants);
+	int participant=0;
 	for (map<int, CouplingAlgorithmOutput*>::iterator it = outputs.begin(); it != outputs.end(); it++) {
 
 		CouplingAlgorithmOutput *output = it->second;
-		double *newOuput = new double[this->sysSize];
+		assert(output->size == this->oneSize);
+		double *newOutput = output->getArray();
 
 		for(unsigned long int i=0; i<this->oneSize; i++){
-			// TODO :: here after all the GMRES iterations, the update is added to the copy at the beginning.
-			// There are in total three vectors
-			// 1. the outputCopyAtIterationBeginning -> this is from the AbstractCouplingAlgorithm
-			// 2. solutionUpdate -> defined in this class -> This will be updated after every GMRES iteration -> this should be added to outputCopyAtIterationBeginning
-			// 3. gmresUpdate -> defined in this class -> this will be calculated in the GMRES iterations and will be added to solutionUpdate after every GMRES iteration.
-
-			// TODO :: Now the question is what should this output contain.
-			// Should it contain the new velocities/displacements on the
-			newOuput[i] = output->outputCopyAtIterationBeginning[i]+this->solutionUpdate[i];  // TODO : Change to actual update
+			// After all the GMRES iterations, the update is added to the copy at the beginning.
+			newOutput[i] = output->outputCopyAtIterationBeginning[i] + this->solutionUpdate[participant*this->oneSize + i];
 		}
-		output->overwrite(newOuput);
+		participant++;
 	}
 
-
-	//// Cleaning up the memory
-	delete []residual;
-	delete []w;
-	delete []V;
-	delete []cs;
-	delete []sn;
-	delete []y;
-	delete []s;
 	count++;
 }
 
 void GMRES::init(){
-	// Do nothing
+	// One block per participant and one block of lambdas per pair of consecutive participants
+	assert(functionInput.size() == functionOutput.size());
+	assert(functionInput.size() >= 2);
+	numParticipants = functionInput.size();
+	oneSize = functionInput[0]->dataField->numLocations * functionInput[0]->dataField->dimension;
+	for(unsigned long int i=0; i<numParticipants; i++){
+		assert(functionInput[i]->dataField->numLocations * functionInput[i]->dataField->dimension == oneSize);
+		assert(functionOutput[i]->dataField->numLocations * functionOutput[i]->dataField->dimension == oneSize);
+	}
+	sysSize = (2 * numParticipants - 1) * oneSize;
+
+	delete []rhs;
+	delete []solutionUpdate;
+	delete []gmresUpdate;
+	// RHS vector
+	rhs = new double[sysSize]();
+	// Solution vector
+	solutionUpdate = new double[sysSize]();
+	// GMRES update
+	gmresUpdate = new double[sysSize]();
+	// workspace of the effect of the system matrix
+	effect.resize(sysSize);
 }
 
 
@@ -260,84 +266,151 @@ void GMRES::addOutputConnection(ConnectionIO *connection){
 }
 
 void GMRES::constructResidualVector(double *residualVec){
-	// formulating the RHS for the GMRES system.
-	if(!rhsDone){
-		formulateRHS();
-		rhsDone = true;
-	}
-
 	// Calculating the effect of the the system matrix on the current solution. (Ax)
-	double *effect = new double[this->sysSize];
-	getEffectFromClients(solutionUpdate, effect);
+	getEffectFromClients(solutionUpdate, &effect[0]);
 
 	// finding the residue
 	// r = b - Ax (here Ax is the effect and b is the RHS)
-	for(int i=0; i<this->sysSize; i++){
+	for(unsigned long int i=0; i<this->sysSize; i++){
 		residualVec[i] = rhs[i] - effect[i];
 	}
-
-	// Cleaning up the memory
-	delete []effect;
 }
 
 
 void GMRES::formulateRHS(){
 	/*
-	 * RHS for the GMRES system
+	 * RHS for the GMRES system of N participants
 	 *
-	 * 			 _                     _
-	 * 			|  Res_fluid 			|
-	 * RHS = 	| 						|
-	 * 			|  Res_structure		|
-	 * 			|						|
-	 * 			|  lambda (u_f - u_s)	|
-	 * 			|_					   _|
+	 * 			 _                         _
+	 * 			|  Res_0 					|
+	 * 			|  ...						|
+	 * RHS = 	|  Res_N-1					|
+	 * 			|							|
+	 * 			|  lambda_0 (u_0 - u_1)		|
+	 * 			|  ...						|
+	 * 			|  lambda_N-2 (u_N-2 - u_N-1)|
+	 * 			|_					       _|
 	 *
 	 */
 
-	// Get Fluid and structural solver residue
-	// here both functionInput and functionOutput will have same size
-	for(int i=0; i<this->functionInput.size(); i++){
+	// Get the residues of all participants
+	for(unsigned long int i=0; i<this->functionInput.size(); i++){
 		this->functionInput[i]->receive();								//// INCOMING COMMUNICATION
 	}
 
-
 	// Storing the obtained residues into the RHS vector.
 	// We have to use them as soon as we receive because we will rewrite them once we receive next entitiy.
-	for(int i=0; i<this->functionInput.size(); i++){
-		for(int j=0; j<oneSize; j++){
+	for(unsigned long int i=0; i<this->functionInput.size(); i++){
+		for(unsigned long int j=0; j<oneSize; j++){
 			rhs[i*oneSize+j] = functionInput[i]->dataField->data[j];
 		}
 	}
 
-	// Get Fluid and Structural solver velocity
+	// Get the interface velocities of all participants
 	// Here the previous data in the functionInput and functionOutput will be over written.
-	for(int i=0; i<this->functionInput.size(); i++){
+	for(unsigned long int i=0; i<this->functionInput.size(); i++){
 		this->functionInput[i]->receive();								//// INCOMING COMMUNICATION
 	}
 
-	// Calculate lambda as u_f - u_s
-	// This is 2 solver FSI specific.
-	unsigned long int lambdaPosition = oneSize*functionInput.size();
-	for(int i=0; i<oneSize; i++){
-		rhs[i+lambdaPosition] = functionInput[functionInput.size() -1]->dataField->data[i] - functionInput[functionInput.size()]->dataField->data[i];
+	// Calculate lambda_k as u_k - u_k+1 for each pair of consecutive participants
+	unsigned long int lambdaPosition = oneSize*numParticipants;
+	for(unsigned long int k=0; k+1<numParticipants; k++){
+		for(unsigned long int i=0; i<oneSize; i++){
+			rhs[lambdaPosition + k*oneSize + i] = functionInput[k]->dataField->data[i] - functionInput[k+1]->dataField->data[i];
+		}
 	}
 }
 
 void GMRES::getEffectFromClients(double *vec, double *effect){
-	// Setting the data in the input
-	for(int i=0; i<this->functionInput.size(); i++){
-		for(int j=0; j<oneSize; j++){
+	// Setting the data in the output
+	for(unsigned long int i=0; i<numParticipants; i++){
+		for(unsigned long int j=0; j<oneSize; j++){
 			functionOutput[i]->dataField->data[j] = vec[i*oneSize+j];
 		}
 	}
-	// Send fluid and structural part of vec to respective solvers
-	for(int i=0; i<this->functionInput.size(); i++){
-		functionInput[i]->send();										//// OUTGOING COMMUNICATION
+	// Post the sends to all participants first, so that they evaluate in parallel
+	std::vector<bool> isSendPending(numParticipants);
+	for(unsigned long int i=0; i<numParticipants; i++){
+		isSendPending[i] = (functionOutput[i]->startSend() >= 0);		//// OUTGOING COMMUNICATION
 	}
-	// Receive the effect from fluid and structural solvers.
-	for(int i=0; i<this->functionInput.size(); i++){
+	// Receive the effects. The send has to complete before, since input and output may share the data field.
+	for(unsigned long int i=0; i<numParticipants; i++){
+		if(isSendPending[i])
+			functionOutput[i]->finishSend();
 		functionInput[i]->receive();									//// INCOMING COMMUNICATION
+		for(unsigned long int j=0; j<oneSize; j++){
+			effect[i*oneSize+j] = functionInput[i]->dataField->data[j];
+		}
+	}
+	// Coupling by the lambdas: lambda_k acts on participant k with +1 and on participant k+1 with -1,
+	// and the continuity rows are u_k - u_k+1
+	unsigned long int lambdaPosition = oneSize*numParticipants;
+	for(unsigned long int k=0; k+1<numParticipants; k++){
+		for(unsigned long int j=0; j<oneSize; j++){
+			double lambda = vec[lambdaPosition + k*oneSize + j];
+			effect[k*oneSize + j] += lambda;
+			effect[(k+1)*oneSize + j] -= lambda;
+			effect[lambdaPosition + k*oneSize + j] = vec[k*oneSize + j] - vec[(k+1)*oneSize + j];
+		}
+	}
+}
+
+void GMRES::updateRecycleSpace(){
+	// Recompute C = A U, then orthonormalize C by modified Gram-Schmidt and apply the same operations on U
+	std::deque<std::vector<double> > oldU;
+	oldU.swap(recycleU);
+	recycleC.clear();
+	vector<double> c(this->sysSize);
+	for(unsigned long int k=0; k<oldU.size(); k++){
+		getEffectFromClients(&oldU[k][0], &c[0]);
+		vector<double> u = oldU[k];
+		double normBefore = EMPIRE::MathLibrary::vector2norm(&c[0], this->sysSize);
+		for(unsigned long int l=0; l<recycleC.size(); l++){
+			double dum = EMPIRE::MathLibrary::computeDenseDotProduct(this->sysSize, &c[0], &recycleC[l][0]);
+			for(unsigned long int n=0; n<this->sysSize; n++){
+				c[n] -= dum * recycleC[l][n];
+				u[n] -= dum * recycleU[l][n];
+			}
+		}
+		double normAfter = EMPIRE::MathLibrary::vector2norm(&c[0], this->sysSize);
+		// drop the direction if it became dependent on the newer ones
+		if(normAfter <= 1e-10 * normBefore || normAfter == 0.0)
+			continue;
+		for(unsigned long int n=0; n<this->sysSize; n++){
+			c[n] /= normAfter;
+			u[n] /= normAfter;
+		}
+		recycleC.push_back(c);
+		recycleU.push_back(u);
+	}
+}
+
+void GMRES::addRecycleDirection(const std::vector<double> &z, const std::vector<double> &Az){
+	if(recycleDimension == 0)
+		return;
+	vector<double> u(z);
+	vector<double> c(Az);
+	double normBefore = EMPIRE::MathLibrary::vector2norm(&c[0], this->sysSize);
+	for(unsigned long int l=0; l<recycleC.size(); l++){
+		double dum = EMPIRE::MathLibrary::computeDenseDotProduct(this->sysSize, &c[0], &recycleC[l][0]);
+		for(unsigned long int n=0; n<this->sysSize; n++){
+			c[n] -= dum * recycleC[l][n];
+			u[n] -= dum * recycleU[l][n];
+		}
+	}
+	double normAfter = EMPIRE::MathLibrary::vector2norm(&c[0], this->sysSize);
+	if(normAfter <= 1e-10 * normBefore || normAfter == 0.0)
+		return;
+	for(unsigned long int n=0; n<this->sysSize; n++){
+		c[n] /= normAfter;
+		u[n] /= normAfter;
+	}
+	// the newest direction comes first, the oldest one is dropped
+	recycleC.push_front(c);
+	recycleU.push_front(u);
+	if(recycleC.size() > recycleDimension){
+		recycleC.pop_back();
+		recycleU.pop_back();
 	}
 }
 
@@ -357,7 +430,34 @@ void GMRES::calculateNextRotations(double a, double b, double* c, double* s){
 	 }
 }
 
+void GMRES::writeCheckpoint(CheckpointArchive &archive) const {
+	AbstractCouplingAlgorithm::writeCheckpoint(archive);
+	archive.write((int) count);
+	archive.write(recycleU);
+	archive.write(recycleC);
+}
 
-
+void GMRES::readCheckpoint(CheckpointArchive &archive) {
+	AbstractCouplingAlgorithm::readCheckpoint(archive);
+	int storedCount;
+	archive.read(storedCount);
+	count = storedCount;
+	archive.read(recycleU);
+	archive.read(recycleC);
+	if (recycleU.size() != recycleC.size() || recycleU.size() > recycleDimension) {
+		ERROR_OUT() << "GMRES: the checkpoint of \"" << name << "\" has " << recycleU.size()
+				<< " recycled directions, at most " << recycleDimension << " are allowed" << endl;
+		exit(EXIT_FAILURE);
+	}
+	for (unsigned long int k = 0; k < recycleU.size(); k++) {
+		if (recycleU[k].size() != sysSize || recycleC[k].size() != sysSize) {
+			ERROR_OUT() << "GMRES: the recycled directions in the checkpoint of \"" << name
+					<< "\" do not have the size of the system " << sysSize << endl;
+			exit(EXIT_FAILURE);
+		}
+	}
 }
 
+
+
+}
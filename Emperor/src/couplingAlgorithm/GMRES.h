@@ -29,6 +29,7 @@
 
 #include "AbstractCouplingAlgorithm.h"
 #include <vector>
+#include <deque>
 
 
 namespace EMPIRE {
@@ -43,7 +44,9 @@ class SparseMatrix;
 class ConnectionIO;
 
 /********//**
- * \brief Class GMRES does GMRES based Co-Simulation
+ * \brief Class GMRES does GMRES based Co-Simulation of N participants. The interface system holds
+ *        one block per participant and one block of Lagrange multipliers per pair of consecutive
+ *        participants. The solutions of earlier solves are recycled as the initial space of the next solve.
  ***********/
 class GMRES: public AbstractCouplingAlgorithm {
 public:
@@ -54,9 +57,11 @@ public:
 	 * \param[in] maxOuterItter		The maximum number of outer iterations for GMRES algorithm
 	 * \param[in] maxInnerItter 	The maximum number of inner iterations for GMRES algorithm.
 	 * \param[in] residualTolerance The tolerance for the GMRES convergence.
+	 * \param[in] recycleDimension  The maximum number of directions recycled to the next solve (0 means no recycling)
 	 * \author Aditya Ghantasala
 	 ***********/
-	GMRES(std::string _name, int maxOuterItter, int maxInnerItter, double residualTolerance);
+	GMRES(std::string _name, int maxOuterItter, int maxInnerItter, double residualTolerance,
+			int recycleDimension = 0);
 
 	/***********************************************************************************************
 	 * \brief Destructor
@@ -77,7 +82,7 @@ public:
 	void calcCurrentResidual(){}
 
 	/***********************************************************************************************
-	 * \brief Init GMRES
+	 * \brief Init GMRES, determines the size of the interface system from the connections
 	 * \author Aditya Ghantasala
 	 ***********/
 	void init();
@@ -95,16 +100,23 @@ public:
 	void addOutputConnection(ConnectionIO *connection);
 
 
-	/*
-	 * May we we need the following functions
-	 *
-	 * ConstructGlobalResidualVector
-	 * SolveInterfaceSystemWithGMRES
-	 * ReceiveResidualsFromClients (to be modular)
-	 * SendVectorToGetEffectFromClients (to be modular)
-	 * ReceiveEffectsFromClients (to be modular)   // Basically we put all the send and receive calls in these function calls.
-	 *
-	 */
+	/***********************************************************************************************
+	 * \brief Get the number of directions currently kept for recycling
+	 * \return the number of recycled directions
+	 ***********/
+	int getNumRecycledDirections() const {
+		return recycleU.size();
+	}
+	/***********************************************************************************************
+	 * \brief Write the recycled directions in addition
+	 * \param[in] archive the archive
+	 ***********/
+	void writeCheckpoint(CheckpointArchive &archive) const;
+	/***********************************************************************************************
+	 * \brief Restore the state written by writeCheckpoint
+	 * \param[in] archive the archive
+	 ***********/
+	void readCheckpoint(CheckpointArchive &archive);
 
 private:
 
@@ -115,6 +127,8 @@ private:
 	unsigned long int sysSize;
 	/// Number of DOFs on the interface of the system.
 	unsigned long int oneSize;
+	/// Number of participants (clients) in the interface system
+	unsigned long int numParticipants;
 	/// Count variable
 	unsigned long int count;
 	/// Maximum outer iterations
@@ -129,8 +143,14 @@ private:
 	double *gmresUpdate;
 	// RHS vector for the GMRES method
 	double *rhs;
-	// Boolean to find if the RHS is formulated
-	bool rhsDone;
+	/// Workspace of the effect of the system matrix, sized in init
+	std::vector<double> effect;
+	/// Maximum number of recycled directions
+	unsigned long int recycleDimension;
+	/// Recycled directions U (solutions of earlier solves), the newest direction comes first
+	std::deque<std::vector<double> > recycleU;
+	/// Effects C = A U of the recycled directions, orthonormal
+	std::deque<std::vector<double> > recycleC;
 
 
 	/// I/O functions for communicating with the clients during the update calculation
@@ -151,7 +171,8 @@ private:
 	void constructResidualVector(double *globalResidualVec);
 
 	/***********************************************************************************************
-	 * \brief Method gets the effect of the system matrix (for GMRES)
+	 * \brief Method gets the effect of the system matrix (for GMRES). The blocks of all participants
+	 *        are sent before any effect is received, so that the clients evaluate in parallel.
 	 * \param[out] effect 			-A double pointer to the global residual vector.
 	 * 								 Memory should be allocated before passing the pointer.
 	 * \param[in]  vec 				-The vector on which the effect should be obtained.
@@ -165,6 +186,19 @@ private:
 	 ***********/
 	void formulateRHS();
 
+	/***********************************************************************************************
+	 * \brief Recompute the effects of the recycled directions with the current system matrix and
+	 *        orthonormalize them, directions which became dependent are dropped
+	 ***********/
+	void updateRecycleSpace();
+
+	/***********************************************************************************************
+	 * \brief Add a correction direction and its effect to the recycled directions
+	 * \param[in] z the correction direction
+	 * \param[in] Az the effect of the system matrix on z
+	 ***********/
+	void addRecycleDirection(const std::vector<double> &z, const std::vector<double> &Az);
+
 
 	/***********************************************************************************************
 	 * \brief Method calculates the rotations necessary for orthogonalization.
@@ -22,6 +22,8 @@
 #include <assert.h>
 #include <sstream>
 #include <string.h>
+#include <math.h>
+#include <algorithm>
 
 
 #include "IJCSA.h"
@@ -32,6 +34,7 @@
 #include "Residual.h"
 #include "AbstractCouplingAlgorithm.h"
 #include "MathLibrary.h"
+#include "BufferPool.h"
 
 
 
@@ -45,12 +48,16 @@ IJCSA::IJCSA(std::string _name) :
 	debugMe = false;
 	globalResidual = NULL;
 	correctorVec = NULL;
+	interfaceJacGlobal = NULL;
+	isFactorized = false;
+	maxRankOfUpdate = 0;
+	linearSolver = MathLibrary::LinearSolverRegistry::DIRECT;
 }
 
 IJCSA::~IJCSA() {
 	delete[] globalResidual;
 	delete[] correctorVec;
-	delete[] interfaceJacGlobal;
+	delete interfaceJacGlobal;
 }
 
 void IJCSA::calcNewValue() {
@@ -72,13 +79,9 @@ void IJCSA::calcNewValue() {
 	}
 	/// get updated values for interface Jacobian
 	calcInterfaceJacobian();
-	assembleInterfaceJacobian();
 
 	/// compute IJCSA update
-	// Edit Aditya
-	(*interfaceJacGlobal).factorize();
-	(*interfaceJacGlobal).solve(correctorVec,globalResidual);
-	(*interfaceJacGlobal).reset();
+	solveInterfaceJacobian();
 
 	/// tmpVec holds -corrector_global
 	DEBUG_OUT() << std::endl;
@@ -96,16 +99,13 @@ void IJCSA::calcNewValue() {
 		assert(outputs.find(it->first) != outputs.end());
 		CouplingAlgorithmOutput *output = outputs.find(it->first)->second;
 		assert(residual->size == output->size);
-		double *newOuput = new double[residual->size];
-		// U_i_n+1 = U_i_n + alpha R_i_n
-
+		// U_i_n+1 = U_i_n - corrector_i, computed in place
+		double *newOutput = output->getArray();
 		for (int i = 0; i < residual->size; i++) {
-			newOuput[i] = output->outputCopyAtIterationBeginning[i]
+			newOutput[i] = output->outputCopyAtIterationBeginning[i]
 			                                                     - correctorVec[i+oldResidualSize];
 		}
-		oldResidualSize=residual->size;
-		output->overwrite(newOuput);
-		delete[] newOuput;
+		oldResidualSize += residual->size;
 	}
 
 }
@@ -174,11 +174,163 @@ void IJCSA::calcInterfaceJacobian() {
 
 }
 
+void IJCSA::calcCurrentResidual() {
+	for (int i = 0; i < interfaceJacobianBlocks.size(); i++) {
+		interfaceJacobianBlock &block = interfaceJacobianBlocks[i];
+		if (newTimeStep || block.isUpdatedEveryIteration)
+			setInterfaceJacobianBlock(block,
+					block.clientCode->recvInterfaceJacobian(block.jacobianName));
+	}
+}
+
+void IJCSA::setInterfaceJacobianBlock(interfaceJacobianBlock &block,
+		const ClientCode::InterfaceJacobian &jacobian) {
+	if (!block.isReceived) {
+		if (block.indexRow - 1 + jacobian.numRows > globalResidualSize
+				|| block.indexColumn - 1 + jacobian.numColumns > globalResidualSize) {
+			ERROR_OUT() << "IJCSA: the interface Jacobian block \"" << block.jacobianName << "\" of "
+					<< jacobian.numRows << " x " << jacobian.numColumns << " at ("
+					<< block.indexRow << ", " << block.indexColumn
+					<< ") exceeds the global residual size " << globalResidualSize << endl;
+			exit(EXIT_FAILURE);
+		}
+		bool isSymmetric = (*interfaceJacGlobal).getIsSymmetric();
+		for (int i = 0; i < jacobian.numRows; i++) {
+			for (int j = jacobian.rowPointers[i]; j < jacobian.rowPointers[i + 1]; j++) {
+				int row = block.indexRow - 1 + i;
+				int column = block.indexColumn - 1 + jacobian.columnIndices[j];
+				if (isSymmetric && row > column) // mirrored from the upper triangular part
+					continue;
+				block.rows.push_back(row);
+				block.columns.push_back(column);
+				block.valueIndices.push_back(j);
+			}
+		}
+		block.values.resize(block.valueIndices.size());
+		block.isReceived = true;
+	}
+	assert(jacobian.values.size() == jacobian.rowPointers[jacobian.numRows]);
+	for (int k = 0; k < block.valueIndices.size(); k++)
+		block.values[k] = jacobian.values[block.valueIndices[k]];
+}
+
+void IJCSA::getInterfaceJacobianValues(map<pair<int, int>, double> &values) {
+	values.clear();
+	for (int i = 0; i < interfaceJacobianEntrys.size(); i++)
+		values[pair<int, int>(interfaceJacobianEntrys[i].indexRow - 1,
+				interfaceJacobianEntrys[i].indexColumn - 1)] = interfaceJacobianEntrys[i].value;
+	for (int i = 0; i < interfaceJacobianBlocks.size(); i++) {
+		const interfaceJacobianBlock &block = interfaceJacobianBlocks[i];
+		for (int k = 0; k < block.values.size(); k++)
+			values[pair<int, int>(block.rows[k], block.columns[k])] = block.values[k];
+	}
+}
+
+void IJCSA::factorizeInterfaceJacobian() {
+	assembleInterfaceJacobian();
+	(*interfaceJacGlobal).factorize();
+	getInterfaceJacobianValues(factorizedValues);
+	isFactorized = true;
+}
+
+void IJCSA::solveInterfaceJacobian() {
+	map<pair<int, int>, double> values;
+	getInterfaceJacobianValues(values);
+	if (!isFactorized)
+		factorizeInterfaceJacobian();
+
+	/// the changed entries give J = J_0 + sum_k delta_k * e_row_k * e_column_k^T
+	vector<int> rows;
+	vector<int> columns;
+	vector<double> deltas;
+	bool isSymmetric = (*interfaceJacGlobal).getIsSymmetric();
+	for (map<pair<int, int>, double>::iterator it = values.begin(); it != values.end(); it++) {
+		double delta = it->second - factorizedValues[it->first];
+		if (delta == 0.0)
+			continue;
+		rows.push_back(it->first.first);
+		columns.push_back(it->first.second);
+		deltas.push_back(delta);
+		if (isSymmetric && it->first.first != it->first.second) { // the lower triangular part
+			rows.push_back(it->first.second);
+			columns.push_back(it->first.first);
+			deltas.push_back(delta);
+		}
+	}
+	int rank = deltas.size();
+	if (rank > maxRankOfUpdate) {
+		factorizeInterfaceJacobian();
+		rank = 0;
+	}
+
+	/// y = J_0^-1 * r
+	(*interfaceJacGlobal).solve(correctorVec, globalResidual);
+	if (rank == 0)
+		return;
+
+	/// Sherman-Morrison-Woodbury with U = [delta_k * e_row_k] and V = [e_column_k]:
+	/// J^-1 * r = y - Z * (I + V^T * Z)^-1 * V^T * y with Z = J_0^-1 * U
+	/// Z and the right hand sides are recycled over the iterations by the buffer pool
+	BufferPool::Buffer Z((size_t) rank * globalResidualSize);
+	BufferPool::Buffer rhs(globalResidualSize);
+	for (int k = 0; k < rank; k++) {
+		for (int i = 0; i < globalResidualSize; i++)
+			rhs[i] = 0.0;
+		rhs[rows[k]] = deltas[k];
+		(*interfaceJacGlobal).solve(&Z[(size_t) k * globalResidualSize], rhs.data());
+	}
+	vector<double> S(rank * rank);
+	vector<double> t(rank);
+	for (int j = 0; j < rank; j++) {
+		for (int k = 0; k < rank; k++)
+			S[j * rank + k] = (j == k ? 1.0 : 0.0) + Z[(size_t) k * globalResidualSize + columns[j]];
+		t[j] = correctorVec[columns[j]];
+	}
+	/// solve S * t = V^T * y by Gaussian elimination with partial pivoting
+	for (int j = 0; j < rank; j++) {
+		int pivot = j;
+		for (int i = j + 1; i < rank; i++)
+			if (fabs(S[i * rank + j]) > fabs(S[pivot * rank + j]))
+				pivot = i;
+		if (S[pivot * rank + j] == 0.0) {
+			WARNING_BLOCK_OUT("IJCSA", "solveInterfaceJacobian()",
+					"singular low-rank correction, the interface Jacobian is factorized again");
+			factorizeInterfaceJacobian();
+			(*interfaceJacGlobal).solve(correctorVec, globalResidual);
+			return;
+		}
+		if (pivot != j) {
+			for (int k = 0; k < rank; k++)
+				swap(S[j * rank + k], S[pivot * rank + k]);
+			swap(t[j], t[pivot]);
+		}
+		for (int i = j + 1; i < rank; i++) {
+			double factor = S[i * rank + j] / S[j * rank + j];
+			for (int k = j; k < rank; k++)
+				S[i * rank + k] -= factor * S[j * rank + k];
+			t[i] -= factor * t[j];
+		}
+	}
+	for (int j = rank - 1; j >= 0; j--) {
+		for (int k = j + 1; k < rank; k++)
+			t[j] -= S[j * rank + k] * t[k];
+		t[j] /= S[j * rank + j];
+	}
+	for (int k = 0; k < rank; k++)
+		for (int i = 0; i < globalResidualSize; i++)
+			correctorVec[i] -= Z[(size_t) k * globalResidualSize + i] * t[k];
+}
+
 void IJCSA::assembleInterfaceJacobian(){
 	for(int i=0;i<interfaceJacobianEntrys.size();i++){
 		(*interfaceJacGlobal)(interfaceJacobianEntrys[i].indexRow-1,
 						interfaceJacobianEntrys[i].indexColumn-1)=interfaceJacobianEntrys[i].value;
 	}
+	for (int i = 0; i < interfaceJacobianBlocks.size(); i++) {
+		const interfaceJacobianBlock &block = interfaceJacobianBlocks[i];
+		for (int k = 0; k < block.values.size(); k++)
+			(*interfaceJacGlobal)(block.rows[k], block.columns[k]) = block.values[k];
+	}
 }
 
 
@@ -192,6 +344,7 @@ void IJCSA::init() {
 	globalResidual = new double[globalResidualSize];
 	correctorVec   = new double[globalResidualSize];
 	interfaceJacGlobal = new EMPIRE::MathLibrary::SparseMatrix<double>(globalResidualSize,true);
+	interfaceJacGlobal->setLinearSolver(linearSolver);
 
 
 	assembleInterfaceJacobian();
@@ -219,4 +372,53 @@ void IJCSA::addInterfaceJacobianEntry(unsigned int _indexRow,
 	interfaceJacobianEntrys.push_back(tmp);
 }
 
+void IJCSA::addInterfaceJacobianBlock(unsigned int _indexRow, unsigned int _indexColumn,
+		ClientCode *_clientCode, std::string _jacobianName, bool _isUpdatedEveryIteration) {
+	assert(_indexRow >= 1 && _indexColumn >= 1);
+	interfaceJacobianBlock tmp;
+	tmp.indexRow = _indexRow;
+	tmp.indexColumn = _indexColumn;
+	tmp.clientCode = _clientCode;
+	tmp.jacobianName = _jacobianName;
+	tmp.isUpdatedEveryIteration = _isUpdatedEveryIteration;
+	tmp.isReceived = false;
+	interfaceJacobianBlocks.push_back(tmp);
+}
+
+void IJCSA::writeCheckpoint(CheckpointArchive &archive) const {
+	AbstractCouplingAlgorithm::writeCheckpoint(archive);
+	archive.write((int) interfaceJacobianEntrys.size());
+	for (int i = 0; i < interfaceJacobianEntrys.size(); i++) {
+		archive.write(interfaceJacobianEntrys[i].value);
+		archive.write(interfaceJacobianEntrys[i].oldInput);
+		archive.write(interfaceJacobianEntrys[i].oldOutput);
+	}
+	archive.write(functionInputold);
+	archive.write(functionInput);
+	archive.write(functionOutputold);
+	archive.write(functionOutput);
+}
+
+void IJCSA::readCheckpoint(CheckpointArchive &archive) {
+	AbstractCouplingAlgorithm::readCheckpoint(archive);
+	int numEntries;
+	archive.read(numEntries);
+	if (numEntries != interfaceJacobianEntrys.size()) {
+		ERROR_OUT() << "IJCSA: the checkpoint of \"" << name << "\" has " << numEntries
+				<< " interface Jacobian entries instead of " << interfaceJacobianEntrys.size() << endl;
+		exit(EXIT_FAILURE);
+	}
+	for (int i = 0; i < interfaceJacobianEntrys.size(); i++) {
+		archive.read(interfaceJacobianEntrys[i].value);
+		archive.read(interfaceJacobianEntrys[i].oldInput);
+		archive.read(interfaceJacobianEntrys[i].oldOutput);
+	}
+	archive.read(functionInputold);
+	archive.read(functionInput);
+	archive.read(functionOutputold);
+	archive.read(functionOutput);
+	// the restored entries are factorized at the next solve
+	isFactorized = false;
+}
+
 } /* namespace EMPIRE */
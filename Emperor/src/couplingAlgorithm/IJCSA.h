@@ -28,8 +28,10 @@
 #define IJCSA_H_
 
 #include <vector>
+#include <map>
 #include <fstream>
 #include "AbstractCouplingAlgorithm.h"
+#include "ClientCode.h"
 
 namespace EMPIRE {
 
@@ -64,10 +66,10 @@ public:
      ***********/
     void calcNewValue();
     /***********************************************************************************************
-     * \brief Calculate the new value of the residual
-     * \author Aditya Ghantasala
+     * \brief Receive the blocks of the interface Jacobian sent by the clients with their outputs
+     *        of this iteration, at the first iteration of a time step or at every iteration
      ***********/
-    void calcCurrentResidual(){}
+    void calcCurrentResidual();
     /***********************************************************************************************
      * \brief Init IJCSA
      * \author Stefan Sicklinger
@@ -99,6 +101,47 @@ public:
      * \author Stefan Sicklinger
      ***********/
     void addInterfaceJacobianEntry(unsigned int _indexRow, unsigned int _indexColumn, ConnectionIO* _jacobianSignal);
+    /***********************************************************************************************
+     * \brief add a block of the interface Jacobian sent by a client in compressed sparse row format
+     *        (EMPIRE_API_sendInterfaceJacobian). The entries of the block are added at the first
+     *        transfer and overwritten in place at the later ones, the interface Jacobian is
+     *        symmetric, so entries of the block below its diagonal are left out.
+     * \param[in] _indexRow    row index of the first row of the block
+     * \param[in] _indexColumn column index of the first column of the block
+     * \param[in] _clientCode the client sending the block
+     * \param[in] _jacobianName the name of the block
+     * \param[in] _isUpdatedEveryIteration whether the block is received at every iteration
+     *            instead of the first iteration of every time step
+     ***********/
+    void addInterfaceJacobianBlock(unsigned int _indexRow, unsigned int _indexColumn,
+            ClientCode *_clientCode, std::string _jacobianName, bool _isUpdatedEveryIteration);
+    /***********************************************************************************************
+     * \brief Set the maximum rank of the low-rank correction of the factorized interface Jacobian.
+     *        The factorization is kept over the iterations and time steps, changed entries are taken
+     *        into account by the Sherman-Morrison-Woodbury formula. If more than _maxRankOfUpdate
+     *        rank-one terms are needed, the interface Jacobian is factorized again.
+     * \param[in] _maxRankOfUpdate the maximum rank, 0 for factorizing whenever an entry changed
+     ***********/
+    void setMaxRankOfUpdate(int _maxRankOfUpdate) {
+        maxRankOfUpdate = _maxRankOfUpdate;
+    }
+    /***********************************************************************************************
+     * \brief Select the solver of the interface Jacobian, must be called before init
+     * \param[in] _linearSolver the name of the solver in the LinearSolverRegistry
+     ***********/
+    void setLinearSolver(const std::string &_linearSolver) {
+        linearSolver = _linearSolver;
+    }
+    /***********************************************************************************************
+     * \brief Write the entries of the interface Jacobian and the function values of the automatic differencing in addition
+     * \param[in] archive the archive
+     ***********/
+    void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    void readCheckpoint(CheckpointArchive &archive);
 private:
     /***********************************************************************************************
      * \brief Calculates interface Jacobian using FD
@@ -110,6 +153,44 @@ private:
      * \author Stefan Sicklinger
      ***********/
     void assembleInterfaceJacobian();
+    /***********************************************************************************************
+     * \brief Solve the interface Jacobian for the corrector, by the kept factorization and the
+     *        Sherman-Morrison-Woodbury correction of the entries changed since the factorization
+     ***********/
+    void solveInterfaceJacobian();
+    /***********************************************************************************************
+     * \brief Assemble and factorize the interface Jacobian with the current entries
+     ***********/
+    void factorizeInterfaceJacobian();
+    /***********************************************************************************************
+     * \brief Get the current entries of the interface Jacobian, zero-based
+     * \param[out] values the value of each (row, column)
+     ***********/
+    void getInterfaceJacobianValues(std::map<std::pair<int, int>, double> &values);
+
+    struct interfaceJacobianBlock{
+        unsigned int indexRow;
+        unsigned int indexColumn;
+        ClientCode *clientCode;
+        std::string jacobianName;
+        bool isUpdatedEveryIteration;
+        /// whether the entries have been added at the first transfer
+        bool isReceived;
+        /// zero-based rows and columns of the entries in the interface Jacobian
+        std::vector<int> rows;
+        std::vector<int> columns;
+        /// index of every entry in the values of the block sent
+        std::vector<int> valueIndices;
+        /// the current value of every entry
+        std::vector<double> values;
+    };
+    /***********************************************************************************************
+     * \brief Take the values of a block received, the entries are added at the first call
+     * \param[in] block the block
+     * \param[in] jacobian the block as received by the client code
+     ***********/
+    void setInterfaceJacobianBlock(interfaceJacobianBlock &block,
+            const ClientCode::InterfaceJacobian &jacobian);
 
     struct interfaceJacobianEntry{
     	unsigned int indexRow;
@@ -127,6 +208,8 @@ private:
     };
     /// vector of all entries of the global interface jacobian matrix
     std::vector<interfaceJacobianEntry> interfaceJacobianEntrys;
+    /// blocks of the global interface jacobian sent by the clients
+    std::vector<interfaceJacobianBlock> interfaceJacobianBlocks;
     /// whether output numbers or not
     bool debugMe;
     /// size of global residual vector
@@ -137,6 +220,14 @@ private:
     double *correctorVec;
     /// global interface Jacobian matrix
     MathLibrary::SparseMatrix<double> *interfaceJacGlobal;
+    /// whether interfaceJacGlobal holds a factorization
+    bool isFactorized;
+    /// the entries of interfaceJacGlobal when it was factorized, zero-based
+    std::map<std::pair<int, int>, double> factorizedValues;
+    /// maximum rank of the Sherman-Morrison-Woodbury correction before factorizing again
+    int maxRankOfUpdate;
+    /// name of the solver of the interface Jacobian in the LinearSolverRegistry
+    std::string linearSolver;
 
     /// friend class in unit test
     friend class TestIJCSA;
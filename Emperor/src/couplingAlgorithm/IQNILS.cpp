@@ -0,0 +1,254 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "IQNILS.h"
+#include "DataField.h"
+#include "ConnectionIO.h"
+#include "Signal.h"
+#include "Residual.h"
+#include "Message.h"
+
+#include <assert.h>
+#include <math.h>
+#include <sstream>
+
+using namespace std;
+
+namespace EMPIRE {
+
+IQNILS::IQNILS(std::string _name, double _initRelaxationFactor, int _reuseTimeSteps,
+        double _filterTolerance) :
+        AbstractCouplingAlgorithm(_name), INIT_RELAXATION_FACTOR(_initRelaxationFactor), REUSE_TIME_STEPS(
+                _reuseTimeSteps), FILTER_TOLERANCE(_filterTolerance) {
+    assert(REUSE_TIME_STEPS >= 0);
+    assert(FILTER_TOLERANCE >= 0.0);
+    globalResidualSize = 0;
+    hasOldIteration = false;
+    timeStepCounter = 0;
+}
+
+IQNILS::~IQNILS() {
+}
+
+void IQNILS::init() {
+    // determine global residual vector size
+    globalResidualSize = 0;
+    for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++)
+        globalResidualSize += it->second->size;
+    globalResidual.resize(globalResidualSize);
+    globalResidualOld.resize(globalResidualSize);
+    globalSolverResult.resize(globalResidualSize);
+    globalSolverResultOld.resize(globalResidualSize);
+    newGlobalOutput.resize(globalResidualSize);
+}
+
+void IQNILS::calcCurrentResidual() {
+    // compute the current residuals
+    for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++)
+        it->second->computeCurrentResidual();
+}
+
+void IQNILS::startNewTimeStep() {
+    timeStepCounter++;
+    hasOldIteration = false;
+    while (!columnTimeSteps.empty() && columnTimeSteps.back() < timeStepCounter - REUSE_TIME_STEPS) {
+        V.pop_back();
+        W.pop_back();
+        columnTimeSteps.pop_back();
+    }
+}
+
+void IQNILS::calcNewValue() {
+    assert((int) globalResidual.size() == globalResidualSize);
+    /// reset if new time step is started
+    if (newTimeStep) {
+        startNewTimeStep();
+        newTimeStep = false;
+    }
+
+    /// assemble global residual vector and global solver result
+    assert(outputs.size() == residuals.size());
+    int offset = 0;
+    for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++) {
+        Residual *residual = it->second;
+        assert(outputs.find(it->first) != outputs.end());
+        CouplingAlgorithmOutput *output = outputs.find(it->first)->second;
+        assert(residual->size == output->size);
+        for (int i = 0; i < residual->size; i++) {
+            globalResidual[offset + i] = residual->residualVector[i];
+            globalSolverResult[offset + i] = output->outputCopyAtIterationBeginning[i]
+                    + residual->residualVector[i];
+        }
+        offset += residual->size;
+    }
+    assert(offset == globalResidualSize);
+
+    /// add the differences to the previous iteration as the newest columns
+    if (hasOldIteration) {
+        V.push_front(vector<double>(globalResidualSize));
+        W.push_front(vector<double>(globalResidualSize));
+        columnTimeSteps.push_front(timeStepCounter);
+        for (int i = 0; i < globalResidualSize; i++) {
+            V.front()[i] = globalResidual[i] - globalResidualOld[i];
+            W.front()[i] = globalSolverResult[i] - globalSolverResultOld[i];
+        }
+        // more columns than rows are linearly dependent anyway
+        while ((int) V.size() > globalResidualSize) {
+            V.pop_back();
+            W.pop_back();
+            columnTimeSteps.pop_back();
+        }
+    }
+
+    /// compute the new global output
+    vector<vector<double> > Q;
+    vector<double> R;
+    computeFilteredQR(Q, R);
+    int numColumns = V.size();
+    if (numColumns == 0) {
+        // U_n+1 = U_n + alpha R_n
+        for (int i = 0; i < globalResidualSize; i++)
+            newGlobalOutput[i] = globalSolverResult[i] - globalResidual[i]
+                    + INIT_RELAXATION_FACTOR * globalResidual[i];
+    } else {
+        // least-squares solution of V * alpha = -R_n by R * alpha = - Q^T * R_n
+        vector<double> alpha(numColumns);
+        for (int j = 0; j < numColumns; j++) {
+            double sum = 0.0;
+            for (int i = 0; i < globalResidualSize; i++)
+                sum += Q[j][i] * globalResidual[i];
+            alpha[j] = -sum;
+        }
+        for (int j = numColumns - 1; j >= 0; j--) {
+            for (int k = j + 1; k < numColumns; k++)
+                alpha[j] -= R[j * numColumns + k] * alpha[k];
+            alpha[j] /= R[j * numColumns + j];
+        }
+        // U_n+1 = U_n + R_n + W * alpha
+        for (int i = 0; i < globalResidualSize; i++)
+            newGlobalOutput[i] = globalSolverResult[i];
+        for (int j = 0; j < numColumns; j++)
+            for (int i = 0; i < globalResidualSize; i++)
+                newGlobalOutput[i] += W[j][i] * alpha[j];
+    }
+    stringstream toOutput;
+    toOutput << "IQN-ILS: least-squares model of " << numColumns << " column(s)";
+    INDENT_OUT(1, toOutput.str(), infoOut);
+
+    /// apply the new output
+    offset = 0;
+    for (map<int, Residual*>::iterator it = residuals.begin(); it != residuals.end(); it++) {
+        CouplingAlgorithmOutput *output = outputs.find(it->first)->second;
+        output->overwrite(&newGlobalOutput[offset]);
+        offset += output->size;
+    }
+
+    /// save old values
+    globalResidualOld = globalResidual;
+    globalSolverResultOld = globalSolverResult;
+    hasOldIteration = true;
+}
+
+void IQNILS::computeFilteredQR(vector<vector<double> > &Q, vector<double> &R) {
+    Q.clear();
+    vector<vector<double> > RColumns;
+    int j = 0;
+    while (j < (int) V.size()) {
+        vector<double> q = V[j];
+        vector<double> r(Q.size() + 1);
+        double normColumn = 0.0;
+        for (int i = 0; i < globalResidualSize; i++)
+            normColumn += q[i] * q[i];
+        normColumn = sqrt(normColumn);
+        for (int k = 0; k < (int) Q.size(); k++) {
+            double dot = 0.0;
+            for (int i = 0; i < globalResidualSize; i++)
+                dot += Q[k][i] * q[i];
+            r[k] = dot;
+            for (int i = 0; i < globalResidualSize; i++)
+                q[i] -= dot * Q[k][i];
+        }
+        double normOrthogonal = 0.0;
+        for (int i = 0; i < globalResidualSize; i++)
+            normOrthogonal += q[i] * q[i];
+        normOrthogonal = sqrt(normOrthogonal);
+        if (normOrthogonal <= FILTER_TOLERANCE * normColumn || normOrthogonal == 0.0) {
+            V.erase(V.begin() + j);
+            W.erase(W.begin() + j);
+            columnTimeSteps.erase(columnTimeSteps.begin() + j);
+            continue;
+        }
+        for (int i = 0; i < globalResidualSize; i++)
+            q[i] /= normOrthogonal;
+        r[Q.size()] = normOrthogonal;
+        Q.push_back(q);
+        RColumns.push_back(r);
+        j++;
+    }
+    int numColumns = Q.size();
+    R.assign(numColumns * numColumns, 0.0);
+    for (int k = 0; k < numColumns; k++)
+        for (int i = 0; i <= k; i++)
+            R[i * numColumns + k] = RColumns[k][i];
+}
+
+void IQNILS::writeCheckpoint(CheckpointArchive &archive) const {
+    AbstractCouplingAlgorithm::writeCheckpoint(archive);
+    archive.write(globalResidual);
+    archive.write(globalResidualOld);
+    archive.write(globalSolverResult);
+    archive.write(globalSolverResultOld);
+    archive.write(hasOldIteration);
+    archive.write(timeStepCounter);
+    archive.write(V);
+    archive.write(W);
+    for (unsigned i = 0; i < columnTimeSteps.size(); i++)
+        archive.write(columnTimeSteps[i]);
+}
+
+void IQNILS::readCheckpoint(CheckpointArchive &archive) {
+    AbstractCouplingAlgorithm::readCheckpoint(archive);
+    archive.read(&globalResidual[0], globalResidualSize);
+    archive.read(&globalResidualOld[0], globalResidualSize);
+    archive.read(&globalSolverResult[0], globalResidualSize);
+    archive.read(&globalSolverResultOld[0], globalResidualSize);
+    archive.read(hasOldIteration);
+    archive.read(timeStepCounter);
+    archive.read(V);
+    archive.read(W);
+    if (V.size() != W.size()) {
+        ERROR_OUT() << "IQNILS: the checkpoint of \"" << name << "\" has " << V.size()
+                << " residual differences but " << W.size() << " solver result differences" << endl;
+        exit(EXIT_FAILURE);
+    }
+    for (unsigned i = 0; i < V.size(); i++) {
+        if (V[i].size() != globalResidualSize || W[i].size() != globalResidualSize) {
+            ERROR_OUT() << "IQNILS: the differences in the checkpoint of \"" << name
+                    << "\" do not have the size of the global residual " << globalResidualSize
+                    << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+    columnTimeSteps.resize(V.size());
+    for (unsigned i = 0; i < columnTimeSteps.size(); i++)
+        archive.read(columnTimeSteps[i]);
+}
+
+} /* namespace EMPIRE */
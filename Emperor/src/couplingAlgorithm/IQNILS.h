@@ -0,0 +1,134 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file IQNILS.h
+ * This file holds the class IQNILS
+ * \date 10/14/2026
+ **************************************************************************************************/
+
+#ifndef IQNILS_H_
+#define IQNILS_H_
+
+#include "AbstractCouplingAlgorithm.h"
+#include <vector>
+#include <deque>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class IQNILS does the interface quasi-Newton iterations with an approximation of the
+ *        inverse Jacobian from a least-squares model (IQN-ILS). The model is built from the
+ *        differences of the residuals and of the solver results of the previous iterations, the
+ *        ones of the last time steps can be reused. Linearly dependent differences are removed by
+ *        filtering the QR decomposition.
+ ***********/
+class IQNILS: public AbstractCouplingAlgorithm {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _name the name of the coupling algorithm
+     * \param[in] _initRelaxationFactor the constant relaxation factor of the first iteration of a
+     *            time step without reused differences
+     * \param[in] _reuseTimeSteps the number of previous time steps whose differences are reused
+     * \param[in] _filterTolerance a difference is removed if the norm of its part orthogonal to the
+     *            newer differences is below _filterTolerance times its norm
+     ***********/
+    IQNILS(std::string _name, double _initRelaxationFactor, int _reuseTimeSteps,
+            double _filterTolerance);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~IQNILS();
+    /***********************************************************************************************
+     * \brief Calculate the new value of the output
+     ***********/
+    void calcNewValue();
+    /***********************************************************************************************
+     * \brief Calculate the current residual
+     ***********/
+    void calcCurrentResidual();
+    /***********************************************************************************************
+     * \brief Init the global vectors, must be called after the residuals and outputs are added
+     ***********/
+    void init();
+    /***********************************************************************************************
+     * \brief Get the number of differences the least-squares model consists of
+     * \return the number of columns of V and W
+     ***********/
+    int getNumColumns() const {
+        return V.size();
+    }
+    /***********************************************************************************************
+     * \brief Write the differences of the previous iterations and time steps in addition
+     * \param[in] archive the archive
+     ***********/
+    void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    void readCheckpoint(CheckpointArchive &archive);
+private:
+    /***********************************************************************************************
+     * \brief Remove the differences of time steps which are not reused anymore
+     ***********/
+    void startNewTimeStep();
+    /***********************************************************************************************
+     * \brief Compute the QR decomposition of V by modified Gram-Schmidt, starting from the newest
+     *        column. Columns which are almost linearly dependent on newer ones are removed from V
+     *        and W.
+     * \param[out] Q the orthonormal columns
+     * \param[out] R the upper triangular matrix stored row by row, size numColumns x numColumns
+     ***********/
+    void computeFilteredQR(std::vector<std::vector<double> > &Q, std::vector<double> &R);
+    /// constant relaxation factor of the first iteration
+    const double INIT_RELAXATION_FACTOR;
+    /// number of previous time steps whose differences are reused
+    const int REUSE_TIME_STEPS;
+    /// tolerance of the QR filter
+    const double FILTER_TOLERANCE;
+    /// size of global residual vector
+    int globalResidualSize;
+    /// current global residual vector
+    std::vector<double> globalResidual;
+    /// global residual vector of the previous iteration
+    std::vector<double> globalResidualOld;
+    /// current solver result, i.e. output at the iteration beginning plus residual
+    std::vector<double> globalSolverResult;
+    /// solver result of the previous iteration
+    std::vector<double> globalSolverResultOld;
+    /// workspace of the new global output, sized in init
+    std::vector<double> newGlobalOutput;
+    /// whether there is a previous iteration in the current time step
+    bool hasOldIteration;
+    /// counter of the time steps, used to tag the differences
+    int timeStepCounter;
+    /// differences of the residuals, the newest first
+    std::deque<std::vector<double> > V;
+    /// differences of the solver results, the newest first
+    std::deque<std::vector<double> > W;
+    /// time step counter at which each column of V and W was added
+    std::deque<int> columnTimeSteps;
+    /// friend class in unit test
+    friend class TestIQNILS;
+};
+
+} /* namespace EMPIRE */
+#endif /* IQNILS_H_ */
@@ -25,36 +25,37 @@
 #include "ConnectionIO.h"
 #include "DataField.h"
 #include "Signal.h"
+#include "MathLibrary.h"
+#include "CheckpointArchive.h"
 
 namespace EMPIRE {
 
 Residual::Component::Component(double _coefficient, std::string _timeToUpdate,
         ConnectionIO *_reference) :
-        coefficient(_coefficient), timeToUpdate(_timeToUpdate), reference(_reference) {
+        dataCopy(NULL), coefficient(_coefficient), timeToUpdate(_timeToUpdate), reference(
+                _reference) {
     if (reference->type == EMPIRE_ConnectionIO_DataField) {
         size = reference->dataField->dimension * reference->dataField->numLocations;
-        dataCopy = new double[size];
     } else if (reference->type == EMPIRE_ConnectionIO_Signal) {
         size = reference->signal->size;
-        dataCopy = new double[size];
     } else {
         assert(false);
     }
+    reference->getHistory(DataHistory::ITERATION)->reserve(1);
 }
 
 Residual::Component::~Component() {
-    delete[] dataCopy;
     delete reference;
 }
 
-void Residual::Component::updateAtIterationBeginning() {
+void Residual::Component::updateAtIterationBeginning(long long tag) {
     if (timeToUpdate == "iterationBeginning") {
         if (reference->type == EMPIRE_ConnectionIO_DataField) {
-            for (int i = 0; i < size; i++)
-                dataCopy[i] = reference->dataField->data[i];
+            dataCopy = reference->getHistory(DataHistory::ITERATION)->snapshot(
+                    reference->dataField->data, tag);
         } else if (reference->type == EMPIRE_ConnectionIO_Signal) {
-            for (int i = 0; i < size; i++)
-                dataCopy[i] = reference->signal->array[i];
+            dataCopy = reference->getHistory(DataHistory::ITERATION)->snapshot(
+                    reference->signal->array, tag);
         } else {
             assert(false);
         }
@@ -63,14 +64,14 @@ void Residual::Component::updateAtIterationBeginning() {
     }
 }
 
-void Residual::Component::updateAtIterationEnd() {
+void Residual::Component::updateAtIterationEnd(long long tag) {
     if (timeToUpdate == "iterationEnd") {
         if (reference->type == EMPIRE_ConnectionIO_DataField) {
-            for (int i = 0; i < size; i++)
-                dataCopy[i] = reference->dataField->data[i];
+            dataCopy = reference->getHistory(DataHistory::ITERATION)->snapshot(
+                    reference->dataField->data, tag);
         } else if (reference->type == EMPIRE_ConnectionIO_Signal) {
-            for (int i = 0; i < size; i++)
-                dataCopy[i] = reference->signal->array[i];
+            dataCopy = reference->getHistory(DataHistory::ITERATION)->snapshot(
+                    reference->signal->array, tag);
         } else {
             assert(false);
         }
@@ -79,6 +80,11 @@ void Residual::Component::updateAtIterationEnd() {
     }
 }
 
+void Residual::Component::restore(const double *data) {
+    dataCopy = reference->getHistory(DataHistory::ITERATION)->snapshot(data,
+            DataHistory::newTag());
+}
+
 Residual::Residual(int _index) :
         index(_index) {
     size = 0;
@@ -101,14 +107,22 @@ void Residual::init() {
 }
 
 void Residual::updateAtIterationBeginning() {
+    updateAtIterationBeginning(DataHistory::newTag());
+}
+
+void Residual::updateAtIterationBeginning(long long tag) {
     for (int i = 0; i < components.size(); i++) {
-        components[i]->updateAtIterationBeginning();
+        components[i]->updateAtIterationBeginning(tag);
     }
-
 }
+
 void Residual::updateAtIterationEnd() {
+    updateAtIterationEnd(DataHistory::newTag());
+}
+
+void Residual::updateAtIterationEnd(long long tag) {
     for (int i = 0; i < components.size(); i++) {
-        components[i]->updateAtIterationEnd();
+        components[i]->updateAtIterationEnd(tag);
     }
 }
 
@@ -118,21 +132,42 @@ void Residual::addComponent(double _coefficient, std::string _timeToUpdate,
 }
 
 void Residual::computeCurrentResidual() {
-    // compute the residual vector
-    for (int i=0; i<size; i++)
-        residualVector[i] = 0.0;
+    // compute the residual vector and its L2 norm in one pass
+    std::vector<const double*> vecs(components.size());
+    std::vector<double> coefficients(components.size());
     for (int i = 0; i < components.size(); i++) {
-        for (int j=0; j<size; j++) {
-            residualVector[j] += components[i]->dataCopy[j] * components[i]->coefficient;
-        }
-    }
-    // compute the L2 norm of the residual vector
-    residualVectorL2Norm = 0.0;
-    for (int i = 0; i < size; i++) {
-        residualVectorL2Norm += residualVector[i] * residualVector[i];
+        vecs[i] = components[i]->dataCopy;
+        coefficients[i] = components[i]->coefficient;
     }
+    residualVectorL2Norm = MathLibrary::computeReproducibleLinearCombination(residualVector,
+            components.size(), &vecs[0], &coefficients[0], size);
     residualVectorL2Norm /= size;
     residualVectorL2Norm = sqrt(residualVectorL2Norm);
 }
 
+void Residual::writeCheckpoint(CheckpointArchive &archive) const {
+    archive.write(residualVector, size);
+    archive.write(residualVectorL2Norm);
+    for (int i = 0; i < components.size(); i++) {
+        archive.write(components[i]->dataCopy != NULL);
+        if (components[i]->dataCopy != NULL)
+            archive.write(components[i]->dataCopy, components[i]->size);
+    }
+}
+
+void Residual::readCheckpoint(CheckpointArchive &archive) {
+    archive.read(residualVector, size);
+    archive.read(residualVectorL2Norm);
+    std::vector<double> dataCopy;
+    for (int i = 0; i < components.size(); i++) {
+        bool hasCopy;
+        archive.read(hasCopy);
+        if (hasCopy) {
+            dataCopy.resize(components[i]->size);
+            archive.read(&dataCopy[0], dataCopy.size());
+            components[i]->restore(&dataCopy[0]);
+        }
+    }
+}
+
 } /* namespace EMPIRE */
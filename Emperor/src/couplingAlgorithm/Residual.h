@@ -32,6 +32,7 @@
 namespace EMPIRE {
 
 class ConnectionIO;
+class CheckpointArchive;
 /********//**
  * \brief Class Residual is the residual in the coupling algorithm
  ***********/
@@ -66,16 +67,37 @@ public:
      * \author Tianyang Wang
      ***********/
     void updateAtIterationBeginning();
+    /***********************************************************************************************
+     * \brief Update components at the iteration beginning by the snapshots with the given tag,
+     *        which are shared with the other consumers of the iteration history
+     * \param[in] tag the tag of the snapshots
+     ***********/
+    void updateAtIterationBeginning(long long tag);
     /***********************************************************************************************
      * \brief Update components at the iteration end
      * \author Tianyang Wang
      ***********/
     void updateAtIterationEnd();
+    /***********************************************************************************************
+     * \brief Update components at the iteration end by the snapshots with the given tag
+     * \param[in] tag the tag of the snapshots
+     ***********/
+    void updateAtIterationEnd(long long tag);
     /***********************************************************************************************
      * \brief Compute the current residual (both residualVector and residualVectorL2Norm)
      * \author Tianyang Wang
      ***********/
     void computeCurrentResidual();
+    /***********************************************************************************************
+     * \brief Write the residual vector and the copies of the components
+     * \param[in] archive the archive
+     ***********/
+    void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    void readCheckpoint(CheckpointArchive &archive);
     /// size of the array residualVector
     int size;
     /// the residual vector
@@ -105,16 +127,24 @@ private:
         virtual ~Component();
         /***********************************************************************************************
          * \brief Update itself at the iteration beginning
+         * \param[in] tag the tag of the snapshot
          * \author Tianyang Wang
          ***********/
-        void updateAtIterationBeginning();
+        void updateAtIterationBeginning(long long tag);
         /***********************************************************************************************
          * \brief Update itself at the iteration end
+         * \param[in] tag the tag of the snapshot
          * \author Tianyang Wang
          ***********/
-        void updateAtIterationEnd();
-        /// copy of the array in the reference
-        double *dataCopy;
+        void updateAtIterationEnd(long long tag);
+        /***********************************************************************************************
+         * \brief Restore the copy from the given data
+         * \param[in] data the data, size values
+         ***********/
+        void restore(const double *data);
+        /// copy of the array in the reference, a snapshot in its iteration history, NULL before
+        /// the first update
+        const double *dataCopy;
         /// size of the array
         int size;
         /// the coefficient of itself in the residual
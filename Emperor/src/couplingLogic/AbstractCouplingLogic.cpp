@@ -21,6 +21,7 @@
 #include "AbstractCouplingLogic.h"
 #include "Connection.h"
 #include "DataOutput.h"
+#include "Message.h"
 
 namespace EMPIRE {
 
@@ -35,6 +36,7 @@ AbstractCouplingLogic::~AbstractCouplingLogic() {
 
 void AbstractCouplingLogic::addCouplingLogic(AbstractCouplingLogic *couplingLogic) {
     couplingLogicSequence.push_back(couplingLogic);
+    couplingLogicBatches.clear();
 }
 
 int AbstractCouplingLogic::size() {
@@ -45,5 +47,46 @@ void AbstractCouplingLogic::addDataOutput(DataOutput *dataOutput) {
     dataOutputVec.push_back(dataOutput);
 }
 
+void AbstractCouplingLogic::setTimeStep(int timeStep) {
+    for (int i = 0; i < couplingLogicSequence.size(); i++)
+        couplingLogicSequence[i]->setTimeStep(timeStep);
+}
+
+void AbstractCouplingLogic::doCouplingLogicSequence() {
+    if (couplingLogicBatches.empty())
+        computeCouplingLogicBatches();
+    for (int i = 0; i < couplingLogicBatches.size(); i++) {
+        if (couplingLogicBatches[i].size() == 1) {
+            couplingLogicBatches[i][0]->doCoupling();
+        } else {
+            vector<Connection*> connections;
+            for (int j = 0; j < couplingLogicBatches[i].size(); j++)
+                connections.push_back(dynamic_cast<Connection*>(couplingLogicBatches[i][j]));
+            Connection::exchangeConcurrently(connections);
+        }
+    }
+}
+
+void AbstractCouplingLogic::computeCouplingLogicBatches() {
+    couplingLogicBatches.clear();
+    bool isBatchOfConnections = false;
+    for (int i = 0; i < couplingLogicSequence.size(); i++) {
+        Connection *connection = dynamic_cast<Connection*>(couplingLogicSequence[i]);
+        bool isIndependent = connection != NULL && isBatchOfConnections;
+        for (int j = 0; isIndependent && j < couplingLogicBatches.back().size(); j++)
+            if (connection->dependsOn(dynamic_cast<Connection*>(couplingLogicBatches.back()[j])))
+                isIndependent = false;
+        if (isIndependent) {
+            couplingLogicBatches.back().push_back(connection);
+        } else {
+            couplingLogicBatches.push_back(vector<AbstractCouplingLogic*>(1, couplingLogicSequence[i]));
+            isBatchOfConnections = connection != NULL;
+        }
+    }
+    if (couplingLogicBatches.size() < couplingLogicSequence.size())
+        INFO_OUT() << couplingLogicSequence.size() << " coupling logics are run in " << couplingLogicBatches.size()
+                << " batches of independent connections" << endl;
+}
+
 
 } /* namespace EMPIRE */
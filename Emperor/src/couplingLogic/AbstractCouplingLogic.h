@@ -63,15 +63,39 @@ public:
      * \author Tianyang Wang
      ***********/
     int size();
+    /***********************************************************************************************
+     * \brief Get the coupling logics of couplingLogicSequence
+     ***********/
+    const std::vector<AbstractCouplingLogic*> &getCouplingLogicSequence() const {
+        return couplingLogicSequence;
+    }
     /***********************************************************************************************
      * \brief Add a dataOutput which will write data of current iteration
      * \param[in] dataOutput the data output writer
      * \author Tianyang Wang
      ***********/
     void addDataOutput(DataOutput *dataOutput);
+    /***********************************************************************************************
+     * \brief Set the time step of the enclosing time step loop in all coupling logics of
+     *        couplingLogicSequence
+     * \param[in] timeStep the time step, starting from 1
+     ***********/
+    virtual void setTimeStep(int timeStep);
 protected:
+    /***********************************************************************************************
+     * \brief Do the coupling of all coupling logics in couplingLogicSequence. Consecutive connections
+     *        which do not depend on each other are transferred concurrently.
+     ***********/
+    void doCouplingLogicSequence();
+    /***********************************************************************************************
+     * \brief Split couplingLogicSequence into batches of consecutive connections which do not depend
+     *        on each other. Any other coupling logic is a batch on its own.
+     ***********/
+    void computeCouplingLogicBatches();
     /// a sequence of coupling logics
     std::vector<AbstractCouplingLogic*> couplingLogicSequence;
+    /// couplingLogicSequence split into batches which can run concurrently, empty if not computed yet
+    std::vector<std::vector<AbstractCouplingLogic*> > couplingLogicBatches;
     /// dataOutputs
     std::vector<DataOutput*> dataOutputVec;
     /// the unit test class
@@ -21,19 +21,82 @@
 #include <iostream>
 #include <assert.h>
 #include <time.h>
+#include <algorithm>
+#include <omp.h>
+#include <math.h>
+#include <string.h>
 
 #include "Connection.h"
 #include "ClientCode.h"
 #include "DataField.h"
+#include "AbstractMesh.h"
+#include "FEMesh.h"
+#include "Signal.h"
 #include "AbstractFilter.h"
+#include "MappingFilter.h"
+#include "ChainedMappingFilter.h"
+#include "MapperAdapter.h"
+#include "ScalingFilter.h"
 #include "ConnectionIO.h"
+#include "ServerCommunication.h"
 #include "Message.h"
+#include "Profiler.h"
+#include "LiveMetrics.h"
 
 using namespace std;
 
 namespace EMPIRE {
+/***********************************************************************************************
+ * \brief Get the storage of the data field or the signal of an input/output, data fields aliased by
+ *        a copy filter share their storage and thus depend on each other
+ ***********/
+static const void *getDataOf(const ConnectionIO *io) {
+    if (io->type == EMPIRE_ConnectionIO_DataField)
+        return io->dataField->data;
+    if (io->type == EMPIRE_ConnectionIO_MeshCoordinates)
+        return io->mesh;
+    return io->signal;
+}
+
+/***********************************************************************************************
+ * \brief Get the values of the data field or the signal of an input/output
+ ***********/
+static void getValuesOf(const ConnectionIO *io, const double *&values, int &size) {
+    if (io->type == EMPIRE_ConnectionIO_DataField) {
+        values = io->dataField->data;
+        size = io->dataField->numLocations * io->dataField->dimension;
+    } else if (io->type == EMPIRE_ConnectionIO_MeshCoordinates) {
+        values = dynamic_cast<const FEMesh*>(io->mesh)->nodes;
+        size = dynamic_cast<const FEMesh*>(io->mesh)->numNodes * 3;
+    } else {
+        values = io->signal->array;
+        size = io->signal->size;
+    }
+}
+
+/***********************************************************************************************
+ * \brief Check whether values differ from a reference by more than the relative tolerance in the
+ *        2-norm, a tolerance of 0 compares them bitwise
+ ***********/
+static bool isChanged(const double *values, int size, const vector<double> &reference,
+        double tolerance) {
+    if (reference.size() != size)
+        return true;
+    if (tolerance == 0.0)
+        return size > 0 && memcmp(values, &reference[0], size * sizeof(double)) != 0;
+    double deltaSquare = 0.0;
+    double referenceSquare = 0.0;
+    for (int i = 0; i < size; i++) {
+        deltaSquare += (values[i] - reference[i]) * (values[i] - reference[i]);
+        referenceSquare += reference[i] * reference[i];
+    }
+    return sqrt(deltaSquare) > tolerance * sqrt(referenceSquare);
+}
+
 Connection::Connection(std::string _name) :
-        AbstractCouplingLogic(), name(_name), inputVec(), outputVec(), filterVec() {
+        AbstractCouplingLogic(), name(_name), inputVec(), outputVec(), filterVec(), filterPipeline(), chainedMappingFilters(), chainMappings(
+                false), isFilterPipelineCompiled(false), exchangeInterval(1), timeStep(0), bundleSignals(false), skipUnchangedInputs(false), changeTolerance(
+                0.0) {
 }
 
 Connection::~Connection() {
@@ -43,33 +106,261 @@ Connection::~Connection() {
         delete outputVec[i];
     for (int i = 0; i < filterVec.size(); i++)
         delete filterVec[i];
+    for (unsigned i = 0; i < chainedMappingFilters.size(); i++)
+        delete chainedMappingFilters[i];
 }
 
 void Connection::doCoupling() {
+    if (!isExchangeStep()) {
+        interpolateInTime();
+        return;
+    }
     transferData();
+    storeHistory();
+}
+
+void Connection::setExchangeInterval(int _exchangeInterval) {
+    assert(_exchangeInterval >= 1);
+    exchangeInterval = _exchangeInterval;
+}
+
+void Connection::setSignalBundling(bool _bundleSignals) {
+    bundleSignals = _bundleSignals;
+}
+
+void Connection::setChangeDetection(bool _skipUnchangedInputs, double _changeTolerance) {
+    assert(_changeTolerance >= 0.0);
+    skipUnchangedInputs = _skipUnchangedInputs;
+    changeTolerance = _changeTolerance;
+    inputSnapshots.clear();
+}
+
+void Connection::setMappingChaining(bool _chainMappings) {
+    chainMappings = _chainMappings;
+    isFilterPipelineCompiled = false;
+}
+
+void Connection::keepDataField(const DataField *dataField) {
+    keptDataFields.insert(dataField);
+    isFilterPipelineCompiled = false;
+}
+
+void Connection::setTimeStep(int _timeStep) {
+    timeStep = _timeStep;
+}
+
+bool Connection::isExchangeStep() const {
+    return exchangeInterval == 1 || timeStep < 1 || (timeStep - 1) % exchangeInterval == 0;
+}
+
+void Connection::storeHistory() {
+    if (exchangeInterval == 1 || timeStep < 1 || inputVec.empty())
+        return;
+    vector<DataField*> dataFields;
+    collectWrittenDataFields(dataFields);
+    // the data received now are those of the last time step before the next transfer
+    int exchangeStep = timeStep - (timeStep - 1) % exchangeInterval;
+    for (unsigned i = 0; i < dataFields.size(); i++) {
+        if (dataFields[i]->getHistoryLength() == 0)
+            dataFields[i]->setHistoryLength(2);
+        dataFields[i]->storeHistory(exchangeStep + exchangeInterval - 1);
+        dataFields[i]->interpolateHistory(timeStep);
+    }
+}
+
+void Connection::interpolateInTime() {
+    if (inputVec.empty())
+        return;
+    vector<DataField*> dataFields;
+    collectWrittenDataFields(dataFields);
+    for (unsigned i = 0; i < dataFields.size(); i++)
+        if (dataFields[i]->getHistoryLength() > 0)
+            dataFields[i]->interpolateHistory(timeStep);
 }
 
 void Connection::transferData() {
+    PROFILER_SCOPE(name);
+    compileFilterPipeline();
+    MappingFilter *pipelinedFilter = getPipelinedMappingFilter();
+    if (pipelinedFilter != NULL) {
+        transferDataPipelined(pipelinedFilter);
+        return;
+    }
     // Start time stamps
     time_t timeStart, timeEnd;
     stringstream timeMessage;
 
-
-    for (unsigned i = 0; i < inputVec.size(); i++)
-        inputVec[i]->receive();
+    // Post the receives of all inputs at once, so that the transfers from all clients overlap
+    vector<ConnectionIO*> pendingInputs;
+    vector<int> pendingRequests;
+    for (unsigned i = 0; i < inputVec.size(); i++) {
+        int request = startReceiveInput(inputVec[i]);
+        if (request >= 0) {
+            pendingInputs.push_back(inputVec[i]);
+            pendingRequests.push_back(request);
+        }
+    }
     time(&timeStart);
-    for (unsigned i = 0; i < filterVec.size(); i++){
-        filterVec[i]->filtering();
+    compileFilterPipeline();
+    bool isFiltered = true;
+    if (skipUnchangedInputs) { // all inputs have to be compared before any filter runs
+        for (unsigned i = 0; i < pendingInputs.size(); i++)
+            pendingInputs[i]->finishReceive();
+        pendingInputs.clear();
+        pendingRequests.clear();
+        isFiltered = hasInputChanged();
     }
+    for (unsigned i = 0; i < filterPipeline.size() && isFiltered; i++){
+        // Run the stage as soon as its inputs have arrived, whichever input arrives first is completed
+        while (true) {
+            bool isInputPending = false;
+            for (unsigned j = 0; j < pendingInputs.size(); j++)
+                if (stageHasInput(filterPipeline[i], pendingInputs[j]))
+                    isInputPending = true;
+            if (!isInputPending)
+                break;
+            static const string waitName("wait for inputs");
+            PROFILER_SCOPE(waitName);
+            int arrived = ServerCommunication::getSingleton()->waitForAnyRequest(pendingRequests);
+            pendingInputs[arrived]->finishReceive();
+            pendingInputs.erase(pendingInputs.begin() + arrived);
+            pendingRequests.erase(pendingRequests.begin() + arrived);
+        }
+        runFilterStage(filterPipeline[i]);
+    }
+    for (unsigned i = 0; i < pendingInputs.size(); i++)
+        pendingInputs[i]->finishReceive();
     time(&timeEnd);
     timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for filtering";
     INDENT_OUT(1, timeMessage.str(), infoOut);
     timeMessage.str("");
+    static const string sendName("send outputs");
+    PROFILER_SCOPE(sendName);
+    vector<ConnectionIO*> pendingOutputs;
     for (unsigned i = 0; i < outputVec.size(); i++){
-        outputVec[i]->send();
+        if (startSendOutput(outputVec[i]) >= 0)
+            pendingOutputs.push_back(outputVec[i]);
+    }
+    for (unsigned i = 0; i < pendingOutputs.size(); i++){
+        pendingOutputs[i]->finishSend();
     }
 }
 
+MappingFilter *Connection::getPipelinedMappingFilter() const {
+    // the inputs are compared before the filters run, so they cannot be mapped while they arrive
+    if (inputVec.size() != 1 || outputVec.size() != 1 || filterPipeline.size() != 1
+            || filterPipeline[0].filters.size() != 1 || skipUnchangedInputs)
+        return NULL;
+    const ConnectionIO *input = inputVec[0];
+    const ConnectionIO *output = outputVec[0];
+    if (input->type != EMPIRE_ConnectionIO_DataField
+            || output->type != EMPIRE_ConnectionIO_DataField)
+        return NULL;
+    MappingFilter *filter = dynamic_cast<MappingFilter*>(filterPipeline[0].filters[0]);
+    if (filter == NULL || !filter->hasInput(input) || !filter->isRowBlockFilteringSupported())
+        return NULL;
+    const vector<ConnectionIO*> &filterOutputs = filter->getOutputs();
+    if (filterOutputs.size() != 1 || filterOutputs[0]->dataField != output->dataField)
+        return NULL;
+    if (!input->clientCode->isDataFieldPipelined(input->mesh->name, input->dataField->name)
+            || !output->clientCode->isDataFieldPipelined(output->mesh->name,
+                    output->dataField->name))
+        return NULL;
+    return filter;
+}
+
+void Connection::transferDataPipelined(MappingFilter *filter) {
+    ConnectionIO *input = inputVec[0];
+    ConnectionIO *output = outputVec[0];
+    const string &inMeshName = input->mesh->name;
+    const string &inDataFieldName = input->dataField->name;
+    const string &outMeshName = output->mesh->name;
+    const string &outDataFieldName = output->dataField->name;
+    int inChunkSize = input->clientCode->getDataFieldChunkSize(inMeshName, inDataFieldName);
+    int outChunkSize = output->clientCode->getDataFieldChunkSize(outMeshName, outDataFieldName);
+    int dimension = output->dataField->dimension;
+    assert(input->dataField->dimension == dimension);
+    int outSize = output->dataField->numLocations * dimension;
+    int numOutChunks = (outSize + outChunkSize - 1) / outChunkSize;
+
+    time_t timeStart, timeEnd;
+    stringstream timeMessage;
+    input->startReceive();
+    output->clientCode->startPipelinedSendDataField(outMeshName, outDataFieldName);
+    time(&timeStart);
+    int numMappedNodes = 0;
+    for (int k = 0; k < numOutChunks; k++) {
+        // the nodes having an entry in the chunk, the first one may be mapped with the last chunk
+        int endNode = (min((k + 1) * outChunkSize, outSize) + dimension - 1) / dimension;
+        if (endNode > numMappedNodes) {
+            int numRequiredEntries = filter->getNumRequiredInputNodes(endNode) * dimension;
+            {
+                static const string waitName("wait for inputs");
+                PROFILER_SCOPE(waitName);
+                input->clientCode->waitForDataFieldChunks(inMeshName, inDataFieldName,
+                        (numRequiredEntries + inChunkSize - 1) / inChunkSize);
+            }
+            PROFILER_SCOPE(filterPipeline[0].name);
+            double startTime = LiveMetrics::isEnabled() ? omp_get_wtime() : 0.0;
+            filter->filterRowBlock(numMappedNodes, endNode);
+            numMappedNodes = endNode;
+            if (LiveMetrics::isEnabled())
+                LiveMetrics::add(LiveMetrics::CONNECTION_FILTER_SECONDS,
+                        LiveMetrics::label("connection", name), omp_get_wtime() - startTime);
+        }
+        output->clientCode->sendDataFieldChunks(outMeshName, outDataFieldName, k + 1);
+    }
+    input->finishReceive();
+    time(&timeEnd);
+    timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for filtering in "
+            << numOutChunks << " chunks";
+    INDENT_OUT(1, timeMessage.str(), infoOut);
+    static const string sendName("send outputs");
+    PROFILER_SCOPE(sendName);
+    output->finishSend();
+}
+
+void Connection::filterAndStartSend() {
+    assert(pendingInputVec.empty());
+    filter();
+    startSend();
+}
+
+void Connection::filter() {
+    PROFILER_SCOPE(name);
+    compileFilterPipeline();
+    if (!hasInputChanged())
+        return;
+    for (unsigned i = 0; i < filterPipeline.size(); i++)
+        runFilterStage(filterPipeline[i]);
+}
+
+void Connection::startSend() {
+    assert(pendingOutputVec.empty());
+    for (unsigned i = 0; i < outputVec.size(); i++)
+        if (startSendOutput(outputVec[i]) >= 0)
+            pendingOutputVec.push_back(outputVec[i]);
+}
+
+void Connection::finishSend() {
+    for (unsigned i = 0; i < pendingOutputVec.size(); i++)
+        pendingOutputVec[i]->finishSend();
+    pendingOutputVec.clear();
+}
+
+void Connection::startReceive() {
+    assert(pendingInputVec.empty());
+    for (unsigned i = 0; i < inputVec.size(); i++)
+        if (startReceiveInput(inputVec[i]) >= 0)
+            pendingInputVec.push_back(inputVec[i]);
+}
+
+void Connection::finishReceive() {
+    for (unsigned i = 0; i < pendingInputVec.size(); i++)
+        pendingInputVec[i]->finishReceive();
+    pendingInputVec.clear();
+}
+
 void Connection::addInput(ConnectionIO *input) {
     assert(input!=NULL);
     inputVec.push_back(input);
@@ -83,6 +374,334 @@ void Connection::addOutput(ConnectionIO *output) {
 void Connection::addFilter(AbstractFilter *filter) {
     assert(filter!=NULL);
     filterVec.push_back(filter);
+    isFilterPipelineCompiled = false;
+}
+
+void Connection::compileFilterPipeline() {
+    if (isFilterPipelineCompiled)
+        return;
+    filterPipeline.clear();
+    for (unsigned i = 0; i < chainedMappingFilters.size(); i++)
+        delete chainedMappingFilters[i];
+    chainedMappingFilters.clear();
+    set<const AbstractFilter*> composedFilters;
+    for (unsigned i = 0; i < filterVec.size(); i++) {
+        AbstractFilter *filter = filterVec[i];
+        // Fold the scaling filters right after a mapping filter into the mapper output
+        MappingFilter *mappingFilter = dynamic_cast<MappingFilter*>(filter);
+        if (mappingFilter != NULL) {
+            composedFilters.insert(mappingFilter);
+            double outputFactor = 1.0;
+            while (i + 1 < filterVec.size()) {
+                ScalingFilter *scalingFilter = dynamic_cast<ScalingFilter*>(filterVec[i + 1]);
+                if (scalingFilter == NULL || !mappingFilter->canFoldScaling(scalingFilter))
+                    break;
+                outputFactor *= scalingFilter->getFactor();
+                composedFilters.insert(scalingFilter);
+                i++;
+            }
+            mappingFilter->setOutputFactor(outputFactor);
+            if (chainMappings && !filterPipeline.empty()
+                    && chainMapping(filterPipeline.back(), mappingFilter, composedFilters))
+                continue;
+        }
+        // Fuse the elementwise filters over the same number of entries
+        if (filter->isElementwise() && !filterPipeline.empty() && filterPipeline.back().isFused
+                && filterPipeline.back().filters[0]->getNumEntries() == filter->getNumEntries()) {
+            filterPipeline.back().filters.push_back(filter);
+            continue;
+        }
+        FilterStage stage;
+        stage.filters.push_back(filter);
+        stage.isFused = filter->isElementwise();
+        stage.isChained = false;
+        filterPipeline.push_back(stage);
+    }
+    // Name the stages by the position of their filters in the filter sequence
+    int firstFilter = 1;
+    for (unsigned i = 0; i < filterPipeline.size(); i++) {
+        stringstream stageName;
+        int numFilters = filterPipeline[i].filters.size();
+        if (filterPipeline[i].isChained)
+            numFilters = dynamic_cast<ChainedMappingFilter*>(filterPipeline[i].filters[0])->getNumMappings();
+        if (numFilters == 1)
+            stageName << "filter " << firstFilter;
+        else
+            stageName << "filters " << firstFilter << "-" << firstFilter + numFilters - 1;
+        if (filterPipeline[i].isFused)
+            stageName << " (fused)";
+        if (filterPipeline[i].isChained)
+            stageName << " (chained)";
+        filterPipeline[i].name = stageName.str();
+        firstFilter += numFilters;
+    }
+    isFilterPipelineCompiled = true;
+}
+
+bool Connection::chainMapping(FilterStage &stage, MappingFilter *filter,
+        const std::set<const AbstractFilter*> &composedFilters) {
+    if (stage.isFused || stage.filters.size() != 1 || !filter->isExplicitOperatorSupported())
+        return false;
+    MappingFilter *previous = dynamic_cast<MappingFilter*>(stage.filters[0]);
+    ChainedMappingFilter *chainedFilter = NULL;
+    if (stage.isChained)
+        chainedFilter = dynamic_cast<ChainedMappingFilter*>(stage.filters[0]);
+    else if (previous == NULL || !previous->isExplicitOperatorSupported())
+        return false;
+    const ConnectionIO *between = stage.filters[0]->getOutputs()[0];
+    if (!filter->hasInput(between))
+        return false;
+    // the data field between the mappings is not written anymore
+    const void *betweenData = getDataOf(between);
+    for (unsigned i = 0; i < outputVec.size(); i++)
+        if (getDataOf(outputVec[i]) == betweenData)
+            return false;
+    for (set<const DataField*>::const_iterator it = keptDataFields.begin();
+            it != keptDataFields.end(); it++)
+        if ((*it)->data == betweenData)
+            return false;
+    for (unsigned i = 0; i < filterVec.size(); i++)
+        if (composedFilters.find(filterVec[i]) == composedFilters.end()
+                && filterVec[i]->hasInput(between))
+            return false;
+
+    bool isNew = chainedFilter == NULL;
+    if (isNew)
+        chainedFilter = new ChainedMappingFilter(previous);
+    if (!chainedFilter->chain(filter)) {
+        if (isNew)
+            delete chainedFilter;
+        INDENT_OUT(1, "Connection " + name + " does not chain a mapping, the composed operator "
+                "would have more entries than the operators in series", infoOut);
+        return false;
+    }
+    chainedFilter->init();
+    if (isNew) {
+        chainedMappingFilters.push_back(chainedFilter);
+        stage.filters[0] = chainedFilter;
+        stage.isChained = true;
+    }
+    return true;
+}
+
+void Connection::runFilterStage(const FilterStage &stage) {
+    PROFILER_SCOPE(stage.name);
+    double startTime = LiveMetrics::isEnabled() ? omp_get_wtime() : 0.0;
+    if (!stage.isFused || stage.filters.size() == 1) {
+        for (unsigned i = 0; i < stage.filters.size(); i++)
+            stage.filters[i]->filtering();
+    } else {
+        // Pass each block of entries through all filters while it is in cache
+        int numEntries = stage.filters[0]->getNumEntries();
+        for (int begin = 0; begin < numEntries; begin += FUSED_BLOCK_SIZE) {
+            int end = std::min(begin + FUSED_BLOCK_SIZE, numEntries);
+            for (unsigned i = 0; i < stage.filters.size(); i++)
+                stage.filters[i]->filterEntries(begin, end);
+        }
+    }
+    if (LiveMetrics::isEnabled())
+        LiveMetrics::add(LiveMetrics::CONNECTION_FILTER_SECONDS,
+                LiveMetrics::label("connection", name), omp_get_wtime() - startTime);
+}
+
+bool Connection::dependsOn(const Connection *earlier) const {
+    set<const void*> readData, writtenData, mappers;
+    set<const ClientCode*> sendClients, receiveClients;
+    collectDependencies(readData, writtenData, sendClients, receiveClients, mappers);
+    set<const void*> earlierReadData, earlierWrittenData, earlierMappers;
+    set<const ClientCode*> earlierSendClients, earlierReceiveClients;
+    earlier->collectDependencies(earlierReadData, earlierWrittenData, earlierSendClients, earlierReceiveClients,
+            earlierMappers);
+    for (set<const void*>::iterator it = earlierWrittenData.begin(); it != earlierWrittenData.end(); it++)
+        if (readData.count(*it) > 0 || writtenData.count(*it) > 0)
+            return true;
+    for (set<const void*>::iterator it = earlierReadData.begin(); it != earlierReadData.end(); it++)
+        if (writtenData.count(*it) > 0)
+            return true;
+    // the answer of a client may depend on what the earlier connection sends to it
+    for (set<const ClientCode*>::iterator it = earlierSendClients.begin(); it != earlierSendClients.end(); it++)
+        if (receiveClients.count(*it) > 0)
+            return true;
+    for (set<const void*>::iterator it = earlierMappers.begin(); it != earlierMappers.end(); it++)
+        if (mappers.count(*it) > 0)
+            return true;
+    return false;
+}
+
+void Connection::exchangeConcurrently(const std::vector<Connection*> &connections) {
+    vector<Connection*> exchangingConnections;
+    for (unsigned i = 0; i < connections.size(); i++) {
+        if (connections[i]->isExchangeStep())
+            exchangingConnections.push_back(connections[i]);
+        else
+            connections[i]->interpolateInTime();
+    }
+    if (exchangingConnections.size() == 1) {
+        exchangingConnections[0]->transferData();
+    } else if (exchangingConnections.size() > 1) {
+        transferDataConcurrently(exchangingConnections);
+    }
+    for (unsigned i = 0; i < exchangingConnections.size(); i++)
+        exchangingConnections[i]->storeHistory();
+}
+
+void Connection::transferDataConcurrently(const std::vector<Connection*> &connections) {
+    // Receive in the order of the connections
+    for (unsigned i = 0; i < connections.size(); i++)
+        connections[i]->startReceive();
+    for (unsigned i = 0; i < connections.size(); i++)
+        connections[i]->finishReceive();
+    time_t timeStart, timeEnd;
+    time(&timeStart);
+    filterConcurrently(connections);
+    time(&timeEnd);
+    stringstream timeMessage;
+    timeMessage << "It took " << difftime(timeEnd, timeStart) << " seconds for filtering " << connections.size()
+            << " connections concurrently";
+    INDENT_OUT(1, timeMessage.str(), infoOut);
+    // Send in the order of the connections
+    for (unsigned i = 0; i < connections.size(); i++)
+        connections[i]->startSend();
+    for (unsigned i = 0; i < connections.size(); i++)
+        connections[i]->finishSend();
+}
+
+void Connection::filterConcurrently(const std::vector<Connection*> &connections) {
+    if (connections.size() == 1) {
+        connections[0]->filter();
+        return;
+    }
+    // The parallel regions of the mappers are nested in this one
+#pragma omp parallel for num_threads(connections.size()) schedule(dynamic, 1)
+    for (int i = 0; i < (int) connections.size(); i++)
+        connections[i]->filter();
+}
+
+void Connection::collectDependencies(std::set<const void*> &readData, std::set<const void*> &writtenData,
+        std::set<const ClientCode*> &sendClients, std::set<const ClientCode*> &receiveClients,
+        std::set<const void*> &mappers) const {
+    for (unsigned i = 0; i < inputVec.size(); i++) {
+        writtenData.insert(getDataOf(inputVec[i]));
+        receiveClients.insert(inputVec[i]->clientCode);
+    }
+    for (unsigned i = 0; i < outputVec.size(); i++) {
+        readData.insert(getDataOf(outputVec[i]));
+        sendClients.insert(outputVec[i]->clientCode);
+    }
+    for (unsigned i = 0; i < filterVec.size(); i++) {
+        const vector<ConnectionIO*> &filterInputs = filterVec[i]->getInputs();
+        for (unsigned j = 0; j < filterInputs.size(); j++)
+            readData.insert(getDataOf(filterInputs[j]));
+        const vector<ConnectionIO*> &filterOutputs = filterVec[i]->getOutputs();
+        for (unsigned j = 0; j < filterOutputs.size(); j++)
+            writtenData.insert(getDataOf(filterOutputs[j]));
+        const MappingFilter *mappingFilter = dynamic_cast<const MappingFilter*>(filterVec[i]);
+        if (mappingFilter != NULL) {
+            mappers.insert(mappingFilter->getMapper());
+            // the mapper reads the nodes which a connection may receive
+            readData.insert(mappingFilter->getMapper()->getMeshA());
+            readData.insert(mappingFilter->getMapper()->getMeshB());
+        }
+    }
+}
+
+void Connection::collectWrittenDataFields(std::vector<DataField*> &dataFields) const {
+    vector<ConnectionIO*> writtenIOs(inputVec);
+    for (unsigned i = 0; i < filterVec.size(); i++) {
+        const vector<ConnectionIO*> &filterOutputs = filterVec[i]->getOutputs();
+        writtenIOs.insert(writtenIOs.end(), filterOutputs.begin(), filterOutputs.end());
+    }
+    set<const double*> storages;
+    for (unsigned i = 0; i < writtenIOs.size(); i++) {
+        if (writtenIOs[i]->type != EMPIRE_ConnectionIO_DataField)
+            continue;
+        if (storages.insert(writtenIOs[i]->dataField->data).second)
+            dataFields.push_back(writtenIOs[i]->dataField);
+    }
+}
+
+int Connection::startReceiveInput(ConnectionIO *input) {
+    if (!bundleSignals || input->type != EMPIRE_ConnectionIO_Signal)
+        return input->startReceive();
+    unsigned i = find(inputVec.begin(), inputVec.end(), input) - inputVec.begin();
+    vector<string> signalNames;
+    if (getSignalBundle(inputVec, i, signalNames))
+        input->clientCode->recvSignals(signalNames);
+    return -1;
+}
+
+int Connection::startSendOutput(ConnectionIO *output) {
+    if (!bundleSignals || output->type != EMPIRE_ConnectionIO_Signal)
+        return output->startSend();
+    unsigned i = find(outputVec.begin(), outputVec.end(), output) - outputVec.begin();
+    vector<string> signalNames;
+    if (getSignalBundle(outputVec, i, signalNames))
+        output->clientCode->sendSignals(signalNames);
+    return -1;
+}
+
+bool Connection::getSignalBundle(const std::vector<ConnectionIO*> &ios, unsigned i,
+        std::vector<std::string> &signalNames) {
+    assert(ios[i]->type == EMPIRE_ConnectionIO_Signal);
+    signalNames.clear();
+    bool isFirst = true;
+    for (unsigned j = 0; j < ios.size(); j++) {
+        if (ios[j]->type != EMPIRE_ConnectionIO_Signal || ios[j]->clientCode != ios[i]->clientCode)
+            continue;
+        if (j < i)
+            isFirst = false;
+        signalNames.push_back(ios[j]->signal->name);
+    }
+    return isFirst;
+}
+
+bool Connection::hasInputChanged() {
+    if (!skipUnchangedInputs || inputVec.empty())
+        return true;
+    bool hasChanged = inputSnapshots.empty();
+    if (hasChanged) {
+        // a filter writing into an input would leave the input filtered only at the first time
+        set<const void*> inputData;
+        for (unsigned i = 0; i < inputVec.size(); i++)
+            inputData.insert(getDataOf(inputVec[i]));
+        for (unsigned i = 0; i < filterVec.size(); i++) {
+            const vector<ConnectionIO*> &filterOutputs = filterVec[i]->getOutputs();
+            for (unsigned j = 0; j < filterOutputs.size(); j++)
+                if (inputData.find(getDataOf(filterOutputs[j])) != inputData.end()) {
+                    ERROR_OUT() << "Connection " << name
+                            << " cannot skip unchanged inputs, a filter writes into an input"
+                            << endl;
+                    exit(-1);
+                }
+        }
+        inputSnapshots.resize(inputVec.size());
+    }
+    for (unsigned i = 0; i < inputVec.size() && !hasChanged; i++) {
+        const double *values;
+        int size;
+        getValuesOf(inputVec[i], values, size);
+        hasChanged = isChanged(values, size, inputSnapshots[i], changeTolerance);
+    }
+    if (!hasChanged) {
+        INDENT_OUT(1, "Inputs of connection " + name + " are unchanged, the filters are skipped",
+                infoOut);
+        return false;
+    }
+    // the reference is the last filtering, so that small changes cannot add up unnoticed
+    for (unsigned i = 0; i < inputVec.size(); i++) {
+        const double *values;
+        int size;
+        getValuesOf(inputVec[i], values, size);
+        inputSnapshots[i].assign(values, values + size);
+    }
+    return true;
+}
+
+bool Connection::stageHasInput(const FilterStage &stage, const ConnectionIO *io) {
+    for (unsigned i = 0; i < stage.filters.size(); i++)
+        if (stage.filters[i]->hasInput(io))
+            return true;
+    return false;
 }
 
 } /* namespace EMPIRE */
@@ -29,18 +29,29 @@
 
 #include <string>
 #include <vector>
+#include <set>
 #include "AbstractCouplingLogic.h"
 #include "EMPEROR_Enum.h"
 
 namespace EMPIRE {
 
 class ClientCode;
+class DataField;
 class AbstractFilter;
 class AbstractExtrapolator;
 class ConnectionIO;
+class MappingFilter;
+class ChainedMappingFilter;
 
 /********//**
- * \brief Class Connection sends and receives data between two clients and does data processing
+ * \brief Class Connection sends and receives data between two clients and does data processing.
+ *        A connection with an exchange interval of n transfers only at every n-th time step of the
+ *        enclosing time step loop, starting from the first one, such that a slow client takes one
+ *        step per n steps of the others and its mapping runs only then. Such a connection may
+ *        only communicate with the slow client. The slow client is ahead, i.e. the data received
+ *        at time step k are those of time step k+n-1. The data fields written by the connection
+ *        are kept for the two latest transfers and interpolated linearly in time at every time
+ *        step, so that the connections of the fast clients read the data at their time step.
  ***********/
 class Connection: public AbstractCouplingLogic {
 public:
@@ -60,11 +71,100 @@ public:
      * \author Tianyang Wang
      ***********/
     void doCoupling();
+    /***********************************************************************************************
+     * \brief Set the number of time steps between two transfers
+     * \param[in] _exchangeInterval the number of time steps, 1 transfers at every time step
+     ***********/
+    void setExchangeInterval(int _exchangeInterval);
+    /***********************************************************************************************
+     * \brief Get the number of time steps between two transfers
+     ***********/
+    int getExchangeInterval() const {
+        return exchangeInterval;
+    }
+    /***********************************************************************************************
+     * \brief Transfer the signals of a client as one bundle (see ClientCode::recvSignals): all
+     *        signal inputs from a client are received at the position of the first one, and all
+     *        signal outputs to a client are sent at the position of the first one, in the order of
+     *        the inputs and outputs
+     * \param[in] _bundleSignals true to bundle the signals
+     ***********/
+    void setSignalBundling(bool _bundleSignals);
+    /***********************************************************************************************
+     * \brief Skip the filters while the inputs do not change. The inputs are compared with those
+     *        of the last filtering after they have been received, if none has changed by more than
+     *        the tolerance the outputs keep their values and are sent again. Not allowed with an
+     *        exchange interval, nor with filters writing into an input
+     * \param[in] _skipUnchangedInputs true to compare the inputs
+     * \param[in] _changeTolerance the relative change of the 2-norm of an input up to which it is
+     *            unchanged, 0 to skip only on bit-identical inputs
+     ***********/
+    void setChangeDetection(bool _skipUnchangedInputs, double _changeTolerance);
+    /***********************************************************************************************
+     * \brief Compose mapping filters in series whose mappers hand out explicit operators into one
+     *        operator when the filter pipeline is compiled, e.g. H_BC * H_AB for the mappings A->B
+     *        and B->C. The data field in between is then not written, so it is only composed if
+     *        neither another filter nor an output of the connection reads it, nor is it kept by
+     *        keepDataField
+     * \param[in] _chainMappings true to compose the mappings
+     ***********/
+    void setMappingChaining(bool _chainMappings);
+    /***********************************************************************************************
+     * \brief Keep a data field written by the filters of the connection up to date even if it lies
+     *        between chained mappings, because it is read outside of the connection (e.g. by a data
+     *        output, a coupling algorithm or another connection)
+     * \param[in] dataField the data field
+     ***********/
+    void keepDataField(const DataField *dataField);
+    /***********************************************************************************************
+     * \brief Set the time step of the enclosing time step loop
+     * \param[in] _timeStep the time step, starting from 1
+     ***********/
+    void setTimeStep(int _timeStep);
+    /***********************************************************************************************
+     * \brief Check whether the connection transfers at the current time step
+     ***********/
+    bool isExchangeStep() const;
+    /***********************************************************************************************
+     * \brief Store the data fields written by the transfer as the latest time level and interpolate
+     *        them to the current time step, does nothing if the connection transfers at every step
+     *        or has no inputs
+     ***********/
+    void storeHistory();
+    /***********************************************************************************************
+     * \brief Interpolate the data fields written by the connection to the current time step
+     ***********/
+    void interpolateInTime();
     /***********************************************************************************************
      * \brief Main job of this class, i.e. receive data field, filter it by a sequence of filters, and send it
      * \author Tianyang Wang
      ***********/
     void transferData();
+    /***********************************************************************************************
+     * \brief First phase of a Jacobi iteration, i.e. filter the data at hand (received in the
+     *        previous iteration) and post the sends of all outputs
+     ***********/
+    void filterAndStartSend();
+    /***********************************************************************************************
+     * \brief Run the filters on the data at hand
+     ***********/
+    void filter();
+    /***********************************************************************************************
+     * \brief Post the sends of all outputs
+     ***********/
+    void startSend();
+    /***********************************************************************************************
+     * \brief Complete the sends posted by startSend()
+     ***********/
+    void finishSend();
+    /***********************************************************************************************
+     * \brief Second phase of a Jacobi iteration, i.e. post the receives of all inputs
+     ***********/
+    void startReceive();
+    /***********************************************************************************************
+     * \brief Complete the receives posted by startReceive()
+     ***********/
+    void finishReceive();
 
     void addInput(ConnectionIO *input);
     void addOutput(ConnectionIO *output);
@@ -75,7 +175,144 @@ public:
      * \author Tianyang Wang
      ***********/
     void addFilter(AbstractFilter *filter);
+    /***********************************************************************************************
+     * \brief Get the filters in the order they are added
+     ***********/
+    const std::vector<AbstractFilter*> &getFilters() const {
+        return filterVec;
+    }
+    /***********************************************************************************************
+     * \brief Check whether this connection must run after an earlier connection of a sequence.
+     *        This is the case if one writes data the other reads or writes, if this connection
+     *        receives from a client the earlier one sends to, or if both use the same mapper.
+     * \param[in] earlier the connection before this one in the sequence
+     * \return true if the connections cannot run concurrently
+     ***********/
+    bool dependsOn(const Connection *earlier) const;
+    /***********************************************************************************************
+     * \brief Transfer the data of independent connections at once. All communication is done by
+     *        the calling thread in the order of the connections, so that the order of the messages
+     *        to every client is kept, and the filtering of the connections runs concurrently.
+     * \param[in] connections the connections, none depending on another
+     ***********/
+    static void transferDataConcurrently(const std::vector<Connection*> &connections);
+    /***********************************************************************************************
+     * \brief Transfer the data of independent connections at once, only of those transferring at
+     *        the current time step, the others are interpolated in time
+     * \param[in] connections the connections, none depending on another
+     ***********/
+    static void exchangeConcurrently(const std::vector<Connection*> &connections);
+    /***********************************************************************************************
+     * \brief Run the filters of independent connections concurrently
+     * \param[in] connections the connections, none depending on another
+     ***********/
+    static void filterConcurrently(const std::vector<Connection*> &connections);
 protected:
+    /********//**
+     * \brief Struct FilterStage is one step of the compiled filter pipeline, either a single filter or
+     *        several consecutive elementwise filters fused into one pass over the data
+     ***********/
+    struct FilterStage {
+        /// the filters of the stage in the order of the filter sequence
+        std::vector<AbstractFilter*> filters;
+        /// true if the filters are run entrywise in blocks
+        bool isFused;
+        /// true if the only filter is a chain of mapping filters
+        bool isChained;
+        /// the name of the stage in the profile
+        std::string name;
+    };
+    /***********************************************************************************************
+     * \brief Compile the filter sequence into stages. Consecutive elementwise filters over the same
+     *        number of entries are fused, and scaling filters right after a mapping filter are folded
+     *        into the write of the mapper output.
+     ***********/
+    void compileFilterPipeline();
+    /***********************************************************************************************
+     * \brief Compose a mapping filter with the mapping of the stage before it, if the filter reads
+     *        the output of that mapping only and both operators are explicit
+     * \param[in] stage the last stage of the pipeline compiled so far
+     * \param[in] filter the mapping filter following the stage
+     * \param[in] composedFilters the filters whose work is done by the operators of the mappings,
+     *            i.e. the mapping filters and the scaling filters folded into them
+     * \return true if the filter is composed into the stage
+     ***********/
+    bool chainMapping(FilterStage &stage, MappingFilter *filter,
+            const std::set<const AbstractFilter*> &composedFilters);
+    /***********************************************************************************************
+     * \brief Run one stage of the compiled filter pipeline
+     * \param[in] stage the stage
+     ***********/
+    void runFilterStage(const FilterStage &stage);
+    /***********************************************************************************************
+     * \brief Get the mapping filter of a connection which can map its input while it arrives in
+     *        chunks and send the output in chunks while it is mapped. This is the case if the only
+     *        filter maps the only input to the only output by ranges of nodes and both data
+     *        fields are transferred in chunks in the order of the meshes.
+     * \return the mapping filter, NULL if the connection is not pipelined
+     ***********/
+    MappingFilter *getPipelinedMappingFilter() const;
+    /***********************************************************************************************
+     * \brief Transfer the data of a pipelined connection: the nodes of every output chunk are
+     *        mapped as soon as the input chunks they depend on have arrived, and the chunk is sent
+     *        before the next one is mapped
+     * \param[in] filter the mapping filter given by getPipelinedMappingFilter
+     ***********/
+    void transferDataPipelined(MappingFilter *filter);
+    /***********************************************************************************************
+     * \brief Start the receive of an input, a bundled signal is received with the bundle of its
+     *        client at the first signal of the client
+     * \return the request of a non-blocking receive, -1 if the input has been received
+     ***********/
+    int startReceiveInput(ConnectionIO *input);
+    /***********************************************************************************************
+     * \brief Start the send of an output, a bundled signal is sent with the bundle of its client
+     *        at the first signal of the client
+     * \return the request of a non-blocking send, -1 if the output has been sent
+     ***********/
+    int startSendOutput(ConnectionIO *output);
+    /***********************************************************************************************
+     * \brief Get the signals of the bundle of the client of ios[i]
+     * \param[in] ios the inputs or the outputs
+     * \param[in] i the position of a signal
+     * \param[out] signalNames the names of the signals of the client in the order of ios
+     * \return true if ios[i] is the first signal of its client
+     ***********/
+    static bool getSignalBundle(const std::vector<ConnectionIO*> &ios, unsigned i,
+            std::vector<std::string> &signalNames);
+    /***********************************************************************************************
+     * \brief Check whether the inputs have changed since the last filtering, the inputs are
+     *        stored as the reference of the next check if so
+     * \return true if the filters have to run, always true without change detection
+     ***********/
+    bool hasInputChanged();
+    /***********************************************************************************************
+     * \brief Get the data fields written by the connection, one per data storage
+     * \param[out] dataFields the data fields received from the clients or written by the filters
+     ***********/
+    void collectWrittenDataFields(std::vector<DataField*> &dataFields) const;
+    /***********************************************************************************************
+     * \brief Check whether one of the filters of a stage reads the data of io
+     * \param[in] stage the stage
+     * \param[in] io the connection input
+     * \return true if the stage reads the data of io
+     ***********/
+    static bool stageHasInput(const FilterStage &stage, const ConnectionIO *io);
+    /***********************************************************************************************
+     * \brief Collect the data fields and signals read and written, the clients and the mappers
+     *        used by the connection
+     * \param[out] readData the data read by the filters or sent to the clients
+     * \param[out] writtenData the data written by the filters or received from the clients
+     * \param[out] sendClients the clients sent to
+     * \param[out] receiveClients the clients received from
+     * \param[out] mappers the mappers of the mapping filters
+     ***********/
+    void collectDependencies(std::set<const void*> &readData, std::set<const void*> &writtenData,
+            std::set<const ClientCode*> &sendClients, std::set<const ClientCode*> &receiveClients,
+            std::set<const void*> &mappers) const;
+    /// number of entries a fused stage processes with each filter before passing to the next one
+    static const int FUSED_BLOCK_SIZE = 1024;
+
     /// name of the connection
     std::string name;
     /// inputs
@@ -84,6 +321,32 @@ protected:
     std::vector<ConnectionIO*> outputVec;
     /// sequence of filters
     std::vector<AbstractFilter*> filterVec;
+    /// the filter sequence compiled into stages
+    std::vector<FilterStage> filterPipeline;
+    /// the chained mapping filters of filterPipeline, owned by the connection
+    std::vector<ChainedMappingFilter*> chainedMappingFilters;
+    /// whether mapping filters in series are composed
+    bool chainMappings;
+    /// the data fields written by the filters which are read outside of the connection
+    std::set<const DataField*> keptDataFields;
+    /// true if filterPipeline is up to date with filterVec
+    bool isFilterPipelineCompiled;
+    /// inputs whose receives are posted by startReceive()
+    std::vector<ConnectionIO*> pendingInputVec;
+    /// outputs whose sends are posted by filterAndStartSend()
+    std::vector<ConnectionIO*> pendingOutputVec;
+    /// number of time steps between two transfers
+    int exchangeInterval;
+    /// the time step of the enclosing time step loop, 0 outside of time step loops
+    int timeStep;
+    /// whether the signals of a client are transferred as one bundle
+    bool bundleSignals;
+    /// whether the filters are skipped while the inputs do not change
+    bool skipUnchangedInputs;
+    /// the relative change of an input up to which it is unchanged
+    double changeTolerance;
+    /// the values of the inputs at the last filtering, empty before the first one
+    std::vector<std::vector<double> > inputSnapshots;
     /// the unit test class
     friend class TestConnection;
 };
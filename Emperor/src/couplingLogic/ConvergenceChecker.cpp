@@ -24,12 +24,15 @@
 #include <assert.h>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 
 #include "ConvergenceChecker.h"
 #include "DataField.h"
 #include "Message.h"
 #include "AbstractCouplingAlgorithm.h"
 #include "Signal.h"
+#include "LiveMetrics.h"
+#include "MapperAdapter.h"
 
 using namespace std;
 
@@ -91,11 +94,27 @@ void ConvergenceChecker::CheckResidual::writeResidualToShell() {
 
 }
 
+void ConvergenceChecker::CheckResidual::setLiveMetrics() {
+    stringstream index;
+    index << residualIndex;
+    string labels = LiveMetrics::label("couplingAlgorithm", couplingAlgorithm->getName()) + ","
+            + LiveMetrics::label("residual", index.str());
+    LiveMetrics::set(LiveMetrics::RESIDUAL_ABSOLUTE, labels, getAbsoluteResidual());
+    LiveMetrics::set(LiveMetrics::RESIDUAL_RELATIVE, labels, getRelativeResidual());
+}
+
+double ConvergenceChecker::CheckResidual::getResidualRatio() {
+    if (checkOnAbsolute)
+        return ABS_TOL > 0.0 ? getAbsoluteResidual() / ABS_TOL : 0.0;
+    return REL_TOL > 0.0 ? getRelativeResidual() / REL_TOL : 0.0;
+}
+
 ConvergenceChecker::ConvergenceChecker(double maxNumOfIters) :
         MAX_NUM_ITERATIONS(maxNumOfIters), unitTest(false) {
     currentNumOfIterations = 0;
     debugResidual = true;
     timeStepNumber = 1;
+    firstResidualRatio = 0.0;
 
     residualFileName = "convergenceChecker";
     residualFileName.append(".log");
@@ -141,6 +160,21 @@ bool ConvergenceChecker::isConvergent() {
     }
     residualFile << endl;
 
+    if (LiveMetrics::isEnabled()) {
+        LiveMetrics::add(LiveMetrics::COUPLING_ITERATIONS, "", 1.0);
+        LiveMetrics::set(LiveMetrics::COUPLING_ITERATION, "", currentNumOfIterations);
+        for (int i = 0; i < checkResiduals.size(); i++)
+            checkResiduals[i]->setLiveMetrics();
+    }
+
+    // the mappers solving inexactly take their tolerance from the distance to convergence
+    double residualRatio = 0.0;
+    for (int i = 0; i < checkResiduals.size(); i++)
+        residualRatio = max(residualRatio, checkResiduals[i]->getResidualRatio());
+    if (currentNumOfIterations == 1)
+        firstResidualRatio = residualRatio;
+    MapperAdapter::setCouplingResidualRatio(residualRatio);
+
     // 3. set convergence when limit or maxNumOfIters is satisfied
     bool reachMaxNumOfIters = (currentNumOfIterations == MAX_NUM_ITERATIONS);
     bool isConvergent = true;
@@ -157,6 +191,8 @@ bool ConvergenceChecker::isConvergent() {
         }
         currentNumOfIterations = 0;
         timeStepNumber++;
+        // the first iteration of the next time step is expected as far from convergence as this one's
+        MapperAdapter::setCouplingResidualRatio(firstResidualRatio);
         return true;
     }
 
@@ -127,6 +127,15 @@ private:
          * \author Tianyang Wang
          ***********/
         void writeResidualToShell();
+        /***********************************************************************************************
+         * \brief Set the absolute and relative residual of the live metrics
+         ***********/
+        void setLiveMetrics();
+        /***********************************************************************************************
+         * \brief get the residual the convergence is checked on divided by its tolerance
+         * \return the ratio, 0 if the tolerance is 0
+         ***********/
+        double getResidualRatio();
     private:
         /// reference to the coupling algorithm
         AbstractCouplingAlgorithm *couplingAlgorithm;
@@ -155,6 +164,8 @@ private:
     std::string residualFileName;
     /// time step number, only used when writing the residual in a file
     int timeStepNumber;
+    /// the largest residual ratio of the first iteration of the time step, see CheckResidual::getResidualRatio
+    double firstResidualRatio;
 
     /// if unitTest, do not output debug message
     bool unitTest;
@@ -53,8 +53,7 @@ public:
      * \author Tianyang Wang
      ***********/
     void doCoupling() {
-        for (int i=0; i<couplingLogicSequence.size(); i++)
-            couplingLogicSequence[i]->doCoupling();
+        doCouplingLogicSequence();
     }
 };
 
@@ -0,0 +1,248 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "CouplingStateCheckpoint.h"
+#include "CheckpointArchive.h"
+#include "Message.h"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+using namespace std;
+
+namespace EMPIRE {
+
+/// magic number at the beginning of every checkpoint file
+static const char MAGIC[8] = { 'E', 'M', 'P', 'I', 'R', 'E', 'C', 'K' };
+/// version of the file layout
+static const int32_t VERSION = 1;
+
+/***********************************************************************************************
+ * \brief Write a value in binary
+ ***********/
+template<class T>
+static void writeValue(ofstream &file, T value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+/***********************************************************************************************
+ * \brief Read a value in binary
+ * \return false if the file ends before
+ ***********/
+template<class T>
+static bool readValue(ifstream &file, T &value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return file.good();
+}
+/***********************************************************************************************
+ * \brief Read bytes preceded by their number
+ * \return false if the file ends before
+ ***********/
+static bool readBytes(ifstream &file, vector<char> &bytes) {
+    int64_t numBytes;
+    if (!readValue(file, numBytes) || numBytes < 0)
+        return false;
+    bytes.resize(numBytes);
+    if (numBytes > 0)
+        file.read(&bytes[0], numBytes);
+    return file.good();
+}
+
+CouplingStateCheckpoint::CouplingStateCheckpoint(std::string _directory, int _interval,
+        int _numKept, int queueDepth) :
+        directory(_directory), interval(_interval), numKept(_numKept) {
+    assert(directory.size() > 0);
+    assert(interval >= 0 && numKept >= 1);
+    if (interval > 0 && mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        ERROR_OUT() << "CouplingStateCheckpoint: the directory \"" << directory
+                << "\" cannot be created" << endl;
+        exit(EXIT_FAILURE);
+    }
+    asyncWriter = new AsyncOutputWriter(queueDepth);
+}
+
+CouplingStateCheckpoint::~CouplingStateCheckpoint() {
+    delete asyncWriter;
+}
+
+void CouplingStateCheckpoint::addObject(std::string objectName, AbstractCheckpointable *object) {
+    assert(object != NULL);
+    for (unsigned i = 0; i < objects.size(); i++)
+        assert(objects[i].first != objectName);
+    objects.push_back(pair<string, AbstractCheckpointable*>(objectName, object));
+}
+
+void CouplingStateCheckpoint::writeTimeStep(int timeStep) {
+    if (interval == 0 || timeStep % interval != 0)
+        return;
+    // the file written numKept checkpoints ago is removed once the new one is complete
+    int obsoleteTimeStep = 0;
+    writtenTimeSteps.push_back(timeStep);
+    if (writtenTimeSteps.size() > numKept) {
+        obsoleteTimeStep = writtenTimeSteps.front();
+        writtenTimeSteps.erase(writtenTimeSteps.begin());
+    }
+    // the state is copied now, the coupling changes it while the file is written
+    CheckpointOutputTask *task = new CheckpointOutputTask(this, timeStep, obsoleteTimeStep);
+    task->objectNames.resize(objects.size());
+    task->buffers.resize(objects.size());
+    for (unsigned i = 0; i < objects.size(); i++) {
+        CheckpointArchive archive(objects[i].first);
+        objects[i].second->writeCheckpoint(archive);
+        task->objectNames[i] = objects[i].first;
+        task->buffers[i] = archive.getBuffer();
+    }
+    asyncWriter->push(task);
+}
+
+int CouplingStateCheckpoint::restart() {
+    int timeStep = 0;
+    {
+        ifstream latestFile(getLatestFileName().c_str());
+        if (!(latestFile >> timeStep)) {
+            WARNING_OUT() << "CouplingStateCheckpoint: there is no checkpoint in \"" << directory
+                    << "\", the coupling starts from the beginning" << endl;
+            return 0;
+        }
+    }
+    string fileName = getFileName(timeStep);
+    ifstream file(fileName.c_str(), ios::in | ios::binary);
+    char magic[8];
+    int32_t version, timeStepInFile, numSections;
+    file.read(magic, sizeof(magic));
+    bool valid = file.good() && equal(magic, magic + sizeof(magic), MAGIC);
+    valid = valid && readValue(file, version) && version == VERSION;
+    valid = valid && readValue(file, timeStepInFile) && timeStepInFile == timeStep;
+    valid = valid && readValue(file, numSections) && numSections >= 0;
+    map<string, vector<char> > sections;
+    for (int i = 0; valid && i < numSections; i++) {
+        vector<char> nameChars;
+        valid = readBytes(file, nameChars);
+        string sectionName(nameChars.begin(), nameChars.end());
+        valid = valid && readBytes(file, sections[sectionName]);
+    }
+    if (!valid) {
+        ERROR_OUT() << "CouplingStateCheckpoint: \"" << fileName
+                << "\" is not a valid checkpoint file" << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    for (unsigned i = 0; i < objects.size(); i++) {
+        map<string, vector<char> >::iterator it = sections.find(objects[i].first);
+        if (it == sections.end()) {
+            ERROR_OUT() << "CouplingStateCheckpoint: \"" << fileName << "\" holds no state of \""
+                    << objects[i].first << "\"" << endl;
+            exit(EXIT_FAILURE);
+        }
+        CheckpointArchive archive(objects[i].first, it->second);
+        objects[i].second->readCheckpoint(archive);
+        if (!archive.isAtEnd()) {
+            ERROR_OUT() << "CouplingStateCheckpoint: the state of \"" << objects[i].first
+                    << "\" in \"" << fileName << "\" does not match the current setup" << endl;
+            exit(EXIT_FAILURE);
+        }
+        sections.erase(it);
+    }
+    for (map<string, vector<char> >::iterator it = sections.begin(); it != sections.end(); it++)
+        WARNING_OUT() << "CouplingStateCheckpoint: the state of \"" << it->first
+                << "\" is not used by the current setup" << endl;
+    INFO_OUT() << "CouplingStateCheckpoint: the coupling restarts after time step " << timeStep
+            << " from \"" << fileName << "\"" << endl;
+    return timeStep;
+}
+
+void CouplingStateCheckpoint::flush() {
+    asyncWriter->flush();
+}
+
+std::string CouplingStateCheckpoint::getFileName(int timeStep) const {
+    stringstream fileName;
+    fileName << directory << "/checkpoint_" << timeStep << ".bin";
+    return fileName.str();
+}
+
+std::string CouplingStateCheckpoint::getLatestFileName() const {
+    return directory + "/checkpoint.latest";
+}
+
+CheckpointOutputTask::CheckpointOutputTask(const CouplingStateCheckpoint *_checkpoint,
+        int _timeStep, int _obsoleteTimeStep) :
+        checkpoint(_checkpoint), timeStep(_timeStep), obsoleteTimeStep(_obsoleteTimeStep) {
+}
+
+CheckpointOutputTask::~CheckpointOutputTask() {
+}
+
+void CheckpointOutputTask::execute() {
+    // write to a temporary file first, so that a run dying during the output leaves the last
+    // complete checkpoint
+    string fileName = checkpoint->getFileName(timeStep);
+    string tmpFileName = fileName + ".tmp";
+    {
+        ofstream file(tmpFileName.c_str(), ios::out | ios::binary | ios::trunc);
+        file.write(MAGIC, sizeof(MAGIC));
+        writeValue<int32_t>(file, VERSION);
+        writeValue<int32_t>(file, timeStep);
+        writeValue<int32_t>(file, objectNames.size());
+        for (unsigned i = 0; i < objectNames.size(); i++) {
+            writeValue<int64_t>(file, objectNames[i].size());
+            file.write(objectNames[i].c_str(), objectNames[i].size());
+            writeValue<int64_t>(file, buffers[i].size());
+            if (!buffers[i].empty())
+                file.write(&buffers[i][0], buffers[i].size());
+        }
+        file.flush();
+        if (!file.good()) {
+            WARNING_OUT() << "CouplingStateCheckpoint: writing \"" << tmpFileName
+                    << "\" failed, no checkpoint of time step " << timeStep << endl;
+            file.close();
+            remove(tmpFileName.c_str());
+            return;
+        }
+    }
+    if (rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+        WARNING_OUT() << "CouplingStateCheckpoint: \"" << fileName
+                << "\" cannot be written, no checkpoint of time step " << timeStep << endl;
+        remove(tmpFileName.c_str());
+        return;
+    }
+    string latestFileName = checkpoint->getLatestFileName();
+    string tmpLatestFileName = latestFileName + ".tmp";
+    {
+        ofstream latestFile(tmpLatestFileName.c_str(), ios::out | ios::trunc);
+        latestFile << timeStep << endl;
+    }
+    if (rename(tmpLatestFileName.c_str(), latestFileName.c_str()) != 0) {
+        WARNING_OUT() << "CouplingStateCheckpoint: \"" << latestFileName
+                << "\" cannot be written" << endl;
+        return;
+    }
+    if (obsoleteTimeStep > 0)
+        remove(checkpoint->getFileName(obsoleteTimeStep).c_str());
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,149 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file CouplingStateCheckpoint.h
+ * This file holds the class CouplingStateCheckpoint. A checkpoint file consists of
+ *  - a header (magic number, version, time step, number of objects),
+ *  - one section per object: its name, the number of bytes and the bytes of its CheckpointArchive.
+ * The file <directory>/checkpoint.latest holds the time step of the last complete checkpoint.
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef COUPLINGSTATECHECKPOINT_H_
+#define COUPLINGSTATECHECKPOINT_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "AsyncOutputWriter.h"
+
+namespace EMPIRE {
+
+class AbstractCheckpointable;
+
+/********//**
+ * \brief Class CouplingStateCheckpoint writes the state of the coupling algorithms, extrapolators
+ *        and filters at the end of every interval-th time step, and restores it when a run is
+ *        restarted. The state is copied to in-memory archives on the coupling thread and written
+ *        to disk by an AsyncOutputWriter, so that the coupling does not wait for the disk. A file
+ *        is written to a temporary name and renamed when complete, only the last numKept files
+ *        are kept.
+ ***********/
+class CouplingStateCheckpoint {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _directory the directory of the checkpoint files, it is created if it does not exist
+     * \param[in] _interval a checkpoint is written every interval time steps, 0 for none
+     * \param[in] _numKept number of checkpoint files kept
+     * \param[in] queueDepth the queue depth of the writer, 0 to write synchronously
+     ***********/
+    CouplingStateCheckpoint(std::string _directory, int _interval, int _numKept, int queueDepth);
+    /***********************************************************************************************
+     * \brief Destructor, waits until the pending checkpoints are written
+     ***********/
+    virtual ~CouplingStateCheckpoint();
+    /***********************************************************************************************
+     * \brief Add an object whose state is checkpointed
+     * \param[in] objectName a unique name of the object
+     * \param[in] object the object, not owned
+     ***********/
+    void addObject(std::string objectName, AbstractCheckpointable *object);
+    /***********************************************************************************************
+     * \brief Write a checkpoint if the time step is a multiple of the interval
+     * \param[in] timeStep the time step which has just ended
+     ***********/
+    void writeTimeStep(int timeStep);
+    /***********************************************************************************************
+     * \brief Restore the state of all objects from the last complete checkpoint
+     * \return the time step of the checkpoint, 0 if there is none
+     ***********/
+    int restart();
+    /***********************************************************************************************
+     * \brief Wait until all pending checkpoints are written
+     ***********/
+    void flush();
+    /***********************************************************************************************
+     * \brief Get the name of the checkpoint file of a time step
+     * \param[in] timeStep the time step
+     * \return the file name
+     ***********/
+    std::string getFileName(int timeStep) const;
+    /***********************************************************************************************
+     * \brief Get the name of the file holding the time step of the last complete checkpoint
+     * \return the file name
+     ***********/
+    std::string getLatestFileName() const;
+
+private:
+    /// directory of the checkpoint files
+    std::string directory;
+    /// a checkpoint is written every interval time steps
+    int interval;
+    /// number of checkpoint files kept
+    int numKept;
+    /// the objects whose state is checkpointed, by their names
+    std::vector<std::pair<std::string, AbstractCheckpointable*> > objects;
+    /// the writer of the checkpoint files
+    AsyncOutputWriter *asyncWriter;
+    /// the time steps of the checkpoint files written in this run
+    std::vector<int> writtenTimeSteps;
+    /// disallow copy constructor
+    CouplingStateCheckpoint(const CouplingStateCheckpoint&);
+    /// disallow assignment operator
+    CouplingStateCheckpoint& operator=(const CouplingStateCheckpoint&);
+};
+
+/********//**
+ * \brief Class CheckpointOutputTask writes the archives of a checkpoint to its file
+ ***********/
+class CheckpointOutputTask: public AbstractOutputTask {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _checkpoint the CouplingStateCheckpoint
+     * \param[in] _timeStep the time step of the checkpoint
+     * \param[in] _obsoleteTimeStep the time step whose file is removed afterwards, 0 for none
+     ***********/
+    CheckpointOutputTask(const CouplingStateCheckpoint *_checkpoint, int _timeStep,
+            int _obsoleteTimeStep);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~CheckpointOutputTask();
+    /***********************************************************************************************
+     * \brief Write the file
+     ***********/
+    void execute();
+    /// the names of the objects
+    std::vector<std::string> objectNames;
+    /// the archives of the objects
+    std::vector<std::vector<char> > buffers;
+private:
+    /// the CouplingStateCheckpoint
+    const CouplingStateCheckpoint *checkpoint;
+    /// the time step of the checkpoint
+    int timeStep;
+    /// the time step whose file is removed afterwards
+    int obsoleteTimeStep;
+};
+
+} /* namespace EMPIRE */
+#endif /* COUPLINGSTATECHECKPOINT_H_ */
@@ -19,16 +19,19 @@
  *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
  */
 #include <assert.h>
+#include <stdlib.h>
 #include <iostream>
 #include <sstream>
 
 #include "IterativeCouplingLoop.h"
 #include "ConvergenceChecker.h"
+#include "Connection.h"
 #include "DataField.h"
 #include "ClientCode.h"
 #include "AbstractCouplingAlgorithm.h"
 #include "Message.h"
 #include "DataOutput.h"
+#include "Profiler.h"
 
 using namespace std;
 
@@ -38,6 +41,7 @@ IterativeCouplingLoop::IterativeCouplingLoop() :
 		AbstractCouplingLogic(), convergenceObserverVec(), convergenceChecker(
 				NULL) {
 	outputCounter = 0;
+	couplingSchema = EMPIRE_GaussSeidel;
 }
 
 IterativeCouplingLoop::~IterativeCouplingLoop() {
@@ -67,54 +71,75 @@ void IterativeCouplingLoop::doCoupling() {
 		dataOutputVec[i]->init(rearPart.str());
 
 	while (true) {
+		PROFILER_SCOPE("coupling iteration");
 		count++;
 		stringstream ss;
 		ss << "iteration step: " << count;
 		HEADING_OUT(4, "IterativeCouplingLoop", ss.str(), infoOut);
 		// update data in coupling algorithm
-		for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
-			couplingAlgorithmVec[i]->updateAtIterationBeginning();
-			// This is just for the first iteration.
-			// To make iteration end value not zero.
-			if(count == 1){
-				// update data in coupling algorithm
-				for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
-					couplingAlgorithmVec[i]->updateAtIterationEnd();
+		{
+			PROFILER_SCOPE("coupling algorithm");
+			for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
+				couplingAlgorithmVec[i]->updateAtIterationBeginning();
+				// This is just for the first iteration.
+				// To make iteration end value not zero.
+				if(count == 1){
+					// update data in coupling algorithm
+					for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
+						couplingAlgorithmVec[i]->updateAtIterationEnd();
+					}
 				}
+				couplingAlgorithmVec[i]->setCurrentIteration(count);
+				couplingAlgorithmVec[i]->setCurrentTimeStep(outputCounter);
 			}
-			couplingAlgorithmVec[i]->setCurrentIteration(count);
-			couplingAlgorithmVec[i]->setCurrentTimeStep(outputCounter);
 		}
 
 		// do coupling
-		for (int i = 0; i < couplingLogicSequence.size(); i++)
-			couplingLogicSequence[i]->doCoupling();
+		if (couplingSchema == EMPIRE_Jacobi) {
+			doJacobiCoupling();
+		} else {
+			doCouplingLogicSequence();
+		}
 
 		// write data field at this iteration
-		for (int i = 0; i < dataOutputVec.size(); i++)
-			dataOutputVec[i]->writeCurrentStep(count);
+		if (!dataOutputVec.empty()) {
+			PROFILER_SCOPE("data output");
+			for (int i = 0; i < dataOutputVec.size(); i++)
+				dataOutputVec[i]->writeCurrentStep(count);
+		}
 
 		// update data in coupling algorithm
-		for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
-			couplingAlgorithmVec[i]->updateAtIterationEnd();
+		{
+			PROFILER_SCOPE("coupling algorithm");
+			for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
+				couplingAlgorithmVec[i]->updateAtIterationEnd();
+			}
 		}
 
 		// compute the new residual for the coupling algorithm.
-		for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
-			couplingAlgorithmVec[i]->calcCurrentResidual();
+		{
+			PROFILER_SCOPE("residual");
+			for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
+				couplingAlgorithmVec[i]->calcCurrentResidual();
+			}
 		}
 
 		// broadcast convergence
-		if (convergenceChecker->isConvergent()) {
-			broadcastConvergenceToClients(true);
-			break;
-		} else {
-			broadcastConvergenceToClients(false);
+		bool isConvergent;
+		{
+			PROFILER_SCOPE("convergence check");
+			isConvergent = convergenceChecker->isConvergent();
+			broadcastConvergenceToClients(isConvergent);
 		}
+		if (isConvergent)
+			break;
 
 		// compute the new output of the coupling algorithm
-		for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
-			couplingAlgorithmVec[i]->calcNewValue();
+		{
+			PROFILER_SCOPE("coupling algorithm");
+			for (int i = 0; i < couplingAlgorithmVec.size(); i++) {
+				couplingAlgorithmVec[i]->calcNewValue();
+			}
 		}
 
 		assert(count == convergenceChecker->getCurrentNumOfIterations());
@@ -122,6 +147,45 @@ void IterativeCouplingLoop::doCoupling() {
 	//std::cout << "number of iterative coupling loops: " << count << std::endl;
 }
 
+void IterativeCouplingLoop::doJacobiCoupling() {
+	vector<Connection*> connections;
+	for (int i = 0; i < couplingLogicSequence.size(); i++) {
+		Connection *connection = dynamic_cast<Connection*>(couplingLogicSequence[i]);
+		if (connection == NULL) {
+			ERROR_OUT() << "IterativeCouplingLoop: the Jacobi schema only allows connections in the sequence" << endl;
+			exit(-1);
+		}
+		if (connection->getExchangeInterval() > 1) {
+			ERROR_OUT() << "IterativeCouplingLoop: the Jacobi schema does not allow connections with an exchange interval" << endl;
+			exit(-1);
+		}
+		connections.push_back(connection);
+	}
+	// filter the connections which do not depend on each other concurrently
+	if (couplingLogicBatches.empty())
+		computeCouplingLogicBatches();
+	for (int i = 0; i < couplingLogicBatches.size(); i++) {
+		vector<Connection*> batch;
+		for (int j = 0; j < couplingLogicBatches[i].size(); j++)
+			batch.push_back(dynamic_cast<Connection*>(couplingLogicBatches[i][j]));
+		Connection::filterConcurrently(batch);
+	}
+	// send the outputs of all connections at once, so that all clients solve concurrently
+	for (int i = 0; i < connections.size(); i++)
+		connections[i]->startSend();
+	for (int i = 0; i < connections.size(); i++)
+		connections[i]->finishSend();
+	// collect the results of all clients
+	for (int i = 0; i < connections.size(); i++)
+		connections[i]->startReceive();
+	for (int i = 0; i < connections.size(); i++)
+		connections[i]->finishReceive();
+}
+
+void IterativeCouplingLoop::setCouplingSchema(EMPIRE_IterativeCouplingLoop_schema _couplingSchema) {
+	couplingSchema = _couplingSchema;
+}
+
 void IterativeCouplingLoop::addConvergenceObserver(ClientCode *clientCode) {
 	convergenceObserverVec.push_back(clientCode);
 }
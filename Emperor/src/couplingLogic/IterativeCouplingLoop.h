@@ -30,6 +30,7 @@
 #include <vector>
 
 #include "AbstractCouplingLogic.h"
+#include "EMPEROR_Enum.h"
 
 namespace EMPIRE {
 
@@ -38,7 +39,11 @@ class ClientCode;
 class AbstractCouplingAlgorithm;
 
 /********//**
- * \brief Class IterativeCouplingLoop performs iterative coupling of a certain time step
+ * \brief Class IterativeCouplingLoop performs iterative coupling of a certain time step. In the
+ *        Gauss-Seidel schema the coupling logics are done one after another. In the Jacobi schema
+ *        all connections first send their (filtered) outputs and then receive their inputs, such
+ *        that all clients solve concurrently. Then each client has to receive its inputs before
+ *        sending its outputs in every iteration.
  ***********/
 class IterativeCouplingLoop: public AbstractCouplingLogic {
 public:
@@ -76,6 +81,11 @@ public:
      * \author Tianyang Wang
      ***********/
     void addCouplingAlgorithm(AbstractCouplingAlgorithm *_couplingAlgorithm);
+    /***********************************************************************************************
+     * \brief Set the coupling schema (Gauss-Seidel by default)
+     * \param[in] _couplingSchema Gauss-Seidel or Jacobi
+     ***********/
+    void setCouplingSchema(EMPIRE_IterativeCouplingLoop_schema _couplingSchema);
 
 private:
     /// convergence checker
@@ -86,6 +96,12 @@ private:
     std::vector<ClientCode*> convergenceObserverVec;
     /// output counter
     int outputCounter;
+    /// coupling schema
+    EMPIRE_IterativeCouplingLoop_schema couplingSchema;
+    /***********************************************************************************************
+     * \brief Do one iteration of the Jacobi schema, the sequence must consist of connections only
+     ***********/
+    void doJacobiCoupling();
 
     /***********************************************************************************************
      * \brief Broadcast the convergence signal to all clients/observers
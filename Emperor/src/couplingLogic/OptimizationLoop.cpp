@@ -2,8 +2,10 @@
 #include "ClientCode.h"
 #include "Message.h"
 #include "DataOutput.h"
+#include "CouplingLogicSequence.h"
 
 #include <sstream>
+#include <algorithm>
 #include <assert.h>
 
 using namespace std;
@@ -12,7 +14,7 @@ namespace EMPIRE {
 
 OptimizationLoop::OptimizationLoop(int _maxNumOfIterations) :
         AbstractCouplingLogic(), maxNumOfIterations(_maxNumOfIterations), convergenceSignalSender(
-                NULL) {
+                NULL), concurrentDesigns(false) {
     currentNumOfIterations = 0;
 }
 
@@ -23,6 +25,8 @@ void OptimizationLoop::doCoupling() {
     // initialize output files
     for (int i = 0; i < dataOutputVec.size(); i++)
         dataOutputVec[i]->init("");
+    if (concurrentDesigns)
+        interleaveDesigns();
 
     while (true) {
         currentNumOfIterations++;
@@ -35,8 +39,7 @@ void OptimizationLoop::doCoupling() {
         HEADING_OUT(2, "OptimizationLoop", ss.str(), infoOut);
 
         // do coupling
-        for (int i = 0; i < couplingLogicSequence.size(); i++)
-            couplingLogicSequence[i]->doCoupling();
+        doCouplingLogicSequence();
 
         // write data field at this iteration
         for (int i = 0; i < dataOutputVec.size(); i++)
@@ -54,6 +57,30 @@ void OptimizationLoop::doCoupling() {
     }
 }
 
+void OptimizationLoop::interleaveDesigns() {
+    int numDesigns = couplingLogicSequence.size();
+    vector<vector<AbstractCouplingLogic*> > designs(numDesigns);
+    int maxDesignSize = 0;
+    for (int i = 0; i < numDesigns; i++) {
+        // a design which is a loop is run as a whole
+        if (dynamic_cast<CouplingLogicSequence*>(couplingLogicSequence[i]) != NULL)
+            designs[i] = couplingLogicSequence[i]->getCouplingLogicSequence();
+        else
+            designs[i].push_back(couplingLogicSequence[i]);
+        maxDesignSize = max(maxDesignSize, (int) designs[i].size());
+    }
+    vector<AbstractCouplingLogic*> interleavedSequence;
+    for (int j = 0; j < maxDesignSize; j++)
+        for (int i = 0; i < numDesigns; i++)
+            if (j < designs[i].size())
+                interleavedSequence.push_back(designs[i][j]);
+    couplingLogicSequence.clear();
+    for (int i = 0; i < interleavedSequence.size(); i++)
+        addCouplingLogic(interleavedSequence[i]);
+    concurrentDesigns = false;
+    INFO_OUT() << numDesigns << " designs are evaluated concurrently per optimization step" << endl;
+}
+
 void OptimizationLoop::setConvergenceSignalSender(ClientCode *_convergenceSignalSender) {
     assert(convergenceSignalSender == NULL);
     convergenceSignalSender = _convergenceSignalSender;
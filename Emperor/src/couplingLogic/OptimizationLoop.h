@@ -32,7 +32,12 @@ namespace EMPIRE {
 class ClientCode;
 
 /********//**
- * \brief Class OptimizationLoop performs optimization loop
+ * \brief Class OptimizationLoop performs optimization loop. With concurrent designs, every coupling
+ *        logic of the sequence is the analysis of one design with its own clients, e.g. a
+ *        sequence of connections, and the optimizer evaluates a batch of designs per iteration.
+ *        The sequences of the designs are interleaved, such that the connections of different
+ *        designs, which do not depend on each other, are transferred concurrently and all clients
+ *        of the batch compute at the same time.
  ***********/
 class OptimizationLoop: public AbstractCouplingLogic {
 public:
@@ -64,8 +69,21 @@ public:
      * \author Tianyang Wang
      ***********/
     void addConvergenceSignalReceiver(ClientCode *convergenceSignalReceiver);
+    /***********************************************************************************************
+     * \brief Set whether the coupling logics of the sequence are the analyses of independent designs
+     *        which are run concurrently
+     * \param[in] _concurrentDesigns true to run the designs concurrently
+     ***********/
+    void setConcurrentDesigns(bool _concurrentDesigns) {
+        concurrentDesigns = _concurrentDesigns;
+    }
 
 private:
+    /***********************************************************************************************
+     * \brief Replace the designs in couplingLogicSequence by their coupling logics, taking the
+     *        first of every design, then the second of every design and so on
+     ***********/
+    void interleaveDesigns();
     /// convergence signal sender
     ClientCode *convergenceSignalSender;
     /// vector of convergence signal receivers
@@ -74,6 +92,8 @@ private:
     int currentNumOfIterations;
     /// maximun number of iterations
     int maxNumOfIterations;
+    /// whether the coupling logics of the sequence are independent designs run concurrently
+    bool concurrentDesigns;
 
     /// unit test class
     friend class TestEmperor;
@@ -27,13 +27,18 @@
 #include "AbstractExtrapolator.h"
 #include "Message.h"
 #include "DataOutput.h"
+#include "Profiler.h"
+#include "LiveMetrics.h"
+#include "CouplingStateCheckpoint.h"
+#include "MapperAdapter.h"
 
 namespace EMPIRE {
 
 using namespace std;
 
 TimeStepLoop::TimeStepLoop(int _numTimeSteps) :
-        AbstractCouplingLogic(), numTimeSteps(_numTimeSteps), extrapolator(NULL) {
+        AbstractCouplingLogic(), numTimeSteps(_numTimeSteps), extrapolator(NULL),
+        checkpoint(NULL), restart(false) {
     assert(numTimeSteps > 0);
     outputCounter = 0;
 }
@@ -49,29 +54,72 @@ void TimeStepLoop::doCoupling() {
     for (int i = 0; i < dataOutputVec.size(); i++)
         dataOutputVec[i]->init(rearPart.str());
 
-    for (int timeStep = 1; timeStep <= numTimeSteps; timeStep++) {
+    // the state of the coupling is restored after all objects are initialized
+    int firstTimeStep = 1;
+    if (checkpoint != NULL && restart) {
+        firstTimeStep = checkpoint->restart() + 1;
+        restart = false;
+    }
+
+    for (int timeStep = firstTimeStep; timeStep <= numTimeSteps; timeStep++) {
         // output to shell
         stringstream ss;
         ss << "time step: " << timeStep;
         HEADING_OUT(3, "TimeStepLoop", ss.str(), infoOut);
+        LiveMetrics::set(LiveMetrics::TIME_STEP, "", timeStep);
+
+        {
+            PROFILER_SCOPE("time step");
+            // the connections with an exchange interval transfer only at some time steps
+            setTimeStep(timeStep);
+            // set extrapolation
+            if (extrapolator != NULL) {
+                PROFILER_SCOPE("extrapolation");
+                extrapolator->extrapolate();
+            }
+
+            // do the coupling
+            doCouplingLogicSequence();
 
-        // set extrapolation
-        if (extrapolator != NULL)
-            extrapolator->extrapolate();
+            // the errors of the converged mappings of the time step
+            if (!mappersWithErrorsAtTimeStepEnd.empty()) {
+                PROFILER_SCOPE("mapping errors");
+                for (int i = 0; i < mappersWithErrorsAtTimeStepEnd.size(); i++)
+                    mappersWithErrorsAtTimeStepEnd[i]->computeErrorsAtTimeStepEnd();
+            }
 
-        // do the coupling
-        for (int i = 0; i < couplingLogicSequence.size(); i++)
-            couplingLogicSequence[i]->doCoupling();
+            // write data field at current time step
+            if (!dataOutputVec.empty()) {
+                PROFILER_SCOPE("data output");
+                for (int i = 0; i < dataOutputVec.size(); i++)
+                    dataOutputVec[i]->writeCurrentStep(timeStep);
+            }
+        }
 
-        // write data field at current time step
-        for (int i = 0; i < dataOutputVec.size(); i++)
-            dataOutputVec[i]->writeCurrentStep(timeStep);
+        // the state is copied at once, the file is written while the next time step runs
+        if (checkpoint != NULL) {
+            PROFILER_SCOPE("checkpoint");
+            checkpoint->writeTimeStep(timeStep);
+        }
 
+        // write the timers of this time step
+        Profiler::writeTimeStep(timeStep);
     }
+    if (checkpoint != NULL)
+        checkpoint->flush();
 }
 
 void TimeStepLoop::setExtrapolator(AbstractExtrapolator *_extrapolator) {
     extrapolator = _extrapolator;
 }
 
+void TimeStepLoop::setCheckpoint(CouplingStateCheckpoint *_checkpoint, bool _restart) {
+    checkpoint = _checkpoint;
+    restart = _restart;
+}
+
+void TimeStepLoop::addMapperWithErrorsAtTimeStepEnd(MapperAdapter *mapper) {
+    mappersWithErrorsAtTimeStepEnd.push_back(mapper);
+}
+
 } /* namespace EMPIRE */
@@ -34,6 +34,8 @@
 namespace EMPIRE {
 
 class AbstractExtrapolator;
+class CouplingStateCheckpoint;
+class MapperAdapter;
 
 /********//**
  * \brief Class TimeStepLoop performs time step loop on the sequence of coupling logics
@@ -62,6 +64,17 @@ public:
      * \author Tianyang Wang
      ***********/
     void setExtrapolator(AbstractExtrapolator *_extrapolator);
+    /***********************************************************************************************
+     * \brief Set the checkpoint which is written at the end of the time steps
+     * \param[in] _checkpoint the checkpoint
+     * \param[in] _restart whether the loop continues after the last checkpoint
+     ***********/
+    void setCheckpoint(CouplingStateCheckpoint *_checkpoint, bool _restart);
+    /***********************************************************************************************
+     * \brief Add a mapper whose mapping errors are computed at the end of the time steps
+     * \param[in] mapper the mapper
+     ***********/
+    void addMapperWithErrorsAtTimeStepEnd(MapperAdapter *mapper);
 
 private:
     /// number of time steps
@@ -70,6 +83,12 @@ private:
     AbstractExtrapolator *extrapolator;
     /// output counter
     int outputCounter;
+    /// the checkpoint of the coupling state, NULL if none
+    CouplingStateCheckpoint *checkpoint;
+    /// whether the loop continues after the last checkpoint
+    bool restart;
+    /// the mappers whose mapping errors are computed at the end of the time steps
+    std::vector<MapperAdapter*> mappersWithErrorsAtTimeStepEnd;
     /// the unit test classes
     friend class TestLoops;
     friend class TestEmperor;
@@ -20,6 +20,8 @@
  */
 #include "AbstractExtrapolator.h"
 #include "ConnectionIO.h"
+#include "DataField.h"
+#include "Signal.h"
 #include <assert.h>
 
 namespace EMPIRE {
@@ -37,4 +39,38 @@ void AbstractExtrapolator::addConnectionIO(ConnectionIO *io) {
     connectionIOs.push_back(io);
 }
 
+void AbstractExtrapolator::writeCheckpoint(CheckpointArchive &archive) const {
+    archive.write(currentTimeStepNumber);
+    for (int i = 0; i < connectionIOs.size(); i++)
+        archive.write(getData(connectionIOs[i]), getDataSize(connectionIOs[i]));
+}
+
+void AbstractExtrapolator::readCheckpoint(CheckpointArchive &archive) {
+    archive.read(currentTimeStepNumber);
+    for (int i = 0; i < connectionIOs.size(); i++)
+        archive.read(getData(connectionIOs[i]), getDataSize(connectionIOs[i]));
+}
+
+int AbstractExtrapolator::getDataSize(const ConnectionIO *io) {
+    if (io->type == EMPIRE_ConnectionIO_DataField) {
+        return io->dataField->dimension * io->dataField->numLocations;
+    } else if (io->type == EMPIRE_ConnectionIO_Signal) {
+        return io->signal->size;
+    } else {
+        assert(false);
+    }
+    return 0;
+}
+
+double *AbstractExtrapolator::getData(const ConnectionIO *io) {
+    if (io->type == EMPIRE_ConnectionIO_DataField) {
+        return io->dataField->data;
+    } else if (io->type == EMPIRE_ConnectionIO_Signal) {
+        return io->signal->array;
+    } else {
+        assert(false);
+    }
+    return NULL;
+}
+
 } /* namespace EMPIRE */
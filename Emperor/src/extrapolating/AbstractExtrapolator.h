@@ -29,6 +29,7 @@
 #include "EMPEROR_Enum.h"
 #include <vector>
 #include <string>
+#include "CheckpointArchive.h"
 
 namespace EMPIRE {
 
@@ -37,7 +38,7 @@ class ConnectionIO;
 /********//**
  * \brief Class AbstractExtrapolator is the superclass of all extrapolators
  ***********/
-class AbstractExtrapolator {
+class AbstractExtrapolator : public AbstractCheckpointable {
 public:
     /***********************************************************************************************
      * \brief Constructor
@@ -66,6 +67,17 @@ public:
      * \author Tianyang Wang
      ***********/
     virtual void extrapolate() = 0;
+    /***********************************************************************************************
+     * \brief Write the time step number and the current data of the connectionIOs, which the
+     *        extrapolation of the next time step starts from
+     * \param[in] archive the archive
+     ***********/
+    virtual void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    virtual void readCheckpoint(CheckpointArchive &archive);
 
 protected:
     /// name
@@ -74,6 +86,18 @@ protected:
     std::vector<const ConnectionIO*> connectionIOs;
     /// currentTimeStepNumber
     int currentTimeStepNumber;
+    /***********************************************************************************************
+     * \brief Get the size of the data of a connectionIO
+     * \param[in] io the connectionIO
+     * \return the number of entries
+     ***********/
+    static int getDataSize(const ConnectionIO *io);
+    /***********************************************************************************************
+     * \brief Get the data of a connectionIO
+     * \param[in] io the connectionIO
+     * \return the array of the data field or signal
+     ***********/
+    static double *getData(const ConnectionIO *io);
     // the unit test class
     friend class TestExtrapolator;
 };
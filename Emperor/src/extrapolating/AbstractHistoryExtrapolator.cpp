@@ -0,0 +1,122 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "AbstractHistoryExtrapolator.h"
+#include "Signal.h"
+#include "DataField.h"
+#include "ConnectionIO.h"
+#include "Message.h"
+#include <assert.h>
+
+using namespace std;
+
+namespace EMPIRE {
+
+AbstractHistoryExtrapolator::AbstractHistoryExtrapolator(std::string _name, int _historyLength) :
+        AbstractExtrapolator(_name), historyLength(_historyLength), unitTest(false), latest(-1),
+        numSnapshots(0) {
+    assert(historyLength >= 1);
+}
+
+AbstractHistoryExtrapolator::~AbstractHistoryExtrapolator() {
+    for (int i = 0; i < connectionIOs.size(); i++) {
+        delete connectionIOs[i];
+    }
+}
+
+void AbstractHistoryExtrapolator::init() {
+    assert(connectionIOs.size() > 0);
+    assert(tags.size() == 0);
+    for (int i = 0; i < connectionIOs.size(); i++)
+        connectionIOs[i]->getHistory(DataHistory::TIME_STEP)->reserve(historyLength);
+    tags.assign(historyLength, 0);
+    weights.resize(historyLength);
+}
+
+void AbstractHistoryExtrapolator::extrapolate() {
+    if (!unitTest) {
+        HEADING_OUT(4, "Extrapolator", "doing extrapolation ...", infoOut);
+    }
+    assert(tags.size() == historyLength);
+    currentTimeStepNumber++;
+    // nothing is known before the first time step
+    if (currentTimeStepNumber == 1)
+        return;
+
+    // store the data of the last time step, it overwrites the oldest snapshot
+    latest = (latest + 1) % historyLength;
+    if (numSnapshots < historyLength)
+        numSnapshots++;
+    tags[latest] = DataHistory::newTag();
+    for (int i = 0; i < connectionIOs.size(); i++)
+        connectionIOs[i]->getHistory(DataHistory::TIME_STEP)->snapshot(getData(connectionIOs[i]),
+                tags[latest]);
+
+    computeWeights(numSnapshots, &weights[0]);
+
+    // new = sum of weights[k] x (data of the k-th last time step)
+    for (int i = 0; i < connectionIOs.size(); i++) {
+        int size = getDataSize(connectionIOs[i]);
+        double *data = getData(connectionIOs[i]);
+        const DataHistory *history = connectionIOs[i]->getHistory(DataHistory::TIME_STEP);
+        for (int j = 0; j < size; j++)
+            data[j] = 0.0;
+        for (int k = 0; k < numSnapshots; k++) {
+            const double *snapshot = history->find(tags[(latest - k + historyLength) % historyLength]);
+            assert(snapshot != NULL);
+            for (int j = 0; j < size; j++)
+                data[j] += weights[k] * snapshot[j];
+        }
+    }
+}
+
+void AbstractHistoryExtrapolator::writeCheckpoint(CheckpointArchive &archive) const {
+    AbstractExtrapolator::writeCheckpoint(archive);
+    archive.write(numSnapshots);
+    // from the oldest to the latest snapshot
+    for (int k = numSnapshots - 1; k >= 0; k--) {
+        long long tag = tags[(latest - k + historyLength) % historyLength];
+        for (int i = 0; i < connectionIOs.size(); i++)
+            archive.write(connectionIOs[i]->getHistory(DataHistory::TIME_STEP)->find(tag),
+                    getDataSize(connectionIOs[i]));
+    }
+}
+
+void AbstractHistoryExtrapolator::readCheckpoint(CheckpointArchive &archive) {
+    AbstractExtrapolator::readCheckpoint(archive);
+    int numStored;
+    archive.read(numStored);
+    latest = -1;
+    numSnapshots = 0;
+    vector<double> snapshot;
+    for (int k = 0; k < numStored; k++) {
+        latest = (latest + 1) % historyLength;
+        numSnapshots++;
+        tags[latest] = DataHistory::newTag();
+        for (int i = 0; i < connectionIOs.size(); i++) {
+            snapshot.resize(getDataSize(connectionIOs[i]));
+            archive.read(&snapshot[0], snapshot.size());
+            connectionIOs[i]->getHistory(DataHistory::TIME_STEP)->snapshot(&snapshot[0],
+                    tags[latest]);
+        }
+    }
+}
+
+} /* namespace EMPIRE */
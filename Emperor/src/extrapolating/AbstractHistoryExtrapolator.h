@@ -0,0 +1,96 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file AbstractHistoryExtrapolator.h
+ * This file holds the class AbstractHistoryExtrapolator
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef ABSTRACTHISTORYEXTRAPOLATOR_H_
+#define ABSTRACTHISTORYEXTRAPOLATOR_H_
+
+#include "AbstractExtrapolator.h"
+#include <vector>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class AbstractHistoryExtrapolator is the superclass of all extrapolators which predict the
+ *        data of the new time step as a weighted sum of the data of the previous time steps. The
+ *        data of the previous time steps is kept in the time step history of the data fields and
+ *        signals, shared with the other consumers, so no memory is allocated after init().
+ ***********/
+class AbstractHistoryExtrapolator : public AbstractExtrapolator {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _name the name
+     * \param[in] _historyLength the maximum number of previous time steps used for extrapolation
+     ***********/
+    AbstractHistoryExtrapolator(std::string _name, int _historyLength);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~AbstractHistoryExtrapolator();
+    /***********************************************************************************************
+     * \brief initialize the extrapolator after all the connectionIOs are added
+     ***********/
+    void init();
+    /***********************************************************************************************
+     * \brief Do extrapolation
+     ***********/
+    void extrapolate();
+    /***********************************************************************************************
+     * \brief Write the data of the previous time steps in addition
+     * \param[in] archive the archive
+     ***********/
+    void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    void readCheckpoint(CheckpointArchive &archive);
+
+protected:
+    /***********************************************************************************************
+     * \brief Compute the weights of the previous time steps
+     * \param[in] numSteps the number of previous time steps available (1 <= numSteps <= historyLength)
+     * \param[out] _weights weight of each previous time step, the first one is the latest time step
+     ***********/
+    virtual void computeWeights(int numSteps, double *_weights) = 0;
+    /// the maximum number of previous time steps used for extrapolation
+    const int historyLength;
+    /// if unit test, do not show debug message
+    bool unitTest;
+
+private:
+    /// the snapshot tags of the previous time steps, a ring of historyLength tags
+    std::vector<long long> tags;
+    /// position of the latest tag in the ring
+    int latest;
+    /// number of tags in the ring
+    int numSnapshots;
+    /// the weights of the snapshots
+    std::vector<double> weights;
+    /// for unit test
+    friend class TestExtrapolator;
+};
+
+} /* namespace EMPIRE */
+#endif /* ABSTRACTHISTORYEXTRAPOLATOR_H_ */
@@ -0,0 +1,55 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "AdamsBashforthExtrapolator.h"
+#include <assert.h>
+
+using namespace std;
+
+namespace EMPIRE {
+
+/// coefficients of the Adams-Bashforth methods of order 1 to 4, the first one is the latest
+static const double ADAMS_BASHFORTH_COEFFICIENTS[4][4] = { { 1.0, 0.0, 0.0, 0.0 }, { 3.0 / 2.0,
+        -1.0 / 2.0, 0.0, 0.0 }, { 23.0 / 12.0, -16.0 / 12.0, 5.0 / 12.0, 0.0 }, { 55.0 / 24.0, -59.0
+        / 24.0, 37.0 / 24.0, -9.0 / 24.0 } };
+
+AdamsBashforthExtrapolator::AdamsBashforthExtrapolator(std::string _name, int _order) :
+        AbstractHistoryExtrapolator(_name, _order + 1), order(_order) {
+    assert(order >= 1 && order <= MAX_ORDER);
+}
+
+AdamsBashforthExtrapolator::~AdamsBashforthExtrapolator() {
+}
+
+void AdamsBashforthExtrapolator::computeWeights(int numSteps, double *_weights) {
+    assert(numSteps >= 1 && numSteps <= historyLength);
+    for (int k = 0; k < numSteps; k++)
+        _weights[k] = 0.0;
+    _weights[0] = 1.0;
+    // new = data0 + sum of b_j x (data_j - data_j+1)
+    int q = (order < numSteps - 1) ? order : numSteps - 1;
+    for (int j = 0; j < q; j++) {
+        double b = ADAMS_BASHFORTH_COEFFICIENTS[q - 1][j];
+        _weights[j] += b;
+        _weights[j + 1] -= b;
+    }
+}
+
+} /* namespace EMPIRE */
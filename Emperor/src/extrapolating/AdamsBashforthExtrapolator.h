@@ -0,0 +1,69 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file AdamsBashforthExtrapolator.h
+ * This file holds the class AdamsBashforthExtrapolator
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef ADAMSBASHFORTHEXTRAPOLATOR_H_
+#define ADAMSBASHFORTHEXTRAPOLATOR_H_
+
+#include "AbstractHistoryExtrapolator.h"
+
+namespace EMPIRE {
+/********//**
+ * \brief Class AdamsBashforthExtrapolator predicts the new time step by an explicit Adams-Bashforth
+ *        step, where the time derivatives are the backward differences of the previous time steps,
+ *        e.g. order 2 gives "new = data0 + 3/2 x (data0 - data00) - 1/2 x (data00 - data000)".
+ *        While fewer time steps are available, the order is reduced accordingly.
+ ***********/
+class AdamsBashforthExtrapolator : public AbstractHistoryExtrapolator {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _name the name
+     * \param[in] _order the order of the Adams-Bashforth method (1 to 4)
+     ***********/
+    AdamsBashforthExtrapolator(std::string _name, int _order);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~AdamsBashforthExtrapolator();
+
+protected:
+    /***********************************************************************************************
+     * \brief Compute the weights of the previous time steps
+     * \param[in] numSteps the number of previous time steps available
+     * \param[out] _weights weight of each previous time step, the first one is the latest time step
+     ***********/
+    void computeWeights(int numSteps, double *_weights);
+
+private:
+    /// the order of the Adams-Bashforth method
+    const int order;
+    /// the maximum order supported
+    static const int MAX_ORDER = 4;
+    /// for unit test
+    friend class TestExtrapolator;
+};
+
+} /* namespace EMPIRE */
+#endif /* ADAMSBASHFORTHEXTRAPOLATOR_H_ */
@@ -10,40 +10,19 @@ using namespace std;
 namespace EMPIRE {
 
 LinearExtrapolator::LinearExtrapolator(std::string _name) :
-        AbstractExtrapolator(_name), unitTest(false) {
+        AbstractExtrapolator(_name), tag00(0), tag0(0), unitTest(false) {
 }
 
 LinearExtrapolator::~LinearExtrapolator() {
     for (int i = 0; i < connectionIOs.size(); i++) {
         delete connectionIOs[i];
     }
-    for (int i = 0; i < data00.size(); i++) {
-        delete[] data00[i];
-    }
-    for (int i = 0; i < data0.size(); i++) {
-        delete[] data0[i];
-    }
 }
 
 void LinearExtrapolator::init() {
     assert(connectionIOs.size() > 0);
-    for (int i = 0; i < connectionIOs.size(); i++) {
-        if (connectionIOs[i]->type == EMPIRE_ConnectionIO_DataField) {
-            DataField *dataField = connectionIOs[i]->dataField;
-            double *tmp00 = new double[dataField->dimension * dataField->numLocations];
-            data00.push_back(tmp00);
-            double *tmp0 = new double[dataField->dimension * dataField->numLocations];
-            data0.push_back(tmp0);
-        } else if (connectionIOs[i]->type == EMPIRE_ConnectionIO_Signal) {
-            Signal *signal = connectionIOs[i]->signal;
-            double *tmp00 = new double[signal->size];
-            data00.push_back(tmp00);
-            double *tmp0 = new double[signal->size];
-            data0.push_back(tmp0);
-        } else {
-            assert(false);
-        }
-    }
+    for (int i = 0; i < connectionIOs.size(); i++)
+        connectionIOs[i]->getHistory(DataHistory::TIME_STEP)->reserve(2);
 }
 
 void LinearExtrapolator::extrapolate() {
@@ -51,79 +30,59 @@ void LinearExtrapolator::extrapolate() {
         HEADING_OUT(4, "LinearExtrapolator", "doing linear extrapolation ...", infoOut);
     }
 
-    assert(connectionIOs.size() == data0.size());
-    assert(data00.size() == data0.size());
     currentTimeStepNumber++;
-    if (currentTimeStepNumber == 1) {
+    if (currentTimeStepNumber == 1)
         return;
-    } else if (currentTimeStepNumber == 2) {
-        // store the data at time step 1 to data0
-        for (int i = 0; i < connectionIOs.size(); i++) {
-            if (connectionIOs[i]->type == EMPIRE_ConnectionIO_DataField) {
-                DataField *dataField = connectionIOs[i]->dataField;
-                for (int j = 0; j < dataField->dimension * dataField->numLocations; j++) {
-                    data0[i][j] = dataField->data[j];
-                }
-            } else if (connectionIOs[i]->type == EMPIRE_ConnectionIO_Signal) {
-                Signal *signal = connectionIOs[i]->signal;
-                for (int j = 0; j < signal->size; j++) {
-                    data0[i][j] = signal->array[j];
-                }
-            } else {
-                assert(false);
-            }
-        }
-    } else {
-        // store data0 to data00
-        for (int i = 0; i < connectionIOs.size(); i++) {
-            if (connectionIOs[i]->type == EMPIRE_ConnectionIO_DataField) {
-                DataField *dataField = connectionIOs[i]->dataField;
-                for (int j = 0; j < dataField->dimension * dataField->numLocations; j++) {
-                    data00[i][j] = data0[i][j];
-                }
-            } else if (connectionIOs[i]->type == EMPIRE_ConnectionIO_Signal) {
-                Signal *signal = connectionIOs[i]->signal;
-                for (int j = 0; j < signal->size; j++) {
-                    data00[i][j] = data0[i][j];
-                }
-            } else {
-                assert(false);
-            }
-        }
 
-        // store data of last time step to data0
-        for (int i = 0; i < connectionIOs.size(); i++) {
-            if (connectionIOs[i]->type == EMPIRE_ConnectionIO_DataField) {
-                DataField *dataField = connectionIOs[i]->dataField;
-                for (int j = 0; j < dataField->dimension * dataField->numLocations; j++) {
-                    data0[i][j] = dataField->data[j];
-                }
-            } else if (connectionIOs[i]->type == EMPIRE_ConnectionIO_Signal) {
-                Signal *signal = connectionIOs[i]->signal;
-                for (int j = 0; j < signal->size; j++) {
-                    data0[i][j] = signal->array[j];
-                }
-            } else {
-                assert(false);
-            }
-        }
+    // store the data of the last time step, data0 becomes data00
+    tag00 = tag0;
+    tag0 = DataHistory::newTag();
+    for (int i = 0; i < connectionIOs.size(); i++)
+        connectionIOs[i]->getHistory(DataHistory::TIME_STEP)->snapshot(getData(connectionIOs[i]),
+                tag0);
+    if (currentTimeStepNumber == 2)
+        return;
 
-        // do linear extrapolation with formula "new = 2 x data0 - data00"
-        for (int i = 0; i < connectionIOs.size(); i++) {
-            if (connectionIOs[i]->type == EMPIRE_ConnectionIO_DataField) {
-                DataField *dataField = connectionIOs[i]->dataField;
-                for (int j = 0; j < dataField->dimension * dataField->numLocations; j++) {
-                    dataField->data[j] = 2.0 * data0[i][j] - data00[i][j];
-                }
-            } else if (connectionIOs[i]->type == EMPIRE_ConnectionIO_Signal) {
-                Signal *signal = connectionIOs[i]->signal;
-                for (int j = 0; j < signal->size; j++) {
-                    signal->array[j] = 2.0 * data0[i][j] - data00[i][j];
-                    ;
-                }
-            } else {
-                assert(false);
-            }
+    // do linear extrapolation with formula "new = 2 x data0 - data00"
+    for (int i = 0; i < connectionIOs.size(); i++) {
+        const DataHistory *history = connectionIOs[i]->getHistory(DataHistory::TIME_STEP);
+        const double *data0 = history->find(tag0);
+        const double *data00 = history->find(tag00);
+        assert(data0 != NULL && data00 != NULL);
+        int size = getDataSize(connectionIOs[i]);
+        double *data = getData(connectionIOs[i]);
+        for (int j = 0; j < size; j++)
+            data[j] = 2.0 * data0[j] - data00[j];
+    }
+}
+
+void LinearExtrapolator::writeCheckpoint(CheckpointArchive &archive) const {
+    AbstractExtrapolator::writeCheckpoint(archive);
+    // data00 exists from the third time step on, data0 from the second one
+    for (int i = 0; i < connectionIOs.size(); i++) {
+        const DataHistory *history = connectionIOs[i]->getHistory(DataHistory::TIME_STEP);
+        if (currentTimeStepNumber >= 3)
+            archive.write(history->find(tag00), getDataSize(connectionIOs[i]));
+        if (currentTimeStepNumber >= 2)
+            archive.write(history->find(tag0), getDataSize(connectionIOs[i]));
+    }
+}
+
+void LinearExtrapolator::readCheckpoint(CheckpointArchive &archive) {
+    AbstractExtrapolator::readCheckpoint(archive);
+    tag00 = DataHistory::newTag();
+    tag0 = DataHistory::newTag();
+    vector<double> snapshot;
+    for (int i = 0; i < connectionIOs.size(); i++) {
+        DataHistory *history = connectionIOs[i]->getHistory(DataHistory::TIME_STEP);
+        snapshot.resize(getDataSize(connectionIOs[i]));
+        if (currentTimeStepNumber >= 3) {
+            archive.read(&snapshot[0], snapshot.size());
+            history->snapshot(&snapshot[0], tag00);
+        }
+        if (currentTimeStepNumber >= 2) {
+            archive.read(&snapshot[0], snapshot.size());
+            history->snapshot(&snapshot[0], tag0);
         }
     }
 }
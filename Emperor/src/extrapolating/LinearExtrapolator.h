@@ -56,11 +56,21 @@ public:
      * \author Tianyang Wang
      ***********/
     void extrapolate();
+    /***********************************************************************************************
+     * \brief Write the data of the previous time steps in addition
+     * \param[in] archive the archive
+     ***********/
+    void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    void readCheckpoint(CheckpointArchive &archive);
 private:
-    // data of the previous' previous time step
-    std::vector<double*> data00;
-    // data of the previous time step
-    std::vector<double*> data0;
+    /// snapshot tag of the data of the previous' previous time step in the time step history
+    long long tag00;
+    /// snapshot tag of the data of the previous time step in the time step history
+    long long tag0;
     /// if unit test, do not show debug message
     bool unitTest;
     /// for unit test
@@ -0,0 +1,91 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "PolynomialExtrapolator.h"
+#include <assert.h>
+#include <math.h>
+
+using namespace std;
+
+namespace EMPIRE {
+
+PolynomialExtrapolator::PolynomialExtrapolator(std::string _name, int _degree,
+        int _historyLength) :
+        AbstractHistoryExtrapolator(_name, _historyLength), degree(_degree),
+        normalMatrix((_degree + 1) * (_degree + 1)), coefficients(_degree + 1) {
+    assert(degree >= 0);
+    assert(historyLength >= degree + 1);
+}
+
+PolynomialExtrapolator::~PolynomialExtrapolator() {
+}
+
+void PolynomialExtrapolator::computeWeights(int numSteps, double *_weights) {
+    assert(numSteps >= 1 && numSteps <= historyLength);
+    // the k-th last time step is at t=-k, the new one at t=1
+    int p = (degree < numSteps - 1) ? degree : numSteps - 1;
+    int m = p + 1;
+    // normal equations (A^T A) c = e, where A_ka = t_k^a and e_a = 1^a, then the weights are A c
+    for (int a = 0; a < m; a++) {
+        for (int b = 0; b < m; b++) {
+            double sum = 0.0;
+            for (int k = 0; k < numSteps; k++)
+                sum += pow(-(double) k, a + b);
+            normalMatrix[a * m + b] = sum;
+        }
+        coefficients[a] = 1.0;
+    }
+    // Gaussian elimination with partial pivoting
+    for (int a = 0; a < m; a++) {
+        int pivot = a;
+        for (int b = a + 1; b < m; b++)
+            if (fabs(normalMatrix[b * m + a]) > fabs(normalMatrix[pivot * m + a]))
+                pivot = b;
+        if (pivot != a) {
+            for (int b = 0; b < m; b++) {
+                double tmp = normalMatrix[a * m + b];
+                normalMatrix[a * m + b] = normalMatrix[pivot * m + b];
+                normalMatrix[pivot * m + b] = tmp;
+            }
+            double tmp = coefficients[a];
+            coefficients[a] = coefficients[pivot];
+            coefficients[pivot] = tmp;
+        }
+        for (int b = a + 1; b < m; b++) {
+            double factor = normalMatrix[b * m + a] / normalMatrix[a * m + a];
+            for (int c = a; c < m; c++)
+                normalMatrix[b * m + c] -= factor * normalMatrix[a * m + c];
+            coefficients[b] -= factor * coefficients[a];
+        }
+    }
+    for (int a = m - 1; a >= 0; a--) {
+        for (int b = a + 1; b < m; b++)
+            coefficients[a] -= normalMatrix[a * m + b] * coefficients[b];
+        coefficients[a] /= normalMatrix[a * m + a];
+    }
+    for (int k = 0; k < numSteps; k++) {
+        double weight = 0.0;
+        for (int a = 0; a < m; a++)
+            weight += coefficients[a] * pow(-(double) k, a);
+        _weights[k] = weight;
+    }
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,74 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file PolynomialExtrapolator.h
+ * This file holds the class PolynomialExtrapolator
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef POLYNOMIALEXTRAPOLATOR_H_
+#define POLYNOMIALEXTRAPOLATOR_H_
+
+#include "AbstractHistoryExtrapolator.h"
+#include <vector>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class PolynomialExtrapolator fits a polynomial of a certain degree to the data of the
+ *        previous time steps in the least squares sense, and evaluates it at the new time step.
+ *        If the history length is degree+1, the polynomial interpolates the data, e.g. degree 2
+ *        gives the quadratic extrapolation "new = 3 x data0 - 3 x data00 + data000". While fewer
+ *        time steps are available, the degree is reduced accordingly.
+ ***********/
+class PolynomialExtrapolator : public AbstractHistoryExtrapolator {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _name the name
+     * \param[in] _degree the degree of the polynomial
+     * \param[in] _historyLength the number of previous time steps fitted (at least _degree+1)
+     ***********/
+    PolynomialExtrapolator(std::string _name, int _degree, int _historyLength);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~PolynomialExtrapolator();
+
+protected:
+    /***********************************************************************************************
+     * \brief Compute the weights of the previous time steps
+     * \param[in] numSteps the number of previous time steps available
+     * \param[out] _weights weight of each previous time step, the first one is the latest time step
+     ***********/
+    void computeWeights(int numSteps, double *_weights);
+
+private:
+    /// the degree of the polynomial
+    const int degree;
+    /// normal matrix of the least squares fit
+    std::vector<double> normalMatrix;
+    /// coefficients of the polynomial which gives the weights
+    std::vector<double> coefficients;
+    /// for unit test
+    friend class TestExtrapolator;
+};
+
+} /* namespace EMPIRE */
+#endif /* POLYNOMIALEXTRAPOLATOR_H_ */
@@ -0,0 +1,214 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <assert.h>
+#include "stdlib.h"
+
+#include "ADIOS2StreamIO.h"
+
+#ifdef USE_ADIOS2
+#include <adios2.h>
+#endif
+
+using namespace std;
+
+namespace ADIOS2StreamIO {
+
+#ifdef USE_ADIOS2
+/********//**
+ * \brief Struct Stream holds the ADIOS2 objects of a writer
+ ***********/
+struct Writer::Stream {
+    adios2::ADIOS adios;
+    adios2::IO io;
+    adios2::Engine engine;
+};
+
+/***********************************************************************************************
+ * \brief Get a 2D variable of constant dimensions, define it at its first use
+ ***********/
+template<class T>
+static adios2::Variable<T> getVariable(adios2::IO &io, const string &name, size_t rows,
+        size_t cols) {
+    adios2::Variable<T> variable = io.InquireVariable<T>(name);
+    if (!variable) {
+        adios2::Dims shape(2);
+        shape[0] = rows;
+        shape[1] = cols;
+        adios2::Dims start(2, 0);
+        variable = io.DefineVariable<T>(name, shape, start, shape, adios2::ConstantDims);
+    }
+    return variable;
+}
+
+/***********************************************************************************************
+ * \brief Put a 2D array into the current step, the data are copied before returning
+ ***********/
+template<class T>
+static void putArray(adios2::IO &io, adios2::Engine &engine, const string &name, size_t rows,
+        size_t cols, const T *data) {
+    if (rows == 0 || cols == 0)
+        return;
+    adios2::Variable<T> variable = getVariable<T>(io, name, rows, cols);
+    engine.Put(variable, data, adios2::Mode::Sync);
+}
+
+Writer::Writer(string _streamName, string engineType, int queueLimit) :
+        streamName(_streamName), currentStep(-1) {
+    stream = new Stream;
+    try {
+        stream->io = stream->adios.DeclareIO(streamName);
+        stream->io.SetEngine(engineType);
+        if (engineType == "SST" || engineType == "sst") {
+            // the co-simulation never waits for the readers
+            stream->io.SetParameter("RendezvousReaderCount", "0");
+            stringstream ss;
+            ss << (queueLimit > 0 ? queueLimit : 1);
+            stream->io.SetParameter("QueueLimit", ss.str());
+            stream->io.SetParameter("QueueFullPolicy", "Discard");
+        }
+        stream->engine = stream->io.Open(streamName, adios2::Mode::Write);
+    } catch (std::exception &e) {
+        cerr << "ADIOS2StreamIO: cannot open stream " << streamName << ": " << e.what() << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+Writer::~Writer() {
+    if (currentStep >= 0)
+        endStep();
+    stream->engine.Close();
+    delete stream;
+}
+
+void Writer::writeFEMesh(int numNodes, const double *_nodes, const int *_nodeIDs, int numElems,
+        const int *_numNodesPerElem, const int *elems, const int *_elemIDs) {
+    nodes.assign(_nodes, _nodes + numNodes * 3);
+    nodeIDs.assign(_nodeIDs, _nodeIDs + numNodes);
+    elemIDs.assign(_elemIDs, _elemIDs + numElems);
+    numNodesPerElem.assign(_numNodesPerElem, _numNodesPerElem + numElems);
+    map<int, int> nodeIDToPosition;
+    for (int i = 0; i < numNodes; i++)
+        nodeIDToPosition[nodeIDs[i]] = i;
+    elemNodePositions.clear();
+    int count = 0;
+    for (int i = 0; i < numElems; i++)
+        for (int j = 0; j < numNodesPerElem[i]; j++)
+            elemNodePositions.push_back(nodeIDToPosition[elems[count++]]);
+}
+
+void Writer::updateNodes(const double *_nodes) {
+    nodes.assign(_nodes, _nodes + nodes.size());
+}
+
+void Writer::beginStep(int stepNum) {
+    assert(currentStep < 0);
+    stream->engine.BeginStep();
+    currentStep = stepNum;
+    adios2::Variable<int> step = stream->io.InquireVariable<int>("step");
+    if (!step)
+        step = stream->io.DefineVariable<int>("step");
+    stream->engine.Put(step, currentStep, adios2::Mode::Sync);
+}
+
+void Writer::appendData(string resultName, int stepNum, bool atNode, int numComponents,
+        int numLocations, const double *data) {
+    assert(stepNum == currentStep);
+    string name = "results/" + resultName;
+    bool isNewResult = !stream->io.InquireVariable<double>(name);
+    putArray(stream->io, stream->engine, name, numLocations, numComponents, data);
+    if (isNewResult)
+        stream->io.DefineAttribute<string>("location", (atNode ? "node" : "element"), name);
+}
+
+void Writer::appendSignal(string signalName, int size, const double *data) {
+    assert(currentStep >= 0);
+    putArray(stream->io, stream->engine, "signals/" + signalName, 1, size, data);
+}
+
+void Writer::endStep() {
+    assert(currentStep >= 0);
+    // the mesh is in every step, such that readers can connect at any time
+    if (!nodeIDs.empty()) {
+        putArray(stream->io, stream->engine, "mesh/nodes", nodeIDs.size(), 3, &nodes[0]);
+        putArray(stream->io, stream->engine, "mesh/nodeIDs", nodeIDs.size(), 1,
+                &nodeIDs[0]);
+    }
+    if (!elemIDs.empty()) {
+        putArray(stream->io, stream->engine, "mesh/elemIDs", elemIDs.size(), 1, &elemIDs[0]);
+        putArray(stream->io, stream->engine, "mesh/numNodesPerElem", numNodesPerElem.size(), 1,
+                &numNodesPerElem[0]);
+        putArray(stream->io, stream->engine, "mesh/elems", elemNodePositions.size(), 1,
+                &elemNodePositions[0]);
+    }
+    stream->engine.EndStep();
+    currentStep = -1;
+}
+
+#else /* USE_ADIOS2 */
+/***********************************************************************************************
+ * \brief Exit since EMPIRE is built without ADIOS2
+ ***********/
+static void exitWithoutADIOS2() {
+    cerr << "ADIOS2StreamIO: EMPIRE is built without ADIOS2, reconfigure with USE_ADIOS2=ON"
+            << endl;
+    exit(EXIT_FAILURE);
+}
+
+Writer::Writer(string _streamName, string engineType, int queueLimit) :
+        streamName(_streamName), stream(NULL), currentStep(-1) {
+    exitWithoutADIOS2();
+}
+
+Writer::~Writer() {
+}
+
+void Writer::writeFEMesh(int numNodes, const double *_nodes, const int *_nodeIDs, int numElems,
+        const int *_numNodesPerElem, const int *elems, const int *_elemIDs) {
+    exitWithoutADIOS2();
+}
+
+void Writer::updateNodes(const double *_nodes) {
+    exitWithoutADIOS2();
+}
+
+void Writer::beginStep(int stepNum) {
+    exitWithoutADIOS2();
+}
+
+void Writer::appendData(string resultName, int stepNum, bool atNode, int numComponents,
+        int numLocations, const double *data) {
+    exitWithoutADIOS2();
+}
+
+void Writer::appendSignal(string signalName, int size, const double *data) {
+    exitWithoutADIOS2();
+}
+
+void Writer::endStep() {
+    exitWithoutADIOS2();
+}
+#endif /* USE_ADIOS2 */
+
+} /* namespace ADIOS2StreamIO */
@@ -0,0 +1,135 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file ADIOS2StreamIO.h
+ * This file holds the ADIOS2 result stream. Instead of files, the results are published step by
+ * step to an ADIOS2 engine, by default the SST staging engine, from which consumers on other nodes
+ * (e.g. ParaView or a post-processing job) read them while the co-simulation runs. One stream holds
+ * a mesh and all data written on it, every step contains:
+ *  - step: the step number
+ *  - mesh/nodes: the node coordinates, numNodes x 3
+ *  - mesh/nodeIDs, mesh/elemIDs, mesh/numNodesPerElem: the IDs and the element sizes
+ *  - mesh/elems: the elements by node positions
+ *  - results/<name>: one variable per result, numLocations x numComponents, its attribute location
+ *    is "node" or "element"
+ * A stream of signals holds signals/<name> instead.
+ * The SST writer neither waits for readers to connect nor for slow readers, the steps no reader has
+ * taken are discarded when the queue of the stream is full.
+ * If EMPIRE is built without USE_ADIOS2, creating a writer is an error.
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef ADIOS2STREAMIO_H_
+#define ADIOS2STREAMIO_H_
+
+#include <string>
+#include <vector>
+
+namespace ADIOS2StreamIO {
+/********//**
+ * \brief Class Writer publishes the steps of a mesh and its results, or of signals, to an ADIOS2
+ *        stream. A step is written by beginStep, appendData or appendSignal, and endStep.
+ ***********/
+class Writer {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, opens the stream
+     * \param[in] streamName name of the stream, the readers open it by this name
+     * \param[in] engineType the ADIOS2 engine, e.g. SST for staging or BP5 for files
+     * \param[in] queueLimit the number of steps the SST engine queues for slow readers
+     ***********/
+    Writer(std::string streamName, std::string engineType, int queueLimit);
+    /***********************************************************************************************
+     * \brief Destructor, ends an open step and closes the stream
+     ***********/
+    virtual ~Writer();
+    /***********************************************************************************************
+     * \brief Set the FE mesh published with every step, the node IDs in elems are converted to node
+     *        positions
+     * \param[in] numNodes number of nodes
+     * \param[in] nodes coordinates of the nodes
+     * \param[in] nodeIDs IDs of the nodes
+     * \param[in] numElems number of elements
+     * \param[in] numNodesPerElem number of nodes of each element
+     * \param[in] elems the nodes IDs of all elements
+     * \param[in] elemIDs IDs of the elements
+     ***********/
+    void writeFEMesh(int numNodes, const double *nodes, const int *nodeIDs, int numElems,
+            const int *numNodesPerElem, const int *elems, const int *elemIDs);
+    /***********************************************************************************************
+     * \brief Update the node coordinates of the mesh, e.g. of a moving mesh, before endStep
+     * \param[in] nodes coordinates of the nodes
+     ***********/
+    void updateNodes(const double *nodes);
+    /***********************************************************************************************
+     * \brief Begin a step
+     * \param[in] stepNum step number
+     ***********/
+    void beginStep(int stepNum);
+    /***********************************************************************************************
+     * \brief Write data of the current step
+     * \param[in] resultName name of the data
+     * \param[in] stepNum step number, the one passed to beginStep
+     * \param[in] atNode true for data on nodes, false for elemental data
+     * \param[in] numComponents number of components per location (1 or 3)
+     * \param[in] numLocations number of nodes or elements
+     * \param[in] data data of this step, copied before returning
+     ***********/
+    void appendData(std::string resultName, int stepNum, bool atNode, int numComponents,
+            int numLocations, const double *data);
+    /***********************************************************************************************
+     * \brief Write a signal in the current step
+     * \param[in] signalName name of the signal
+     * \param[in] size number of doubles of the signal
+     * \param[in] data the signal, copied before returning
+     ***********/
+    void appendSignal(std::string signalName, int size, const double *data);
+    /***********************************************************************************************
+     * \brief End the current step, which publishes it together with the mesh
+     ***********/
+    void endStep();
+
+private:
+    /// the ADIOS2 objects, hidden from the users of the writer
+    struct Stream;
+    /// name of the stream
+    std::string streamName;
+    /// the ADIOS2 objects of the stream
+    Stream *stream;
+    /// the step begun by beginStep, -1 if no step is open
+    int currentStep;
+    /// coordinates of the nodes
+    std::vector<double> nodes;
+    /// IDs of the nodes
+    std::vector<int> nodeIDs;
+    /// IDs of the elements
+    std::vector<int> elemIDs;
+    /// number of nodes of each element
+    std::vector<int> numNodesPerElem;
+    /// the elements by node positions
+    std::vector<int> elemNodePositions;
+    /// disallow copy constructor
+    Writer(const Writer&);
+    /// disallow assignment operator
+    Writer& operator=(const Writer&);
+};
+
+} /* namespace ADIOS2StreamIO */
+#endif /* ADIOS2STREAMIO_H_ */
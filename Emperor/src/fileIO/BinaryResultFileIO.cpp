@@ -0,0 +1,394 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <map>
+#include <assert.h>
+#include <string.h>
+#include <stddef.h>
+#include "stdlib.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "BinaryResultFileIO.h"
+#include "GiDFileIO.h"
+
+using namespace std;
+
+namespace BinaryResultFileIO {
+/// magic number at the beginning of every binary result file
+const char MAGIC[8] = { 'E', 'M', 'P', 'I', 'R', 'E', 'R', 'B' };
+/// version of the file format
+const int32_t VERSION = 1;
+/// the analysis name used in the converted GiD files
+const string ANALYSIS_NAME = "\"EMPIRE_CoSimulation\"";
+
+/********//**
+ * \brief Structure FileHeader is the header of a binary result file as stored on disk
+ ***********/
+struct FileHeader {
+    char magic[8];
+    int32_t version;
+    int32_t numNodes;
+    int32_t numElems;
+    int32_t reserved;
+    /// offset of the record index, 0 if the file has not been closed properly
+    int64_t indexOffset;
+    int64_t numRecords;
+};
+
+/********//**
+ * \brief Structure RecordHeader is the header of a record as stored on disk
+ ***********/
+struct RecordHeader {
+    char resultName[NAME_LENGTH];
+    int32_t stepNum;
+    /// 0 for nodal data, 1 for elemental data
+    int32_t location;
+    int32_t numComponents;
+    int32_t numLocations;
+};
+
+Writer::Writer(string _fileName, int numNodes, const int *nodeIDs, int numElems,
+        const int *elemIDs, const int *numNodesPerElem) :
+        fileName(_fileName), endOffset(0) {
+    fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        cerr << "BinaryResultFileIO::Writer: file \"" << fileName << "\" cannot be created" << '\n';
+        exit(EXIT_FAILURE);
+    }
+    FileHeader header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.numNodes = numNodes;
+    header.numElems = numElems;
+    header.reserved = 0;
+    header.indexOffset = 0;
+    header.numRecords = 0;
+    writeAt(&header, sizeof(header), 0);
+    endOffset = sizeof(header);
+
+    writeIDs(nodeIDs, numNodes);
+    writeIDs(elemIDs, numElems);
+    writeIDs(numNodesPerElem, numElems);
+}
+
+Writer::~Writer() {
+    const int64_t numRecords = recordOffsets.size();
+    if (numRecords > 0)
+        writeAt(&recordOffsets[0], numRecords * sizeof(int64_t), endOffset);
+    // indexOffset and numRecords are the last members of FileHeader
+    int64_t index[2] = { endOffset, numRecords };
+    writeAt(index, sizeof(index), offsetof(FileHeader, indexOffset));
+    close(fd);
+}
+
+void Writer::appendData(string resultName, int stepNum, bool atNode, int numComponents,
+        int numLocations, const double *data) {
+    if (resultName.size() >= NAME_LENGTH) {
+        cerr << "BinaryResultFileIO::Writer: result name \"" << resultName << "\" is longer than "
+                << NAME_LENGTH - 1 << " characters" << '\n';
+        exit(EXIT_FAILURE);
+    }
+    RecordHeader recordHeader;
+    memset(recordHeader.resultName, 0, NAME_LENGTH);
+    strncpy(recordHeader.resultName, resultName.c_str(), NAME_LENGTH - 1);
+    recordHeader.stepNum = stepNum;
+    recordHeader.location = (atNode ? 0 : 1);
+    recordHeader.numComponents = numComponents;
+    recordHeader.numLocations = numLocations;
+
+    const int64_t dataSize = (int64_t) numLocations * numComponents * sizeof(double);
+    writeAt(&recordHeader, sizeof(recordHeader), endOffset);
+    writeAt(data, dataSize, endOffset + sizeof(recordHeader));
+    recordOffsets.push_back(endOffset);
+    endOffset += sizeof(recordHeader) + dataSize;
+}
+
+void Writer::writeIDs(const int *ids, int numIDs) {
+    if (numIDs == 0)
+        return;
+    vector<int32_t> ids32(ids, ids + numIDs);
+    writeAt(&ids32[0], numIDs * sizeof(int32_t), endOffset);
+    endOffset += numIDs * sizeof(int32_t);
+}
+
+void Writer::writeAt(const void *buffer, int64_t size, int64_t offset) {
+    const char *bytes = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, offset);
+        if (written < 0) {
+            cerr << "BinaryResultFileIO::Writer: writing to file \"" << fileName << "\" failed"
+                    << '\n';
+            exit(EXIT_FAILURE);
+        }
+        bytes += written;
+        size -= written;
+        offset += written;
+    }
+}
+
+Reader::Reader(string _fileName) :
+        fileName(_fileName) {
+    fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "BinaryResultFileIO::Reader: file \"" << fileName << "\" cannot be found" << '\n';
+        exit(EXIT_FAILURE);
+    }
+    FileHeader header;
+    readAt(&header, sizeof(header), 0);
+    if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        cerr << "BinaryResultFileIO::Reader: file \"" << fileName
+                << "\" is not a binary result file of this version" << '\n';
+        exit(EXIT_FAILURE);
+    }
+    int64_t offset = sizeof(header);
+    readIDs(nodeIDs, header.numNodes, offset);
+    readIDs(elemIDs, header.numElems, offset);
+    readIDs(numNodesPerElem, header.numElems, offset);
+
+    vector<int64_t> recordOffsets;
+    if (header.indexOffset != 0 && header.numRecords > 0) {
+        recordOffsets.resize(header.numRecords);
+        readAt(&recordOffsets[0], header.numRecords * sizeof(int64_t), header.indexOffset);
+    }
+    struct stat fileStatus;
+    fstat(fd, &fileStatus);
+    const int64_t end = (header.indexOffset != 0 ? header.indexOffset : fileStatus.st_size);
+    for (int i = 0; header.indexOffset == 0 || i < header.numRecords; i++) {
+        if (header.indexOffset != 0)
+            offset = recordOffsets[i];
+        else if (offset + (int64_t) sizeof(RecordHeader) > end) // scan the file without index
+            break;
+        RecordHeader recordHeader;
+        readAt(&recordHeader, sizeof(recordHeader), offset);
+        recordHeader.resultName[NAME_LENGTH - 1] = '\0';
+        Record record;
+        record.resultName = recordHeader.resultName;
+        record.stepNum = recordHeader.stepNum;
+        record.atNode = (recordHeader.location == 0);
+        record.numComponents = recordHeader.numComponents;
+        record.numLocations = recordHeader.numLocations;
+        record.dataOffset = offset + sizeof(recordHeader);
+        offset = record.dataOffset
+                + (int64_t) record.numLocations * record.numComponents * sizeof(double);
+        if (offset > end) // the last record of an aborted run may be incomplete
+            break;
+        records.push_back(record);
+    }
+}
+
+Reader::~Reader() {
+    close(fd);
+}
+
+void Reader::readData(const Record &record, double *data) const {
+    readAt(data, (int64_t) record.numLocations * record.numComponents * sizeof(double),
+            record.dataOffset);
+}
+
+void Reader::readIDs(vector<int> &ids, int numIDs, int64_t &offset) const {
+    if (numIDs == 0)
+        return;
+    vector<int32_t> ids32(numIDs);
+    readAt(&ids32[0], numIDs * sizeof(int32_t), offset);
+    ids.assign(ids32.begin(), ids32.end());
+    offset += numIDs * sizeof(int32_t);
+}
+
+void Reader::readAt(void *buffer, int64_t size, int64_t offset) const {
+    char *bytes = static_cast<char*>(buffer);
+    while (size > 0) {
+        ssize_t numRead = pread(fd, bytes, size, offset);
+        if (numRead <= 0) {
+            cerr << "BinaryResultFileIO::Reader: reading from file \"" << fileName << "\" failed"
+                    << '\n';
+            exit(EXIT_FAILURE);
+        }
+        bytes += numRead;
+        size -= numRead;
+        offset += numRead;
+    }
+}
+
+void convertToDotRes(string binFileName, string resFileName) {
+    Reader reader(binFileName);
+    GiDFileIO::initDotRes(resFileName);
+    for (int i = 0; i < reader.records.size(); i++) {
+        const Record &record = reader.records[i];
+        double *data = new double[record.numLocations * record.numComponents];
+        reader.readData(record, data);
+        string type = (record.numComponents == 1 ? "Scalar" : "Vector");
+        string resultName = "\"" + record.resultName + "\"";
+        if (record.atNode) {
+            assert(record.numLocations == reader.nodeIDs.size());
+            GiDFileIO::appendNodalDataToDotRes(resFileName, resultName, ANALYSIS_NAME,
+                    record.stepNum, type, record.numLocations, &reader.nodeIDs[0], data);
+        } else {
+            assert(record.numLocations == reader.elemIDs.size());
+            GiDFileIO::appendElementalDataToDotRes(resFileName, resultName, ANALYSIS_NAME,
+                    record.stepNum, type, record.numLocations, &reader.elemIDs[0],
+                    &reader.numNodesPerElem[0], data);
+        }
+        delete[] data;
+    }
+}
+
+/***********************************************************************************************
+ * \brief Write the data of a record to a VTK file, reordered to the order of the mesh file.
+ *        Locations which are not in the mesh file (recordToMeshPos is -1) are skipped.
+ ***********/
+static void writeVTKData(ostream &vtkFile, const Record &record, const double *data,
+        const vector<int> &recordToMeshPos, int numMeshLocations) {
+    string name = record.resultName;
+    for (int i = 0; i < name.size(); i++)
+        if (name[i] == ' ')
+            name[i] = '_';
+    const int numComponents = record.numComponents;
+    vector<double> meshData(numMeshLocations * numComponents, 0.0);
+    for (int i = 0; i < record.numLocations; i++)
+        if (recordToMeshPos[i] >= 0)
+            for (int j = 0; j < numComponents; j++)
+                meshData[recordToMeshPos[i] * numComponents + j] = data[i * numComponents + j];
+    if (numComponents == 1)
+        vtkFile << "SCALARS " << name << " double 1" << '\n' << "LOOKUP_TABLE default" << '\n';
+    else
+        vtkFile << "VECTORS " << name << " double" << '\n';
+    for (int i = 0; i < numMeshLocations; i++) {
+        for (int j = 0; j < numComponents; j++)
+            vtkFile << (j == 0 ? "" : " ") << meshData[i * numComponents + j];
+        vtkFile << '\n';
+    }
+}
+
+void convertToVTK(string binFileName, string mshFileName, string vtkFileBaseName) {
+    Reader reader(binFileName);
+    int numNodes, numElems;
+    double *nodes;
+    int *nodeIDs, *numNodesPerElem, *elems, *elemIDs;
+    GiDFileIO::readDotMsh(mshFileName, numNodes, numElems, nodes, nodeIDs, numNodesPerElem, elems,
+            elemIDs);
+
+    map<int, int> nodeIDToPos;
+    for (int i = 0; i < numNodes; i++)
+        nodeIDToPos[nodeIDs[i]] = i;
+    map<int, int> elemIDToPos;
+    for (int i = 0; i < numElems; i++)
+        elemIDToPos[elemIDs[i]] = i;
+    // nodes which do not belong to any element are not in the mesh file
+    vector<int> recordNodeToMeshPos(reader.nodeIDs.size(), -1);
+    for (int i = 0; i < reader.nodeIDs.size(); i++)
+        if (nodeIDToPos.find(reader.nodeIDs[i]) != nodeIDToPos.end())
+            recordNodeToMeshPos[i] = nodeIDToPos[reader.nodeIDs[i]];
+    vector<int> recordElemToMeshPos(reader.elemIDs.size(), -1);
+    for (int i = 0; i < reader.elemIDs.size(); i++)
+        if (elemIDToPos.find(reader.elemIDs[i]) != elemIDToPos.end())
+            recordElemToMeshPos[i] = elemIDToPos[reader.elemIDs[i]];
+
+    map<int, vector<int> > stepToRecords;
+    for (int i = 0; i < reader.records.size(); i++)
+        stepToRecords[reader.records[i].stepNum].push_back(i);
+
+    for (map<int, vector<int> >::iterator it = stepToRecords.begin(); it != stepToRecords.end();
+            it++) {
+        stringstream vtkFileName;
+        vtkFileName << vtkFileBaseName << "_" << it->first << ".vtk";
+        ofstream vtkFile(vtkFileName.str().c_str());
+        if (!vtkFile) {
+            cerr << "BinaryResultFileIO::convertToVTK: file \"" << vtkFileName.str()
+                    << "\" cannot be created" << '\n';
+            exit(EXIT_FAILURE);
+        }
+        vtkFile << setprecision(12);
+        vtkFile << "# vtk DataFile Version 3.0" << '\n';
+        vtkFile << "EMPIRE results of step " << it->first << '\n';
+        vtkFile << "ASCII" << '\n';
+        vtkFile << "DATASET UNSTRUCTURED_GRID" << '\n';
+        vtkFile << "POINTS " << numNodes << " double" << '\n';
+        for (int i = 0; i < numNodes; i++)
+            vtkFile << nodes[i * 3 + 0] << " " << nodes[i * 3 + 1] << " " << nodes[i * 3 + 2]
+                    << '\n';
+        int cellListSize = 0;
+        for (int i = 0; i < numElems; i++)
+            cellListSize += numNodesPerElem[i] + 1;
+        vtkFile << "CELLS " << numElems << " " << cellListSize << '\n';
+        int count = 0;
+        for (int i = 0; i < numElems; i++) {
+            vtkFile << numNodesPerElem[i];
+            for (int j = 0; j < numNodesPerElem[i]; j++)
+                vtkFile << " " << nodeIDToPos[elems[count + j]];
+            count += numNodesPerElem[i];
+            vtkFile << '\n';
+        }
+        vtkFile << "CELL_TYPES " << numElems << '\n';
+        for (int i = 0; i < numElems; i++) {
+            if (numNodesPerElem[i] == 2)
+                vtkFile << 3 << '\n'; // VTK_LINE
+            else if (numNodesPerElem[i] == 3)
+                vtkFile << 5 << '\n'; // VTK_TRIANGLE
+            else if (numNodesPerElem[i] == 4)
+                vtkFile << 9 << '\n'; // VTK_QUAD
+            else
+                vtkFile << 7 << '\n'; // VTK_POLYGON
+        }
+
+        const vector<int> &records = it->second;
+        bool pointDataStarted = false;
+        for (int i = 0; i < records.size(); i++) {
+            const Record &record = reader.records[records[i]];
+            if (!record.atNode)
+                continue;
+            if (!pointDataStarted)
+                vtkFile << "POINT_DATA " << numNodes << '\n';
+            pointDataStarted = true;
+            double *data = new double[record.numLocations * record.numComponents];
+            reader.readData(record, data);
+            writeVTKData(vtkFile, record, data, recordNodeToMeshPos, numNodes);
+            delete[] data;
+        }
+        bool cellDataStarted = false;
+        for (int i = 0; i < records.size(); i++) {
+            const Record &record = reader.records[records[i]];
+            if (record.atNode)
+                continue;
+            if (!cellDataStarted)
+                vtkFile << "CELL_DATA " << numElems << '\n';
+            cellDataStarted = true;
+            double *data = new double[record.numLocations * record.numComponents];
+            reader.readData(record, data);
+            writeVTKData(vtkFile, record, data, recordElemToMeshPos, numElems);
+            delete[] data;
+        }
+        vtkFile.close();
+    }
+
+    delete[] nodes;
+    delete[] nodeIDs;
+    delete[] numNodesPerElem;
+    delete[] elems;
+    delete[] elemIDs;
+}
+
+} /* namespace BinaryResultFileIO */
@@ -0,0 +1,180 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file BinaryResultFileIO.h
+ * This file holds the binary result file format, an alternative to the GiD .res format which avoids
+ * formatting every double as text and reopening the file at every output step. The file
+ * consists of
+ *  - a header (magic number, version, number of nodes and elements, offset of the record index),
+ *  - the node IDs, the element IDs and the number of nodes of each element,
+ *  - one record per result and step: a record header followed by the raw double array,
+ *  - the record index, i.e. the offsets of all records, written when the file is closed.
+ * If the index is missing (e.g. the run was aborted), the records are found by scanning the file.
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef BINARYRESULTFILEIO_H_
+#define BINARYRESULTFILEIO_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace BinaryResultFileIO {
+/// length of the result name in a record header, including the terminating zero
+const int NAME_LENGTH = 64;
+/********//**
+ * \brief Class Writer writes a binary result file. The file stays open until the writer is
+ *        deleted, and every record is written with pwrite at its final offset.
+ ***********/
+class Writer {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, creates the file and writes the header and the IDs
+     * \param[in] fileName name of the result file
+     * \param[in] numNodes number of nodes
+     * \param[in] nodeIDs IDs of the nodes
+     * \param[in] numElems number of elements
+     * \param[in] elemIDs IDs of the elements
+     * \param[in] numNodesPerElem number of nodes of each element
+     ***********/
+    Writer(std::string fileName, int numNodes, const int *nodeIDs, int numElems,
+            const int *elemIDs, const int *numNodesPerElem);
+    /***********************************************************************************************
+     * \brief Destructor, writes the record index and closes the file
+     ***********/
+    virtual ~Writer();
+    /***********************************************************************************************
+     * \brief Append data of a certain step
+     * \param[in] resultName name of the data
+     * \param[in] stepNum step number
+     * \param[in] atNode true for nodal data, false for elemental data
+     * \param[in] numComponents number of components per location (1 or 3)
+     * \param[in] numLocations number of nodes or elements
+     * \param[in] data data of this step
+     ***********/
+    void appendData(std::string resultName, int stepNum, bool atNode, int numComponents,
+            int numLocations, const double *data);
+
+private:
+    /// name of the file
+    std::string fileName;
+    /// file descriptor
+    int fd;
+    /// offset where the next record is written
+    int64_t endOffset;
+    /// offsets of all records written so far
+    std::vector<int64_t> recordOffsets;
+    /***********************************************************************************************
+     * \brief Write an ID array at endOffset
+     ***********/
+    void writeIDs(const int *ids, int numIDs);
+    /***********************************************************************************************
+     * \brief Write a buffer at an offset, exit on failure
+     ***********/
+    void writeAt(const void *buffer, int64_t size, int64_t offset);
+    /// disallow copy constructor
+    Writer(const Writer&);
+    /// disallow assignment operator
+    Writer& operator=(const Writer&);
+};
+
+/********//**
+ * \brief Structure Record describes one record of a binary result file
+ ***********/
+struct Record {
+    /// name of the data
+    std::string resultName;
+    /// step number
+    int stepNum;
+    /// true for nodal data, false for elemental data
+    bool atNode;
+    /// number of components per location
+    int numComponents;
+    /// number of nodes or elements
+    int numLocations;
+    /// offset of the data in the file
+    int64_t dataOffset;
+};
+
+/********//**
+ * \brief Class Reader reads a binary result file written by Writer
+ ***********/
+class Reader {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, reads the header, the IDs and the record list
+     * \param[in] fileName name of the result file
+     ***********/
+    Reader(std::string fileName);
+    /***********************************************************************************************
+     * \brief Destructor, closes the file
+     ***********/
+    virtual ~Reader();
+    /// IDs of the nodes
+    std::vector<int> nodeIDs;
+    /// IDs of the elements
+    std::vector<int> elemIDs;
+    /// number of nodes of each element
+    std::vector<int> numNodesPerElem;
+    /// all records in the order they were written
+    std::vector<Record> records;
+    /***********************************************************************************************
+     * \brief Read the data of a record
+     * \param[in] record the record
+     * \param[out] data the data, of size numLocations * numComponents
+     ***********/
+    void readData(const Record &record, double *data) const;
+
+private:
+    /// name of the file
+    std::string fileName;
+    /// file descriptor
+    int fd;
+    /***********************************************************************************************
+     * \brief Read an ID array at offset and move offset behind it
+     ***********/
+    void readIDs(std::vector<int> &ids, int numIDs, int64_t &offset) const;
+    /***********************************************************************************************
+     * \brief Read a buffer at an offset, exit on failure
+     ***********/
+    void readAt(void *buffer, int64_t size, int64_t offset) const;
+    /// disallow copy constructor
+    Reader(const Reader&);
+    /// disallow assignment operator
+    Reader& operator=(const Reader&);
+};
+
+/***********************************************************************************************
+ * \brief Convert a binary result file to a GiD .res file
+ * \param[in] binFileName name of the binary result file
+ * \param[in] resFileName name of the GiD result file
+ ***********/
+void convertToDotRes(std::string binFileName, std::string resFileName);
+/***********************************************************************************************
+ * \brief Convert a binary result file to legacy VTK files, one per step
+ * \param[in] binFileName name of the binary result file
+ * \param[in] mshFileName name of the GiD mesh file written by the same data output
+ * \param[in] vtkFileBaseName the file of step i is named vtkFileBaseName_i.vtk
+ ***********/
+void convertToVTK(std::string binFileName, std::string mshFileName, std::string vtkFileBaseName);
+
+} /* namespace BinaryResultFileIO */
+#endif /* BINARYRESULTFILEIO_H_ */
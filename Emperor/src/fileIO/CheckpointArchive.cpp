@@ -0,0 +1,142 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "CheckpointArchive.h"
+#include "Message.h"
+#include <sstream>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+using namespace std;
+
+namespace EMPIRE {
+
+CheckpointArchive::CheckpointArchive(std::string _name) :
+        name(_name), position(0) {
+}
+
+CheckpointArchive::CheckpointArchive(std::string _name, const std::vector<char> &_buffer) :
+        name(_name), buffer(_buffer), position(0) {
+}
+
+CheckpointArchive::~CheckpointArchive() {
+}
+
+void CheckpointArchive::write(int value) {
+    int32_t tmp = value;
+    writeBytes(&tmp, sizeof(tmp));
+}
+
+void CheckpointArchive::write(double value) {
+    writeBytes(&value, sizeof(value));
+}
+
+void CheckpointArchive::write(bool value) {
+    char tmp = value ? 1 : 0;
+    writeBytes(&tmp, sizeof(tmp));
+}
+
+void CheckpointArchive::write(const double *array, int size) {
+    int64_t tmp = size;
+    writeBytes(&tmp, sizeof(tmp));
+    writeBytes(array, size * sizeof(double));
+}
+
+void CheckpointArchive::write(const std::vector<double> &values) {
+    write(values.empty() ? NULL : &values[0], values.size());
+}
+
+void CheckpointArchive::write(const std::deque<std::vector<double> > &values) {
+    write((int) values.size());
+    for (unsigned i = 0; i < values.size(); i++)
+        write(values[i]);
+}
+
+void CheckpointArchive::read(int &value) {
+    int32_t tmp;
+    readBytes(&tmp, sizeof(tmp));
+    value = tmp;
+}
+
+void CheckpointArchive::read(double &value) {
+    readBytes(&value, sizeof(value));
+}
+
+void CheckpointArchive::read(bool &value) {
+    char tmp;
+    readBytes(&tmp, sizeof(tmp));
+    value = (tmp != 0);
+}
+
+void CheckpointArchive::read(double *array, int size) {
+    int64_t storedSize;
+    readBytes(&storedSize, sizeof(storedSize));
+    if (storedSize != size) {
+        stringstream message;
+        message << "an array of size " << size << " is expected, but the stored one has size "
+                << storedSize;
+        fail(message.str());
+    }
+    readBytes(array, size * sizeof(double));
+}
+
+void CheckpointArchive::read(std::vector<double> &values) {
+    int64_t storedSize;
+    readBytes(&storedSize, sizeof(storedSize));
+    if (storedSize < 0 || (size_t) storedSize * sizeof(double) > buffer.size() - position)
+        fail("the archive ends before the stored array");
+    values.resize(storedSize);
+    readBytes(values.empty() ? NULL : &values[0], storedSize * sizeof(double));
+}
+
+void CheckpointArchive::read(std::deque<std::vector<double> > &values) {
+    int size;
+    read(size);
+    if (size < 0)
+        fail("a negative number of arrays is stored");
+    values.resize(size);
+    for (int i = 0; i < size; i++)
+        read(values[i]);
+}
+
+void CheckpointArchive::writeBytes(const void *data, size_t numBytes) {
+    if (numBytes == 0)
+        return;
+    const char *bytes = static_cast<const char*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + numBytes);
+}
+
+void CheckpointArchive::readBytes(void *data, size_t numBytes) {
+    if (numBytes > buffer.size() - position)
+        fail("the archive ends before the expected data");
+    if (numBytes == 0)
+        return;
+    memcpy(data, &buffer[position], numBytes);
+    position += numBytes;
+}
+
+void CheckpointArchive::fail(const std::string &message) const {
+    ERROR_OUT() << "CheckpointArchive: the checkpoint of \"" << name
+            << "\" does not match the current setup, " << message << endl;
+    exit(EXIT_FAILURE);
+}
+
+} /* namespace EMPIRE */
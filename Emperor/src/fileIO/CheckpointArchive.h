@@ -0,0 +1,164 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file CheckpointArchive.h
+ * This file holds the class CheckpointArchive and the interface AbstractCheckpointable
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef CHECKPOINTARCHIVE_H_
+#define CHECKPOINTARCHIVE_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <stddef.h>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class CheckpointArchive is an in-memory binary buffer the state of an object is written to
+ *        and read from. Every array is stored with its size, so that a restart with different
+ *        meshes or settings is detected instead of reading garbage. A read beyond the end or of
+ *        a different size stops the program with an error naming the archive.
+ ***********/
+class CheckpointArchive {
+public:
+    /***********************************************************************************************
+     * \brief Constructor of an empty archive to be written
+     * \param[in] _name name of the archive, used in error messages
+     ***********/
+    CheckpointArchive(std::string _name);
+    /***********************************************************************************************
+     * \brief Constructor of an archive to be read
+     * \param[in] _name name of the archive, used in error messages
+     * \param[in] _buffer the bytes of the archive
+     ***********/
+    CheckpointArchive(std::string _name, const std::vector<char> &_buffer);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~CheckpointArchive();
+    /***********************************************************************************************
+     * \brief Write a value
+     ***********/
+    void write(int value);
+    void write(double value);
+    void write(bool value);
+    /***********************************************************************************************
+     * \brief Write an array preceded by its size
+     * \param[in] array the array
+     * \param[in] size number of entries
+     ***********/
+    void write(const double *array, int size);
+    /***********************************************************************************************
+     * \brief Write a vector preceded by its size
+     ***********/
+    void write(const std::vector<double> &values);
+    /***********************************************************************************************
+     * \brief Write vectors preceded by their number
+     ***********/
+    void write(const std::deque<std::vector<double> > &values);
+    /***********************************************************************************************
+     * \brief Read a value
+     ***********/
+    void read(int &value);
+    void read(double &value);
+    void read(bool &value);
+    /***********************************************************************************************
+     * \brief Read an array of known size, the stored size must be the same
+     * \param[out] array the array
+     * \param[in] size number of entries
+     ***********/
+    void read(double *array, int size);
+    /***********************************************************************************************
+     * \brief Read a vector, it is resized to the stored size
+     ***********/
+    void read(std::vector<double> &values);
+    /***********************************************************************************************
+     * \brief Read vectors, the deque is resized to the stored number
+     ***********/
+    void read(std::deque<std::vector<double> > &values);
+    /***********************************************************************************************
+     * \brief Get the bytes written so far
+     ***********/
+    const std::vector<char> &getBuffer() const {
+        return buffer;
+    }
+    /***********************************************************************************************
+     * \brief Whether all bytes are read
+     ***********/
+    bool isAtEnd() const {
+        return position == buffer.size();
+    }
+    /***********************************************************************************************
+     * \brief Get the name of the archive
+     ***********/
+    const std::string &getName() const {
+        return name;
+    }
+
+private:
+    /// name of the archive
+    std::string name;
+    /// the bytes
+    std::vector<char> buffer;
+    /// position of the next byte to be read
+    size_t position;
+    /***********************************************************************************************
+     * \brief Append bytes
+     ***********/
+    void writeBytes(const void *data, size_t numBytes);
+    /***********************************************************************************************
+     * \brief Read bytes, stops the program if the archive ends before
+     ***********/
+    void readBytes(void *data, size_t numBytes);
+    /***********************************************************************************************
+     * \brief Stop the program because the archive does not match the object reading it
+     * \param[in] message what does not match
+     ***********/
+    void fail(const std::string &message) const;
+};
+
+/********//**
+ * \brief Class AbstractCheckpointable is the interface of the objects whose state is written to a
+ *        checkpoint of the coupling and restored from it, see CouplingStateCheckpoint. The
+ *        object must be initialized before, the sizes of its arrays are not part of its state.
+ ***********/
+class AbstractCheckpointable {
+public:
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~AbstractCheckpointable() {
+    }
+    /***********************************************************************************************
+     * \brief Write the state
+     * \param[in] archive the archive
+     ***********/
+    virtual void writeCheckpoint(CheckpointArchive &archive) const = 0;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    virtual void readCheckpoint(CheckpointArchive &archive) = 0;
+};
+
+} /* namespace EMPIRE */
+#endif /* CHECKPOINTARCHIVE_H_ */
@@ -27,9 +27,11 @@
 #include <map>
 #include <assert.h>
 #include <vector>
+#include <algorithm>
 #include "stdlib.h"
 
 #include "GiDFileIO.h"
+#include "TextFileScanner.h"
 
 using namespace std;
 
@@ -131,214 +133,250 @@ void outputGaussPoints(ostream &outputStream) {
     outputStream << "end gausspoints" << endl << endl;
 }
 
+/***********************************************************************************************
+ * \brief Parse the header line of a mesh block in a .msh file
+ * \param[in] textLine the line starting with "mesh"
+ * \param[out] numberOfNodesThisElement number of nodes of the elements of this mesh block
+ ***********/
+void parseMeshHeaderLine(const string &textLine, int &numberOfNodesThisElement) {
+    const int XYZ = 3;
+    string lineToken, meshName, elementType;
+    int dimension;
+    int count = 0;
+    { // get number of words in the line
+        istringstream lineStream(textLine);
+        while (lineStream >> lineToken)
+            count++;
+    }
+    const int headerLineWordsWithMeshName = 8;
+    istringstream lineStream(textLine);
+    lineStream >> lineToken; // skip the word "mesh"
+    if (count == headerLineWordsWithMeshName) { // there is a mesh name
+        do {
+            lineStream >> lineToken;
+            meshName.append(" ").append(lineToken); // here a space is added to the beginning
+        } while (meshName[meshName.size() - 1] != '\"'); // parse the name with spaces in
+        meshName.erase(meshName.begin()); // remove the space at the beginning
+    } else {
+        assert(count == 7);
+        meshName = "\"\"";
+    }
+
+    lineStream >> lineToken; // skip the keyword "dimension"
+    convertToLowerCase(lineToken);
+    assert(lineToken.compare("dimension") == 0);
+    lineStream >> dimension;
+    assert(dimension == XYZ);
+
+    lineStream >> lineToken; // skip the keyword "ElemType"
+    convertToLowerCase(lineToken);
+    assert(lineToken.compare("elemtype") == 0);
+    lineStream >> elementType;
+
+    lineStream >> lineToken; // skip the keyword "Nnode"
+    convertToLowerCase(lineToken);
+    assert(lineToken.compare("nnode") == 0);
+    lineStream >> numberOfNodesThisElement;
+
+    if (elementType == "Triangle")
+        assert(numberOfNodesThisElement == 3);
+    else if (elementType == "Quadrilateral")
+        assert(numberOfNodesThisElement == 4);
+    else if (elementType == "Linear")
+        assert(numberOfNodesThisElement == 2);
+    else
+        assert(false);
+}
+/***********************************************************************************************
+ * \brief Whether a line is empty or a comment
+ ***********/
+bool isEmptyOrComment(const char *line, const char *end) {
+    const char *p = TextFileScanner::skipBlanks(line, end);
+    return (p >= end || *p == '\n' || *p == '#');
+}
+/***********************************************************************************************
+ * \brief Find the line starting with "end", which closes the block starting at begin
+ * \return the beginning of the line
+ ***********/
+const char *findEndOfBlock(const char *begin, const char *end) {
+    for (const char *line = begin; line < end; line = TextFileScanner::nextLine(line, end))
+        if (TextFileScanner::wordEquals(line, end, "end"))
+            return line;
+    cerr << "GiDFileIO: the block is not closed by \"end\"" << endl;
+    exit(EXIT_FAILURE);
+    return end;
+}
+/***********************************************************************************************
+ * \brief Parse the lines of a coordinates block in parallel
+ * \param[in] begin the first line of the block
+ * \param[in] end the line closing the block
+ * \param[in/out] nodeIDs the node IDs are appended
+ * \param[in/out] nodeCoordinates the node coordinates are appended
+ ***********/
+void parseNodeBlock(const char *begin, const char *end, vector<int> &nodeIDs,
+        vector<double> &nodeCoordinates) {
+    const int XYZ = 3;
+    vector<const char*> lineBegins;
+    TextFileScanner::splitLines(begin, end, lineBegins);
+    int numLines = lineBegins.size();
+    vector<int> idOfLine(numLines);
+    vector<double> coordinatesOfLine(numLines * XYZ, 0.0);
+    vector<char> isNode(numLines, 0);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numLines; i++) {
+        if (isEmptyOrComment(lineBegins[i], end))
+            continue;
+        const char *p = TextFileScanner::scanInt(lineBegins[i], end, idOfLine[i]);
+        assert(p != NULL);
+        for (int j = 0; j < XYZ && p != NULL; j++)
+            p = TextFileScanner::scanDouble(p, end, coordinatesOfLine[i * XYZ + j]);
+        isNode[i] = 1;
+    }
+    for (int i = 0; i < numLines; i++) {
+        if (!isNode[i])
+            continue;
+        nodeIDs.push_back(idOfLine[i]);
+        for (int j = 0; j < XYZ; j++)
+            nodeCoordinates.push_back(coordinatesOfLine[i * XYZ + j]);
+    }
+}
+/***********************************************************************************************
+ * \brief Parse the lines of an elements block in parallel
+ * \param[in] begin the first line of the block
+ * \param[in] end the line closing the block
+ * \param[in] numberOfNodesThisElement number of nodes of each element in this block
+ * \param[in/out] elementIds the element IDs are appended
+ * \param[in/out] elementNodeTables the element tables are appended
+ ***********/
+void parseElementBlock(const char *begin, const char *end, int numberOfNodesThisElement,
+        vector<int> &elementIds, vector<int> &elementNodeTables) {
+    vector<const char*> lineBegins;
+    TextFileScanner::splitLines(begin, end, lineBegins);
+    int numLines = lineBegins.size();
+    vector<int> idOfLine(numLines);
+    vector<int> nodeIdsOfLine(numLines * numberOfNodesThisElement);
+    vector<char> isElement(numLines, 0);
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numLines; i++) {
+        if (isEmptyOrComment(lineBegins[i], end))
+            continue;
+        const char *p = TextFileScanner::scanInt(lineBegins[i], end, idOfLine[i]);
+        assert(p != NULL);
+        for (int j = 0; j < numberOfNodesThisElement; j++) {
+            p = TextFileScanner::scanInt(p, end, nodeIdsOfLine[i * numberOfNodesThisElement + j]);
+            assert(p != NULL);
+        }
+        int materialNumber;
+        const char *q = TextFileScanner::scanInt(p, end, materialNumber); // there may be material number
+        if (q != NULL)
+            p = q;
+        p = TextFileScanner::skipBlanks(p, end);
+        assert(p >= end || *p == '\n'); // nothing else in the line
+        isElement[i] = 1;
+    }
+    for (int i = 0; i < numLines; i++) {
+        if (!isElement[i])
+            continue;
+        elementIds.push_back(idOfLine[i]);
+        for (int j = 0; j < numberOfNodesThisElement; j++)
+            elementNodeTables.push_back(nodeIdsOfLine[i * numberOfNodesThisElement + j]);
+    }
+}
+
 void readDotMsh(string fileName, int &numberOfMeshNodes, int &numberOfElements,
         double *&meshNodeCoordinates, int *&meshNodeIds, int *&numberOfNodesPerElement,
         int *&elementNodeTables, int *&elementIds) {
-    ifstream inputStream(fileName.c_str());
-    if (!inputStream) {
+    TextFileScanner::MappedFile file(fileName);
+    if (!file.isOpen()) {
         cerr << "readDotMsh: GiD .msh file \"" << fileName << "\" cannot be found" << '\n';
         exit(EXIT_FAILURE);
     }
     const int XYZ = 3;
-    bool inNodes = false, inElements = false, inMesh = false;
+    const char *end = file.end();
+    bool inMesh = false;
     int numberOfNodesThisElement = 0;
-    map<int, Node *> *nodeAtId = new map<int, Node *>;
-    list<Node *> *meshNodes = new list<Node *>;
-    list<Element *> *elements = new list<Element *>;
-    string elementType, textLine, meshName, lineToken;
-
-    while (true) { /* parse line */
-        getline(inputStream, textLine, '\n');
-
-        istringstream lineStream(textLine);
-        lineStream >> skipws >> lineToken;
-        convertToLowerCase(lineToken);
-
-        if (lineToken.size() == 0 || lineToken[0] == '#') {
+    vector<int> nodeIDsInFile;
+    vector<double> nodeCoordinatesInFile;
+    vector<int> elementIdsInFile;
+    vector<int> numberOfNodesPerElementInFile;
+    vector<int> elementNodeTablesInFile;
+
+    const char *line = file.begin();
+    while (line < end) { /* parse line */
+        if (isEmptyOrComment(line, end)) {
             // ignore comments and empty lines
-        } else if (inNodes) {
-            if (lineToken.compare("end") == 0) {
-                inNodes = false;
-            } else { // add node
-                int id;
-                istringstream lineStream(textLine);
-                lineStream >> id;
-                double *coordinate = new double[XYZ];
-                for (int i = 0; i < XYZ; i++) {
-                    lineStream >> coordinate[i];
-                }assert(nodeAtId->find(id) == nodeAtId->end());
-                // enforce unique node ids
-                (*nodeAtId)[id] = new Node(id, coordinate);
-            }
-        } else if (inElements) {
-            if (lineToken.compare("end") == 0) {
-                inElements = false;
-                inMesh = false;
-            } else {
-                { // 1. check the number of entries in this line
-                    istringstream lineStream(textLine);
-                    int count = 0;
-                    while (lineStream >> lineToken)
-                        count++;
-                    // there may be material number
-                    assert(
-                            (count == (numberOfNodesThisElement + 1)) || (count == (numberOfNodesThisElement + 2)));
-                }
-                { // 2. parse the elements
-                    istringstream lineStream(textLine);
-                    int id;
-                    lineStream >> id;
-                    int *nodeIds = new int[numberOfNodesThisElement];
-                    for (int i = 0; i < numberOfNodesThisElement; i++) {
-                        lineStream >> nodeIds[i];
-                    }
-                    elements->push_back(new Element(id, nodeIds, numberOfNodesThisElement));
-                }
-            }
-        } else if (lineToken.compare("mesh") == 0) { // new mesh
-            int dimension;
+            line = TextFileScanner::nextLine(line, end);
+        } else if (TextFileScanner::wordEquals(line, end, "mesh")) { // new mesh
+            string textLine(line, TextFileScanner::endOfLine(line, end));
+            parseMeshHeaderLine(textLine, numberOfNodesThisElement);
             inMesh = true;
-            int count = 0;
-            { // get number of words in the line
-                istringstream lineStream(textLine);
-                while (lineStream >> lineToken)
-                    count++;
-            }
-            { // extract header
-                const int headerLineWordsWithMeshName = 8;
-                istringstream lineStream(textLine);
-                lineStream >> lineToken; // skip the word "mesh"
-                meshName.clear(); // ignore previous mesh names
-                if (count == headerLineWordsWithMeshName) { // there is a mesh name
-                    do {
-                        lineStream >> lineToken;
-                        meshName.append(" ").append(lineToken); // here a space is added to the beginning
-                    } while (meshName[meshName.size() - 1] != '\"'); // parse the name with spaces in
-                    meshName.erase(meshName.begin()); // remove the space at the beginning
-                } else {
-                    assert(count == 7);
-                    meshName = "\"\"";
-                }
-
-                lineStream >> lineToken; // skip the keyword "dimension"
-                convertToLowerCase(lineToken);
-                assert(lineToken.compare("dimension") == 0);
-                lineStream >> dimension;
-                assert(dimension == XYZ);
-
-                lineStream >> lineToken; // skip the keyword "ElemType"
-                convertToLowerCase(lineToken);
-                assert(lineToken.compare("elemtype") == 0);
-                lineStream >> elementType;
-
-                lineStream >> lineToken; // skip the keyword "Nnode"
-                convertToLowerCase(lineToken);
-                assert(lineToken.compare("nnode") == 0);
-                lineStream >> numberOfNodesThisElement;
-
-                if (elementType == "Triangle")
-                    assert(numberOfNodesThisElement == 3);
-                else if (elementType == "Quadrilateral")
-                    assert(numberOfNodesThisElement == 4);
-                else if (elementType == "Linear")
-                    assert(numberOfNodesThisElement == 2);
-                else
-                    assert(false);
-            }
-        } else if (lineToken.compare("coordinates") == 0) {
-            inNodes = true;
-        } else if (lineToken.compare("elements") == 0) {
-            inElements = true;
+            line = TextFileScanner::nextLine(line, end);
+        } else if (TextFileScanner::wordEquals(line, end, "coordinates")) {
+            const char *blockBegin = TextFileScanner::nextLine(line, end);
+            const char *blockEnd = findEndOfBlock(blockBegin, end);
+            parseNodeBlock(blockBegin, blockEnd, nodeIDsInFile, nodeCoordinatesInFile);
+            line = TextFileScanner::nextLine(blockEnd, end);
+        } else if (TextFileScanner::wordEquals(line, end, "elements")) {
+            assert(inMesh);
+            const char *blockBegin = TextFileScanner::nextLine(line, end);
+            const char *blockEnd = findEndOfBlock(blockBegin, end);
+            parseElementBlock(blockBegin, blockEnd, numberOfNodesThisElement, elementIdsInFile,
+                    elementNodeTablesInFile);
+            numberOfNodesPerElementInFile.resize(elementIdsInFile.size(),
+                    numberOfNodesThisElement);
+            inMesh = false;
+            line = TextFileScanner::nextLine(blockEnd, end);
+        } else {
+            line = TextFileScanner::nextLine(line, end);
         }
-        // terminate if failbit, eofbit or badbit is set
-        if (!inputStream.good())
-            break;
     } /* parse line */
 
     assert(inMesh == false);
-    assert(inNodes == false);
-    assert(inElements == false);
-
-    numberOfElements = elements->size();
-
-    { // number of nodes per element
-        int i = 0;
-        numberOfNodesPerElement = new int[numberOfElements];
-        list<Element *>::iterator it;
-        for (it = elements->begin(); it != elements->end(); ++it, ++i)
-            numberOfNodesPerElement[i] = (*it)->numberOfNodes;
-    }
-
-    { // element Ids
-        int i = 0;
-        elementIds = new int[numberOfElements];
-        list<Element *>::iterator it;
-        for (it = elements->begin(); it != elements->end(); ++it, ++i)
-            elementIds[i] = (*it)->id;
-    }
-
-    { // element tables
-        int size = 0;
-        list<Element *>::iterator it;
-        for (it = elements->begin(); it != elements->end(); ++it) {
-            size += (*it)->numberOfNodes;
-        }
-        elementNodeTables = new int[size];
-
-        int i_g = 0;
-        for (it = elements->begin(); it != elements->end(); ++it) {
-            for (int i = 0; i < (*it)->numberOfNodes; i++)
-                elementNodeTables[i_g++] = (*it)->nodeIds[i];
-        }
-    }
 
-    { // get nodes with element association
-        int id;
-        list<Element *>::iterator it;
-        for (it = elements->begin(); it != elements->end(); ++it) {
-            for (int i = 0; i < (*it)->numberOfNodes; i++) {
-                id = (*it)->nodeIds[i];
-                assert(nodeAtId->find(id) != nodeAtId->end());
-                // node must exist
-                meshNodes->push_back((*nodeAtId)[id]);
-            }
-        }
-        meshNodes->sort(); // remove duplicates
-        meshNodes->unique();
-        meshNodes->sort(compare_node_by_id);
-    }
-
-    numberOfMeshNodes = meshNodes->size();
-
-    { // node coordinates
-        int i = 0;
-        meshNodeCoordinates = new double[numberOfMeshNodes * XYZ];
-        list<Node *>::iterator it;
-        for (it = meshNodes->begin(); it != meshNodes->end(); ++it, ++i)
-            for (int j = 0; j < XYZ; j++)
-                meshNodeCoordinates[i * XYZ + j] = (*it)->coordinate[j];
+    // sort the nodes by ID, enforce unique node ids
+    int numberOfNodesInFile = nodeIDsInFile.size();
+    vector<pair<int, int> > nodeIDToPosInFile(numberOfNodesInFile);
+    for (int i = 0; i < numberOfNodesInFile; i++)
+        nodeIDToPosInFile[i] = pair<int, int>(nodeIDsInFile[i], i);
+    sort(nodeIDToPosInFile.begin(), nodeIDToPosInFile.end());
+    for (int i = 1; i < numberOfNodesInFile; i++)
+        assert(nodeIDToPosInFile[i - 1].first != nodeIDToPosInFile[i].first);
+
+    // only the nodes belonging to elements are in the mesh
+    vector<char> isMeshNode(numberOfNodesInFile, 0);
+    for (int i = 0; i < elementNodeTablesInFile.size(); i++) {
+        vector<pair<int, int> >::iterator it = lower_bound(nodeIDToPosInFile.begin(),
+                nodeIDToPosInFile.end(), pair<int, int>(elementNodeTablesInFile[i], -1));
+        assert(it != nodeIDToPosInFile.end() && it->first == elementNodeTablesInFile[i]);
+        // node must exist
+        isMeshNode[it - nodeIDToPosInFile.begin()] = 1;
     }
 
-    { // node Ids
-        int i = 0;
-        meshNodeIds = new int[numberOfMeshNodes];
-        list<Node *>::iterator it;
-        for (it = meshNodes->begin(); it != meshNodes->end(); ++it, ++i)
-            meshNodeIds[i] = (*it)->id;
-    }
-
-    { // delete nodes
-        for (map<int, Node *>::iterator it = nodeAtId->begin(); it != nodeAtId->end(); ++it)
-            delete (it->second);
-        delete nodeAtId;
-        delete meshNodes;
+    numberOfMeshNodes = 0;
+    for (int i = 0; i < numberOfNodesInFile; i++)
+        numberOfMeshNodes += isMeshNode[i];
+    meshNodeCoordinates = new double[numberOfMeshNodes * XYZ];
+    meshNodeIds = new int[numberOfMeshNodes];
+    for (int i = 0, count = 0; i < numberOfNodesInFile; i++) {
+        if (!isMeshNode[i])
+            continue;
+        int posInFile = nodeIDToPosInFile[i].second;
+        meshNodeIds[count] = nodeIDToPosInFile[i].first;
+        for (int j = 0; j < XYZ; j++)
+            meshNodeCoordinates[count * XYZ + j] = nodeCoordinatesInFile[posInFile * XYZ + j];
+        count++;
     }
 
-    { // delete elements
-        for (list<Element *>::iterator it = elements->begin(); it != elements->end(); ++it)
-            delete (*it);
-        delete elements;
+    numberOfElements = elementIdsInFile.size();
+    numberOfNodesPerElement = new int[numberOfElements];
+    elementIds = new int[numberOfElements];
+    for (int i = 0; i < numberOfElements; i++) {
+        numberOfNodesPerElement[i] = numberOfNodesPerElementInFile[i];
+        elementIds[i] = elementIdsInFile[i];
     }
+    elementNodeTables = new int[elementNodeTablesInFile.size()];
+    for (int i = 0; i < elementNodeTablesInFile.size(); i++)
+        elementNodeTables[i] = elementNodeTablesInFile[i];
 }
 
 void writeDotMsh(std::string fileName, int numberOfMeshNodes,
@@ -607,11 +645,60 @@ void appendElementalDataToDotRes(std::string fileName, std::string resultName,
     delete quads;
 }
 
+/***********************************************************************************************
+ * \brief Parse the header line of a result block in a .res file
+ * \param[in] textLine the line starting with "result"
+ * \param[out] resultNameInFile name of the result with quotation marks
+ * \param[out] analysisNameInFile name of the analysis with quotation marks
+ * \param[out] stepNumInFile step number
+ * \param[out] typeInFile type in lower case
+ * \param[out] locationInFile location in lower case
+ ***********/
+void parseResultHeaderLine(const string &textLine, string &resultNameInFile,
+        string &analysisNameInFile, int &stepNumInFile, string &typeInFile,
+        string &locationInFile) {
+    istringstream lineStream(textLine);
+    string lineToken;
+    lineStream >> lineToken; // skip the word "result"
+    resultNameInFile.clear();
+    do {
+        lineStream >> lineToken;
+        resultNameInFile.append(" ").append(lineToken); // here a space is added to the beginning
+    } while (resultNameInFile[resultNameInFile.size() - 1] != '\"'); // parse the name with spaces in
+    resultNameInFile.erase(resultNameInFile.begin()); // remove the space at the beginning
+
+    analysisNameInFile.clear();
+    do {
+        lineStream >> lineToken;
+        analysisNameInFile.append(" ").append(lineToken); // here a space is added to the beginning
+    } while (analysisNameInFile[analysisNameInFile.size() - 1] != '\"'); // parse the name with spaces in
+    analysisNameInFile.erase(analysisNameInFile.begin()); // remove the space at the beginning
+
+    lineStream >> stepNumInFile;
+    lineStream >> typeInFile;
+    convertToLowerCase(typeInFile);
+    lineStream >> locationInFile;
+    convertToLowerCase(locationInFile);
+}
+/***********************************************************************************************
+ * \brief Exit since a result is not found in a .res file
+ ***********/
+void exitResultNotFound(const string &fileName, const string &resultName,
+        const string &analysisName, int stepNum, const string &type) {
+    cerr << "result with the following parameters is not found in " << fileName << endl;
+    cerr << "result name: " << resultName << endl;
+    cerr << "analysis name: " << analysisName << endl;
+    cerr << "step number: " << stepNum << endl;
+    cerr << "type: " << type << endl;
+    cerr << "Exit!" << endl;
+    exit(EXIT_FAILURE);
+}
+
 void readNodalDataFromDotRes(std::string fileName, std::string resultName,
         std::string analysisName, int stepNum, std::string type,
         int numberOfNodes, const int *nodeIds, double *data) {
-    ifstream dotResFile(fileName.c_str());
-    assert(dotResFile);
+    TextFileScanner::MappedFile file(fileName);
+    assert(file.isOpen());
 
     assert(resultName.size()!=0);
     if (resultName[0] != '\"')
@@ -624,7 +711,6 @@ void readNodalDataFromDotRes(std::string fileName, std::string resultName,
     if (analysisName[analysisName.size()-1] != '\"')
         analysisName.append("\"");
 
-
     int dimension = 0;
     convertToLowerCase(type);
     if (type == "vector")
@@ -634,97 +720,53 @@ void readNodalDataFromDotRes(std::string fileName, std::string resultName,
     else
         assert(false);
 
-    map<int, int> *nodeIDToPosMap = new map<int, int>;
-    for (int i = 0; i < numberOfNodes; i++) {
-        nodeIDToPosMap->insert(nodeIDToPosMap->end(), pair<int, int>(nodeIds[i], i));
-    }
-
-    while (true) { /* parse line */
-        if (!dotResFile.good()) { // terminate if failbit, eofbit or badbit is set
-            cerr << "result with the following parameters is not found in " << fileName << endl;
-            cerr << "result name: " << resultName << endl;
-            cerr << "analysis name: " << analysisName << endl;
-            cerr << "step number: " << stepNum << endl;
-            cerr << "type: " << type << endl;
-            cerr << "Exit!" << endl;
-            exit(EXIT_FAILURE);
-        }
-        string textLine;
-        string lineToken;
-        getline(dotResFile, textLine, '\n');
-
-        istringstream lineStream(textLine);
-        lineStream >> skipws >> lineToken;
-        convertToLowerCase(lineToken);
-        if (lineToken == "result") {
-            string resultNameInFile;
-            do {
-                lineStream >> lineToken;
-                resultNameInFile.append(" ").append(lineToken); // here a space is added to the beginning
-            } while (resultNameInFile[resultNameInFile.size() - 1] != '\"'); // parse the name with spaces in
-            resultNameInFile.erase(resultNameInFile.begin()); // remove the space at the beginning
-
-            string analysisNameInFile;
-            do {
-                lineStream >> lineToken;
-                analysisNameInFile.append(" ").append(lineToken); // here a space is added to the beginning
-            } while (analysisNameInFile[analysisNameInFile.size() - 1] != '\"'); // parse the name with spaces in
-            analysisNameInFile.erase(analysisNameInFile.begin()); // remove the space at the beginning
-
-            int stepNumInFile;
-            lineStream >> stepNumInFile;
-
-            string typeInFile;
-            lineStream >> typeInFile;
-            convertToLowerCase(typeInFile);
-
-            string locationInFile;
-            lineStream >> locationInFile;
-            convertToLowerCase(locationInFile);
-
-            if (stepNumInFile > stepNum) { // save time if it is beyond the interesting time step
-                cerr << "result with the following parameters is not found in " << fileName << endl;
-                cerr << "result name: " << resultName << endl;
-                cerr << "analysis name: " << analysisName << endl;
-                cerr << "step number: " << stepNum << endl;
-                cerr << "type: " << type << endl;
-                cerr << "Exit!" << endl;
-                exit(EXIT_FAILURE);
+    vector<pair<int, int> > nodeIDToPos(numberOfNodes);
+    for (int i = 0; i < numberOfNodes; i++)
+        nodeIDToPos[i] = pair<int, int>(nodeIds[i], i);
+    sort(nodeIDToPos.begin(), nodeIDToPos.end());
+
+    const char *end = file.end();
+    for (const char *line = file.begin(); line < end; line = TextFileScanner::nextLine(line, end)) { /* parse line */
+        if (!TextFileScanner::wordEquals(line, end, "result"))
+            continue;
+        string resultNameInFile, analysisNameInFile, typeInFile, locationInFile;
+        int stepNumInFile;
+        parseResultHeaderLine(string(line, TextFileScanner::endOfLine(line, end)),
+                resultNameInFile, analysisNameInFile, stepNumInFile, typeInFile, locationInFile);
+
+        if (stepNumInFile > stepNum) // save time if it is beyond the interesting time step
+            exitResultNotFound(fileName, resultName, analysisName, stepNum, type);
+
+        if (resultName == resultNameInFile && analysisName == analysisNameInFile
+                && stepNum == stepNumInFile && type == typeInFile
+                && locationInFile == "onnodes") { // read nodal data, do not allow empty lines or comments
+            line = TextFileScanner::nextLine(line, end);
+            assert(TextFileScanner::wordEquals(line, end, "values"));
+            line = TextFileScanner::nextLine(line, end);
+            vector<const char*> lineBegins(numberOfNodes);
+            for (int i = 0; i < numberOfNodes; i++) {
+                lineBegins[i] = line;
+                line = TextFileScanner::nextLine(line, end);
             }
-
-            if (resultName == resultNameInFile && analysisName == analysisNameInFile
-                    && stepNum == stepNumInFile && type == typeInFile
-                    && locationInFile == "onnodes") { // read nodal data, do not allow empty lines or comments
-                getline(dotResFile, textLine, '\n');
-                istringstream lineStream1(textLine);
-                lineStream1 >> skipws >> lineToken;
-                convertToLowerCase(lineToken);
-                assert(lineToken == "values");
-                for (int i = 0; i < numberOfNodes; i++) {
-                    getline(dotResFile, textLine, '\n');
-                    istringstream lineStream2(textLine);
-                    int nodeID;
-                    lineStream2 >> skipws >> nodeID;
-                    assert(nodeIDToPosMap->find(nodeID) != nodeIDToPosMap->end());
-                    for (int j = 0; j < dimension; j++) {
-                        int nodePos = nodeIDToPosMap->at(nodeID);
-                        lineStream2 >> data[nodePos * dimension + j];
-                    }
+            assert(TextFileScanner::wordEquals(line, end, "end"));
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < numberOfNodes; i++) {
+                int nodeID;
+                const char *p = TextFileScanner::scanInt(lineBegins[i], end, nodeID);
+                assert(p != NULL);
+                vector<pair<int, int> >::const_iterator it = lower_bound(nodeIDToPos.begin(),
+                        nodeIDToPos.end(), pair<int, int>(nodeID, -1));
+                assert(it != nodeIDToPos.end() && it->first == nodeID);
+                int nodePos = it->second;
+                for (int j = 0; j < dimension; j++) {
+                    p = TextFileScanner::scanDouble(p, end, data[nodePos * dimension + j]);
+                    assert(p != NULL);
                 }
-                getline(dotResFile, textLine, '\n');
-                istringstream lineStream3(textLine);
-                lineStream3 >> skipws >> lineToken;
-                convertToLowerCase(lineToken);
-                assert(lineToken == "end");
-
-                return;
-            } else {
-                continue;
             }
-
+            return;
         }
     }
-    delete nodeIDToPosMap;
+    exitResultNotFound(fileName, resultName, analysisName, stepNum, type);
 }
 
 void readNodalDataFromDotResFast(std::ifstream &dotResFile, std::string fileName, std::string resultName,
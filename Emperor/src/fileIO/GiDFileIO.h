@@ -30,7 +30,8 @@
 
 namespace GiDFileIO {
 /***********************************************************************************************
- * \brief Read a .msh file, initialize mesh data
+ * \brief Read a .msh file, initialize mesh data. The file is memory mapped and the coordinates
+ *        and elements blocks are parsed in parallel
  * \param[in] fileName name of the mesh file
  * \param[out] numberOfMeshNodes number of nodes belonging to elements
  * \param[out] numberOfElements number of elements in the mesh
@@ -97,7 +98,8 @@ void appendElementalDataToDotRes(std::string fileName, std::string resultName,
         std::string analysisName, int stepNum, std::string type, int numberOfElements,
         const int *elemIds, const int *numberOfNodesPerElement, const double *data);
 /***********************************************************************************************
- * \brief Read nodal data in a .res file given the parameters of the data
+ * \brief Read nodal data in a .res file given the parameters of the data. The file is memory
+ *        mapped and the values block is parsed in parallel
  * \param[in] fileName name of the result file
  * \param[in] resultName name of the data
  * \param[in] analysisName name of the analysis
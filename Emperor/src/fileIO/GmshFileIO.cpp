@@ -24,25 +24,578 @@
 #include <sstream>
 #include <list>
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <stddef.h>
+#include <ctype.h>
 #include "stdlib.h"
 
 #include "GmshFileIO.h"
 #include "meshIO.h"
+#include "TextFileScanner.h"
 
 namespace EMPIRE {
 
 using namespace std;
 
+namespace {
+const int XYZ = 3;
+/// number of elements/nodes handled per chunk when writing binary files
+const int WRITE_CHUNK_SIZE = 1 << 20;
+
+void exitReadError(const string &fileName, const string &reason) {
+  cerr << "GmshFileIO::readDotMsh: Gmsh .msh file \"" << fileName << "\" " << reason << '\n';
+  exit(EXIT_FAILURE);
+}
+
+/***********************************************************************************************
+ * \brief Copy a value out of the mapped file, the binary data in .msh files is not aligned
+ ***********/
+template<typename T>
+const char *readValue(const char *p, const char *end, T &value, const string &fileName) {
+  if (end - p < (ptrdiff_t) sizeof(T))
+    exitReadError(fileName, "is truncated");
+  memcpy(&value, p, sizeof(T));
+  return p + sizeof(T);
+}
+
+/***********************************************************************************************
+ * \brief Skip count values of the given size, exit if the file is too short
+ ***********/
+const char *skipValues(const char *p, const char *end, size_t count, size_t size, const string &fileName) {
+  if (count > (size_t) (end - p) / size)
+    exitReadError(fileName, "is truncated");
+  return p + count * size;
+}
+
+/***********************************************************************************************
+ * \brief Skip the line break behind a binary section and check its closing keyword
+ * \return the line behind the closing keyword
+ ***********/
+const char *skipSectionEnd(const char *p, const char *end, const char *keyword, const string &fileName) {
+  if (p < end && *p == '\n')
+    p++;
+  if (!TextFileScanner::wordEquals(p, end, keyword))
+    exitReadError(fileName, string("is corrupt, ") + keyword + " is missing");
+  return TextFileScanner::nextLine(p, end);
+}
+
+/***********************************************************************************************
+ * \brief Skip a section which is not needed by searching its closing keyword "$End..."
+ * \return the line behind the closing keyword
+ ***********/
+const char *skipSection(const char *line, const char *end, const string &fileName) {
+  const char *wordEnd = line;
+  while (wordEnd < end && !TextFileScanner::isBlank(*wordEnd) && *wordEnd != '\n')
+    wordEnd++;
+  string keyword("$end");
+  for (const char *c = line + 1; c < wordEnd; c++)
+    keyword += tolower(*c);
+  for (line = TextFileScanner::nextLine(line, end); line < end; line = TextFileScanner::nextLine(line, end)) {
+    if (*line == '$' && TextFileScanner::wordEquals(line, end, keyword.c_str()))
+      return TextFileScanner::nextLine(line, end);
+  }
+  exitReadError(fileName, "is corrupt, " + keyword + " is missing");
+  return end;
+}
+
+/***********************************************************************************************
+ * \brief Number of nodes of a Gmsh element type
+ * \return the number of nodes, or 0 if the type is unknown
+ ***********/
+int numberOfNodesOfElementType(int type) {
+  switch (type) {
+  case 1: return 2;   // line
+  case 2: return 3;   // triangle
+  case 3: return 4;   // quad
+  case 4: return 4;   // tetrahedron
+  case 5: return 8;   // hexahedron
+  case 6: return 6;   // prism
+  case 7: return 5;   // pyramid
+  case 8: return 3;   // second order line
+  case 9: return 6;   // second order triangle
+  case 10: return 9;  // second order quad
+  case 11: return 10; // second order tetrahedron
+  case 15: return 1;  // point
+  case 16: return 8;  // second order quad, serendipity
+  default: return 0;
+  }
+}
+
+/***********************************************************************************************
+ * \brief Skip the binary $Entities section, the geometric entities are not needed
+ ***********/
+const char *skipBinaryEntities(const char *p, const char *end, const string &fileName) {
+  size_t numberOfEntities[4];
+  for (int dim = 0; dim < 4; dim++)
+    p = readValue(p, end, numberOfEntities[dim], fileName);
+  for (int dim = 0; dim < 4; dim++) {
+    for (size_t i = 0; i < numberOfEntities[dim]; i++) {
+      size_t numberOfTags;
+      // tag, then point coordinates or bounding box
+      p = skipValues(p, end, 1, sizeof(int), fileName);
+      p = skipValues(p, end, (dim == 0 ? 3 : 6), sizeof(double), fileName);
+      p = readValue(p, end, numberOfTags, fileName); // physical tags
+      p = skipValues(p, end, numberOfTags, sizeof(int), fileName);
+      if (dim > 0) {
+	p = readValue(p, end, numberOfTags, fileName); // bounding entities
+	p = skipValues(p, end, numberOfTags, sizeof(int), fileName);
+      }
+    }
+  }
+  return p;
+}
+
+/***********************************************************************************************
+ * \brief A block of nodes of one entity in a binary .msh file
+ ***********/
+struct NodeBlock {
+  const char *tags;
+  const char *coordinates;
+  int numberOfValuesPerNode; // x,y,z and the parametric coordinates
+  int numberOfNodes;
+  int offset; // position of the first node in all nodes of the file
+};
+
+/***********************************************************************************************
+ * \brief Read the binary $Nodes section. The block positions are found sequentially, the nodes
+ *        are copied in parallel.
+ ***********/
+const char *readBinaryNodes(const char *p, const char *end, const string &fileName,
+			    vector<pair<int, int> > &nodeIDToPosInFile, vector<double> &nodeCoordinatesInFile) {
+  size_t numberOfBlocks, numberOfNodes, minTag, maxTag;
+  p = readValue(p, end, numberOfBlocks, fileName);
+  p = readValue(p, end, numberOfNodes, fileName);
+  p = readValue(p, end, minTag, fileName);
+  p = readValue(p, end, maxTag, fileName);
+  if (numberOfNodes > INT_MAX || maxTag > INT_MAX)
+    exitReadError(fileName, "has too many nodes or too large node tags");
+
+  vector<NodeBlock> blocks;
+  size_t offset = 0;
+  for (size_t b = 0; b < numberOfBlocks; b++) {
+    int entityDim, entityTag, parametric;
+    size_t numberOfNodesInBlock;
+    p = readValue(p, end, entityDim, fileName);
+    p = readValue(p, end, entityTag, fileName);
+    p = readValue(p, end, parametric, fileName);
+    p = readValue(p, end, numberOfNodesInBlock, fileName);
+    if (numberOfNodesInBlock > numberOfNodes - offset)
+      exitReadError(fileName, "is corrupt, the $Nodes blocks do not match the number of nodes");
+    NodeBlock block;
+    block.numberOfValuesPerNode = XYZ + (parametric ? entityDim : 0);
+    block.numberOfNodes = numberOfNodesInBlock;
+    block.offset = offset;
+    block.tags = p;
+    p = skipValues(p, end, numberOfNodesInBlock, sizeof(size_t), fileName);
+    block.coordinates = p;
+    p = skipValues(p, end, numberOfNodesInBlock, block.numberOfValuesPerNode * sizeof(double), fileName);
+    blocks.push_back(block);
+    offset += numberOfNodesInBlock;
+  }
+  if (offset != numberOfNodes)
+    exitReadError(fileName, "is corrupt, the $Nodes blocks do not match the number of nodes");
+
+  nodeIDToPosInFile.resize(numberOfNodes);
+  nodeCoordinatesInFile.resize(numberOfNodes * XYZ);
+  for (size_t b = 0; b < blocks.size(); b++) {
+    const NodeBlock &block = blocks[b];
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < block.numberOfNodes; i++) {
+      size_t tag;
+      memcpy(&tag, block.tags + i * sizeof(size_t), sizeof(size_t));
+      int posInFile = block.offset + i;
+      nodeIDToPosInFile[posInFile] = pair<int, int>(tag, posInFile);
+      memcpy(&nodeCoordinatesInFile[(size_t) posInFile * XYZ],
+	     block.coordinates + (size_t) i * block.numberOfValuesPerNode * sizeof(double), XYZ * sizeof(double));
+    }
+  }
+  return p;
+}
+
+/***********************************************************************************************
+ * \brief A block of triangles or quads of one entity in a binary .msh file
+ ***********/
+struct ElementBlock {
+  const char *data; // tag and node tags of each element
+  int numberOfNodesPerElement;
+  int numberOfElements;
+  int offset; // position of the first element in the mesh
+  size_t tableOffset; // position of the first element in the element tables
+};
+
+/***********************************************************************************************
+ * \brief Read the binary $Elements section. Only triangles and quads are kept, points and lines
+ *        of the geometry are skipped. The block positions are found sequentially, the elements
+ *        are copied in parallel.
+ ***********/
+const char *readBinaryElements(const char *p, const char *end, const string &fileName,
+			       vector<int> &elementIdsInFile, vector<int> &numberOfNodesPerElementInFile,
+			       vector<int> &elementNodeTablesInFile) {
+  size_t numberOfBlocks, numberOfElements, minTag, maxTag;
+  p = readValue(p, end, numberOfBlocks, fileName);
+  p = readValue(p, end, numberOfElements, fileName);
+  p = readValue(p, end, minTag, fileName);
+  p = readValue(p, end, maxTag, fileName);
+  if (maxTag > INT_MAX)
+    exitReadError(fileName, "has too large element tags");
+
+  vector<ElementBlock> blocks;
+  size_t numberOfSurfaceElements = 0, tableSize = 0;
+  for (size_t b = 0; b < numberOfBlocks; b++) {
+    int entityDim, entityTag, type;
+    size_t numberOfElementsInBlock;
+    p = readValue(p, end, entityDim, fileName);
+    p = readValue(p, end, entityTag, fileName);
+    p = readValue(p, end, type, fileName);
+    p = readValue(p, end, numberOfElementsInBlock, fileName);
+    int numberOfNodesThisType = numberOfNodesOfElementType(type);
+    if (numberOfNodesThisType == 0)
+      exitReadError(fileName, "has an unknown element type");
+    const char *data = p;
+    p = skipValues(p, end, numberOfElementsInBlock, (1 + numberOfNodesThisType) * sizeof(size_t), fileName);
+
+    if (type == 15 || type == 1 || type == 8) // points and lines of the geometry
+      continue;
+    if (type != 2 && type != 3)
+      exitReadError(fileName, "has elements which are neither triangles nor quads");
+    ElementBlock block;
+    block.data = data;
+    block.numberOfNodesPerElement = numberOfNodesThisType;
+    block.numberOfElements = numberOfElementsInBlock;
+    block.offset = numberOfSurfaceElements;
+    block.tableOffset = tableSize;
+    blocks.push_back(block);
+    numberOfSurfaceElements += numberOfElementsInBlock;
+    tableSize += numberOfElementsInBlock * numberOfNodesThisType;
+    if (tableSize > INT_MAX)
+      exitReadError(fileName, "has too many elements");
+  }
+
+  elementIdsInFile.resize(numberOfSurfaceElements);
+  numberOfNodesPerElementInFile.resize(numberOfSurfaceElements);
+  elementNodeTablesInFile.resize(tableSize);
+  bool nodeTagsFitIntoInt = true;
+  for (size_t b = 0; b < blocks.size(); b++) {
+    const ElementBlock &block = blocks[b];
+    const int numberOfValuesPerElement = 1 + block.numberOfNodesPerElement;
+#pragma omp parallel for schedule(static) reduction(&&:nodeTagsFitIntoInt)
+    for (int i = 0; i < block.numberOfElements; i++) {
+      size_t values[1 + 4];
+      memcpy(values, block.data + (size_t) i * numberOfValuesPerElement * sizeof(size_t),
+	     numberOfValuesPerElement * sizeof(size_t));
+      elementIdsInFile[block.offset + i] = values[0];
+      numberOfNodesPerElementInFile[block.offset + i] = block.numberOfNodesPerElement;
+      for (int j = 0; j < block.numberOfNodesPerElement; j++) {
+	nodeTagsFitIntoInt = nodeTagsFitIntoInt && (values[1 + j] <= INT_MAX);
+	elementNodeTablesInFile[block.tableOffset + (size_t) i * block.numberOfNodesPerElement + j] = values[1 + j];
+      }
+    }
+  }
+  if (!nodeTagsFitIntoInt)
+    exitReadError(fileName, "has elements with too large node tags");
+  return p;
+}
+
+/***********************************************************************************************
+ * \brief Read a Gmsh 4.1 binary .msh file from the line behind the $MeshFormat header
+ ***********/
+void readBinaryDotMsh(const char *line, const char *end, const string &fileName,
+		      int &numberOfMeshNodes, int &numberOfElements, double *&meshNodeCoordinates,
+		      int *&meshNodeIds, int *&numberOfNodesPerElement, int *&elementNodeTables, int *&elementIds) {
+  int one;
+  const char *p = readValue(line, end, one, fileName);
+  if (one != 1)
+    exitReadError(fileName, "was written on a machine with a different byte order");
+  line = skipSectionEnd(p, end, "$endmeshformat", fileName);
+
+  bool hasNodes = false, hasElements = false;
+  vector<pair<int, int> > nodeIDToPosInFile;
+  vector<double> nodeCoordinatesInFile;
+  vector<int> elementIdsInFile;
+  vector<int> numberOfNodesPerElementInFile;
+  vector<int> elementNodeTablesInFile;
+
+  while (line < end && !(hasNodes && hasElements)) { /* parse section */
+    if (TextFileScanner::wordEquals(line, end, "$nodes")) {
+      p = readBinaryNodes(TextFileScanner::nextLine(line, end), end, fileName,
+			  nodeIDToPosInFile, nodeCoordinatesInFile);
+      line = skipSectionEnd(p, end, "$endnodes", fileName);
+      hasNodes = true;
+    }
+    else if (TextFileScanner::wordEquals(line, end, "$elements")) {
+      p = readBinaryElements(TextFileScanner::nextLine(line, end), end, fileName,
+			     elementIdsInFile, numberOfNodesPerElementInFile, elementNodeTablesInFile);
+      line = skipSectionEnd(p, end, "$endelements", fileName);
+      hasElements = true;
+    }
+    else if (TextFileScanner::wordEquals(line, end, "$entities")) {
+      p = skipBinaryEntities(TextFileScanner::nextLine(line, end), end, fileName);
+      line = skipSectionEnd(p, end, "$endentities", fileName);
+    }
+    else if (TextFileScanner::wordEquals(line, end, "$partitionedentities")) {
+      exitReadError(fileName, "is partitioned, which is not supported");
+    }
+    else if (*line == '$') { // e.g. $PhysicalNames
+      line = skipSection(line, end, fileName);
+    }
+    else {
+      line = TextFileScanner::nextLine(line, end);
+    }
+  } /* parse section */
+  if (!hasNodes || !hasElements)
+    exitReadError(fileName, "has no $Nodes or no $Elements section");
+
+  // sort the nodes by ID (Gmsh usually writes them sorted), enforce unique node ids
+  int numberOfNodesInFile = nodeIDToPosInFile.size();
+  bool isSorted = true;
+  for (int i = 1; i < numberOfNodesInFile && isSorted; i++)
+    isSorted = nodeIDToPosInFile[i - 1] < nodeIDToPosInFile[i];
+  if (!isSorted)
+    sort(nodeIDToPosInFile.begin(), nodeIDToPosInFile.end());
+  for (int i = 1; i < numberOfNodesInFile; i++)
+    if (nodeIDToPosInFile[i - 1].first == nodeIDToPosInFile[i].first)
+      exitReadError(fileName, "has duplicate node tags");
+
+  // only the nodes belonging to elements are in the mesh, concurrent marks write the same value
+  vector<char> isMeshNode(numberOfNodesInFile, 0);
+  const int tableSize = elementNodeTablesInFile.size();
+  int numberOfMissingNodes = 0;
+#pragma omp parallel for schedule(static) reduction(+:numberOfMissingNodes)
+  for (int i = 0; i < tableSize; i++) {
+    vector<pair<int, int> >::const_iterator it = lower_bound(nodeIDToPosInFile.begin(),
+	nodeIDToPosInFile.end(), pair<int, int>(elementNodeTablesInFile[i], -1));
+    if (it == nodeIDToPosInFile.end() || it->first != elementNodeTablesInFile[i])
+      numberOfMissingNodes++;
+    else
+      isMeshNode[it - nodeIDToPosInFile.begin()] = 1;
+  }
+  if (numberOfMissingNodes > 0)
+    exitReadError(fileName, "has elements with nodes which do not exist");
+
+  vector<int> meshNodePosOfNode(numberOfNodesInFile);
+  numberOfMeshNodes = 0;
+  for (int i = 0; i < numberOfNodesInFile; i++) {
+    meshNodePosOfNode[i] = numberOfMeshNodes;
+    numberOfMeshNodes += isMeshNode[i];
+  }
+  meshNodeCoordinates = new double[(size_t) numberOfMeshNodes * XYZ];
+  meshNodeIds = new int[numberOfMeshNodes];
+#pragma omp parallel for schedule(static)
+  for (int i = 0; i < numberOfNodesInFile; i++) {
+    if (!isMeshNode[i])
+      continue;
+    int pos = meshNodePosOfNode[i];
+    int posInFile = nodeIDToPosInFile[i].second;
+    meshNodeIds[pos] = nodeIDToPosInFile[i].first;
+    for (int j = 0; j < XYZ; j++)
+      meshNodeCoordinates[(size_t) pos * XYZ + j] = nodeCoordinatesInFile[(size_t) posInFile * XYZ + j];
+  }
+
+  numberOfElements = elementIdsInFile.size();
+  numberOfNodesPerElement = new int[numberOfElements];
+  elementIds = new int[numberOfElements];
+  elementNodeTables = new int[tableSize];
+  if (numberOfElements > 0) {
+    memcpy(numberOfNodesPerElement, &numberOfNodesPerElementInFile[0], numberOfElements * sizeof(int));
+    memcpy(elementIds, &elementIdsInFile[0], numberOfElements * sizeof(int));
+    memcpy(elementNodeTables, &elementNodeTablesInFile[0], tableSize * sizeof(int));
+  }
+}
+
+/***********************************************************************************************
+ * \brief Collects small binary values and large chunks in one buffer, which is written to the
+ *        stream in large pieces
+ ***********/
+class BufferedBinaryWriter {
+public:
+  BufferedBinaryWriter(ofstream &_outputStream) :
+    outputStream(_outputStream) {
+    buffer.reserve(BUFFER_SIZE);
+  }
+  ~BufferedBinaryWriter() {
+    flush();
+  }
+  template<typename T>
+  void put(const T &value) {
+    memcpy(grow(sizeof(T)), &value, sizeof(T));
+  }
+  void putText(const char *text) {
+    memcpy(grow(strlen(text)), text, strlen(text));
+  }
+  /// append size bytes to the buffer, which are filled by the caller
+  char *grow(size_t size) {
+    if (!buffer.empty() && buffer.size() + size > BUFFER_SIZE)
+      flush();
+    size_t oldSize = buffer.size();
+    buffer.resize(oldSize + size);
+    return &buffer[oldSize];
+  }
+  void flush() {
+    if (!buffer.empty())
+      outputStream.write(&buffer[0], buffer.size());
+    buffer.clear();
+  }
+private:
+  static const size_t BUFFER_SIZE = 64 << 20;
+  ofstream &outputStream;
+  vector<char> buffer;
+};
+
+/***********************************************************************************************
+ * \brief Write a Gmsh 4.1 binary .msh file. All nodes are in one block sorted by id, the elements
+ *        are in one block of triangles and one block of quads. There is no $Entities section,
+ *        Gmsh creates discrete entities for the blocks.
+ ***********/
+void writeBinaryDotMsh(const string &fileName, int numberOfMeshNodes, int numberOfElements,
+		       const double *meshNodeCoordinates, const int *meshNodeIds,
+		       const int *numberOfNodesPerElement, const int *elementNodeTables, const int *elementIds) {
+  ofstream outputStream(fileName.c_str(), ios::binary);
+  if (!outputStream) {
+    cerr << "GmshFileIO::writeDotMsh: Gmsh .msh file \"" << fileName << "\" cannot be created" << endl;
+    exit(EXIT_FAILURE);
+  }
+  const int surfaceDim = 2, entityTag = 1, notParametric = 0;
+  BufferedBinaryWriter writer(outputStream);
+
+  // write header
+  writer.putText("$MeshFormat\n4.1 1 8\n");
+  writer.put((int) 1);
+  writer.putText("\n$EndMeshFormat\n");
+
+  { // write nodes ordered by id
+    vector<pair<int, int> > nodeIDToPos(numberOfMeshNodes);
+    for (int i = 0; i < numberOfMeshNodes; i++)
+      nodeIDToPos[i] = pair<int, int>(meshNodeIds[i], i);
+    sort(nodeIDToPos.begin(), nodeIDToPos.end());
+
+    writer.putText("$Nodes\n");
+    writer.put((size_t) 1);
+    writer.put((size_t) numberOfMeshNodes);
+    writer.put((size_t) (numberOfMeshNodes > 0 ? nodeIDToPos.front().first : 0));
+    writer.put((size_t) (numberOfMeshNodes > 0 ? nodeIDToPos.back().first : 0));
+    writer.put(surfaceDim);
+    writer.put(entityTag);
+    writer.put(notParametric);
+    writer.put((size_t) numberOfMeshNodes);
+    for (int first = 0; first < numberOfMeshNodes; first += WRITE_CHUNK_SIZE) {
+      int count = min(WRITE_CHUNK_SIZE, numberOfMeshNodes - first);
+      char *out = writer.grow(count * sizeof(size_t));
+#pragma omp parallel for schedule(static)
+      for (int i = 0; i < count; i++) {
+	size_t tag = nodeIDToPos[first + i].first;
+	memcpy(out + i * sizeof(size_t), &tag, sizeof(size_t));
+      }
+    }
+    for (int first = 0; first < numberOfMeshNodes; first += WRITE_CHUNK_SIZE) {
+      int count = min(WRITE_CHUNK_SIZE, numberOfMeshNodes - first);
+      char *out = writer.grow(count * XYZ * sizeof(double));
+#pragma omp parallel for schedule(static)
+      for (int i = 0; i < count; i++)
+	memcpy(out + i * XYZ * sizeof(double), meshNodeCoordinates + (size_t) nodeIDToPos[first + i].second * XYZ,
+	       XYZ * sizeof(double));
+    }
+    writer.putText("\n$EndNodes\n");
+  }
+
+  { // write elements, one block per element type
+    vector<int> elementsOfType[2]; // triangles and quads
+    vector<size_t> tableOffsets(numberOfElements);
+    size_t tableOffset = 0;
+    int minTag = INT_MAX, maxTag = 0;
+    for (int i = 0; i < numberOfElements; i++) {
+      tableOffsets[i] = tableOffset;
+      tableOffset += numberOfNodesPerElement[i];
+      if (numberOfNodesPerElement[i] == 3)
+	elementsOfType[0].push_back(i);
+      else if (numberOfNodesPerElement[i] == 4)
+	elementsOfType[1].push_back(i);
+      else {
+	cerr << "GmshFileIO::writeDotMsh: only triangles and quads can be written" << endl;
+	exit(EXIT_FAILURE);
+      }
+      minTag = min(minTag, elementIds[i]);
+      maxTag = max(maxTag, elementIds[i]);
+    }
+    const int types[2] = {2, 3};
+
+    writer.putText("$Elements\n");
+    writer.put((size_t) (!elementsOfType[0].empty() + !elementsOfType[1].empty()));
+    writer.put((size_t) numberOfElements);
+    writer.put((size_t) (numberOfElements > 0 ? minTag : 0));
+    writer.put((size_t) maxTag);
+    for (int t = 0; t < 2; t++) {
+      const vector<int> &elements = elementsOfType[t];
+      const int numberOfElementsOfType = elements.size();
+      if (numberOfElementsOfType == 0)
+	continue;
+      const int numberOfNodesThisType = numberOfNodesOfElementType(types[t]);
+      const int numberOfValuesPerElement = 1 + numberOfNodesThisType;
+      writer.put(surfaceDim);
+      writer.put(entityTag);
+      writer.put(types[t]);
+      writer.put((size_t) numberOfElementsOfType);
+      for (int first = 0; first < numberOfElementsOfType; first += WRITE_CHUNK_SIZE) {
+	int count = min(WRITE_CHUNK_SIZE, numberOfElementsOfType - first);
+	char *out = writer.grow((size_t) count * numberOfValuesPerElement * sizeof(size_t));
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < count; i++) {
+	  int element = elements[first + i];
+	  size_t values[1 + 4];
+	  values[0] = elementIds[element];
+	  for (int j = 0; j < numberOfNodesThisType; j++)
+	    values[1 + j] = elementNodeTables[tableOffsets[element] + j];
+	  memcpy(out + (size_t) i * numberOfValuesPerElement * sizeof(size_t), values,
+		 numberOfValuesPerElement * sizeof(size_t));
+	}
+      }
+    }
+    writer.putText("\n$EndElements\n");
+  }
+  writer.flush();
+  if (!outputStream) {
+    cerr << "GmshFileIO::writeDotMsh: Gmsh .msh file \"" << fileName << "\" cannot be written" << endl;
+    exit(EXIT_FAILURE);
+  }
+}
+} /* namespace */
+
 void GmshFileIO::readDotMsh(string fileName, int &numberOfMeshNodes, int &numberOfElements, double *&meshNodeCoordinates,
 			    int *&meshNodeIds, int *&numberOfNodesPerElement, int *&elementNodeTables, int *&elementIds) {
+  { // binary files are read from the mapped file, ascii files with the stream below
+    TextFileScanner::MappedFile file(fileName);
+    const char *end = file.end();
+    for (const char *line = file.begin(); file.isOpen() && line < end; line = TextFileScanner::nextLine(line, end)) {
+      if (!TextFileScanner::wordEquals(line, end, "$meshformat"))
+	continue;
+      line = TextFileScanner::nextLine(line, end);
+      double versionNumber;
+      int fileType = 0, dataSize = 0;
+      const char *p = TextFileScanner::scanDouble(line, end, versionNumber);
+      if (p != NULL)
+	p = TextFileScanner::scanInt(p, end, fileType);
+      if (p != NULL)
+	p = TextFileScanner::scanInt(p, end, dataSize);
+      if (p == NULL)
+	exitReadError(fileName, "has a corrupt $MeshFormat section");
+      if (fileType != 1) // ascii file format
+	break;
+      if (versionNumber != 4.1 || dataSize != sizeof(size_t))
+	exitReadError(fileName, "is binary, but not in the Gmsh 4.1 format with 8 byte integers");
+      readBinaryDotMsh(TextFileScanner::nextLine(line, end), end, fileName, numberOfMeshNodes, numberOfElements,
+		       meshNodeCoordinates, meshNodeIds, numberOfNodesPerElement, elementNodeTables, elementIds);
+      return;
+    }
+  }
   ifstream inputStream(fileName.c_str());
   if (!inputStream) {
     cerr << "GmshFileIO::readDotMsh: Gmsh .msh file \"" << fileName << "\" cannot be found"
 	 << '\n';
     exit(EXIT_FAILURE);
   }
-  const int XYZ = 3;
   bool inNodes = false, inElements = false;
   int numberOfNodes;
   int numberOfNodesThisElement = 0;
@@ -222,8 +775,13 @@ void GmshFileIO::readDotMsh(string fileName, int &numberOfMeshNodes, int &number
 }
 
 void GmshFileIO::writeDotMsh(string fileName, int numberOfMeshNodes, int numberOfElements, double *&meshNodeCoordinates,
-			     int *meshNodeIds, int *numberOfNodesPerElement, int *elementNodeTables, int *elementIds) {
-  const int XYZ = 3;
+			     int *meshNodeIds, int *numberOfNodesPerElement, int *elementNodeTables, int *elementIds,
+			     bool binary) {
+  if (binary) {
+    writeBinaryDotMsh(fileName, numberOfMeshNodes, numberOfElements, meshNodeCoordinates, meshNodeIds,
+		      numberOfNodesPerElement, elementNodeTables, elementIds);
+    return;
+  }
   list<MeshIO::Node *> meshNodes;
   list<MeshIO::Element *> elements;
   
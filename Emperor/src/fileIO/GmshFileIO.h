@@ -36,7 +36,9 @@ namespace EMPIRE {
 class GmshFileIO {
 public:
     /***********************************************************************************************
-     * \brief Read a .msh file, initialize mesh data
+     * \brief Read a .msh file, initialize mesh data. Ascii files in the format 2.2 and binary files
+     *        in the format 4.1 are supported. Binary files are memory-mapped and their node and
+     *        element blocks are copied in parallel; points and lines of the geometry are skipped.
      * \param[in] fileName name of the mesh file
      * \param[out] numberOfMeshNodes number of nodes belonging to elements
      * \param[out] numberOfElements number of elements in the mesh
@@ -50,7 +52,8 @@ public:
     static void readDotMsh(std::string fileName, int &numberOfMeshNodes, int &numberOfElements, double *&meshNodeCoordinates,
 			   int *&meshNodeIds, int *&numberOfNodesPerElement, int *&elementNodeTables, int *&elementIds);
     /***********************************************************************************************
-     * \brief Write a .msh file
+     * \brief Write a .msh file, either ascii in the format 2.2 or binary in the format 4.1. Binary
+     *        files are filled in parallel and written in large chunks.
      * \param[in] fileName name of the mesh file
      * \param[out] numberOfMeshNodes number of nodes belonging to elements
      * \param[out] numberOfElements number of elements in the mesh
@@ -59,10 +62,12 @@ public:
      * \param[out] numberOfNodesPerElement number of nodes in each element
      * \param[out] elementNodeTables "element tables" or "connectivity tables"
      * \param[out] elementIds index/id of each element
+     * \param[in] binary write the binary format 4.1 instead of the ascii format 2.2
      * \author Michael Andre
      ***********/
      static void writeDotMsh(std::string fileName, int numberOfMeshNodes, int numberOfElements, double *&meshNodeCoordinates,
-			     int *meshNodeIds, int *numberOfNodesPerElement, int *elementNodeTables, int *elementIds);
+			     int *meshNodeIds, int *numberOfNodesPerElement, int *elementNodeTables, int *elementIds,
+			     bool binary = false);
 };
 } /* namespace EMPIRE */
 
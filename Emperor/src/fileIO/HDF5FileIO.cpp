@@ -0,0 +1,403 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <assert.h>
+#include "stdlib.h"
+
+#include "HDF5FileIO.h"
+
+#ifdef USE_HDF5
+#include <pthread.h>
+#include "hdf5.h"
+#include "IGAMesh.h"
+#include "IGAPatchSurface.h"
+#include "IGAControlPoint.h"
+#include "IGATessellationIO.h"
+#include "IDToIndexMap.h"
+#endif
+
+using namespace std;
+
+namespace HDF5FileIO {
+
+#ifdef USE_HDF5
+/// the HDF5 library is in general not built thread safe, all calls are serialized by this mutex
+static pthread_mutex_t hdf5Mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/********//**
+ * \brief Class ScopedLock locks hdf5Mutex during its lifetime
+ ***********/
+class ScopedLock {
+public:
+    ScopedLock() {
+        pthread_mutex_lock(&hdf5Mutex);
+    }
+    ~ScopedLock() {
+        pthread_mutex_unlock(&hdf5Mutex);
+    }
+};
+
+/// XDMF type code of a polygon in a Mixed topology
+const int XDMF_POLYGON = 3;
+/// XDMF type code of a triangle in a Mixed topology
+const int XDMF_TRIANGLE = 4;
+/// XDMF type code of a quadrilateral in a Mixed topology
+const int XDMF_QUADRILATERAL = 5;
+/// XDMF type code of a polyline in a Mixed topology
+const int XDMF_POLYLINE = 2;
+/// maximum number of rows of a chunk of a result dataset
+const hsize_t MAX_CHUNK_ROWS = 16384;
+
+/***********************************************************************************************
+ * \brief Write a 2D dataset, exit on failure
+ ***********/
+static void writeDataset(hid_t fileID, const string &name, hid_t memType, hsize_t rows,
+        hsize_t cols, const void *data, int compressionLevel, bool chunked) {
+    hsize_t dims[2] = { rows, cols };
+    hid_t spaceID = H5Screate_simple(2, dims, NULL);
+    hid_t lcplID = H5Pcreate(H5P_LINK_CREATE);
+    H5Pset_create_intermediate_group(lcplID, 1);
+    hid_t dcplID = H5Pcreate(H5P_DATASET_CREATE);
+    if (chunked && rows > 0 && cols > 0) {
+        hsize_t chunk[2] = { (rows < MAX_CHUNK_ROWS ? rows : MAX_CHUNK_ROWS), cols };
+        H5Pset_chunk(dcplID, 2, chunk);
+        if (compressionLevel > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) > 0)
+            H5Pset_deflate(dcplID, compressionLevel);
+    }
+    hid_t datasetID = H5Dcreate2(fileID, name.c_str(), memType, spaceID, lcplID, dcplID,
+            H5P_DEFAULT);
+    if (datasetID < 0) {
+        cerr << "HDF5FileIO: cannot create dataset " << name << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (rows > 0 && cols > 0
+            && H5Dwrite(datasetID, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data) < 0) {
+        cerr << "HDF5FileIO: cannot write dataset " << name << endl;
+        exit(EXIT_FAILURE);
+    }
+    H5Dclose(datasetID);
+    H5Pclose(dcplID);
+    H5Pclose(lcplID);
+    H5Sclose(spaceID);
+}
+
+/***********************************************************************************************
+ * \brief The dataset name of a result, '/' in the result name is replaced
+ ***********/
+static string datasetNameOfResult(string resultName, int stepNum) {
+    for (int i = 0; i < resultName.size(); i++)
+        if (resultName[i] == '/')
+            resultName[i] = '_';
+    stringstream ss;
+    ss << "/results/" << resultName << "/" << stepNum;
+    return ss.str();
+}
+
+/***********************************************************************************************
+ * \brief Remove the directory part of a file name
+ ***********/
+static string baseName(const string &fileName) {
+    size_t pos = fileName.find_last_of('/');
+    return (pos == string::npos ? fileName : fileName.substr(pos + 1));
+}
+
+Writer::Writer(string _fileName, int _compressionLevel) :
+        fileName(_fileName), compressionLevel(_compressionLevel), numNodes(0), numElems(0), topologySize(
+                0) {
+    ScopedLock lock;
+    string h5FileName = fileName + ".h5";
+    fileID = H5Fcreate(h5FileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (fileID < 0) {
+        cerr << "HDF5FileIO: cannot create " << h5FileName << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+Writer::~Writer() {
+    ScopedLock lock;
+    H5Fclose(fileID);
+    writeXDMF();
+}
+
+void Writer::writeFEMesh(int _numNodes, const double *nodes, const int *nodeIDs, int _numElems,
+        const int *numNodesPerElem, const int *elems, const int *elemIDs) {
+    EMPIRE::IDToIndexMap nodeIDToNodePosMap(_numNodes, nodeIDs);
+    vector<double> geometry(nodes, nodes + _numNodes * 3);
+    vector<int> elemSizes(numNodesPerElem, numNodesPerElem + _numElems);
+    vector<int> elemNodePositions;
+    int count = 0;
+    for (int i = 0; i < _numElems; i++) {
+        for (int j = 0; j < numNodesPerElem[i]; j++)
+            elemNodePositions.push_back(nodeIDToNodePosMap.at(elems[count + j]));
+        count += numNodesPerElem[i];
+    }
+    writeMesh(geometry, elemSizes, elemNodePositions);
+
+    ScopedLock lock;
+    writeDataset(fileID, "/mesh/nodeIDs", H5T_NATIVE_INT, _numNodes, 1, nodeIDs, 0, false);
+    writeDataset(fileID, "/mesh/elemIDs", H5T_NATIVE_INT, _numElems, 1, elemIDs, 0, false);
+}
+
+void Writer::writeIGAControlNet(const EMPIRE::IGAMesh *mesh) {
+    vector<double> geometry(mesh->getNumNodes() * 3, 0.0);
+    vector<int> elemSizes;
+    vector<int> elemNodePositions;
+    for (int p = 0; p < mesh->getNumPatches(); p++) {
+        const EMPIRE::IGAPatchSurface *patch = mesh->getSurfacePatch(p);
+        int uNoCPs = patch->getUNoControlPoints();
+        int vNoCPs = patch->getVNoControlPoints();
+        for (int i = 0; i < patch->getNoControlPoints(); i++) {
+            int dof = (*patch)[i]->getDofIndex();
+            assert(dof >= 0 && dof < mesh->getNumNodes());
+            geometry[dof * 3 + 0] = (*patch)[i]->getX();
+            geometry[dof * 3 + 1] = (*patch)[i]->getY();
+            geometry[dof * 3 + 2] = (*patch)[i]->getZ();
+        }
+        // the control point of index (u, v) is stored at v * uNoCPs + u
+        for (int v = 0; v < vNoCPs - 1; v++) {
+            for (int u = 0; u < uNoCPs - 1; u++) {
+                elemSizes.push_back(4);
+                elemNodePositions.push_back((*patch)[v * uNoCPs + u]->getDofIndex());
+                elemNodePositions.push_back((*patch)[v * uNoCPs + u + 1]->getDofIndex());
+                elemNodePositions.push_back((*patch)[(v + 1) * uNoCPs + u + 1]->getDofIndex());
+                elemNodePositions.push_back((*patch)[(v + 1) * uNoCPs + u]->getDofIndex());
+            }
+        }
+    }
+    writeMesh(geometry, elemSizes, elemNodePositions);
+}
+
+void Writer::writeTessellation(const EMPIRE::IGATessellationIO::Tessellation *tessellation) {
+    vector<int> elemSizes(tessellation->getNumQuads(), 4);
+    writeMesh(tessellation->getPoints(), elemSizes, tessellation->getQuads());
+}
+
+void Writer::writeMesh(const vector<double> &geometry, const vector<int> &elemSizes,
+        const vector<int> &elemNodePositions) {
+    ScopedLock lock;
+    assert(numNodes == 0 && numElems == 0); // only one mesh per file
+    numNodes = geometry.size() / 3;
+    numElems = elemSizes.size();
+
+    bool allTriangles = true;
+    bool allQuadrilaterals = true;
+    for (int i = 0; i < numElems; i++) {
+        allTriangles = allTriangles && (elemSizes[i] == 3);
+        allQuadrilaterals = allQuadrilaterals && (elemSizes[i] == 4);
+    }
+    vector<int> topology;
+    if (numElems > 0 && (allTriangles || allQuadrilaterals)) {
+        topologyType = (allTriangles ? "Triangle" : "Quadrilateral");
+        topology = elemNodePositions;
+    } else {
+        topologyType = "Mixed";
+        int count = 0;
+        for (int i = 0; i < numElems; i++) {
+            if (elemSizes[i] == 3) {
+                topology.push_back(XDMF_TRIANGLE);
+            } else if (elemSizes[i] == 4) {
+                topology.push_back(XDMF_QUADRILATERAL);
+            } else if (elemSizes[i] == 2) {
+                topology.push_back(XDMF_POLYLINE);
+                topology.push_back(2);
+            } else {
+                topology.push_back(XDMF_POLYGON);
+                topology.push_back(elemSizes[i]);
+            }
+            for (int j = 0; j < elemSizes[i]; j++)
+                topology.push_back(elemNodePositions[count + j]);
+            count += elemSizes[i];
+        }
+    }
+    topologySize = topology.size();
+
+    writeDataset(fileID, "/mesh/geometry", H5T_NATIVE_DOUBLE, numNodes, 3,
+            (geometry.empty() ? NULL : &geometry[0]), 0, false);
+    writeDataset(fileID, "/mesh/topology", H5T_NATIVE_INT, topologySize, 1,
+            (topology.empty() ? NULL : &topology[0]), 0, false);
+}
+
+void Writer::appendData(string resultName, int stepNum, bool atNode, int numComponents,
+        int numLocations, const double *data) {
+    ScopedLock lock;
+    assert(numLocations == (atNode ? numNodes : numElems));
+    Result result;
+    result.resultName = resultName;
+    result.datasetName = datasetNameOfResult(resultName, stepNum);
+    result.stepNum = stepNum;
+    result.atNode = atNode;
+    result.numComponents = numComponents;
+    writeDataset(fileID, result.datasetName, H5T_NATIVE_DOUBLE, numLocations, numComponents, data,
+            compressionLevel, true);
+    H5Fflush(fileID, H5F_SCOPE_LOCAL);
+    results.push_back(result);
+}
+
+void Writer::writeXDMF() const {
+    string xdmfFileName = fileName + ".xdmf";
+    string h5FileName = baseName(fileName) + ".h5"; // relative to the XDMF file
+    ofstream xdmfFile(xdmfFileName.c_str(), ios_base::out);
+    if (xdmfFile.fail()) {
+        cerr << "HDF5FileIO: cannot open " << xdmfFileName << endl;
+        exit(EXIT_FAILURE);
+    }
+    // group the results by step, in increasing order
+    map<int, vector<int> > stepToResultsMap;
+    for (int i = 0; i < results.size(); i++)
+        stepToResultsMap[results[i].stepNum].push_back(i);
+    if (stepToResultsMap.empty())
+        stepToResultsMap[0]; // the mesh only
+
+    xdmfFile << "<?xml version=\"1.0\" ?>" << endl;
+    xdmfFile << "<Xdmf Version=\"2.0\">" << endl;
+    xdmfFile << "  <Domain>" << endl;
+    xdmfFile << "    <Grid Name=\"mesh\" GridType=\"Collection\" CollectionType=\"Temporal\">"
+            << endl;
+    for (map<int, vector<int> >::const_iterator it = stepToResultsMap.begin();
+            it != stepToResultsMap.end(); it++) {
+        xdmfFile << "      <Grid Name=\"step_" << it->first << "\" GridType=\"Uniform\">" << endl;
+        xdmfFile << "        <Time Value=\"" << it->first << "\"/>" << endl;
+        xdmfFile << "        <Topology TopologyType=\"" << topologyType
+                << "\" NumberOfElements=\"" << numElems << "\">" << endl;
+        xdmfFile << "          <DataItem Dimensions=\"" << topologySize
+                << "\" NumberType=\"Int\" Format=\"HDF\">" << h5FileName << ":/mesh/topology"
+                << "</DataItem>" << endl;
+        xdmfFile << "        </Topology>" << endl;
+        xdmfFile << "        <Geometry GeometryType=\"XYZ\">" << endl;
+        xdmfFile << "          <DataItem Dimensions=\"" << numNodes
+                << " 3\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">" << h5FileName
+                << ":/mesh/geometry</DataItem>" << endl;
+        xdmfFile << "        </Geometry>" << endl;
+        for (int i = 0; i < it->second.size(); i++) {
+            const Result &result = results[it->second[i]];
+            xdmfFile << "        <Attribute Name=\"" << result.resultName << "\" AttributeType=\""
+                    << (result.numComponents == 3 ? "Vector" : "Scalar") << "\" Center=\""
+                    << (result.atNode ? "Node" : "Cell") << "\">" << endl;
+            xdmfFile << "          <DataItem Dimensions=\""
+                    << (result.atNode ? numNodes : numElems) << " " << result.numComponents
+                    << "\" NumberType=\"Float\" Precision=\"8\" Format=\"HDF\">" << h5FileName
+                    << ":" << result.datasetName << "</DataItem>" << endl;
+            xdmfFile << "        </Attribute>" << endl;
+        }
+        xdmfFile << "      </Grid>" << endl;
+    }
+    xdmfFile << "    </Grid>" << endl;
+    xdmfFile << "  </Domain>" << endl;
+    xdmfFile << "</Xdmf>" << endl;
+    xdmfFile.close();
+}
+
+bool readData(string fileName, string resultName, int stepNum, int size, double *data) {
+    ScopedLock lock;
+    string h5FileName = fileName + ".h5";
+    hid_t fileID = H5Fopen(h5FileName.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (fileID < 0) {
+        cerr << "HDF5FileIO: cannot open " << h5FileName << endl;
+        exit(EXIT_FAILURE);
+    }
+    string datasetName = datasetNameOfResult(resultName, stepNum);
+    // check link by link, H5Lexists needs the intermediate groups to exist
+    bool found = true;
+    string path;
+    string remaining = datasetName.substr(1);
+    while (found && !remaining.empty()) {
+        size_t pos = remaining.find('/');
+        path += "/" + remaining.substr(0, pos);
+        remaining = (pos == string::npos ? "" : remaining.substr(pos + 1));
+        found = (H5Lexists(fileID, path.c_str(), H5P_DEFAULT) > 0);
+    }
+    if (found) {
+        hid_t datasetID = H5Dopen2(fileID, datasetName.c_str(), H5P_DEFAULT);
+        hid_t spaceID = H5Dget_space(datasetID);
+        if (H5Sget_simple_extent_npoints(spaceID) != size) {
+            cerr << "HDF5FileIO: dataset " << datasetName << " of " << h5FileName
+                    << " does not have " << size << " values" << endl;
+            exit(EXIT_FAILURE);
+        }
+        if (size > 0
+                && H5Dread(datasetID, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)
+                        < 0) {
+            cerr << "HDF5FileIO: cannot read dataset " << datasetName << endl;
+            exit(EXIT_FAILURE);
+        }
+        H5Sclose(spaceID);
+        H5Dclose(datasetID);
+    }
+    H5Fclose(fileID);
+    return found;
+}
+
+#else /* USE_HDF5 */
+/***********************************************************************************************
+ * \brief Exit since EMPIRE is built without HDF5
+ ***********/
+static void exitWithoutHDF5() {
+    cerr << "HDF5FileIO: EMPIRE is built without HDF5, reconfigure with USE_HDF5=ON" << endl;
+    exit(EXIT_FAILURE);
+}
+
+Writer::Writer(string _fileName, int _compressionLevel) :
+        fileName(_fileName), compressionLevel(_compressionLevel), fileID(-1), numNodes(0), numElems(
+                0), topologySize(0) {
+    exitWithoutHDF5();
+}
+
+Writer::~Writer() {
+}
+
+void Writer::writeFEMesh(int _numNodes, const double *nodes, const int *nodeIDs, int _numElems,
+        const int *numNodesPerElem, const int *elems, const int *elemIDs) {
+    exitWithoutHDF5();
+}
+
+void Writer::writeIGAControlNet(const EMPIRE::IGAMesh *mesh) {
+    exitWithoutHDF5();
+}
+
+void Writer::writeTessellation(const EMPIRE::IGATessellationIO::Tessellation *tessellation) {
+    exitWithoutHDF5();
+}
+
+void Writer::writeMesh(const vector<double> &geometry, const vector<int> &elemSizes,
+        const vector<int> &elemNodePositions) {
+    exitWithoutHDF5();
+}
+
+void Writer::appendData(string resultName, int stepNum, bool atNode, int numComponents,
+        int numLocations, const double *data) {
+    exitWithoutHDF5();
+}
+
+void Writer::writeXDMF() const {
+    exitWithoutHDF5();
+}
+
+bool readData(string fileName, string resultName, int stepNum, int size, double *data) {
+    exitWithoutHDF5();
+    return false;
+}
+#endif /* USE_HDF5 */
+
+} /* namespace HDF5FileIO */
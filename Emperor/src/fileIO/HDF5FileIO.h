@@ -0,0 +1,155 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file HDF5FileIO.h
+ * This file holds the HDF5 result file format. One file holds a mesh (FE mesh, section mesh or the
+ * control net of an IGA mesh) and all data written on it:
+ *  - /mesh/geometry: the node (or control point) coordinates, numNodes x 3
+ *  - /mesh/topology: the elements by node positions, in XDMF "Mixed" layout unless all elements
+ *    are triangles or all are quadrilaterals
+ *  - /mesh/nodeIDs, /mesh/elemIDs: the IDs, for FE meshes only
+ *  - /results/<name>/<step>: one chunked (optionally compressed) dataset per result and step
+ * An XDMF index <fileName>.xdmf referring to the datasets is written when the file is closed, such
+ * that the results can be loaded in ParaView as a time series.
+ * If EMPIRE is built without USE_HDF5, creating a writer or reading a file is an error.
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef HDF5FILEIO_H_
+#define HDF5FILEIO_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace EMPIRE {
+class IGAMesh;
+namespace IGATessellationIO {
+class Tessellation;
+}
+}
+
+namespace HDF5FileIO {
+/********//**
+ * \brief Class Writer writes an HDF5 result file and its XDMF index. Calls to the HDF5 library are
+ *        serialized, so that writers of different data outputs can live on different threads.
+ ***********/
+class Writer {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, creates the file
+     * \param[in] fileName name of the file without extension (.h5 and .xdmf are appended)
+     * \param[in] compressionLevel deflate level of the result datasets, 0 for no compression
+     ***********/
+    Writer(std::string fileName, int compressionLevel);
+    /***********************************************************************************************
+     * \brief Destructor, writes the XDMF index and closes the file
+     ***********/
+    virtual ~Writer();
+    /***********************************************************************************************
+     * \brief Write a FE mesh, the node IDs in elems are converted to node positions
+     * \param[in] numNodes number of nodes
+     * \param[in] nodes coordinates of the nodes
+     * \param[in] nodeIDs IDs of the nodes
+     * \param[in] numElems number of elements
+     * \param[in] numNodesPerElem number of nodes of each element
+     * \param[in] elems the nodes IDs of all elements
+     * \param[in] elemIDs IDs of the elements
+     ***********/
+    void writeFEMesh(int numNodes, const double *nodes, const int *nodeIDs, int numElems,
+            const int *numNodesPerElem, const int *elems, const int *elemIDs);
+    /***********************************************************************************************
+     * \brief Write the control net of an IGA mesh. The control points are stored by their dof
+     *        index, and the net of each patch is stored as quadrilaterals
+     * \param[in] mesh the IGA mesh
+     ***********/
+    void writeIGAControlNet(const EMPIRE::IGAMesh *mesh);
+    /***********************************************************************************************
+     * \brief Write the tessellation of an IGA mesh, its data fields are appended at the points
+     * \param[in] tessellation the tessellation
+     ***********/
+    void writeTessellation(const EMPIRE::IGATessellationIO::Tessellation *tessellation);
+    /***********************************************************************************************
+     * \brief Write data of a certain step
+     * \param[in] resultName name of the data
+     * \param[in] stepNum step number
+     * \param[in] atNode true for data on nodes or control points, false for elemental data
+     * \param[in] numComponents number of components per location (1 or 3)
+     * \param[in] numLocations number of nodes or elements
+     * \param[in] data data of this step
+     ***********/
+    void appendData(std::string resultName, int stepNum, bool atNode, int numComponents,
+            int numLocations, const double *data);
+
+private:
+    /********//**
+     * \brief Structure Result describes a dataset of the results
+     ***********/
+    struct Result {
+        std::string resultName;
+        std::string datasetName;
+        int stepNum;
+        bool atNode;
+        int numComponents;
+    };
+    /// name of the file without extension
+    std::string fileName;
+    /// deflate level of the result datasets
+    int compressionLevel;
+    /// the HDF5 file
+    int64_t fileID;
+    /// number of nodes of the mesh
+    int numNodes;
+    /// number of elements of the mesh
+    int numElems;
+    /// size of the topology dataset
+    int topologySize;
+    /// XDMF topology type, Triangle, Quadrilateral or Mixed
+    std::string topologyType;
+    /// all results written so far
+    std::vector<Result> results;
+    /***********************************************************************************************
+     * \brief Write the mesh datasets
+     ***********/
+    void writeMesh(const std::vector<double> &geometry, const std::vector<int> &elemSizes,
+            const std::vector<int> &elemNodePositions);
+    /***********************************************************************************************
+     * \brief Write the XDMF index
+     ***********/
+    void writeXDMF() const;
+    /// disallow copy constructor
+    Writer(const Writer&);
+    /// disallow assignment operator
+    Writer& operator=(const Writer&);
+};
+
+/***********************************************************************************************
+ * \brief Read data of a certain step from an HDF5 result file, e.g. for restarting
+ * \param[in] fileName name of the file without extension
+ * \param[in] resultName name of the data
+ * \param[in] stepNum step number
+ * \param[in] size number of doubles expected (numLocations * numComponents)
+ * \param[out] data the data
+ * \return false if the file does not contain the data of this step
+ ***********/
+bool readData(std::string fileName, std::string resultName, int stepNum, int size, double *data);
+
+} /* namespace HDF5FileIO */
+#endif /* HDF5FILEIO_H_ */
@@ -0,0 +1,286 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "IGATessellationIO.h"
+#include "IGAMesh.h"
+#include "IGAPatchSurface.h"
+#include "IGAControlPoint.h"
+#include "BSplineBasis2D.h"
+#include "BSplineBasis1D.h"
+#include "ScratchArray.h"
+#include "CSRMatrix.h"
+#include "AuxiliaryParameters.h"
+#include "Message.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+namespace EMPIRE {
+namespace IGATessellationIO {
+
+/// the tessellation of a single patch
+struct PatchTessellation {
+    std::vector<double> points;
+    std::vector<int> quads;
+    std::vector<int> rowPtr;
+    std::vector<int> cols;
+    std::vector<double> values;
+};
+
+/***********************************************************************************************
+ * \brief Get the grid parameters of a direction, each knot span is subdivided
+ ***********/
+static void computeGridParameters(const BSplineBasis1D *basis, int numSubdivisions,
+        vector<double> &parameters) {
+    const double *knots = basis->getKnotVector();
+    parameters.clear();
+    for (int i = 0; i < basis->getNoKnots() - 1; i++) {
+        if (knots[i] == knots[i + 1])
+            continue;
+        for (int j = 0; j < numSubdivisions; j++)
+            parameters.push_back(knots[i] + (knots[i + 1] - knots[i]) * j / numSubdivisions);
+    }
+    parameters.push_back(knots[basis->getNoKnots() - 1]);
+}
+
+/***********************************************************************************************
+ * \brief Tessellate a patch, a grid point is inside the trimmed domain if it is inside an odd
+ *        number of trimming loops, a grid cell is kept if its four points are inside
+ ***********/
+static void tessellatePatch(const IGAPatchSurface *patch, int numSubdivisions,
+        PatchTessellation &tessellation) {
+    BSplineBasis2D *basis = patch->getIGABasis();
+    vector<double> uParameters;
+    vector<double> vParameters;
+    computeGridParameters(basis->getUBSplineBasis1D(), numSubdivisions, uParameters);
+    computeGridParameters(basis->getVBSplineBasis1D(), numSubdivisions, vParameters);
+    const int numU = uParameters.size();
+    const int numV = vParameters.size();
+
+    vector<char> isInside(numU * numV, true);
+    if (patch->isTrimmed()) {
+        const IGAPatchSurfaceTrimming &trimming = patch->getTrimming();
+        for (int j = 0; j < numV; j++) {
+            for (int i = 0; i < numU; i++) {
+                double uv[2] = { uParameters[i], vParameters[j] };
+                int numLoopsAround = 0;
+                for (int k = 0; k < trimming.getNumOfLoops(); k++)
+                    numLoopsAround += trimming.getLoop(k).isPointInside(uv);
+                isInside[j * numU + i] = (numLoopsAround % 2 == 1);
+            }
+        }
+    }
+
+    // number the grid points of the kept cells
+    vector<int> gridToPoint(numU * numV, -1);
+    vector<double> uv;
+    for (int j = 0; j < numV - 1; j++) {
+        for (int i = 0; i < numU - 1; i++) {
+            const int corners[4] = { j * numU + i, j * numU + i + 1, (j + 1) * numU + i + 1,
+                    (j + 1) * numU + i };
+            bool isKept = true;
+            for (int k = 0; k < 4; k++)
+                isKept = isKept && isInside[corners[k]];
+            if (!isKept)
+                continue;
+            for (int k = 0; k < 4; k++) {
+                if (gridToPoint[corners[k]] < 0) {
+                    gridToPoint[corners[k]] = uv.size() / 2;
+                    uv.push_back(uParameters[corners[k] % numU]);
+                    uv.push_back(vParameters[corners[k] / numU]);
+                }
+                tessellation.quads.push_back(gridToPoint[corners[k]]);
+            }
+        }
+    }
+    const int numPoints = uv.size() / 2;
+    if (numPoints == 0) {
+        tessellation.rowPtr.assign(1, 0);
+        return;
+    }
+
+    tessellation.points.resize(numPoints * 3);
+    patch->computeCartesianCoordinatesAndNormalVectors(numPoints, &uv[0],
+            &tessellation.points[0], NULL, NULL);
+
+    // the basis functions of the points, by the dof index of the control points
+    const int pDegree = basis->getUBSplineBasis1D()->getPolynomialDegree();
+    const int qDegree = basis->getVBSplineBasis1D()->getPolynomialDegree();
+    const int noLocalBasisFunctions = (pDegree + 1) * (qDegree + 1);
+    const int uNoControlPoints = patch->getUNoControlPoints();
+    ScratchArray<double, SCRATCH_SIZE_2D> localBasisFunctions(noLocalBasisFunctions);
+    tessellation.rowPtr.resize(numPoints + 1);
+    tessellation.cols.resize(numPoints * noLocalBasisFunctions);
+    tessellation.values.resize(numPoints * noLocalBasisFunctions);
+    for (int iPoint = 0; iPoint < numPoints; iPoint++) {
+        const double u = uv[2 * iPoint];
+        const double v = uv[2 * iPoint + 1];
+        const int spanU = patch->findSpanU(u);
+        const int spanV = patch->findSpanV(v);
+        basis->computeLocalBasisFunctions(localBasisFunctions, u, spanU, v, spanV);
+        tessellation.rowPtr[iPoint] = iPoint * noLocalBasisFunctions;
+        int counter = iPoint * noLocalBasisFunctions;
+        for (int j = 0; j <= qDegree; j++) {
+            for (int i = 0; i <= pDegree; i++) {
+                int CPindex = (spanV - qDegree + j) * uNoControlPoints + (spanU - pDegree + i);
+                tessellation.cols[counter] = (*patch)[CPindex]->getDofIndex();
+                tessellation.values[counter] = localBasisFunctions[j * (pDegree + 1) + i];
+                counter++;
+            }
+        }
+    }
+    tessellation.rowPtr[numPoints] = numPoints * noLocalBasisFunctions;
+}
+
+Tessellation::Tessellation(const IGAMesh *_mesh, int _numSubdivisions) {
+    assert(_numSubdivisions > 0);
+    // The patches are of very different cost, thus they are handed out one by one
+    const int numPatches = _mesh->getNumPatches();
+    vector<PatchTessellation> patchTessellations(numPatches);
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads) schedule(dynamic, 1)
+    for (int patchCount = 0; patchCount < numPatches; patchCount++)
+        tessellatePatch(_mesh->getSurfacePatch(patchCount), _numSubdivisions,
+                patchTessellations[patchCount]);
+
+    // concatenate the patches
+    vector<int> rowPtr(1, 0);
+    vector<int> cols;
+    vector<double> values;
+    for (int patchCount = 0; patchCount < numPatches; patchCount++) {
+        const PatchTessellation &patchTessellation = patchTessellations[patchCount];
+        const int pointOffset = points.size() / 3;
+        const int entryOffset = cols.size();
+        points.insert(points.end(), patchTessellation.points.begin(),
+                patchTessellation.points.end());
+        for (int i = 0; i < patchTessellation.quads.size(); i++)
+            quads.push_back(patchTessellation.quads[i] + pointOffset);
+        for (int i = 1; i < patchTessellation.rowPtr.size(); i++)
+            rowPtr.push_back(patchTessellation.rowPtr[i] + entryOffset);
+        cols.insert(cols.end(), patchTessellation.cols.begin(), patchTessellation.cols.end());
+        values.insert(values.end(), patchTessellation.values.begin(),
+                patchTessellation.values.end());
+    }
+    basisFunctions = new MathLibrary::CSRMatrix(getNumPoints(), _mesh->getNumNodes(), rowPtr,
+            cols, values, AuxiliaryParameters::mapperSetNumThreads, false,
+            MathLibrary::CSRMatrix::MATRIX_PRODUCT);
+    INFO_OUT() << "IGA mesh \"" << _mesh->name << "\" is tessellated by " << getNumQuads()
+            << " quadrilaterals" << endl;
+}
+
+Tessellation::~Tessellation() {
+    delete basisFunctions;
+}
+
+void Tessellation::evaluate(int numComponents, const double *valuesOnCPs, double *values) const {
+    if (numComponents == 1)
+        basisFunctions->multiply(false, valuesOnCPs, values);
+    else
+        basisFunctions->multiplyBlock(false, valuesOnCPs, values, numComponents);
+}
+
+/***********************************************************************************************
+ * \brief Write an array in big endian byte order, as required by the binary legacy VTK format
+ ***********/
+template<class T>
+static void writeBigEndian(ofstream &file, const vector<T> &data) {
+    if (data.empty())
+        return;
+    const uint16_t one = 1;
+    const bool isLittleEndian = (*(const char*) &one == 1);
+    if (!isLittleEndian) {
+        file.write((const char*) &data[0], data.size() * sizeof(T));
+        return;
+    }
+    vector<char> buffer(data.size() * sizeof(T));
+    for (size_t i = 0; i < data.size(); i++) {
+        const char *bytes = (const char*) &data[i];
+        for (size_t k = 0; k < sizeof(T); k++)
+            buffer[i * sizeof(T) + k] = bytes[sizeof(T) - 1 - k];
+    }
+    file.write(&buffer[0], buffer.size());
+}
+
+VTKWriter::VTKWriter(std::string _fileName, const Tessellation *_tessellation) :
+        fileName(_fileName), tessellation(_tessellation) {
+}
+
+VTKWriter::~VTKWriter() {
+}
+
+void VTKWriter::appendData(std::string dataFieldName, int numComponents,
+        const double *valuesOnCPs) {
+    assert(numComponents == 1 || numComponents == 3);
+    dataFieldNames.push_back(dataFieldName);
+    dataFieldNumComponents.push_back(numComponents);
+    dataFieldValues.push_back(vector<double>(tessellation->getNumPoints() * numComponents));
+    if (tessellation->getNumPoints() > 0)
+        tessellation->evaluate(numComponents, valuesOnCPs, &dataFieldValues.back()[0]);
+}
+
+void VTKWriter::endStep(int step) {
+    if (dataFieldNames.empty())
+        return;
+    stringstream stepFileName;
+    stepFileName << fileName << "_" << step << ".vtk";
+    ofstream file(stepFileName.str().c_str(), ios_base::out | ios_base::binary);
+    if (file.fail()) {
+        ERROR_OUT() << "Cannot open " << stepFileName.str() << endl;
+        exit(EXIT_FAILURE);
+    }
+    const int numPoints = tessellation->getNumPoints();
+    const int numQuads = tessellation->getNumQuads();
+    file << "# vtk DataFile Version 3.0\n" << fileName << " step " << step << "\nBINARY\n";
+    file << "DATASET UNSTRUCTURED_GRID\n";
+    file << "POINTS " << numPoints << " double\n";
+    writeBigEndian(file, tessellation->getPoints());
+    // each cell is stored as its number of points followed by the points
+    vector<int32_t> cells(numQuads * 5);
+    for (int i = 0; i < numQuads; i++) {
+        cells[i * 5] = 4;
+        for (int k = 0; k < 4; k++)
+            cells[i * 5 + 1 + k] = tessellation->getQuads()[i * 4 + k];
+    }
+    file << "\nCELLS " << numQuads << " " << numQuads * 5 << "\n";
+    writeBigEndian(file, cells);
+    const int32_t VTK_QUAD = 9;
+    vector<int32_t> cellTypes(numQuads, VTK_QUAD);
+    file << "\nCELL_TYPES " << numQuads << "\n";
+    writeBigEndian(file, cellTypes);
+    file << "\nPOINT_DATA " << numPoints << "\n";
+    for (int i = 0; i < dataFieldNames.size(); i++) {
+        if (dataFieldNumComponents[i] == 1)
+            file << "SCALARS " << dataFieldNames[i] << " double 1\nLOOKUP_TABLE default\n";
+        else
+            file << "VECTORS " << dataFieldNames[i] << " double\n";
+        writeBigEndian(file, dataFieldValues[i]);
+        file << "\n";
+    }
+    file.close();
+    dataFieldNames.clear();
+    dataFieldNumComponents.clear();
+    dataFieldValues.clear();
+}
+
+} /* namespace IGATessellationIO */
+} /* namespace EMPIRE */
@@ -0,0 +1,150 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file IGATessellationIO.h
+ * This file holds the tessellation of IGA meshes for visualization. Every patch is evaluated on a
+ * grid in its parameter space, which subdivides each knot span, and the grid cells inside the
+ * trimmed domain are kept as quadrilaterals. The tessellation stores the basis functions of its
+ * points as a sparse matrix, such that a data field on the control points is evaluated at all
+ * points by one sparse product. The tessellation and its data fields are written as binary legacy
+ * VTK files, one file per step, or by HDF5FileIO.
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef IGATESSELLATIONIO_H_
+#define IGATESSELLATIONIO_H_
+
+#include <string>
+#include <vector>
+
+namespace EMPIRE {
+class IGAMesh;
+namespace MathLibrary {
+class CSRMatrix;
+}
+namespace IGATessellationIO {
+/********//**
+ * \brief Class Tessellation is a quadrilateral mesh of the trimmed patches of an IGA mesh. The
+ *        patches are tessellated concurrently, the points of a patch are evaluated at once by
+ *        the batched evaluator of IGAPatchSurface. Points on the edges between patches are not
+ *        merged.
+ ***********/
+class Tessellation {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, tessellates the patches, the trimming of the patches must be linearized
+     * \param[in] _mesh the IGA mesh
+     * \param[in] _numSubdivisions number of grid cells per knot span in each direction
+     ***********/
+    Tessellation(const IGAMesh *_mesh, int _numSubdivisions);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~Tessellation();
+    /***********************************************************************************************
+     * \brief Evaluate a data field on the control points at all points of the tessellation
+     * \param[in] numComponents number of components of the data field
+     * \param[in] valuesOnCPs the data field, stored by the dof index of the control points
+     * \param[out] values the values at the points, numPoints x numComponents
+     ***********/
+    void evaluate(int numComponents, const double *valuesOnCPs, double *values) const;
+    /***********************************************************************************************
+     * \brief Get the number of points
+     ***********/
+    int getNumPoints() const {
+        return points.size() / 3;
+    }
+    /***********************************************************************************************
+     * \brief Get the coordinates of the points, numPoints x 3
+     ***********/
+    const std::vector<double> &getPoints() const {
+        return points;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of quadrilaterals
+     ***********/
+    int getNumQuads() const {
+        return quads.size() / 4;
+    }
+    /***********************************************************************************************
+     * \brief Get the quadrilaterals by the positions of their points, numQuads x 4
+     ***********/
+    const std::vector<int> &getQuads() const {
+        return quads;
+    }
+private:
+    /// the coordinates of the points
+    std::vector<double> points;
+    /// the positions of the points of the quadrilaterals
+    std::vector<int> quads;
+    /// the basis functions of the points, numPoints x number of control points
+    MathLibrary::CSRMatrix *basisFunctions;
+    /// disallow copy constructor
+    Tessellation(const Tessellation&);
+    /// disallow assignment operator
+    Tessellation& operator=(const Tessellation&);
+};
+
+/********//**
+ * \brief Class VTKWriter writes the steps of a tessellation as binary legacy VTK files
+ *        <fileName>_<step>.vtk. The data fields of a step are evaluated by appendData and written
+ *        together with the tessellation by endStep.
+ ***********/
+class VTKWriter {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _fileName name of the files without step and extension
+     * \param[in] _tessellation the tessellation, not owned
+     ***********/
+    VTKWriter(std::string _fileName, const Tessellation *_tessellation);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~VTKWriter();
+    /***********************************************************************************************
+     * \brief Evaluate a data field of the current step at the points
+     * \param[in] dataFieldName name of the data field
+     * \param[in] numComponents number of components, 1 or 3
+     * \param[in] valuesOnCPs the data field, stored by the dof index of the control points
+     ***********/
+    void appendData(std::string dataFieldName, int numComponents, const double *valuesOnCPs);
+    /***********************************************************************************************
+     * \brief Write the file of a step with the data fields appended since the last step, nothing
+     *        is written if no data field is appended
+     * \param[in] step the step number
+     ***********/
+    void endStep(int step);
+private:
+    /// name of the files without step and extension
+    std::string fileName;
+    /// the tessellation
+    const Tessellation *tessellation;
+    /// names of the data fields of the current step
+    std::vector<std::string> dataFieldNames;
+    /// number of components of the data fields of the current step
+    std::vector<int> dataFieldNumComponents;
+    /// values of the data fields of the current step at the points
+    std::vector<std::vector<double> > dataFieldValues;
+};
+
+} /* namespace IGATessellationIO */
+} /* namespace EMPIRE */
+#endif /* IGATESSELLATIONIO_H_ */
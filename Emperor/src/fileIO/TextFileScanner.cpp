@@ -0,0 +1,215 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <iostream>
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include "stdlib.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "TextFileScanner.h"
+
+using namespace std;
+
+namespace TextFileScanner {
+
+/// exactly representable powers of ten
+static const double POWERS_OF_TEN[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+/// largest exponent in POWERS_OF_TEN
+const int MAX_EXACT_POWER_OF_TEN = 22;
+/// largest integer whose double representation is exact (2^53)
+const uint64_t MAX_EXACT_MANTISSA = 9007199254740992ULL;
+/// number of significant digits which fit into uint64_t
+const int MAX_MANTISSA_DIGITS = 19;
+
+MappedFile::MappedFile(string fileName) :
+        opened(false), data(NULL), size(0) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat fileStatus;
+    if (fstat(fd, &fileStatus) != 0) {
+        close(fd);
+        return;
+    }
+    size = fileStatus.st_size;
+    if (size > 0) {
+        void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            cerr << "TextFileScanner: cannot map \"" << fileName << "\"" << endl;
+            exit(EXIT_FAILURE);
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    close(fd); // the mapping stays valid
+    opened = true;
+}
+
+MappedFile::~MappedFile() {
+    if (data != NULL)
+        munmap(const_cast<char*>(data), size);
+}
+
+const char *nextLine(const char *p, const char *end) {
+    const char *newLine = endOfLine(p, end);
+    return (newLine < end ? newLine + 1 : end);
+}
+
+const char *endOfLine(const char *p, const char *end) {
+    if (p >= end)
+        return end;
+    const char *newLine = static_cast<const char*>(memchr(p, '\n', end - p));
+    return (newLine == NULL ? end : newLine);
+}
+
+bool wordEquals(const char *p, const char *end, const char *keyword) {
+    p = skipBlanks(p, end);
+    for (; *keyword != '\0'; keyword++, p++) {
+        if (p >= end || tolower(*p) != *keyword)
+            return false;
+    }
+    return (p >= end || isBlank(*p) || *p == '\n');
+}
+
+const char *scanInt(const char *p, const char *end, int &value) {
+    p = skipBlanks(p, end);
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+    if (p >= end || *p < '0' || *p > '9')
+        return NULL;
+    long long result = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+        result = result * 10 + (*p - '0');
+    value = static_cast<int>(negative ? -result : result);
+    return p;
+}
+
+/***********************************************************************************************
+ * \brief Convert [begin, end) by strtod, for the numbers which are not converted exactly
+ ***********/
+static const char *scanDoubleByStrtod(const char *begin, const char *end, double &value) {
+    char buffer[64];
+    size_t length = end - begin;
+    if (length >= sizeof(buffer)) {
+        string token(begin, end);
+        char *tokenEnd;
+        value = strtod(token.c_str(), &tokenEnd);
+        return (tokenEnd == token.c_str() ? NULL : begin + (tokenEnd - token.c_str()));
+    }
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    char *tokenEnd;
+    value = strtod(buffer, &tokenEnd);
+    return (tokenEnd == buffer ? NULL : begin + (tokenEnd - buffer));
+}
+
+const char *scanDouble(const char *p, const char *end, double &value) {
+    p = skipBlanks(p, end);
+    const char *begin = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+    uint64_t mantissa = 0;
+    int numDigits = 0; // significant digits in mantissa
+    int exponent = 0;
+    bool hasDigits = false;
+    bool exact = true;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+        hasDigits = true;
+        if (numDigits < MAX_MANTISSA_DIGITS) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0)
+                numDigits++;
+        } else {
+            exponent++;
+            exact = exact && (*p == '0');
+        }
+    }
+    if (p < end && *p == '.') {
+        p++;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            hasDigits = true;
+            if (numDigits < MAX_MANTISSA_DIGITS) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0)
+                    numDigits++;
+                exponent--;
+            } else {
+                exact = exact && (*p == '0');
+            }
+        }
+    }
+    if (!hasDigits) { // e.g. nan or inf
+        const char *tokenEnd = begin;
+        while (tokenEnd < end && !isBlank(*tokenEnd) && *tokenEnd != '\n')
+            tokenEnd++;
+        return scanDoubleByStrtod(begin, tokenEnd, value);
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool negativeExponent = false;
+        if (q < end && (*q == '-' || *q == '+')) {
+            negativeExponent = (*q == '-');
+            q++;
+        }
+        if (q < end && *q >= '0' && *q <= '9') {
+            int exponentInFile = 0;
+            for (; q < end && *q >= '0' && *q <= '9'; q++)
+                if (exponentInFile < 100000)
+                    exponentInFile = exponentInFile * 10 + (*q - '0');
+            exponent += (negativeExponent ? -exponentInFile : exponentInFile);
+            p = q;
+        }
+    }
+    if (mantissa == 0) {
+        value = (negative ? -0.0 : 0.0);
+        return p;
+    }
+    if (!exact || mantissa > MAX_EXACT_MANTISSA || exponent > MAX_EXACT_POWER_OF_TEN
+            || exponent < -MAX_EXACT_POWER_OF_TEN)
+        return scanDoubleByStrtod(begin, p, value);
+    // mantissa and the power of ten are exact, so a single multiplication or division is
+    // correctly rounded
+    double result = static_cast<double>(mantissa);
+    if (exponent < 0)
+        result /= POWERS_OF_TEN[-exponent];
+    else
+        result *= POWERS_OF_TEN[exponent];
+    value = (negative ? -result : result);
+    return p;
+}
+
+void splitLines(const char *begin, const char *end, vector<const char*> &lineBegins) {
+    for (const char *p = begin; p < end; p = nextLine(p, end))
+        lineBegins.push_back(p);
+}
+
+} /* namespace TextFileScanner */
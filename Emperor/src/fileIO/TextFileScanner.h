@@ -0,0 +1,143 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file TextFileScanner.h
+ * This file holds the tools to parse large text files (e.g. GiD .msh and .res) without iostreams:
+ * a memory-mapped file and hand-written scanners for integers and doubles, which work directly on
+ * the mapped characters. The scanners do not allocate and can be called from several threads on
+ * different parts of the same file.
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef TEXTFILESCANNER_H_
+#define TEXTFILESCANNER_H_
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+
+namespace TextFileScanner {
+/********//**
+ * \brief Class MappedFile maps a whole file read-only into memory
+ ***********/
+class MappedFile {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, maps the file
+     * \param[in] fileName name of the file
+     ***********/
+    MappedFile(std::string fileName);
+    /***********************************************************************************************
+     * \brief Destructor, unmaps the file
+     ***********/
+    virtual ~MappedFile();
+    /***********************************************************************************************
+     * \brief Whether the file could be opened
+     ***********/
+    bool isOpen() const {
+        return opened;
+    }
+    /***********************************************************************************************
+     * \brief The first character of the file
+     ***********/
+    const char *begin() const {
+        return data;
+    }
+    /***********************************************************************************************
+     * \brief Behind the last character of the file
+     ***********/
+    const char *end() const {
+        return data + size;
+    }
+
+private:
+    /// whether the file could be opened
+    bool opened;
+    /// the mapped characters
+    const char *data;
+    /// number of characters
+    size_t size;
+    /// disallow copy constructor
+    MappedFile(const MappedFile&);
+    /// disallow assignment operator
+    MappedFile& operator=(const MappedFile&);
+};
+
+/***********************************************************************************************
+ * \brief Whether c is a blank (space, tab or carriage return)
+ ***********/
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+/***********************************************************************************************
+ * \brief Skip blanks, but not the end of the line
+ * \return the first non-blank character or end
+ ***********/
+inline const char *skipBlanks(const char *p, const char *end) {
+    while (p < end && isBlank(*p))
+        p++;
+    return p;
+}
+/***********************************************************************************************
+ * \brief Find the beginning of the next line
+ * \return the character behind the next '\n' or end
+ ***********/
+const char *nextLine(const char *p, const char *end);
+/***********************************************************************************************
+ * \brief Find the end of the current line
+ * \return the next '\n' or end
+ ***********/
+const char *endOfLine(const char *p, const char *end);
+/***********************************************************************************************
+ * \brief Compare the next word with a lower case keyword, ignoring the case of the word
+ * \param[in] p the beginning of the word, blanks are skipped
+ * \param[in] end end of the buffer
+ * \param[in] keyword the keyword in lower case
+ * \return true if the word is the keyword (followed by a blank, the end of the line or end)
+ ***********/
+bool wordEquals(const char *p, const char *end, const char *keyword);
+/***********************************************************************************************
+ * \brief Read an integer, leading blanks are skipped
+ * \param[in] p where to start
+ * \param[in] end end of the buffer
+ * \param[out] value the integer
+ * \return the character behind the integer, or NULL if there is no integer
+ ***********/
+const char *scanInt(const char *p, const char *end, int &value);
+/***********************************************************************************************
+ * \brief Read a double, leading blanks are skipped. Numbers with at most 19 significant digits
+ *        and small exponents are converted exactly without strtod, all others fall back to strtod,
+ *        so that the result is always the correctly rounded value.
+ * \param[in] p where to start
+ * \param[in] end end of the buffer
+ * \param[out] value the double
+ * \return the character behind the double, or NULL if there is no double
+ ***********/
+const char *scanDouble(const char *p, const char *end, double &value);
+/***********************************************************************************************
+ * \brief Split a part of a buffer into lines
+ * \param[in] begin where to start
+ * \param[in] end where to stop
+ * \param[out] lineBegins the beginning of each line
+ ***********/
+void splitLines(const char *begin, const char *end, std::vector<const char*> &lineBegins);
+
+} /* namespace TextFileScanner */
+#endif /* TEXTFILESCANNER_H_ */
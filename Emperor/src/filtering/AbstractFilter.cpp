@@ -21,6 +21,8 @@
 #include "AbstractFilter.h"
 #include <assert.h>
 #include "ConnectionIO.h"
+#include "DataField.h"
+#include "Signal.h"
 
 namespace EMPIRE {
 
@@ -45,4 +47,58 @@ void AbstractFilter::addOutput(ConnectionIO *output) {
     outputVec.push_back(output);
 }
 
+bool AbstractFilter::hasInput(const ConnectionIO *io) const {
+    for (int i = 0; i < inputVec.size(); i++) {
+        if (io->type == EMPIRE_ConnectionIO_DataField && inputVec[i]->dataField == io->dataField)
+            return true;
+        if (io->type == EMPIRE_ConnectionIO_Signal && inputVec[i]->signal == io->signal)
+            return true;
+    }
+    return false;
+}
+
+const std::vector<ConnectionIO*> &AbstractFilter::getInputs() const {
+    return inputVec;
+}
+
+const std::vector<ConnectionIO*> &AbstractFilter::getOutputs() const {
+    return outputVec;
+}
+
+bool AbstractFilter::isElementwise() const {
+    return false;
+}
+
+int AbstractFilter::getNumEntries() const {
+    return -1;
+}
+
+void AbstractFilter::filterEntries(int _begin, int _end) {
+    assert(false);
+}
+
+void AbstractFilter::writeCheckpoint(CheckpointArchive &archive) const {
+}
+
+void AbstractFilter::readCheckpoint(CheckpointArchive &archive) {
+}
+
+double *AbstractFilter::getData(const ConnectionIO *io) {
+    if (io->type == EMPIRE_ConnectionIO_DataField)
+        return io->dataField->data;
+    else if (io->type == EMPIRE_ConnectionIO_Signal)
+        return io->signal->array;
+    assert(false);
+    return NULL;
+}
+
+int AbstractFilter::getSize(const ConnectionIO *io) {
+    if (io->type == EMPIRE_ConnectionIO_DataField)
+        return io->dataField->numLocations * io->dataField->dimension;
+    else if (io->type == EMPIRE_ConnectionIO_Signal)
+        return io->signal->size;
+    assert(false);
+    return -1;
+}
+
 } /* namespace EMPIRE */
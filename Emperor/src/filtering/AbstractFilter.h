@@ -31,13 +31,14 @@
 #include <stdlib.h>
 #include <vector>
 #include "EMPEROR_Enum.h"
+#include "CheckpointArchive.h"
 
 namespace EMPIRE {
 class ConnectionIO;
 /********//**
  * \brief Class AbstractFilter is the superclass of all data field filters
  ***********/
-class AbstractFilter {
+class AbstractFilter : public AbstractCheckpointable {
 public:
     /***********************************************************************************************
      * \brief Constructor
@@ -71,8 +72,62 @@ public:
      * \author Tianyang Wang
      ***********/
     void addOutput(ConnectionIO *output);
+    /***********************************************************************************************
+     * \brief Check whether one of the inputs refers to the same data field or signal as io
+     * \param[in] io the connection input or output
+     * \return true if the filter reads the data of io
+     ***********/
+    bool hasInput(const ConnectionIO *io) const;
+    /***********************************************************************************************
+     * \brief Get the inputs of the filter
+     ***********/
+    const std::vector<ConnectionIO*> &getInputs() const;
+    /***********************************************************************************************
+     * \brief Get the outputs of the filter
+     ***********/
+    const std::vector<ConnectionIO*> &getOutputs() const;
+    /***********************************************************************************************
+     * \brief Check whether every entry of the outputs is computed from the entries of the inputs
+     *        with the same index only. Consecutive elementwise filters can be fused into one pass.
+     * \return true if filterEntries() can be called
+     ***********/
+    virtual bool isElementwise() const;
+    /***********************************************************************************************
+     * \brief Get the number of entries an elementwise filter runs over
+     * \return the number of entries
+     ***********/
+    virtual int getNumEntries() const;
+    /***********************************************************************************************
+     * \brief Filter the entries in [_begin, _end) of an elementwise filter
+     * \param[in] _begin the first entry
+     * \param[in] _end one past the last entry
+     ***********/
+    virtual void filterEntries(int _begin, int _end);
+    /***********************************************************************************************
+     * \brief Write the state kept between the time steps, nothing for a stateless filter
+     * \param[in] archive the archive
+     ***********/
+    virtual void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the state written by writeCheckpoint
+     * \param[in] archive the archive
+     ***********/
+    virtual void readCheckpoint(CheckpointArchive &archive);
 
 protected:
+    /***********************************************************************************************
+     * \brief Get the data array of a data field or signal input/output
+     * \param[in] io the connection input or output
+     * \return the data array
+     ***********/
+    static double *getData(const ConnectionIO *io);
+    /***********************************************************************************************
+     * \brief Get the number of entries of a data field or signal input/output
+     * \param[in] io the connection input or output
+     * \return the number of entries
+     ***********/
+    static int getSize(const ConnectionIO *io);
+
     /// inputs
     std::vector<ConnectionIO*> inputVec;
     /// outputs
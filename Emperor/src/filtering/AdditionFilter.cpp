@@ -23,31 +23,27 @@ void AdditionFilter::init() {
 }
 
 void AdditionFilter::filtering() {
-    double *x, *y, *z;
-    int n = -1;
-    EMPIRE_ConnectionIO_Type type = outputVec[0]->type;
-    if (type == EMPIRE_ConnectionIO_DataField) {
-        x = inputVec[0]->dataField->data;
-        y = inputVec[1]->dataField->data;
-        z = outputVec[0]->dataField->data;
-
-        n = outputVec[0]->dataField->dimension * outputVec[0]->dataField->numLocations;
-        assert(inputVec[0]->dataField->dimension * inputVec[0]->dataField->numLocations == n);
-        assert(inputVec[1]->dataField->dimension * inputVec[1]->dataField->numLocations == n);
-    } else if (type == EMPIRE_ConnectionIO_Signal) {
-        x = inputVec[0]->signal->array;
-        y = inputVec[1]->signal->array;
-        z = outputVec[0]->signal->array;
-
-        n = outputVec[0]->signal->size;
-        assert(inputVec[0]->signal->size == n);
-        assert(inputVec[1]->signal->size == n);
-    } else {
-        assert(false);
-    }
+    filterEntries(0, getNumEntries());
+}
+
+bool AdditionFilter::isElementwise() const {
+    return true;
+}
+
+int AdditionFilter::getNumEntries() const {
+    int n = getSize(outputVec[0]);
+    assert(getSize(inputVec[0]) == n);
+    assert(getSize(inputVec[1]) == n);
+    return n;
+}
+
+void AdditionFilter::filterEntries(int _begin, int _end) {
+    const double *x = getData(inputVec[0]);
+    const double *y = getData(inputVec[1]);
+    double *z = getData(outputVec[0]);
 
     // do z = a*x + b*y, use mathlibrary in the future
-    for (int i = 0; i < n; i++) {
+    for (int i = _begin; i < _end; i++) {
         z[i] = a * x[i] + b * y[i];
     }
 }
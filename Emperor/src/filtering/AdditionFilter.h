@@ -56,6 +56,20 @@ public:
      * \author Tianyang Wang
      ***********/
     void init();
+    /***********************************************************************************************
+     * \brief Addition is elementwise
+     ***********/
+    bool isElementwise() const;
+    /***********************************************************************************************
+     * \brief Get the number of entries of the output
+     ***********/
+    int getNumEntries() const;
+    /***********************************************************************************************
+     * \brief Filter the entries in [_begin, _end)
+     * \param[in] _begin the first entry
+     * \param[in] _end one past the last entry
+     ***********/
+    void filterEntries(int _begin, int _end);
 private:
     /// a
     const double a;
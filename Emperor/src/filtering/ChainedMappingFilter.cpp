@@ -0,0 +1,140 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "ChainedMappingFilter.h"
+#include "MappingFilter.h"
+#include "ConnectionIO.h"
+#include "DataField.h"
+#include <assert.h>
+#include <algorithm>
+
+using namespace std;
+
+namespace EMPIRE {
+
+/***********************************************************************************************
+ * \brief Copy a data field input/output of a filter
+ ***********/
+static ConnectionIO *copyIO(const ConnectionIO *io) {
+    assert(io->type == EMPIRE_ConnectionIO_DataField);
+    return new ConnectionIO(io->clientCode, io->mesh, io->dataField);
+}
+
+ChainedMappingFilter::ChainedMappingFilter(const MappingFilter *first) :
+        AbstractFilter(), numMappings(1) {
+    assert(first->isExplicitOperatorSupported());
+    first->getExplicitOperator(numRows, numColumns, rowPointers, columnIndices, values);
+    addInput(copyIO(first->getInputs()[0]));
+    addOutput(copyIO(first->getOutputs()[0]));
+}
+
+ChainedMappingFilter::~ChainedMappingFilter() {
+}
+
+bool ChainedMappingFilter::chain(const MappingFilter *next) {
+    assert(next->isExplicitOperatorSupported());
+    assert(next->getInputs()[0]->dataField->data == outputVec[0]->dataField->data);
+    // the product is not computed in place
+    if (next->getOutputs()[0]->dataField->data == inputVec[0]->dataField->data)
+        return false;
+    int numRowsNext, numColumnsNext;
+    vector<int> rowPointersNext, columnIndicesNext;
+    vector<double> valuesNext;
+    next->getExplicitOperator(numRowsNext, numColumnsNext, rowPointersNext, columnIndicesNext,
+            valuesNext);
+    assert(numColumnsNext == numRows);
+    vector<int> composedRowPointers, composedColumnIndices;
+    vector<double> composedValues;
+    multiply(numRowsNext, rowPointersNext, columnIndicesNext, valuesNext, numColumns, rowPointers,
+            columnIndices, values, composedRowPointers, composedColumnIndices, composedValues);
+    if (composedValues.size() > values.size() + valuesNext.size())
+        return false;
+    numRows = numRowsNext;
+    rowPointers.swap(composedRowPointers);
+    columnIndices.swap(composedColumnIndices);
+    values.swap(composedValues);
+    delete outputVec[0];
+    outputVec[0] = copyIO(next->getOutputs()[0]);
+    numMappings++;
+    return true;
+}
+
+void ChainedMappingFilter::init() {
+    assert(inputVec.size() == 1);
+    assert(outputVec.size() == 1);
+    assert(inputVec[0]->dataField->numLocations == numColumns);
+    assert(outputVec[0]->dataField->numLocations == numRows);
+    assert(inputVec[0]->dataField->dimension == outputVec[0]->dataField->dimension);
+}
+
+void ChainedMappingFilter::filtering() {
+    const double *input = inputVec[0]->dataField->data;
+    double *output = outputVec[0]->dataField->data;
+    const int dim = outputVec[0]->dataField->dimension;
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < numRows; i++) {
+        double *outputNode = &output[i * dim];
+        for (int d = 0; d < dim; d++)
+            outputNode[d] = 0.0;
+        for (int k = rowPointers[i]; k < rowPointers[i + 1]; k++) {
+            const double *inputNode = &input[columnIndices[k] * dim];
+            for (int d = 0; d < dim; d++)
+                outputNode[d] += values[k] * inputNode[d];
+        }
+    }
+}
+
+void ChainedMappingFilter::multiply(int numRowsA, const std::vector<int> &rowPointersA,
+        const std::vector<int> &columnIndicesA, const std::vector<double> &valuesA,
+        int numColumnsB, const std::vector<int> &rowPointersB,
+        const std::vector<int> &columnIndicesB, const std::vector<double> &valuesB,
+        std::vector<int> &rowPointersC, std::vector<int> &columnIndicesC,
+        std::vector<double> &valuesC) {
+    // the row of C is accumulated densely, rowOfColumn marks the columns it has entries in
+    vector<int> rowOfColumn(numColumnsB, -1);
+    vector<double> rowValues(numColumnsB, 0.0);
+    vector<int> rowColumns;
+    rowPointersC.assign(1, 0);
+    columnIndicesC.clear();
+    valuesC.clear();
+    for (int i = 0; i < numRowsA; i++) {
+        rowColumns.clear();
+        for (int k = rowPointersA[i]; k < rowPointersA[i + 1]; k++) {
+            int m = columnIndicesA[k];
+            for (int l = rowPointersB[m]; l < rowPointersB[m + 1]; l++) {
+                int j = columnIndicesB[l];
+                if (rowOfColumn[j] != i) {
+                    rowOfColumn[j] = i;
+                    rowValues[j] = 0.0;
+                    rowColumns.push_back(j);
+                }
+                rowValues[j] += valuesA[k] * valuesB[l];
+            }
+        }
+        sort(rowColumns.begin(), rowColumns.end());
+        for (unsigned k = 0; k < rowColumns.size(); k++) {
+            columnIndicesC.push_back(rowColumns[k]);
+            valuesC.push_back(rowValues[rowColumns[k]]);
+        }
+        rowPointersC.push_back(columnIndicesC.size());
+    }
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,104 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file ChainedMappingFilter.h
+ * This file holds the class ChainedMappingFilter
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef CHAINEDMAPPINGFILTER_H_
+#define CHAINEDMAPPINGFILTER_H_
+
+#include "AbstractFilter.h"
+#include <vector>
+
+namespace EMPIRE {
+
+class MappingFilter;
+
+/********//**
+ * \brief Class ChainedMappingFilter replaces mapping filters in series, each reading the output of
+ *        the one before, by the product of their operators, e.g. H_BC * H_AB for the mappings
+ *        A->B and B->C. The data fields in between are not written.
+ ***********/
+class ChainedMappingFilter: public AbstractFilter {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, starts the chain with the operator of a mapping filter
+     * \param[in] first the first mapping filter, its operator must be explicit
+     ***********/
+    ChainedMappingFilter(const MappingFilter *first);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~ChainedMappingFilter();
+    /***********************************************************************************************
+     * \brief Filtering, one product of the composed operator with every component of the input
+     ***********/
+    void filtering();
+    /***********************************************************************************************
+     * \brief Initialize data according to the inputs and outputs
+     ***********/
+    void init();
+    /***********************************************************************************************
+     * \brief Append a mapping filter reading the output of the chain. The chain is kept as it is
+     *        if the composed operator would have more entries than the operators it replaces,
+     *        then applying them one after the other is cheaper
+     * \param[in] next the mapping filter, its operator must be explicit
+     * \return true if the mapping filter is appended
+     ***********/
+    bool chain(const MappingFilter *next);
+    /***********************************************************************************************
+     * \brief Get the number of mapping filters of the chain
+     ***********/
+    int getNumMappings() const {
+        return numMappings;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of entries of the composed operator
+     ***********/
+    int getNumNonZeros() const {
+        return values.size();
+    }
+private:
+    /***********************************************************************************************
+     * \brief Multiply two sparse matrices in CSR format, C = A * B, the columns of every row of C
+     *        are sorted
+     ***********/
+    static void multiply(int numRowsA, const std::vector<int> &rowPointersA,
+            const std::vector<int> &columnIndicesA, const std::vector<double> &valuesA,
+            int numColumnsB, const std::vector<int> &rowPointersB,
+            const std::vector<int> &columnIndicesB, const std::vector<double> &valuesB,
+            std::vector<int> &rowPointersC, std::vector<int> &columnIndicesC,
+            std::vector<double> &valuesC);
+    /// number of mapping filters of the chain
+    int numMappings;
+    /// number of output nodes
+    int numRows;
+    /// number of input nodes
+    int numColumns;
+    /// the composed operator in CSR format
+    std::vector<int> rowPointers;
+    std::vector<int> columnIndices;
+    std::vector<double> values;
+};
+
+} /* namespace EMPIRE */
+#endif /* CHAINEDMAPPINGFILTER_H_ */
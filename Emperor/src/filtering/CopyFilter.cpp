@@ -28,8 +28,8 @@
 
 namespace EMPIRE {
 
-CopyFilter::CopyFilter(int _signalOffset) :
-        AbstractFilter(), signalOffset(_signalOffset), unitTest(false) {
+CopyFilter::CopyFilter(int _signalOffset, bool _isAliasing) :
+        AbstractFilter(), signalOffset(_signalOffset), aliasing(_isAliasing), unitTest(false) {
 }
 CopyFilter::~CopyFilter() {
 }
@@ -40,6 +40,9 @@ void CopyFilter::filtering() {
         DataField *outDataField = outputVec[0]->dataField;
         assert(inDataField != NULL);
         assert(outDataField != NULL);
+        // nothing to copy if the output shares the storage of the input
+        if (outDataField->data == inDataField->data)
+            return;
 
         int sizeIn = inDataField->numLocations * inDataField->dimension;
         int sizeOut = outDataField->numLocations * outDataField->dimension;
@@ -92,10 +95,46 @@ void CopyFilter::filtering() {
     }
 }
 
+bool CopyFilter::isElementwise() const {
+    return inputVec[0]->type == EMPIRE_ConnectionIO_DataField && getSize(inputVec[0]) == getSize(outputVec[0]);
+}
+
+int CopyFilter::getNumEntries() const {
+    return getSize(outputVec[0]);
+}
+
+void CopyFilter::filterEntries(int _begin, int _end) {
+    const double *inData = getData(inputVec[0]);
+    double *outData = getData(outputVec[0]);
+    if (outData == inData)
+        return;
+    for (int i = _begin; i < _end; i++)
+        outData[i] = inData[i];
+}
+
 void CopyFilter::init() {
     assert(inputVec.size() == 1);
     assert(outputVec.size() == 1);
     assert(inputVec[0]->type == outputVec[0]->type);
+    if (aliasing) {
+        if (inputVec[0]->type != EMPIRE_ConnectionIO_DataField) {
+            ERROR_OUT() << "An aliasing copy filter only forwards data fields" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        const DataField *inDataField = inputVec[0]->dataField;
+        const DataField *outDataField = outputVec[0]->dataField;
+        if (getSize(inputVec[0]) != getSize(outputVec[0])) {
+            ERROR_OUT() << "An aliasing copy filter needs data fields of the same size, but \""
+                    << inDataField->name << "\" has " << getSize(inputVec[0]) << " entries and \""
+                    << outDataField->name << "\" has " << getSize(outputVec[0]) << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void CopyFilter::aliasOutput() {
+    assert(aliasing);
+    outputVec[0]->dataField->aliasData(inputVec[0]->dataField);
 }
 
 } /* namespace EMPIRE */
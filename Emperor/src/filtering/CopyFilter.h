@@ -32,16 +32,19 @@
 namespace EMPIRE {
 
 /********//**
- * \brief Class CopyFilter copy the input to the output, if not enough input data, fill by 0
+ * \brief Class CopyFilter copy the input to the output, if not enough input data, fill by 0.
+ *        An aliasing copy filter lets the output data field share the storage of the input data
+ *        field, such that forwarding a field unchanged costs nothing.
  ***********/
 class CopyFilter: public AbstractFilter {
 public:
     /***********************************************************************************************
      * \brief Constructor
-     * \param[in] _factor for scaling
+     * \param[in] _signalOffset offset in the larger signal
+     * \param[in] _isAliasing whether the output data field shares the storage of the input
      * \author Tianyang Wang, Stefan Sicklinger
      ***********/
-    CopyFilter(int _signalOffset);
+    CopyFilter(int _signalOffset, bool _isAliasing = false);
     /***********************************************************************************************
      * \brief Destructor
      * \author Tianyang Wang
@@ -57,9 +60,36 @@ public:
      * \author Tianyang Wang
      ***********/
     void init();
+    /***********************************************************************************************
+     * \brief Copying is elementwise between data fields of the same size
+     ***********/
+    bool isElementwise() const;
+    /***********************************************************************************************
+     * \brief Get the number of entries of the output
+     ***********/
+    int getNumEntries() const;
+    /***********************************************************************************************
+     * \brief Filter the entries in [_begin, _end)
+     * \param[in] _begin the first entry
+     * \param[in] _end one past the last entry
+     ***********/
+    void filterEntries(int _begin, int _end);
+    /***********************************************************************************************
+     * \brief Check whether the output data field shares the storage of the input
+     ***********/
+    bool isAliasing() const {
+        return aliasing;
+    }
+    /***********************************************************************************************
+     * \brief Let the output data field share the storage of the input data field. Called once all
+     *        connections are set up, since the output must not be written by anyone else.
+     ***********/
+    void aliasOutput();
 private:
     /// Signal offset value 0--> no offset
     int signalOffset;
+    /// whether the output data field shares the storage of the input
+    bool aliasing;
     /// if unit test, do not output debug message
     bool unitTest;
     /// unit test class
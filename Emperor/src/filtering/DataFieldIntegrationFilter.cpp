@@ -28,14 +28,15 @@
 #include "DataFieldIntegrationAdapter.h"
 #include "ConnectionIO.h"
 #include "DataField.h"
+#include "BufferPool.h"
 
 using namespace std;
 
 namespace EMPIRE {
 
-DataFieldIntegrationFilter::DataFieldIntegrationFilter(AbstractMesh *_mesh):
+DataFieldIntegrationFilter::DataFieldIntegrationFilter(AbstractMesh *_mesh, bool _isLumped):
 	mesh(_mesh) {
-	dataFieldIntegrationAdapter = new DataFieldIntegrationAdapter(_mesh);
+	dataFieldIntegrationAdapter = new DataFieldIntegrationAdapter(_mesh, _isLumped);
 }
 
 DataFieldIntegrationFilter::~DataFieldIntegrationFilter() {
@@ -76,39 +77,39 @@ void DataFieldIntegrationFilter::init() {
     }
 }
 
+void DataFieldIntegrationFilter::setLinearSolver(const std::string &name) {
+    dataFieldIntegrationAdapter->setLinearSolver(name);
+}
+
 void DataFieldIntegrationFilter::integrate() {
     DataField *inDataField = inputVec[0]->dataField;
     DataField *outDataField = outputVec[0]->dataField;
     int n = inDataField->numLocations;
-    double *inDataFieldDOFi = new double[n];
-    double *outDataFieldDOFi = new double[n];
+    BufferPool::Buffer inDataFieldDOFi(n);
+    BufferPool::Buffer outDataFieldDOFi(n);
     int numDOFs = inDataField->dimension;
     for (int i = 0; i < numDOFs; i++) {
         for (int j = 0; j < inDataField->numLocations; j++)
             inDataFieldDOFi[j] = inDataField->data[j * numDOFs + i];
-        dataFieldIntegrationAdapter->integrate(inDataFieldDOFi, outDataFieldDOFi);
+        dataFieldIntegrationAdapter->integrate(inDataFieldDOFi.data(), outDataFieldDOFi.data());
         for (int j = 0; j < n; j++)
             outDataField->data[j * numDOFs + i] = outDataFieldDOFi[j];
     }
-    delete[] inDataFieldDOFi;
-    delete[] outDataFieldDOFi;
 }
 
 void DataFieldIntegrationFilter::deIntegrate() {
     DataField *inDataField = inputVec[0]->dataField;
     DataField *outDataField = outputVec[0]->dataField;
     int n = inDataField->numLocations;
-    double *inDataFieldDOFi = new double[n];
-    double *outDataFieldDOFi = new double[n];
+    BufferPool::Buffer inDataFieldDOFi(n);
+    BufferPool::Buffer outDataFieldDOFi(n);
     int numDOFs = inDataField->dimension;
     for (int i = 0; i < numDOFs; i++) {
         for (int j = 0; j < inDataField->numLocations; j++)
             inDataFieldDOFi[j] = inDataField->data[j * numDOFs + i];
-        dataFieldIntegrationAdapter->deIntegrate(inDataFieldDOFi, outDataFieldDOFi);
+        dataFieldIntegrationAdapter->deIntegrate(inDataFieldDOFi.data(), outDataFieldDOFi.data());
         for (int j = 0; j < n; j++)
             outDataField->data[j * numDOFs + i] = outDataFieldDOFi[j];
     }
-    delete[] inDataFieldDOFi;
-    delete[] outDataFieldDOFi;
 }
 } /* namespace EMPIRE */
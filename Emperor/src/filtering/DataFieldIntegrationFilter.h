@@ -26,6 +26,7 @@
 #ifndef DATAFIELDINTEGRATIONFILTER_H_
 #define DATAFIELDINTEGRATIONFILTER_H_
 
+#include <string>
 #include "AbstractFilter.h"
 
 namespace EMPIRE {
@@ -41,9 +42,11 @@ class DataFieldIntegrationFilter: public AbstractFilter {
 public:
     /***********************************************************************************************
      * \brief Constructor
+     * \param[in] mesh the mesh the filter is applied onto
+     * \param[in] isLumped whether the row sums of the mass matrix are used
      * \author Tianyang Wang
      ***********/
-    DataFieldIntegrationFilter(AbstractMesh *mesh);
+    DataFieldIntegrationFilter(AbstractMesh *mesh, bool isLumped = false);
     /***********************************************************************************************
      * \brief Destructor
      * \author Tianyang Wang
@@ -59,6 +62,11 @@ public:
      * \author Tianyang Wang
      ***********/
     void init();
+    /***********************************************************************************************
+     * \brief Select the solver of the mass matrix for the deintegration
+     * \param[in] name the name of the solver in the LinearSolverRegistry
+     ***********/
+    void setLinearSolver(const std::string &name);
 
 private:
     /// whether to do integration or
@@ -19,32 +19,27 @@
  *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
  */
 #include <assert.h>
-#include <map>
 
 #include "LocationFilter.h"
 #include "AbstractMesh.h"
 #include "FEMesh.h"
+#include "FEMeshConnectivity.h"
 #include "ClientCode.h"
 #include "DataField.h"
 #include "ConnectionIO.h"
+#include "AuxiliaryParameters.h"
 
 namespace EMPIRE {
 
 using namespace std;
 
 LocationFilter::LocationFilter() :
-        AbstractFilter(), mesh(NULL), feMesh(NULL) {
+        AbstractFilter(), mesh(NULL), feMesh(NULL), connectivity(NULL) {
 }
 
 LocationFilter::~LocationFilter() {
-    if (caseNum == 1) {
-        const int numNodes = feMesh->numNodes;
-        for (int i = 0; i < numNodes; i++)
-            delete nodePosToElemTable[i];
-        delete[] nodePosToElemTable;
-    } else {
-        assert(false);
-    }
+    // connectivity is owned by feMesh
+    assert(caseNum == 1);
 }
 
 void LocationFilter::filtering() {
@@ -93,45 +88,60 @@ void LocationFilter::filterDataFieldCase1() {
     const double *inData = inDataField->data;
     double *outData = outDataField->data;
 
+    // the value at a node is the average of the elements containing it, a sparse matrix-vector
+    // product with the CSR node to element table whose row sums are precomputed in nodeWeights
     const int numNodes = feMesh->numNodes;
-    for (int i = 0; i < numNodes; i++) {
-        vector<int> *elemsContainingMe = nodePosToElemTable[i];
-        double weight = 1.0 / double(elemsContainingMe->size());
-        for (int j = 0; j < dimension; j++) {
+    const int *nodeOffsets = connectivity->getNodeOffsets();
+    const int *nodeElems = connectivity->getNodeElems();
+    const double *weights = &nodeWeights[0];
+    if (dimension == 1) {
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads)
+        for (int i = 0; i < numNodes; i++) {
             double sum = 0.0;
-            for (int k = 0; k < elemsContainingMe->size(); k++)
-                sum += inData[elemsContainingMe->at(k) * dimension + j];
-            outData[i * dimension + j] = weight * sum;
+#pragma omp simd reduction(+:sum)
+            for (int k = nodeOffsets[i]; k < nodeOffsets[i + 1]; k++)
+                sum += inData[nodeElems[k]];
+            outData[i] = weights[i] * sum;
+        }
+    } else if (dimension == 3) {
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads)
+        for (int i = 0; i < numNodes; i++) {
+            double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0;
+#pragma omp simd reduction(+:sum0,sum1,sum2)
+            for (int k = nodeOffsets[i]; k < nodeOffsets[i + 1]; k++) {
+                const double *elemData = &inData[nodeElems[k] * 3];
+                sum0 += elemData[0];
+                sum1 += elemData[1];
+                sum2 += elemData[2];
+            }
+            outData[i * 3 + 0] = weights[i] * sum0;
+            outData[i * 3 + 1] = weights[i] * sum1;
+            outData[i * 3 + 2] = weights[i] * sum2;
+        }
+    } else {
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads)
+        for (int i = 0; i < numNodes; i++) {
+            double *nodeData = &outData[i * dimension];
+            for (int j = 0; j < dimension; j++)
+                nodeData[j] = 0.0;
+            for (int k = nodeOffsets[i]; k < nodeOffsets[i + 1]; k++) {
+                const double *elemData = &inData[nodeElems[k] * dimension];
+#pragma omp simd
+                for (int j = 0; j < dimension; j++)
+                    nodeData[j] += elemData[j];
+            }
+            for (int j = 0; j < dimension; j++)
+                nodeData[j] *= weights[i];
         }
     }
 }
 
 void LocationFilter::computeNodePosToElemTable() {
+    connectivity = feMesh->getConnectivity();
     const int numNodes = feMesh->numNodes;
-    const int numElems = feMesh->numElems;
-    const int *nodeIDs = feMesh->nodeIDs;
-    const int *elems = feMesh->elems;
-
-    nodePosToElemTable = new vector<int>*[numNodes];
-    for (int i = 0; i < numNodes; i++)
-        nodePosToElemTable[i] = new vector<int>;
-
-    // a map linking a nodeID to its position in nodes is required
-    map<int, int> *nodeIDToNodePosMap = new map<int, int>;
+    nodeWeights.resize(numNodes);
     for (int i = 0; i < numNodes; i++)
-        nodeIDToNodePosMap->insert(nodeIDToNodePosMap->end(), pair<int, int>(nodeIDs[i], i));
-
-    int count = 0;
-    for (int i = 0; i < numElems; i++) {
-        int numNodesThisElem = feMesh->numNodesPerElem[i];
-        for (int j = 0; j < numNodesThisElem; j++) {
-            int nodeID = elems[count + j];
-            int nodePos = nodeIDToNodePosMap->at(nodeID);
-            nodePosToElemTable[nodePos]->push_back(i);
-        }
-        count += numNodesThisElem;
-    }assert(count == feMesh->elemsArraySize);
-    delete nodeIDToNodePosMap;
+        nodeWeights[i] = 1.0 / double(connectivity->getNumElemsOfNode(i));
 }
 
 } /* namespace EMPIRE */
@@ -34,6 +34,7 @@ namespace EMPIRE {
 
 class AbstractMesh;
 class FEMesh;
+class FEMeshConnectivity;
 /********//**
  * \brief Class LocationFilter filters the data between element centroids and nodes
  ***********/
@@ -65,8 +66,10 @@ private:
     AbstractMesh *mesh;
     /// cast mesh to feMesh
     FEMesh *feMesh;
-    /// table that links a node position (instead of node ID) to all elements containing it
-    std::vector<int> **nodePosToElemTable;
+    /// tables that link a node position (instead of node ID) to all elements containing it, shared by feMesh
+    const FEMeshConnectivity *connectivity;
+    /// 1 / the number of elements containing a node, for every node position
+    std::vector<double> nodeWeights;
     /// case number --- 1. field from element centroids to nodes; 2. to be implemented
     int caseNum;
     /***********************************************************************************************
@@ -75,7 +78,7 @@ private:
      ***********/
     void filterDataFieldCase1();
     /***********************************************************************************************
-     * \brief Compute the member nodePosToElemTable
+     * \brief Set the member connectivity from feMesh and compute the weights of the nodes
      * \author Tianyang Wang
      ***********/
     void computeNodePosToElemTable();
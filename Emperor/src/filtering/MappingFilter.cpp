@@ -23,8 +23,12 @@
 #include "ConnectionIO.h"
 #include "DataField.h"
 #include "DataFieldIntegrationFilter.h"
+#include "ScalingFilter.h"
+#include "Profiler.h"
 
 #include <assert.h>
+#include <math.h>
+#include <string.h>
 #include <iostream>
 
 using namespace std;
@@ -38,6 +42,10 @@ MappingFilter::MappingFilter(MapperAdapter *_mapper) :
     outputModifier = NULL;
     tmpInput = NULL;
     tmpOutput = NULL;
+    outputFactor = 1.0;
+    isIncremental = false;
+    incrementTolerance = 0.0;
+    mappedOutput = NULL;
 }
 
 MappingFilter::~MappingFilter() {
@@ -51,9 +59,12 @@ MappingFilter::~MappingFilter() {
         delete tmpOutput;
         delete outputModifier; // this will also delete the ConnectionIOs or it
     }
+    delete mappedOutput;
 }
 
 void MappingFilter::filtering() {
+    if (isIncremental && mapper->isIncrementalMappingSupported() && filterIncrementally())
+        return;
     // 1. input -> tmpInput
     if (inputModifier != NULL) {
         inputModifier->filtering();
@@ -71,15 +82,69 @@ void MappingFilter::filtering() {
     } else {
         outDataField = outputVec[0]->dataField;
     }
+    PROFILER_SCOPE("mapping");
     if (consistentMapping) {
-        mapper->consistentMapping(inDataField, outDataField);
+        mapper->consistentMapping(inDataField, outDataField, outputFactor);
     } else {
-        mapper->conservativeMapping(inDataField, outDataField);
+        mapper->conservativeMapping(inDataField, outDataField, outputFactor);
     }
     // 3. tmpOutput -> output
     if (outputModifier != NULL) {
         outputModifier->filtering();
     }
+    if (isIncremental) {
+        const DataField *input = inputVec[0]->dataField;
+        const DataField *output = outputVec[0]->dataField;
+        lastInput.assign(input->data, input->data + input->numLocations * input->dimension);
+        lastOutput.assign(output->data, output->data + output->numLocations * output->dimension);
+    }
+}
+
+bool MappingFilter::filterIncrementally() {
+    const DataField *input = inputVec[0]->dataField;
+    DataField *output = outputVec[0]->dataField;
+    const int inputSize = input->numLocations * input->dimension;
+    const int outputSize = output->numLocations * output->dimension;
+    if (!lastInput.empty()) {
+        double deltaNorm = 0.0;
+        double inputNorm = 0.0;
+        for (int i = 0; i < inputSize; i++) {
+            double delta = input->data[i] - lastInput[i];
+            deltaNorm += delta * delta;
+            inputNorm += input->data[i] * input->data[i];
+        }
+        if (sqrt(deltaNorm) <= incrementTolerance * sqrt(inputNorm)) {
+            // the input the output belongs to is kept, such that small changes add up
+            memcpy(output->data, &lastOutput[0], outputSize * sizeof(double));
+            return true;
+        }
+    }
+    if (!isChangedRowsFilteringSupported())
+        return false;
+
+    PROFILER_SCOPE("mapping");
+    const int dim = input->dimension;
+    if (mappedOutput == NULL) {
+        mappedOutput = new DataField("", EMPIRE_DataField_atNode, output->numLocations,
+                output->dimension, output->typeOfQuantity);
+        isInputNodeChanged.assign(input->numLocations, 1);
+    } else {
+        for (int i = 0; i < input->numLocations; i++) {
+            isInputNodeChanged[i] = memcmp(&input->data[i * dim], &lastInput[i * dim],
+                    dim * sizeof(double)) != 0;
+        }
+    }
+    mapper->consistentChangedRowsMapping(input, mappedOutput, &isInputNodeChanged[0]);
+    for (int i = 0; i < outputSize; i++)
+        output->data[i] = outputFactor * mappedOutput->data[i];
+    lastInput.assign(input->data, input->data + inputSize);
+    lastOutput.assign(output->data, output->data + outputSize);
+    return true;
+}
+
+bool MappingFilter::isChangedRowsFilteringSupported() const {
+    return consistentMapping && inputModifier == NULL && outputModifier == NULL
+            && mapper->isRowBlockMappingSupported();
 }
 
 void MappingFilter::init() {
@@ -160,4 +225,81 @@ void MappingFilter::init() {
     }
 }
 
+bool MappingFilter::canFoldScaling(const ScalingFilter *_scaling) const {
+    // a zero factor must overwrite the output instead
+    return _scaling->getFactor() != 0.0 && _scaling->hasInput(outputVec[0]);
+}
+
+void MappingFilter::setOutputFactor(double _outputFactor) {
+    assert(_outputFactor != 0.0);
+    outputFactor = _outputFactor;
+}
+
+void MappingFilter::setIncrementalMapping(double _incrementTolerance) {
+    assert(_incrementTolerance >= 0.0);
+    isIncremental = true;
+    incrementTolerance = _incrementTolerance;
+}
+
+bool MappingFilter::isExplicitOperatorSupported() const {
+    return !isIncremental && inputModifier == NULL && outputModifier == NULL
+            && mapper->isMappingOperatorExportSupported();
+}
+
+void MappingFilter::getExplicitOperator(int &numRows, int &numColumns,
+        std::vector<int> &rowPointers, std::vector<int> &columnIndices,
+        std::vector<double> &values) const {
+    assert(isExplicitOperatorSupported());
+    if (consistentMapping) {
+        mapper->getMappingOperator(numRows, numColumns, rowPointers, columnIndices, values, false);
+    } else {
+        // fieldA = H^T * fieldB, the rows of H are counted into the columns of the transpose
+        int numRowsH, numColumnsH;
+        vector<int> rowPointersH, columnIndicesH;
+        vector<double> valuesH;
+        mapper->getMappingOperator(numRowsH, numColumnsH, rowPointersH, columnIndicesH, valuesH,
+                false);
+        numRows = numColumnsH;
+        numColumns = numRowsH;
+        rowPointers.assign(numRows + 1, 0);
+        for (unsigned k = 0; k < columnIndicesH.size(); k++)
+            rowPointers[columnIndicesH[k] + 1]++;
+        for (int i = 0; i < numRows; i++)
+            rowPointers[i + 1] += rowPointers[i];
+        columnIndices.resize(columnIndicesH.size());
+        values.resize(valuesH.size());
+        vector<int> next(rowPointers.begin(), rowPointers.end() - 1);
+        for (int i = 0; i < numRowsH; i++) {
+            for (int k = rowPointersH[i]; k < rowPointersH[i + 1]; k++) {
+                int j = next[columnIndicesH[k]]++;
+                columnIndices[j] = i;
+                values[j] = valuesH[k];
+            }
+        }
+    }
+    if (outputFactor != 1.0)
+        for (unsigned k = 0; k < values.size(); k++)
+            values[k] *= outputFactor;
+}
+
+MapperAdapter *MappingFilter::getMapper() const {
+    return mapper;
+}
+
+bool MappingFilter::isRowBlockFilteringSupported() const {
+    // the incremental mapping needs the whole input
+    return !isIncremental && isChangedRowsFilteringSupported();
+}
+
+int MappingFilter::getNumRequiredInputNodes(int endOutputNode) const {
+    return mapper->getNumRequiredNodesA(endOutputNode);
+}
+
+void MappingFilter::filterRowBlock(int firstOutputNode, int endOutputNode) {
+    assert(isRowBlockFilteringSupported());
+    PROFILER_SCOPE("mapping");
+    mapper->consistentRowBlockMapping(inputVec[0]->dataField, outputVec[0]->dataField,
+            firstOutputNode, endOutputNode, outputFactor);
+}
+
 } /* namespace EMPIRE */
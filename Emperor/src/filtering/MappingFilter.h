@@ -28,12 +28,14 @@
 #define MAPPINGFILTER_H_
 
 #include "AbstractFilter.h"
+#include <vector>
 
 namespace EMPIRE {
 
 class MapperAdapter;
 class DataFieldIntegrationFilter;
 class DataField;
+class ScalingFilter;
 
 /********//**
  * \brief Class MappingFilter filters the data by calling a mapper
@@ -63,7 +65,77 @@ public:
      * \author Tianyang Wang
      ***********/
     void init();
+    /***********************************************************************************************
+     * \brief Check whether a scaling filter running right after this filter scales its output, so
+     *        that the scaling can be folded into the write of the mapper output
+     * \param[in] _scaling the scaling filter
+     * \return true if the scaling can be folded
+     ***********/
+    bool canFoldScaling(const ScalingFilter *_scaling) const;
+    /***********************************************************************************************
+     * \brief Set the factor the mapper output is scaled with
+     * \param[in] _outputFactor the factor, must not be zero
+     ***********/
+    void setOutputFactor(double _outputFactor);
+    /***********************************************************************************************
+     * \brief Get the mapper
+     ***********/
+    MapperAdapter *getMapper() const;
+    /***********************************************************************************************
+     * \brief Whether the output can be computed by ranges of nodes, which is the case for a
+     *        consistent mapping without integration of the input or the output by a mapper
+     *        supporting it
+     ***********/
+    bool isRowBlockFilteringSupported() const;
+    /***********************************************************************************************
+     * \brief Get the number of leading input nodes the output nodes before endOutputNode depend on
+     * \param[in] endOutputNode the end of the leading output nodes
+     ***********/
+    int getNumRequiredInputNodes(int endOutputNode) const;
+    /***********************************************************************************************
+     * \brief Compute the output nodes firstOutputNode to endOutputNode-1 only
+     * \param[in] firstOutputNode the first output node
+     * \param[in] endOutputNode the end of the output nodes
+     ***********/
+    void filterRowBlock(int firstOutputNode, int endOutputNode);
+    /***********************************************************************************************
+     * \brief Map incrementally, e.g. inside an iterative coupling loop. The mapping is skipped and
+     *        the previous output is kept if the input has changed by less than the tolerance
+     *        relative to its norm since the last mapping. Otherwise a consistent mapping by a mapper
+     *        supporting row blocks maps only the output nodes depending on a changed input node,
+     *        which is exact due to the linearity of the mapping. Not used for moving meshes
+     * \param[in] _incrementTolerance the relative tolerance of the input change, 0 skips the
+     *            mapping of unchanged inputs only
+     ***********/
+    void setIncrementalMapping(double _incrementTolerance);
+    /***********************************************************************************************
+     * \brief Whether the filter is one sparse matrix applied to its input, which is the case if
+     *        the mapper hands out its operator, neither the input nor the output is integrated
+     *        and the mapping is not incremental
+     ***********/
+    bool isExplicitOperatorSupported() const;
+    /***********************************************************************************************
+     * \brief Get the operator M of the filter, output = M * input for every component, in the node
+     *        order of the data fields. It is the operator of the mapper, transposed for a
+     *        conservative mapping and scaled by the output factor
+     * \param[out] numRows the number of output nodes
+     * \param[out] numColumns the number of input nodes
+     * \param[out] rowPointers the first entry of every row, numRows+1 integers
+     * \param[out] columnIndices the column of every entry
+     * \param[out] values the value of every entry
+     ***********/
+    void getExplicitOperator(int &numRows, int &numColumns, std::vector<int> &rowPointers,
+            std::vector<int> &columnIndices, std::vector<double> &values) const;
 private:
+    /***********************************************************************************************
+     * \brief Do the incremental mapping if the input change allows it
+     * \return false if the full mapping has to be done
+     ***********/
+    bool filterIncrementally();
+    /***********************************************************************************************
+     * \brief Whether the output nodes depending on changed input nodes can be mapped alone
+     ***********/
+    bool isChangedRowsFilteringSupported() const;
     /// The mapper
     MapperAdapter *mapper;
     /// true if do consistent mapping, false if do conservative mapping
@@ -76,6 +148,20 @@ private:
     DataField *tmpInput;
     /// temporary output for mapper
     DataField *tmpOutput;
+    /// factor of the folded scaling filters
+    double outputFactor;
+    /// whether the mapping is done incrementally
+    bool isIncremental;
+    /// the relative tolerance of the input change below which the mapping is skipped
+    double incrementTolerance;
+    /// the input of the last mapping
+    std::vector<double> lastInput;
+    /// the output of the last mapping
+    std::vector<double> lastOutput;
+    /// the unscaled mapper output of the last mapping, if only changed rows are mapped
+    DataField *mappedOutput;
+    /// whether the values of an input node have changed since the last mapping
+    std::vector<char> isInputNodeChanged;
 };
 
 } /* namespace EMPIRE */
@@ -33,25 +33,32 @@ ScalingFilter::~ScalingFilter() {
 }
 
 void ScalingFilter::filtering() {
-    EMPIRE_ConnectionIO_Type IOType = inputVec[0]->type;
-    if (IOType == EMPIRE_ConnectionIO_DataField) {
-        DataField *inDataField = inputVec[0]->dataField;
-        for (int i = 0; i < inDataField->numLocations * inDataField->dimension; i++) {
-            if (factor == 0.0)
-                inDataField->data[i] = 0.0;
-            else
-                inDataField->data[i] *= factor;
-        }
-    } else if (IOType == EMPIRE_ConnectionIO_Signal) {
-        Signal *inSignal = inputVec[0]->signal;
-        for (int i = 0; i < inSignal->size; i++) {
-            inSignal->array[i] *= factor;
-        }
+    filterEntries(0, getNumEntries());
+}
+
+bool ScalingFilter::isElementwise() const {
+    return true;
+}
+
+int ScalingFilter::getNumEntries() const {
+    return getSize(inputVec[0]);
+}
+
+void ScalingFilter::filterEntries(int _begin, int _end) {
+    double *data = getData(inputVec[0]);
+    if (factor == 0.0 && inputVec[0]->type == EMPIRE_ConnectionIO_DataField) {
+        for (int i = _begin; i < _end; i++)
+            data[i] = 0.0;
     } else {
-        assert(false);
+        for (int i = _begin; i < _end; i++)
+            data[i] *= factor;
     }
 }
 
+double ScalingFilter::getFactor() const {
+    return factor;
+}
+
 void ScalingFilter::init() {
     assert(inputVec.size() == 1);
     assert(outputVec.size() == 1);
@@ -53,6 +53,24 @@ public:
      * \author Tianyang Wang
      ***********/
     void init();
+    /***********************************************************************************************
+     * \brief Scaling is elementwise
+     ***********/
+    bool isElementwise() const;
+    /***********************************************************************************************
+     * \brief Get the number of entries of the data field or signal
+     ***********/
+    int getNumEntries() const;
+    /***********************************************************************************************
+     * \brief Filter the entries in [_begin, _end)
+     * \param[in] _begin the first entry
+     * \param[in] _end one past the last entry
+     ***********/
+    void filterEntries(int _begin, int _end);
+    /***********************************************************************************************
+     * \brief Get the scaling factor
+     ***********/
+    double getFactor() const;
 private:
     /// scaling factor
     double factor;
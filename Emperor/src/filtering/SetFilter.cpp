@@ -41,16 +41,28 @@ void SetFilter::filtering() {
             inDataField->data[i] = value;
         }*/
     } else if (IOType == EMPIRE_ConnectionIO_Signal) {
-        Signal *inSignal = inputVec[0]->signal;
-        assert(inSignal->size==value.size());
-        for (int i = 0; i < inSignal->size; i++) {
-            inSignal->array[i] = value[i];
-        }
+        filterEntries(0, getNumEntries());
     } else {
         assert(false);
     }
 }
 
+bool SetFilter::isElementwise() const {
+    return inputVec[0]->type == EMPIRE_ConnectionIO_Signal;
+}
+
+int SetFilter::getNumEntries() const {
+    assert(inputVec[0]->signal->size == value.size());
+    return inputVec[0]->signal->size;
+}
+
+void SetFilter::filterEntries(int _begin, int _end) {
+    double *array = inputVec[0]->signal->array;
+    for (int i = _begin; i < _end; i++) {
+        array[i] = value[i];
+    }
+}
+
 void SetFilter::init() {
     assert(inputVec.size() == 1);
     assert(outputVec.size() == 1);
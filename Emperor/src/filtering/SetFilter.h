@@ -53,6 +53,20 @@ public:
      * \author Stefan Sicklinger
      ***********/
     void init();
+    /***********************************************************************************************
+     * \brief Setting is elementwise on signals
+     ***********/
+    bool isElementwise() const;
+    /***********************************************************************************************
+     * \brief Get the number of entries of the signal
+     ***********/
+    int getNumEntries() const;
+    /***********************************************************************************************
+     * \brief Filter the entries in [_begin, _end)
+     * \param[in] _begin the first entry
+     * \param[in] _end one past the last entry
+     ***********/
+    void filterEntries(int _begin, int _end);
 private:
     /// values for all entries
     std::vector<double> value;
@@ -33,31 +33,44 @@ WeakCouplingFilter::~WeakCouplingFilter() {
 }
 
 void WeakCouplingFilter::filtering() {
-	INDENT_OUT(1, "WeakCouplingFilter: Calculating the predictor ...", infoOut);
+	filterEntries(0, getNumEntries());
+}
 
-	EMPIRE_ConnectionIO_Type IOType = inputVec[0]->type;
-	if (IOType == EMPIRE_ConnectionIO_DataField) {
-		DataField *inDataField = inputVec[0]->dataField;
-		for (int i = 0; i < inDataField->numLocations * inDataField->dimension; i++) {
-			t2[i] = beta * inDataField->data[i] + (1.0 - beta) * tp[i];
-			tp[i] = 2.0 * t2[i] - t1[i];
-			t1[i] = t2[i];
-			inDataField->data[i] = tp[i];
-		}
+bool WeakCouplingFilter::isElementwise() const {
+	return true;
+}
 
-	} else if (IOType == EMPIRE_ConnectionIO_Signal) {
-		Signal *inSignal = inputVec[0]->signal;
-		for (int i = 0; i < inSignal->size; i++) {
-			t2[i] = beta * inSignal->array[i] + (1.0 - beta) * tp[i];
-			tp[i] = 2.0 * t2[i] - t1[i];
-			t1[i] = t2[i];
-			inSignal->array[i] = tp[i];
-		}
-	} else {
-		assert(false);
+int WeakCouplingFilter::getNumEntries() const {
+	return getSize(inputVec[0]);
+}
+
+void WeakCouplingFilter::filterEntries(int _begin, int _end) {
+	if (_begin == 0)
+		INDENT_OUT(1, "WeakCouplingFilter: Calculating the predictor ...", infoOut);
+
+	double *data = getData(inputVec[0]);
+	for (int i = _begin; i < _end; i++) {
+		t2[i] = beta * data[i] + (1.0 - beta) * tp[i];
+		tp[i] = 2.0 * t2[i] - t1[i];
+		t1[i] = t2[i];
+		data[i] = tp[i];
 	}
 }
 
+void WeakCouplingFilter::writeCheckpoint(CheckpointArchive &archive) const {
+	int size = getNumEntries();
+	archive.write(t1, size);
+	archive.write(t2, size);
+	archive.write(tp, size);
+}
+
+void WeakCouplingFilter::readCheckpoint(CheckpointArchive &archive) {
+	int size = getNumEntries();
+	archive.read(t1, size);
+	archive.read(t2, size);
+	archive.read(tp, size);
+}
+
 void WeakCouplingFilter::init() {
 	assert(inputVec.size() == 1);
 	assert(outputVec.size() == 1);
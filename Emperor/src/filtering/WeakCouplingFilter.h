@@ -53,6 +53,30 @@ public:
      * \author Ivan Hanzlicek
      ***********/
     void init();
+    /***********************************************************************************************
+     * \brief The predictor is elementwise
+     ***********/
+    bool isElementwise() const;
+    /***********************************************************************************************
+     * \brief Get the number of entries of the data field or signal
+     ***********/
+    int getNumEntries() const;
+    /***********************************************************************************************
+     * \brief Filter the entries in [_begin, _end)
+     * \param[in] _begin the first entry
+     * \param[in] _end one past the last entry
+     ***********/
+    void filterEntries(int _begin, int _end);
+    /***********************************************************************************************
+     * \brief Write the traction forces of the previous time steps and the predictor
+     * \param[in] archive the archive
+     ***********/
+    void writeCheckpoint(CheckpointArchive &archive) const;
+    /***********************************************************************************************
+     * \brief Restore the traction forces of the previous time steps and the predictor
+     * \param[in] archive the archive
+     ***********/
+    void readCheckpoint(CheckpointArchive &archive);
 private:
     // weighting parameter
     const double beta;
@@ -42,8 +42,14 @@ enum EMPIRE_DataField_location {
 enum EMPIRE_DataField_typeOfQuantity {
     EMPIRE_DataField_field, EMPIRE_DataField_fieldIntegral
 };
+enum EMPIRE_DataField_wireFormat {
+    EMPIRE_DataField_float64 = 0,
+    EMPIRE_DataField_float32 = 1,
+    EMPIRE_DataField_lossless = 2,
+    EMPIRE_DataField_deltaLossless = 3
+};
 enum EMPIRE_ConnectionIO_Type {
-    EMPIRE_ConnectionIO_Signal, EMPIRE_ConnectionIO_DataField
+    EMPIRE_ConnectionIO_Signal, EMPIRE_ConnectionIO_DataField, EMPIRE_ConnectionIO_MeshCoordinates
 };
 enum EMPIRE_Signal_dimension {
     EMPIRE_Signal_0D, EMPIRE_Signal_1D, EMPIRE_Signal_2D, EMPIRE_Signal_3D
@@ -52,6 +58,10 @@ enum EMPIRE_Signal_dimension {
 enum EMPIRE_BlasLevel1Filter_RoutineName {
     EMPIRE_BlasLevel1Filter_daxpy
 };
+enum EMPIRE_DataOutput_format {
+    EMPIRE_DataOutput_GiD, EMPIRE_DataOutput_binary, EMPIRE_DataOutput_HDF5,
+    EMPIRE_DataOutput_ADIOS2
+};
 /********//**
  * The rule of naming 2:
  * EMPIRE_[motherClassName]_type and
@@ -66,7 +76,8 @@ enum EMPIRE_Mapper_type {
     EMPIRE_NearestElementMapper,
     EMPIRE_IGAMortarMapper,
     EMPIRE_IGABarycentricMapper,
-    EMPIRE_CurveSurfaceMapper
+    EMPIRE_CurveSurfaceMapper,
+    EMPIRE_RBFMapper
 };
 
 enum EMPIRE_CurveSurfaceMapper_type {
@@ -84,6 +95,12 @@ enum EMPIRE_Mesh_type {
     EMPIRE_Mesh_SectionMesh
 };
 
+enum EMPIRE_Mesh_renumbering {
+    EMPIRE_Mesh_noRenumbering,
+    EMPIRE_Mesh_mortonRenumbering,
+    EMPIRE_Mesh_hilbertRenumbering
+};
+
 enum EMPIRE_Condition_type{
     EMPIRE_WeakIGADirichletCurveCondition,
     EMPIRE_WeakIGADirichletSurfaceCondition,
@@ -109,15 +126,23 @@ enum EMPIRE_CouplingLogic_type {
     EMPIRE_OptimizationLoop
 };
 
+enum EMPIRE_IterativeCouplingLoop_schema {
+    EMPIRE_GaussSeidel,
+    EMPIRE_Jacobi
+};
+
 enum EMPIRE_Extrapolator_type {
-    EMPIRE_LinearExtrapolator
+    EMPIRE_LinearExtrapolator,
+    EMPIRE_PolynomialExtrapolator,
+    EMPIRE_AdamsBashforthExtrapolator
 };
 
 enum EMPIRE_CouplingAlgorithm_type {
     EMPIRE_Aitken,
     EMPIRE_ConstantRelaxation,
     EMPIRE_IJCSA,
-    EMPIRE_GMRES
+    EMPIRE_GMRES,
+    EMPIRE_IQNILS
 };
 
 /********//**
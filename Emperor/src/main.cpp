@@ -69,6 +69,7 @@
 #include "Message.h"
 #include "AuxiliaryFunctions.h"
 #include "MPIErrorHandling.h"
+#include "ServerRanks.h"
 
 using namespace std;
 using namespace EMPIRE;
@@ -77,6 +78,12 @@ int main(int argc, char **argv) {
     Emperor *emperor = new Emperor();
 
     emperor->initEnvironment(&argc, &argv);
+    if (ServerRanks::getRank() > 0) { // a worker of an Emperor started on several ranks
+        ServerRanks::serveCommands();
+        delete emperor;
+        MPI_Finalize();
+        return (0);
+    }
     omp_set_nested(1); /// Enable nested parallelism
     omp_set_max_active_levels(2); /// Max two levels of nested parallelism
     omp_set_dynamic(0); /// I take full control
@@ -114,8 +121,11 @@ int main(int argc, char **argv) {
         } /// End of sections
     } /// End of parallel section
 
+    Message::setSinkThread(); // the sink was the coupling thread
     INFO_OUT() << "Stop openmp threading" << endl;
     delete emperor;
+    // after the mappers, which delete their distributed matrices
+    ServerRanks::terminateWorkers();
     MPI_Finalize();
 
     return (0);
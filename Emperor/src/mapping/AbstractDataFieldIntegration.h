@@ -27,6 +27,7 @@
 #ifndef ABSTRACTDATAFIELDINTEGRATION_H_
 #define ABSTRACTDATAFIELDINTEGRATION_H_
 
+#include <vector>
 #include "MathLibrary.h"
 
 namespace EMPIRE {
@@ -47,6 +48,11 @@ public:
      * \author Tianyang Wang
      ***********/
     void integrate(const double *tractions, double *forces) {
+        if (isLumped) {
+            for (int i = 0; i < numNodes; i++)
+                forces[i] = lumpedMass[i] * tractions[i];
+            return;
+        }
         // This routine supports only one-based indexing of the input arrays.
         // Edit Aditya
         massMatrix->determineCSR();
@@ -59,20 +65,58 @@ public:
      * \author Tianyang Wang
      ***********/
     void deIntegrate(const double *forces, double *tractions) {
+        if (isLumped) {
+            for (int i = 0; i < numNodes; i++)
+                tractions[i] = forces[i] / lumpedMass[i];
+            return;
+        }
+        // the factorization of the frozen matrix is computed by the first call and reused
         // Edit Aditya
         massMatrix->solve(tractions,const_cast<double*>(forces));
     };
+    /***********************************************************************************************
+     * \brief Select the solver of the mass matrix, ignored if the mass matrix is lumped
+     * \param[in] name the name of the solver in the LinearSolverRegistry
+     ***********/
+    void setLinearSolver(const std::string &name) {
+        if (massMatrix != NULL)
+            massMatrix->setLinearSolver(name);
+    }
 protected:
     /***********************************************************************************************
      * \brief Constructor protected to prevent explicit instantiation
      * \author Fabien Pean
      ***********/
-	AbstractDataFieldIntegration() {
+	AbstractDataFieldIntegration(bool _isLumped = false) :
+	        massMatrix(NULL), numNodes(0), isLumped(_isLumped) {
 	};
-    /// massMatrix csr format
+    /***********************************************************************************************
+     * \brief Finish the assembly of the mass matrix. The matrix is frozen, such that its
+     *        factorization is never invalidated. A lumped mass matrix is reduced to its row sums
+     *        and the sparse matrix is released.
+     ***********/
+    void finalizeMassMatrix() {
+        massMatrix->freeze();
+        if (!isLumped)
+            return;
+        lumpedMass.resize(numNodes);
+        for (int i = 0; i < numNodes; i++) {
+            lumpedMass[i] = massMatrix->getRowSum(i);
+            // a node outside of all elements keeps its value
+            if (lumpedMass[i] == 0.0)
+                lumpedMass[i] = 1.0;
+        }
+        delete massMatrix;
+        massMatrix = NULL;
+    }
+    /// massMatrix csr format, NULL if lumped
     EMPIRE::MathLibrary::SparseMatrix<double> *massMatrix;
     /// number of nodes
     int numNodes;
+    /// whether the row sums of the mass matrix are used instead of the mass matrix
+    bool isLumped;
+    /// the row sums of the mass matrix if lumped
+    std::vector<double> lumpedMass;
 };
 
 } /* namespace EMPIRE */
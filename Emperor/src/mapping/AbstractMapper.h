@@ -28,12 +28,18 @@
 #define ABSTRACTMAPPER_H_
 
 #include <string>
+#include <vector>
+#include <assert.h>
 
 #include "EMPEROR_Enum.h"
+#include "MemoryUsage.h"
+#include "MapperBuildStatistics.h"
+#include "LinearSolver.h"
 
 namespace EMPIRE {
 class DataField;
 class AbstractMesh;
+class CouplingMatricesCache;
 
 /********//**
  * \brief Class AbstractMapper is the superclass of all mappers
@@ -84,6 +90,346 @@ public:
      * ***********/
     virtual void computeErrorsConsistentMapping(const double *fieldA, const double *fieldB) = 0;
 
+    /***********************************************************************************************
+     * \brief Whether the mapper can map all components of an interleaved field in one go
+     * \return true if consistentBlockMapping and conservativeBlockMapping are implemented
+     ***********/
+    virtual bool isBlockMappingSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Do consistent mapping on all components of interleaved fields at once (e.g. x,y,z-displacements)
+     * \param[in] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[out] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    virtual void consistentBlockMapping(const double *fieldA, double *fieldB, int numComponents) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Do conservative mapping on all components of interleaved integrated fields at once (e.g. x,y,z-forces)
+     * \param[in] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[out] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    virtual void conservativeBlockMapping(const double *fieldB, double *fieldA, int numComponents) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Do consistent mapping from A to B and conservative mapping from B to A in one call (e.g.
+     *        the displacements and the forces of a coupling iteration). Mappers solving with a
+     *        symmetric coupling matrix override it to solve both directions at once.
+     * \param[in] fieldA the field of mesh A (e.g. displacements)
+     * \param[out] fieldBOut the consistently mapped field of mesh B
+     * \param[in] fieldB the integral field of mesh B (e.g. forces)
+     * \param[out] fieldAOut the conservatively mapped field of mesh A
+     * \param[in] numComponents the number of interleaved components per node, more than one only if
+     *            isBlockMappingSupported
+     ***********/
+    virtual void mapBothDirections(const double *fieldA, double *fieldBOut, const double *fieldB,
+            double *fieldAOut, int numComponents) {
+        if (numComponents == 1) {
+            consistentMapping(fieldA, fieldBOut);
+            conservativeMapping(fieldB, fieldAOut);
+        } else {
+            consistentBlockMapping(fieldA, fieldBOut, numComponents);
+            conservativeBlockMapping(fieldB, fieldAOut, numComponents);
+        }
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the consistent mapping of a range of nodes of B can be done on its own once a
+     *        leading part of fieldA is known, which allows to map a field while it is received.
+     *        Called after buildCouplingMatrices
+     * \return true if getNumRequiredNodesA and consistentRowBlockMapping are implemented
+     ***********/
+    virtual bool isRowBlockMappingSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Get the number of leading nodes of A the consistent mapping of the nodes of B before
+     *        endNodeB depends on
+     * \param[in] endNodeB the end of the leading nodes of B
+     ***********/
+    virtual int getNumRequiredNodesA(int endNodeB) const {
+        assert(false);
+        return 0;
+    }
+
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes firstNodeB to endNodeB-1 of B only, the other
+     *        nodes of fieldB are untouched
+     * \param[in] fieldA the field of mesh A, only the first getNumRequiredNodesA(endNodeB) nodes
+     *            are read
+     * \param[out] fieldB the field of mesh B
+     * \param[in] numComponents the number of interleaved components per node
+     * \param[in] firstNodeB the first node of B
+     * \param[in] endNodeB the end of the nodes of B
+     ***********/
+    virtual void consistentRowBlockMapping(const double *fieldA, double *fieldB,
+            int numComponents, int firstNodeB, int endNodeB) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes of B which depend on a changed node of A only, the
+     *        other nodes of fieldB keep the mapping of the unchanged fieldA. Supported if
+     *        isRowBlockMappingSupported
+     * \param[in] fieldA the field of mesh A
+     * \param[in,out] fieldB the field of mesh B, holding the mapping of fieldA before its change
+     * \param[in] numComponents the number of interleaved components per node
+     * \param[in] isNodeAChanged whether the values of a node of A have changed
+     * \return the number of mapped nodes of B
+     ***********/
+    virtual int consistentChangedRowsMapping(const double *fieldA, double *fieldB,
+            int numComponents, const char *isNodeAChanged) {
+        assert(false);
+        return 0;
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the coupling matrices can be stored in and read from a CouplingMatricesCache
+     * \return true if writeCouplingMatricesToCache and readCouplingMatricesFromCache are implemented
+     ***********/
+    virtual bool isCouplingMatricesCacheSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Store the coupling matrices in the cache, called after buildCouplingMatrices
+     * \param[in] cache the cache
+     ***********/
+    virtual void writeCouplingMatricesToCache(CouplingMatricesCache *cache) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Take the coupling matrices from the cache instead of calling buildCouplingMatrices
+     * \param[in] cache the loaded cache
+     * \return false if the cache does not hold all matrices, then nothing is changed
+     ***********/
+    virtual bool readCouplingMatricesFromCache(const CouplingMatricesCache *cache) {
+        assert(false);
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the coupling matrices can be rebuilt after the nodes of the meshes moved
+     * \return true if updateGeometry is implemented
+     ***********/
+    virtual bool isGeometryUpdateSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Rebuild the coupling matrices after the nodes of the meshes moved, the topology of the
+     *        meshes must be unchanged. The matrices are reassembled in place, so that a factorization
+     *        with an unchanged sparsity pattern only redoes the numerical phase.
+     ***********/
+    virtual void updateGeometry() {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the coupling matrices can be updated row by row after some nodes moved
+     * \return true if updateGeometry(movedNodesA, movedNodesB) is implemented
+     ***********/
+    virtual bool isPartialGeometryUpdateSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Recompute only the rows of the coupling matrices which depend on moved nodes: the rows
+     *        of the moved nodes of B, the rows interpolating from moved nodes of A and the rows for
+     *        which a moved node or element of A may now be nearer than the one they interpolate
+     *        from. The node arrays of the mapper already hold the new coordinates, the topology of
+     *        the meshes is unchanged.
+     * \param[in] movedNodesA the positions of the moved nodes of A
+     * \param[in] movedNodesB the positions of the moved nodes of B
+     ***********/
+    virtual void updateGeometry(const std::vector<int> &movedNodesA,
+            const std::vector<int> &movedNodesB) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the mass matrix can be solved by an iterative solver instead of a direct one
+     * \return true if setIterativeSolver is implemented
+     ***********/
+    virtual bool isIterativeSolverSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Solve the mass matrix by the preconditioned conjugate gradient method, warm started from
+     *        the previous mapped field. Must be called before buildCouplingMatrices.
+     * \param[in] tolerance the relative residual tolerance
+     * \param[in] maxIterations the maximum number of iterations
+     ***********/
+    virtual void setIterativeSolver(double tolerance, int maxIterations) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Change the tolerance of the iterative solver between two mappings, e.g. to solve
+     *        inexactly while the coupling is far from convergence. setIterativeSolver must have
+     *        been called and the coupling matrices must be built.
+     * \param[in] tolerance the relative residual tolerance
+     ***********/
+    virtual void setIterativeSolverTolerance(double tolerance) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Select the solver of the matrix the mapper solves by its name in the
+     *        LinearSolverRegistry. Must be called before buildCouplingMatrices. Mappers which do not
+     *        solve a matrix ignore it.
+     * \param[in] name the name of the solver
+     ***********/
+    virtual void setLinearSolver(const std::string &name) {
+    }
+
+    /***********************************************************************************************
+     * \brief Set the threads, the ordering and the storage of the PARDISO factors of the matrix
+     *        the mapper solves. Must be called before buildCouplingMatrices. Mappers which do not
+     *        solve a matrix ignore it.
+     * \param[in] settings the settings
+     ***********/
+    virtual void setPardisoSettings(const MathLibrary::PardisoSettings &settings) {
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the mapper can release the data only needed for building the coupling matrices
+     * \return true if setCompactAfterBuild is implemented
+     ***********/
+    virtual bool isCompactAfterBuildSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Release the data only needed for building the coupling matrices (projections, polygons,
+     *        element tables) once they are built or read from the cache. Must be called before
+     *        buildCouplingMatrices
+     * \param[in] compact true to release the data
+     ***********/
+    virtual void setCompactAfterBuild(bool compact) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the mapper can reorder its coupling matrices for a smaller bandwidth
+     * \return true if setReorderCouplingMatrices is implemented
+     ***********/
+    virtual bool isReorderCouplingMatricesSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Renumber the unknowns of the coupling matrices by reverse Cuthill-McKee once they are
+     *        built, the mapped fields keep the order of the meshes. Must be called before
+     *        buildCouplingMatrices
+     * \param[in] reorder true to reorder
+     ***********/
+    virtual void setReorderCouplingMatrices(bool reorder) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the mapper can store its interpolation weights in single precision
+     * \return true if setSinglePrecisionWeights is implemented
+     ***********/
+    virtual bool isSinglePrecisionWeightsSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Store the weights of the coupling matrix in single precision, the mapping still
+     *        accumulates in double precision. Must be called before buildCouplingMatrices
+     * \param[in] singlePrecision true for single precision
+     ***********/
+    virtual void setSinglePrecisionWeights(bool singlePrecision) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the mapper can precompute its mapping as one explicit operator
+     * \return true if setExplicitMappingOperator is implemented
+     ***********/
+    virtual bool isExplicitMappingOperatorSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Precompute the mapping operator (e.g. C_BB^(-1) * C_BA) as one sparse matrix once the
+     *        coupling matrices are built, so that a mapping is one product. Must be called before
+     *        buildCouplingMatrices
+     * \param[in] explicitOperator true to precompute the operator
+     ***********/
+    virtual void setExplicitMappingOperator(bool explicitOperator) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the whole mapping is one sparse matrix which can be handed out, called after
+     *        buildCouplingMatrices
+     * \return true if getMappingOperator is implemented
+     ***********/
+    virtual bool isMappingOperatorExportSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Get a copy of the mapping operator M in CSR format, consistent mapping is
+     *        fieldB = M * fieldA and conservative mapping fieldA = M^T * fieldB. The rows are the
+     *        nodes of B and the columns the nodes of A in the order of the mapper
+     * \param[out] rowPointers the first entry of every row, one more than the nodes of B
+     * \param[out] columnIndices the column of every entry
+     * \param[out] values the value of every entry
+     ***********/
+    virtual void getMappingOperator(std::vector<int> &rowPointers, std::vector<int> &columnIndices,
+            std::vector<double> &values) const {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the mapper can build its operators for the used mapping directions only
+     * \return true if setMappingDirections is implemented
+     ***********/
+    virtual bool isMappingDirectionsSupported() const {
+        return false;
+    }
+
+    /***********************************************************************************************
+     * \brief Build only the operators of the used mapping directions, the other mapping must not be
+     *        called. Must be called before buildCouplingMatrices
+     * \param[in] consistent whether consistent mapping is used
+     * \param[in] conservative whether conservative mapping is used
+     ***********/
+    virtual void setMappingDirections(bool consistent, bool conservative) {
+        assert(false);
+    }
+
+    /***********************************************************************************************
+     * \brief Get the heap memory held by the mapper (coupling matrices, search structures and tables)
+     *        broken down by its components, the meshes are not included
+     ***********/
+    virtual MemoryUsage getMemoryUsage() const {
+        return MemoryUsage();
+    }
+
+    /***********************************************************************************************
+     * \brief Get the quality and the cost of the last build of the coupling matrices (projections,
+     *        clipped polygons, quadrature points, matrix sizes and the time of the stages), empty
+     *        if the mapper does not collect them
+     ***********/
+    virtual MapperBuildStatistics getBuildStatistics() const {
+        return MapperBuildStatistics();
+    }
+
     /// type of the mapper
     EMPIRE_Mapper_type mapperType;
 
@@ -22,6 +22,7 @@
 #include <assert.h>
 #include <math.h>
 #include <vector>
+#include <algorithm>
 
 #ifdef FLANN
 #include "flann/flann.hpp"
@@ -34,6 +35,12 @@
 //#include "MortarMath.h"
 // Edit Aditya
 #include "MathLibrary.h"
+#include "CSRMatrix.h"
+#include "DistributedCSRMatrix.h"
+#include "AuxiliaryParameters.h"
+#include "AABBTree.h"
+#include "MultilevelNeighborSearch.h"
+#include "Message.h"
 
 
 using namespace std;
@@ -42,9 +49,42 @@ namespace EMPIRE {
 
 const int BarycentricInterpolationMapper::MAX_NUM_NEIGHBORS_TO_SEARCH = 50;
 
+/********//**
+ * \brief Class BarycentricNeighborVisitor takes the two nearest nodes of A and the nearest node
+ *        which is not on their line as the neighbors of a node of B
+ ***********/
+class BarycentricNeighborVisitor : public MultilevelNeighborSearch::Visitor {
+public:
+    BarycentricNeighborVisitor(const double *_nodesA, int *_neighborsTable) :
+            nodesA(_nodesA), neighborsTable(_neighborsTable) {
+    }
+    void visit(int point, const int *neighbors, int numNeighbors) {
+        const double *p1 = &(nodesA[neighbors[0] * 3]);
+        const double *p2 = &(nodesA[neighbors[1] * 3]);
+        int p3Index = 2;
+        while (true) {
+            const double *p3 = &(nodesA[neighbors[p3Index] * 3]);
+            if (BarycentricInterpolationMapper::areNotOnTheSameLine(p1, p2, p3)) {
+                break;
+            }
+            p3Index++;
+            assert(p3Index != numNeighbors);
+        }
+
+        neighborsTable[point * 3 + 0] = neighbors[0];
+        neighborsTable[point * 3 + 1] = neighbors[1];
+        neighborsTable[point * 3 + 2] = neighbors[p3Index];
+    }
+private:
+    const double *nodesA;
+    int *neighborsTable;
+};
+
 BarycentricInterpolationMapper::BarycentricInterpolationMapper(int _numNodesA,
         const double *_nodesA, int _numNodesB, const double *_nodesB) :
-        numNodesA(_numNodesA), nodesA(_nodesA), numNodesB(_numNodesB), nodesB(_nodesB) {
+        numNodesA(_numNodesA), nodesA(_nodesA), numNodesB(_numNodesB), nodesB(_nodesB),
+        isSinglePrecisionWeights(false), isConsistentMappingUsed(true),
+        isConservativeMappingUsed(true), couplingMatrix(NULL), sharedSearchTree(NULL) {
 
     mapperType = EMPIRE_BarycentricInterpolationMapper;
 
@@ -56,35 +96,52 @@ BarycentricInterpolationMapper::BarycentricInterpolationMapper(int _numNodesA,
 BarycentricInterpolationMapper::~BarycentricInterpolationMapper() {
     delete neighborsTable;
     delete weightsTable;
+    delete couplingMatrix;
+}
+
+void BarycentricInterpolationMapper::setSharedSearchTree(flann::Index<flann::L2<double> > *tree) {
+    sharedSearchTree = tree;
 }
 
 void BarycentricInterpolationMapper::consistentMapping(const double *fieldA, double *fieldB) {
-    for (int i = 0; i < numNodesB; i++) { // i-th node
-        int neighbors[3];
-        for (int j = 0; j < 3; j++) {
-            neighbors[j] = neighborsTable[i * 3 + j];
-        }
-        double val = 0.0;
-        for (int j = 0; j < 3; j++) { //j-th neighbor
-            val += weightsTable[i * 3 + j] * fieldA[neighbors[j]];
-        }
-        fieldB[i] = val;
-    }
+    couplingMatrix->multiply(false, fieldA, fieldB);
 }
 
-void BarycentricInterpolationMapper::conservativeMapping(const double *fieldB,
-        double *fieldA) {
-    for (int i = 0; i < numNodesA; i++) {
-        fieldA[i] = 0.0;
-    }
-    for (int i = 0; i < numNodesB; i++) { // i-th node
-        int neighbors[3];
-        for (int j = 0; j < 3; j++)
-            neighbors[j] = neighborsTable[i * 3 + j];
-        for (int j = 0; j < 3; j++) { //j-th neighbor
-            fieldA[neighbors[j]] += weightsTable[i * 3 + j] * fieldB[i];
-        }
-    }
+void BarycentricInterpolationMapper::conservativeMapping(const double *fieldB, double *fieldA) {
+    couplingMatrix->multiply(true, fieldB, fieldA);
+}
+
+void BarycentricInterpolationMapper::consistentBlockMapping(const double *fieldA, double *fieldB,
+        int numComponents) {
+    couplingMatrix->multiplyBlock(false, fieldA, fieldB, numComponents);
+}
+
+void BarycentricInterpolationMapper::conservativeBlockMapping(const double *fieldB, double *fieldA,
+        int numComponents) {
+    couplingMatrix->multiplyBlock(true, fieldB, fieldA, numComponents);
+}
+
+void BarycentricInterpolationMapper::getMappingOperator(std::vector<int> &rowPointers,
+        std::vector<int> &columnIndices, std::vector<double> &values) const {
+    couplingMatrix->getEntries(rowPointers, columnIndices, values);
+}
+
+bool BarycentricInterpolationMapper::isRowBlockMappingSupported() const {
+    return isConsistentMappingUsed && couplingMatrix->isRowRangeProductSupported();
+}
+
+int BarycentricInterpolationMapper::getNumRequiredNodesA(int endNodeB) const {
+    return couplingMatrix->getColumnBound(endNodeB);
+}
+
+void BarycentricInterpolationMapper::consistentRowBlockMapping(const double *fieldA,
+        double *fieldB, int numComponents, int firstNodeB, int endNodeB) {
+    couplingMatrix->multiplyRowRange(fieldA, fieldB, numComponents, firstNodeB, endNodeB);
+}
+
+int BarycentricInterpolationMapper::consistentChangedRowsMapping(const double *fieldA, double *fieldB,
+        int numComponents, const char *isNodeAChanged) {
+    return couplingMatrix->multiplyChangedRows(fieldA, fieldB, numComponents, isNodeAChanged);
 }
 
 void BarycentricInterpolationMapper::computeErrorsConsistentMapping(const double *_slaveField, const double *_masterField) {
@@ -92,12 +149,89 @@ void BarycentricInterpolationMapper::computeErrorsConsistentMapping(const double
     exit(-1);
 }
 
+MemoryUsage BarycentricInterpolationMapper::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("neighbors table", numNodesB * 3 * sizeof(int));
+    usage.add("weights table", numNodesB * 3 * sizeof(double));
+    if (couplingMatrix != NULL)
+        usage.add("coupling matrix", couplingMatrix->getMemoryUsage());
+    return usage;
+}
+
 void BarycentricInterpolationMapper::buildCouplingMatrices(){
-    computeNeighbors();
-    computeWeights();
+    vector<int> rows(numNodesB);
+    for (int i = 0; i < numNodesB; i++)
+        rows[i] = i;
+    computeNeighbors(rows);
+    computeWeights(rows);
+    assembleCouplingMatrix();
+}
+
+void BarycentricInterpolationMapper::updateGeometry(const vector<int> &movedNodesA,
+        const vector<int> &movedNodesB) {
+    // A row is affected if its node moved, if one of its neighbors moved or if a moved node of A is
+    // now nearer than its furthest neighbor. Nodes of A which moved away without being neighbors
+    // had been skipped by the search, so they do not change the row.
+    vector<char> isAffected(numNodesB, 0);
+    for (int i = 0; i < movedNodesB.size(); i++)
+        isAffected[movedNodesB[i]] = 1;
+    if (!movedNodesA.empty()) {
+        vector<char> isMovedA(numNodesA, 0);
+        vector<AABB> movedBoxes(movedNodesA.size());
+        for (int i = 0; i < movedNodesA.size(); i++) {
+            isMovedA[movedNodesA[i]] = 1;
+            movedBoxes[i].computeFromPoints(&(nodesA[movedNodesA[i] * 3]), 1);
+        }
+        AABBTree movedTree(movedBoxes);
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads)
+        for (int i = 0; i < numNodesB; i++) {
+            if (isAffected[i])
+                continue;
+            double radius = 0.0;
+            for (int j = 0; j < 3; j++) {
+                int neighbor = neighborsTable[i * 3 + j];
+                if (isMovedA[neighbor])
+                    isAffected[i] = 1;
+                radius = max(radius,
+                        EMPIRE::MathLibrary::distanceSquare(&(nodesB[i * 3]), &(nodesA[neighbor * 3])));
+            }
+            if (isAffected[i])
+                continue;
+            AABBTreeDistanceQuery query(movedTree, &(nodesB[i * 3]));
+            double distance;
+            if (query.next(sqrt(radius), distance) >= 0)
+                isAffected[i] = 1;
+        }
+    }
+    vector<int> rows;
+    for (int i = 0; i < numNodesB; i++)
+        if (isAffected[i])
+            rows.push_back(i);
+
+    // a shared tree belongs to the old geometry, so the search builds an own one from now on
+    sharedSearchTree = NULL;
+    if (!rows.empty()) {
+        computeNeighbors(rows);
+        computeWeights(rows);
+    }
+    INFO_OUT() << "BarycentricInterpolationMapper: " << rows.size() << " of " << numNodesB
+            << " rows updated after the geometry changed" << endl;
+    assembleCouplingMatrix();
+}
+
+void BarycentricInterpolationMapper::assembleCouplingMatrix() {
+    vector<int> rowPtr(numNodesB + 1);
+    for (int i = 0; i <= numNodesB; i++)
+        rowPtr[i] = i * 3;
+    vector<int> cols(neighborsTable, neighborsTable + numNodesB * 3);
+    vector<double> values(weightsTable, weightsTable + numNodesB * 3);
+    delete couplingMatrix;
+    couplingMatrix = DistributedCSRMatrix::create(numNodesB, numNodesA, rowPtr, cols, values,
+            AuxiliaryParameters::mapperSetNumThreads, isSinglePrecisionWeights,
+            MathLibrary::CSRMatrix::getProducts(isConsistentMappingUsed, isConservativeMappingUsed));
 }
 
-void BarycentricInterpolationMapper::computeNeighbors() {
+void BarycentricInterpolationMapper::computeNeighbors(const vector<int> &rows) {
     int NUM_NEIGHBORS_TO_SEARCH = MAX_NUM_NEIGHBORS_TO_SEARCH;
     if (NUM_NEIGHBORS_TO_SEARCH > numNodesA) {
         NUM_NEIGHBORS_TO_SEARCH = numNodesA;
@@ -110,7 +244,8 @@ void BarycentricInterpolationMapper::computeNeighbors() {
 
         ANNkd_tree *ANodesTree = new ANNkd_tree(ANodes, numNodesA, 3);
 
-        for (int i = 0; i < numNodesB; i++) {
+        for (int r = 0; r < rows.size(); r++) {
+            int i = rows[r];
             int nb[NUM_NEIGHBORS_TO_SEARCH];
             double dummy[NUM_NEIGHBORS_TO_SEARCH];
             ANodesTree->annkSearch(&(nodesB[i * 3]), NUM_NEIGHBORS_TO_SEARCH, nb, dummy);
@@ -138,45 +273,35 @@ void BarycentricInterpolationMapper::computeNeighbors() {
     }
     {
 #ifdef FLANN
-        double *nodesBCasted = const_cast<double*>(nodesB);
-        flann::Matrix<double> *ANodes = new flann::Matrix<double>(
-                const_cast<double*>(nodesA), numNodesA, 3);
-        flann::Index<flann::L2<double> > *ANodesTree = new flann::Index<flann::L2<double> >(*ANodes,
-                flann::KDTreeSingleIndexParams(1));
-        ANodesTree->buildIndex(); // Build binary tree for searching
+        flann::Matrix<double> *ANodes = NULL;
+        flann::Index<flann::L2<double> > *ANodesTree = sharedSearchTree;
+        if (ANodesTree == NULL) {
+            ANodes = new flann::Matrix<double>(const_cast<double*>(nodesA), numNodesA, 3);
+            ANodesTree = new flann::Index<flann::L2<double> >(*ANodes,
+                    flann::KDTreeSingleIndexParams(1));
+            ANodesTree->buildIndex(); // Build binary tree for searching
+        }
 
-        for (int i = 0; i < numNodesB; i++) {
-            flann::Matrix<double> nodeI(&(nodesBCasted[i * 3]), 1, 3);
-            vector<vector<int> > indexes_tmp;
-            vector<vector<double> > dists_tmp;
-            ANodesTree->knnSearch(nodeI, indexes_tmp, dists_tmp, NUM_NEIGHBORS_TO_SEARCH,
-                    flann::SearchParams(1));
-
-            const double *p1 = &(nodesA[indexes_tmp[0][0] * 3]);
-            const double *p2 = &(nodesA[indexes_tmp[0][1] * 3]);
-            int p3Index = 2;
-            while (true) {
-                const double *p3 = &(nodesA[indexes_tmp[0][p3Index] * 3]);
-                if (areNotOnTheSameLine(p1, p2, p3)) {
-                    break;
-                }
-                p3Index++;
-                assert(p3Index != NUM_NEIGHBORS_TO_SEARCH);
-            }
+        // the nodes of B are agglomerated into clusters whose centers are searched first, every
+        // node then searches among the nodes of A close to its cluster only
+        MultilevelNeighborSearch search(numNodesA, nodesA, ANodesTree);
+        BarycentricNeighborVisitor visitor(nodesA, neighborsTable);
+        search.search(nodesB, rows, NUM_NEIGHBORS_TO_SEARCH,
+                AuxiliaryParameters::mapperSetNumThreads, visitor);
 
-            neighborsTable[i * 3 + 0] = indexes_tmp[0][0];
-            neighborsTable[i * 3 + 1] = indexes_tmp[0][1];
-            neighborsTable[i * 3 + 2] = indexes_tmp[0][p3Index];
+        if (ANodes != NULL) { // the tree is not shared
+            delete ANodes;
+            delete ANodesTree;
         }
-
-        delete ANodes;
-        delete ANodesTree;
 #endif
     }
 }
 
-void BarycentricInterpolationMapper::computeWeights() {
-    for (int i = 0; i < numNodesB; i++) { // i-th node in B
+void BarycentricInterpolationMapper::computeWeights(const vector<int> &rows) {
+    const int numRows = rows.size();
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads)
+    for (int r = 0; r < numRows; r++) {
+        int i = rows[r]; // i-th node in B
         const double *nodeI = &(nodesB[i * 3]);
         double triangle[9];
         for (int j = 0; j < 3; j++) { //j-th neighbor in A
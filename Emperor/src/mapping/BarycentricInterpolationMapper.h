@@ -30,7 +30,16 @@
 #include <string>
 #include "AbstractMapper.h"
 
+namespace flann {
+template<typename Distance> class Index;
+template<class T> struct L2;
+template<typename T> class Matrix;
+}
+
 namespace EMPIRE {
+namespace MathLibrary {
+class CSRMatrix;
+}
 /********//**
  * \brief Class BarycentricInterpolationMapper performs barycentric interpolation mapping
  ***********/
@@ -57,6 +66,79 @@ public:
      * \author Altug Emiroglu
      ***********/
     void buildCouplingMatrices();
+    /***********************************************************************************************
+     * \brief Use a searching tree owned by someone else, e.g. the spatial index of the mesh, instead
+     *        of building one. Must be called before buildCouplingMatrices
+     * \param[in] tree the FLANN searching tree over the nodes of A
+     ***********/
+    void setSharedSearchTree(flann::Index<flann::L2<double> > *tree);
+    /***********************************************************************************************
+     * \brief The rows can be updated after some nodes moved
+     * \return true
+     ***********/
+    bool isPartialGeometryUpdateSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Search the neighbors again and recompute the weights for the moved nodes of B, for the
+     *        nodes of B with a moved neighbor and for those to which a moved node of A came nearer
+     *        than their furthest neighbor
+     * \param[in] movedNodesA the positions of the moved nodes of A
+     * \param[in] movedNodesB the positions of the moved nodes of B
+     ***********/
+    void updateGeometry(const std::vector<int> &movedNodesA, const std::vector<int> &movedNodesB);
+    /***********************************************************************************************
+     * \brief Get the heap memory of the neighbors and the weights tables
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+    /***********************************************************************************************
+     * \brief The weights can be stored in single precision
+     * \return true
+     ***********/
+    bool isSinglePrecisionWeightsSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Store the weights of the coupling matrix in single precision
+     * \param[in] singlePrecision true for single precision
+     ***********/
+    void setSinglePrecisionWeights(bool singlePrecision) {
+        isSinglePrecisionWeights = singlePrecision;
+    }
+
+    /***********************************************************************************************
+     * \brief The coupling matrix is the mapping operator
+     * \return true
+     ***********/
+    bool isMappingOperatorExportSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Get a copy of the coupling matrix
+     ***********/
+    void getMappingOperator(std::vector<int> &rowPointers, std::vector<int> &columnIndices,
+            std::vector<double> &values) const;
+
+    /***********************************************************************************************
+     * \brief The coupling matrix can be built for one direction only
+     * \return true
+     ***********/
+    bool isMappingDirectionsSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Keep only the arrays of the products of the used directions in the coupling matrix
+     * \param[in] consistent whether consistent mapping is used
+     * \param[in] conservative whether conservative mapping is used
+     ***********/
+    void setMappingDirections(bool consistent, bool conservative) {
+        isConsistentMappingUsed = consistent;
+        isConservativeMappingUsed = conservative;
+    }
 
     /***********************************************************************************************
      * \brief Do consistent mapping on fields (e.g. displacements or tractions)
@@ -80,7 +162,47 @@ public:
      * \author Andreas Apostolatos
      ***********/
     void computeErrorsConsistentMapping(const double *fieldA, const double *fieldB);
+    /***********************************************************************************************
+     * \brief Block mapping is supported by this mapper
+     * \return true
+     ***********/
+    bool isBlockMappingSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Do consistent mapping on all components of interleaved fields at once
+     * \param[in] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[out] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void consistentBlockMapping(const double *fieldA, double *fieldB, int numComponents);
+    /***********************************************************************************************
+     * \brief Do conservative mapping on all components of interleaved integrated fields at once
+     * \param[in] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[out] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void conservativeBlockMapping(const double *fieldB, double *fieldA, int numComponents);
+    /***********************************************************************************************
+     * \brief Row blocks are mapped by the coupling matrix, if it is not distributed
+     ***********/
+    bool isRowBlockMappingSupported() const;
+    /***********************************************************************************************
+     * \brief Get the number of leading nodes of A the nodes of B before endNodeB interpolate from
+     ***********/
+    int getNumRequiredNodesA(int endNodeB) const;
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes firstNodeB to endNodeB-1 of B only
+     ***********/
+    void consistentRowBlockMapping(const double *fieldA, double *fieldB, int numComponents,
+            int firstNodeB, int endNodeB);
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes of B depending on a changed node of A only
+     ***********/
+    int consistentChangedRowsMapping(const double *fieldA, double *fieldB, int numComponents,
+            const char *isNodeAChanged);
 private:
+    friend class BarycentricNeighborVisitor;
     /// number of nodes of A
     int numNodesA;
     /// nodes of A
@@ -93,18 +215,34 @@ private:
     int *neighborsTable;
     /// weights of the neighbors
     double *weightsTable;
+    /// whether the weights of the coupling matrix are stored in single precision
+    bool isSinglePrecisionWeights;
+    /// whether consistent mapping is used
+    bool isConsistentMappingUsed;
+    /// whether conservative mapping is used
+    bool isConservativeMappingUsed;
+    /// the neighbors and weights as matrix B x A, analysed once for the mapping calls
+    MathLibrary::CSRMatrix *couplingMatrix;
+    /// searching tree over the nodes of A owned by someone else, NULL if the mapper builds its own
+    flann::Index<flann::L2<double> > *sharedSearchTree;
     /// number of neighbors to search (more than 3 is needed, because sometimes 3 nodes are on the same line)
     static const int MAX_NUM_NEIGHBORS_TO_SEARCH;
     /***********************************************************************************************
      * \brief Compute the neighbors
+     * \param[in] rows the nodes of B whose neighbors are computed
      * \author Tianyang Wang
      ***********/
-    void computeNeighbors();
+    void computeNeighbors(const std::vector<int> &rows);
     /***********************************************************************************************
      * \brief Compute the weights
+     * \param[in] rows the nodes of B whose weights are computed
      * \author Tianyang Wang
      ***********/
-    void computeWeights();
+    void computeWeights(const std::vector<int> &rows);
+    /***********************************************************************************************
+     * \brief Build the coupling matrix from the neighbors and weights tables
+     ***********/
+    void assembleCouplingMatrix();
     /***********************************************************************************************
      * \brief whether the three nodes are on the same line or not
      * \return true if not on the same line, otherwise, false
@@ -0,0 +1,452 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "CouplingMatricesCache.h"
+#include "MathLibrary.h"
+#include "BlockSparseMatrix.h"
+#include "AbstractMesh.h"
+#include "FEMesh.h"
+#include "IGAMesh.h"
+#include "IGAPatchSurface.h"
+#include "IGAPatchSurfaceTrimming.h"
+#include "WeakIGADirichletCurveCondition.h"
+#include "WeakIGADirichletSurfaceCondition.h"
+#include "WeakIGAPatchContinuityCondition.h"
+#include "Message.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <assert.h>
+#include <stdio.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+
+using namespace std;
+
+namespace EMPIRE {
+
+/// magic number at the beginning of every cache file
+static const char MAGIC[8] = { 'E', 'M', 'P', 'I', 'R', 'E', 'C', 'M' };
+/// version of the file layout
+static const int32_t VERSION = 1;
+/// FNV-1a offset basis
+static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+/// FNV-1a prime
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+/***********************************************************************************************
+ * \brief Write a value in binary
+ ***********/
+template<class T>
+static void writeValue(ofstream &file, T value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+/***********************************************************************************************
+ * \brief Write an array in binary, preceded by nothing
+ ***********/
+template<class T>
+static void writeArray(ofstream &file, const vector<T> &values) {
+    if (!values.empty())
+        file.write(reinterpret_cast<const char*>(&values[0]), values.size() * sizeof(T));
+}
+/***********************************************************************************************
+ * \brief Write a string in binary, preceded by its length
+ ***********/
+static void writeString(ofstream &file, const string &value) {
+    writeValue<int32_t>(file, value.size());
+    file.write(value.c_str(), value.size());
+}
+/***********************************************************************************************
+ * \brief Read a value in binary
+ * \return false if the file ends before
+ ***********/
+template<class T>
+static bool readValue(ifstream &file, T &value) {
+    file.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return file.good();
+}
+/***********************************************************************************************
+ * \brief Read an array of known size in binary
+ * \return false if the file ends before
+ ***********/
+template<class T>
+static bool readArray(ifstream &file, int64_t size, vector<T> &values) {
+    if (size < 0)
+        return false;
+    values.resize(size);
+    if (size > 0)
+        file.read(reinterpret_cast<char*>(&values[0]), size * sizeof(T));
+    return file.good();
+}
+/***********************************************************************************************
+ * \brief Read a string in binary, preceded by its length
+ * \return false if the file ends before
+ ***********/
+static bool readString(ifstream &file, string &value) {
+    int32_t length;
+    vector<char> chars;
+    if (!readValue(file, length) || !readArray(file, length, chars))
+        return false;
+    value.assign(chars.begin(), chars.end());
+    return true;
+}
+
+CouplingMatricesCache::CouplingMatricesCache(std::string _directory, std::string _mapperName) :
+        directory(_directory), mapperName(_mapperName), key(FNV_OFFSET_BASIS) {
+    assert(directory.size() > 0);
+}
+
+CouplingMatricesCache::~CouplingMatricesCache() {
+}
+
+void CouplingMatricesCache::addToKey(const void *data, size_t numBytes) {
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < numBytes; i++) {
+        key ^= bytes[i];
+        key *= FNV_PRIME;
+    }
+}
+
+void CouplingMatricesCache::addToKey(int value) {
+    addToKey(&value, sizeof(value));
+}
+
+void CouplingMatricesCache::addToKey(double value) {
+    addToKey(&value, sizeof(value));
+}
+
+void CouplingMatricesCache::addToKey(bool value) {
+    addToKey((int) value);
+}
+
+void CouplingMatricesCache::addToKey(const std::string &value) {
+    addToKey((int) value.size());
+    addToKey(value.c_str(), value.size());
+}
+
+void CouplingMatricesCache::addMeshToKey(AbstractMesh *mesh) {
+    uint64_t contentHash = mesh->getContentHash();
+    addToKey(&contentHash, sizeof(contentHash));
+}
+
+uint64_t CouplingMatricesCache::hashMeshContent(AbstractMesh *mesh) {
+    // the cache only computes the key, it is neither loaded nor saved
+    CouplingMatricesCache hash(".", "");
+    hash.addToKey((int) mesh->type);
+    if (mesh->type == EMPIRE_Mesh_FEMesh || mesh->type == EMPIRE_Mesh_SectionMesh)
+        hash.addFEMeshToKey(dynamic_cast<FEMesh *>(mesh));
+    else if (mesh->type == EMPIRE_Mesh_IGAMesh)
+        hash.addIGAMeshToKey(dynamic_cast<IGAMesh *>(mesh));
+    else
+        assert(false);
+    return hash.getKey();
+}
+
+void CouplingMatricesCache::addFEMeshToKey(const FEMesh *mesh) {
+    addToKey(mesh->numNodes);
+    addToKey(mesh->numElems);
+    addToKey(mesh->nodes, mesh->numNodes * 3 * sizeof(double));
+    addToKey(mesh->nodeIDs, mesh->numNodes * sizeof(int));
+    addToKey(mesh->numNodesPerElem, mesh->numElems * sizeof(int));
+    addToKey(mesh->elems, mesh->elemsArraySize * sizeof(int));
+}
+
+void CouplingMatricesCache::addIGAMeshToKey(const IGAMesh *mesh) {
+    addToKey(mesh->getNumNodes());
+    addToKey(mesh->getNumPatches());
+    for (int p = 0; p < mesh->getNumPatches(); p++) {
+        const IGAPatchSurface *patch = mesh->getSurfacePatch(p);
+        for (int uv = 0; uv < 2; uv++) {
+            const BSplineBasis1D *basis = patch->getIGABasis(uv);
+            addToKey(basis->getPolynomialDegree());
+            addToKey(basis->getNoKnots());
+            addToKey(basis->getKnotVector(), basis->getNoKnots() * sizeof(double));
+        }
+        addToKey(patch->getNoControlPoints());
+        for (int i = 0; i < patch->getNoControlPoints(); i++) {
+            addToKey((*patch)[i]->getX());
+            addToKey((*patch)[i]->getY());
+            addToKey((*patch)[i]->getZ());
+            addToKey((*patch)[i]->getW());
+            addToKey((*patch)[i]->getDofIndex());
+        }
+        addToKey(patch->isTrimmed());
+        if (patch->isTrimmed()) {
+            const IGAPatchSurfaceTrimming &trimming = patch->getTrimming();
+            addToKey(trimming.getNumOfLoops());
+            for (int i = 0; i < trimming.getNumOfLoops(); i++) {
+                const vector<double> &polylines = trimming.getLoop(i).getPolylines();
+                addToKey((int) polylines.size());
+                if (!polylines.empty())
+                    addToKey(&polylines[0], polylines.size() * sizeof(double));
+            }
+        }
+    }
+
+    // the weak conditions are identified by their patches and their Gauss points
+    vector<WeakIGADirichletCurveCondition*> curveConditions = mesh->getWeakIGADirichletCurveConditions();
+    addToKey((int) curveConditions.size());
+    for (int i = 0; i < curveConditions.size(); i++) {
+        const WeakIGADirichletCurveCondition *condition = curveConditions[i];
+        addToKey(condition->getPatchIndex());
+        addToKey(condition->getPatchBLIndex());
+        addToKey(condition->getPatchBLTrCurveIndex());
+        addToKey(condition->getCurveNumGP());
+        if (condition->getCurveGPWeights() != NULL)
+            addToKey(condition->getCurveGPWeights(), condition->getCurveNumGP() * sizeof(double));
+        if (condition->getCurveGPJacobianProducts() != NULL)
+            addToKey(condition->getCurveGPJacobianProducts(),
+                    condition->getCurveNumGP() * sizeof(double));
+    }
+    vector<WeakIGADirichletSurfaceCondition*> surfaceConditions = mesh->getWeakIGADirichletSurfaceConditions();
+    addToKey((int) surfaceConditions.size());
+    for (int i = 0; i < surfaceConditions.size(); i++) {
+        const WeakIGADirichletSurfaceCondition *condition = surfaceConditions[i];
+        addToKey(condition->getPatchIndex());
+        addToKey(condition->getSurfaceNumGP());
+        if (condition->getSurfaceGPWeights() != NULL)
+            addToKey(condition->getSurfaceGPWeights(), condition->getSurfaceNumGP() * sizeof(double));
+        if (condition->getSurfaceGPJacobians() != NULL)
+            addToKey(condition->getSurfaceGPJacobians(), condition->getSurfaceNumGP() * sizeof(double));
+    }
+    vector<WeakIGAPatchContinuityCondition*> continuityConditions = mesh->getWeakIGAPatchContinuityConditions();
+    addToKey((int) continuityConditions.size());
+    for (int i = 0; i < continuityConditions.size(); i++) {
+        const WeakIGAPatchContinuityCondition *condition = continuityConditions[i];
+        addToKey(condition->getMasterPatchIndex());
+        addToKey(condition->getSlavePatchIndex());
+        addToKey(condition->getMasterPatchBLIndex());
+        addToKey(condition->getSlavePatchBLIndex());
+        addToKey(condition->getMasterPatchBLTrCurveIndex());
+        addToKey(condition->getSlavePatchBLTrCurveIndex());
+        addToKey(condition->getTrCurveNumGP());
+        if (condition->getTrCurveGPWeights() != NULL)
+            addToKey(condition->getTrCurveGPWeights(), condition->getTrCurveNumGP() * sizeof(double));
+        if (condition->getTrCurveGPJacobianProducts() != NULL)
+            addToKey(condition->getTrCurveGPJacobianProducts(),
+                    condition->getTrCurveNumGP() * sizeof(double));
+    }
+}
+
+std::string CouplingMatricesCache::getFileName() const {
+    stringstream fileName;
+    fileName << directory << "/" << mapperName << "_" << hex << setw(16) << setfill('0') << key
+            << ".couplingMatrices";
+    return fileName.str();
+}
+
+std::string CouplingMatricesCache::findFileOfOtherMapper() const {
+    stringstream suffix;
+    suffix << "_" << hex << setw(16) << setfill('0') << key << ".couplingMatrices";
+    string fileName;
+    DIR *dir = opendir(directory.c_str());
+    if (dir == NULL)
+        return fileName;
+    for (struct dirent *entry = readdir(dir); entry != NULL; entry = readdir(dir)) {
+        string entryName(entry->d_name);
+        if (entryName.size() > suffix.str().size()
+                && entryName.compare(entryName.size() - suffix.str().size(), string::npos, suffix.str()) == 0) {
+            fileName = directory + "/" + entryName;
+            break;
+        }
+    }
+    closedir(dir);
+    return fileName;
+}
+
+bool CouplingMatricesCache::load() {
+    matrices.clear();
+    vectors.clear();
+    string fileName = getFileName();
+    if (!ifstream(fileName.c_str(), ios::in | ios::binary)) {
+        // the key does not contain the name, so another mapper may have written the same matrices
+        fileName = findFileOfOtherMapper();
+        if (fileName.empty() || !ifstream(fileName.c_str(), ios::in | ios::binary))
+            return false;
+        INFO_OUT() << "CouplingMatricesCache: mapper \"" << mapperName
+                << "\" reuses the coupling matrices in \"" << fileName << "\"" << endl;
+    }
+    return loadFile(fileName);
+}
+
+bool CouplingMatricesCache::loadFile(const std::string &fileName) {
+    matrices.clear();
+    vectors.clear();
+    ifstream file(fileName.c_str(), ios::in | ios::binary);
+    if (!file)
+        return false;
+
+    char magic[8];
+    int32_t version;
+    uint64_t keyInFile;
+    int32_t numMatrices, numVectors;
+    file.read(magic, sizeof(magic));
+    bool valid = file.good() && equal(magic, magic + sizeof(magic), MAGIC);
+    valid = valid && readValue(file, version) && version == VERSION;
+    valid = valid && readValue(file, keyInFile) && keyInFile == key;
+    valid = valid && readValue(file, numMatrices) && readValue(file, numVectors);
+    for (int i = 0; valid && i < numMatrices; i++) {
+        string matrixName;
+        structMatrix matrix;
+        int32_t isSymmetric;
+        int64_t numEntries;
+        valid = readString(file, matrixName) && readValue(file, matrix.numRows)
+                && readValue(file, matrix.numColumns) && readValue(file, isSymmetric)
+                && readValue(file, numEntries) && readArray(file, matrix.numRows + 1, matrix.rowPtr)
+                && readArray(file, numEntries, matrix.cols) && readArray(file, numEntries, matrix.vals);
+        valid = valid && matrix.rowPtr[0] == 0 && matrix.rowPtr[matrix.numRows] == numEntries;
+        for (int64_t k = 0; valid && k < numEntries; k++)
+            valid = (matrix.cols[k] >= 0 && matrix.cols[k] < matrix.numColumns);
+        for (int64_t r = 0; valid && r < matrix.numRows; r++)
+            valid = (matrix.rowPtr[r] <= matrix.rowPtr[r + 1]);
+        matrix.isSymmetric = (isSymmetric != 0);
+        if (valid)
+            matrices[matrixName] = matrix;
+    }
+    for (int i = 0; valid && i < numVectors; i++) {
+        string vectorName;
+        int64_t size;
+        valid = readString(file, vectorName) && readValue(file, size)
+                && readArray(file, size, vectors[vectorName]);
+    }
+
+    if (!valid) {
+        WARNING_OUT() << "CouplingMatricesCache: the file \"" << fileName
+                << "\" is not a valid cache file and is ignored" << endl;
+        matrices.clear();
+        vectors.clear();
+        return false;
+    }
+    return true;
+}
+
+void CouplingMatricesCache::save() const {
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+        WARNING_OUT() << "CouplingMatricesCache: the directory \"" << directory
+                << "\" cannot be created, the coupling matrices are not cached" << endl;
+        return;
+    }
+    string fileName = getFileName();
+    if (!saveFile(fileName)) {
+        WARNING_OUT() << "CouplingMatricesCache: the coupling matrices of mapper \"" << mapperName
+                << "\" are not cached" << endl;
+        return;
+    }
+    INFO_OUT() << "CouplingMatricesCache: coupling matrices of mapper \"" << mapperName
+            << "\" written to \"" << fileName << "\"" << endl;
+}
+
+bool CouplingMatricesCache::saveFile(const std::string &fileName) const {
+    // write to a temporary file first, so that an aborted run does not leave a truncated file
+    string tmpFileName = fileName + ".tmp";
+    {
+        ofstream file(tmpFileName.c_str(), ios::out | ios::binary | ios::trunc);
+        file.write(MAGIC, sizeof(MAGIC));
+        writeValue<int32_t>(file, VERSION);
+        writeValue<uint64_t>(file, key);
+        writeValue<int32_t>(file, matrices.size());
+        writeValue<int32_t>(file, vectors.size());
+        for (map<string, structMatrix>::const_iterator it = matrices.begin(); it != matrices.end();
+                it++) {
+            const structMatrix &matrix = it->second;
+            writeString(file, it->first);
+            writeValue<int64_t>(file, matrix.numRows);
+            writeValue<int64_t>(file, matrix.numColumns);
+            writeValue<int32_t>(file, matrix.isSymmetric);
+            writeValue<int64_t>(file, matrix.vals.size());
+            writeArray(file, matrix.rowPtr);
+            writeArray(file, matrix.cols);
+            writeArray(file, matrix.vals);
+        }
+        for (map<string, vector<double> >::const_iterator it = vectors.begin();
+                it != vectors.end(); it++) {
+            writeString(file, it->first);
+            writeValue<int64_t>(file, it->second.size());
+            writeArray(file, it->second);
+        }
+        if (!file.good()) {
+            WARNING_OUT() << "CouplingMatricesCache: writing \"" << tmpFileName << "\" failed" << endl;
+            file.close();
+            remove(tmpFileName.c_str());
+            return false;
+        }
+    }
+    if (rename(tmpFileName.c_str(), fileName.c_str()) != 0) {
+        WARNING_OUT() << "CouplingMatricesCache: \"" << fileName << "\" cannot be written" << endl;
+        remove(tmpFileName.c_str());
+        return false;
+    }
+    return true;
+}
+
+void CouplingMatricesCache::setMatrix(const std::string &matrixName,
+        MathLibrary::SparseMatrix<double> *matrix) {
+    structMatrix &cachedMatrix = matrices[matrixName];
+    cachedMatrix.numRows = matrix->getNumberOfRows();
+    cachedMatrix.numColumns = matrix->getNumberOfColumns();
+    cachedMatrix.isSymmetric = matrix->getIsSymmetric();
+    matrix->getCSR(cachedMatrix.rowPtr, cachedMatrix.cols, cachedMatrix.vals);
+}
+
+void CouplingMatricesCache::setMatrix(const std::string &matrixName,
+        const MathLibrary::BlockSparseMatrix *matrix) {
+    structMatrix &cachedMatrix = matrices[matrixName];
+    cachedMatrix.numRows = MathLibrary::BlockSparseMatrix::BLOCK_SIZE * matrix->getNumBlockRows();
+    cachedMatrix.numColumns = MathLibrary::BlockSparseMatrix::BLOCK_SIZE * matrix->getNumBlockCols();
+    cachedMatrix.isSymmetric = false;
+    matrix->getCSR(cachedMatrix.rowPtr, cachedMatrix.cols, cachedMatrix.vals);
+}
+
+bool CouplingMatricesCache::hasMatrix(const std::string &matrixName,
+        MathLibrary::SparseMatrix<double> *matrix) const {
+    map<string, structMatrix>::const_iterator it = matrices.find(matrixName);
+    if (it == matrices.end())
+        return false;
+    return it->second.numRows == (int64_t) matrix->getNumberOfRows()
+            && it->second.numColumns == (int64_t) matrix->getNumberOfColumns()
+            && it->second.isSymmetric == matrix->getIsSymmetric();
+}
+
+void CouplingMatricesCache::getMatrix(const std::string &matrixName,
+        MathLibrary::SparseMatrix<double> *matrix) const {
+    assert(hasMatrix(matrixName, matrix));
+    const structMatrix &cachedMatrix = matrices.at(matrixName);
+    matrix->setCSR(cachedMatrix.rowPtr, cachedMatrix.cols, cachedMatrix.vals);
+}
+
+void CouplingMatricesCache::setVector(const std::string &vectorName, const double *data,
+        size_t size) {
+    vectors[vectorName].assign(data, data + size);
+}
+
+bool CouplingMatricesCache::getVector(const std::string &vectorName, size_t size,
+        double *data) const {
+    map<string, vector<double> >::const_iterator it = vectors.find(vectorName);
+    if (it == vectors.end() || it->second.size() != size)
+        return false;
+    for (size_t i = 0; i < size; i++)
+        data[i] = it->second[i];
+    return true;
+}
+
+} /* namespace EMPIRE */
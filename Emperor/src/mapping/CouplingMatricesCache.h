@@ -0,0 +1,218 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file CouplingMatricesCache.h
+ * This file holds the class CouplingMatricesCache
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef COUPLINGMATRICESCACHE_H_
+#define COUPLINGMATRICESCACHE_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace EMPIRE {
+
+namespace MathLibrary {
+template<class T> class SparseMatrix;
+class BlockSparseMatrix;
+}
+class AbstractMesh;
+class FEMesh;
+class IGAMesh;
+
+/********//**
+ * \brief Class CouplingMatricesCache stores the coupling matrices of a mapper in a file, so that a
+ *        restarted simulation with the same meshes and mapper parameters reads them instead of
+ *        building them again. The file is identified by a hash (key) of the meshes and parameters.
+ *        Only the entries of the matrices are stored, the factorization is redone by the solver.
+ ***********/
+class CouplingMatricesCache {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _directory the directory of the cache files, it is created if it does not exist
+     * \param[in] _mapperName name of the mapper
+     ***********/
+    CouplingMatricesCache(std::string _directory, std::string _mapperName);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~CouplingMatricesCache();
+    /***********************************************************************************************
+     * \brief Add raw bytes to the key
+     * \param[in] data the bytes
+     * \param[in] numBytes number of bytes
+     ***********/
+    void addToKey(const void *data, size_t numBytes);
+    /***********************************************************************************************
+     * \brief Add a parameter to the key
+     * \param[in] value the parameter
+     ***********/
+    void addToKey(int value);
+    /***********************************************************************************************
+     * \brief Add a parameter to the key
+     * \param[in] value the parameter
+     ***********/
+    void addToKey(double value);
+    /***********************************************************************************************
+     * \brief Add a parameter to the key
+     * \param[in] value the parameter
+     ***********/
+    void addToKey(bool value);
+    /***********************************************************************************************
+     * \brief Add a parameter to the key
+     * \param[in] value the parameter
+     ***********/
+    void addToKey(const std::string &value);
+    /***********************************************************************************************
+     * \brief Add a FE mesh or an IGA mesh to the key by its content hash, which the mesh computes
+     *        once, see AbstractMesh::getContentHash
+     * \param[in] mesh the mesh
+     ***********/
+    void addMeshToKey(AbstractMesh *mesh);
+    /***********************************************************************************************
+     * \brief Hash the type and the content of a FE mesh or an IGA mesh
+     * \param[in] mesh the mesh
+     * \return the hash
+     ***********/
+    static uint64_t hashMeshContent(AbstractMesh *mesh);
+    /***********************************************************************************************
+     * \brief Get the hash of everything added to the key, e.g. to identify meshes and mapper
+     *        settings without a cache file
+     * \return the key
+     ***********/
+    uint64_t getKey() const {
+        return key;
+    }
+    /***********************************************************************************************
+     * \brief Get the name of the cache file, it contains the key
+     * \return the file name
+     ***********/
+    std::string getFileName() const;
+    /***********************************************************************************************
+     * \brief Find the cache file of the current key written by another mapper, e.g. the mapper of
+     *        another design with the same meshes and parameters
+     * \return the file name, empty if there is none
+     ***********/
+    std::string findFileOfOtherMapper() const;
+    /***********************************************************************************************
+     * \brief Read the cache file of the current key, or the one of another mapper with the same key
+     * \return true if the file exists and is valid
+     ***********/
+    bool load();
+    /***********************************************************************************************
+     * \brief Read a file written by saveFile, e.g. the saved mapper of another process
+     * \param[in] fileName the file
+     * \return true if the file exists, is valid and was written with the current key
+     ***********/
+    bool loadFile(const std::string &fileName);
+    /***********************************************************************************************
+     * \brief Write all stored matrices and vectors to the cache file of the current key
+     ***********/
+    void save() const;
+    /***********************************************************************************************
+     * \brief Write all stored matrices and vectors and the current key to the given file
+     * \param[in] fileName the file, it is replaced at once after it has been written completely
+     * \return true if the file is written
+     ***********/
+    bool saveFile(const std::string &fileName) const;
+    /***********************************************************************************************
+     * \brief Store a matrix in the cache
+     * \param[in] matrixName name of the matrix
+     * \param[in] matrix the matrix
+     ***********/
+    void setMatrix(const std::string &matrixName, MathLibrary::SparseMatrix<double> *matrix);
+    /***********************************************************************************************
+     * \brief Store a matrix of 3x3 blocks in the cache as unsymmetric scalar matrix, so that it can
+     *        be read into a SparseMatrix
+     * \param[in] matrixName name of the matrix
+     * \param[in] matrix the matrix
+     ***********/
+    void setMatrix(const std::string &matrixName, const MathLibrary::BlockSparseMatrix *matrix);
+    /***********************************************************************************************
+     * \brief Whether the cache holds a matrix of the given name and size
+     * \param[in] matrixName name of the matrix
+     * \param[in] matrix an empty matrix of the expected size and symmetry
+     * \return true if found
+     ***********/
+    bool hasMatrix(const std::string &matrixName, MathLibrary::SparseMatrix<double> *matrix) const;
+    /***********************************************************************************************
+     * \brief Fill an empty matrix with the entries in the cache and freeze it
+     * \param[in] matrixName name of the matrix, hasMatrix must be true
+     * \param[out] matrix the matrix
+     ***********/
+    void getMatrix(const std::string &matrixName, MathLibrary::SparseMatrix<double> *matrix) const;
+    /***********************************************************************************************
+     * \brief Store a vector in the cache
+     * \param[in] vectorName name of the vector
+     * \param[in] data the entries
+     * \param[in] size number of entries
+     ***********/
+    void setVector(const std::string &vectorName, const double *data, size_t size);
+    /***********************************************************************************************
+     * \brief Get a vector from the cache
+     * \param[in] vectorName name of the vector
+     * \param[in] size expected number of entries
+     * \param[out] data the entries
+     * \return true if a vector of the given name and size is found
+     ***********/
+    bool getVector(const std::string &vectorName, size_t size, double *data) const;
+
+private:
+    /// a matrix in zero-based CSR format
+    struct structMatrix {
+        int64_t numRows;
+        int64_t numColumns;
+        bool isSymmetric;
+        std::vector<int> rowPtr;
+        std::vector<int> cols;
+        std::vector<double> vals;
+    };
+    /// directory of the cache files
+    std::string directory;
+    /// name of the mapper
+    std::string mapperName;
+    /// hash of everything that is added to the key
+    uint64_t key;
+    /// the matrices by name
+    std::map<std::string, structMatrix> matrices;
+    /// the vectors by name
+    std::map<std::string, std::vector<double> > vectors;
+    /***********************************************************************************************
+     * \brief Add the nodes and elements of a FE mesh to the key
+     ***********/
+    void addFEMeshToKey(const FEMesh *mesh);
+    /***********************************************************************************************
+     * \brief Add the patches, trimming loops and weak conditions of an IGA mesh to the key
+     ***********/
+    void addIGAMeshToKey(const IGAMesh *mesh);
+    /// disallow copy constructor
+    CouplingMatricesCache(const CouplingMatricesCache&);
+    /// disallow assignment operator
+    CouplingMatricesCache& operator=(const CouplingMatricesCache&);
+};
+
+} /* namespace EMPIRE */
+#endif /* COUPLINGMATRICESCACHE_H_ */
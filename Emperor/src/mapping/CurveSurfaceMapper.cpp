@@ -1,8 +1,10 @@
 #include "CurveSurfaceMapper.h"
 #include "KinematicMotion.h"
 #include "Message.h"
+#include "IDToIndexMap.h"
 #include <assert.h>
-#include <map>
+#include <vector>
+#include <algorithm>
 #include <iostream>
 #include <math.h>
 #include <stdlib.h>
@@ -10,6 +12,78 @@
 using namespace std;
 
 namespace EMPIRE {
+// set default value for mapper threads
+int CurveSurfaceMapper::mapperSetNumThreads = 1;
+/// fewer nodes are sorted by one thread, the merges would cost more than they save
+static const int MIN_NUM_NODES_PER_SORT_BLOCK = 10000;
+
+/***********************************************************************************************
+ * \brief Move the nodes of a section by x = R*x + T and store their displacements
+ * \param[in] A the motion as row major 3x4 matrix [R|T], see KinematicMotion::getAffineMatrix()
+ * \param[in] numNodes the number of nodes of the section
+ * \param[in] nodes the positions of the nodes in the surface node array
+ * \param[in] coors the coordinates of the nodes, first all x, then all y, then all z
+ * \param[out] surfaceDisp the displacements of all surface nodes
+ ***********/
+static void moveSectionNodes(const double *A, int numNodes, const int *nodes, const double *coors,
+        double *surfaceDisp) {
+    const double *x = coors;
+    const double *y = coors + numNodes;
+    const double *z = coors + 2 * numNodes;
+    // the displacement is (R - I) * x + T
+#pragma omp simd
+    for (int j = 0; j < numNodes; j++) {
+        double *disp = &surfaceDisp[nodes[j] * 3];
+        disp[0] = (A[0] - 1.0) * x[j] + A[1] * y[j] + A[2] * z[j] + A[3];
+        disp[1] = A[4] * x[j] + (A[5] - 1.0) * y[j] + A[6] * z[j] + A[7];
+        disp[2] = A[8] * x[j] + A[9] * y[j] + (A[10] - 1.0) * z[j] + A[11];
+    }
+}
+
+/***********************************************************************************************
+ * \brief Orders the nodes by their x coordinate and nodes of equal x by their position
+ ***********/
+struct CompareNodesByX {
+    /// the coordinates of the nodes
+    const double *coors;
+    bool operator()(int a, int b) const {
+        return coors[a * 3] < coors[b * 3] || (coors[a * 3] == coors[b * 3] && a < b);
+    }
+};
+
+/***********************************************************************************************
+ * \brief Sort the positions of the nodes by their x coordinate. Every thread sorts a block of the
+ *        positions, the sorted blocks are then merged pairwise in parallel
+ * \param[in] coors the coordinates of the nodes
+ * \param[in] numNodes the number of nodes
+ * \param[out] order the positions of the nodes in ascending x
+ * \param[in] numThreads the number of threads
+ ***********/
+static void sortNodesByX(const double *coors, int numNodes, int *order, int numThreads) {
+    CompareNodesByX compare;
+    compare.coors = coors;
+    for (int i = 0; i < numNodes; i++)
+        order[i] = i;
+    int numBlocks = max(1, min(numThreads, numNodes / MIN_NUM_NODES_PER_SORT_BLOCK));
+    vector<int> blockBegins(numBlocks + 1);
+    for (int b = 0; b <= numBlocks; b++)
+        blockBegins[b] = (long) numNodes * b / numBlocks;
+#pragma omp parallel for num_threads(numBlocks) schedule(static, 1)
+    for (int b = 0; b < numBlocks; b++)
+        sort(order + blockBegins[b], order + blockBegins[b + 1], compare);
+    for (int width = 1; width < numBlocks; width *= 2) {
+        int numMerges = (numBlocks + 2 * width - 1) / (2 * width);
+#pragma omp parallel for num_threads(numMerges) schedule(static, 1)
+        for (int m = 0; m < numMerges; m++) {
+            int first = m * 2 * width;
+            int middle = min(first + width, numBlocks);
+            int last = min(first + 2 * width, numBlocks);
+            if (middle < last)
+                inplace_merge(order + blockBegins[first], order + blockBegins[middle],
+                        order + blockBegins[last], compare);
+        }
+    }
+}
 
 CurveSurfaceMapper::CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type _type, int _curveNumNodes,
         int _curveNumElements, const double *_curveNodeCoors, const int *_curveNodeIDs,
@@ -25,115 +99,140 @@ CurveSurfaceMapper::CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type _type, int
 
     mapperType = EMPIRE_CurveSurfaceMapper;
 
-    /*
-     * Coordinate systems:
-     *   O --- global
-     *   Q --- beam root, origin is an arbitrary point in the root section
-     *   P --- origin is the cross point of the section with the beam element, orientation is the same as the global system
-     */
     // construct KM_O_Q
     KM_O_Q = new KinematicMotion();
     KM_O_Q->addRotation(rotation_O_Q);
     KM_O_Q->addTranslation(translation_O_Q);
 
-    // surface node coordinates in Q
-    double *surfaceNodeCoorsInQ = new double[surfaceNumNodes * 3];
-    for (int i = 0; i < surfaceNumNodes * 3; i++)
-        surfaceNodeCoorsInQ[i] = surfaceNodeCoors[i];
-    KinematicMotion *KM_Q_O = KM_O_Q->newInverse();
-    for (int i = 0; i < surfaceNumNodes; i++) {
-        KM_Q_O->move(&surfaceNodeCoorsInQ[i * 3]);
-    }
-
     // check number of surface nodes
     assert(
             surfaceNumNodes
                     == surfaceNumRootSectionNodes + surfaceNumTipSectionNodes
                             + (surfaceNumSections - 2) * surfaceNumNormalSectionNodes);
 
-    // sort surface nodes according to x in Q system
+    // map curve node ID to curve node position
+    curveNodeIDToPos = new IDToIndexMap(curveNumNodes, _curveNodeIDs);
+
     sortedPosToUnsortedPos = new int[surfaceNumNodes];
+    curveNodeCoorsInQ = new double[curveNumNodes * 3];
+    sectionP = new double[surfaceNumSections * 3]; // cross point between section and beam
+    sectionToCurveElem = new int[surfaceNumSections];
+    shapeFuncOfSection = new double[10 * surfaceNumSections];
+    // transformation from local beam to the global system
+    ROT_O_ELEM = new KinematicMotion*[curveNumElements];
+    for (int i = 0; i < curveNumElements; i++)
+        ROT_O_ELEM[i] = NULL;
+    // initialize section rotation for conservative mapping
+    sectionRot = new double[surfaceNumSections * 3];
+    sectionNodesBegin = new int[surfaceNumSections + 1];
+    sectionNodes = new int[surfaceNumNodes];
+    sectionNodeCoors = new double[surfaceNumNodes * 3];
 
-    multimap<double, int> *mapCoorX2Pos = new multimap<double, int>; // sort by x coordinate
-    for (int i = 0; i < surfaceNumNodes; i++) {
-        mapCoorX2Pos->insert(pair<double, int>(surfaceNodeCoorsInQ[i * 3 + 0], i));
+    // special initialization for different algorithms
+    if (type == EMPIRE_CurveSurfaceMapper_linear) {
+        curveElemLength = new double[curveNumElements];
+    } else if (type == EMPIRE_CurveSurfaceMapper_corotate2D) {
+        // construct KM_O_Q
+        const double EPS = 1E-10;
+        for (int i = 0; i < 9; i++) {
+            double tmp = fabs(rotation_O_Q[i]);
+            if (tmp > 0.5)
+                assert(fabs(tmp - 1.0) < EPS); // should be 1
+            else
+                assert(fabs(tmp - 0.0) < EPS); // should be 0
+        }
+        // transformation from local beam to Q
+        ROT_Q_ELEM = new KinematicMotion*[curveNumElements];
+        for (int i = 0; i < curveNumElements; i++)
+            ROT_Q_ELEM[i] = NULL;
+        // rotation angle from local beam to Q
+        angle_Q_ELEM = new double[curveNumElements];
+    } else if (type == EMPIRE_CurveSurfaceMapper_corotate3D) {
+        // do nothing
+    } else {
+        assert(false);
     }
 
-    int count = 0;
-    for (multimap<double, int>::iterator it = mapCoorX2Pos->begin(); it != mapCoorX2Pos->end();
-            it++) {
-        sortedPosToUnsortedPos[count] = it->second;
-        count++;
-    }
-    
-    delete mapCoorX2Pos;
-    
-    // curve node coordinates in Q
-    curveNodeCoorsInQ = new double[curveNumNodes * 3];
-    for (int i = 0; i < curveNumNodes * 3; i++)
-        curveNodeCoorsInQ[i] = curveNodeCoors[i];
-    for (int i = 0; i < curveNumNodes; i++) {
-        KM_Q_O->move(&curveNodeCoorsInQ[i * 3]);
-    }
+    buildSections();
+}
 
-    // map curve node ID to curve node position
-    curveNodeIDToPos = new map<int, int>;
-    for (int i = 0; i < curveNumNodes; i++) {
-        curveNodeIDToPos->insert(pair<int, int>(_curveNodeIDs[i], i));
-    }
+void CurveSurfaceMapper::buildSections() {
+    /*
+     * Coordinate systems:
+     *   O --- global
+     *   Q --- beam root, origin is an arbitrary point in the root section
+     *   P --- origin is the cross point of the section with the beam element, orientation is the same as the global system
+     */
+    KinematicMotion *KM_Q_O = KM_O_Q->newInverse();
+
+    // surface node coordinates in Q
+    double *surfaceNodeCoorsInQ = new double[surfaceNumNodes * 3];
+    KM_Q_O->moveBatch(surfaceNodeCoors, surfaceNodeCoorsInQ, surfaceNumNodes,
+            mapperSetNumThreads);
+
+    // sort surface nodes according to x in Q system
+    sortNodesByX(surfaceNodeCoorsInQ, surfaceNumNodes, sortedPosToUnsortedPos,
+            mapperSetNumThreads);
 
-    // map the x coordinate of the right node to an element
-    map<double, int> *rightXToElemPos = new map<double, int>;
+    // curve node coordinates in Q
+    KM_Q_O->moveBatch(curveNodeCoors, curveNodeCoorsInQ, curveNumNodes, mapperSetNumThreads);
+    delete KM_Q_O;
 
+    // the x coordinates of the right nodes of the elements in ascending order, an element whose
+    // right x equals the one of an element before it is skipped
+    vector<pair<double, int> > rightXOfElems(curveNumElements);
     for (int i = 0; i < curveNumElements; i++) {
         int leftID = curveElems[i * 2 + 0];
         int rightID = curveElems[i * 2 + 1];
         double leftX = curveNodeCoorsInQ[curveNodeIDToPos->at(leftID) * 3 + 0];
         double rightX = curveNodeCoorsInQ[curveNodeIDToPos->at(rightID) * 3 + 0];
-
-        if (leftX > rightX) {
-            rightX = leftX;
-        }
-        rightXToElemPos->insert(pair<double, int>(rightX, i));
+        rightXOfElems[i] = make_pair(max(leftX, rightX), i);
+    }
+    sort(rightXOfElems.begin(), rightXOfElems.end());
+    vector<double> rightX;
+    vector<int> rightXElemPos;
+    for (int k = 0; k < curveNumElements; k++) {
+        if (k > 0 && rightXOfElems[k].first == rightXOfElems[k - 1].first)
+            continue;
+        rightX.push_back(rightXOfElems[k].first);
+        rightXElemPos.push_back(rightXOfElems[k].second);
     }
 
-    // relate a section to a curve element: section center P, shape function + derivative, section to curve element
-    sectionP = new double[surfaceNumSections * 3]; // cross point between section and beam
-    sectionToCurveElem = new int[surfaceNumSections];
-    shapeFuncOfSection = new double[10 * surfaceNumSections];
+    // the surface nodes of the sections with their coordinates stored per section and coordinate, such that the nodes
+    // of a section are moved by one motion in a vectorized loop
+    sectionNodesBegin[0] = 0;
     for (int i = 0; i < surfaceNumSections; i++) {
-        // compute the x of a section in the Q system
-        double sectionX = 0.0;
+        int numSectionNodes;
         if (i == 0) { // root
-            for (int j = 0; j < surfaceNumRootSectionNodes; j++) {
-                sectionX += surfaceNodeCoorsInQ[sortedPosToUnsortedPos[j] * 3 + 0];
-            }
-            sectionX /= (double) surfaceNumRootSectionNodes;
+            numSectionNodes = surfaceNumRootSectionNodes;
         } else if (i == surfaceNumSections - 1) { // tip
-            for (int j = 0; j < surfaceNumTipSectionNodes; j++) {
-                int pos = sortedPosToUnsortedPos[surfaceNumNodes - j - 1];
-                sectionX += surfaceNodeCoorsInQ[pos * 3 + 0];
-            }
-            sectionX /= (double) surfaceNumTipSectionNodes;
+            numSectionNodes = surfaceNumTipSectionNodes;
         } else { // normal
-            for (int j = 0; j < surfaceNumNormalSectionNodes; j++) {
-                int pos = sortedPosToUnsortedPos[surfaceNumRootSectionNodes
-                        + (i - 1) * surfaceNumNormalSectionNodes + j];
-                sectionX += surfaceNodeCoorsInQ[pos * 3 + 0];
-            }
-            sectionX /= (double) surfaceNumNormalSectionNodes;
+            numSectionNodes = surfaceNumNormalSectionNodes;
         }
+        sectionNodesBegin[i + 1] = sectionNodesBegin[i] + numSectionNodes;
+    }
 
-        // use section x and rightXToElemPos to relate a section to the corresponding curve element
-        map<double, int>::iterator it = rightXToElemPos->lower_bound(sectionX); // find the first one bigger than section x
-        if (it != rightXToElemPos->end()) {
-            sectionToCurveElem[i] = it->second;
-        } else {
-            sectionToCurveElem[i] = rightXToElemPos->rbegin()->second;
-            /*cout << "sectionX: " << sectionX << endl;
-             cout << "rightX: " << rightXToElemPos->rbegin()->first << endl;
-             cout << "rightX - sectionX:" << rightXToElemPos->rbegin()->first - sectionX << endl;*/
+    // relate a section to a curve element: section center P, shape function + derivative, section to curve element
+#pragma omp parallel for num_threads(mapperSetNumThreads)
+    for (int i = 0; i < surfaceNumSections; i++) {
+        int begin = sectionNodesBegin[i];
+        int numSectionNodes = sectionNodesBegin[i + 1] - begin;
+        // compute the x of a section in the Q system, the nodes of the tip are taken from the end
+        double sectionX = 0.0;
+        for (int j = 0; j < numSectionNodes; j++) {
+            int pos = (i == surfaceNumSections - 1) ?
+                    sortedPosToUnsortedPos[surfaceNumNodes - j - 1] : sortedPosToUnsortedPos[begin + j];
+            sectionNodes[begin + j] = pos;
+            for (int k = 0; k < 3; k++)
+                sectionNodeCoors[begin * 3 + k * numSectionNodes + j] = surfaceNodeCoors[pos * 3 + k];
+            sectionX += surfaceNodeCoorsInQ[pos * 3 + 0];
         }
+        sectionX /= (double) numSectionNodes;
+
+        // find the first element whose right x is not smaller than section x, or the last one
+        int k = lower_bound(rightX.begin(), rightX.end(), sectionX) - rightX.begin();
+        sectionToCurveElem[i] = (k < rightX.size()) ? rightXElemPos[k] : rightXElemPos.back();
 
         // compute the local coordinate xi of the section in the beam/curve
         int node1ID = curveElems[sectionToCurveElem[i] * 2 + 0];
@@ -146,10 +245,6 @@ CurveSurfaceMapper::CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type _type, int
 
         if (diff < 0) // node2 is on the left
             xi = -xi;
-        //cout << "xi:" << xi <<endl;
-        //cout << "sectionX:" << sectionX <<endl;
-        //cout << "node1X:" << node1X <<endl;
-        //cout << "diff:" << diff <<endl;
         // compute the shape functions and their derivatives
         double linearShapeFunc1 = 0.5 * (1.0 - xi);
         double linearShapeFunc2 = 0.5 * (1.0 + xi);
@@ -192,9 +287,6 @@ CurveSurfaceMapper::CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type _type, int
             shapeFuncOfSection[i * 10 + 5 + 4] = cubicShapeFuncRotDeriv1;
         }
 
-        //for (int j=0; j<10; j++)
-        // cout << "shapeFunction " << j << ": " << shapeFuncOfSection[i*10 +j] << endl;
-
         // compute P, which is the cross point between section and beam/curve
         for (int j = 0; j < 3; j++) {
             sectionP[i * 3 + j] = shapeFuncOfSection[i * 10 + 0]
@@ -203,13 +295,14 @@ CurveSurfaceMapper::CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type _type, int
                             * curveNodeCoors[curveNodeIDToPos->at(node2ID) * 3 + j];
         }
     }
+    delete[] surfaceNodeCoorsInQ;
 
-    // transformation from local beam to the global system
-    ROT_O_ELEM = new KinematicMotion*[curveNumElements];
     // compute ROT_O_ELEM
+#pragma omp parallel for num_threads(mapperSetNumThreads)
     for (int i = 0; i < curveNumElements; i++) {
         // For the definition of local axes, see carat ElementBeam1::calc_transformation_matrix, or
         // carat.st.bv.tum.de/caratuserswiki/index.php/Users:General_FEM_Analysis/Elements_Reference/Beam1
+        delete ROT_O_ELEM[i];
         ROT_O_ELEM[i] = new KinematicMotion;
         int node1ID = curveElems[i * 2 + 0];
         int node2ID = curveElems[i * 2 + 1];
@@ -254,21 +347,8 @@ CurveSurfaceMapper::CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type _type, int
         }
     }
 
-    // initialize section rotation for conservative mapping
-    sectionRot = new double[surfaceNumSections * 3];
-
-    // delete
-    delete[] surfaceNodeCoorsInQ;
-    delete rightXToElemPos;
-    if (type != EMPIRE_CurveSurfaceMapper_corotate2D) {
-        delete KM_Q_O;
-        delete KM_O_Q;
-        delete[] curveNodeCoorsInQ;
-    }
-
     // special initialization for different algorithms
     if (type == EMPIRE_CurveSurfaceMapper_linear) {
-        curveElemLength = new double[curveNumElements];
         for (int i = 0; i < curveNumElements; i++) {
             int node1ID = curveElems[i * 2 + 0];
             int node2ID = curveElems[i * 2 + 1];
@@ -284,30 +364,19 @@ CurveSurfaceMapper::CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type _type, int
             assert(curveElemLength[i] != 0.0);
         }
     } else if (type == EMPIRE_CurveSurfaceMapper_corotate2D) {
-        // construct KM_O_Q
-        const double EPS = 1E-10;
-        for (int i = 0; i < 9; i++) {
-            double tmp = fabs(rotation_O_Q[i]);
-            if (tmp > 0.5)
-                assert(fabs(tmp - 1.0) < EPS); // should be 1
-            else
-                assert(fabs(tmp - 0.0) < EPS); // should be 0
-        }
-
         // z coordinates should be 0 in Q
+        const double EPS = 1E-10;
         for (int i = 0; i < curveNumNodes; i++) {
             assert(fabs(curveNodeCoorsInQ[i * 3 + 2] - 0.0) < EPS);
         }
 
-        // transformation from local beam to Q
-        ROT_Q_ELEM = new KinematicMotion*[curveNumElements];
-        // rotation angle from local beam to Q
-        angle_Q_ELEM = new double[curveNumElements];
         // compute ROT_Q_ELEM and angle_Q_ELEM
+#pragma omp parallel for num_threads(mapperSetNumThreads)
         for (int i = 0; i < curveNumElements; i++) {
             // For the definition of local axes, see carat ElementBeam1::calc_transformation_matrix, or
             // carat.st.bv.tum.de/caratuserswiki/index.php/Users:General_FEM_Analysis/Elements_Reference/Beam1
             // x and y are defined on Q instead of O, which is different than the classic carat definition
+            delete ROT_Q_ELEM[i];
             ROT_Q_ELEM[i] = new KinematicMotion;
             int node1ID = curveElems[i * 2 + 0];
             int node2ID = curveElems[i * 2 + 1];
@@ -344,13 +413,11 @@ CurveSurfaceMapper::CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type _type, int
                 }
             }
         }
-        delete KM_Q_O;
-    } else if (type == EMPIRE_CurveSurfaceMapper_corotate3D) {
-        // do nothing
-    } else {
-        assert(false);
     }
-    
+}
+
+void CurveSurfaceMapper::updateGeometry() {
+    buildSections();
 }
 
 CurveSurfaceMapper::~CurveSurfaceMapper() {
@@ -364,6 +431,11 @@ CurveSurfaceMapper::~CurveSurfaceMapper() {
     delete[] ROT_O_ELEM;
     delete[] sectionP;
     delete[] sectionRot;
+    delete[] sectionNodesBegin;
+    delete[] sectionNodes;
+    delete[] sectionNodeCoors;
+    delete KM_O_Q;
+    delete[] curveNodeCoorsInQ;
 
     // special destruction for different algorithms
     if (type == EMPIRE_CurveSurfaceMapper_linear) {
@@ -374,9 +446,7 @@ CurveSurfaceMapper::~CurveSurfaceMapper() {
             delete ROT_Q_ELEM[i];
         }
         delete[] ROT_Q_ELEM;
-        delete KM_O_Q;
         delete[] angle_Q_ELEM;
-        delete[] curveNodeCoorsInQ;
     } else if (type == EMPIRE_CurveSurfaceMapper_corotate3D) {
         // do nothing
     } else {
@@ -405,6 +475,7 @@ void CurveSurfaceMapper::consistentMappingLinear(const double *curveDispRot, dou
     double *node2DispLocal = new double[curveNumElements * 3];
     double *node2RotLocal = new double[curveNumElements * 3];
     // get displacements and rotations in the curve element local system
+#pragma omp parallel for num_threads(mapperSetNumThreads)
     for (int i = 0; i < curveNumElements; i++) {
         int node1ID = curveElems[i * 2 + 0];
         int node2ID = curveElems[i * 2 + 1];
@@ -427,7 +498,9 @@ void CurveSurfaceMapper::consistentMappingLinear(const double *curveDispRot, dou
         //cout << node2RotLocal[i * 3 + 0] <<" "<< node2RotLocal[i * 3 + 1] <<" "<< node2RotLocal[i * 3 + 2] << endl;
     }
 
-    // compute displacements of nodes through sections
+    // compute displacements of nodes through sections, the motion of a section is composed once and
+    // applied to all its nodes
+#pragma omp parallel for schedule(dynamic, 4) num_threads(mapperSetNumThreads)
     for (int i = 0; i < surfaceNumSections; i++) {
         // interpolate section rot and disp on the element local system
         int elem = sectionToCurveElem[i];
@@ -504,34 +577,11 @@ void CurveSurfaceMapper::consistentMappingLinear(const double *curveDispRot, dou
         delete TRL_P_O;
 
         // move the section nodes, get the displacements
-        int numSectionNodes;
-        if (i == 0) { // root
-            numSectionNodes = surfaceNumRootSectionNodes;
-        } else if (i == surfaceNumSections - 1) { // tip
-            numSectionNodes = surfaceNumTipSectionNodes;
-        } else { // normal
-            numSectionNodes = surfaceNumNormalSectionNodes;
-        }
-        for (int j = 0; j < numSectionNodes; j++) {
-            int pos;
-            if (i == 0) { // root
-                pos = sortedPosToUnsortedPos[j];
-            } else if (i == surfaceNumSections - 1) { // tip
-                pos = sortedPosToUnsortedPos[surfaceNumNodes - j - 1];
-            } else { // normal
-                pos = sortedPosToUnsortedPos[surfaceNumRootSectionNodes
-                        + (i - 1) * surfaceNumNormalSectionNodes + j];
-            }
-            double nodalOldCoor[3];
-            double nodalNewCoor[3];
-            for (int k = 0; k < 3; k++) {
-                nodalOldCoor[k] = surfaceNodeCoors[pos * 3 + k];
-                nodalNewCoor[k] = surfaceNodeCoors[pos * 3 + k];
-            }
-            KM_Oo_Od.move(nodalNewCoor);
-            for (int k = 0; k < 3; k++)
-                surfaceDisp[pos * 3 + k] = nodalNewCoor[k] - nodalOldCoor[k];
-        }
+        double affine[12];
+        KM_Oo_Od.getAffineMatrix(affine);
+        int begin = sectionNodesBegin[i];
+        moveSectionNodes(affine, sectionNodesBegin[i + 1] - begin, &sectionNodes[begin],
+                &sectionNodeCoors[begin * 3], surfaceDisp);
         // compute the final section displacement and rotation from KM_Oo_Ord
         KM_Oo_Od.getRotationVector(&sectionRot[i * 3]);
     }
@@ -558,6 +608,7 @@ void CurveSurfaceMapper::consistentMappingCorotate2D(const double *curveDispRot,
     // length of the element after deformation
     double *corotateElementLength = new double[curveNumElements];
     // compute DOFs in the curve element local system, compute corotate transformations, current length of the element
+#pragma omp parallel for num_threads(mapperSetNumThreads)
     for (int i = 0; i < curveNumElements; i++) {
         int node1ID = curveElems[i * 2 + 0];
         int node2ID = curveElems[i * 2 + 1];
@@ -611,7 +662,9 @@ void CurveSurfaceMapper::consistentMappingCorotate2D(const double *curveDispRot,
         //cout << node2Rot[i * 3 + 0] <<" "<< node2Rot[i * 3 + 1] <<" "<< node2Rot[i * 3 + 2] << endl;
     }
 
-    // compute displacements of nodes according to rotations and displacements of sections
+    // compute displacements of nodes according to rotations and displacements of sections, the motion of a section is
+    // composed once and applied to all its nodes
+#pragma omp parallel for schedule(dynamic, 4) num_threads(mapperSetNumThreads)
     for (int i = 0; i < surfaceNumSections; i++) {
         // interpolate section rot and disp on the element local system
         int elem = sectionToCurveElem[i];
@@ -705,34 +758,11 @@ void CurveSurfaceMapper::consistentMappingCorotate2D(const double *curveDispRot,
         delete TRL_P_O;
 
         // move the section nodes, get the displacements
-        int numSectionNodes;
-        if (i == 0) { // root
-            numSectionNodes = surfaceNumRootSectionNodes;
-        } else if (i == surfaceNumSections - 1) { // tip
-            numSectionNodes = surfaceNumTipSectionNodes;
-        } else { // normal
-            numSectionNodes = surfaceNumNormalSectionNodes;
-        }
-        for (int j = 0; j < numSectionNodes; j++) {
-            int pos;
-            if (i == 0) { // root
-                pos = sortedPosToUnsortedPos[j];
-            } else if (i == surfaceNumSections - 1) { // tip
-                pos = sortedPosToUnsortedPos[surfaceNumNodes - j - 1];
-            } else { // normal
-                pos = sortedPosToUnsortedPos[surfaceNumRootSectionNodes
-                        + (i - 1) * surfaceNumNormalSectionNodes + j];
-            }
-            double nodalOldCoor[3];
-            double nodalNewCoor[3];
-            for (int k = 0; k < 3; k++) {
-                nodalOldCoor[k] = surfaceNodeCoors[pos * 3 + k];
-                nodalNewCoor[k] = surfaceNodeCoors[pos * 3 + k];
-            }
-            KM_Oo_Ord.move(nodalNewCoor);
-            for (int k = 0; k < 3; k++)
-                surfaceDisp[pos * 3 + k] = nodalNewCoor[k] - nodalOldCoor[k];
-        }
+        double affine[12];
+        KM_Oo_Ord.getAffineMatrix(affine);
+        int begin = sectionNodesBegin[i];
+        moveSectionNodes(affine, sectionNodesBegin[i + 1] - begin, &sectionNodes[begin],
+                &sectionNodeCoors[begin * 3], surfaceDisp);
 
         // compute the final section displacement and rotation from KM_Oo_Ord
         KM_Oo_Ord.getRotationVector(&sectionRot[i * 3]);
@@ -764,6 +794,7 @@ void CurveSurfaceMapper::consistentMappingCorotate3D(const double *curveDispRot,
     // length of the element after deformation
     double *corotateElementLength = new double[curveNumElements];
     // compute DOFs in the curve element local system, compute corotate transformations, current length of the element
+#pragma omp parallel for num_threads(mapperSetNumThreads)
     for (int i = 0; i < curveNumElements; i++) {
         int node1ID = curveElems[i * 2 + 0];
         int node2ID = curveElems[i * 2 + 1];
@@ -898,7 +929,9 @@ void CurveSurfaceMapper::consistentMappingCorotate3D(const double *curveDispRot,
         //cout << node2Rot[i * 3 + 0] <<" "<< node2Rot[i * 3 + 1] <<" "<< node2Rot[i * 3 + 2] << endl;
     }
 
-    // compute displacements of nodes according to rotations and displacements of sections
+    // compute displacements of nodes according to rotations and displacements of sections, the motion of a section is
+    // composed once and applied to all its nodes
+#pragma omp parallel for schedule(dynamic, 4) num_threads(mapperSetNumThreads)
     for (int i = 0; i < surfaceNumSections; i++) {
         // interpolate section rot and disp on the element local system
         int elem = sectionToCurveElem[i];
@@ -981,34 +1014,11 @@ void CurveSurfaceMapper::consistentMappingCorotate3D(const double *curveDispRot,
         delete TRL_P_O;
 
         // move the section nodes, get the displacements
-        int numSectionNodes;
-        if (i == 0) { // root
-            numSectionNodes = surfaceNumRootSectionNodes;
-        } else if (i == surfaceNumSections - 1) { // tip
-            numSectionNodes = surfaceNumTipSectionNodes;
-        } else { // normal
-            numSectionNodes = surfaceNumNormalSectionNodes;
-        }
-        for (int j = 0; j < numSectionNodes; j++) {
-            int pos;
-            if (i == 0) { // root
-                pos = sortedPosToUnsortedPos[j];
-            } else if (i == surfaceNumSections - 1) { // tip
-                pos = sortedPosToUnsortedPos[surfaceNumNodes - j - 1];
-            } else { // normal
-                pos = sortedPosToUnsortedPos[surfaceNumRootSectionNodes
-                        + (i - 1) * surfaceNumNormalSectionNodes + j];
-            }
-            double nodalOldCoor[3];
-            double nodalNewCoor[3];
-            for (int k = 0; k < 3; k++) {
-                nodalOldCoor[k] = surfaceNodeCoors[pos * 3 + k];
-                nodalNewCoor[k] = surfaceNodeCoors[pos * 3 + k];
-            }
-            KM_Oo_Ord.move(nodalNewCoor);
-            for (int k = 0; k < 3; k++)
-                surfaceDisp[pos * 3 + k] = nodalNewCoor[k] - nodalOldCoor[k];
-        }
+        int begin = sectionNodesBegin[i];
+        double affine[12];
+        KM_Oo_Ord.getAffineMatrix(affine);
+        moveSectionNodes(affine, sectionNodesBegin[i + 1] - begin, &sectionNodes[begin],
+                &sectionNodeCoors[begin * 3], surfaceDisp);
 
         // compute the final section displacement and rotation from KM_Oo_Ord
         KM_Oo_Ord.getRotationVector(&sectionRot[i * 3]);
@@ -1034,23 +1044,10 @@ void CurveSurfaceMapper::conservativeMapping(const double *surfaceForce, double
         curveForceMoment[i] = 0.0;
     }
 
+    // sum the forces of every section and their moments around P in parallel
+    double *sectionForceMoment = new double[surfaceNumSections * 6];
+#pragma omp parallel for schedule(dynamic, 4) num_threads(mapperSetNumThreads)
     for (int i = 0; i < surfaceNumSections; i++) {
-        int elem = sectionToCurveElem[i];
-        int node1ID = curveElems[elem * 2 + 0];
-        int node2ID = curveElems[elem * 2 + 1];
-        int node1Pos = curveNodeIDToPos->at(node1ID);
-        int node2Pos = curveNodeIDToPos->at(node2ID);
-        double linearShapeFunc1 = shapeFuncOfSection[i * 10 + 0];
-        double linearShapeFunc2 = shapeFuncOfSection[i * 10 + 5 + 0];
-        int numSectionNodes;
-        if (i == 0) { // root
-            numSectionNodes = surfaceNumRootSectionNodes;
-        } else if (i == surfaceNumSections - 1) { // tip
-            numSectionNodes = surfaceNumTipSectionNodes;
-        } else { // normal
-            numSectionNodes = surfaceNumNormalSectionNodes;
-        }
-
         KinematicMotion ROT;
         double tmpSectionRot[3];
         for (int j = 0; j < 3; j++)
@@ -1058,52 +1055,59 @@ void CurveSurfaceMapper::conservativeMapping(const double *surfaceForce, double
         double angle = normalizeVector(tmpSectionRot);
 
         ROT.addRotation(tmpSectionRot, true, angle);
-
+        const double *R = ROT.getRotationMatrix();
+        const double *P = &sectionP[i * 3];
+
+        int begin = sectionNodesBegin[i];
+        int numSectionNodes = sectionNodesBegin[i + 1] - begin;
+        const int *nodes = &sectionNodes[begin];
+        const double *x = &sectionNodeCoors[begin * 3];
+        const double *y = x + numSectionNodes;
+        const double *z = y + numSectionNodes;
+        double Fx = 0.0, Fy = 0.0, Fz = 0.0;
+        double Mx = 0.0, My = 0.0, Mz = 0.0;
+#pragma omp simd reduction(+:Fx,Fy,Fz,Mx,My,Mz)
         for (int j = 0; j < numSectionNodes; j++) {
-            int pos;
-            if (i == 0) { // root
-                pos = sortedPosToUnsortedPos[j];
-            } else if (i == surfaceNumSections - 1) { // tip
-                pos = sortedPosToUnsortedPos[surfaceNumNodes - j - 1];
-            } else { // normal
-                pos = sortedPosToUnsortedPos[surfaceNumRootSectionNodes
-                        + (i - 1) * surfaceNumNormalSectionNodes + j];
-            }
             // distance from P to a section node in the original configuration
-            double P2N[3];
-            for (int k = 0; k < 3; k++) {
-                P2N[k] = surfaceNodeCoors[pos * 3 + k] - sectionP[i * 3 + k];
-            }
-
+            double dx = x[j] - P[0];
+            double dy = y[j] - P[1];
+            double dz = z[j] - P[2];
             // distance from P to a section node in the deformed configuration
-            ROT.move(P2N);
-
+            double rx = R[0] * dx + R[1] * dy + R[2] * dz;
+            double ry = R[3] * dx + R[4] * dy + R[5] * dz;
+            double rz = R[6] * dx + R[7] * dy + R[8] * dz;
             // force vector on the nodal
-            double F[3];
-            for (int k = 0; k < 3; k++) {
-                F[k] = surfaceForce[pos * 3 + k];
-            }
+            const double *F = &surfaceForce[nodes[j] * 3];
+            Fx += F[0];
+            Fy += F[1];
+            Fz += F[2];
             // compute moment around P with the nodal force: M = R X F
-            double M[3];
-            M[0] = P2N[1] * F[2] - P2N[2] * F[1];
-            M[1] = P2N[2] * F[0] - P2N[0] * F[2];
-            M[2] = P2N[0] * F[1] - P2N[1] * F[0];
-
-            /*cout << "F" << endl;
-             cout << F[0] << " " << F[1] << " " << F[2] << endl;
-             cout << "M" << endl;
-             cout << M[0] << " " << M[1] << " " << M[2] << endl;
-             cout << "linearShapeFunc1: " << linearShapeFunc1 << endl;
-             cout << "linearShapeFunc1: " << linearShapeFunc1 << endl;*/
-            // split F and M to curve/beam end nodes
-            for (int k = 0; k < 3; k++) {
-                curveForceMoment[node1Pos * 6 + 0 + k] += linearShapeFunc1 * F[k];
-                curveForceMoment[node1Pos * 6 + 3 + k] += linearShapeFunc1 * M[k];
-                curveForceMoment[node2Pos * 6 + 0 + k] += linearShapeFunc2 * F[k];
-                curveForceMoment[node2Pos * 6 + 3 + k] += linearShapeFunc2 * M[k];
-            }
+            Mx += ry * F[2] - rz * F[1];
+            My += rz * F[0] - rx * F[2];
+            Mz += rx * F[1] - ry * F[0];
+        }
+        double *FM = &sectionForceMoment[i * 6];
+        FM[0] = Fx;
+        FM[1] = Fy;
+        FM[2] = Fz;
+        FM[3] = Mx;
+        FM[4] = My;
+        FM[5] = Mz;
+    }
+
+    // split F and M to curve/beam end nodes, sections of the same element add to the same nodes
+    for (int i = 0; i < surfaceNumSections; i++) {
+        int elem = sectionToCurveElem[i];
+        int node1Pos = curveNodeIDToPos->at(curveElems[elem * 2 + 0]);
+        int node2Pos = curveNodeIDToPos->at(curveElems[elem * 2 + 1]);
+        double linearShapeFunc1 = shapeFuncOfSection[i * 10 + 0];
+        double linearShapeFunc2 = shapeFuncOfSection[i * 10 + 5 + 0];
+        for (int k = 0; k < 6; k++) {
+            curveForceMoment[node1Pos * 6 + k] += linearShapeFunc1 * sectionForceMoment[i * 6 + k];
+            curveForceMoment[node2Pos * 6 + k] += linearShapeFunc2 * sectionForceMoment[i * 6 + k];
         }
     }
+    delete[] sectionForceMoment;
 }
 
 void CurveSurfaceMapper::computeErrorsConsistentMapping(const double *curveDispRot, const double *surfaceDisp) {
@@ -33,6 +33,7 @@
 namespace EMPIRE {
 
 class KinematicMotion;
+class IDToIndexMap;
 
 /********//**
  * \brief Class CurveSurfaceMapper maps DOFs between beam elements and surface mesh with sections
@@ -76,6 +77,21 @@ public:
      ***********/
     void buildCouplingMatrices();
 
+    /***********************************************************************************************
+     * \brief The sections can be rebuilt after the nodes of the meshes moved
+     * \return true
+     ***********/
+    bool isGeometryUpdateSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Rebuild the sections and the curve element systems from the current node coordinates
+     *        (e.g. a new reference configuration of the section mesh), the number of nodes of every
+     *        section must be unchanged
+     ***********/
+    void updateGeometry();
+
     /***********************************************************************************************
      * \brief Map deformation from curve to surface / reconstruct the deformed surface according to beam DOFs.
      * \param[in] curveDispRot displacements and rotations on curve nodes
@@ -123,6 +139,9 @@ public:
      ***********/
     void computeErrorsConsistentMapping(const double *curveDispRot,const double *surfaceDisp);
 
+    /// defines number of threads used for mapper routines
+    static int mapperSetNumThreads;
+
 protected:
     /// type of the CurveSurfaceMapper
     EMPIRE_CurveSurfaceMapper_type type;
@@ -150,7 +169,7 @@ protected:
     /// After sorting the surface nodes into sections, map from sorted position to its position in node array
     int *sortedPosToUnsortedPos;
     /// Map a curve/beam node ID to the its position in node array
-    std::map<int, int> *curveNodeIDToPos;
+    IDToIndexMap *curveNodeIDToPos;
     /// Map a section to the corresponding curve/beam element
     int *sectionToCurveElem;
     /// cross point between section and curve/beam
@@ -161,6 +180,18 @@ protected:
     KinematicMotion **ROT_O_ELEM;
     /// rotation of a section needed by conservative mapping
     double *sectionRot;
+    /// the surface nodes of section i are sectionNodes[sectionNodesBegin[i]] to sectionNodes[sectionNodesBegin[i+1]-1]
+    int *sectionNodesBegin;
+    /// the positions of the surface nodes in the node array ordered by section
+    int *sectionNodes;
+    /// the coordinates of the surface nodes ordered by section, per section first all x, then all y, then all z
+    double *sectionNodeCoors;
+    /***********************************************************************************************
+     * \brief Sort the surface nodes into the sections by their x in the root system Q, relate the
+     *        sections to the curve elements by a binary search over the x of the element ends and
+     *        compute the curve element systems. Called by the constructor and updateGeometry
+     ***********/
+    void buildSections();
     /***********************************************************************************************
      * \brief Normalize a rotation (or length) vector and return the rotation angle (or length)
      * \param[in] vector a rotation (or length) vector
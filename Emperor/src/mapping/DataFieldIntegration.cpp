@@ -20,10 +20,13 @@
  */
 #include "DataFieldIntegration.h"
 #include "FEMesh.h"
+#include "FEMeshConnectivity.h"
+#include "FEMeshGeometry.h"
 #include "MathLibrary.h"
 #include "Message.h"
-#include <map>
+#include "AuxiliaryParameters.h"
 #include <vector>
+#include <omp.h>
 #include <assert.h>
 #include <iostream>
 #include <stdlib.h>
@@ -36,163 +39,50 @@ const int DataFieldIntegration::numGPsMassMatrixTri = 6;
 const int DataFieldIntegration::numGPsMassMatrixQuad = 4;
 
 DataFieldIntegration::DataFieldIntegration(int _numNodes, int _numElems,
-        const int *_numNodesPerElem, const double *_nodes, const int *_nodeIDs, const int *_elems) {
+        const int *_numNodesPerElem, const double *_nodes, const int *_nodeIDs, const int *_elems,
+        bool _isLumped) :
+        AbstractDataFieldIntegration(_isLumped) {
 	numNodes=_numNodes;
-    // Edit Aditya
-    massMatrix = new EMPIRE::MathLibrary::SparseMatrix<double>(numNodes,false);
-
-    const int *nodeIDs = _nodeIDs;
-    const double *nodes = _nodes;
-    const int numElems = _numElems;
-    const int *numNodesPerElem = _numNodesPerElem;
-    const int *elems = _elems;
-
-    // compute directElemTable which link the element to the all its nodes' positions (instead of IDs)
-    vector<int> **directElemTable = new vector<int>*[numElems];
-    for (int i = 0; i < numElems; i++)
-        directElemTable[i] = new vector<int>;
-    map<int, int> *nodesMap = new map<int, int>();
-    for (int i = 0; i < numNodes; i++)
-        nodesMap->insert(nodesMap->end(), pair<int, int>(nodeIDs[i], i));
-    int count = 0;
-    for (int i = 0; i < numElems; i++) {
-        const int numNodesThisElem = numNodesPerElem[i];
-        for (int j = 0; j < numNodesThisElem; j++) {
-            directElemTable[i]->push_back(nodesMap->at(elems[count + j]));
-        }
-        count += numNodesThisElem;
-    }
-    delete nodesMap;
-
-    // compute the sparsity map
-    // sparsity map has the information of a, ia, ja in a CSR formated matrix
-    map<int, double> **sparsityMap = new map<int, double>*[numNodes];
-    for (int i = 0; i < numNodes; i++)
-        sparsityMap[i] = new map<int, double>;
-
-    for (int i = 0; i < numElems; i++) {
-        const int numNodesThisElem = numNodesPerElem[i];
-        double elem[numNodesThisElem * 3]; // this element
-        int pos[numNodesThisElem]; // the position of the node in the nodeCoors
-        for (int j = 0; j < numNodesThisElem; j++) {
-            pos[j] = directElemTable[i]->at(j);
-            for (int k = 0; k < 3; k++)
-                elem[j * 3 + k] = nodes[pos[j] * 3 + k];
-        }
-
-        // replace the master element by the projection of it on its "element plane"
-        // we do it here because we have done the same in MortarMapper
-        if (numNodesThisElem == 4) {
-            double masterElemNormal[3];
-            EMPIRE::MathLibrary::computeNormalOfQuad(elem, true, masterElemNormal);
-            double masterQuadCenter[3];
-            EMPIRE::MathLibrary::computePolygonCenter(elem, 4, masterQuadCenter);
-            double masterQuadPrj[12];
-            EMPIRE::MathLibrary::projectToPlane(masterQuadCenter, masterElemNormal, elem, 4, masterQuadPrj);
-            for (int i = 0; i < 12; i++)
-                elem[i] = masterQuadPrj[i];
-        }
-
-        // make use of the symmetry
-        double massMatrixElem[numNodesThisElem * numNodesThisElem];
-        if (numNodesThisElem == 4)
-        	EMPIRE::MathLibrary::computeMassMatrixOfQuad(elem, numGPsMassMatrixQuad, false, massMatrixElem);
-        else if (numNodesThisElem == 3)
-        	EMPIRE::MathLibrary::computeMassMatrixOfTrianlge(elem, numGPsMassMatrixTri, false,
-                    massMatrixElem);
-        else
-            assert(false);
-        for (int j = 0; j < numNodesThisElem; j++) {
-            for (int k = j; k < numNodesThisElem; k++) {
-                int smaller, larger;
-                if (pos[j] > pos[k]) {
-                    larger = pos[j];
-                    smaller = pos[k];
-                } else {
-                    larger = pos[k];
-                    smaller = pos[j];
-                }
-                double massMatrixJK = massMatrixElem[j * numNodesThisElem + k];
-                bool inserted = sparsityMap[smaller]->insert(
-                        pair<int, double>(larger, massMatrixJK)).second; // *.second is a bool indicating inserted or not
-                if (!inserted)
-                    (sparsityMap[smaller]->at(larger)) += massMatrixJK; // at() returns a reference, so using "+=" is correct
-            }
-        }
-    }
-
-    // 2. according to sparsity map, compute a, ia, ja of CSR formated massMatrix
-    int nnz = 1; // number of non-zero entries
-    for (int i = 0; i < numNodes; i++) {
-        nnz += sparsityMap[i]->size();
-    }
-    nnz--;
-    int count2 = 0;
-    for (int i = 0; i < numNodes; i++) {
-        for (map<int, double>::iterator it = sparsityMap[i]->begin(); it != sparsityMap[i]->end();
-                it++) {
-        	// Edit Aditya
-        	(*massMatrix)(i,it->first) = it->second;
-        	(*massMatrix)(it->first,i) = it->second;
-            count2++;
-        }
-    }assert(nnz == count2);
-
-    // delete spasity map
-    for (int i = 0; i < numNodes; i++)
-        delete sparsityMap[i];
-    delete[] sparsityMap;
-
-    for (int i = 0; i < numElems; i++)
-        delete directElemTable[i];
-    delete[] directElemTable;
+    FEMeshConnectivity connectivity(_numNodes, _nodeIDs, _numElems, _numNodesPerElem, _elems);
+    FEMeshGeometry elemGeometry(_numElems, _numNodesPerElem, _nodes, &connectivity,
+            AuxiliaryParameters::mapperSetNumThreads);
+    computeMassMatrix(_nodes, _numElems, _numNodesPerElem, &connectivity, &elemGeometry);
 }
 
-DataFieldIntegration::DataFieldIntegration(FEMesh* _mesh) {
+DataFieldIntegration::DataFieldIntegration(FEMesh* _mesh, bool _isLumped) :
+        AbstractDataFieldIntegration(_isLumped) {
     FEMesh *actualMesh = NULL;
     if (_mesh->triangulate() == NULL)
         actualMesh = _mesh;
     else
         actualMesh = _mesh->triangulate();
     numNodes = actualMesh->numNodes;
+    computeMassMatrix(actualMesh->nodes, actualMesh->numElems, actualMesh->numNodesPerElem,
+            actualMesh->getConnectivity(), actualMesh->getElemGeometry());
+}
+
+void DataFieldIntegration::computeMassMatrix(const double *nodes, int numElems,
+        const int *numNodesPerElem, const FEMeshConnectivity *connectivity,
+        const FEMeshGeometry *elemGeometry) {
     // Edit Aditya
     massMatrix = new EMPIRE::MathLibrary::SparseMatrix<double>(numNodes,false);
 
-    int *nodeIDs = actualMesh->nodeIDs;
-    double *nodes = actualMesh->nodes;
-    int numElems = actualMesh->numElems;
-    int *numNodesPerElem = actualMesh->numNodesPerElem;
-    int *elems = actualMesh->elems;
-
-    // compute directElemTable which link the element to the all its nodes' positions (instead of IDs)
-    vector<int> **directElemTable = new vector<int>*[numElems];
-    for (int i = 0; i < numElems; i++)
-        directElemTable[i] = new vector<int>;
-    map<int, int> *nodesMap = new map<int, int>();
-    for (int i = 0; i < numNodes; i++)
-        nodesMap->insert(nodesMap->end(), pair<int, int>(nodeIDs[i], i));
-    int count = 0;
-    for (int i = 0; i < numElems; i++) {
-        const int numNodesThisElem = numNodesPerElem[i];
-        for (int j = 0; j < numNodesThisElem; j++) {
-            directElemTable[i]->push_back(nodesMap->at(elems[count + j]));
-        }
-        count += numNodesThisElem;
-    }
-    delete nodesMap;
-
-    // compute the sparsity map
-    // sparsity map has the information of a, ia, ja in a CSR formated matrix
-    map<int, double> **sparsityMap = new map<int, double>*[numNodes];
-    for (int i = 0; i < numNodes; i++)
-        sparsityMap[i] = new map<int, double>;
-
+    // every thread collects the entries of its elements in its own buffer, or every element in its
+    // own buffer if the assembly has to be reproducible, they are merged afterwards
+    const int numThreads = AuxiliaryParameters::mapperSetNumThreads;
+    vector<vector<MathLibrary::SparseMatrixTriplet<double> > > buffers(
+            MathLibrary::getNumAssemblyBuffers(numThreads, numElems));
+#pragma omp parallel num_threads(numThreads)
+    {
+#pragma omp for schedule(dynamic, 256)
     for (int i = 0; i < numElems; i++) {
+        vector<MathLibrary::SparseMatrixTriplet<double> >& buffer = buffers[MathLibrary::getAssemblyBuffer(i)];
         const int numNodesThisElem = numNodesPerElem[i];
         double elem[numNodesThisElem * 3]; // this element
         int pos[numNodesThisElem]; // the position of the node in the nodeCoors
+        const int *elemNodes = connectivity->getElemNodes(i);
         for (int j = 0; j < numNodesThisElem; j++) {
-            pos[j] = directElemTable[i]->at(j);
+            pos[j] = elemNodes[j];
             for (int k = 0; k < 3; k++)
                 elem[j * 3 + k] = nodes[pos[j] * 3 + k];
         }
@@ -200,69 +90,30 @@ DataFieldIntegration::DataFieldIntegration(FEMesh* _mesh) {
         // replace the master element by the projection of it on its "element plane"
         // we do it here because we have done the same in MortarMapper
         if (numNodesThisElem == 4) {
-            double masterElemNormal[3];
-            EMPIRE::MathLibrary::computeNormalOfQuad(elem, true, masterElemNormal);
-            double masterQuadCenter[3];
-            EMPIRE::MathLibrary::computePolygonCenter(elem, 4, masterQuadCenter);
+            const double *masterElemNormal = elemGeometry->getNormal(i);
+            const double *masterQuadCenter = elemGeometry->getCentroid(i);
             double masterQuadPrj[12];
             EMPIRE::MathLibrary::projectToPlane(masterQuadCenter, masterElemNormal, elem, 4, masterQuadPrj);
             for (int i = 0; i < 12; i++)
                 elem[i] = masterQuadPrj[i];
         }
 
-        // make use of the symmetry
         double massMatrixElem[numNodesThisElem * numNodesThisElem];
         if (numNodesThisElem == 4)
-        	EMPIRE::MathLibrary::computeMassMatrixOfQuad(elem, numGPsMassMatrixQuad, false, massMatrixElem);
+        	EMPIRE::MathLibrary::computeMassMatrixOfQuad<numGPsMassMatrixQuad>(elem, false, massMatrixElem);
         else if (numNodesThisElem == 3)
-        	EMPIRE::MathLibrary::computeMassMatrixOfTrianlge(elem, numGPsMassMatrixTri, false,
+        	EMPIRE::MathLibrary::computeMassMatrixOfTriangle<numGPsMassMatrixTri>(elem, false,
                     massMatrixElem);
         else
             assert(false);
-        for (int j = 0; j < numNodesThisElem; j++) {
-            for (int k = j; k < numNodesThisElem; k++) {
-                int smaller, larger;
-                if (pos[j] > pos[k]) {
-                    larger = pos[j];
-                    smaller = pos[k];
-                } else {
-                    larger = pos[k];
-                    smaller = pos[j];
-                }
-                double massMatrixJK = massMatrixElem[j * numNodesThisElem + k];
-                bool inserted = sparsityMap[smaller]->insert(
-                        pair<int, double>(larger, massMatrixJK)).second; // *.second is a bool indicating inserted or not
-                if (!inserted)
-                    (sparsityMap[smaller]->at(larger)) += massMatrixJK; // at() returns a reference, so using "+=" is correct
-            }
-        }
-    }
-
-    // 2. according to sparsity map, compute a, ia, ja of CSR formated massMatrix
-    int nnz = 1; // number of non-zero entries
-    for (int i = 0; i < numNodes; i++) {
-        nnz += sparsityMap[i]->size();
+        for (int j = 0; j < numNodesThisElem; j++)
+            for (int k = 0; k < numNodesThisElem; k++)
+                buffer.push_back(MathLibrary::SparseMatrixTriplet<double>(pos[j], pos[k],
+                        massMatrixElem[j * numNodesThisElem + k]));
     }
-    nnz--;
-    int count2 = 0;
-    for (int i = 0; i < numNodes; i++) {
-        for (map<int, double>::iterator it = sparsityMap[i]->begin(); it != sparsityMap[i]->end();
-                it++) {
-        	// Edit Aditya
-        	(*massMatrix)(i,it->first) = it->second;
-        	(*massMatrix)(it->first,i) = it->second;
-            count2++;
-        }
-    }assert(nnz == count2);
-
-    // delete spasity map
-    for (int i = 0; i < numNodes; i++)
-        delete sparsityMap[i];
-    delete[] sparsityMap;
-
-    for (int i = 0; i < numElems; i++)
-        delete directElemTable[i];
-    delete[] directElemTable;
+    } //#pragma omp parallel
+    massMatrix->addTriplets(buffers, numThreads);
+    finalizeMassMatrix();
 }
 
 DataFieldIntegration::~DataFieldIntegration() {
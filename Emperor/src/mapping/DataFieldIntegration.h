@@ -36,6 +36,8 @@ namespace MathLibrary
 	class SparseMatrix;
 }
 class FEMesh;
+class FEMeshConnectivity;
+class FEMeshGeometry;
 
 /********//**
  * \brief Class DataFieldIntegration is an operator from traction to force or vice versa
@@ -51,16 +53,18 @@ public:
      * \param[in] _nodes coordinates of nodes
      * \param[in] _nodeIDs IDs of nodes
      * \param[in] _elems element table
+     * \param[in] _isLumped whether the row sums of the mass matrix are used
      * \author Tianyang Wang
      ***********/
     DataFieldIntegration(int _numNodes, int _numElems, const int *_numNodesPerElem,
-            const double *_nodes, const int *_nodeIDs, const int *_elems);
+            const double *_nodes, const int *_nodeIDs, const int *_elems, bool _isLumped = false);
     /***********************************************************************************************
      * \brief Constructor
      * \param[in] _mesh FE mesh on which integration is proceeding
+     * \param[in] _isLumped whether the row sums of the mass matrix are used
      * \author Fabien Pean
      ***********/
-    DataFieldIntegration(FEMesh* mesh);
+    DataFieldIntegration(FEMesh* mesh, bool _isLumped = false);
     /***********************************************************************************************
      * \brief Destructor
      * \author Tianyang Wang
@@ -72,6 +76,16 @@ private:
     static const int numGPsMassMatrixTri;
     /// number of Gauss points used for computing quad element mass matrix
     static const int numGPsMassMatrixQuad;
+    /***********************************************************************************************
+     * \brief Assemble the mass matrix of the mesh, the elements are integrated in parallel
+     * \param[in] nodes coordinates of nodes
+     * \param[in] numElems number of elements
+     * \param[in] numNodesPerElem number of nodes per element
+     * \param[in] connectivity the element to node table by node positions
+     * \param[in] elemGeometry the centroids and normals of the elements
+     ***********/
+    void computeMassMatrix(const double *nodes, int numElems, const int *numNodesPerElem,
+            const FEMeshConnectivity *connectivity, const FEMeshGeometry *elemGeometry);
 
 };
 
@@ -16,14 +16,14 @@
 
 namespace EMPIRE {
 
-DataFieldIntegrationAdapter::DataFieldIntegrationAdapter(AbstractMesh *_mesh) :
+DataFieldIntegrationAdapter::DataFieldIntegrationAdapter(AbstractMesh *_mesh, bool _isLumped) :
 	mesh(_mesh) {
 	if(mesh->type == EMPIRE_Mesh_FEMesh) {
 	    FEMesh *feMesh = dynamic_cast<FEMesh*>(_mesh);
-	    initDataFieldIntegrationMesh(feMesh);
+	    initDataFieldIntegrationMesh(feMesh, _isLumped);
    } else if(mesh->type == EMPIRE_Mesh_IGAMesh) {
 	    IGAMesh *igaMesh = dynamic_cast<IGAMesh*>(_mesh);
-	    initDataFieldIntegrationNURBS(igaMesh);
+	    initDataFieldIntegrationNURBS(igaMesh, _isLumped);
    } else
 		ERROR_BLOCK_OUT("DataFieldIntegrationAdapter","DataFieldIntegrationAdapter","DataFieldIntegration not implemented for mesh other than standard FE mesh or NURBS surfaces");
 }
@@ -32,12 +32,12 @@ DataFieldIntegrationAdapter::~DataFieldIntegrationAdapter() {
 	delete dataFieldIntegrationImpl;
 }
 
-void DataFieldIntegrationAdapter::initDataFieldIntegrationMesh(FEMesh *_mesh) {
-	dataFieldIntegrationImpl=new DataFieldIntegration(_mesh);
+void DataFieldIntegrationAdapter::initDataFieldIntegrationMesh(FEMesh *_mesh, bool _isLumped) {
+	dataFieldIntegrationImpl=new DataFieldIntegration(_mesh, _isLumped);
 }
 
-void DataFieldIntegrationAdapter::initDataFieldIntegrationNURBS(IGAMesh *_mesh) {
-	dataFieldIntegrationImpl=new DataFieldIntegrationNURBS(_mesh);
+void DataFieldIntegrationAdapter::initDataFieldIntegrationNURBS(IGAMesh *_mesh, bool _isLumped) {
+	dataFieldIntegrationImpl=new DataFieldIntegrationNURBS(_mesh, _isLumped);
 }
 
 void DataFieldIntegrationAdapter::integrate(const double *tractions, double *forces) {
@@ -48,4 +48,8 @@ void DataFieldIntegrationAdapter::deIntegrate(const double *forces, double *trac
 	dataFieldIntegrationImpl->deIntegrate(forces, tractions);
 }
 
+void DataFieldIntegrationAdapter::setLinearSolver(const std::string &name) {
+	dataFieldIntegrationImpl->setLinearSolver(name);
+}
+
 } /* namespace EMPIRE */
@@ -27,6 +27,8 @@
 #ifndef DATAFIELDINTEGRATIONADAPTER_H_
 #define DATAFIELDINTEGRATIONADAPTER_H_
 
+#include <string>
+
 namespace EMPIRE {
 
 class AbstractMesh;
@@ -44,9 +46,10 @@ public:
      * \brief Constructor
      * \param[in] _name name of the mapper
      * \param[in] _mesh mesh
+     * \param[in] _isLumped whether the row sums of the mass matrix are used
      * \author Fabien Pean
      ***********/
-	DataFieldIntegrationAdapter(AbstractMesh *_mesh);
+	DataFieldIntegrationAdapter(AbstractMesh *_mesh, bool _isLumped = false);
     /***********************************************************************************************
      * \brief Destructor
      * \author Fabien Pean
@@ -54,14 +57,16 @@ public:
 	virtual ~DataFieldIntegrationAdapter();
     /***********************************************************************************************
      * \brief Initialize initDataFieldIntegrationMesh
+     * \param[in] _isLumped whether the row sums of the mass matrix are used
      * \author Fabien Pean
      ***********/
-    void initDataFieldIntegrationMesh(FEMesh *_mesh);
+    void initDataFieldIntegrationMesh(FEMesh *_mesh, bool _isLumped);
     /***********************************************************************************************
      * \brief Initialize initDataFieldIntegrationNURBS
+     * \param[in] _isLumped whether the row sums of the mass matrix are used
      * \author Fabien Pean
      ***********/
-    void initDataFieldIntegrationNURBS(IGAMesh *_mesh);
+    void initDataFieldIntegrationNURBS(IGAMesh *_mesh, bool _isLumped);
     /***********************************************************************************************
      * \brief Do integration (massMatrix*tractions=forces).
      * \param[in] tractions tractions (in one direction)
@@ -76,6 +81,11 @@ public:
      * \author Tianyang Wang
      ***********/
     void deIntegrate(const double *forces, double *tractions);
+    /***********************************************************************************************
+     * \brief Select the solver of the mass matrix
+     * \param[in] name the name of the solver in the LinearSolverRegistry
+     ***********/
+    void setLinearSolver(const std::string &name);
     /***********************************************************************************************
      * \brief is it mesh or not
      * \param[in] _mesh mesh
@@ -26,15 +26,17 @@
 #include "ClipperAdapter.h"
 #include "TriangulatorAdaptor.h"
 #include "Message.h"
+#include "AuxiliaryParameters.h"
+#include <omp.h>
 
 namespace EMPIRE {
 
 double DataFieldIntegrationNURBS::EPS_CLEANTRIANGLE = 1e-6;
-double DataFieldIntegrationNURBS::EPS_CLIPPING = 1e-9;
 
 using std::make_pair;
 
-DataFieldIntegrationNURBS::DataFieldIntegrationNURBS(IGAMesh* _mesh): meshIGA(_mesh) {
+DataFieldIntegrationNURBS::DataFieldIntegrationNURBS(IGAMesh* _mesh, bool _isLumped):
+        AbstractDataFieldIntegration(_isLumped), meshIGA(_mesh) {
 
     // Get the number of patches
     int numPatches = meshIGA->getNumPatches();
@@ -46,12 +48,15 @@ DataFieldIntegrationNURBS::DataFieldIntegrationNURBS(IGAMesh* _mesh): meshIGA(_m
     massMatrix = new EMPIRE::MathLibrary::SparseMatrix<double>(numNodes,false);
 
     // Initialize the Gauss quadrature rules
-    gaussRuleOnTriangle = new EMPIRE::MathLibrary::IGAGaussQuadrature*[numPatches];
-    gaussRuleOnQuadrilateral = new EMPIRE::MathLibrary::IGAGaussQuadrature*[numPatches];
+    gaussRuleOnTriangle = new const EMPIRE::MathLibrary::IGAGaussQuadrature*[numPatches];
+    gaussRuleOnQuadrilateral = new const EMPIRE::MathLibrary::IGAGaussQuadrature*[numPatches];
 
     // Initialize the integration area
     areaIntegration = 0.0;
 
+    // Initialize the statistics of the triangulation
+    numTriangulationsPerPath.assign(TriangulatorAdaptor::NUM_PATHS, 0);
+
     // Create the Gauss quadrature rules for all patches
     createGaussQuadratureRules();
 
@@ -61,19 +66,27 @@ DataFieldIntegrationNURBS::DataFieldIntegrationNURBS(IGAMesh* _mesh): meshIGA(_m
     // Print the integration area
     INFO_OUT() << "The integration area in the data integration filter is equal to: " << areaIntegration << std::endl;
 
+    // Print the statistics of the triangulation
+    {
+        long numTriangulations = 0;
+        for (int iPath = 0; iPath < TriangulatorAdaptor::NUM_PATHS; iPath++)
+            numTriangulations += numTriangulationsPerPath[iPath];
+        INFO_OUT() << "Number of triangulated polygons in the data integration filter: " << numTriangulations << std::endl;
+        for (int iPath = 0; iPath < TriangulatorAdaptor::NUM_PATHS && numTriangulations > 0; iPath++)
+            INFO_OUT() << "    by " << TriangulatorAdaptor::getPathName((TriangulatorAdaptor::TriangulationPath)iPath) << ": "
+                    << numTriangulationsPerPath[iPath] << " ("
+                    << 100.0 * numTriangulationsPerPath[iPath] / numTriangulations << "%)" << std::endl;
+    }
+
     // Enforce flying nodes in Cnn
     enforceCnn();
+
+    // Freeze the mass matrix, or reduce it to its row sums
+    finalizeMassMatrix();
 }
 
 DataFieldIntegrationNURBS::~DataFieldIntegrationNURBS() {
-    // Initialize auxiliary arrays
-    int numPatches = meshIGA->getNumPatches();
-
-    // Delete the quadrature rules
-    for (int iPatches = 0; iPatches < numPatches; iPatches++) {
-        delete[] gaussRuleOnTriangle[iPatches];
-        delete[] gaussRuleOnQuadrilateral[iPatches];
-    }
+    // Delete the arrays of the quadrature rules, the rules themselves are shared
     delete[] gaussRuleOnTriangle;
     delete[] gaussRuleOnQuadrilateral;
 }
@@ -116,9 +129,9 @@ void DataFieldIntegrationNURBS::createGaussQuadratureRules() {
 
         // Instantiate the corresponding Gauss quadrature on triangle
         if (polOrder <= 8) // Use the Gauss quadrature over the triangle with the symmetric rule
-            gaussRuleOnTriangle[iPatches] = new MathLibrary::IGAGaussQuadratureOnTriangle(numGPs);
+            gaussRuleOnTriangle[iPatches] = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_TRIANGLE, numGPs);
         else // Use the Gauss quadrature over the triangle with the degenerated quadrilateral
-            gaussRuleOnTriangle[iPatches] = new MathLibrary::IGAGaussQuadratureOnTriangleUsingDegeneratedQuadrilateral(numGPs);
+            gaussRuleOnTriangle[iPatches] = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_TRIANGLE_DEGENERATED_QUADRILATERAL, numGPs);
 
         // Find the polynomial degree of the integrand \int_{\Omega} R_i*R_i d\Omega when a quadrilateral is considered
         pTilde = 2*std::max(pDegree, qDegree);
@@ -127,7 +140,7 @@ void DataFieldIntegrationNURBS::createGaussQuadratureRules() {
         numGPs = pow(std::ceil((pTilde + 1)/2.0), 2.0);
 
         // Instantiate the corresponding Gauss quadrature on quadrilateral
-        gaussRuleOnQuadrilateral[iPatches] = new MathLibrary::IGAGaussQuadratureOnBiunitQuadrilateral(numGPs);
+        gaussRuleOnQuadrilateral[iPatches] = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_BIUNIT_QUADRILATERAL, numGPs);
     }
 }
 
@@ -137,323 +150,82 @@ void DataFieldIntegrationNURBS::computeMassMatrix() {
      *
      * Function layout :
      *
-     * 1. Loop over all patches
-     * ->
-     *    1i. Get the surface patch
-     *   1ii. Get the boundaries of the parameter space
-     *  1iii. Clip the parameter space by the knot spans
-     *   1iv. Loop over all the generated polygons
-     *   ->
-     *        1iv.1. Clean the polygon
-     *        1iv.2. Check if the polygon has less than 3 vertices and if yes continue
-     *        1iv.3. Initialize list of trimmed polygons in case patch is not trimmed
-     *        1iv.4. Clip the polygon by trimming if the patch is trimmed
-     *        1iv.5. Loop over all generated subpolygons
-     *        ->
-     *               1iv.5i. Clean the polygon
-     *              1iv.5ii. Check if the polygon has less than 3 vertices and if yes continue
-     *             1iv.5iii. Triangulate the generated polygon
-     *              1iv.5iv. Loop over all triangles of the triangulation
-     *              ->
-     *                       1iv.5iv.1. Clean triangle
-     *                       1iv.5iv.2. Check if the triangle after cleaning is no more a triangle
-     *                       1iv.5iv.3. Pass the triangle into the integration function
-     *              <-
-     *        <-
-     * <-
-     */
-
-    // Initialize auxiliary arrays
-    int numPatches = meshIGA->getNumPatches();
-
-    // 1. Loop over all patches
-    for(unsigned int iPatches = 0; iPatches < numPatches; iPatches++) {
-        // 1i. Get the surface patch
-        IGAPatchSurface* patch = meshIGA->getSurfacePatch(iPatches);
-
-        // 1ii. Get the boundaries of the parameter space
-        Polygon2D polygonUV(4);
-        {
-            const double u0 = patch->getIGABasis()->getUBSplineBasis1D()->getFirstKnot();
-            const double v0 = patch->getIGABasis()->getVBSplineBasis1D()->getFirstKnot();
-            const double u1 = patch->getIGABasis()->getUBSplineBasis1D()->getLastKnot();
-            const double v1 = patch->getIGABasis()->getVBSplineBasis1D()->getLastKnot();
-            polygonUV[0] = make_pair(u0,v0);
-            polygonUV[1] = make_pair(u1,v0);
-            polygonUV[2] = make_pair(u1,v1);
-            polygonUV[3] = make_pair(u0,v1);
-        }
-
-        // 1iii. Clip the parameter space by the knot spans
-        Polygon2D listSpan;
-        ListPolygon2D listKnotPolygonUV;
-        clipByKnotSpan(patch,polygonUV,listKnotPolygonUV,listSpan);
-
-        // 1iv. Loop over all the generated polygons
-        for(int index = 0;index < listSpan.size(); index++) {
-            // 1iv.1. Clean the polygon
-            ClipperAdapter::cleanPolygon(listKnotPolygonUV[index]);
-
-            // 1iv.2. Check if the polygon has less than 3 vertices and if yes continue
-            if(listKnotPolygonUV[index].size() < 3)
-                continue;
-
-            // 1iv.3. Initialize list of trimmed polygons in case patch is not trimmed
-            ListPolygon2D listTrimmedPolygonUV(1, listKnotPolygonUV[index]);
-
-            // 1iv.4. Clip the polygon by trimming if the patch is trimmed
-            if(patch->isTrimmed())
-                clipByTrimming(patch,listKnotPolygonUV[index], listTrimmedPolygonUV);
-
-            // 1iv.5. Loop over all generated subpolygons
-            for(int trimmedPolygonIndex = 0; trimmedPolygonIndex < listTrimmedPolygonUV.size(); trimmedPolygonIndex++) {
-                // 1iv.5i. Clean the polygon
-                ClipperAdapter::cleanPolygon(listTrimmedPolygonUV[trimmedPolygonIndex]);
-
-                // 1iv.5ii. Check if the polygon has less than 3 vertices and if yes continue
-                if(listTrimmedPolygonUV[trimmedPolygonIndex].size()<3)
-                    continue;
-
-                // 1iv.5iii. Triangulate the generated polygon
-                ListPolygon2D triangulatedPolygons = triangulatePolygon(listTrimmedPolygonUV[trimmedPolygonIndex]);
-
-                // 1iv.5iv. Loop over all triangles of the triangulation
-                for(ListPolygon2D::iterator triangulatedPolygon = triangulatedPolygons.begin(); triangulatedPolygon != triangulatedPolygons.end(); triangulatedPolygon++) {
-                    // 1iv.5iv.1. Clean triangle
-                    ClipperAdapter::cleanPolygon(*triangulatedPolygon,EPS_CLEANTRIANGLE);
-
-                    // 1iv.5iv.2. Check if the triangle after cleaning is no more a triangle
-                    if(triangulatedPolygon->size() < 3)
-                        continue;
-
-                    // 1iv.5iv.3. Pass the triangle into the integration function
-                    integrate(patch, iPatches, *triangulatedPolygon, listSpan[index].first, listSpan[index].second);
-                }
-            }
-        }
-    }
-}
-
-void DataFieldIntegrationNURBS::clipByTrimming(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygonUV) {
-    /*
-     * Clips a given polygon by the tirmming curves within a patch
-     *
-     * Function layout:
+     * 1. Compute the integration cells of all patches, i.e. their knot spans clipped by the trimming and triangulated
      *
-     * 1. Initialize auxiliary variables
+     * 2. Collect the integration cells of all patches
      *
-     * 2. Loop over all trimming loops within the patch
+     * 3. Loop over all integration cells
      * ->
-     *    2i. Get the linearized trimming loop
-     *   2ii. Add the trimming loop in the clipper
-     * <-
-     *
-     * 3. Setup filling rule to have for sure clockwise loop as hole and counterclockwise as boundaries
-     */
-
-    // 1. Initialize auxiliary variables
-	ClipperAdapter c;
-
-    // 2. Loop over all trimming loops within the patch
-    for(int iLoop = 0; iLoop < _thePatch->getTrimming().getNumOfLoops(); iLoop++) {
-        // 2i. Get the linearized trimming loop
-        const std::vector<double> clippingWindow = _thePatch->getTrimming().getLoop(iLoop).getPolylines();
-
-        // 2ii. Add the trimming loop in the clipper
-		c.addPathClipper(clippingWindow);
-	}
-
-    // 3. Setup filling rule to have for sure clockwise loop as hole and counterclockwise as boundaries
-	c.setFilling(ClipperAdapter::POSITIVE, 0);
-	c.addPathSubject(_polygonUV);
-	c.clip();
-	c.getSolution(_listPolygonUV);
-}
-
-bool DataFieldIntegrationNURBS::computeKnotSpanOfProjElement(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, int* _span) {
-    /*
-     * Clips a given polygon by the knot spans in the given patch
-     *
-     * Function layout:
-     *
-     * 1. Find minimum and maximum knot span indices in u- and v-directions
-     *
-     * 2. Loop over all nodes in the given polygon
-     * ->
-     *    2i. Find the knot span indices where the nodes belong into
-     *   2ii. Clamp the knot span indices in case the image of the node is outside the knot limits
-     * <-
-     *
-     * 3. Flag on whether all nodes of the polygon are in the same knot span
-     *
-     * 4. Return the flag
-     */
-
-    // 1. Find minimum and maximum knot span indices in u- and v-directions
-    int minSpanU = _thePatch->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(_polygonUV[0].first);
-    int minSpanV = _thePatch->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(_polygonUV[0].second);
-    int maxSpanU = minSpanU;
-    int maxSpanV = minSpanV;
-
-    // 2. Loop over all nodes in the given polygon
-    for (int iNodes = 1; iNodes < _polygonUV.size(); iNodes++) {
-        // 2i. Find the knot span indices where the nodes belong into
-        int spanU = _thePatch->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(_polygonUV[iNodes].first);
-        int spanV = _thePatch->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(_polygonUV[iNodes].second);
-
-        // 2ii. Clamp the knot span indices in case the image of the node is outside the knot limits
-        if (spanU < minSpanU)
-            minSpanU = spanU;
-        if (spanU > maxSpanU)
-            maxSpanU = spanU;
-        if (spanV < minSpanV)
-            minSpanV = spanV;
-        if (spanV > maxSpanV)
-            maxSpanV = spanV;
-    }
-
-    // 3. Flag on whether all nodes of the polygon are in the same knot span
-    bool OnSameKnotSpan = (minSpanU == maxSpanU && minSpanV == maxSpanV);
-    if(_span!=NULL) {
-        _span[0] = minSpanU;
-        _span[1] = maxSpanU;
-        _span[2] = minSpanV;
-        _span[3] = maxSpanV;
-    }
-
-    // 4. Return the flag
-    return OnSameKnotSpan;
-}
-
-void DataFieldIntegrationNURBS::clipByKnotSpan(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygon, Polygon2D& _listSpan) {
-    /*
-     * Clips a given polygon by the knot spans of the given patch
-     *
-     * Function layout:
-     *
-     * 1. Initialize auxiliary variables
-     *
-     * 2. Get the knot vectors of the patch
-     *
-     * 3.find the knot span which the current element located in. (from minSpanu to maxSpanu in U-direction, and from minSpanV to max SpanV in V-direction)
-     *
-     * 4. Find the clipped polygon
-     * ->
-     *    ### If all vertices of the polygon are on same knot span then returned the same polygon as input ###
-     *    4i. Add the polygon into the list
-     *   4ii. Add the corresponding knot span indices of the knot span containing the polygon
-     *    ### Else clip the polygon for every knot span window it is crossing ###
-     *    4i. Loop over all spans in u-direction
+     *    3i. Loop over all triangles of the cell
      *    ->
-     *        4i.1. Loop over all spans in v-direction
-     *        ->
-     *              4i.1i. Initialize a clipper adapter
-     *             4i.1ii. Clip the polygon with the knot span window
-     *             ### Check if the encountered knot span is collapsed ###
-     *             4i.1ii.1. Create the knot span window
-     *             4i.1ii.2. Clip the polygon with the knot span window (WARNING : here we assume to get only a single output polygon from the clipping!)
-     *        <-
+     *        3i.1. Clean triangle
+     *        3i.2. Check if the triangle after cleaning is no more a triangle
+     *        3i.3. Pass the triangle into the integration function
      *    <-
      * <-
-     */
-
-    // 1. Initialize auxiliary variables
-    int span[4];
-
-    // 2. Get the knot vectors of the patch
-    const double *knotVectorU = _thePatch->getIGABasis()->getUBSplineBasis1D()->getKnotVector();
-    const double *knotVectorV = _thePatch->getIGABasis()->getVBSplineBasis1D()->getKnotVector();
-
-    // 3.find the knot span which the current element located in. (from minSpanu to maxSpanu in U-direction, and from minSpanV to max SpanV in V-direction)
-	int isOnSameKnotSpan = computeKnotSpanOfProjElement(_thePatch, _polygonUV,span);
-    int minSpanU = span[0];
-    int maxSpanU = span[1];
-    int minSpanV = span[2];
-    int maxSpanV = span[3];
-
-    // 4. Find the clipped polygon
-    if (isOnSameKnotSpan) { // ### If all vertices of the polygon are on same knot span then returned the same polygon as input ###
-        // 4i. Add the polygon into the list
-		_listPolygon.push_back(_polygonUV);
-
-        // 4ii. Add the corresponding knot span indices of the knot span containing the polygon
-		_listSpan.push_back(make_pair(minSpanU,minSpanV));
-    } else { // ### Else clip the polygon for every knot span window it is crossing ###
-        // 4i. Loop over all spans in u-direction
-		for (int spanU = minSpanU; spanU <= maxSpanU; spanU++) {
-            // 4i.1. Loop over all spans in v-direction
-			for (int spanV = minSpanV; spanV <= maxSpanV; spanV++) {
-                // 4i.1i. Initialize a clipper adapter
-                ClipperAdapter c(EPS_CLIPPING);
-
-                // 4i.1ii. Clip the polygon with the knot span window
-                if (knotVectorU[spanU] != knotVectorU[spanU + 1] && knotVectorV[spanV] != knotVectorV[spanV + 1]) { // ### Check if the encountered knot span is collapsed ###
-                    // 4i.1ii.1. Create the knot span window
-					Polygon2D knotSpanWindow(4);
-                    knotSpanWindow[0] = make_pair(knotVectorU[spanU],knotVectorV[spanV]);
-                    knotSpanWindow[1] = make_pair(knotVectorU[spanU + 1],knotVectorV[spanV]);
-                    knotSpanWindow[2] = make_pair(knotVectorU[spanU + 1],knotVectorV[spanV + 1]);
-                    knotSpanWindow[3] = make_pair(knotVectorU[spanU],knotVectorV[spanV + 1]);
-
-                    // 4i.1ii.2. Clip the polygon with the knot span window (WARNING : here we assume to get only a single output polygon from the clipping!)
-					Polygon2D solution = c.clip(_polygonUV,knotSpanWindow);
-					/// Store polygon and its knot span for integration
-					_listPolygon.push_back(solution);
-					_listSpan.push_back(make_pair(spanU,spanV));
-				}
-			}
-		}
-	}
-}
-
-DataFieldIntegrationNURBS::ListPolygon2D DataFieldIntegrationNURBS::triangulatePolygon(const Polygon2D& _polygonUV) {
-    /*
-     * Triangulates given polygon
-     *
-     * Function layout :
-     *
-     * 1. If the polygon is already a triangle do nothing
-     *
-     * 2. Initialize triangulator
-     *
-     * 3. Loop over all segments of the given polygon and add its ends into the triangulator
      *
-     * 4. Triangulate the polygon
-     *
-     * 5. Fill the output list of the newly generated polygons
-     *
-     * 6. Return the updated list of the triangulated polygons
+     * 4. Count the triangulation paths of the cells for the statistics
      */
 
-    // 1. If the polygon is already a triangle do nothing
-    if(_polygonUV.size() < 4)
-		return ListPolygon2D(1,_polygonUV);
+    // 1. Compute the integration cells of all patches, they are shared with the conditions of the mesh
+    meshIGA->prepareIntegrationCells();
 
-    // 2. Initialize triangulator
-	TriangulatorAdaptor triangulator;
+    // 2. Collect the integration cells of all patches as pairs of patch index and cell index
+    int numPatches = meshIGA->getNumPatches();
+    const int numThreads = AuxiliaryParameters::mapperSetNumThreads;
+    std::vector<std::pair<int, int> > cells;
+    for(int iPatches = 0; iPatches < numPatches; iPatches++) {
+        const int numCells = meshIGA->getSurfacePatch(iPatches)->getIntegrationCells().size();
+        for(int iCell = 0; iCell < numCells; iCell++)
+            cells.push_back(make_pair(iPatches, iCell));
+    }
 
-    // 3. Loop over all segments of the given polygon and add its ends into the triangulator
-    for(Polygon2D::const_iterator it = _polygonUV.begin(); it!=_polygonUV.end(); it++)
-		triangulator.addPoint(it->first,it->second,0);
+    // 3. Loop over all integration cells of all patches in parallel, every thread collects its
+    // entries in its own buffer, or every cell in its own buffer if the assembly has to be
+    // reproducible, they are merged afterwards. The areas of the cells are added in their order.
+    const int numCells = cells.size();
+    std::vector<std::vector<MathLibrary::SparseMatrixTriplet<double> > > buffers(
+            MathLibrary::getNumAssemblyBuffers(numThreads, numCells));
+    std::vector<double> cellAreas(numCells, 0.0);
+#pragma omp parallel num_threads(numThreads)
+    {
+#pragma omp for schedule(dynamic, 16)
+    for(int iCell = 0; iCell < numCells; iCell++) {
+        std::vector<MathLibrary::SparseMatrixTriplet<double> >& buffer = buffers[MathLibrary::getAssemblyBuffer(iCell)];
+        const int iPatches = cells[iCell].first;
+        IGAPatchSurface* patch = meshIGA->getSurfacePatch(iPatches);
+        const IGAPatchSurface::IntegrationCell& cell = patch->getIntegrationCells()[cells[iCell].second];
 
-    // 4. Triangulate the polygon
-	int numTriangles = _polygonUV.size() - 2;
-	int triangleIndexes[3 * numTriangles];
-    bool triangulated = triangulator.triangulate(triangleIndexes);
-	if(!triangulated)
-		return ListPolygon2D();
+        // 3i. Loop over all triangles of the cell
+        for(int iTriangle = 0; iTriangle < cell.triangles.size(); iTriangle++) {
+            // 3i.1. Clean triangle
+            Polygon2D triangle = cell.triangles[iTriangle];
+            ClipperAdapter::cleanPolygon(triangle, EPS_CLEANTRIANGLE);
 
-    // 5. Fill the output list of the newly generated polygons
-	ListPolygon2D out(numTriangles, Polygon2D(3));
-	for(int i = 0; i < numTriangles; i++)
-        for(int j = 0; j < 3; j++)
-            out[i][j] = _polygonUV[triangleIndexes[3*i + j]];
+            // 3i.2. Check if the triangle after cleaning is no more a triangle
+            if(triangle.size() < 3)
+                continue;
 
-    // 6. Return the updated list of the triangulated polygons
-	return out;
+            // 3i.3. Pass the triangle into the integration function
+            cellAreas[iCell] += integrate(patch, iPatches, triangle, cell.spanU, cell.spanV, buffer);
+        }
+    }
+    } //#pragma omp parallel
+    for(int iCell = 0; iCell < numCells; iCell++)
+        areaIntegration += cellAreas[iCell];
+    massMatrix->addTriplets(buffers, numThreads);
+
+    // 4. Count the triangulation paths of the cells
+    for(int iCell = 0; iCell < numCells; iCell++) {
+        const IGAPatchSurface::IntegrationCell& cell =
+                meshIGA->getSurfacePatch(cells[iCell].first)->getIntegrationCells()[cells[iCell].second];
+        for(int iPath = 0; iPath < cell.triangulationPaths.size(); iPath++)
+            numTriangulationsPerPath[cell.triangulationPaths[iPath]]++;
+    }
 }
 
-void DataFieldIntegrationNURBS::integrate(IGAPatchSurface* _thePatch, int _indexPatch, Polygon2D _polygonUV, int _spanU, int _spanV) {
+double DataFieldIntegrationNURBS::integrate(IGAPatchSurface* _thePatch, int _indexPatch, Polygon2D _polygonUV, int _spanU, int _spanV,
+        std::vector<MathLibrary::SparseMatrixTriplet<double> >& _buffer) {
     /*
      * Integrates the triangulated polygons and assembles the mass matrix
      *
@@ -481,13 +253,15 @@ void DataFieldIntegrationNURBS::integrate(IGAPatchSurface* _thePatch, int _index
      * 6viii. Compute the determinant of the Jacobian of the transformation from the physical space to the NURBS parameter space
      *   6ix. Compute the Jacobian of the transformation from the NURBS parameter space to the integration space
      *    6x. Compute the Jacobian products
-     *   6xi. Update the integration area at the Gauss point
+     *   6xi. Update the integrated area at the Gauss point
      *  6xii. Loop over all local basis functions in a nested loop to compute and assemble the local mass matrix
      *   ->
      *        6xii.1. Compute the local basis functions of the dual product RI*RJ
      *        6xii.2. Compute and add the local mass matrix contributions
      *   <-
      * <-
+     *
+     * 7. Return the integrated area
      */
 
     // 1. Check input
@@ -497,7 +271,7 @@ void DataFieldIntegrationNURBS::integrate(IGAPatchSurface* _thePatch, int _index
     assert(numNodesUV < 5);
 
     // 2. Get the corresponding quadrature rule depending on the integration domain
-    EMPIRE::MathLibrary::IGAGaussQuadrature* theGaussQuadrature;
+    const EMPIRE::MathLibrary::IGAGaussQuadrature* theGaussQuadrature;
     int numNodesQuadrature = numNodesUV;
     if (numNodesQuadrature == 3)
         theGaussQuadrature = gaussRuleOnTriangle[_indexPatch];
@@ -549,6 +323,7 @@ void DataFieldIntegrationNURBS::integrate(IGAPatchSurface* _thePatch, int _index
 	}
 
     // 6. Loop over all Gauss points
+    double area = 0.0;
     for (int iGP = 0; iGP < theGaussQuadrature->getNumGaussPoints(); iGP++) {
         // 6i. Get the Gauss point coordinates in the integration space
         const double *gaussPoint = theGaussQuadrature->getGaussPoint(iGP);
@@ -600,8 +375,8 @@ void DataFieldIntegrationNURBS::integrate(IGAPatchSurface* _thePatch, int _index
         // 6x. Compute the Jacobian products
         Jacobian = JacobianUVToPhysical * JacobianCanonicalToUV;
 
-        // 6xi. Update the integration area at the Gauss point
-        areaIntegration += Jacobian * gaussWeight;
+        // 6xi. Update the integrated area at the Gauss point
+        area += Jacobian * gaussWeight;
 
         // 6xii. Loop over all local basis functions in a nested loop to compute and assemble the local mass matrix
         for (int i = 0; i < numBasisFunctions; i++) {
@@ -611,12 +386,16 @@ void DataFieldIntegrationNURBS::integrate(IGAPatchSurface* _thePatch, int _index
                     IGABasisFctsJ = localBasisFunctionsAndDerivatives[_thePatch->getIGABasis()->indexDerivativeBasisFunction(1, 0, 0, j)];
 
                     // 6xii.2. Compute and add the local mass matrix contributions
-                    (*massMatrix)(dofIGA[i], dofIGA[j]) += IGABasisFctsI * IGABasisFctsJ * Jacobian * gaussWeight;
+                    const double massIJ = IGABasisFctsI * IGABasisFctsJ * Jacobian * gaussWeight;
+                    _buffer.push_back(MathLibrary::SparseMatrixTriplet<double>(dofIGA[i], dofIGA[j], massIJ));
                     if(dofIGA[i] != dofIGA[j]) // Because matrix not instantiated as symmetric
-                        (*massMatrix)(dofIGA[j], dofIGA[i]) += IGABasisFctsI * IGABasisFctsJ * Jacobian * gaussWeight;
+                        _buffer.push_back(MathLibrary::SparseMatrixTriplet<double>(dofIGA[j], dofIGA[i], massIJ));
 			}
 		}
     }
+
+    // 7. Return the integrated area
+    return area;
 }
 
 void DataFieldIntegrationNURBS::enforceCnn() {
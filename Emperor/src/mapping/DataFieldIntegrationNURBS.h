@@ -51,21 +51,25 @@ private:
     IGAMesh* meshIGA;
 
     /// Quadrature rule over the triangulated subdomains
-    EMPIRE::MathLibrary::IGAGaussQuadrature **gaussRuleOnTriangle;
+    const EMPIRE::MathLibrary::IGAGaussQuadrature **gaussRuleOnTriangle;
 
     /// Quadrature rule over the non-triangulated subdomains
-    EMPIRE::MathLibrary::IGAGaussQuadrature **gaussRuleOnQuadrilateral;
+    const EMPIRE::MathLibrary::IGAGaussQuadrature **gaussRuleOnQuadrilateral;
 
     /// Integration area
     double areaIntegration;
 
+    /// Number of polygons triangulated by each path of TriangulatorAdaptor::triangulatePolygon
+    std::vector<long> numTriangulationsPerPath;
+
 public:
     /***********************************************************************************************
      * \brief Constructor
      * \param[in] _mesh Pointer to mesh class relies on.
+     * \param[in] _isLumped whether the row sums of the mass matrix are used
      * \author Fabien Pean
      ***********/
-    DataFieldIntegrationNURBS(IGAMesh* mesh);
+    DataFieldIntegrationNURBS(IGAMesh* mesh, bool _isLumped = false);
     /***********************************************************************************************
      * \brief Destructor
      * \author Tianyang Wang
@@ -74,7 +78,8 @@ public:
 
 private:
     /***********************************************************************************************
-     * \brief Compute the mass matrix
+     * \brief Compute the mass matrix on the integration cells of the patches, which are shared with
+     *        the conditions of the mesh. The cells of all patches are integrated in parallel
      * \author Andreas Apostolatos
      ***********/
     void computeMassMatrix();
@@ -85,42 +90,6 @@ private:
      ***********/
     void createGaussQuadratureRules();
 
-    /***********************************************************************************************
-     * \brief Clip the input polygon by the trimming window of the patch
-     * \param[in] _thePatch 	The patch for which trimming curves are used
-     * \param[in] _polygonUV 	An input polygon defined in parametric (i.e. 2D) space
-     * \param[out] _listPolygon	A set of polygons after application of trimming polygon
-     * \author Fabien Pean
-     ***********/
-    void clipByTrimming(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygonUV);
-
-    /***********************************************************************************************
-     * \brief Compute the span of the projected element living in _thePatch
-     * \param[in] _thePatch 	The patch to compute the coupling matrices for
-     * \param[in] _polygonUV 	The resulting from the clipping polygon at each knot span in the NURBS space
-     * \param[out] _span 		An array size 4 containing [minSpanU maxSpanU minSpanV maxSpanV]
-     * \return 					True if inside a single knot span, false otherwise
-     * \author Fabien Pean
-     ***********/
-    bool computeKnotSpanOfProjElement(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, int* _span=NULL);
-
-    /***********************************************************************************************
-     * \brief Clip the input polygon for every knot span of the patch it is crossing
-     * \param[in] _thePatch 	The patch for which trimming curves are used
-     * \param[in] _polygonUV 	An input polygon defined in parametric (i.e. 2D) space
-     * \param[out] _listPolygon	A set of polygons after application of knot span clipping
-     * \param[out] _listSpan	The list of span index every polygon of the list above is linked to
-     * \author Fabien Pean
-     ***********/
-    void clipByKnotSpan(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygon, Polygon2D& _listSpan);
-
-    /***********************************************************************************************
-     * \brief triangulate optimally a 2D input polygon
-     * \param[in] _polygonUV 	An input polygon defined in parametric (i.e. 2D) space
-     * \author Fabien Pean
-     ***********/
-    ListPolygon2D triangulatePolygon(const Polygon2D& _polygonUV);
-
     /***********************************************************************************************
      * \brief Integrate the element coupling matrices and assemble them to the global one
      * \param[in] _thePatch	The patch to compute the coupling matrices for
@@ -128,9 +97,12 @@ private:
      * \param[in] _polygonIGA The resulting from the clipping polygon at each knot span in the NURBS space
      * \param[in] _spanU The knot span index in the u-direction where basis will be evaluated
      * \param[in] _spanV The knot span index in the v-direction where basis will be evaluated
+     * \param[out] _buffer The buffer of the thread the entries of the mass matrix are added to
+     * \return The integrated area
      * \author Andreas Apostolatos, Fabien Pean
      ***********/
-    void integrate(IGAPatchSurface* _thePatch, int _indexPatch, Polygon2D _polygonUV, int _spanU, int _spanV);
+    double integrate(IGAPatchSurface* _thePatch, int _indexPatch, Polygon2D _polygonUV, int _spanU, int _spanV,
+            std::vector<MathLibrary::SparseMatrixTriplet<double> >& _buffer);
 
     /***********************************************************************************************
 	 * \brief Fill empty rows with identity for ensuring numerical stability
@@ -152,7 +124,6 @@ public:
 private:
     /// Tolerance for cleaning a triangle before integrating
     static double EPS_CLEANTRIANGLE;
-    static double EPS_CLIPPING;
 };
 
 } /* namespace EMPIRE */
@@ -0,0 +1,99 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "EnsembleMappingBatch.h"
+#include "MapperAdapter.h"
+#include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+using namespace std;
+
+namespace EMPIRE {
+
+EnsembleMappingBatch::EnsembleMappingBatch(MapperAdapter *_mapper, int _numReplicas,
+        double _window) :
+        mapper(_mapper), numRunningReplicas(_numReplicas), window(_window) {
+    assert(mapper != NULL);
+    assert(numRunningReplicas > 0 && window >= 0.0);
+    isMapping = false;
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&changed, NULL);
+}
+
+EnsembleMappingBatch::~EnsembleMappingBatch() {
+    assert(batches[0].empty() && batches[1].empty() && !isMapping);
+    pthread_cond_destroy(&changed);
+    pthread_mutex_destroy(&mutex);
+}
+
+void EnsembleMappingBatch::map(bool consistent, const DataField *input, DataField *output,
+        double outputFactor) {
+    Request request = { input, output, outputFactor, false };
+    vector<Request*> &batch = batches[consistent ? 0 : 1];
+    pthread_mutex_lock(&mutex);
+    batch.push_back(&request);
+    if (batch.size() > 1) { // the first request of the batch maps it
+        pthread_cond_broadcast(&changed);
+        while (!request.isDone)
+            pthread_cond_wait(&changed, &mutex);
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    double seconds = floor(window);
+    deadline.tv_sec += (time_t) seconds;
+    deadline.tv_nsec += (long) ((window - seconds) * 1e9);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    while ((int) batch.size() < numRunningReplicas)
+        if (pthread_cond_timedwait(&changed, &mutex, &deadline) == ETIMEDOUT)
+            break;
+    // the requests arriving from now on form the next batch, which is mapped after this one
+    vector<Request*> requests;
+    requests.swap(batch);
+    while (isMapping)
+        pthread_cond_wait(&changed, &mutex);
+    isMapping = true;
+    pthread_mutex_unlock(&mutex);
+
+    mapper->mapEnsemble(consistent, requests);
+
+    pthread_mutex_lock(&mutex);
+    isMapping = false;
+    for (unsigned i = 0; i < requests.size(); i++)
+        requests[i]->isDone = true;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&mutex);
+}
+
+void EnsembleMappingBatch::replicaFinished() {
+    pthread_mutex_lock(&mutex);
+    assert(numRunningReplicas > 0);
+    numRunningReplicas--;
+    pthread_cond_broadcast(&changed);
+    pthread_mutex_unlock(&mutex);
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,109 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file EnsembleMappingBatch.h
+ * This file holds the class EnsembleMappingBatch
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef ENSEMBLEMAPPINGBATCH_H_
+#define ENSEMBLEMAPPINGBATCH_H_
+
+#include <vector>
+#include <pthread.h>
+
+namespace EMPIRE {
+
+class MapperAdapter;
+class DataField;
+
+/********//**
+ * \brief Class EnsembleMappingBatch collects the mappings the replicas of an ensemble ask a shared
+ *        mapper for, such that the fields of all replicas are mapped by one product with several
+ *        right hand sides. The coupling thread of every replica calls map, the first request of a
+ *        direction waits until every running replica has asked or the batch window has elapsed and
+ *        then maps the whole batch, the others wait for their results. The requests are mapped
+ *        independently of each other, so the results do not depend on how they are batched.
+ ***********/
+class EnsembleMappingBatch {
+public:
+    /********//**
+     * \brief A mapping asked for by one replica
+     ***********/
+    struct Request {
+        /// the input data
+        const DataField *input;
+        /// the output data
+        DataField *output;
+        /// the factor the output data is scaled with
+        double outputFactor;
+        /// whether the request has been mapped
+        bool isDone;
+    };
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _mapper the mapper shared by the replicas
+     * \param[in] _numReplicas the number of replicas
+     * \param[in] _window the seconds the first request waits for the requests of the other replicas
+     ***********/
+    EnsembleMappingBatch(MapperAdapter *_mapper, int _numReplicas, double _window);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~EnsembleMappingBatch();
+    /***********************************************************************************************
+     * \brief Map the field of one replica together with the fields of the other replicas, returns
+     *        when the output is written
+     * \param[in] consistent true for consistent mapping from A to B, false for conservative mapping
+     *            from B to A
+     * \param[in] input the input data
+     * \param[out] output the output data
+     * \param[in] outputFactor the factor the output data is scaled with
+     ***********/
+    void map(bool consistent, const DataField *input, DataField *output, double outputFactor);
+    /***********************************************************************************************
+     * \brief Tell that a replica has finished its co-simulation, the batches do not wait for its
+     *        requests anymore
+     ***********/
+    void replicaFinished();
+
+private:
+    /// the mapper shared by the replicas
+    MapperAdapter *mapper;
+    /// the number of replicas which have not finished their co-simulation
+    int numRunningReplicas;
+    /// the seconds the first request waits for the others
+    double window;
+    /// the collected requests of the consistent (0) and the conservative (1) mapping
+    std::vector<Request*> batches[2];
+    /// whether a batch is being mapped, the mapper maps one batch at a time
+    bool isMapping;
+    /// protects all members
+    pthread_mutex_t mutex;
+    /// signaled when a request is added, a replica finished or a batch is mapped
+    pthread_cond_t changed;
+    /// disallow copy constructor
+    EnsembleMappingBatch(const EnsembleMappingBatch&);
+    /// disallow assignment operator
+    EnsembleMappingBatch& operator=(const EnsembleMappingBatch&);
+};
+
+} /* namespace EMPIRE */
+#endif /* ENSEMBLEMAPPINGBATCH_H_ */
@@ -28,10 +28,14 @@
 #include "IGAPatchSurface.h"
 #include "IGAMesh.h"
 #include "FEMesh.h"
+#include "FEMeshConnectivity.h"
+#include "FEMeshSpatialIndex.h"
 #include "ClipperAdapter.h"
 #include "TriangulatorAdaptor.h"
 #include "MathLibrary.h"
 #include "DataField.h"
+#include "AuxiliaryParameters.h"
+#include <omp.h>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -63,8 +67,8 @@ IGABarycentricMapper::IGABarycentricMapper(std::string _name, IGAMesh *_meshIGA,
     else
         meshFE = _meshFE->triangulate();
 
-    // Initialize flag on whether the meshFEDirectElemTable was created
-    isMeshFEDirectElemTable = false;
+    // The element freedom tables are set in initTables
+    meshFEConnectivity = NULL;
 
     projectedCoords.resize(meshFE->numNodes);
     projectedCPs.resize(meshIGA->getNumNodes());
@@ -80,7 +84,6 @@ IGABarycentricMapper::IGABarycentricMapper(std::string _name, IGAMesh *_meshIGA,
         numNodesSlave = meshFE->numNodes;
         numNodesMaster = meshIGA->getNumNodes(); // number of CPs
         C_L = new MathLibrary::SparseMatrix<double>(numNodesMaster, numNodesMaster);
-        C_LT = new MathLibrary::SparseMatrix<double>(numNodesMaster, numNodesMaster);
         C_R = new MathLibrary::SparseMatrix<double>(numNodesMaster, numNodesSlave);
     }
 
@@ -90,17 +93,10 @@ IGABarycentricMapper::IGABarycentricMapper(std::string _name, IGAMesh *_meshIGA,
 
 IGABarycentricMapper::~IGABarycentricMapper() {
 
-    if(isMeshFEDirectElemTable){
-        for (int i = 0; i < meshFE->numElems; i++)
-            delete[] meshFEDirectElemTable[i];
-        delete[] meshFEDirectElemTable;
-    }
-
     if (isMappingIGA2FEM) {
         delete C_M;
     } else {
         delete C_L;
-        delete C_LT;
         delete C_R;
         delete numNodesPerNeighborElem;
     }
@@ -137,7 +133,9 @@ void IGABarycentricMapper::buildCouplingMatrices() {
 
     // Compute the EFT for the FE mesh
     initTables();
-    isMeshFEDirectElemTable = true;
+
+    // Clip the trimmed patches once for all projections
+    clipPatches();
 
     if (isMappingIGA2FEM) {
         projectPointsToSurface();
@@ -159,43 +157,8 @@ void IGABarycentricMapper::buildCouplingMatrices() {
 }
 
 void IGABarycentricMapper::initTables() {
-    /* using the map to store the nodeIDs
-     * but here the "key" is the node ID, and the value is the position in nodeIDs
-     * the map is sorted automatically, so it is efficient for searching
-     */
-
-    // compute direct element table for fluid mesh
-    meshFEDirectElemTable = new int*[meshFE->numElems]; // deleted
-    for (int i = 0; i < meshFE->numElems; i++)
-        meshFEDirectElemTable[i] = new int[meshFE->numNodesPerElem[i]];
-
-    map<int, int> meshFENodesMap;
-    for (int i = 0; i < meshFE->numNodes; i++)
-        meshFENodesMap.insert(meshFENodesMap.end(), pair<int, int>(meshFE->nodeIDs[i], i));
-    int count = 0;
-
-    for (int i = 0; i < meshFE->numElems; i++) {
-        const int numNodesPerElem = meshFE->numNodesPerElem[i];
-
-        for (int j = 0; j < numNodesPerElem; j++) {
-            if (meshFENodesMap.find(meshFE->elems[count + j]) == meshFENodesMap.end()) {
-                ERROR_OUT() << "Cannot find node ID " << meshFE->elems[count + j] << endl;
-                exit(-1);
-            }
-            meshFEDirectElemTable[i][j] = meshFENodesMap.at(meshFE->elems[count + j]);
-        }
-        count += numNodesPerElem;
-    }
-
-    for (int node = 0; node < meshFE->numNodes; node++) {
-        for (int elem = 0; elem < meshFE->numElems; elem++) {
-            const int numNodesPerElem = meshFE->numNodesPerElem[elem];
-            int* out = find(meshFEDirectElemTable[elem],meshFEDirectElemTable[elem]+numNodesPerElem,node);
-            if(out != meshFEDirectElemTable[elem]+numNodesPerElem) {
-            	meshFENodeToElementTable[node].push_back(elem);
-            }
-        }
-    }
+    // the element freedom tables are built once by the FE mesh and shared
+    meshFEConnectivity = meshFE->getConnectivity();
 }
 
 void IGABarycentricMapper::projectCPsToSurface() {
@@ -236,18 +199,15 @@ void IGABarycentricMapper::projectCPsToSurface() {
     // Bounding box preprocessing, assign to each node the patches to be visited
     INFO_OUT()<<"Bounding box preprocessing..."<<endl;
     time(&timeStart);
+    vector<int> patchIndicesOfPoint;
 
     for (int i = 0; i < meshIGA->getNumNodes(); i++) {
         double P[3];
         P[0] = meshIGACpNet[i]->getX();
         P[1] = meshIGACpNet[i]->getY();
         P[2] = meshIGACpNet[i]->getZ();
-        for(int patchCount = 0; patchCount < numPatches; patchCount++) {
-            IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(patchCount);
-            bool isInside = thePatch->getBoundingBox().isPointInside(P, projectionProperties.maxProjectionDistance);
-            if(isInside)
-                patchToProcessPerCP[i].insert(patchCount);
-        }
+        meshIGA->findPatchesContainingPoint(P, projectionProperties.maxProjectionDistance, patchIndicesOfPoint);
+        patchToProcessPerCP[i].insert(patchIndicesOfPoint.begin(), patchIndicesOfPoint.end());
 
         if(patchToProcessPerCP[i].empty()) {
             stringstream msg;
@@ -267,13 +227,23 @@ void IGABarycentricMapper::projectCPsToSurface() {
         IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(patchIndex);
         IGAControlPoint **cpNet = thePatch->getControlPointNet();
         int num = thePatch->getNoControlPoints();
+
+        // Compute the projections of the control points of the patch in parallel, nothing is stored in the loop
+        vector<char> batchIsTrimmed(num, 0);
+        vector<char> batchIsComputed(num, 0);
+        vector<char> batchHasConverged(num, 0);
+        vector<double> batchU(num);
+        vector<double> batchV(num);
+        vector<double> batchDistance(num);
+        vector<double> batchProjectedXYZ(3 * num);
+#pragma omp parallel for schedule(dynamic, 16) num_threads(AuxiliaryParameters::mapperSetNumThreads)
         for(int i = 0; i < num; i++) {
             int counterCP = cpNet[i]->getDofIndex();
             // If support of CP is completely in trimmed region, ignore CP
             double u1, u2, v1, v2;
-            knotSpanOfSupportCP(patchIndex, counterCP, u1, u2, v1, v2);
+            knotSpanOfSupportCP(patchIndex, i, u1, u2, v1, v2);
             if (!projectionInside(patchIndex, u1, v1) && !projectionInside(patchIndex, u2, v1) && !projectionInside(patchIndex, u1, v2) && !projectionInside(patchIndex, u2, v2) ) {
-                isProjectionOfCpOnTrimmed[counterCP] = true;
+                batchIsTrimmed[i] = 1;
                 continue;
             }
             // If already projected, go to next CP
@@ -281,11 +251,26 @@ void IGABarycentricMapper::projectCPsToSurface() {
                 continue;
             // If node in BBox of patch
             if(patchToProcessPerCP[counterCP].find(patchIndex) != patchToProcessPerCP[counterCP].end()) {
-                computeInitialGuessForProjectionOfCPs(patchIndex, counterCP, initialU, initialV);
-                bool flagProjected = projectCpOnPatch(patchIndex, counterCP, initialU, initialV, minProjectionDistance[counterCP], minProjectionPoint[counterCP]);
-                isProjected[counterCP] = isProjected[counterCP] || flagProjected;
+                computeInitialGuessForProjectionOfCPs(patchIndex, counterCP, batchU[i], batchV[i]);
+                batchHasConverged[i] = computeCpProjectionOnPatch(patchIndex, counterCP, batchU[i], batchV[i],
+                        &batchProjectedXYZ[3 * i], batchDistance[i]);
+                batchIsComputed[i] = 1;
             }
         }
+
+        // Validate and store the projections in the order of the control points
+        for(int i = 0; i < num; i++) {
+            int counterCP = cpNet[i]->getDofIndex();
+            if (batchIsTrimmed[i]) {
+                isProjectionOfCpOnTrimmed[counterCP] = true;
+                continue;
+            }
+            if (!batchIsComputed[i])
+                continue;
+            bool flagProjected = storeCpProjection(patchIndex, counterCP, batchU[i], batchV[i], &batchProjectedXYZ[3 * i],
+                    batchDistance[i], batchHasConverged[i], minProjectionDistance[counterCP], minProjectionPoint[counterCP]);
+            isProjected[counterCP] = isProjected[counterCP] || flagProjected;
+        }
     }
     time(&timeEnd);
 
@@ -389,20 +374,36 @@ void IGABarycentricMapper::computeInitialGuessForProjectionOfCPs(const int _patc
 }
 
 bool IGABarycentricMapper::projectCpOnPatch(const int _patchIndex, const int _cpIndex, const double _u0, const double _v0, double& _minProjectionDistance, std::vector<double>& _minProjectionPoint) {
-    IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(_patchIndex);
-    /// Get the Cartesian coordinates of the CP
-    double P[3], projectedP[3];
-    projectedP[0] = P[0] = meshIGACpNet[_cpIndex]->getX();
-    projectedP[1] = P[1] = meshIGACpNet[_cpIndex]->getY();
-    projectedP[2] = P[2] = meshIGACpNet[_cpIndex]->getZ();
     /// Get an initial guess for the parametric location of the projected CP on the NURBS patch
     double u = _u0;
     double v = _v0;
+    double projectedP[3];
+    double distance;
+    bool hasConverged = computeCpProjectionOnPatch(_patchIndex, _cpIndex, u, v, projectedP, distance);
+    return storeCpProjection(_patchIndex, _cpIndex, u, v, projectedP, distance, hasConverged, _minProjectionDistance, _minProjectionPoint);
+}
+
+bool IGABarycentricMapper::computeCpProjectionOnPatch(const int _patchIndex, const int _cpIndex, double& _u, double& _v, double* _projectedP, double& _distance) {
+    IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(_patchIndex);
+    /// Get the Cartesian coordinates of the CP
+    double P[3];
+    _projectedP[0] = P[0] = meshIGACpNet[_cpIndex]->getX();
+    _projectedP[1] = P[1] = meshIGACpNet[_cpIndex]->getY();
+    _projectedP[2] = P[2] = meshIGACpNet[_cpIndex]->getZ();
     /// Compute point projection on the NURBS patch using the Newton-Rapshon iteration method
     bool hasResidualConverged;
-    bool hasConverged = thePatch->computePointProjectionOnPatch(u, v, projectedP,
+    bool hasConverged = thePatch->computePointProjectionOnPatch(_u, _v, _projectedP,
             hasResidualConverged, newtonRaphson.maxNumOfIterations, newtonRaphson.tolerance);
-    double distance = MathLibrary::computePointDistance(P, projectedP);
+    _distance = MathLibrary::computePointDistance(P, _projectedP);
+    return hasConverged;
+}
+
+bool IGABarycentricMapper::storeCpProjection(const int _patchIndex, const int _cpIndex, const double _u, const double _v, const double* _projectedP,
+                                             const double _distance, const bool _hasConverged, double& _minProjectionDistance, std::vector<double>& _minProjectionPoint) {
+    double projectedP[3] = {_projectedP[0], _projectedP[1], _projectedP[2]};
+    double u = _u;
+    double v = _v;
+    double distance = _distance;
 
     /// Return false if the projection falls on a trimmed patch region
     if(!projectionInside(_patchIndex, u, v)) {
@@ -410,7 +411,7 @@ bool IGABarycentricMapper::projectCpOnPatch(const int _patchIndex, const int _cp
         return false;
     }
 
-    if(hasConverged && distance < projectionProperties.maxProjectionDistance) {
+    if(_hasConverged && distance < projectionProperties.maxProjectionDistance) {
         /// Perform some validity checks to validate the projected point
         if(distance > _minProjectionDistance + projectionProperties.maxDistanceForProjectedPointsOnDifferentPatches) {
             return false;
@@ -439,14 +440,6 @@ bool IGABarycentricMapper::projectCpOnPatch(const int _patchIndex, const int _cp
 void IGABarycentricMapper::computeNeighborsAndWeights() {
     // Array that holds the number of nodes of each element
     numNodesPerNeighborElem = new int[meshIGA->getNumNodes()];
-    // Compute elementCentroids
-    double *elementCentroids = new double[meshFE->numElems * 3];
-    for (int i = 0; i < meshFE->numElems; i++) { // compute the centroid of all elements in FE mesh
-        int numNodesThisElem = meshFE->numNodesPerElem[i];
-        double thisElem[numNodesThisElem * 3];
-        getElemCoorInFEMMesh(i, thisElem);
-        EMPIRE::MathLibrary::computePolygonCenter(thisElem, numNodesThisElem, &(elementCentroids[i * 3]));
-    }
 
     int NUM_NEIGHBORS_TO_SEARCH = MAX_NUM_NEIGHBORS_TO_SEARCH;
     if (NUM_NEIGHBORS_TO_SEARCH > meshFE->numElems) {
@@ -456,6 +449,7 @@ void IGABarycentricMapper::computeNeighborsAndWeights() {
     {
     #ifdef FLANN
         double *castedCPs = new double[meshIGA->getNumNodes() * 3];
+#pragma omp parallel for schedule(dynamic, 64) num_threads(AuxiliaryParameters::mapperSetNumThreads)
         for (int i = 0; i < meshIGA->getNumNodes(); ++i) {
             if (!isProjectionOfCpOnTrimmed[i]) {
                 IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(projectedCPs[i].begin()->first);
@@ -468,15 +462,14 @@ void IGABarycentricMapper::computeNeighborsAndWeights() {
             }
         }
 
-        /// Build binary tree for searching
         const double *constCPs = const_cast<double*>(castedCPs);
-        flann::Matrix<double> *elementCentroids_FLANN = new flann::Matrix<double>(
-                const_cast<double*>(elementCentroids), meshFE->numElems, 3);
-        flann::Index<flann::L2<double> > *ANodesTree = new flann::Index<flann::L2<double> >(
-                *elementCentroids_FLANN, flann::KDTreeSingleIndexParams(1));
-        ANodesTree->buildIndex();
+        /// The searching tree over the element centroids is shared by all mappers of the FE mesh
+        flann::Index<flann::L2<double> > *ANodesTree =
+                meshFE->getSpatialIndex()->getElemCentroidsTree();
 
         /// Traverse through all valid CPs and project them to the FE mesh; store element index and local element coordinates
+        /// The searches only read the tree and every CP writes its own entries, so the CPs are processed in parallel
+#pragma omp parallel for schedule(dynamic, 64) num_threads(AuxiliaryParameters::mapperSetNumThreads)
         for (int i = 0; i < meshIGA->getNumNodes(); i++) {
             if (!isProjectionOfCpOnTrimmed[i]) {
                 flann::Matrix<double> nodeI(&(castedCPs[i * 3]), 1, 3);
@@ -612,18 +605,13 @@ void IGABarycentricMapper::computeNeighborsAndWeights() {
                 }
             }
         }
-        delete elementCentroids_FLANN;
-        delete ANodesTree;
-        delete castedCPs;
+        delete[] castedCPs;
     #endif
     }
-    delete[] elementCentroids;
 }
 
-void IGABarycentricMapper::knotSpanOfSupportCP(const int _patchIndex, const int _cpIndex, double& _u1, double& _u2, double& _v1, double& _v2) {
+void IGABarycentricMapper::knotSpanOfSupportCP(const int _patchIndex, const int _cpLocalIndex, double& _u1, double& _u2, double& _v1, double& _v2) {
     IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(_patchIndex);
-    IGAControlPoint **cpNet = thePatch->getControlPointNet();
-    int numCPsInPatch = thePatch->getNoControlPoints();
     int pDegree = thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
     int qDegree = thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
     double * pKnotVector = thePatch->getIGABasis()->getUBSplineBasis1D()->getKnotVector();
@@ -633,16 +621,8 @@ void IGABarycentricMapper::knotSpanOfSupportCP(const int _patchIndex, const int
     int pNumCP = pNumKnots - pDegree - 1;
     int qNumCP = qNumKnots - qDegree - 1;
 
-    int i;
-    for(i = 0; i < numCPsInPatch; i++) {
-        if (cpNet[i]->getDofIndex() == _cpIndex)
-            break;
-    }
-
-    if (i == numCPsInPatch) {
-        ERROR_OUT() << "Trying to find support for foreign control point [" << _cpIndex << "] to patch [" << _patchIndex << "] !\n";
-        return;
-    }
+    int i = _cpLocalIndex;
+    assert(i >= 0 && i < thePatch->getNoControlPoints());
 
     int ip, iq;
     ip = i % pNumCP;
@@ -658,7 +638,7 @@ void IGABarycentricMapper::getElemCoorInFEMMesh(int elemIndex, double *elem) {
     // compute the coordinates of an element by its id
     int numNodesThisElem = meshFE->numNodesPerElem[elemIndex];
     for (int i = 0; i < numNodesThisElem; i++) {
-        int nodePos = meshFEDirectElemTable[elemIndex][i]; // position of the node
+        int nodePos = meshFEConnectivity->getElemNodes(elemIndex)[i]; // position of the node
         for (int j = 0; j < 3; j++) {
             elem[i * 3 + j] = meshFE->nodes[nodePos * 3 + j];
         }
@@ -716,18 +696,15 @@ void IGABarycentricMapper::projectPointsToSurface() {
     // Bounding box preprocessing, assign to each node the patches to be visited
     INFO_OUT()<<"Bounding box preprocessing..."<<endl;
     time(&timeStart);
+    vector<int> patchIndicesOfPoint;
 
     for (int i = 0; i < meshFE->numNodes; i++) {
     	double P[3];
     	P[0] = meshFE->nodes[3 * i + 0];
     	P[1] = meshFE->nodes[3 * i + 1];
     	P[2] = meshFE->nodes[3 * i + 2];
-        for(int patchCount = 0; patchCount < numPatches; patchCount++) {
-            IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(patchCount);
-            bool isInside = thePatch->getBoundingBox().isPointInside(P, projectionProperties.maxProjectionDistance);
-            if(isInside)
-            	patchToProcessPerNode[i].insert(patchCount);
-        }
+        meshIGA->findPatchesContainingPoint(P, projectionProperties.maxProjectionDistance, patchIndicesOfPoint);
+        patchToProcessPerNode[i].insert(patchIndicesOfPoint.begin(), patchIndicesOfPoint.end());
 
         if(patchToProcessPerNode[i].empty()) {
             stringstream msg;
@@ -750,7 +727,7 @@ void IGABarycentricMapper::projectPointsToSurface() {
             IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(patchIndex);
             bool initialGuessComputed = false;
             for(int j = 0; j < numNodesInElem; j++) {
-                int nodeIndex = meshFEDirectElemTable[i][j];
+                int nodeIndex = meshFEConnectivity->getElemNodes(i)[j];
                 // If already projected, go to next node
                 if(projectedCoords[nodeIndex].find(patchIndex) != projectedCoords[nodeIndex].end())
                     continue;
@@ -787,7 +764,7 @@ void IGABarycentricMapper::projectPointsToSurface() {
                 newtonRaphson.tolerance = 10*newtonRaphson.tolerance;
                 for(set<int>::iterator patchIndex=patchToProcessPerNode[i].begin();patchIndex!=patchToProcessPerNode[i].end();patchIndex++) {
                     IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(*patchIndex);
-                    computeInitialGuessForProjection(*patchIndex, meshFENodeToElementTable[i][0], i, initialU, initialV);
+                    computeInitialGuessForProjection(*patchIndex, meshFEConnectivity->getNodeElems(i)[0], i, initialU, initialV);
                     bool flagProjected = projectPointOnPatch(*patchIndex, i, initialU, initialV, minProjectionDistance[i], minProjectionPoint[i]);
                     isProjected[i] = isProjected[i] || flagProjected;
                 }
@@ -823,7 +800,7 @@ void IGABarycentricMapper::computeInitialGuessForProjection(const int _patchInde
     int projectedNode = -1;
 	/// 2. Loop over all nodes of the current element to check if there exist one node has been projected already
     for (int j = 0; j < meshFE->numNodesPerElem[_elemIndex]; j++) {
-    	int nodeIndex = meshFEDirectElemTable[_elemIndex][j];
+    	int nodeIndex = meshFEConnectivity->getElemNodes(_elemIndex)[j];
         if (projectedCoords[nodeIndex].find(_patchIndex) != projectedCoords[nodeIndex].end()) {
             /// 1iii.2i. If the node has already been projected set projection flag to true
             isNodeInsideElementProjected = true;
@@ -904,12 +881,13 @@ bool IGABarycentricMapper::forceProjectPointOnPatch(const int patchIndex, const
     /// Get an initial guess for the parametric location of the projected node of the FE side on the NURBS patch
     double u = 0;
     double v = 0;
-    for(vector<int>::const_iterator it=meshFENodeToElementTable[nodeIndex].begin();it!=meshFENodeToElementTable[nodeIndex].end();it++) {
+    const int *elemsOfNode = meshFEConnectivity->getNodeElems(nodeIndex);
+    for(const int *it=elemsOfNode;it!=elemsOfNode+meshFEConnectivity->getNumElemsOfNode(nodeIndex);it++) {
     	const int numNodesPerElem = meshFE->numNodesPerElem[*it];
     	for(int i = 0; i< numNodesPerElem; i++) {
-    		if(projectedCoords[meshFEDirectElemTable[*it][i]].find(patchIndex) != projectedCoords[meshFEDirectElemTable[*it][i]].end()) {
-    			u=projectedCoords[meshFEDirectElemTable[*it][i]][patchIndex][0];
-    			v=projectedCoords[meshFEDirectElemTable[*it][i]][patchIndex][1];
+    		if(projectedCoords[meshFEConnectivity->getElemNodes(*it)[i]].find(patchIndex) != projectedCoords[meshFEConnectivity->getElemNodes(*it)[i]].end()) {
+    			u=projectedCoords[meshFEConnectivity->getElemNodes(*it)[i]][patchIndex][0];
+    			v=projectedCoords[meshFEConnectivity->getElemNodes(*it)[i]][patchIndex][1];
     		}
     	}
     }
@@ -942,14 +920,11 @@ bool IGABarycentricMapper::projectionInside(const int _patchIndex, const double
     /// Examine each projection, whether it is in trimmed region or not
     Point2D projectedPoint;
     projectedPoint = make_pair(_u, _v);
-    IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(_patchIndex);
 
-    /// Save trimmed patch to list polygon
-    ListPolygon2D listTrimmedPolygon;
-    clipPatch(thePatch, listTrimmedPolygon);
-    for (int i = 0; i < listTrimmedPolygon.size(); ++i)
-        ClipperAdapter::cleanPolygon(listTrimmedPolygon[i]);
-    
+    /// The trimmed patch is clipped once by clipPatches
+    assert((size_t) _patchIndex < trimmedPatchPolygons.size());
+    const ListPolygon2D& listTrimmedPolygon = trimmedPatchPolygons[_patchIndex];
+
     bool isPointIn = false; // returns true if point is inside the trimmed patch
     bool isPointOn = false; // returns true if point is on the boundary of the trimmed patch
 
@@ -1002,13 +977,28 @@ void IGABarycentricMapper::clipPatch(const IGAPatchSurface* _thePatch, ListPolyg
     }
 }
 
+void IGABarycentricMapper::clipPatches() {
+    int numPatches = meshIGA->getNumPatches();
+    trimmedPatchPolygons.assign(numPatches, ListPolygon2D());
+#pragma omp parallel for schedule(dynamic, 1) num_threads(AuxiliaryParameters::mapperSetNumThreads)
+    for (int patchIndex = 0; patchIndex < numPatches; patchIndex++) {
+        ListPolygon2D& listTrimmedPolygon = trimmedPatchPolygons[patchIndex];
+        clipPatch(meshIGA->getSurfacePatch(patchIndex), listTrimmedPolygon);
+        for (int i = 0; i < listTrimmedPolygon.size(); ++i)
+            ClipperAdapter::cleanPolygon(listTrimmedPolygon[i]);
+    }
+}
+
 void IGABarycentricMapper::computeCouplingMatrices() {
     /*
      * Computes the coupling matrices C_M or C_L and C_R.
+     * The rows are computed in parallel, every thread collects its entries in a triplet buffer which are merged
+     * into the matrices at the end. The matrices are frozen afterwards.
      * 1. Mapping is from IGA surface to FE mesh
      * ->
      * 1i. Loop over all the elements in the FE side
      * 1ii. Compute the coupling matrix C_M
+     * 1iii. Merge the buffers into C_M and freeze it
      * <-
      *
      * 2. Mapping is from FE mesh to IGA surface
@@ -1016,6 +1006,7 @@ void IGABarycentricMapper::computeCouplingMatrices() {
      * 2i. Loop over all IGA surface control points
      * 2ii. Compute the coupling matrix C_L
      * 2iii. Compute the coupling matrix C_R
+     * 2iv. Merge the buffers into C_L and C_R and freeze them
      * <-
      */
 
@@ -1023,10 +1014,16 @@ void IGABarycentricMapper::computeCouplingMatrices() {
 	time_t timeStart, timeEnd;
 
     time(&timeStart);
+    const int numThreads = AuxiliaryParameters::mapperSetNumThreads;
     /// 1. Mapping is from IGA surface to FE mesh
     if (isMappingIGA2FEM) {
+        std::vector<std::vector<MathLibrary::SparseMatrixTriplet<double> > > bufferC_M(numThreads);
+
         /// 1i. Loop through all nodes of master surface (FE)
+#pragma omp parallel for schedule(dynamic, 64) num_threads(numThreads)
         for (int counterNodeFE = 0; counterNodeFE < meshFE->numNodes; ++counterNodeFE) {
+            std::vector<MathLibrary::SparseMatrixTriplet<double> > &buffer = bufferC_M[omp_get_thread_num()];
+
             // get patch index
             int patchIndex = projectedCoords[counterNodeFE].begin()->first;
             
@@ -1057,16 +1054,25 @@ void IGABarycentricMapper::computeCouplingMatrices() {
             /// 1ii. Compute the coupling matrix C_M
             for (int i = 0; i < nShapeFuncsIGA; ++i) {
                 int position = cpNet[dofIGA[i]]->getDofIndex();
-                (*C_M)(counterNodeFE, position) += basisFctsMaster[i];
+                buffer.push_back(MathLibrary::SparseMatrixTriplet<double>(counterNodeFE, position, basisFctsMaster[i]));
             }
         }
+
+        /// 1iii. Merge the buffers into C_M and freeze it
+        C_M->addTriplets(bufferC_M, numThreads);
+        C_M->freeze();
     } else {
         /// 2. Mapping is from FE mesh to IGA surface
         int numNodesIGA = meshIGA->getNumNodes();
         int numNodesFEM = meshFE->numNodes;
+        std::vector<std::vector<MathLibrary::SparseMatrixTriplet<double> > > bufferC_L(numThreads);
+        std::vector<std::vector<MathLibrary::SparseMatrixTriplet<double> > > bufferC_R(numThreads);
 
         /// 2i. Loop over all IGA surface control points
+#pragma omp parallel for schedule(dynamic, 64) num_threads(numThreads)
         for (int counterCP = 0; counterCP < numNodesIGA; ++counterCP) {
+            std::vector<MathLibrary::SparseMatrixTriplet<double> > &bufferL = bufferC_L[omp_get_thread_num()];
+            std::vector<MathLibrary::SparseMatrixTriplet<double> > &bufferR = bufferC_R[omp_get_thread_num()];
             if(!isProjectionOfCpOnTrimmed[counterCP]) {
                 /// Build left hand side matrix
                 // get patch index
@@ -1101,8 +1107,7 @@ void IGABarycentricMapper::computeCouplingMatrices() {
                     int position1 = counterCP;
                     int position2 = cpNet[dofIGA[i]]->getDofIndex();
                     double value = basisFctsMaster[i];
-                    (*C_L)(position1, position2) = value;
-                    (*C_LT)(position2, position1) = value;
+                    bufferL.push_back(MathLibrary::SparseMatrixTriplet<double>(position1, position2, value));
                 }
 
                 /// 2iii. Compute the coupling matrix C_R
@@ -1120,16 +1125,21 @@ void IGABarycentricMapper::computeCouplingMatrices() {
                 }
                 for (int k = 0; k < numNodesPerNeighborElem[counterCP]; ++k) {
                     int position1 = counterCP;
-                    int position2 = meshFEDirectElemTable[elemIndex][k];
-                    (*C_R)(position1, position2) = weights[k];
+                    int position2 = meshFEConnectivity->getElemNodes(elemIndex)[k];
+                    bufferR.push_back(MathLibrary::SparseMatrixTriplet<double>(position1, position2, weights[k]));
                 }
             } else {
-                (*C_L)(counterCP, counterCP) = 1.0; // if CP is projected on a trimmed region, ignore it
-                (*C_LT)(counterCP, counterCP) = 1.0;
-                (*C_R)(counterCP, 0) = 1.0; // this basically assigns the stress of the first FEM node to every CP that's ignored; required for
-                                            // consistency of mapping
+                bufferL.push_back(MathLibrary::SparseMatrixTriplet<double>(counterCP, counterCP, 1.0)); // if CP is projected on a trimmed region, ignore it
+                bufferR.push_back(MathLibrary::SparseMatrixTriplet<double>(counterCP, 0, 1.0)); // this basically assigns the stress of the first FEM node to every CP that's ignored; required for
+                                                                                                // consistency of mapping
             }
         }
+
+        /// 2iv. Merge the buffers into C_L and C_R and freeze them
+        C_L->addTriplets(bufferC_L, numThreads);
+        C_R->addTriplets(bufferC_R, numThreads);
+        C_L->freeze();
+        C_R->freeze();
     }
 
     time(&timeEnd);
@@ -1167,7 +1177,7 @@ void IGABarycentricMapper::conservativeMapping(const double* _masterField, doubl
         C_M->transposeMulitplyVec(const_cast<double *>(_masterField), _slaveField, numNodesMaster);
     } else {
         double* tmpVec = new double[numNodesMaster];
-        C_LT->solve(tmpVec, const_cast<double *>(_masterField));
+        C_L->solveTranspose(tmpVec, const_cast<double *>(_masterField));
         C_R->transposeMulitplyVec(tmpVec, _slaveField, numNodesMaster);
 
         delete[] tmpVec;
@@ -45,6 +45,7 @@ template<class T> class SparseMatrix;
 class IGAPatchSurface;
 class IGAMesh;
 class FEMesh;
+class FEMeshConnectivity;
 class DataField;
 
 
@@ -67,14 +68,8 @@ private:
     /// Fluid Mesh
     FEMesh *meshFE;
 
-    /// Flag on whether the meshFEDirectElemTable was created
-    bool isMeshFEDirectElemTable;
-
-    /// The element freedom table for the fluid mesh
-    int **meshFEDirectElemTable;
-
-    /// The reverse element freedom table for the fluid mesh
-    std::map<int, std::vector<int> > meshFENodeToElementTable;
+    /// The element freedom and the reverse element freedom tables of the fluid mesh, owned by the mesh
+    const FEMeshConnectivity *meshFEConnectivity;
 
     /// The IGA to FEM coupling matrix
     MathLibrary::SparseMatrix<double> *C_M;
@@ -82,9 +77,6 @@ private:
     /// The FEM to IGA left hand side coupling matrix
     MathLibrary::SparseMatrix<double> *C_L;
 
-    /// The FEM to IGA left hand side transpose coupling matrix
-    MathLibrary::SparseMatrix<double> *C_LT;
-
     /// The FEM to IGA right hand side coupling matrix
     MathLibrary::SparseMatrix<double> *C_R;
 
@@ -105,6 +97,9 @@ private:
 
     std::vector<bool> isProjectionOfCpOnTrimmed;
 
+    /// The trimmed parameter domain of every patch, clipped once before the projections
+    std::vector<ListPolygon2D> trimmedPatchPolygons;
+
     int numOfValidCPs;
 
     /// The number of nodes that the neighboring element to a control point has
@@ -197,7 +192,7 @@ public:
     /// intern function used for mapping
 private:
     /***********************************************************************************************
-     * \brief Initialization of the element freedom tables
+     * \brief Initialization of the element freedom tables, they are shared with the FE mesh
      * \author Chenshen Wu
      ***********/
     void initTables();
@@ -230,17 +225,46 @@ private:
      ***********/
     bool projectCpOnPatch(const int _patchIndex, const int _cpIndex, const double _u0, const double _v0, double& _minProjectionDistance, std::vector<double>& _minProjectionPoint);
 
+    /***********************************************************************************************
+     * \brief Compute the projection of a control point on a patch using Newton-Raphson, nothing is stored
+     *        such that the control points can be projected in parallel
+     * \param[in] _patchIndex The index of the patch we are working on
+     * \param[in] _cpIndex The global index of the control point we are working with
+     * \param[in/out] _u The initial guess and the projection in u direction
+     * \param[in/out] _v The initial guess and the projection in v direction
+     * \param[out] _projectedP The Cartesian coordinates of the projection
+     * \param[out] _distance The distance between the control point and its projection
+     * \return Whether the Newton-Raphson iterations converged
+     ***********/
+    bool computeCpProjectionOnPatch(const int _patchIndex, const int _cpIndex, double& _u, double& _v, double* _projectedP, double& _distance);
+
+    /***********************************************************************************************
+     * \brief Validate a projection of a control point against its projections on the other patches and store it
+     * \param[in] _patchIndex The index of the patch we are working on
+     * \param[in] _cpIndex The global index of the control point we are working with
+     * \param[in] _u The projection in u direction
+     * \param[in] _v The projection in v direction
+     * \param[in] _projectedP The Cartesian coordinates of the projection
+     * \param[in] _distance The distance between the control point and its projection
+     * \param[in] _hasConverged Whether the Newton-Raphson iterations converged
+     * \param[out] _minProjectionDistance The previous distance computed
+     * \param[out] _minProjectionPoint The previous point computed
+     * \return Whether the projection is stored
+     ***********/
+    bool storeCpProjection(const int _patchIndex, const int _cpIndex, const double _u, const double _v, const double* _projectedP,
+                           const double _distance, const bool _hasConverged, double& _minProjectionDistance, std::vector<double>& _minProjectionPoint);
+
     /***********************************************************************************************
      * \brief Compute the knot span of a control point's shape function's support from the knot vector
-     * \param[in] _thePatch The patch we are working on
-     * \param[in] _cpIndex The index of the CP we are working with
+     * \param[in] _patchIndex The index of the patch we are working on
+     * \param[in] _cpLocalIndex The index of the CP in the control point net of the patch
      * \param[out] _u1 The start local coordinate in u direction
      * \param[out] _u2 The end local coordinate in u direction
      * \param[out] _v1 The start local coordinate in v direction
      * \param[out] _v2 The end local coordinate in v direction
      * \author Apostolos Petalas
      ***********/
-    void knotSpanOfSupportCP(const int _patchIndex, const int _cpIndex, double& _u1, double& _u2, double& _v1, double& _v2);
+    void knotSpanOfSupportCP(const int _patchIndex, const int _cpLocalIndex, double& _u1, double& _u2, double& _v1, double& _v2);
 
     /***********************************************************************************************
      * \brief Fills up the array projectedCPsOnFEMesh by computing the projection on the FE mesh of the projections of the CPs on the IGA surface
@@ -319,9 +343,15 @@ private:
      * \author Apostolos Petalas
      ***********/
     void clipPatch(const IGAPatchSurface* _thePatch, ListPolygon2D& _listPolygon);
+
+    /***********************************************************************************************
+     * \brief Clip all patches in parallel and keep their trimmed parameter domains for projectionInside
+     ***********/
+    void clipPatches();
     
     /***********************************************************************************************
-     * \brief Compute matrices C_M, C_L and C_R by looping over the FE elements or over the control points and processing them
+     * \brief Compute matrices C_M, C_L and C_R by looping over the FE elements or over the control points and processing them.
+     *        The rows are computed in parallel into triplet buffers, the matrices are frozen afterwards.
      * \author Apostolos Petalas
      ***********/
     void computeCouplingMatrices();
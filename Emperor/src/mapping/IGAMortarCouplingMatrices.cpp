@@ -30,6 +30,7 @@
 #include "TriangulatorAdaptor.h"
 #include "MathLibrary.h"
 #include "DataField.h"
+#include "BlockSparseMatrix.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -42,15 +43,21 @@ using namespace std;
 
 namespace EMPIRE {
 
-IGAMortarCouplingMatrices::IGAMortarCouplingMatrices(int _size_N , int _size_R, bool _isExpanded)
+const size_t IGAMortarCouplingMatrices::MAX_BUFFER_SIZE = 1 << 20;
+
+IGAMortarCouplingMatrices::IGAMortarCouplingMatrices(int _size_N , int _size_R, bool _isExpanded,
+        bool _isSymmetricCnn)
 {
     // Initialize sizes
     size_N = _size_N;
     size_R = _size_R;
+    numFree = size_N;
 
     // Initialize coupling matrices
-    Cnn = new MathLibrary::SparseMatrix<double>(size_N, false);
+    Cnn = new MathLibrary::SparseMatrix<double>(size_N, _isSymmetricCnn);
     Cnr = new MathLibrary::SparseMatrix<double>(size_N, size_R);
+    CnrBlocks = NULL;
+    isBufferPerItem = false;
 
     // Flag on whether the expanded version of the coupling matrices is assumed
     isExpanded = _isExpanded;
@@ -60,15 +67,328 @@ IGAMortarCouplingMatrices::IGAMortarCouplingMatrices(int _size_N , int _size_R,
 IGAMortarCouplingMatrices::~IGAMortarCouplingMatrices() {
     delete Cnn;
     delete Cnr;
+    delete CnrBlocks;
 }
 
 void IGAMortarCouplingMatrices::factorizeCnn() {
     Cnn->factorize();
 }
 
+void IGAMortarCouplingMatrices::initBuffers(int _numThreads, int _numItems) {
+    int numBuffers = MathLibrary::getNumAssemblyBuffers(_numThreads, _numItems);
+    isBufferPerItem = AuxiliaryParameters::reproducible;
+    bufferCnn.resize(numBuffers);
+    bufferCnr.resize(numBuffers);
+}
+
+void IGAMortarCouplingMatrices::flushBufferIfFull(int _buffer) {
+    if (isBufferPerItem || bufferCnn[_buffer].size() + bufferCnr[_buffer].size() < MAX_BUFFER_SIZE)
+        return;
+    std::vector<std::vector<MathLibrary::SparseMatrixTriplet<double> > > buffer(1);
+#pragma omp critical (IGAMortarCouplingMatricesFlush)
+    {
+        buffer[0].swap(bufferCnn[_buffer]);
+        Cnn->addTriplets(buffer);
+        buffer[0].swap(bufferCnr[_buffer]);
+        Cnr->addTriplets(buffer);
+    }
+}
+
+void IGAMortarCouplingMatrices::assembleBuffers(int _numThreads) {
+    Cnn->addTriplets(bufferCnn, _numThreads);
+    Cnr->addTriplets(bufferCnr, _numThreads);
+    bufferCnn.clear();
+    bufferCnr.clear();
+}
+
+void IGAMortarCouplingMatrices::freezeCouplingMatrices() {
+    Cnn->freeze();
+    Cnr->freeze();
+}
+
+/***********************************************************************************************
+ * \brief Permute the rows and the columns of a frozen symmetric matrix in place, an entry moved
+ *        below the diagonal is stored at its mirrored position
+ * \param[in,out] matrix the matrix, frozen again on return
+ * \param[in] newPositionOfOld new position of every row and column
+ ***********/
+static void permuteSymmetricMatrix(MathLibrary::SparseMatrix<double> *matrix,
+        const vector<int> &newPositionOfOld) {
+    assert(matrix->getIsSymmetric());
+    vector<int> rowPtr, cols;
+    vector<double> vals;
+    matrix->getCSR(rowPtr, cols, vals);
+    int numRows = rowPtr.size() - 1;
+
+    vector<int> newRowPtr(numRows + 1, 0);
+    for (int i = 0; i < numRows; i++)
+        for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+            newRowPtr[min(newPositionOfOld[i], newPositionOfOld[cols[k]]) + 1]++;
+    for (int i = 0; i < numRows; i++)
+        newRowPtr[i + 1] += newRowPtr[i];
+    vector<pair<int, double> > entries(vals.size());
+    vector<int> next(newRowPtr.begin(), newRowPtr.end() - 1);
+    for (int i = 0; i < numRows; i++) {
+        for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+            int row = newPositionOfOld[i];
+            int col = newPositionOfOld[cols[k]];
+            if (row > col)
+                swap(row, col);
+            entries[next[row]++] = make_pair(col, vals[k]);
+        }
+    }
+    vector<int> newCols(entries.size());
+    vector<double> newVals(entries.size());
+    for (int i = 0; i < numRows; i++) {
+        sort(entries.begin() + newRowPtr[i], entries.begin() + newRowPtr[i + 1]);
+        for (int k = newRowPtr[i]; k < newRowPtr[i + 1]; k++) {
+            newCols[k] = entries[k].first;
+            newVals[k] = entries[k].second;
+        }
+    }
+    matrix->resetValues();
+    matrix->setCSR(newRowPtr, newCols, newVals);
+}
+
+/***********************************************************************************************
+ * \brief Permute the rows and optionally the columns of a frozen unsymmetric matrix in place
+ * \param[in,out] matrix the matrix, frozen again on return
+ * \param[in] newRowOfOld new position of every row
+ * \param[in] newColumnOfOld new position of every column, NULL to keep the columns
+ ***********/
+static void permuteMatrix(MathLibrary::SparseMatrix<double> *matrix, const vector<int> &newRowOfOld,
+        const vector<int> *newColumnOfOld) {
+    assert(!matrix->getIsSymmetric());
+    vector<int> rowPtr, cols;
+    vector<double> vals;
+    matrix->getCSR(rowPtr, cols, vals);
+    int numRows = rowPtr.size() - 1;
+    vector<int> oldRowOfNew(numRows);
+    for (int i = 0; i < numRows; i++)
+        oldRowOfNew[newRowOfOld[i]] = i;
+
+    vector<int> newRowPtr(numRows + 1, 0);
+    vector<int> newCols;
+    vector<double> newVals;
+    newCols.reserve(cols.size());
+    newVals.reserve(vals.size());
+    vector<pair<int, double> > row;
+    for (int i = 0; i < numRows; i++) {
+        int oldRow = oldRowOfNew[i];
+        row.clear();
+        for (int k = rowPtr[oldRow]; k < rowPtr[oldRow + 1]; k++)
+            row.push_back(make_pair(newColumnOfOld ? (*newColumnOfOld)[cols[k]] : cols[k], vals[k]));
+        sort(row.begin(), row.end());
+        for (size_t k = 0; k < row.size(); k++) {
+            newCols.push_back(row[k].first);
+            newVals.push_back(row[k].second);
+        }
+        newRowPtr[i + 1] = newCols.size();
+    }
+    matrix->resetValues();
+    matrix->setCSR(newRowPtr, newCols, newVals);
+}
+
+void IGAMortarCouplingMatrices::reorderCouplingMatrices() {
+    assert(Cnn->getIsFrozen() && Cnr->getIsFrozen());
+    assert(!isBlocked() && numFree == size_N);
+    vector<int> rowPtr, cols;
+    vector<double> vals;
+    Cnn->getCSR(rowPtr, cols, vals);
+    vector<int> newOrder;
+    if (isExpanded) {
+        // order the nodes by the pattern of the 3x3 blocks and number their unknowns one after the other
+        const int BLOCK_SIZE = MathLibrary::BlockSparseMatrix::BLOCK_SIZE;
+        assert(size_N % BLOCK_SIZE == 0);
+        MathLibrary::BlockSparseMatrix CnnBlocks(size_N / BLOCK_SIZE, size_N / BLOCK_SIZE);
+        CnnBlocks.setCSR(rowPtr, cols, vals);
+        const vector<int> &blockCols = CnnBlocks.getBlockCols();
+        vector<int> nodeOrder;
+        MathLibrary::computeReverseCuthillMcKeeOrder(CnnBlocks.getNumBlockRows(),
+                &CnnBlocks.getBlockRowPtr()[0], blockCols.empty() ? NULL : &blockCols[0], nodeOrder);
+        newOrder.resize(size_N);
+        for (size_t k = 0; k < nodeOrder.size(); k++)
+            for (int c = 0; c < BLOCK_SIZE; c++)
+                newOrder[BLOCK_SIZE * k + c] = BLOCK_SIZE * nodeOrder[k] + c;
+    } else
+        MathLibrary::computeReverseCuthillMcKeeOrder(size_N, &rowPtr[0],
+                cols.empty() ? NULL : &cols[0], newOrder);
+    vector<int> newPosition(size_N);
+    for (size_t k = 0; k < size_N; k++)
+        newPosition[newOrder[k]] = k;
+    if (Cnn->getIsSymmetric())
+        permuteSymmetricMatrix(Cnn, newPosition);
+    else
+        permuteMatrix(Cnn, newPosition, &newPosition);
+    permuteMatrix(Cnr, newPosition, NULL);
+    order.swap(newOrder);
+}
+
+void IGAMortarCouplingMatrices::eliminateConstrainedUnknowns() {
+    assert(Cnn->getIsFrozen() && Cnr->getIsFrozen());
+    assert(!isBlocked() && numFree == size_N);
+    if (indexEmptyRowCnn.empty())
+        return;
+    vector<int> rowPtr, cols, rowPtrCnr, colsCnr;
+    vector<double> vals, valsCnr;
+    Cnn->getCSR(rowPtr, cols, vals);
+    Cnr->getCSR(rowPtrCnr, colsCnr, valsCnr);
+
+    // an empty row is constrained unless a weak condition added to it afterwards, the rows are in the current order
+    vector<int> rowOfUnknown(size_N);
+    for (size_t k = 0; k < size_N; k++)
+        rowOfUnknown[order.empty() ? k : order[k]] = k;
+    // the entries left of the diagonal of a symmetric Cnn are stored in the columns of the rows above
+    vector<char> isColumnOffDiagonal;
+    if (Cnn->getIsSymmetric()) {
+        isColumnOffDiagonal.assign(size_N, 0);
+        for (size_t row = 0; row < size_N; row++)
+            for (int k = rowPtr[row]; k < rowPtr[row + 1]; k++)
+                if (cols[k] != (int)row)
+                    isColumnOffDiagonal[cols[k]] = 1;
+    }
+    vector<char> isConstrained(size_N, 0);
+    for (size_t i = 0; i < indexEmptyRowCnn.size(); i++) {
+        int row = rowOfUnknown[indexEmptyRowCnn[i]];
+        bool isDiagonalOnly = rowPtrCnr[row] == rowPtrCnr[row + 1]
+                && (isColumnOffDiagonal.empty() || !isColumnOffDiagonal[row]);
+        for (int k = rowPtr[row]; k < rowPtr[row + 1]; k++)
+            if (cols[k] != row)
+                isDiagonalOnly = false;
+        isConstrained[row] = isDiagonalOnly;
+    }
+    if (isExpanded) {
+        const int BLOCK_SIZE = MathLibrary::BlockSparseMatrix::BLOCK_SIZE;
+        for (size_t row = 0; row < size_N; row += BLOCK_SIZE) {
+            char isNodeConstrained = 1;
+            for (int c = 0; c < BLOCK_SIZE; c++)
+                isNodeConstrained &= isConstrained[row + c];
+            for (int c = 0; c < BLOCK_SIZE; c++)
+                isConstrained[row + c] = isNodeConstrained;
+        }
+    }
+
+    // the free rows come first and the constrained rows last, both keep the current order
+    vector<int> oldRowOfNew;
+    oldRowOfNew.reserve(size_N);
+    for (size_t row = 0; row < size_N; row++)
+        if (!isConstrained[row])
+            oldRowOfNew.push_back(row);
+    size_t newNumFree = oldRowOfNew.size();
+    if (newNumFree == size_N || newNumFree == 0)
+        return;
+    for (size_t row = 0; row < size_N; row++)
+        if (isConstrained[row])
+            oldRowOfNew.push_back(row);
+    vector<int> newRowOfOld(size_N);
+    for (size_t i = 0; i < size_N; i++)
+        newRowOfOld[oldRowOfNew[i]] = i;
+
+    // the constrained unknowns are zero, so their columns are dropped, the free columns stay sorted and
+    // the entries of a symmetric Cnn stay in its upper triangular part
+    vector<int> freeRowPtr(newNumFree + 1, 0), freeCols, freeRowPtrCnr(newNumFree + 1, 0), freeColsCnr;
+    vector<double> freeVals, freeValsCnr;
+    freeCols.reserve(cols.size());
+    freeVals.reserve(vals.size());
+    freeColsCnr.reserve(colsCnr.size());
+    freeValsCnr.reserve(valsCnr.size());
+    for (size_t i = 0; i < newNumFree; i++) {
+        int oldRow = oldRowOfNew[i];
+        for (int k = rowPtr[oldRow]; k < rowPtr[oldRow + 1]; k++) {
+            if (isConstrained[cols[k]])
+                continue;
+            freeCols.push_back(newRowOfOld[cols[k]]);
+            freeVals.push_back(vals[k]);
+        }
+        freeRowPtr[i + 1] = freeCols.size();
+        freeColsCnr.insert(freeColsCnr.end(), colsCnr.begin() + rowPtrCnr[oldRow],
+                colsCnr.begin() + rowPtrCnr[oldRow + 1]);
+        freeValsCnr.insert(freeValsCnr.end(), valsCnr.begin() + rowPtrCnr[oldRow],
+                valsCnr.begin() + rowPtrCnr[oldRow + 1]);
+        freeRowPtrCnr[i + 1] = freeColsCnr.size();
+    }
+
+    vector<int> newOrder(size_N);
+    for (size_t k = 0; k < size_N; k++)
+        newOrder[k] = order.empty() ? oldRowOfNew[k] : order[oldRowOfNew[k]];
+    setOrder(newOrder, newNumFree);
+    Cnn->setCSR(freeRowPtr, freeCols, freeVals);
+    Cnr->setCSR(freeRowPtrCnr, freeColsCnr, freeValsCnr);
+}
+
+void IGAMortarCouplingMatrices::setOrder(const vector<int> &_order, size_t _numFree) {
+    assert(_order.size() == size_N || (_order.empty() && _numFree == size_N));
+    assert(_numFree <= size_N && !isBlocked());
+    order = _order;
+    if (_numFree == numFree)
+        return;
+    // the matrices of the free rows keep the solver settings of Cnn
+    MathLibrary::SparseMatrix<double> *freeCnn = new MathLibrary::SparseMatrix<double>(_numFree,
+            Cnn->getIsSymmetric());
+    if (Cnn->getIsIterative())
+        freeCnn->setIterativeSolver(Cnn->getIterativeTolerance(), Cnn->getIterativeMaxIterations());
+    freeCnn->setLinearSolver(Cnn->getLinearSolver());
+    freeCnn->setPardisoSettings(Cnn->getPardisoSettings());
+    delete Cnn;
+    Cnn = freeCnn;
+    delete Cnr;
+    Cnr = new MathLibrary::SparseMatrix<double>(_numFree, size_R);
+    numFree = _numFree;
+}
+
+void IGAMortarCouplingMatrices::blockCouplingMatrices(int _numThreads) {
+    assert(Cnr->getIsFrozen());
+    if (!isExpanded || isBlocked())
+        return;
+    const int BLOCK_SIZE = MathLibrary::BlockSparseMatrix::BLOCK_SIZE;
+    assert(numFree % BLOCK_SIZE == 0 && size_R % BLOCK_SIZE == 0);
+    vector<int> rowPtr, cols;
+    vector<double> vals;
+    Cnr->getCSR(rowPtr, cols, vals);
+    CnrBlocks = new MathLibrary::BlockSparseMatrix(numFree / BLOCK_SIZE, size_R / BLOCK_SIZE,
+            _numThreads);
+    CnrBlocks->setCSR(rowPtr, cols, vals);
+    // an empty Cnr of the same size is kept for the size checks of the cache
+    delete Cnr;
+    Cnr = new MathLibrary::SparseMatrix<double>(numFree, size_R);
+}
+
+void IGAMortarCouplingMatrices::multiplyCnr(const double *_slaveVec, double *_masterVec) {
+    if (isBlocked())
+        CnrBlocks->multiply(false, _slaveVec, _masterVec);
+    else
+        Cnr->mulitplyVec(false, const_cast<double *>(_slaveVec), _masterVec, numFree);
+}
+
+void IGAMortarCouplingMatrices::transposeMultiplyCnr(const double *_masterVec, double *_slaveVec) {
+    if (isBlocked())
+        CnrBlocks->multiply(true, _masterVec, _slaveVec);
+    else
+        Cnr->transposeMulitplyVec(const_cast<double *>(_masterVec), _slaveVec, numFree);
+}
+
+MemoryUsage IGAMortarCouplingMatrices::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("Cnn", Cnn->getMemoryUsage());
+    usage.add("Cnr", Cnr->getMemoryUsage());
+    if (CnrBlocks != NULL)
+        usage.add("Cnr blocks", CnrBlocks->getMemoryUsage());
+    size_t bufferBytes = MemoryUsage::ofVector(bufferCnn) + MemoryUsage::ofVector(bufferCnr);
+    for (size_t i = 0; i < bufferCnn.size(); i++)
+        bufferBytes += MemoryUsage::ofVector(bufferCnn[i]);
+    for (size_t i = 0; i < bufferCnr.size(); i++)
+        bufferBytes += MemoryUsage::ofVector(bufferCnr[i]);
+    usage.add("assembly buffers", bufferBytes);
+    usage.add("empty rows of Cnn", MemoryUsage::ofVector(indexEmptyRowCnn));
+    usage.add("order", MemoryUsage::ofVector(order));
+    return usage;
+}
+
 void IGAMortarCouplingMatrices::enforceCnn() {
     /*
-     * Checks if a row is empty and if yes adds 1.0 in the diagonal
+     * Checks if a row is empty and if yes adds 1.0 in the diagonal. Of a symmetric Cnn only the upper
+     * triangular part of a row is checked, which suffices since a basis function coupled to another
+     * one also contributes to its diagonal entry
      */
     indexEmptyRowCnn.reserve(size_N);
     for(int i = 0; i < size_N; i++) {
@@ -42,6 +42,7 @@ namespace EMPIRE {
 
 namespace MathLibrary {
 template<class T> class SparseMatrix;
+class BlockSparseMatrix;
 }
 
 class IGAMortarCouplingMatrices {
@@ -53,6 +54,9 @@ private:
     // CNR matrices
     MathLibrary::SparseMatrix<double> *Cnr;
 
+    // Cnr in 3x3 blocks, replaces the entries of Cnr in the expanded version, NULL otherwise
+    MathLibrary::BlockSparseMatrix *CnrBlocks;
+
     // Master and slave sizes of Cnr
     size_t size_N;
     size_t size_R;
@@ -62,6 +66,20 @@ private:
 
     // Vector containing all indices of empty rows in Cnn
     std::vector<int> indexEmptyRowCnn;
+    // Row k of the reordered Cnn and Cnr is the master unknown order[k], empty if not reordered
+    std::vector<int> order;
+    // Number of free master unknowns, Cnn and Cnr only hold the rows of the free unknowns which come first in
+    // the order, the constrained unknowns at the end of the order are zero
+    size_t numFree;
+
+    // Triplet buffers of Cnn and Cnr, one per thread or one per item, filled during the parallel assembly
+    std::vector<std::vector<MathLibrary::SparseMatrixTriplet<double> > > bufferCnn;
+    std::vector<std::vector<MathLibrary::SparseMatrixTriplet<double> > > bufferCnr;
+    // Whether there is one buffer per item of the assembly
+    bool isBufferPerItem;
+
+    // Number of entries of a thread buffer above which it is merged into the coupling matrices
+    static const size_t MAX_BUFFER_SIZE;
 
 public:
 
@@ -69,9 +87,12 @@ public:
      * \brief Constructor
      * \param[in] _size_N Master size of Cnr
      * \param[in] _size_R Slave size of Cnr
+     * \param[in] _isExpanded whether the expanded version of the coupling matrices is assumed
+     * \param[in] _isSymmetricCnn whether only the upper triangular part of Cnn is stored, which
+     *            halves its memory. Rows of Cnn must not be replaced then, e.g. to enforce consistency
      * \author Andreas Apostolatos
      ***********/
-    IGAMortarCouplingMatrices(int _size_N , int _size_R, bool _isExpanded);
+    IGAMortarCouplingMatrices(int _size_N , int _size_R, bool _isExpanded, bool _isSymmetricCnn = false);
 
     /***********************************************************************************************
      * \brief Destructor
@@ -103,6 +124,90 @@ public:
         (*Cnr)(_row, _column) += value;
     }
 
+    /***********************************************************************************************
+     * \brief Allocate the triplet buffers for the parallel assembly of Cnn and Cnr over items, e.g.
+     *        elements or conditions, one buffer per thread or one per item if the assembly has to
+     *        be reproducible, see MathLibrary::getNumAssemblyBuffers. An item adds its entries to
+     *        the buffer MathLibrary::getAssemblyBuffer(item).
+     * \param[in] _numThreads The number of threads taking part in the assembly
+     * \param[in] _numItems The number of items of the assembly
+     ***********/
+    void initBuffers(int _numThreads, int _numItems);
+
+    /***********************************************************************************************
+     * \brief Add value in a buffer for the Cnn matrix
+     * \param[in] _buffer the buffer
+     * \param[in] _row row of added value
+     * \param[in] _column column of added value
+     * \param[in] value value to be added
+     ***********/
+    void addCNNValueToBuffer(int _buffer, int _row, int _column, double value) {
+        bufferCnn[_buffer].push_back(MathLibrary::SparseMatrixTriplet<double>(_row, _column, value));
+    }
+
+    /***********************************************************************************************
+     * \brief Add value in a buffer for the Cnr matrix
+     * \param[in] _buffer the buffer
+     * \param[in] _row row of added value
+     * \param[in] _column column of added value
+     * \param[in] value value to be added
+     ***********/
+    void addCNRValueToBuffer(int _buffer, int _row, int _column, double value) {
+        bufferCnr[_buffer].push_back(MathLibrary::SparseMatrixTriplet<double>(_row, _column, value));
+    }
+
+    /***********************************************************************************************
+     * \brief Get the number of triplets in a buffer
+     * \param[in] _buffer the buffer
+     * \param[out] _sizeCnn the number of triplets of Cnn
+     * \param[out] _sizeCnr the number of triplets of Cnr
+     ***********/
+    void getBufferSizes(int _buffer, size_t &_sizeCnn, size_t &_sizeCnr) const {
+        _sizeCnn = bufferCnn[_buffer].size();
+        _sizeCnr = bufferCnr[_buffer].size();
+    }
+
+    /***********************************************************************************************
+     * \brief Copy the triplets added to a buffer since it had the given sizes
+     * \param[in] _buffer the buffer
+     * \param[in] _beginCnn the first triplet of Cnn to copy
+     * \param[in] _beginCnr the first triplet of Cnr to copy
+     * \param[out] _cnn the triplets of Cnn
+     * \param[out] _cnr the triplets of Cnr
+     ***********/
+    void copyBufferTail(int _buffer, size_t _beginCnn, size_t _beginCnr,
+            std::vector<MathLibrary::SparseMatrixTriplet<double> > &_cnn,
+            std::vector<MathLibrary::SparseMatrixTriplet<double> > &_cnr) const {
+        _cnn.assign(bufferCnn[_buffer].begin() + _beginCnn, bufferCnn[_buffer].end());
+        _cnr.assign(bufferCnr[_buffer].begin() + _beginCnr, bufferCnr[_buffer].end());
+    }
+
+    /***********************************************************************************************
+     * \brief Add triplets to a buffer
+     * \param[in] _buffer the buffer
+     * \param[in] _cnn the triplets of Cnn
+     * \param[in] _cnr the triplets of Cnr
+     ***********/
+    void addTripletsToBuffer(int _buffer, const std::vector<MathLibrary::SparseMatrixTriplet<double> > &_cnn,
+            const std::vector<MathLibrary::SparseMatrixTriplet<double> > &_cnr) {
+        bufferCnn[_buffer].insert(bufferCnn[_buffer].end(), _cnn.begin(), _cnn.end());
+        bufferCnr[_buffer].insert(bufferCnr[_buffer].end(), _cnr.begin(), _cnr.end());
+    }
+
+    /***********************************************************************************************
+     * \brief Merge a buffer of the calling thread into Cnn and Cnr if it grows beyond MAX_BUFFER_SIZE.
+     *        This may be called from within a parallel region, only one thread merges at a time.
+     *        Nothing is merged with one buffer per item, the order of the merges would vary.
+     * \param[in] _buffer the buffer
+     ***********/
+    void flushBufferIfFull(int _buffer);
+
+    /***********************************************************************************************
+     * \brief Merge the buffers in their order into Cnn and Cnr and release the buffers
+     * \param[in] _numThreads The number of threads used for the merge
+     ***********/
+    void assembleBuffers(int _numThreads);
+
     /***********************************************************************************************
      * \brief Set value in the Cnn matrix
      * \param[in] _row row of value
@@ -169,12 +274,128 @@ public:
      ***********/
     void factorizeCnn();
 
+    /***********************************************************************************************
+     * \brief Finalize the assembly of Cnn and Cnr, no values can be added afterwards
+     ***********/
+    void freezeCouplingMatrices();
+
+    /***********************************************************************************************
+     * \brief Renumber the master unknowns of the frozen Cnn and Cnr by reverse Cuthill-McKee, the
+     *        rows and columns of Cnn and the rows of Cnr are permuted. The columns of Cnr keep the
+     *        order of the slave unknowns. In the expanded version the nodes are renumbered, so that
+     *        the three unknowns of a node stay together.
+     ***********/
+    void reorderCouplingMatrices();
+
+    /***********************************************************************************************
+     * \brief Move the frozen expanded Cnr into 3x3 blocks, the entries of the scalar Cnr are
+     *        released. Only the expanded version is blocked, otherwise nothing is done.
+     * \param[in] _numThreads the number of threads of the products with Cnr
+     ***********/
+    void blockCouplingMatrices(int _numThreads);
+
+    /***********************************************************************************************
+     * \brief Whether Cnr is stored in 3x3 blocks, see blockCouplingMatrices
+     ***********/
+    bool isBlocked() const {
+        return CnrBlocks != NULL;
+    }
+
+    /***********************************************************************************************
+     * \brief get Cnr in 3x3 blocks, NULL if it is not blocked
+     ***********/
+    const MathLibrary::BlockSparseMatrix* getCnrBlocks() const {
+        return CnrBlocks;
+    }
+
+    /***********************************************************************************************
+     * \brief Compute _masterVec = Cnr * _slaveVec with the blocked or the scalar Cnr
+     * \param[in] _slaveVec the vector of size size_R
+     * \param[out] _masterVec the vector of size getNumFree()
+     ***********/
+    void multiplyCnr(const double *_slaveVec, double *_masterVec);
+
+    /***********************************************************************************************
+     * \brief Compute _slaveVec = Cnr^T * _masterVec with the blocked or the scalar Cnr
+     * \param[in] _masterVec the vector of size getNumFree()
+     * \param[out] _slaveVec the vector of size size_R
+     ***********/
+    void transposeMultiplyCnr(const double *_masterVec, double *_slaveVec);
+
+    /***********************************************************************************************
+     * \brief Eliminate the constrained master unknowns from the frozen Cnn and Cnr. The unknowns of
+     *        the empty rows found by enforceCnn are constrained to zero if their rows still hold the
+     *        diagonal only. They are moved to the end of the order, the free unknowns keep their
+     *        order. Cnn is replaced by its free block and Cnr by its free rows, so that only the free
+     *        block is factorized. In the expanded version a node is only constrained with all its
+     *        unknowns, so that the nodes stay together.
+     ***********/
+    void eliminateConstrainedUnknowns();
+
+    /***********************************************************************************************
+     * \brief Set the order of Cnn and Cnr which have been reordered before, e.g. read from a cache.
+     *        If the number of free unknowns changes, Cnn and Cnr are replaced by empty matrices of
+     *        the free rows which can be filled with setCSR.
+     * \param[in] _order row k is the master unknown _order[k], empty if not reordered
+     * \param[in] _numFree the number of free unknowns, see eliminateConstrainedUnknowns
+     ***********/
+    void setOrder(const std::vector<int> &_order, size_t _numFree);
+
+    /***********************************************************************************************
+     * \brief Get the order of Cnn and Cnr, see setOrder, empty if they are not reordered
+     ***********/
+    const std::vector<int> &getOrder() const {
+        return order;
+    }
+
+    /***********************************************************************************************
+     * \brief Whether the master unknowns of Cnn and Cnr are reordered
+     ***********/
+    bool isReordered() const {
+        return !order.empty();
+    }
+
+    /***********************************************************************************************
+     * \brief Get the number of free master unknowns, the size of the factorized Cnn
+     ***********/
+    int getNumFree() const {
+        return numFree;
+    }
+
+    /***********************************************************************************************
+     * \brief Copy the free unknowns of a master field into the order of Cnn and Cnr
+     * \param[in] _field the field in the order of the master mesh
+     * \param[out] _reorderedField the field in the order of Cnn, of size getNumFree()
+     ***********/
+    void toReorderedField(const double *_field, double *_reorderedField) const {
+        for (size_t k = 0; k < numFree; k++)
+            _reorderedField[k] = _field[order[k]];
+    }
+
+    /***********************************************************************************************
+     * \brief Copy a master field from the order of Cnn and Cnr into the order of the master mesh, the
+     *        constrained unknowns are set to zero
+     * \param[in] _reorderedField the field in the order of Cnn, of size getNumFree()
+     * \param[out] _field the field in the order of the master mesh
+     ***********/
+    void fromReorderedField(const double *_reorderedField, double *_field) const {
+        for (size_t k = 0; k < numFree; k++)
+            _field[order[k]] = _reorderedField[k];
+        for (size_t k = numFree; k < order.size(); k++)
+            _field[order[k]] = 0.0;
+    }
+
     /***********************************************************************************************
      * \brief Enforce consistency on the correct CNN matrix
      * \author Andreas Apostolatos
      ***********/
     void enforceCnn();
 
+    /***********************************************************************************************
+     * \brief Get the heap memory of the coupling matrices and of the assembly buffers
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
     /***********************************************************************************************
      * \brief Get indices of rows that are empty for the correct CNN matrix
      * \author Andreas Apostolatos
@@ -32,17 +32,25 @@
 
 #include "IGAMortarMapper.h"
 #include "IGAPatchSurface.h"
+#include "ScratchArray.h"
 #include "WeakIGADirichletCurveCondition.h"
 #include "WeakIGADirichletSurfaceCondition.h"
 #include "WeakIGAPatchContinuityCondition.h"
 #include "IGAMortarCouplingMatrices.h"
+#include "CouplingMatricesCache.h"
 #include "IGAMesh.h"
 #include "FEMesh.h"
+#include "FEMeshConnectivity.h"
 #include "ClipperAdapter.h"
 #include "TriangulatorAdaptor.h"
+#include "MonotonicArena.h"
 #include "MathLibrary.h"
+#include "BlockSparseMatrix.h"
 #include "GeometryMath.h"
 #include "DataField.h"
+#include "Profiler.h"
+#include "BuildProgress.h"
+#include "CostOrderedSchedule.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -52,6 +60,7 @@
 #include <algorithm>
 #include <iomanip>
 #include <limits.h>
+#include <omp.h>
 
 using namespace std;
 
@@ -59,10 +68,17 @@ namespace EMPIRE {
 
 double IGAMortarMapper::EPS_CLEANTRIANGLE = 1e-6;
 double IGAMortarMapper::EPS_CLIPPING = 1e-9;
+// set default value for mapper threads
+int IGAMortarMapper::mapperSetNumThreads = 1;
 
 /// Declaration statement
 static const string HEADER_DECLARATION = "Author: Andreas Apostolatos";
 
+/// Estimated costs of an element relative to an untrimmed element on one knot span, see estimateElementCost
+static const double COST_UNCHANGED_ELEMENT = 0.01;
+static const double COST_CUT_KNOT_SPAN = 4.0;
+static const double COST_SPLIT_PATCH = 50.0;
+
 IGAMortarMapper::IGAMortarMapper(std::string _name, AbstractMesh *_meshA, AbstractMesh *_meshB): name(_name) {
 
     // Check input
@@ -111,8 +127,14 @@ IGAMortarMapper::IGAMortarMapper(std::string _name, AbstractMesh *_meshA, Abstra
         numNodesMaster = meshIGA->getNumNodes();
     }
 
-    // Initialize flag on whether the meshFEDirectElemTable was created
-    isMeshFEDirectElemTable = false;
+    // The element freedom tables are set in initTables
+    meshFEConnectivity = NULL;
+
+    // Initialize flag on the release of the build data
+    isCompactAfterBuild = false;
+
+    // Initialize flag on the reordering of the coupling matrices
+    isReorderCouplingMatrices = false;
 
     // Initialize flag on the expansion of the coupling matrices
     isExpanded = false;
@@ -120,10 +142,17 @@ IGAMortarMapper::IGAMortarMapper(std::string _name, AbstractMesh *_meshA, Abstra
     // Initialize flag on the initialization of the coupling matrices
     isCouplingMatrices = false;
 
+    // Initialize the solver of Cnn to the direct solver
+    iterativeSolverTolerance = 0.0;
+    iterativeSolverMaxIterations = 0;
+    linearSolver = MathLibrary::LinearSolverRegistry::DIRECT;
+
     // Initialize Gauss quadratures
-    gaussRuleOnTriangle = new EMPIRE::MathLibrary::IGAGaussQuadrature*[numPatches];
-    gaussRuleOnQuadrilateral = new EMPIRE::MathLibrary::IGAGaussQuadrature*[numPatches];
+    gaussRuleOnTriangle = new const EMPIRE::MathLibrary::IGAGaussQuadrature*[numPatches];
+    gaussRuleOnQuadrilateral = new const EMPIRE::MathLibrary::IGAGaussQuadrature*[numPatches];
     isGaussQuadature = false;
+    numGaussPointsAdaptive = 0;
+    numGaussPointsSaved = 0;
 
     // Initialize the integration area
     areaIntegration = 0.0;
@@ -204,11 +233,14 @@ void IGAMortarMapper::setParametersBisection(int _noIterations, double _tolProje
     propBisection.tolProjection = _tolProjection;
 }
 
-void IGAMortarMapper::setParametersIntegration(bool _isAutomaticNoGPTriangle, int _noGPTriangle, bool _isAutomaticNoGPQuadrilateral, int _noGPQuadrilateral) {
+void IGAMortarMapper::setParametersIntegration(bool _isAutomaticNoGPTriangle, int _noGPTriangle, bool _isAutomaticNoGPQuadrilateral, int _noGPQuadrilateral,
+                                               bool _isAdaptive, double _tolAdaptive) {
     propIntegration.isAutomaticNoGPTriangle = _isAutomaticNoGPTriangle;
     propIntegration.noGPTriangle = _noGPTriangle;
     propIntegration.isAutomaticNoGPQuadrilateral = _isAutomaticNoGPQuadrilateral;
     propIntegration.noGPQuadrilateral = _noGPQuadrilateral;
+    propIntegration.isAdaptive = _isAdaptive;
+    propIntegration.tolAdaptive = _tolAdaptive;
 }
 
 void IGAMortarMapper::setParametersWeakCurveDirichletConditions(bool _isWeakCurveDirichletConditions, bool _isAutomaticPenaltyParameters,
@@ -249,11 +281,13 @@ void IGAMortarMapper::setParametersStrongCurveDirichletConditions(bool _isStrong
     propStrongCurveDirichletConditions.isStrongCurveDirichletConditions = _isStrongCurveDirichletConditions;
 }
 
-void IGAMortarMapper::setParametersErrorComputation(bool _isErrorComputation, bool _isDomainError, bool _isCurveError, bool _isInterfaceError){
+void IGAMortarMapper::setParametersErrorComputation(bool _isErrorComputation, bool _isDomainError, bool _isCurveError, bool _isInterfaceError,
+                                                    bool _isCompactStorage){
     propErrorComputation.isErrorComputation = _isErrorComputation;
     propErrorComputation.isDomainError = _isDomainError;
     propErrorComputation.isCurveError = _isCurveError;
     propErrorComputation.isInterfaceError = _isInterfaceError;
+    propErrorComputation.isCompactStorage = _isCompactStorage;
 }
 
 void IGAMortarMapper::buildCouplingMatrices() {
@@ -310,9 +344,13 @@ void IGAMortarMapper::buildCouplingMatrices() {
      *
      * 23. Compute the Penalty matrices for the application of weak Dirichlet conditions across surfaces
      *
-     * 24. Factorize Cnn matrix
+     * 24. Freeze the coupling matrices, eliminate the flying nodes and factorize the free block of Cnn
      */
 
+    // Time the stages in the build statistics and in the profile
+    buildStatistics.reset();
+    MapperBuildStatistics::StageTimer stages(buildStatistics);
+
     // 0. Print message
     HEADING_OUT(3, "IGAMortarMapper", "Building coupling matrices for ("+ name +")...", infoOut);
     {
@@ -332,6 +370,7 @@ void IGAMortarMapper::buildCouplingMatrices() {
     }
 
     // 1. Check input
+    stages.next("1. check input");
     if (propErrorComputation.isErrorComputation)
         if (propErrorComputation.isCurveError && !propWeakCurveDirichletConditions.isWeakCurveDirichletConditions){
             ERROR_OUT() << "Error in MapperAdapter::initIGAMortarMapper" << endl;
@@ -351,6 +390,7 @@ void IGAMortarMapper::buildCouplingMatrices() {
     }
 
     // 2. Compute the minimum element area size in the multipatch geometry and the minimum edge size in the Finite Element mesh
+    stages.next("2. minimum element and edge size");
     if (propErrorComputation.isErrorComputation)
         if (propErrorComputation.isDomainError) {
             computeMinimumElementAreaSize();
@@ -358,18 +398,22 @@ void IGAMortarMapper::buildCouplingMatrices() {
         }
 
     // 3. Initialize coupling matrices
+    stages.next("3. initialize coupling matrices");
     initialize();
 
     // 4. Initialize auxiliary variables
+    stages.next("4. auxiliary variables");
     int numPatches = getIGAMesh()->getNumPatches();
     string filename; // String holding the mapper names
     IGAPatchSurface::MAX_NUM_ITERATIONS = propNewtonRaphson.noIterations; // Set default scheme values
     IGAPatchSurface::TOL_ORTHOGONALITY = propNewtonRaphson.tolProjection; // Set default scheme values
 
     // 5. Create the Gauss quadrature rules for each patch
+    stages.next("5. Gauss quadrature rules");
     createGaussQuadratureRules();
 
     // 6. Find the maximum number of Gauss points within an element
+    stages.next("6. maximum number of Gauss points");
     int maxNumGP = 0;
     int numGP;
     for (int iPatches = 0; iPatches < numPatches; iPatches++) {
@@ -382,17 +426,23 @@ void IGAMortarMapper::buildCouplingMatrices() {
     }
 
     // 7. Project the FE nodes onto the multipatch trimmed geometry
+    stages.next("7. projection");
     projectPointsToSurface();
+    projectedNodes.assign(meshFE->nodes, meshFE->nodes + 3 * meshFE->numNodes);
 
     // 8. Write the projected points on to a file only in DEBUG mode to be used in MATLAB
+    stages.next("8. write projected nodes");
     if (Message::isDebugMode())
         writeProjectedNodesOntoIGAMesh();
 
-    // 9. Reserve some space for gauss point values in the domain (the size is not known exactly in advance)
-    if (propErrorComputation.isDomainError)
+    // 9. Reserve some space for gauss point values in the domain (the size is not known exactly in advance),
+    // the compact streams grow with the Gauss points as the reserve alone would be of the size of the streams
+    stages.next("9. reserve domain Gauss points");
+    if (propErrorComputation.isDomainError && !propErrorComputation.isCompactStorage)
         streamGPs.reserve(8*meshFE->numElems*maxNumGP);
 
     // 10. Reserve space for the gauss point values along each trimming curve where conditions are applied
+    stages.next("10. reserve curve Gauss points");
     if(propErrorComputation.isCurveError){
         int noCurveGPs = 0;
         std::vector<WeakIGADirichletCurveCondition*> weakIGADirichletCurveConditions = meshIGA->getWeakIGADirichletCurveConditions();
@@ -403,6 +453,7 @@ void IGAMortarMapper::buildCouplingMatrices() {
     }
 
     // 11. Reserve space for the interface gauss point values
+    stages.next("11. reserve interface Gauss points");
     if(propErrorComputation.isInterfaceError){
         int noInterfaceGPs = 0;
         std::vector<WeakIGAPatchContinuityCondition*> weakIGAPatchContinuityConditions = meshIGA->getWeakIGAPatchContinuityConditions();
@@ -413,40 +464,48 @@ void IGAMortarMapper::buildCouplingMatrices() {
     }
 
     // 12. Compute mortar coupling matrices
+    stages.next("12. clipping and integration");
     computeCouplingMatrices();
 
     // 13.Print the integration area
+    stages.next("13. integration area");
     INFO_OUT() << "The integration area in the IGA mortar mapper is equal to: " << areaIntegration << std::endl;
 
     // 14. Write the gauss point and the coupling matrices data in files
+    stages.next("14. write Gauss points and coupling matrices");
     if(Message::isDebugMode()) {
         writeGaussPointData();
         writeCouplingMatricesToFile();
     }
 
     // 15. Write polygon net of projected elements to a vtk file
+    stages.next("15. write projected polygons");
     writeCartesianProjectedPolygon("trimmedPolygonsOntoNURBSSurface", trimmedProjectedPolygons);
     writeCartesianProjectedPolygon("integratedPolygonsOntoNURBSSurface", triangulatedProjectedPolygons2);
     trimmedProjectedPolygons.clear();
     triangulatedProjectedPolygons2.clear();
 
     // 16. Compute the Penalty parameters for the application of weak Dirichlet curve conditions
+    stages.next("16. penalty parameters of weak Dirichlet curve conditions");
     if(propWeakCurveDirichletConditions.isWeakCurveDirichletConditions && !isMappingIGA2FEM) {
         filename = name + "_penaltyParametersWeakDirichletConditions.txt";
         computePenaltyParametersForWeakDirichletCurveConditions(filename);
     }
 
     // 17. Compute the Penalty parameters for the application of weak Dirichlet surface conditions
+    stages.next("17. penalty parameters of weak Dirichlet surface conditions");
     if(propWeakSurfaceDirichletConditions.isWeakSurfaceDirichletConditions && !isMappingIGA2FEM)
         computePenaltyParametersForWeakDirichletSurfaceConditions();
 
     // 18. Compute the Penalty parameters for the application of weak patch continuity conditions
+    stages.next("18. penalty parameters of weak patch continuity conditions");
     if(propWeakPatchContinuityConditions.isWeakPatchContinuityConditions && !isMappingIGA2FEM) {
         filename = name + "_penaltyParametersWeakContinuityConditions.txt";
         computePenaltyParametersForPatchContinuityConditions(filename);
     }
 
     // 19. Compute the Penalty matrices for the application of weak continuity conditions between the multipatches
+    stages.next("19. weak patch continuity conditions");
     if (propWeakPatchContinuityConditions.isWeakPatchContinuityConditions && !isMappingIGA2FEM) {
         INFO_OUT() << "Application of weak patch continuity conditions started" << endl;
         if(!propWeakPatchContinuityConditions.isAutomaticPenaltyParameters) {
@@ -462,16 +521,19 @@ void IGAMortarMapper::buildCouplingMatrices() {
         INFO_OUT() << "No application of weak patch continuity conditions is assumed" << std::endl;
 
     // 20. Remove empty rows and columns from system (flying nodes)
+    stages.next("20. flying nodes");
     if(!isMappingIGA2FEM){
         INFO_OUT() << "Enforcing flying nodes in Cnn" << std::endl;
         couplingMatrices->enforceCnn();
     }
 
     // 21. Check and enforce consistency in Cnn. This has to be done before the weak application of the Dirichlet conditions.
+    stages.next("21. enforce consistency");
     if (propConsistency.enforceConsistency)
         enforceConsistency();
 
     // 22. Compute the Penalty matrices for the application of weak Dirichlet conditions along trimming curves
+    stages.next("22. weak Dirichlet curve conditions");
     if (propWeakCurveDirichletConditions.isWeakCurveDirichletConditions) {
         INFO_OUT() << "Application of weak Dirichlet curve conditions started" << endl;
         if(!propWeakCurveDirichletConditions.isAutomaticPenaltyParameters) {
@@ -485,6 +547,7 @@ void IGAMortarMapper::buildCouplingMatrices() {
         INFO_OUT() << "No application of weak Dirichlet curve conditions are assumed" << std::endl;
 
     // 23. Compute the Penalty matrices for the application of weak Dirichlet conditions across surfaces
+    stages.next("23. weak Dirichlet surface conditions");
     if (propWeakSurfaceDirichletConditions.isWeakSurfaceDirichletConditions) {
         INFO_OUT() << "Application of weak Dirichlet surface conditions started" << endl;
         if(!propWeakSurfaceDirichletConditions.isAutomaticPenaltyParameters) {
@@ -497,28 +560,281 @@ void IGAMortarMapper::buildCouplingMatrices() {
     } else
         INFO_OUT() << "No application of weak Dirichlet surface conditions are assumed" << std::endl;
 
-    // 24. Factorize Cnn matrix
+    // 24. Freeze the coupling matrices, eliminate the flying nodes and factorize the free block of Cnn
+    stages.next("24. factorization");
+    couplingMatrices->freezeCouplingMatrices();
+    if (isReorderCouplingMatrices)
+        couplingMatrices->reorderCouplingMatrices();
+    couplingMatrices->eliminateConstrainedUnknowns();
+    recordCouplingMatrixStatistics();
+    couplingMatrices->blockCouplingMatrices(mapperSetNumThreads);
+    couplingMatrices->factorizeCnn();
+    INFO_OUT() << "Factorize was successful" << std::endl;
+
+    if (isCompactAfterBuild)
+        releaseBuildData();
+}
+
+void IGAMortarMapper::updateGeometry() {
+    /*
+     * Rebuilds the coupling matrices after the nodes of the FE mesh moved, the IGA mesh is unchanged.
+     *
+     * Function layout :
+     *
+     * 1. Print message
+     *
+     * 2. Project the moved nodes and find the elements to integrate again
+     *
+     * 3. Compute the coupling matrices from the new and the recorded contributions of the elements
+     *
+     * 4. Remove empty rows and columns from system (flying nodes) and enforce consistency
+     *
+     * 5. Freeze the coupling matrices, eliminate the flying nodes and factorize the free block of Cnn
+     */
+    assert(isGeometryUpdateSupported());
+
+    // Time the stages in the build statistics and in the profile
+    buildStatistics.reset();
+    MapperBuildStatistics::StageTimer stages(buildStatistics);
+
+    // 1. Print message
+    HEADING_OUT(3, "IGAMortarMapper", "Updating coupling matrices for ("+ name +") to the moved nodes...", infoOut);
+
+    // 2. Project the moved nodes and find the elements to integrate again. The contributions of the elements are
+    // recorded from the first update on, such that a mapper on a fixed mesh does not keep them
+    // The quadrature rules are not created if the coupling matrices were read from the cache
+    stages.next("2. projection");
+    if (!isGaussQuadature)
+        createGaussQuadratureRules();
+    projectedPolygons.resize(meshFE->numElems);
+    triangulatedProjectedPolygons.resize(meshFE->numElems);
+    vector<char> isElementChanged;
+    reprojectPointsToSurface(isElementChanged);
+    if (elementContributions.empty()) {
+        elementContributions.resize(meshFE->numElems);
+        isElementChanged.assign(meshFE->numElems, 1);
+    }
+    int numElementsChanged = std::count(isElementChanged.begin(), isElementChanged.end(), 1);
+    INFO_OUT() << numElementsChanged << " out of " << meshFE->numElems << " elements are integrated again" << endl;
+
+    // 3. Compute the coupling matrices from the new and the recorded contributions of the elements, the pattern of Cnn
+    // changes with the projections
+    stages.next("3. clipping and integration");
+    delete couplingMatrices;
+    initCouplingMatrices();
+    areaIntegration = 0.0;
+    computeCouplingMatrices(&isElementChanged);
+    INFO_OUT() << "The integration area in the IGA mortar mapper is equal to: " << areaIntegration << std::endl;
+    trimmedProjectedPolygons.clear();
+    triangulatedProjectedPolygons2.clear();
+
+    // 4. Remove empty rows and columns from system (flying nodes) and enforce consistency
+    stages.next("4. enforce consistency");
+    if(!isMappingIGA2FEM)
+        couplingMatrices->enforceCnn();
+    if (propConsistency.enforceConsistency)
+        enforceConsistency();
+
+    // 5. Freeze the coupling matrices, eliminate the flying nodes and factorize the free block of Cnn
+    stages.next("5. factorization");
+    couplingMatrices->freezeCouplingMatrices();
+    if (isReorderCouplingMatrices)
+        couplingMatrices->reorderCouplingMatrices();
+    couplingMatrices->eliminateConstrainedUnknowns();
+    recordCouplingMatrixStatistics();
+    couplingMatrices->blockCouplingMatrices(mapperSetNumThreads);
+    couplingMatrices->factorizeCnn();
+    INFO_OUT() << "Factorize was successful" << std::endl;
+
+    if (isCompactAfterBuild)
+        releaseBuildData();
+}
+
+void IGAMortarMapper::writeCouplingMatricesToCache(CouplingMatricesCache *cache) {
+    cache->setMatrix("Cnn", couplingMatrices->getCnn());
+    if (couplingMatrices->isBlocked())
+        cache->setMatrix("Cnr", couplingMatrices->getCnrBlocks());
+    else
+        cache->setMatrix("Cnr", couplingMatrices->getCnr());
+    // the cached matrices are reordered and hold the free unknowns only, their order is stored with them
+    if (couplingMatrices->isReordered()) {
+        const std::vector<int> &order = couplingMatrices->getOrder();
+        std::vector<double> orderValues(order.begin(), order.end());
+        cache->setVector("CnnOrder", &orderValues[0], orderValues.size());
+        double numFree = couplingMatrices->getNumFree();
+        cache->setVector("CnnNumFree", &numFree, 1);
+    }
+}
+
+bool IGAMortarMapper::readCouplingMatricesFromCache(const CouplingMatricesCache *cache) {
+    assert(isCouplingMatrices);
+    // the order is set first, it gives the size of the cached matrices of the free unknowns
+    std::vector<double> orderValues(couplingMatrices->getSizeN());
+    double numFree = couplingMatrices->getSizeN();
+    if (!orderValues.empty()
+            && cache->getVector("CnnOrder", orderValues.size(), &orderValues[0])) {
+        cache->getVector("CnnNumFree", 1, &numFree);
+        couplingMatrices->setOrder(std::vector<int>(orderValues.begin(), orderValues.end()), numFree);
+    }
+    if (!cache->hasMatrix("Cnn", couplingMatrices->getCnn())
+            || !cache->hasMatrix("Cnr", couplingMatrices->getCnr())) {
+        couplingMatrices->setOrder(std::vector<int>(), couplingMatrices->getSizeN());
+        return false;
+    }
+    cache->getMatrix("Cnn", couplingMatrices->getCnn());
+    cache->getMatrix("Cnr", couplingMatrices->getCnr());
+    if (!couplingMatrices->isReordered() && isReorderCouplingMatrices)
+        couplingMatrices->reorderCouplingMatrices();
+    buildStatistics.reset();
+    recordCouplingMatrixStatistics();
+    couplingMatrices->blockCouplingMatrices(mapperSetNumThreads);
     couplingMatrices->factorizeCnn();
     INFO_OUT() << "Factorize was successful" << std::endl;
+    if (isCompactAfterBuild)
+        releaseBuildData();
+    return true;
+}
+
+void IGAMortarMapper::recordCouplingMatrixStatistics() {
+    MathLibrary::SparseMatrix<double>* Cnn = couplingMatrices->getCnn();
+    MathLibrary::SparseMatrix<double>* Cnr = couplingMatrices->getCnr();
+    buildStatistics.setMatrix("Cnn", Cnn->getNumberOfRows(), Cnn->getNumberOfColumns(),
+                              Cnn->getNumberOfNonZeros(), Cnn->getIsSymmetric());
+    buildStatistics.setMatrix("Cnr", Cnr->getNumberOfRows(), Cnr->getNumberOfColumns(),
+                              Cnr->getNumberOfNonZeros(), Cnr->getIsSymmetric());
+}
+
+void IGAMortarMapper::releaseBuildData() {
+    size_t bytesBefore = getMemoryUsage().getTotal();
+
+    // swap with empty containers, clear() keeps the capacity
+    std::vector<std::map<int, std::vector<double> > >().swap(projectedCoords);
+    std::vector<double>().swap(projectedNodes);
+    std::vector<ElementContributions>().swap(elementContributions);
+    std::vector<std::map<int, Polygon2D> >().swap(projectedPolygons);
+    std::vector<std::map<int, ListPolygon2D> >().swap(triangulatedProjectedPolygons);
+    std::map<int, ListPolygon2D>().swap(triangulatedProjectedPolygons2);
+    std::vector<std::vector<std::vector<double> > >().swap(streamGPsPerThread);
+    std::vector<CompactStreamGPs>().swap(compactStreamGPsPerThread);
+
+    size_t bytesAfter = getMemoryUsage().getTotal();
+    INFO_OUT() << "Released " << (bytesBefore - bytesAfter) / (1024.0 * 1024.0)
+            << " MB of build data of mapper \"" << name << "\"" << std::endl;
+}
+
+void IGAMortarMapper::setIterativeSolver(double tolerance, int maxIterations) {
+    assert(isIterativeSolverSupported());
+    iterativeSolverTolerance = tolerance;
+    iterativeSolverMaxIterations = maxIterations;
+    if (isCouplingMatrices)
+        couplingMatrices->getCnn()->setIterativeSolver(tolerance, maxIterations);
+}
+
+void IGAMortarMapper::setIterativeSolverTolerance(double tolerance) {
+    assert(isCouplingMatrices && iterativeSolverTolerance > 0.0);
+    couplingMatrices->getCnn()->setIterativeTolerance(tolerance);
+}
+
+void IGAMortarMapper::setLinearSolver(const std::string &name) {
+    linearSolver = name;
+    if (isCouplingMatrices)
+        couplingMatrices->getCnn()->setLinearSolver(name);
+}
+
+void IGAMortarMapper::setPardisoSettings(const MathLibrary::PardisoSettings &settings) {
+    pardisoSettings = settings;
+    if (isCouplingMatrices)
+        couplingMatrices->getCnn()->setPardisoSettings(settings);
+}
+
+/***********************************************************************************************
+ * \brief Get the heap memory of a list of polygons
+ ***********/
+template<class ListPolygon>
+static size_t getPolygonListMemory(const ListPolygon &_listPolygon) {
+    size_t bytes = MemoryUsage::ofVector(_listPolygon);
+    for (size_t i = 0; i < _listPolygon.size(); i++)
+        bytes += MemoryUsage::ofVector(_listPolygon[i]);
+    return bytes;
+}
+
+/***********************************************************************************************
+ * \brief Get the heap memory of a list of Gauss point streams
+ ***********/
+static size_t getStreamMemory(const vector<vector<double> > &_streams) {
+    size_t bytes = MemoryUsage::ofVector(_streams);
+    for (size_t i = 0; i < _streams.size(); i++)
+        bytes += MemoryUsage::ofVector(_streams[i]);
+    return bytes;
+}
+
+MemoryUsage IGAMortarMapper::getMemoryUsage() const {
+    MemoryUsage usage;
+    if (isCouplingMatrices)
+        usage.add("coupling matrices", couplingMatrices->getMemoryUsage());
+
+    size_t bytes = MemoryUsage::ofVector(projectedCoords);
+    for (size_t i = 0; i < projectedCoords.size(); i++) {
+        bytes += MemoryUsage::ofMap(projectedCoords[i]);
+        for (map<int, vector<double> >::const_iterator it = projectedCoords[i].begin();
+                it != projectedCoords[i].end(); it++)
+            bytes += MemoryUsage::ofVector(it->second);
+    }
+    usage.add("projected coordinates", bytes + MemoryUsage::ofVector(projectedNodes));
+
+    bytes = MemoryUsage::ofVector(elementContributions);
+    for (size_t i = 0; i < elementContributions.size(); i++)
+        bytes += MemoryUsage::ofVector(elementContributions[i].cnn) + MemoryUsage::ofVector(elementContributions[i].cnr);
+    usage.add("element contributions", bytes);
+
+    bytes = MemoryUsage::ofVector(projectedPolygons);
+    for (size_t i = 0; i < projectedPolygons.size(); i++) {
+        bytes += MemoryUsage::ofMap(projectedPolygons[i]);
+        for (map<int, Polygon2D>::const_iterator it = projectedPolygons[i].begin();
+                it != projectedPolygons[i].end(); it++)
+            bytes += MemoryUsage::ofVector(it->second);
+    }
+    usage.add("projected polygons", bytes);
+
+    bytes = MemoryUsage::ofVector(triangulatedProjectedPolygons);
+    for (size_t i = 0; i < triangulatedProjectedPolygons.size(); i++) {
+        bytes += MemoryUsage::ofMap(triangulatedProjectedPolygons[i]);
+        for (map<int, ListPolygon2D>::const_iterator it = triangulatedProjectedPolygons[i].begin();
+                it != triangulatedProjectedPolygons[i].end(); it++)
+            bytes += getPolygonListMemory(it->second);
+    }
+    usage.add("triangulated polygons", bytes);
+
+    bytes = MemoryUsage::ofMap(trimmedProjectedPolygons)
+            + MemoryUsage::ofMap(triangulatedProjectedPolygons2);
+    for (map<int, ListPolygon2D>::const_iterator it = trimmedProjectedPolygons.begin();
+            it != trimmedProjectedPolygons.end(); it++)
+        bytes += getPolygonListMemory(it->second);
+    for (map<int, ListPolygon2D>::const_iterator it = triangulatedProjectedPolygons2.begin();
+            it != triangulatedProjectedPolygons2.end(); it++)
+        bytes += getPolygonListMemory(it->second);
+    usage.add("polygons per patch", bytes);
+
+    bytes = getStreamMemory(streamGPs) + getStreamMemory(streamInterfaceGPs)
+            + getStreamMemory(streamCurveGPs) + MemoryUsage::ofVector(streamGPsPerThread);
+    for (size_t i = 0; i < streamGPsPerThread.size(); i++)
+        bytes += getStreamMemory(streamGPsPerThread[i]);
+    bytes += MemoryUsage::ofVector(compactStreamGPs.indices) + MemoryUsage::ofVector(compactStreamGPs.values)
+            + MemoryUsage::ofVector(compactStreamGPsPerThread);
+    for (size_t i = 0; i < compactStreamGPsPerThread.size(); i++)
+        bytes += MemoryUsage::ofVector(compactStreamGPsPerThread[i].indices)
+                + MemoryUsage::ofVector(compactStreamGPsPerThread[i].values);
+    usage.add("Gauss point streams", bytes);
+
+    usage.add("empty rows of Cnn", MemoryUsage::ofVector(indexEmptyRowCnn));
+    return usage;
 }
 
 IGAMortarMapper::~IGAMortarMapper() {
     // Initialize auxiliary variables
     int numPatches = getIGAMesh()->getNumPatches();
 
-    // Delete the Finite Element direct element table
-    if(isMeshFEDirectElemTable){
-        for (int i = 0; i < meshFE->numElems; i++)
-            delete[] meshFEDirectElemTable[i];
-        delete[] meshFEDirectElemTable;
-    }
-
-    // Delete the quadrature rules
-    if (isGaussQuadature)
-        for (int iPatches = 0; iPatches < numPatches; iPatches++) {
-                delete gaussRuleOnTriangle[iPatches];
-                delete gaussRuleOnQuadrilateral[iPatches];
-        }
+    // Delete the arrays of the quadrature rules, the rules themselves are shared
     delete[] gaussRuleOnTriangle;
     delete[] gaussRuleOnQuadrilateral;
 
@@ -537,8 +853,10 @@ IGAMortarMapper::~IGAMortarMapper() {
     delete[] weakPatchContinuityAlphaSecondaryTwistingIJ;
 
     // Delete the stored GP values
-    if (propErrorComputation.isDomainError)
+    if (propErrorComputation.isDomainError) {
         streamGPs.clear();
+        compactStreamGPs = CompactStreamGPs();
+    }
     if (propErrorComputation.isCurveError)
         streamCurveGPs.clear();
     if (propErrorComputation.isInterfaceError)
@@ -547,89 +865,11 @@ IGAMortarMapper::~IGAMortarMapper() {
 
 void IGAMortarMapper::initTables() {
     /*
-     * Create the map to store the nodeIDs but here the "key" is the node ID, and the value is the position in nodeIDs
-     * the map is sorted automatically, so it is efficient for searching
-     *
-     * Function layout:
-     *
-     * 1. Initialize the direct element freedom tables for the Finite Element mesh
-     *
-     * 2. Make a map between the node ids and the local indexing
-     *
-     * 3. Loop over all elements in the Finite Element mesh
-     * ->
-     *    3i. Get the number of nodes per element for the given element
-     *   3ii. Loop over all nodes in the Finite Element
-     *   ->
-     *        3ii.1. Assert an error if an ID is not found in the map
-     *        3ii.2. Insert the id of the node in the map
-     *   <-
-     * <-
-     *
-     * 4. Loop over all nodes in the Finite Element mesh
-     * ->
-     *    4i. Loop over all elements in the Finite Element mesh
-     *    ->
-     *        4i.1. Get the number of nodes for the given element
-     *        4i.2. Find the given node in the current element
-     *        4i.3. Insert the element in the node map
-     *    <-
-     * <-
-     *
-     * 5. Set flag of the initialization of the flag
+     * The element freedom table (the positions of the nodes of each element in nodeIDs) and the reverse
+     * element freedom table (the elements containing each node) are built once by the FE mesh and
+     * shared with all mappers and filters on it
      */
-
-    // 1. Initialize the direct element freedom tables for the Finite Element mesh
-    meshFEDirectElemTable = new int*[meshFE->numElems]; // deleted
-    for (int i = 0; i < meshFE->numElems; i++)
-        meshFEDirectElemTable[i] = new int[meshFE->numNodesPerElem[i]];
-
-    // 2. Make a map between the node ids and the local indexing
-    map<int, int> meshFENodesMap;
-    for (int i = 0; i < meshFE->numNodes; i++)
-        meshFENodesMap.insert(meshFENodesMap.end(), pair<int, int>(meshFE->nodeIDs[i], i));
-    int count = 0;
-
-    // 3. Loop over all elements in the Finite Element mesh
-    for (int i = 0; i < meshFE->numElems; i++) {
-        // 3i. Get the number of nodes per element for the given element
-        const int numNodesPerElem = meshFE->numNodesPerElem[i];
-
-        // 3ii. Loop over all nodes in the Finite Element
-        for (int j = 0; j < numNodesPerElem; j++) {
-            // 3ii.1. Assert an error if an ID is not found in the map
-            if (meshFENodesMap.find(meshFE->elems[count + j]) == meshFENodesMap.end()) {
-                ERROR_OUT() << "Cannot find node ID " << meshFE->elems[count + j] << endl;
-                exit(-1);
-            }
-
-            // 3ii.2. Insert the id of the node in the map
-            meshFEDirectElemTable[i][j] = meshFENodesMap.at(meshFE->elems[count + j]);
-        }
-
-        // 3iii. Updated counter
-        count += numNodesPerElem;
-    }
-
-    // 4. Loop over all nodes in the Finite Element mesh
-    for (int iNodes = 0; iNodes < meshFE->numNodes; iNodes++) {
-        // 4i. Loop over all elements in the Finite Element mesh
-        for (int elem = 0; elem < meshFE->numElems; elem++) {
-            // 4i.1. Get the number of nodes for the given element
-            const int numNodesPerElem = meshFE->numNodesPerElem[elem];
-
-            // 4i.2. Find the given node in the current element
-            int* out = find(meshFEDirectElemTable[elem],meshFEDirectElemTable[elem]+numNodesPerElem,iNodes);
-
-            // 4i.3. Insert the element in the node map
-            if(out != meshFEDirectElemTable[elem] + numNodesPerElem) {
-                meshFENodeToElementTable[iNodes].push_back(elem);
-            }
-        }
-    }
-
-    // 5. Set flag of the initialization of the flag
-    isMeshFEDirectElemTable = true;
+    meshFEConnectivity = meshFE->getConnectivity();
 }
 
 void IGAMortarMapper::initCouplingMatrices() {
@@ -661,8 +901,14 @@ void IGAMortarMapper::initCouplingMatrices() {
         size_R = numNodesSlave;
     }
 
-    // 3. Initialize coupling matrices
-    couplingMatrices = new IGAMortarCouplingMatrices(size_N, size_R, isExpanded);
+    // 3. Initialize coupling matrices, only the upper triangular part of Cnn is stored unless enforcing consistency
+    // replaces rows of Cnn
+    couplingMatrices = new IGAMortarCouplingMatrices(size_N, size_R, isExpanded,
+            !propConsistency.enforceConsistency);
+    if (iterativeSolverTolerance > 0.0)
+        couplingMatrices->getCnn()->setIterativeSolver(iterativeSolverTolerance, iterativeSolverMaxIterations);
+    couplingMatrices->getCnn()->setLinearSolver(linearSolver);
+    couplingMatrices->getCnn()->setPardisoSettings(pardisoSettings);
 
     // 4. Set flag on the initialization of the coupling matrices accordingly
     isCouplingMatrices = true;
@@ -710,7 +956,7 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
      *    1v. Loop over all the trimming loops
      *    ->
      *        1v.1. Get the polylines which comprise each trimming loop
-     *        1v.2. Add the first point also at the end of the line
+     *        1v.2. Check that the polylines consist of complete vertices
      *    <-
      *   1vi. Initialize the basis functions and base vectors arrays
      *  1vii. Get the Gauss point quadrature for a quadrilateral
@@ -730,7 +976,6 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
      *             1ix.3vii. Updated the element size from the Gauss point contribution
      *        <-
      *   <-
-     *    1x. Erase pointers
      * <-
      */
 
@@ -740,8 +985,8 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
     int derivDegree = 1;
     int derivDegreeBaseVec = 0;
     int noBaseVec = 2;
-    int pDegree, qDegree, numUGPs, numVGPs, noUKnots, noVKnots, uKnotSpan, vKnotSpan, indexBaseVctU, indexBaseVctV, numBasisFunctions, numLoops, size, numVertices, remainder, division;
-    int noCoord = 3;
+    int pDegree, qDegree, numUGPs, numVGPs, noUKnots, noVKnots, uKnotSpan, vKnotSpan, indexBaseVctU, indexBaseVctV, numBasisFunctions, numLoops, size, remainder, division;
+    const int noCoord = 3;
     int numPatches = getIGAMesh()->getNumPatches();
     const double *knotVectorU, *knotVectorV;
     double JacobianCanonicalToUV, JacobianUVToPhysical, u, v;
@@ -751,7 +996,6 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
     double uv[2];
     double surfaceNormalTilde[3];
     const double* polyline;
-    vector<vector<double> > polygonTrimming;
 
     // 1. Loop over all patches in the multipatch geometry
     for (int iPatches = 0; iPatches < numPatches; iPatches++) {
@@ -773,13 +1017,13 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
         // 1v. Loop over all the trimming loops
         for (int iLoops = 0; iLoops < numLoops; iLoops++){
             // 1v.1. Get the polylines which comprise each trimming loop
-            vector<double> polygonTrimmingLoop;
             polyline = getIGAMesh()->getSurfacePatch(iPatches)->getTrimming().getLoop(iLoops).getPolylines(&size);
-            for (int iPoint = 0; iPoint < size; iPoint++)
-                polygonTrimmingLoop.push_back(polyline[iPoint]);
 
-            // 1v.2. Add the first point also at the end of the line
-            polygonTrimming.push_back(polygonTrimmingLoop);
+            // 1v.2. Check that the polylines consist of complete vertices
+            if (size % 2 != 0) {
+                ERROR_OUT() << "Number of coordinates for the polygon vertices is not even";
+                exit(-1);
+            }
         }
 
         // 1vi. Initialize the basis functions and base vectors arrays
@@ -798,8 +1042,8 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
             ERROR_BLOCK_OUT("createGaussQuadratureRules","IGAMortarMapper","Found corner case not encountered before related to the integration over a quadrilateral!");
 
         // 1viii. Instantiate the corresponding Gauss quadrature on quadrilateral
-        EMPIRE::MathLibrary::IGAGaussQuadrature* gaussURule = new MathLibrary::IGAGaussQuadratureOnBiunitInterval(numUGPs);
-        EMPIRE::MathLibrary::IGAGaussQuadrature* gaussVRule = new MathLibrary::IGAGaussQuadratureOnBiunitInterval(numVGPs);
+        const EMPIRE::MathLibrary::IGAGaussQuadrature* gaussURule = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_BIUNIT_INTERVAL, numUGPs);
+        const EMPIRE::MathLibrary::IGAGaussQuadrature* gaussVRule = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_BIUNIT_INTERVAL, numVGPs);
 
         // 1ix. Loop over all the nonzero elements of the patch
         for (int iVSpan = qDegree; iVSpan <= noVKnots - qDegree - 2; iVSpan++) {
@@ -823,15 +1067,8 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
                             // 1ix.3ii. Check if the Gauss point was found outside a trimming curve
                             uv[0] = u;
                             uv[1] = v;
-                            for (int iLoops = 0; iLoops < numLoops; iLoops++){
-                                polyline = getIGAMesh()->getSurfacePatch(iPatches)->getTrimming().getLoop(iLoops).getPolylines(&size);
-                                if (size % 2 != 0) {
-                                    ERROR_OUT() << "Number of coordinates for the polygon vertices is not even";
-                                    exit(-1);
-                                }
-                                numVertices = size / 2;
-                                isInside = MathLibrary::findIfPointIsInside2DPolygon(numVertices, polygonTrimming[iLoops], uv);
-                            }
+                            for (int iLoops = 0; iLoops < numLoops; iLoops++)
+                                isInside = getIGAMesh()->getSurfacePatch(iPatches)->getTrimming().getLoop(iLoops).isPointInside(uv);
                             if (isElementTrimmed)
                                     break;
 
@@ -855,7 +1092,7 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
 
                             // 1ix.3vi. Compute the Jacobian of the transformation from the physical to the parameter space
                             MathLibrary::computeVectorCrossProduct(baseVectorU, baseVectorV, surfaceNormalTilde);
-                            JacobianUVToPhysical = MathLibrary::vector2norm(surfaceNormalTilde, noCoord);
+                            JacobianUVToPhysical = MathLibrary::vector2norm<noCoord>(surfaceNormalTilde);
 
                             // 1ix.3vii. Updated the element size from the Gauss point contribution
                             elementArea += JacobianCanonicalToUV*JacobianUVToPhysical*gaussVRule->getGaussWeight(iUGP)*gaussURule->getGaussWeight(iVGP);
@@ -869,10 +1106,6 @@ void IGAMortarMapper::computeMinimumElementAreaSize() {
                 elementArea = 0.0;
             }
         }
-
-        // 1x. Erase pointers
-        delete gaussURule;
-        delete gaussVRule;
     }
 }
 
@@ -926,15 +1159,15 @@ void IGAMortarMapper::computeMinimumEdgeSize() {
             }
 
             // 1ii.2. Find the indices of the nodes in the FE mesh
-            indexNode1 = meshFEDirectElemTable[iElmnt][locIdNode1];
-            indexNode2 = meshFEDirectElemTable[iElmnt][locIdNode2];
+            indexNode1 = meshFEConnectivity->getElemNodes(iElmnt)[locIdNode1];
+            indexNode2 = meshFEConnectivity->getElemNodes(iElmnt)[locIdNode2];
 
             // 1ii.3. Get first node of the edge
             for (int iCoord = 0; iCoord < noCoord; iCoord++)
                 edgeFE[iCoord] = meshFE->nodes[3*indexNode2 + iCoord] - meshFE->nodes[3*indexNode1 + iCoord];
 
             // 1ii.4. Compute the edge length
-            edgeLength = EMPIRE::MathLibrary::vector2norm(edgeFE, noCoord);
+            edgeLength = EMPIRE::MathLibrary::vector2norm<noCoord>(edgeFE);
 
             // 1ii.5. Check if the current edge size is smaller than the smallest found
             if (edgeLength < minEdgeSize)
@@ -944,6 +1177,13 @@ void IGAMortarMapper::computeMinimumEdgeSize() {
 }
 
 void IGAMortarMapper::projectPointsToSurface() {
+    vector<int> nodeIndices(meshFE->numNodes);
+    for (int iNode = 0; iNode < meshFE->numNodes; iNode++)
+        nodeIndices[iNode] = iNode;
+    projectPointsToSurface(nodeIndices);
+}
+
+void IGAMortarMapper::projectPointsToSurface(const vector<int> &_nodeIndices) {
 
     // Number of spatial coordinates
     int numCoord = 3;
@@ -955,7 +1195,7 @@ void IGAMortarMapper::projectPointsToSurface() {
 
     // Array of booleans containing flags on the projection of the FE nodes onto the NURBS patch
     // A node needs to be projected at least once
-    vector<bool> isProjected(meshFE->numNodes);
+    vector<char> isProjected(meshFE->numNodes, 0);
 
     // Keep track of the minimum distance found between a node and a patch
     vector<double> minProjectionDistance(meshFE->numNodes, 1e9);
@@ -985,7 +1225,6 @@ void IGAMortarMapper::projectPointsToSurface() {
     vector<double> candidatesU;
     vector<double> candidatesV;
     double* candidatesXYZ;
-    double tmpUV[2];
     double* P;
 
     // Pointer to the patch to process
@@ -993,25 +1232,25 @@ void IGAMortarMapper::projectPointsToSurface() {
 
     INFO_OUT() << "Bounding box preprocessing started" << endl;
     time(&timeStart);
-    for (int iPatch = 0; iPatch < numPatches; iPatch++) {
-
-        // Get the patch to process
-        thePatch = meshIGA->getSurfacePatch(iPatch);
-
-        // Loop over the FE-Nodes
-        for (int iNode = 0; iNode < meshFE->numNodes; iNode++) {
-
-            // Get the point to process
-            P = &meshFE->nodes[numCoord * iNode];
-
-            // Check if the point is inside the bounding box and fill in the vectors with corresponding indices
-            bool isInside = thePatch->getBoundingBox().isPointInside(P, propProjection.maxProjectionDistance);
-            if(isInside) {
-                nodeIndicesToProcessPerPatch[iPatch].insert(iNode);
-                patchIndicesToProcessPerNode[iNode].insert(iPatch);
-                std::copy(P, P + numCoord, std::back_inserter(nodeCoordsToProcessPerPatch[iPatch]));
-            }
+    // Loop over the FE-Nodes, only the patches whose bounding box contains the node are returned by the hierarchy over the patch bounding boxes
+    vector<int> patchIndicesOfNode;
+    for (size_t i = 0; i < _nodeIndices.size(); i++) {
+        int iNode = _nodeIndices[i];
+
+        // Get the point to process
+        P = &meshFE->nodes[numCoord * iNode];
+
+        // Fill in the vectors with the indices of the patches whose bounding box contains the point
+        meshIGA->findPatchesContainingPoint(P, propProjection.maxProjectionDistance, patchIndicesOfNode);
+        for (int i = 0; i < patchIndicesOfNode.size(); i++) {
+            int iPatch = patchIndicesOfNode[i];
+            nodeIndicesToProcessPerPatch[iPatch].insert(iNode);
+            patchIndicesToProcessPerNode[iNode].insert(iPatch);
+            std::copy(P, P + numCoord, std::back_inserter(nodeCoordsToProcessPerPatch[iPatch]));
         }
+    }
+    // Only a projection of all nodes must have nodes in the bounding box of every patch
+    for (int iPatch = 0; iPatch < numPatches && _nodeIndices.size() == meshFE->numNodes; iPatch++) {
         if(nodeIndicesToProcessPerPatch[iPatch].empty()) {
             stringstream msg;
             msg << "Patch [" << iPatch << "] does not have any nodes in its bounding box! Increase maxProjectionDistance !";
@@ -1024,7 +1263,14 @@ void IGAMortarMapper::projectPointsToSurface() {
 
     INFO_OUT()<<"First pass projection started"<<endl;
     time(&timeStart);
+    long numProjectionsFirstPass = 0;
+    for (int iPatch = 0; iPatch < numPatches; iPatch++)
+        numProjectionsFirstPass += nodeIndicesToProcessPerPatch[iPatch].size();
+    BuildProgress progress("IGAMortarMapper: first pass projection", "projections", numProjectionsFirstPass);
     for (int iPatch = 0; iPatch < numPatches; iPatch++) {
+        if (nodeIndicesToProcessPerPatch[iPatch].empty())
+            continue;
+
         // Get the patch to project points onto
         thePatch = meshIGA->getSurfacePatch(iPatch);
 
@@ -1078,15 +1324,17 @@ void IGAMortarMapper::projectPointsToSurface() {
         candidatesV.push_back(grevilleAbscissaeV.back());
         EMPIRE::MathLibrary::sortRemoveDuplicates(candidatesV);
 
-        // Compute the physical coordinates of the initial guess points
+        // Compute the physical coordinates of the initial guess points in one batch
         candidatesXYZ = new double[candidatesU.size()*candidatesV.size()*numCoord];
+        std::vector<double> candidatesUV(candidatesU.size()*candidatesV.size()*2);
         for (int iCandidateV = 0; iCandidateV < candidatesV.size(); iCandidateV++) {
-            tmpUV[1] = candidatesV[iCandidateV];
             for (int iCandidateU = 0; iCandidateU < candidatesU.size(); iCandidateU++) {
-                tmpUV[0] = candidatesU[iCandidateU];
-                thePatch->computeCartesianCoordinates(&candidatesXYZ[(iCandidateV*candidatesU.size()+iCandidateU)*numCoord],tmpUV);
+                candidatesUV[(iCandidateV*candidatesU.size()+iCandidateU)*2] = candidatesU[iCandidateU];
+                candidatesUV[(iCandidateV*candidatesU.size()+iCandidateU)*2 + 1] = candidatesV[iCandidateV];
             }
         }
+        thePatch->computeCartesianCoordinatesAndNormalVectors(candidatesU.size()*candidatesV.size(),
+                &candidatesUV[0], candidatesXYZ, NULL, NULL);
 
         // Construct the search tree of initial guess points to find out the initial guess for the points to project
         #ifdef ANN
@@ -1112,36 +1360,47 @@ void IGAMortarMapper::projectPointsToSurface() {
             dummyDistances.clear();
         #endif
 
-        // Retrieve the initial guess coordinates from the patch parametric space(UV)
-        std::div_t dv;
-        int patchNodeIndex = 0;
-        // Loop over the nodes in the current patch bounding box
-        for(set<int>::iterator iNode = nodeIndicesToProcessPerPatch[iPatch].begin(); iNode != nodeIndicesToProcessPerPatch[iPatch].end(); iNode++) {
-            // The quotient = iVCP, remainder = iUCP, since the ordering of the initial guesses were done in such order. See the ordering of "candidatesXYZ" above.
-            #ifdef ANN
-                dv = std::div(patchCandidateIndices[patchNodeIndex], candidatesU.size());
-            #endif
-            #ifdef FLANN
-                dv = std::div(patchCandidateIndices[patchNodeIndex][0], candidatesU.size());
-            #endif
-
-            initialU = candidatesU[dv.rem];
-            initialV = candidatesV[dv.quot];
-
-            bool flagProjected = projectPointOnPatch(iPatch, *iNode, initialU, initialV, minProjectionDistance[*iNode], minProjectionPoint[*iNode]);
-            isProjected[*iNode] = isProjected[*iNode] || flagProjected;
-
-            /*if (isProjected[*iNode]) {
-                double P[3], projectedP[3],u,v;
-                projectedP[0] = P[0] = meshFE->nodes[*iNode * 3 + 0];
-                projectedP[1] = P[1] = meshFE->nodes[*iNode * 3 + 1];
-                projectedP[2] = P[2] = meshFE->nodes[*iNode * 3 + 2];
-                u = projectedCoords[*iNode][iPatch][0];
-                v = projectedCoords[*iNode][iPatch][1];
-                std::cout << "Projected node with coordinates ( " << projectedP[0] << " , " << projectedP[1]  << " , "  << projectedP[2] << " ) onto ( " << u << " , " << v << ")" << std::endl;
-            }*/
-
-            patchNodeIndex++;
+        // Compute the projections of all nodes in the current patch bounding box in parallel. The results are kept in a
+        // flat buffer per node (u, v, distance, projected point) and validated against the other patches afterwards
+        int numNodesInBox = nodeIndicesToProcessPerPatch[iPatch].size();
+        vector<int> batchNodeIndices(nodeIndicesToProcessPerPatch[iPatch].begin(), nodeIndicesToProcessPerPatch[iPatch].end());
+        vector<double> batchU(numNodesInBox);
+        vector<double> batchV(numNodesInBox);
+        vector<double> batchDistance(numNodesInBox);
+        vector<double> batchProjectedXYZ(numCoord * numNodesInBox);
+        vector<char> batchIsConverged(numNodesInBox);
+#pragma omp parallel num_threads(mapperSetNumThreads)
+        {
+            // no barrier at the end of the loop, so that the trace shows the load balance
+            PROFILER_WORKER_SCOPE("projection onto patch");
+#pragma omp for schedule(dynamic, 64) nowait
+            for (int patchNodeIndex = 0; patchNodeIndex < numNodesInBox; patchNodeIndex++) {
+                // Retrieve the initial guess coordinates from the patch parametric space(UV)
+                // The quotient = iVCP, remainder = iUCP, since the ordering of the initial guesses were done in such order. See the ordering of "candidatesXYZ" above.
+                std::div_t dv;
+                #ifdef ANN
+                    dv = std::div(patchCandidateIndices[patchNodeIndex], candidatesU.size());
+                #endif
+                #ifdef FLANN
+                    dv = std::div(patchCandidateIndices[patchNodeIndex][0], candidatesU.size());
+                #endif
+
+                batchU[patchNodeIndex] = candidatesU[dv.rem];
+                batchV[patchNodeIndex] = candidatesV[dv.quot];
+                batchIsConverged[patchNodeIndex] = computePointProjectionOnPatch(iPatch, batchNodeIndices[patchNodeIndex],
+                        batchU[patchNodeIndex], batchV[patchNodeIndex], &batchProjectedXYZ[numCoord * patchNodeIndex], batchDistance[patchNodeIndex]);
+                progress.add();
+            }
+        }
+
+        // Validate and store the projections, this depends on the projections onto the previous patches
+        for (int patchNodeIndex = 0; patchNodeIndex < numNodesInBox; patchNodeIndex++) {
+            if (!batchIsConverged[patchNodeIndex])
+                continue;
+            int iNode = batchNodeIndices[patchNodeIndex];
+            bool flagProjected = storePointProjection(iPatch, iNode, batchU[patchNodeIndex], batchV[patchNodeIndex], &batchProjectedXYZ[numCoord * patchNodeIndex],
+                                                      batchDistance[patchNodeIndex], minProjectionDistance[iNode], minProjectionPoint[iNode]);
+            isProjected[iNode] = isProjected[iNode] || flagProjected;
         }
 
         // Clear patch related variables
@@ -1151,11 +1410,15 @@ void IGAMortarMapper::projectPointsToSurface() {
         candidatesV.clear();
         delete[] candidatesXYZ;
     }
+    progress.finish();
     time(&timeEnd);
     INFO_OUT()<<"First pass projection done in "<< difftime(timeEnd, timeStart) << " seconds"<<endl;
 
     int missing = 0;
-    for (int iNode = 0; iNode < meshFE->numNodes; iNode++) {
+    for (size_t i = 0; i < _nodeIndices.size(); i++) {
+        int iNode = _nodeIndices[i];
+        if(isProjected[iNode])
+            buildStatistics.addProjection(MapperBuildStatistics::PROJECTION_DIRECT);
         if(!isProjected[iNode]) {
             missing++;
             notProjectedNodeIndicesFirstPass.insert(iNode);
@@ -1164,17 +1427,27 @@ void IGAMortarMapper::projectPointsToSurface() {
         }
     }
 
-    // Second pass projection --> relax Newton-Rapshon tolerance and if still fails refine the sampling points for the Newton-Raphson initial guesses
+    // Second pass projection --> closest point over the knot spans pruned by their bounding boxes, including the patch
+    // boundaries, and if still fails relax the Newton-Rapshon tolerance
     if(missing) {
-        INFO_OUT()<< missing << " out of " << meshFE->numNodes <<" nodes could NOT be projected during first pass" << endl;
+        INFO_OUT()<< missing << " out of " << _nodeIndices.size() <<" nodes could NOT be projected during first pass" << endl;
         INFO_OUT()<<"Second pass projection started"<<endl;
         time(&timeStart);
         missing = 0;
         for(set<int>::iterator iNode = notProjectedNodeIndicesFirstPass.begin(); iNode != notProjectedNodeIndicesFirstPass.end(); iNode++) {
             for(set<int>::iterator iPatch = patchIndicesToProcessPerNode[*iNode].begin();iPatch != patchIndicesToProcessPerNode[*iNode].end(); iPatch++) {
-                computeInitialGuessForProjection(*iPatch, meshFENodeToElementTable[*iNode][0], *iNode, initialU, initialV);
+                computeInitialGuessForProjection(*iPatch, meshFEConnectivity->getNodeElems(*iNode)[0], *iNode, initialU, initialV);
+                bool flagProjected = forceProjectPointOnPatchByPruning(*iPatch, *iNode, initialU, initialV, minProjectionDistance[*iNode], minProjectionPoint[*iNode]);
+                isProjected[*iNode] = isProjected[*iNode] || flagProjected;
+            }
+            if(isProjected[*iNode])
+                buildStatistics.addProjection(MapperBuildStatistics::PROJECTION_PRUNED);
+            for(set<int>::iterator iPatch = patchIndicesToProcessPerNode[*iNode].begin();iPatch != patchIndicesToProcessPerNode[*iNode].end() && !isProjected[*iNode]; iPatch++) {
+                computeInitialGuessForProjection(*iPatch, meshFEConnectivity->getNodeElems(*iNode)[0], *iNode, initialU, initialV);
                 bool flagProjected = forceProjectPointOnPatchByRelaxation(*iPatch, *iNode, initialU, initialV, minProjectionDistance[*iNode], minProjectionPoint[*iNode]);
                 isProjected[*iNode] = isProjected[*iNode] || flagProjected;
+                if(isProjected[*iNode])
+                    buildStatistics.addProjection(MapperBuildStatistics::PROJECTION_RELAXED);
             }
             if(!isProjected[*iNode]) {
                 notProjectedNodeIndicesSecondPass.insert(*iNode);
@@ -1198,6 +1471,8 @@ void IGAMortarMapper::projectPointsToSurface() {
 //                bool flagProjected = forceProjectPointOnPatchBySampling(*iPatch, *iNode, minProjectionDistance[*iNode], minProjectionPoint[*iNode]);
 //                isProjected[*iNode] = isProjected[*iNode] || flagProjected;
 //            }
+//            if(isProjected[*iNode])
+//                buildStatistics.addProjection(MapperBuildStatistics::PROJECTION_SAMPLED);
 //            if(!isProjected[*iNode]) {
 //                WARNING_OUT()<<"Node ["<<*iNode<<"] not projected at third pass with coordinates "<<meshFE->nodes[(*iNode)*numCoord]<<","<<meshFE->nodes[(*iNode)*numCoord+1]<<","<<meshFE->nodes[(*iNode)*numCoord+2]<<endl;
 //                missing++;
@@ -1208,9 +1483,10 @@ void IGAMortarMapper::projectPointsToSurface() {
 //        INFO_OUT()<<"Third pass projection done in "<< difftime(timeEnd, timeStart) << " seconds"<<endl;
 //    }
 
+    buildStatistics.addProjections(MapperBuildStatistics::PROJECTION_FAILED, missing);
     if(missing) {
         stringstream msg;
-        msg << missing << " nodes over " << meshFE->numNodes << " could NOT be projected!" << endl;
+        msg << missing << " nodes over " << _nodeIndices.size() << " could NOT be projected!" << endl;
         msg << "Treatment possibility 1." << endl;
         msg << "Possibly relax parameters in projectionProperties or newtonRaphson" << endl;
         msg << "Treatment possibility 2." << endl;
@@ -1219,6 +1495,108 @@ void IGAMortarMapper::projectPointsToSurface() {
     }
 }
 
+void IGAMortarMapper::reprojectPointsToSurface(vector<char>& _isElementChanged) {
+
+    // Number of spatial coordinates
+    int numCoord = 3;
+
+    // Time stamps
+    time_t timeStart, timeEnd;
+
+    // Without the projections of the last build all nodes are projected and all elements are integrated
+    if (projectedNodes.size() != numCoord * meshFE->numNodes) {
+        projectedCoords.assign(meshFE->numNodes, map<int, vector<double> >());
+        projectPointsToSurface();
+        projectedNodes.assign(meshFE->nodes, meshFE->nodes + numCoord * meshFE->numNodes);
+        _isElementChanged.assign(meshFE->numElems, 1);
+        return;
+    }
+
+    INFO_OUT() << "Warm started projection started" << endl;
+    time(&timeStart);
+
+    // Find the moved nodes and whether they are projected onto the same patches as before, a node entering the bounding
+    // box of another patch may be projected onto it
+    vector<int> movedNodeIndices;
+    vector<char> isWarmStarted;
+    vector<int> patchIndicesOfNode;
+    for (int iNode = 0; iNode < meshFE->numNodes; iNode++) {
+        const double *P = &meshFE->nodes[numCoord * iNode];
+        if (std::equal(P, P + numCoord, &projectedNodes[numCoord * iNode]))
+            continue;
+        bool isSamePatches = !projectedCoords[iNode].empty();
+        meshIGA->findPatchesContainingPoint(P, propProjection.maxProjectionDistance, patchIndicesOfNode);
+        for (int i = 0; i < patchIndicesOfNode.size() && isSamePatches; i++)
+            isSamePatches = projectedCoords[iNode].find(patchIndicesOfNode[i]) != projectedCoords[iNode].end();
+        movedNodeIndices.push_back(iNode);
+        isWarmStarted.push_back(isSamePatches);
+    }
+
+    // Project the moved nodes onto their patches starting from their previous parametric coordinates, the projections
+    // of a node are validated against each other as in the full search
+    int numMovedNodes = movedNodeIndices.size();
+    vector<map<int, vector<double> > > previousProjectedCoords(numMovedNodes);
+#pragma omp parallel for schedule(dynamic, 64) num_threads(mapperSetNumThreads)
+    for (int i = 0; i < numMovedNodes; i++) {
+        int iNode = movedNodeIndices[i];
+        previousProjectedCoords[i].swap(projectedCoords[iNode]);
+        if (!isWarmStarted[i])
+            continue;
+        double minProjectionDistance = 1e9;
+        vector<double> minProjectionPoint;
+        for (map<int, vector<double> >::const_iterator it = previousProjectedCoords[i].begin();
+                it != previousProjectedCoords[i].end() && isWarmStarted[i]; it++) {
+            double u = it->second[0];
+            double v = it->second[1];
+            double projectedP[3];
+            double distance;
+            isWarmStarted[i] = computePointProjectionOnPatch(it->first, iNode, u, v, projectedP, distance);
+            if (isWarmStarted[i])
+                storePointProjection(it->first, iNode, u, v, projectedP, distance, minProjectionDistance, minProjectionPoint);
+        }
+        if (!isWarmStarted[i])
+            projectedCoords[iNode].clear();
+    }
+    vector<int> nodeIndicesToSearch;
+    for (int i = 0; i < numMovedNodes; i++)
+        if (!isWarmStarted[i])
+            nodeIndicesToSearch.push_back(movedNodeIndices[i]);
+    time(&timeEnd);
+    INFO_OUT() << numMovedNodes - nodeIndicesToSearch.size() << " out of " << numMovedNodes
+            << " moved nodes projected from their previous parametric coordinates in " << difftime(timeEnd, timeStart) << " seconds" << endl;
+    buildStatistics.addProjections(MapperBuildStatistics::PROJECTION_WARM_STARTED, numMovedNodes - nodeIndicesToSearch.size());
+
+    // Search the remaining moved nodes on all patches
+    if (!nodeIndicesToSearch.empty())
+        projectPointsToSurface(nodeIndicesToSearch);
+
+    // The contributions of an element depend on the parametric coordinates of its nodes, those of an element split
+    // between patches also on the Cartesian coordinates of its nodes
+    vector<char> isNodeMoved(meshFE->numNodes, 0);
+    vector<char> isNodeProjectionChanged(meshFE->numNodes, 0);
+    for (int i = 0; i < numMovedNodes; i++) {
+        isNodeMoved[movedNodeIndices[i]] = 1;
+        isNodeProjectionChanged[movedNodeIndices[i]] = projectedCoords[movedNodeIndices[i]] != previousProjectedCoords[i];
+    }
+    _isElementChanged.assign(meshFE->numElems, 0);
+    for (int elemIndex = 0; elemIndex < meshFE->numElems; elemIndex++) {
+        bool isMoved = false;
+        for (int iNode = 0; iNode < meshFE->numNodesPerElem[elemIndex]; iNode++) {
+            int nodeIndex = meshFEConnectivity->getElemNodes(elemIndex)[iNode];
+            if (isNodeProjectionChanged[nodeIndex])
+                _isElementChanged[elemIndex] = 1;
+            isMoved = isMoved || isNodeMoved[nodeIndex];
+        }
+        if (isMoved && !_isElementChanged[elemIndex]) {
+            set<int> patchWithFullElt;
+            set<int> patchWithSplitElt;
+            getPatchesIndexElementIsOn(elemIndex, patchWithFullElt, patchWithSplitElt);
+            _isElementChanged[elemIndex] = !patchWithSplitElt.empty();
+        }
+    }
+    projectedNodes.assign(meshFE->nodes, meshFE->nodes + numCoord * meshFE->numNodes);
+}
+
 void IGAMortarMapper::computeInitialGuessForProjection(const int _patchIndex, const int _elemIndex, const int _nodeIndex, double& _u, double& _v) {
     /*
      * Finds an initial guess for the projection of a node on the given patch
@@ -1250,7 +1628,7 @@ void IGAMortarMapper::computeInitialGuessForProjection(const int _patchIndex, co
     // 3. Loop over all nodes of the current element
     for (int iNodesElmnt = 0; iNodesElmnt < meshFE->numNodesPerElem[_elemIndex]; iNodesElmnt++) {
         // 3i. Get the index of the node from the direct element freedom table
-        int nodeIndex = meshFEDirectElemTable[_elemIndex][iNodesElmnt];
+        int nodeIndex = meshFEConnectivity->getElemNodes(_elemIndex)[iNodesElmnt];
 
         // 3ii. Check if the node has already been projected and get its index
         if (projectedCoords[nodeIndex].find(_patchIndex) != projectedCoords[nodeIndex].end()) {
@@ -1274,45 +1652,58 @@ void IGAMortarMapper::computeInitialGuessForProjection(const int _patchIndex, co
 }
 
 bool IGAMortarMapper::projectPointOnPatch(const int patchIndex, const int nodeIndex, const double u0, const double v0, double& minProjectionDistance, vector<double>& minProjectionPoint) {
-
-    IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(patchIndex);
-    /// Get the Cartesian coordinates of the node in the FE side
-    double P[3], projectedP[3];
-    projectedP[0] = P[0] = meshFE->nodes[nodeIndex * 3 + 0];
-    projectedP[1] = P[1] = meshFE->nodes[nodeIndex * 3 + 1];
-    projectedP[2] = P[2] = meshFE->nodes[nodeIndex * 3 + 2];
     /// Get an initial guess for the parametric location of the projected node of the FE side on the NURBS patch
     double u = u0;
     double v = v0;
+    double projectedP[3];
+    double distance;
+    /// Compute point projection on the NURBS patch using the Newton-Rapshon iteration method
+    if(computePointProjectionOnPatch(patchIndex, nodeIndex, u, v, projectedP, distance))
+        return storePointProjection(patchIndex, nodeIndex, u, v, projectedP, distance, minProjectionDistance, minProjectionPoint);
+    return false;
+}
+
+bool IGAMortarMapper::computePointProjectionOnPatch(const int _patchIndex, const int _nodeIndex, double& _u, double& _v, double* _projectedP, double& _distance) {
+    IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(_patchIndex);
+    /// Get the Cartesian coordinates of the node in the FE side
+    double P[3];
+    for (int iCoord = 0; iCoord < 3; iCoord++)
+        _projectedP[iCoord] = P[iCoord] = meshFE->nodes[_nodeIndex * 3 + iCoord];
     /// Compute point projection on the NURBS patch using the Newton-Rapshon iteration method
     bool hasResidualConverged;
-    bool hasConverged = thePatch->computePointProjectionOnPatch(u, v, projectedP,
-                                                                hasResidualConverged, propNewtonRaphson.noIterations, propNewtonRaphson.tolProjection);
-    double distance = MathLibrary::computePointDistance(P, projectedP);
-    if(hasConverged &&  distance < propProjection.maxProjectionDistance) {
-        /// Perform some validity checks to validate the projected point
-        if(distance > minProjectionDistance + propProjection.maxProjectionDistanceOnDifferentPatches) {
-            return false;
-        }
-        if(!minProjectionPoint.empty() &&
-                MathLibrary::computePointDistance(projectedP, &minProjectionPoint[0]) > propProjection.maxProjectionDistanceOnDifferentPatches &&
-                distance > minProjectionDistance) {
-            return false;
-        }
-        if(distance < minProjectionDistance - propProjection.maxProjectionDistanceOnDifferentPatches
-                || MathLibrary::computePointDistance(projectedP, &minProjectionPoint[0]) > propProjection.maxProjectionDistanceOnDifferentPatches) {
-            projectedCoords[nodeIndex].clear();
-        }
-        /// Store result
-        vector<double> uv(2);
-        uv[0] = u;
-        uv[1] = v;
-        projectedCoords[nodeIndex].insert(make_pair(patchIndex, uv));
-        minProjectionDistance = distance;
-        minProjectionPoint = vector<double>(projectedP, projectedP + 3);
-        return true;
+    int numIterations;
+    bool hasConverged = thePatch->computePointProjectionOnPatch(_u, _v, _projectedP,
+                                                                hasResidualConverged, propNewtonRaphson.noIterations, propNewtonRaphson.tolProjection,
+                                                                IGAPatchSurface::TOL_DISTANCE, &numIterations);
+    buildStatistics.addNewtonIterations(numIterations);
+    _distance = MathLibrary::computePointDistance(P, _projectedP);
+    return hasConverged && _distance < propProjection.maxProjectionDistance;
+}
+
+bool IGAMortarMapper::storePointProjection(const int _patchIndex, const int _nodeIndex, const double _u, const double _v, const double* _projectedP,
+                                           const double _distance, double& _minProjectionDistance, vector<double>& _minProjectionPoint) {
+    double projectedP[3] = {_projectedP[0], _projectedP[1], _projectedP[2]};
+    /// Perform some validity checks to validate the projected point
+    if(_distance > _minProjectionDistance + propProjection.maxProjectionDistanceOnDifferentPatches) {
+        return false;
     }
-    return false;
+    if(!_minProjectionPoint.empty() &&
+            MathLibrary::computePointDistance(projectedP, &_minProjectionPoint[0]) > propProjection.maxProjectionDistanceOnDifferentPatches &&
+            _distance > _minProjectionDistance) {
+        return false;
+    }
+    if(_distance < _minProjectionDistance - propProjection.maxProjectionDistanceOnDifferentPatches
+            || MathLibrary::computePointDistance(projectedP, &_minProjectionPoint[0]) > propProjection.maxProjectionDistanceOnDifferentPatches) {
+        projectedCoords[_nodeIndex].clear();
+    }
+    /// Store result
+    vector<double> uv(2);
+    uv[0] = _u;
+    uv[1] = _v;
+    projectedCoords[_nodeIndex].insert(make_pair(_patchIndex, uv));
+    _minProjectionDistance = _distance;
+    _minProjectionPoint = vector<double>(projectedP, projectedP + 3);
+    return true;
 }
 
 bool IGAMortarMapper::forceProjectPointOnPatchByRelaxation(const int patchIndex, const int nodeIndex, const double u0, const double v0, double& minProjectionDistance, vector<double>& minProjectionPoint) {
@@ -1329,29 +1720,24 @@ bool IGAMortarMapper::forceProjectPointOnPatchByRelaxation(const int patchIndex,
     /// Compute point projection on the NURBS patch using the Newton-Rapshon iteration method
     bool hasConverged = thePatch->computeForcedPointProjectionOnPatch(u, v, projectedP);
     double distance = MathLibrary::computePointDistance(P, projectedP);
-    if(hasConverged &&  distance < propProjection.maxProjectionDistance) {
-        /// Perform some validity checks to validate the projected point
-        if(distance > minProjectionDistance + propProjection.maxProjectionDistanceOnDifferentPatches) {
-            return false;
-        }
-        if(!minProjectionPoint.empty() &&
-                MathLibrary::computePointDistance(projectedP, &minProjectionPoint[0]) > propProjection.maxProjectionDistanceOnDifferentPatches &&
-                distance > minProjectionDistance) {
-            return false;
-        }
-        if(distance < minProjectionDistance - propProjection.maxProjectionDistanceOnDifferentPatches
-                || MathLibrary::computePointDistance(projectedP, &minProjectionPoint[0]) > propProjection.maxProjectionDistanceOnDifferentPatches) {
-            projectedCoords[nodeIndex].clear();
-        }
-        /// Store result
-        vector<double> uv(2);
-        uv[0] = u;
-        uv[1] = v;
-        projectedCoords[nodeIndex].insert(make_pair(patchIndex, uv));
-        minProjectionDistance = distance;
-        minProjectionPoint = vector<double>(projectedP, projectedP + 3);
-        return true;
-    }
+    if(hasConverged &&  distance < propProjection.maxProjectionDistance)
+        return storePointProjection(patchIndex, nodeIndex, u, v, projectedP, distance, minProjectionDistance, minProjectionPoint);
+    return false;
+}
+
+bool IGAMortarMapper::forceProjectPointOnPatchByPruning(const int patchIndex, const int nodeIndex, const double u0, const double v0, double& minProjectionDistance, vector<double>& minProjectionPoint) {
+    IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(patchIndex);
+    /// Get the Cartesian coordinates of the node in the FE side
+    double P[3], projectedP[3];
+    for (int iCoord = 0; iCoord < 3; iCoord++)
+        projectedP[iCoord] = P[iCoord] = meshFE->nodes[nodeIndex * 3 + iCoord];
+    /// Compute the closest point on the NURBS patch, which may lie on its boundary
+    double u = u0;
+    double v = v0;
+    bool hasConverged = thePatch->computeClosestPointProjectionOnPatch(u, v, projectedP, propNewtonRaphson.noIterations, propNewtonRaphson.tolProjection);
+    double distance = MathLibrary::computePointDistance(P, projectedP);
+    if(hasConverged && distance < propProjection.maxProjectionDistance)
+        return storePointProjection(patchIndex, nodeIndex, u, v, projectedP, distance, minProjectionDistance, minProjectionPoint);
     return false;
 }
 
@@ -1365,12 +1751,13 @@ bool IGAMortarMapper::forceProjectPointOnPatchBySampling(const int patchIndex, c
     /// Get an initial guess for the parametric location of the projected node of the FE side on the NURBS patch
     double u = 0;
     double v = 0;
-    for(vector<int>::const_iterator it=meshFENodeToElementTable[nodeIndex].begin();it!=meshFENodeToElementTable[nodeIndex].end();it++) {
+    const int *elemsOfNode = meshFEConnectivity->getNodeElems(nodeIndex);
+    for(const int *it=elemsOfNode;it!=elemsOfNode+meshFEConnectivity->getNumElemsOfNode(nodeIndex);it++) {
         const int numNodesPerElem = meshFE->numNodesPerElem[*it];
         for(int i = 0; i< numNodesPerElem; i++) {
-            if(projectedCoords[meshFEDirectElemTable[*it][i]].find(patchIndex) != projectedCoords[meshFEDirectElemTable[*it][i]].end()) {
-                u = projectedCoords[meshFEDirectElemTable[*it][i]][patchIndex][0];
-                v = projectedCoords[meshFEDirectElemTable[*it][i]][patchIndex][1];
+            if(projectedCoords[meshFEConnectivity->getElemNodes(*it)[i]].find(patchIndex) != projectedCoords[meshFEConnectivity->getElemNodes(*it)[i]].end()) {
+                u = projectedCoords[meshFEConnectivity->getElemNodes(*it)[i]][patchIndex][0];
+                v = projectedCoords[meshFEConnectivity->getElemNodes(*it)[i]][patchIndex][1];
             }
         }
     }
@@ -1396,7 +1783,7 @@ bool IGAMortarMapper::forceProjectPointOnPatchBySampling(const int patchIndex, c
     return true;
 }
 
-void IGAMortarMapper::computeCouplingMatrices() {
+void IGAMortarMapper::computeCouplingMatrices(const vector<char> *_isElementChanged) {
     /*
      * Computes the coupling matrices CNR and CNN.
      * Loop over all the elements in the FE side
@@ -1408,12 +1795,19 @@ void IGAMortarMapper::computeCouplingMatrices() {
      * 2i. Loop over patches where element can be projected entirely on one patch
      * 2ii. Loop over patches where element is split
      * <-
+     *
+     * The elements are distributed over mapperSetNumThreads threads, every thread collects its
+     * contributions in its own buffer which are merged into the coupling matrices at the end. If the
+     * assembly has to be reproducible every element has its own buffer, they are merged in the order
+     * of the elements.
+     * On a geometry update the recorded contributions of the unchanged elements are copied into the
+     * buffers instead and those of the changed elements are recorded again
      */
     // Time stamps
     time_t timeStart, timeEnd;
 
-    /// List of integrated element
-    set<int> elementIntegrated;
+    /// Flag for every element on whether it is integrated
+    vector<char> elementIntegrated(meshFE->numElems, 0);
 
     int elementStringLength;
     {
@@ -1424,74 +1818,207 @@ void IGAMortarMapper::computeCouplingMatrices() {
 
     INFO_OUT() << "Computing coupling matrices started" << endl;
     time(&timeStart);
+    couplingMatrices->initBuffers(mapperSetNumThreads, meshFE->numElems);
+    if (propErrorComputation.isCompactStorage)
+        compactStreamGPsPerThread.resize(MathLibrary::getNumAssemblyBuffers(mapperSetNumThreads, meshFE->numElems));
+    else
+        streamGPsPerThread.resize(MathLibrary::getNumAssemblyBuffers(mapperSetNumThreads, meshFE->numElems));
+    numTriangulationsPerPath.assign(TriangulatorAdaptor::NUM_PATHS, 0);
+    numGaussPointsAdaptive = 0;
+    numGaussPointsSaved = 0;
+    /// Project the edges of the elements split by patch boundaries at once
+    computeBoundaryEdgeProjections(_isElementChanged);
+    /// Order the elements by their estimated cost, such that the expensive ones start first
+    vector<int> elementOrder;
+    {
+        vector<double> elementCosts(meshFE->numElems);
+#pragma omp parallel for schedule(static) num_threads(mapperSetNumThreads)
+        for (int elemIndex = 0; elemIndex < meshFE->numElems; elemIndex++)
+            elementCosts[elemIndex] = estimateElementCost(elemIndex, _isElementChanged);
+        CostOrderedSchedule::computeOrder(elementCosts, elementOrder);
+    }
+    BuildProgress progress("IGAMortarMapper: clipping and integration", "elements", meshFE->numElems);
     /// Loop over all the elements in the FE side
-    for (int elemIndex = 0; elemIndex < meshFE->numElems; elemIndex++) {
-        DEBUG_OUT()<< setfill ('#') << setw(18+elementStringLength) << "#" << endl;
-        DEBUG_OUT()<< setfill (' ') << "### ELEMENT ["<< setw(elementStringLength) << elemIndex << "] ###"<<endl;
-        DEBUG_OUT()<< setfill ('#') << setw(18+elementStringLength) << "#" << setfill (' ')<< endl;
-        // Get the number of shape functions. Depending on number of nodes in the current element
-        int numNodesElementFE = meshFE->numNodesPerElem[elemIndex];
-        /// Find whether the projected FE element is located on one patch
-        set<int> patchWithFullElt;
-        set<int> patchWithSplitElt;
-        getPatchesIndexElementIsOn(elemIndex, patchWithFullElt, patchWithSplitElt);
-        DEBUG_OUT()<<"Element FULLY projected on \t" << patchWithFullElt.size() << " patch" << endl;
-        DEBUG_OUT()<<"Element PARTLY projected on \t" << patchWithSplitElt.size() << " patch" << endl;
-
-        /////////////////////////////////////
-        /// Compute the coupling matrices ///
-        /////////////////////////////////////
-
-        /// 1. If the current element can be projected on one patch
-        for (set<int>::iterator it = patchWithFullElt.begin();
-             it != patchWithFullElt.end(); ++it) {
-            int patchIndex=*it;
-            /// Get the projected coordinates for the current element
-            Polygon2D polygonUV;
-            /// 1.1 Get initial polygon from projection
-            // For every point of polygon
-            buildFullParametricElement(elemIndex, numNodesElementFE, patchIndex, polygonUV);
-            ClipperAdapter::cleanPolygon(polygonUV);
-            bool isIntegrated = computeLocalCouplingMatrix(elemIndex, patchIndex, polygonUV);
-            if(isIntegrated) {
-                elementIntegrated.insert(elemIndex);
-                projectedPolygons[elemIndex][patchIndex]=polygonUV;
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        // no barrier at the end of the loop, so that the trace shows the load balance
+        PROFILER_WORKER_SCOPE("clipping and integration");
+#pragma omp for schedule(dynamic, 1) nowait
+        for (int position = 0; position < meshFE->numElems; position++) {
+            int elemIndex = elementOrder[position];
+            const int buffer = MathLibrary::getAssemblyBuffer(elemIndex);
+            DEBUG_OUT()<< setfill ('#') << setw(18+elementStringLength) << "#" << endl;
+            DEBUG_OUT()<< setfill (' ') << "### ELEMENT ["<< setw(elementStringLength) << elemIndex << "] ###"<<endl;
+            DEBUG_OUT()<< setfill ('#') << setw(18+elementStringLength) << "#" << setfill (' ')<< endl;
+            // Reuse the recorded contributions of an unchanged element
+            if (_isElementChanged != NULL && !(*_isElementChanged)[elemIndex]) {
+                couplingMatrices->addTripletsToBuffer(buffer, elementContributions[elemIndex].cnn,
+                        elementContributions[elemIndex].cnr);
+#pragma omp atomic
+                areaIntegration += elementContributions[elemIndex].area;
+                elementIntegrated[elemIndex] = !projectedPolygons[elemIndex].empty();
+                couplingMatrices->flushBufferIfFull(buffer);
+                progress.add();
+                continue;
+            }
+            size_t bufferSizeCnn, bufferSizeCnr;
+            if (_isElementChanged != NULL) {
+                projectedPolygons[elemIndex].clear();
+                triangulatedProjectedPolygons[elemIndex].clear();
+                elementContributions[elemIndex].area = 0.0;
+                couplingMatrices->getBufferSizes(buffer, bufferSizeCnn, bufferSizeCnr);
+            }
+            // The clipping and triangulation temporaries of the element are released at its end
+            MonotonicArena::Scope arenaScope(MonotonicArena::getThreadArena());
+            // Get the number of shape functions. Depending on number of nodes in the current element
+            int numNodesElementFE = meshFE->numNodesPerElem[elemIndex];
+            /// Find whether the projected FE element is located on one patch
+            set<int> patchWithFullElt;
+            set<int> patchWithSplitElt;
+            getPatchesIndexElementIsOn(elemIndex, patchWithFullElt, patchWithSplitElt);
+            DEBUG_OUT()<<"Element FULLY projected on \t" << patchWithFullElt.size() << " patch" << endl;
+            DEBUG_OUT()<<"Element PARTLY projected on \t" << patchWithSplitElt.size() << " patch" << endl;
+
+            /////////////////////////////////////
+            /// Compute the coupling matrices ///
+            /////////////////////////////////////
+
+            /// 1. If the current element can be projected on one patch
+            for (set<int>::iterator it = patchWithFullElt.begin();
+                 it != patchWithFullElt.end(); ++it) {
+                int patchIndex=*it;
+                /// Get the projected coordinates for the current element
+                Polygon2D polygonUV;
+                /// 1.1 Get initial polygon from projection
+                // For every point of polygon
+                buildFullParametricElement(elemIndex, numNodesElementFE, patchIndex, polygonUV);
+                ClipperAdapter::cleanPolygon(polygonUV);
+                bool isIntegrated = computeLocalCouplingMatrix(elemIndex, patchIndex, polygonUV);
+                if(isIntegrated) {
+                    elementIntegrated[elemIndex] = 1;
+                    projectedPolygons[elemIndex][patchIndex]=polygonUV;
+                }
             }
-        }
 
-        /// 2. If the current element is split in more than one patches
-        // Loop over all the patches in the IGA Mesh having a part of the FE element projected inside
-        for (set<int>::iterator it = patchWithSplitElt.begin(); it != patchWithSplitElt.end(); it++) {
-            int patchIndex = *it;
+            /// 2. If the current element is split in more than one patches
+            // Loop over all the patches in the IGA Mesh having a part of the FE element projected inside
+            for (set<int>::iterator it = patchWithSplitElt.begin(); it != patchWithSplitElt.end(); it++) {
+                int patchIndex = *it;
 
-            // Stores points of the polygon clipped by the nurbs patch
-            Polygon2D polygonUV;
+                // Stores points of the polygon clipped by the nurbs patch
+                Polygon2D polygonUV;
 
-            buildBoundaryParametricElement(elemIndex, numNodesElementFE, patchIndex, polygonUV);
+                buildBoundaryParametricElement(elemIndex, numNodesElementFE, patchIndex, polygonUV);
 
-            ClipperAdapter::cleanPolygon(polygonUV);
+                ClipperAdapter::cleanPolygon(polygonUV);
 
-            bool isIntegrated = computeLocalCouplingMatrix(elemIndex, patchIndex, polygonUV);
+                bool isIntegrated = computeLocalCouplingMatrix(elemIndex, patchIndex, polygonUV);
 
-            if(isIntegrated) {
-                elementIntegrated.insert(elemIndex);
-                projectedPolygons[elemIndex][patchIndex]=polygonUV;
-            }
-        } // end of loop over set of split patch
-    } // end of loop over all the element
+                if(isIntegrated) {
+                    elementIntegrated[elemIndex] = 1;
+                    projectedPolygons[elemIndex][patchIndex]=polygonUV;
+                }
+            } // end of loop over set of split patch
+
+            // Record the contributions of the element
+            if (_isElementChanged != NULL)
+                couplingMatrices->copyBufferTail(buffer, bufferSizeCnn, bufferSizeCnr,
+                        elementContributions[elemIndex].cnn, elementContributions[elemIndex].cnr);
+
+            // Keep the memory of the thread buffers bounded
+            couplingMatrices->flushBufferIfFull(buffer);
+            progress.add();
+        } // end of loop over all the element
+    }
+    progress.finish();
+
+    std::vector<BoundaryEdgeProjection>().swap(boundaryEdgeProjections);
+
+    /// Merge the contributions of all threads
+    couplingMatrices->assembleBuffers(mapperSetNumThreads);
+    for (int iThread = 0; iThread < streamGPsPerThread.size(); iThread++)
+        streamGPs.insert(streamGPs.end(), streamGPsPerThread[iThread].begin(), streamGPsPerThread[iThread].end());
+    streamGPsPerThread.clear();
+    for (int iThread = 0; iThread < compactStreamGPsPerThread.size(); iThread++) {
+        CompactStreamGPs &threadGPs = compactStreamGPsPerThread[iThread];
+        compactStreamGPs.indices.insert(compactStreamGPs.indices.end(), threadGPs.indices.begin(), threadGPs.indices.end());
+        compactStreamGPs.values.insert(compactStreamGPs.values.end(), threadGPs.values.begin(), threadGPs.values.end());
+        compactStreamGPs.numGPs += threadGPs.numGPs;
+    }
+    std::vector<CompactStreamGPs>().swap(compactStreamGPsPerThread);
+    if (propErrorComputation.isCompactStorage) {
+        std::vector<int>(compactStreamGPs.indices).swap(compactStreamGPs.indices);
+        std::vector<float>(compactStreamGPs.values).swap(compactStreamGPs.values);
+    }
+    int numElementsIntegrated = std::count(elementIntegrated.begin(), elementIntegrated.end(), 1);
 
     time(&timeEnd);
     INFO_OUT() << "Computing coupling matrices done! It took " << difftime(timeEnd, timeStart) << " seconds" << endl;
-    if(elementIntegrated.size() != meshFE->numElems) {
-        WARNING_OUT()<<"Number of FE mesh not integrated is "<<meshFE->numElems - elementIntegrated.size()<<" over "<<meshFE->numElems<<endl;
+    {
+        long numTriangulations = 0;
+        for (int iPath = 0; iPath < TriangulatorAdaptor::NUM_PATHS; iPath++)
+            numTriangulations += numTriangulationsPerPath[iPath];
+        INFO_OUT() << "Number of triangulated polygons: " << numTriangulations << endl;
+        for (int iPath = 0; iPath < TriangulatorAdaptor::NUM_PATHS && numTriangulations > 0; iPath++)
+            INFO_OUT() << "    by " << TriangulatorAdaptor::getPathName((TriangulatorAdaptor::TriangulationPath)iPath) << ": "
+                    << numTriangulationsPerPath[iPath] << " ("
+                    << 100.0 * numTriangulationsPerPath[iPath] / numTriangulations << "%)" << endl;
+    }
+    numTriangulationsPerPath.clear();
+    if (propIntegration.isAdaptive && numGaussPointsAdaptive + numGaussPointsSaved > 0)
+        INFO_OUT() << "Adaptive integration evaluated " << numGaussPointsAdaptive << " Gauss points and saved "
+                << numGaussPointsSaved << " (" << 100.0 * numGaussPointsSaved / (numGaussPointsAdaptive + numGaussPointsSaved)
+                << "%) with respect to the rules of the patches" << endl;
+    if(numElementsIntegrated != meshFE->numElems) {
+        WARNING_OUT()<<"Number of FE mesh not integrated is "<<meshFE->numElems - numElementsIntegrated<<" over "<<meshFE->numElems<<endl;
         for(int i = 0; i < meshFE->numElems; i++) {
-            if(!elementIntegrated.count(i))
+            if(!elementIntegrated[i])
                 WARNING_OUT()<<"Missing element number "<< i <<endl;
         }
         WARNING_BLOCK_OUT("IGAMortarMapper","ComputeCouplingMatrices","Not all element in FE mesh integrated ! Coupling matrices invalid");
     }
 }
 
+double IGAMortarMapper::estimateElementCost(int _elemIndex, const vector<char> *_isElementChanged) const {
+    // The contributions of an unchanged element are only copied
+    if (_isElementChanged != NULL && !(*_isElementChanged)[_elemIndex])
+        return COST_UNCHANGED_ELEMENT;
+    const int numNodes = meshFE->numNodesPerElem[_elemIndex];
+    const int *elemNodes = meshFEConnectivity->getElemNodes(_elemIndex);
+    double cost = 1.0;
+    for (int patchIndex = 0; patchIndex < meshIGA->getSurfacePatches().size(); patchIndex++) {
+        int numNodesOnPatch = 0;
+        int minSpanU = INT_MAX, maxSpanU = -1, minSpanV = INT_MAX, maxSpanV = -1;
+        const IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(patchIndex);
+        for (int nodeCount = 0; nodeCount < numNodes; nodeCount++) {
+            map<int, vector<double> >::const_iterator it = projectedCoords[elemNodes[nodeCount]].find(patchIndex);
+            if (it == projectedCoords[elemNodes[nodeCount]].end())
+                continue;
+            numNodesOnPatch++;
+            int spanU = thePatch->findSpanU(it->second[0]);
+            int spanV = thePatch->findSpanV(it->second[1]);
+            minSpanU = min(minSpanU, spanU);
+            maxSpanU = max(maxSpanU, spanU);
+            minSpanV = min(minSpanV, spanV);
+            maxSpanV = max(maxSpanV, spanV);
+        }
+        if (numNodesOnPatch == 0)
+            continue;
+        // An element crossing the patch boundary is clipped by the projections of its edges
+        if (numNodesOnPatch < numNodes)
+            cost += COST_SPLIT_PATCH;
+        // Every knot span under the element is clipped and integrated, the cut ones by the trimming too
+        for (int spanU = minSpanU; spanU <= maxSpanU; spanU++)
+            for (int spanV = minSpanV; spanV <= maxSpanV; spanV++) {
+                cost += 1.0;
+                if (thePatch->isTrimmed()
+                        && thePatch->getKnotSpanTrimming(spanU, spanV) == IGAPatchSurface::KNOTSPAN_CUT)
+                    cost += COST_CUT_KNOT_SPAN;
+            }
+    }
+    return cost;
+}
+
 void IGAMortarMapper::getPatchesIndexElementIsOn(int elemIndex, set<int>& patchWithFullElt, set<int>& patchWithSplitElt) {
     // Initialize the flag whether the projected FE element is located on one patch
     bool isAllNodesOnPatch = true;
@@ -1508,7 +2035,7 @@ void IGAMortarMapper::getPatchesIndexElementIsOn(int elemIndex, set<int>& patchW
         for (int nodeCount = 0; nodeCount < meshFE->numNodesPerElem[elemIndex]; nodeCount++) {
             // Find the index of the node in the FE mesh
 
-            int nodeIndex = meshFEDirectElemTable[elemIndex][nodeCount];
+            int nodeIndex = meshFEConnectivity->getElemNodes(elemIndex)[nodeCount];
 
             // Find whether this index is in the projected nodes array
             bool isNodeOnPatch = projectedCoords[nodeIndex].find(patchCount)
@@ -1539,7 +2066,7 @@ void IGAMortarMapper::getPatchesIndexElementIsOn(int elemIndex, set<int>& patchW
 void IGAMortarMapper::buildFullParametricElement(int elemCount, int numNodesElementFE, int patchIndex, Polygon2D& polygonUV) {
     // Just look into projectedCoords structure and build the polygon
     for (int nodeCount = 0; nodeCount < numNodesElementFE; nodeCount++) {
-        int nodeIndex = meshFEDirectElemTable[elemCount][nodeCount];
+        int nodeIndex = meshFEConnectivity->getElemNodes(elemCount)[nodeCount];
         double u = projectedCoords[nodeIndex][patchIndex][0];
         double v = projectedCoords[nodeIndex][patchIndex][1];
         polygonUV.push_back(make_pair(u,v));
@@ -1553,10 +2080,6 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
     bool isProjectedOnPatchBoundary, isProjectedOnPatchBoundary0, isProjectedOnPatchBoundary2;
     bool isNodeInsidePatch, isNode0InsidePatch, isNode2InsidePatch;
     bool isUInside, isVInside, isValid;
-    double* P0;
-    double* P1;
-    double* P2;
-    double* PIn;
     int nodeIndex, nodeIndex0, nodeIndex2;
     int nodeCount, nodeCount0, nodeCount2;
     double tolLambda = 1e-6;
@@ -1575,7 +2098,7 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
     // Loop over all the nodes of the Finite Element
     for(int nodeCount = 0; nodeCount < numNodesElementFE; nodeCount++) {
         // Get the node index in the node array
-        nodeIndex = meshFEDirectElemTable[elemIndex][nodeCount];
+        nodeIndex = meshFEConnectivity->getElemNodes(elemIndex)[nodeCount];
 
         // Get the flag whether the node has been projected inside the patch
         isNodeInsidePatch = projectedCoords[nodeIndex].find(patchIndex) != projectedCoords[nodeIndex].end();
@@ -1591,20 +2114,15 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
         nodeCount = (i + 0) % numNodesElementFE;
         nodeCount0 = (i + numNodesElementFE - 1) % numNodesElementFE;
         nodeCount2 = (i + 1) % numNodesElementFE;
-        nodeIndex = meshFEDirectElemTable[elemIndex][nodeCount];
-        nodeIndex0 = meshFEDirectElemTable[elemIndex][nodeCount0];
-        nodeIndex2 = meshFEDirectElemTable[elemIndex][nodeCount2];
+        nodeIndex = meshFEConnectivity->getElemNodes(elemIndex)[nodeCount];
+        nodeIndex0 = meshFEConnectivity->getElemNodes(elemIndex)[nodeCount0];
+        nodeIndex2 = meshFEConnectivity->getElemNodes(elemIndex)[nodeCount2];
 
         // Get the corresponding flags on whether the nodes are projected inside the patch
         isNodeInsidePatch = projectedCoords[nodeIndex].find(patchIndex) != projectedCoords[nodeIndex].end();
         isNode0InsidePatch = projectedCoords[nodeIndex0].find(patchIndex) != projectedCoords[nodeIndex0].end();
         isNode2InsidePatch = projectedCoords[nodeIndex2].find(patchIndex) != projectedCoords[nodeIndex2].end();
 
-        // Get the Cartesian coordinates of the node and its neighbours
-        P0 = &(meshFE->nodes[nodeIndex0 * 3]);
-        P1 = &(meshFE->nodes[nodeIndex * 3]);
-        P2 = &(meshFE->nodes[nodeIndex2 * 3]);
-
         // If the node is projected inside the patch add its parametric coordinates into the polygonUV container
         if(isNodeInsidePatch) {
             u = projectedCoords[nodeIndex][patchIndex][0];
@@ -1624,7 +2142,7 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
             v0 = v0In;
             lambda0 = 0.0;
             distance0 = propProjection.maxProjectionDistance;
-            isProjectedOnPatchBoundary0 = projectLineOnPatchBoundary(thePatch, u0, v0, lambda0, distance0, P0, P1);
+            isProjectedOnPatchBoundary0 = projectEdgeOnPatchBoundary(patchIndex, nodeIndex0, nodeIndex, u0, v0, lambda0, distance0);
 
             // Get the parametric coordinates of the next neighbouring node
             u2In = projectedCoords[nodeIndex2][patchIndex][0];
@@ -1635,7 +2153,7 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
             v2 = v2In;
             lambda2 = 0.0;
             distance2 = propProjection.maxProjectionDistance;
-            isProjectedOnPatchBoundary2 = projectLineOnPatchBoundary(thePatch, u2, v2, lambda2, distance2, P2, P1);
+            isProjectedOnPatchBoundary2 = projectEdgeOnPatchBoundary(patchIndex, nodeIndex2, nodeIndex, u2, v2, lambda2, distance2);
 
             // Initialize flag
             isValid = false;
@@ -1718,7 +2236,7 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
             v = vIn;
             lambda = 0.0;
             distance = propProjection.maxProjectionDistance;
-            isProjectedOnPatchBoundary = projectLineOnPatchBoundary(thePatch, u, v, lambda, distance, P2, P1);
+            isProjectedOnPatchBoundary = projectEdgeOnPatchBoundary(patchIndex, nodeIndex2, nodeIndex, u, v, lambda, distance);
         }
 
         // If the node has a projection outside the patch, the previous neighbouring node has a projection outside and next neighbouring node has a projection inside
@@ -1732,7 +2250,7 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
             v = vIn;
             lambda = 0.0;
             distance = propProjection.maxProjectionDistance;
-            isProjectedOnPatchBoundary = projectLineOnPatchBoundary(thePatch, u, v, lambda, distance, P0, P1);
+            isProjectedOnPatchBoundary = projectEdgeOnPatchBoundary(patchIndex, nodeIndex0, nodeIndex, u, v, lambda, distance);
         }
 
         // If no edge is projected on the patch boundary
@@ -1743,7 +2261,6 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
                     continue;
 
                 // Set up initial guess using the parametric coordinates of the projected node
-                PIn = &(meshFE->nodes[*it * 3]);
                 uIn = projectedCoords[*it][patchIndex][0];
                 vIn = projectedCoords[*it][patchIndex][1];
 
@@ -1752,7 +2269,7 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
                 v = vIn;
                 lambda = 0.0;
                 distance = propProjection.maxProjectionDistance;
-                isProjectedOnPatchBoundary = projectLineOnPatchBoundary(thePatch, u, v, lambda, distance, PIn, P1);
+                isProjectedOnPatchBoundary = projectEdgeOnPatchBoundary(patchIndex, *it, nodeIndex, u, v, lambda, distance);
             }
         }
 
@@ -1791,26 +2308,209 @@ void IGAMortarMapper::buildBoundaryParametricElement(int elemIndex, int numNodes
     }
 }
 
-bool IGAMortarMapper::projectLineOnPatchBoundary(IGAPatchSurface* thePatch, double& u, double& v, double& _lambda, double& _distance, double* Pin, double* Pout) {
-    double uIn = u;
-    double vIn = v;
-    double lambda = _lambda;
-    double distance =_distance;
-    bool isProjectedOnPatchBoundary = false;
-    double tolLambda = 1e-6;
-
-    // Use the Newton-Raphson algorithm to find the intersection
-    isProjectedOnPatchBoundary = thePatch->computePointProjectionOnPatchBoundaryNewtonRhapson(u, v, lambda, distance, Pin, Pout,
-                                                                                              propNewtonRaphsonBoundary.noIterations, propNewtonRaphsonBoundary.tolProjection);
-    // Check on whether the Newton-Raphson projection is valid
-    isProjectedOnPatchBoundary = isProjectedOnPatchBoundary && distance <= _distance && lambda >= tolLambda;
-
-    // Use the bisection algorithm to find the intersection
-    if (!isProjectedOnPatchBoundary) {
-        DEBUG_OUT() << "In IGAMortarMapper::projectLineOnPatchBoundary. Point projection on boundary using Newton-Rhapson did not converge. Trying bisection algorithm." << endl;
-        u = uIn;
-        v = vIn;
-        lambda = _lambda;
+void IGAMortarMapper::computeBoundaryEdgeProjections(const vector<char> *_isElementChanged) {
+    /*
+     * 1. Collect the directed edges from a node projected on a patch to a neighbouring node which is not, the edges
+     *    shared by neighbouring elements once
+     * 2. Linearize the boundaries of the patches with such edges
+     * 3. Project all edges in parallel with the same initial guess as buildBoundaryParametricElement
+     */
+    boundaryEdgeProjections.clear();
+    const int numPatches = meshIGA->getSurfacePatches().size();
+    vector<char> isPatchSplit(numPatches, 0);
+    for (int elemIndex = 0; elemIndex < meshFE->numElems; elemIndex++) {
+        if (_isElementChanged != NULL && !(*_isElementChanged)[elemIndex])
+            continue;
+        set<int> patchWithFullElt;
+        set<int> patchWithSplitElt;
+        getPatchesIndexElementIsOn(elemIndex, patchWithFullElt, patchWithSplitElt);
+        const int numNodesElementFE = meshFE->numNodesPerElem[elemIndex];
+        const int *elemNodes = meshFEConnectivity->getElemNodes(elemIndex);
+        for (set<int>::iterator it = patchWithSplitElt.begin(); it != patchWithSplitElt.end(); it++) {
+            isPatchSplit[*it] = 1;
+            for (int i = 0; i < numNodesElementFE; i++) {
+                int nodeOut = elemNodes[i];
+                if (projectedCoords[nodeOut].find(*it) != projectedCoords[nodeOut].end())
+                    continue;
+                int neighbours[2] = { elemNodes[(i + numNodesElementFE - 1) % numNodesElementFE],
+                        elemNodes[(i + 1) % numNodesElementFE] };
+                for (int j = 0; j < 2; j++) {
+                    if (projectedCoords[neighbours[j]].find(*it) == projectedCoords[neighbours[j]].end())
+                        continue;
+                    BoundaryEdgeProjection edge;
+                    edge.patchIndex = *it;
+                    edge.nodeIn = neighbours[j];
+                    edge.nodeOut = nodeOut;
+                    boundaryEdgeProjections.push_back(edge);
+                }
+            }
+        }
+    }
+    sort(boundaryEdgeProjections.begin(), boundaryEdgeProjections.end());
+    boundaryEdgeProjections.erase(unique(boundaryEdgeProjections.begin(), boundaryEdgeProjections.end()),
+            boundaryEdgeProjections.end());
+    if (boundaryEdgeProjections.empty())
+        return;
+
+    // The vertices of the linearized boundaries, four subdivisions per knot span, for the edges
+    // (0,1,2,3) --> (uRunsvStart,uRunsvEnd,uStartvRuns,uEndvRuns)
+    const int numSubdivisions = 4;
+    vector<vector<double> > boundaryParameters(4 * numPatches);
+    vector<vector<double> > boundaryPoints(4 * numPatches);
+#pragma omp parallel for num_threads(mapperSetNumThreads) schedule(dynamic, 1)
+    for (int patchIndex = 0; patchIndex < numPatches; patchIndex++) {
+        if (!isPatchSplit[patchIndex])
+            continue;
+        IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(patchIndex);
+        const BSplineBasis1D* uBasis = thePatch->getIGABasis()->getUBSplineBasis1D();
+        const BSplineBasis1D* vBasis = thePatch->getIGABasis()->getVBSplineBasis1D();
+        for (int edge = 0; edge < 4; edge++) {
+            const BSplineBasis1D* runningBasis = edge < 2 ? uBasis : vBasis;
+            const double* knots = runningBasis->getKnotVector();
+            double fixed = edge == 0 ? vBasis->getFirstKnot() : edge == 1 ? vBasis->getLastKnot() :
+                           edge == 2 ? uBasis->getFirstKnot() : uBasis->getLastKnot();
+            vector<double> &parameters = boundaryParameters[4 * patchIndex + edge];
+            vector<double> &points = boundaryPoints[4 * patchIndex + edge];
+            for (int span = runningBasis->getPolynomialDegree(); span < runningBasis->computeNoBasisFunctions(); span++) {
+                if (knots[span] == knots[span + 1])
+                    continue;
+                for (int k = 0; k < numSubdivisions; k++)
+                    parameters.push_back(knots[span] + (knots[span + 1] - knots[span]) * k / numSubdivisions);
+            }
+            parameters.push_back(runningBasis->getLastKnot());
+            points.resize(3 * parameters.size());
+            for (int k = 0; k < parameters.size(); k++) {
+                double uv[2] = { edge < 2 ? parameters[k] : fixed, edge < 2 ? fixed : parameters[k] };
+                thePatch->computeCartesianCoordinates(&points[3 * k], uv);
+            }
+        }
+    }
+
+    const int numEdges = boundaryEdgeProjections.size();
+    int numEdgesByLinearization = 0;
+#pragma omp parallel for num_threads(mapperSetNumThreads) schedule(dynamic, 16) reduction(+:numEdgesByLinearization)
+    for (int i = 0; i < numEdges; i++) {
+        BoundaryEdgeProjection &edge = boundaryEdgeProjections[i];
+        IGAPatchSurface* thePatch = meshIGA->getSurfacePatch(edge.patchIndex);
+        double* Pin = &(meshFE->nodes[edge.nodeIn * 3]);
+        double* Pout = &(meshFE->nodes[edge.nodeOut * 3]);
+        const vector<double> &uvIn = projectedCoords[edge.nodeIn].find(edge.patchIndex)->second;
+        edge.lambda = 0.0;
+        edge.distance = propProjection.maxProjectionDistance;
+        edge.isProjected = projectLineOnLinearizedPatchBoundary(thePatch, &boundaryParameters[4 * edge.patchIndex],
+                &boundaryPoints[4 * edge.patchIndex], edge.u, edge.v, edge.lambda, edge.distance, Pin, Pout);
+        if (edge.isProjected) {
+            numEdgesByLinearization++;
+            continue;
+        }
+        edge.u = uvIn[0];
+        edge.v = uvIn[1];
+        edge.lambda = 0.0;
+        edge.distance = propProjection.maxProjectionDistance;
+        edge.isProjected = projectLineOnPatchBoundary(thePatch, edge.u, edge.v, edge.lambda, edge.distance, Pin, Pout);
+    }
+    INFO_OUT() << "Projected " << numEdges << " element edges on the patch boundaries, " << numEdgesByLinearization
+            << " from the linearized boundaries" << endl;
+}
+
+bool IGAMortarMapper::projectLineOnLinearizedPatchBoundary(IGAPatchSurface* _thePatch, const vector<double>* _parameters,
+        const vector<double>* _points, double& _u, double& _v, double& _lambda, double& _distance, double* _Pin, double* _Pout) {
+    double tolLambda = 1e-6;
+
+    // 1. Find the closest segment of every linearized boundary to the line
+    double minDistance[4];
+    double minRatio[4];
+    double minLambda[4];
+    int minSegment[4];
+    for (int edge = 0; edge < 4; edge++) {
+        minDistance[edge] = numeric_limits<double>::max();
+        for (int k = 0; k + 1 < _parameters[edge].size(); k++) {
+            double lambda, ratio;
+            double distance = MathLibrary::distanceSegmentSegment(lambda, ratio, _Pin, _Pout, &_points[edge][3 * k],
+                    &_points[edge][3 * k + 3]);
+            if (distance < minDistance[edge]) {
+                minDistance[edge] = distance;
+                minRatio[edge] = ratio;
+                minLambda[edge] = lambda;
+                minSegment[edge] = k;
+            }
+        }
+    }
+
+    // 2. Only a boundary clearly closer than the others is taken, e.g. not near the corners of the patch
+    int edge = min_element(minDistance, minDistance + 4) - minDistance;
+    for (int other = 0; other < 4; other++)
+        if (other != edge && minDistance[other] <= 2.0 * minDistance[edge])
+            return false;
+
+    // 3. Refine the intersection on this boundary
+    const vector<double> &parameters = _parameters[edge];
+    double t = parameters[minSegment[edge]] + minRatio[edge] * (parameters[minSegment[edge] + 1] - parameters[minSegment[edge]]);
+    double lambda = minLambda[edge];
+    double distance;
+    bool isConverged = _thePatch->solvePointProjectionOnPatchBoundaryNewtonRaphson(t, lambda, distance, _Pin, _Pout, edge,
+            propNewtonRaphsonBoundary.noIterations, propNewtonRaphsonBoundary.tolProjection);
+    if (lambda > 1.0 && lambda - 1.0 <= 1e-3)
+        lambda = 1.0;
+    if (!isConverged || lambda < tolLambda || lambda > 1.0 || distance > _distance)
+        return false;
+
+    const BSplineBasis1D* uBasis = _thePatch->getIGABasis()->getUBSplineBasis1D();
+    const BSplineBasis1D* vBasis = _thePatch->getIGABasis()->getVBSplineBasis1D();
+    if (edge < 2) {
+        uBasis->clampKnot(t);
+        _u = t;
+        _v = edge == 0 ? vBasis->getFirstKnot() : vBasis->getLastKnot();
+    } else {
+        vBasis->clampKnot(t);
+        _u = edge == 2 ? uBasis->getFirstKnot() : uBasis->getLastKnot();
+        _v = t;
+    }
+    _lambda = lambda;
+    _distance = distance;
+    return true;
+}
+
+bool IGAMortarMapper::projectEdgeOnPatchBoundary(int _patchIndex, int _nodeIn, int _nodeOut, double& _u, double& _v,
+        double& _lambda, double& _distance) {
+    BoundaryEdgeProjection key;
+    key.patchIndex = _patchIndex;
+    key.nodeIn = _nodeIn;
+    key.nodeOut = _nodeOut;
+    vector<BoundaryEdgeProjection>::const_iterator it = lower_bound(boundaryEdgeProjections.begin(),
+            boundaryEdgeProjections.end(), key);
+    if (it != boundaryEdgeProjections.end() && *it == key) {
+        _u = it->u;
+        _v = it->v;
+        _lambda = it->lambda;
+        _distance = it->distance;
+        return it->isProjected;
+    }
+    // Nodes of an element which are not neighbours
+    return projectLineOnPatchBoundary(meshIGA->getSurfacePatch(_patchIndex), _u, _v, _lambda, _distance,
+            &(meshFE->nodes[_nodeIn * 3]), &(meshFE->nodes[_nodeOut * 3]));
+}
+
+bool IGAMortarMapper::projectLineOnPatchBoundary(IGAPatchSurface* thePatch, double& u, double& v, double& _lambda, double& _distance, double* Pin, double* Pout) {
+    double uIn = u;
+    double vIn = v;
+    double lambda = _lambda;
+    double distance =_distance;
+    bool isProjectedOnPatchBoundary = false;
+    double tolLambda = 1e-6;
+
+    // Use the Newton-Raphson algorithm to find the intersection
+    isProjectedOnPatchBoundary = thePatch->computePointProjectionOnPatchBoundaryNewtonRhapson(u, v, lambda, distance, Pin, Pout,
+                                                                                              propNewtonRaphsonBoundary.noIterations, propNewtonRaphsonBoundary.tolProjection);
+    // Check on whether the Newton-Raphson projection is valid
+    isProjectedOnPatchBoundary = isProjectedOnPatchBoundary && distance <= _distance && lambda >= tolLambda;
+
+    // Use the bisection algorithm to find the intersection
+    if (!isProjectedOnPatchBoundary) {
+        DEBUG_OUT() << "In IGAMortarMapper::projectLineOnPatchBoundary. Point projection on boundary using Newton-Rhapson did not converge. Trying bisection algorithm." << endl;
+        u = uIn;
+        v = vIn;
+        lambda = _lambda;
         distance = _distance;
         isProjectedOnPatchBoundary = thePatch->computePointProjectionOnPatchBoundaryBisection(u, v, lambda, distance, Pin, Pout,
                                                                                               propBisection.noIterations, propBisection.tolProjection);
@@ -1896,24 +2596,27 @@ bool IGAMortarMapper::computeLocalCouplingMatrix(const int _elemIndex, const int
         std::cout << "axis equal;" << std::endl;
     }*/
 
-    /// 1.2 Apply trimming
-    if(thePatch->isTrimmed())
-        clipByTrimming(thePatch,projectedElementOnPatch,listTrimmedPolygonUV);
+    /// 1.2 Apply trimming, which is done per knot span in 1.3.1 by the trimming state of the knot spans of the patch
 
-    /// Debug data
-    trimmedProjectedPolygons[_patchIndex].insert(trimmedProjectedPolygons[_patchIndex].end(),listTrimmedPolygonUV.begin(), listTrimmedPolygonUV.end());
     /// 1.3 For each subelement output of the trimmed polygon, clip by knot span
     for(int trimmedPolygonIndex=0;trimmedPolygonIndex<listTrimmedPolygonUV.size();trimmedPolygonIndex++) {
         Polygon2D listSpan;
         ListPolygon2D listPolygonUV;
-        /// 1.3.1 Clip by knot span
+        /// 1.3.1 Clip by knot span, then by the trimming of each knot span
         clipByKnotSpan(thePatch,listTrimmedPolygonUV[trimmedPolygonIndex],listPolygonUV,listSpan);
+        if(thePatch->isTrimmed())
+            clipByKnotSpanTrimming(thePatch,listPolygonUV,listSpan);
+
+        /// Debug data
+#pragma omp critical (IGAMortarMapperTrimmedPolygons)
+        trimmedProjectedPolygons[_patchIndex].insert(trimmedProjectedPolygons[_patchIndex].end(),listPolygonUV.begin(), listPolygonUV.end());
 
         /// 1.3.2 For each subelement clipped by knot span, compute canonical element and integrate
         for(int index=0;index<listSpan.size();index++) {
             // ClipperAdapter::cleanPolygon(listPolygonUV[index],1e-9);
             if(listPolygonUV[index].size() < 3)
                 continue;
+            buildStatistics.addClippedPolygon(listPolygonUV[index].size());
 
             /// Print on the terminal the Cartesian representation of the polygon
             /*std::cout << std::endl;
@@ -1959,6 +2662,7 @@ bool IGAMortarMapper::computeLocalCouplingMatrix(const int _elemIndex, const int
                 if(triangulatedPolygon->size() < 3)
                     continue;
                 triangulatedProjectedPolygons[_elemIndex][_patchIndex].push_back(*triangulatedPolygon);
+#pragma omp critical (IGAMortarMapperTriangulatedPolygons)
                 triangulatedProjectedPolygons2[_patchIndex].push_back(*triangulatedPolygon);
                 // Get canonical element
                 Polygon2D polygonWZ = computeCanonicalElement(_elemIndex, _projectedElement, *triangulatedPolygon);
@@ -1981,43 +2685,30 @@ void IGAMortarMapper::clipByPatch(const IGAPatchSurface* _thePatch, Polygon2D& _
     knotSpanWindow[2] = make_pair(u1,v1);
     knotSpanWindow[3] = make_pair(u0,v1);
     ClipperAdapter c;
-    _polygonUV = c.clip(_polygonUV,knotSpanWindow);
+    ListPolygon2D listSolution;
+    c.setPathClipper(knotSpanWindow);
+    c.clip(_polygonUV, listSolution);
+    _polygonUV = listSolution.empty() ? Polygon2D() : listSolution[0];
 }
 
-void IGAMortarMapper::clipByTrimming(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygonUV) {
+void IGAMortarMapper::clipByKnotSpanTrimming(const IGAPatchSurface* _thePatch, ListPolygon2D& _listPolygon, Polygon2D& _listSpan) {
     /*
-     * Clips a given polygon by the tirmming curves within a patch
-     *
-     * Function layout:
-     *
-     * 1. Initialize auxiliary variables
-     *
-     * 2. Loop over all trimming loops within the patch
-     * ->
-     *    2i. Get the linearized trimming loop
-     *   2ii. Add the trimming loop in the clipper
-     * <-
-     *
-     * 3. Setup filling rule to have for sure clockwise loop as hole and counterclockwise as boundaries
+     * Clips the polygons resulting from the knot span clipping by the trimming of their knot spans.
+     * Polygons in untrimmed knot spans are kept as they are, the ones in knot spans trimmed away are
+     * dropped, and only the ones in cut knot spans are given to the clipper
      */
-
-    // 1. Initialize auxiliary variables
-    ClipperAdapter c;
-
-    // 2. Loop over all trimming loops within the patch
-    for(int loop = 0; loop < _thePatch->getTrimming().getNumOfLoops(); loop++) {
-        // 2i. Get the linearized trimming loop
-        const std::vector<double> clippingWindow = _thePatch->getTrimming().getLoop(loop).getPolylines();
-
-        // 2ii. Add the trimming loop in the clipper
-        c.addPathClipper(clippingWindow);
+    ListPolygon2D listKnotSpanPolygon;
+    Polygon2D listKnotSpan;
+    listKnotSpanPolygon.swap(_listPolygon);
+    listKnotSpan.swap(_listSpan);
+    ListPolygon2D listTrimmedPolygon;
+    for(int index = 0; index < listKnotSpan.size(); index++) {
+        _thePatch->clipByKnotSpanTrimming(listKnotSpan[index].first, listKnotSpan[index].second, listKnotSpanPolygon[index], listTrimmedPolygon);
+        for(int i = 0; i < listTrimmedPolygon.size(); i++) {
+            _listPolygon.push_back(listTrimmedPolygon[i]);
+            _listSpan.push_back(listKnotSpan[index]);
+        }
     }
-
-    // 3. Setup filling rule to have for sure clockwise loop as hole and counterclockwise as boundaries
-    c.setFilling(ClipperAdapter::POSITIVE, 0);
-    c.addPathSubject(_polygonUV);
-    c.clip();
-    c.getSolution(_listPolygonUV);
 }
 
 void IGAMortarMapper::clipByTrimming(const IGAPatchSurfaceTrimmingLoop* _theTrimmingLoop, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygonUV) {
@@ -2071,18 +2762,20 @@ void IGAMortarMapper::clipByKnotSpan(const IGAPatchSurface* _thePatch, const Pol
      *    ->
      *        4i.1. Loop over all spans in v-direction
      *        ->
-     *              4i.1i. Initialize a clipper adapter
-     *             4i.1ii. Clip the polygon with the knot span window
-     *             ### Check if the encountered knot span is collapsed ###
-     *             4i.1ii.1. Create the knot span window
-     *             4i.1ii.2. Clip the polygon with the knot span window (WARNING : here we assume to get only a single output polygon from the clipping!)
+     *               4i.1i. Clip the polygon with the knot span window
+     *               ### Check if the encountered knot span is collapsed ###
+     *               4i.1i.1. Set the knot span window as clipping window
+     *               4i.1i.2. Clip the polygon with the knot span window (WARNING : here we assume to get only a single output polygon from the clipping!)
      *        <-
      *    <-
      * <-
      */
 
-    // 1. Initialize auxiliary variables
+    // 1. Initialize auxiliary variables, the clipper adapter keeps its storage for all knot span windows
     int span[4];
+    ClipperAdapter c(EPS_CLIPPING);
+    Polygon2D knotSpanWindow(4);
+    ListPolygon2D listSolution;
 
     // 2. Get the knot vectors of the patch
     const double *knotVectorU = _thePatch->getIGABasis()->getUBSplineBasis1D()->getKnotVector();
@@ -2107,22 +2800,19 @@ void IGAMortarMapper::clipByKnotSpan(const IGAPatchSurface* _thePatch, const Pol
         for (int spanU = minSpanU; spanU <= maxSpanU; spanU++) {
             // 4i.1. Loop over all spans in v-direction
             for (int spanV = minSpanV; spanV <= maxSpanV; spanV++) {
-                // 4i.1i. Initialize a clipper adapter
-                ClipperAdapter c(EPS_CLIPPING);
-
-                // 4i.1ii. Clip the polygon with the knot span window
+                // 4i.1i. Clip the polygon with the knot span window
                 if (knotVectorU[spanU] != knotVectorU[spanU + 1] && knotVectorV[spanV] != knotVectorV[spanV + 1]) { // ### Check if the encountered knot span is collapsed ###
-                    // 4i.1ii.1. Create the knot span window
-                    Polygon2D knotSpanWindow(4);
+                    // 4i.1i.1. Set the knot span window as clipping window
                     knotSpanWindow[0] = make_pair(knotVectorU[spanU],knotVectorV[spanV]);
                     knotSpanWindow[1] = make_pair(knotVectorU[spanU + 1],knotVectorV[spanV]);
                     knotSpanWindow[2] = make_pair(knotVectorU[spanU + 1],knotVectorV[spanV + 1]);
                     knotSpanWindow[3] = make_pair(knotVectorU[spanU],knotVectorV[spanV + 1]);
+                    c.setPathClipper(knotSpanWindow);
 
-                    // 4i.1ii.2. Clip the polygon with the knot span window (WARNING : here we assume to get only a single output polygon from the clipping!)
-                    Polygon2D solution = c.clip(_polygonUV,knotSpanWindow);
+                    // 4i.1i.2. Clip the polygon with the knot span window (WARNING : here we assume to get only a single output polygon from the clipping!)
+                    c.clip(_polygonUV, listSolution);
                     /// Store polygon and its knot span for integration
-                    _listPolygon.push_back(solution);
+                    _listPolygon.push_back(listSolution.empty() ? Polygon2D() : listSolution[0]);
                     _listSpan.push_back(make_pair(spanU,spanV));
                 }
             }
@@ -2136,44 +2826,24 @@ IGAMortarMapper::ListPolygon2D IGAMortarMapper::triangulatePolygon(const Polygon
      *
      * Function layout :
      *
-     * 1. If the polygon is already a triangle do nothing
-     *
-     * 2. Initialize triangulator
+     * 1. Triangulate the polygon, small convex polygons by a fan and other small polygons by ear clipping
      *
-     * 3. Loop over all segments of the given polygon and add its ends into the triangulator
+     * 2. Count the path taken for the statistics of the computation of the coupling matrices
      *
-     * 4. Triangulate the polygon
-     *
-     * 5. Fill the output list of the newly generated polygons
-     *
-     * 6. Return the updated list of the triangulated polygons
+     * 3. Return the list of the triangulated polygons, empty if the triangulation failed
      */
 
-    // 1. If the polygon is already a triangle do nothing
-    if(_polygonUV.size() < 4)
-        return ListPolygon2D(1,_polygonUV);
-
-    // 2. Initialize triangulator
-    TriangulatorAdaptor triangulator;
-
-    // 3. Loop over all segments of the given polygon and add its ends into the triangulator
-    for(Polygon2D::const_iterator it = _polygonUV.begin(); it!=_polygonUV.end(); it++)
-        triangulator.addPoint(it->first,it->second,0);
+    // 1. Triangulate the polygon
+    ListPolygon2D out;
+    TriangulatorAdaptor::TriangulationPath path = TriangulatorAdaptor::triangulatePolygon(_polygonUV, out);
 
-    // 4. Triangulate the polygon
-    int numTriangles = _polygonUV.size() - 2;
-    int triangleIndexes[3 * numTriangles];
-    bool triangulated = triangulator.triangulate(triangleIndexes);
-    if(!triangulated)
-        return ListPolygon2D();
-
-    // 5. Fill the output list of the newly generated polygons
-    ListPolygon2D out(numTriangles, Polygon2D(3));
-    for(int i = 0; i < numTriangles; i++)
-        for(int j = 0; j < 3; j++)
-            out[i][j] = _polygonUV[triangleIndexes[3*i + j]];
+    // 2. Count the path taken
+    if (!numTriangulationsPerPath.empty()) {
+#pragma omp atomic
+        numTriangulationsPerPath[path]++;
+    }
 
-    // 6. Return the updated list of the triangulated polygons
+    // 3. Return the list of the triangulated polygons
     return out;
 }
 
@@ -2234,6 +2904,32 @@ IGAMortarMapper::Polygon2D IGAMortarMapper::computeCanonicalElement(const int _e
     return polygonWZ;
 }
 
+/***********************************************************************************************
+ * \brief Compute the images of all Gauss points of the integration domain in the NURBS parameter
+ *        space and the basis functions of the low order Finite Element at them, with the number of
+ *        nodes of the integration domain and of the Finite Element fixed at compile time
+ * \param[in] _theGaussQuadrature the Gauss quadrature on the canonical integration domain
+ * \param[in] _nodesUV the nodes of the integration domain in the NURBS parameter space
+ * \param[in] _nodesWZ the nodes of the integration domain in the canonical space of the element
+ * \param[out] _uv the images of the Gauss points in the NURBS parameter space, numGPs x 2
+ * \param[out] _basisFunctionsFE the basis functions of the element, numGPs x NUM_NODES_FE
+ ***********/
+template<int NUM_NODES_QUADRATURE, int NUM_NODES_FE>
+static void computeGaussPointImages(const MathLibrary::IGAGaussQuadrature *_theGaussQuadrature,
+        const double *_nodesUV, const double *_nodesWZ, double *_uv, double *_basisFunctionsFE) {
+    const int numGPs = _theGaussQuadrature->getNumGaussPoints();
+    for (int iGP = 0; iGP < numGPs; iGP++) {
+        double basisFunctions[NUM_NODES_QUADRATURE];
+        double wz[2];
+        MathLibrary::computeLowOrderShapeFunc<NUM_NODES_QUADRATURE>(
+                _theGaussQuadrature->getGaussPoint(iGP), basisFunctions);
+        MathLibrary::computeLinearCombination<NUM_NODES_QUADRATURE, 2>(_nodesUV, basisFunctions,
+                &_uv[iGP * 2]);
+        MathLibrary::computeLinearCombination<NUM_NODES_QUADRATURE, 2>(_nodesWZ, basisFunctions, wz);
+        MathLibrary::computeLowOrderShapeFunc<NUM_NODES_FE>(wz, &_basisFunctionsFE[iGP * NUM_NODES_FE]);
+    }
+}
+
 void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Polygon2D _polygonUV,
                                 int _spanU, int _spanV, Polygon2D _polygonWZ, int _elementIndex) {
     /*
@@ -2249,43 +2945,34 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
      *
      * 4. Create an element freedom table for the isogeometric field
      *
+     * 4ii. Initialize the local coupling matrices
+     *
      * 5. Copy input polygon into contiguous C format
      *
+     * 5ii. Compute the images of all Gauss points in the NURBS parameter space and the basis functions of the low order Finite Element at them
+     *
      * 6. Loop over all Gauss points
      * ->
-     *    6i. Get the Gauss point coordinates in the integration space
-     *   6ii. Get the Gauss point weight
-     *  6iii. Compute the basis functions describing parametrically the integration domain
-     *   6iv. Compute the image of the gauss point in the NURBS parameter space
-     *    6v. Compute the image of the Gauss point in the low order Finite Element
-     *   6vi. Compute the basis functions of the low order Finite Element
-     *  6vii. Compute the local NURBS basis functions and their first order derivatives
-     * 6viii. Compute the base vectors and their first derivatives
-     *   6ix. Compute the surface normal vector at the Gauss point
-     *    6x. Compute the determinant of the Jacobian of the transformation from the physical space to the NURBS parameter space
-     *   6xi. Compute the determinant of the Jacobian of the transformation from the NURBS parameter space to the canonical space
-     *  6xii. Compute the product of the determinants of the Jacobian matrices
-     * 6xiii. Update the integration area at the Gauss point
-     *   6xiv. Loop over all local basis functions in the master side
-     * ->
-     *        6xiv.1. Loop over all local basis functions in the master side to compute and assemble the local Cnn matrix to the global one
-     *        ->
-     *                 6xiv.1i. Compute the product of the basis functions
-     *                6xiv.1ii. Compute the integrand on the Gauss point times the Gauss weight
-     *               6xiv.1iii. Find the DOF numbering of the dual basis functions product
-     *                6xiv.1iv. Assemble the element contributions to the global Cnn matrix
-     *        <-
-     *
-     *        6xiv.2. Loop over all local basis functions in the slave side to compute and assemble the local Cnr matrix to the global one
-     *        ->
-     *                 6xiv.2i. Compute the integrand on the Gauss point times the Gauss weight
-     *                6xiv.2ii. Find the DOF numbering of the dual basis functions product
-     *               6xiv.2iii. Assemble the element contributions to the global Cnr matrix
-     *        <-
+     *     6i. Get the Gauss point coordinates in the integration space
+     *    6ii. Get the Gauss point weight
+     *   6iii. Get the image of the Gauss point in the NURBS parameter space
+     *    6iv. Get the basis functions of the low order Finite Element at the Gauss point
+     *     6v. Compute the local NURBS basis functions and their first order derivatives
+     *    6vi. Compute the base vectors and their first derivatives
+     *   6vii. Compute the surface normal vector at the Gauss point
+     *  6viii. Compute the determinant of the Jacobian of the transformation from the physical space to the NURBS parameter space
+     *    6ix. Compute the determinant of the Jacobian of the transformation from the NURBS parameter space to the canonical space
+     *     6x. Compute the product of the determinants of the Jacobian matrices
+     *    6xi. Update the integration area at the Gauss point
+     *   6xii. Store the master and the slave basis functions and the weight of the Gauss point in the batch
+     *  6xiii. Save the gauss point data for the computation of the L2 norm of the error
      * <-
      *
-     *  6xv. Save the gauss point data for the computation of the L2 norm of the error
-     * <-
+     * 6b. Compute the local Cnn and Cnr matrices from the batch of all Gauss points
+     *
+     * 7. Update the integration area
+     *
+     * 8. Assemble the local matrices into the buffers of the element, see MathLibrary::getAssemblyBuffer
      */
 
     // 1. Read input
@@ -2299,7 +2986,7 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
     assert(numNodesWZ < 5);
 
     // 2. Get the corresponding quadrature rule depending on the integration domain
-    EMPIRE::MathLibrary::IGAGaussQuadrature* theGaussQuadrature;
+    const EMPIRE::MathLibrary::IGAGaussQuadrature* theGaussQuadrature;
     int nNodesQuadrature = numNodesUV;
     if (nNodesQuadrature == 3)
         theGaussQuadrature = gaussRuleOnTriangle[_patchIndex];
@@ -2309,10 +2996,22 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
         ERROR_OUT() << "Only triangles and quadrilaterals are expected as integration domains";
         exit(-1);
     }
+    if (propIntegration.isAdaptive) {
+        const EMPIRE::MathLibrary::IGAGaussQuadrature* theAdaptiveGaussQuadrature =
+                getAdaptiveGaussQuadrature(_thePatch, _patchIndex, _polygonUV, _spanU, _spanV, _elementIndex);
+        int numGPsAdaptive = theAdaptiveGaussQuadrature->getNumGaussPoints();
+        int numGPsSaved = theGaussQuadrature->getNumGaussPoints() - numGPsAdaptive;
+#pragma omp atomic
+        numGaussPointsAdaptive += numGPsAdaptive;
+#pragma omp atomic
+        numGaussPointsSaved += numGPsSaved;
+        theGaussQuadrature = theAdaptiveGaussQuadrature;
+    }
+    buildStatistics.addGaussPoints(theGaussQuadrature->getNumGaussPoints());
 
     // 2. Initialize auxiliary variables
     int indexBaseVctU, indexBaseVctV;
-    int noCoord = 3;
+    const int noCoord = 3;
     int derivDegree = 1;
     int derivDegreeBaseVec = 0;
     int noBaseVec = 2;
@@ -2324,11 +3023,9 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
     int pDegree = _thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
     int qDegree = _thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
     int numBasisFunctionsIGA = (pDegree + 1) * (qDegree + 1);
-    double basisFunctions[nNodesQuadrature];
-    double basisFunctionsFE[numNodesElementFE];
+    const double *basisFunctionsFE;
     double cartesianCoordGP[noCoord];
-    double uv[2];
-    double wz[2];
+    const double *uv;
     double baseVectorU[3];
     double baseVectorV[3];
     double surfaceNormalTilde[3];
@@ -2340,11 +3037,6 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
     double dudy;
     double dvdx;
     double dvdy;
-    double IGABasisFctsI;
-    double IGABasisFctsJ;
-    double basisFctsMaster;
-    double basisFctsSlave;
-    double basisFunctionsProduct;
     double integrand;
     double localBasisFunctionsAndDerivatives[(derivDegree + 1) * (derivDegree + 2) * numBasisFunctionsIGA / 2];
     double baseVctsAndDerivs[(derivDegreeBaseVec + 1) * (derivDegreeBaseVec + 2) * noCoord * noBaseVec / 2];
@@ -2364,6 +3056,22 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
     for (int i = 0; i < numBasisFunctionsIGA; i++)
         dofIGA[i] = _thePatch->getControlPointNet()[dofIGA[i]]->getDofIndex();
 
+    // 4ii. Initialize the local coupling matrices which are accumulated over all Gauss points
+    const int buffer = MathLibrary::getAssemblyBuffer(_elementIndex);
+    double localCnn[numNodesElMaster * numNodesElMaster];
+    double localCnr[numNodesElMaster * numNodesElSlave];
+    for (int i = 0; i < numNodesElMaster * numNodesElMaster; i++)
+        localCnn[i] = 0.0;
+    for (int i = 0; i < numNodesElMaster * numNodesElSlave; i++)
+        localCnr[i] = 0.0;
+    double localAreaIntegration = 0.0;
+
+    // 4iii. The batch of the Gauss points, the Gauss point is the innermost index of the basis functions
+    const int numGPs = theGaussQuadrature->getNumGaussPoints();
+    double batchBasisMaster[numNodesElMaster * numGPs];
+    double batchBasisSlave[numNodesElSlave * numGPs];
+    double batchWeights[numGPs];
+
     // 5. Copy input polygon into contiguous C format
     double nodesUV[8];
     double nodesWZ[8];
@@ -2374,31 +3082,42 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
         nodesWZ[i*2 + 1] = _polygonWZ[i].second;
     }
 
+    // 5ii. Compute the images of all Gauss points in the NURBS parameter space and the basis
+    // functions of the low order Finite Element at them, dispatched once on the element types
+    double allUV[numGPs * 2];
+    double allBasisFunctionsFE[numGPs * numNodesElementFE];
+    if (nNodesQuadrature == 3 && numNodesElementFE == 3)
+        computeGaussPointImages<3, 3>(theGaussQuadrature, nodesUV, nodesWZ, allUV, allBasisFunctionsFE);
+    else if (nNodesQuadrature == 3 && numNodesElementFE == 4)
+        computeGaussPointImages<3, 4>(theGaussQuadrature, nodesUV, nodesWZ, allUV, allBasisFunctionsFE);
+    else if (nNodesQuadrature == 4 && numNodesElementFE == 3)
+        computeGaussPointImages<4, 3>(theGaussQuadrature, nodesUV, nodesWZ, allUV, allBasisFunctionsFE);
+    else if (nNodesQuadrature == 4 && numNodesElementFE == 4)
+        computeGaussPointImages<4, 4>(theGaussQuadrature, nodesUV, nodesWZ, allUV, allBasisFunctionsFE);
+    else {
+        ERROR_OUT() << "Low order basis functions are computed for only triangles or quadrilaterals" << endl;
+        exit(-1);
+    }
+
     // 6. Loop over all Gauss points
-    for (int iGP = 0; iGP < theGaussQuadrature->getNumGaussPoints(); iGP++) {
+    for (int iGP = 0; iGP < numGPs; iGP++) {
         // 6i. Get the Gauss point coordinates in the integration space
         const double *gaussPoint = theGaussQuadrature->getGaussPoint(iGP);
 
         // 6ii. Get the Gauss point weight
         gaussWeight = theGaussQuadrature->getGaussWeight(iGP);
 
-        // 6iii. Compute the basis functions describing parametrically the integration domain
-        MathLibrary::computeLowOrderShapeFunc(nNodesQuadrature, gaussPoint, basisFunctions);
+        // 6iii. Get the image of the Gauss point in the NURBS parameter space
+        uv = &allUV[iGP * 2];
 
-        // 6iv. Compute the image of the gauss point in the NURBS parameter space
-        MathLibrary::computeLinearCombination(nNodesQuadrature, 2, nodesUV, basisFunctions, uv);
+        // 6iv. Get the basis functions of the low order Finite Element at the Gauss point
+        basisFunctionsFE = &allBasisFunctionsFE[iGP * numNodesElementFE];
 
-        // 6v. Compute the image of the Gauss point in the low order Finite Element
-        MathLibrary::computeLinearCombination(nNodesQuadrature, 2, nodesWZ, basisFunctions, wz);
-
-        // 6vi. Compute the basis functions of the low order Finite Element
-        MathLibrary::computeLowOrderShapeFunc(numNodesElementFE, wz, basisFunctionsFE);
-
-        // 6vii. Compute the local NURBS basis functions and their first order derivatives
+        // 6v. Compute the local NURBS basis functions and their first order derivatives
         _thePatch->getIGABasis()->computeLocalBasisFunctionsAndDerivatives(localBasisFunctionsAndDerivatives,
                                                                            derivDegree, uv[0], _spanU, uv[1], _spanV);
 
-        // 6viii. Compute the base vectors and their first derivatives
+        // 6vi. Compute the base vectors and their first derivatives
         _thePatch->computeBaseVectorsAndDerivatives(baseVctsAndDerivs, localBasisFunctionsAndDerivatives, derivDegreeBaseVec,_spanU, _spanV);
         for (int iCoord = 0; iCoord < noCoord; iCoord++) {
             indexBaseVctU = _thePatch->indexDerivativeBaseVector(0 , 0, 0, iCoord, 0);
@@ -2407,13 +3126,13 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
             baseVectorV[iCoord] = baseVctsAndDerivs[indexBaseVctV];
         }
 
-        // 6ix. Compute the surface normal vector at the Gauss point
+        // 6vii. Compute the surface normal vector at the Gauss point
         MathLibrary::computeVectorCrossProduct(baseVectorU, baseVectorV, surfaceNormalTilde);
 
-        // 6x. Compute the determinant of the Jacobian of the transformation from the physical space to the NURBS parameter space
-        JacobianUVToPhysical = MathLibrary::vector2norm(surfaceNormalTilde, noCoord);
+        // 6viii. Compute the determinant of the Jacobian of the transformation from the physical space to the NURBS parameter space
+        JacobianUVToPhysical = MathLibrary::vector2norm<noCoord>(surfaceNormalTilde);
 
-        // 6xi. Compute the determinant of the Jacobian of the transformation from the NURBS parameter space to the canonical space
+        // 6ix. Compute the determinant of the Jacobian of the transformation from the NURBS parameter space to the canonical space
         if (nNodesQuadrature == 3) {
             JacobianCanonicalToUV = MathLibrary::computeAreaTriangle( nodesUV[2] - nodesUV[0], nodesUV[3] - nodesUV[1], 0,
                                                                       nodesUV[4] - nodesUV[0], nodesUV[5] - nodesUV[1], 0)*2.0;
@@ -2429,84 +3148,47 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
             JacobianCanonicalToUV = fabs(dudx * dvdy - dudy * dvdx);
         }
 
-        // 6xii. Compute the product of the determinants of the Jacobian matrices
+        // 6x. Compute the product of the determinants of the Jacobian matrices
         JacobianProduct = JacobianUVToPhysical*JacobianCanonicalToUV;
 
-        // 6xiii. Update the integration area at the Gauss point
-        areaIntegration += JacobianProduct*theGaussQuadrature->getGaussWeight(iGP);
-
-        // 6xiv. Loop over all local basis functions in the master side
-        for (int i = 0; i < numNodesElMaster; i++) {
-            // 6xiv.1. Loop over all local basis functions in the master side to compute and assemble the local Cnn matrix to the global one
-            for (int j = i; j < numNodesElMaster; j++) { // Starts from i because of computing only the upper triangular entries of the matrix
-                // 6xiv.1i. Compute the product of the basis functions
-                if (isMappingIGA2FEM)
-                    basisFunctionsProduct = basisFunctionsFE[i] * basisFunctionsFE[j];
-                else {
-                    IGABasisFctsI = localBasisFunctionsAndDerivatives[_thePatch->getIGABasis()->indexDerivativeBasisFunction(1, 0, 0, i)];
-                    IGABasisFctsJ = localBasisFunctionsAndDerivatives[_thePatch->getIGABasis()->indexDerivativeBasisFunction(1, 0, 0, j)];
-                    basisFunctionsProduct = IGABasisFctsI*IGABasisFctsJ;
-                }
-
-                // 6xiv.1ii. Compute the integrand on the Gauss point times the Gauss weight
-                integrand = basisFunctionsProduct*JacobianProduct*theGaussQuadrature->getGaussWeight(iGP);
+        // 6xi. Update the integration area at the Gauss point
+        localAreaIntegration += JacobianProduct*theGaussQuadrature->getGaussWeight(iGP);
 
-                // 6xiv.1iii. Find the DOF numbering of the dual basis functions product
-                if (isMappingIGA2FEM) {
-                    dof1 = meshFEDirectElemTable[_elementIndex][i];
-                    dof2 = meshFEDirectElemTable[_elementIndex][j];
-                } else {
-                    dof1 = dofIGA[i];
-                    dof2 = dofIGA[j];
-                }
+        // 6xii. Store the master and the slave basis functions and the weight of the Gauss point in the batch
+        batchWeights[iGP] = JacobianProduct*theGaussQuadrature->getGaussWeight(iGP);
+        for (int i = 0; i < numBasisFunctionsIGA; i++) {
+            double IGABasisFctsI = localBasisFunctionsAndDerivatives[_thePatch->getIGABasis()->indexDerivativeBasisFunction(1, 0, 0, i)];
+            if (isMappingIGA2FEM)
+                batchBasisSlave[i * numGPs + iGP] = IGABasisFctsI;
+            else
+                batchBasisMaster[i * numGPs + iGP] = IGABasisFctsI;
+        }
+        for (int i = 0; i < numNodesElementFE; i++) {
+            if (isMappingIGA2FEM)
+                batchBasisMaster[i * numGPs + iGP] = basisFunctionsFE[i];
+            else
+                batchBasisSlave[i * numGPs + iGP] = basisFunctionsFE[i];
+        }
 
-                // 6xiv.1iv. Assemble the element contributions to the global Cnn matrix
-                if (!isExpanded){
-                    couplingMatrices->addCNNValue(dof1, dof2, integrand);
-                    if (dof1 != dof2)
-                        couplingMatrices->addCNNValue(dof2, dof1, integrand);
-                } else {
-                    for(int iCoord = 0; iCoord < noCoord; iCoord++){
-                        couplingMatrices->addCNNValue(noCoord*dof1 + iCoord, noCoord*dof2 + iCoord, integrand);
-                        if (dof1 != dof2)
-                            couplingMatrices->addCNNValue(noCoord*dof2 + iCoord, noCoord*dof1 + iCoord, integrand);
-                    }
-                }
+        // 6xiii. Save the gauss point data for the computation of the L2 norm of the error
+        if(propErrorComputation.isDomainError && propErrorComputation.isCompactStorage){
+            CompactStreamGPs &threadGPs = compactStreamGPsPerThread[buffer];
+            threadGPs.values.push_back(theGaussQuadrature->getGaussWeight(iGP)*JacobianProduct);
+            threadGPs.indices.push_back(numNodesElementFE);
+            for (int i = 0; i < numNodesElementFE; i++) {
+                threadGPs.indices.push_back(meshFEConnectivity->getElemNodes(_elementIndex)[i]);
+                threadGPs.values.push_back(basisFunctionsFE[i]);
             }
-
-            // 6xiv.2. Loop over all local basis functions in the slave side to compute and assemble the local Cnr matrix to the global one
-            for (int j = 0; j < numNodesElSlave; j++) {
-                // 6xiv.2i. Compute the integrand on the Gauss point times the Gauss weight
-                if (isMappingIGA2FEM) {
-                    basisFctsMaster = basisFunctionsFE[i];
-                    basisFctsSlave = localBasisFunctionsAndDerivatives[_thePatch->getIGABasis()->indexDerivativeBasisFunction(1, 0, 0, j)];
-                } else {
-                    basisFctsMaster = localBasisFunctionsAndDerivatives[_thePatch->getIGABasis()->indexDerivativeBasisFunction(1, 0, 0, i)];
-                    basisFctsSlave = basisFunctionsFE[j];
-                }
-                integrand = basisFctsMaster*basisFctsSlave*JacobianProduct*theGaussQuadrature->getGaussWeight(iGP);
-
-                // 6xiv.2ii. Find the DOF numbering of the dual basis functions product
-                if (isMappingIGA2FEM) {
-                    dof1 = meshFEDirectElemTable[_elementIndex][i];
-                    dof2 = dofIGA[j];
-                } else {
-                    dof1 = dofIGA[i];
-                    dof2 = meshFEDirectElemTable[_elementIndex][j];
-                }
-
-                // 6xiv.2iii. Assemble the element contributions to the global Cnr matrix
-                if (!isExpanded){
-                    couplingMatrices->addCNRValue(dof1, dof2, integrand);
-                } else {
-                    for(int iCoord = 0; iCoord < noCoord; iCoord++)
-                        couplingMatrices->addCNRValue(noCoord*dof1 + iCoord, noCoord*dof2 + iCoord, integrand);
-                }
+            threadGPs.indices.push_back(numBasisFunctionsIGA);
+            for (int i = 0; i < numBasisFunctionsIGA; i++) {
+                threadGPs.indices.push_back(dofIGA[i]);
+                threadGPs.values.push_back(localBasisFunctionsAndDerivatives[_thePatch->getIGABasis()->indexDerivativeBasisFunction(1, 0, 0, i)]);
             }
-        }
-
-        // 6xv. Save the gauss point data for the computation of the L2 norm of the error
-        if(propErrorComputation.isDomainError){
+            _thePatch->computeCartesianCoordinates(cartesianCoordGP,localBasisFunctionsAndDerivatives,derivDegree,_spanU,_spanV);
+            for (int iCoord = 0; iCoord < noCoord; iCoord++)
+                threadGPs.values.push_back(cartesianCoordGP[iCoord]);
+            threadGPs.numGPs++;
+        } else if(propErrorComputation.isDomainError){
             std::vector<double> streamGP;
             // weight + JacobianProduct + numBasisFuncsFE + (#dof, shapefuncvalue,...) + nShapeFuncsIGA + (#dof, shapefuncvalue,...) + cartesianCoordinatesGP
             streamGP.reserve(1 + 1 + 1 + 2*numNodesElementFE + 1 + 2*numBasisFunctionsIGA);
@@ -2514,7 +3196,7 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
             streamGP.push_back(JacobianProduct);
             streamGP.push_back(numNodesElementFE);
             for (int i = 0; i < numNodesElementFE; i++) {
-                streamGP.push_back(meshFEDirectElemTable[_elementIndex][i]);
+                streamGP.push_back(meshFEConnectivity->getElemNodes(_elementIndex)[i]);
                 streamGP.push_back(basisFunctionsFE[i]);
             }
             streamGP.push_back(numBasisFunctionsIGA);
@@ -2526,7 +3208,69 @@ void IGAMortarMapper::integrate(IGAPatchSurface* _thePatch, int _patchIndex, Pol
             _thePatch->computeCartesianCoordinates(cartesianCoordGP,localBasisFunctionsAndDerivatives,derivDegree,_spanU,_spanV);
             for (int iCoord = 0; iCoord < noCoord; iCoord++)
                 streamGP.push_back(cartesianCoordGP[iCoord]);
-            streamGPs.push_back(streamGP);
+            streamGPsPerThread[buffer].push_back(streamGP);
+        }
+    }
+
+    // 6b. Compute the local Cnn and Cnr matrices from the batch, only the upper triangular part of Cnn is computed
+    MathLibrary::accumulateWeightedProducts(numGPs, numNodesElMaster, numNodesElMaster, batchBasisMaster,
+                                            batchBasisMaster, batchWeights, true, localCnn);
+    MathLibrary::accumulateWeightedProducts(numGPs, numNodesElMaster, numNodesElSlave, batchBasisMaster,
+                                            batchBasisSlave, batchWeights, false, localCnr);
+
+    // 7. Update the integration area
+#pragma omp atomic
+    areaIntegration += localAreaIntegration;
+    if (!elementContributions.empty())
+        elementContributions[_elementIndex].area += localAreaIntegration;
+
+    // 8. Assemble the local matrices into the buffers of the element
+    for (int i = 0; i < numNodesElMaster; i++) {
+        // 8i. Assemble the local Cnn matrix, only its upper triangular part has been computed
+        for (int j = i; j < numNodesElMaster; j++) {
+            // 8i.1. Find the DOF numbering of the dual basis functions product
+            if (isMappingIGA2FEM) {
+                dof1 = meshFEConnectivity->getElemNodes(_elementIndex)[i];
+                dof2 = meshFEConnectivity->getElemNodes(_elementIndex)[j];
+            } else {
+                dof1 = dofIGA[i];
+                dof2 = dofIGA[j];
+            }
+            integrand = localCnn[i * numNodesElMaster + j];
+
+            // 8i.2. Assemble the element contributions to the global Cnn matrix
+            if (!isExpanded){
+                couplingMatrices->addCNNValueToBuffer(buffer, dof1, dof2, integrand);
+                if (dof1 != dof2)
+                    couplingMatrices->addCNNValueToBuffer(buffer, dof2, dof1, integrand);
+            } else {
+                for(int iCoord = 0; iCoord < noCoord; iCoord++){
+                    couplingMatrices->addCNNValueToBuffer(buffer, noCoord*dof1 + iCoord, noCoord*dof2 + iCoord, integrand);
+                    if (dof1 != dof2)
+                        couplingMatrices->addCNNValueToBuffer(buffer, noCoord*dof2 + iCoord, noCoord*dof1 + iCoord, integrand);
+                }
+            }
+        }
+
+        // 8ii. Assemble the local Cnr matrix
+        for (int j = 0; j < numNodesElSlave; j++) {
+            // 8ii.1. Find the DOF numbering of the dual basis functions product
+            if (isMappingIGA2FEM) {
+                dof1 = meshFEConnectivity->getElemNodes(_elementIndex)[i];
+                dof2 = dofIGA[j];
+            } else {
+                dof1 = dofIGA[i];
+                dof2 = meshFEConnectivity->getElemNodes(_elementIndex)[j];
+            }
+            integrand = localCnr[i * numNodesElSlave + j];
+
+            // 8ii.2. Assemble the element contributions to the global Cnr matrix
+            if (!isExpanded){
+                couplingMatrices->addCNRValueToBuffer(buffer, dof1, dof2, integrand);
+            } else {
+                for(int iCoord = 0; iCoord < noCoord; iCoord++)
+                    couplingMatrices->addCNRValueToBuffer(buffer, noCoord*dof1 + iCoord, noCoord*dof2 + iCoord, integrand);
+            }
         }
     }
 }
@@ -2600,44 +3344,33 @@ int IGAMortarMapper::getNeighbourElementofEdge(int _element, int _node1, int _no
      *
      * 1. Initialize auxilary variables
      *
-     * 2. Loop over all the elements in the Finite Element mesh
+     * 2. Loop over all the elements containing the first vertex (in ascending order)
      * ->
-     *    2i. Initialize the flags to false
-     *   2ii. Loop over all nodes of the element
-     *   ->
-     *        2ii.1. Check if first vertex is found in the given element
-     *        2ii.2. Check if first vertex is found in the given element
-     *        2ii.3. If both vertices are found return the index of the element
-     *   <-
+     *    2i. Loop over all nodes of the element
+     *    ->
+     *        2i.1. If the second vertex is found return the index of the element
+     *    <-
      * <-
      *
      * 3. If polygon is on boundary of mesh, can occur
      */
 
     // 1. Initialize auxilary variables
-    bool isNode1;
-    bool isNode2;
-
-    // 2. Loop over all the elements in the Finite Element mesh
-    for(int i = 0; i < meshFE->numElems; i++) {
-        // 2i. Initialize the flags to false
-        isNode1 = false;
-        isNode2 = false;
-
-        // 2ii. Loop over all nodes of the element
-        for(int j = 0; j < meshFE->numNodesPerElem[i]; j++) {
-            // 2ii.1. Check if first vertex is found in the given element
-            if (isNode1 == false)
-                isNode1 = (meshFEDirectElemTable[i][j] == _node1)?true:false;
-
-            // 2ii.2. Check if first vertex is found in the given element
-            if (isNode2 == false)
-                isNode2 = (meshFEDirectElemTable[i][j] == _node2)?true:false;
-
-            // 2ii.3. If both vertices are found return the index of the element
-            if(_element != i && isNode1 && isNode2) {
-                return i;
-            }
+    const int *elemsOfNode1 = meshFEConnectivity->getNodeElems(_node1);
+    const int numElemsOfNode1 = meshFEConnectivity->getNumElemsOfNode(_node1);
+
+    // 2. Loop over all the elements containing the first vertex (in ascending order)
+    for(int i = 0; i < numElemsOfNode1; i++) {
+        int elem = elemsOfNode1[i];
+        if (elem == _element)
+            continue;
+
+        // 2i. Loop over all nodes of the element
+        const int *elemNodes = meshFEConnectivity->getElemNodes(elem);
+        for(int j = 0; j < meshFE->numNodesPerElem[elem]; j++) {
+            // 2i.1. If the second vertex is found return the index of the element
+            if (elemNodes[j] == _node2)
+                return elem;
         }
     }
 
@@ -2645,6 +3378,146 @@ int IGAMortarMapper::getNeighbourElementofEdge(int _element, int _node1, int _no
     return -1;
 }
 
+/***********************************************************************************************
+ * \brief Get the least degree k <= _degree such that _ratio^(k+1) <= _tolerance, that is the degree
+ *        beyond which the terms of a polynomial of degree _degree contribute less than the tolerance
+ *        over a domain of relative size _ratio
+ ***********/
+static int getTruncatedDegree(int _degree, double _ratio, double _tolerance) {
+    int degree = 0;
+    double term = _ratio;
+    while (degree < _degree && term > _tolerance) {
+        term *= _ratio;
+        degree++;
+    }
+    return degree;
+}
+
+/***********************************************************************************************
+ * \brief Get the number of Gauss points of the adaptive rule on a triangle or on a quadrilateral.
+ *        The polynomial orders of the integrands are found as in createGaussQuadratureRules().
+ *        Returns -1 if no rule of the registry integrates the order.
+ ***********/
+static int getAdaptiveNumGaussPoints(int _numNodes, bool _isMappingIGA2FEM, int _pDegree, int _qDegree, int _geometryDegree) {
+    const int numGPsPerPolOrder[8] = {1, 3, 4, 6, 7, 12, 13, 16};
+    if (_numNodes == 3) {
+        int polOrder;
+        if (_isMappingIGA2FEM) // Integrands N_i*N_i and N_i*R_i
+            polOrder = std::max(2, 1 + _pDegree + _qDegree);
+        else // Integrands R_i*R_i and R_i*N_i
+            polOrder = std::max(1 + _pDegree + _qDegree, 2 * (_pDegree + _qDegree));
+        polOrder += _geometryDegree;
+        if (polOrder > 8)
+            return -1;
+        return numGPsPerPolOrder[std::max(polOrder, 1) - 1];
+    } else {
+        int maxDegree = std::max(_pDegree, _qDegree);
+        int pTilde;
+        if (_isMappingIGA2FEM)
+            pTilde = std::max(2, maxDegree + 2);
+        else
+            pTilde = std::max(maxDegree + 2, 2 * maxDegree);
+        pTilde += _geometryDegree;
+        int numGPsPerDirection = (int) std::ceil((pTilde + 1) / 2.0);
+        if (numGPsPerDirection > 10)
+            return -1;
+        return numGPsPerDirection * numGPsPerDirection;
+    }
+}
+
+const EMPIRE::MathLibrary::IGAGaussQuadrature* IGAMortarMapper::getAdaptiveGaussQuadrature(IGAPatchSurface* _thePatch, int _patchIndex,
+                                                                                           const Polygon2D& _polygonUV, int _spanU, int _spanV, int _elementIndex) {
+    /*
+     * Finds the Gauss rule of least points for the integration subdomain
+     *
+     * Function layout:
+     *
+     * 1. Get the rule of the patch
+     *
+     * 2. Compute the size of the subdomain relative to the knot span
+     *
+     * 3. Find the degrees of the NURBS basis which contribute above the tolerance
+     *
+     * 4. Return the rule of the patch if the reduced rule without the geometry is not smaller
+     *
+     * 5. Compute the largest angle between the surface normals at the vertices of the subdomain
+     *
+     * 6. Find the degree added by the curvature of the surface and get the reduced rule
+     */
+
+    // 1. Get the rule of the patch
+    int numNodes = _polygonUV.size();
+    const EMPIRE::MathLibrary::IGAGaussQuadrature* thePatchGaussQuadrature =
+            (numNodes == 3) ? gaussRuleOnTriangle[_patchIndex] : gaussRuleOnQuadrilateral[_patchIndex];
+    double tolerance = propIntegration.tolAdaptive;
+
+    // 2. Compute the size of the subdomain relative to the knot span
+    double uMin = _polygonUV[0].first, uMax = _polygonUV[0].first;
+    double vMin = _polygonUV[0].second, vMax = _polygonUV[0].second;
+    for (int i = 1; i < numNodes; i++) {
+        uMin = std::min(uMin, _polygonUV[i].first);
+        uMax = std::max(uMax, _polygonUV[i].first);
+        vMin = std::min(vMin, _polygonUV[i].second);
+        vMax = std::max(vMax, _polygonUV[i].second);
+    }
+    const double *knotVectorU = _thePatch->getIGABasis()->getUBSplineBasis1D()->getKnotVector();
+    const double *knotVectorV = _thePatch->getIGABasis()->getVBSplineBasis1D()->getKnotVector();
+    double ratioU = (uMax - uMin) / (knotVectorU[_spanU + 1] - knotVectorU[_spanU]);
+    double ratioV = (vMax - vMin) / (knotVectorV[_spanV + 1] - knotVectorV[_spanV]);
+
+    // 3. Find the degrees of the NURBS basis which contribute above the tolerance
+    int pDegree = _thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
+    int qDegree = _thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
+    int pEffective = getTruncatedDegree(pDegree, ratioU, tolerance);
+    int qEffective = getTruncatedDegree(qDegree, ratioV, tolerance);
+
+    // 4. Return the rule of the patch if the reduced rule without the geometry is not smaller
+    int numGPs = getAdaptiveNumGaussPoints(numNodes, isMappingIGA2FEM, pEffective, qEffective, 0);
+    if (numGPs < 0 || numGPs >= thePatchGaussQuadrature->getNumGaussPoints())
+        return thePatchGaussQuadrature;
+
+    // 5. Compute the largest angle between the surface normals at the vertices of the subdomain
+    const int noCoord = 3;
+    int derivDegree = 1;
+    int derivDegreeBaseVec = 0;
+    int noBaseVec = 2;
+    int numBasisFunctionsIGA = (pDegree + 1) * (qDegree + 1);
+    double localBasisFunctionsAndDerivatives[(derivDegree + 1) * (derivDegree + 2) * numBasisFunctionsIGA / 2];
+    double baseVctsAndDerivs[(derivDegreeBaseVec + 1) * (derivDegreeBaseVec + 2) * noCoord * noBaseVec / 2];
+    double baseVectorU[3];
+    double baseVectorV[3];
+    double normals[4][3];
+    for (int i = 0; i < numNodes; i++) {
+        _thePatch->getIGABasis()->computeLocalBasisFunctionsAndDerivatives(localBasisFunctionsAndDerivatives, derivDegree,
+                                                                           _polygonUV[i].first, _spanU, _polygonUV[i].second, _spanV);
+        _thePatch->computeBaseVectorsAndDerivatives(baseVctsAndDerivs, localBasisFunctionsAndDerivatives, derivDegreeBaseVec, _spanU, _spanV);
+        for (int iCoord = 0; iCoord < noCoord; iCoord++) {
+            baseVectorU[iCoord] = baseVctsAndDerivs[_thePatch->indexDerivativeBaseVector(0, 0, 0, iCoord, 0)];
+            baseVectorV[iCoord] = baseVctsAndDerivs[_thePatch->indexDerivativeBaseVector(0, 0, 0, iCoord, 1)];
+        }
+        MathLibrary::computeVectorCrossProduct(baseVectorU, baseVectorV, normals[i]);
+        double normNormal = MathLibrary::vector2norm<noCoord>(normals[i]);
+        for (int iCoord = 0; iCoord < noCoord; iCoord++)
+            normals[i][iCoord] /= normNormal;
+    }
+    double maxAngle = 0.0;
+    for (int i = 1; i < numNodes; i++) {
+        double cosAngle = MathLibrary::computeDenseDotProduct<noCoord>(normals[0], normals[i]);
+        maxAngle = std::max(maxAngle, acos(std::min(1.0, std::max(-1.0, cosAngle))));
+    }
+
+    // 6. Find the degree added by the curvature of the surface and get the reduced rule
+    // The area element varies at most quadratically with the angle over the subdomain
+    int geometryDegree = getTruncatedDegree(2, maxAngle, tolerance);
+    numGPs = getAdaptiveNumGaussPoints(numNodes, isMappingIGA2FEM, pEffective, qEffective, geometryDegree);
+    if (numGPs < 0 || numGPs >= thePatchGaussQuadrature->getNumGaussPoints())
+        return thePatchGaussQuadrature;
+    if (numNodes == 3)
+        return MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_TRIANGLE, numGPs);
+    else
+        return MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_BIUNIT_QUADRILATERAL, numGPs);
+}
+
 void IGAMortarMapper::createGaussQuadratureRules() {
     /*
      * Creates a Gauss quadrature rule for quadrilaterals and for triangles at each patch
@@ -2729,9 +3602,9 @@ void IGAMortarMapper::createGaussQuadratureRules() {
 
         // 4iv. Instantiate the corresponding Gauss quadrature on triangle
         if ((propIntegration.isAutomaticNoGPTriangle && polOrder <= 8) || !propIntegration.isAutomaticNoGPTriangle && numGPs <= 16) // Use the Gauss quadrature over the triangle with the symmetric rule
-            gaussRuleOnTriangle[iPatches] = new MathLibrary::IGAGaussQuadratureOnTriangle(numGPs);
+            gaussRuleOnTriangle[iPatches] = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_TRIANGLE, numGPs);
         else if ((propIntegration.isAutomaticNoGPTriangle && polOrder > 8) || !propIntegration.isAutomaticNoGPTriangle && numGPs > 16) // Use the Gauss quadrature over the triangle with the degenerated quadrilateral
-            gaussRuleOnTriangle[iPatches] = new MathLibrary::IGAGaussQuadratureOnTriangleUsingDegeneratedQuadrilateral(numGPs);
+            gaussRuleOnTriangle[iPatches] = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_TRIANGLE_DEGENERATED_QUADRILATERAL, numGPs);
         else
             ERROR_BLOCK_OUT("createGaussQuadratureRules","IGAMortarMapper","Found corner case not encountered before related to the integration over a triangle!");
 
@@ -2759,7 +3632,7 @@ void IGAMortarMapper::createGaussQuadratureRules() {
             ERROR_BLOCK_OUT("createGaussQuadratureRules","IGAMortarMapper","Found corner case not encountered before related to the integration over a quadrilateral!");
 
         // 4vii. Instantiate the corresponding Gauss quadrature on quadrilateral
-        gaussRuleOnQuadrilateral[iPatches] = new MathLibrary::IGAGaussQuadratureOnBiunitQuadrilateral(numGPs);
+        gaussRuleOnQuadrilateral[iPatches] = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_BIUNIT_QUADRILATERAL, numGPs);
     }
 }
 
@@ -2769,253 +3642,282 @@ void IGAMortarMapper::computeIGAWeakDirichletCurveConditionMatrices() {
      *
      * Function layout:
      *
-     * 1. Initialize auxiliary variables
+     * 1. Get the weak Dirichlet curve conditions
      *
-     * 2. Get the weak Dirichlet curve conditions
+     * 2. Allocate the triplet buffers of the threads and the Gauss point streams of the conditions
      *
-     * 3. Loop over all the conditions for the application of weak Dirichlet conditions
+     * 3. Initialize the auxiliary variables and the arrays of every thread
+     *
+     * 4. Loop over all the conditions for the application of weak Dirichlet conditions in parallel
      * ->
-     *    3i. Get the penalty factors for the primary and the secondary field
-     *   3ii. Get the index of the patch
-     *  3iii. Get the number of Gauss Points for the given condition
-     *   3iv. Get the parametric coordinates of the Gauss Points
-     *    3v. Get the corresponding Gauss weights
-     *   3vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
-     *  3vii. Get the product of the Jacobian transformations
-     * 3viii. Get the patch
-     *   3ix. Get the polynomial orders of the master and the slave patch
-     *    3x. get the number of local basis functions
-     *   3xi. get the number of the local DOFs for the patch
-     *  3xii. Initialize pointers
-     * 3xiii. Loop over all the Gauss Points of the given condition
+     *    4i. Get the penalty factors for the primary and the secondary field
+     *   4ii. Get the index of the patch
+     *  4iii. Get the number of Gauss Points for the given condition
+     *   4iv. Get the parametric coordinates of the Gauss Points
+     *    4v. Get the corresponding Gauss weights
+     *   4vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
+     *  4vii. Get the product of the Jacobian transformations
+     * 4viii. Get the patch
+     *   4ix. Get the polynomial orders of the master and the slave patch
+     *    4x. get the number of local basis functions
+     *   4xi. get the number of the local DOFs for the patch
+     *  4xii. Get the arrays of the thread, they grow to the largest condition
+     * 4xiii. Loop over all the Gauss Points of the given condition
      * ->
-     *        3xiii.1. Get the parametric coordinates of the Gauss Point on the patch
-     *        3xiii.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
-     *        3xiii.3. Get the tangent to the boundary vector on the patch
-     *        3xiii.4. compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
-     *        3xiii.5. Compute the B-operator matrices needed for the computation of the patch weak Dirichlet conditions at the patch
-     *        3xiii.6. Compute the local penalty factor for scaling the rotational contributions
-     *        3xiii.7. Scale the B-operator matrices
-     *        3xiii.8. Compute the dual product matrices for the displacements
-     *        3xiii.9. Compute the dual product matrices for the bending rotations
-     *       3xiii.10. Compute the dual product matrices for the twisting rotations
-     *       3xiii.11. Compute the element index tables for the patch
-     *       3xiii.12. Compute the element freedom tables for the patch
-     *       3xiii.13. Loop over all DOFs to assemble the contributions of the weak Dirichlet conditions into the Cnn
+     *        4xiii.1. Get the parametric coordinates of the Gauss Point on the patch
+     *        4xiii.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
+     *        4xiii.3. Get the tangent to the boundary vector on the patch
+     *        4xiii.4. compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
+     *        4xiii.5. Compute the B-operator matrices needed for the computation of the patch weak Dirichlet conditions at the patch
+     *        4xiii.6. Compute the local penalty factor for scaling the rotational contributions
+     *        4xiii.7. Scale the B-operator matrices
+     *        4xiii.8. Compute the dual product matrices for the displacements
+     *        4xiii.9. Compute the dual product matrices for the bending rotations
+     *       4xiii.10. Compute the dual product matrices for the twisting rotations
+     *       4xiii.11. Compute the element index tables for the patch
+     *       4xiii.12. Compute the element freedom tables for the patch
+     *       4xiii.13. Loop over all DOFs to assemble the contributions of the weak Dirichlet conditions into the Cnn
      *       ->
-     *                 3xiii.13i. Assemble the displacement coupling entries
-     *                3xiii.13ii. Assemble the bending rotation coupling entries
-     *               3xiii.13iii. Assemble the twisting rotation coupling entries
+     *                 4xiii.13i. Assemble the displacement coupling entries
+     *                4xiii.13ii. Assemble the bending rotation coupling entries
+     *               4xiii.13iii. Assemble the twisting rotation coupling entries
      *       <-
-     *       3xiii.14. Store the Gauss point values necessary for the error computation
+     *       4xiii.14. Store the Gauss point values necessary for the error computation
      * <-
-     *  3xiv. Delete pointers
      * <-
+     *
+     * 5. Merge the contributions of all threads and append the Gauss point streams in the order of the conditions
      */
 
-    // 1. Initialize auxiliary variables
-    const int noCoordParam = 2;
-    const int noCoord = 3;
-    int patchIndex;
-    int counter;
-    int p;
-    int q;
-    int noLocalBasisFcts;
-    int noDOFsLoc;
-    int noGPsOnCond;
-    int uKnotSpan;
-    int vKnotSpan;
-    int indexCP;
-    double uGP;
-    double vGP;
-    double tangentCurveVct[noCoord];
-    double normalCurveVct[noCoord];
-    double normBOperatorOmegaT;
-    double normBOperatorOmegaN;
-    double surfaceNormalVct[noCoord];
-    double alphaLocal;
-    double alphaPrimary;
-    double alphaSecondaryBending;
-    double alphaSecondaryTwisting;
-    double elementLengthOnGP;
-    double* curveGPs;
-    double* curveGPWeights;
-    double* curveGPTangents;
-    double* curveGPJacobianProducts;
-    IGAPatchSurface* thePatch;
-
-    // 2. Get the weak Dirichlet curve conditions
+    // 1. Get the weak Dirichlet curve conditions
     std::vector<WeakIGADirichletCurveCondition*> weakIGADirichletCurveConditions = meshIGA->getWeakIGADirichletCurveConditions();
 
-    // 3. Loop over all the conditions for the application of weak Dirichlet conditions
-    for (int iDCC = 0; iDCC < weakIGADirichletCurveConditions.size(); iDCC++){
-        // 3i. Get the penalty factors for the primary and the secondary field
-        alphaPrimary = weakDirichletCCAlphaPrimary[iDCC];
-        alphaSecondaryBending = weakDirichletCCAlphaSecondaryBending[iDCC];
-        alphaSecondaryTwisting = weakDirichletCCAlphaSecondaryTwisting[iDCC];
-
-        // 3ii. Get the index of the patch
-        patchIndex = weakIGADirichletCurveConditions[iDCC]->getPatchIndex();
+    // 2. Allocate the triplet buffers of the threads and the Gauss point streams of the conditions
+    couplingMatrices->initBuffers(mapperSetNumThreads, weakIGADirichletCurveConditions.size());
+    std::vector<std::vector<std::vector<double> > > streamCurveGPsOfConditions(weakIGADirichletCurveConditions.size());
 
-        // 3iii. Get the number of Gauss Points for the given condition
-        noGPsOnCond = weakIGADirichletCurveConditions[iDCC]->getCurveNumGP();
-
-        // 3iv. Get the parametric coordinates of the Gauss Points
-        curveGPs = weakIGADirichletCurveConditions[iDCC]->getCurveGPs();
-
-        // 3v. Get the corresponding Gauss weights
-        curveGPWeights = weakIGADirichletCurveConditions[iDCC]->getCurveGPWeights();
-
-        // 3vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
-        curveGPTangents = weakIGADirichletCurveConditions[iDCC]->getCurveGPTangents();
-
-        // 3vii. Get the product of the Jacobian transformations
-        curveGPJacobianProducts = weakIGADirichletCurveConditions[iDCC]->getCurveGPJacobianProducts();
-
-        // 3viii. Get the patch
-        thePatch = meshIGA->getSurfacePatch(patchIndex);
-
-        // 3ix. Get the polynomial orders of the master and the slave patch
-        p = thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
-        q = thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
-
-        // 3x. get the number of local basis functions
-        noLocalBasisFcts = (p + 1)*(q + 1);
-
-        // 3xi. get the number of the local DOFs for the patch
-        noDOFsLoc = noCoord*noLocalBasisFcts;
-
-        // 3xii. Initialize pointers
-        double* BDisplacementsGC = new double[noCoord*noDOFsLoc];
-        double* BOperatorOmegaT = new double[noDOFsLoc];
-        double* BOperatorOmegaN = new double[noDOFsLoc];
-        double* KPenaltyDisplacement = new double[noDOFsLoc*noDOFsLoc];
-        double* KPenaltyBendingRotation = new double[noDOFsLoc*noDOFsLoc];
-        double* KPenaltyTwistingRotation = new double[noDOFsLoc*noDOFsLoc];
-
-        // 3xiii. Loop over all the Gauss Points of the given condition
-        for(int iGP = 0; iGP < noGPsOnCond; iGP++){
-            // 3xiii.1. Get the parametric coordinates of the Gauss Point on the patch
-            uGP = curveGPs[iGP*noCoordParam];
-            vGP = curveGPs[iGP*noCoordParam + 1];
-
-            // 3xiii.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
-            uKnotSpan = thePatch->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGP);
-            vKnotSpan = thePatch->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGP);
+    BuildProgress progress("IGAMortarMapper: weak Dirichlet curve conditions", "conditions", weakIGADirichletCurveConditions.size());
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        // 3. Initialize the auxiliary variables and the arrays of the thread
+        const int noCoordParam = 2;
+        const int noCoord = 3;
+        int patchIndex;
+        int counter;
+        int p;
+        int q;
+        int noLocalBasisFcts;
+        int noDOFsLoc;
+        int noGPsOnCond;
+        int uKnotSpan;
+        int vKnotSpan;
+        int indexCP;
+        double uGP;
+        double vGP;
+        double tangentCurveVct[noCoord];
+        double normalCurveVct[noCoord];
+        double normBOperatorOmegaT;
+        double normBOperatorOmegaN;
+        double surfaceNormalVct[noCoord];
+        double alphaLocal;
+        double alphaPrimary;
+        double alphaSecondaryBending;
+        double alphaSecondaryTwisting;
+        double elementLengthOnGP;
+        double* curveGPs;
+        double* curveGPWeights;
+        double* curveGPTangents;
+        double* curveGPJacobianProducts;
+        IGAPatchSurface* thePatch;
+
+        std::vector<double> BDisplacementsGCArray;
+        std::vector<double> BOperatorOmegaTArray;
+        std::vector<double> BOperatorOmegaNArray;
+        std::vector<double> KPenaltyDisplacementArray;
+        std::vector<double> KPenaltyBendingRotationArray;
+        std::vector<double> KPenaltyTwistingRotationArray;
+
+        // 4. Loop over all the conditions for the application of weak Dirichlet conditions
+#pragma omp for schedule(dynamic, 1)
+        for (int iDCC = 0; iDCC < weakIGADirichletCurveConditions.size(); iDCC++){
+            // The buffer of the condition, see MathLibrary::getAssemblyBuffer
+            const int buffer = MathLibrary::getAssemblyBuffer(iDCC);
+
+            // 4i. Get the penalty factors for the primary and the secondary field
+            alphaPrimary = weakDirichletCCAlphaPrimary[iDCC];
+            alphaSecondaryBending = weakDirichletCCAlphaSecondaryBending[iDCC];
+            alphaSecondaryTwisting = weakDirichletCCAlphaSecondaryTwisting[iDCC];
+
+            // 4ii. Get the index of the patch
+            patchIndex = weakIGADirichletCurveConditions[iDCC]->getPatchIndex();
+
+            // 4iii. Get the number of Gauss Points for the given condition
+            noGPsOnCond = weakIGADirichletCurveConditions[iDCC]->getCurveNumGP();
+
+            // 4iv. Get the parametric coordinates of the Gauss Points
+            curveGPs = weakIGADirichletCurveConditions[iDCC]->getCurveGPs();
+
+            // 4v. Get the corresponding Gauss weights
+            curveGPWeights = weakIGADirichletCurveConditions[iDCC]->getCurveGPWeights();
+
+            // 4vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
+            curveGPTangents = weakIGADirichletCurveConditions[iDCC]->getCurveGPTangents();
+
+            // 4vii. Get the product of the Jacobian transformations
+            curveGPJacobianProducts = weakIGADirichletCurveConditions[iDCC]->getCurveGPJacobianProducts();
+
+            // 4viii. Get the patch
+            thePatch = meshIGA->getSurfacePatch(patchIndex);
+
+            // 4ix. Get the polynomial orders of the master and the slave patch
+            p = thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
+            q = thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
+
+            // 4x. get the number of local basis functions
+            noLocalBasisFcts = (p + 1)*(q + 1);
+
+            // 4xi. get the number of the local DOFs for the patch
+            noDOFsLoc = noCoord*noLocalBasisFcts;
+
+            // 4xii. Get the arrays of the thread, they grow to the largest condition
+            BDisplacementsGCArray.resize(noCoord*noDOFsLoc);
+            double* BDisplacementsGC = &BDisplacementsGCArray[0];
+            BOperatorOmegaTArray.resize(noDOFsLoc);
+            double* BOperatorOmegaT = &BOperatorOmegaTArray[0];
+            BOperatorOmegaNArray.resize(noDOFsLoc);
+            double* BOperatorOmegaN = &BOperatorOmegaNArray[0];
+            KPenaltyDisplacementArray.resize(noDOFsLoc*noDOFsLoc);
+            double* KPenaltyDisplacement = &KPenaltyDisplacementArray[0];
+            KPenaltyBendingRotationArray.resize(noDOFsLoc*noDOFsLoc);
+            double* KPenaltyBendingRotation = &KPenaltyBendingRotationArray[0];
+            KPenaltyTwistingRotationArray.resize(noDOFsLoc*noDOFsLoc);
+            double* KPenaltyTwistingRotation = &KPenaltyTwistingRotationArray[0];
+
+            // 4xiii. Loop over all the Gauss Points of the given condition
+            for(int iGP = 0; iGP < noGPsOnCond; iGP++){
+                // 4xiii.1. Get the parametric coordinates of the Gauss Point on the patch
+                uGP = curveGPs[iGP*noCoordParam];
+                vGP = curveGPs[iGP*noCoordParam + 1];
+
+                // 4xiii.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
+                uKnotSpan = thePatch->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGP);
+                vKnotSpan = thePatch->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGP);
+
+                // 4xiii.3. Get the tangent to the boundary vector on the patch
+                for(int iCoord = 0; iCoord < noCoord; iCoord++)
+                    tangentCurveVct[iCoord] = curveGPTangents[iGP*noCoord + iCoord];
+
+                // 4xiii.4. compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
+                elementLengthOnGP = curveGPJacobianProducts[iGP];
+
+                // 4xiii.5. Compute the B-operator matrices needed for the computation of the patch weak Dirichlet conditions at the patch
+                computeDisplacementAndRotationBOperatorMatrices(BDisplacementsGC, BOperatorOmegaT, BOperatorOmegaN, normalCurveVct,
+                                                                surfaceNormalVct, thePatch, tangentCurveVct, uGP, vGP, uKnotSpan, vKnotSpan);
+
+                // 4xiii.6. Compute the local penalty factor for scaling the rotational contributions
+                if (propWeakCurveDirichletConditions.isSecBendingPrescribed) {
+                    normBOperatorOmegaT = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaT, noDOFsLoc);
+                    alphaLocal = normBOperatorOmegaT;
+                } else
+                    alphaLocal = - 1.0;
 
-            // 3xiii.3. Get the tangent to the boundary vector on the patch
-            for(int iCoord = 0; iCoord < noCoord; iCoord++)
-                tangentCurveVct[iCoord] = curveGPTangents[iGP*noCoord + iCoord];
-
-            // 3xiii.4. compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
-            elementLengthOnGP = curveGPJacobianProducts[iGP];
-
-            // 3xiii.5. Compute the B-operator matrices needed for the computation of the patch weak Dirichlet conditions at the patch
-            computeDisplacementAndRotationBOperatorMatrices(BDisplacementsGC, BOperatorOmegaT, BOperatorOmegaN, normalCurveVct,
-                                                            surfaceNormalVct, thePatch, tangentCurveVct, uGP, vGP, uKnotSpan, vKnotSpan);
-
-            // 3xiii.6. Compute the local penalty factor for scaling the rotational contributions
-            if (propWeakCurveDirichletConditions.isSecBendingPrescribed) {
-                normBOperatorOmegaT = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaT, noDOFsLoc);
-                alphaLocal = normBOperatorOmegaT;
-            } else
-                alphaLocal = - 1.0;
-
-            if (propWeakCurveDirichletConditions.isSecTwistingPrescribed) {
-                normBOperatorOmegaN = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaN, noDOFsLoc);
-                if (normBOperatorOmegaN > alphaLocal)
-                    alphaLocal = normBOperatorOmegaN;
-            }
-            alphaLocal = 1.0/abs(alphaLocal);
+                if (propWeakCurveDirichletConditions.isSecTwistingPrescribed) {
+                    normBOperatorOmegaN = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaN, noDOFsLoc);
+                    if (normBOperatorOmegaN > alphaLocal)
+                        alphaLocal = normBOperatorOmegaN;
+                }
+                alphaLocal = 1.0/abs(alphaLocal);
 
-            // 3xiii.7. Scale the B-operator matrices
-            EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaT, alphaLocal, noDOFsLoc);
-            EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaN, alphaLocal, noDOFsLoc);
+                // 4xiii.7. Scale the B-operator matrices
+                EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaT, alphaLocal, noDOFsLoc);
+                EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaN, alphaLocal, noDOFsLoc);
 
-            // 3xiii.6. Compute the dual product matrices for the displacements
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLoc,noDOFsLoc,BDisplacementsGC,BDisplacementsGC,KPenaltyDisplacement);
+                // 4xiii.6. Compute the dual product matrices for the displacements
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLoc,noDOFsLoc,BDisplacementsGC,BDisplacementsGC,KPenaltyDisplacement);
 
-            // 3xiii.7. Compute the dual product matrices for the bending rotations
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLoc, noDOFsLoc, BOperatorOmegaT, BOperatorOmegaT, KPenaltyBendingRotation);
+                // 4xiii.7. Compute the dual product matrices for the bending rotations
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLoc, noDOFsLoc, BOperatorOmegaT, BOperatorOmegaT, KPenaltyBendingRotation);
 
-            // 3xiii.8. Compute the dual product matrices for the twisting rotations
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLoc, noDOFsLoc, BOperatorOmegaN, BOperatorOmegaN, KPenaltyTwistingRotation);
+                // 4xiii.8. Compute the dual product matrices for the twisting rotations
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLoc, noDOFsLoc, BOperatorOmegaN, BOperatorOmegaN, KPenaltyTwistingRotation);
 
-            // 3xiii.9. Compute the element index tables for the patch
-            int CPIndex[noLocalBasisFcts];
-            thePatch->getIGABasis()->getBasisFunctionsIndex(uKnotSpan, vKnotSpan, CPIndex);
+                // 4xiii.9. Compute the element index tables for the patch
+                int CPIndex[noLocalBasisFcts];
+                thePatch->getIGABasis()->getBasisFunctionsIndex(uKnotSpan, vKnotSpan, CPIndex);
 
-            // 3xiii.10. Compute the element freedom tables for the patch
-            int EFT[noDOFsLoc];
-            counter = 0;
-            for (int i = 0; i < noLocalBasisFcts; i++){
-                indexCP = thePatch->getControlPointNet()[CPIndex[i]]->getDofIndex();
-                for (int j = 0; j < noCoord; j++){
-                    EFT[counter] = noCoord*indexCP + j;
-                    counter++;
+                // 4xiii.10. Compute the element freedom tables for the patch
+                int EFT[noDOFsLoc];
+                counter = 0;
+                for (int i = 0; i < noLocalBasisFcts; i++){
+                    indexCP = thePatch->getControlPointNet()[CPIndex[i]]->getDofIndex();
+                    for (int j = 0; j < noCoord; j++){
+                        EFT[counter] = noCoord*indexCP + j;
+                        counter++;
+                    }
                 }
-            }
 
-            // 3xiii.11. Loop over all DOFs to assemble the contributions of the weak Dirichlet conditions into the Cnn
-            for(int i = 0; i < noDOFsLoc; i++){
-                for(int j = 0; j < noDOFsLoc; j++){
-                    // 3xiii.11i. Assemble the displacement coupling entries
-                    if (propWeakCurveDirichletConditions.isPrimPrescribed)
-                        couplingMatrices->addCNNValue(EFT[i], EFT[i], alphaPrimary*KPenaltyDisplacement[i*noDOFsLoc + i]*elementLengthOnGP);
+                // 4xiii.11. Loop over all DOFs to assemble the contributions of the weak Dirichlet conditions into the Cnn
+                for(int i = 0; i < noDOFsLoc; i++){
+                    for(int j = 0; j < noDOFsLoc; j++){
+                        // 4xiii.11i. Assemble the displacement coupling entries
+                        if (propWeakCurveDirichletConditions.isPrimPrescribed)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFT[i], EFT[i], alphaPrimary*KPenaltyDisplacement[i*noDOFsLoc + i]*elementLengthOnGP);
 
-                    // 3xiii.11ii. Assemble the bending rotation coupling entries
-                    if (propWeakCurveDirichletConditions.isSecBendingPrescribed)
-                        couplingMatrices->addCNNValue(EFT[i], EFT[j], alphaSecondaryBending*KPenaltyBendingRotation[i*noDOFsLoc + j]*elementLengthOnGP);
+                        // 4xiii.11ii. Assemble the bending rotation coupling entries
+                        if (propWeakCurveDirichletConditions.isSecBendingPrescribed)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFT[i], EFT[j], alphaSecondaryBending*KPenaltyBendingRotation[i*noDOFsLoc + j]*elementLengthOnGP);
 
-                    // 3xiii.11iii. Assemble the twisting rotation coupling entries
-                    if (propWeakCurveDirichletConditions.isSecTwistingPrescribed)
-                        couplingMatrices->addCNNValue(EFT[i], EFT[j], alphaSecondaryTwisting*KPenaltyTwistingRotation[i*noDOFsLoc + j]*elementLengthOnGP);
+                        // 4xiii.11iii. Assemble the twisting rotation coupling entries
+                        if (propWeakCurveDirichletConditions.isSecTwistingPrescribed)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFT[i], EFT[j], alphaSecondaryTwisting*KPenaltyTwistingRotation[i*noDOFsLoc + j]*elementLengthOnGP);
+                    }
                 }
-            }
 
-            // 3xiii.12. Store the Gauss point values necessary for the error computation
-            if(propErrorComputation.isCurveError){
-                // Initialize variable storing the Gauss Point data
-                std::vector<double> streamCurveGP;
+                // 4xiii.12. Store the Gauss point values necessary for the error computation
+                if(propErrorComputation.isCurveError){
+                    // Initialize variable storing the Gauss Point data
+                    std::vector<double> streamCurveGP;
 
-                // elementLengthOnGP + noBasisFuncs + (#indexCP, basisFuncValue,...) + (#indexDOF, BtValue, BnValue,...)
-                streamCurveGP.reserve(1 + 1 + 2*noLocalBasisFcts + 3*noDOFsLoc);
+                    // elementLengthOnGP + noBasisFuncs + (#indexCP, basisFuncValue,...) + (#indexDOF, BtValue, BnValue,...)
+                    streamCurveGP.reserve(1 + 1 + 2*noLocalBasisFcts + 3*noDOFsLoc);
 
-                // Save the element length on the Gauss Point
-                streamCurveGP.push_back(elementLengthOnGP);
+                    // Save the element length on the Gauss Point
+                    streamCurveGP.push_back(elementLengthOnGP);
 
-                // Save the number of basis functions
-                streamCurveGP.push_back(noLocalBasisFcts);
+                    // Save the number of basis functions
+                    streamCurveGP.push_back(noLocalBasisFcts);
 
-                // Save the Control Point index and the basis function's values
-                for(int iBFs = 0; iBFs < noLocalBasisFcts; iBFs++){
-                    indexCP = thePatch->getControlPointNet()[CPIndex[iBFs]]->getDofIndex();
-                    streamCurveGP.push_back(indexCP);
-                    streamCurveGP.push_back(BDisplacementsGC[0*noLocalBasisFcts + 3*iBFs]);
-                }
+                    // Save the Control Point index and the basis function's values
+                    for(int iBFs = 0; iBFs < noLocalBasisFcts; iBFs++){
+                        indexCP = thePatch->getControlPointNet()[CPIndex[iBFs]]->getDofIndex();
+                        streamCurveGP.push_back(indexCP);
+                        streamCurveGP.push_back(BDisplacementsGC[0*noLocalBasisFcts + 3*iBFs]);
+                    }
 
-                // Save the DOF index and the bending and twisting B-operator values
-                for(int iDOFs = 0; iDOFs < noDOFsLoc; iDOFs++){
-                    streamCurveGP.push_back(EFT[iDOFs]);
-                    streamCurveGP.push_back(BOperatorOmegaT[iDOFs]);
-                    streamCurveGP.push_back(BOperatorOmegaN[iDOFs]);
-                }
+                    // Save the DOF index and the bending and twisting B-operator values
+                    for(int iDOFs = 0; iDOFs < noDOFsLoc; iDOFs++){
+                        streamCurveGP.push_back(EFT[iDOFs]);
+                        streamCurveGP.push_back(BOperatorOmegaT[iDOFs]);
+                        streamCurveGP.push_back(BOperatorOmegaN[iDOFs]);
+                    }
 
-                // Push back the Gauss Point values into the member variable
-                streamCurveGPs.push_back(streamCurveGP);
-            }
+                    // Push back the Gauss Point values into the member variable
+                    streamCurveGPsOfConditions[iDCC].push_back(streamCurveGP);
+                }
 
-        } // End of Gauss Point loop
+                // Keep the memory of the buffer bounded
+                couplingMatrices->flushBufferIfFull(buffer);
+            } // End of Gauss Point loop
 
-        // 3xiv. Delete pointers
-        delete[] BDisplacementsGC;
-        delete[] BOperatorOmegaT;
-        delete[] BOperatorOmegaN;
-        delete[] KPenaltyDisplacement;
-        delete[] KPenaltyBendingRotation;
-        delete[] KPenaltyTwistingRotation;
+            progress.add();
+        } // End of weak Dirichlet curve condition loop
+    }
+    progress.finish();
 
-    } // End of weak Dirichlet curve condition loop
+    // 5. Merge the contributions of all threads and append the Gauss point streams in the order of the conditions
+    couplingMatrices->assembleBuffers(mapperSetNumThreads);
+    for (int iCond = 0; iCond < streamCurveGPsOfConditions.size(); iCond++)
+        streamCurveGPs.insert(streamCurveGPs.end(), streamCurveGPsOfConditions[iCond].begin(), streamCurveGPsOfConditions[iCond].end());
 }
 
 void IGAMortarMapper::computeIGAWeakDirichletSurfaceConditionMatrices() {
@@ -3024,160 +3926,184 @@ void IGAMortarMapper::computeIGAWeakDirichletSurfaceConditionMatrices() {
      *
      * Function layout:
      *
-     * 1. Initialize auxiliary variables
+     * 1. Get the weak Dirichlet surface conditions
+     *
+     * 2. Allocate the triplet buffers of the threads
      *
-     * 2. Get the weak Dirichlet surface conditions
+     * 3. Initialize the auxiliary variables and the arrays of every thread
      *
-     * 3. Loop over all the conditions for the application of weak Dirichlet conditions over surfaces
+     * 4. Loop over all the conditions for the application of weak Dirichlet conditions over surfaces in parallel
      * ->
-     *    3i. Get the penalty factors for the primary field
-     *   3ii. Get the index of the patch
-     *  3iii. Get the number of Gauss Points for the given condition
-     *   3iv. Get the parametric coordinates of the Gauss Points
-     *    3v. Get the corresponding Gauss weights
-     *   3vi. Get the Jacobian products
-     *  3vii. Get the patch
-     * 3viii. Get the polynomial orders of the master and the slave patch
-     *   3ix. get the number of local basis functions
-     *    3x. get the number of the local DOFs for the patch
-     *   3xi. Initialize pointers
-     *  3xii. Loop over all the Gauss Points of the given condition
+     *    4i. Get the penalty factors for the primary field
+     *   4ii. Get the index of the patch
+     *  4iii. Get the number of Gauss Points for the given condition
+     *   4iv. Get the parametric coordinates of the Gauss Points
+     *    4v. Get the corresponding Gauss weights
+     *   4vi. Get the Jacobian products
+     *  4vii. Get the patch
+     * 4viii. Get the polynomial orders of the master and the slave patch
+     *   4ix. get the number of local basis functions
+     *    4x. get the number of the local DOFs for the patch
+     *   4xi. Get the arrays of the thread, they grow to the largest condition
+     *  4xii. Loop over all the Gauss Points of the given condition
      *  ->
-     *        3xii.1. Get the parametric coordinates of the Gauss Point on the patch
-     *        3xii.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
-     *        3xii.3. compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
-     *        3xii.4. Compute the B-operator matrices needed for the computation of the patch weak Dirichlet conditions at the patch
-     *        3xii.5. Compute the dual product matrices for the displacements
-     *        3xii.6. Compute the element index tables for the patch
-     *        3xii.7. Compute the element freedom tables for the patch
-     *        3xii.8. Assemble KPenaltyDisplacement to the global coupling matrix CNN
+     *        4xii.1. Get the parametric coordinates of the Gauss Point on the patch
+     *        4xii.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
+     *        4xii.3. compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
+     *        4xii.4. Compute the B-operator matrices needed for the computation of the patch weak Dirichlet conditions at the patch
+     *        4xii.5. Compute the dual product matrices for the displacements
+     *        4xii.6. Compute the element index tables for the patch
+     *        4xii.7. Compute the element freedom tables for the patch
+     *        4xii.8. Assemble KPenaltyDisplacement to the global coupling matrix CNN
      *  <-
-     * 3xiii. Delete pointers
      * <-
+     *
+     * 5. Merge the contributions of all threads
      */
 
-    // 1. Initialize auxiliary variables
-    const int noCoordParam = 2;
-    const int noCoord = 3;
-    int patchIndex;
-    int counter;
-    int p;
-    int q;
-    int noLocalBasisFcts;
-    int noDOFsLoc;
-    int noGPsOnCond;
-    int uKnotSpan;
-    int vKnotSpan;
-    int indexCP;
-    double uGP;
-    double vGP;
-    double tangentCurveVct[noCoord] = {0,0,0};
-    double normalCurveVct[noCoord];
-    double surfaceNormalVct[noCoord];
-    double alphaPrimary;
-    double jacobianOnGP;
-    double* surfaceGPs;
-    double* surfaceGPWeights;
-    double* surfaceGPJacobians;
-    IGAPatchSurface* thePatch;
-
-    // 2. Get the weak Dirichlet surface conditions
+    // 1. Get the weak Dirichlet surface conditions
     std::vector<WeakIGADirichletSurfaceCondition*> weakIGADirichletSurfaceConditions = meshIGA->getWeakIGADirichletSurfaceConditions();
 
-    // 3. Loop over all the conditions for the application of weak Dirichlet conditions over surfaces
-    for (int iDSC = 0; iDSC < weakIGADirichletSurfaceConditions.size(); iDSC++){
-        // 3i. Get the penalty factors for the primary field
-        alphaPrimary = weakDirichletSCAlphaPrimary[iDSC];
-
-        // 3ii. Get the index of the patch
-        patchIndex = weakIGADirichletSurfaceConditions[iDSC]->getPatchIndex();
-
-        // 3iii. Get the number of Gauss Points for the given condition
-        noGPsOnCond = weakIGADirichletSurfaceConditions[iDSC]->getSurfaceNumGP();
-
-        // 3iv. Get the parametric coordinates of the Gauss Points
-        surfaceGPs = weakIGADirichletSurfaceConditions[iDSC]->getSurfaceGPs();
-
-        // 3v. Get the corresponding Gauss weights
-        surfaceGPWeights = weakIGADirichletSurfaceConditions[iDSC]->getSurfaceGPWeights();
-
-        // 3vi. Get the Jacobian products
-        surfaceGPJacobians = weakIGADirichletSurfaceConditions[iDSC]->getSurfaceGPJacobians();
-
-        // 3vii. Get the patch
-        thePatch = meshIGA->getSurfacePatch(patchIndex);
-
-        // 3viii. Get the polynomial orders of the master and the slave patch
-        p = thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
-        q = thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
-
-        // 3ix. get the number of local basis functions
-        noLocalBasisFcts = (p + 1)*(q + 1);
-
-        // 3x. get the number of the local DOFs for the patch
-        noDOFsLoc = noCoord*noLocalBasisFcts;
-
-        // 3xi. Initialize pointers
-        double* BDisplacementsGC = new double[noCoord*noDOFsLoc];
-        double* BOperatorOmegaT = new double[noDOFsLoc];
-        double* BOperatorOmegaN = new double[noDOFsLoc];
-        double* KPenaltyDisplacement = new double[noDOFsLoc*noDOFsLoc];
-
-        // 3xii. Loop over all the Gauss Points of the given condition
-        for(int iGP = 0; iGP < noGPsOnCond; iGP++){
-            // 3xii.1. Get the parametric coordinates of the Gauss Point on the patch
-            uGP = surfaceGPs[iGP*noCoordParam];
-            vGP = surfaceGPs[iGP*noCoordParam + 1];
-
-            // 3xii.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
-            uKnotSpan = thePatch->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGP);
-            vKnotSpan = thePatch->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGP);
-
-            // 3xii.3. compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
-            jacobianOnGP = surfaceGPJacobians[iGP];
-
-            // 3xii.4. Compute the B-operator matrices needed for the computation of the patch weak Dirichlet conditions at the patch
-            computeDisplacementAndRotationBOperatorMatrices(BDisplacementsGC, BOperatorOmegaT, BOperatorOmegaN, normalCurveVct,
-                                                            surfaceNormalVct, thePatch, tangentCurveVct, uGP, vGP, uKnotSpan, vKnotSpan);
-
-            // 3xii.5. Compute the dual product matrices for the displacements
-            if (propWeakSurfaceDirichletConditions.isPrimPrescribed)
-                EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLoc,noDOFsLoc,BDisplacementsGC,BDisplacementsGC,KPenaltyDisplacement);
+    // 2. Allocate the triplet buffers of the threads
+    couplingMatrices->initBuffers(mapperSetNumThreads, weakIGADirichletSurfaceConditions.size());
 
-            // 3xii.6. Compute the element index tables for the patch
-            int CPIndex[noLocalBasisFcts];
-            thePatch->getIGABasis()->getBasisFunctionsIndex(uKnotSpan, vKnotSpan, CPIndex);
-
-            // 3xii.7. Compute the element freedom tables for the patch
-            int EFT[noDOFsLoc];
-            counter = 0;
-            for (int i = 0; i < noLocalBasisFcts; i++){
-                indexCP = thePatch->getControlPointNet()[CPIndex[i]]->getDofIndex();
-                for (int j = 0; j < noCoord; j++){
-                    EFT[counter] = noCoord*indexCP + j;
-                    counter++;
+    BuildProgress progress("IGAMortarMapper: weak Dirichlet surface conditions", "conditions", weakIGADirichletSurfaceConditions.size());
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        // 3. Initialize the auxiliary variables and the arrays of the thread
+        const int noCoordParam = 2;
+        const int noCoord = 3;
+        int patchIndex;
+        int counter;
+        int p;
+        int q;
+        int noLocalBasisFcts;
+        int noDOFsLoc;
+        int noGPsOnCond;
+        int uKnotSpan;
+        int vKnotSpan;
+        int indexCP;
+        double uGP;
+        double vGP;
+        double tangentCurveVct[noCoord] = {0,0,0};
+        double normalCurveVct[noCoord];
+        double surfaceNormalVct[noCoord];
+        double alphaPrimary;
+        double jacobianOnGP;
+        double* surfaceGPs;
+        double* surfaceGPWeights;
+        double* surfaceGPJacobians;
+        IGAPatchSurface* thePatch;
+
+        std::vector<double> BDisplacementsGCArray;
+        std::vector<double> BOperatorOmegaTArray;
+        std::vector<double> BOperatorOmegaNArray;
+        std::vector<double> KPenaltyDisplacementArray;
+
+        // 4. Loop over all the conditions for the application of weak Dirichlet conditions over surfaces
+#pragma omp for schedule(dynamic, 1)
+        for (int iDSC = 0; iDSC < weakIGADirichletSurfaceConditions.size(); iDSC++){
+            // The buffer of the condition, see MathLibrary::getAssemblyBuffer
+            const int buffer = MathLibrary::getAssemblyBuffer(iDSC);
+
+            // 4i. Get the penalty factors for the primary field
+            alphaPrimary = weakDirichletSCAlphaPrimary[iDSC];
+
+            // 4ii. Get the index of the patch
+            patchIndex = weakIGADirichletSurfaceConditions[iDSC]->getPatchIndex();
+
+            // 4iii. Get the number of Gauss Points for the given condition
+            noGPsOnCond = weakIGADirichletSurfaceConditions[iDSC]->getSurfaceNumGP();
+
+            // 4iv. Get the parametric coordinates of the Gauss Points
+            surfaceGPs = weakIGADirichletSurfaceConditions[iDSC]->getSurfaceGPs();
+
+            // 4v. Get the corresponding Gauss weights
+            surfaceGPWeights = weakIGADirichletSurfaceConditions[iDSC]->getSurfaceGPWeights();
+
+            // 4vi. Get the Jacobian products
+            surfaceGPJacobians = weakIGADirichletSurfaceConditions[iDSC]->getSurfaceGPJacobians();
+
+            // 4vii. Get the patch
+            thePatch = meshIGA->getSurfacePatch(patchIndex);
+
+            // 4viii. Get the polynomial orders of the master and the slave patch
+            p = thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
+            q = thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
+
+            // 4ix. get the number of local basis functions
+            noLocalBasisFcts = (p + 1)*(q + 1);
+
+            // 4x. get the number of the local DOFs for the patch
+            noDOFsLoc = noCoord*noLocalBasisFcts;
+
+            // 4xi. Get the arrays of the thread, they grow to the largest condition
+            BDisplacementsGCArray.resize(noCoord*noDOFsLoc);
+            double* BDisplacementsGC = &BDisplacementsGCArray[0];
+            BOperatorOmegaTArray.resize(noDOFsLoc);
+            double* BOperatorOmegaT = &BOperatorOmegaTArray[0];
+            BOperatorOmegaNArray.resize(noDOFsLoc);
+            double* BOperatorOmegaN = &BOperatorOmegaNArray[0];
+            KPenaltyDisplacementArray.resize(noDOFsLoc*noDOFsLoc);
+            double* KPenaltyDisplacement = &KPenaltyDisplacementArray[0];
+
+            // 4xii. Loop over all the Gauss Points of the given condition
+            for(int iGP = 0; iGP < noGPsOnCond; iGP++){
+                // 4xii.1. Get the parametric coordinates of the Gauss Point on the patch
+                uGP = surfaceGPs[iGP*noCoordParam];
+                vGP = surfaceGPs[iGP*noCoordParam + 1];
+
+                // 4xii.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
+                uKnotSpan = thePatch->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGP);
+                vKnotSpan = thePatch->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGP);
+
+                // 4xii.3. compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
+                jacobianOnGP = surfaceGPJacobians[iGP];
+
+                // 4xii.4. Compute the B-operator matrices needed for the computation of the patch weak Dirichlet conditions at the patch
+                computeDisplacementAndRotationBOperatorMatrices(BDisplacementsGC, BOperatorOmegaT, BOperatorOmegaN, normalCurveVct,
+                                                                surfaceNormalVct, thePatch, tangentCurveVct, uGP, vGP, uKnotSpan, vKnotSpan);
+
+                // 4xii.5. Compute the dual product matrices for the displacements
+                if (propWeakSurfaceDirichletConditions.isPrimPrescribed)
+                    EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLoc,noDOFsLoc,BDisplacementsGC,BDisplacementsGC,KPenaltyDisplacement);
+
+                // 4xii.6. Compute the element index tables for the patch
+                int CPIndex[noLocalBasisFcts];
+                thePatch->getIGABasis()->getBasisFunctionsIndex(uKnotSpan, vKnotSpan, CPIndex);
+
+                // 4xii.7. Compute the element freedom tables for the patch
+                int EFT[noDOFsLoc];
+                counter = 0;
+                for (int i = 0; i < noLocalBasisFcts; i++){
+                    indexCP = thePatch->getControlPointNet()[CPIndex[i]]->getDofIndex();
+                    for (int j = 0; j < noCoord; j++){
+                        EFT[counter] = noCoord*indexCP + j;
+                        counter++;
+                    }
                 }
-            }
 
-            // 3xii.8. Assemble KPenaltyDisplacement to the global coupling matrix CNN
-            if (propWeakSurfaceDirichletConditions.isPrimPrescribed)
-                for(int i = 0; i < noDOFsLoc; i++){
-                    for(int j = 0; j < noDOFsLoc; j++){
-                        // Assemble the displacement coupling entries
-                        couplingMatrices->addCNNValue(EFT[i], EFT[i], alphaPrimary*KPenaltyDisplacement[i*noDOFsLoc + i]*jacobianOnGP);
+                // 4xii.8. Assemble KPenaltyDisplacement to the global coupling matrix CNN
+                if (propWeakSurfaceDirichletConditions.isPrimPrescribed)
+                    for(int i = 0; i < noDOFsLoc; i++){
+                        for(int j = 0; j < noDOFsLoc; j++){
+                            // Assemble the displacement coupling entries
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFT[i], EFT[i], alphaPrimary*KPenaltyDisplacement[i*noDOFsLoc + i]*jacobianOnGP);
+                        }
                     }
-                }
 
-            //// 3xii.9. TODO Store the GP data into array for later usage in the error computation
-        } // End of Gauss Point loop
+                //// 4xii.9. TODO Store the GP data into array for later usage in the error computation
+                // Keep the memory of the buffer bounded
+                couplingMatrices->flushBufferIfFull(buffer);
+            } // End of Gauss Point loop
 
-        // 3xiii. Delete pointers
-        delete[] BDisplacementsGC;
-        delete[] BOperatorOmegaT;
-        delete[] BOperatorOmegaN;
-        delete[] KPenaltyDisplacement;
+            progress.add();
+        } // End of weak Dirichlet surface condition loop
+    }
+    progress.finish();
 
-    } // End of weak Dirichlet surface condition loop
+    // 5. Merge the contributions of all threads
+    couplingMatrices->assembleBuffers(mapperSetNumThreads);
 }
 
 void IGAMortarMapper::computeIGAPatchWeakContinuityConditionMatrices() {
@@ -3186,498 +4112,537 @@ void IGAMortarMapper::computeIGAPatchWeakContinuityConditionMatrices() {
      *
      * Function layout:
      *
-     * 1. Initialize auxiliary variables
+     * 1. Get the weak patch continuity conditions
      *
-     * 2. Get the weak patch continuity conditions
+     * 2. Allocate the triplet buffers of the threads and the Gauss point streams of the conditions
      *
-     * 3. Loop over all the conditions for the application of weak continuity across patch interfaces
+     * 3. Initialize the auxiliary variables and the arrays of every thread
+     *
+     * 4. Loop over all the conditions for the application of weak continuity across patch interfaces in parallel
      * ->
-     *    3i. Get the penalty factors for the primary and the secondary field
-     *   3ii. Get the index of the master and slave patches
-     *  3iii. Get the number of Gauss Points for the given condition
-     *   3iv. Get the parametric coordinates of the Gauss Points
-     *    3v. Get the corresponding Gauss weights
-     *   3vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
-     *  3vii. Get the product of the Jacobian transformations
-     * 3viii. Get the master and the slave patch
-     *   3ix. Get the polynomial orders of the master and the slave patch
-     *    3x. get the number of local basis functions for master and slave patch
-     *   3xi. get the number of the local DOFs for the master and slave patch
-     *  3xii. Initialize pointers
-     * 3xiii. Loop over all the Gauss Points of the given condition
+     *    4i. Get the penalty factors for the primary and the secondary field
+     *   4ii. Get the index of the master and slave patches
+     *  4iii. Get the number of Gauss Points for the given condition
+     *   4iv. Get the parametric coordinates of the Gauss Points
+     *    4v. Get the corresponding Gauss weights
+     *   4vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
+     *  4vii. Get the product of the Jacobian transformations
+     * 4viii. Get the master and the slave patch
+     *   4ix. Get the polynomial orders of the master and the slave patch
+     *    4x. get the number of local basis functions for master and slave patch
+     *   4xi. get the number of the local DOFs for the master and slave patch
+     *  4xii. Get the arrays of the thread, they grow to the largest condition
+     * 4xiii. Loop over all the Gauss Points of the given condition
      * ->
-     *        3xiii.1. Get the parametric coordinates of the Gauss Point on the master patch
-     *        3xiii.2. Get the parametric coordinates of the Gauss Point on the slave patch
-     *        3xiii.3. Find the knot span indices of the Gauss point locations in the parameter space of the master patch
-     *        3xiii.4. Find the knot span indices of the Gauss point locations in the parameter space of the slave patch
-     *        3xiii.5. Get the tangent to the boundary vector on the master and the slave patch
-     *        3xiii.6. Compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
-     *        3xiii.7. Compute the B-operator matrices needed for the computation of the patch weak continuity contributions at the master patch
-     *        3xiii.8. Compute the B-operator matrices needed for the computation of the patch weak continuity contributions at the slave patch
-     *        3xiii.9. Compute the local penalty factor for scaling the rotational contributions
-     *       3xiii.10. Scale the B-operator matrices
-     *       3xiii.11. Compute the angle of the surface normal vectors
-     *       3xiii.12. Determine the alignment of the tangent vectors from both patches at their common interface
-     *       3xiii.13. Check if the tangent vectors at the coupled trimming curves are zero and if yes go to the next Gauss point
-     *       3xiii.14. Check if the tangent vectors are aligned and if not assert error
-     *       3xiii.15. Check if the angle between the tangent vectors is 0° (have the same direction cos(phi) = 1) or 180° (have opposite directions cos(phi) = - 1) to formulate the interface constraint
-     *       3xiii.16. Determine the alignment of the normal vectors from both patches at their common interface
-     *       3xiii.17. Check if the normal vectors at the coupled trimming curves are zero and if yes go to the next Gauss point
-     *       3xiii.18. Check if the boundary normal vectors have an angle of [0,90]U[270,360] meaning the the vectors are in the positive quadrant or [90,270] meaning that the vectors are in the negative quadrant
-     *       3xiii.19. Compute the dual product matrices for the displacements
-     *       3xiii.20. Compute the dual product matrices for the bending rotations
-     *       3xiii.21. Compute the dual product matrices for the twisting rotations
-     *       3xiii.22. Compute the element index tables for the master and slave patch
-     *       3xiii.23. Compute the element freedom tables for the master and the slave patch
-     *       3xiii.24. Loop over all DOFs of the master patch to assemble KPenaltyDisplacementMaster to the global coupling matrix CNN
+     *        4xiii.1. Get the parametric coordinates of the Gauss Point on the master patch
+     *        4xiii.2. Get the parametric coordinates of the Gauss Point on the slave patch
+     *        4xiii.3. Find the knot span indices of the Gauss point locations in the parameter space of the master patch
+     *        4xiii.4. Find the knot span indices of the Gauss point locations in the parameter space of the slave patch
+     *        4xiii.5. Get the tangent to the boundary vector on the master and the slave patch
+     *        4xiii.6. Compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
+     *        4xiii.7. Compute the B-operator matrices needed for the computation of the patch weak continuity contributions at the master patch
+     *        4xiii.8. Compute the B-operator matrices needed for the computation of the patch weak continuity contributions at the slave patch
+     *        4xiii.9. Compute the local penalty factor for scaling the rotational contributions
+     *       4xiii.10. Scale the B-operator matrices
+     *       4xiii.11. Compute the angle of the surface normal vectors
+     *       4xiii.12. Determine the alignment of the tangent vectors from both patches at their common interface
+     *       4xiii.13. Check if the tangent vectors at the coupled trimming curves are zero and if yes go to the next Gauss point
+     *       4xiii.14. Check if the tangent vectors are aligned and if not assert error
+     *       4xiii.15. Check if the angle between the tangent vectors is 0° (have the same direction cos(phi) = 1) or 180° (have opposite directions cos(phi) = - 1) to formulate the interface constraint
+     *       4xiii.16. Determine the alignment of the normal vectors from both patches at their common interface
+     *       4xiii.17. Check if the normal vectors at the coupled trimming curves are zero and if yes go to the next Gauss point
+     *       4xiii.18. Check if the boundary normal vectors have an angle of [0,90]U[270,360] meaning the the vectors are in the positive quadrant or [90,270] meaning that the vectors are in the negative quadrant
+     *       4xiii.19. Compute the dual product matrices for the displacements
+     *       4xiii.20. Compute the dual product matrices for the bending rotations
+     *       4xiii.21. Compute the dual product matrices for the twisting rotations
+     *       4xiii.22. Compute the element index tables for the master and slave patch
+     *       4xiii.23. Compute the element freedom tables for the master and the slave patch
+     *       4xiii.24. Loop over all DOFs of the master patch to assemble KPenaltyDisplacementMaster to the global coupling matrix CNN
      *       ->
-     *                 3xiii.24i. Assemble the displacement coupling entries
-     *                3xiii.24ii. Assemble the bending rotation coupling entries
-     *               3xiii.24iii. Assemble the twisting rotation coupling entries
+     *                 4xiii.24i. Assemble the displacement coupling entries
+     *                4xiii.24ii. Assemble the bending rotation coupling entries
+     *               4xiii.24iii. Assemble the twisting rotation coupling entries
      *       <-
-     *       3xiii.25. Loop over all DOFs of the slave patch to assemble KPenaltyDisplacementSlave to the global coupling matrix CNN
+     *       4xiii.25. Loop over all DOFs of the slave patch to assemble KPenaltyDisplacementSlave to the global coupling matrix CNN
      *       ->
-     *                 3xiii.25i. Assemble the displacement coupling entries
-     *                3xiii.25ii. Assemble the bending rotation coupling entries
-     *               3xiii.25iii. Assemble the twisting rotation coupling entries
+     *                 4xiii.25i. Assemble the displacement coupling entries
+     *                4xiii.25ii. Assemble the bending rotation coupling entries
+     *               4xiii.25iii. Assemble the twisting rotation coupling entries
      *       <-
-     *       3xiii.26. Loop over all DOFs of the master/slave patches to assemble CPenaltyDisplacement to the global coupling matrix CNN
+     *       4xiii.26. Loop over all DOFs of the master/slave patches to assemble CPenaltyDisplacement to the global coupling matrix CNN
      *       ->
-     *                 3xiii.26i. Assemble the displacement coupling entries
-     *                3xiii.26ii. Assemble the bending rotation coupling entries
-     *               3xiii.26iii. Assemble the twisting rotation coupling entries
+     *                 4xiii.26i. Assemble the displacement coupling entries
+     *                4xiii.26ii. Assemble the bending rotation coupling entries
+     *               4xiii.26iii. Assemble the twisting rotation coupling entries
      *       <-
-     *       3xiii.27. Save the Gauss point data for further computation of the error in the L2 norm
+     *       4xiii.27. Save the Gauss point data for further computation of the error in the L2 norm
      * <-
-     *  3xiv. Delete pointers
      * <-
+     *
+     * 5. Merge the contributions of all threads and append the Gauss point streams in the order of the conditions
      */
 
-    // 1. Initialize auxiliary variables
-    const double tolAngle = 1e-1;
-    const double tolVct = 1e-4;
-    const int noCoordParam = 2;
-    const int noCoord = 3;
-    int indexMaster;
-    int indexSlave;
-    int counter;
-    int pMaster;
-    int qMaster;
-    int pSlave;
-    int qSlave;
-    int noLocalBasisFctsMaster;
-    int noLocalBasisFctsSlave;
-    int noDOFsLocMaster;
-    int noDOFsLocSlave;
-    int noGPsOnContCond;
-    int uKnotSpanMaster;
-    int uKnotSpanSlave;
-    int vKnotSpanMaster;
-    int vKnotSpanSlave;
-    int indexCP;
-    double uGPMaster;
-    double vGPMaster;
-    double uGPSlave;
-    double vGPSlave;
-    double cosPhiTangents;
-    double cosPhiNormals;
-    double cosPhiSurfaceNormals;
-    double condAligned;
-    double factorTangent;
-    double factorNormal;
-    double tangentTrCurveVctMaster[noCoord];
-    double tangentTrCurveVctSlave[noCoord];
-    double normalTrCurveVctMaster[noCoord];
-    double normalTrCurveVctSlave[noCoord];
-    double surfaceNormalVctMaster[noCoord];
-    double surfaceNormalVctSlave[noCoord];
-    double normTangentTrCurveVctMaster;
-    double normTangentTrCurveVctSlave;
-    double normNormalTrCurveVctMaster;
-    double normNormalTrCurveVctSlave;
-    double normSurfaceNormalVctMaster;
-    double normSurfaceNormalVctSlave;
-    double normBOperatorOmegaTMaster;
-    double normBOperatorOmegaNMaster;
-    double normBOperatorOmegaTSlave;
-    double normBOperatorOmegaNSlave;
-    double alphaLocal;
-    double alphaPrimary;
-    double alphaSecondaryBending;
-    double alphaSecondaryTwisting;
-    double elementLengthOnGP;
-    double* trCurveMasterGPs;
-    double* trCurveSlaveGPs;
-    double* trCurveGPWeights;
-    double* trCurveMasterGPTangents;
-    double* trCurveSlaveGPTangents;
-    double* trCurveGPJacobianProducts;
-    IGAPatchSurface* patchMaster;
-    IGAPatchSurface* patchSlave;
-
-    // 2. Get the weak patch continuity conditions
+    // 1. Get the weak patch continuity conditions
     std::vector<WeakIGAPatchContinuityCondition*> weakIGAPatchContinuityConditions = meshIGA->getWeakIGAPatchContinuityConditions();
 
-    // 3. Loop over all the conditions for the application of weak continuity across patch interfaces
-    for (int iWCC = 0; iWCC < weakIGAPatchContinuityConditions.size(); iWCC++){
-        // 3i. Get the penalty factors for the primary and the secondary field
-        alphaPrimary = weakPatchContinuityAlphaPrimaryIJ[iWCC];
-        alphaSecondaryBending = weakPatchContinuityAlphaSecondaryBendingIJ[iWCC];
-        alphaSecondaryTwisting = weakPatchContinuityAlphaSecondaryTwistingIJ[iWCC];
-
-        // 3ii. Get the index of the master and slave patches
-        indexMaster = weakIGAPatchContinuityConditions[iWCC]->getMasterPatchIndex();
-        indexSlave = weakIGAPatchContinuityConditions[iWCC]->getSlavePatchIndex();
-
-        // 3iii. Get the number of Gauss Points for the given condition
-        noGPsOnContCond = weakIGAPatchContinuityConditions[iWCC]->getTrCurveNumGP();
-
-        // 3iv. Get the parametric coordinates of the Gauss Points
-        trCurveMasterGPs = weakIGAPatchContinuityConditions[iWCC]->getTrCurveMasterGPs();
-        trCurveSlaveGPs = weakIGAPatchContinuityConditions[iWCC]->getTrCurveSlaveGPs();
-
-        // 3v. Get the corresponding Gauss weights
-        trCurveGPWeights = weakIGAPatchContinuityConditions[iWCC]->getTrCurveGPWeights();
-
-        // 3vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
-        trCurveMasterGPTangents = weakIGAPatchContinuityConditions[iWCC]->getTrCurveMasterGPTangents();
-        trCurveSlaveGPTangents = weakIGAPatchContinuityConditions[iWCC]->getTrCurveSlaveGPTangents();
-
-        // 3vii. Get the product of the Jacobian transformations
-        trCurveGPJacobianProducts = weakIGAPatchContinuityConditions[iWCC]->getTrCurveGPJacobianProducts();
-
-        // 3viii. Get the master and the slave patch
-        patchMaster = meshIGA->getSurfacePatch(indexMaster);
-        patchSlave = meshIGA->getSurfacePatch(indexSlave);
-
-        // 3ix. Get the polynomial orders of the master and the slave patch
-        pMaster = patchMaster->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
-        qMaster = patchMaster->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
-        pSlave = patchSlave->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
-        qSlave = patchSlave->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
-
-        // 3x. get the number of local basis functions for master and slave patch
-        noLocalBasisFctsMaster = (pMaster + 1)*(qMaster + 1);
-        noLocalBasisFctsSlave = (pSlave + 1)*(qSlave + 1);
-
-        // 3xi. get the number of the local DOFs for the master and slave patch
-        noDOFsLocMaster = noCoord*noLocalBasisFctsMaster;
-        noDOFsLocSlave = noCoord*noLocalBasisFctsSlave;
-
-        // 3xii. Initialize pointers
-        double* BDisplacementsGCMaster = new double[noCoord*noDOFsLocMaster];
-        double* BDisplacementsGCSlave = new double[noCoord*noDOFsLocSlave];
-        double* BOperatorOmegaTMaster = new double[noDOFsLocMaster];
-        double* BOperatorOmegaTSlave = new double[noDOFsLocSlave];
-        double* BOperatorOmegaNMaster = new double[noDOFsLocMaster];
-        double* BOperatorOmegaNSlave = new double[noDOFsLocSlave];
-        double* KPenaltyDisplacementMaster = new double[noDOFsLocMaster*noDOFsLocMaster];
-        double* KPenaltyDisplacementSlave = new double[noDOFsLocSlave*noDOFsLocSlave];
-        double* CPenaltyDisplacement = new double[noDOFsLocMaster*noDOFsLocSlave];
-        double* KPenaltyBendingRotationMaster = new double[noDOFsLocMaster*noDOFsLocMaster];
-        double* KPenaltyBendingRotationSlave = new double[noDOFsLocSlave*noDOFsLocSlave];
-        double* CPenaltyBendingRotation = new double[noDOFsLocMaster*noDOFsLocSlave];
-        double* KPenaltyTwistingRotationMaster = new double[noDOFsLocMaster*noDOFsLocMaster];
-        double* KPenaltyTwistingRotationSlave = new double[noDOFsLocSlave*noDOFsLocSlave];
-        double* CPenaltyTwistingRotation = new double[noDOFsLocMaster*noDOFsLocSlave];
-
-        // 3xiii. Loop over all the Gauss Points of the given condition
-        for(int iGP = 0; iGP < noGPsOnContCond; iGP++){
-            // 3xiii.1. Get the parametric coordinates of the Gauss Point on the master patch
-            uGPMaster = trCurveMasterGPs[iGP*noCoordParam];
-            vGPMaster = trCurveMasterGPs[iGP*noCoordParam + 1];
-
-            // 3xiii.2. Get the parametric coordinates of the Gauss Point on the slave patch
-            uGPSlave = trCurveSlaveGPs[iGP*noCoordParam];
-            vGPSlave = trCurveSlaveGPs[iGP*noCoordParam + 1];
-
-            // 3xiii.3. Find the knot span indices of the Gauss point locations in the parameter space of the master patch
-            uKnotSpanMaster = patchMaster->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGPMaster);
-            vKnotSpanMaster = patchMaster->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGPMaster);
-
-            // 3xiii.4. Find the knot span indices of the Gauss point locations in the parameter space of the slave patch
-            uKnotSpanSlave = patchSlave->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGPSlave);
-            vKnotSpanSlave = patchSlave->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGPSlave);
-
-            // 3xiii.5. Get the tangent to the boundary vector on the master and the slave patch
-            for(int iCoord = 0; iCoord < noCoord; iCoord++){
-                tangentTrCurveVctMaster[iCoord] = trCurveMasterGPTangents[iGP*noCoord + iCoord];
-                tangentTrCurveVctSlave[iCoord] = trCurveSlaveGPTangents[iGP*noCoord + iCoord];
-            }
-
-            // 3xiii.6. Compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
-            elementLengthOnGP = trCurveGPJacobianProducts[iGP];
-
-            // 3xiii.7. Compute the B-operator matrices needed for the computation of the patch weak continuity contributions at the master patch
-            computeDisplacementAndRotationBOperatorMatrices(BDisplacementsGCMaster, BOperatorOmegaTMaster, BOperatorOmegaNMaster, normalTrCurveVctMaster,
-                                                            surfaceNormalVctMaster, patchMaster, tangentTrCurveVctMaster, uGPMaster, vGPMaster, uKnotSpanMaster,
-                                                            vKnotSpanMaster);
-
-            // 3xiii.8. Compute the B-operator matrices needed for the computation of the patch weak continuity contributions at the slave patch
-            computeDisplacementAndRotationBOperatorMatrices(BDisplacementsGCSlave, BOperatorOmegaTSlave, BOperatorOmegaNSlave, normalTrCurveVctSlave,
-                                                            surfaceNormalVctSlave, patchSlave, tangentTrCurveVctSlave, uGPSlave, vGPSlave, uKnotSpanSlave,
-                                                            vKnotSpanSlave);
-
-            // 3xiii.9. Compute the local penalty factor for scaling the rotational contributions
-            if (propWeakPatchContinuityConditions.isSecBendingCoupled) {
-                normBOperatorOmegaTMaster = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaTMaster, noDOFsLocMaster);
-                alphaLocal = normBOperatorOmegaTMaster;
-                normBOperatorOmegaTSlave = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaTSlave, noDOFsLocSlave);
-                if (normBOperatorOmegaTSlave > alphaLocal)
-                    alphaLocal = normBOperatorOmegaTSlave;
-            } else
-                alphaLocal = - 1.0;
-
-            if (propWeakPatchContinuityConditions.isSecTwistingCoupled) {
-                normBOperatorOmegaNMaster = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaNMaster, noDOFsLocMaster);
-                if (normBOperatorOmegaNMaster > alphaLocal)
-                    alphaLocal = normBOperatorOmegaNMaster;
-                normBOperatorOmegaNSlave = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaNSlave, noDOFsLocSlave);
-                if (normBOperatorOmegaNSlave > alphaLocal)
-                    alphaLocal = normBOperatorOmegaNSlave;
-            }
-            alphaLocal = 1.0/abs(alphaLocal);
-
-            // 3xiii.10. Scale the B-operator matrices
-            EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaTMaster, alphaLocal, noDOFsLocMaster);
-            EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaNMaster, alphaLocal, noDOFsLocMaster);
-            EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaTSlave, alphaLocal, noDOFsLocSlave);
-            EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaNSlave, alphaLocal, noDOFsLocSlave);
-
-            // 3xiii.11. Compute the angle of the surface normal vectors
-            normSurfaceNormalVctMaster = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, surfaceNormalVctMaster, surfaceNormalVctMaster);
-            normSurfaceNormalVctMaster = sqrt(normSurfaceNormalVctMaster);
-            normSurfaceNormalVctSlave = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, surfaceNormalVctSlave, surfaceNormalVctSlave);
-            normSurfaceNormalVctSlave = sqrt(normSurfaceNormalVctSlave);
-            cosPhiSurfaceNormals = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, surfaceNormalVctMaster, surfaceNormalVctSlave);
-            cosPhiSurfaceNormals = cosPhiSurfaceNormals/(normSurfaceNormalVctMaster*normSurfaceNormalVctSlave);
-
-            // 3xiii.12. Determine the alignment of the tangent vectors from both patches at their common interface
-            normTangentTrCurveVctMaster = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,tangentTrCurveVctMaster,tangentTrCurveVctMaster);
-            normTangentTrCurveVctMaster = sqrt(normTangentTrCurveVctMaster);
-            normTangentTrCurveVctSlave = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,tangentTrCurveVctSlave,tangentTrCurveVctSlave);
-            normTangentTrCurveVctSlave = sqrt(normTangentTrCurveVctSlave);
-            cosPhiTangents = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,tangentTrCurveVctMaster,tangentTrCurveVctSlave);
-            cosPhiTangents = cosPhiTangents/(normTangentTrCurveVctMaster*normTangentTrCurveVctSlave);
-
-            // 3xiii.13. Check if the tangent vectors at the coupled trimming curves are zero and if yes go to the next Gauss point
-            if(normTangentTrCurveVctMaster < tolVct && normTangentTrCurveVctSlave < tolVct)
-                continue;
-            else if((normTangentTrCurveVctMaster < tolVct && normTangentTrCurveVctSlave > tolVct) || (normTangentTrCurveVctMaster > tolVct && normTangentTrCurveVctSlave < tolVct))
-                assert(false);
+    // 2. Allocate the triplet buffers of the threads and the Gauss point streams of the conditions
+    couplingMatrices->initBuffers(mapperSetNumThreads, weakIGAPatchContinuityConditions.size());
+    std::vector<std::vector<std::vector<double> > > streamInterfaceGPsOfConditions(weakIGAPatchContinuityConditions.size());
 
-            // 3xiii.14. Check if the tangent vectors are aligned and if not assert error
-            condAligned = cosPhiTangents*cosPhiTangents - 1;
-            if (abs(condAligned) > tolAngle) {
-                INFO_OUT() << "Found boundaries for which the tangent vectors are not aligned with angle = " << cosPhiTangents << endl;
-            }
-            assert(abs(condAligned) < tolAngle);
+    BuildProgress progress("IGAMortarMapper: weak patch continuity conditions", "conditions", weakIGAPatchContinuityConditions.size());
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        // 3. Initialize the auxiliary variables and the arrays of the thread
+        const double tolAngle = 1e-1;
+        const double tolVct = 1e-4;
+        const int noCoordParam = 2;
+        const int noCoord = 3;
+        int indexMaster;
+        int indexSlave;
+        int counter;
+        int pMaster;
+        int qMaster;
+        int pSlave;
+        int qSlave;
+        int noLocalBasisFctsMaster;
+        int noLocalBasisFctsSlave;
+        int noDOFsLocMaster;
+        int noDOFsLocSlave;
+        int noGPsOnContCond;
+        int uKnotSpanMaster;
+        int uKnotSpanSlave;
+        int vKnotSpanMaster;
+        int vKnotSpanSlave;
+        int indexCP;
+        double uGPMaster;
+        double vGPMaster;
+        double uGPSlave;
+        double vGPSlave;
+        double cosPhiTangents;
+        double cosPhiNormals;
+        double cosPhiSurfaceNormals;
+        double condAligned;
+        double factorTangent;
+        double factorNormal;
+        double tangentTrCurveVctMaster[noCoord];
+        double tangentTrCurveVctSlave[noCoord];
+        double normalTrCurveVctMaster[noCoord];
+        double normalTrCurveVctSlave[noCoord];
+        double surfaceNormalVctMaster[noCoord];
+        double surfaceNormalVctSlave[noCoord];
+        double normTangentTrCurveVctMaster;
+        double normTangentTrCurveVctSlave;
+        double normNormalTrCurveVctMaster;
+        double normNormalTrCurveVctSlave;
+        double normSurfaceNormalVctMaster;
+        double normSurfaceNormalVctSlave;
+        double normBOperatorOmegaTMaster;
+        double normBOperatorOmegaNMaster;
+        double normBOperatorOmegaTSlave;
+        double normBOperatorOmegaNSlave;
+        double alphaLocal;
+        double alphaPrimary;
+        double alphaSecondaryBending;
+        double alphaSecondaryTwisting;
+        double elementLengthOnGP;
+        double* trCurveMasterGPs;
+        double* trCurveSlaveGPs;
+        double* trCurveGPWeights;
+        double* trCurveMasterGPTangents;
+        double* trCurveSlaveGPTangents;
+        double* trCurveGPJacobianProducts;
+        IGAPatchSurface* patchMaster;
+        IGAPatchSurface* patchSlave;
+
+        std::vector<double> BDisplacementsGCMasterArray;
+        std::vector<double> BDisplacementsGCSlaveArray;
+        std::vector<double> BOperatorOmegaTMasterArray;
+        std::vector<double> BOperatorOmegaTSlaveArray;
+        std::vector<double> BOperatorOmegaNMasterArray;
+        std::vector<double> BOperatorOmegaNSlaveArray;
+        std::vector<double> KPenaltyDisplacementMasterArray;
+        std::vector<double> KPenaltyDisplacementSlaveArray;
+        std::vector<double> CPenaltyDisplacementArray;
+        std::vector<double> KPenaltyBendingRotationMasterArray;
+        std::vector<double> KPenaltyBendingRotationSlaveArray;
+        std::vector<double> CPenaltyBendingRotationArray;
+        std::vector<double> KPenaltyTwistingRotationMasterArray;
+        std::vector<double> KPenaltyTwistingRotationSlaveArray;
+        std::vector<double> CPenaltyTwistingRotationArray;
+
+        // 4. Loop over all the conditions for the application of weak continuity across patch interfaces
+#pragma omp for schedule(dynamic, 1)
+        for (int iWCC = 0; iWCC < weakIGAPatchContinuityConditions.size(); iWCC++){
+            // The buffer of the condition, see MathLibrary::getAssemblyBuffer
+            const int buffer = MathLibrary::getAssemblyBuffer(iWCC);
+
+            // 4i. Get the penalty factors for the primary and the secondary field
+            alphaPrimary = weakPatchContinuityAlphaPrimaryIJ[iWCC];
+            alphaSecondaryBending = weakPatchContinuityAlphaSecondaryBendingIJ[iWCC];
+            alphaSecondaryTwisting = weakPatchContinuityAlphaSecondaryTwistingIJ[iWCC];
+
+            // 4ii. Get the index of the master and slave patches
+            indexMaster = weakIGAPatchContinuityConditions[iWCC]->getMasterPatchIndex();
+            indexSlave = weakIGAPatchContinuityConditions[iWCC]->getSlavePatchIndex();
+
+            // 4iii. Get the number of Gauss Points for the given condition
+            noGPsOnContCond = weakIGAPatchContinuityConditions[iWCC]->getTrCurveNumGP();
+
+            // 4iv. Get the parametric coordinates of the Gauss Points
+            trCurveMasterGPs = weakIGAPatchContinuityConditions[iWCC]->getTrCurveMasterGPs();
+            trCurveSlaveGPs = weakIGAPatchContinuityConditions[iWCC]->getTrCurveSlaveGPs();
+
+            // 4v. Get the corresponding Gauss weights
+            trCurveGPWeights = weakIGAPatchContinuityConditions[iWCC]->getTrCurveGPWeights();
+
+            // 4vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
+            trCurveMasterGPTangents = weakIGAPatchContinuityConditions[iWCC]->getTrCurveMasterGPTangents();
+            trCurveSlaveGPTangents = weakIGAPatchContinuityConditions[iWCC]->getTrCurveSlaveGPTangents();
+
+            // 4vii. Get the product of the Jacobian transformations
+            trCurveGPJacobianProducts = weakIGAPatchContinuityConditions[iWCC]->getTrCurveGPJacobianProducts();
+
+            // 4viii. Get the master and the slave patch
+            patchMaster = meshIGA->getSurfacePatch(indexMaster);
+            patchSlave = meshIGA->getSurfacePatch(indexSlave);
+
+            // 4ix. Get the polynomial orders of the master and the slave patch
+            pMaster = patchMaster->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
+            qMaster = patchMaster->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
+            pSlave = patchSlave->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
+            qSlave = patchSlave->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
+
+            // 4x. get the number of local basis functions for master and slave patch
+            noLocalBasisFctsMaster = (pMaster + 1)*(qMaster + 1);
+            noLocalBasisFctsSlave = (pSlave + 1)*(qSlave + 1);
+
+            // 4xi. get the number of the local DOFs for the master and slave patch
+            noDOFsLocMaster = noCoord*noLocalBasisFctsMaster;
+            noDOFsLocSlave = noCoord*noLocalBasisFctsSlave;
+
+            // 4xii. Get the arrays of the thread, they grow to the largest condition
+            BDisplacementsGCMasterArray.resize(noCoord*noDOFsLocMaster);
+            double* BDisplacementsGCMaster = &BDisplacementsGCMasterArray[0];
+            BDisplacementsGCSlaveArray.resize(noCoord*noDOFsLocSlave);
+            double* BDisplacementsGCSlave = &BDisplacementsGCSlaveArray[0];
+            BOperatorOmegaTMasterArray.resize(noDOFsLocMaster);
+            double* BOperatorOmegaTMaster = &BOperatorOmegaTMasterArray[0];
+            BOperatorOmegaTSlaveArray.resize(noDOFsLocSlave);
+            double* BOperatorOmegaTSlave = &BOperatorOmegaTSlaveArray[0];
+            BOperatorOmegaNMasterArray.resize(noDOFsLocMaster);
+            double* BOperatorOmegaNMaster = &BOperatorOmegaNMasterArray[0];
+            BOperatorOmegaNSlaveArray.resize(noDOFsLocSlave);
+            double* BOperatorOmegaNSlave = &BOperatorOmegaNSlaveArray[0];
+            KPenaltyDisplacementMasterArray.resize(noDOFsLocMaster*noDOFsLocMaster);
+            double* KPenaltyDisplacementMaster = &KPenaltyDisplacementMasterArray[0];
+            KPenaltyDisplacementSlaveArray.resize(noDOFsLocSlave*noDOFsLocSlave);
+            double* KPenaltyDisplacementSlave = &KPenaltyDisplacementSlaveArray[0];
+            CPenaltyDisplacementArray.resize(noDOFsLocMaster*noDOFsLocSlave);
+            double* CPenaltyDisplacement = &CPenaltyDisplacementArray[0];
+            KPenaltyBendingRotationMasterArray.resize(noDOFsLocMaster*noDOFsLocMaster);
+            double* KPenaltyBendingRotationMaster = &KPenaltyBendingRotationMasterArray[0];
+            KPenaltyBendingRotationSlaveArray.resize(noDOFsLocSlave*noDOFsLocSlave);
+            double* KPenaltyBendingRotationSlave = &KPenaltyBendingRotationSlaveArray[0];
+            CPenaltyBendingRotationArray.resize(noDOFsLocMaster*noDOFsLocSlave);
+            double* CPenaltyBendingRotation = &CPenaltyBendingRotationArray[0];
+            KPenaltyTwistingRotationMasterArray.resize(noDOFsLocMaster*noDOFsLocMaster);
+            double* KPenaltyTwistingRotationMaster = &KPenaltyTwistingRotationMasterArray[0];
+            KPenaltyTwistingRotationSlaveArray.resize(noDOFsLocSlave*noDOFsLocSlave);
+            double* KPenaltyTwistingRotationSlave = &KPenaltyTwistingRotationSlaveArray[0];
+            CPenaltyTwistingRotationArray.resize(noDOFsLocMaster*noDOFsLocSlave);
+            double* CPenaltyTwistingRotation = &CPenaltyTwistingRotationArray[0];
+
+            // 4xiii. Loop over all the Gauss Points of the given condition
+            for(int iGP = 0; iGP < noGPsOnContCond; iGP++){
+                // 4xiii.1. Get the parametric coordinates of the Gauss Point on the master patch
+                uGPMaster = trCurveMasterGPs[iGP*noCoordParam];
+                vGPMaster = trCurveMasterGPs[iGP*noCoordParam + 1];
+
+                // 4xiii.2. Get the parametric coordinates of the Gauss Point on the slave patch
+                uGPSlave = trCurveSlaveGPs[iGP*noCoordParam];
+                vGPSlave = trCurveSlaveGPs[iGP*noCoordParam + 1];
+
+                // 4xiii.3. Find the knot span indices of the Gauss point locations in the parameter space of the master patch
+                uKnotSpanMaster = patchMaster->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGPMaster);
+                vKnotSpanMaster = patchMaster->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGPMaster);
+
+                // 4xiii.4. Find the knot span indices of the Gauss point locations in the parameter space of the slave patch
+                uKnotSpanSlave = patchSlave->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGPSlave);
+                vKnotSpanSlave = patchSlave->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGPSlave);
+
+                // 4xiii.5. Get the tangent to the boundary vector on the master and the slave patch
+                for(int iCoord = 0; iCoord < noCoord; iCoord++){
+                    tangentTrCurveVctMaster[iCoord] = trCurveMasterGPTangents[iGP*noCoord + iCoord];
+                    tangentTrCurveVctSlave[iCoord] = trCurveSlaveGPTangents[iGP*noCoord + iCoord];
+                }
 
-            // 3xiii.15. Check if the angle between the tangent vectors is 0° (have the same direction cos(phi) = 1) or 180° (have opposite directions cos(phi) = - 1) to formulate the interface constraint
-            if (abs(cosPhiTangents - 1) < sqrt(tolAngle)) {
-                factorTangent = - 1.0;
-            } else if (abs(cosPhiTangents + 1) < sqrt(tolAngle)) {
-                factorTangent = + 1.0;
-            } else {
-                assert(false);
-            }
+                // 4xiii.6. Compute elementLength on GP. The weight is already included in variable trCurveGPJacobianProducts
+                elementLengthOnGP = trCurveGPJacobianProducts[iGP];
+
+                // 4xiii.7. Compute the B-operator matrices needed for the computation of the patch weak continuity contributions at the master patch
+                computeDisplacementAndRotationBOperatorMatrices(BDisplacementsGCMaster, BOperatorOmegaTMaster, BOperatorOmegaNMaster, normalTrCurveVctMaster,
+                                                                surfaceNormalVctMaster, patchMaster, tangentTrCurveVctMaster, uGPMaster, vGPMaster, uKnotSpanMaster,
+                                                                vKnotSpanMaster);
+
+                // 4xiii.8. Compute the B-operator matrices needed for the computation of the patch weak continuity contributions at the slave patch
+                computeDisplacementAndRotationBOperatorMatrices(BDisplacementsGCSlave, BOperatorOmegaTSlave, BOperatorOmegaNSlave, normalTrCurveVctSlave,
+                                                                surfaceNormalVctSlave, patchSlave, tangentTrCurveVctSlave, uGPSlave, vGPSlave, uKnotSpanSlave,
+                                                                vKnotSpanSlave);
+
+                // 4xiii.9. Compute the local penalty factor for scaling the rotational contributions
+                if (propWeakPatchContinuityConditions.isSecBendingCoupled) {
+                    normBOperatorOmegaTMaster = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaTMaster, noDOFsLocMaster);
+                    alphaLocal = normBOperatorOmegaTMaster;
+                    normBOperatorOmegaTSlave = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaTSlave, noDOFsLocSlave);
+                    if (normBOperatorOmegaTSlave > alphaLocal)
+                        alphaLocal = normBOperatorOmegaTSlave;
+                } else
+                    alphaLocal = - 1.0;
+
+                if (propWeakPatchContinuityConditions.isSecTwistingCoupled) {
+                    normBOperatorOmegaNMaster = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaNMaster, noDOFsLocMaster);
+                    if (normBOperatorOmegaNMaster > alphaLocal)
+                        alphaLocal = normBOperatorOmegaNMaster;
+                    normBOperatorOmegaNSlave = EMPIRE::MathLibrary::vector2norm(BOperatorOmegaNSlave, noDOFsLocSlave);
+                    if (normBOperatorOmegaNSlave > alphaLocal)
+                        alphaLocal = normBOperatorOmegaNSlave;
+                }
+                alphaLocal = 1.0/abs(alphaLocal);
+
+                // 4xiii.10. Scale the B-operator matrices
+                EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaTMaster, alphaLocal, noDOFsLocMaster);
+                EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaNMaster, alphaLocal, noDOFsLocMaster);
+                EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaTSlave, alphaLocal, noDOFsLocSlave);
+                EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(BOperatorOmegaNSlave, alphaLocal, noDOFsLocSlave);
+
+                // 4xiii.11. Compute the angle of the surface normal vectors
+                normSurfaceNormalVctMaster = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(surfaceNormalVctMaster, surfaceNormalVctMaster);
+                normSurfaceNormalVctMaster = sqrt(normSurfaceNormalVctMaster);
+                normSurfaceNormalVctSlave = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(surfaceNormalVctSlave, surfaceNormalVctSlave);
+                normSurfaceNormalVctSlave = sqrt(normSurfaceNormalVctSlave);
+                cosPhiSurfaceNormals = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(surfaceNormalVctMaster, surfaceNormalVctSlave);
+                cosPhiSurfaceNormals = cosPhiSurfaceNormals/(normSurfaceNormalVctMaster*normSurfaceNormalVctSlave);
+
+                // 4xiii.12. Determine the alignment of the tangent vectors from both patches at their common interface
+                normTangentTrCurveVctMaster = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(tangentTrCurveVctMaster,tangentTrCurveVctMaster);
+                normTangentTrCurveVctMaster = sqrt(normTangentTrCurveVctMaster);
+                normTangentTrCurveVctSlave = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(tangentTrCurveVctSlave,tangentTrCurveVctSlave);
+                normTangentTrCurveVctSlave = sqrt(normTangentTrCurveVctSlave);
+                cosPhiTangents = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(tangentTrCurveVctMaster,tangentTrCurveVctSlave);
+                cosPhiTangents = cosPhiTangents/(normTangentTrCurveVctMaster*normTangentTrCurveVctSlave);
+
+                // 4xiii.13. Check if the tangent vectors at the coupled trimming curves are zero and if yes go to the next Gauss point
+                if(normTangentTrCurveVctMaster < tolVct && normTangentTrCurveVctSlave < tolVct)
+                    continue;
+                else if((normTangentTrCurveVctMaster < tolVct && normTangentTrCurveVctSlave > tolVct) || (normTangentTrCurveVctMaster > tolVct && normTangentTrCurveVctSlave < tolVct))
+                    assert(false);
 
-            // 3xiii.16. Determine the alignment of the normal vectors from both patches at their common interface
-            normNormalTrCurveVctMaster = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,normalTrCurveVctMaster,normalTrCurveVctMaster);
-            normNormalTrCurveVctMaster = sqrt(normNormalTrCurveVctMaster);
-            normNormalTrCurveVctSlave = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,normalTrCurveVctSlave,normalTrCurveVctSlave);
-            normNormalTrCurveVctSlave = sqrt(normNormalTrCurveVctSlave);
-            cosPhiNormals = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,normalTrCurveVctMaster,normalTrCurveVctSlave);
-            cosPhiNormals = cosPhiTangents/(normNormalTrCurveVctMaster*normNormalTrCurveVctSlave);
+                // 4xiii.14. Check if the tangent vectors are aligned and if not assert error
+                condAligned = cosPhiTangents*cosPhiTangents - 1;
+                if (abs(condAligned) > tolAngle) {
+                    INFO_OUT() << "Found boundaries for which the tangent vectors are not aligned with angle = " << cosPhiTangents << endl;
+                }
+                assert(abs(condAligned) < tolAngle);
 
-            // 3xiii.17. Check if the normal vectors at the coupled trimming curves are zero and if yes go to the next Gauss point
-            if(normNormalTrCurveVctMaster < tolVct && normNormalTrCurveVctSlave < tolVct)
-                continue;
-            else if((normNormalTrCurveVctMaster < tolVct && normNormalTrCurveVctSlave > tolVct) || (normNormalTrCurveVctMaster > tolVct && normNormalTrCurveVctSlave < tolVct))
-                assert(false);
+                // 4xiii.15. Check if the angle between the tangent vectors is 0° (have the same direction cos(phi) = 1) or 180° (have opposite directions cos(phi) = - 1) to formulate the interface constraint
+                if (abs(cosPhiTangents - 1) < sqrt(tolAngle)) {
+                    factorTangent = - 1.0;
+                } else if (abs(cosPhiTangents + 1) < sqrt(tolAngle)) {
+                    factorTangent = + 1.0;
+                } else {
+                    assert(false);
+                }
 
-            // 3xiii.18. Check if the boundary normal vectors have an angle of [0,90]U[270,360] meaning the the vectors are in the positive quadrant or [90,270] meaning that the vectors are in the negative quadrant
-            if (cosPhiNormals >= 0)
-                factorNormal = + 1.0;
-            else
-                factorNormal = - 1.0;
-            factorNormal *= - 1.0;
+                // 4xiii.16. Determine the alignment of the normal vectors from both patches at their common interface
+                normNormalTrCurveVctMaster = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(normalTrCurveVctMaster,normalTrCurveVctMaster);
+                normNormalTrCurveVctMaster = sqrt(normNormalTrCurveVctMaster);
+                normNormalTrCurveVctSlave = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(normalTrCurveVctSlave,normalTrCurveVctSlave);
+                normNormalTrCurveVctSlave = sqrt(normNormalTrCurveVctSlave);
+                cosPhiNormals = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(normalTrCurveVctMaster,normalTrCurveVctSlave);
+                cosPhiNormals = cosPhiTangents/(normNormalTrCurveVctMaster*normNormalTrCurveVctSlave);
 
-            // Check whether the surface normal vectors have an angle of [0,90]U[270,360] meaning the the patches have the same normal orientation or [90,270] meaning that the patches have opossite normal orientation
-//            if (cosPhiSurfaceNormals < 0.0) {
-//                factorTangent = (-1.0)*factorTangent;
-//                factorNormal = (-1.0)*factorNormal;
-//            }
+                // 4xiii.17. Check if the normal vectors at the coupled trimming curves are zero and if yes go to the next Gauss point
+                if(normNormalTrCurveVctMaster < tolVct && normNormalTrCurveVctSlave < tolVct)
+                    continue;
+                else if((normNormalTrCurveVctMaster < tolVct && normNormalTrCurveVctSlave > tolVct) || (normNormalTrCurveVctMaster > tolVct && normNormalTrCurveVctSlave < tolVct))
+                    assert(false);
 
-            // 3xiii.19. Compute the dual product matrices for the displacements
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLocMaster,noDOFsLocMaster,BDisplacementsGCMaster,BDisplacementsGCMaster,KPenaltyDisplacementMaster);
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLocSlave,noDOFsLocSlave,BDisplacementsGCSlave,BDisplacementsGCSlave,KPenaltyDisplacementSlave);
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLocMaster,noDOFsLocSlave,BDisplacementsGCMaster,BDisplacementsGCSlave,CPenaltyDisplacement);
-
-            // 3xiii.20. Compute the dual product matrices for the bending rotations
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocMaster, noDOFsLocMaster ,BOperatorOmegaTMaster, BOperatorOmegaTMaster, KPenaltyBendingRotationMaster);
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocSlave, noDOFsLocSlave, BOperatorOmegaTSlave, BOperatorOmegaTSlave, KPenaltyBendingRotationSlave);
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocMaster, noDOFsLocSlave, BOperatorOmegaTMaster, BOperatorOmegaTSlave,CPenaltyBendingRotation);
-
-            // 3xiii.21. Compute the dual product matrices for the twisting rotations
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocMaster, noDOFsLocMaster ,BOperatorOmegaNMaster, BOperatorOmegaNMaster, KPenaltyTwistingRotationMaster);
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocSlave, noDOFsLocSlave, BOperatorOmegaNSlave, BOperatorOmegaNSlave, KPenaltyTwistingRotationSlave);
-            EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocMaster, noDOFsLocSlave, BOperatorOmegaNMaster, BOperatorOmegaNSlave,CPenaltyTwistingRotation);
-
-            // 3xiii.22. Compute the element index tables for the master and slave patch
-            int CPIndexMaster[noLocalBasisFctsMaster];
-            int CPIndexSlave[noLocalBasisFctsSlave];
-            patchMaster->getIGABasis()->getBasisFunctionsIndex(uKnotSpanMaster, vKnotSpanMaster, CPIndexMaster);
-            patchSlave->getIGABasis()->getBasisFunctionsIndex(uKnotSpanSlave, vKnotSpanSlave, CPIndexSlave);
-
-            // 3xiii.23. Compute the element freedom tables for the master and the slave patch
-            int EFTMaster[noDOFsLocMaster];
-            counter = 0;
-            for (int i = 0; i < noLocalBasisFctsMaster ; i++){
-                indexCP = patchMaster->getControlPointNet()[CPIndexMaster[i]]->getDofIndex();
-                for (int j = 0; j < noCoord; j++){
-                    EFTMaster[counter] = noCoord*indexCP + j;
-                    counter++;
+                // 4xiii.18. Check if the boundary normal vectors have an angle of [0,90]U[270,360] meaning the the vectors are in the positive quadrant or [90,270] meaning that the vectors are in the negative quadrant
+                if (cosPhiNormals >= 0)
+                    factorNormal = + 1.0;
+                else
+                    factorNormal = - 1.0;
+                factorNormal *= - 1.0;
+
+                // Check whether the surface normal vectors have an angle of [0,90]U[270,360] meaning the the patches have the same normal orientation or [90,270] meaning that the patches have opossite normal orientation
+    //            if (cosPhiSurfaceNormals < 0.0) {
+    //                factorTangent = (-1.0)*factorTangent;
+    //                factorNormal = (-1.0)*factorNormal;
+    //            }
+
+                // 4xiii.19. Compute the dual product matrices for the displacements
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLocMaster,noDOFsLocMaster,BDisplacementsGCMaster,BDisplacementsGCMaster,KPenaltyDisplacementMaster);
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLocSlave,noDOFsLocSlave,BDisplacementsGCSlave,BDisplacementsGCSlave,KPenaltyDisplacementSlave);
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(noCoord,noDOFsLocMaster,noDOFsLocSlave,BDisplacementsGCMaster,BDisplacementsGCSlave,CPenaltyDisplacement);
+
+                // 4xiii.20. Compute the dual product matrices for the bending rotations
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocMaster, noDOFsLocMaster ,BOperatorOmegaTMaster, BOperatorOmegaTMaster, KPenaltyBendingRotationMaster);
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocSlave, noDOFsLocSlave, BOperatorOmegaTSlave, BOperatorOmegaTSlave, KPenaltyBendingRotationSlave);
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocMaster, noDOFsLocSlave, BOperatorOmegaTMaster, BOperatorOmegaTSlave,CPenaltyBendingRotation);
+
+                // 4xiii.21. Compute the dual product matrices for the twisting rotations
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocMaster, noDOFsLocMaster ,BOperatorOmegaNMaster, BOperatorOmegaNMaster, KPenaltyTwistingRotationMaster);
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocSlave, noDOFsLocSlave, BOperatorOmegaNSlave, BOperatorOmegaNSlave, KPenaltyTwistingRotationSlave);
+                EMPIRE::MathLibrary::computeTransposeMatrixProduct(1, noDOFsLocMaster, noDOFsLocSlave, BOperatorOmegaNMaster, BOperatorOmegaNSlave,CPenaltyTwistingRotation);
+
+                // 4xiii.22. Compute the element index tables for the master and slave patch
+                int CPIndexMaster[noLocalBasisFctsMaster];
+                int CPIndexSlave[noLocalBasisFctsSlave];
+                patchMaster->getIGABasis()->getBasisFunctionsIndex(uKnotSpanMaster, vKnotSpanMaster, CPIndexMaster);
+                patchSlave->getIGABasis()->getBasisFunctionsIndex(uKnotSpanSlave, vKnotSpanSlave, CPIndexSlave);
+
+                // 4xiii.23. Compute the element freedom tables for the master and the slave patch
+                int EFTMaster[noDOFsLocMaster];
+                counter = 0;
+                for (int i = 0; i < noLocalBasisFctsMaster ; i++){
+                    indexCP = patchMaster->getControlPointNet()[CPIndexMaster[i]]->getDofIndex();
+                    for (int j = 0; j < noCoord; j++){
+                        EFTMaster[counter] = noCoord*indexCP + j;
+                        counter++;
+                    }
                 }
-            }
-            counter = 0;
-            int EFTSlave[noDOFsLocSlave];
-            for (int i = 0; i < noLocalBasisFctsSlave ; i++){
-                indexCP = patchSlave->getControlPointNet()[CPIndexSlave[i]]->getDofIndex();
-                for (int j = 0; j < noCoord; j++){
-                    EFTSlave[counter] = noCoord*indexCP + j;
-                    counter++;
+                counter = 0;
+                int EFTSlave[noDOFsLocSlave];
+                for (int i = 0; i < noLocalBasisFctsSlave ; i++){
+                    indexCP = patchSlave->getControlPointNet()[CPIndexSlave[i]]->getDofIndex();
+                    for (int j = 0; j < noCoord; j++){
+                        EFTSlave[counter] = noCoord*indexCP + j;
+                        counter++;
+                    }
                 }
-            }
 
-            // 3xiii.24. Loop over all DOFs of the master patch to assemble KPenaltyDisplacementMaster to the global coupling matrix CNN
-            for(int i = 0; i < noDOFsLocMaster; i++){
-                for(int j = 0; j < noDOFsLocMaster; j++){
-                    // 3xiii.24i. Assemble the displacement coupling entries
-                    if (propWeakPatchContinuityConditions.isPrimCoupled)
-                        couplingMatrices->addCNNValue(EFTMaster[i], EFTMaster[j], alphaPrimary*KPenaltyDisplacementMaster[i*noDOFsLocMaster + j]*elementLengthOnGP);
+                // 4xiii.24. Loop over all DOFs of the master patch to assemble KPenaltyDisplacementMaster to the global coupling matrix CNN
+                for(int i = 0; i < noDOFsLocMaster; i++){
+                    for(int j = 0; j < noDOFsLocMaster; j++){
+                        // 4xiii.24i. Assemble the displacement coupling entries
+                        if (propWeakPatchContinuityConditions.isPrimCoupled)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTMaster[i], EFTMaster[j], alphaPrimary*KPenaltyDisplacementMaster[i*noDOFsLocMaster + j]*elementLengthOnGP);
 
-                    // 3xiii.24ii. Assemble the bending rotation coupling entries
-                    if (propWeakPatchContinuityConditions.isSecBendingCoupled)
-                        couplingMatrices->addCNNValue(EFTMaster[i], EFTMaster[j], alphaSecondaryBending*KPenaltyBendingRotationMaster[i*noDOFsLocMaster + j]*elementLengthOnGP);
+                        // 4xiii.24ii. Assemble the bending rotation coupling entries
+                        if (propWeakPatchContinuityConditions.isSecBendingCoupled)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTMaster[i], EFTMaster[j], alphaSecondaryBending*KPenaltyBendingRotationMaster[i*noDOFsLocMaster + j]*elementLengthOnGP);
 
-                    // 3xiii.24iii. Assemble the twisting rotation coupling entries
-                    if (propWeakPatchContinuityConditions.isSecTwistingCoupled)
-                        couplingMatrices->addCNNValue(EFTMaster[i], EFTMaster[j], alphaSecondaryTwisting*KPenaltyTwistingRotationMaster[i*noDOFsLocMaster + j]*elementLengthOnGP);
+                        // 4xiii.24iii. Assemble the twisting rotation coupling entries
+                        if (propWeakPatchContinuityConditions.isSecTwistingCoupled)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTMaster[i], EFTMaster[j], alphaSecondaryTwisting*KPenaltyTwistingRotationMaster[i*noDOFsLocMaster + j]*elementLengthOnGP);
+                    }
                 }
-            }
 
-            // 3xiii.25. Loop over all DOFs of the slave patch to assemble KPenaltyDisplacementSlave to the global coupling matrix CNN
-            for(int i = 0; i < noDOFsLocSlave; i++){
-                for(int j = 0; j < noDOFsLocSlave; j++) {
-                    // 3xiii.25i. Assemble the displacement coupling entries
-                    if (propWeakPatchContinuityConditions.isPrimCoupled)
-                        couplingMatrices->addCNNValue(EFTSlave[i], EFTSlave[j], alphaPrimary*KPenaltyDisplacementSlave[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                // 4xiii.25. Loop over all DOFs of the slave patch to assemble KPenaltyDisplacementSlave to the global coupling matrix CNN
+                for(int i = 0; i < noDOFsLocSlave; i++){
+                    for(int j = 0; j < noDOFsLocSlave; j++) {
+                        // 4xiii.25i. Assemble the displacement coupling entries
+                        if (propWeakPatchContinuityConditions.isPrimCoupled)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTSlave[i], EFTSlave[j], alphaPrimary*KPenaltyDisplacementSlave[i*noDOFsLocSlave + j]*elementLengthOnGP);
 
-                    // 3xiii.25ii. Assemble the bending rotation coupling entries
-                    if (propWeakPatchContinuityConditions.isSecBendingCoupled)
-                        couplingMatrices->addCNNValue(EFTSlave[i], EFTSlave[j], alphaSecondaryBending*KPenaltyBendingRotationSlave[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                        // 4xiii.25ii. Assemble the bending rotation coupling entries
+                        if (propWeakPatchContinuityConditions.isSecBendingCoupled)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTSlave[i], EFTSlave[j], alphaSecondaryBending*KPenaltyBendingRotationSlave[i*noDOFsLocSlave + j]*elementLengthOnGP);
 
-                    // 3xiii.25iii. Assemble the twisting rotation coupling entries
-                    if (propWeakPatchContinuityConditions.isSecTwistingCoupled)
-                        couplingMatrices->addCNNValue(EFTSlave[i], EFTSlave[j], alphaSecondaryTwisting*KPenaltyTwistingRotationSlave[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                        // 4xiii.25iii. Assemble the twisting rotation coupling entries
+                        if (propWeakPatchContinuityConditions.isSecTwistingCoupled)
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTSlave[i], EFTSlave[j], alphaSecondaryTwisting*KPenaltyTwistingRotationSlave[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                    }
                 }
-            }
 
-            // 3xiii.26. Loop over all DOFs of the master/slave patches to assemble CPenaltyDisplacement to the global coupling matrix CNN
-            for(int i = 0; i < noDOFsLocMaster; i++){
-                for(int j = 0; j < noDOFsLocSlave; j++){
-                    // 3xiii.26i. Assemble the displacement coupling entries
-                    if (propWeakPatchContinuityConditions.isPrimCoupled) {
-                        couplingMatrices->addCNNValue(EFTMaster[i], EFTSlave[j], alphaPrimary*(-1.0)*CPenaltyDisplacement[i*noDOFsLocSlave + j]*elementLengthOnGP);
-                        couplingMatrices->addCNNValue(EFTSlave[j], EFTMaster[i], alphaPrimary*(-1.0)*CPenaltyDisplacement[i*noDOFsLocSlave + j]*elementLengthOnGP);
-                    }
+                // 4xiii.26. Loop over all DOFs of the master/slave patches to assemble CPenaltyDisplacement to the global coupling matrix CNN
+                for(int i = 0; i < noDOFsLocMaster; i++){
+                    for(int j = 0; j < noDOFsLocSlave; j++){
+                        // 4xiii.26i. Assemble the displacement coupling entries
+                        if (propWeakPatchContinuityConditions.isPrimCoupled) {
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTMaster[i], EFTSlave[j], alphaPrimary*(-1.0)*CPenaltyDisplacement[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTSlave[j], EFTMaster[i], alphaPrimary*(-1.0)*CPenaltyDisplacement[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                        }
 
-                    // 3xiii.26ii. Assemble the bending rotation coupling entries
-                    if (propWeakPatchContinuityConditions.isSecBendingCoupled) {
-                        couplingMatrices->addCNNValue(EFTMaster[i], EFTSlave[j], alphaSecondaryBending*factorTangent*CPenaltyBendingRotation[i*noDOFsLocSlave + j]*elementLengthOnGP);
-                        couplingMatrices->addCNNValue(EFTSlave[j], EFTMaster[i], alphaSecondaryBending*factorTangent*CPenaltyBendingRotation[i*noDOFsLocSlave + j]*elementLengthOnGP);
-                    }
+                        // 4xiii.26ii. Assemble the bending rotation coupling entries
+                        if (propWeakPatchContinuityConditions.isSecBendingCoupled) {
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTMaster[i], EFTSlave[j], alphaSecondaryBending*factorTangent*CPenaltyBendingRotation[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTSlave[j], EFTMaster[i], alphaSecondaryBending*factorTangent*CPenaltyBendingRotation[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                        }
 
-                    // 3xiii.26iii. Assemble the twisting rotation coupling entries
-                    if (propWeakPatchContinuityConditions.isSecTwistingCoupled) {
-                        couplingMatrices->addCNNValue(EFTMaster[i], EFTSlave[j], alphaSecondaryTwisting*factorNormal*CPenaltyTwistingRotation[i*noDOFsLocSlave + j]*elementLengthOnGP);
-                        couplingMatrices->addCNNValue(EFTSlave[j], EFTMaster[i], alphaSecondaryTwisting*factorNormal*CPenaltyTwistingRotation[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                        // 4xiii.26iii. Assemble the twisting rotation coupling entries
+                        if (propWeakPatchContinuityConditions.isSecTwistingCoupled) {
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTMaster[i], EFTSlave[j], alphaSecondaryTwisting*factorNormal*CPenaltyTwistingRotation[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                            couplingMatrices->addCNNValueToBuffer(buffer, EFTSlave[j], EFTMaster[i], alphaSecondaryTwisting*factorNormal*CPenaltyTwistingRotation[i*noDOFsLocSlave + j]*elementLengthOnGP);
+                        }
                     }
                 }
-            }
 
-            // 3xiii.27. Save the Gauss point data for further computation of the error in the L2 norm
-            if(propErrorComputation.isInterfaceError){
-                // Initialize variable storing the Gauss Point data
-                std::vector<double> streamInterfaceGP;
+                // 4xiii.27. Save the Gauss point data for further computation of the error in the L2 norm
+                if(propErrorComputation.isInterfaceError){
+                    // Initialize variable storing the Gauss Point data
+                    std::vector<double> streamInterfaceGP;
 
-                // elementLengthOnGP + noBasisFuncsI + (#indexCP, basisFuncValueI,...) + (#indexDOF, BtValueI, BnValueI,...) + noBasisFuncsJ + (#indexCP, basisFuncValueJ,...) + (#indexDOF, BtValueJ, BnValueJ,...) + factorTangent + factorNormal
-                streamInterfaceGP.reserve(1 + 1 + 2*noLocalBasisFctsMaster + 3*noDOFsLocMaster + 1 + 2*noLocalBasisFctsSlave + 3*noDOFsLocSlave + 1 + 1);
+                    // elementLengthOnGP + noBasisFuncsI + (#indexCP, basisFuncValueI,...) + (#indexDOF, BtValueI, BnValueI,...) + noBasisFuncsJ + (#indexCP, basisFuncValueJ,...) + (#indexDOF, BtValueJ, BnValueJ,...) + factorTangent + factorNormal
+                    streamInterfaceGP.reserve(1 + 1 + 2*noLocalBasisFctsMaster + 3*noDOFsLocMaster + 1 + 2*noLocalBasisFctsSlave + 3*noDOFsLocSlave + 1 + 1);
 
-                // Save the element length on the Gauss Point
-                streamInterfaceGP.push_back(elementLengthOnGP);
+                    // Save the element length on the Gauss Point
+                    streamInterfaceGP.push_back(elementLengthOnGP);
 
-                // Save the number of basis functions of the master patch
-                streamInterfaceGP.push_back(noLocalBasisFctsMaster);
+                    // Save the number of basis functions of the master patch
+                    streamInterfaceGP.push_back(noLocalBasisFctsMaster);
 
-                // Save the Control Point index and the basis function's values of the master patch
-                for(int iBFs = 0; iBFs < noLocalBasisFctsMaster; iBFs++){
-                    indexCP = patchMaster->getControlPointNet()[CPIndexMaster[iBFs]]->getDofIndex();
-                    streamInterfaceGP.push_back(indexCP);
-                    streamInterfaceGP.push_back(BDisplacementsGCMaster[0*noLocalBasisFctsMaster + 3*iBFs]);
-                }
+                    // Save the Control Point index and the basis function's values of the master patch
+                    for(int iBFs = 0; iBFs < noLocalBasisFctsMaster; iBFs++){
+                        indexCP = patchMaster->getControlPointNet()[CPIndexMaster[iBFs]]->getDofIndex();
+                        streamInterfaceGP.push_back(indexCP);
+                        streamInterfaceGP.push_back(BDisplacementsGCMaster[0*noLocalBasisFctsMaster + 3*iBFs]);
+                    }
 
-                // Save the DOF index and the bending and twisting B-operator values of the master patch
-                for(int iDOFs = 0; iDOFs < noDOFsLocMaster; iDOFs++){
-                    streamInterfaceGP.push_back(EFTMaster[iDOFs]);
-                    streamInterfaceGP.push_back(BOperatorOmegaTMaster[iDOFs]);
-                    streamInterfaceGP.push_back(BOperatorOmegaNMaster[iDOFs]);
-                }
+                    // Save the DOF index and the bending and twisting B-operator values of the master patch
+                    for(int iDOFs = 0; iDOFs < noDOFsLocMaster; iDOFs++){
+                        streamInterfaceGP.push_back(EFTMaster[iDOFs]);
+                        streamInterfaceGP.push_back(BOperatorOmegaTMaster[iDOFs]);
+                        streamInterfaceGP.push_back(BOperatorOmegaNMaster[iDOFs]);
+                    }
 
-                // Save the number of basis functions of the slave patch
-                streamInterfaceGP.push_back(noLocalBasisFctsSlave);
+                    // Save the number of basis functions of the slave patch
+                    streamInterfaceGP.push_back(noLocalBasisFctsSlave);
 
-                // Save the Control Point index and the basis function's values of the slave patch
-                for(int iBFs = 0; iBFs < noLocalBasisFctsSlave; iBFs++){
-                    indexCP = patchSlave->getControlPointNet()[CPIndexSlave[iBFs]]->getDofIndex();
-                    streamInterfaceGP.push_back(indexCP);
-                    streamInterfaceGP.push_back(BDisplacementsGCSlave[0*noLocalBasisFctsSlave + 3*iBFs]);
-                }
+                    // Save the Control Point index and the basis function's values of the slave patch
+                    for(int iBFs = 0; iBFs < noLocalBasisFctsSlave; iBFs++){
+                        indexCP = patchSlave->getControlPointNet()[CPIndexSlave[iBFs]]->getDofIndex();
+                        streamInterfaceGP.push_back(indexCP);
+                        streamInterfaceGP.push_back(BDisplacementsGCSlave[0*noLocalBasisFctsSlave + 3*iBFs]);
+                    }
 
-                // Save the DOF index and the bending and twisting B-operator values of the slave patch
-                for(int iDOFs = 0; iDOFs < noDOFsLocSlave; iDOFs++){
-                    streamInterfaceGP.push_back(EFTSlave[iDOFs]);
-                    streamInterfaceGP.push_back(BOperatorOmegaTSlave[iDOFs]);
-                    streamInterfaceGP.push_back(BOperatorOmegaNSlave[iDOFs]);
+                    // Save the DOF index and the bending and twisting B-operator values of the slave patch
+                    for(int iDOFs = 0; iDOFs < noDOFsLocSlave; iDOFs++){
+                        streamInterfaceGP.push_back(EFTSlave[iDOFs]);
+                        streamInterfaceGP.push_back(BOperatorOmegaTSlave[iDOFs]);
+                        streamInterfaceGP.push_back(BOperatorOmegaNSlave[iDOFs]);
+                    }
+
+                    // Save the factors
+                    streamInterfaceGP.push_back(factorTangent);
+                    streamInterfaceGP.push_back(factorNormal);
+
+                    // Push back the Gauss Point values into the member variable
+                    streamInterfaceGPsOfConditions[iWCC].push_back(streamInterfaceGP);
                 }
+                // Keep the memory of the buffer bounded
+                couplingMatrices->flushBufferIfFull(buffer);
+            } // End of Gauss Point loop
 
-                // Save the factors
-                streamInterfaceGP.push_back(factorTangent);
-                streamInterfaceGP.push_back(factorNormal);
+            progress.add();
+        } // End of weak continuity condition loop
+    }
+    progress.finish();
 
-                // Push back the Gauss Point values into the member variable
-                streamInterfaceGPs.push_back(streamInterfaceGP);
-            }
-        } // End of Gauss Point loop
-
-        // 3xiv. Delete pointers
-        delete[] BDisplacementsGCMaster;
-        delete[] BDisplacementsGCSlave;
-        delete[] BOperatorOmegaTMaster;
-        delete[] BOperatorOmegaTSlave;
-        delete[] BOperatorOmegaNMaster;
-        delete[] BOperatorOmegaNSlave;
-        delete[] KPenaltyDisplacementMaster;
-        delete[] KPenaltyDisplacementSlave;
-        delete[] CPenaltyDisplacement;
-        delete[] KPenaltyBendingRotationMaster;
-        delete[] KPenaltyBendingRotationSlave;
-        delete[] CPenaltyBendingRotation;
-        delete[] KPenaltyTwistingRotationMaster;
-        delete[] KPenaltyTwistingRotationSlave;
-        delete[] CPenaltyTwistingRotation;
-    } // End of weak continuity condition loop
+    // 5. Merge the contributions of all threads and append the Gauss point streams in the order of the conditions
+    couplingMatrices->assembleBuffers(mapperSetNumThreads);
+    for (int iCond = 0; iCond < streamInterfaceGPsOfConditions.size(); iCond++)
+        streamInterfaceGPs.insert(streamInterfaceGPs.end(), streamInterfaceGPsOfConditions[iCond].begin(), streamInterfaceGPsOfConditions[iCond].end());
 }
 
 void IGAMortarMapper::computeDisplacementAndRotationBOperatorMatrices(double* _BDisplacementsGC, double* _BOperatorOmegaT,
@@ -3721,8 +4686,6 @@ void IGAMortarMapper::computeDisplacementAndRotationBOperatorMatrices(double* _B
      * 11. Compute the curvature tensor in the contravariant basis
      *
      * 12. Compute the B-operator matrices for the rotation vector
-     *
-     * 13. Delete pointers
      */
 
     // 1. Initialize auxiliary arrays
@@ -3747,18 +4710,18 @@ void IGAMortarMapper::computeDisplacementAndRotationBOperatorMatrices(double* _B
     int q = _patch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
     int noLocalBasisFcts = (p + 1)*(q + 1);
     int noDOFsLoc = noCoord*noLocalBasisFcts;
-    double* basisFctsAndDerivs = new double[(derivDegreeBasis + 1) * (derivDegreeBasis + 2)
-            * noLocalBasisFcts / 2];
-    double* baseVctsAndDerivs = new double[(derivDegreeBaseVec + 1)
-            * (derivDegreeBaseVec + 2) * noCoord * noBaseVec / 2];
-    double* BdDisplacementsdUGC = new double[noCoord*noDOFsLoc];
-    double* BdDisplacementsdVGC = new double[noCoord*noDOFsLoc];
-    double* commonBOperator1 = new double[noParametricCoord*noDOFsLoc];
-    double* commonBOperator2Part1 = new double[noDOFsLoc];
-    double* commonBOperator2Part2 = new double[noDOFsLoc];
-    double* commonBOperator2 = new double[noParametricCoord*noDOFsLoc];
-    double* commonBOperator3 = new double[noParametricCoord*noDOFsLoc];
-    double* commonBOperator = new double[noParametricCoord*noDOFsLoc];
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * SCRATCH_SIZE_2D> basisFctsAndDerivs(
+            (derivDegreeBasis + 1) * (derivDegreeBasis + 2) * noLocalBasisFcts / 2);
+    ScratchArray<double, SCRATCH_NO_DERIVS_2D * 3 * 2> baseVctsAndDerivs(
+            (derivDegreeBaseVec + 1) * (derivDegreeBaseVec + 2) * noCoord * noBaseVec / 2);
+    ScratchArray<double, 3 * 3 * SCRATCH_SIZE_2D> BdDisplacementsdUGC(noCoord*noDOFsLoc);
+    ScratchArray<double, 3 * 3 * SCRATCH_SIZE_2D> BdDisplacementsdVGC(noCoord*noDOFsLoc);
+    ScratchArray<double, 2 * 3 * SCRATCH_SIZE_2D> commonBOperator1(noParametricCoord*noDOFsLoc);
+    ScratchArray<double, 3 * SCRATCH_SIZE_2D> commonBOperator2Part1(noDOFsLoc);
+    ScratchArray<double, 3 * SCRATCH_SIZE_2D> commonBOperator2Part2(noDOFsLoc);
+    ScratchArray<double, 2 * 3 * SCRATCH_SIZE_2D> commonBOperator2(noParametricCoord*noDOFsLoc);
+    ScratchArray<double, 2 * 3 * SCRATCH_SIZE_2D> commonBOperator3(noParametricCoord*noDOFsLoc);
+    ScratchArray<double, 2 * 3 * SCRATCH_SIZE_2D> commonBOperator(noParametricCoord*noDOFsLoc);
 
     // 2. Compute the basis functions and their derivatives
     _patch->getIGABasis()->computeLocalBasisFunctionsAndDerivatives(basisFctsAndDerivs, derivDegreeBasis, _u, _uKnotSpan,
@@ -3810,8 +4773,8 @@ void IGAMortarMapper::computeDisplacementAndRotationBOperatorMatrices(double* _B
     for(int iCov = 0; iCov < noParametricCoord; iCov++){
         for (int iCoord = 0; iCoord < noCoord; iCoord++)
             contravariantBaseVct[iCoord] = contravariantBaseVcts[noCoord*iCov + iCoord];
-        tangentTrCurveVctCov[iCov] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,contravariantBaseVct,_tangentTrCurveVct);
-        normalTrCurveVctCov[iCov] = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord,contravariantBaseVct,_normalTrCurveVct);
+        tangentTrCurveVctCov[iCov] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(contravariantBaseVct,_tangentTrCurveVct);
+        normalTrCurveVctCov[iCov] = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(contravariantBaseVct,_normalTrCurveVct);
     }
 
     // 11. Compute the curvature tensor in the contravariant basis
@@ -3832,21 +4795,9 @@ void IGAMortarMapper::computeDisplacementAndRotationBOperatorMatrices(double* _B
     EMPIRE::MathLibrary::computeMatrixProduct(noParametricCoord, noCoord, noDOFsLoc, BabTimesContravariantBaseVct, _BDisplacementsGC, commonBOperator3);
     for(int i = 0; i < noParametricCoord*noDOFsLoc; i++)
         commonBOperator[i] = commonBOperator1[i] + commonBOperator2[i] + commonBOperator3[i];
-    EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar(normalTrCurveVctCov, -1.0, noCoord);
+    EMPIRE::MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(normalTrCurveVctCov, -1.0);
     EMPIRE::MathLibrary::computeTransposeMatrixProduct(noParametricCoord, 1, noDOFsLoc, normalTrCurveVctCov, commonBOperator, _BOperatorOmegaT);
     EMPIRE::MathLibrary::computeTransposeMatrixProduct(noParametricCoord, 1, noDOFsLoc, tangentTrCurveVctCov, commonBOperator, _BOperatorOmegaN);
-
-    // 13. Delete pointers
-    delete[] basisFctsAndDerivs;
-    delete[] baseVctsAndDerivs;
-    delete[] BdDisplacementsdUGC;
-    delete[] BdDisplacementsdVGC;
-    delete[] commonBOperator1;
-    delete[] commonBOperator2Part1;
-    delete[] commonBOperator2Part2;
-    delete[] commonBOperator2;
-    delete[] commonBOperator3;
-    delete[] commonBOperator;
 }
 
 void IGAMortarMapper::computePenaltyParametersForWeakDirichletCurveConditions(std::string _filename){
@@ -3858,11 +4809,11 @@ void IGAMortarMapper::computePenaltyParametersForWeakDirichletCurveConditions(st
      *
      * 1. Initialize a file stream to write out the Penalty parameters
      *
-     * 2. Initialize auxiliary arrays
+     * 2. Get the weak patch continuity conditions
      *
-     * 3. Get the weak patch continuity conditions
+     * 3. Initialize the auxiliary arrays of every thread
      *
-     * 4. Loop over all the conditions for the application of weak continuity across patch interfaces
+     * 4. Loop over all the conditions for the application of weak continuity across patch interfaces in parallel
      * ->
      *    4i. Check if penalty factors are to be assigned manually in the xml file
      *   4ii. Get the index of the patch
@@ -3888,10 +4839,9 @@ void IGAMortarMapper::computePenaltyParametersForWeakDirichletCurveConditions(st
      *  <-
      *   4xv. Check the element sizes for the last elements
      *  4xvi. Compute correspondingly the penalty factors
-     * 4xvii. Write the Penalty parameters into a file
      * <-
      *
-     * 5. Close file
+     * 5. Write the Penalty parameters into a file in the order of the conditions and close it
      */
 
     // 1. Initialize a file stream to write out the Penalty parameters
@@ -3902,139 +4852,146 @@ void IGAMortarMapper::computePenaltyParametersForWeakDirichletCurveConditions(st
         ofs << std::endl;
     }
 
-    // 2. Initialize auxiliary arrays
-    const int noCoord = 3;
-    bool isElementChanged;
-    int patchIndex;
-    int p;
-    int q;
-    int pMax;
-    int noLocalBasisFcts;
-    int noDOFsLoc;
-    int noGPsOnCond;
-    int uKnotSpan;
-    int vKnotSpan;
-    int uKnotSpanSaved;
-    int vKnotSpanSaved;
-    double uGP;
-    double vGP;
-    double elEdgeSize;
-    double minElEdgeSize;
-    double alphaPrim;
-    double alphaSec;
-    double* curveGPs;
-    double* curveGPWeights;
-    double* curveGPTangents;
-    double* curveGPJacobianProducts;
-    IGAPatchSurface* thePatch;
-
-    // 3. Get the weak patch continuity conditions
+    // 2. Get the weak patch continuity conditions
     std::vector<WeakIGADirichletCurveCondition*> weakIGADirichletCurveConditions = meshIGA->getWeakIGADirichletCurveConditions();
 
-    // 4. Loop over all the conditions for the application of weak continuity across patch interfaces
-    for (int iWDCC = 0; iWDCC < weakIGADirichletCurveConditions.size(); iWDCC++){
-        // 4i. Check if penalty factors are to be assigned manually in the xml file
-        if(!propWeakCurveDirichletConditions.isAutomaticPenaltyParameters){
-            weakDirichletCCAlphaPrimary[iWDCC] = propWeakCurveDirichletConditions.alphaPrim;
-            weakDirichletCCAlphaSecondaryBending[iWDCC] = propWeakCurveDirichletConditions.alphaSecBending;
-            weakDirichletCCAlphaSecondaryTwisting[iWDCC] = propWeakCurveDirichletConditions.alphaSecTwisting;
-            continue;
-        }
-
-        // 4ii. Get the index of the patch
-        patchIndex = weakIGADirichletCurveConditions[iWDCC]->getPatchIndex();
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        // 3. Initialize the auxiliary arrays of the thread
+        const int noCoord = 3;
+        bool isElementChanged;
+        int patchIndex;
+        int p;
+        int q;
+        int pMax;
+        int noLocalBasisFcts;
+        int noDOFsLoc;
+        int noGPsOnCond;
+        int uKnotSpan;
+        int vKnotSpan;
+        int uKnotSpanSaved;
+        int vKnotSpanSaved;
+        double uGP;
+        double vGP;
+        double elEdgeSize;
+        double minElEdgeSize;
+        double alphaPrim;
+        double alphaSec;
+        double* curveGPs;
+        double* curveGPWeights;
+        double* curveGPTangents;
+        double* curveGPJacobianProducts;
+        IGAPatchSurface* thePatch;
+
+        // 4. Loop over all the conditions for the application of weak continuity across patch interfaces
+#pragma omp for schedule(dynamic, 1)
+        for (int iWDCC = 0; iWDCC < weakIGADirichletCurveConditions.size(); iWDCC++){
+            // 4i. Check if penalty factors are to be assigned manually in the xml file
+            if(!propWeakCurveDirichletConditions.isAutomaticPenaltyParameters){
+                weakDirichletCCAlphaPrimary[iWDCC] = propWeakCurveDirichletConditions.alphaPrim;
+                weakDirichletCCAlphaSecondaryBending[iWDCC] = propWeakCurveDirichletConditions.alphaSecBending;
+                weakDirichletCCAlphaSecondaryTwisting[iWDCC] = propWeakCurveDirichletConditions.alphaSecTwisting;
+                continue;
+            }
 
-        // 4iii. Get the number of Gauss Points for the given condition
-        noGPsOnCond = weakIGADirichletCurveConditions[iWDCC]->getCurveNumGP();
+            // 4ii. Get the index of the patch
+            patchIndex = weakIGADirichletCurveConditions[iWDCC]->getPatchIndex();
 
-        // 4iv. Get the parametric coordinates of the Gauss Points
-        curveGPs = weakIGADirichletCurveConditions[iWDCC]->getCurveGPs();
+            // 4iii. Get the number of Gauss Points for the given condition
+            noGPsOnCond = weakIGADirichletCurveConditions[iWDCC]->getCurveNumGP();
 
-        // 4v. Get the corresponding Gauss weights
-        curveGPWeights = weakIGADirichletCurveConditions[iWDCC]->getCurveGPWeights();
+            // 4iv. Get the parametric coordinates of the Gauss Points
+            curveGPs = weakIGADirichletCurveConditions[iWDCC]->getCurveGPs();
 
-        // 4vi. Get the tangent vectors at the curve of the given condition in the Cartesian space
-        curveGPTangents = weakIGADirichletCurveConditions[iWDCC]->getCurveGPTangents();
+            // 4v. Get the corresponding Gauss weights
+            curveGPWeights = weakIGADirichletCurveConditions[iWDCC]->getCurveGPWeights();
 
-        // 4vii. Get the product of the Jacobian transformations
-        curveGPJacobianProducts = weakIGADirichletCurveConditions[iWDCC]->getCurveGPJacobianProducts();
+            // 4vi. Get the tangent vectors at the curve of the given condition in the Cartesian space
+            curveGPTangents = weakIGADirichletCurveConditions[iWDCC]->getCurveGPTangents();
 
-        // 4viii. Get the master and the slave patch
-        thePatch = meshIGA->getSurfacePatch(patchIndex);
+            // 4vii. Get the product of the Jacobian transformations
+            curveGPJacobianProducts = weakIGADirichletCurveConditions[iWDCC]->getCurveGPJacobianProducts();
 
-        // 4ix. Get the polynomial orders of the patch
-        p = thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
-        q = thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
-        pMax = std::max(p, q);
+            // 4viii. Get the master and the slave patch
+            thePatch = meshIGA->getSurfacePatch(patchIndex);
 
-        // 4x. Get the number of local basis functions for the patch
-        noLocalBasisFcts = (p + 1)*(q + 1);
+            // 4ix. Get the polynomial orders of the patch
+            p = thePatch->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
+            q = thePatch->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
+            pMax = std::max(p, q);
 
-        // 4xi. Get the number of the local DOFs for the patch
-        noDOFsLoc = noCoord*noLocalBasisFcts;
+            // 4x. Get the number of local basis functions for the patch
+            noLocalBasisFcts = (p + 1)*(q + 1);
 
-        // 4xii. Initialize flags on whether an element has been changed while looping over the Gauss Points
-        isElementChanged = false;
+            // 4xi. Get the number of the local DOFs for the patch
+            noDOFsLoc = noCoord*noLocalBasisFcts;
 
-        // 4xiii. Initialize the element edge sizes
-        elEdgeSize = 0.0;
-        minElEdgeSize = std::numeric_limits<double>::max();
+            // 4xii. Initialize flags on whether an element has been changed while looping over the Gauss Points
+            isElementChanged = false;
 
-        // 4xiv. Loop over all the Gauss Points of the given condition
-        for(int iGP = 0; iGP < noGPsOnCond; iGP++){
-            // 4xiv.1. Get the parametric coordinates of the Gauss Point on the patch
-            uGP = curveGPs[2*iGP];
-            vGP = curveGPs[2*iGP + 1];
+            // 4xiii. Initialize the element edge sizes
+            elEdgeSize = 0.0;
+            minElEdgeSize = std::numeric_limits<double>::max();
 
-            // 4xiv.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
-            uKnotSpan = thePatch->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGP);
-            vKnotSpan = thePatch->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGP);
+            // 4xiv. Loop over all the Gauss Points of the given condition
+            for(int iGP = 0; iGP < noGPsOnCond; iGP++){
+                // 4xiv.1. Get the parametric coordinates of the Gauss Point on the patch
+                uGP = curveGPs[2*iGP];
+                vGP = curveGPs[2*iGP + 1];
 
-            // 4xiv.3. Initialize the saved knot span indices
-            if(iGP == 0){
-                uKnotSpanSaved = uKnotSpan;
-                vKnotSpanSaved = vKnotSpan;
-            }
+                // 4xiv.2. Find the knot span indices of the Gauss point locations in the parameter space of the patch
+                uKnotSpan = thePatch->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGP);
+                vKnotSpan = thePatch->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGP);
 
-            // 4xiv.4. Initialize element edge sizes if an element has been crossed
-            if(uKnotSpan != uKnotSpanSaved || vKnotSpan != vKnotSpanSaved){
-                if(elEdgeSize < minElEdgeSize)
-                    minElEdgeSize = elEdgeSize;
-                elEdgeSize = 0.0;
-            }
+                // 4xiv.3. Initialize the saved knot span indices
+                if(iGP == 0){
+                    uKnotSpanSaved = uKnotSpan;
+                    vKnotSpanSaved = vKnotSpan;
+                }
 
-            // 4xiv.5. Add the contribution from the Gauss Point to the element edge sizes
-            elEdgeSize += curveGPJacobianProducts[iGP];
+                // 4xiv.4. Initialize element edge sizes if an element has been crossed
+                if(uKnotSpan != uKnotSpanSaved || vKnotSpan != vKnotSpanSaved){
+                    if(elEdgeSize < minElEdgeSize)
+                        minElEdgeSize = elEdgeSize;
+                    elEdgeSize = 0.0;
+                }
 
-            // 4xiv.6. Save the knot span indices
-            uKnotSpanSaved = uKnotSpan;
-            vKnotSpanSaved = vKnotSpan;
+                // 4xiv.5. Add the contribution from the Gauss Point to the element edge sizes
+                elEdgeSize += curveGPJacobianProducts[iGP];
 
-        } // End of Gauss Point loop
+                // 4xiv.6. Save the knot span indices
+                uKnotSpanSaved = uKnotSpan;
+                vKnotSpanSaved = vKnotSpan;
 
-        // 4xv. Check the element sizes for the last elements
-        if(elEdgeSize < minElEdgeSize)
-            minElEdgeSize = elEdgeSize;
-        if (minElEdgeSize < minElEdgeSizeDirichlet)
-            minElEdgeSizeDirichlet = minElEdgeSize;
+            } // End of Gauss Point loop
 
-        // 4xvi. Compute correspondingly the penalty factors
-        alphaPrim = pMax/minElEdgeSize;
-        alphaSec = pMax/sqrt(minElEdgeSize);
-        weakDirichletCCAlphaPrimary[iWDCC] = alphaPrim;
-        weakDirichletCCAlphaSecondaryBending[iWDCC] = alphaPrim;
+            // 4xv. Check the element sizes for the last elements
+            if(elEdgeSize < minElEdgeSize)
+                minElEdgeSize = elEdgeSize;
+#pragma omp critical (IGAMortarMapperMinElEdgeSize)
+            {
+                if (minElEdgeSize < minElEdgeSizeDirichlet)
+                    minElEdgeSizeDirichlet = minElEdgeSize;
+            }
 
-        // 4xvii. Write the Penalty parameters into a file
-        if (!_filename.empty()) {
-            ofs << "Weak Dirichlet curve condition on patch[" << patchIndex << "] :" << std::endl;
-            ofs << "weakDirichletCCAlpha[" << iWDCC << "] = " << scientific << setprecision(15) << alphaPrim << std::endl;
-            ofs << std::endl;
-        }
-    } // End of weak Dirichlet curve condition loop
+            // 4xvi. Compute correspondingly the penalty factors
+            alphaPrim = pMax/minElEdgeSize;
+            alphaSec = pMax/sqrt(minElEdgeSize);
+            weakDirichletCCAlphaPrimary[iWDCC] = alphaPrim;
+            weakDirichletCCAlphaSecondaryBending[iWDCC] = alphaPrim;
+        } // End of weak Dirichlet curve condition loop
+    }
 
-    // 5. Close file
-    if (!_filename.empty())
+    // 5. Write the Penalty parameters into a file in the order of the conditions and close it
+    if (!_filename.empty()) {
+        if (propWeakCurveDirichletConditions.isAutomaticPenaltyParameters)
+            for (int iWDCC = 0; iWDCC < weakIGADirichletCurveConditions.size(); iWDCC++){
+                ofs << "Weak Dirichlet curve condition on patch[" << weakIGADirichletCurveConditions[iWDCC]->getPatchIndex() << "] :" << std::endl;
+                ofs << "weakDirichletCCAlpha[" << iWDCC << "] = " << scientific << setprecision(15) << weakDirichletCCAlphaPrimary[iWDCC] << std::endl;
+                ofs << std::endl;
+            }
         ofs.close();
+    }
 }
 
 void IGAMortarMapper::computePenaltyParametersForWeakDirichletSurfaceConditions(){
@@ -4070,11 +5027,11 @@ void IGAMortarMapper::computePenaltyParametersForPatchContinuityConditions(std::
      *
      * 1. Initialize a file stream to write out the Penalty parameters
      *
-     * 2. Initialize auxiliary variables
+     * 2. Get the weak patch continuity conditions
      *
-     * 3. Get the weak patch continuity conditions
+     * 3. Initialize the auxiliary variables of every thread
      *
-     * 4. Loop over all the conditions for the application of weak continuity across patch interfaces
+     * 4. Loop over all the conditions for the application of weak continuity across patch interfaces in parallel
      * ->
      *    4i. Check if penalty factors are to be assigned manually in the xml file
      *   4ii. Get the index of the master and slave patches
@@ -4106,7 +5063,7 @@ void IGAMortarMapper::computePenaltyParametersForPatchContinuityConditions(std::
      *4xviii. Write the Penalty parameters into a file
      * <-
      *
-     * 5. Close file
+     * 5. Write the Penalty parameters into a file in the order of the conditions and close it
      */
 
     // 1. Initialize a file stream to write out the Penalty parameters
@@ -4117,202 +5074,210 @@ void IGAMortarMapper::computePenaltyParametersForPatchContinuityConditions(std::
         ofs << std::endl;
     }
 
-    // 2. Initialize auxiliary variables
-    const int noCoord = 3;
-    bool isElementMasterChanged;
-    bool isElementSlaveChanged;
-    int indexMaster;
-    int indexSlave;
-    int pMaster;
-    int qMaster;
-    int pSlave;
-    int qSlave;
-    int pMaxMaster;
-    int pMaxSlave;
-    int pMax;
-    int noLocalBasisFctsMaster;
-    int noLocalBasisFctsSlave;
-    int noDOFsLocMaster;
-    int noDOFsLocSlave;
-    int noGPsOnContCond;
-    int uKnotSpanMaster;
-    int uKnotSpanSlave;
-    int vKnotSpanMaster;
-    int vKnotSpanSlave;
-    int uKnotSpanMasterSaved;
-    int uKnotSpanSlaveSaved;
-    int vKnotSpanMasterSaved;
-    int vKnotSpanSlaveSaved;
-    double uGPMaster;
-    double vGPMaster;
-    double uGPSlave;
-    double vGPSlave;
-    double elEdgeSizeMaster;
-    double elEdgeSizeSlave;
-    double minElEdgeSizeMaster;
-    double minElEdgeSizeSlave;
-    double minElEdgeSize;
-    double alphaBar;
-    double* trCurveMasterGPs;
-    double* trCurveSlaveGPs;
-    double* trCurveGPWeights;
-    double* trCurveMasterGPTangents;
-    double* trCurveSlaveGPTangents;
-    double* trCurveGPJacobianProducts;
-    IGAPatchSurface* patchMaster;
-    IGAPatchSurface* patchSlave;
-
-    // 3. Get the weak patch continuity conditions
+    // 2. Get the weak patch continuity conditions
     std::vector<WeakIGAPatchContinuityCondition*> weakIGAPatchContinuityConditions = meshIGA->getWeakIGAPatchContinuityConditions();
 
-    // 4. Loop over all the conditions for the application of weak continuity across patch interfaces
-    for (int iWCC = 0; iWCC < weakIGAPatchContinuityConditions.size(); iWCC++){
-        // 4i. Check if penalty factors are to be assigned manually in the xml file
-        if(!propWeakPatchContinuityConditions.isAutomaticPenaltyParameters){
-            weakPatchContinuityAlphaPrimaryIJ[iWCC] = propWeakPatchContinuityConditions.alphaPrim;
-            weakPatchContinuityAlphaSecondaryBendingIJ[iWCC] = propWeakPatchContinuityConditions.alphaSecBending;
-            weakPatchContinuityAlphaSecondaryTwistingIJ[iWCC] = propWeakPatchContinuityConditions.alphaSecTwisting;
-            continue;
-        }
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        // 3. Initialize the auxiliary variables of the thread
+        const int noCoord = 3;
+        bool isElementMasterChanged;
+        bool isElementSlaveChanged;
+        int indexMaster;
+        int indexSlave;
+        int pMaster;
+        int qMaster;
+        int pSlave;
+        int qSlave;
+        int pMaxMaster;
+        int pMaxSlave;
+        int pMax;
+        int noLocalBasisFctsMaster;
+        int noLocalBasisFctsSlave;
+        int noDOFsLocMaster;
+        int noDOFsLocSlave;
+        int noGPsOnContCond;
+        int uKnotSpanMaster;
+        int uKnotSpanSlave;
+        int vKnotSpanMaster;
+        int vKnotSpanSlave;
+        int uKnotSpanMasterSaved;
+        int uKnotSpanSlaveSaved;
+        int vKnotSpanMasterSaved;
+        int vKnotSpanSlaveSaved;
+        double uGPMaster;
+        double vGPMaster;
+        double uGPSlave;
+        double vGPSlave;
+        double elEdgeSizeMaster;
+        double elEdgeSizeSlave;
+        double minElEdgeSizeMaster;
+        double minElEdgeSizeSlave;
+        double minElEdgeSize;
+        double alphaBar;
+        double* trCurveMasterGPs;
+        double* trCurveSlaveGPs;
+        double* trCurveGPWeights;
+        double* trCurveMasterGPTangents;
+        double* trCurveSlaveGPTangents;
+        double* trCurveGPJacobianProducts;
+        IGAPatchSurface* patchMaster;
+        IGAPatchSurface* patchSlave;
+
+        // 4. Loop over all the conditions for the application of weak continuity across patch interfaces
+#pragma omp for schedule(dynamic, 1)
+        for (int iWCC = 0; iWCC < weakIGAPatchContinuityConditions.size(); iWCC++){
+            // 4i. Check if penalty factors are to be assigned manually in the xml file
+            if(!propWeakPatchContinuityConditions.isAutomaticPenaltyParameters){
+                weakPatchContinuityAlphaPrimaryIJ[iWCC] = propWeakPatchContinuityConditions.alphaPrim;
+                weakPatchContinuityAlphaSecondaryBendingIJ[iWCC] = propWeakPatchContinuityConditions.alphaSecBending;
+                weakPatchContinuityAlphaSecondaryTwistingIJ[iWCC] = propWeakPatchContinuityConditions.alphaSecTwisting;
+                continue;
+            }
 
-        // 4ii. Get the index of the master and slave patches
-        indexMaster = weakIGAPatchContinuityConditions[iWCC]->getMasterPatchIndex();
-        indexSlave = weakIGAPatchContinuityConditions[iWCC]->getSlavePatchIndex();
-
-        // 4iii. Get the number of Gauss Points for the given condition
-        noGPsOnContCond = weakIGAPatchContinuityConditions[iWCC]->getTrCurveNumGP();
-
-        // 4iv. Get the parametric coordinates of the Gauss Points
-        trCurveMasterGPs = weakIGAPatchContinuityConditions[iWCC]->getTrCurveMasterGPs();
-        trCurveSlaveGPs = weakIGAPatchContinuityConditions[iWCC]->getTrCurveSlaveGPs();
-
-        // 4v. Get the corresponding Gauss weights
-        trCurveGPWeights = weakIGAPatchContinuityConditions[iWCC]->getTrCurveGPWeights();
-
-        // 4vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
-        trCurveMasterGPTangents = weakIGAPatchContinuityConditions[iWCC]->getTrCurveMasterGPTangents();
-        trCurveSlaveGPTangents = weakIGAPatchContinuityConditions[iWCC]->getTrCurveSlaveGPTangents();
-
-        // 4vii. Get the product of the Jacobian transformations
-        trCurveGPJacobianProducts = weakIGAPatchContinuityConditions[iWCC]->getTrCurveGPJacobianProducts();
-
-        // 4viii. Get the master and the slave patch
-        patchMaster = meshIGA->getSurfacePatch(indexMaster);
-        patchSlave = meshIGA->getSurfacePatch(indexSlave);
-
-        // 4ix. Get the polynomial orders of the master and the slave patch
-        pMaster = patchMaster->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
-        qMaster = patchMaster->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
-        pSlave = patchSlave->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
-        qSlave = patchSlave->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
-        pMaxMaster = pMaster;
-        if(pMaxMaster < qMaster)
-            pMaxMaster = qMaster;
-        pMaxSlave = pSlave;
-        if(pMaxSlave < qSlave)
-            pMaxSlave = qSlave;
-        pMax = pMaxMaster;
-        if(pMaxMaster < pMaxSlave)
-            pMax = pMaxSlave;
-
-        // 4x. Get the number of local basis functions for master and slave patch
-        noLocalBasisFctsMaster = (pMaster + 1)*(qMaster + 1);
-        noLocalBasisFctsSlave = (pSlave + 1)*(qSlave + 1);
-
-        // 4xi. Get the number of the local DOFs for the master and slave patch
-        noDOFsLocMaster = noCoord*noLocalBasisFctsMaster;
-        noDOFsLocSlave = noCoord*noLocalBasisFctsSlave;
-
-        // 4xii. Initialize flags on whether an element has been changed while looping over the Gauss Points
-        isElementMasterChanged = false;
-        isElementSlaveChanged = false;
-
-        // 4xiii. Initialize the element edge sizes
-        elEdgeSizeMaster = 0.0;
-        elEdgeSizeSlave = 0.0;
-        minElEdgeSizeMaster = std::numeric_limits<double>::max();
-        minElEdgeSizeSlave = std::numeric_limits<double>::max();
-
-        // 4xiv. Loop over all the Gauss Points of the given condition
-        for(int iGP = 0; iGP < noGPsOnContCond; iGP++){
-            // 4xiv.1. Get the parametric coordinates of the Gauss Point on the master patch
-            uGPMaster = trCurveMasterGPs[2*iGP];
-            vGPMaster = trCurveMasterGPs[2*iGP + 1];
-
-            // 4xiv.2. Get the parametric coordinates of the Gauss Point on the slave patch
-            uGPSlave = trCurveSlaveGPs[2*iGP];
-            vGPSlave = trCurveSlaveGPs[2*iGP + 1];
-
-            // 4xiv.3. Find the knot span indices of the Gauss point locations in the parameter space of the master patch
-            uKnotSpanMaster = patchMaster->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGPMaster);
-            vKnotSpanMaster = patchMaster->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGPMaster);
-
-            // 4xiv.4. Find the knot span indices of the Gauss point locations in the parameter space of the slave patch
-            uKnotSpanSlave = patchSlave->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGPSlave);
-            vKnotSpanSlave = patchSlave->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGPSlave);
-
-            // 4xiv.5. Initialize the saved knot span indices
-            if(iGP == 0){
+            // 4ii. Get the index of the master and slave patches
+            indexMaster = weakIGAPatchContinuityConditions[iWCC]->getMasterPatchIndex();
+            indexSlave = weakIGAPatchContinuityConditions[iWCC]->getSlavePatchIndex();
+
+            // 4iii. Get the number of Gauss Points for the given condition
+            noGPsOnContCond = weakIGAPatchContinuityConditions[iWCC]->getTrCurveNumGP();
+
+            // 4iv. Get the parametric coordinates of the Gauss Points
+            trCurveMasterGPs = weakIGAPatchContinuityConditions[iWCC]->getTrCurveMasterGPs();
+            trCurveSlaveGPs = weakIGAPatchContinuityConditions[iWCC]->getTrCurveSlaveGPs();
+
+            // 4v. Get the corresponding Gauss weights
+            trCurveGPWeights = weakIGAPatchContinuityConditions[iWCC]->getTrCurveGPWeights();
+
+            // 4vi. Get the tangent vectors at the trimming curve of the given condition in the Cartesian space
+            trCurveMasterGPTangents = weakIGAPatchContinuityConditions[iWCC]->getTrCurveMasterGPTangents();
+            trCurveSlaveGPTangents = weakIGAPatchContinuityConditions[iWCC]->getTrCurveSlaveGPTangents();
+
+            // 4vii. Get the product of the Jacobian transformations
+            trCurveGPJacobianProducts = weakIGAPatchContinuityConditions[iWCC]->getTrCurveGPJacobianProducts();
+
+            // 4viii. Get the master and the slave patch
+            patchMaster = meshIGA->getSurfacePatch(indexMaster);
+            patchSlave = meshIGA->getSurfacePatch(indexSlave);
+
+            // 4ix. Get the polynomial orders of the master and the slave patch
+            pMaster = patchMaster->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
+            qMaster = patchMaster->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
+            pSlave = patchSlave->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree();
+            qSlave = patchSlave->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree();
+            pMaxMaster = pMaster;
+            if(pMaxMaster < qMaster)
+                pMaxMaster = qMaster;
+            pMaxSlave = pSlave;
+            if(pMaxSlave < qSlave)
+                pMaxSlave = qSlave;
+            pMax = pMaxMaster;
+            if(pMaxMaster < pMaxSlave)
+                pMax = pMaxSlave;
+
+            // 4x. Get the number of local basis functions for master and slave patch
+            noLocalBasisFctsMaster = (pMaster + 1)*(qMaster + 1);
+            noLocalBasisFctsSlave = (pSlave + 1)*(qSlave + 1);
+
+            // 4xi. Get the number of the local DOFs for the master and slave patch
+            noDOFsLocMaster = noCoord*noLocalBasisFctsMaster;
+            noDOFsLocSlave = noCoord*noLocalBasisFctsSlave;
+
+            // 4xii. Initialize flags on whether an element has been changed while looping over the Gauss Points
+            isElementMasterChanged = false;
+            isElementSlaveChanged = false;
+
+            // 4xiii. Initialize the element edge sizes
+            elEdgeSizeMaster = 0.0;
+            elEdgeSizeSlave = 0.0;
+            minElEdgeSizeMaster = std::numeric_limits<double>::max();
+            minElEdgeSizeSlave = std::numeric_limits<double>::max();
+
+            // 4xiv. Loop over all the Gauss Points of the given condition
+            for(int iGP = 0; iGP < noGPsOnContCond; iGP++){
+                // 4xiv.1. Get the parametric coordinates of the Gauss Point on the master patch
+                uGPMaster = trCurveMasterGPs[2*iGP];
+                vGPMaster = trCurveMasterGPs[2*iGP + 1];
+
+                // 4xiv.2. Get the parametric coordinates of the Gauss Point on the slave patch
+                uGPSlave = trCurveSlaveGPs[2*iGP];
+                vGPSlave = trCurveSlaveGPs[2*iGP + 1];
+
+                // 4xiv.3. Find the knot span indices of the Gauss point locations in the parameter space of the master patch
+                uKnotSpanMaster = patchMaster->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGPMaster);
+                vKnotSpanMaster = patchMaster->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGPMaster);
+
+                // 4xiv.4. Find the knot span indices of the Gauss point locations in the parameter space of the slave patch
+                uKnotSpanSlave = patchSlave->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(uGPSlave);
+                vKnotSpanSlave = patchSlave->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(vGPSlave);
+
+                // 4xiv.5. Initialize the saved knot span indices
+                if(iGP == 0){
+                    uKnotSpanMasterSaved = uKnotSpanMaster;
+                    vKnotSpanMasterSaved = vKnotSpanMaster;
+                    uKnotSpanSlaveSaved = uKnotSpanSlave;
+                    vKnotSpanSlaveSaved = vKnotSpanSlave;
+                }
+
+                // 4xiv.6. Initialize element edge sizes if an element has been crossed
+                if(uKnotSpanMaster != uKnotSpanMasterSaved || vKnotSpanMaster != vKnotSpanMasterSaved){
+                    if(elEdgeSizeMaster < minElEdgeSizeMaster)
+                        minElEdgeSizeMaster = elEdgeSizeMaster;
+                    elEdgeSizeMaster = 0.0;
+                }
+                if(uKnotSpanSlave != uKnotSpanSlaveSaved || vKnotSpanSlave != vKnotSpanSlaveSaved){
+                    if(elEdgeSizeSlave < minElEdgeSizeSlave)
+                        minElEdgeSizeSlave = elEdgeSizeSlave;
+                    elEdgeSizeSlave = 0.0;
+                }
+
+                // 4xiv.7. Add the contribution from the Gauss Point to the element edge sizes
+                elEdgeSizeMaster += trCurveGPJacobianProducts[iGP];
+                elEdgeSizeSlave += trCurveGPJacobianProducts[iGP];
+
+                // 4xiv.8. Save the knot span indices
                 uKnotSpanMasterSaved = uKnotSpanMaster;
                 vKnotSpanMasterSaved = vKnotSpanMaster;
                 uKnotSpanSlaveSaved = uKnotSpanSlave;
                 vKnotSpanSlaveSaved = vKnotSpanSlave;
+            } // End of Gauss Point loop
+
+            // 4xv. Check the element sizes for the last elements
+            if(elEdgeSizeMaster < minElEdgeSizeMaster)
+                minElEdgeSizeMaster = elEdgeSizeMaster;
+            if(elEdgeSizeSlave < minElEdgeSizeSlave)
+                minElEdgeSizeSlave = elEdgeSizeSlave;
+
+            // 4xvi. Get the minimum of the minimum element edge sizes between both patches
+            minElEdgeSize = minElEdgeSizeMaster;
+            if(minElEdgeSizeSlave < minElEdgeSize){
+                minElEdgeSize = minElEdgeSizeSlave;
             }
-
-            // 4xiv.6. Initialize element edge sizes if an element has been crossed
-            if(uKnotSpanMaster != uKnotSpanMasterSaved || vKnotSpanMaster != vKnotSpanMasterSaved){
-                if(elEdgeSizeMaster < minElEdgeSizeMaster)
-                    minElEdgeSizeMaster = elEdgeSizeMaster;
-                elEdgeSizeMaster = 0.0;
-            }
-            if(uKnotSpanSlave != uKnotSpanSlaveSaved || vKnotSpanSlave != vKnotSpanSlaveSaved){
-                if(elEdgeSizeSlave < minElEdgeSizeSlave)
-                    minElEdgeSizeSlave = elEdgeSizeSlave;
-                elEdgeSizeSlave = 0.0;
+#pragma omp critical (IGAMortarMapperMinElEdgeSize)
+            {
+                if (minElEdgeSize < minElEdgeSizeInterface)
+                    minElEdgeSizeInterface = minElEdgeSize;
             }
 
-            // 4xiv.7. Add the contribution from the Gauss Point to the element edge sizes
-            elEdgeSizeMaster += trCurveGPJacobianProducts[iGP];
-            elEdgeSizeSlave += trCurveGPJacobianProducts[iGP];
-
-            // 4xiv.8. Save the knot span indices
-            uKnotSpanMasterSaved = uKnotSpanMaster;
-            vKnotSpanMasterSaved = vKnotSpanMaster;
-            uKnotSpanSlaveSaved = uKnotSpanSlave;
-            vKnotSpanSlaveSaved = vKnotSpanSlave;
-        } // End of Gauss Point loop
-
-        // 4xv. Check the element sizes for the last elements
-        if(elEdgeSizeMaster < minElEdgeSizeMaster)
-            minElEdgeSizeMaster = elEdgeSizeMaster;
-        if(elEdgeSizeSlave < minElEdgeSizeSlave)
-            minElEdgeSizeSlave = elEdgeSizeSlave;
-
-        // 4xvi. Get the minimum of the minimum element edge sizes between both patches
-        minElEdgeSize = minElEdgeSizeMaster;
-        if(minElEdgeSizeSlave < minElEdgeSize){
-            minElEdgeSize = minElEdgeSizeSlave;
-        }
-        if (minElEdgeSize < minElEdgeSizeInterface)
-            minElEdgeSizeInterface = minElEdgeSize;
-
-        // 4xvii. Compute correspondingly the penalty factors
-        alphaBar = pMax/minElEdgeSize;
-        weakPatchContinuityAlphaPrimaryIJ[iWCC] = alphaBar;
-        weakPatchContinuityAlphaSecondaryBendingIJ[iWCC] = alphaBar;
-        weakPatchContinuityAlphaSecondaryTwistingIJ[iWCC] = alphaBar;
-
-        // 4xviii. Write the Penalty parameters into a file
-        if (!_filename.empty()) {
-            ofs << "Coupling between patch[" << indexMaster << "] and patch[" << indexSlave << "]:" << std::endl;
-            ofs << "weakPatchContinuityAlphaPrimaryIJ[" << iWCC << "] = " << scientific << setprecision(15)  << alphaBar << std::endl;
-            ofs << std::endl;
-        }
-    } // End of weak continuity condition loop
+            // 4xvii. Compute correspondingly the penalty factors
+            alphaBar = pMax/minElEdgeSize;
+            weakPatchContinuityAlphaPrimaryIJ[iWCC] = alphaBar;
+            weakPatchContinuityAlphaSecondaryBendingIJ[iWCC] = alphaBar;
+            weakPatchContinuityAlphaSecondaryTwistingIJ[iWCC] = alphaBar;
+        } // End of weak continuity condition loop
+    }
 
-    // 5. Close file
-    if (!_filename.empty())
+    // 5. Write the Penalty parameters into a file in the order of the conditions and close it
+    if (!_filename.empty()) {
+        if (propWeakPatchContinuityConditions.isAutomaticPenaltyParameters)
+            for (int iWCC = 0; iWCC < weakIGAPatchContinuityConditions.size(); iWCC++){
+                ofs << "Coupling between patch[" << weakIGAPatchContinuityConditions[iWCC]->getMasterPatchIndex() << "] and patch["
+                    << weakIGAPatchContinuityConditions[iWCC]->getSlavePatchIndex() << "]:" << std::endl;
+                ofs << "weakPatchContinuityAlphaPrimaryIJ[" << iWCC << "] = " << scientific << setprecision(15)  << weakPatchContinuityAlphaPrimaryIJ[iWCC] << std::endl;
+                ofs << std::endl;
+            }
         ofs.close();
+    }
 }
 
 void IGAMortarMapper::consistentMapping(const double* _slaveField, double *_masterField) {
@@ -4336,10 +5301,22 @@ void IGAMortarMapper::consistentMapping(const double* _slaveField, double *_mast
     double* tmpVec = new double[size_N]();
 
     // 2. Compute the right hand side of the isogeometric mortar-based mapping method, C_NR * x_slave = tmpVec
-    couplingMatrices->getCnr()->mulitplyVec(false,const_cast<double *>(_slaveField), tmpVec, size_N);
+    {
+        PROFILER_SCOPE("SpMV");
+        couplingMatrices->multiplyCnr(_slaveField, tmpVec);
+    }
 
     // 3. Solve for the master field using the isogeometric mortar-based mapping method, Cnn * x_master = tmpVec
-    couplingMatrices->getCnn()->solve(_masterField, tmpVec);
+    //    A reordered Cnn is solved in its order, the previous field is the initial guess of the iterative solver
+    PROFILER_SCOPE("solve");
+    if (couplingMatrices->isReordered()) {
+        double* reorderedField = new double[size_N];
+        couplingMatrices->toReorderedField(_masterField, reorderedField);
+        couplingMatrices->getCnn()->solve(reorderedField, tmpVec);
+        couplingMatrices->fromReorderedField(reorderedField, _masterField);
+        delete[] reorderedField;
+    } else
+        couplingMatrices->getCnn()->solve(_masterField, tmpVec);
 
     // 4. Delete pointers
     delete[] tmpVec;
@@ -4367,18 +5344,104 @@ void IGAMortarMapper::conservativeMapping(const double* _masterField, double *_s
 
     // 1. Initialize auxiliary arrays
     int size_N = couplingMatrices->getSizeN();
-    double* tmpVec = new double[size_N];
+    double* tmpVec = new double[size_N]();
 
     // 2. Compute the transformation matrix corresponding to the isogeometric mortar-based mapping
-    couplingMatrices->getCnn()->solve(tmpVec, const_cast<double *>(_masterField));
+    //    The rows of a reordered Cnr are in the order of Cnn, so only the master field is reordered.
+    //    The transposed solve reuses the factorization of the consistent mapping
+    {
+        PROFILER_SCOPE("solve");
+        if (couplingMatrices->isReordered()) {
+            double* reorderedField = new double[size_N];
+            couplingMatrices->toReorderedField(_masterField, reorderedField);
+            couplingMatrices->getCnn()->solveTranspose(tmpVec, reorderedField);
+            delete[] reorderedField;
+        } else
+            couplingMatrices->getCnn()->solveTranspose(tmpVec, const_cast<double *>(_masterField));
+    }
 
     // 3. Tranpose multiply the right-hand side with the mortar tranformation matrix
-    couplingMatrices->getCnr()->transposeMulitplyVec(tmpVec, _slaveField, size_N);
+    {
+        PROFILER_SCOPE("SpMV");
+        couplingMatrices->transposeMultiplyCnr(tmpVec, _slaveField);
+    }
 
     // 4. Delete pointers
     delete[] tmpVec;
 }
 
+void IGAMortarMapper::mapBothDirections(const double *_slaveField, double *_masterField,
+        const double *_masterIntegralField, double *_slaveIntegralField, int numComponents) {
+    /*
+     * Cnn is symmetric, so the consistent and the conservative mapping solve with the same matrix,
+     *
+     * Cnn * [x_master, tmpVec] = [Cnr * x_slave, f_master]
+     * f_slave = Cnr^T * tmpVec
+     *
+     * Function layout:
+     *
+     * 1. Initialize auxiliary arrays
+     *
+     * 2. Interleave the right hand sides and the initial guesses in the order of Cnn
+     *
+     * 3. Solve for both right hand sides at once
+     *
+     * 4. Take the master field and tranpose multiply the second solution with Cnr
+     *
+     * 5. Delete pointers
+     */
+    assert(numComponents == 1);
+
+    // 1. Initialize auxiliary arrays, only the free unknowns are solved for
+    int size_N = couplingMatrices->getSizeN();
+    int numFree = couplingMatrices->getNumFree();
+    double* tmpVec = new double[size_N]();
+    double* masterField = new double[size_N];
+    double* masterIntegralField = new double[size_N];
+    double* rhs = new double[2 * size_N];
+    double* sol = new double[2 * size_N];
+
+    // 2. Interleave the right hand sides and the initial guesses in the order of Cnn
+    couplingMatrices->multiplyCnr(_slaveField, tmpVec);
+    if (couplingMatrices->isReordered()) {
+        couplingMatrices->toReorderedField(_masterField, masterField);
+        couplingMatrices->toReorderedField(_masterIntegralField, masterIntegralField);
+    } else {
+        for (int i = 0; i < size_N; i++) {
+            masterField[i] = _masterField[i];
+            masterIntegralField[i] = _masterIntegralField[i];
+        }
+    }
+    for (int i = 0; i < numFree; i++) {
+        rhs[2 * i] = tmpVec[i];
+        rhs[2 * i + 1] = masterIntegralField[i];
+        sol[2 * i] = masterField[i];
+        sol[2 * i + 1] = 0.0;
+    }
+
+    // 3. Solve for both right hand sides at once
+    couplingMatrices->getCnn()->solveBlock(sol, rhs, 2);
+
+    // 4. Take the master field and tranpose multiply the second solution with Cnr
+    for (int i = 0; i < numFree; i++) {
+        masterField[i] = sol[2 * i];
+        tmpVec[i] = sol[2 * i + 1];
+    }
+    if (couplingMatrices->isReordered())
+        couplingMatrices->fromReorderedField(masterField, _masterField);
+    else
+        for (int i = 0; i < size_N; i++)
+            _masterField[i] = masterField[i];
+    couplingMatrices->transposeMultiplyCnr(tmpVec, _slaveIntegralField);
+
+    // 5. Delete pointers
+    delete[] tmpVec;
+    delete[] masterField;
+    delete[] masterIntegralField;
+    delete[] rhs;
+    delete[] sol;
+}
+
 void IGAMortarMapper::computeErrorsConsistentMapping(const double* _slaveField, const double *_masterField) {
     /*
      * Computes the domain, interface and boundary errors corresponding to the isogeometric mortar-based mapping
@@ -4434,6 +5497,11 @@ double IGAMortarMapper::computeDomainErrorInL2Norm4ConsistentMapping(const doubl
      *
      * weight + jacobian + nShapeFuncsFE + (#dof, shapefuncValue,...) + nShapeFuncsIGA + (#dof, shapefuncValue,...)
      *
+     * or, if propErrorComputation.isCompactStorage, in the arrays of compactStreamGPs which are read with a cursor each,
+     *
+     * indices: nShapeFuncsFE + (#dof,...) + nShapeFuncsIGA + (#dof,...)
+     * values: weight*jacobian + (shapefuncValue,...) + (shapefuncValue,...) + cartesianCoordinatesGP
+     *
      * Function layout:
      *
      * 1. Initialize auxiliary arrays
@@ -4486,8 +5554,12 @@ double IGAMortarMapper::computeDomainErrorInL2Norm4ConsistentMapping(const doubl
     int noCPsIGA;
     int indexNode;
     int indexCP;
-    int noCoord = 3;
+    const int noCoord = 3;
     double tolNormSlaveField = 1e-6;
+    bool isCompact = propErrorComputation.isCompactStorage;
+    int noGPs = isCompact ? compactStreamGPs.numGPs : streamGPs.size();
+    const int *indices = isCompact && !compactStreamGPs.indices.empty() ? &compactStreamGPs.indices[0] : NULL;
+    const float *values = isCompact && !compactStreamGPs.values.empty() ? &compactStreamGPs.values[0] : NULL;
 
     // Open file for writing the error at each Gauss point
     string filename = name + "_relativeErrorL2Domain.csv";
@@ -4497,15 +5569,15 @@ double IGAMortarMapper::computeDomainErrorInL2Norm4ConsistentMapping(const doubl
     filestream << std::dec;
 
     // 2. Loop over all the Gauss Points
-    for(int iGP = 0; iGP < streamGPs.size(); iGP++){
-        // 2i. Get the Gauss Point Weight
-        GW = streamGPs[iGP][0];
+    for(int iGP = 0; iGP < noGPs; iGP++){
+        // 2i. Get the Gauss Point Weight (the compact stream holds the product with the Jacobian)
+        GW = isCompact ? *values++ : streamGPs[iGP][0];
 
         // 2ii. Get the product of the Jacobian transformations at the Gauss point
-        JacobianProducts = streamGPs[iGP][1];
+        JacobianProducts = isCompact ? 1.0 : streamGPs[iGP][1];
 
         // 2iii. Get the number of the basis functions of the finite element
-        noNodesFE = streamGPs[iGP][2];
+        noNodesFE = isCompact ? *indices++ : streamGPs[iGP][2];
 
         // 2iv. Initialize the field on the finite element mesh at the Gauss point
         for(int iCoord = 0; iCoord < noCoord; iCoord++)
@@ -4514,10 +5586,10 @@ double IGAMortarMapper::computeDomainErrorInL2Norm4ConsistentMapping(const doubl
         // 2v. Loop over the nodes of the finite element
         for(int iNodesFE = 0; iNodesFE < noNodesFE; iNodesFE++){
             // 2v.1. Get the value of the basis function
-            basisFctFEM = streamGPs[iGP][3 + 2*iNodesFE + 1];
+            basisFctFEM = isCompact ? *values++ : streamGPs[iGP][3 + 2*iNodesFE + 1];
 
             // 2v.2. Get the index of the node
-            indexNode = streamGPs[iGP][3 + 2*iNodesFE];
+            indexNode = isCompact ? *indices++ : streamGPs[iGP][3 + 2*iNodesFE];
             for(int iCoord = 0; iCoord < noCoord; iCoord++)
                 if(!isMappingIGA2FEM) {
                     fieldFEM[iCoord] += basisFctFEM*_slaveField[noCoord*indexNode + iCoord];
@@ -4526,7 +5598,7 @@ double IGAMortarMapper::computeDomainErrorInL2Norm4ConsistentMapping(const doubl
         }
 
         // 2vi. Get the number of basis functions of the isogeometric discretization
-        noCPsIGA = streamGPs[iGP][3 + 2*noNodesFE];
+        noCPsIGA = isCompact ? *indices++ : streamGPs[iGP][3 + 2*noNodesFE];
 
         // 2vii. Initialize the field on the isogeometric discretization at the Gauss point
         for(int iCoord = 0; iCoord < noCoord; iCoord++)
@@ -4535,10 +5607,10 @@ double IGAMortarMapper::computeDomainErrorInL2Norm4ConsistentMapping(const doubl
         // 2viii. Loop over the Control Points of the isogeometric discretization
         for(int iCPsIGA = 0; iCPsIGA < noCPsIGA; iCPsIGA++){
             // 2viii.1. Get the value of the basis function
-            basisFctIGA = streamGPs[iGP][3 + 2*noNodesFE + 2*iCPsIGA + 2];
+            basisFctIGA = isCompact ? *values++ : streamGPs[iGP][3 + 2*noNodesFE + 2*iCPsIGA + 2];
 
             // 2viii.2. Get the index of the CP
-            indexCP = streamGPs[iGP][3 + 2*noNodesFE + 2*iCPsIGA + 1];
+            indexCP = isCompact ? *indices++ : streamGPs[iGP][3 + 2*noNodesFE + 2*iCPsIGA + 1];
             for(int iCoord = 0; iCoord < noCoord; iCoord++)
                 if(!isMappingIGA2FEM)
                     fieldIGA[iCoord] += basisFctIGA*_masterField[noCoord*indexCP + iCoord];
@@ -4551,13 +5623,13 @@ double IGAMortarMapper::computeDomainErrorInL2Norm4ConsistentMapping(const doubl
             errorVct[iCoord] = fieldFEM[iCoord] - fieldIGA[iCoord];
 
         // 2x. Compute the norm of the difference of the fields at the Gauss Point
-        errorGPSquare = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, errorVct, errorVct);
+        errorGPSquare = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(errorVct, errorVct);
 
         // 2xi. Compute the norm of the reference field at the Gauss Point
         if(!isMappingIGA2FEM)
-            slaveFieldNorm = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, fieldFEM, fieldFEM);
+            slaveFieldNorm = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(fieldFEM, fieldFEM);
         else
-            slaveFieldNorm = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, fieldIGA, fieldIGA);
+            slaveFieldNorm = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(fieldIGA, fieldIGA);
 
         // 2xii. Add the contributions from the Gauss Point
         errorL2Domain += errorGPSquare*JacobianProducts*GW;
@@ -4565,7 +5637,7 @@ double IGAMortarMapper::computeDomainErrorInL2Norm4ConsistentMapping(const doubl
 
         // 2xiii. Write the Cartesian coordinates anf the value of the error at the Gauss point
         for (int iCoord = 0; iCoord < noCoord; iCoord++)
-            filestream << streamGPs[iGP][3 + 2*noNodesFE + 2*noCPsIGA + 1 + iCoord] << ",";
+            filestream << (isCompact ? *values++ : streamGPs[iGP][3 + 2*noNodesFE + 2*noCPsIGA + 1 + iCoord]) << ",";
         filestream << sqrt(errorGPSquare) << endl;
     }
 
@@ -4630,7 +5702,7 @@ void IGAMortarMapper::computeIGADirichletCurveErrorInL2Norm(double* _errorL2Curv
     int noDOFs;
     int indexCP;
     int indexDOF;
-    int noCoord = 3;
+    const int noCoord = 3;
     double elementLengthOnGP;
     double basisFct;
     double BoperatorT;
@@ -4693,7 +5765,7 @@ void IGAMortarMapper::computeIGADirichletCurveErrorInL2Norm(double* _errorL2Curv
         for(int iCoord = 0; iCoord < noCoord; iCoord++){
             errorField[iCoord] = field[iCoord] - 0.0;
         }
-        normErrorFieldSquare = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, errorField, errorField);
+        normErrorFieldSquare = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(errorField, errorField);
         _errorL2Curve[0] += normErrorFieldSquare*elementLengthOnGP;
 
         // 2vii. Compute the error in terms of the rotations
@@ -4773,7 +5845,7 @@ void IGAMortarMapper::computeIGAPatchInterfaceErrorInL2Norm(double* _errorL2Inte
     int noDOFsJ;
     int indexCP;
     int indexDOF;
-    int noCoord = 3;
+    const int noCoord = 3;
     double factorTangent;
     double factorNormal;
     double elementLengthOnGP;
@@ -4881,7 +5953,7 @@ void IGAMortarMapper::computeIGAPatchInterfaceErrorInL2Norm(double* _errorL2Inte
         for(int iCoord = 0; iCoord < noCoord; iCoord++){
             errorField[iCoord] = fieldI[iCoord] - fieldJ[iCoord];
         }
-        normErrorFieldSquare = EMPIRE::MathLibrary::computeDenseDotProduct(noCoord, errorField, errorField);
+        normErrorFieldSquare = EMPIRE::MathLibrary::computeDenseDotProduct<noCoord>(errorField, errorField);
         _errorL2Interface[0] += normErrorFieldSquare*elementLengthOnGP;
 
         // 2xi. Compute the error in terms of the rotations
@@ -4909,6 +5981,21 @@ void IGAMortarMapper::writeGaussPointData() {
         }
         filestream << endl;
     }
+    // the compact streams are written in the same format with the weight times the Jacobian and a Jacobian of 1
+    const int *indices = compactStreamGPs.indices.empty() ? NULL : &compactStreamGPs.indices[0];
+    const float *values = compactStreamGPs.values.empty() ? NULL : &compactStreamGPs.values[0];
+    for (size_t iGP = 0; iGP < compactStreamGPs.numGPs; iGP++) {
+        filestream << *values++ << " " << 1.0 << " ";
+        for (int iSide = 0; iSide < 2; iSide++) {
+            int noBasisFcts = *indices++;
+            filestream << noBasisFcts << " ";
+            for (int i = 0; i < noBasisFcts; i++)
+                filestream << *indices++ << " " << *values++ << " ";
+        }
+        for (int iCoord = 0; iCoord < 3; iCoord++)
+            filestream << *values++ << " ";
+        filestream << endl;
+    }
     filestream.close();
 }
 
@@ -5093,7 +6180,11 @@ void IGAMortarMapper::printCouplingMatrices() {
     ERROR_OUT() << "Cnn" << endl;
     couplingMatrices->getCnn()->printCSR();
     ERROR_OUT() << "Cnr" << endl;
-    couplingMatrices->getCnr()->printCSR();
+    if (couplingMatrices->isBlocked())
+        ERROR_OUT() << "stored in " << couplingMatrices->getCnrBlocks()->getBlockCols().size()
+                << " 3x3 blocks" << endl;
+    else
+        couplingMatrices->getCnr()->printCSR();
 }
 
 void IGAMortarMapper::writeCouplingMatricesToFile() {
@@ -5154,7 +6245,7 @@ void IGAMortarMapper::enforceConsistency() {
     }
 
     // 4. Compute the mapped field using the isogeometric mortar-based method
-    double* output = new double[size_N];
+    double* output = new double[size_N]();
     this->consistentMapping(ones, output);
 
     // 5. Compute the norm of the mapped field
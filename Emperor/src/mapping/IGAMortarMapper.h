@@ -53,6 +53,7 @@ class IGAPatchSurfaceTrimmingLoop;
 class IGAMesh;
 class Message;
 class FEMesh;
+class FEMeshConnectivity;
 class DataField;
 class IGAMortarCouplingMatrices;
 
@@ -82,14 +83,8 @@ private:
     /// Fluid Mesh
     FEMesh *meshFE;
 
-    /// Flag on whether the meshFEDirectElemTable was created
-    bool isMeshFEDirectElemTable;
-
-    /// The element freedom table for the fluid mesh
-    int **meshFEDirectElemTable;
-
-    /// The reverse element freedom table for the finite element mesh
-    std::map<int, std::vector<int> > meshFENodeToElementTable;
+    /// The element freedom and the reverse element freedom tables of the fluid mesh, owned by the mesh
+    const FEMeshConnectivity *meshFEConnectivity;
 
     /// Indices for rows which are identically zero in the mass matrix
     std::vector<int> indexEmptyRowCnn;
@@ -97,6 +92,24 @@ private:
     /// Flag on whether the coupling matrices are initialized
     bool isCouplingMatrices;
 
+    /// Relative residual tolerance of the iterative solver of Cnn, 0 for the direct solver
+    double iterativeSolverTolerance;
+
+    /// Maximum number of iterations of the iterative solver of Cnn
+    int iterativeSolverMaxIterations;
+
+    /// Name of the solver of Cnn in the LinearSolverRegistry
+    std::string linearSolver;
+
+    /// Settings of the PARDISO factorization of Cnn
+    MathLibrary::PardisoSettings pardisoSettings;
+
+    /// Flag on whether the data only needed for building the coupling matrices is released after the build
+    bool isCompactAfterBuild;
+
+    /// Flag on whether Cnn and Cnr are reordered by reverse Cuthill-McKee after the build
+    bool isReorderCouplingMatrices;
+
     /// The isogeometric coupling matrices
     IGAMortarCouplingMatrices *couplingMatrices;
 
@@ -158,15 +171,58 @@ private:
     bool isGaussQuadature;
 
     /// Quadrature rule over the triangulated subdomains
-    EMPIRE::MathLibrary::IGAGaussQuadrature **gaussRuleOnTriangle;
+    const EMPIRE::MathLibrary::IGAGaussQuadrature **gaussRuleOnTriangle;
 
     /// Quadrature rule over the non-triangulated subdomains
-    EMPIRE::MathLibrary::IGAGaussQuadrature **gaussRuleOnQuadrilateral;
+    const EMPIRE::MathLibrary::IGAGaussQuadrature **gaussRuleOnQuadrilateral;
 
     /// The parametric coordinates of the projected nodes on the surface
     /// For each node i, for each possible patch j, store parametric coordinates of i in j
     std::vector<std::map<int, std::vector<double> > > projectedCoords;
 
+    /// The coordinates of the FE nodes at their last projection, to find the moved nodes on a geometry update
+    std::vector<double> projectedNodes;
+
+    /// The contributions of an element to Cnn, Cnr and the integration area
+    struct ElementContributions {
+        std::vector<MathLibrary::SparseMatrixTriplet<double> > cnn;
+        std::vector<MathLibrary::SparseMatrixTriplet<double> > cnr;
+        double area;
+        ElementContributions() :
+                area(0.0) {
+        }
+    };
+
+    /// The contributions of every element, recorded from the first geometry update on to reuse those of the
+    /// elements whose projections did not change, empty before
+    std::vector<ElementContributions> elementContributions;
+
+    /// The projection on a patch boundary of the FE edge from a node projected on the patch to a node which is not
+    struct BoundaryEdgeProjection {
+        int patchIndex;
+        int nodeIn;
+        int nodeOut;
+        double u;
+        double v;
+        double lambda;
+        double distance;
+        bool isProjected;
+        bool operator<(const BoundaryEdgeProjection& _other) const {
+            if (patchIndex != _other.patchIndex)
+                return patchIndex < _other.patchIndex;
+            if (nodeIn != _other.nodeIn)
+                return nodeIn < _other.nodeIn;
+            return nodeOut < _other.nodeOut;
+        }
+        bool operator==(const BoundaryEdgeProjection& _other) const {
+            return patchIndex == _other.patchIndex && nodeIn == _other.nodeIn && nodeOut == _other.nodeOut;
+        }
+    };
+
+    /// The boundary projections of the edges of the split elements, computed in one parallel stage at the start of
+    /// computeCouplingMatrices and sorted, such that the edges shared by neighbouring elements are projected once
+    std::vector<BoundaryEdgeProjection> boundaryEdgeProjections;
+
     /// Polygon reconstructed in 2D parametric space stored for each patch
     std::map<int,ListPolygon2D> trimmedProjectedPolygons;
 
@@ -179,10 +235,44 @@ private:
     /// List of all the triangulated polygons
     std::vector<std::map<int,ListPolygon2D> > triangulatedProjectedPolygons;
 
+    /// Number of polygons triangulated by each path of TriangulatorAdaptor::triangulatePolygon
+    std::vector<long> numTriangulationsPerPath;
+
+    /// Number of Gauss points evaluated and saved with respect to the patch rules by the adaptive integration
+    long numGaussPointsAdaptive;
+    long numGaussPointsSaved;
+
+    /// Quality and cost of the last build or update of the coupling matrices
+    MapperBuildStatistics buildStatistics;
+
     /// Stream of gauss points stored in line with format
     /// Weight / Jacobian / NumOfFENode / Node1 / ShapeValue1 / Node2 / ShapeValue2 ... NumOfIGANode / Node1 / ShapeValue1/ ... cartesianCoordinatesGP
     std::vector<std::vector<double> > streamGPs;
 
+    /// Gauss point streams collected by each thread (or element, see MathLibrary::getAssemblyBuffer) during the
+    /// parallel computation of the coupling matrices
+    std::vector<std::vector<std::vector<double> > > streamGPsPerThread;
+
+    /// Gauss points of the domain error packed in two flat arrays, the values in single precision
+    struct CompactStreamGPs {
+        /// per Gauss point: NumOfFENode / Node1 / Node2 ... NumOfIGANode / Node1 / ...
+        std::vector<int> indices;
+        /// per Gauss point: Weight*Jacobian / FEShapeValue1 ... IGAShapeValue1 ... cartesianCoordinatesGP
+        std::vector<float> values;
+        /// the number of Gauss points
+        size_t numGPs;
+        CompactStreamGPs() :
+                numGPs(0) {
+        }
+    };
+
+    /// Gauss points of the domain error if propErrorComputation.isCompactStorage, streamGPs stays empty
+    CompactStreamGPs compactStreamGPs;
+
+    /// Compact Gauss point streams collected by each thread (or element) during the parallel computation of the
+    /// coupling matrices
+    std::vector<CompactStreamGPs> compactStreamGPsPerThread;
+
     /// Stream of interface gauss points stored in line with format
     std::vector<std::vector<double> > streamInterfaceGPs;
 
@@ -223,6 +313,8 @@ private:
         int noGPTriangle;
         int isAutomaticNoGPQuadrilateral;
         int noGPQuadrilateral;
+        bool isAdaptive;
+        double tolAdaptive;
     } propIntegration;
 
     /// Properties for the application of weak Dirichlet conditions along trimming curves
@@ -268,6 +360,7 @@ private:
         bool isDomainError;
         bool isCurveError;
         bool isInterfaceError;
+        bool isCompactStorage;
     } propErrorComputation;
 
 public:
@@ -341,9 +434,12 @@ public:
      * \param[in] _noGPTriangle The number of Gauss points when performs integration on triangle
      * \param[in] _isAutomaticNoGPQuadrilateral Flag on whether the Gauss rule on a triangle is automatically created or not
      * \param[in] _noGPQuadrilateral The number of Gauss points when performs integration on quadrilateral
+     * \param[in] _isAdaptive Flag on whether the Gauss rule is reduced for every integration subdomain below the rule of the patch
+     * \param[in] _tolAdaptive The tolerance on the estimated relative quadrature error of the reduced rules
      * \author Andreas Apostolatos, Fabien Pean
      ***********/
-    void setParametersIntegration(bool _isAutomaticNoGPTriangle = false, int _noGPTriangle = 16, bool _isAutomaticNoGPQuadrilateral = false, int _noGPQuadrilateral = 25);
+    void setParametersIntegration(bool _isAutomaticNoGPTriangle = false, int _noGPTriangle = 16, bool _isAutomaticNoGPQuadrilateral = false, int _noGPQuadrilateral = 25,
+                                  bool _isAdaptive = false, double _tolAdaptive = 1e-6);
 
     /***********************************************************************************************
      * \brief Set the parameters for the application of weak Dirichlet boundary conditions along trimming curves
@@ -400,10 +496,12 @@ public:
      * \param[in] _isDomainError Flag on the computation of the error from the mapping in the domain
      * \param[in] _isCurveError Flag on the computation of the error of the constaint satisfaction along the trimming curves
      * \param[in] _isInterfaceError Flag on the computation of the interface error between the patches
+     * \param[in] _isCompactStorage Flag on storing the Gauss points of the domain error packed in single precision
      * \author Andreas Apostolatos
      ***********/
     void setParametersErrorComputation(bool _isErrorComputation = false, bool _isDomainError = false,
-                                       bool _isCurveError = false, bool _isInterfaceError = false);
+                                       bool _isCurveError = false, bool _isInterfaceError = false,
+                                       bool _isCompactStorage = false);
 
     /***********************************************************************************************
      * \brief Build the coupling matrcies Cnn and Cnr
@@ -411,6 +509,134 @@ public:
      ***********/
     void buildCouplingMatrices();
 
+    /***********************************************************************************************
+     * \brief The coupling matrices can be cached unless the mapping errors are computed, since the
+     *        errors need the Gauss point data of the integration
+     * \return true if there is no error computation
+     ***********/
+    bool isCouplingMatricesCacheSupported() const {
+        return !propErrorComputation.isErrorComputation;
+    }
+
+    /***********************************************************************************************
+     * \brief Store Cnn and Cnr in the cache, they include all weak conditions and the expansion
+     * \param[in] cache the cache
+     ***********/
+    void writeCouplingMatricesToCache(CouplingMatricesCache *cache);
+
+    /***********************************************************************************************
+     * \brief Take Cnn and Cnr from the cache instead of building them and factorize Cnn. The
+     *        coupling matrices must be initialized
+     * \param[in] cache the loaded cache
+     * \return false if the cache does not hold all matrices
+     ***********/
+    bool readCouplingMatricesFromCache(const CouplingMatricesCache *cache);
+
+    /***********************************************************************************************
+     * \brief Cnn can be solved iteratively unless consistency is enforced, since enforcing
+     *        consistency replaces rows of Cnn and makes it unsymmetric
+     * \return true if consistency is not enforced
+     ***********/
+    bool isIterativeSolverSupported() const {
+        return !propConsistency.enforceConsistency;
+    }
+
+    /***********************************************************************************************
+     * \brief Solve Cnn by the preconditioned conjugate gradient method instead of factorizing it
+     * \param[in] tolerance the relative residual tolerance
+     * \param[in] maxIterations the maximum number of iterations
+     ***********/
+    void setIterativeSolver(double tolerance, int maxIterations);
+
+    /***********************************************************************************************
+     * \brief Change the tolerance of the conjugate gradient method of Cnn between two mappings
+     * \param[in] tolerance the relative residual tolerance
+     ***********/
+    void setIterativeSolverTolerance(double tolerance);
+
+    /***********************************************************************************************
+     * \brief Select the solver of Cnn
+     * \param[in] name the name of the solver in the LinearSolverRegistry
+     ***********/
+    void setLinearSolver(const std::string &name);
+
+    /***********************************************************************************************
+     * \brief Set the threads, the ordering and the storage of the PARDISO factors of Cnn
+     * \param[in] settings the settings
+     ***********/
+    void setPardisoSettings(const MathLibrary::PardisoSettings &settings);
+
+    /***********************************************************************************************
+     * \brief The build data can always be released, the mapping and the error computation only use
+     *        the coupling matrices and the Gauss point streams
+     * \return true
+     ***********/
+    bool isCompactAfterBuildSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Release projectedCoords, the projected and triangulated polygons and the Gauss point
+     *        streams after the coupling matrices are built or read from the cache
+     * \param[in] compact true to release the data
+     ***********/
+    void setCompactAfterBuild(bool compact) {
+        isCompactAfterBuild = compact;
+    }
+
+    /***********************************************************************************************
+     * \brief The coupling matrices can be rebuilt after the FE nodes moved unless weak conditions or
+     *        the error computation are used, whose data is not updated
+     * \return true if neither weak conditions nor the error computation are used
+     ***********/
+    bool isGeometryUpdateSupported() const {
+        return !propWeakCurveDirichletConditions.isWeakCurveDirichletConditions
+                && !propWeakSurfaceDirichletConditions.isWeakSurfaceDirichletConditions
+                && !propWeakPatchContinuityConditions.isWeakPatchContinuityConditions
+                && !propErrorComputation.isErrorComputation;
+    }
+
+    /***********************************************************************************************
+     * \brief Rebuild the coupling matrices after the FE nodes moved. Newton-Raphson starts from the
+     *        previous parametric coordinates of each moved node, only the nodes for which it fails are
+     *        searched again on all patches. From the second update on, only the elements whose
+     *        projections changed are integrated again. After the build data was released all nodes
+     *        are projected and all elements are integrated.
+     ***********/
+    void updateGeometry();
+
+    /***********************************************************************************************
+     * \brief The master unknowns of Cnn and Cnr can always be renumbered, the mapping permutes the
+     *        master fields
+     * \return true
+     ***********/
+    bool isReorderCouplingMatricesSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Renumber the master unknowns of Cnn and Cnr by reverse Cuthill-McKee before Cnn is
+     *        factorized
+     * \param[in] reorder true to reorder
+     ***********/
+    void setReorderCouplingMatrices(bool reorder) {
+        isReorderCouplingMatrices = reorder;
+    }
+
+    /***********************************************************************************************
+     * \brief Get the heap memory of the coupling matrices, the projections, the polygons, the
+     *        Gauss point streams
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+    /***********************************************************************************************
+     * \brief Get the projections, the clipped polygons, the Gauss points, the sizes of Cnn and Cnr
+     *        and the time of the stages of the last build or update of the coupling matrices
+     ***********/
+    MapperBuildStatistics getBuildStatistics() const {
+        return buildStatistics;
+    }
+
     /***********************************************************************************************
      * \brief Perform consistent mapping
      * \param[in] _slaveField The reference field
@@ -427,6 +653,18 @@ public:
      ***********/
     void conservativeMapping(const double *_masterField, double *_slaveField);
 
+    /***********************************************************************************************
+     * \brief Perform consistent and conservative mapping with one solve of the symmetric Cnn having
+     *        both right hand sides
+     * \param[in] _slaveField The reference field of the consistent mapping
+     * \param[in/out] _masterField the target field of the consistent mapping
+     * \param[in] _masterIntegralField The target field of the conservative mapping
+     * \param[out] _slaveIntegralField The reference field of the conservative mapping
+     * \param[in] numComponents must be 1
+     ***********/
+    void mapBothDirections(const double *_slaveField, double *_masterField,
+            const double *_masterIntegralField, double *_slaveIntegralField, int numComponents);
+
     /***********************************************************************************************
      * \brief Compute the mapping errors
      * \param[in] _slaveField The reference field
@@ -463,7 +701,19 @@ public:
     /// intern function used for mapping
 private:
     /***********************************************************************************************
-     * \brief Initialization of the element freedom tables
+     * \brief Release the data which is only used for building the coupling matrices, the mapping and
+     *        the error computation use the coupling matrices and the Gauss point streams only
+     ***********/
+    void releaseBuildData();
+
+    /***********************************************************************************************
+     * \brief Record the sizes of the frozen Cnn and Cnr in the build statistics, must be called
+     *        before Cnr is blocked
+     ***********/
+    void recordCouplingMatrixStatistics();
+
+    /***********************************************************************************************
+     * \brief Initialization of the element freedom tables, they are shared with the FE mesh
      * \author Andreas Apostolatos
      ***********/
     void initTables();
@@ -480,6 +730,21 @@ private:
      ***********/
     void projectPointsToSurface();
 
+    /***********************************************************************************************
+     * \brief Fills up the array projectedCoords for the given nodes by performing closest point projection
+     * \param[in] _nodeIndices the nodes to project, their entries in projectedCoords must be empty
+     ***********/
+    void projectPointsToSurface(const std::vector<int> &_nodeIndices);
+
+    /***********************************************************************************************
+     * \brief Project the nodes which moved since their last projection by Newton-Raphson from their
+     *        previous parametric coordinates. A node is searched again on all patches if an iteration
+     *        fails, if it leaves the maximum projection distance or if it enters the bounding box of a
+     *        patch it was not projected onto.
+     * \param[out] _isElementChanged for every element whether it must be integrated again
+     ***********/
+    void reprojectPointsToSurface(std::vector<char> &_isElementChanged);
+
     /***********************************************************************************************
      * \brief Compute the initial guess for a node of an element
      * \param[in] _patchCount The index of the patch we are working on
@@ -503,6 +768,34 @@ private:
      ***********/
     bool projectPointOnPatch(const int patchIndex, const int nodeIndex, const double u0, const double v0, double& minProjectionDistance, std::vector<double>& minProjectionPoint);
 
+    /***********************************************************************************************
+     * \brief Compute the projection of a point on a patch using Newton-Raphson without storing it.
+     *        This function does not modify the mapper and can be called concurrently.
+     * \param[in] _patchIndex The index of the patch we are working on
+     * \param[in] _nodeIndex The global index of the node in the element we are working with
+     * \param[in/out] _u On input the initial guess in u direction, on output the projected u
+     * \param[in/out] _v On input the initial guess in v direction, on output the projected v
+     * \param[out] _projectedP The Cartesian coordinates of the projected point
+     * \param[out] _distance The distance between the node and the projected point
+     * \return Whether the iterations converged within the maximum projection distance
+     ***********/
+    bool computePointProjectionOnPatch(const int _patchIndex, const int _nodeIndex, double& _u, double& _v, double* _projectedP, double& _distance);
+
+    /***********************************************************************************************
+     * \brief Validate a computed projection of a node against the projections on other patches and store it in projectedCoords
+     * \param[in] _patchIndex The index of the patch we are working on
+     * \param[in] _nodeIndex The global index of the node
+     * \param[in] _u The projected u
+     * \param[in] _v The projected v
+     * \param[in] _projectedP The Cartesian coordinates of the projected point
+     * \param[in] _distance The distance between the node and the projected point
+     * \param[in/out] _minProjectionDistance The minimum distance of the node to all patches so far
+     * \param[in/out] _minProjectionPoint The projected point related to the minimum distance
+     * \return Whether the projection is stored
+     ***********/
+    bool storePointProjection(const int _patchIndex, const int _nodeIndex, const double _u, const double _v, const double* _projectedP,
+                              const double _distance, double& _minProjectionDistance, std::vector<double>& _minProjectionPoint);
+
     /***********************************************************************************************
      * \brief Compute the projection of a point on a patch using Newton-Raphson
      * \param[in] _patchIndex The index of the patch we are working on
@@ -515,6 +808,19 @@ private:
      ***********/
     bool forceProjectPointOnPatchByRelaxation(const int patchIndex, const int nodeIndex, const double u0, const double v0, double& minProjectionDistance, std::vector<double>& minProjectionPoint);
 
+    /***********************************************************************************************
+     * \brief Compute the closest point of a patch to a node, visiting the knot spans by the distance of
+     *        their bounding boxes and accepting closest points on the patch boundary
+     * \param[in] _patchIndex The index of the patch we are working on
+     * \param[in] _nodeIndex The global index of the node in the element we are working with
+     * \param[in] _u The initial guess in u direction
+     * \param[in] _v The initial guess in v direction
+     * \param[out] _minProjectionDistance The previous distance computed
+     * \param[out] _minProjectionPoint The previous point computed
+     * \return Whether the projection is stored
+     ***********/
+    bool forceProjectPointOnPatchByPruning(const int patchIndex, const int nodeIndex, const double u0, const double v0, double& minProjectionDistance, std::vector<double>& minProjectionPoint);
+
     /***********************************************************************************************
      * \brief Compute the projection of a point on a patch using a brute force method
      * \param[in] _patchCount The index of the patch we are working on
@@ -527,9 +833,11 @@ private:
 
     /***********************************************************************************************
      * \brief Compute matrices Cnn and Cnr by looping over the FE elements and processing them
+     * \param[in] _isElementChanged if given, the recorded contributions of the elements not flagged are
+     *            reused and those of the flagged elements are recorded again
      * \author Andreas Apostolatos, Fabien Pean
      ***********/
-    void computeCouplingMatrices();
+    void computeCouplingMatrices(const std::vector<char> *_isElementChanged = NULL);
 
 public:
     /***********************************************************************************************
@@ -598,6 +906,16 @@ public:
     void computePenaltyParametersForPatchContinuityConditions(std::string _filename);
 
 private:
+    /***********************************************************************************************
+     * \brief Estimate the cost of clipping and integrating an element from its projection, without
+     *        clipping. The estimate grows with the number of knot spans the element covers, with the
+     *        knot spans cut by the trimming and most with the patch boundaries the element crosses.
+     * \param[in] _elemIndex The index of the element
+     * \param[in] _isElementChanged The changed elements on a geometry update, NULL otherwise
+     * \return The estimated cost in the unit of an untrimmed element on one knot span
+     ***********/
+    double estimateElementCost(int _elemIndex, const std::vector<char> *_isElementChanged) const;
+
     /***********************************************************************************************
      * \brief Get the patches index on which the FE-side element is projected
      * \param[in] _elemIndex The index of the element one is getting the patches for
@@ -627,6 +945,47 @@ private:
      ***********/
     void buildBoundaryParametricElement(int elemIndex, int numNodesElementFE, int patchIndex, Polygon2D& polygonUV);
 
+    /***********************************************************************************************
+     * \brief Project the edges of all split elements on the patch boundaries in parallel. The edges are
+     *        first intersected with the linearized patch boundaries, which gives the boundary and the
+     *        initial guess of a single Newton-Raphson iteration, and otherwise projected by
+     *        projectLineOnPatchBoundary
+     * \param[in] _isElementChanged Flag for every element whether it is integrated again, all if NULL
+     ***********/
+    void computeBoundaryEdgeProjections(const std::vector<char> *_isElementChanged);
+
+    /***********************************************************************************************
+     * \brief Project a line on the patch boundary starting from its closest segment on the linearized boundary
+     * \param[in] _thePatch The patch
+     * \param[in] _parameters The running parameters of the vertices of the linearization for the 4 boundaries
+     * \param[in] _points The Cartesian coordinates of the vertices of the linearization for the 4 boundaries
+     * \param[out] _u The u-parameter of the projection on the boundary
+     * \param[out] _v The v-parameter of the projection on the boundary
+     * \param[out] _lambda The ratio on the line
+     * \param[in/out] _distance Given the maximum and returned the distance of the line to the patch boundary
+     * \param[in] _Pin The point of the line that could have been projected in the patch
+     * \param[in] _Pout The point of the line that could not have been projected in the patch
+     * \return Whether the line is projected, false if no boundary is clearly the closest one
+     ***********/
+    bool projectLineOnLinearizedPatchBoundary(IGAPatchSurface* _thePatch, const std::vector<double>* _parameters,
+            const std::vector<double>* _points, double& _u, double& _v, double& _lambda, double& _distance,
+            double* _Pin, double* _Pout);
+
+    /***********************************************************************************************
+     * \brief Get the projection of a FE edge on the patch boundary from boundaryEdgeProjections, or
+     *        compute it by projectLineOnPatchBoundary if the nodes are not neighbours
+     * \param[in] _patchIndex The patch index
+     * \param[in] _nodeIn The node projected on the patch
+     * \param[in] _nodeOut The node not projected on the patch
+     * \param[in/out] _u Given the u-parameter of the node projected on the patch and returned that on the boundary
+     * \param[in/out] _v Given the v-parameter of the node projected on the patch and returned that on the boundary
+     * \param[in/out] _lambda The ratio on the line
+     * \param[in/out] _distance The distance of the line to the patch
+     * \return Flag if it has converged
+     ***********/
+    bool projectEdgeOnPatchBoundary(int _patchIndex, int _nodeIn, int _nodeOut, double& _u, double& _v,
+            double& _lambda, double& _distance);
+
     /***********************************************************************************************
      * \brief Compute the projection of a line on patch boundary, display warnings and backup solution
      * \param[in] _thePatch The patch to compute the coupling matrices for
@@ -659,13 +1018,12 @@ private:
     void clipByPatch(const IGAPatchSurface* _thePatch, Polygon2D& _polygonUV);
 
     /***********************************************************************************************
-     * \brief Clip the input polygon by the trimming window of the patch
+     * \brief Clip the polygons output by clipByKnotSpan by the trimming of their knot spans
      * \param[in] _thePatch The patch for which trimming curves are used
-     * \param[in] _polygonUV An input polygon defined in parametric (i.e. 2D) space
-     * \param[out] _listPolygon	A set of polygons after application of trimming polygon
-     * \author Andreas Apostolatos, Fabien Pean
+     * \param[in/out] _listPolygon The polygons, replaced by their parts inside the trimmed domain
+     * \param[in/out] _listSpan The list of span index every polygon of the list above is linked to
      ***********/
-    void clipByTrimming(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygonUV);
+    void clipByKnotSpanTrimming(const IGAPatchSurface* _thePatch, ListPolygon2D& _listPolygon, Polygon2D& _listSpan);
 
     /***********************************************************************************************
      * \brief Clip the input polygon by the trimming window of the trimming loop
@@ -688,7 +1046,7 @@ private:
     void clipByKnotSpan(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygon, Polygon2D& _listSpan);
 
     /***********************************************************************************************
-     * \brief triangulate optimally a 2D input polygon
+     * \brief triangulate a 2D input polygon, see TriangulatorAdaptor::triangulatePolygon
      * \param[in] _polygonUV 	An input polygon defined in parametric (i.e. 2D) space
      * \author Fabien Pean
      ***********/
@@ -716,6 +1074,23 @@ private:
      ***********/
     void computeMinimumEdgeSize();
 
+    /***********************************************************************************************
+     * \brief Get the Gauss rule of least points for an integration subdomain whose estimated relative error
+     *        stays below propIntegration.tolAdaptive. Over a subdomain of relative size r with respect to
+     *        the knot span, the terms of degree k of the NURBS basis contribute in the order of r^k, and the
+     *        geometry contributes in the order of the angle between the surface normals at its vertices.
+     *        The rule is never larger than the one of the patch.
+     * \param[in] _thePatch The patch the subdomain is on
+     * \param[in] _patchIndex The index of the patch as stored in IGAMesh
+     * \param[in] _polygonUV The integration subdomain in the NURBS parameter space
+     * \param[in] _spanU The knot span index in the u-direction of the subdomain
+     * \param[in] _spanV The knot span index in the v-direction of the subdomain
+     * \param[in] _elementIndex The global numbering of the element from the FE mesh
+     * \return The Gauss rule, either the one of the patch or a reduced one
+     ***********/
+    const EMPIRE::MathLibrary::IGAGaussQuadrature* getAdaptiveGaussQuadrature(IGAPatchSurface* _thePatch, int _patchIndex,
+                                                                              const Polygon2D& _polygonUV, int _spanU, int _spanV, int _elementIndex);
+
     /***********************************************************************************************
      * \brief Integrate the element coupling matrices and assemble them to the global one
      * \param[in] _thePatch The patch to compute the coupling matrices for
@@ -863,6 +1238,13 @@ public:
         return isExpanded;
     }
 
+    /***********************************************************************************************
+     * \brief Get flag on whether the coupling matrices are initialized, see initialize
+     ***********/
+    bool getIsCouplingMatrices() const {
+        return isCouplingMatrices;
+    }
+
     /***********************************************************************************************
      * \brief Get the number of the weak patch continuity conditions
      * \author Altug Emiroglu
@@ -977,6 +1359,9 @@ public:
      ***********/
     void printErrorMessage(Message &message, double _errorL2Domain, double* _errorL2Curve, double *_errorL2Interface);
 
+    /// defines number of threads used for mapper routines
+    static int mapperSetNumThreads;
+
     // Constant members of the class
 private:
     /// Tolerance for cleaning a triangle before integrating
@@ -0,0 +1,335 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <assert.h>
+#include <math.h>
+#include <sstream>
+#include <iomanip>
+#include "IGAMortarMapperTuning.h"
+#include "IGAMortarMapper.h"
+#include "MapperBuildStatistics.h"
+#include "IGAMesh.h"
+#include "IGAPatchSurface.h"
+#include "IGAControlPoint.h"
+#include "FEMesh.h"
+#include "IDToIndexMap.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/// a trial may be this much slower than the best trial so far, which covers the noise of the timing
+static const double TIME_TOLERANCE = 0.05;
+
+/// the values tried for the number of test points of the initial guess of the projection
+static const int CANDIDATES_INITIAL_GUESS[] = { 1, 2, 3, 4, 6, 8 };
+/// the values tried for the number of iterations of the Newton-Raphson schemes
+static const int CANDIDATES_NEWTON_RAPHSON[] = { 3, 5, 8, 10, 15 };
+/// the values tried for the number of iterations of the bisection
+static const int CANDIDATES_BISECTION[] = { 10, 15, 20, 30 };
+/// the values tried for the number of Gauss points on triangles, the symmetric rules
+static const int CANDIDATES_GP_TRIANGLE[] = { 1, 3, 4, 6, 7, 12, 13, 16 };
+/// the values tried for the number of Gauss points on quadrilaterals
+static const int CANDIDATES_GP_QUADRILATERAL[] = { 1, 4, 9, 16, 25, 36, 49, 64, 81 };
+
+/// a parameter which is swept, a number of iterations or of points
+struct SweptParameter {
+    /// name of the parameter in the report
+    const char *name;
+    /// the swept value
+    int IGAMortarMapperTuning::Parameters::*value;
+    /// the flag of the automatic choice of the value, which is not swept if set, or NULL
+    bool IGAMortarMapperTuning::Parameters::*isAutomatic;
+    /// the values tried in ascending order
+    const int *candidates;
+    int numCandidates;
+};
+
+#define NUM_OF(array) ((int) (sizeof(array) / sizeof(array[0])))
+
+/// the parameters in the order they are swept
+static const SweptParameter SWEPT_PARAMETERS[] = {
+        { "noInitialGuess", &IGAMortarMapperTuning::Parameters::noInitialGuess, NULL,
+                CANDIDATES_INITIAL_GUESS, NUM_OF(CANDIDATES_INITIAL_GUESS) },
+        { "newtonRaphsonSurface noIterations",
+                &IGAMortarMapperTuning::Parameters::noIterationsNewtonRaphson, NULL,
+                CANDIDATES_NEWTON_RAPHSON, NUM_OF(CANDIDATES_NEWTON_RAPHSON) },
+        { "newtonRaphsonBoundary noIterations",
+                &IGAMortarMapperTuning::Parameters::noIterationsNewtonRaphsonBoundary, NULL,
+                CANDIDATES_NEWTON_RAPHSON, NUM_OF(CANDIDATES_NEWTON_RAPHSON) },
+        { "bisectionBoundary noIterations",
+                &IGAMortarMapperTuning::Parameters::noIterationsBisection, NULL,
+                CANDIDATES_BISECTION, NUM_OF(CANDIDATES_BISECTION) },
+        { "noGPTriangle", &IGAMortarMapperTuning::Parameters::noGPTriangle,
+                &IGAMortarMapperTuning::Parameters::isAutomaticNoGPTriangle,
+                CANDIDATES_GP_TRIANGLE, NUM_OF(CANDIDATES_GP_TRIANGLE) },
+        { "noGPQuadrilateral", &IGAMortarMapperTuning::Parameters::noGPQuadrilateral,
+                &IGAMortarMapperTuning::Parameters::isAutomaticNoGPQuadrilateral,
+                CANDIDATES_GP_QUADRILATERAL, NUM_OF(CANDIDATES_GP_QUADRILATERAL) } };
+
+IGAMortarMapperTuning::IGAMortarMapperTuning(std::string _name, AbstractMesh *_meshA,
+        AbstractMesh *_meshB, int _sampleSize, double _targetProjectionSuccessRate,
+        double _targetMappingError, int _numThreads) :
+        name(_name), targetProjectionSuccessRate(_targetProjectionSuccessRate), targetMappingError(
+                _targetMappingError), numThreads(_numThreads) {
+    assert(_sampleSize > 0);
+    isMeshAIGA = (_meshA->type == EMPIRE_Mesh_IGAMesh);
+    meshIGA = isMeshAIGA ? _meshA : _meshB;
+    AbstractMesh *meshFE = isMeshAIGA ? _meshB : _meshA;
+    assert(meshIGA->type == EMPIRE_Mesh_IGAMesh);
+    assert(meshFE->type == EMPIRE_Mesh_FEMesh || meshFE->type == EMPIRE_Mesh_SectionMesh);
+    sample = createSample(dynamic_cast<FEMesh *>(meshFE), _sampleSize);
+}
+
+IGAMortarMapperTuning::~IGAMortarMapperTuning() {
+    delete sample;
+}
+
+int IGAMortarMapperTuning::getNumSampleElems() const {
+    return sample->numElems;
+}
+
+FEMesh *IGAMortarMapperTuning::createSample(FEMesh *meshFE, int sampleSize) {
+    int stride = (meshFE->numElems + sampleSize - 1) / sampleSize;
+    if (stride < 1)
+        stride = 1;
+    vector<int> elemOffsets(meshFE->numElems + 1, 0);
+    for (int i = 0; i < meshFE->numElems; i++)
+        elemOffsets[i + 1] = elemOffsets[i] + meshFE->numNodesPerElem[i];
+
+    // the nodes of the sampled elements keep their order in the mesh
+    const IDToIndexMap *nodeIndex = meshFE->getNodeIndex();
+    vector<char> isNodeSampled(meshFE->numNodes, 0);
+    int numSampleElems = 0;
+    for (int i = 0; i < meshFE->numElems; i += stride) {
+        for (int j = elemOffsets[i]; j < elemOffsets[i + 1]; j++)
+            isNodeSampled[nodeIndex->at(meshFE->elems[j])] = 1;
+        numSampleElems++;
+    }
+    int numSampleNodes = 0;
+    for (int i = 0; i < meshFE->numNodes; i++)
+        numSampleNodes += isNodeSampled[i];
+
+    FEMesh *sample = new FEMesh(meshFE->name + "_tuningSample", numSampleNodes, numSampleElems,
+            meshFE->triangulateAll);
+    for (int i = 0, k = 0; i < meshFE->numNodes; i++) {
+        if (!isNodeSampled[i])
+            continue;
+        sample->nodeIDs[k] = meshFE->nodeIDs[i];
+        for (int j = 0; j < 3; j++)
+            sample->nodes[k * 3 + j] = meshFE->nodes[i * 3 + j];
+        k++;
+    }
+    for (int i = 0, k = 0; i < meshFE->numElems; i += stride, k++) {
+        sample->numNodesPerElem[k] = meshFE->numNodesPerElem[i];
+        sample->elemIDs[k] = meshFE->elemIDs[i];
+    }
+    sample->initElems();
+    for (int i = 0, k = 0; i < meshFE->numElems; i += stride)
+        for (int j = elemOffsets[i]; j < elemOffsets[i + 1]; j++)
+            sample->elems[k++] = meshFE->elems[j];
+    sample->prepare();
+    return sample;
+}
+
+IGAMortarMapperTuning::Trial IGAMortarMapperTuning::build(const std::string &description,
+        const Parameters &parameters, std::vector<double> &mappedCoordinates) {
+    IGAMortarMapper::mapperSetNumThreads = numThreads;
+    string trialName = name + " (tuning: " + description + ")";
+    IGAMortarMapper *mapper =
+            isMeshAIGA ?
+                    new IGAMortarMapper(trialName, meshIGA, sample) :
+                    new IGAMortarMapper(trialName, sample, meshIGA);
+    mapper->setParametersProjection(parameters.maxProjectionDistance, parameters.noInitialGuess,
+            parameters.maxProjectionDistanceOnDifferentPatches);
+    mapper->setParametersNewtonRaphson(parameters.noIterationsNewtonRaphson,
+            parameters.tolProjectionNewtonRaphson);
+    mapper->setParametersNewtonRaphsonBoundary(parameters.noIterationsNewtonRaphsonBoundary,
+            parameters.tolProjectionNewtonRaphsonBoundary);
+    mapper->setParametersBisection(parameters.noIterationsBisection,
+            parameters.tolProjectionBisection);
+    mapper->setParametersIntegration(parameters.isAutomaticNoGPTriangle, parameters.noGPTriangle,
+            parameters.isAutomaticNoGPQuadrilateral, parameters.noGPQuadrilateral,
+            parameters.isAdaptiveIntegration, parameters.tolAdaptiveIntegration);
+    double startTime = omp_get_wtime();
+    mapper->initialize();
+    mapper->buildCouplingMatrices();
+    double seconds = omp_get_wtime() - startTime;
+
+    Trial trial;
+    trial.description = description;
+    trial.parameters = parameters;
+    trial.secondsPerElement = seconds / sample->numElems;
+    trial.mappingError = 0.0;
+    trial.isAccepted = false;
+    MapperBuildStatistics statistics = mapper->getBuildStatistics();
+    long numNodes = 0;
+    for (int kind = 0; kind < MapperBuildStatistics::NUM_PROJECTION_KINDS; kind++)
+        numNodes += statistics.getNumProjections((MapperBuildStatistics::ProjectionKind) kind);
+    long numFailed = statistics.getNumProjections(MapperBuildStatistics::PROJECTION_FAILED);
+    trial.projectionSuccessRate = (numNodes == 0) ? 1.0 : 1.0 - (double) numFailed / numNodes;
+
+    // map the coordinates of mesh A, which the geometry of both meshes approximates
+    IGAMesh *iga = dynamic_cast<IGAMesh *>(meshIGA);
+    int numNodesA = isMeshAIGA ? iga->getNumNodes() : sample->numNodes;
+    int numNodesB = isMeshAIGA ? sample->numNodes : iga->getNumNodes();
+    vector<double> coordinatesA(3 * numNodesA, 0.0);
+    if (isMeshAIGA) {
+        for (int i = 0; i < iga->getNumPatches(); i++) {
+            IGAPatchSurface *patch = iga->getSurfacePatch(i);
+            IGAControlPoint **controlPoints = patch->getControlPointNet();
+            for (int j = 0; j < patch->getNoControlPoints(); j++) {
+                int dof = controlPoints[j]->getDofIndex();
+                coordinatesA[0 * numNodesA + dof] = controlPoints[j]->getX();
+                coordinatesA[1 * numNodesA + dof] = controlPoints[j]->getY();
+                coordinatesA[2 * numNodesA + dof] = controlPoints[j]->getZ();
+            }
+        }
+    } else {
+        for (int i = 0; i < numNodesA; i++)
+            for (int j = 0; j < 3; j++)
+                coordinatesA[j * numNodesA + i] = sample->nodes[i * 3 + j];
+    }
+    mappedCoordinates.assign(3 * numNodesB, 0.0);
+    for (int j = 0; j < 3; j++)
+        mapper->consistentMapping(&coordinatesA[j * numNodesA], &mappedCoordinates[j * numNodesB]);
+    delete mapper;
+    return trial;
+}
+
+bool IGAMortarMapperTuning::tryParameters(const std::string &description,
+        const Parameters &parameters, double bestSecondsPerElement) {
+    vector<double> mappedCoordinates;
+    Trial trial = build(description, parameters, mappedCoordinates);
+    assert(mappedCoordinates.size() == referenceMappedCoordinates.size());
+    double difference = 0.0;
+    double reference = 0.0;
+    for (size_t i = 0; i < mappedCoordinates.size(); i++) {
+        double d = mappedCoordinates[i] - referenceMappedCoordinates[i];
+        difference += d * d;
+        reference += referenceMappedCoordinates[i] * referenceMappedCoordinates[i];
+    }
+    trial.mappingError = (reference > 0.0) ? sqrt(difference / reference) : sqrt(difference);
+    trial.isAccepted = trial.projectionSuccessRate >= targetProjectionSuccessRate
+            && trial.mappingError <= targetMappingError
+            && trial.secondsPerElement <= (1.0 + TIME_TOLERANCE) * bestSecondsPerElement;
+    trials.push_back(trial);
+    return trial.isAccepted;
+}
+
+IGAMortarMapperTuning::Parameters IGAMortarMapperTuning::tune(const Parameters &configured) {
+    HEADING_OUT(3, "IGAMortarMapperTuning",
+            "Tuning the build parameters of (" + name + ") on a sample...", infoOut);
+    trials.clear();
+    Trial reference = build("configured", configured, referenceMappedCoordinates);
+    reference.isAccepted = reference.projectionSuccessRate >= targetProjectionSuccessRate;
+    trials.push_back(reference);
+    if (!reference.isAccepted) {
+        WARNING_OUT() << "IGAMortarMapperTuning: the configured parameters of mapper \"" << name
+                << "\" project " << 100.0 * reference.projectionSuccessRate
+                << "% of the sample nodes, less than the target, they are kept" << endl;
+        return configured;
+    }
+
+    // sweep one parameter at a time from its cheapest value, the other ones at their best values
+    Parameters current = configured;
+    double bestSecondsPerElement = reference.secondsPerElement;
+    bool isChanged = false;
+    for (int i = 0; i < NUM_OF(SWEPT_PARAMETERS); i++) {
+        const SweptParameter &swept = SWEPT_PARAMETERS[i];
+        if (swept.isAutomatic != NULL && current.*(swept.isAutomatic))
+            continue;
+        for (int j = 0; j < swept.numCandidates && swept.candidates[j] < current.*(swept.value);
+                j++) {
+            Parameters candidate = current;
+            candidate.*(swept.value) = swept.candidates[j];
+            stringstream description;
+            description << swept.name << " = " << swept.candidates[j];
+            if (tryParameters(description.str(), candidate, bestSecondsPerElement)) {
+                current = candidate;
+                bestSecondsPerElement = trials.back().secondsPerElement;
+                isChanged = true;
+                break;
+            }
+        }
+    }
+    if (!isChanged)
+        return configured;
+
+    // the values are accepted one by one, the combination is checked again
+    if (!tryParameters("combined", current, reference.secondsPerElement)) {
+        WARNING_OUT() << "IGAMortarMapperTuning: the combination of the tuned parameters of mapper \""
+                << name << "\" misses the targets, the configured parameters are kept" << endl;
+        return configured;
+    }
+    return current;
+}
+
+void IGAMortarMapperTuning::print(const Parameters &suggested) const {
+    INFO_OUT() << "Tuning of mapper \"" << name << "\" on " << sample->numElems
+            << " sample elements (target projection success rate "
+            << 100.0 * targetProjectionSuccessRate << "%, target mapping error "
+            << targetMappingError << "):" << endl;
+    for (size_t i = 0; i < trials.size(); i++) {
+        const Trial &trial = trials[i];
+        stringstream line;
+        line << "    " << left << setw(40) << trial.description << right << " projected " << setw(7)
+                << fixed << setprecision(3) << 100.0 * trial.projectionSuccessRate << "%, error "
+                << scientific << setprecision(2) << trial.mappingError << ", "
+                << trial.secondsPerElement << " s/element" << (trial.isAccepted ? "" : " (rejected)");
+        INFO_OUT() << line.str() << endl;
+    }
+    INFO_OUT() << "Suggested elements of the IGAMortarMapper block of mapper \"" << name << "\":"
+            << endl;
+    stringstream xml;
+    writeXML(xml, suggested);
+    string line;
+    while (getline(xml, line))
+        INFO_OUT() << "    " << line << endl;
+}
+
+void IGAMortarMapperTuning::writeXML(std::ostream &out, const Parameters &parameters) {
+    out << "<surfaceProjection maxProjectionDistance=\"" << parameters.maxProjectionDistance
+            << "\" noInitialGuess=\"" << parameters.noInitialGuess
+            << "\" maxProjectionDistanceOnDifferentPatches=\""
+            << parameters.maxProjectionDistanceOnDifferentPatches << "\"/>" << endl;
+    out << "<newtonRaphsonSurface noIterations=\"" << parameters.noIterationsNewtonRaphson
+            << "\" tolProjection=\"" << parameters.tolProjectionNewtonRaphson << "\"/>" << endl;
+    out << "<newtonRaphsonBoundary noIterations=\"" << parameters.noIterationsNewtonRaphsonBoundary
+            << "\" tolProjection=\"" << parameters.tolProjectionNewtonRaphsonBoundary << "\"/>"
+            << endl;
+    out << "<bisectionBoundary noIterations=\"" << parameters.noIterationsBisection
+            << "\" tolProjection=\"" << parameters.tolProjectionBisection << "\"/>" << endl;
+    if (!parameters.isAutomaticNoGPTriangle || !parameters.isAutomaticNoGPQuadrilateral
+            || parameters.isAdaptiveIntegration) {
+        out << "<integration";
+        if (!parameters.isAutomaticNoGPTriangle)
+            out << " noGPTriangle=\"" << parameters.noGPTriangle << "\"";
+        if (!parameters.isAutomaticNoGPQuadrilateral)
+            out << " noGPQuadrilateral=\"" << parameters.noGPQuadrilateral << "\"";
+        if (parameters.isAdaptiveIntegration)
+            out << " adaptive=\"true\" tolAdaptive=\"" << parameters.tolAdaptiveIntegration << "\"";
+        out << "/>" << endl;
+    }
+}
+
+} /* namespace EMPIRE */
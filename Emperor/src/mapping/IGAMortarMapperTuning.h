@@ -0,0 +1,181 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file IGAMortarMapperTuning.h
+ * This file holds the class IGAMortarMapperTuning
+ * \date 10/15/2026
+ **************************************************************************************************/
+
+#ifndef IGAMORTARMAPPERTUNING_H_
+#define IGAMORTARMAPPERTUNING_H_
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+namespace EMPIRE {
+
+class AbstractMesh;
+class FEMesh;
+
+/********//**
+ * \brief Class IGAMortarMapperTuning looks for the cheapest projection and integration parameters
+ *        of an IGAMortarMapper. The coupling matrices are built on a sample of the elements of the
+ *        FE mesh, first with the configured parameters as the reference and then with cheaper
+ *        values of one parameter at a time. A value is kept if the share of the projected nodes
+ *        reaches the target, the coordinates mapped with it differ from the reference by at most
+ *        the target mapping error and the build is not slower per element.
+ ***********/
+class IGAMortarMapperTuning {
+public:
+    /// the parameters of the build which are tuned, as in the settings of the IGAMortarMapper
+    struct Parameters {
+        double maxProjectionDistance;
+        int noInitialGuess;
+        double maxProjectionDistanceOnDifferentPatches;
+        int noIterationsNewtonRaphson;
+        double tolProjectionNewtonRaphson;
+        int noIterationsNewtonRaphsonBoundary;
+        double tolProjectionNewtonRaphsonBoundary;
+        int noIterationsBisection;
+        double tolProjectionBisection;
+        bool isAutomaticNoGPTriangle;
+        int noGPTriangle;
+        bool isAutomaticNoGPQuadrilateral;
+        int noGPQuadrilateral;
+        bool isAdaptiveIntegration;
+        double tolAdaptiveIntegration;
+    };
+    /// the measurements of one build on the sample
+    struct Trial {
+        /// the changed parameter and its value
+        std::string description;
+        Parameters parameters;
+        /// share of the sample nodes projected onto the NURBS surface
+        double projectionSuccessRate;
+        /// relative difference of the mapped coordinates to those of the reference build
+        double mappingError;
+        /// wall time of the build divided by the number of sample elements
+        double secondsPerElement;
+        /// whether the trial reached the targets and is kept
+        bool isAccepted;
+    };
+
+    /***********************************************************************************************
+     * \brief Constructor, samples the elements of the FE mesh
+     * \param[in] _name name of the tuned mapper
+     * \param[in] _meshA mesh A of the mapper (either IGA or FE mesh)
+     * \param[in] _meshB mesh B of the mapper (either IGA or FE mesh)
+     * \param[in] _sampleSize the number of FE elements the trial builds use
+     * \param[in] _targetProjectionSuccessRate the least share of projected sample nodes
+     * \param[in] _targetMappingError the largest relative difference of the mapped coordinates to
+     *            those of the configured parameters
+     * \param[in] _numThreads number of threads of the trial builds
+     ***********/
+    IGAMortarMapperTuning(std::string _name, AbstractMesh *_meshA, AbstractMesh *_meshB,
+            int _sampleSize, double _targetProjectionSuccessRate, double _targetMappingError,
+            int _numThreads);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~IGAMortarMapperTuning();
+    /***********************************************************************************************
+     * \brief Sweep the parameters, starting from the configured ones
+     * \param[in] configured the parameters of the settings of the mapper
+     * \return the cheapest parameters found, the configured ones if the combination of the
+     *         cheaper values misses the targets
+     ***********/
+    Parameters tune(const Parameters &configured);
+    /***********************************************************************************************
+     * \brief Get the trials of the last tuning in the order they were built
+     * \return the trials
+     ***********/
+    const std::vector<Trial> &getTrials() const {
+        return trials;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of elements of the sample
+     * \return the number of elements
+     ***********/
+    int getNumSampleElems() const;
+    /***********************************************************************************************
+     * \brief Print the trials and the suggested parameters to the shell
+     * \param[in] suggested the result of tune
+     ***********/
+    void print(const Parameters &suggested) const;
+    /***********************************************************************************************
+     * \brief Write the parameters as the elements of the IGAMortarMapper block of the input file
+     * \param[in] out the stream
+     * \param[in] parameters the parameters
+     ***********/
+    static void writeXML(std::ostream &out, const Parameters &parameters);
+
+private:
+    /// name of the tuned mapper
+    std::string name;
+    /// the IGA mesh of the mapper
+    AbstractMesh *meshIGA;
+    /// the sample of the FE mesh of the mapper
+    FEMesh *sample;
+    /// whether mesh A of the mapper is the IGA mesh
+    bool isMeshAIGA;
+    /// the least share of projected sample nodes
+    double targetProjectionSuccessRate;
+    /// the largest relative difference of the mapped coordinates to the reference
+    double targetMappingError;
+    /// number of threads of the trial builds
+    int numThreads;
+    /// the coordinates mapped with the configured parameters, component after component
+    std::vector<double> referenceMappedCoordinates;
+    /// the trials of the last tuning
+    std::vector<Trial> trials;
+
+    /***********************************************************************************************
+     * \brief Create the sample of the FE mesh with every n-th element and its nodes
+     * \param[in] meshFE the FE mesh of the mapper
+     * \param[in] sampleSize the number of sample elements
+     * \return the sample, owned by the caller
+     ***********/
+    static FEMesh *createSample(FEMesh *meshFE, int sampleSize);
+    /***********************************************************************************************
+     * \brief Build the coupling matrices of the sample, map the coordinates and measure the build
+     * \param[in] description the changed parameter and its value
+     * \param[in] parameters the parameters of the build
+     * \param[out] mappedCoordinates the coordinates of mesh A mapped to mesh B
+     * \return the trial, not yet accepted
+     ***********/
+    Trial build(const std::string &description, const Parameters &parameters,
+            std::vector<double> &mappedCoordinates);
+    /***********************************************************************************************
+     * \brief Build a trial and accept it if it reaches the targets and is not slower than the best
+     *        trial so far
+     * \param[in] description the changed parameter and its value
+     * \param[in] parameters the parameters of the build
+     * \param[in] bestSecondsPerElement the time per element of the best trial so far
+     * \return whether the trial is accepted
+     ***********/
+    bool tryParameters(const std::string &description, const Parameters &parameters,
+            double bestSecondsPerElement);
+};
+
+} /* namespace EMPIRE */
+
+#endif /* IGAMORTARMAPPERTUNING_H_ */
@@ -273,6 +273,37 @@ void KinematicMotion::move(double *coordinates) const {
     vectorAddition(coordinates, translationVector);
 }
 
+void KinematicMotion::moveBatch(const double *in, double *out, int n, int numThreads) const {
+    double affine[12];
+    getAffineMatrix(affine);
+    transformBatch(affine, in, out, n, numThreads);
+}
+
+void KinematicMotion::getAffineMatrix(double *affine) const {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++)
+            affine[i * 4 + j] = rotationMatrix[i * 3 + j];
+        affine[i * 4 + 3] = translationVector[i];
+    }
+}
+
+void KinematicMotion::transformBatch(const double *affine, const double *in, double *out, int n,
+        int numThreads) {
+    // the entries in locals, such that the compiler knows they do not alias the points
+    const double a0 = affine[0], a1 = affine[1], a2 = affine[2], a3 = affine[3];
+    const double a4 = affine[4], a5 = affine[5], a6 = affine[6], a7 = affine[7];
+    const double a8 = affine[8], a9 = affine[9], a10 = affine[10], a11 = affine[11];
+#pragma omp parallel for simd num_threads(numThreads) if(numThreads > 1)
+    for (int i = 0; i < n; i++) {
+        double x = in[i * 3 + 0];
+        double y = in[i * 3 + 1];
+        double z = in[i * 3 + 2];
+        out[i * 3 + 0] = a0 * x + a1 * y + a2 * z + a3;
+        out[i * 3 + 1] = a4 * x + a5 * y + a6 * z + a7;
+        out[i * 3 + 2] = a8 * x + a9 * y + a10 * z + a11;
+    }
+}
+
 void KinematicMotion::checkRotationCorrectness() const {
     double M[9];
     double M_inv[9];
@@ -132,6 +132,30 @@ public:
      * \author Tianyang Wang
      ***********/
     void move(double *coordinates) const;
+    /***********************************************************************************************
+     * \brief Move many points like move(), the motion is composed once into a 3x4 matrix
+     * \param[in] in the coordinates of the points, x, y and z of each point
+     * \param[out] out the moved coordinates, may be in
+     * \param[in] n the number of points
+     * \param[in] numThreads the number of threads
+     ***********/
+    void moveBatch(const double *in, double *out, int n, int numThreads = 1) const;
+    /***********************************************************************************************
+     * \brief Get the motion as a row major 3x4 matrix [R|t], such that many points can be moved
+     *        by one matrix without composing the motion again
+     * \param[out] affine the 12 entries of the matrix
+     ***********/
+    void getAffineMatrix(double *affine) const;
+    /***********************************************************************************************
+     * \brief Move many points by a 3x4 matrix [R|t]: x = R*x + t
+     * \param[in] affine the row major matrix, see getAffineMatrix()
+     * \param[in] in the coordinates of the points, x, y and z of each point
+     * \param[out] out the moved coordinates, may be in
+     * \param[in] n the number of points
+     * \param[in] numThreads the number of threads
+     ***********/
+    static void transformBatch(const double *affine, const double *in, double *out, int n,
+            int numThreads = 1);
     /***********************************************************************************************
      * \brief Check the correctness of the rotation by checking whether the transpose is equal to the inverse
      * \author Tianyang Wang
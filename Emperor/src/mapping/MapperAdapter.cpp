@@ -25,29 +25,66 @@
 #include "NearestNeighborMapper.h"
 #include "BarycentricInterpolationMapper.h"
 #include "NearestElementMapper.h"
+#include "RBFMapper.h"
 #include "CurveSurfaceMapper.h"
 #include "AbstractMesh.h"
 #include "FEMesh.h"
+#include "FEMeshSpatialIndex.h"
 #include "IGAMesh.h"
 #include "SectionMesh.h"
 #include "IGAPatchSurface.h" 	
 #include "DataField.h"
 #include <iostream>
+#include <fstream>
 #include <assert.h>
 #include <stdlib.h>
+#include <math.h>
+#include <algorithm>
 #include "AuxiliaryParameters.h"
 #include "AbstractMapper.h"
+#include "CouplingMatricesCache.h"
+#include "LinearSolver.h"
+#include "Profiler.h"
+#include "BufferPool.h"
+#include "TaskPool.h"
 
 using namespace std;
 
 namespace EMPIRE {
 
+double MapperAdapter::couplingResidualRatio = 0.0;
+
 MapperAdapter::MapperAdapter(std::string _name, AbstractMesh *_meshA, AbstractMesh *_meshB) :
         name(_name), meshA(_meshA), meshB(_meshB) {
     mapperImpl = NULL;
+    couplingMatricesCacheDirectory = "";
+    iterativeSolverTolerance = 0.0;
+    iterativeSolverMaxIterations = 0;
+    inexactSolveForcing = 0.0;
+    inexactSolveMaxTolerance = 0.0;
+    linearSolver = MathLibrary::LinearSolverRegistry::DIRECT;
+    compactAfterBuild = false;
+    reorderCouplingMatrices = false;
+    singlePrecisionWeights = false;
+    explicitMappingOperator = false;
+    isConsistentMappingUsed = true;
+    isConservativeMappingUsed = true;
+    isOneDirectionBuilt = false;
+    numThreads = AuxiliaryParameters::mapperSetNumThreads;
+    ensembleBatch = NULL;
+    geometryUpdateThreshold = 0.0;
+    isMeshAMovedByClient = false;
+    isMeshBMovedByClient = false;
+    setConservationMonitor(0, 0.0);
+    buildStatisticsReport = false;
+    errorComputationThread = NULL;
+    numRunningErrorComputations = 0;
+    setErrorComputationSampling(1, false, false);
 }
 
 MapperAdapter::~MapperAdapter() {
+    delete errorComputationThread;
+    delete ensembleBatch;
     delete mapperImpl;
 }
 
@@ -55,7 +92,7 @@ void MapperAdapter::initMortarMapper(bool oppositeSurfaceNormal, bool dual,
         bool enforceConsistency) {
 
     MortarMapper::mklSetNumThreads = AuxiliaryParameters::mklSetNumThreads;
-    MortarMapper::mapperSetNumThreads = AuxiliaryParameters::mapperSetNumThreads;
+    MortarMapper::mapperSetNumThreads = numThreads;
 
     FEMesh *a = NULL;
     FEMesh *b = NULL;
@@ -82,10 +119,20 @@ void MapperAdapter::initMortarMapper(bool oppositeSurfaceNormal, bool dual,
 
     mapperImpl = new MortarMapper(a->numNodes, a->numElems, a->numNodesPerElem, a->nodes,
             a->nodeIDs, a->elems, b->numNodes, b->numElems, b->numNodesPerElem, b->nodes,
-            b->nodeIDs, b->elems, oppositeSurfaceNormal, dual, enforceConsistency);
+            b->nodeIDs, b->elems, oppositeSurfaceNormal, dual, enforceConsistency,
+            a->getConnectivity(), b->getConnectivity());
     MortarMapper* mapper = dynamic_cast<MortarMapper*>(mapperImpl);
     mapper->writeMode = this->writeMode;
-    mapper->buildCouplingMatrices();
+    mapper->setSharedSearchTree(a->getSpatialIndex()->getNodesTree());
+    mapper->setSharedElemGeometry(a->getElemGeometry(), b->getElemGeometry());
+
+    CouplingMatricesCache *cache = createCouplingMatricesCache("mortarMapper");
+    if (cache != NULL) {
+        cache->addToKey(oppositeSurfaceNormal);
+        cache->addToKey(dual);
+        cache->addToKey(enforceConsistency);
+    }
+    buildCouplingMatrices(cache);
 }
 
 void MapperAdapter::initIGAMortarMapper(bool _enforceConsistency, double _tolConsistency,
@@ -94,15 +141,18 @@ void MapperAdapter::initIGAMortarMapper(bool _enforceConsistency, double _tolCon
                                         int _noIterationsNewtonRaphsonBoundary, double _tolProjectionNewtonRaphsonBoundary,
                                         int _noIterationsBisection, double _tolProjectionBisection,
                                         bool _isAutomaticNoGPTriangle, int _noGPTriangle, bool _isAutomaticNoGPQuadrilateral, int _noGPQuadrilateral,
+                                        bool _isAdaptiveIntegration, double _tolAdaptiveIntegration,
                                         bool _isWeakCurveDirichletConditions, bool _isAutomaticPenaltyParametersWeakCurveDirichletConditions, bool _isPrimPrescribedWeakCurveDirichletConditions, bool _isSecBendingPrescribedWeakCurveDirichletConditions, bool _isSecTwistingPrescribedWeakCurveDirichletConditions, double _alphaPrimWeakCurveDirichletConditions, double _alphaSecBendingWeakCurveDirichletConditions, double _alphaSecTwistingWeakCurveDirichletConditions,
                                         bool _isWeakSurfaceDirichletConditions, bool _isAutomaticPenaltyParametersWeakSurfaceDirichletConditions, bool _isPrimPrescribedWeakSurfaceDirichletConditions, double _alphaPrimWeakSurfaceDirichletConditions,
                                         bool _isWeakPatchContinuityConditions, bool _isAutomaticPenaltyParametersWeakContinuityConditions, bool _isPrimCoupledWeakContinuityConditions, bool _isSecBendingCoupledWeakContinuityConditions, bool _isSecTwistingCoupledWeakContinuityConditions, double _alphaPrimWeakContinuityConditions, double _alphaSecBendingWeakContinuityConditions, double _alphaSecTwistingWeakContinuityConditions,
                                         bool _isStrongCurveDirichletConditions,
-                                        bool _isErrorComputation, bool _isDomainError, bool _isCurveError, bool _isInterfaceError) {
+                                        bool _isErrorComputation, bool _isDomainError, bool _isCurveError, bool _isInterfaceError,
+                                        bool _isCompactErrorStorage) {
 
     assert((meshA->type == EMPIRE_Mesh_FEMesh && meshB->type == EMPIRE_Mesh_IGAMesh) ||
            (meshB->type == EMPIRE_Mesh_FEMesh && meshA->type == EMPIRE_Mesh_IGAMesh));
 
+    IGAMortarMapper::mapperSetNumThreads = numThreads;
     mapperImpl = new IGAMortarMapper(name, meshA, meshB);
     IGAMortarMapper* mapper = dynamic_cast<IGAMortarMapper*>(mapperImpl);
     mapper->writeMode = this->writeMode;
@@ -111,7 +161,8 @@ void MapperAdapter::initIGAMortarMapper(bool _enforceConsistency, double _tolCon
     mapper->setParametersNewtonRaphson(_noIterationsNewton, _tolProjectionNewtonRaphson);
     mapper->setParametersNewtonRaphsonBoundary(_noIterationsNewtonRaphsonBoundary, _tolProjectionNewtonRaphsonBoundary);
     mapper->setParametersBisection(_noIterationsBisection, _tolProjectionBisection);
-    mapper->setParametersIntegration(_isAutomaticNoGPTriangle, _noGPTriangle, _isAutomaticNoGPQuadrilateral, _noGPQuadrilateral);
+    mapper->setParametersIntegration(_isAutomaticNoGPTriangle, _noGPTriangle, _isAutomaticNoGPQuadrilateral, _noGPQuadrilateral,
+                                     _isAdaptiveIntegration, _tolAdaptiveIntegration);
     mapper->setParametersWeakCurveDirichletConditions(_isWeakCurveDirichletConditions, _isAutomaticPenaltyParametersWeakCurveDirichletConditions,
                                                       _isPrimPrescribedWeakCurveDirichletConditions, _isSecBendingPrescribedWeakCurveDirichletConditions,
                                                       _isSecTwistingPrescribedWeakCurveDirichletConditions, _alphaPrimWeakCurveDirichletConditions,
@@ -123,9 +174,52 @@ void MapperAdapter::initIGAMortarMapper(bool _enforceConsistency, double _tolCon
                                                        _isSecTwistingCoupledWeakContinuityConditions, _alphaPrimWeakContinuityConditions,
                                                        _alphaSecBendingWeakContinuityConditions, _alphaSecTwistingWeakContinuityConditions);
     mapper->setParametersStrongCurveDirichletConditions(_isStrongCurveDirichletConditions);
-    mapper->setParametersErrorComputation(_isErrorComputation, _isDomainError, _isCurveError, _isInterfaceError);
+    mapper->setParametersErrorComputation(_isErrorComputation, _isDomainError, _isCurveError, _isInterfaceError,
+                                          _isCompactErrorStorage);
     mapper->initialize();
-    mapper->buildCouplingMatrices();
+
+    CouplingMatricesCache *cache = createCouplingMatricesCache("IGAMortarMapper");
+    if (cache != NULL) {
+        cache->addToKey(_enforceConsistency);
+        cache->addToKey(_tolConsistency);
+        cache->addToKey(_maxProjectionDistance);
+        cache->addToKey(_noInitialGuess);
+        cache->addToKey(_maxProjectionDistanceOnDifferentPatches);
+        cache->addToKey(_noIterationsNewton);
+        cache->addToKey(_tolProjectionNewtonRaphson);
+        cache->addToKey(_noIterationsNewtonRaphsonBoundary);
+        cache->addToKey(_tolProjectionNewtonRaphsonBoundary);
+        cache->addToKey(_noIterationsBisection);
+        cache->addToKey(_tolProjectionBisection);
+        cache->addToKey(_isAutomaticNoGPTriangle);
+        cache->addToKey(_noGPTriangle);
+        cache->addToKey(_isAutomaticNoGPQuadrilateral);
+        cache->addToKey(_noGPQuadrilateral);
+        cache->addToKey(_isAdaptiveIntegration);
+        cache->addToKey(_tolAdaptiveIntegration);
+        cache->addToKey(_isWeakCurveDirichletConditions);
+        cache->addToKey(_isAutomaticPenaltyParametersWeakCurveDirichletConditions);
+        cache->addToKey(_isPrimPrescribedWeakCurveDirichletConditions);
+        cache->addToKey(_isSecBendingPrescribedWeakCurveDirichletConditions);
+        cache->addToKey(_isSecTwistingPrescribedWeakCurveDirichletConditions);
+        cache->addToKey(_alphaPrimWeakCurveDirichletConditions);
+        cache->addToKey(_alphaSecBendingWeakCurveDirichletConditions);
+        cache->addToKey(_alphaSecTwistingWeakCurveDirichletConditions);
+        cache->addToKey(_isWeakSurfaceDirichletConditions);
+        cache->addToKey(_isAutomaticPenaltyParametersWeakSurfaceDirichletConditions);
+        cache->addToKey(_isPrimPrescribedWeakSurfaceDirichletConditions);
+        cache->addToKey(_alphaPrimWeakSurfaceDirichletConditions);
+        cache->addToKey(_isWeakPatchContinuityConditions);
+        cache->addToKey(_isAutomaticPenaltyParametersWeakContinuityConditions);
+        cache->addToKey(_isPrimCoupledWeakContinuityConditions);
+        cache->addToKey(_isSecBendingCoupledWeakContinuityConditions);
+        cache->addToKey(_isSecTwistingCoupledWeakContinuityConditions);
+        cache->addToKey(_alphaPrimWeakContinuityConditions);
+        cache->addToKey(_alphaSecBendingWeakContinuityConditions);
+        cache->addToKey(_alphaSecTwistingWeakContinuityConditions);
+        cache->addToKey(_isStrongCurveDirichletConditions);
+    }
+    buildCouplingMatrices(cache);
 }
 
 void MapperAdapter::initIGABarycentricMapper(double _maxProjectionDistance, int _numRefinementForIntialGuess,
@@ -164,7 +258,8 @@ void MapperAdapter::initNearestNeighborMapper() {
     mapperImpl = new NearestNeighborMapper(a->numNodes, a->nodes, b->numNodes, b->nodes);
     NearestNeighborMapper* mapper = dynamic_cast<NearestNeighborMapper*>(mapperImpl);
     mapper->writeMode = this->writeMode;
-    mapper->buildCouplingMatrices();
+    mapper->setSharedSearchTree(a->getSpatialIndex()->getNodesTree());
+    buildCouplingMatrices(NULL);
 }
 
 void MapperAdapter::initBarycentricInterpolationMapper() {
@@ -178,7 +273,8 @@ void MapperAdapter::initBarycentricInterpolationMapper() {
     mapperImpl = new BarycentricInterpolationMapper(a->numNodes, a->nodes, b->numNodes, b->nodes);
     BarycentricInterpolationMapper* mapper = dynamic_cast<BarycentricInterpolationMapper*>(mapperImpl);
     mapper->writeMode = this->writeMode;
-    mapper->buildCouplingMatrices();
+    mapper->setSharedSearchTree(a->getSpatialIndex()->getNodesTree());
+    buildCouplingMatrices(NULL);
 }
 
 void MapperAdapter::initNearestElementMapper() {
@@ -188,14 +284,33 @@ void MapperAdapter::initNearestElementMapper() {
     FEMesh *a = dynamic_cast<FEMesh *>(meshA);
     FEMesh *b = dynamic_cast<FEMesh *>(meshB);
     assert(mapperImpl == NULL);
-    NearestElementMapper::mapperSetNumThreads = AuxiliaryParameters::mapperSetNumThreads;
+    NearestElementMapper::mapperSetNumThreads = numThreads;
 
     mapperImpl = new NearestElementMapper(a->numNodes, a->numElems, a->numNodesPerElem, a->nodes,
             a->nodeIDs, a->elems, b->numNodes, b->numElems, b->numNodesPerElem, b->nodes,
             b->nodeIDs, b->elems);
     NearestElementMapper* mapper = dynamic_cast<NearestElementMapper*>(mapperImpl);
     mapper->writeMode = this->writeMode;
-    mapper->buildCouplingMatrices();
+    mapper->setSharedSearchTree(a->getSpatialIndex()->getElemAABBTree());
+    mapper->setSharedConnectivity(a->getConnectivity());
+    mapper->setSharedElemGeometry(a->getElemGeometry());
+    buildCouplingMatrices(NULL);
+}
+
+void MapperAdapter::initRBFMapper(int numNodesPerPatch) {
+    assert(meshA->type == EMPIRE_Mesh_FEMesh || meshA->type == EMPIRE_Mesh_SectionMesh);
+    assert(meshB->type == EMPIRE_Mesh_FEMesh || meshB->type == EMPIRE_Mesh_SectionMesh);
+
+    FEMesh *a = dynamic_cast<FEMesh *>(meshA);
+    FEMesh *b = dynamic_cast<FEMesh *>(meshB);
+    assert(mapperImpl == NULL);
+    RBFMapper::mapperSetNumThreads = numThreads;
+
+    mapperImpl = new RBFMapper(a->numNodes, a->nodes, b->numNodes, b->nodes, numNodesPerPatch);
+    RBFMapper* mapper = dynamic_cast<RBFMapper*>(mapperImpl);
+    mapper->writeMode = this->writeMode;
+    mapper->setSharedSearchTree(a->getSpatialIndex()->getNodesTree());
+    buildCouplingMatrices(NULL);
 }
 
 void MapperAdapter::initCurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type type) {
@@ -205,14 +320,357 @@ void MapperAdapter::initCurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type type)
     FEMesh *a = dynamic_cast<FEMesh *>(meshA);
     SectionMesh *b = dynamic_cast<SectionMesh *>(meshB);
     assert(mapperImpl == NULL);
+    CurveSurfaceMapper::mapperSetNumThreads = numThreads;
     mapperImpl = new CurveSurfaceMapper(type, a->numNodes, a->numElems, a->nodes, a->nodeIDs,
             a->elems, b->numNodes, b->nodes, b->getNumSections(), b->getNumRootSectionNodes(),
             b->getNumNormalSectionNodes(), b->getNumTipSectionNodes(), b->getRotationGlobal2Root(),
             b->getTranslationGlobal2Root());
 }
 
-void MapperAdapter::consistentMapping(const DataField *fieldA, DataField *fieldB) {
+CouplingMatricesCache *MapperAdapter::createCouplingMatricesCache(std::string mapperTypeName) {
+    if (couplingMatricesCacheDirectory.empty())
+        return NULL;
+    CouplingMatricesCache *cache = new CouplingMatricesCache(couplingMatricesCacheDirectory, name);
+    cache->addToKey(mapperTypeName);
+    cache->addMeshToKey(meshA);
+    cache->addMeshToKey(meshB);
+    return cache;
+}
+
+void MapperAdapter::buildCouplingMatrices(CouplingMatricesCache *cache) {
+    assert(mapperImpl != NULL);
+    PROFILER_SCOPE("build coupling matrices of " + name);
+    if (iterativeSolverTolerance > 0.0) {
+        if (mapperImpl->isIterativeSolverSupported())
+            mapperImpl->setIterativeSolver(iterativeSolverTolerance, iterativeSolverMaxIterations);
+        else
+            WARNING_OUT() << "MapperAdapter: mapper \"" << name
+                    << "\" does not support the iterative solver, the direct solver is used" << endl;
+    }
+    mapperImpl->setLinearSolver(linearSolver);
+    mapperImpl->setPardisoSettings(pardisoSettings);
+    if (compactAfterBuild) {
+        if (mapperImpl->isCompactAfterBuildSupported())
+            mapperImpl->setCompactAfterBuild(true);
+        else
+            WARNING_OUT() << "MapperAdapter: mapper \"" << name
+                    << "\" does not support compactAfterBuild, its build data is kept" << endl;
+    }
+    if (reorderCouplingMatrices) {
+        if (mapperImpl->isReorderCouplingMatricesSupported())
+            mapperImpl->setReorderCouplingMatrices(true);
+        else
+            WARNING_OUT() << "MapperAdapter: mapper \"" << name
+                    << "\" does not support reorderCouplingMatrices, the order is kept" << endl;
+    }
+    if (singlePrecisionWeights) {
+        if (mapperImpl->isSinglePrecisionWeightsSupported())
+            mapperImpl->setSinglePrecisionWeights(true);
+        else
+            WARNING_OUT() << "MapperAdapter: mapper \"" << name
+                    << "\" does not support singlePrecisionWeights, double precision is used" << endl;
+    }
+    if (explicitMappingOperator) {
+        if (mapperImpl->isExplicitMappingOperatorSupported())
+            mapperImpl->setExplicitMappingOperator(true);
+        else
+            WARNING_OUT() << "MapperAdapter: mapper \"" << name
+                    << "\" does not support explicitMappingOperator, the coupling matrices are used" << endl;
+    }
+    if (!(isConsistentMappingUsed && isConservativeMappingUsed)
+            && mapperImpl->isMappingDirectionsSupported()) {
+        mapperImpl->setMappingDirections(isConsistentMappingUsed, isConservativeMappingUsed);
+        isOneDirectionBuilt = true;
+        INFO_OUT() << "MapperAdapter: mapper \"" << name << "\" is built for "
+                << (isConsistentMappingUsed ? "consistent" : "conservative") << " mapping only" << endl;
+    }
+    if (cache == NULL || !mapperImpl->isCouplingMatricesCacheSupported()) {
+        mapperImpl->buildCouplingMatrices();
+    } else if (cache->load() && mapperImpl->readCouplingMatricesFromCache(cache)) {
+        INFO_OUT() << "MapperAdapter: coupling matrices of mapper \"" << name << "\" read from \""
+                << cache->getFileName() << "\"" << endl;
+    } else {
+        mapperImpl->buildCouplingMatrices();
+        mapperImpl->writeCouplingMatricesToCache(cache);
+        cache->save();
+    }
+    delete cache;
+    getMemoryUsage().print("mapper \"" + name + "\"");
+    reportBuildStatistics();
+}
+
+MemoryUsage MapperAdapter::getMemoryUsage() const {
+    assert(mapperImpl != NULL);
+    return mapperImpl->getMemoryUsage();
+}
+
+MapperBuildStatistics MapperAdapter::getBuildStatistics() const {
+    assert(mapperImpl != NULL);
+    return mapperImpl->getBuildStatistics();
+}
+
+void MapperAdapter::reportBuildStatistics() const {
+    if (!buildStatisticsReport)
+        return;
+    MapperBuildStatistics statistics = getBuildStatistics();
+    statistics.print("mapper \"" + name + "\"");
+    string fileName = name + "_buildStatistics.json";
+    ofstream file(fileName.c_str());
+    if (!file) {
+        WARNING_OUT() << "MapperAdapter: cannot write the build statistics to \"" << fileName << "\"" << endl;
+        return;
+    }
+    statistics.writeJSON(file, name);
+}
+
+/***********************************************************************************************
+ * \brief Copy the moved nodes of a FE mesh to its triangulated copy, on which the mappers work
+ * \param[in] mesh the mesh
+ ***********/
+static void updateTriangulatedNodes(AbstractMesh *mesh) {
+    FEMesh *feMesh = dynamic_cast<FEMesh *>(mesh);
+    if (feMesh == NULL || feMesh->triangulate() == NULL)
+        return;
+    FEMesh *triangulatedMesh = feMesh->triangulate();
+    assert(triangulatedMesh->numNodes == feMesh->numNodes);
+    for (int i = 0; i < feMesh->numNodes * 3; i++)
+        triangulatedMesh->nodes[i] = feMesh->nodes[i];
+}
+
+void MapperAdapter::updateGeometry() {
+    assert(mapperImpl != NULL);
+    if (!mapperImpl->isGeometryUpdateSupported()) {
+        ERROR_OUT() << "Error in MapperAdapter::updateGeometry" << endl;
+        ERROR_OUT() << "Mapper \"" << name << "\" does not support geometry updates!" << endl;
+        exit(-1);
+    }
+    waitForErrorComputation();
+    updateTriangulatedNodes(meshA);
+    updateTriangulatedNodes(meshB);
+    meshA->updateContentHash();
+    meshB->updateContentHash();
+    mapperImpl->updateGeometry();
+    reportBuildStatistics();
+}
+
+/***********************************************************************************************
+ * \brief Find the nodes which moved further than the threshold since the mapper was last updated
+ * \param[in] mesh the mesh
+ * \param[in] newNodes the new coordinates of the nodes of the mesh
+ * \param[in] threshold the distance a node has to move to count as moved
+ * \param[in,out] buildNodes the coordinates the mapper was last updated with, the moved nodes are
+ *                 set to their new coordinates. If empty, it is initialized with the nodes of mesh
+ * \param[out] movedNodes the positions of the moved nodes
+ ***********/
+static void findMovedNodes(const FEMesh *mesh, const double *newNodes, double threshold,
+        vector<double> &buildNodes, vector<int> &movedNodes) {
+    if (buildNodes.empty())
+        buildNodes.assign(mesh->nodes, mesh->nodes + mesh->numNodes * 3);
+    for (int i = 0; i < mesh->numNodes; i++) {
+        double distanceSquare = 0.0;
+        for (int k = 0; k < 3; k++)
+            distanceSquare += (newNodes[i * 3 + k] - buildNodes[i * 3 + k])
+                    * (newNodes[i * 3 + k] - buildNodes[i * 3 + k]);
+        if (distanceSquare > threshold * threshold) {
+            movedNodes.push_back(i);
+            for (int k = 0; k < 3; k++)
+                buildNodes[i * 3 + k] = newNodes[i * 3 + k];
+        }
+    }
+}
+
+/***********************************************************************************************
+ * \brief Copy the new coordinates into a mesh and discard what was computed from the old ones
+ * \param[in] mesh the mesh
+ * \param[in] newNodes the new coordinates of the nodes of the mesh
+ ***********/
+static void moveNodes(FEMesh *mesh, const double *newNodes) {
+    for (int i = 0; i < mesh->numNodes * 3; i++)
+        mesh->nodes[i] = newNodes[i];
+    mesh->invalidateSpatialIndex(); // also copies the nodes to the triangulated mesh
+    mesh->updateContentHash();
+}
+
+bool MapperAdapter::updateGeometry(const double *newNodesA, const double *newNodesB) {
+    assert(mapperImpl != NULL);
+    FEMesh *feMeshA = dynamic_cast<FEMesh *>(meshA);
+    FEMesh *feMeshB = dynamic_cast<FEMesh *>(meshB);
+    if ((newNodesA != NULL && feMeshA == NULL) || (newNodesB != NULL && feMeshB == NULL)) {
+        ERROR_OUT() << "Error in MapperAdapter::updateGeometry" << endl;
+        ERROR_OUT() << "Only the nodes of FE meshes can be moved!" << endl;
+        exit(-1);
+    }
+    PROFILER_SCOPE("update geometry of " + name);
+    waitForErrorComputation();
+    vector<int> movedNodesA, movedNodesB;
+    if (newNodesA != NULL)
+        findMovedNodes(feMeshA, newNodesA, geometryUpdateThreshold, buildNodesA, movedNodesA);
+    if (newNodesB != NULL)
+        findMovedNodes(feMeshB, newNodesB, geometryUpdateThreshold, buildNodesB, movedNodesB);
+    if (movedNodesA.empty() && movedNodesB.empty())
+        return false;
+    if (!mapperImpl->isPartialGeometryUpdateSupported() && !mapperImpl->isGeometryUpdateSupported()) {
+        ERROR_OUT() << "Error in MapperAdapter::updateGeometry" << endl;
+        ERROR_OUT() << "Mapper \"" << name << "\" does not support geometry updates!" << endl;
+        exit(-1);
+    }
+    if (newNodesA != NULL)
+        moveNodes(feMeshA, newNodesA);
+    if (newNodesB != NULL)
+        moveNodes(feMeshB, newNodesB);
+    INFO_OUT() << "MapperAdapter: " << movedNodesA.size() << " nodes of A and "
+            << movedNodesB.size() << " nodes of B of mapper \"" << name << "\" moved" << endl;
+    if (mapperImpl->isPartialGeometryUpdateSupported())
+        mapperImpl->updateGeometry(movedNodesA, movedNodesB);
+    else
+        mapperImpl->updateGeometry();
+    reportBuildStatistics();
+    return true;
+}
+
+void MapperAdapter::setMeshMotion(std::string dataFieldA, std::string dataFieldB,
+        double threshold) {
+    FEMesh *feMeshA = dynamic_cast<FEMesh *>(meshA);
+    FEMesh *feMeshB = dynamic_cast<FEMesh *>(meshB);
+    if ((dataFieldA != "" && feMeshA == NULL) || (dataFieldB != "" && feMeshB == NULL)) {
+        ERROR_OUT() << "Error in MapperAdapter::setMeshMotion" << endl;
+        ERROR_OUT() << "Only the nodes of FE meshes can be moved!" << endl;
+        exit(-1);
+    }
+    meshMotionA = dataFieldA;
+    meshMotionB = dataFieldB;
+    geometryUpdateThreshold = threshold;
+    referenceNodesA.clear();
+    referenceNodesB.clear();
+    if (meshMotionA != "")
+        referenceNodesA.assign(feMeshA->nodes, feMeshA->nodes + feMeshA->numNodes * 3);
+    if (meshMotionB != "")
+        referenceNodesB.assign(feMeshB->nodes, feMeshB->nodes + feMeshB->numNodes * 3);
+}
+
+void MapperAdapter::setMeshMovedByClient(bool movedA, bool movedB, double threshold) {
+    FEMesh *feMeshA = dynamic_cast<FEMesh *>(meshA);
+    FEMesh *feMeshB = dynamic_cast<FEMesh *>(meshB);
+    if ((movedA && feMeshA == NULL) || (movedB && feMeshB == NULL)) {
+        ERROR_OUT() << "Error in MapperAdapter::setMeshMovedByClient" << endl;
+        ERROR_OUT() << "Only the nodes of FE meshes can be moved!" << endl;
+        exit(-1);
+    }
+    if ((movedA && meshMotionA != "") || (movedB && meshMotionB != "")) {
+        ERROR_OUT() << "Mapper \"" << name
+                << "\" cannot move a mesh both by a displacement field and by its client!" << endl;
+        exit(-1);
+    }
+    isMeshAMovedByClient = movedA;
+    isMeshBMovedByClient = movedB;
+    geometryUpdateThreshold = threshold;
+    // the mapper is built with the nodes at hand, which the client overwrites later on
+    if (movedA)
+        buildNodesA.assign(feMeshA->nodes, feMeshA->nodes + feMeshA->numNodes * 3);
+    if (movedB)
+        buildNodesB.assign(feMeshB->nodes, feMeshB->nodes + feMeshB->numNodes * 3);
+}
+
+/***********************************************************************************************
+ * \brief Add a displacement data field to the reference coordinates of a mesh
+ * \param[in] mesh the mesh
+ * \param[in] dataFieldName the name of the displacement data field
+ * \param[in] referenceNodes the coordinates of the nodes as received
+ * \param[out] newNodes the displaced coordinates
+ ***********/
+static void computeDisplacedNodes(AbstractMesh *mesh, const std::string &dataFieldName,
+        const vector<double> &referenceNodes, vector<double> &newNodes) {
+    const DataField *displacements = mesh->getDataFieldByName(dataFieldName);
+    assert(displacements->dimension == EMPIRE_DataField_vector);
+    assert(displacements->numLocations * 3 == referenceNodes.size());
+    newNodes.resize(referenceNodes.size());
+    for (int i = 0; i < referenceNodes.size(); i++)
+        newNodes[i] = referenceNodes[i] + displacements->data[i];
+}
+
+/***********************************************************************************************
+ * \brief Copy the nodes a client has moved in place, they are compared with the nodes the mapper
+ *        was last updated with
+ * \param[in] mesh the FE mesh
+ * \param[out] newNodes the coordinates of the nodes of the mesh
+ ***********/
+static void copyNodes(AbstractMesh *mesh, vector<double> &newNodes) {
+    const FEMesh *feMesh = dynamic_cast<FEMesh *>(mesh);
+    newNodes.assign(feMesh->nodes, feMesh->nodes + feMesh->numNodes * 3);
+}
+
+void MapperAdapter::applyMeshMotion() {
+    if (meshMotionA == "" && meshMotionB == "" && !isMeshAMovedByClient && !isMeshBMovedByClient)
+        return;
+    vector<double> newNodesA, newNodesB;
+    if (meshMotionA != "")
+        computeDisplacedNodes(meshA, meshMotionA, referenceNodesA, newNodesA);
+    else if (isMeshAMovedByClient)
+        copyNodes(meshA, newNodesA);
+    if (meshMotionB != "")
+        computeDisplacedNodes(meshB, meshMotionB, referenceNodesB, newNodesB);
+    else if (isMeshBMovedByClient)
+        copyNodes(meshB, newNodesB);
+    updateGeometry(newNodesA.empty() ? NULL : &newNodesA[0],
+            newNodesB.empty() ? NULL : &newNodesB[0]);
+}
+
+void MapperAdapter::adaptIterativeSolverTolerance() {
+    if (inexactSolveForcing <= 0.0 || iterativeSolverTolerance <= 0.0
+            || !mapperImpl->isIterativeSolverSupported())
+        return;
+    // far from convergence the solve may be as inexact as the coupling, near it the tolerance is the configured one
+    double tolerance = iterativeSolverTolerance * max(1.0, inexactSolveForcing * couplingResidualRatio);
+    tolerance = max(iterativeSolverTolerance, min(tolerance, inexactSolveMaxTolerance));
+    mapperImpl->setIterativeSolverTolerance(tolerance);
+}
+
+void MapperAdapter::setEnsemble(int numReplicas, double batchWindow) {
+    delete ensembleBatch;
+    ensembleBatch = NULL;
+    replicaMeshesA.clear();
+    replicaMeshesB.clear();
+    if (numReplicas > 1 && (meshMotionA != "" || meshMotionB != "" || isMeshAMovedByClient
+            || isMeshBMovedByClient)) {
+        ERROR_OUT() << "Mapper \"" << name << "\" cannot move its meshes in an ensemble!" << endl;
+        exit(-1);
+    }
+    if (numReplicas > 1)
+        ensembleBatch = new EnsembleMappingBatch(this, numReplicas, batchWindow);
+}
+
+void MapperAdapter::addReplicaMeshes(AbstractMesh *replicaMeshA, AbstractMesh *replicaMeshB) {
+    replicaMeshesA.push_back(replicaMeshA);
+    replicaMeshesB.push_back(replicaMeshB);
+}
+
+void MapperAdapter::replicaFinished() {
+    if (ensembleBatch != NULL)
+        ensembleBatch->replicaFinished();
+}
+
+void MapperAdapter::consistentMapping(const DataField *fieldA, DataField *fieldB, double outputFactor) {
     assert(mapperImpl != NULL);
+    if (isOneDirectionBuilt && !isConsistentMappingUsed) {
+        ERROR_OUT() << "Mapper \"" << name << "\" is built for conservative mapping only!" << endl;
+        exit(-1);
+    }
+    assert(outputFactor != 0.0);
+    applyMeshMotion();
+    adaptIterativeSolverTolerance();
+    if (ensembleBatch != NULL) {
+        ensembleBatch->map(true, fieldA, fieldB, outputFactor);
+    } else {
+        mapConsistently(fieldA, fieldB, outputFactor);
+        monitoredFieldA = fieldA;
+        monitoredFieldB = fieldB;
+    }
+}
+
+void MapperAdapter::mapConsistently(const DataField *fieldA, DataField *fieldB, double outputFactor) {
+    // The factor is folded into the write of the output, unless the mapping error is computed from the unscaled output
+    bool isErrorComputation = dynamic_cast<IGAMortarMapper *>(mapperImpl) != NULL && dynamic_cast<IGAMortarMapper *>(mapperImpl)->getIsErrorComputation();
+    bool isOutputFactorFolded = false;
 
     // 1. Do the consistent mapping
     if (dynamic_cast<CurveSurfaceMapper *>(mapperImpl) != NULL) { // CurveSurfaceMappers map DOFs together
@@ -251,27 +709,289 @@ void MapperAdapter::consistentMapping(const DataField *fieldA, DataField *fieldB
         assert(fieldA->numLocations == numNodesA);
         assert(fieldB->numLocations == numNodesB);
 
-        double *fieldADOFi = new double[fieldA->numLocations];
-        double *fieldBDOFi = new double[fieldB->numLocations];
         int numDOFs = fieldA->dimension;
-        for (int i = 0; i < numDOFs; i++) {
-            for (int j = 0; j < fieldA->numLocations; j++)
-                fieldADOFi[j] = fieldA->data[j * numDOFs + i];
-            mapperImpl->consistentMapping(fieldADOFi, fieldBDOFi);
-            for (int j = 0; j < fieldB->numLocations; j++)
-                fieldB->data[j * numDOFs + i] = fieldBDOFi[j];
+        if (mapperImpl->isBlockMappingSupported()) { // map all DOFs together without splitting the field
+            mapperImpl->consistentBlockMapping(fieldA->data, fieldB->data, numDOFs);
+        } else {
+            BufferPool::Buffer fieldADOFi(fieldA->numLocations);
+            BufferPool::Buffer fieldBDOFi(fieldB->numLocations);
+            isOutputFactorFolded = !isErrorComputation;
+            double factor = isOutputFactorFolded ? outputFactor : 1.0;
+            for (int i = 0; i < numDOFs; i++) {
+                for (int j = 0; j < fieldA->numLocations; j++)
+                    fieldADOFi[j] = fieldA->data[j * numDOFs + i];
+                for (int j = 0; j < fieldB->numLocations; j++) // initial guess of iterative solvers
+                    fieldBDOFi[j] = fieldB->data[j * numDOFs + i] / factor;
+                mapperImpl->consistentMapping(fieldADOFi.data(), fieldBDOFi.data());
+                for (int j = 0; j < fieldB->numLocations; j++)
+                    fieldB->data[j * numDOFs + i] = factor * fieldBDOFi[j];
+            }
+        }
+    }
+
+    // 2. Compute the mapping error, or keep the fields for the end of the time step
+    if (isErrorComputation) {
+        if (errorComputationAtTimeStepEnd) {
+            errorFieldA = fieldA;
+            errorFieldB = fieldB;
+            errorOutputFactor = outputFactor;
+        } else if (++numErrorSamples % errorComputationInterval == 0) {
+            computeErrors(fieldA, fieldB, 1.0);
         }
-        delete[] fieldADOFi;
-        delete[] fieldBDOFi;
     }
 
-    // 2. Compute the mapping error
-    if (dynamic_cast<IGAMortarMapper *>(mapperImpl) != NULL && dynamic_cast<IGAMortarMapper *>(mapperImpl)->getIsErrorComputation())
+    // 3. Scale the output if the factor could not be folded into its write
+    if (outputFactor != 1.0 && !isOutputFactorFolded)
+        for (int i = 0; i < fieldB->numLocations * fieldB->dimension; i++)
+            fieldB->data[i] *= outputFactor;
+}
+
+/********//**
+ * \brief Class MappingErrorTask computes the errors of a consistent mapping from copies of its fields
+ *        on the background thread of the MapperAdapter
+ ***********/
+class MappingErrorTask: public AbstractTask {
+public:
+    MappingErrorTask(AbstractMapper *_mapper, const BufferPool::Buffer &_fieldA,
+            const BufferPool::Buffer &_fieldB, int *_numRunning) :
+            mapper(_mapper), fieldA(_fieldA), fieldB(_fieldB), numRunning(_numRunning) {
+    }
+    void execute() {
+        mapper->computeErrorsConsistentMapping(fieldA.data(), fieldB.data());
+#pragma omp atomic
+        (*numRunning)--;
+    }
+private:
+    /// the mapper
+    AbstractMapper *mapper;
+    /// the copy of the input of the mapping
+    BufferPool::Buffer fieldA;
+    /// the copy of the unscaled output of the mapping
+    BufferPool::Buffer fieldB;
+    /// the number of running error computations of the MapperAdapter
+    int *numRunning;
+};
+
+void MapperAdapter::setErrorComputationSampling(int interval, bool atTimeStepEnd,
+        bool background) {
+    assert(interval > 0);
+    waitForErrorComputation();
+    delete errorComputationThread;
+    errorComputationThread = background ? new TaskPool(1) : NULL;
+    errorComputationInterval = interval;
+    errorComputationAtTimeStepEnd = atTimeStepEnd;
+    errorComputationInBackground = background;
+    numErrorSamples = 0;
+    errorFieldA = NULL;
+    errorFieldB = NULL;
+    errorOutputFactor = 1.0;
+}
+
+void MapperAdapter::computeErrorsAtTimeStepEnd() {
+    if (!errorComputationAtTimeStepEnd || errorFieldA == NULL)
+        return;
+    if (++numErrorSamples % errorComputationInterval == 0)
+        computeErrors(errorFieldA, errorFieldB, errorOutputFactor);
+    errorFieldA = NULL;
+    errorFieldB = NULL;
+}
+
+void MapperAdapter::waitForErrorComputation() {
+    if (errorComputationThread != NULL)
+        errorComputationThread->wait();
+}
+
+void MapperAdapter::computeErrors(const DataField *fieldA, const DataField *fieldB,
+        double outputFactor) {
+    if (!errorComputationInBackground && outputFactor == 1.0) {
         mapperImpl->computeErrorsConsistentMapping(fieldA->data, fieldB->data);
+        return;
+    }
+    int numRunning;
+#pragma omp atomic read
+    numRunning = numRunningErrorComputations;
+    if (numRunning > 0) {
+        Profiler::addCount("skipped mapping error samples of " + name, 1.0);
+        return;
+    }
+    // the errors are computed from the unscaled output
+    int sizeA = fieldA->numLocations * fieldA->dimension;
+    int sizeB = fieldB->numLocations * fieldB->dimension;
+    BufferPool::Buffer copyA(sizeA);
+    BufferPool::Buffer copyB(sizeB);
+    for (int i = 0; i < sizeA; i++)
+        copyA[i] = fieldA->data[i];
+    for (int i = 0; i < sizeB; i++)
+        copyB[i] = fieldB->data[i] / outputFactor;
+    if (errorComputationInBackground) {
+#pragma omp atomic
+        numRunningErrorComputations++;
+        errorComputationThread->push(new MappingErrorTask(mapperImpl, copyA, copyB,
+                &numRunningErrorComputations));
+    } else {
+        mapperImpl->computeErrorsConsistentMapping(copyA.data(), copyB.data());
+    }
+}
+
+bool MapperAdapter::isRowBlockMappingSupported() const {
+    return mapperImpl != NULL && ensembleBatch == NULL && meshMotionA == "" && meshMotionB == ""
+            && !isMeshAMovedByClient && !isMeshBMovedByClient
+            && (!isOneDirectionBuilt || isConsistentMappingUsed)
+            && mapperImpl->isRowBlockMappingSupported();
+}
+
+bool MapperAdapter::isMappingOperatorExportSupported() const {
+    return mapperImpl != NULL && meshMotionA == "" && meshMotionB == "" && !isMeshAMovedByClient
+            && !isMeshBMovedByClient && mapperImpl->isMappingOperatorExportSupported();
+}
+
+void MapperAdapter::getMappingOperator(int &numRows, int &numColumns,
+        std::vector<int> &rowPointers, std::vector<int> &columnIndices,
+        std::vector<double> &values, bool clientOrder) const {
+    assert(isMappingOperatorExportSupported());
+    const FEMesh *feMeshA = dynamic_cast<const FEMesh *>(meshA);
+    const FEMesh *feMeshB = dynamic_cast<const FEMesh *>(meshB);
+    assert(feMeshA != NULL && feMeshB != NULL);
+    numRows = feMeshB->numNodes;
+    numColumns = feMeshA->numNodes;
+    mapperImpl->getMappingOperator(rowPointers, columnIndices, values);
+    assert(rowPointers.size() == numRows + 1);
+    if (!clientOrder || (!feMeshA->isRenumbered() && !feMeshB->isRenumbered()))
+        return;
+    // the client position of every node of the mapper, found by renumbering the positions
+    vector<double> clientPositions(max(numRows, numColumns));
+    for (int i = 0; i < clientPositions.size(); i++)
+        clientPositions[i] = i;
+    vector<double> clientPosA(clientPositions.begin(), clientPositions.begin() + numColumns);
+    vector<double> clientPosB(clientPositions.begin(), clientPositions.begin() + numRows);
+    if (feMeshA->isRenumbered())
+        feMeshA->fromClientOrder(EMPIRE_DataField_atNode, 1, &clientPositions[0], &clientPosA[0]);
+    if (feMeshB->isRenumbered())
+        feMeshB->fromClientOrder(EMPIRE_DataField_atNode, 1, &clientPositions[0], &clientPosB[0]);
+    // the rows are sorted by their client positions, the columns renamed
+    vector<int> rowOfClientNode(numRows);
+    for (int i = 0; i < numRows; i++)
+        rowOfClientNode[(int) clientPosB[i]] = i;
+    vector<int> clientRowPointers(numRows + 1, 0);
+    vector<int> clientColumnIndices(columnIndices.size());
+    vector<double> clientValues(values.size());
+    for (int c = 0; c < numRows; c++) {
+        int row = rowOfClientNode[c];
+        int k = clientRowPointers[c];
+        for (int j = rowPointers[row]; j < rowPointers[row + 1]; j++, k++) {
+            clientColumnIndices[k] = (int) clientPosA[columnIndices[j]];
+            clientValues[k] = values[j];
+        }
+        clientRowPointers[c + 1] = k;
+    }
+    rowPointers.swap(clientRowPointers);
+    columnIndices.swap(clientColumnIndices);
+    values.swap(clientValues);
+}
+
+int MapperAdapter::getNumRequiredNodesA(int endNodeB) const {
+    return mapperImpl->getNumRequiredNodesA(endNodeB);
+}
+
+void MapperAdapter::consistentRowBlockMapping(const DataField *fieldA, DataField *fieldB,
+        int firstNodeB, int endNodeB, double outputFactor) {
+    assert(isRowBlockMappingSupported());
+    assert(fieldA->dimension == fieldB->dimension);
+    assert(outputFactor != 0.0);
+    int numDOFs = fieldB->dimension;
+    mapperImpl->consistentRowBlockMapping(fieldA->data, fieldB->data, numDOFs, firstNodeB,
+            endNodeB);
+    if (outputFactor != 1.0)
+        for (int i = firstNodeB * numDOFs; i < endNodeB * numDOFs; i++)
+            fieldB->data[i] *= outputFactor;
+}
+
+bool MapperAdapter::isIncrementalMappingSupported() const {
+    return mapperImpl != NULL && ensembleBatch == NULL && meshMotionA == "" && meshMotionB == ""
+            && !isMeshAMovedByClient && !isMeshBMovedByClient;
+}
+
+int MapperAdapter::consistentChangedRowsMapping(const DataField *fieldA, DataField *fieldB,
+        const char *isNodeAChanged) {
+    assert(isRowBlockMappingSupported());
+    assert(fieldA->dimension == fieldB->dimension);
+    return mapperImpl->consistentChangedRowsMapping(fieldA->data, fieldB->data, fieldB->dimension,
+            isNodeAChanged);
 }
 
-void MapperAdapter::conservativeMapping(const DataField *fieldB, DataField *fieldA) {
+void MapperAdapter::conservativeMapping(const DataField *fieldB, DataField *fieldA, double outputFactor) {
     assert(mapperImpl != NULL);
+    if (isOneDirectionBuilt && !isConservativeMappingUsed) {
+        ERROR_OUT() << "Mapper \"" << name << "\" is built for consistent mapping only!" << endl;
+        exit(-1);
+    }
+    assert(outputFactor != 0.0);
+    applyMeshMotion();
+    adaptIterativeSolverTolerance();
+    if (ensembleBatch != NULL) {
+        ensembleBatch->map(false, fieldB, fieldA, outputFactor);
+    } else {
+        mapConservatively(fieldB, fieldA, outputFactor);
+        monitorConservation(fieldB, fieldA);
+    }
+}
+
+/***********************************************************************************************
+ * \brief Reduce the virtual work of a force field on a displacement field and the squared norms of
+ *        both fields in one pass, the sums do not depend on the number of threads
+ * \param[in] size the size of the fields
+ * \param[in] displacements the displacement field, NULL if there is none
+ * \param[in] forces the force field
+ * \param[out] work the virtual work, 0 without displacements
+ * \param[out] squaredNormDisplacements the squared norm of the displacements, 0 without
+ * \param[out] squaredNormForces the squared norm of the forces
+ ***********/
+static void reduceWorkAndNorms(int size, const double *displacements, const double *forces,
+        double &work, double &squaredNormDisplacements, double &squaredNormForces) {
+    if (displacements != NULL) {
+        MathLibrary::computeReproducibleDotProducts(displacements, forces, size,
+                &squaredNormDisplacements, &work, &squaredNormForces);
+    } else {
+        work = 0.0;
+        squaredNormDisplacements = 0.0;
+        squaredNormForces = MathLibrary::computeReproducibleSquaredNorm(forces, size);
+    }
+}
+
+void MapperAdapter::monitorConservation(const DataField *fieldB, const DataField *fieldA) {
+    if (monitorInterval <= 0 || ++numMonitoredMappings % monitorInterval != 0)
+        return;
+    // the work is only defined if the displacements have the layout of the forces
+    bool hasDisplacements = monitoredFieldA != NULL
+            && monitoredFieldA->numLocations == fieldA->numLocations
+            && monitoredFieldA->dimension == fieldA->dimension
+            && monitoredFieldB->numLocations == fieldB->numLocations
+            && monitoredFieldB->dimension == fieldB->dimension;
+    double workA, workB, uuA, uuB, ffA, ffB;
+    reduceWorkAndNorms(fieldA->numLocations * fieldA->dimension,
+            hasDisplacements ? monitoredFieldA->data : NULL, fieldA->data, workA, uuA, ffA);
+    reduceWorkAndNorms(fieldB->numLocations * fieldB->dimension,
+            hasDisplacements ? monitoredFieldB->data : NULL, fieldB->data, workB, uuB, ffB);
+
+    string prefix = "mapper \"" + name + "\": ";
+    Profiler::setValue(prefix + "norm of forces A", sqrt(ffA));
+    Profiler::setValue(prefix + "norm of forces B", sqrt(ffB));
+    if (!hasDisplacements)
+        return;
+    double maxWork = max(fabs(workA), fabs(workB));
+    double relativeDifference = (maxWork > 0.0) ? fabs(workA - workB) / maxWork : 0.0;
+    Profiler::setValue(prefix + "norm of displacements A", sqrt(uuA));
+    Profiler::setValue(prefix + "norm of displacements B", sqrt(uuB));
+    Profiler::setValue(prefix + "virtual work A", workA);
+    Profiler::setValue(prefix + "virtual work B", workB);
+    Profiler::setValue(prefix + "relative virtual work difference", relativeDifference);
+    if (relativeDifference > monitorTolerance)
+        WARNING_OUT() << "Mapper \"" << name << "\" does not conserve the virtual work: "
+                << workA << " on A, " << workB << " on B" << endl;
+}
+
+void MapperAdapter::mapConservatively(const DataField *fieldB, DataField *fieldA, double outputFactor) {
+    bool isOutputFactorFolded = false;
     if (dynamic_cast<CurveSurfaceMapper *>(mapperImpl) != NULL) { // CurveSurfaceMappers map DOFs together
         assert(fieldA->dimension == EMPIRE_DataField_doubleVector);
         assert(fieldB->dimension == EMPIRE_DataField_vector);
@@ -309,18 +1029,129 @@ void MapperAdapter::conservativeMapping(const DataField *fieldB, DataField *fiel
         assert(fieldA->numLocations == numNodesA);
         assert(fieldB->numLocations == numNodesB);
 
-        double *fieldADOFi = new double[fieldA->numLocations];
-        double *fieldBDOFi = new double[fieldB->numLocations];
         int numDOFs = fieldA->dimension;
-        for (int i = 0; i < numDOFs; i++) {
-            for (int j = 0; j < fieldB->numLocations; j++)
-                fieldBDOFi[j] = fieldB->data[j * numDOFs + i];
-            mapperImpl->conservativeMapping(fieldBDOFi, fieldADOFi);
-            for (int j = 0; j < fieldA->numLocations; j++)
-                fieldA->data[j * numDOFs + i] = fieldADOFi[j];
+        if (mapperImpl->isBlockMappingSupported()) { // map all DOFs together without splitting the field
+            mapperImpl->conservativeBlockMapping(fieldB->data, fieldA->data, numDOFs);
+        } else {
+            BufferPool::Buffer fieldADOFi(fieldA->numLocations);
+            BufferPool::Buffer fieldBDOFi(fieldB->numLocations);
+            isOutputFactorFolded = true;
+            for (int i = 0; i < numDOFs; i++) {
+                for (int j = 0; j < fieldB->numLocations; j++)
+                    fieldBDOFi[j] = fieldB->data[j * numDOFs + i];
+                mapperImpl->conservativeMapping(fieldBDOFi.data(), fieldADOFi.data());
+                for (int j = 0; j < fieldA->numLocations; j++)
+                    fieldA->data[j * numDOFs + i] = outputFactor * fieldADOFi[j];
+            }
+        }
+    }
+
+    // Scale the output if the factor could not be folded into its write
+    if (outputFactor != 1.0 && !isOutputFactorFolded)
+        for (int i = 0; i < fieldA->numLocations * fieldA->dimension; i++)
+            fieldA->data[i] *= outputFactor;
+}
+
+void MapperAdapter::mapBothDirections(const DataField *fieldA, DataField *fieldBOut,
+        const DataField *fieldB, DataField *fieldAOut) {
+    assert(mapperImpl != NULL);
+    if (isOneDirectionBuilt) {
+        ERROR_OUT() << "Mapper \"" << name << "\" is built for one mapping direction only!" << endl;
+        exit(-1);
+    }
+    assert(fieldA->dimension == fieldBOut->dimension);
+    assert(fieldB->dimension == fieldAOut->dimension);
+    applyMeshMotion();
+    adaptIterativeSolverTolerance();
+    // the replicas of an ensemble batch each direction on its own
+    if (ensembleBatch != NULL) {
+        consistentMapping(fieldA, fieldBOut);
+        conservativeMapping(fieldB, fieldAOut);
+        return;
+    }
+    bool isErrorComputation = dynamic_cast<IGAMortarMapper *>(mapperImpl) != NULL && dynamic_cast<IGAMortarMapper *>(mapperImpl)->getIsErrorComputation();
+    int numComponents;
+    if (dynamic_cast<CurveSurfaceMapper *>(mapperImpl) != NULL
+            || (dynamic_cast<IGAMortarMapper *>(mapperImpl) != NULL && (dynamic_cast<IGAMortarMapper *>(mapperImpl)->getIsExpanded()))
+            || dynamic_cast<IGABarycentricMapper *>(mapperImpl) != NULL) { // these map the whole field
+        numComponents = 1;
+    } else if (fieldA->dimension == fieldB->dimension
+            && (fieldA->dimension == 1 || mapperImpl->isBlockMappingSupported())) {
+        numComponents = fieldA->dimension;
+    } else {
+        numComponents = 0;
+    }
+    // Map one direction after the other if the fields have to be split or the error is computed
+    if (numComponents == 0 || isErrorComputation) {
+        consistentMapping(fieldA, fieldBOut);
+        conservativeMapping(fieldB, fieldAOut);
+        return;
+    }
+    mapperImpl->mapBothDirections(fieldA->data, fieldBOut->data, fieldB->data, fieldAOut->data,
+            numComponents);
+    monitoredFieldA = fieldA;
+    monitoredFieldB = fieldBOut;
+    monitorConservation(fieldB, fieldAOut);
+}
+
+void MapperAdapter::mapEnsemble(bool consistent,
+        const vector<EnsembleMappingBatch::Request*> &requests) {
+    bool isErrorComputation = dynamic_cast<IGAMortarMapper *>(mapperImpl) != NULL && dynamic_cast<IGAMortarMapper *>(mapperImpl)->getIsErrorComputation();
+    bool isBlockMapping = mapperImpl->isBlockMappingSupported() && !isErrorComputation
+            && dynamic_cast<CurveSurfaceMapper *>(mapperImpl) == NULL
+            && !(dynamic_cast<IGAMortarMapper *>(mapperImpl) != NULL && (dynamic_cast<IGAMortarMapper *>(mapperImpl)->getIsExpanded()))
+            && dynamic_cast<IGABarycentricMapper *>(mapperImpl) == NULL;
+    vector<bool> isMapped(requests.size(), false);
+    for (unsigned i = 0; i < requests.size(); i++) {
+        if (isMapped[i])
+            continue;
+        // the fields of the same dimension are mapped together
+        vector<EnsembleMappingBatch::Request*> group;
+        for (unsigned j = i; j < requests.size(); j++) {
+            if (isMapped[j] || (j != i && !isBlockMapping)
+                    || requests[j]->input->dimension != requests[i]->input->dimension)
+                continue;
+            group.push_back(requests[j]);
+            isMapped[j] = true;
+        }
+        if (group.size() == 1) {
+            if (consistent)
+                mapConsistently(group[0]->input, group[0]->output, group[0]->outputFactor);
+            else
+                mapConservatively(group[0]->input, group[0]->output, group[0]->outputFactor);
+            continue;
+        }
+        int numDOFs = group[0]->input->dimension;
+        int numReplicas = group.size();
+        int numComponents = numReplicas * numDOFs;
+        int numInputLocations = group[0]->input->numLocations;
+        int numOutputLocations = group[0]->output->numLocations;
+        BufferPool::Buffer inputs((size_t) numInputLocations * numComponents);
+        BufferPool::Buffer outputs((size_t) numOutputLocations * numComponents);
+        for (int k = 0; k < numReplicas; k++) {
+            assert(group[k]->output->dimension == numDOFs);
+            assert(group[k]->input->numLocations == numInputLocations);
+            assert(group[k]->output->numLocations == numOutputLocations);
+            const double *input = group[k]->input->data;
+            const double *output = group[k]->output->data;
+            for (int j = 0; j < numInputLocations; j++)
+                for (int c = 0; c < numDOFs; c++)
+                    inputs[j * numComponents + k * numDOFs + c] = input[j * numDOFs + c];
+            for (int j = 0; j < numOutputLocations; j++) // initial guess of iterative solvers
+                for (int c = 0; c < numDOFs; c++)
+                    outputs[j * numComponents + k * numDOFs + c] = output[j * numDOFs + c];
+        }
+        if (consistent)
+            mapperImpl->consistentBlockMapping(inputs.data(), outputs.data(), numComponents);
+        else
+            mapperImpl->conservativeBlockMapping(inputs.data(), outputs.data(), numComponents);
+        for (int k = 0; k < numReplicas; k++) {
+            double *output = group[k]->output->data;
+            double factor = group[k]->outputFactor;
+            for (int j = 0; j < numOutputLocations; j++)
+                for (int c = 0; c < numDOFs; c++)
+                    output[j * numDOFs + c] = factor * outputs[j * numComponents + k * numDOFs + c];
         }
-        delete[] fieldADOFi;
-        delete[] fieldBDOFi;
     }
 }
 
@@ -28,7 +28,13 @@
 #define MAPPERADAPTER_H_
 
 #include <string>
+#include <vector>
 #include "EMPEROR_Enum.h"
+#include "MemoryUsage.h"
+#include "MapperBuildStatistics.h"
+#include "LinearSolver.h"
+#include "EnsembleMappingBatch.h"
+#include "BufferPool.h"
 
 namespace EMPIRE {
 
@@ -36,6 +42,8 @@ class MortarMapper;
 class AbstractMesh;
 class DataField;
 class AbstractMapper;
+class CouplingMatricesCache;
+class TaskPool;
 
 /********//**
  * \brief Class MapperAdapter is the adaptor of the mapper.
@@ -75,6 +83,8 @@ public:
      * \param[in] _noGPTriangle The number of Gauss points when performs integration on triangle
      * \param[in] _isAutomaticNoGPQuadrilateral Flag on whether the Gauss rule in a quadrilateral is automatically created or not
      * \param[in] _noGPQuadrilateral The number of Gauss points when performs integration on quadrilateral
+     * \param[in] _isAdaptiveIntegration Flag on whether the Gauss rule is reduced for every integration subdomain
+     * \param[in] _tolAdaptiveIntegration The tolerance on the estimated relative quadrature error of the adaptive rules
      * \param[in] _isWeakCurveDirichletConditions Flag on whether weak Dirichlet conditions along trimming curves are assumed
      * \param[in] _isAutomaticPenaltyParametersWeakCurveDirichletConditions Flag on whether the Penalty parameters for the application of weak Dirichlet conditions along trimming curves is automatic
      * \param[in] _isPrimPrescribedWeakCurveDirichletConditions Flag on whether the primary field is prescribed along the trimming curves
@@ -100,6 +110,7 @@ public:
      * \param[in] _isDomainError Flag on the computation of the domain error from the mapping
      * \param[in] _isInterfaceError Flag on the computation of the interface error from the mapping
      * \param[in] _isCurveError Flag on the computation of the error along the trimming curves where Dirichlet conditions are applied
+     * \param[in] _isCompactErrorStorage Flag on storing the Gauss points of the domain error packed in single precision
      * \author Andreas Apostolatos, Altug Emiroglu, Fabien Pean
      ***********/
     void initIGAMortarMapper(bool _enforceConsistency, double _tolConsistency,
@@ -108,11 +119,13 @@ public:
                              int _noIterationsNewtonRaphsonBoundary, double _tolProjectionNewtonRaphsonBoundary,
                              int _noIterationsBisection, double _tolProjectionBisection,
                              bool _isAutomaticNoGPTriangle, int _noGPTriangle, bool _isAutomaticNoGPQuadrilateral, int _noGPQuadrilateral,
+                             bool _isAdaptiveIntegration, double _tolAdaptiveIntegration,
                              bool _isWeakCurveDirichletConditions, bool _isAutomaticPenaltyParametersWeakCurveDirichletConditions, bool _isPrimPrescribedWeakCurveDirichletConditions, bool _isSecBendingPrescribedWeakCurveDirichletConditions, bool _isSecTwistingPrescribedWeakCurveDirichletConditions, double _alphaPrimWeakCurveDirichletConditions, double _alphaSecBendingWeakCurveDirichletConditions, double _alphaSecTwistingWeakCurveDirichletConditions,
                              bool _isWeakSurfaceDirichletConditions, bool _isAutomaticPenaltyParametersWeakSurfaceDirichletConditions, bool _isPrimPrescribedWeakSurfaceDirichletConditions, double _alphaPrimWeakSurfaceDirichletConditions,
                              bool _isWeakPatchContinuityConditions, bool _isAutomaticPenaltyParametersWeakContinuityConditions, bool _isPrimCoupledWeakContinuityConditions, bool _isSecBendingCoupledWeakContinuityConditions, bool _isSecTwistingCoupledWeakContinuityConditions, double _alphaPrimWeakContinuityConditions, double _alphaSecBendingWeakContinuityConditions, double _alphaSecTwistingWeakContinuityConditions,
                              bool _isStrongCurveDirichletConditions,
-                             bool _isErrorComputation, bool _isDomainError, bool _isCurveError, bool _isInterfaceError);
+                             bool _isErrorComputation, bool _isDomainError, bool _isCurveError, bool _isInterfaceError,
+                             bool _isCompactErrorStorage = false);
 
     /***********************************************************************************************
      * \brief Initialize IGA Barycentric Mapper
@@ -140,12 +153,72 @@ public:
      * \author Tianyang Wang
      ***********/
     void initNearestElementMapper();
+    /***********************************************************************************************
+     * \brief Initialize RBFMapper
+     * \param[in] numNodesPerPatch number of nodes of A in one patch of the partition of unity
+     ***********/
+    void initRBFMapper(int numNodesPerPatch);
     /***********************************************************************************************
      * \brief Initialize CurveSurfaceMapper
      * \param[in] type type of the CurveSurfaceMapper
      * \author Tianyang Wang
      ***********/
     void initCurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_type type);
+    /***********************************************************************************************
+     * \brief Rebuild the coupling matrices after the nodes of mesh A and mesh B moved (e.g. by a
+     *        kinematic motion), the topology of the meshes must be unchanged. If the sparsity pattern
+     *        of the matrices does not change, the solver only redoes the numerical factorization.
+     *        Only the mortar mapper supports geometry updates.
+     ***********/
+    void updateGeometry();
+    /***********************************************************************************************
+     * \brief Move the nodes of the FE meshes and update the coupling matrices. Only the nodes which
+     *        moved further than the threshold of setMeshMotion since the last update count as moved.
+     *        The nearest neighbor, barycentric interpolation and nearest element mappers recompute
+     *        only the rows depending on them, the mortar mappers rebuild the matrices in place.
+     * \param[in] newNodesA the new coordinates of the nodes of A, NULL if A does not move
+     * \param[in] newNodesB the new coordinates of the nodes of B, NULL if B does not move
+     * \return whether any node counted as moved, otherwise nothing is changed
+     ***********/
+    bool updateGeometry(const double *newNodesA, const double *newNodesB);
+    /***********************************************************************************************
+     * \brief Move the meshes by displacement data fields before every mapping, the nodes of the
+     *        meshes at this call are the reference coordinates. Must not be used in an ensemble.
+     * \param[in] dataFieldA the name of the displacement field of mesh A, empty if A does not move
+     * \param[in] dataFieldB the name of the displacement field of mesh B, empty if B does not move
+     * \param[in] threshold the distance a node has to move before the mapper is updated
+     ***********/
+    void setMeshMotion(std::string dataFieldA, std::string dataFieldB, double threshold);
+    /***********************************************************************************************
+     * \brief Update the mapper before every mapping if its client has moved the nodes of an FE
+     *        mesh in place (see ClientCode::recvMeshCoordinates). The nodes at this call are those
+     *        the mapper is built with. Must not be used in an ensemble, nor together with a mesh
+     *        motion of the same mesh.
+     * \param[in] movedA whether the client moves mesh A
+     * \param[in] movedB whether the client moves mesh B
+     * \param[in] threshold the distance a node has to move before the mapper is updated
+     ***********/
+    void setMeshMovedByClient(bool movedA, bool movedB, double threshold);
+    /***********************************************************************************************
+     * \brief Get mesh A
+     ***********/
+    const AbstractMesh *getMeshA() const {
+        return meshA;
+    }
+    /***********************************************************************************************
+     * \brief Get mesh B
+     ***********/
+    const AbstractMesh *getMeshB() const {
+        return meshB;
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory held by the mapper broken down by its components
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+    /***********************************************************************************************
+     * \brief Get the statistics of the last build or update of the coupling matrices
+     ***********/
+    MapperBuildStatistics getBuildStatistics() const;
     /***********************************************************************************************
      * \brief Destructor
      * \author Tianyang Wang
@@ -155,16 +228,86 @@ public:
      * \brief Do consistent mapping from A to B (map displacements)
      * \param[in] fieldA is the input data
      * \param[out] fieldB is the output data
+     * \param[in] outputFactor is the factor the output data is scaled with, it must not be zero
      * \author Tianyang Wang
      ***********/
-    void consistentMapping(const DataField *fieldA, DataField *fieldB);
+    void consistentMapping(const DataField *fieldA, DataField *fieldB, double outputFactor = 1.0);
     /***********************************************************************************************
      * \brief Do conservative mapping from B to A (map forces)
      * \param[in] fieldB is the input data
      * \param[out] fieldA is the output data
+     * \param[in] outputFactor is the factor the output data is scaled with, it must not be zero
      * \author Tianyang Wang
      ***********/
-    void conservativeMapping(const DataField *fieldB, DataField *fieldA);
+    void conservativeMapping(const DataField *fieldB, DataField *fieldA, double outputFactor = 1.0);
+    /***********************************************************************************************
+     * \brief Whether the consistent mapping can be done by ranges of nodes of B while fieldA is
+     *        received, which needs the support of the mapper and neither an ensemble nor moving
+     *        meshes
+     ***********/
+    bool isRowBlockMappingSupported() const;
+    /***********************************************************************************************
+     * \brief Get the number of leading nodes of A the consistent mapping of the nodes of B before
+     *        endNodeB depends on
+     * \param[in] endNodeB the end of the leading nodes of B
+     ***********/
+    int getNumRequiredNodesA(int endNodeB) const;
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes firstNodeB to endNodeB-1 of B only
+     * \param[in] fieldA is the input data, only the nodes given by getNumRequiredNodesA are read
+     * \param[out] fieldB is the output data, its other nodes are untouched
+     * \param[in] firstNodeB the first node of B
+     * \param[in] endNodeB the end of the nodes of B
+     * \param[in] outputFactor is the factor the output data is scaled with, it must not be zero
+     ***********/
+    void consistentRowBlockMapping(const DataField *fieldA, DataField *fieldB, int firstNodeB,
+            int endNodeB, double outputFactor = 1.0);
+    /***********************************************************************************************
+     * \brief Whether the mapping of a field equals the mapping of the same field before, which is
+     *        the case if the meshes do not move and the mapper is not shared by an ensemble
+     ***********/
+    bool isIncrementalMappingSupported() const;
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes of B which depend on a changed node of A only,
+     *        supported if isRowBlockMappingSupported
+     * \param[in] fieldA is the input data
+     * \param[in,out] fieldB is the output data, holding the mapping of fieldA before its change
+     * \param[in] isNodeAChanged whether the values of a node of A have changed
+     * \return the number of mapped nodes of B
+     ***********/
+    int consistentChangedRowsMapping(const DataField *fieldA, DataField *fieldB,
+            const char *isNodeAChanged);
+    /***********************************************************************************************
+     * \brief Whether the mapping can be handed to a client as one sparse matrix, which needs the
+     *        support of the mapper and meshes which do not move
+     ***********/
+    bool isMappingOperatorExportSupported() const;
+    /***********************************************************************************************
+     * \brief Get a copy of the mapping operator M with the nodes in the order of the clients,
+     *        consistent mapping is fieldB = M * fieldA and conservative mapping fieldA = M^T * fieldB
+     *        for every component of the fields. Supported if isMappingOperatorExportSupported
+     * \param[out] numRows the number of nodes of B
+     * \param[out] numColumns the number of nodes of A
+     * \param[out] rowPointers the first entry of every row, numRows+1 integers
+     * \param[out] columnIndices the column of every entry
+     * \param[out] values the value of every entry
+     * \param[in] clientOrder false to keep the nodes in the order of the meshes in Emperor, which
+     *            is that of the data fields
+     ***********/
+    void getMappingOperator(int &numRows, int &numColumns, std::vector<int> &rowPointers,
+            std::vector<int> &columnIndices, std::vector<double> &values,
+            bool clientOrder = true) const;
+    /***********************************************************************************************
+     * \brief Do consistent mapping from A to B and conservative mapping from B to A in one pass
+     *        (e.g. the displacements and the forces of a coupling iteration), the mortar and the IGA
+     *        mortar mappers solve both directions with one call to the solver
+     * \param[in] fieldA is the input data of the consistent mapping
+     * \param[out] fieldBOut is the output data of the consistent mapping
+     * \param[in] fieldB is the input data of the conservative mapping
+     * \param[out] fieldAOut is the output data of the conservative mapping
+     ***********/
+    void mapBothDirections(const DataField *fieldA, DataField *fieldBOut, const DataField *fieldB,
+            DataField *fieldAOut);
     /***********************************************************************************************
      * \brief is it meshA or not
      * \param[in] mesh mesh
@@ -172,7 +315,12 @@ public:
      * \author Tianyang Wang
      ***********/
     bool isMeshA(AbstractMesh *mesh) {
-        return meshA == mesh;
+        if (meshA == mesh)
+            return true;
+        for (unsigned i = 0; i < replicaMeshesA.size(); i++)
+            if (replicaMeshesA[i] == mesh)
+                return true;
+        return false;
     }
     /***********************************************************************************************
      * \brief is it meshB or not
@@ -181,8 +329,33 @@ public:
      * \author Tianyang Wang
      ***********/
     bool isMeshB(AbstractMesh *mesh) {
-        return meshB == mesh;
+        if (meshB == mesh)
+            return true;
+        for (unsigned i = 0; i < replicaMeshesB.size(); i++)
+            if (replicaMeshesB[i] == mesh)
+                return true;
+        return false;
     }
+    /***********************************************************************************************
+     * \brief Share the mapper between the replicas of an ensemble, the mappings the replicas ask
+     *        for are then collected and mapped together (see EnsembleMappingBatch). Must be called
+     *        after the init functions and before the replicas map. A previous ensemble and its
+     *        replica meshes are dropped.
+     * \param[in] numReplicas the number of replicas, 1 for no ensemble
+     * \param[in] batchWindow the seconds the first mapping of a batch waits for the other replicas
+     ***********/
+    void setEnsemble(int numReplicas, double batchWindow);
+    /***********************************************************************************************
+     * \brief Register the meshes of a replica, which are copies of mesh A and mesh B, such that its
+     *        mapping filters find the mapping direction by isMeshA and isMeshB
+     * \param[in] replicaMeshA the copy of mesh A
+     * \param[in] replicaMeshB the copy of mesh B
+     ***********/
+    void addReplicaMeshes(AbstractMesh *replicaMeshA, AbstractMesh *replicaMeshB);
+    /***********************************************************************************************
+     * \brief Tell that a replica of the ensemble has finished its co-simulation
+     ***********/
+    void replicaFinished();
 
     /***********************************************************************************************
      * \brief sets write mode for the underlying mapper implementation
@@ -192,6 +365,191 @@ public:
         writeMode = _writeMode;
     }
 
+    /***********************************************************************************************
+     * \brief Cache the coupling matrices in a directory, must be called before the init functions.
+     *        If a cache file of the same meshes and parameters exists, the matrices are read from it
+     *        instead of being built, otherwise they are built and written to it. Only the mortar and
+     *        the IGA mortar mapper support caching.
+     * \param[in] directory the directory of the cache files, empty for no caching
+     ***********/
+    void setCouplingMatricesCache(std::string directory) {
+        couplingMatricesCacheDirectory = directory;
+    }
+
+    /***********************************************************************************************
+     * \brief Solve the mass matrix of the mapper by the Jacobi preconditioned conjugate gradient
+     *        method instead of factorizing it, must be called before the init functions. Each solve
+     *        starts from the mapped field of the previous call. Only the standard mortar mapper and
+     *        the IGA mortar mapper without enforced consistency support it, the others keep their
+     *        solver.
+     * \param[in] tolerance the relative residual tolerance, 0 for the direct solver
+     * \param[in] maxIterations the maximum number of iterations
+     ***********/
+    void setIterativeSolver(double tolerance, int maxIterations) {
+        iterativeSolverTolerance = tolerance;
+        iterativeSolverMaxIterations = maxIterations;
+    }
+
+    /***********************************************************************************************
+     * \brief Select the solver of the mass matrix of the mapper by its name in the
+     *        LinearSolverRegistry, must be called before the init functions. The iterative solver
+     *        takes precedence, mappers without a mass matrix to solve ignore it.
+     * \param[in] name the name of the solver
+     ***********/
+    void setLinearSolver(const std::string &name) {
+        linearSolver = name;
+    }
+
+    /***********************************************************************************************
+     * \brief Solve the mass matrix inexactly while the coupling is far from convergence. The
+     *        tolerance of the iterative solver is multiplied by forcing times the ratio of the
+     *        coupling residual to its tolerance, see setCouplingResidualRatio, so that it is the
+     *        configured tolerance once the residual is within 1 / forcing of convergence. The
+     *        solves are warm started from the previous mapped field.
+     * \param[in] forcing the factor of the residual ratio, 0 for exact solves
+     * \param[in] maxTolerance the loosest tolerance of the iterative solver
+     ***********/
+    void setInexactSolve(double forcing, double maxTolerance) {
+        inexactSolveForcing = forcing;
+        inexactSolveMaxTolerance = maxTolerance;
+    }
+
+    /***********************************************************************************************
+     * \brief Set the ratio of the coupling residual to its tolerance, the largest one of the
+     *        residuals checked by the last convergence check, for all mappers solving inexactly
+     * \param[in] ratio the ratio, 0 if unknown, then the mappers solve exactly
+     ***********/
+    static void setCouplingResidualRatio(double ratio) {
+        couplingResidualRatio = ratio;
+    }
+
+    /***********************************************************************************************
+     * \brief Set the threads, the ordering and the storage of the PARDISO factors of the mass
+     *        matrix of the mapper, must be called before the init functions
+     * \param[in] settings the settings
+     ***********/
+    void setPardisoSettings(const MathLibrary::PardisoSettings &settings) {
+        pardisoSettings = settings;
+    }
+
+    /***********************************************************************************************
+     * \brief Release the data the mapper only needs for building its coupling matrices once they are
+     *        built or read from the cache, must be called before the init functions. Only the IGA
+     *        mortar mapper supports it, the others keep their data.
+     * \param[in] compact true to release the data
+     ***********/
+    void setCompactAfterBuild(bool compact) {
+        compactAfterBuild = compact;
+    }
+
+    /***********************************************************************************************
+     * \brief Reorder the coupling matrices by reverse Cuthill-McKee after they are built, so that the
+     *        products and the solves of the mapping access the fields more contiguously. Must be
+     *        called before the init functions. Only the IGA mortar mapper supports it.
+     * \param[in] reorder true to reorder
+     ***********/
+    void setReorderCouplingMatrices(bool reorder) {
+        reorderCouplingMatrices = reorder;
+    }
+
+    /***********************************************************************************************
+     * \brief Store the interpolation weights in single precision, which halves the memory traffic of
+     *        the mapping. Must be called before the init functions. Only the nearest neighbor,
+     *        barycentric interpolation and nearest element mappers support it.
+     * \param[in] singlePrecision true for single precision
+     ***********/
+    void setSinglePrecisionWeights(bool singlePrecision) {
+        singlePrecisionWeights = singlePrecision;
+    }
+
+    /***********************************************************************************************
+     * \brief Precompute the mapping operator as one sparse matrix after the build, so that each
+     *        mapping is a single sparse matrix vector product. Must be called before the init
+     *        functions. Only the dual mortar mapper supports it.
+     * \param[in] explicitOperator true to precompute the operator
+     ***********/
+    void setExplicitMappingOperator(bool explicitOperator) {
+        explicitMappingOperator = explicitOperator;
+    }
+
+    /***********************************************************************************************
+     * \brief Set the mapping directions the filters use, mappers supporting it build only the
+     *        operators of these directions. Must be called before the init functions.
+     * \param[in] consistent whether consistent mapping (A to B) is used
+     * \param[in] conservative whether conservative mapping (B to A) is used
+     ***********/
+    void setMappingDirections(bool consistent, bool conservative) {
+        isConsistentMappingUsed = consistent;
+        isConservativeMappingUsed = conservative;
+    }
+
+    /***********************************************************************************************
+     * \brief Sample the computation of the errors of the consistent mapping (IGA mortar mapper with
+     *        error computation), which integrates the errors over all stored Gauss points. Without
+     *        sampling the errors of every consistent mapping are computed right after it.
+     * \param[in] interval the errors are computed for every interval-th consistent mapping, or at
+     *            the end of every interval-th time step with a consistent mapping
+     * \param[in] atTimeStepEnd compute the errors of the last consistent mapping of a time step
+     *            only (the converged one of an iterative coupling), see computeErrorsAtTimeStepEnd
+     * \param[in] background compute the errors on a background thread from a copy of the fields,
+     *            a sample is skipped while the errors of the previous one are still computed
+     ***********/
+    void setErrorComputationSampling(int interval, bool atTimeStepEnd, bool background);
+    /***********************************************************************************************
+     * \brief Whether the errors of the consistent mapping are computed at the end of a time step
+     ***********/
+    bool isErrorComputationAtTimeStepEnd() const {
+        return errorComputationAtTimeStepEnd;
+    }
+    /***********************************************************************************************
+     * \brief Compute the errors of the last consistent mapping of the time step if the sampling
+     *        says so, called by the time step loop at the end of every time step
+     ***********/
+    void computeErrorsAtTimeStepEnd();
+    /***********************************************************************************************
+     * \brief Wait until the errors computed on the background thread are done
+     ***********/
+    void waitForErrorComputation();
+
+    /***********************************************************************************************
+     * \brief Monitor the conservation of the mapping during the run. Every interval-th conservative
+     *        mapping, the virtual work of the forces on the displacements of the last consistent
+     *        mapping is computed on both meshes, f_A . u_A and f_B . u_B, which a conservative
+     *        mapping keeps equal, together with the norms of the four fields. All of them are
+     *        reduced in one pass over each mesh. They are set as monitored values of the Profiler,
+     *        a warning is printed if the relative difference of the work exceeds the tolerance.
+     *        Output factors other than 1 scale the work accordingly, ensembles are not monitored.
+     * \param[in] interval the number of conservative mappings per sample, 0 for no monitoring
+     * \param[in] tolerance the relative difference of the work above which a warning is printed
+     ***********/
+    void setConservationMonitor(int interval, double tolerance) {
+        monitorInterval = interval;
+        monitorTolerance = tolerance;
+        numMonitoredMappings = 0;
+        monitoredFieldA = NULL;
+        monitoredFieldB = NULL;
+    }
+
+    /***********************************************************************************************
+     * \brief Report the build statistics of the mapper (projections, Newton-Raphson iterations,
+     *        clipped polygons, Gauss points, sizes of the coupling matrices and time of the stages)
+     *        after every build and geometry update. They are printed and written to
+     *        "<name>_buildStatistics.json"
+     * \param[in] report true to report
+     ***********/
+    void setBuildStatisticsReport(bool report) {
+        buildStatisticsReport = report;
+    }
+
+    /***********************************************************************************************
+     * \brief Set the number of threads the mortar, IGA mortar, nearest element and RBF mappers build
+     *        their coupling matrices with, must be called before the init functions
+     * \param[in] _numThreads the number of threads, AuxiliaryParameters::mapperSetNumThreads by default
+     ***********/
+    void setNumThreads(int _numThreads) {
+        numThreads = _numThreads;
+    }
+
 private:
     /// the adapted mapper
     AbstractMapper *mapperImpl;
@@ -203,6 +561,152 @@ private:
     AbstractMesh *meshB;
     /// write mode for the mapper
     int writeMode;
+    /// directory of the coupling matrices cache, empty for no caching
+    std::string couplingMatricesCacheDirectory;
+    /// relative residual tolerance of the iterative solver, 0 for the direct solver
+    double iterativeSolverTolerance;
+    /// maximum number of iterations of the iterative solver
+    int iterativeSolverMaxIterations;
+    /// name of the solver of the mass matrix in the LinearSolverRegistry
+    std::string linearSolver;
+    /// settings of the PARDISO factorization of the mass matrix
+    MathLibrary::PardisoSettings pardisoSettings;
+    /// whether the data only needed for the build is released after the build
+    bool compactAfterBuild;
+    /// whether the coupling matrices are reordered after the build
+    bool reorderCouplingMatrices;
+    /// whether the interpolation weights are stored in single precision
+    bool singlePrecisionWeights;
+    /// whether the mapping operator is precomputed as one sparse matrix
+    bool explicitMappingOperator;
+    /// whether consistent mapping is used
+    bool isConsistentMappingUsed;
+    /// whether conservative mapping is used
+    bool isConservativeMappingUsed;
+    /// whether the mapper built the operators of the used directions only
+    bool isOneDirectionBuilt;
+    /// number of threads of the thread parallel mappers
+    int numThreads;
+    /// the copies of mesh A of the replicas of an ensemble
+    std::vector<AbstractMesh*> replicaMeshesA;
+    /// the copies of mesh B of the replicas of an ensemble
+    std::vector<AbstractMesh*> replicaMeshesB;
+    /// collects the mappings of the replicas of an ensemble, NULL without ensemble
+    EnsembleMappingBatch *ensembleBatch;
+    /// the displacement field moving mesh A, empty if A does not move
+    std::string meshMotionA;
+    /// the displacement field moving mesh B, empty if B does not move
+    std::string meshMotionB;
+    /// the distance a node has to move before the mapper is updated
+    double geometryUpdateThreshold;
+    /// whether the client moves the nodes of mesh A in place
+    bool isMeshAMovedByClient;
+    /// whether the client moves the nodes of mesh B in place
+    bool isMeshBMovedByClient;
+    /// the nodes of A the displacements are added to
+    std::vector<double> referenceNodesA;
+    /// the nodes of B the displacements are added to
+    std::vector<double> referenceNodesB;
+    /// the nodes of A the mapper was last updated with, empty before the first update
+    std::vector<double> buildNodesA;
+    /// the nodes of B the mapper was last updated with, empty before the first update
+    std::vector<double> buildNodesB;
+    /// the errors are computed for every errorComputationInterval-th sample
+    int errorComputationInterval;
+    /// whether the errors are computed at the end of a time step
+    bool errorComputationAtTimeStepEnd;
+    /// whether the errors are computed on a background thread
+    bool errorComputationInBackground;
+    /// the number of consistent mappings or time steps since the sampling was set
+    int numErrorSamples;
+    /// the fields of the last consistent mapping of the time step, NULL if there is none
+    const DataField *errorFieldA;
+    /// the output of the last consistent mapping of the time step, scaled by errorOutputFactor
+    const DataField *errorFieldB;
+    /// the output factor of the last consistent mapping of the time step
+    double errorOutputFactor;
+    /// the background thread of the error computation, NULL if the errors are computed at once
+    TaskPool *errorComputationThread;
+    /// the number of error computations pushed to the background thread and not finished yet
+    int numRunningErrorComputations;
+    /// the number of conservative mappings per sample of the conservation monitor, 0 for none
+    int monitorInterval;
+    /// the relative difference of the virtual work above which the monitor warns
+    double monitorTolerance;
+    /// the number of conservative mappings since monitoring started
+    int numMonitoredMappings;
+    /// the input of the last consistent mapping, NULL before the first one
+    const DataField *monitoredFieldA;
+    /// the output of the last consistent mapping, NULL before the first one
+    const DataField *monitoredFieldB;
+    /// whether the build statistics are reported after a build or update
+    bool buildStatisticsReport;
+    /// the factor of the coupling residual ratio in the tolerance of the iterative solver, 0 for exact solves
+    double inexactSolveForcing;
+    /// the loosest tolerance of the inexact solves
+    double inexactSolveMaxTolerance;
+    /// the ratio of the coupling residual to its tolerance of the last convergence check, 0 if unknown
+    static double couplingResidualRatio;
+    /***********************************************************************************************
+     * \brief Print the build statistics and write them to "<name>_buildStatistics.json" if
+     *        buildStatisticsReport is set
+     ***********/
+    void reportBuildStatistics() const;
+    /***********************************************************************************************
+     * \brief Move the meshes by the displacement fields set by setMeshMotion, or update the
+     *        mapper to the nodes moved by the client
+     ***********/
+    void applyMeshMotion();
+    /***********************************************************************************************
+     * \brief Set the tolerance of the iterative solver from the coupling residual ratio, see
+     *        setInexactSolve
+     ***********/
+    void adaptIterativeSolverTolerance();
+    /***********************************************************************************************
+     * \brief Compute the errors of a consistent mapping at once or on the background thread
+     * \param[in] fieldA the input of the consistent mapping
+     * \param[in] fieldB the output of the consistent mapping
+     * \param[in] outputFactor the factor fieldB is scaled with
+     ***********/
+    void computeErrors(const DataField *fieldA, const DataField *fieldB, double outputFactor);
+    /***********************************************************************************************
+     * \brief Sample the virtual work and the norms of the fields after a conservative mapping, see
+     *        setConservationMonitor
+     * \param[in] fieldB the input of the conservative mapping
+     * \param[in] fieldA the output of the conservative mapping
+     ***********/
+    void monitorConservation(const DataField *fieldB, const DataField *fieldA);
+    /***********************************************************************************************
+     * \brief Do consistent mapping of one field, see consistentMapping
+     ***********/
+    void mapConsistently(const DataField *fieldA, DataField *fieldB, double outputFactor);
+    /***********************************************************************************************
+     * \brief Do conservative mapping of one field, see conservativeMapping
+     ***********/
+    void mapConservatively(const DataField *fieldB, DataField *fieldA, double outputFactor);
+    /***********************************************************************************************
+     * \brief Map the fields of a batch of the replicas of an ensemble. The fields of equal dimension
+     *        are interleaved, component c of replica k at node i is at i * numReplicas * dimension +
+     *        k * dimension + c, and mapped by one block mapping with numReplicas * dimension
+     *        components. Mappers without block mapping, mapping whole fields or computing the
+     *        mapping error map the fields one after another.
+     * \param[in] consistent true for consistent mapping, false for conservative mapping
+     * \param[in,out] requests the mappings of the batch
+     ***********/
+    void mapEnsemble(bool consistent, const std::vector<EnsembleMappingBatch::Request*> &requests);
+    friend class EnsembleMappingBatch;
+    /***********************************************************************************************
+     * \brief Create a cache whose key contains the mapper type and both meshes
+     * \param[in] mapperTypeName the type of the mapper
+     * \return the cache, NULL if caching is switched off
+     ***********/
+    CouplingMatricesCache *createCouplingMatricesCache(std::string mapperTypeName);
+    /***********************************************************************************************
+     * \brief Read the coupling matrices of mapperImpl from the cache, or build them and write them
+     *        to the cache
+     * \param[in] cache the cache with the complete key, NULL for no caching. It is deleted.
+     ***********/
+    void buildCouplingMatrices(CouplingMatricesCache *cache);
 };
 
 } /* namespace EMPIRE */
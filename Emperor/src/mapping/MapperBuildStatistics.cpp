@@ -0,0 +1,269 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <assert.h>
+#include <sstream>
+#include <iomanip>
+#include "MapperBuildStatistics.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/// write a string as a JSON string
+static void writeJSONString(ostream &out, const string &text) {
+    out << '"';
+    for (unsigned i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if ((unsigned char) c < 0x20)
+            out << ' ';
+        else
+            out << c;
+    }
+    out << '"';
+}
+
+MapperBuildStatistics::MapperBuildStatistics() {
+    reset();
+}
+
+void MapperBuildStatistics::reset() {
+    numProjections.assign(NUM_PROJECTION_KINDS, 0);
+    newtonIterationHistogram.assign(MAX_HISTOGRAM_ITERATIONS + 1, 0);
+    numClippedPolygons = 0;
+    numClippedPolygonVertices = 0;
+    numGaussPoints = 0;
+    matrices.clear();
+    stages.clear();
+}
+
+void MapperBuildStatistics::addProjection(ProjectionKind kind) {
+    assert(kind >= 0 && kind < NUM_PROJECTION_KINDS);
+#pragma omp atomic
+    numProjections[kind]++;
+}
+
+void MapperBuildStatistics::addProjections(ProjectionKind kind, long numNodes) {
+    assert(kind >= 0 && kind < NUM_PROJECTION_KINDS);
+#pragma omp atomic
+    numProjections[kind] += numNodes;
+}
+
+void MapperBuildStatistics::addNewtonIterations(int numIterations) {
+    int bin = numIterations < 0 ? 0 : numIterations;
+    if (bin > MAX_HISTOGRAM_ITERATIONS)
+        bin = MAX_HISTOGRAM_ITERATIONS;
+#pragma omp atomic
+    newtonIterationHistogram[bin]++;
+}
+
+void MapperBuildStatistics::addClippedPolygon(int numVertices) {
+#pragma omp atomic
+    numClippedPolygons++;
+#pragma omp atomic
+    numClippedPolygonVertices += numVertices;
+}
+
+void MapperBuildStatistics::addGaussPoints(int _numGaussPoints) {
+#pragma omp atomic
+    numGaussPoints += _numGaussPoints;
+}
+
+void MapperBuildStatistics::setMatrix(const std::string &name, size_t numRows, size_t numColumns,
+        size_t numNonZeros, bool isSymmetric) {
+    MatrixSize matrix;
+    matrix.name = name;
+    matrix.numRows = numRows;
+    matrix.numColumns = numColumns;
+    matrix.numNonZeros = numNonZeros;
+    matrix.isSymmetric = isSymmetric;
+    for (int i = 0; i < matrices.size(); i++) {
+        if (matrices[i].name == name) {
+            matrices[i] = matrix;
+            return;
+        }
+    }
+    matrices.push_back(matrix);
+}
+
+void MapperBuildStatistics::addStageTime(const std::string &name, double seconds) {
+    for (int i = 0; i < stages.size(); i++) {
+        if (stages[i].first == name) {
+            stages[i].second += seconds;
+            return;
+        }
+    }
+    stages.push_back(make_pair(name, seconds));
+}
+
+size_t MapperBuildStatistics::getMatrixNumNonZeros(const std::string &name) const {
+    for (int i = 0; i < matrices.size(); i++)
+        if (matrices[i].name == name)
+            return matrices[i].numNonZeros;
+    return 0;
+}
+
+double MapperBuildStatistics::getMatrixFill(const std::string &name) const {
+    for (int i = 0; i < matrices.size(); i++) {
+        if (matrices[i].name != name)
+            continue;
+        const MatrixSize &matrix = matrices[i];
+        // only the upper triangular part of a symmetric matrix is stored
+        double numEntries = matrix.isSymmetric ?
+                0.5 * matrix.numRows * (matrix.numRows + 1.0) :
+                (double) matrix.numRows * matrix.numColumns;
+        return numEntries > 0 ? matrix.numNonZeros / numEntries : 0.0;
+    }
+    return 0.0;
+}
+
+double MapperBuildStatistics::getStageTime(const std::string &name) const {
+    for (int i = 0; i < stages.size(); i++)
+        if (stages[i].first == name)
+            return stages[i].second;
+    return 0.0;
+}
+
+double MapperBuildStatistics::getTotalTime() const {
+    double total = 0.0;
+    for (int i = 0; i < stages.size(); i++)
+        total += stages[i].second;
+    return total;
+}
+
+const char *MapperBuildStatistics::getProjectionKindName(ProjectionKind kind) {
+    switch (kind) {
+    case PROJECTION_DIRECT:
+        return "direct";
+    case PROJECTION_WARM_STARTED:
+        return "warmStarted";
+    case PROJECTION_PRUNED:
+        return "pruned";
+    case PROJECTION_RELAXED:
+        return "relaxed";
+    case PROJECTION_SAMPLED:
+        return "sampled";
+    case PROJECTION_FAILED:
+        return "failed";
+    default:
+        assert(false);
+        return "";
+    }
+}
+
+void MapperBuildStatistics::writeJSON(std::ostream &out, const std::string &mapperName) const {
+    out << toJSON(mapperName);
+}
+
+std::string MapperBuildStatistics::toJSON(const std::string &mapperName) const {
+    // the format of the numbers is set on a stream of its own
+    stringstream out;
+    out << setprecision(6);
+    out << "{\n  \"mapper\": ";
+    writeJSONString(out, mapperName);
+    out << ",\n  \"projections\": {";
+    for (int kind = 0; kind < NUM_PROJECTION_KINDS; kind++) {
+        out << (kind == 0 ? "" : ", ");
+        writeJSONString(out, getProjectionKindName((ProjectionKind) kind));
+        out << ": " << numProjections[kind];
+    }
+    // the histogram ends at the last non-empty bin
+    int numBins = newtonIterationHistogram.size();
+    while (numBins > 0 && newtonIterationHistogram[numBins - 1] == 0)
+        numBins--;
+    out << "},\n  \"newtonIterationHistogram\": [";
+    for (int i = 0; i < numBins; i++)
+        out << (i == 0 ? "" : ", ") << newtonIterationHistogram[i];
+    out << "],\n  \"clippedPolygons\": {\"count\": " << numClippedPolygons << ", \"vertices\": "
+            << numClippedPolygonVertices << "},\n  \"gaussPoints\": " << numGaussPoints
+            << ",\n  \"matrices\": [";
+    for (int i = 0; i < matrices.size(); i++) {
+        out << (i == 0 ? "\n    " : ",\n    ") << "{\"name\": ";
+        writeJSONString(out, matrices[i].name);
+        out << ", \"rows\": " << matrices[i].numRows << ", \"columns\": " << matrices[i].numColumns
+                << ", \"nonZeros\": " << matrices[i].numNonZeros << ", \"symmetric\": "
+                << (matrices[i].isSymmetric ? "true" : "false") << ", \"fill\": "
+                << getMatrixFill(matrices[i].name) << "}";
+    }
+    out << (matrices.empty() ? "" : "\n  ") << "],\n  \"stages\": [";
+    for (int i = 0; i < stages.size(); i++) {
+        out << (i == 0 ? "\n    " : ",\n    ") << "{\"name\": ";
+        writeJSONString(out, stages[i].first);
+        out << ", \"seconds\": " << fixed << stages[i].second << "}";
+        out.unsetf(ios_base::floatfield);
+    }
+    out << (stages.empty() ? "" : "\n  ") << "],\n  \"totalSeconds\": " << fixed << getTotalTime() << "\n}\n";
+    return out.str();
+}
+
+void MapperBuildStatistics::print(const std::string &title) const {
+    INFO_OUT() << "Build statistics of " << title << ":" << endl;
+    for (int kind = 0; kind < NUM_PROJECTION_KINDS; kind++)
+        if (numProjections[kind] > 0)
+            INFO_OUT() << "    nodes projected (" << getProjectionKindName((ProjectionKind) kind)
+                    << "): " << numProjections[kind] << endl;
+    long numNewtonProjections = 0;
+    long numNewtonIterations = 0;
+    for (int i = 0; i < newtonIterationHistogram.size(); i++) {
+        numNewtonProjections += newtonIterationHistogram[i];
+        numNewtonIterations += i * newtonIterationHistogram[i];
+    }
+    if (numNewtonProjections > 0)
+        INFO_OUT() << "    Newton-Raphson iterations per projection: "
+                << (double) numNewtonIterations / numNewtonProjections << endl;
+    if (numClippedPolygons > 0)
+        INFO_OUT() << "    clipped polygons: " << numClippedPolygons << " with "
+                << (double) numClippedPolygonVertices / numClippedPolygons
+                << " vertices on average" << endl;
+    INFO_OUT() << "    Gauss points: " << numGaussPoints << endl;
+    for (int i = 0; i < matrices.size(); i++)
+        INFO_OUT() << "    " << matrices[i].name << ": " << matrices[i].numRows << " x "
+                << matrices[i].numColumns << " with " << matrices[i].numNonZeros
+                << " entries, fill " << getMatrixFill(matrices[i].name) << endl;
+    INFO_OUT() << "    total time of the stages: " << getTotalTime() << " seconds" << endl;
+}
+
+MapperBuildStatistics::StageTimer::StageTimer(MapperBuildStatistics &_statistics) :
+        statistics(_statistics), startTime(0.0) {
+}
+
+MapperBuildStatistics::StageTimer::~StageTimer() {
+    stop();
+}
+
+void MapperBuildStatistics::StageTimer::next(const std::string &name) {
+    stop();
+    profilerStages.next(name);
+    stageName = name;
+    startTime = omp_get_wtime();
+}
+
+void MapperBuildStatistics::StageTimer::stop() {
+    if (!stageName.empty())
+        statistics.addStageTime(stageName, omp_get_wtime() - startTime);
+    stageName.clear();
+    profilerStages.stop();
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,252 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file MapperBuildStatistics.h
+ * This file holds the class MapperBuildStatistics
+ * \date 10/15/2026
+ **************************************************************************************************/
+
+#ifndef MAPPERBUILDSTATISTICS_H_
+#define MAPPERBUILDSTATISTICS_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "Profiler.h"
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class MapperBuildStatistics holds the quality and the cost of the last build of the
+ *        coupling matrices of a mapper: how the nodes were projected, the histogram of the
+ *        Newton-Raphson iterations of the projections, the clipped polygons, the quadrature points,
+ *        the sizes of the coupling matrices and the time of the stages of the build. The counters
+ *        can be increased from several OpenMP threads at once.
+ ***********/
+class MapperBuildStatistics {
+public:
+    /// how a node was projected
+    enum ProjectionKind {
+        /// by the Newton-Raphson iterations from the nearest initial guess
+        PROJECTION_DIRECT,
+        /// by the Newton-Raphson iterations from the parametric coordinates of the last build
+        PROJECTION_WARM_STARTED,
+        /// by the closest point over the knot spans pruned by their bounding boxes
+        PROJECTION_PRUNED,
+        /// by the Newton-Raphson iterations with relaxed tolerances
+        PROJECTION_RELAXED,
+        /// by sampling the patch
+        PROJECTION_SAMPLED,
+        /// not projected
+        PROJECTION_FAILED,
+        NUM_PROJECTION_KINDS
+    };
+    /// the projections with more iterations are counted in the last bin of the histogram
+    static const int MAX_HISTOGRAM_ITERATIONS = 64;
+
+    /***********************************************************************************************
+     * \brief Constructor, all counters are zero
+     ***********/
+    MapperBuildStatistics();
+    /***********************************************************************************************
+     * \brief Set all counters to zero and remove the matrices and the stages
+     ***********/
+    void reset();
+    /***********************************************************************************************
+     * \brief Count the projection of a node, thread safe
+     * \param[in] kind how the node was projected
+     ***********/
+    void addProjection(ProjectionKind kind);
+    /***********************************************************************************************
+     * \brief Count the projections of several nodes
+     * \param[in] kind how the nodes were projected
+     * \param[in] numNodes the number of nodes
+     ***********/
+    void addProjections(ProjectionKind kind, long numNodes);
+    /***********************************************************************************************
+     * \brief Count the Newton-Raphson iterations of a projection in the histogram, thread safe
+     * \param[in] numIterations the number of iterations
+     ***********/
+    void addNewtonIterations(int numIterations);
+    /***********************************************************************************************
+     * \brief Count a polygon clipped for the integration, thread safe
+     * \param[in] numVertices the number of vertices of the polygon
+     ***********/
+    void addClippedPolygon(int numVertices);
+    /***********************************************************************************************
+     * \brief Count the quadrature points of an integration domain, thread safe
+     * \param[in] numGaussPoints the number of quadrature points
+     ***********/
+    void addGaussPoints(int numGaussPoints);
+    /***********************************************************************************************
+     * \brief Set the size of a coupling matrix, a matrix set before is replaced
+     * \param[in] name the name of the matrix, e.g. "Cnn"
+     * \param[in] numRows the number of rows
+     * \param[in] numColumns the number of columns
+     * \param[in] numNonZeros the number of stored entries
+     * \param[in] isSymmetric whether only the upper triangular part is stored
+     ***********/
+    void setMatrix(const std::string &name, size_t numRows, size_t numColumns, size_t numNonZeros,
+            bool isSymmetric);
+    /***********************************************************************************************
+     * \brief Add the time of a stage of the build, the time is added to a stage of the same name
+     * \param[in] name the name of the stage
+     * \param[in] seconds the wall time
+     ***********/
+    void addStageTime(const std::string &name, double seconds);
+
+    /***********************************************************************************************
+     * \brief Get the number of nodes projected in a way
+     ***********/
+    long getNumProjections(ProjectionKind kind) const {
+        return numProjections[kind];
+    }
+    /***********************************************************************************************
+     * \brief Get the histogram of the Newton-Raphson iterations, entry i is the number of
+     *        projections with i iterations
+     ***********/
+    const std::vector<long> &getNewtonIterationHistogram() const {
+        return newtonIterationHistogram;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of clipped polygons
+     ***********/
+    long getNumClippedPolygons() const {
+        return numClippedPolygons;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of vertices of all clipped polygons
+     ***********/
+    long getNumClippedPolygonVertices() const {
+        return numClippedPolygonVertices;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of quadrature points
+     ***********/
+    long getNumGaussPoints() const {
+        return numGaussPoints;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of stored entries of a matrix
+     * \return the number of entries, 0 if there is no such matrix
+     ***********/
+    size_t getMatrixNumNonZeros(const std::string &name) const;
+    /***********************************************************************************************
+     * \brief Get the ratio of the stored entries of a matrix to the size of its stored part
+     * \return the fill, 0 if there is no such matrix
+     ***********/
+    double getMatrixFill(const std::string &name) const;
+    /***********************************************************************************************
+     * \brief Get the time of a stage
+     * \return the wall time in seconds, 0 if there is no such stage
+     ***********/
+    double getStageTime(const std::string &name) const;
+    /***********************************************************************************************
+     * \brief Get the sum of the times of all stages
+     ***********/
+    double getTotalTime() const;
+    /***********************************************************************************************
+     * \brief Get the name of a projection kind as used in the report
+     ***********/
+    static const char *getProjectionKindName(ProjectionKind kind);
+
+    /***********************************************************************************************
+     * \brief Write the statistics as a JSON object
+     * \param[in] out the stream
+     * \param[in] mapperName the name of the mapper written in the object
+     ***********/
+    void writeJSON(std::ostream &out, const std::string &mapperName) const;
+    /***********************************************************************************************
+     * \brief Get the statistics as a JSON object, see writeJSON
+     ***********/
+    std::string toJSON(const std::string &mapperName) const;
+    /***********************************************************************************************
+     * \brief Print the statistics to infoOut
+     * \param[in] title the title of the output, e.g. the name of the mapper
+     ***********/
+    void print(const std::string &title) const;
+
+    /********//**
+     * \brief Class StageTimer times the consecutive stages of a build in the statistics and in the
+     *        profile, see Profiler::StageTimer
+     ***********/
+    class StageTimer {
+    public:
+        /***********************************************************************************************
+         * \brief Constructor
+         * \param[in] _statistics the statistics the stages are added to
+         ***********/
+        StageTimer(MapperBuildStatistics &_statistics);
+        /***********************************************************************************************
+         * \brief Destructor, ends the current stage
+         ***********/
+        ~StageTimer();
+        /***********************************************************************************************
+         * \brief End the current stage and start the next one
+         * \param[in] name the name of the next stage
+         ***********/
+        void next(const std::string &name);
+        /***********************************************************************************************
+         * \brief End the current stage
+         ***********/
+        void stop();
+    private:
+        /// the statistics
+        MapperBuildStatistics &statistics;
+        /// the timer of the stage in the profile
+        Profiler::StageTimer profilerStages;
+        /// name of the current stage, empty if there is none
+        std::string stageName;
+        /// wall time at the start of the current stage
+        double startTime;
+        StageTimer(const StageTimer&);
+        StageTimer& operator=(const StageTimer&);
+    };
+
+private:
+    /// the size of a coupling matrix
+    struct MatrixSize {
+        std::string name;
+        size_t numRows;
+        size_t numColumns;
+        size_t numNonZeros;
+        bool isSymmetric;
+    };
+    /// number of nodes per projection kind
+    std::vector<long> numProjections;
+    /// number of projections per number of Newton-Raphson iterations
+    std::vector<long> newtonIterationHistogram;
+    /// number of clipped polygons
+    long numClippedPolygons;
+    /// number of vertices of the clipped polygons
+    long numClippedPolygonVertices;
+    /// number of quadrature points
+    long numGaussPoints;
+    /// the coupling matrices in the order of their addition
+    std::vector<MatrixSize> matrices;
+    /// name of a stage <=> its wall time, in the order of the stages
+    std::vector<std::pair<std::string, double> > stages;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* MAPPERBUILDSTATISTICS_H_ */
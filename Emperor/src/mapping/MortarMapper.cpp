@@ -37,6 +37,16 @@
 #endif
 
 #include "MortarMapper.h"
+#include "FEMeshConnectivity.h"
+#include "FEMeshGeometry.h"
+#include "AABBTree.h"
+#include "CouplingMatricesCache.h"
+#include "CSRMatrix.h"
+#include "DistributedCSRMatrix.h"
+#include "Profiler.h"
+#include "BuildProgress.h"
+#include "AuxiliaryParameters.h"
+#include "CostOrderedSchedule.h"
 #include "Message.h"
 //#include "AuxiliaryFunctions.h"
 #include <iostream>
@@ -59,30 +69,38 @@ const int MortarMapper::numGPsMassMatrixTri = 6;
 const int MortarMapper::numGPsMassMatrixQuad = 4;
 const int MortarMapper::numGPsOnClipTri = 6;
 const int MortarMapper::numGPsOnClipQuad = 12;
+const double MortarMapper::projectionTolerance = 0.25;
 
 MortarMapper::MortarMapper(int _slaveNumNodes, int _slaveNumElems, const int *_slaveNodesPerElem,
         const double *_slaveNodeCoors, const int *_slaveNodeNumbers, const int *_slaveElemTable,
         int _masterNumNodes, int _masterNumElems, const int *_masterNodesPerElem,
         const double *_masterNodeCoors, const int *_masterNodeNumbers, const int *_masterElemTable,
-        bool _oppositeSurfaceNormal, bool _dual, bool _toEnforceConsistency) :
+        bool _oppositeSurfaceNormal, bool _dual, bool _toEnforceConsistency,
+        const FEMeshConnectivity *_slaveConnectivity, const FEMeshConnectivity *_masterConnectivity) :
         slaveNumNodes(_slaveNumNodes), slaveNumElems(_slaveNumElems), slaveNodesPerElem(
                 _slaveNodesPerElem), slaveNodeCoors(_slaveNodeCoors), slaveNodeNumbers(
                 _slaveNodeNumbers), slaveElemTable(_slaveElemTable), masterNumNodes(
                 _masterNumNodes), masterNumElems(_masterNumElems), masterNodesPerElem(
                 _masterNodesPerElem), masterNodeCoors(_masterNodeCoors), masterNodeNumbers(
                 _masterNodeNumbers), masterElemTable(_masterElemTable), oppositeSurfaceNormal(
-                _oppositeSurfaceNormal), dual(_dual), toEnforceConsistency(_toEnforceConsistency) {
+                _oppositeSurfaceNormal), dual(_dual), toEnforceConsistency(_toEnforceConsistency), sharedSlaveConnectivity(
+                _slaveConnectivity), sharedMasterConnectivity(_masterConnectivity), slaveGeometry(NULL), masterGeometry(
+                NULL), sharedSlaveGeometry(NULL), sharedMasterGeometry(NULL) {
 
     mapperType = EMPIRE_MortarMapper;
 
     // a could-be NULL pointer must be initialized to NULL, otherwise there could be segmentation fault when delete it
     C_BB_A_DUAL = NULL;
+    isExplicitMappingOperator = false;
+    isConsistentMappingUsed = true;
+    isConservativeMappingUsed = true;
+    H = NULL;
     // check whether the necessary libraries are there
 
     /// Initializing the sparse matrices
-    /// This is symmetric square matrix of size "masterNumNodes". For first attempt
-    /// we store it as full matrix
-    C_BB = new MathLibrary::SparseMatrix<double>(masterNumNodes, false);
+    /// This is symmetric positive definite square matrix of size "masterNumNodes", only its upper
+    /// triangular part is kept, so that the solvers use a Cholesky decomposition
+    C_BB = new MathLibrary::SparseMatrix<double>(masterNumNodes, true);
 
     /// This is a rectangular matrix of size
     /// masterNumNodes X slaveNumNodes
@@ -105,6 +123,8 @@ MortarMapper::MortarMapper(int _slaveNumNodes, int _slaveNumElems, const int *_s
 #endif*/
 
     // 1. initialize data that could be used later
+    FLANNkd_tree = NULL;
+    FLANNSlaveNodes = NULL;
     initTables();
     initANNTree();
 
@@ -112,15 +132,26 @@ MortarMapper::MortarMapper(int _slaveNumNodes, int _slaveNumElems, const int *_s
 
 void MortarMapper::buildCouplingMatrices(){
 
+    double startTime = omp_get_wtime();
+    assemblyWorkTime = 0.0;
+    initFLANNTree();
+    initElemGeometry();
+
     // 2. compute C_BB
-    computeC_BB();
+    {
+        PROFILER_SCOPE("C_BB");
+        computeC_BB();
+    }
 //     if (!dual) {
 //        C_BB->printFullToFile("MortarMapper_Cbb.dat");
 //     } else {
 //        MathLibrary::printFullToFile("MortarMapper_Cbb.dat", C_BB_A_DUAL, masterNumNodes);
 //     }
     // 3. compute C_BA
-    computeC_BA();
+    {
+        PROFILER_SCOPE("C_BA");
+        computeC_BA();
+    }
 //     if (!dual) {
 //        C_BA->printFullToFile("MortarMapper_Cba.dat");
 //     } else {
@@ -133,14 +164,129 @@ void MortarMapper::buildCouplingMatrices(){
     if ((Message::isDebugMode() || writeMode > 0) && !dual)
         C_BA->printCSRToFile("C_BA.dat",1);
 
+    // 4. finalize the assembly, the mapping only works on the compressed matrices
+    {
+        PROFILER_SCOPE("freeze");
+        if (!dual) {
+            C_BB->freeze();
+            C_BA->freeze();
+        } else {
+            C_BA_DUAL->freeze();
+        }
+    }
+    if (isExplicitMappingOperator) {
+        PROFILER_SCOPE("H");
+        computeMappingOperator();
+    }
+
+    // 5. report the statistics of the assembly, the speedup is the ratio of the time spent by all threads
+    // in the element loops to the wall time of the whole build
+    double buildTime = omp_get_wtime() - startTime;
+    INFO_OUT() << "MortarMapper: coupling matrices built in " << buildTime << " s using " << mapperSetNumThreads
+            << " thread(s), speedup of the assembly: " << (buildTime > 0.0 ? assemblyWorkTime / buildTime : 1.0) << endl;
+
+    deleteANNTree();
+    deleteTables();
+
+}
+
+void MortarMapper::writeCouplingMatricesToCache(CouplingMatricesCache *cache) {
+    if (!dual) {
+        cache->setMatrix("C_BB", C_BB);
+        cache->setMatrix("C_BA", C_BA);
+    } else {
+        cache->setVector("C_BB_A_DUAL", C_BB_A_DUAL, masterNumNodes);
+        cache->setMatrix("C_BA_DUAL", C_BA_DUAL);
+    }
+}
+
+bool MortarMapper::readCouplingMatricesFromCache(const CouplingMatricesCache *cache) {
+    if (!dual) {
+        if (!cache->hasMatrix("C_BB", C_BB) || !cache->hasMatrix("C_BA", C_BA))
+            return false;
+        cache->getMatrix("C_BB", C_BB);
+        cache->getMatrix("C_BA", C_BA);
+    } else {
+        if (!cache->hasMatrix("C_BA_DUAL", C_BA_DUAL))
+            return false;
+        assert(C_BB_A_DUAL == NULL);
+        C_BB_A_DUAL = new double[masterNumNodes];
+        if (!cache->getVector("C_BB_A_DUAL", masterNumNodes, C_BB_A_DUAL)) {
+            delete[] C_BB_A_DUAL;
+            C_BB_A_DUAL = NULL;
+            return false;
+        }
+        cache->getMatrix("C_BA_DUAL", C_BA_DUAL);
+        if (isExplicitMappingOperator)
+            computeMappingOperator();
+    }
+    // the tables are only needed for building the matrices
     deleteANNTree();
     deleteTables();
+    return true;
+}
+
+void MortarMapper::setIterativeSolver(double tolerance, int maxIterations) {
+    assert(!dual);
+    C_BB->setIterativeSolver(tolerance, maxIterations);
+}
+
+void MortarMapper::setIterativeSolverTolerance(double tolerance) {
+    assert(!dual);
+    C_BB->setIterativeTolerance(tolerance);
+}
+
+void MortarMapper::setLinearSolver(const std::string &name) {
+    if (!dual)
+        C_BB->setLinearSolver(name);
+}
+
+void MortarMapper::setPardisoSettings(const MathLibrary::PardisoSettings &settings) {
+    if (!dual)
+        C_BB->setPardisoSettings(settings);
+}
 
+MemoryUsage MortarMapper::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("C_BB", C_BB->getMemoryUsage());
+    if (!dual) {
+        usage.add("C_BA", C_BA->getMemoryUsage());
+    } else {
+        usage.add("C_BA_DUAL", C_BA_DUAL->getMemoryUsage());
+        if (C_BB_A_DUAL != NULL)
+            usage.add("C_BB_A_DUAL", masterNumNodes * sizeof(double));
+        if (H != NULL)
+            usage.add("H", H->getMemoryUsage());
+    }
+    return usage;
+}
+
+void MortarMapper::updateGeometry() {
+    // keep the matrices, so that C_BB keeps the analysis of the solver
+    if (!dual) {
+        C_BB->resetValues();
+        C_BA->resetValues();
+    } else {
+        delete[] C_BB_A_DUAL;
+        C_BB_A_DUAL = NULL;
+        delete H;
+        H = NULL;
+        C_BA_DUAL->resetValues();
+    }
+    // a shared searching tree and shared element geometries were built on the old coordinates, own
+    // ones are built instead
+    FLANNkd_tree = NULL;
+    sharedSlaveGeometry = NULL;
+    sharedMasterGeometry = NULL;
+    initTables();
+    initANNTree();
+    buildCouplingMatrices();
 }
 
 MortarMapper::~MortarMapper() {
     delete C_BB;
     delete[] C_BB_A_DUAL;
+    delete H;
 
     if(!dual){
         delete C_BA;
@@ -156,7 +302,27 @@ MortarMapper::~MortarMapper() {
 #endif
 }
 
+void MortarMapper::computeMappingOperator() {
+    assert(dual && C_BB_A_DUAL != NULL);
+    vector<int> rowPtr;
+    vector<int> cols;
+    vector<double> values;
+    C_BA_DUAL->getCSR(rowPtr, cols, values);
+    for (int i = 0; i < masterNumNodes; i++)
+        for (int j = rowPtr[i]; j < rowPtr[i + 1]; j++)
+            values[j] /= C_BB_A_DUAL[i];
+    delete H;
+    H = DistributedCSRMatrix::create(masterNumNodes, slaveNumNodes, rowPtr, cols, values,
+            mapperSetNumThreads, false,
+            MathLibrary::CSRMatrix::getProducts(isConsistentMappingUsed, isConservativeMappingUsed));
+}
+
 void MortarMapper::consistentMapping(const double *slaveField, double *masterField) {
+    if (H != NULL) {
+        PROFILER_SCOPE("SpMV");
+        H->multiply(false, slaveField, masterField);
+        return;
+    }
     double *slaveFieldCopy = new double[slaveNumNodes];
 
 //    INFO_OUT() << "MortarMapper::consistentMapping ->  Norm of the Slave field :: "  << EMPIRE::MathLibrary::computeVectorLength(slaveField) << endl;
@@ -165,18 +331,29 @@ void MortarMapper::consistentMapping(const double *slaveField, double *masterFie
     for (int i = 0; i < slaveNumNodes; i++)
         slaveFieldCopy[i] = slaveField[i];
 
-    // 1. matrix vector product (W_tmp = C_BA * W_A)
+    // 0. the previous master field is the initial guess of an iterative solver
+    double *ddum = NULL; // Temporary variable to store the solution of the system.
     if (!dual) {
-    	(*C_BA).mulitplyVec(false,slaveFieldCopy,masterField,masterNumNodes);
+        ddum = new double[masterNumNodes];
+        for (int i = 0; i < masterNumNodes; i++)
+            ddum[i] = masterField[i];
     }
-    else {
-    	(*C_BA_DUAL).mulitplyVec(false,slaveFieldCopy,masterField,masterNumNodes);
+
+    // 1. matrix vector product (W_tmp = C_BA * W_A)
+    {
+        PROFILER_SCOPE("SpMV");
+        if (!dual) {
+            (*C_BA).mulitplyVec(false,slaveFieldCopy,masterField,masterNumNodes);
+        }
+        else {
+            (*C_BA_DUAL).mulitplyVec(false,slaveFieldCopy,masterField,masterNumNodes);
+        }
     }
 
     delete[] slaveFieldCopy;
     // 2. solve C_BB * W_B = W_tmp
     if (!dual) {
-        double *ddum = new double[masterNumNodes]; // Temporary variable to store the solution of the system.
+        PROFILER_SCOPE("solve");
         (*C_BB).solve(ddum, masterField);
         for(int i=0; i<masterNumNodes; i++){
         	masterField[i] = ddum[i];
@@ -197,6 +374,11 @@ void MortarMapper::conservativeMapping(const double *masterField, double *slaveF
      * F_A --- slaveField
      * F_B --- masterField
      */
+    if (H != NULL) {
+        PROFILER_SCOPE("SpMV");
+        H->multiply(true, masterField, slaveField);
+        return;
+    }
 
 //    INFO_OUT() << "MortarMapper::consistentMapping ->  Norm of the Slave field :: "  << EMPIRE::MathLibrary::computeVectorLength(slaveField) << endl;
 //	  INFO_OUT() << "MortarMapper::consistentMapping ->  Norm of the Master field :: " << EMPIRE::MathLibrary::computeVectorLength(masterField) << endl;
@@ -206,9 +388,9 @@ void MortarMapper::conservativeMapping(const double *masterField, double *slaveF
         masterFieldCopy[i] = masterField[i];
     // 1. solve C_BB * F_tmp = F_B
     if (!dual) {
-
-    	double *ddum = new double[masterNumNodes]; // dummy but the memory is asked for
-    	(*C_BB).solve(ddum, masterFieldCopy);
+        PROFILER_SCOPE("solve");
+    	double *ddum = new double[masterNumNodes](); // dummy but the memory is asked for
+    	(*C_BB).solveTranspose(ddum, masterFieldCopy); // reuses the factorization of the consistent mapping
     	for(int i=0; i<masterNumNodes; i++){
     		masterFieldCopy[i] = ddum[i];
     	}
@@ -221,46 +403,195 @@ void MortarMapper::conservativeMapping(const double *masterField, double *slaveF
     // 2. matrix vector product (F_A = C_BA^T * F_tmp)
     int m = masterNumNodes; // number of rows of C_BA
     int n = slaveNumNodes; // number of columns of C_BA
+    {
+        PROFILER_SCOPE("SpMV");
+        if (!dual) {
+            (*C_BA).transposeMulitplyVec(masterFieldCopy, slaveField, masterNumNodes);
+        }
+        else {
+            (*C_BA_DUAL).transposeMulitplyVec(masterFieldCopy, slaveField, masterNumNodes);
+        }
+    }
+
+    delete[] masterFieldCopy;
+}
+
+void MortarMapper::consistentBlockMapping(const double *slaveField, double *masterField,
+        int numComponents) {
+    if (H != NULL) {
+        H->multiplyBlock(false, slaveField, masterField, numComponents);
+        return;
+    }
+    // 0. the previous master field is the initial guess of an iterative solver
+    double *ddum = NULL; // Temporary variable to store the solution of the system.
     if (!dual) {
-    	(*C_BA).transposeMulitplyVec(masterFieldCopy, slaveField, masterNumNodes);
+        ddum = new double[masterNumNodes * numComponents];
+        for (int i = 0; i < masterNumNodes * numComponents; i++)
+            ddum[i] = masterField[i];
     }
-    else {
-    	(*C_BA_DUAL).transposeMulitplyVec(masterFieldCopy, slaveField, masterNumNodes);
+
+    // 1. matrix product for all components (W_tmp = C_BA * W_A)
+    if (!dual) {
+        (*C_BA).multiplyBlock(false, slaveField, masterField, numComponents);
+    } else {
+        (*C_BA_DUAL).multiplyBlock(false, slaveField, masterField, numComponents);
+    }
+
+    // 2. solve C_BB * W_B = W_tmp with all components as right hand sides
+    if (!dual) {
+        (*C_BB).solveBlock(ddum, masterField, numComponents);
+        for (int i = 0; i < masterNumNodes * numComponents; i++) {
+            masterField[i] = ddum[i];
+        }
+        delete[] ddum;
+    } else {
+        for (int i = 0; i < masterNumNodes; i++)
+            for (int k = 0; k < numComponents; k++)
+                masterField[i * numComponents + k] /= C_BB_A_DUAL[i];
+    }
+}
+
+void MortarMapper::conservativeBlockMapping(const double *masterField, double *slaveField,
+        int numComponents) {
+    if (H != NULL) {
+        H->multiplyBlock(true, masterField, slaveField, numComponents);
+        return;
+    }
+    // 1. solve C_BB * F_tmp = F_B with all components as right hand sides
+    double *masterFieldCopy = new double[masterNumNodes * numComponents]();
+    if (!dual) {
+        (*C_BB).solveTransposeBlock(masterFieldCopy, masterField, numComponents);
+    } else {
+        for (int i = 0; i < masterNumNodes; i++)
+            for (int k = 0; k < numComponents; k++)
+                masterFieldCopy[i * numComponents + k] = masterField[i * numComponents + k] / C_BB_A_DUAL[i];
+    }
+
+    // 2. matrix product for all components (F_A = C_BA^T * F_tmp)
+    if (!dual) {
+        (*C_BA).multiplyBlock(true, masterFieldCopy, slaveField, numComponents);
+    } else {
+        (*C_BA_DUAL).multiplyBlock(true, masterFieldCopy, slaveField, numComponents);
     }
 
     delete[] masterFieldCopy;
 }
 
+void MortarMapper::getMappingOperator(std::vector<int> &rowPointers,
+        std::vector<int> &columnIndices, std::vector<double> &values) const {
+    H->getEntries(rowPointers, columnIndices, values);
+}
+
+bool MortarMapper::isRowBlockMappingSupported() const {
+    return H != NULL && isConsistentMappingUsed && H->isRowRangeProductSupported();
+}
+
+int MortarMapper::getNumRequiredNodesA(int endNodeB) const {
+    return H->getColumnBound(endNodeB);
+}
+
+void MortarMapper::consistentRowBlockMapping(const double *slaveField, double *masterField,
+        int numComponents, int firstNodeB, int endNodeB) {
+    H->multiplyRowRange(slaveField, masterField, numComponents, firstNodeB, endNodeB);
+}
+
+int MortarMapper::consistentChangedRowsMapping(const double *slaveField, double *masterField,
+        int numComponents, const char *isNodeAChanged) {
+    return H->multiplyChangedRows(slaveField, masterField, numComponents, isNodeAChanged);
+}
+
+void MortarMapper::mapBothDirections(const double *slaveField, double *masterField,
+        const double *masterIntegralField, double *slaveIntegralField, int numComponents) {
+    if (dual) {
+        AbstractMapper::mapBothDirections(slaveField, masterField, masterIntegralField,
+                slaveIntegralField, numComponents);
+        return;
+    }
+    // C_BB is symmetric, so C_BB^(-T) = C_BB^(-1) and both directions are one solve with
+    // 2 * numComponents right hand sides, the previous master field is the initial guess
+    int numVecs = 2 * numComponents;
+    vector<double> tmp(masterNumNodes * numComponents);
+    vector<double> rhs(masterNumNodes * numVecs);
+    vector<double> sol(masterNumNodes * numVecs, 0.0);
+
+    // 1. matrix product for all components (W_tmp = C_BA * W_A)
+    (*C_BA).multiplyBlock(false, slaveField, &tmp[0], numComponents);
+    for (int i = 0; i < masterNumNodes; i++) {
+        for (int k = 0; k < numComponents; k++) {
+            rhs[i * numVecs + k] = tmp[i * numComponents + k];
+            rhs[i * numVecs + numComponents + k] = masterIntegralField[i * numComponents + k];
+            sol[i * numVecs + k] = masterField[i * numComponents + k];
+        }
+    }
+
+    // 2. solve C_BB * [W_B, F_tmp] = [W_tmp, F_B]
+    (*C_BB).solveBlock(&sol[0], &rhs[0], numVecs);
+    for (int i = 0; i < masterNumNodes; i++) {
+        for (int k = 0; k < numComponents; k++) {
+            masterField[i * numComponents + k] = sol[i * numVecs + k];
+            tmp[i * numComponents + k] = sol[i * numVecs + numComponents + k];
+        }
+    }
+
+    // 3. matrix product for all components (F_A = C_BA^T * F_tmp)
+    (*C_BA).multiplyBlock(true, &tmp[0], slaveIntegralField, numComponents);
+}
+
 void MortarMapper::computeErrorsConsistentMapping(const double *slaveField, const double *masterField) {
     ERROR_OUT() << "Error computation for the mortar mapper has not been implemented" << endl;
     exit(-1);
 }
 
 void MortarMapper::computeC_BB() {
-    // 1. compute the sparsity map
-    // sparsity map has the information of a, ia, ja in a CSR formated matrix
+    // 1. compute the sparsity pattern from the master elements, the entries of the element mass
+    // matrices are added to it directly in CSR format
     if (!dual) {
-
+        vector<int> elemPtr(masterNumElems + 1, 0);
+        for (int i = 0; i < masterNumElems; i++)
+            elemPtr[i + 1] = elemPtr[i] + masterNodesPerElem[i];
+        vector<int> elemNodes(elemPtr[masterNumElems]);
+        for (int i = 0; i < masterNumElems; i++)
+            for (int j = 0; j < masterNodesPerElem[i]; j++)
+                elemNodes[elemPtr[i] + j] = masterConnectivity->getElemNodes(i)[j];
+        vector<int> rowPtr, cols;
+        MathLibrary::computeSparsityPattern(masterNumNodes, elemPtr, elemNodes, elemPtr, elemNodes,
+                true, mapperSetNumThreads, rowPtr, cols);
+        C_BB->setPattern(rowPtr, cols);
     } else {
         C_BB_A_DUAL = new double[masterNumNodes];
         for (int i = 0; i < masterNumNodes; i++)
             C_BB_A_DUAL[i] = 0.0;
     }
 
+    double workTime = 0.0;
+    // if the assembly has to be reproducible, the mass matrices of the elements are stored and added
+    // in the order of the elements afterwards, otherwise every thread adds them atomically
+    const bool isReproducible = AuxiliaryParameters::reproducible;
+    vector<int> massMatricesPtr;
+    vector<double> massMatrices;
+    if (isReproducible) {
+        massMatricesPtr.assign(masterNumElems + 1, 0);
+        for (int i = 0; i < masterNumElems; i++)
+            massMatricesPtr[i + 1] = massMatricesPtr[i] + masterNodesPerElem[i] * masterNodesPerElem[i];
+        massMatrices.resize(massMatricesPtr[masterNumElems]);
+    }
+
+#pragma omp parallel num_threads(mapperSetNumThreads) reduction(+:workTime)
+    {
+    double threadStartTime = omp_get_wtime();
+#pragma omp for
     for (int i = 0; i < masterNumElems; i++) {
         const int numNodesMasterElem = masterNodesPerElem[i];
         double elem[numNodesMasterElem * 3]; // this element
         int pos[numNodesMasterElem]; // the position of the node in the nodeCoors
         for (int j = 0; j < numNodesMasterElem; j++) {
-            pos[j] = masterDirectElemTable[i]->at(j);
+            pos[j] = masterConnectivity->getElemNodes(i)[j];
             for (int k = 0; k < 3; k++)
                 elem[j * 3 + k] = masterNodeCoors[pos[j] * 3 + k];
         }
         if (numNodesMasterElem == 4) { // replace the master element by the projection of it on its "element plane"
-            double masterElemNormal[3];
-            EMPIRE::MathLibrary::computeNormalOfQuad(elem, true, masterElemNormal);
-            double masterQuadCenter[3];
-            EMPIRE::MathLibrary::computePolygonCenter(elem, 4, masterQuadCenter);
+            const double *masterElemNormal = masterGeometry->getNormal(i);
+            const double *masterQuadCenter = masterGeometry->getCentroid(i);
             double masterQuadPrj[12];
             EMPIRE::MathLibrary::projectToPlane(masterQuadCenter, masterElemNormal, elem, 4, masterQuadPrj);
             for (int i = 0; i < 12; i++)
@@ -270,65 +601,112 @@ void MortarMapper::computeC_BB() {
         // make use of the symmetry
         double massMatrix[numNodesMasterElem * numNodesMasterElem];
         if (numNodesMasterElem == 4)
-        	EMPIRE::MathLibrary::computeMassMatrixOfQuad(elem, numGPsMassMatrixQuad, dual, massMatrix);
+        	EMPIRE::MathLibrary::computeMassMatrixOfQuad<numGPsMassMatrixQuad>(elem, dual, massMatrix);
         else if (numNodesMasterElem == 3)
-        	EMPIRE::MathLibrary::computeMassMatrixOfTrianlge(elem, numGPsMassMatrixTri, dual, massMatrix);
+        	EMPIRE::MathLibrary::computeMassMatrixOfTriangle<numGPsMassMatrixTri>(elem, dual, massMatrix);
         else
             assert(false);
-        if (!dual) {
+        if (isReproducible) {
+            for (int j = 0; j < numNodesMasterElem * numNodesMasterElem; j++)
+                massMatrices[massMatricesPtr[i] + j] = massMatrix[j];
+        } else if (!dual) {
 
         	for (int j = 0; j < numNodesMasterElem; j++) {
             	for (int k = 0; k < numNodesMasterElem; k++) {
             		double massMatrixJK = massMatrix[j * numNodesMasterElem + k];
-            		(*C_BB)(pos[j], pos[k]) += massMatrixJK;
+            		C_BB->addToEntry(pos[j], pos[k], massMatrixJK);
             	}
             }
 
         } else {
             for (int j = 0; j < numNodesMasterElem; j++) {
+#pragma omp atomic
                 C_BB_A_DUAL[pos[j]] += massMatrix[j * numNodesMasterElem + j];
             }
         }
     }
+    workTime += omp_get_wtime() - threadStartTime;
+    } //#pragma omp parallel
+    for (int i = 0; i < masterNumElems && isReproducible; i++) {
+        const int numNodesMasterElem = masterNodesPerElem[i];
+        const int *pos = masterConnectivity->getElemNodes(i);
+        const double *massMatrix = &massMatrices[massMatricesPtr[i]];
+        for (int j = 0; j < numNodesMasterElem; j++) {
+            if (!dual) {
+                for (int k = 0; k < numNodesMasterElem; k++)
+                    C_BB->addToEntry(pos[j], pos[k], massMatrix[j * numNodesMasterElem + k]);
+            } else {
+                C_BB_A_DUAL[pos[j]] += massMatrix[j * numNodesMasterElem + j];
+            }
+        }
+    }
+    assemblyWorkTime += workTime;
+
+    // C_BB is complete, it is frozen so that its rows can be queried, e.g. to enforce consistency
+    if (!dual)
+        C_BB->freeze();
 }
 
 void MortarMapper::computeC_BA() {
 
+    // 1. find the slave elements whose boxes intersect the box of every master element, every
+    // thread collects its entries in its own buffer, they are merged into C_BA afterwards
+    vector<int> candidatesPtr;
+    vector<int> candidates;
+    findCandidates(candidatesPtr, candidates);
+#ifdef FLANN
+    int numBuffers = MathLibrary::getNumAssemblyBuffers(mapperSetNumThreads, masterNumElems);
+#else
+    int numBuffers = MathLibrary::getNumAssemblyBuffers(1, masterNumElems);
+#endif
+    std::vector<std::vector<MathLibrary::SparseMatrixTriplet<double> > > buffers(numBuffers);
+    // the master and the slave element of every overlap found by a thread, or of a master element if
+    // the assembly has to be reproducible, one after the other
+    std::vector<std::vector<int> > overlaps(numBuffers);
+    double workTime = 0.0;
+    // the master elements with the most candidates are clipped first, the cheap ones balance the
+    // threads at the end
+    vector<int> masterOrder;
+    {
+        vector<double> masterCosts(masterNumElems);
+        for (int i = 0; i < masterNumElems; i++)
+            masterCosts[i] = candidatesPtr[i + 1] - candidatesPtr[i];
+        CostOrderedSchedule::computeOrder(masterCosts, masterOrder);
+    }
+    BuildProgress progress("MortarMapper: clipping and integration", "master elements", masterNumElems);
+
     // 2. compute entries in the sparsity map by looping over the master elements
 #ifdef FLANN
-#pragma omp parallel num_threads(mapperSetNumThreads)
+#pragma omp parallel num_threads(mapperSetNumThreads) reduction(+:workTime)
 #endif
     {
+        double threadStartTime = omp_get_wtime();
 #ifdef FLANN
         //EMPIRE::AuxiliaryFunctions::report_num_threads(2);
-#pragma omp for
+#pragma omp for schedule(dynamic, 1)
 #endif
-        for (int i = 0; i < masterNumElems; i++) {
+        for (int position = 0; position < masterNumElems; position++) {
+            int i = masterOrder[position];
+            std::vector<MathLibrary::SparseMatrixTriplet<double> >& buffer = buffers[MathLibrary::getAssemblyBuffer(i)];
+            std::vector<int>& overlapElems = overlaps[MathLibrary::getAssemblyBuffer(i)];
             // 2.1 compute the searching radius
             int numNodesMasterElem = masterNodesPerElem[i];
             double *masterElem = new double[numNodesMasterElem * 3];
             getElemCoor(i, MortarMapper::MASTER, masterElem);
 
-            double radiusSqr = computeSearchRadiusSquare(masterElem, numNodesMasterElem);
-            // if (!(i%1000)) cout << endl << i << "RADIUS: " << radius << endl;
-
-            // 2.2 find all candidates which may overlap the master element
-            double masterElemNormal[3];
-            if (numNodesMasterElem == 3) {
-            	EMPIRE::MathLibrary::computeNormalOfTriangle(masterElem, true, masterElemNormal);
-            } else {
-            	EMPIRE::MathLibrary::computeNormalOfQuad(masterElem, true, masterElemNormal);
-            }
+            // 2.2 the candidates which may overlap the master element, without the elements having
+            // the wrong normal direction
+            const double *masterElemNormal = masterGeometry->getNormal(i);
             set<int> *neighborElems = new set<int>;
-            findCandidates(masterElem, numNodesMasterElem, masterElemNormal, radiusSqr,
-                    neighborElems);
+            for (int j = candidatesPtr[i]; j < candidatesPtr[i + 1]; j++)
+                if (!kickOutCandidate(masterElemNormal, slaveGeometry->getNormal(candidates[j]), 0.7))
+                    neighborElems->insert(neighborElems->end(), candidates[j]);
 
             map<int, double*> *projections = new map<int, double*>; // the projections of all neighboring nodes
             if (numNodesMasterElem == 3)
                 projectToElemPlane(masterElem, masterElemNormal, neighborElems, projections);
             if (numNodesMasterElem == 4) { // replace the master element by the projection of it on its "element plane"
-                double masterQuadCenter[3];
-                EMPIRE::MathLibrary::computePolygonCenter(masterElem, numNodesMasterElem, masterQuadCenter);
+                const double *masterQuadCenter = masterGeometry->getCentroid(i);
                 double masterQuadPrj[12];
                 EMPIRE::MathLibrary::projectToPlane(masterQuadCenter, masterElemNormal, masterElem, 4,
                         masterQuadPrj);
@@ -341,50 +719,61 @@ void MortarMapper::computeC_BA() {
 
             int posMasterNodes[numNodesMasterElem]; // the position of the nodes in the master element
             for (int j = 0; j < numNodesMasterElem; j++)
-                posMasterNodes[j] = masterDirectElemTable[i]->at(j);
+                posMasterNodes[j] = masterConnectivity->getElemNodes(i)[j];
 
             // 2.3 create the point clipper
-            int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(masterElemNormal);
-            EMPIRE::MathLibrary::PolygonClipper *clipper = new EMPIRE::MathLibrary::PolygonClipper(masterElem,
-                    numNodesMasterElem, planeToProject);
+            int planeToProject = masterGeometry->getPlaneToProject(i);
+            EMPIRE::MathLibrary::PolygonClipper clipper(masterElem, numNodesMasterElem, planeToProject);
 
             // 2.4 if dual, compute the coefficient matrix here
             double coeffMatrix[numNodesMasterElem * numNodesMasterElem];
             if (dual)
                 computeDualCoeffMatrix(masterElem, numNodesMasterElem, coeffMatrix);
-            // 2.5 loop over the candidates, do clipping
+
+            // 2.5 the master edges every projected node is outside of, computed once for the nodes shared
+            // by several candidates
+            map<int, int> outsideCodes;
+            for (map<int, double*>::iterator it = projections->begin(); it != projections->end(); it++)
+                outsideCodes.insert(outsideCodes.end(), pair<int, int>(it->first, clipper.computeOutsideCode(it->second)));
+
+            // 2.6 loop over the candidates, do clipping
             for (set<int>::iterator it = neighborElems->begin(); it != neighborElems->end(); it++) {
                 int numNodesSlaveElem = slaveNodesPerElem[*it];
                 int posSlaveNodes[numNodesSlaveElem]; // the position of the node in the slave triangle
                 double slaveElemPrj[numNodesSlaveElem * 3];
 
+                int commonOutsideCode = ~0;
+                for (int ii = 0; ii < numNodesSlaveElem; ii++) {
+                    posSlaveNodes[ii] = slaveConnectivity->getElemNodes(*it)[ii];
+                    commonOutsideCode &= outsideCodes.find(posSlaveNodes[ii])->second;
+                }
+                if (commonOutsideCode != 0) // all nodes are outside of one master edge, no overlap
+                    continue;
+
                 for (int ii = 0; ii < numNodesSlaveElem; ii++) {
-                    posSlaveNodes[ii] = slaveDirectElemTable[*it]->at(ii);
                     for (int jj = 0; jj < 3; jj++) {
                         slaveElemPrj[ii * 3 + jj] = projections->at(posSlaveNodes[ii])[jj];
                     }
                 }
                 double result[numNodesMasterElem * numNodesSlaveElem];
 
-                vector<double*> *clippedPolygon = new vector<double*>;
-                bool overlap = clipper->clip(slaveElemPrj, numNodesSlaveElem, clippedPolygon); // clip
+                // clip and integrate on the stack, nothing is allocated for a pair of elements
+                double clippedPolygon[EMPIRE::MathLibrary::PolygonClipper::MAX_SIZE_CLIPPED_POLYGON * 3];
+                int sizeClippedPolygon;
+                bool overlap = clipper.clip(slaveElemPrj, numNodesSlaveElem, clippedPolygon,
+                        sizeClippedPolygon);
                 if (overlap)
                     gaussQuadratureOnClip(masterElem, numNodesMasterElem, slaveElemPrj,
-                            numNodesSlaveElem, planeToProject, clippedPolygon, result);
-                for (int i = 0; i < clippedPolygon->size(); i++)
-                    delete[] clippedPolygon->at(i);
-                delete clippedPolygon;
+                            numNodesSlaveElem, planeToProject, clippedPolygon, sizeClippedPolygon,
+                            result);
                 if (overlap) { // only add the result to sparsity map if overlap happens, that is how C_BA is sparse
+                    overlapElems.push_back(i);
+                    overlapElems.push_back(*it);
                     if (!dual) {
                         for (int ii = 0; ii < numNodesMasterElem; ii++) {
                             for (int jj = 0; jj < numNodesSlaveElem; jj++) {
-#ifdef FLANN
-#pragma omp critical (map1)
-#endif
-                                {
-                                	(*C_BA)(posMasterNodes[ii], posSlaveNodes[jj]) += result[ii * numNodesSlaveElem + jj];
-                                	//std::cout<<"C_BA("<<posMasterNodes[ii]<<","<<posSlaveNodes[jj]<<") = "<<result[ii * numNodesSlaveElem + jj]<<std::endl;
-                                } //omp critical
+                                buffer.push_back(MathLibrary::SparseMatrixTriplet<double>(posMasterNodes[ii], posSlaveNodes[jj],
+                                        result[ii * numNodesSlaveElem + jj]));
                             }
                         }
                     } else {
@@ -395,14 +784,8 @@ void MortarMapper::computeC_BA() {
                                 coeffMatrix, result_dual); // now it is dual
                         for (int ii = 0; ii < numNodesMasterElem; ii++) {
                             for (int jj = 0; jj < numNodesSlaveElem; jj++) {
-#ifdef FLANN
-#pragma omp critical (map2)
-#endif
-                                {
-                                	(*C_BA_DUAL)(posMasterNodes[ii], posSlaveNodes[jj]) += result_dual[ii * numNodesSlaveElem + jj];
-                                	if(result_dual[ii * numNodesSlaveElem + jj] == NAN)
-                                		std::cout<<"C_BA("<<posMasterNodes[ii]<<","<<posSlaveNodes[jj]<<") = "<<result[ii * numNodesSlaveElem + jj]<<std::endl;
-                                } //omp critical
+                                buffer.push_back(MathLibrary::SparseMatrixTriplet<double>(posMasterNodes[ii], posSlaveNodes[jj],
+                                        result_dual[ii * numNodesSlaveElem + jj]));
                             }
                         }
                         //(*C_BA_DUAL).printFullToFile("Mortar_C_BA.log");
@@ -416,12 +799,45 @@ void MortarMapper::computeC_BA() {
             delete[] masterElem;
             delete projections;
             delete neighborElems;
-            delete clipper;
+            progress.add();
         }
-
+        workTime += omp_get_wtime() - threadStartTime;
     } //#pragma omp parallel
+    progress.finish();
+    assemblyWorkTime += workTime;
 
-    // 3. modify C_BA to enforce consistency
+    // 3. add the entries of all threads directly in CSR format, the pattern is given by the overlapping
+    // elements. Enforcing consistency replaces rows of C_BA, so the buffers are merged into the matrix then
+    MathLibrary::SparseMatrix<double> *matrix = dual ? C_BA_DUAL : C_BA;
+    if (toEnforceConsistency) {
+        matrix->addTriplets(buffers, mapperSetNumThreads);
+    } else {
+        vector<int> elemRowPtr(1, 0), elemRows, elemColPtr(1, 0), elemCols;
+        for (int b = 0; b < numBuffers; b++) {
+            for (size_t k = 0; k < overlaps[b].size(); k += 2) {
+                const int *masterNodes = masterConnectivity->getElemNodes(overlaps[b][k]);
+                elemRows.insert(elemRows.end(), masterNodes, masterNodes + masterNodesPerElem[overlaps[b][k]]);
+                elemRowPtr.push_back(elemRows.size());
+                const int *slaveNodes = slaveConnectivity->getElemNodes(overlaps[b][k + 1]);
+                elemCols.insert(elemCols.end(), slaveNodes, slaveNodes + slaveNodesPerElem[overlaps[b][k + 1]]);
+                elemColPtr.push_back(elemCols.size());
+            }
+            std::vector<int>().swap(overlaps[b]);
+        }
+        vector<int> rowPtr, cols;
+        MathLibrary::computeSparsityPattern(masterNumNodes, elemRowPtr, elemRows, elemColPtr, elemCols,
+                false, mapperSetNumThreads, rowPtr, cols);
+        matrix->setPattern(rowPtr, cols);
+        // the buffers are added in their order if the assembly has to be reproducible
+#pragma omp parallel for num_threads(mapperSetNumThreads) schedule(dynamic) if (!AuxiliaryParameters::reproducible)
+        for (int b = 0; b < numBuffers; b++) {
+            for (size_t k = 0; k < buffers[b].size(); k++)
+                matrix->addToEntry(buffers[b][k].row, buffers[b][k].column, buffers[b][k].value);
+            std::vector<MathLibrary::SparseMatrixTriplet<double> >().swap(buffers[b]);
+        }
+    }
+
+    // 4. modify C_BA to enforce consistency
     if (toEnforceConsistency) {
         enforceConsistency();
     }
@@ -561,30 +977,25 @@ void MortarMapper::enforceConsistency() {
 #endif
                 //sparsityMapC_BA[i]->insert(pair<int, double>(nb, factor[i]));
                 // nearest element interpolation
-                vector<int> * vecElemOfNode = slaveNodeToElemTable[nb];
+                const int *elemsOfNode = slaveConnectivity->getNodeElems(nb);
+                const int numElemsOfNode = slaveConnectivity->getNumElemsOfNode(nb);
                 double minDistance = 1E100; // arbitrary big value
                 int elemWithMinDist = -1;
 
-                for (int j=0; j<vecElemOfNode->size(); j++) {
-                    int numNodesThisElem = slaveNodesPerElem[vecElemOfNode->at(j)];
-                    double *slaveElem = new double[numNodesThisElem * 3];
-                    getElemCoor(vecElemOfNode->at(j), MortarMapper::SLAVE, slaveElem);
-                    double center[3];
-                    EMPIRE::MathLibrary::computePolygonCenter(slaveElem, numNodesThisElem, center);
+                for (int j=0; j<numElemsOfNode; j++) {
+                    const double *center = slaveGeometry->getCentroid(elemsOfNode[j]);
                     double dist = EMPIRE::MathLibrary::distanceSquare(center, &masterNodeCoors[i * 3]);
                     if (dist < minDistance) {
                         minDistance = dist;
-                        elemWithMinDist = vecElemOfNode->at(j);
+                        elemWithMinDist = elemsOfNode[j];
                     }
-                    delete[] slaveElem;
                 }
                 int numNodesThisElem = slaveNodesPerElem[elemWithMinDist];;
                 if (numNodesThisElem == 3) {
                     double triangle[3 * 3];
                     getElemCoor(elemWithMinDist, MortarMapper::SLAVE, triangle);
-                    double normal[3];
-                    EMPIRE::MathLibrary::computeNormalOfTriangle(triangle, true, normal);
-                    int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(normal);
+                    const double *normal = slaveGeometry->getNormal(elemWithMinDist);
+                    int planeToProject = slaveGeometry->getPlaneToProject(elemWithMinDist);
 
                     double projection[3];
                     EMPIRE::MathLibrary::projectToPlane(&triangle[0], normal, &masterNodeCoors[i * 3], 1,
@@ -595,19 +1006,17 @@ void MortarMapper::enforceConsistency() {
                             projection, localCoors);
 
                     for (int j=0; j<3; j++) {
-                        int nodePos = slaveDirectElemTable[elemWithMinDist]->at(j);
+                        int nodePos = slaveConnectivity->getElemNodes(elemWithMinDist)[j];
                         (*C_BA)(i,nodePos) = factor[i]*localCoors[j];
                     }
                 } else if (numNodesThisElem == 4) {
                     double quad[4 * 3];
                     getElemCoor(elemWithMinDist, MortarMapper::SLAVE, quad);
-                    double normal[3];
-                    EMPIRE::MathLibrary::computeNormalOfQuad(quad, true, normal);
-                    int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(normal);
+                    const double *normal = slaveGeometry->getNormal(elemWithMinDist);
+                    int planeToProject = slaveGeometry->getPlaneToProject(elemWithMinDist);
 
                     { // replace the element by the projection of it on its "element plane"
-                        double quadCenter[3];
-                        EMPIRE::MathLibrary::computePolygonCenter(quad, 4, quadCenter);
+                        const double *quadCenter = slaveGeometry->getCentroid(elemWithMinDist);
                         double quadPrj[12];
                         EMPIRE::MathLibrary::projectToPlane(quadCenter, normal, quad, 4, quadPrj);
                         for (int j = 0; j < 12; j++)
@@ -623,7 +1032,7 @@ void MortarMapper::enforceConsistency() {
                     double weights[4];
                     EMPIRE::MathLibrary::computeShapeFuncOfQuad(localCoors, weights);
                     for (int j=0; j<4; j++) {
-                        int nodePos = slaveDirectElemTable[elemWithMinDist]->at(j);
+                        int nodePos = slaveConnectivity->getElemNodes(elemWithMinDist)[j];
                         (*C_BA)(i,nodePos) = factor[i]*weights[j];
                     }
                 } else {
@@ -666,30 +1075,25 @@ void MortarMapper::enforceConsistency() {
 #endif
 
                 // nearest element interpolation
-                vector<int> * vecElemOfNode = slaveNodeToElemTable[nb];
+                const int *elemsOfNode = slaveConnectivity->getNodeElems(nb);
+                const int numElemsOfNode = slaveConnectivity->getNumElemsOfNode(nb);
                 double minDistance = 1E100; // arbitrary big value
                 int elemWithMinDist = -1;
 
-                for (int j=0; j<vecElemOfNode->size(); j++) {
-                    int numNodesThisElem = slaveNodesPerElem[vecElemOfNode->at(j)];
-                    double *slaveElem = new double[numNodesThisElem * 3];
-                    getElemCoor(vecElemOfNode->at(j), MortarMapper::SLAVE, slaveElem);
-                    double center[3];
-                    EMPIRE::MathLibrary::computePolygonCenter(slaveElem, numNodesThisElem, center);
+                for (int j=0; j<numElemsOfNode; j++) {
+                    const double *center = slaveGeometry->getCentroid(elemsOfNode[j]);
                     double dist = EMPIRE::MathLibrary::distanceSquare(center, &masterNodeCoors[i * 3]);
                     if (dist < minDistance) {
                         minDistance = dist;
-                        elemWithMinDist = vecElemOfNode->at(j);
+                        elemWithMinDist = elemsOfNode[j];
                     }
-                    delete[] slaveElem;
                 }
                 int numNodesThisElem = slaveNodesPerElem[elemWithMinDist];;
                 if (numNodesThisElem == 3) {
                     double triangle[3 * 3];
                     getElemCoor(elemWithMinDist, MortarMapper::SLAVE, triangle);
-                    double normal[3];
-                    EMPIRE::MathLibrary::computeNormalOfTriangle(triangle, true, normal);
-                    int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(normal);
+                    const double *normal = slaveGeometry->getNormal(elemWithMinDist);
+                    int planeToProject = slaveGeometry->getPlaneToProject(elemWithMinDist);
 
                     double projection[3];
                     EMPIRE::MathLibrary::projectToPlane(&triangle[0], normal, &masterNodeCoors[i * 3], 1,
@@ -700,19 +1104,17 @@ void MortarMapper::enforceConsistency() {
                             projection, localCoors);
 
                     for (int j=0; j<3; j++) {
-                        int nodePos = slaveDirectElemTable[elemWithMinDist]->at(j);
+                        int nodePos = slaveConnectivity->getElemNodes(elemWithMinDist)[j];
                         (*C_BA_DUAL)(i,nodePos) = factor*localCoors[j];
                     }
                 } else if (numNodesThisElem == 4) {
                     double quad[4 * 3];
                     getElemCoor(elemWithMinDist, MortarMapper::SLAVE, quad);
-                    double normal[3];
-                    EMPIRE::MathLibrary::computeNormalOfQuad(quad, true, normal);
-                    int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(normal);
+                    const double *normal = slaveGeometry->getNormal(elemWithMinDist);
+                    int planeToProject = slaveGeometry->getPlaneToProject(elemWithMinDist);
 
                     { // replace the element by the projection of it on its "element plane"
-                        double quadCenter[3];
-                        EMPIRE::MathLibrary::computePolygonCenter(quad, 4, quadCenter);
+                        const double *quadCenter = slaveGeometry->getCentroid(elemWithMinDist);
                         double quadPrj[12];
                         EMPIRE::MathLibrary::projectToPlane(quadCenter, normal, quad, 4, quadPrj);
                         for (int j = 0; j < 12; j++)
@@ -728,7 +1130,7 @@ void MortarMapper::enforceConsistency() {
                     double weights[4];
                     EMPIRE::MathLibrary::computeShapeFuncOfQuad(localCoors, weights);
                     for (int j=0; j<4; j++) {
-                        int nodePos = slaveDirectElemTable[elemWithMinDist]->at(j);
+                        int nodePos = slaveConnectivity->getElemNodes(elemWithMinDist)[j];
                         (*C_BA_DUAL)(i,nodePos) = factor*weights[j];
                     }
                 } else {
@@ -750,82 +1152,45 @@ void MortarMapper::enforceConsistency() {
 
 
 void MortarMapper::initTables() {
-    // using the map to store the nodeNumbers
-    // but here the "key" is the node number, and the value is the position in nodeNumbers
-    // the map is sorted automatically, so it is efficient for searching
-
-    { // 1. compute slaveDirectElemTable
-        slaveDirectElemTable = new vector<int>*[slaveNumElems];
-        for (int i = 0; i < slaveNumElems; i++)
-            slaveDirectElemTable[i] = new vector<int>;
-        map<int, int> *slaveNodesMap = new map<int, int>();
-        for (int i = 0; i < slaveNumNodes; i++)
-            slaveNodesMap->insert(slaveNodesMap->end(), pair<int, int>(slaveNodeNumbers[i], i));
-        int count = 0;
-        for (int i = 0; i < slaveNumElems; i++) {
-            const int numNodesSlaveElem = slaveNodesPerElem[i];   
-            for (int j = 0; j < numNodesSlaveElem; j++) {
-                if(slaveNodesMap->find(slaveElemTable[count + j])== slaveNodesMap->end() ){
-                ERROR_OUT()<< "Slave Node Label " << slaveElemTable[count + j] << " is not part of slaveNodesMap." << endl;
-                }
-                slaveDirectElemTable[i]->push_back(slaveNodesMap->at(slaveElemTable[count + j]));
-            }
-            count += numNodesSlaveElem;
-        }
-        delete slaveNodesMap;
-    }
-
-    { // 2. compute masterDirectElemTable
-        masterDirectElemTable = new vector<int>*[masterNumElems];
-        for (int i = 0; i < masterNumElems; i++)
-            masterDirectElemTable[i] = new vector<int>;
-        map<int, int> *masterNodesMap = new map<int, int>();
-
-        for (int i = 0; i < masterNumNodes; i++)
-            masterNodesMap->insert(masterNodesMap->end(), pair<int, int>(masterNodeNumbers[i], i));
-
-        int count = 0;
-        for (int i = 0; i < masterNumElems; i++) {
-            const int numNodesMasterElem = masterNodesPerElem[i];
-            for (int j = 0; j < numNodesMasterElem; j++) {
-                masterDirectElemTable[i]->push_back(masterNodesMap->at(masterElemTable[count + j]));
-            }
-            count += numNodesMasterElem;
-        }
-        delete masterNodesMap;
-    }
-
-    { // 3. compute slaveNodeToElemTable
-        slaveNodeToElemTable = new vector<int>*[slaveNumNodes];
-        for (int i = 0; i < slaveNumNodes; i++)
-            slaveNodeToElemTable[i] = new vector<int>;
-        for (int i = 0; i < slaveNumElems; i++) {
-            const int numNodesSlaveElem = slaveNodesPerElem[i];
-            for (int j = 0; j < numNodesSlaveElem; j++) {
-                int nodePos = slaveDirectElemTable[i]->at(j);
-                slaveNodeToElemTable[nodePos]->push_back(i);
-            }
-        }
-    }
+    // the tables refer to the position of a node in nodeCoors instead of its number
+    if (sharedSlaveConnectivity != NULL)
+        slaveConnectivity = sharedSlaveConnectivity;
+    else
+        slaveConnectivity = new FEMeshConnectivity(slaveNumNodes, slaveNodeNumbers, slaveNumElems,
+                slaveNodesPerElem, slaveElemTable);
+    if (sharedMasterConnectivity != NULL)
+        masterConnectivity = sharedMasterConnectivity;
+    else
+        masterConnectivity = new FEMeshConnectivity(masterNumNodes, masterNodeNumbers, masterNumElems,
+                masterNodesPerElem, masterElemTable);
+}
 
-    // 4. computeSlaveElemNormals
-    computeSlaveElemNormals();
+void MortarMapper::initElemGeometry() {
+    if (sharedSlaveGeometry != NULL)
+        slaveGeometry = sharedSlaveGeometry;
+    else
+        slaveGeometry = new FEMeshGeometry(slaveNumElems, slaveNodesPerElem, slaveNodeCoors,
+                slaveConnectivity, mapperSetNumThreads);
+    if (sharedMasterGeometry != NULL)
+        masterGeometry = sharedMasterGeometry;
+    else
+        masterGeometry = new FEMeshGeometry(masterNumElems, masterNodesPerElem, masterNodeCoors,
+                masterConnectivity, mapperSetNumThreads);
 }
 
 void MortarMapper::deleteTables() {
-    for (int i = 0; i < slaveNumElems; i++)
-        delete slaveDirectElemTable[i];
-    delete[] slaveDirectElemTable;
-
-    for (int i = 0; i < masterNumElems; i++)
-        delete masterDirectElemTable[i];
-    delete[] masterDirectElemTable;
-
-    for (int i = 0; i < slaveNumNodes; i++)
-        delete slaveNodeToElemTable[i];
-    delete[] slaveNodeToElemTable;
-
-    delete[] slaveElemNormals;
+    if (slaveConnectivity != sharedSlaveConnectivity)
+        delete slaveConnectivity;
+    slaveConnectivity = NULL;
+    if (masterConnectivity != sharedMasterConnectivity)
+        delete masterConnectivity;
+    masterConnectivity = NULL;
+    if (slaveGeometry != sharedSlaveGeometry)
+        delete slaveGeometry;
+    slaveGeometry = NULL;
+    if (masterGeometry != sharedMasterGeometry)
+        delete masterGeometry;
+    masterGeometry = NULL;
 }
 
 void MortarMapper::initANNTree() {
@@ -838,13 +1203,29 @@ void MortarMapper::initANNTree() {
     }
     slaveNodesTree = new ANNkd_tree(ANNSlaveNodes, slaveNumNodes, 3);
 #endif
+}
+
+void MortarMapper::initFLANNTree() {
 #ifdef FLANN
+    if (FLANNkd_tree != NULL)
+        return;
     FLANNSlaveNodes = new flann::Matrix<double>(const_cast<double*>(slaveNodeCoors), slaveNumNodes, 3);
     FLANNkd_tree = new flann::Index<flann::L2<double> >(*FLANNSlaveNodes, flann::KDTreeSingleIndexParams(1));
     FLANNkd_tree->buildIndex(); // Build binary tree for searching
 #endif
 }
 
+void MortarMapper::setSharedSearchTree(flann::Index<flann::L2<double> > *tree) {
+    assert(FLANNkd_tree == NULL);
+    FLANNkd_tree = tree;
+}
+
+void MortarMapper::setSharedElemGeometry(const FEMeshGeometry *_slaveGeometry,
+        const FEMeshGeometry *_masterGeometry) {
+    sharedSlaveGeometry = _slaveGeometry;
+    sharedMasterGeometry = _masterGeometry;
+}
+
 void MortarMapper::deleteANNTree() {
 #ifdef ANN
     delete[] ANNSlaveNodes;
@@ -852,187 +1233,151 @@ void MortarMapper::deleteANNTree() {
     annClose();
 #endif
 #ifdef FLANN
-    delete FLANNSlaveNodes;
-    delete FLANNkd_tree;
+    if (FLANNSlaveNodes != NULL) { // the tree is not shared
+        delete FLANNSlaveNodes;
+        delete FLANNkd_tree;
+        FLANNSlaveNodes = NULL;
+        FLANNkd_tree = NULL;
+    }
 #endif
 }
 
-void MortarMapper::gaussQuadratureOnClip(const double *masterElem, int numNodesMasterElem,
-        const double *slaveElem, int numNodesSlaveElem, int planeToProject,
-        vector<double*> *clippedPolygon, double *result) {
-    for (int i = 0; i < numNodesMasterElem * numNodesSlaveElem; i++)
+/***********************************************************************************************
+ * \brief Compute the shape function values of an element at a point inside of it
+ * \param[in] elem the element
+ * \param[in] planeToProject project to plane (case: {2:x-y ; 0:y-z ;1: z-x} )
+ * \param[in] point the point
+ * \param[out] shapeFuncValues the values of the NUM_NODES shape functions
+ ***********/
+template<int NUM_NODES> static void computeShapeFuncValues(const double *elem,
+        int planeToProject, const double *point, double *shapeFuncValues);
+template<> void computeShapeFuncValues<3>(const double *elem, int planeToProject,
+        const double *point, double *shapeFuncValues) {
+    bool inside = EMPIRE::MathLibrary::computeLocalCoorInTriangle(elem, planeToProject, point,
+            shapeFuncValues);
+    assert(inside);
+}
+template<> void computeShapeFuncValues<4>(const double *elem, int planeToProject,
+        const double *point, double *shapeFuncValues) {
+    double localCoor[2];
+    bool inside = EMPIRE::MathLibrary::computeLocalCoorInQuad(elem, planeToProject, point,
+            localCoor);
+    assert(inside);
+    EMPIRE::MathLibrary::computeShapeFuncOfQuad(localCoor, shapeFuncValues);
+}
+
+/***********************************************************************************************
+ * \brief Compute the Gauss quadrature of the shape function product with the element types and
+ *        the Gauss rule fixed at compile time, see MortarMapper::gaussQuadratureOnClip
+ ***********/
+template<int NUM_NODES_MASTER, int NUM_NODES_SLAVE, int NUM_GPS>
+static void gaussQuadratureOnClip(const double *masterElem, const double *slaveElem,
+        int planeToProject, const double *clippedPolygon, int sizeClippedPolygon, double *result) {
+    const double *gaussPointsLocal =
+            EMPIRE::MathLibrary::TriangleGaussRule<NUM_GPS>::getGaussPoints();
+    const double *weights = EMPIRE::MathLibrary::TriangleGaussRule<NUM_GPS>::getWeights();
+    for (int i = 0; i < NUM_NODES_MASTER * NUM_NODES_SLAVE; i++)
         result[i] = 0.0;
 
-    int numGPs = 0;
-    if (numNodesMasterElem == 3 && numNodesSlaveElem == 3)
-        numGPs = numGPsOnClipTri;
-    else
-        numGPs = numGPsOnClipQuad;
-    // if the clipped polygon is a triangle, do Gauss quadrature on it directly
-    if (clippedPolygon->size() == 3) {
+    // if the clipped polygon is a triangle, do Gauss quadrature on it directly, if not, divide it
+    // into triangles around its center
+    double center[3];
+    int numClipTriangles = 1;
+    if (sizeClippedPolygon != 3) {
+        EMPIRE::MathLibrary::computePolygonCenter(clippedPolygon, sizeClippedPolygon, center);
+        numClipTriangles = sizeClippedPolygon;
+    }
+    for (int t = 0; t < numClipTriangles; t++) {
         double clipTriangle[9];
-        for (int i = 0; i < 3; i++)
-            for (int j = 0; j < 3; j++)
-                clipTriangle[i * 3 + j] = clippedPolygon->at(i)[j];
-
-        EMPIRE::MathLibrary::GaussQuadratureOnTriangle *gaussQuadratureOnTriangle =
-                new EMPIRE::MathLibrary::GaussQuadratureOnTriangle(clipTriangle, numGPs);
-        ShapeFunctionProduct *integrand = new ShapeFunctionProduct(masterElem, numNodesMasterElem,
-                slaveElem, numNodesSlaveElem, planeToProject);
-        integrand->setGaussPoints(gaussQuadratureOnTriangle->gaussPointsGlobal,
-                gaussQuadratureOnTriangle->numGaussPoints);
-        integrand->computeShapeFunctionProducts();
-
-        for (int i = 0; i < numNodesMasterElem; i++) {
-            for (int j = 0; j < numNodesSlaveElem; j++) {
-                integrand->setShapeFunctions(i, j);
-                gaussQuadratureOnTriangle->setIntegrandFunc(integrand);
-                result[i * numNodesSlaveElem + j] = gaussQuadratureOnTriangle->computeIntegral();
-            }
+        if (sizeClippedPolygon == 3) {
+            for (int i = 0; i < 9; i++)
+                clipTriangle[i] = clippedPolygon[i];
+        } else {
+            EMPIRE::MathLibrary::buildTrianagle(center, &clippedPolygon[t * 3],
+                    &clippedPolygon[(t + 1) % sizeClippedPolygon * 3], clipTriangle);
         }
-        delete gaussQuadratureOnTriangle;
-        delete integrand;
-    } else { // if not, divide it into triangles, on each of which doing Gauss quadrature
-        int size = clippedPolygon->size();
-        double tmp[size * 3];
-        for (int i = 0; i < size; i++)
-            for (int j = 0; j < 3; j++)
-                tmp[i * 3 + j] = clippedPolygon->at(i)[j];
-        double center[3];
-        EMPIRE::MathLibrary::computePolygonCenter(tmp, size, center);
-
-        for (int i = 0; i < size; i++) {
-            double clipTriangle[9];
-            EMPIRE::MathLibrary::buildTrianagle(center, clippedPolygon->at(i),
-                    clippedPolygon->at((i + 1) % size), clipTriangle);
-            EMPIRE::MathLibrary::GaussQuadratureOnTriangle *gaussQuadratureOnTriangle =
-                    new EMPIRE::MathLibrary::GaussQuadratureOnTriangle(clipTriangle, numGPs);
-            ShapeFunctionProduct *integrand = new ShapeFunctionProduct(masterElem,
-                    numNodesMasterElem, slaveElem, numNodesSlaveElem, planeToProject);
-            integrand->setGaussPoints(gaussQuadratureOnTriangle->gaussPointsGlobal,
-                    gaussQuadratureOnTriangle->numGaussPoints);
-            integrand->computeShapeFunctionProducts();
-            for (int i = 0; i < numNodesMasterElem; i++) {
-                for (int j = 0; j < numNodesSlaveElem; j++) {
-                    integrand->setShapeFunctions(i, j);
-                    gaussQuadratureOnTriangle->setIntegrandFunc(integrand);
-                    result[i * numNodesSlaveElem + j] +=
-                            gaussQuadratureOnTriangle->computeIntegral();
-                }
+        double area = EMPIRE::MathLibrary::computeAreaOfTriangle(clipTriangle);
+
+        // shape function values of both elements on the Gauss points
+        double shapeFuncValuesMaster[NUM_GPS * NUM_NODES_MASTER];
+        double shapeFuncValuesSlave[NUM_GPS * NUM_NODES_SLAVE];
+        for (int g = 0; g < NUM_GPS; g++) {
+            double gaussPoint[3];
+            EMPIRE::MathLibrary::computeGlobalCoorInTriangle(clipTriangle,
+                    &gaussPointsLocal[g * 3], gaussPoint);
+            computeShapeFuncValues<NUM_NODES_MASTER>(masterElem, planeToProject, gaussPoint,
+                    &shapeFuncValuesMaster[g * NUM_NODES_MASTER]);
+            computeShapeFuncValues<NUM_NODES_SLAVE>(slaveElem, planeToProject, gaussPoint,
+                    &shapeFuncValuesSlave[g * NUM_NODES_SLAVE]);
+        }
+        for (int i = 0; i < NUM_NODES_MASTER; i++) {
+            for (int j = 0; j < NUM_NODES_SLAVE; j++) {
+                double integral = 0.0;
+                for (int g = 0; g < NUM_GPS; g++)
+                    integral += weights[g]
+                            * (shapeFuncValuesMaster[g * NUM_NODES_MASTER + i]
+                                    * shapeFuncValuesSlave[g * NUM_NODES_SLAVE + j]);
+                result[i * NUM_NODES_SLAVE + j] += integral * area;
             }
-            delete gaussQuadratureOnTriangle;
-            delete integrand;
         }
     }
 }
 
-double MortarMapper::computeSearchRadiusSquare(const double* masterElem, int numNodesMasterElem) {
-    // 1. find the longest edge of this element (masterElem)
-    double masterElemCopy[3 * numNodesMasterElem];
-    EMPIRE::MathLibrary::copyElem(masterElem, numNodesMasterElem, masterElemCopy);
-    double lengthSqr = EMPIRE::MathLibrary::longestEdgeLengthSquare(masterElemCopy, numNodesMasterElem);
-
-    // 2. find the longest edge of the neighboring elements (the slave side)
-    // the neighboring elements are found by
-    // first find all neighboring nodes of the nodes of the master element,
-    // then all elements on the slave side having these nodes are the neighboring elements.
-    // These elements together with the master element itself help to compute a reasonable search radius.
-    double dummy;
-    int nb;
-    vector<int>* elemVec[numNodesMasterElem]; // store nearest elements of each node of the masterElem
-    for (int i = 0; i < numNodesMasterElem; i++) {
-#ifdef ANN
-        slaveNodesTree->annkSearch(&masterElemCopy[i * 3], 1, &nb, &dummy);
-#endif
-#ifdef FLANN
-        flann::Matrix<double> masterElemCopyFlann(&masterElemCopy[i*3], 1, 3);
-        vector<vector<int> > indexes_tmp;
-        vector<vector<double> > dists_tmp;
-        FLANNkd_tree->knnSearch(masterElemCopyFlann, indexes_tmp, dists_tmp, 1, flann::SearchParams(1));
-        nb = indexes_tmp[0][0];
-#endif
-
-        elemVec[i] = slaveNodeToElemTable[nb]; // do not modify/delete contents in elemVec!!!
-    }
+void MortarMapper::gaussQuadratureOnClip(const double *masterElem, int numNodesMasterElem,
+        const double *slaveElem, int numNodesSlaveElem, int planeToProject,
+        const double *clippedPolygon, int sizeClippedPolygon, double *result) {
+    // dispatch once per element pair to the kernel of the element types
+    if (numNodesMasterElem == 3 && numNodesSlaveElem == 3)
+        EMPIRE::gaussQuadratureOnClip<3, 3, numGPsOnClipTri>(masterElem, slaveElem,
+                planeToProject, clippedPolygon, sizeClippedPolygon, result);
+    else if (numNodesMasterElem == 3 && numNodesSlaveElem == 4)
+        EMPIRE::gaussQuadratureOnClip<3, 4, numGPsOnClipQuad>(masterElem, slaveElem,
+                planeToProject, clippedPolygon, sizeClippedPolygon, result);
+    else if (numNodesMasterElem == 4 && numNodesSlaveElem == 3)
+        EMPIRE::gaussQuadratureOnClip<4, 3, numGPsOnClipQuad>(masterElem, slaveElem,
+                planeToProject, clippedPolygon, sizeClippedPolygon, result);
+    else if (numNodesMasterElem == 4 && numNodesSlaveElem == 4)
+        EMPIRE::gaussQuadratureOnClip<4, 4, numGPsOnClipQuad>(masterElem, slaveElem,
+                planeToProject, clippedPolygon, sizeClippedPolygon, result);
+    else
+        assert(false);
+}
 
-    double searchRadiusSqr = lengthSqr; // the goal of the first two steps is to set up this value
-    set<int> neighborElemsTmp; // set allows no multiple entries
-    for (int i = 0; i < numNodesMasterElem; i++)
-        for (unsigned j = 0; j < elemVec[i]->size(); j++)
-            neighborElemsTmp.insert(elemVec[i]->at(j));
-
-    for (set<int>::iterator it = neighborElemsTmp.begin(); it != neighborElemsTmp.end(); it++) {
-        int numNodesSlaveElem = slaveNodesPerElem[*it];
-        double elemTmp[3 * numNodesSlaveElem];
-        // for a single element, find its longest edge
-        getElemCoor(*it, MortarMapper::SLAVE, elemTmp);
-        lengthSqr = EMPIRE::MathLibrary::longestEdgeLengthSquare(elemTmp, numNodesSlaveElem);
-        if (lengthSqr > searchRadiusSqr)
-            searchRadiusSqr = lengthSqr;
+void MortarMapper::findCandidates(vector<int> &candidatesPtr, vector<int> &candidates) {
+    // 1. the boxes of the elements are enlarged by a part of their longest edge, such that the boxes
+    // of elements which overlap after the projection intersect also on curved interfaces
+    vector<AABB> masterBoxes(masterNumElems);
+    vector<AABB> slaveBoxes(slaveNumElems);
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        double elem[4 * 3];
+#pragma omp for
+        for (int i = 0; i < masterNumElems; i++) {
+            getElemCoor(i, MortarMapper::MASTER, elem);
+            computeElemBox(elem, masterNodesPerElem[i], masterBoxes[i]);
+        }
+#pragma omp for
+        for (int i = 0; i < slaveNumElems; i++) {
+            getElemCoor(i, MortarMapper::SLAVE, elem);
+            computeElemBox(elem, slaveNodesPerElem[i], slaveBoxes[i]);
+        }
     }
 
-    // 3. the radius is 1.12 times the longest edge in the first two steps
-    searchRadiusSqr *= 1.12;
-    searchRadiusSqr *= 1.12;
-    return searchRadiusSqr;
+    // 2. find all intersecting pairs of boxes by traversing both hierarchies at once
+    AABBTree masterTree(masterBoxes);
+    AABBTree slaveTree(slaveBoxes);
+    AABBTree::findIntersectingPairs(masterTree, slaveTree, 0.0, mapperSetNumThreads, candidatesPtr,
+            candidates);
 }
 
-void MortarMapper::findCandidates(const double* masterElem, int masterElemNumNodes,
-        const double* masterElemNormal, double searchRadiusSqr, set<int> *neighborElems) {
-    // Use fixed radius search on end points of the element,
-    // all elements containing these points are the overlapped candidates
-    // 1. find all neighboring elements in the radius
-    double masterElemCopy[masterElemNumNodes * 3];
-    EMPIRE::MathLibrary::copyElem(masterElem, masterElemNumNodes, masterElemCopy);
-    // OpenMP parallelize this loop
-    // Ann is not thread safe
-    for (int i = 0; i < masterElemNumNodes; i++) {
-        int n_nb = 0;
-        int *nbs;
-#ifdef ANN
-        n_nb = slaveNodesTree->annkFRSearch(&masterElemCopy[i * 3], searchRadiusSqr, 0); // get the number of neighbors in a radius
-        nbs = new int[n_nb];
-        double *dummy = new double[n_nb];
-        slaveNodesTree->annkFRSearch(&masterElemCopy[i * 3], searchRadiusSqr, n_nb, nbs, dummy);// get the real neighbors (ANN uses the square of the radius)
-        delete dummy;
-#endif
-
-#ifdef FLANN
-        flann::Matrix<double> masterElemCopyFlann(&masterElemCopy[i*3], 1, 3);
-        vector<vector<int> > indexes_tmp;
-        vector<vector<double> > dists_tmp;
-        FLANNkd_tree->radiusSearch(masterElemCopyFlann, indexes_tmp, dists_tmp, searchRadiusSqr, flann::SearchParams(1));
-        n_nb = indexes_tmp[0].size();
-        nbs = new int[indexes_tmp[0].size()];
-        for (int j=0; j<indexes_tmp[0].size(); j++)
-        nbs[j] = indexes_tmp[0][j];
-#endif
-        for (int j = 0; j < n_nb; j++) {
-            vector<int> * vecTmp = slaveNodeToElemTable[nbs[j]];
-            for (unsigned k = 0; k < vecTmp->size(); k++) {
-                neighborElems->insert(vecTmp->at(k));
-            }
-        }
-        delete[] nbs;
-    }
-    vector<set<int>::iterator> toDelete;
-    // 2. kick out the elements that have wrong normal direction
-    for (set<int>::iterator it = neighborElems->begin(); it != neighborElems->end(); it++) {
-        double *slaveElemNormal = &slaveElemNormals[(*it) * 3];
-        if (kickOutCandidate(masterElemNormal, slaveElemNormal, 0.7))
-            toDelete.push_back(it); //neighborElems->erase(it) is wrong! because it++ goes to a magic place later
+void MortarMapper::computeElemBox(const double *elem, int numNodesElem, AABB &box) {
+    box.computeFromPoints(elem, numNodesElem);
+    double tolerance = projectionTolerance
+            * sqrt(EMPIRE::MathLibrary::longestEdgeLengthSquare(elem, numNodesElem));
+    for (int k = 0; k < 3; k++) {
+        box[2 * k] -= tolerance;
+        box[2 * k + 1] += tolerance;
     }
-    /*if (toDelete.size() == neighborElems->size()) { // loose the restriction if no neighbors are found
-     toDelete.clear();
-     for (set<int>::iterator it = neighborElems->begin(); it != neighborElems->end(); it++) {
-     double *slaveElemNormal = &slaveElemNormals[(*it) * 3];
-     if (kickOutCandidate(masterElemNormal, slaveElemNormal, 0.01))
-     toDelete.push_back(it); //neighborElems->erase(it) is wrong! because it++ goes to a magic place later
-     }
-     }*/
-    for (int i = 0; i < toDelete.size(); i++)
-        neighborElems->erase(toDelete[i]); // out kicking
-    //assert(neighborElems->size()!=0);
 }
 
 bool MortarMapper::kickOutCandidate(const double *masterUnitNormal, const double *slaveUnitNormal,
@@ -1049,7 +1394,7 @@ void MortarMapper::projectToElemPlane(const double *elem, const double *planeUni
     set<int> neighborNodes;
     for (set<int>::iterator it = neighborElems->begin(); it != neighborElems->end(); it++) {
         for (int i = 0; i < slaveNodesPerElem[*it]; i++)
-            neighborNodes.insert(slaveDirectElemTable[*it]->at(i));
+            neighborNodes.insert(slaveConnectivity->getElemNodes(*it)[i]);
     }
     //cout << neighborNodes.size();
     for (set<int>::iterator it = neighborNodes.begin(); it != neighborNodes.end(); it++) {
@@ -1065,7 +1410,7 @@ void MortarMapper::getElemCoor(int elemIndex, MeshLabel label, double *elem) {
     if (label == MASTER) {
         int numNodesMasterElem = masterNodesPerElem[elemIndex];
         for (int i = 0; i < numNodesMasterElem; i++) {
-            int nodePos = masterDirectElemTable[elemIndex]->at(i); // position of the node
+            int nodePos = masterConnectivity->getElemNodes(elemIndex)[i]; // position of the node
             for (int j = 0; j < 3; j++) {
                 elem[i * 3 + j] = masterNodeCoors[nodePos * 3 + j];
             }
@@ -1074,7 +1419,7 @@ void MortarMapper::getElemCoor(int elemIndex, MeshLabel label, double *elem) {
     } else if (label == SLAVE) {
         int numNodesSlaveElem = slaveNodesPerElem[elemIndex];
         for (int i = 0; i < numNodesSlaveElem; i++) {
-            int nodePos = slaveDirectElemTable[elemIndex]->at(i); // position of the node
+            int nodePos = slaveConnectivity->getElemNodes(elemIndex)[i]; // position of the node
             for (int j = 0; j < 3; j++) {
                 elem[i * 3 + j] = slaveNodeCoors[nodePos * 3 + j];
             }
@@ -1084,27 +1429,6 @@ void MortarMapper::getElemCoor(int elemIndex, MeshLabel label, double *elem) {
     }
 }
 
-void MortarMapper::computeSlaveElemNormals() {
-    slaveElemNormals = new double[slaveNumElems * 3];
-    for (int i = 0; i < slaveNumElems; i++) {
-        const int numNodesSlaveElem = slaveNodesPerElem[i];
-        double slaveElem[numNodesSlaveElem * 3];
-        for (int j = 0; j < numNodesSlaveElem; j++) {
-            for (int k = 0; k < 3; k++) {
-                int pos = slaveDirectElemTable[i]->at(j);
-                slaveElem[j * 3 + k] = slaveNodeCoors[pos * 3 + k];
-            }
-        }
-        if (numNodesSlaveElem == 3) {
-        	EMPIRE::MathLibrary::computeNormalOfTriangle(slaveElem, true, &slaveElemNormals[i * 3]);
-        } else if (numNodesSlaveElem == 4) {
-        	EMPIRE::MathLibrary::computeNormalOfQuad(slaveElem, true, &slaveElemNormals[i * 3]);
-        } else {
-            assert(false);
-        }
-    }
-}
-
 void MortarMapper::checkNullPointers() {
     if (!dual) {
     	assert(C_BB == NULL);
@@ -1119,17 +1443,17 @@ void MortarMapper::computeDualCoeffMatrix(const double *elem, int numNodesElem,
         double *coeffMatrix) {
     double massMatrix[numNodesElem * numNodesElem];
     if (numNodesElem == 4)
-    	EMPIRE::MathLibrary::computeMassMatrixOfQuad(elem, numGPsMassMatrixQuad, false, massMatrix);
+    	EMPIRE::MathLibrary::computeMassMatrixOfQuad<numGPsMassMatrixQuad>(elem, false, massMatrix);
     else if (numNodesElem == 3)
-    	EMPIRE::MathLibrary::computeMassMatrixOfTrianlge(elem, numGPsMassMatrixTri, false, massMatrix);
+    	EMPIRE::MathLibrary::computeMassMatrixOfTriangle<numGPsMassMatrixTri>(elem, false, massMatrix);
     else
         assert(false);
 
     // store the dual mass matrix in coeffMatrix temporarily
     if (numNodesElem == 4)
-    	EMPIRE::MathLibrary::computeMassMatrixOfQuad(elem, numGPsMassMatrixQuad, true, coeffMatrix);
+    	EMPIRE::MathLibrary::computeMassMatrixOfQuad<numGPsMassMatrixQuad>(elem, true, coeffMatrix);
     else if (numNodesElem == 3)
-    	EMPIRE::MathLibrary::computeMassMatrixOfTrianlge(elem, numGPsMassMatrixTri, true, coeffMatrix);
+    	EMPIRE::MathLibrary::computeMassMatrixOfTriangle<numGPsMassMatrixTri>(elem, true, coeffMatrix);
     else
     	assert(false);
 
@@ -1192,154 +1516,4 @@ void MortarMapper::computeDualCoeffMatrix(const double *elem, int numNodesElem,
     // if it fails, then a singular mass matrix is indicated
 }
 
-MortarMapper::ShapeFunctionProduct::ShapeFunctionProduct(const double *_masterElem,
-        int _numNodesMasterElem, const double *_slaveElem, int _numNodesSlaveElem,
-        int _planeToProject) :
-        masterElem(_masterElem), numNodesMasterElem(_numNodesMasterElem), slaveElem(_slaveElem), numNodesSlaveElem(
-                _numNodesSlaveElem), planeToProject(_planeToProject) {
-    gaussPoints = NULL;
-    shapeFunctionProducts = NULL;
-}
-
-MortarMapper::ShapeFunctionProduct::~ShapeFunctionProduct() {
-    assert(gaussPoints!=NULL);
-    assert(shapeFunctionProducts!=NULL);
-    delete[] gaussPoints;
-    for (int i = 0; i < numNodesMasterElem * numNodesSlaveElem; i++)
-        delete[] shapeFunctionProducts[i];
-    delete[] shapeFunctionProducts;
-}
-
-void MortarMapper::ShapeFunctionProduct::computeShapeFunctionProducts() {
-    assert(shapeFunctionProducts == NULL);
-    assert(gaussPoints != NULL);
-    shapeFunctionProducts = new double*[numNodesMasterElem * numNodesSlaveElem];
-    for (int i = 0; i < numNodesMasterElem * numNodesSlaveElem; i++)
-        shapeFunctionProducts[i] = new double[numGaussPoints];
-
-    for (int i = 0; i < numGaussPoints; i++) {
-        double *gaussPoint = &gaussPoints[i * 3];
-        // *. compute shape function values on master element (on the Gauss point)
-        double shapeFuncValueMasterElem[numNodesMasterElem];
-        if (numNodesMasterElem == 3) {
-            double localCoor[3];
-            bool inside = EMPIRE::MathLibrary::computeLocalCoorInTriangle(masterElem, planeToProject,
-                    gaussPoint, localCoor);
-            // debug
-            if (!inside){
-            	cout<<"Error in computing local coordinates in tria master element"<<endl;
-                cout<<"GP coordinates: "<<gaussPoint[0]<<"\t"<<gaussPoint[1]<<"\t"<<gaussPoint[2]<<endl;
-                cout<<"Element nodes:"<<endl;
-                for(int ctr=0;ctr<numNodesMasterElem;ctr++){
-                	cout<<ctr+1<<": "<<masterElem[ctr*3]<<"\t"<<masterElem[ctr*3+1]<<"\t"<<masterElem[ctr*3+2]<<endl;
-                }
-            }
-            // debug end
-            assert(inside);
-            for (int j = 0; j < 3; j++) {
-                shapeFuncValueMasterElem[j] = localCoor[j];
-            }
-        } else if (numNodesMasterElem == 4) {
-            double localCoor[2];
-            bool inside = EMPIRE::MathLibrary::computeLocalCoorInQuad(masterElem, planeToProject, gaussPoint,
-                    localCoor);
-            // debug
-            if (!inside){
-            	cout<<"Error in computing local coordinates in quad master element"<<endl;
-            	cout<<"GP coordinates: "<<gaussPoint[0]<<"\t"<<gaussPoint[1]<<"\t"<<gaussPoint[2]<<endl;
-            	cout<<"Element nodes:"<<endl;
-                for(int ctr=0;ctr<numNodesMasterElem;ctr++){
-                	cout<<ctr+1<<": "<<masterElem[ctr*3]<<"\t"<<masterElem[ctr*3+1]<<"\t"<<masterElem[ctr*3+2]<<endl;
-                }
-             }
-            // debug end
-            assert(inside);
-            EMPIRE::MathLibrary::computeShapeFuncOfQuad(localCoor, shapeFuncValueMasterElem);
-
-        } else {
-            assert(false);
-        }
-        // *. compute shape function values on slave element (on the Gauss point)
-        double shapeFuncValueSlaveElem[numNodesSlaveElem];
-        if (numNodesSlaveElem == 3) {
-            double localCoor[3];
-            bool inside = EMPIRE::MathLibrary::computeLocalCoorInTriangle(slaveElem, planeToProject,
-                    gaussPoint, localCoor);
-            // debug
-            if (!inside){
-            	cout<<"Error in computing local coordinates in quad slave element"<<endl;
-                cout<<"GP coordinates: "<<gaussPoint[0]<<"\t"<<gaussPoint[1]<<"\t"<<gaussPoint[2]<<endl;
-                cout<<"Element nodes:"<<endl;
-                for(int ctr=0;ctr<numNodesSlaveElem;ctr++){
-                	cout<<ctr+1<<": "<<slaveElem[ctr*3]<<slaveElem[ctr*3+1]<<slaveElem[ctr*3+2]<<endl;
-                }
-            }
-            // debug end
-            assert(inside);
-            for (int j = 0; j < 3; j++) {
-                shapeFuncValueSlaveElem[j] = localCoor[j];
-            }
-        } else if (numNodesSlaveElem == 4) {
-            double localCoor[2];
-            bool inside = EMPIRE::MathLibrary::computeLocalCoorInQuad(slaveElem, planeToProject, gaussPoint,
-                    localCoor);
-            // debug
-            if (!inside){
-            	cout<<"Error in computing local coordinates in quad slave element"<<endl;
-            	cout<<"GP coordinates: "<<gaussPoint[0]<<"\t"<<gaussPoint[1]<<"\t"<<gaussPoint[2]<<endl;
-            	cout<<"Element nodes:"<<endl;
-            	for(int ctr=0;ctr<numNodesSlaveElem;ctr++){
-            		cout<<ctr+1<<": "<<slaveElem[ctr*3]<<slaveElem[ctr*3+1]<<slaveElem[ctr*3+2]<<endl;
-            	}
-            }
-            // debug end
-            assert(inside);
-
-            EMPIRE::MathLibrary::computeShapeFuncOfQuad(localCoor, shapeFuncValueSlaveElem);
-        } else {
-            assert(false);
-        }
-        // *. compute shape function products (on the Gauss point)
-        for (int j = 0; j < numNodesMasterElem; j++)
-            for (int k = 0; k < numNodesSlaveElem; k++)
-                shapeFunctionProducts[j * numNodesSlaveElem + k][i] = shapeFuncValueMasterElem[j]
-                        * shapeFuncValueSlaveElem[k];
-    }
-
-}
-
-void MortarMapper::ShapeFunctionProduct::setGaussPoints(const double *_gaussPoints,
-        int _numGaussPoints) {
-    assert(gaussPoints == NULL);
-    numGaussPoints = _numGaussPoints;
-    gaussPoints = new double[numGaussPoints * 3];
-    for (int i = 0; i < numGaussPoints * 3; i++)
-        gaussPoints[i] = _gaussPoints[i];
-}
-
-void MortarMapper::ShapeFunctionProduct::setShapeFunctions(int _masterShapeFuncID,
-        int _slaveShapeFuncID) {
-    masterShapeFuncID = _masterShapeFuncID;
-    slaveShapeFuncID = _slaveShapeFuncID;
-}
-
-double MortarMapper::ShapeFunctionProduct::operator ()(double *gaussPoint) {
-    assert(gaussPoints!=NULL);
-    assert(shapeFunctionProducts!=NULL);
-    for (int i = 0; i < numGaussPoints; i++) {
-        if (gaussPoints[i * 3 + 0] == gaussPoint[0] && gaussPoints[i * 3 + 1] == gaussPoint[1]
-                && gaussPoints[i * 3 + 2] == gaussPoint[2]) {
-            return shapeFunctionProducts[masterShapeFuncID * numNodesSlaveElem + slaveShapeFuncID][i];
-        }
-    }
-    // should not come here
-    assert(false);
-    return 0.0;
-}
-
-
-
-
-
-
 } /* namespace EMPIRE */
@@ -36,6 +36,15 @@
 
 class ANNkd_tree;
 
+namespace EMPIRE {
+class FEMeshConnectivity;
+class FEMeshGeometry;
+class AABB;
+namespace MathLibrary {
+class CSRMatrix;
+}
+}
+
 namespace flann {
 template<typename Distance> class Index;
 template<class T> struct L2;
@@ -68,6 +77,10 @@ public:
      * \param[in] _oppositeSurfaceNormal whether the interface of master side and of master side have opposite normals  or not (true or false)
      * \param[in] _dual whether or not to use dual mortar (true or false)
      * \param[in] _toEnforceConsistency whether or not to enforce consistency
+     * \param[in] _slaveConnectivity the connectivity tables of the slave mesh owned by someone else
+     *            (e.g. the FEMesh), NULL to build own tables
+     * \param[in] _masterConnectivity the connectivity tables of the master mesh owned by someone else
+     *            (e.g. the FEMesh), NULL to build own tables
      * \author Tianyang Wang
      ***********/
     MortarMapper(int _slaveNumNodes, int _slaveNumElems, const int *_slaveNodesPerElem,
@@ -75,7 +88,8 @@ public:
             int _masterNumNodes, int _masterNumElems, const int *_masterNodesPerElem,
             const double *_masterNodeCoors, const int *_masterNodeNumbers,
             const int *_masterElemTable, bool _oppositeSurfaceNormal, bool _dual,
-            bool _toEnforceConsistency);
+            bool _toEnforceConsistency, const FEMeshConnectivity *_slaveConnectivity = NULL,
+            const FEMeshConnectivity *_masterConnectivity = NULL);
     /***********************************************************************************************
      * \brief Destructor
      * \author Tianyang Wang
@@ -88,6 +102,21 @@ public:
      * \author Tianyang Wang
      ***********/
     void buildCouplingMatrices();
+    /***********************************************************************************************
+     * \brief Use a searching tree owned by someone else, e.g. the spatial index of the mesh, instead
+     *        of building one. Must be called before buildCouplingMatrices
+     * \param[in] tree the FLANN searching tree over the slave nodes
+     ***********/
+    void setSharedSearchTree(flann::Index<flann::L2<double> > *tree);
+    /***********************************************************************************************
+     * \brief Use the element geometries owned by someone else, e.g. the FEMesh, instead of computing
+     *        them. Must be called before buildCouplingMatrices, they are not used anymore after the
+     *        geometry has been updated
+     * \param[in] _slaveGeometry the centroids and normals of the slave elements, NULL to compute them
+     * \param[in] _masterGeometry the centroids and normals of the master elements, NULL to compute them
+     ***********/
+    void setSharedElemGeometry(const FEMeshGeometry *_slaveGeometry,
+            const FEMeshGeometry *_masterGeometry);
 
     /***********************************************************************************************
      * \brief Do consistent mapping on fields (e.g. displacements or tractions) --- C_BB * masterField = C_BA * slaveField
@@ -110,6 +139,157 @@ public:
      * \author Tianyang Wang
      ***********/
     void computeErrorsConsistentMapping(const double *slaveField, const double *masterField);
+    /***********************************************************************************************
+     * \brief Block mapping is supported by this mapper
+     * \return true
+     ***********/
+    bool isBlockMappingSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Do consistent mapping on all components of interleaved fields at once, i.e. one product
+     *        with C_BA and one solve with C_BB having all components as right hand sides
+     * \param[in] slaveField the field of the slave side, component k of node i is slaveField[i * numComponents + k]
+     * \param[out] masterField the field of the master side, component k of node i is masterField[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void consistentBlockMapping(const double *slaveField, double *masterField, int numComponents);
+    /***********************************************************************************************
+     * \brief Do conservative mapping on all components of interleaved integral fields at once
+     * \param[in] masterField the field of the master side, component k of node i is masterField[i * numComponents + k]
+     * \param[out] slaveField the field of the slave side, component k of node i is slaveField[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void conservativeBlockMapping(const double *masterField, double *slaveField, int numComponents);
+    /***********************************************************************************************
+     * \brief Row blocks are mapped by the precomputed operator H only, if it is not distributed
+     ***********/
+    bool isRowBlockMappingSupported() const;
+    /***********************************************************************************************
+     * \brief Get the number of leading slave nodes the master nodes before endNodeB depend on in H
+     ***********/
+    int getNumRequiredNodesA(int endNodeB) const;
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the master nodes firstNodeB to endNodeB-1 only
+     ***********/
+    void consistentRowBlockMapping(const double *slaveField, double *masterField,
+            int numComponents, int firstNodeB, int endNodeB);
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes of B depending on a changed node of A only
+     ***********/
+    int consistentChangedRowsMapping(const double *slaveField, double *masterField,
+            int numComponents, const char *isNodeAChanged);
+    /***********************************************************************************************
+     * \brief Do consistent and conservative mapping with one solve of the symmetric C_BB having the
+     *        right hand sides of both directions, the dual mortar mapper maps one after the other
+     * \param[in] slaveField the field of the slave side (e.g. displacements)
+     * \param[in,out] masterField the consistently mapped field of the master side
+     * \param[in] masterIntegralField the integral field of the master side (e.g. forces)
+     * \param[out] slaveIntegralField the conservatively mapped field of the slave side
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void mapBothDirections(const double *slaveField, double *masterField,
+            const double *masterIntegralField, double *slaveIntegralField, int numComponents);
+    /***********************************************************************************************
+     * \brief The coupling matrices can be cached
+     * \return true
+     ***********/
+    bool isCouplingMatricesCacheSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Store C_BB and C_BA (or their dual versions) in the cache
+     * \param[in] cache the cache
+     ***********/
+    void writeCouplingMatricesToCache(CouplingMatricesCache *cache);
+    /***********************************************************************************************
+     * \brief Take C_BB and C_BA (or their dual versions) from the cache instead of building them
+     * \param[in] cache the loaded cache
+     * \return false if the cache does not hold all matrices
+     ***********/
+    bool readCouplingMatricesFromCache(const CouplingMatricesCache *cache);
+    bool isGeometryUpdateSupported() const {
+        return true;
+    }
+    void updateGeometry();
+    /***********************************************************************************************
+     * \brief Only C_BB of the standard mortar mapper needs a solver, the dual mortar mapper divides
+     *        by the diagonal
+     * \return true if not dual
+     ***********/
+    bool isIterativeSolverSupported() const {
+        return !dual;
+    }
+    /***********************************************************************************************
+     * \brief Solve C_BB by the preconditioned conjugate gradient method
+     * \param[in] tolerance the relative residual tolerance
+     * \param[in] maxIterations the maximum number of iterations
+     ***********/
+    void setIterativeSolver(double tolerance, int maxIterations);
+    /***********************************************************************************************
+     * \brief Change the tolerance of the conjugate gradient method of C_BB between two mappings
+     * \param[in] tolerance the relative residual tolerance
+     ***********/
+    void setIterativeSolverTolerance(double tolerance);
+    /***********************************************************************************************
+     * \brief Select the solver of C_BB, the dual mortar mapper does not solve
+     * \param[in] name the name of the solver in the LinearSolverRegistry
+     ***********/
+    void setLinearSolver(const std::string &name);
+    /***********************************************************************************************
+     * \brief Set the threads, the ordering and the storage of the PARDISO factors of C_BB
+     * \param[in] settings the settings
+     ***********/
+    void setPardisoSettings(const MathLibrary::PardisoSettings &settings);
+    /***********************************************************************************************
+     * \brief Only the dual mortar mapper has a diagonal C_BB, whose inverse keeps C_BA sparse
+     * \return true if dual
+     ***********/
+    bool isExplicitMappingOperatorSupported() const {
+        return dual;
+    }
+    /***********************************************************************************************
+     * \brief Precompute H = C_BB^(-1) * C_BA, consistent mapping is then H * slaveField and
+     *        conservative mapping H^T * masterField
+     * \param[in] explicitOperator true to precompute H
+     ***********/
+    void setExplicitMappingOperator(bool explicitOperator) {
+        assert(dual);
+        isExplicitMappingOperator = explicitOperator;
+    }
+    /***********************************************************************************************
+     * \brief The precomputed operator H can be handed out
+     * \return true if H is built
+     ***********/
+    bool isMappingOperatorExportSupported() const {
+        return H != NULL;
+    }
+    /***********************************************************************************************
+     * \brief Get a copy of H
+     ***********/
+    void getMappingOperator(std::vector<int> &rowPointers, std::vector<int> &columnIndices,
+            std::vector<double> &values) const;
+    /***********************************************************************************************
+     * \brief The explicit operator H can be built for one direction only, C_BB and C_BA serve both
+     * \return true
+     ***********/
+    bool isMappingDirectionsSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Keep only the arrays of the products of the used directions in H
+     * \param[in] consistent whether consistent mapping is used
+     * \param[in] conservative whether conservative mapping is used
+     ***********/
+    void setMappingDirections(bool consistent, bool conservative) {
+        isConsistentMappingUsed = consistent;
+        isConservativeMappingUsed = conservative;
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory of the coupling matrices, the tables and the searching tree are
+     *        released after the build
+     ***********/
+    MemoryUsage getMemoryUsage() const;
     /// defines number of threads used for MKL routines
     static int mklSetNumThreads;
     /// defines number of threads used for mapper routines
@@ -151,7 +331,7 @@ private:
 
     /// nearest neighbors searching tree of FLAN libraray
     flann::Index<flann::L2<double> > *FLANNkd_tree;
-    /// nodes constructing the searching tree
+    /// nodes constructing the searching tree, NULL if the tree is shared
     flann::Matrix<double> *FLANNSlaveNodes;
 
     /// nearest neighbors searching tree of ANN libraray
@@ -159,14 +339,22 @@ private:
     /// nodes constructing the searching tree
     double **ANNSlaveNodes;
 
-    /// directElemTable means the entries is not the node number, but the position in nodeCoors
-    std::vector<int> **slaveDirectElemTable;
-    /// directElemTable means the entries is not the node number, but the position in nodeCoors
-    std::vector<int> **masterDirectElemTable;
-    /// given a node, all the elements containing it are got
-    std::vector<int> **slaveNodeToElemTable;
-    /// compute normals of all slave elements
-    double *slaveElemNormals;
+    /// element to node and node to element tables of the slave mesh (by node positions in nodeCoors)
+    const FEMeshConnectivity *slaveConnectivity;
+    /// element to node table of the master mesh (by node positions in nodeCoors)
+    const FEMeshConnectivity *masterConnectivity;
+    /// tables of the slave mesh owned by someone else, NULL if own tables are built
+    const FEMeshConnectivity *sharedSlaveConnectivity;
+    /// tables of the master mesh owned by someone else, NULL if own tables are built
+    const FEMeshConnectivity *sharedMasterConnectivity;
+    /// centroids and normals of the slave elements, only valid while the matrices are built
+    const FEMeshGeometry *slaveGeometry;
+    /// centroids and normals of the master elements, only valid while the matrices are built
+    const FEMeshGeometry *masterGeometry;
+    /// geometry of the slave elements owned by someone else, NULL if an own one is computed
+    const FEMeshGeometry *sharedSlaveGeometry;
+    /// geometry of the master elements owned by someone else, NULL if an own one is computed
+    const FEMeshGeometry *sharedMasterGeometry;
 
     /// dual version of C_BB_A, which is diagonal
     double *C_BB_A_DUAL;
@@ -176,6 +364,17 @@ private:
     /// New sparse matrix.
     MathLibrary::SparseMatrix<double> *C_BA;
     MathLibrary::SparseMatrix<double> *C_BA_DUAL;
+    /// whether the mapping uses the precomputed operator H
+    bool isExplicitMappingOperator;
+    /// whether consistent mapping is used
+    bool isConsistentMappingUsed;
+    /// whether conservative mapping is used
+    bool isConservativeMappingUsed;
+    /// the mapping operator H = C_BB^(-1) * C_BA of the dual mortar mapper, NULL if not precomputed
+    MathLibrary::CSRMatrix *H;
+
+    /// time spent by all threads in the assembly loops, used to report the speedup of the assembly
+    double assemblyWorkTime;
 
 
     /// number of Gauss points used for computing triangle element mass matrix
@@ -186,6 +385,9 @@ private:
     static const int numGPsOnClipTri;
     /// number of Gauss points used for computing shape function (quad) products on a clip
     static const int numGPsOnClipQuad;
+    /// the part of the longest edge by which the boxes of the elements are enlarged to find the
+    /// candidates of the clipping
+    static const double projectionTolerance;
 
     /// pardiso variable
     void *pt[64]; // this is related to internal memory management, see PARDISO manual
@@ -212,6 +414,10 @@ private:
     /// unit test class
     friend class TestMortarMapper;
 
+    /***********************************************************************************************
+     * \brief Compute H by scaling the rows of C_BA_DUAL by the inverse of the diagonal C_BB_A_DUAL
+     ***********/
+    void computeMappingOperator();
     /***********************************************************************************************
      * \brief Compute matrix C_BB
      * \author Tianyang Wang
@@ -242,6 +448,10 @@ private:
      * \author Tianyang Wang
      ***********/
     void initANNTree();
+    /***********************************************************************************************
+     * \brief Initialize the FLANN nearest neighbor searching tree, unless a shared one is set
+     ***********/
+    void initFLANNTree();
     /***********************************************************************************************
      * \brief Deallocate the memory of the searching tree
      * \author Tianyang Wang
@@ -254,32 +464,30 @@ private:
      * \param[in] slaveElem the slave element
      * \param[in] numNodesSlaveElem number of nodes of the slave element
      * \param[in] planeToProject project to plane (case: {2:x-y ; 0:y-z ;1: z-x} )
-     * \param[in] polygon the clipped polygon
+     * \param[in] clippedPolygon the clipped polygon
+     * \param[in] sizeClippedPolygon number of points of the clipped polygon
      * \param[out] result the Gauss quadrature of the shape function product. 9 entries if triangle, 16 entries if quadrilateral.
      * \author Tianyang Wang
      ***********/
     void gaussQuadratureOnClip(const double *masterElem, int numNodesMasterElem,
             const double *slaveElem, int numNodesSlaveElem, int planeToProject,
-            std::vector<double*> *clippedPolygon, double *result);
+            const double *clippedPolygon, int sizeClippedPolygon, double *result);
     /***********************************************************************************************
-     * \brief Compute the search radius to find the overlapping candidates of the master element.
-     * \param[in] masterElem master element
-     * \param[in] numNodesMasterElem number of nodes of the master element
-     * \return the square of the search radius
-     * \author Tianyang Wang
+     * \brief Find the overlapping candidates of all master elements by intersecting the bounding
+     *        boxes of the elements of both meshes, the boxes are enlarged by projectionTolerance.
+     * \param[out] candidatesPtr the candidates of master element i are at the positions
+     *             candidatesPtr[i] to candidatesPtr[i+1]-1 of candidates
+     * \param[out] candidates the slave elements, sorted for every master element
      ***********/
-    double computeSearchRadiusSquare(const double* masterElem, int numNodesMasterElem);
+    void findCandidates(std::vector<int> &candidatesPtr, std::vector<int> &candidates);
     /***********************************************************************************************
-     * \brief Find the overlapping candidates of the master element with the searching radius.
-     * \param[in] masterElem the master element
-     * \param[in] numNodesMasterElem number of nodes of the master element
-     * \param[in] masterElemNormal the normal direction of the master element
-     * \param[in] searchRadiusSqr the square of the search radius
-     * \param[out] neighborElems the neighboring elements which are the overlapping candidates
-     * \author Tianyang Wang
+     * \brief Compute the bounding box of an element enlarged by projectionTolerance times its
+     *        longest edge
+     * \param[in] elem the coordinates of the nodes of the element
+     * \param[in] numNodesElem number of nodes of the element
+     * \param[out] box the box
      ***********/
-    void findCandidates(const double* masterElem, int numNodesMasterElem,
-            const double *masterElemNormal, double searchRadiusSqr, std::set<int> *neighborElems);
+    static void computeElemBox(const double *elem, int numNodesElem, AABB &box);
     /***********************************************************************************************
      * \brief Kick out the candidates who have wrong normal direction. Only here the field "oppositeSurfaceNormal" is used.
      * \brief This helps to avoid getting wrong overlap on the meshes like Turek benchmark 3D mesh.
@@ -310,10 +518,10 @@ private:
      ***********/
     void getElemCoor(int elemIndex, MeshLabel label, double *elem);
     /***********************************************************************************************
-     * \brief Compute the table of normals of all slave elements. Must be implemented by concrete child classes.
-     * \author Tianyang Wang
+     * \brief Get the centroids and normals of all slave and master elements, the shared ones or
+     *        own ones computed by the threads of the mapper
      ***********/
-    void computeSlaveElemNormals();
+    void initElemGeometry();
     /***********************************************************************************************
      * \brief Check C_BB and C_BA related pointers, in order to verify the logic
      * \author Tianyang Wang
@@ -327,78 +535,6 @@ private:
      * \author Tianyang Wang
      ***********/
     void computeDualCoeffMatrix(const double *elem, int numNodesElem, double *coeffMatrix);
-    /********//**
-     * \brief Class shapeFunctionProduct computes the shape function products of two elements
-     ***********/
-    class ShapeFunctionProduct: public EMPIRE::MathLibrary::IntegrandFunction {
-    public:
-        /***********************************************************************************************
-         * \brief Constructor
-         * \param[in] _masterElem the master element
-         * \param[in] _numNodesMasterElem number of nodes of the master element
-         * \param[in] _slaveElem the slave element
-         * \param[in] _numNodesSlaveElem number of nodes of the slave element
-         * \param[in] _planeToProject project to plane (case: {2:x-y ; 0:y-z ;1: z-x} )
-         * \author Tianyang Wang
-         ***********/
-        ShapeFunctionProduct(const double *_masterElem, int _numNodesMasterElem,
-                const double *_slaveElem, int _numNodesSlaveElem, int _planeToProject);
-        /***********************************************************************************************
-         * \brief Destructor
-         * \author Tianyang Wang
-         ***********/
-        virtual ~ShapeFunctionProduct();
-        /***********************************************************************************************
-         * \brief Compute shape function products on all Gauss points. These are computed here to avoid
-         *        computing the local coordinates of the same Gauss point for multiple times.
-         * \author Tianyang Wang
-         ***********/
-        void computeShapeFunctionProducts();
-        /***********************************************************************************************
-         * \brief set all Gauss points
-         * \param[in] _gaussPoints x,y,z coordinates of all Gauss points
-         * \param[in] _numGaussPoints x,y,z coordinates of all Gauss points
-         * \author Tianyang Wang
-         ***********/
-        void setGaussPoints(const double *_gaussPoints, int _numGaussPoints);
-        /***********************************************************************************************
-         * \brief Set the shape functions
-         * \param[in] _masterShapeFuncID shape function ID of the master element
-         * \param[in] _slaveShapeFuncID shape function ID of the slave element
-         * \param[in] gaussPoint x,y,z coordinates of the Gauss point
-         * \author Tianyang Wang
-         ***********/
-        void setShapeFunctions(int _masterShapeFuncID, int _slaveShapeFuncID);
-        /***********************************************************************************************
-         * \brief Compute the shape function product on the Gauss point. In fact, the shape function
-         *        products have been computed by computeAllShapeFunctionProducts().
-         * \param[in] gaussPoint x,y,z coordinates of the Gauss point
-         * \return the function value
-         * \author Tianyang Wang
-         ***********/
-        double operator()(double *gaussPoint);
-    private:
-        /// the master element
-        const double *masterElem;
-        /// number of nodes of the master element
-        int numNodesMasterElem;
-        /// the slave element
-        const double *slaveElem;
-        /// number of nodes of the slave element
-        int numNodesSlaveElem;
-        /// project to plane (case: {2:x-y ; 0:y-z ;1: z-x} )
-        int planeToProject;
-        /// number of Gauss points
-        int numGaussPoints;
-        /// coordinates of all gauss points
-        double * gaussPoints;
-        /// different shape function products on all Gauss points
-        double **shapeFunctionProducts;
-        /// shape function ID of the master element
-        int masterShapeFuncID;
-        /// shape function ID of the slave element
-        int slaveShapeFuncID;
-    };
 };
 
 } /* namespace EMPIRE */
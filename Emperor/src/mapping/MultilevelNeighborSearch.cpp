@@ -0,0 +1,159 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifdef FLANN
+#include "flann/flann.hpp"
+#endif
+
+#include <assert.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <utility>
+#include "MultilevelNeighborSearch.h"
+#include "SpaceFillingCurve.h"
+#include "BoundingBox.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+const int MultilevelNeighborSearch::CLUSTER_SIZE = 256;
+const int MultilevelNeighborSearch::MAX_CANDIDATES_FACTOR = 4;
+
+MultilevelNeighborSearch::MultilevelNeighborSearch(int _numNodesA, const double *_nodesA,
+        flann::Index<flann::L2<double> > *_treeA) :
+        numNodesA(_numNodesA), nodesA(_nodesA), treeA(_treeA) {
+}
+
+MultilevelNeighborSearch::~MultilevelNeighborSearch() {
+}
+
+void MultilevelNeighborSearch::search(const double *points, const vector<int> &queries,
+        int numNeighbors, int numThreads, Visitor &visitor) const {
+#ifdef FLANN
+    const int numQueries = queries.size();
+    if (numQueries == 0)
+        return;
+    assert(numNeighbors >= 1 && numNeighbors <= numNodesA);
+
+    // 1. order the points along a Morton curve, such that consecutive points are close
+    vector<double> queryPoints(numQueries * 3);
+    for (int q = 0; q < numQueries; q++)
+        for (int k = 0; k < 3; k++)
+            queryPoints[q * 3 + k] = points[queries[q] * 3 + k];
+    vector<int> order;
+    SpaceFillingCurve::computeOrder(SpaceFillingCurve::MORTON, numQueries, &queryPoints[0], order);
+    vector<int> sortedQueries(numQueries);
+    vector<double> sortedPoints(numQueries * 3);
+    for (int q = 0; q < numQueries; q++) {
+        sortedQueries[q] = queries[order[q]];
+        for (int k = 0; k < 3; k++)
+            sortedPoints[q * 3 + k] = queryPoints[order[q] * 3 + k];
+    }
+    vector<double>().swap(queryPoints);
+
+    // 2. the clusters of consecutive points are searched in parallel
+    const int numClusters = (numQueries + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+#pragma omp parallel num_threads(numThreads)
+    {
+        vector<pair<int, int> > stack; // the first point and the number of points of the clusters
+        vector<pair<double, int> > distances;
+        vector<int> neighbors(numNeighbors);
+#pragma omp for schedule(dynamic, 1)
+        for (int c = 0; c < numClusters; c++) {
+            stack.push_back(pair<int, int>(c * CLUSTER_SIZE,
+                    min(CLUSTER_SIZE, numQueries - c * CLUSTER_SIZE)));
+            while (!stack.empty()) {
+                int first = stack.back().first;
+                int count = stack.back().second;
+                stack.pop_back();
+
+                // 2.1 the center of the cluster is the coarse proxy of its points. The k nearest
+                // nodes of a point are within 2h + d_k of the center, where h is the distance of
+                // the farthest point to the center and d_k the distance of the k-th node
+                AABB box;
+                box.computeFromPoints(&sortedPoints[first * 3], count);
+                double center[3];
+                double h = 0.0;
+                for (int k = 0; k < 3; k++) {
+                    center[k] = 0.5 * (box[2 * k] + box[2 * k + 1]);
+                    h += (box[2 * k + 1] - center[k]) * (box[2 * k + 1] - center[k]);
+                }
+                h = sqrt(h);
+                flann::Matrix<double> centerFlann(center, 1, 3);
+                vector<vector<int> > indexes;
+                vector<vector<double> > dists; // squared distances
+                treeA->knnSearch(centerFlann, indexes, dists, numNeighbors, flann::SearchParams(1));
+                double radius = (2.0 * h + sqrt(dists[0][numNeighbors - 1])) * (1.0 + 1E-10);
+                treeA->radiusSearch(centerFlann, indexes, dists, radius * radius,
+                        flann::SearchParams(1));
+                const vector<int> &candidates = indexes[0];
+                const int numCandidates = candidates.size();
+
+                // 2.2 refine a cluster with too many candidates
+                if (count > 1 && numCandidates > MAX_CANDIDATES_FACTOR * (count + numNeighbors)) {
+                    int half = count / 2;
+                    stack.push_back(pair<int, int>(first, half));
+                    stack.push_back(pair<int, int>(first + half, count - half));
+                    continue;
+                }
+
+                // 2.3 every point of the cluster searches among the candidates, if rounding left
+                // fewer candidates than neighbors (e.g. all points and nodes coincide), the points
+                // search the tree instead
+                distances.resize(numCandidates);
+                for (int q = first; q < first + count; q++) {
+                    const double *P = &sortedPoints[q * 3];
+                    if (numCandidates >= numNeighbors) {
+                        for (int j = 0; j < numCandidates; j++) {
+                            const double *node = &nodesA[candidates[j] * 3];
+                            double dx = node[0] - P[0];
+                            double dy = node[1] - P[1];
+                            double dz = node[2] - P[2];
+                            distances[j] = pair<double, int>(dx * dx + dy * dy + dz * dz,
+                                    candidates[j]);
+                        }
+                        partial_sort(distances.begin(), distances.begin() + numNeighbors,
+                                distances.end());
+                        for (int j = 0; j < numNeighbors; j++)
+                            neighbors[j] = distances[j].second;
+                    } else {
+                        flann::Matrix<double> pointFlann(const_cast<double*>(P), 1, 3);
+                        vector<vector<int> > pointIndexes;
+                        vector<vector<double> > pointDists;
+                        treeA->knnSearch(pointFlann, pointIndexes, pointDists, numNeighbors,
+                                flann::SearchParams(1));
+                        for (int j = 0; j < numNeighbors; j++)
+                            neighbors[j] = pointIndexes[0][j];
+                    }
+                    visitor.visit(sortedQueries[q], &neighbors[0], numNeighbors);
+                }
+            }
+        }
+    }
+#else
+    ERROR_OUT() << "MultilevelNeighborSearch: FLANN is needed" << endl;
+    exit(-1);
+#endif
+}
+
+} /* namespace EMPIRE */
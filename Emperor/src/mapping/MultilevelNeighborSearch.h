@@ -0,0 +1,101 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file MultilevelNeighborSearch.h
+ * This file holds the class MultilevelNeighborSearch
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef MULTILEVELNEIGHBORSEARCH_H_
+#define MULTILEVELNEIGHBORSEARCH_H_
+
+#include <vector>
+
+namespace flann {
+template<typename Distance> class Index;
+template<class T> struct L2;
+}
+
+namespace EMPIRE {
+/********//**
+ * \brief Class MultilevelNeighborSearch finds the k nearest nodes of A of many points at once.
+ *        The points are ordered along a Morton curve and agglomerated into clusters. The center
+ *        of a cluster is searched first in the tree of A, which bounds the region holding the k
+ *        nearest nodes of all points of the cluster. A cluster with too many nodes of A in this
+ *        region is split, the points of the other clusters only search among these nodes. The
+ *        neighbors found are the same as the ones of a search of every point in the tree.
+ ***********/
+class MultilevelNeighborSearch {
+public:
+    /********//**
+     * \brief Receives the neighbors of the points, it is called by several threads at once
+     ***********/
+    class Visitor {
+    public:
+        virtual ~Visitor() {
+        }
+        /***********************************************************************************************
+         * \brief Receive the neighbors of a point
+         * \param[in] point the position of the point
+         * \param[in] neighbors the nodes of A in increasing distance to the point
+         * \param[in] numNeighbors the number of neighbors
+         ***********/
+        virtual void visit(int point, const int *neighbors, int numNeighbors) = 0;
+    };
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _numNodesA number of nodes of A
+     * \param[in] _nodesA nodes of A
+     * \param[in] _treeA the FLANN tree of the nodes of A
+     ***********/
+    MultilevelNeighborSearch(int _numNodesA, const double *_nodesA,
+            flann::Index<flann::L2<double> > *_treeA);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~MultilevelNeighborSearch();
+    /***********************************************************************************************
+     * \brief Find the nearest nodes of A of some points
+     * \param[in] points x,y,z coordinates of all points
+     * \param[in] queries the positions of the points to be searched
+     * \param[in] numNeighbors the number of neighbors of a point, at most the number of nodes of A
+     * \param[in] numThreads the number of threads
+     * \param[in] visitor receives the neighbors of every point in queries
+     ***********/
+    void search(const double *points, const std::vector<int> &queries, int numNeighbors,
+            int numThreads, Visitor &visitor) const;
+
+private:
+    /// number of nodes of A
+    int numNodesA;
+    /// nodes of A
+    const double *nodesA;
+    /// the FLANN tree of the nodes of A
+    flann::Index<flann::L2<double> > *treeA;
+    /// number of consecutive points along the curve in a cluster before splitting
+    static const int CLUSTER_SIZE;
+    /// a cluster is split if it has more than this factor times its number of points and
+    /// neighbors as candidates
+    static const int MAX_CANDIDATES_FACTOR;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* MULTILEVELNEIGHBORSEARCH_H_ */
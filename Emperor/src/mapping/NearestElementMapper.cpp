@@ -20,28 +20,28 @@
  */
 #include "NearestElementMapper.h"
 //#include "MortarMath.h"
-#ifdef FLANN
-#include "flann/flann.hpp"
-#endif
-
-#ifdef ANN
-#include "ANN/ANN.h"
-#endif
+#include "AABBTree.h"
+#include "FEMeshConnectivity.h"
+#include "FEMeshGeometry.h"
 
 // Edit Aditya
 #include "MathLibrary.h"
+#include "CSRMatrix.h"
+#include "DistributedCSRMatrix.h"
 #include <assert.h>
 #include <math.h>
-#include <map>
+#include <limits>
+#include <algorithm>
 #include <iostream>
 //#include <time.h>
 
 using namespace std;
 namespace EMPIRE {
-const int NearestElementMapper::MAX_NUM_NEIGHBORS_TO_SEARCH = 10;
 // set default value for mapper threads
 int NearestElementMapper::mapperSetNumThreads = 1;
 
+const int NearestElementMapper::CANDIDATE_BATCH_SIZE = 8;
+
 NearestElementMapper::NearestElementMapper(int _numNodesA, int _numElemsA,
         const int *_numNodesPerElemA, const double *_nodesA, const int *_nodeIDsA,
         const int *_elemTableA, int _numNodesB, int _numElemsB, const int *_numNodesPerElemB,
@@ -49,7 +49,9 @@ NearestElementMapper::NearestElementMapper(int _numNodesA, int _numElemsA,
         numNodesA(_numNodesA), numElemsA(_numElemsA), numNodesPerElemA(_numNodesPerElemA), nodesA(
                 _nodesA), nodeIDsA(_nodeIDsA), elemTableA(_elemTableA), numNodesB(_numNodesB), numElemsB(
                 _numElemsB), numNodesPerElemB(_numNodesPerElemB), nodesB(_nodesB), nodeIDsB(
-                _nodeIDsB), elemTableB(_elemTableB) {
+                _nodeIDsB), elemTableB(_elemTableB), sharedSearchTree(NULL), sharedConnectivity(NULL), sharedElemGeometry(NULL), connectivityA(
+                NULL), elemGeometryA(NULL), isSinglePrecisionWeights(false), isConsistentMappingUsed(true),
+                isConservativeMappingUsed(true), couplingMatrix(NULL) {
 
     mapperType = EMPIRE_NearestElementMapper;
 
@@ -67,272 +69,423 @@ NearestElementMapper::~NearestElementMapper() {
     for (int i = 0; i < numNodesB; i++)
         delete[] weightsTable->at(i);
     delete weightsTable;
+    delete couplingMatrix;
 }
 
 void NearestElementMapper::consistentMapping(const double *fieldA, double *fieldB) {
-    //time_t timeStart, timeEnd;
-    //time(&timeStart);
-#pragma omp parallel num_threads(mapperSetNumThreads)
-    {
-#pragma omp for
-        for (int i = 0; i < numNodesB; i++) { // i-th node
-            int numNodesMyNeighbor = numNodesPerNeighborElem[i];
-            int neighbors[numNodesMyNeighbor];
-            for (int j = 0; j < numNodesMyNeighbor; j++) {
-                neighbors[j] = neighborsTable->at(i)[j];
-            }
-            double val = 0.0;
-            for (int j = 0; j < numNodesMyNeighbor; j++) { //j-th neighbor
-                val += weightsTable->at(i)[j] * fieldA[neighbors[j]];
-            }
-            fieldB[i] = val;
-        }
-    } //#pragma omp parallel
-    //time(&timeEnd);
-    //cout << "It took " << difftime(timeEnd, timeStart) << " seconds for consistentMapping" << endl;
+    couplingMatrix->multiply(false, fieldA, fieldB);
 }
 
 void NearestElementMapper::conservativeMapping(const double *fieldB, double *fieldA) {
-    for (int i = 0; i < numNodesA; i++) {
-        fieldA[i] = 0.0;
+    couplingMatrix->multiply(true, fieldB, fieldA);
+}
+
+void NearestElementMapper::consistentBlockMapping(const double *fieldA, double *fieldB,
+        int numComponents) {
+    couplingMatrix->multiplyBlock(false, fieldA, fieldB, numComponents);
+}
+
+void NearestElementMapper::conservativeBlockMapping(const double *fieldB, double *fieldA,
+        int numComponents) {
+    couplingMatrix->multiplyBlock(true, fieldB, fieldA, numComponents);
+}
+
+void NearestElementMapper::getMappingOperator(std::vector<int> &rowPointers,
+        std::vector<int> &columnIndices, std::vector<double> &values) const {
+    couplingMatrix->getEntries(rowPointers, columnIndices, values);
+}
+
+bool NearestElementMapper::isRowBlockMappingSupported() const {
+    return isConsistentMappingUsed && couplingMatrix->isRowRangeProductSupported();
+}
+
+int NearestElementMapper::getNumRequiredNodesA(int endNodeB) const {
+    return couplingMatrix->getColumnBound(endNodeB);
+}
+
+void NearestElementMapper::consistentRowBlockMapping(const double *fieldA, double *fieldB,
+        int numComponents, int firstNodeB, int endNodeB) {
+    couplingMatrix->multiplyRowRange(fieldA, fieldB, numComponents, firstNodeB, endNodeB);
+}
+
+int NearestElementMapper::consistentChangedRowsMapping(const double *fieldA, double *fieldB,
+        int numComponents, const char *isNodeAChanged) {
+    return couplingMatrix->multiplyChangedRows(fieldA, fieldB, numComponents, isNodeAChanged);
+}
+
+void NearestElementMapper::computeErrorsConsistentMapping(const double *_slaveField, const double *_masterField) {
+    ERROR_OUT() << "Error computation for the nearest element mapper has not been implemented" << endl;
+    exit(-1);
+}
+
+void NearestElementMapper::setSharedSearchTree(const AABBTree *tree) {
+    sharedSearchTree = tree;
+}
+
+void NearestElementMapper::setSharedConnectivity(const FEMeshConnectivity *connectivity) {
+    sharedConnectivity = connectivity;
+}
+
+void NearestElementMapper::setSharedElemGeometry(const FEMeshGeometry *elemGeometry) {
+    sharedElemGeometry = elemGeometry;
+}
+
+MemoryUsage NearestElementMapper::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("neighbors table", numNodesB * (sizeof(int) + sizeof(int*)));
+    usage.add("weights table", numNodesB * sizeof(double*));
+    for (int i = 0; i < numNodesB; i++) {
+        if (neighborsTable->at(i) != NULL)
+            usage.add("neighbors table", numNodesPerNeighborElem[i] * sizeof(int));
+        if (weightsTable->at(i) != NULL)
+            usage.add("weights table", numNodesPerNeighborElem[i] * sizeof(double));
+    }
+    if (couplingMatrix != NULL)
+        usage.add("coupling matrix", couplingMatrix->getMemoryUsage());
+    usage.add("element boxes", elemBoxesA.capacity() * sizeof(AABB));
+    usage.add("search radii", searchRadii.capacity() * sizeof(double));
+    return usage;
+}
+
+void NearestElementMapper::buildCouplingMatrices() {
+    // the element to node table of A by node positions
+    connectivityA = sharedConnectivity;
+    FEMeshConnectivity *ownConnectivityA = NULL;
+    if (connectivityA == NULL) {
+        ownConnectivityA = new FEMeshConnectivity(numNodesA, nodeIDsA, numElemsA, numNodesPerElemA,
+                elemTableA);
+        connectivityA = ownConnectivityA;
+    }
+    // the centroids, normals and planes of the elements of A, computed once for all searches
+    elemGeometryA = sharedElemGeometry;
+    FEMeshGeometry *ownElemGeometryA = NULL;
+    if (elemGeometryA == NULL) {
+        ownElemGeometryA = new FEMeshGeometry(numElemsA, numNodesPerElemA, nodesA, connectivityA,
+                mapperSetNumThreads);
+        elemGeometryA = ownElemGeometryA;
+    }
+    // the boxes are kept to find the rows affected by moved elements in updateGeometry
+    elemBoxesA.resize(numElemsA);
+    for (int i = 0; i < numElemsA; i++)
+        computeElemBoxInA(i, elemBoxesA[i]);
+    searchRadii.resize(numNodesB);
+
+    // the bounding volume hierarchy over the elements of A
+    const AABBTree *elemTreeA = sharedSearchTree;
+    AABBTree *ownElemTreeA = NULL;
+    if (elemTreeA == NULL) {
+        ownElemTreeA = new AABBTree(elemBoxesA);
+        elemTreeA = ownElemTreeA;
     }
+
     //time_t timeStart, timeEnd;
     //time(&timeStart);
 #pragma omp parallel num_threads(mapperSetNumThreads)
     {
 #pragma omp for
-        for (int i = 0; i < numNodesB; i++) { // i-th node
-            int numNodesMyNeighbor = numNodesPerNeighborElem[i];
-            int neighbors[numNodesMyNeighbor];
-            for (int j = 0; j < numNodesMyNeighbor; j++)
-                neighbors[j] = neighborsTable->at(i)[j];
-#pragma omp critical
-            {
-                for (int j = 0; j < numNodesMyNeighbor; j++) { //j-th neighbor
-                    fieldA[neighbors[j]] += weightsTable->at(i)[j] * fieldB[i];
-                }
-            }
-        }
+        for (int i = 0; i < numNodesB; i++)
+            computeNeighborsAndWeights(i, *elemTreeA);
     } //#pragma omp parallel
+    delete ownElemTreeA;
     //time(&timeEnd);
-    //cout << "It took " << difftime(timeEnd, timeStart) << " seconds for conservativeMapping"
-    //      << endl;
-}
+    //cout << "It took " << difftime(timeEnd, timeStart) << " seconds for neighbor search" << endl;
+    delete ownElemGeometryA;
+    elemGeometryA = NULL;
+    delete ownConnectivityA;
+    connectivityA = NULL;
 
-void NearestElementMapper::computeErrorsConsistentMapping(const double *_slaveField, const double *_masterField) {
-    ERROR_OUT() << "Error computation for the nearest element mapper has not been implemented" << endl;
-    exit(-1);
+    assembleCouplingMatrix();
 }
 
-void NearestElementMapper::buildCouplingMatrices() {
-    // compute directElemTableA
-    map<int, int> *nodesIDToPosMap = new map<int, int>;
-    for (int i = 0; i < numNodesA; i++)
-        nodesIDToPosMap->insert(nodesIDToPosMap->end(), pair<int, int>(nodeIDsA[i], i));
-    directElemTableA = new vector<int>*[numElemsA];
-    for (int i = 0; i < numElemsA; i++)
-        directElemTableA[i] = new vector<int>;
-    int count = 0;
+void NearestElementMapper::updateGeometry(const vector<int> &movedNodesA,
+        const vector<int> &movedNodesB) {
+    assert(elemBoxesA.size() == numElemsA);
+    connectivityA = sharedConnectivity;
+    FEMeshConnectivity *ownConnectivityA = NULL;
+    if (connectivityA == NULL) {
+        ownConnectivityA = new FEMeshConnectivity(numNodesA, nodeIDsA, numElemsA, numNodesPerElemA,
+                elemTableA);
+        connectivityA = ownConnectivityA;
+    }
+    // a shared element geometry belongs to the old geometry, the search uses an own one from now on
+    sharedElemGeometry = NULL;
+    FEMeshGeometry *ownElemGeometryA = new FEMeshGeometry(numElemsA, numNodesPerElemA, nodesA,
+            connectivityA, mapperSetNumThreads);
+    elemGeometryA = ownElemGeometryA;
+
+    // the elements with a moved node, with their boxes before and after the motion
+    vector<char> isMovedNodeA(numNodesA, 0);
+    for (int i = 0; i < movedNodesA.size(); i++)
+        isMovedNodeA[movedNodesA[i]] = 1;
+    vector<AABB> movedBoxes;
     for (int i = 0; i < numElemsA; i++) {
-        const int numNodesThisElem = numNodesPerElemA[i];
-        for (int j = 0; j < numNodesThisElem; j++) {
-            directElemTableA[i]->push_back(nodesIDToPosMap->at(elemTableA[count + j]));
-        }
-        count += numNodesThisElem;
+        const int *elemNodes = connectivityA->getElemNodes(i);
+        bool isMoved = false;
+        for (int j = 0; j < numNodesPerElemA[i] && !isMoved; j++)
+            isMoved = isMovedNodeA[elemNodes[j]];
+        if (!isMoved)
+            continue;
+        movedBoxes.push_back(elemBoxesA[i]);
+        computeElemBoxInA(i, elemBoxesA[i]);
+        movedBoxes.push_back(elemBoxesA[i]);
     }
-    delete nodesIDToPosMap;
-    // compute elementCentroidsA
-    double *elementCentroidsA = new double[numElemsA * 3];
-    for (int i = 0; i < numElemsA; i++) { // compute the centroid of all elements in A
-        int numNodesThisElem = numNodesPerElemA[i];
-        double thisElem[numNodesThisElem * 3];
-        getElemCoorInA(i, thisElem);
-        EMPIRE::MathLibrary::computePolygonCenter(thisElem, numNodesThisElem, &(elementCentroidsA[i * 3]));
+
+    // A row is affected if its node moved, or if a moved element was or is now within the radius
+    // of its search, since then the element may have decided the search or may decide it now.
+    vector<char> isAffected(numNodesB, 0);
+    for (int i = 0; i < movedNodesB.size(); i++)
+        isAffected[movedNodesB[i]] = 1;
+    if (!movedBoxes.empty()) {
+        AABBTree movedTree(movedBoxes);
+#pragma omp parallel for num_threads(mapperSetNumThreads)
+        for (int i = 0; i < numNodesB; i++) {
+            if (isAffected[i])
+                continue;
+            AABBTreeDistanceQuery query(movedTree, &(nodesB[i * 3]));
+            double distance;
+            if (query.next(searchRadii[i], distance) >= 0)
+                isAffected[i] = 1;
+        }
     }
+    vector<int> rows;
+    for (int i = 0; i < numNodesB; i++)
+        if (isAffected[i])
+            rows.push_back(i);
 
-    int NUM_NEIGHBORS_TO_SEARCH = MAX_NUM_NEIGHBORS_TO_SEARCH;
-    if (NUM_NEIGHBORS_TO_SEARCH > numElemsA) {
-        NUM_NEIGHBORS_TO_SEARCH = numElemsA;
+    // a shared tree belongs to the old geometry, so the search uses an own one from now on
+    sharedSearchTree = NULL;
+    if (!rows.empty()) {
+        AABBTree elemTreeA(elemBoxesA);
+#pragma omp parallel for num_threads(mapperSetNumThreads)
+        for (int i = 0; i < rows.size(); i++)
+            computeNeighborsAndWeights(rows[i], elemTreeA);
     }
-    //time_t timeStart, timeEnd;
-    //time(&timeStart);
-    {
-#ifdef FLANN
-        double *nodesBCasted = const_cast<double*>(nodesB);
-        flann::Matrix<double> *elementCentroidsA_FLANN = new flann::Matrix<double>(
-                const_cast<double*>(elementCentroidsA), numElemsA, 3);
-        flann::Index<flann::L2<double> > *ANodesTree = new flann::Index<flann::L2<double> >(
-                *elementCentroidsA_FLANN, flann::KDTreeSingleIndexParams(1));
-        ANodesTree->buildIndex(); // Build binary tree for searching
+    delete ownElemGeometryA;
+    elemGeometryA = NULL;
+    delete ownConnectivityA;
+    connectivityA = NULL;
+    INFO_OUT() << "NearestElementMapper: " << rows.size() << " of " << numNodesB
+            << " rows updated after the geometry changed" << endl;
 
-#pragma omp parallel num_threads(mapperSetNumThreads)
-        {
-#pragma omp for
-            for (int i = 0; i < numNodesB; i++) {
-                flann::Matrix<double> nodeI(&(nodesBCasted[i * 3]), 1, 3);
-                vector<vector<int> > indexes_tmp;
-                vector<vector<double> > dists_tmp;
-                ANodesTree->knnSearch(nodeI, indexes_tmp, dists_tmp, NUM_NEIGHBORS_TO_SEARCH,
-                        flann::SearchParams(1));
-
-                for (int j = 0; j < NUM_NEIGHBORS_TO_SEARCH; j++) {
-                    int numNodesThisElem = numNodesPerElemA[indexes_tmp[0][j]];
-                    if (numNodesThisElem == 3) {
-                        double triangle[3 * 3];
-                        getElemCoorInA(indexes_tmp[0][j], triangle);
-                        double normal[3];
-                        EMPIRE::MathLibrary::computeNormalOfTriangle(triangle, true, normal);
-                        int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(normal);
-
-                        double projection[3];
-                        EMPIRE::MathLibrary::projectToPlane(&triangle[0], normal, &(nodesB[i * 3]), 1,
-                                projection);
-
-                        double localCoors[3];
-                        EMPIRE::MathLibrary::computeLocalCoorInTriangle(triangle, planeToProject, projection,
-                                localCoors);
-                        bool inside = insideElement(3, localCoors);
-                        if (inside) {
-                            numNodesPerNeighborElem[i] = 3;
-                            neighborsTable->at(i) = new int[3];
-                            for (int k = 0; k < 3; k++) {
-                                neighborsTable->at(i)[k] = directElemTableA[indexes_tmp[0][j]]->at(
-                                        k);
-                            }
-                            weightsTable->at(i) = new double[3];
-                            for (int k = 0; k < 3; k++) {
-                                weightsTable->at(i)[k] = localCoors[k];
-                            }
-                            break;
-                        }
-                    } else if (numNodesThisElem == 4) {
-                        double quad[4 * 3];
-                        getElemCoorInA(indexes_tmp[0][j], quad);
-                        double normal[3];
-                        EMPIRE::MathLibrary::computeNormalOfQuad(quad, true, normal);
-                        int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(normal);
-
-                        { // replace the element by the projection of it on its "element plane"
-                            double quadCenter[3];
-                            EMPIRE::MathLibrary::computePolygonCenter(quad, 4, quadCenter);
-                            double quadPrj[12];
-                            EMPIRE::MathLibrary::projectToPlane(quadCenter, normal, quad, 4, quadPrj);
-                            for (int i = 0; i < 12; i++)
-                            quad[i] = quadPrj[i];
-                        }
-                        double projection[3];
-                        EMPIRE::MathLibrary::projectToPlane(&quad[0], normal, &(nodesB[i * 3]), 1,
-                                projection);
-
-                        double localCoors[2];
-                        EMPIRE::MathLibrary::computeLocalCoorInQuad(quad, planeToProject, projection,
-                                localCoors);
-                        bool inside = insideElement(4, localCoors);
-                        if (inside) {
-                            numNodesPerNeighborElem[i] = 4;
-                            neighborsTable->at(i) = new int[4];
-                            for (int k = 0; k < 4; k++) {
-                                neighborsTable->at(i)[k] = directElemTableA[indexes_tmp[0][j]]->at(
-                                        k);
-                            }
-                            weightsTable->at(i) = new double[4];
-                            EMPIRE::MathLibrary::computeShapeFuncOfQuad(localCoors, weightsTable->at(i));
-                            break;
-                        }
-                    } else {
-                        assert(false);
-                    }
-                    if (j == NUM_NEIGHBORS_TO_SEARCH - 1) { // projections do not locate inside the neighboring elements, use the nearest one
-                        int numNodesThisElem = numNodesPerElemA[indexes_tmp[0][0]];
-                        if (numNodesThisElem == 3) {
-                            double triangle[3 * 3];
-                            getElemCoorInA(indexes_tmp[0][0], triangle);
-                            double normal[3];
-                            EMPIRE::MathLibrary::computeNormalOfTriangle(triangle, true, normal);
-                            int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(normal);
-
-                            double projection[3];
-                            EMPIRE::MathLibrary::projectToPlane(&triangle[0], normal, &(nodesB[i * 3]), 1,
-                                    projection);
-
-                            double localCoors[3];
-                            EMPIRE::MathLibrary::computeLocalCoorInTriangle(triangle, planeToProject,
-                                    projection, localCoors);
-                            {
-                                numNodesPerNeighborElem[i] = 3;
-                                neighborsTable->at(i) = new int[3];
-                                for (int k = 0; k < 3; k++) {
-                                    neighborsTable->at(i)[k] =
-                                    directElemTableA[indexes_tmp[0][0]]->at(k);
-                                }
-                                weightsTable->at(i) = new double[3];
-                                for (int k = 0; k < 3; k++) {
-                                    weightsTable->at(i)[k] = localCoors[k];
-                                }
-                            }
-                        } else if (numNodesThisElem == 4) {
-                            double quad[4 * 3];
-                            getElemCoorInA(indexes_tmp[0][0], quad);
-                            double normal[3];
-                            EMPIRE::MathLibrary::computeNormalOfQuad(quad, true, normal);
-                            int planeToProject = EMPIRE::MathLibrary::computePlaneToProject(normal);
-
-                            { // replace the element by the projection of it on its "element plane"
-                                double quadCenter[3];
-                                EMPIRE::MathLibrary::computePolygonCenter(quad, 4, quadCenter);
-                                double quadPrj[12];
-                                EMPIRE::MathLibrary::projectToPlane(quadCenter, normal, quad, 4, quadPrj);
-                                for (int k = 0; k < 12; k++)
-                                quad[k] = quadPrj[k];
-                            }
-                            double projection[3];
-                            EMPIRE::MathLibrary::projectToPlane(&quad[0], normal, &(nodesB[i * 3]), 1,
-                                    projection);
-
-                            double localCoors[2];
-                            EMPIRE::MathLibrary::computeLocalCoorInQuad(quad, planeToProject, projection,
-                                    localCoors);
-                            {
-                                numNodesPerNeighborElem[i] = 4;
-                                neighborsTable->at(i) = new int[4];
-                                for (int k = 0; k < 4; k++) {
-                                    neighborsTable->at(i)[k] =
-                                    directElemTableA[indexes_tmp[0][0]]->at(k);
-                                }
-                                weightsTable->at(i) = new double[4];
-                                EMPIRE::MathLibrary::computeShapeFuncOfQuad(localCoors, weightsTable->at(i));
-                            }
-                        } else {
-                            assert(false);
-                        }
-                    }
+    assembleCouplingMatrix();
+}
+
+void NearestElementMapper::computeNeighborsAndWeights(int i, const AABBTree &elemTreeA) {
+    const double *nodeI = &(nodesB[i * 3]);
+    // Visit the elements by increasing distance of their bounding boxes. Before an element
+    // containing the projection of nodeI is found, the search radius is the distance to the
+    // nearest centroid, afterwards it is the distance to the projection.
+    double radius = numeric_limits<double>::max();
+    int hostElem = -1;
+    double hostDistance = 0.0;
+    double hostLocalCoors[3];
+    int nearestElem = -1;
+    double nearestDistance = 0.0;
+    double nearestLocalCoors[3];
+    double lastBoxDistance = 0.0;
+
+    // Take the next candidates within the current radius and test them at once. Then visit them
+    // in order as if they were taken one by one: the radius may shrink on the way, a candidate
+    // beyond it ends the search, if the radius grows the next batch continues the search.
+    AABBTreeDistanceQuery query(elemTreeA, nodeI);
+    int elems[CANDIDATE_BATCH_SIZE];
+    double boxDistances[CANDIDATE_BATCH_SIZE];
+    double localCoors[CANDIDATE_BATCH_SIZE * 3];
+    double distances[CANDIDATE_BATCH_SIZE];
+    bool inside[CANDIDATE_BATCH_SIZE];
+    bool isSearchFinished = false;
+    while (!isSearchFinished) {
+        int numCandidates = 0;
+        while (numCandidates < CANDIDATE_BATCH_SIZE
+                && (elems[numCandidates] = query.next(radius, boxDistances[numCandidates])) >= 0)
+            numCandidates++;
+        if (numCandidates == 0)
+            break;
+        computeLocalCoorInElemsA(numCandidates, elems, nodeI, localCoors, distances, inside);
+        for (int c = 0; c < numCandidates; c++) {
+            if (boxDistances[c] > radius) {
+                isSearchFinished = true;
+                break;
+            }
+            int elem = elems[c];
+            lastBoxDistance = boxDistances[c];
+            if (inside[c]) {
+                if (hostElem == -1 || distances[c] < hostDistance) {
+                    hostElem = elem;
+                    hostDistance = distances[c];
+                    for (int k = 0; k < 3; k++)
+                        hostLocalCoors[k] = localCoors[c * 3 + k];
+                    radius = distances[c];
                 }
+            }
+            if (hostElem == -1) {
+                const double *centroid = elemGeometryA->getCentroid(elem);
+                double centroidDistance = sqrt(
+                        EMPIRE::MathLibrary::distanceSquare(centroid, nodeI));
+                if (nearestElem == -1 || centroidDistance < nearestDistance) {
+                    nearestElem = elem;
+                    nearestDistance = centroidDistance;
+                    for (int k = 0; k < 3; k++)
+                        nearestLocalCoors[k] = localCoors[c * 3 + k];
+                    radius = centroidDistance;
+                }
+            }
+        }
+    }
+    // all elements within the final radius and all elements visited before have been considered
+    searchRadii[i] = max(radius, lastBoxDistance);
+    if (hostElem == -1) { // projections do not locate inside any element, use the nearest one
+        assert(nearestElem != -1);
+        hostElem = nearestElem;
+        for (int k = 0; k < 3; k++)
+            hostLocalCoors[k] = nearestLocalCoors[k];
+    }
 
+    int numNodesThisElem = numNodesPerElemA[hostElem];
+    numNodesPerNeighborElem[i] = numNodesThisElem;
+    delete[] neighborsTable->at(i);
+    neighborsTable->at(i) = new int[numNodesThisElem];
+    for (int k = 0; k < numNodesThisElem; k++)
+        neighborsTable->at(i)[k] = connectivityA->getElemNodes(hostElem)[k];
+    delete[] weightsTable->at(i);
+    weightsTable->at(i) = new double[numNodesThisElem];
+    if (numNodesThisElem == 3) {
+        for (int k = 0; k < 3; k++)
+            weightsTable->at(i)[k] = hostLocalCoors[k];
+    } else {
+        EMPIRE::MathLibrary::computeShapeFuncOfQuad(hostLocalCoors, weightsTable->at(i));
+    }
+}
+
+void NearestElementMapper::assembleCouplingMatrix() {
+    vector<int> rowPtr(numNodesB + 1, 0);
+    for (int i = 0; i < numNodesB; i++)
+        rowPtr[i + 1] = rowPtr[i] + numNodesPerNeighborElem[i];
+    vector<int> cols(rowPtr[numNodesB]);
+    vector<double> values(rowPtr[numNodesB]);
+    for (int i = 0; i < numNodesB; i++) {
+        for (int j = 0; j < numNodesPerNeighborElem[i]; j++) {
+            cols[rowPtr[i] + j] = neighborsTable->at(i)[j];
+            values[rowPtr[i] + j] = weightsTable->at(i)[j];
+        }
+    }
+    delete couplingMatrix;
+    couplingMatrix = DistributedCSRMatrix::create(numNodesB, numNodesA, rowPtr, cols, values,
+            mapperSetNumThreads, isSinglePrecisionWeights,
+            MathLibrary::CSRMatrix::getProducts(isConsistentMappingUsed, isConservativeMappingUsed));
+}
+
+void NearestElementMapper::computeLocalCoorInElemsA(int num, const int *elems,
+        const double *node, double *localCoors, double *distances, bool *inside) {
+    assert(num <= CANDIDATE_BATCH_SIZE);
+    // split the batch into triangles and quads
+    int trianglePos[CANDIDATE_BATCH_SIZE];
+    int quadPos[CANDIDATE_BATCH_SIZE];
+    int numTriangles = 0;
+    int numQuads = 0;
+    for (int c = 0; c < num; c++) {
+        if (numNodesPerElemA[elems[c]] == 3) {
+            trianglePos[numTriangles++] = c;
+        } else {
+            assert(numNodesPerElemA[elems[c]] == 4);
+            quadPos[numQuads++] = c;
+        }
+    }
+    // the elements as structure of arrays, coordinate j of node i of element k at
+    // (i * 3 + j) * n + k with n the number of elements of the same type
+    double elemCoors[CANDIDATE_BATCH_SIZE * 12];
+    double normals[CANDIDATE_BATCH_SIZE * 3];
+    double nodes[CANDIDATE_BATCH_SIZE * 3];
+    double projections[CANDIDATE_BATCH_SIZE * 3];
+    double elemLocalCoors[CANDIDATE_BATCH_SIZE * 3];
+    int planesToProject[CANDIDATE_BATCH_SIZE];
+
+    if (numTriangles > 0) {
+        int n = numTriangles;
+        for (int k = 0; k < n; k++) {
+            int elem = elems[trianglePos[k]];
+            const int *elemNodes = connectivityA->getElemNodes(elem);
+            const double *normal = elemGeometryA->getNormal(elem);
+            for (int i = 0; i < 3; i++)
+                for (int j = 0; j < 3; j++)
+                    elemCoors[(i * 3 + j) * n + k] = nodesA[elemNodes[i] * 3 + j];
+            for (int j = 0; j < 3; j++) {
+                normals[j * n + k] = normal[j];
+                nodes[j * n + k] = node[j];
             }
-        } //#pragma omp parallel
-        delete elementCentroidsA_FLANN;
-        delete ANodesTree;
-#endif
+            planesToProject[k] = elemGeometryA->getPlaneToProject(elem);
+        }
+        EMPIRE::MathLibrary::projectToPlanes(n, elemCoors, normals, nodes, projections);
+        EMPIRE::MathLibrary::computeLocalCoorInTriangles(n, elemCoors, planesToProject,
+                projections, elemLocalCoors);
+        for (int k = 0; k < n; k++) {
+            int c = trianglePos[k];
+            double projection[3];
+            for (int j = 0; j < 3; j++) {
+                localCoors[c * 3 + j] = elemLocalCoors[j * n + k];
+                projection[j] = projections[j * n + k];
+            }
+            distances[c] = sqrt(EMPIRE::MathLibrary::distanceSquare(node, projection));
+            inside[c] = insideElement(3, &localCoors[c * 3]);
+        }
+    }
+    if (numQuads > 0) {
+        int n = numQuads;
+        double centroids[CANDIDATE_BATCH_SIZE * 3];
+        for (int k = 0; k < n; k++) {
+            int elem = elems[quadPos[k]];
+            const int *elemNodes = connectivityA->getElemNodes(elem);
+            const double *normal = elemGeometryA->getNormal(elem);
+            const double *centroid = elemGeometryA->getCentroid(elem);
+            for (int i = 0; i < 4; i++)
+                for (int j = 0; j < 3; j++)
+                    elemCoors[(i * 3 + j) * n + k] = nodesA[elemNodes[i] * 3 + j];
+            for (int j = 0; j < 3; j++) {
+                normals[j * n + k] = normal[j];
+                centroids[j * n + k] = centroid[j];
+                nodes[j * n + k] = node[j];
+            }
+            planesToProject[k] = elemGeometryA->getPlaneToProject(elem);
+        }
+        // replace the elements by their projections on their "element planes"
+        for (int i = 0; i < 4; i++)
+            EMPIRE::MathLibrary::projectToPlanes(n, centroids, normals, &elemCoors[i * 3 * n],
+                    &elemCoors[i * 3 * n]);
+        EMPIRE::MathLibrary::projectToPlanes(n, elemCoors, normals, nodes, projections);
+        EMPIRE::MathLibrary::computeLocalCoorInQuads(n, elemCoors, planesToProject, projections,
+                elemLocalCoors);
+        for (int k = 0; k < n; k++) {
+            int c = quadPos[k];
+            double projection[3];
+            for (int j = 0; j < 3; j++)
+                projection[j] = projections[j * n + k];
+            localCoors[c * 3 + 0] = elemLocalCoors[k];
+            localCoors[c * 3 + 1] = elemLocalCoors[n + k];
+            localCoors[c * 3 + 2] = 0.0;
+            distances[c] = sqrt(EMPIRE::MathLibrary::distanceSquare(node, projection));
+            inside[c] = insideElement(4, &localCoors[c * 3]);
+        }
     }
-    //time(&timeEnd);
-    //cout << "It took " << difftime(timeEnd, timeStart) << " seconds for neighbor search" << endl;
-    for (int i = 0; i < numElemsA; i++)
-        delete directElemTableA[i];
-    delete[] directElemTableA;
-    delete[] elementCentroidsA;
 }
 
 void NearestElementMapper::getElemCoorInA(int elemIndex, double *elem) {
     // compute the coordinates of an element by its id
     int numNodesThisElem = numNodesPerElemA[elemIndex];
     for (int i = 0; i < numNodesThisElem; i++) {
-        int nodePos = directElemTableA[elemIndex]->at(i); // position of the node
+        int nodePos = connectivityA->getElemNodes(elemIndex)[i]; // position of the node
         for (int j = 0; j < 3; j++) {
             elem[i * 3 + j] = nodesA[nodePos * 3 + j];
         }
     }
 }
 
+void NearestElementMapper::computeElemBoxInA(int elemIndex, AABB &box) {
+    int numNodesThisElem = numNodesPerElemA[elemIndex];
+    double thisElem[numNodesThisElem * 3];
+    getElemCoorInA(elemIndex, thisElem);
+    box.computeFromPoints(thisElem, numNodesThisElem);
+}
+
 bool NearestElementMapper::insideElement(int numNodesThisElem, double *localCoor) {
     const double EPS = 1e-10;
     if (numNodesThisElem == 3) {
@@ -28,10 +28,20 @@
 
 #include <vector>
 #include "AbstractMapper.h"
+#include "BoundingBox.h"
 
 namespace EMPIRE {
+namespace MathLibrary {
+class CSRMatrix;
+}
+class AABBTree;
+class FEMeshConnectivity;
+class FEMeshGeometry;
 /********//**
- * \brief Class NearestElementMapper performs nearest element mapping
+ * \brief Class NearestElementMapper performs nearest element mapping. Each node of B is projected
+ *        to the element of A containing its projection and closest to it, which is searched by a
+ *        bounding volume hierarchy over the elements of A. If no element contains the projection,
+ *        the element with the nearest centroid is used.
  ***********/
 class NearestElementMapper: public AbstractMapper {
 public:
@@ -68,6 +78,91 @@ public:
      * \edit Altug Emiroglu function name changed from computeNeighborsAndWeights to buildCouplingMatrices
      ***********/
     void buildCouplingMatrices();
+    /***********************************************************************************************
+     * \brief Use a searching tree owned by someone else, e.g. the spatial index of the mesh, instead
+     *        of building one. Must be called before buildCouplingMatrices
+     * \param[in] tree the bounding volume hierarchy over the element bounding boxes of A
+     ***********/
+    void setSharedSearchTree(const AABBTree *tree);
+    /***********************************************************************************************
+     * \brief The rows can be updated after some nodes moved
+     * \return true
+     ***********/
+    bool isPartialGeometryUpdateSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Search the host elements again for the moved nodes of B and for the nodes of B whose
+     *        search reached an element with a moved node, before or after the motion
+     * \param[in] movedNodesA the positions of the moved nodes of A
+     * \param[in] movedNodesB the positions of the moved nodes of B
+     ***********/
+    void updateGeometry(const std::vector<int> &movedNodesA, const std::vector<int> &movedNodesB);
+    /***********************************************************************************************
+     * \brief Use the connectivity tables of A owned by someone else, e.g. the FEMesh, instead of
+     *        building them. Must be called before buildCouplingMatrices
+     * \param[in] connectivity the connectivity tables of A
+     ***********/
+    void setSharedConnectivity(const FEMeshConnectivity *connectivity);
+    /***********************************************************************************************
+     * \brief Use the element geometry of A owned by someone else, e.g. the FEMesh, instead of
+     *        computing it. Must be called before buildCouplingMatrices, it is not used anymore
+     *        after the geometry has been updated
+     * \param[in] elemGeometry the centroids, normals and planes of the elements of A
+     ***********/
+    void setSharedElemGeometry(const FEMeshGeometry *elemGeometry);
+    /***********************************************************************************************
+     * \brief Get the heap memory of the neighbors and the weights tables
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+    /***********************************************************************************************
+     * \brief The weights can be stored in single precision
+     * \return true
+     ***********/
+    bool isSinglePrecisionWeightsSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Store the weights of the coupling matrix in single precision
+     * \param[in] singlePrecision true for single precision
+     ***********/
+    void setSinglePrecisionWeights(bool singlePrecision) {
+        isSinglePrecisionWeights = singlePrecision;
+    }
+
+    /***********************************************************************************************
+     * \brief The coupling matrix is the mapping operator
+     * \return true
+     ***********/
+    bool isMappingOperatorExportSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Get a copy of the coupling matrix
+     ***********/
+    void getMappingOperator(std::vector<int> &rowPointers, std::vector<int> &columnIndices,
+            std::vector<double> &values) const;
+
+    /***********************************************************************************************
+     * \brief The coupling matrix can be built for one direction only
+     * \return true
+     ***********/
+    bool isMappingDirectionsSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Keep only the arrays of the products of the used directions in the coupling matrix
+     * \param[in] consistent whether consistent mapping is used
+     * \param[in] conservative whether conservative mapping is used
+     ***********/
+    void setMappingDirections(bool consistent, bool conservative) {
+        isConsistentMappingUsed = consistent;
+        isConservativeMappingUsed = conservative;
+    }
     /***********************************************************************************************
      * \brief Do consistent mapping on fields (e.g. displacements or tractions)
      * \param[in] fieldA the field of mesh A (e.g. x-displacements on all structure nodes)
@@ -89,6 +184,45 @@ public:
      * \author Andreas Apostolatos
      ***********/
     void computeErrorsConsistentMapping(const double *fieldA, const double *fieldB);
+    /***********************************************************************************************
+     * \brief Block mapping is supported by this mapper
+     * \return true
+     ***********/
+    bool isBlockMappingSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Do consistent mapping on all components of interleaved fields at once
+     * \param[in] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[out] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void consistentBlockMapping(const double *fieldA, double *fieldB, int numComponents);
+    /***********************************************************************************************
+     * \brief Do conservative mapping on all components of interleaved integrated fields at once
+     * \param[in] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[out] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void conservativeBlockMapping(const double *fieldB, double *fieldA, int numComponents);
+    /***********************************************************************************************
+     * \brief Row blocks are mapped by the coupling matrix, if it is not distributed
+     ***********/
+    bool isRowBlockMappingSupported() const;
+    /***********************************************************************************************
+     * \brief Get the number of leading nodes of A the nodes of B before endNodeB interpolate from
+     ***********/
+    int getNumRequiredNodesA(int endNodeB) const;
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes firstNodeB to endNodeB-1 of B only
+     ***********/
+    void consistentRowBlockMapping(const double *fieldA, double *fieldB, int numComponents,
+            int firstNodeB, int endNodeB);
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes of B depending on a changed node of A only
+     ***********/
+    int consistentChangedRowsMapping(const double *fieldA, double *fieldB, int numComponents,
+            const char *isNodeAChanged);
 
     /// defines number of threads used for mapper routines
     static int mapperSetNumThreads;
@@ -119,16 +253,54 @@ private:
     /// how the elements are constructed by the nodes (B)
     const int *elemTableB;
 
+    /// bounding volume hierarchy over the elements of A owned by someone else, NULL if the mapper
+    /// builds its own
+    const AABBTree *sharedSearchTree;
+    /// connectivity tables of A owned by someone else, NULL if the mapper builds its own
+    const FEMeshConnectivity *sharedConnectivity;
+    /// element geometry of A owned by someone else, NULL if the mapper computes its own
+    const FEMeshGeometry *sharedElemGeometry;
     /// number of nodes per neighbor element
     int *numNodesPerNeighborElem;
     /// neighbors of nodes in B
     std::vector<int*> *neighborsTable;
     /// weights of the neighbors
     std::vector<double*> *weightsTable;
-    /// directElemTable means the entries is not the node number, but the position in nodeCoors
-    std::vector<int> **directElemTableA;
-    /// number of neighbors to search
-    static const int MAX_NUM_NEIGHBORS_TO_SEARCH;
+    /// the bounding boxes of the elements of A at the last search
+    std::vector<AABB> elemBoxesA;
+    /// for each node of B, all elements of A whose boxes were within this distance have been
+    /// considered by the search
+    std::vector<double> searchRadii;
+    /// element to node table of A by node positions, only valid during the search
+    const FEMeshConnectivity *connectivityA;
+    /// centroids, normals and planes of the elements of A, only valid during the search
+    const FEMeshGeometry *elemGeometryA;
+    /// whether the weights of the coupling matrix are stored in single precision
+    bool isSinglePrecisionWeights;
+    /// whether consistent mapping is used
+    bool isConsistentMappingUsed;
+    /// whether conservative mapping is used
+    bool isConservativeMappingUsed;
+    /// the neighbors and weights as matrix B x A, analysed once for the mapping calls
+    MathLibrary::CSRMatrix *couplingMatrix;
+    /// number of candidate elements of a node of B tested at once
+    static const int CANDIDATE_BATCH_SIZE;
+    /***********************************************************************************************
+     * \brief Search the host element of a node of B and fill its row of the tables
+     * \param[in] i the position of the node of B
+     * \param[in] elemTreeA the bounding volume hierarchy over the elements of A
+     ***********/
+    void computeNeighborsAndWeights(int i, const AABBTree &elemTreeA);
+    /***********************************************************************************************
+     * \brief Build the coupling matrix from the neighbors and weights tables
+     ***********/
+    void assembleCouplingMatrix();
+    /***********************************************************************************************
+     * \brief Compute the bounding box of an element of A
+     * \param[in] elemIndex the element index/id
+     * \param[out] box the bounding box
+     ***********/
+    void computeElemBoxInA(int elemIndex, AABB &box);
     /***********************************************************************************************
      * \brief Given the element index/id, return the element
      * \param[in] elemIndex the element index/id
@@ -136,6 +308,20 @@ private:
      * \author Tianyang Wang
      ***********/
     void getElemCoorInA(int elemIndex, double *elem);
+    /***********************************************************************************************
+     * \brief Project a node to the planes of a batch of elements of A and compute its local
+     *        coordinates in them. The triangles and the quads of the batch are tested by the
+     *        SIMD kernels of the MathLibrary with the normals and planes of elemGeometryA.
+     * \param[in] num number of elements, at most CANDIDATE_BATCH_SIZE
+     * \param[in] elems the element indices/ids
+     * \param[in] node x,y,z coordinates of the node
+     * \param[out] localCoors local coordinates of the projections, 3 per element (the third is 0
+     *             for quads)
+     * \param[out] distances the distances between the node and its projections
+     * \param[out] inside whether the projections are inside the elements
+     ***********/
+    void computeLocalCoorInElemsA(int num, const int *elems, const double *node,
+            double *localCoors, double *distances, bool *inside);
     /***********************************************************************************************
      * \brief Determine whether a node is inside the element or not
      * \param[in] numNodesThisElem number of nodes of this element (3 or 4)
@@ -20,6 +20,7 @@
  */
 #include "NearestNeighborMapper.h"
 #include <assert.h>
+#include <math.h>
 #include <vector>
 
 #ifdef FLANN
@@ -31,6 +32,11 @@
 #endif
 
 #include "Message.h"
+#include "CSRMatrix.h"
+#include "DistributedCSRMatrix.h"
+#include "AuxiliaryParameters.h"
+#include "AABBTree.h"
+#include "MathLibrary.h"
 
 using namespace std;
 
@@ -38,7 +44,9 @@ namespace EMPIRE {
 
 NearestNeighborMapper::NearestNeighborMapper(int _numNodesA, const double *_nodesA, int _numNodesB,
         const double *_nodesB) :
-        numNodesA(_numNodesA), nodesA(_nodesA), numNodesB(_numNodesB), nodesB(_nodesB) {
+        numNodesA(_numNodesA), nodesA(_nodesA), numNodesB(_numNodesB), nodesB(_nodesB),
+        isSinglePrecisionWeights(false), isConsistentMappingUsed(true),
+        isConservativeMappingUsed(true), couplingMatrix(NULL), FLANNkd_tree(NULL), FLANNNodesA(NULL) {
     neighborsTable = new int[numNodesB];
 
     mapperType = EMPIRE_NearestNeighborMapper;
@@ -47,6 +55,30 @@ NearestNeighborMapper::NearestNeighborMapper(int _numNodesA, const double *_node
 
 NearestNeighborMapper::~NearestNeighborMapper() {
     delete[] neighborsTable;
+    delete couplingMatrix;
+#ifdef FLANN
+    if (FLANNNodesA != NULL) { // the tree is not shared
+        delete FLANNkd_tree;
+        delete FLANNNodesA;
+    }
+#endif
+}
+
+void NearestNeighborMapper::setSharedSearchTree(flann::Index<flann::L2<double> > *tree) {
+    assert(FLANNkd_tree == NULL);
+    FLANNkd_tree = tree;
+}
+
+MemoryUsage NearestNeighborMapper::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("neighbors table", numNodesB * sizeof(int));
+#ifdef FLANN
+    if (FLANNNodesA != NULL) // a shared tree is counted by the mesh
+        usage.add("searching tree", FLANNkd_tree->usedMemory());
+#endif
+    if (couplingMatrix != NULL)
+        usage.add("coupling matrix", couplingMatrix->getMemoryUsage());
+    return usage;
 }
 
 void NearestNeighborMapper::buildCouplingMatrices(){
@@ -73,45 +105,153 @@ void NearestNeighborMapper::buildCouplingMatrices(){
     }
     {
 #ifdef FLANN
-        double *nodesBCasted = const_cast<double*>(nodesB);
-        flann::Matrix<double> *ANodes = new flann::Matrix<double>(const_cast<double*>(nodesA),
-                numNodesA, 3);
-        flann::Index<flann::L2<double> > *ANodesTree = new flann::Index<flann::L2<double> >(*ANodes,
-                flann::KDTreeSingleIndexParams(1));
-        ANodesTree->buildIndex(); // Build binary tree for searching
-
-        for (int i = 0; i < numNodesB; i++) {
-            flann::Matrix<double> nodeI(&(nodesBCasted[i * 3]), 1, 3);
-            vector<vector<int> > indexes_tmp;
-            vector<vector<double> > dists_tmp;
-            ANodesTree->knnSearch(nodeI, indexes_tmp, dists_tmp, 1, flann::SearchParams(1));
-            int nb = indexes_tmp[0][0];
-            neighborsTable[i] = nb;
+        if (FLANNkd_tree == NULL) {
+            FLANNNodesA = new flann::Matrix<double>(const_cast<double*>(nodesA), numNodesA, 3);
+            FLANNkd_tree = new flann::Index<flann::L2<double> >(*FLANNNodesA,
+                    flann::KDTreeSingleIndexParams(1));
+            FLANNkd_tree->buildIndex(); // Build binary tree for searching
         }
 
-        delete ANodes;
-        delete ANodesTree;
+        // Query all nodes of B at once, the indices are written directly into neighborsTable
+        flann::Matrix<double> queryNodes(const_cast<double*>(nodesB), numNodesB, 3);
+        flann::Matrix<int> indexes(neighborsTable, numNodesB, 1);
+        double *distsArray = new double[numNodesB];
+        flann::Matrix<double> dists(distsArray, numNodesB, 1);
+        flann::SearchParams searchParams(1);
+        searchParams.cores = 0; // search with as many threads as OpenMP provides
+        FLANNkd_tree->knnSearch(queryNodes, indexes, dists, 1, searchParams);
+        delete[] distsArray;
 #endif
     }
 
+    assembleCouplingMatrix();
 }
 
-void NearestNeighborMapper::consistentMapping(const double *DOF_A, double *DOF_B) {
-    for (int i = 0; i < numNodesB; i++) {
-        int neighbor = neighborsTable[i];
-        DOF_B[i] = DOF_A[neighbor];
+void NearestNeighborMapper::updateGeometry(const vector<int> &movedNodesA,
+        const vector<int> &movedNodesB) {
+#ifdef FLANN
+    // A row is affected if its node moved, if its neighbor moved or if a moved node of A is now
+    // nearer than its neighbor
+    vector<char> isAffected(numNodesB, 0);
+    for (int i = 0; i < movedNodesB.size(); i++)
+        isAffected[movedNodesB[i]] = 1;
+    if (!movedNodesA.empty()) {
+        vector<char> isMovedA(numNodesA, 0);
+        vector<AABB> movedBoxes(movedNodesA.size());
+        for (int i = 0; i < movedNodesA.size(); i++) {
+            isMovedA[movedNodesA[i]] = 1;
+            movedBoxes[i].computeFromPoints(&(nodesA[movedNodesA[i] * 3]), 1);
+        }
+        AABBTree movedTree(movedBoxes);
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads)
+        for (int i = 0; i < numNodesB; i++) {
+            if (isAffected[i])
+                continue;
+            if (isMovedA[neighborsTable[i]]) {
+                isAffected[i] = 1;
+                continue;
+            }
+            double radius = sqrt(
+                    MathLibrary::distanceSquare(&(nodesB[i * 3]), &(nodesA[neighborsTable[i] * 3])));
+            AABBTreeDistanceQuery query(movedTree, &(nodesB[i * 3]));
+            double distance;
+            if (query.next(radius, distance) >= 0)
+                isAffected[i] = 1;
+        }
     }
-}
+    vector<int> rows;
+    for (int i = 0; i < numNodesB; i++)
+        if (isAffected[i])
+            rows.push_back(i);
 
-void NearestNeighborMapper::conservativeMapping(const double *DOF_B, double *DOF_A) {
-    for (int i = 0; i < numNodesA; i++) {
-        DOF_A[i] = 0.0;
+    // the tree is rebuilt over the moved nodes, a shared tree belongs to the old geometry
+    if (!movedNodesA.empty() || FLANNNodesA == NULL) {
+        if (FLANNNodesA != NULL) {
+            delete FLANNkd_tree;
+            delete FLANNNodesA;
+        }
+        FLANNNodesA = new flann::Matrix<double>(const_cast<double*>(nodesA), numNodesA, 3);
+        FLANNkd_tree = new flann::Index<flann::L2<double> >(*FLANNNodesA,
+                flann::KDTreeSingleIndexParams(1));
+        FLANNkd_tree->buildIndex();
     }
 
-    for (int i = 0; i < numNodesB; i++) {
-        int neighbor = neighborsTable[i];
-        DOF_A[neighbor] += DOF_B[i];
+    if (!rows.empty()) {
+        vector<double> queryNodesArray(rows.size() * 3);
+        for (int i = 0; i < rows.size(); i++)
+            for (int k = 0; k < 3; k++)
+                queryNodesArray[i * 3 + k] = nodesB[rows[i] * 3 + k];
+        vector<int> indexesArray(rows.size());
+        vector<double> distsArray(rows.size());
+        flann::Matrix<double> queryNodes(&queryNodesArray[0], rows.size(), 3);
+        flann::Matrix<int> indexes(&indexesArray[0], rows.size(), 1);
+        flann::Matrix<double> dists(&distsArray[0], rows.size(), 1);
+        flann::SearchParams searchParams(1);
+        searchParams.cores = 0;
+        FLANNkd_tree->knnSearch(queryNodes, indexes, dists, 1, searchParams);
+        for (int i = 0; i < rows.size(); i++)
+            neighborsTable[rows[i]] = indexesArray[i];
     }
+    INFO_OUT() << "NearestNeighborMapper: " << rows.size() << " of " << numNodesB
+            << " rows updated after the geometry changed" << endl;
+    assembleCouplingMatrix();
+#else
+    buildCouplingMatrices();
+#endif
+}
+
+void NearestNeighborMapper::assembleCouplingMatrix() {
+    // one entry of weight 1 per row
+    vector<int> rowPtr(numNodesB + 1);
+    for (int i = 0; i <= numNodesB; i++)
+        rowPtr[i] = i;
+    vector<int> cols(neighborsTable, neighborsTable + numNodesB);
+    vector<double> values(numNodesB, 1.0);
+    delete couplingMatrix;
+    couplingMatrix = DistributedCSRMatrix::create(numNodesB, numNodesA, rowPtr, cols, values,
+            AuxiliaryParameters::mapperSetNumThreads, isSinglePrecisionWeights,
+            MathLibrary::CSRMatrix::getProducts(isConsistentMappingUsed, isConservativeMappingUsed));
+}
+
+void NearestNeighborMapper::consistentMapping(const double *fieldA, double *fieldB) {
+    couplingMatrix->multiply(false, fieldA, fieldB);
+}
+
+void NearestNeighborMapper::conservativeMapping(const double *fieldB, double *fieldA) {
+    couplingMatrix->multiply(true, fieldB, fieldA);
+}
+
+void NearestNeighborMapper::consistentBlockMapping(const double *fieldA, double *fieldB,
+        int numComponents) {
+    couplingMatrix->multiplyBlock(false, fieldA, fieldB, numComponents);
+}
+
+void NearestNeighborMapper::conservativeBlockMapping(const double *fieldB, double *fieldA,
+        int numComponents) {
+    couplingMatrix->multiplyBlock(true, fieldB, fieldA, numComponents);
+}
+
+void NearestNeighborMapper::getMappingOperator(std::vector<int> &rowPointers,
+        std::vector<int> &columnIndices, std::vector<double> &values) const {
+    couplingMatrix->getEntries(rowPointers, columnIndices, values);
+}
+
+bool NearestNeighborMapper::isRowBlockMappingSupported() const {
+    return isConsistentMappingUsed && couplingMatrix->isRowRangeProductSupported();
+}
+
+int NearestNeighborMapper::getNumRequiredNodesA(int endNodeB) const {
+    return couplingMatrix->getColumnBound(endNodeB);
+}
+
+void NearestNeighborMapper::consistentRowBlockMapping(const double *fieldA, double *fieldB,
+        int numComponents, int firstNodeB, int endNodeB) {
+    couplingMatrix->multiplyRowRange(fieldA, fieldB, numComponents, firstNodeB, endNodeB);
+}
+
+int NearestNeighborMapper::consistentChangedRowsMapping(const double *fieldA, double *fieldB,
+        int numComponents, const char *isNodeAChanged) {
+    return couplingMatrix->multiplyChangedRows(fieldA, fieldB, numComponents, isNodeAChanged);
 }
 
 void NearestNeighborMapper::computeErrorsConsistentMapping(const double *_slaveField, const double *_masterField) {
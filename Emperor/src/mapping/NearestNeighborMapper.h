@@ -29,7 +29,16 @@
 #include <string>
 #include "AbstractMapper.h"
 
+namespace flann {
+template<typename Distance> class Index;
+template<class T> struct L2;
+template<typename T> class Matrix;
+}
+
 namespace EMPIRE {
+namespace MathLibrary {
+class CSRMatrix;
+}
 /********//**
  * \brief Class NearestNeighborMapper performs nearest neighbor mapping
  ***********/
@@ -51,11 +60,84 @@ public:
     virtual ~NearestNeighborMapper();
 
     /***********************************************************************************************
-     * \brief Build Coupling Matrices
-     * \param[in] mapperName name of the mapper
+     * \brief Build Coupling Matrices. The searching tree of A is built at the first call and reused
+     *        by later calls, e.g. after the nodes of B have moved
      * \author Altug Emiroglu
      ***********/
     void buildCouplingMatrices();
+    /***********************************************************************************************
+     * \brief Use a searching tree owned by someone else, e.g. the spatial index of the mesh, instead
+     *        of building one. Must be called before buildCouplingMatrices
+     * \param[in] tree the FLANN searching tree over the nodes of A
+     ***********/
+    void setSharedSearchTree(flann::Index<flann::L2<double> > *tree);
+    /***********************************************************************************************
+     * \brief The rows can be updated after some nodes moved
+     * \return true
+     ***********/
+    bool isPartialGeometryUpdateSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Search the nearest neighbors again for the moved nodes of B, for the nodes of B whose
+     *        neighbor moved and for those to which a moved node of A came nearer than their neighbor.
+     *        The searching tree is rebuilt if nodes of A moved
+     * \param[in] movedNodesA the positions of the moved nodes of A
+     * \param[in] movedNodesB the positions of the moved nodes of B
+     ***********/
+    void updateGeometry(const std::vector<int> &movedNodesA, const std::vector<int> &movedNodesB);
+    /***********************************************************************************************
+     * \brief Get the heap memory of the neighbors table and the own searching tree
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+    /***********************************************************************************************
+     * \brief The weights can be stored in single precision
+     * \return true
+     ***********/
+    bool isSinglePrecisionWeightsSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Store the weights of the coupling matrix in single precision
+     * \param[in] singlePrecision true for single precision
+     ***********/
+    void setSinglePrecisionWeights(bool singlePrecision) {
+        isSinglePrecisionWeights = singlePrecision;
+    }
+
+    /***********************************************************************************************
+     * \brief The coupling matrix is the mapping operator
+     * \return true
+     ***********/
+    bool isMappingOperatorExportSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Get a copy of the coupling matrix
+     ***********/
+    void getMappingOperator(std::vector<int> &rowPointers, std::vector<int> &columnIndices,
+            std::vector<double> &values) const;
+
+    /***********************************************************************************************
+     * \brief The coupling matrix can be built for one direction only
+     * \return true
+     ***********/
+    bool isMappingDirectionsSupported() const {
+        return true;
+    }
+
+    /***********************************************************************************************
+     * \brief Keep only the arrays of the products of the used directions in the coupling matrix
+     * \param[in] consistent whether consistent mapping is used
+     * \param[in] conservative whether conservative mapping is used
+     ***********/
+    void setMappingDirections(bool consistent, bool conservative) {
+        isConsistentMappingUsed = consistent;
+        isConservativeMappingUsed = conservative;
+    }
 
     /***********************************************************************************************
      * \brief Do consistent mapping on fields (e.g. displacements or tractions)
@@ -79,6 +161,45 @@ public:
      * \author Andreas Apostolatos
      ***********/
     void computeErrorsConsistentMapping(const double *fieldA, const double *fieldB);
+    /***********************************************************************************************
+     * \brief Block mapping is supported by this mapper
+     * \return true
+     ***********/
+    bool isBlockMappingSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Do consistent mapping on all components of interleaved fields at once
+     * \param[in] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[out] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void consistentBlockMapping(const double *fieldA, double *fieldB, int numComponents);
+    /***********************************************************************************************
+     * \brief Do conservative mapping on all components of interleaved integrated fields at once
+     * \param[in] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[out] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void conservativeBlockMapping(const double *fieldB, double *fieldA, int numComponents);
+    /***********************************************************************************************
+     * \brief Row blocks are mapped by the coupling matrix, if it is not distributed
+     ***********/
+    bool isRowBlockMappingSupported() const;
+    /***********************************************************************************************
+     * \brief Get the number of leading nodes of A the nodes of B before endNodeB interpolate from
+     ***********/
+    int getNumRequiredNodesA(int endNodeB) const;
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes firstNodeB to endNodeB-1 of B only
+     ***********/
+    void consistentRowBlockMapping(const double *fieldA, double *fieldB, int numComponents,
+            int firstNodeB, int endNodeB);
+    /***********************************************************************************************
+     * \brief Do consistent mapping of the nodes of B depending on a changed node of A only
+     ***********/
+    int consistentChangedRowsMapping(const double *fieldA, double *fieldB, int numComponents,
+            const char *isNodeAChanged);
 private:
     /// number of nodes of A
     int numNodesA;
@@ -90,6 +211,22 @@ private:
     const double *nodesB;
     /// table of neighbors of B
     int *neighborsTable;
+    /// whether the weights of the coupling matrix are stored in single precision
+    bool isSinglePrecisionWeights;
+    /// whether consistent mapping is used
+    bool isConsistentMappingUsed;
+    /// whether conservative mapping is used
+    bool isConservativeMappingUsed;
+    /// the neighbors and weights as matrix B x A, analysed once for the mapping calls
+    MathLibrary::CSRMatrix *couplingMatrix;
+    /// nearest neighbors searching tree of FLANN library over the nodes of A
+    flann::Index<flann::L2<double> > *FLANNkd_tree;
+    /// nodes constructing the searching tree, NULL if the tree is shared
+    flann::Matrix<double> *FLANNNodesA;
+    /***********************************************************************************************
+     * \brief Build the coupling matrix from the neighbors table
+     ***********/
+    void assembleCouplingMatrix();
 };
 
 } /* namespace EMPIRE */
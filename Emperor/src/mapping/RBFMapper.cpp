@@ -0,0 +1,409 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "RBFMapper.h"
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#ifdef FLANN
+#include "flann/flann.hpp"
+#endif
+
+#include "Message.h"
+#include "MathLibrary.h"
+#include "AABBTree.h"
+#include "CSRMatrix.h"
+#include "DistributedCSRMatrix.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+int RBFMapper::mapperSetNumThreads = 1;
+const double RBFMapper::SUPPORT_FACTOR = 2.0;
+const double RBFMapper::COVER_FACTOR = 0.5;
+
+/***********************************************************************************************
+ * \brief The Wendland C2 function, positive definite in three dimensions
+ * \param[in] r the distance divided by the support radius
+ * \return (1-r)^4 (4r+1) for r < 1, 0 otherwise
+ ***********/
+static inline double wendlandC2(double r) {
+    if (r >= 1.0)
+        return 0.0;
+    double t = (1.0 - r) * (1.0 - r);
+    return t * t * (4.0 * r + 1.0);
+}
+
+/***********************************************************************************************
+ * \brief Factorize a dense symmetric positive definite matrix into L * L^T in place
+ * \param[in] n the size of the matrix
+ * \param[in,out] A the matrix in row major order, its lower triangle is overwritten by L
+ * \return false if the matrix is not positive definite
+ ***********/
+static bool computeCholesky(int n, double *A) {
+    for (int j = 0; j < n; j++) {
+        double diagonal = A[j * n + j];
+        for (int k = 0; k < j; k++)
+            diagonal -= A[j * n + k] * A[j * n + k];
+        if (diagonal <= 0.0)
+            return false;
+        diagonal = sqrt(diagonal);
+        A[j * n + j] = diagonal;
+        for (int i = j + 1; i < n; i++) {
+            double value = A[i * n + j];
+            for (int k = 0; k < j; k++)
+                value -= A[i * n + k] * A[j * n + k];
+            A[i * n + j] = value / diagonal;
+        }
+    }
+    return true;
+}
+
+/***********************************************************************************************
+ * \brief Solve L * L^T * x = b with the factor of computeCholesky
+ * \param[in] n the size of the matrix
+ * \param[in] L the factor
+ * \param[in,out] x the right hand side on input, the solution on output
+ ***********/
+static void solveCholesky(int n, const double *L, double *x) {
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < i; k++)
+            x[i] -= L[i * n + k] * x[k];
+        x[i] /= L[i * n + i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        for (int k = i + 1; k < n; k++)
+            x[i] -= L[k * n + i] * x[k];
+        x[i] /= L[i * n + i];
+    }
+}
+
+/***********************************************************************************************
+ * \brief Find the patches containing a point and their normalized partition of unity weights.
+ *        A point outside of all patches belongs to the patch with the nearest center.
+ * \param[in] P the point
+ * \param[in] patchTree the bounding boxes of the patch spheres
+ * \param[in] centers the centers of the patches
+ * \param[in] radii the radii of the patches
+ * \param[out] patches the patches containing P
+ * \param[out] weights the weights of the patches, they sum up to one
+ ***********/
+static void findPatches(const double *P, const AABBTree &patchTree, const vector<double> &centers,
+        const vector<double> &radii, vector<int> &patches, vector<double> &weights) {
+    vector<int> boxes;
+    patchTree.findBoxesContainingPoint(P, 0.0, boxes);
+    patches.clear();
+    weights.clear();
+    double sum = 0.0;
+    for (int i = 0; i < boxes.size(); i++) {
+        int patch = boxes[i];
+        double distance = sqrt(MathLibrary::distanceSquare(P, &(centers[patch * 3])));
+        double weight = wendlandC2(distance / radii[patch]);
+        if (weight > 0.0) {
+            patches.push_back(patch);
+            weights.push_back(weight);
+            sum += weight;
+        }
+    }
+    if (patches.empty()) {
+        AABBTreeDistanceQuery query(patchTree, P);
+        double nearestDistance = numeric_limits<double>::max();
+        int nearestPatch = -1;
+        int patch;
+        double boxDistance;
+        while ((patch = query.next(nearestDistance, boxDistance)) >= 0) {
+            double distance = sqrt(MathLibrary::distanceSquare(P, &(centers[patch * 3])));
+            if (distance < nearestDistance) {
+                nearestDistance = distance;
+                nearestPatch = patch;
+            }
+        }
+        assert(nearestPatch != -1);
+        patches.push_back(nearestPatch);
+        weights.push_back(1.0);
+        return;
+    }
+    for (int i = 0; i < weights.size(); i++)
+        weights[i] /= sum;
+}
+
+RBFMapper::RBFMapper(int _numNodesA, const double *_nodesA, int _numNodesB,
+        const double *_nodesB, int _numNodesPerPatch) :
+        numNodesA(_numNodesA), nodesA(_nodesA), numNodesB(_numNodesB), nodesB(_nodesB),
+        numNodesPerPatch(_numNodesPerPatch), numPatches(0), isSinglePrecisionWeights(false),
+        isConsistentMappingUsed(true), isConservativeMappingUsed(true), couplingMatrix(NULL),
+        sharedSearchTree(NULL) {
+    assert(numNodesPerPatch > 0);
+    mapperType = EMPIRE_RBFMapper;
+}
+
+RBFMapper::~RBFMapper() {
+    delete couplingMatrix;
+}
+
+void RBFMapper::setSharedSearchTree(flann::Index<flann::L2<double> > *tree) {
+    sharedSearchTree = tree;
+}
+
+MemoryUsage RBFMapper::getMemoryUsage() const {
+    MemoryUsage usage;
+    if (couplingMatrix != NULL)
+        usage.add("coupling matrix", couplingMatrix->getMemoryUsage());
+    return usage;
+}
+
+void RBFMapper::buildCouplingMatrices() {
+#ifdef FLANN
+    const int n = min(numNodesPerPatch, numNodesA);
+    flann::Matrix<double> *FLANNNodesA = NULL;
+    flann::Index<flann::L2<double> > *treeA = sharedSearchTree;
+    if (treeA == NULL) {
+        FLANNNodesA = new flann::Matrix<double>(const_cast<double*>(nodesA), numNodesA, 3);
+        treeA = new flann::Index<flann::L2<double> >(*FLANNNodesA,
+                flann::KDTreeSingleIndexParams(1));
+        treeA->buildIndex();
+    }
+
+    // 1. Cover the nodes of A by patches of their n nearest nodes. A node within COVER_FACTOR of
+    // the radius of a patch needs no patch of its own, so that the patches overlap and also
+    // contain the nodes of B close to A. A patch of all nodes is the only one.
+    vector<int> patchNodes;
+    vector<double> centers;
+    vector<double> radii;
+    {
+        vector<char> isCovered(numNodesA, 0);
+        for (int i = 0; i < numNodesA; i++) {
+            if (isCovered[i])
+                continue;
+            flann::Matrix<double> nodeI(const_cast<double*>(&(nodesA[i * 3])), 1, 3);
+            vector<vector<int> > indexes;
+            vector<vector<double> > dists; // squared distances
+            treeA->knnSearch(nodeI, indexes, dists, n, flann::SearchParams(1));
+            double radius = sqrt(dists[0][n - 1]);
+            if (radius == 0.0) // the nodes coincide, any length will do
+                radius = 1.0;
+            for (int j = 0; j < n; j++) {
+                patchNodes.push_back(indexes[0][j]);
+                if (dists[0][j] <= COVER_FACTOR * COVER_FACTOR * radius * radius)
+                    isCovered[indexes[0][j]] = 1;
+            }
+            for (int k = 0; k < 3; k++)
+                centers.push_back(nodesA[i * 3 + k]);
+            radii.push_back(radius);
+            if (n == numNodesA) // the patch holds all nodes
+                break;
+        }
+    }
+    numPatches = radii.size();
+    if (FLANNNodesA != NULL) { // the tree is not shared
+        delete FLANNNodesA;
+        delete treeA;
+    }
+
+    // 2. Find the patches of every node of B with its weight of the partition of unity, first
+    // counting them and then storing them by nodes of B
+    vector<AABB> patchBoxes(numPatches);
+    for (int p = 0; p < numPatches; p++) {
+        double corners[6];
+        for (int k = 0; k < 3; k++) {
+            corners[k] = centers[p * 3 + k] - radii[p];
+            corners[3 + k] = centers[p * 3 + k] + radii[p];
+        }
+        patchBoxes[p].computeFromPoints(corners, 2);
+    }
+    AABBTree patchTree(patchBoxes);
+    vector<int> nodePatchesPtr(numNodesB + 1, 0);
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        vector<int> patches;
+        vector<double> weights;
+#pragma omp for
+        for (int i = 0; i < numNodesB; i++) {
+            findPatches(&(nodesB[i * 3]), patchTree, centers, radii, patches, weights);
+            nodePatchesPtr[i + 1] = patches.size();
+        }
+    }
+    for (int i = 0; i < numNodesB; i++)
+        nodePatchesPtr[i + 1] += nodePatchesPtr[i];
+    int numEntries = nodePatchesPtr[numNodesB];
+    vector<int> entryNodes(numEntries);
+    vector<int> entryPatches(numEntries);
+    vector<double> entryWeights(numEntries);
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        vector<int> patches;
+        vector<double> weights;
+#pragma omp for
+        for (int i = 0; i < numNodesB; i++) {
+            findPatches(&(nodesB[i * 3]), patchTree, centers, radii, patches, weights);
+            for (int j = 0; j < patches.size(); j++) {
+                entryNodes[nodePatchesPtr[i] + j] = i;
+                entryPatches[nodePatchesPtr[i] + j] = patches[j];
+                entryWeights[nodePatchesPtr[i] + j] = weights[j];
+            }
+        }
+    }
+    // the entries by patches
+    vector<int> patchEntriesPtr(numPatches + 1, 0);
+    for (int e = 0; e < numEntries; e++)
+        patchEntriesPtr[entryPatches[e] + 1]++;
+    for (int p = 0; p < numPatches; p++)
+        patchEntriesPtr[p + 1] += patchEntriesPtr[p];
+    vector<int> patchEntries(numEntries);
+    {
+        vector<int> position(patchEntriesPtr.begin(), patchEntriesPtr.end() - 1);
+        for (int e = 0; e < numEntries; e++)
+            patchEntries[position[entryPatches[e]]++] = e;
+    }
+
+    // 3. Solve the interpolation system of every patch for the nodes of B in it. With the
+    // constant polynomial, the interpolant at x of the data f is w^T f with
+    // w = u + (1 - sum(u)) / sum(v) * v, Phi * u = phi(x) and Phi * v = 1.
+    vector<int> cols(numEntries * n);
+    vector<double> values(numEntries * n);
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        vector<double> Phi(n * n);
+        vector<double> u(n);
+        vector<double> v(n);
+#pragma omp for schedule(dynamic, 16)
+        for (int p = 0; p < numPatches; p++) {
+            if (patchEntriesPtr[p] == patchEntriesPtr[p + 1])
+                continue;
+            const int *nodes = &(patchNodes[p * n]);
+            double support = SUPPORT_FACTOR * radii[p];
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j <= i; j++)
+                    Phi[i * n + j] = Phi[j * n + i] = wendlandC2(sqrt(MathLibrary::distanceSquare(
+                            &(nodesA[nodes[i] * 3]), &(nodesA[nodes[j] * 3]))) / support);
+            // coinciding nodes make the matrix singular, they are separated by a small shift
+            double shift = 1e-12;
+            vector<double> factor(Phi);
+            while (!computeCholesky(n, &factor[0])) {
+                factor = Phi;
+                for (int i = 0; i < n; i++)
+                    factor[i * n + i] += shift;
+                shift *= 10.0;
+            }
+            for (int i = 0; i < n; i++)
+                v[i] = 1.0;
+            solveCholesky(n, &factor[0], &v[0]);
+            double sumV = 0.0;
+            for (int i = 0; i < n; i++)
+                sumV += v[i];
+
+            for (int q = patchEntriesPtr[p]; q < patchEntriesPtr[p + 1]; q++) {
+                int e = patchEntries[q];
+                const double *x = &(nodesB[entryNodes[e] * 3]);
+                for (int i = 0; i < n; i++)
+                    u[i] = wendlandC2(sqrt(MathLibrary::distanceSquare(x,
+                            &(nodesA[nodes[i] * 3]))) / support);
+                solveCholesky(n, &factor[0], &u[0]);
+                double sumU = 0.0;
+                for (int i = 0; i < n; i++)
+                    sumU += u[i];
+                for (int i = 0; i < n; i++) {
+                    cols[e * n + i] = nodes[i];
+                    values[e * n + i] = entryWeights[e] * (u[i] + (1.0 - sumU) / sumV * v[i]);
+                }
+            }
+        }
+    }
+
+    // 4. Merge the entries of the patches of every node of B into its row
+    vector<int> rowPtr(numNodesB + 1, 0);
+#pragma omp parallel num_threads(mapperSetNumThreads)
+    {
+        vector<pair<int, double> > row;
+#pragma omp for
+        for (int i = 0; i < numNodesB; i++) {
+            int begin = nodePatchesPtr[i] * n;
+            int end = nodePatchesPtr[i + 1] * n;
+            row.clear();
+            for (int j = begin; j < end; j++)
+                row.push_back(make_pair(cols[j], values[j]));
+            sort(row.begin(), row.end());
+            int count = 0;
+            for (int j = 0; j < row.size(); j++) {
+                if (count > 0 && cols[begin + count - 1] == row[j].first) {
+                    values[begin + count - 1] += row[j].second;
+                } else {
+                    cols[begin + count] = row[j].first;
+                    values[begin + count] = row[j].second;
+                    count++;
+                }
+            }
+            rowPtr[i + 1] = count;
+        }
+    }
+    for (int i = 0; i < numNodesB; i++)
+        rowPtr[i + 1] += rowPtr[i];
+    vector<int> rowCols(rowPtr[numNodesB]);
+    vector<double> rowValues(rowPtr[numNodesB]);
+#pragma omp parallel for num_threads(mapperSetNumThreads)
+    for (int i = 0; i < numNodesB; i++) {
+        int begin = nodePatchesPtr[i] * n;
+        for (int j = 0; j < rowPtr[i + 1] - rowPtr[i]; j++) {
+            rowCols[rowPtr[i] + j] = cols[begin + j];
+            rowValues[rowPtr[i] + j] = values[begin + j];
+        }
+    }
+    INFO_OUT() << "RBFMapper: " << numPatches << " patches of " << n << " nodes, "
+            << rowPtr[numNodesB] << " weights" << endl;
+
+    delete couplingMatrix;
+    couplingMatrix = DistributedCSRMatrix::create(numNodesB, numNodesA, rowPtr, rowCols,
+            rowValues, mapperSetNumThreads, isSinglePrecisionWeights,
+            MathLibrary::CSRMatrix::getProducts(isConsistentMappingUsed, isConservativeMappingUsed));
+#else
+    ERROR_OUT() << "Error in RBFMapper::buildCouplingMatrices" << endl;
+    ERROR_OUT() << "The RBF mapper needs the FLANN library!" << endl;
+    exit(-1);
+#endif
+}
+
+void RBFMapper::consistentMapping(const double *fieldA, double *fieldB) {
+    couplingMatrix->multiply(false, fieldA, fieldB);
+}
+
+void RBFMapper::conservativeMapping(const double *fieldB, double *fieldA) {
+    couplingMatrix->multiply(true, fieldB, fieldA);
+}
+
+void RBFMapper::consistentBlockMapping(const double *fieldA, double *fieldB, int numComponents) {
+    couplingMatrix->multiplyBlock(false, fieldA, fieldB, numComponents);
+}
+
+void RBFMapper::conservativeBlockMapping(const double *fieldB, double *fieldA, int numComponents) {
+    couplingMatrix->multiplyBlock(true, fieldB, fieldA, numComponents);
+}
+
+void RBFMapper::computeErrorsConsistentMapping(const double *_slaveField,
+        const double *_masterField) {
+    ERROR_OUT() << "Error computation for the RBF mapper has not been implemented" << endl;
+    exit(-1);
+}
+
+} /* namespace EMPIRE */
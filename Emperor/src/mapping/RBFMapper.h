@@ -0,0 +1,191 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file RBFMapper.h
+ * This file holds the class RBFMapper
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef RBFMAPPER_H_
+#define RBFMAPPER_H_
+
+#include <string>
+#include "AbstractMapper.h"
+
+namespace flann {
+template<typename Distance> class Index;
+template<class T> struct L2;
+template<typename T> class Matrix;
+}
+
+namespace EMPIRE {
+namespace MathLibrary {
+class CSRMatrix;
+}
+/********//**
+ * \brief Class RBFMapper interpolates by radial basis functions over a partition of unity. The
+ *        nodes of A are covered by overlapping spherical patches of numNodesPerPatch nodes each.
+ *        In every patch a small interpolation system of compactly supported Wendland C2 functions
+ *        with a constant polynomial is factorized, and a node of B is interpolated by the
+ *        interpolants of the patches containing it, blended by Wendland weights normalized to one.
+ *        The build therefore scales linearly with the number of nodes, and the weights are kept
+ *        as one sparse coupling matrix, so that a mapping is one product. Constant fields are
+ *        mapped exactly and conservative mapping preserves the sum of the field.
+ ***********/
+class RBFMapper : public AbstractMapper {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _numNodesA number of nodes of A
+     * \param[in] _nodesA nodes of A
+     * \param[in] _numNodesB number of nodes of B
+     * \param[in] _nodesB nodes of B
+     * \param[in] _numNodesPerPatch number of nodes of A in one patch
+     ***********/
+    RBFMapper(int _numNodesA, const double *_nodesA, int _numNodesB, const double *_nodesB,
+            int _numNodesPerPatch);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~RBFMapper();
+    /***********************************************************************************************
+     * \brief Build the patches, solve their interpolation systems and assemble the coupling matrix
+     ***********/
+    void buildCouplingMatrices();
+    /***********************************************************************************************
+     * \brief Use a searching tree owned by someone else, e.g. the spatial index of the mesh, instead
+     *        of building one. Must be called before buildCouplingMatrices
+     * \param[in] tree the FLANN searching tree over the nodes of A
+     ***********/
+    void setSharedSearchTree(flann::Index<flann::L2<double> > *tree);
+    /***********************************************************************************************
+     * \brief Get the heap memory of the coupling matrix
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+    /***********************************************************************************************
+     * \brief Get the number of patches of the last build
+     ***********/
+    int getNumPatches() const {
+        return numPatches;
+    }
+
+    /***********************************************************************************************
+     * \brief The weights can be stored in single precision
+     * \return true
+     ***********/
+    bool isSinglePrecisionWeightsSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Store the weights of the coupling matrix in single precision
+     * \param[in] singlePrecision true for single precision
+     ***********/
+    void setSinglePrecisionWeights(bool singlePrecision) {
+        isSinglePrecisionWeights = singlePrecision;
+    }
+    /***********************************************************************************************
+     * \brief The coupling matrix can be built for one direction only
+     * \return true
+     ***********/
+    bool isMappingDirectionsSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Keep only the arrays of the products of the used directions in the coupling matrix
+     * \param[in] consistent whether consistent mapping is used
+     * \param[in] conservative whether conservative mapping is used
+     ***********/
+    void setMappingDirections(bool consistent, bool conservative) {
+        isConsistentMappingUsed = consistent;
+        isConservativeMappingUsed = conservative;
+    }
+
+    /***********************************************************************************************
+     * \brief Do consistent mapping on fields (e.g. displacements or tractions)
+     * \param[in] fieldA the field of mesh A (e.g. x-displacements on all structure nodes)
+     * \param[out] fieldB the field of mesh B (e.g. x-displacements on all fluid nodes)
+     ***********/
+    void consistentMapping(const double *fieldA, double *fieldB);
+    /***********************************************************************************************
+     * \brief Do conservative mapping on integrated fields (e.g. forces)
+     * \param[in] fieldB the field of mesh B (e.g. x-forces on all fluid nodes)
+     * \param[out] fieldA the field of mesh A (e.g. x-forces on all structure nodes)
+     ***********/
+    void conservativeMapping(const double *fieldB, double *fieldA);
+    /***********************************************************************************************
+     * \brief Compute the mapping errors, not implemented
+     ***********/
+    void computeErrorsConsistentMapping(const double *fieldA, const double *fieldB);
+    /***********************************************************************************************
+     * \brief Block mapping is supported by this mapper
+     * \return true
+     ***********/
+    bool isBlockMappingSupported() const {
+        return true;
+    }
+    /***********************************************************************************************
+     * \brief Do consistent mapping on all components of interleaved fields at once
+     * \param[in] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[out] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void consistentBlockMapping(const double *fieldA, double *fieldB, int numComponents);
+    /***********************************************************************************************
+     * \brief Do conservative mapping on all components of interleaved integrated fields at once
+     * \param[in] fieldB the field of mesh B, component k of node i is fieldB[i * numComponents + k]
+     * \param[out] fieldA the field of mesh A, component k of node i is fieldA[i * numComponents + k]
+     * \param[in] numComponents the number of components per node
+     ***********/
+    void conservativeBlockMapping(const double *fieldB, double *fieldA, int numComponents);
+
+    /// defines number of threads used for mapper routines
+    static int mapperSetNumThreads;
+
+private:
+    /// number of nodes of A
+    int numNodesA;
+    /// nodes of A
+    const double *nodesA;
+    /// number of nodes of B
+    int numNodesB;
+    /// nodes of B
+    const double *nodesB;
+    /// number of nodes of A in one patch
+    int numNodesPerPatch;
+    /// number of patches of the last build
+    int numPatches;
+    /// whether the weights of the coupling matrix are stored in single precision
+    bool isSinglePrecisionWeights;
+    /// whether consistent mapping is used
+    bool isConsistentMappingUsed;
+    /// whether conservative mapping is used
+    bool isConservativeMappingUsed;
+    /// the weights as matrix B x A, analysed once for the mapping calls
+    MathLibrary::CSRMatrix *couplingMatrix;
+    /// searching tree over the nodes of A owned by someone else, NULL if the mapper builds its own
+    flann::Index<flann::L2<double> > *sharedSearchTree;
+    /// the factor from the patch radius to the support radius of the basis functions
+    static const double SUPPORT_FACTOR;
+    /// nodes of A within this fraction of the patch radius need no patch of their own
+    static const double COVER_FACTOR;
+};
+
+} /* namespace EMPIRE */
+#endif /* RBFMAPPER_H_ */
@@ -0,0 +1,267 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <algorithm>
+#include <utility>
+#include <omp.h>
+#include "AABBTree.h"
+
+namespace EMPIRE {
+
+using namespace std;
+
+/********//**
+ * \brief Orders box positions by one coordinate of the box centers
+ ***********/
+struct BoxCenterLess {
+    BoxCenterLess(const vector<AABB> &_boxes, int _axis) :
+            boxes(_boxes), axis(_axis) {
+    }
+    bool operator()(int boxA, int boxB) const {
+        return boxes[boxA][2 * axis] + boxes[boxA][2 * axis + 1]
+                < boxes[boxB][2 * axis] + boxes[boxB][2 * axis + 1];
+    }
+    const vector<AABB> &boxes;
+    int axis;
+};
+
+AABBTree::AABBTree(const vector<AABB> &_boxes) :
+        boxes(_boxes) {
+    const int numBoxes = boxes.size();
+    if (numBoxes == 0)
+        return;
+    sortedBoxIDs.resize(numBoxes);
+    for (int i = 0; i < numBoxes; i++)
+        sortedBoxIDs[i] = i;
+    nodes.reserve(2 * (numBoxes / LEAF_SIZE + 1));
+    build(0, numBoxes);
+}
+
+AABBTree::~AABBTree() {
+}
+
+void AABBTree::findBoxesIntersectingBox(const AABB &box, double offset,
+        vector<int> &boxIDs) const {
+    boxIDs.clear();
+    if (nodes.empty())
+        return;
+    vector<int> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node &node = nodes[stack.back()];
+        stack.pop_back();
+        if (!node.box.intersects(box, offset))
+            continue;
+        if (node.left >= 0) {
+            stack.push_back(node.left);
+            stack.push_back(node.right);
+            continue;
+        }
+        for (int i = node.first; i < node.first + node.count; i++)
+            if (boxes[sortedBoxIDs[i]].intersects(box, offset))
+                boxIDs.push_back(sortedBoxIDs[i]);
+    }
+}
+
+void AABBTree::findBoxesContainingPoint(const double *P, double offset,
+        vector<int> &boxIDs) const {
+    AABB box;
+    box.computeFromPoints(P, 1);
+    findBoxesIntersectingBox(box, offset, boxIDs);
+}
+
+void AABBTree::findIntersectingPairs(const AABBTree &treeA, const AABBTree &treeB,
+        double offset, int numThreads, vector<int> &pairsPtr, vector<int> &boxIDsB) {
+    const int numBoxesA = treeA.getNumBoxes();
+    pairsPtr.assign(numBoxesA + 1, 0);
+    boxIDsB.clear();
+    if (treeA.nodes.empty() || treeB.nodes.empty())
+        return;
+    if (numThreads < 1)
+        numThreads = 1;
+
+    // 1. split the pairs of nodes breadth first until there are enough pairs for the threads,
+    // every pair of leaves below the roots is reached on exactly one path
+    vector<pair<int, int> > tasks(1, pair<int, int>(0, 0));
+    const int minNumTasks = 16 * numThreads;
+    while ((int) tasks.size() < minNumTasks) {
+        vector<pair<int, int> > nextTasks;
+        bool isSplit = false;
+        for (size_t t = 0; t < tasks.size(); t++) {
+            const Node &nodeA = treeA.nodes[tasks[t].first];
+            const Node &nodeB = treeB.nodes[tasks[t].second];
+            if (!nodeA.box.intersects(nodeB.box, offset))
+                continue;
+            if (nodeA.left < 0 && nodeB.left < 0) {
+                nextTasks.push_back(tasks[t]);
+            } else if (isFirstSplit(nodeA, nodeB)) {
+                nextTasks.push_back(pair<int, int>(nodeA.left, tasks[t].second));
+                nextTasks.push_back(pair<int, int>(nodeA.right, tasks[t].second));
+                isSplit = true;
+            } else {
+                nextTasks.push_back(pair<int, int>(tasks[t].first, nodeB.left));
+                nextTasks.push_back(pair<int, int>(tasks[t].first, nodeB.right));
+                isSplit = true;
+            }
+        }
+        tasks.swap(nextTasks);
+        if (!isSplit)
+            break;
+    }
+
+    // 2. traverse the pairs of nodes, every thread collects the pairs of boxes in its own buffer
+    const int numTasks = tasks.size();
+    vector<vector<pair<int, int> > > buffers(numThreads);
+#pragma omp parallel num_threads(numThreads)
+    {
+        vector<pair<int, int> > &buffer = buffers[omp_get_thread_num()];
+        vector<pair<int, int> > stack;
+#pragma omp for schedule(dynamic, 1)
+        for (int t = 0; t < numTasks; t++) {
+            stack.push_back(tasks[t]);
+            while (!stack.empty()) {
+                int nodeIndexA = stack.back().first;
+                int nodeIndexB = stack.back().second;
+                stack.pop_back();
+                const Node &nodeA = treeA.nodes[nodeIndexA];
+                const Node &nodeB = treeB.nodes[nodeIndexB];
+                if (!nodeA.box.intersects(nodeB.box, offset))
+                    continue;
+                if (nodeA.left < 0 && nodeB.left < 0) {
+                    for (int i = nodeA.first; i < nodeA.first + nodeA.count; i++) {
+                        int boxIDA = treeA.sortedBoxIDs[i];
+                        for (int j = nodeB.first; j < nodeB.first + nodeB.count; j++) {
+                            int boxIDB = treeB.sortedBoxIDs[j];
+                            if (treeA.boxes[boxIDA].intersects(treeB.boxes[boxIDB], offset))
+                                buffer.push_back(pair<int, int>(boxIDA, boxIDB));
+                        }
+                    }
+                } else if (isFirstSplit(nodeA, nodeB)) {
+                    stack.push_back(pair<int, int>(nodeA.left, nodeIndexB));
+                    stack.push_back(pair<int, int>(nodeA.right, nodeIndexB));
+                } else {
+                    stack.push_back(pair<int, int>(nodeIndexA, nodeB.left));
+                    stack.push_back(pair<int, int>(nodeIndexA, nodeB.right));
+                }
+            }
+        }
+    }
+
+    // 3. sort the pairs by the boxes of treeA
+    for (int k = 0; k < numThreads; k++)
+        for (size_t p = 0; p < buffers[k].size(); p++)
+            pairsPtr[buffers[k][p].first + 1]++;
+    for (int i = 0; i < numBoxesA; i++)
+        pairsPtr[i + 1] += pairsPtr[i];
+    boxIDsB.resize(pairsPtr[numBoxesA]);
+    vector<int> pos(pairsPtr.begin(), pairsPtr.end() - 1);
+    for (int k = 0; k < numThreads; k++) {
+        for (size_t p = 0; p < buffers[k].size(); p++)
+            boxIDsB[pos[buffers[k][p].first]++] = buffers[k][p].second;
+        vector<pair<int, int> >().swap(buffers[k]);
+    }
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic, 64)
+    for (int i = 0; i < numBoxesA; i++)
+        sort(boxIDsB.begin() + pairsPtr[i], boxIDsB.begin() + pairsPtr[i + 1]);
+}
+
+bool AABBTree::isFirstSplit(const Node &nodeA, const Node &nodeB) {
+    if (nodeB.left < 0)
+        return true;
+    if (nodeA.left < 0)
+        return false;
+    double sizeA = 0.0;
+    double sizeB = 0.0;
+    for (int k = 0; k < 3; k++) {
+        sizeA += nodeA.box[2 * k + 1] - nodeA.box[2 * k];
+        sizeB += nodeB.box[2 * k + 1] - nodeB.box[2 * k];
+    }
+    return sizeA >= sizeB;
+}
+
+int AABBTree::build(int first, int count) {
+    int nodeIndex = nodes.size();
+    nodes.push_back(Node());
+    Node node;
+    node.left = -1;
+    node.right = -1;
+    node.first = first;
+    node.count = count;
+    node.box = boxes[sortedBoxIDs[first]];
+    for (int i = first + 1; i < first + count; i++)
+        node.box.extend(boxes[sortedBoxIDs[i]]);
+
+    if (count > LEAF_SIZE) {
+        int axis = 0;
+        for (int k = 1; k < 3; k++)
+            if (node.box[2 * k + 1] - node.box[2 * k]
+                    > node.box[2 * axis + 1] - node.box[2 * axis])
+                axis = k;
+        int half = count / 2;
+        nth_element(sortedBoxIDs.begin() + first, sortedBoxIDs.begin() + first + half,
+                sortedBoxIDs.begin() + first + count, BoxCenterLess(boxes, axis));
+        node.left = build(first, half);
+        node.right = build(first + half, count - half);
+    }
+    nodes[nodeIndex] = node;
+    return nodeIndex;
+}
+
+AABBTreeDistanceQuery::AABBTreeDistanceQuery(const AABBTree &_tree, const double *_P) :
+        tree(_tree) {
+    assert(_P != NULL);
+    for (int i = 0; i < 3; i++)
+        P[i] = _P[i];
+    if (!tree.nodes.empty())
+        push(tree.nodes[0].box, 0, false);
+}
+
+int AABBTreeDistanceQuery::next(double radius, double &distance) {
+    while (!queue.empty()) {
+        Entry entry = queue.top();
+        if (entry.distance > radius)
+            return -1;
+        queue.pop();
+        if (entry.isBox) {
+            distance = entry.distance;
+            return entry.index;
+        }
+        const AABBTree::Node &node = tree.nodes[entry.index];
+        if (node.left >= 0) {
+            push(tree.nodes[node.left].box, node.left, false);
+            push(tree.nodes[node.right].box, node.right, false);
+        } else {
+            for (int i = node.first; i < node.first + node.count; i++)
+                push(tree.boxes[tree.sortedBoxIDs[i]], tree.sortedBoxIDs[i], true);
+        }
+    }
+    return -1;
+}
+
+void AABBTreeDistanceQuery::push(const AABB &box, int index, bool isBox) {
+    Entry entry;
+    entry.distance = box.computeDistanceToPoint(P);
+    entry.index = index;
+    entry.isBox = isBox;
+    queue.push(entry);
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,185 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file AABBTree.h
+ * This file holds the class AABBTree and the class AABBTreeDistanceQuery
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef AABBTREE_H_
+#define AABBTREE_H_
+
+#include <vector>
+#include <queue>
+#include "BoundingBox.h"
+
+namespace EMPIRE {
+/********//**
+ * \brief Class AABBTree is a bounding volume hierarchy over a set of axis aligned bounding boxes,
+ *        e.g. the bounding boxes of the elements of a mesh. The boxes are split at the median of
+ *        their centers along the longest axis. All queries are thread safe.
+ ***********/
+class AABBTree {
+    friend class AABBTreeDistanceQuery;
+public:
+    /***********************************************************************************************
+     * \brief Constructor, builds the hierarchy
+     * \param[in] _boxes the boxes, they are copied. A box is identified by its position in _boxes
+     ***********/
+    AABBTree(const std::vector<AABB> &_boxes);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~AABBTree();
+    /***********************************************************************************************
+     * \brief Get the number of boxes
+     * \return the number of boxes
+     ***********/
+    inline int getNumBoxes() const {
+        return boxes.size();
+    }
+    /***********************************************************************************************
+     * \brief Get a box
+     * \param[in] boxID the position of the box
+     * \return the box
+     ***********/
+    inline const AABB &getBox(int boxID) const {
+        return boxes[boxID];
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory of the hierarchy
+     * \return the number of bytes
+     ***********/
+    inline size_t getMemory() const {
+        return boxes.capacity() * sizeof(AABB) + nodes.capacity() * sizeof(Node)
+                + sortedBoxIDs.capacity() * sizeof(int);
+    }
+    /***********************************************************************************************
+     * \brief Find all boxes intersecting the given box
+     * \param[in] box the box
+     * \param[in] offset the boxes of the tree are enlarged by offset in each direction
+     * \param[out] boxIDs the positions of the boxes found
+     ***********/
+    void findBoxesIntersectingBox(const AABB &box, double offset, std::vector<int> &boxIDs) const;
+    /***********************************************************************************************
+     * \brief Find all boxes containing the given point
+     * \param[in] P the point
+     * \param[in] offset the boxes of the tree are enlarged by offset in each direction
+     * \param[out] boxIDs the positions of the boxes found
+     ***********/
+    void findBoxesContainingPoint(const double *P, double offset, std::vector<int> &boxIDs) const;
+    /***********************************************************************************************
+     * \brief Find all pairs of intersecting boxes of two trees by traversing both hierarchies at
+     *        once. The pairs of nodes near the roots are shared among the threads, every pair of
+     *        boxes is found exactly once.
+     * \param[in] treeA the first tree
+     * \param[in] treeB the second tree
+     * \param[in] offset the boxes of treeA are enlarged by offset in each direction
+     * \param[in] numThreads the number of threads
+     * \param[out] pairsPtr the boxes of treeB intersecting box i of treeA are at the positions
+     *             pairsPtr[i] to pairsPtr[i+1]-1 of boxIDsB
+     * \param[out] boxIDsB the positions of the boxes of treeB, sorted for every box of treeA
+     ***********/
+    static void findIntersectingPairs(const AABBTree &treeA, const AABBTree &treeB, double offset,
+            int numThreads, std::vector<int> &pairsPtr, std::vector<int> &boxIDsB);
+
+private:
+    /// a node of the hierarchy
+    struct Node {
+        /// the box containing all boxes below this node
+        AABB box;
+        /// the child nodes, -1 for a leaf
+        int left, right;
+        /// the range of the leaf in sortedBoxIDs
+        int first, count;
+    };
+    /// maximum number of boxes in a leaf
+    static const int LEAF_SIZE = 4;
+    /// the boxes
+    std::vector<AABB> boxes;
+    /// the nodes, the root is the first one
+    std::vector<Node> nodes;
+    /// box positions sorted such that each leaf holds a contiguous range
+    std::vector<int> sortedBoxIDs;
+    /***********************************************************************************************
+     * \brief Build the hierarchy over the range [first, first+count) of sortedBoxIDs
+     * \param[in] first the first position in sortedBoxIDs
+     * \param[in] count the number of boxes
+     * \return the position of the new node in nodes
+     ***********/
+    int build(int first, int count);
+    /***********************************************************************************************
+     * \brief Decide which node of a pair of intersecting nodes is split, the larger inner node
+     * \param[in] nodeA the node of treeA
+     * \param[in] nodeB the node of treeB
+     * \return true if nodeA is split, false if nodeB is split
+     ***********/
+    static bool isFirstSplit(const Node &nodeA, const Node &nodeB);
+};
+
+/********//**
+ * \brief Class AABBTreeDistanceQuery returns the boxes of an AABBTree one after the other in
+ *        increasing distance to a point. The caller shrinks the search radius while it finds
+ *        better candidates, so that only the boxes close to the point are ever visited.
+ ***********/
+class AABBTreeDistanceQuery {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _tree the tree to be searched
+     * \param[in] _P the point
+     ***********/
+    AABBTreeDistanceQuery(const AABBTree &_tree, const double *_P);
+    /***********************************************************************************************
+     * \brief Get the next box
+     * \param[in] radius the search radius, boxes further away than radius are not returned
+     * \param[out] distance the distance from the point to the box returned
+     * \return the position of the box, -1 if there is no box left within radius
+     ***********/
+    int next(double radius, double &distance);
+
+private:
+    /// an entry of the priority queue, either a node of the tree or a box
+    struct Entry {
+        /// the distance from the point to the node or box
+        double distance;
+        /// the position of the node or box
+        int index;
+        /// whether index is a box or a node
+        bool isBox;
+        /// the queue pops the closest entry first
+        bool operator<(const Entry &other) const {
+            return distance > other.distance;
+        }
+    };
+    /// the tree
+    const AABBTree &tree;
+    /// the point
+    double P[3];
+    /// the nodes and boxes not visited yet
+    std::priority_queue<Entry> queue;
+    /***********************************************************************************************
+     * \brief Push a node or a box to the queue
+     ***********/
+    void push(const AABB &box, int index, bool isBox);
+};
+
+} /* namespace EMPIRE */
+#endif /* AABBTREE_H_ */
@@ -30,6 +30,7 @@ namespace EMPIRE {
 
 class Message;
 class IGAPatchSurface;
+class CouplingMatricesCache;
 /********//**
  * \brief Class AbstractCondition is the superclass of all other conditions
  ***********/
@@ -59,6 +60,24 @@ public:
      ***********/
     virtual void createGPData(const std::vector<IGAPatchSurface*>& _surfacePatches){};
 
+    /***********************************************************************************************
+     * \brief Store the GP data in a cache, such that a later run with the same mesh reads them
+     *        instead of creating them again
+     * \param[in] _cache The cache
+     * \param[in] _prefix The prefix of the names of the vectors in the cache, unique per condition
+     ***********/
+    virtual void writeGPDataToCache(CouplingMatricesCache* _cache, const std::string& _prefix) const {};
+
+    /***********************************************************************************************
+     * \brief Read the GP data stored by writeGPDataToCache
+     * \param[in] _cache The loaded cache
+     * \param[in] _prefix The prefix of the names of the vectors in the cache
+     * \return Whether the GP data are found, otherwise they must be created
+     ***********/
+    virtual bool readGPDataFromCache(const CouplingMatricesCache* _cache, const std::string& _prefix) {
+        return false;
+    };
+
     /// type of the condition
     EMPIRE_Condition_type type;
 };
@@ -21,6 +21,7 @@
 #include "AbstractMesh.h"
 #include "Message.h"
 #include "DataField.h"
+#include "CouplingMatricesCache.h"
 #include <iostream>
 #include <assert.h>
 
@@ -29,7 +30,7 @@ using namespace std;
 namespace EMPIRE {
 
 AbstractMesh::AbstractMesh(std::string _name) :
-        name(_name) {
+        name(_name), contentHash(0), isContentHashComputed(false) {
 }
 
 AbstractMesh::~AbstractMesh() {
@@ -45,4 +46,25 @@ DataField *AbstractMesh::getDataFieldByName(std::string dataFieldName) {
     return nameToDataFieldMap.at(dataFieldName);
 }
 
+MemoryUsage AbstractMesh::getMemoryUsage() const {
+    MemoryUsage usage;
+    for (map<string, DataField*>::const_iterator it = nameToDataFieldMap.begin();
+            it != nameToDataFieldMap.end(); it++) {
+        const DataField *dataField = it->second;
+        usage.add("data fields", (size_t) dataField->numLocations * dataField->dimension * sizeof(double));
+    }
+    return usage;
+}
+
+uint64_t AbstractMesh::getContentHash() {
+    if (!isContentHashComputed)
+        updateContentHash();
+    return contentHash;
+}
+
+void AbstractMesh::updateContentHash() {
+    contentHash = CouplingMatricesCache::hashMeshContent(this);
+    isContentHashComputed = true;
+}
+
 } /* namespace EMPIRE */
@@ -24,8 +24,10 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <stdint.h>
 #include "EMPEROR_Enum.h"
 #include "BoundingBox.h"
+#include "MemoryUsage.h"
 
 namespace EMPIRE {
 
@@ -69,6 +71,25 @@ public:
      * \author Tianyang Wang
      ***********/
     virtual void computeBoundingBox() = 0;
+    /***********************************************************************************************
+     * \brief Get the heap memory of the mesh broken down by its components, the subclasses add
+     *        their geometry to the data fields counted here
+     ***********/
+    virtual MemoryUsage getMemoryUsage() const;
+    /***********************************************************************************************
+     * \brief Get the hash of the content of the mesh, i.e. the nodes and elements of a FE mesh or
+     *        the knots, control points, trimming loops and weak conditions of an IGA mesh. Two
+     *        meshes with equal hashes are taken as equal, so that the mappers, the coupling matrices
+     *        cache and the daemon reuse the operators of a mesh which is sent again unchanged.
+     *        The hash is computed at the first call, see updateContentHash.
+     * \return the hash
+     ***********/
+    uint64_t getContentHash();
+    /***********************************************************************************************
+     * \brief Compute the hash of the content again, it must be called after the mesh is changed,
+     *        e.g. the client code calls it when the mesh has arrived
+     ***********/
+    void updateContentHash();
 
     /// name of the mesh
     const std::string name;
@@ -79,6 +100,12 @@ public:
 
     /// the boundingBox of the mesh
     AABB boundingBox;
+
+private:
+    /// the hash of the content, valid if isContentHashComputed
+    uint64_t contentHash;
+    /// whether contentHash has been computed
+    bool isContentHashComputed;
 };
 
 } /* namespace EMPIRE */
@@ -21,6 +21,8 @@
 
 #include "BoundingBox.h"
 #include <assert.h>
+#include <math.h>
+#include <algorithm>
 
 namespace EMPIRE {
 
@@ -51,6 +53,52 @@ bool AABB::isPointInside(const double* P, double offset) const {
 	return false;
 }
 
+bool AABB::intersects(const AABB &other, double offset) const {
+	for (int i = 0; i < 3; i++) {
+		if (box[2 * i] - offset > other.box[2 * i + 1]
+				|| box[2 * i + 1] + offset < other.box[2 * i])
+			return false;
+	}
+	return true;
+}
+
+double AABB::computeDistanceToPoint(const double* P) const {
+	assert(P != NULL);
+	double distanceSquare = 0.0;
+	for (int i = 0; i < 3; i++) {
+		double d = 0.0;
+		if (P[i] < box[2 * i])
+			d = box[2 * i] - P[i];
+		else if (P[i] > box[2 * i + 1])
+			d = P[i] - box[2 * i + 1];
+		distanceSquare += d * d;
+	}
+	return sqrt(distanceSquare);
+}
+
+void AABB::computeFromPoints(const double* points, int numPoints) {
+	assert(points != NULL);
+	assert(numPoints > 0);
+	for (int i = 0; i < 3; i++) {
+		box[2 * i] = points[i];
+		box[2 * i + 1] = points[i];
+	}
+	for (int j = 1; j < numPoints; j++) {
+		for (int i = 0; i < 3; i++) {
+			box[2 * i] = std::min(box[2 * i], points[j * 3 + i]);
+			box[2 * i + 1] = std::max(box[2 * i + 1], points[j * 3 + i]);
+		}
+	}
+	flagComputed = true;
+}
+
+void AABB::extend(const AABB &other) {
+	for (int i = 0; i < 3; i++) {
+		box[2 * i] = std::min(box[2 * i], other.box[2 * i]);
+		box[2 * i + 1] = std::max(box[2 * i + 1], other.box[2 * i + 1]);
+	}
+}
+
 Message &operator<<(Message &message, AABB &boundingBox) {
 	using std::endl;
     message << "\t+" << "Axis Aligned Bounding box: " << endl;
@@ -50,6 +50,30 @@ public:
 	virtual ~AABB();
 
 	bool isPointInside(const double* P, double offset=0) const;
+	/***********************************************************************************************
+	 * \brief Check whether this box intersects another box
+	 * \param[in] other the other box
+	 * \param[in] offset this box is enlarged by offset in each direction
+	 * \return true if the boxes intersect
+	 ***********/
+	bool intersects(const AABB &other, double offset=0) const;
+	/***********************************************************************************************
+	 * \brief Compute the euclidean distance from a point to this box, 0 if the point is inside
+	 * \param[in] P the point
+	 * \return the distance
+	 ***********/
+	double computeDistanceToPoint(const double* P) const;
+	/***********************************************************************************************
+	 * \brief Set this box to the smallest box containing all given points
+	 * \param[in] points x,y,z coordinates of the points
+	 * \param[in] numPoints the number of points (at least 1)
+	 ***********/
+	void computeFromPoints(const double* points, int numPoints);
+	/***********************************************************************************************
+	 * \brief Enlarge this box such that it contains another box
+	 * \param[in] other the other box
+	 ***********/
+	void extend(const AABB &other);
 
 	inline double getXmin() const {return box[0];}
 	inline double getXmax() const {return box[1];}
@@ -19,7 +19,10 @@
  *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
  */
 #include "DataField.h"
+#include "NumaMemory.h"
+#include "AuxiliaryParameters.h"
 #include <fstream>
+#include <assert.h>
 
 namespace EMPIRE {
 using namespace std;
@@ -27,11 +30,84 @@ using namespace std;
 DataField::DataField(std::string _name, EMPIRE_DataField_location _location, int _numLocations,
         EMPIRE_DataField_dimension _dimension, EMPIRE_DataField_typeOfQuantity _typeOfQuantity) :
         name(_name), location(_location), numLocations(_numLocations), dimension(_dimension), typeOfQuantity(
-                _typeOfQuantity), data(new double[_numLocations * _dimension]) {
+                _typeOfQuantity), data(
+                NumaMemory::allocateArray<double>((size_t) _numLocations * _dimension)), aliasSource(
+                NULL), latestHistory(-1), numHistoryLevels(0) {
+    for (int i = 0; i < DataHistory::NUM_RATES; i++)
+        histories[i] = NULL;
+    // zeroed by the threads of the mappers, which read and write the data later on
+    NumaMemory::firstTouch(data, (size_t) numLocations * dimension,
+            AuxiliaryParameters::mapperSetNumThreads);
 }
 
 DataField::~DataField() {
-    delete[] data;
+    if (!isAlias())
+        NumaMemory::deallocate(data);
+    for (int i = 0; i < DataHistory::NUM_RATES; i++)
+        delete histories[i];
+}
+
+void DataField::aliasData(const DataField *source) {
+    assert(source != this);
+    assert(source->numLocations * source->dimension == numLocations * dimension);
+    if (!isAlias())
+        NumaMemory::deallocate(data);
+    data = source->data;
+    aliasSource = source;
+}
+
+DataHistory *DataField::getHistory(DataHistory::Rate rate) {
+    if (histories[rate] == NULL)
+        histories[rate] = new DataHistory(numLocations * dimension);
+    return histories[rate];
+}
+
+void DataField::setHistoryLength(int historyLength) {
+    assert(historyLength >= 2);
+    assert(historyTags.size() == 0);
+    getHistory(DataHistory::TIME_LEVEL)->reserve(historyLength);
+    historyTags.assign(historyLength, 0);
+    historyTimes.assign(historyLength, 0.0);
+    latestHistory = -1;
+    numHistoryLevels = 0;
+}
+
+void DataField::storeHistory(double time) {
+    int historyLength = historyTags.size();
+    assert(historyLength > 0);
+    DataHistory *history = histories[DataHistory::TIME_LEVEL];
+    if (numHistoryLevels == 0 || historyTimes[latestHistory] != time) {
+        assert(numHistoryLevels == 0 || historyTimes[latestHistory] < time);
+        latestHistory = (latestHistory + 1) % historyLength;
+        if (numHistoryLevels < historyLength)
+            numHistoryLevels++;
+        historyTags[latestHistory] = DataHistory::newTag();
+        historyTimes[latestHistory] = time;
+        history->snapshot(data, historyTags[latestHistory]);
+    } else {
+        history->replace(data, historyTags[latestHistory]);
+    }
+}
+
+void DataField::interpolateHistory(double time) {
+    assert(numHistoryLevels > 0);
+    int historyLength = historyTags.size();
+    int size = numLocations * dimension;
+    const DataHistory *history = histories[DataHistory::TIME_LEVEL];
+    const double *latest = history->find(historyTags[latestHistory]);
+    assert(latest != NULL);
+    if (numHistoryLevels == 1) {
+        for (int i = 0; i < size; i++)
+            data[i] = latest[i];
+        return;
+    }
+    int previousHistory = (latestHistory - 1 + historyLength) % historyLength;
+    const double *previous = history->find(historyTags[previousHistory]);
+    assert(previous != NULL);
+    double weight = (time - historyTimes[previousHistory])
+            / (historyTimes[latestHistory] - historyTimes[previousHistory]);
+    for (int i = 0; i < size; i++)
+        data[i] = previous[i] + weight * (latest[i] - previous[i]);
 }
 
 void DataField::writeToFile(std::string name,std::string header, std::string footer){
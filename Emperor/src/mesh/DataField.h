@@ -28,8 +28,10 @@
 #define DATAFIELD_H_
 
 #include <string>
+#include <vector>
 #include "EMPEROR_Enum.h"
 #include "Message.h"
+#include "DataHistory.h"
 
 namespace EMPIRE {
 
@@ -60,6 +62,48 @@ public:
      * \author Aditya Ghantasala
      ***********/
      void writeToFile(std::string _name,std::string _header, std::string _footer);
+    /***********************************************************************************************
+     * \brief Share the data storage of another data field of the same size instead of an own one,
+     *        such that copying from it costs nothing. The own storage is released.
+     * \param[in] source the data field whose storage is used, it must outlive the use of this one
+     ***********/
+    void aliasData(const DataField *source);
+    /***********************************************************************************************
+     * \brief Check whether the data storage is shared with another data field by aliasData()
+     ***********/
+    bool isAlias() const {
+        return aliasSource != NULL;
+    }
+    /***********************************************************************************************
+     * \brief Get the history of the data taken at the given rate, shared by all its consumers
+     * \param[in] rate the rate of the snapshots
+     * \return the history, created at the first call
+     ***********/
+    DataHistory *getHistory(DataHistory::Rate rate);
+    /***********************************************************************************************
+     * \brief Keep the data of the latest time levels in the time level history for the
+     *        interpolation in time
+     * \param[in] historyLength the number of time levels kept, at least 2
+     ***********/
+    void setHistoryLength(int historyLength);
+    /***********************************************************************************************
+     * \brief Get the number of time levels kept, 0 if no history is kept
+     ***********/
+    int getHistoryLength() const {
+        return historyTags.size();
+    }
+    /***********************************************************************************************
+     * \brief Store the data as a new time level, which replaces the oldest one. The latest time
+     *        level is replaced if it has the same time, e.g. in the iterations of a time step.
+     * \param[in] time the time of the data, later than the time of the latest time level
+     ***********/
+    void storeHistory(double time);
+    /***********************************************************************************************
+     * \brief Set the data to the linear interpolation in time between the two latest time levels,
+     *        or to the latest time level if only one is stored
+     * \param[in] time the time of the interpolated data
+     ***********/
+    void interpolateHistory(double time);
 
     /// name of the data field
     const std::string name;
@@ -71,9 +115,22 @@ public:
     const EMPIRE_DataField_dimension dimension;
     /// typeOfQuantity could be field or fieldIntegral
     const EMPIRE_DataField_typeOfQuantity typeOfQuantity;
-    /// pointer to the data storage
-    double * const data;
+    /// pointer to the data storage, owned by aliasSource if aliased
+    double *data;
 
+private:
+    /// the data field whose storage is shared, NULL if the storage is owned
+    const DataField *aliasSource;
+    /// the histories of the data for every rate, NULL until requested
+    DataHistory *histories[DataHistory::NUM_RATES];
+    /// the snapshot tag of every time level, a ring of the latest time levels
+    std::vector<long long> historyTags;
+    /// the time of every time level
+    std::vector<double> historyTimes;
+    /// position of the latest time level in the ring
+    int latestHistory;
+    /// number of time levels in the ring
+    int numHistoryLevels;
 };
 
 /***********************************************************************************************
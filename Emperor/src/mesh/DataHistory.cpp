@@ -0,0 +1,101 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "DataHistory.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+namespace EMPIRE {
+
+/// Alignment of the snapshots, a cache line
+static const int HISTORY_ALIGNMENT = 64;
+
+long long DataHistory::lastTag = 0;
+
+DataHistory::DataHistory(int _size) :
+        size(_size), capacity(0), snapshots(NULL), latest(-1), numSnapshots(0) {
+    assert(size > 0);
+    int valuesPerLine = HISTORY_ALIGNMENT / sizeof(double);
+    stride = (size + valuesPerLine - 1) / valuesPerLine * valuesPerLine;
+}
+
+DataHistory::~DataHistory() {
+    free(snapshots);
+}
+
+void DataHistory::reserve(int numSnapshots) {
+    assert(numSnapshots > 0);
+    assert(snapshots == NULL);
+    capacity += numSnapshots;
+}
+
+const double *DataHistory::snapshot(const double *data, long long tag) {
+    const double *existing = find(tag);
+    if (existing != NULL)
+        return existing;
+    if (snapshots == NULL) {
+        assert(capacity > 0);
+        void *memory = NULL;
+        int error = posix_memalign(&memory, HISTORY_ALIGNMENT,
+                (size_t) capacity * stride * sizeof(double));
+        assert(error == 0);
+        snapshots = static_cast<double*>(memory);
+        tags.assign(capacity, 0);
+    }
+    latest = (latest + 1) % capacity;
+    if (numSnapshots < capacity)
+        numSnapshots++;
+    tags[latest] = tag;
+    double *snapshot = snapshots + (size_t) latest * stride;
+    memcpy(snapshot, data, size * sizeof(double));
+    return snapshot;
+}
+
+const double *DataHistory::replace(const double *data, long long tag) {
+    for (int k = 0; k < numSnapshots; k++) {
+        int position = (latest - k + capacity) % capacity;
+        if (tags[position] == tag) {
+            double *snapshot = snapshots + (size_t) position * stride;
+            memcpy(snapshot, data, size * sizeof(double));
+            return snapshot;
+        }
+    }
+    return snapshot(data, tag);
+}
+
+const double *DataHistory::find(long long tag) const {
+    // the latest snapshots are searched first, they are the ones shared
+    for (int k = 0; k < numSnapshots; k++) {
+        int position = (latest - k + capacity) % capacity;
+        if (tags[position] == tag)
+            return snapshots + (size_t) position * stride;
+    }
+    return NULL;
+}
+
+long long DataHistory::newTag() {
+    long long tag;
+#pragma omp atomic capture
+    tag = ++lastTag;
+    return tag;
+}
+
+} /* namespace EMPIRE */
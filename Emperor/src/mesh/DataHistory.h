@@ -0,0 +1,139 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file DataHistory.h
+ * This file holds the class DataHistory
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef DATAHISTORY_H_
+#define DATAHISTORY_H_
+
+#include <vector>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class DataHistory is a ring of snapshots of the data of a data field or signal, shared by
+ *        all consumers which keep past values of it (extrapolators, coupling algorithms, residuals,
+ *        the multirate time levels). Every snapshot is tagged, a snapshot with a tag that is
+ *        already in the ring is shared instead of copied again. Each consumer reserves the number
+ *        of snapshots it needs before the first snapshot, so the ring is allocated once and a new
+ *        snapshot overwrites the oldest one. The snapshots are aligned to cache lines.
+ ***********/
+class DataHistory {
+public:
+    /********//**
+     * \brief The rates at which the consumers take snapshots, consumers of the same rate share one
+     *        ring such that the latest snapshots of each consumer stay in it
+     ***********/
+    enum Rate {
+        /// once per time step
+        TIME_STEP,
+        /// once per iteration of a time step
+        ITERATION,
+        /// once per time level received by a multirate connection
+        TIME_LEVEL,
+        /// number of rates
+        NUM_RATES
+    };
+    /***********************************************************************************************
+     * \brief Constructor, nothing is allocated before the first snapshot
+     * \param[in] _size the number of values of a snapshot
+     ***********/
+    DataHistory(int _size);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~DataHistory();
+    /***********************************************************************************************
+     * \brief Reserve the snapshots of a consumer, must be called before the first snapshot
+     * \param[in] numSnapshots the number of latest snapshots the consumer reads
+     ***********/
+    void reserve(int numSnapshots);
+    /***********************************************************************************************
+     * \brief Take a snapshot of the data, which overwrites the oldest snapshot. Nothing is copied
+     *        if a snapshot with the same tag is in the ring already.
+     * \param[in] data the data, size values
+     * \param[in] tag the tag of the snapshot, from newTag()
+     * \return the snapshot, valid until the ring wraps around
+     ***********/
+    const double *snapshot(const double *data, long long tag);
+    /***********************************************************************************************
+     * \brief Overwrite the snapshot with the given tag by the data, or take a new one if it is not
+     *        in the ring
+     * \param[in] data the data, size values
+     * \param[in] tag the tag of the snapshot
+     * \return the snapshot
+     ***********/
+    const double *replace(const double *data, long long tag);
+    /***********************************************************************************************
+     * \brief Find the snapshot with the given tag
+     * \param[in] tag the tag
+     * \return the snapshot, NULL if it was overwritten or never taken
+     ***********/
+    const double *find(long long tag) const;
+    /***********************************************************************************************
+     * \brief Get the number of values of a snapshot
+     ***********/
+    int getSize() const {
+        return size;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of snapshots reserved by all consumers
+     ***********/
+    int getCapacity() const {
+        return capacity;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of snapshots taken so far, at most the capacity
+     ***********/
+    int getNumSnapshots() const {
+        return numSnapshots;
+    }
+    /***********************************************************************************************
+     * \brief Get a new tag, unique in the process
+     ***********/
+    static long long newTag();
+
+private:
+    /// the number of values of a snapshot
+    const int size;
+    /// the distance between two snapshots, size rounded up to whole cache lines
+    int stride;
+    /// the number of snapshots in the ring
+    int capacity;
+    /// the snapshots, capacity x stride values, allocated at the first snapshot
+    double *snapshots;
+    /// the tag of every snapshot
+    std::vector<long long> tags;
+    /// position of the latest snapshot
+    int latest;
+    /// the number of snapshots taken, at most the capacity
+    int numSnapshots;
+    /// the last tag returned by newTag()
+    static long long lastTag;
+    /// disallow copy constructor
+    DataHistory(const DataHistory&);
+    /// disallow assignment operator
+    DataHistory& operator=(const DataHistory&);
+};
+
+} /* namespace EMPIRE */
+#endif /* DATAHISTORY_H_ */
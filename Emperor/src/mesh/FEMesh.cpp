@@ -25,6 +25,13 @@
 #include "Message.h"
 #include "DataField.h"
 #include "TriangulatorAdaptor.h"
+#include "FEMeshSpatialIndex.h"
+#include "FEMeshConnectivity.h"
+#include "FEMeshGeometry.h"
+#include "IDToIndexMap.h"
+#include "NumaMemory.h"
+#include "AuxiliaryParameters.h"
+#include "SpaceFillingCurve.h"
 
 namespace EMPIRE {
 
@@ -34,7 +41,10 @@ FEMesh::FEMesh(std::string _name, int _numNodes, int _numElems, bool _triangulat
         AbstractMesh(_name), numNodes(_numNodes), numElems(_numElems) {
     type = EMPIRE_Mesh_FEMesh;
     boundingBox.isComputed(false);
-    nodes = new double[numNodes * 3];
+    nodes = NumaMemory::allocateArray<double>((size_t) numNodes * 3);
+    // the nodes are read by all threads of the mappers
+    if (AuxiliaryParameters::numaInterleave)
+        NumaMemory::interleave(nodes, numNodes * 3 * sizeof(double));
     nodeIDs = new int[numNodes];
     numNodesPerElem = new int[numElems];
     elems = NULL;
@@ -46,16 +56,24 @@ FEMesh::FEMesh(std::string _name, int _numNodes, int _numElems, bool _triangulat
     tobeTriangulated = false;
     triangulateAll = _triangulateAll;
     triangulatedMesh = NULL;
+    spatialIndex = NULL;
+    connectivity = NULL;
+    elemGeometry = NULL;
+    nodeIndex = NULL;
 }
 
 FEMesh::~FEMesh() {
-    delete[] nodes;
+    NumaMemory::deallocate(nodes);
     delete[] nodeIDs;
     delete[] numNodesPerElem;
     delete[] elems;
     delete[] elemIDs;
     if (triangulatedMesh != NULL)
         delete triangulatedMesh;
+    delete spatialIndex;
+    delete connectivity;
+    delete elemGeometry;
+    delete nodeIndex;
 }
 
 void FEMesh::initElems() {
@@ -97,118 +115,268 @@ FEMesh *FEMesh::triangulate() {
     if (triangulatedMesh != NULL)
         return triangulatedMesh;
 
-    map<int, int> *nodeIDToNodePosMap = new map<int, int>;
-    for (int i = 0; i < numNodes; i++)
-        nodeIDToNodePosMap->insert(nodeIDToNodePosMap->end(), pair<int, int>(nodeIDs[i], i));
+    const IDToIndexMap *nodeIDToNodePosMap = getNodeIndex();
 
-    vector<int> *elemsTri = new vector<int>;
-    vector<int> *numNodesPerElemTri = new vector<int>;
-    int count = 0;
-	bool isCompletelyTriangulated;
+    // the triangles of every element are counted first, so that the elements are triangulated in parallel
+    vector<int> elemOffsets(numElems + 1, 0);
+    vector<int> elemOffsetsTri(numElems + 1, 0); // the first triangulated element of every element
+    vector<int> elemsOffsetsTri(numElems + 1, 0); // the position of its nodes in the triangulated elems
     for (int i = 0; i < numElems; i++) {
         int numNodesThisElem = numNodesPerElem[i];
-        if (numNodesThisElem == 3) { // put triangles in the new mesh
-            numNodesPerElemTri->push_back(numNodesThisElem);
-            for (int j = 0; j < numNodesThisElem; j++)
-                elemsTri->push_back(elems[count + j]);
-        } else if ((numNodesThisElem == 4) && (!triangulateAll)) { // if not triangulateAll, put quads in the new mesh
-                numNodesPerElemTri->push_back(numNodesThisElem);
-                for (int j = 0; j < numNodesThisElem; j++)
-                    elemsTri->push_back(elems[count + j]);
-        } else {
-            // use third party triangulation algorithm
-            TriangulatorAdaptor *triangulator = new TriangulatorAdaptor();
-            for (int j = 0; j < numNodesThisElem; j++) {
-                int nodeID = elems[count + j];
-                int nodePos = nodeIDToNodePosMap->at(nodeID);
-                double x = nodes[nodePos * 3 + 0];
-                double y = nodes[nodePos * 3 + 1];
-                double z = nodes[nodePos * 3 + 2];
-                triangulator->addPoint(x, y, z);
-            }
-            int numTriangles = numNodesThisElem - 2;
-            int triangleIndexes[numTriangles * 3];
-            isCompletelyTriangulated = triangulator->triangulate(triangleIndexes);
-            for (int j = 0; j < numTriangles; j++) {
-                numNodesPerElemTri->push_back(3);
-                for (int k = 0; k < 3; k++) {
-                    int nodeID = elems[count + triangleIndexes[j * 3 + k]];
-                    elemsTri->push_back(nodeID);
-                }
-            }
-            delete triangulator;
-        }
-        count += numNodesThisElem;
+        // triangles and, if not triangulateAll, quads are put in the new mesh as they are
+        bool isKept = (numNodesThisElem == 3) || ((numNodesThisElem == 4) && (!triangulateAll));
+        elemOffsets[i + 1] = elemOffsets[i] + numNodesThisElem;
+        elemOffsetsTri[i + 1] = elemOffsetsTri[i] + (isKept ? 1 : numNodesThisElem - 2);
+        elemsOffsetsTri[i + 1] = elemsOffsetsTri[i] + (isKept ? numNodesThisElem : 3 * (numNodesThisElem - 2));
     }
-	assert(isCompletelyTriangulated==true);
-    delete nodeIDToNodePosMap;
-    assert(count == elemsArraySize);
+    assert(elemOffsets[numElems] == elemsArraySize);
 
-    triangulatedMesh = new FEMesh(name + "_triangulated", numNodes, numNodesPerElemTri->size());
+    triangulatedMesh = new FEMesh(name + "_triangulated", numNodes, elemOffsetsTri[numElems]);
     for (int i = 0; i < numNodes; i++) {
         triangulatedMesh->nodeIDs[i] = nodeIDs[i];
     }
     for (int i = 0; i < numNodes * 3; i++) {
         triangulatedMesh->nodes[i] = nodes[i];
     }
-    for (int i = 0; i < numNodesPerElemTri->size(); i++) {
-        triangulatedMesh->numNodesPerElem[i] = numNodesPerElemTri->at(i);
+    for (int i = 0; i < numElems; i++) {
+        bool isKept = elemOffsetsTri[i + 1] - elemOffsetsTri[i] == 1;
+        for (int j = elemOffsetsTri[i]; j < elemOffsetsTri[i + 1]; j++)
+            triangulatedMesh->numNodesPerElem[j] = isKept ? numNodesPerElem[i] : 3;
     }
     triangulatedMesh->initElems();
-    for (int i = 0; i < triangulatedMesh->elemsArraySize; i++) {
-        triangulatedMesh->elems[i] = elemsTri->at(i);
-    }
 
-    delete numNodesPerElemTri;
-    delete elemsTri;
+    int isCompletelyTriangulated = 1;
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads) schedule(dynamic, 256) \
+        reduction(&&:isCompletelyTriangulated)
+    for (int i = 0; i < numElems; i++) {
+        int numNodesThisElem = numNodesPerElem[i];
+        const int *elem = &elems[elemOffsets[i]];
+        int *elemTri = &triangulatedMesh->elems[elemsOffsetsTri[i]];
+        if (elemOffsetsTri[i + 1] - elemOffsetsTri[i] == 1 && numNodesThisElem <= 4) {
+            for (int j = 0; j < numNodesThisElem; j++)
+                elemTri[j] = elem[j];
+            continue;
+        }
+        // use third party triangulation algorithm
+        TriangulatorAdaptor triangulator;
+        for (int j = 0; j < numNodesThisElem; j++) {
+            int nodePos = nodeIDToNodePosMap->at(elem[j]);
+            triangulator.addPoint(nodes[nodePos * 3 + 0], nodes[nodePos * 3 + 1], nodes[nodePos * 3 + 2]);
+        }
+        int numTriangles = numNodesThisElem - 2;
+        int triangleIndexes[numTriangles * 3];
+        isCompletelyTriangulated = triangulator.triangulate(triangleIndexes) && isCompletelyTriangulated;
+        for (int j = 0; j < numTriangles * 3; j++)
+            elemTri[j] = elem[triangleIndexes[j]];
+    }
+    assert(isCompletelyTriangulated);
     assert(triangulatedMesh->tobeTriangulated == false);
     return triangulatedMesh;
 }
 
+void FEMesh::prepare() {
+    assert(elems != NULL);
+    validateMesh();
+    computeBoundingBox();
+    getNodeIndex();
+    getConnectivity();
+    getElemGeometry();
+    getSpatialIndex()->getElemBoundingBoxes();
+    if (triangulate() != NULL)
+        triangulatedMesh->prepare();
+}
+
+FEMeshSpatialIndex *FEMesh::getSpatialIndex() {
+    if (spatialIndex == NULL)
+        spatialIndex = new FEMeshSpatialIndex(this);
+    return spatialIndex;
+}
+
+const FEMeshConnectivity *FEMesh::getConnectivity() {
+    assert(elems != NULL);
+    if (connectivity == NULL)
+        connectivity = new FEMeshConnectivity(*getNodeIndex(), numElems, numNodesPerElem, elems);
+    return connectivity;
+}
+
+const FEMeshGeometry *FEMesh::getElemGeometry() {
+    if (elemGeometry == NULL)
+        elemGeometry = new FEMeshGeometry(numElems, numNodesPerElem, nodes, getConnectivity(),
+                AuxiliaryParameters::mapperSetNumThreads);
+    return elemGeometry;
+}
+
+const IDToIndexMap *FEMesh::getNodeIndex() {
+    if (nodeIndex == NULL)
+        nodeIndex = new IDToIndexMap(numNodes, nodeIDs);
+    return nodeIndex;
+}
+
+void FEMesh::renumber(EMPIRE_Mesh_renumbering renumbering) {
+    if (renumbering == EMPIRE_Mesh_noRenumbering)
+        return;
+    assert(elems != NULL);
+    assert(nameToDataFieldMap.empty());
+    assert(!isRenumbered());
+    assert(triangulatedMesh == NULL && spatialIndex == NULL && connectivity == NULL
+            && elemGeometry == NULL);
+    SpaceFillingCurve::Type curve = (renumbering == EMPIRE_Mesh_hilbertRenumbering) ?
+            SpaceFillingCurve::HILBERT : SpaceFillingCurve::MORTON;
+
+    // the element centroids by the node positions of the client, elems holds IDs and stays valid
+    const IDToIndexMap *clientNodeIndex = getNodeIndex();
+    vector<double> centroids(numElems * 3, 0.0);
+    vector<int> elemOffsets(numElems + 1, 0);
+    for (int i = 0; i < numElems; i++)
+        elemOffsets[i + 1] = elemOffsets[i] + numNodesPerElem[i];
+    for (int i = 0; i < numElems; i++) {
+        for (int j = elemOffsets[i]; j < elemOffsets[i + 1]; j++) {
+            int nodePos = clientNodeIndex->at(elems[j]);
+            for (int k = 0; k < 3; k++)
+                centroids[i * 3 + k] += nodes[nodePos * 3 + k];
+        }
+        for (int k = 0; k < 3; k++)
+            centroids[i * 3 + k] /= numNodesPerElem[i];
+    }
+    delete nodeIndex;
+    nodeIndex = NULL;
+
+    vector<int> nodeOrder;
+    SpaceFillingCurve::computeOrder(curve, numNodes, nodes, nodeOrder);
+    vector<double> oldNodes(nodes, nodes + numNodes * 3);
+    vector<int> oldNodeIDs(nodeIDs, nodeIDs + numNodes);
+    clientNodeToNodePos.resize(numNodes);
+    for (int i = 0; i < numNodes; i++) {
+        int oldPos = nodeOrder[i];
+        for (int k = 0; k < 3; k++)
+            nodes[i * 3 + k] = oldNodes[oldPos * 3 + k];
+        nodeIDs[i] = oldNodeIDs[oldPos];
+        clientNodeToNodePos[oldPos] = i;
+    }
+
+    vector<int> elemOrder;
+    SpaceFillingCurve::computeOrder(curve, numElems, &centroids[0], elemOrder);
+    vector<int> oldNumNodesPerElem(numNodesPerElem, numNodesPerElem + numElems);
+    vector<int> oldElems(elems, elems + elemsArraySize);
+    vector<int> oldElemIDs(elemIDs, elemIDs + numElems);
+    clientElemToElemPos.resize(numElems);
+    int count = 0;
+    for (int i = 0; i < numElems; i++) {
+        int oldPos = elemOrder[i];
+        numNodesPerElem[i] = oldNumNodesPerElem[oldPos];
+        for (int j = elemOffsets[oldPos]; j < elemOffsets[oldPos + 1]; j++)
+            elems[count++] = oldElems[j];
+        elemIDs[i] = oldElemIDs[oldPos];
+        clientElemToElemPos[oldPos] = i;
+    }
+    boundingBox.isComputed(false);
+}
+
+void FEMesh::fromClientOrder(EMPIRE_DataField_location location, int dimension,
+        const double *clientData, double *data) const {
+    const vector<int> &perm = (location == EMPIRE_DataField_atNode) ?
+            clientNodeToNodePos : clientElemToElemPos;
+    for (int i = 0; i < perm.size(); i++)
+        for (int j = 0; j < dimension; j++)
+            data[perm[i] * dimension + j] = clientData[i * dimension + j];
+}
+
+void FEMesh::toClientOrder(EMPIRE_DataField_location location, int dimension, const double *data,
+        double *clientData) const {
+    const vector<int> &perm = (location == EMPIRE_DataField_atNode) ?
+            clientNodeToNodePos : clientElemToElemPos;
+    for (int i = 0; i < perm.size(); i++)
+        for (int j = 0; j < dimension; j++)
+            clientData[i * dimension + j] = data[perm[i] * dimension + j];
+}
+
+void FEMesh::invalidateSpatialIndex() {
+    delete spatialIndex;
+    spatialIndex = NULL;
+    delete elemGeometry;
+    elemGeometry = NULL;
+    boundingBox.isComputed(false);
+    if (triangulatedMesh != NULL) {
+        for (int i = 0; i < numNodes * 3; i++)
+            triangulatedMesh->nodes[i] = nodes[i];
+        triangulatedMesh->invalidateSpatialIndex();
+    }
+}
+
+MemoryUsage FEMesh::getMemoryUsage() const {
+    MemoryUsage usage = AbstractMesh::getMemoryUsage();
+    usage.add("nodes", (size_t) numNodes * (3 * sizeof(double) + sizeof(int)));
+    usage.add("elements", (size_t) numElems * 2 * sizeof(int));
+    if (elems != NULL)
+        usage.add("elements", (size_t) elemsArraySize * sizeof(int));
+    if (triangulatedMesh != NULL)
+        usage.add("triangulated mesh", triangulatedMesh->getMemoryUsage());
+    if (spatialIndex != NULL)
+        usage.add("spatial index", spatialIndex->getMemoryUsage());
+    if (connectivity != NULL)
+        usage.add("connectivity", connectivity->getMemoryUsage());
+    if (elemGeometry != NULL)
+        usage.add("element geometry", elemGeometry->getMemoryUsage());
+    if (nodeIndex != NULL)
+        usage.add("node index", nodeIndex->getMemoryUsage());
+    usage.add("renumbering",
+            (clientNodeToNodePos.capacity() + clientElemToElemPos.capacity()) * sizeof(int));
+    return usage;
+}
+
 void FEMesh::computeBoundingBox() {
     if (boundingBox.isComputed())
         return;
-    boundingBox[0] = nodes[0 * 3 + 0];
-    boundingBox[1] = nodes[0 * 3 + 0];
-    boundingBox[2] = nodes[0 * 3 + 1];
-    boundingBox[3] = nodes[0 * 3 + 1];
-    boundingBox[4] = nodes[0 * 3 + 2];
-    boundingBox[5] = nodes[0 * 3 + 2];
-    for (int i = 1; i < numNodes; i++) {
-        double x = nodes[i * 3 + 0];
-        double y = nodes[i * 3 + 1];
-        double z = nodes[i * 3 + 2];
-        if (x < boundingBox[0])
-            boundingBox[0] = x;
-        else if (x > boundingBox[1])
-            boundingBox[1] = x;
-        if (y < boundingBox[2])
-            boundingBox[2] = y;
-        else if (y > boundingBox[3])
-            boundingBox[3] = y;
-        if (z < boundingBox[4])
-            boundingBox[4] = z;
-        else if (z > boundingBox[5])
-            boundingBox[5] = z;
+    double box[6];
+    for (int k = 0; k < 3; k++) {
+        box[2 * k] = nodes[0 * 3 + k];
+        box[2 * k + 1] = nodes[0 * 3 + k];
+    }
+    // every thread bounds a part of the nodes, the boxes of the threads are merged
+#pragma omp parallel num_threads(AuxiliaryParameters::mapperSetNumThreads)
+    {
+        double threadBox[6];
+        for (int k = 0; k < 6; k++)
+            threadBox[k] = box[k];
+#pragma omp for nowait
+        for (int i = 1; i < numNodes; i++) {
+            for (int k = 0; k < 3; k++) {
+                double x = nodes[i * 3 + k];
+                if (x < threadBox[2 * k])
+                    threadBox[2 * k] = x;
+                else if (x > threadBox[2 * k + 1])
+                    threadBox[2 * k + 1] = x;
+            }
+        }
+#pragma omp critical (FEMeshBoundingBox)
+        for (int k = 0; k < 3; k++) {
+            box[2 * k] = min(box[2 * k], threadBox[2 * k]);
+            box[2 * k + 1] = max(box[2 * k + 1], threadBox[2 * k + 1]);
+        }
     }
+    for (int k = 0; k < 6; k++)
+        boundingBox[k] = box[k];
     boundingBox.isComputed(true);
 }
 
 void FEMesh::validateMesh() {
-    int count1 = 0;
-    int count2 = 0;
-    // Check that two nodes index are not identical in a same element
+    vector<int> elemOffsets(numElems + 1, 0);
+    for (int elem = 0; elem < numElems; elem++)
+        elemOffsets[elem + 1] = elemOffsets[elem] + numNodesPerElem[elem];
+    // Check that two nodes index are not identical in a same element, the elements are checked in parallel
+    int isValid = 1;
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads) reduction(&&:isValid)
     for(int elem=0; elem < numElems; elem++) {
+    	const int *elemNodes = &elems[elemOffsets[elem]];
     	for(int node1=0; node1 < numNodesPerElem[elem]-1; node1++){
         	for(int node2=node1+1; node2 < numNodesPerElem[elem]; node2++){
-        		bool identical=elems[count1+node1]==elems[count1+node2];
-        		if(identical)
-        			ERROR_BLOCK_OUT("FEMesh","validateMesh","Mesh not valid. Duplicated node in element");
-        		//assert(!identical);
+        		bool identical=elemNodes[node1]==elemNodes[node2];
+        		isValid = isValid && !identical;
         	}
     	}
-    	count1+=numNodesPerElem[elem];
     }
+    if(!isValid)
+    	ERROR_BLOCK_OUT("FEMesh","validateMesh","Mesh not valid. Duplicated node in element");
     // Check that two elements are not identical
     // !WARNING! Check only element together in the same order
 	/* count1=0;
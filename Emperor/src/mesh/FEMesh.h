@@ -36,6 +36,10 @@ s ******************************************************************************
 namespace EMPIRE {
 class DataField;
 class Message;
+class FEMeshSpatialIndex;
+class FEMeshConnectivity;
+class FEMeshGeometry;
+class IDToIndexMap;
 /********//**
  * \brief Class FEMesh has all data w.r.t. a finite element mesh
  ***********/
@@ -88,6 +92,84 @@ public:
      * \author Fabien Pean
      ***********/
     void validateMesh();
+    /***********************************************************************************************
+     * \brief Prepare the mesh once after it has been received: validate it and compute the bounding
+     *        box, the node index, the connectivity tables, the geometry and bounding boxes of the
+     *        elements and the triangulated mesh if the mesh is to be triangulated. Every step runs
+     *        with the threads of the mappers and its result is kept by the mesh, so that the mappers,
+     *        filters and outputs read it without recomputing. The steps done before are skipped,
+     *        e.g. only the bounding box and the element geometry after the nodes have been moved.
+     ***********/
+    void prepare();
+    /***********************************************************************************************
+     * \brief Get the searching structures over this mesh, which are shared by all mappers and
+     *        filters. The structures are built at their first use
+     * \return the spatial index of this mesh
+     ***********/
+    FEMeshSpatialIndex *getSpatialIndex();
+    /***********************************************************************************************
+     * \brief Discard the spatial index, the element geometry and the bounding box, must be called
+     *        when the nodes have been changed
+     ***********/
+    void invalidateSpatialIndex();
+    /***********************************************************************************************
+     * \brief Get the element to node and the node to element tables by node positions, which are
+     *        shared by all mappers and filters. The tables are built at their first use, after
+     *        elems has been filled
+     * \return the tables of this mesh
+     ***********/
+    const FEMeshConnectivity *getConnectivity();
+    /***********************************************************************************************
+     * \brief Get the centroids, normals, planes to project and areas of all elements, which are
+     *        shared by all mappers and filters. The geometry is computed at its first use and
+     *        discarded by invalidateSpatialIndex()
+     * \return the element geometry of this mesh
+     ***********/
+    const FEMeshGeometry *getElemGeometry();
+    /***********************************************************************************************
+     * \brief Get the map from the node IDs to the node positions, which is shared by all mappers
+     *        and filters. The map is built at the first use, the client codes build it when they
+     *        receive the mesh
+     * \return node ID <=> node position
+     ***********/
+    const IDToIndexMap *getNodeIndex();
+    /***********************************************************************************************
+     * \brief Reorder the nodes and the elements along a space-filling curve through the node
+     *        coordinates and the element centroids, so that neighbours in space are neighbours in
+     *        memory. Must be called after elems has been filled and before the data fields are
+     *        added. The permutation is kept to convert the data fields from/to the client order.
+     * \param[in] renumbering the curve, EMPIRE_Mesh_noRenumbering does nothing
+     ***********/
+    void renumber(EMPIRE_Mesh_renumbering renumbering);
+    /***********************************************************************************************
+     * \brief Whether the nodes and the elements are not in the order of the client
+     ***********/
+    bool isRenumbered() const {
+        return !clientNodeToNodePos.empty() || !clientElemToElemPos.empty();
+    }
+    /***********************************************************************************************
+     * \brief Copy data from the order of the client to the order of the mesh
+     * \param[in] location at node or at element centroid
+     * \param[in] dimension number of values per location
+     * \param[in] clientData the data in the order of the client
+     * \param[out] data the data in the order of the mesh
+     ***********/
+    void fromClientOrder(EMPIRE_DataField_location location, int dimension,
+            const double *clientData, double *data) const;
+    /***********************************************************************************************
+     * \brief Copy data from the order of the mesh to the order of the client
+     * \param[in] location at node or at element centroid
+     * \param[in] dimension number of values per location
+     * \param[in] data the data in the order of the mesh
+     * \param[out] clientData the data in the order of the client
+     ***********/
+    void toClientOrder(EMPIRE_DataField_location location, int dimension, const double *data,
+            double *clientData) const;
+    /***********************************************************************************************
+     * \brief Get the heap memory of the mesh, its data fields, the triangulated mesh and the
+     *        spatial index
+     ***********/
+    MemoryUsage getMemoryUsage() const;
 
     /// triangulate all elments
     bool triangulateAll;
@@ -112,6 +194,18 @@ protected:
     bool tobeTriangulated;
     /// the triangulated mesh
     FEMesh *triangulatedMesh;
+    /// the spatial index, NULL until its first use
+    FEMeshSpatialIndex *spatialIndex;
+    /// the connectivity tables, NULL until their first use
+    FEMeshConnectivity *connectivity;
+    /// the element geometry, NULL until its first use
+    FEMeshGeometry *elemGeometry;
+    /// node ID <=> node position, NULL until its first use
+    IDToIndexMap *nodeIndex;
+    /// position of the i-th node of the client in this mesh, empty if the nodes are not renumbered
+    std::vector<int> clientNodeToNodePos;
+    /// position of the i-th element of the client in this mesh, empty if not renumbered
+    std::vector<int> clientElemToElemPos;
     /// unit test class
     friend class TestFEMesh;
 };
@@ -0,0 +1,97 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <stdlib.h>
+#include "FEMeshConnectivity.h"
+#include "IDToIndexMap.h"
+#include "AuxiliaryParameters.h"
+#include "Message.h"
+
+namespace EMPIRE {
+
+using namespace std;
+
+FEMeshConnectivity::FEMeshConnectivity(int _numNodes, const int *nodeIDs, int _numElems,
+        const int *numNodesPerElem, const int *elems) :
+        numNodes(_numNodes), numElems(_numElems) {
+    build(IDToIndexMap(numNodes, nodeIDs), numNodesPerElem, elems);
+}
+
+FEMeshConnectivity::FEMeshConnectivity(const IDToIndexMap &nodeIndex, int _numElems,
+        const int *numNodesPerElem, const int *elems) :
+        numNodes(nodeIndex.size()), numElems(_numElems) {
+    build(nodeIndex, numNodesPerElem, elems);
+}
+
+void FEMeshConnectivity::build(const IDToIndexMap &nodeIndex, const int *numNodesPerElem,
+        const int *elems) {
+    // 1. element to node table
+    elemOffsets = new int[numElems + 1];
+    elemOffsets[0] = 0;
+    for (int i = 0; i < numElems; i++)
+        elemOffsets[i + 1] = elemOffsets[i] + numNodesPerElem[i];
+    elemNodes = new int[elemOffsets[numElems]];
+    // the lookups are independent, a missing node is reported after the parallel loop
+    int missingEntry = elemOffsets[numElems];
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads) reduction(min:missingEntry)
+    for (int i = 0; i < elemOffsets[numElems]; i++) {
+        elemNodes[i] = nodeIndex.find(elems[i]);
+        if (elemNodes[i] == -1 && i < missingEntry)
+            missingEntry = i;
+    }
+    if (missingEntry < elemOffsets[numElems]) {
+        ERROR_OUT() << "FEMeshConnectivity: cannot find node ID " << elems[missingEntry] << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // 2. node to element table, counted first and filled in element order
+    nodeOffsets = new int[numNodes + 1];
+    for (int i = 0; i <= numNodes; i++)
+        nodeOffsets[i] = 0;
+    for (int i = 0; i < elemOffsets[numElems]; i++)
+        nodeOffsets[elemNodes[i] + 1]++;
+    for (int i = 0; i < numNodes; i++)
+        nodeOffsets[i + 1] += nodeOffsets[i];
+    nodeElems = new int[nodeOffsets[numNodes]];
+    int *fill = new int[numNodes];
+    for (int i = 0; i < numNodes; i++)
+        fill[i] = nodeOffsets[i];
+    for (int i = 0; i < numElems; i++)
+        for (int j = elemOffsets[i]; j < elemOffsets[i + 1]; j++)
+            nodeElems[fill[elemNodes[j]]++] = i;
+    delete[] fill;
+}
+
+FEMeshConnectivity::~FEMeshConnectivity() {
+    delete[] elemOffsets;
+    delete[] elemNodes;
+    delete[] nodeOffsets;
+    delete[] nodeElems;
+}
+
+MemoryUsage FEMeshConnectivity::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("element to node table", (numElems + 1 + elemOffsets[numElems]) * sizeof(int));
+    usage.add("node to element table", (numNodes + 1 + nodeOffsets[numNodes]) * sizeof(int));
+    return usage;
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,146 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file FEMeshConnectivity.h
+ * This file holds the class FEMeshConnectivity
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef FEMESHCONNECTIVITY_H_
+#define FEMESHCONNECTIVITY_H_
+
+#include "MemoryUsage.h"
+
+namespace EMPIRE {
+class IDToIndexMap;
+/********//**
+ * \brief Class FEMeshConnectivity holds the element to node and the node to element tables of a
+ *        finite element mesh in compressed row storage, by node positions instead of node IDs.
+ *        The nodes of element i are elemNodes[elemOffsets[i]] ... elemNodes[elemOffsets[i+1]-1],
+ *        the elements containing node i are nodeElems[nodeOffsets[i]] ... nodeElems[nodeOffsets[i+1]-1]
+ *        in ascending order. The tables of a FEMesh are shared by all mappers and filters.
+ ***********/
+class FEMeshConnectivity {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, builds the tables from the arrays of a mesh
+     * \param[in] _numNodes number of nodes
+     * \param[in] nodeIDs IDs of all nodes
+     * \param[in] _numElems number of elements
+     * \param[in] numNodesPerElem number of nodes of each element
+     * \param[in] elems node IDs of all elements
+     ***********/
+    FEMeshConnectivity(int _numNodes, const int *nodeIDs, int _numElems, const int *numNodesPerElem,
+            const int *elems);
+    /***********************************************************************************************
+     * \brief Constructor, builds the tables from the arrays of a mesh and the map of its node IDs
+     * \param[in] nodeIndex node ID <=> node position
+     * \param[in] _numElems number of elements
+     * \param[in] numNodesPerElem number of nodes of each element
+     * \param[in] elems node IDs of all elements
+     ***********/
+    FEMeshConnectivity(const IDToIndexMap &nodeIndex, int _numElems, const int *numNodesPerElem,
+            const int *elems);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~FEMeshConnectivity();
+    /***********************************************************************************************
+     * \brief Get the offsets of the elements in getElemNodes(), numElems + 1 entries
+     ***********/
+    const int *getElemOffsets() const {
+        return elemOffsets;
+    }
+    /***********************************************************************************************
+     * \brief Get the node positions of all elements
+     ***********/
+    const int *getElemNodes() const {
+        return elemNodes;
+    }
+    /***********************************************************************************************
+     * \brief Get the node positions of an element
+     * \param[in] elem the position of the element
+     ***********/
+    const int *getElemNodes(int elem) const {
+        return &elemNodes[elemOffsets[elem]];
+    }
+    /***********************************************************************************************
+     * \brief Get the number of nodes of an element
+     * \param[in] elem the position of the element
+     ***********/
+    int getNumNodesOfElem(int elem) const {
+        return elemOffsets[elem + 1] - elemOffsets[elem];
+    }
+    /***********************************************************************************************
+     * \brief Get the offsets of the nodes in getNodeElems(), numNodes + 1 entries
+     ***********/
+    const int *getNodeOffsets() const {
+        return nodeOffsets;
+    }
+    /***********************************************************************************************
+     * \brief Get the element positions of all nodes
+     ***********/
+    const int *getNodeElems() const {
+        return nodeElems;
+    }
+    /***********************************************************************************************
+     * \brief Get the positions of the elements containing a node
+     * \param[in] node the position of the node
+     ***********/
+    const int *getNodeElems(int node) const {
+        return &nodeElems[nodeOffsets[node]];
+    }
+    /***********************************************************************************************
+     * \brief Get the number of elements containing a node
+     * \param[in] node the position of the node
+     ***********/
+    int getNumElemsOfNode(int node) const {
+        return nodeOffsets[node + 1] - nodeOffsets[node];
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory of the tables
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+private:
+    /***********************************************************************************************
+     * \brief Build the tables, called by the constructors
+     ***********/
+    void build(const IDToIndexMap &nodeIndex, const int *numNodesPerElem, const int *elems);
+    /// number of nodes
+    const int numNodes;
+    /// number of elements
+    const int numElems;
+    /// offsets of the elements in elemNodes
+    int *elemOffsets;
+    /// node positions of all elements
+    int *elemNodes;
+    /// offsets of the nodes in nodeElems
+    int *nodeOffsets;
+    /// element positions of all nodes
+    int *nodeElems;
+    /// disallow copy constructor
+    FEMeshConnectivity(const FEMeshConnectivity&);
+    /// disallow assignment operator
+    FEMeshConnectivity& operator=(const FEMeshConnectivity&);
+};
+
+} /* namespace EMPIRE */
+#endif /* FEMESHCONNECTIVITY_H_ */
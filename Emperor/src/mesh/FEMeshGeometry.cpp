@@ -0,0 +1,96 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <math.h>
+#include "FEMeshGeometry.h"
+#include "FEMeshConnectivity.h"
+#include "MathLibrary.h"
+
+namespace EMPIRE {
+
+using namespace std;
+
+FEMeshGeometry::FEMeshGeometry(int _numElems, const int *numNodesPerElem, const double *nodes,
+        const FEMeshConnectivity *connectivity, int numThreads) :
+        numElems(_numElems) {
+    centroids = new double[numElems * 3];
+    normals = new double[numElems * 3];
+    planesToProject = new int[numElems];
+    areas = new double[numElems];
+#pragma omp parallel for num_threads(numThreads) schedule(static, 1024)
+    for (int i = 0; i < numElems; i++) {
+        int numNodesThisElem = numNodesPerElem[i];
+        const int *elemNodes = connectivity->getElemNodes(i);
+        double thisElem[numNodesThisElem * 3];
+        for (int j = 0; j < numNodesThisElem; j++)
+            for (int k = 0; k < 3; k++)
+                thisElem[j * 3 + k] = nodes[elemNodes[j] * 3 + k];
+        double *centroid = &centroids[i * 3];
+        double *normal = &normals[i * 3];
+        MathLibrary::computePolygonCenter(thisElem, numNodesThisElem, centroid);
+        if (numNodesThisElem == 3) {
+            MathLibrary::computeNormalOfTriangle(thisElem, true, normal);
+            areas[i] = MathLibrary::computeAreaOfTriangle(thisElem);
+        } else if (numNodesThisElem == 4) {
+            MathLibrary::computeNormalOfQuad(thisElem, true, normal);
+            areas[i] = MathLibrary::computePolygonArea(thisElem, 4);
+        } else { // a polygon, the normals of the triangles around the centroid are summed up
+            assert(numNodesThisElem > 4);
+            for (int k = 0; k < 3; k++)
+                normal[k] = 0.0;
+            for (int j = 0; j < numNodesThisElem; j++) {
+                double triangle[9];
+                for (int k = 0; k < 3; k++) {
+                    triangle[k] = centroid[k];
+                    triangle[3 + k] = thisElem[j * 3 + k];
+                    triangle[6 + k] = thisElem[(j + 1) % numNodesThisElem * 3 + k];
+                }
+                double triangleNormal[3];
+                MathLibrary::computeNormalOfTriangle(triangle, false, triangleNormal);
+                for (int k = 0; k < 3; k++)
+                    normal[k] += triangleNormal[k];
+            }
+            double length = MathLibrary::computeVectorLength(normal);
+            for (int k = 0; k < 3; k++)
+                normal[k] /= length;
+            areas[i] = MathLibrary::computePolygonArea(thisElem, numNodesThisElem);
+        }
+        planesToProject[i] = MathLibrary::computePlaneToProject(normal);
+    }
+}
+
+FEMeshGeometry::~FEMeshGeometry() {
+    delete[] centroids;
+    delete[] normals;
+    delete[] planesToProject;
+    delete[] areas;
+}
+
+MemoryUsage FEMeshGeometry::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("element centroids", numElems * 3 * sizeof(double));
+    usage.add("element normals", numElems * 3 * sizeof(double));
+    usage.add("element planes", numElems * sizeof(int));
+    usage.add("element areas", numElems * sizeof(double));
+    return usage;
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,116 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file FEMeshGeometry.h
+ * This file holds the class FEMeshGeometry
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef FEMESHGEOMETRY_H_
+#define FEMESHGEOMETRY_H_
+
+#include "MemoryUsage.h"
+
+namespace EMPIRE {
+class FEMeshConnectivity;
+/********//**
+ * \brief Class FEMeshGeometry holds the geometry of all elements of a finite element mesh: the
+ *        centroids, the unit normals, the planes to project to and the areas. Every quantity is
+ *        stored in an own array over the elements, e.g. the normal of element i is
+ *        normals[3*i] ... normals[3*i+2]. The quantities are the ones computed by MathLibrary
+ *        (computePolygonCenter, computeNormalOfTriangle/computeNormalOfQuad, computePlaneToProject,
+ *        computeAreaOfTriangle/computePolygonArea), so that the mappers get the same results
+ *        as before. The geometry of a FEMesh is shared by all mappers and filters and discarded
+ *        when the nodes are moved.
+ ***********/
+class FEMeshGeometry {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, computes the geometry of all elements in parallel
+     * \param[in] _numElems number of elements
+     * \param[in] numNodesPerElem number of nodes of each element
+     * \param[in] nodes coordinates of all nodes
+     * \param[in] connectivity the element to node table by node positions
+     * \param[in] numThreads the number of threads
+     ***********/
+    FEMeshGeometry(int _numElems, const int *numNodesPerElem, const double *nodes,
+            const FEMeshConnectivity *connectivity, int numThreads);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~FEMeshGeometry();
+    /***********************************************************************************************
+     * \brief Get the centroids of all elements, 3 entries per element
+     ***********/
+    const double *getCentroids() const {
+        return centroids;
+    }
+    /***********************************************************************************************
+     * \brief Get the centroid of an element
+     * \param[in] elem the position of the element
+     ***********/
+    const double *getCentroid(int elem) const {
+        return &centroids[elem * 3];
+    }
+    /***********************************************************************************************
+     * \brief Get the unit normal of an element
+     * \param[in] elem the position of the element
+     ***********/
+    const double *getNormal(int elem) const {
+        return &normals[elem * 3];
+    }
+    /***********************************************************************************************
+     * \brief Get the plane an element is projected to (case: {2:x-y ; 0:y-z ;1: z-x} )
+     * \param[in] elem the position of the element
+     ***********/
+    int getPlaneToProject(int elem) const {
+        return planesToProject[elem];
+    }
+    /***********************************************************************************************
+     * \brief Get the area of an element
+     * \param[in] elem the position of the element
+     ***********/
+    double getArea(int elem) const {
+        return areas[elem];
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory of the arrays
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+private:
+    /// number of elements
+    const int numElems;
+    /// centroids of all elements
+    double *centroids;
+    /// unit normals of all elements
+    double *normals;
+    /// planes to project of all elements
+    int *planesToProject;
+    /// areas of all elements
+    double *areas;
+    /// disallow copy constructor
+    FEMeshGeometry(const FEMeshGeometry&);
+    /// disallow assignment operator
+    FEMeshGeometry& operator=(const FEMeshGeometry&);
+};
+
+} /* namespace EMPIRE */
+#endif /* FEMESHGEOMETRY_H_ */
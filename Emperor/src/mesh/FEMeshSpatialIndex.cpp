@@ -0,0 +1,153 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include "FEMeshSpatialIndex.h"
+#include "FEMesh.h"
+#include "FEMeshConnectivity.h"
+#include "FEMeshGeometry.h"
+#include "AABBTree.h"
+#include "MathLibrary.h"
+#include "AuxiliaryParameters.h"
+
+#ifdef FLANN
+#include "flann/flann.hpp"
+#endif
+
+namespace EMPIRE {
+
+using namespace std;
+
+FEMeshSpatialIndex::FEMeshSpatialIndex(FEMesh *_mesh) :
+        mesh(_mesh), FLANNNodes(NULL), FLANNNodesTree(NULL), FLANNElemCentroids(
+                NULL), FLANNElemCentroidsTree(NULL), elemBoundingBoxes(NULL), elemAABBTree(
+                NULL) {
+    assert(mesh != NULL);
+}
+
+FEMeshSpatialIndex::~FEMeshSpatialIndex() {
+#ifdef FLANN
+    delete FLANNNodesTree;
+    delete FLANNNodes;
+    delete FLANNElemCentroidsTree;
+    delete FLANNElemCentroids;
+#endif
+    delete[] elemBoundingBoxes;
+    delete elemAABBTree;
+}
+
+flann::Index<flann::L2<double> > *FEMeshSpatialIndex::getNodesTree() {
+#ifdef FLANN
+    if (FLANNNodesTree == NULL) {
+        FLANNNodes = new flann::Matrix<double>(mesh->nodes, mesh->numNodes, 3);
+        FLANNNodesTree = new flann::Index<flann::L2<double> >(*FLANNNodes,
+                flann::KDTreeSingleIndexParams(1));
+        FLANNNodesTree->buildIndex(); // Build binary tree for searching
+    }
+#endif
+    return FLANNNodesTree;
+}
+
+const double *FEMeshSpatialIndex::getElemCentroids() {
+    return mesh->getElemGeometry()->getCentroids();
+}
+
+flann::Index<flann::L2<double> > *FEMeshSpatialIndex::getElemCentroidsTree() {
+#ifdef FLANN
+    if (FLANNElemCentroidsTree == NULL) {
+        FLANNElemCentroids = new flann::Matrix<double>(const_cast<double *>(getElemCentroids()),
+                mesh->numElems, 3);
+        FLANNElemCentroidsTree = new flann::Index<flann::L2<double> >(*FLANNElemCentroids,
+                flann::KDTreeSingleIndexParams(1));
+        FLANNElemCentroidsTree->buildIndex(); // Build binary tree for searching
+    }
+#endif
+    return FLANNElemCentroidsTree;
+}
+
+const double *FEMeshSpatialIndex::getElemBoundingBoxes() {
+    if (elemBoundingBoxes == NULL)
+        computeElemBoundingBoxes();
+    return elemBoundingBoxes;
+}
+
+const AABBTree *FEMeshSpatialIndex::getElemAABBTree() {
+    if (elemAABBTree == NULL) {
+        getElemBoundingBoxes();
+        vector<AABB> boxes(mesh->numElems);
+        for (int i = 0; i < mesh->numElems; i++)
+            for (int k = 0; k < 6; k++)
+                boxes[i][k] = elemBoundingBoxes[i * 6 + k];
+        elemAABBTree = new AABBTree(boxes);
+    }
+    return elemAABBTree;
+}
+
+void FEMeshSpatialIndex::findElemsIntersectingBox(const double *box, double offset,
+        vector<int> &elems) {
+    AABB aabb;
+    for (int k = 0; k < 6; k++)
+        aabb[k] = box[k];
+    getElemAABBTree()->findBoxesIntersectingBox(aabb, offset, elems);
+}
+
+void FEMeshSpatialIndex::findElemsContainingPoint(const double *point, double offset,
+        vector<int> &elems) {
+    getElemAABBTree()->findBoxesContainingPoint(point, offset, elems);
+}
+
+MemoryUsage FEMeshSpatialIndex::getMemoryUsage() const {
+    MemoryUsage usage;
+#ifdef FLANN
+    if (FLANNNodesTree != NULL)
+        usage.add("nodes tree", FLANNNodesTree->usedMemory());
+    if (FLANNElemCentroidsTree != NULL)
+        usage.add("element centroids tree", FLANNElemCentroidsTree->usedMemory());
+#endif
+    if (elemBoundingBoxes != NULL)
+        usage.add("element bounding boxes", mesh->numElems * 6 * sizeof(double));
+    if (elemAABBTree != NULL)
+        usage.add("element AABB tree", elemAABBTree->getMemory());
+    return usage;
+}
+
+void FEMeshSpatialIndex::computeElemBoundingBoxes() {
+    assert(elemBoundingBoxes == NULL);
+    const FEMeshConnectivity *connectivity = mesh->getConnectivity();
+
+    elemBoundingBoxes = new double[mesh->numElems * 6];
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads) schedule(static, 1024)
+    for (int i = 0; i < mesh->numElems; i++) {
+        int numNodesThisElem = mesh->numNodesPerElem[i];
+        const int *elemNodes = connectivity->getElemNodes(i);
+        double thisElem[numNodesThisElem * 3];
+        for (int j = 0; j < numNodesThisElem; j++) {
+            int nodePos = elemNodes[j];
+            for (int k = 0; k < 3; k++)
+                thisElem[j * 3 + k] = mesh->nodes[nodePos * 3 + k];
+        }
+        AABB box;
+        box.computeFromPoints(thisElem, numNodesThisElem);
+        for (int k = 0; k < 6; k++)
+            elemBoundingBoxes[i * 6 + k] = box[k];
+    }
+}
+
+} /* namespace EMPIRE */
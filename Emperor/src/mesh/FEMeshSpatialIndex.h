@@ -0,0 +1,128 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file FEMeshSpatialIndex.h
+ * This file holds the class FEMeshSpatialIndex
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef FEMESHSPATIALINDEX_H_
+#define FEMESHSPATIALINDEX_H_
+
+#include <vector>
+#include "MemoryUsage.h"
+
+namespace flann {
+template<typename Distance> class Index;
+template<class T> struct L2;
+template<typename T> class Matrix;
+}
+
+namespace EMPIRE {
+class FEMesh;
+class AABBTree;
+/********//**
+ * \brief Class FEMeshSpatialIndex holds the searching structures over a FEMesh, which are shared by
+ *        all mappers and filters working on the mesh. Each structure is built at its first use.
+ *        Building is not thread safe, but all queries on a built structure are.
+ ***********/
+class FEMeshSpatialIndex {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _mesh the mesh to be indexed
+     ***********/
+    FEMeshSpatialIndex(FEMesh *_mesh);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~FEMeshSpatialIndex();
+    /***********************************************************************************************
+     * \brief Get the kd-tree over the nodes of the mesh
+     * \return the FLANN searching tree, the indices it returns are node positions
+     ***********/
+    flann::Index<flann::L2<double> > *getNodesTree();
+    /***********************************************************************************************
+     * \brief Get the centroids of all elements, which are kept by the element geometry of the mesh
+     * \return the centroids, 3 coordinates per element
+     ***********/
+    const double *getElemCentroids();
+    /***********************************************************************************************
+     * \brief Get the kd-tree over the element centroids
+     * \return the FLANN searching tree, the indices it returns are element positions
+     ***********/
+    flann::Index<flann::L2<double> > *getElemCentroidsTree();
+    /***********************************************************************************************
+     * \brief Get the axis aligned bounding boxes of all elements
+     * \return the boxes, stored as xmin, xmax, ymin, ymax, zmin, zmax per element
+     ***********/
+    const double *getElemBoundingBoxes();
+    /***********************************************************************************************
+     * \brief Get the bounding volume hierarchy over the element bounding boxes
+     * \return the tree, the box positions it returns are element positions
+     ***********/
+    const AABBTree *getElemAABBTree();
+    /***********************************************************************************************
+     * \brief Find all elements whose bounding box intersects the given box, by the bounding volume
+     *        hierarchy over the element bounding boxes
+     * \param[in] box the box, stored as xmin, xmax, ymin, ymax, zmin, zmax
+     * \param[in] offset the element bounding boxes are enlarged by offset in each direction
+     * \param[out] elems the positions of the elements found
+     ***********/
+    void findElemsIntersectingBox(const double *box, double offset, std::vector<int> &elems);
+    /***********************************************************************************************
+     * \brief Find all elements whose bounding box contains the given point
+     * \param[in] point the point
+     * \param[in] offset the element bounding boxes are enlarged by offset in each direction
+     * \param[out] elems the positions of the elements found
+     ***********/
+    void findElemsContainingPoint(const double *point, double offset, std::vector<int> &elems);
+    /***********************************************************************************************
+     * \brief Get the heap memory of the structures built so far
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+private:
+    /// the mesh
+    FEMesh *mesh;
+    /// nodes constructing the nodes tree
+    flann::Matrix<double> *FLANNNodes;
+    /// nearest neighbors searching tree over the nodes
+    flann::Index<flann::L2<double> > *FLANNNodesTree;
+    /// centroids constructing the centroids tree
+    flann::Matrix<double> *FLANNElemCentroids;
+    /// nearest neighbors searching tree over the element centroids
+    flann::Index<flann::L2<double> > *FLANNElemCentroidsTree;
+    /// bounding boxes of all elements
+    double *elemBoundingBoxes;
+    /// bounding volume hierarchy over the element bounding boxes
+    AABBTree *elemAABBTree;
+    /***********************************************************************************************
+     * \brief Compute elemBoundingBoxes
+     ***********/
+    void computeElemBoundingBoxes();
+    /// disallow copy constructor
+    FEMeshSpatialIndex(const FEMeshSpatialIndex&);
+    /// disallow assignment operator
+    FEMeshSpatialIndex& operator=(const FEMeshSpatialIndex&);
+};
+
+} /* namespace EMPIRE */
+#endif /* FEMESHSPATIALINDEX_H_ */
@@ -33,13 +33,18 @@
 #include "WeakIGAPatchContinuityCondition.h"
 #include "DataField.h"
 #include "Message.h"
+#include "AuxiliaryParameters.h"
+#include "AABBTree.h"
+#include "CouplingMatricesCache.h"
+#include <sstream>
+#include <algorithm>
 
 using namespace std;
 
 namespace EMPIRE {
 
 IGAMesh::IGAMesh(std::string _name) :
-    AbstractMesh(_name), numNodes(0) {
+    AbstractMesh(_name), numNodes(0), patchAABBTree(NULL), trimmingLinearizationType(2) {
     type = EMPIRE_Mesh_IGAMesh;
 
     isNumNodesProvided = false;
@@ -47,7 +52,7 @@ IGAMesh::IGAMesh(std::string _name) :
 }
 
 IGAMesh::IGAMesh(std::string _name, int _numNodes) :
-    AbstractMesh(_name), numNodes(_numNodes) {
+    AbstractMesh(_name), numNodes(_numNodes), patchAABBTree(NULL), trimmingLinearizationType(2) {
     type = EMPIRE_Mesh_IGAMesh;
 
     isNumNodesProvided = true;
@@ -67,6 +72,8 @@ IGAMesh::~IGAMesh() {
 
     for (int i = 0; i < weakIGAPatchContinuityConditions.size(); i++)
         delete weakIGAPatchContinuityConditions[i];
+
+    delete patchAABBTree;
 }
 
 IGAPatchSurface* IGAMesh::addPatch(int _pDegree, int _uNoKnots, double* _uKnotVector, int _qDegree,
@@ -98,43 +105,109 @@ IGAPatchSurface* IGAMesh::addPatch(int _pDegree, int _uNoKnots, double* _uKnotVe
     return surfacePatches.back();
 }
 
+void IGAMesh::preparePatches() {
+    // The patches are of very different cost, thus they are handed out one by one
+    const int numPatches = surfacePatches.size();
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads) schedule(dynamic, 1)
+    for (int patchCount = 0; patchCount < numPatches; patchCount++) {
+        IGAPatchSurface* patch = surfacePatches[patchCount];
+        if (patch->isTrimmed())
+            patch->linearizeTrimming(trimmingLinearizationType);
+        patch->computeBoundingBox();
+    }
+}
+
+void IGAMesh::prepareIntegrationCells() {
+    // The knot spans within a patch are processed concurrently
+    for (int patchCount = 0; patchCount < surfacePatches.size(); patchCount++)
+        surfacePatches[patchCount]->computeIntegrationCells(AuxiliaryParameters::mapperSetNumThreads);
+}
+
+void IGAMesh::createConditionsGPData(const std::vector<AbstractCondition*>& _conditions,
+        const std::string& _cacheDirectory) {
+    const int numConditions = _conditions.size();
+    std::vector<char> isCreated(numConditions, false);
+
+    // Read the GP data of a previous run with the same patches and conditions from the cache
+    CouplingMatricesCache* cache = NULL;
+    if (!_cacheDirectory.empty() && numConditions > 0) {
+        cache = new CouplingMatricesCache(_cacheDirectory, "conditionGPData");
+        uint64_t meshHash = CouplingMatricesCache::hashMeshContent(this);
+        cache->addToKey(&meshHash, sizeof(meshHash));
+        cache->addToKey(numConditions);
+        for (int conditionCount = 0; conditionCount < numConditions; conditionCount++)
+            cache->addToKey((int) _conditions[conditionCount]->type);
+        if (cache->load())
+            for (int conditionCount = 0; conditionCount < numConditions; conditionCount++)
+                isCreated[conditionCount] = _conditions[conditionCount]->readGPDataFromCache(cache,
+                        getConditionCacheName(conditionCount));
+    }
+    const int numRead = std::count(isCreated.begin(), isCreated.end(), true);
+    if (numRead > 0)
+        INFO_OUT() << "The GP data of " << numRead << " of " << numConditions << " conditions of the IGA mesh \""
+                << name << "\" are read from the cache" << std::endl;
+
+    // The surface conditions integrate the cells of the patches, which are shared by the conditions
+    if (!weakIGADirichletSurfaceConditions.empty() && numRead < numConditions)
+        prepareIntegrationCells();
+#pragma omp parallel for num_threads(AuxiliaryParameters::mapperSetNumThreads) schedule(dynamic, 1)
+    for (int conditionCount = 0; conditionCount < numConditions; conditionCount++)
+        if (!isCreated[conditionCount])
+            _conditions[conditionCount]->createGPData(surfacePatches);
+
+    // Store the GP data of all conditions if some are created
+    if (cache != NULL && numRead < numConditions) {
+        for (int conditionCount = 0; conditionCount < numConditions; conditionCount++)
+            _conditions[conditionCount]->writeGPDataToCache(cache, getConditionCacheName(conditionCount));
+        cache->save();
+    }
+    delete cache;
+}
+
+std::string IGAMesh::getConditionCacheName(int _conditionIndex) {
+    std::stringstream cacheName;
+    cacheName << "condition" << _conditionIndex << "_";
+    return cacheName.str();
+}
+
+MemoryUsage IGAMesh::getMemoryUsage() const {
+    MemoryUsage usage = AbstractMesh::getMemoryUsage();
+    for (int i = 0; i < surfacePatches.size(); i++)
+        usage.add("patches", surfacePatches[i]->getMemoryUsage());
+    if (patchAABBTree != NULL)
+        usage.add("patch AABB tree", patchAABBTree->getMemory());
+    return usage;
+}
+
 void IGAMesh::computeBoundingBox() {
-    if (boundingBox.isComputed())
+    if (boundingBox.isComputed() && patchAABBTree != NULL)
         return;
 
-    boundingBox[0] = surfacePatches[0]->getControlPointNet()[0]->getX();
-    boundingBox[1] = surfacePatches[0]->getControlPointNet()[0]->getX();
-    boundingBox[2] = surfacePatches[0]->getControlPointNet()[0]->getY();
-    boundingBox[3] = surfacePatches[0]->getControlPointNet()[0]->getY();
-    boundingBox[4] = surfacePatches[0]->getControlPointNet()[0]->getZ();
-    boundingBox[5] = surfacePatches[0]->getControlPointNet()[0]->getZ();
-
+    std::vector<AABB> patchBoxes(surfacePatches.size());
     for (int patchCount = 0; patchCount < surfacePatches.size(); patchCount++) {
         IGAPatchSurface* patch = surfacePatches[patchCount];
         patch->computeBoundingBox();
+        for (int k = 0; k < 6; k++)
+            patchBoxes[patchCount][k] = patch->getBoundingBox(k);
     }
-    for (int patchCount = 0; patchCount < surfacePatches.size(); patchCount++) {
-        IGAPatchSurface* patch = surfacePatches[patchCount];
-        double xmin = patch->getBoundingBox(0);
-        double xmax = patch->getBoundingBox(1);
-        double ymin = patch->getBoundingBox(2);
-        double ymax = patch->getBoundingBox(3);
-        double zmin = patch->getBoundingBox(4);
-        double zmax = patch->getBoundingBox(5);
-        if (xmin < boundingBox[0])
-            boundingBox[0] = xmin;
-        else if ( xmax > boundingBox[1])
-            boundingBox[1] = xmax;
-        if (ymin < boundingBox[2])
-            boundingBox[2] = ymin;
-        else if (ymax > boundingBox[3])
-            boundingBox[3] = ymax;
-        if (zmin < boundingBox[4])
-            boundingBox[4] = zmin;
-        else if (zmax > boundingBox[5])
-            boundingBox[5] = zmax;
+    // The mesh box is the union of all patch boxes
+    if (!patchBoxes.empty()) {
+        for (int k = 0; k < 6; k++)
+            boundingBox[k] = patchBoxes[0][k];
+        for (int patchCount = 1; patchCount < patchBoxes.size(); patchCount++)
+            boundingBox.extend(patchBoxes[patchCount]);
+        boundingBox.isComputed(true);
     }
-    boundingBox.isComputed(true);
+
+    delete patchAABBTree;
+    patchAABBTree = new AABBTree(patchBoxes);
+}
+
+void IGAMesh::findPatchesContainingPoint(const double* _P, double _offset, std::vector<int>& _patchIndices) {
+    if (patchAABBTree == NULL)
+        computeBoundingBox();
+    patchAABBTree->findBoxesContainingPoint(_P, _offset, _patchIndices);
+    std::sort(_patchIndices.begin(), _patchIndices.end());
 }
 
 void IGAMesh::addDataField(string _dataFieldName, EMPIRE_DataField_location _location,
@@ -214,6 +287,7 @@ void IGAMesh::createWeakDirichletSurfaceConditionGPData(int _connectionIndex) {
      */
 
     // Create GP Data for the patch
+    prepareIntegrationCells();
     weakIGADirichletSurfaceConditions[_connectionIndex]->createGPData(surfacePatches);
 }
 
@@ -43,6 +43,8 @@ class IGAPatchSurface;
 class WeakIGADirichletCurveCondition;
 class WeakIGADirichletSurfaceCondition;
 class WeakIGAPatchContinuityCondition;
+class AbstractCondition;
+class AABBTree;
 
 /********//**
  * \brief class IGAMesh is a specialization of the class AbstractMesh used for IGA Mesh containing number of IGA surface patches
@@ -76,6 +78,12 @@ protected:
     /// The flag on whether num of GPs are provided for the constructor
     bool isNumNodesProvided;
 
+    /// Bounding volume hierarchy over the bounding boxes of the patches, built by computeBoundingBox
+    AABBTree* patchAABBTree;
+
+    /// The type of the linearization of the trimming curves, see IGAPatchCurve::linearize
+    int trimmingLinearizationType;
+
     /// The constructor, the destructor and the copy constructor
 public:
 
@@ -119,6 +127,48 @@ public:
                               double* _vKnotVector, int _uNoControlPoints, int _vNoControlPoints,
                               double* controlPointNet, int* _dofIndexNet);
 
+    /***********************************************************************************************
+     * \brief Prepare all patches for the mapping, that is linearize the trimming of the trimmed
+     *        patches and compute the bounding boxes of all patches. The patches are independent of
+     *        each other and are processed concurrently
+     ***********/
+    void preparePatches();
+
+    /***********************************************************************************************
+     * \brief Set the type of the linearization of the trimming curves used by preparePatches
+     * \param[in] _type Type of linearization, see IGAPatchCurve::linearize
+     ***********/
+    void setTrimmingLinearizationType(int _type) {
+        trimmingLinearizationType = _type;
+    }
+
+    /***********************************************************************************************
+     * \brief Get the type of the linearization of the trimming curves
+     * \return Type of linearization, see IGAPatchCurve::linearize
+     ***********/
+    int getTrimmingLinearizationType() const {
+        return trimmingLinearizationType;
+    }
+
+    /***********************************************************************************************
+     * \brief Compute the integration cells of all patches which have none, see
+     *        IGAPatchSurface::computeIntegrationCells. The patches must be prepared by
+     *        preparePatches before
+     ***********/
+    void prepareIntegrationCells();
+
+    /***********************************************************************************************
+     * \brief Create the Gauss point data of the given conditions concurrently. The conditions only
+     *        read the patches, which must be prepared by preparePatches before. The data are
+     *        created once per mesh and shared by all mappers of the mesh. With a cache directory
+     *        they are read from the file of a previous run with the same patches and conditions,
+     *        or written to it, see CouplingMatricesCache
+     * \param[in] _conditions The conditions of this mesh whose Gauss point data are not provided
+     * \param[in] _cacheDirectory The directory of the cache file, no cache if empty
+     ***********/
+    void createConditionsGPData(const std::vector<AbstractCondition*>& _conditions,
+            const std::string& _cacheDirectory = "");
+
     /// Specializing abstract functions from AbstractMesh class
 public:
     /***********************************************************************************************
@@ -133,11 +183,28 @@ public:
                       EMPIRE_DataField_dimension _dimension, EMPIRE_DataField_typeOfQuantity _typeOfQuantity);
 
     /***********************************************************************************************
-     * \brief Compute the bounding box of the mesh
+     * \brief Compute the bounding box of the mesh and the bounding volume hierarchy over the bounding
+     *        boxes of its patches
      * \author Chenshen Wu
      ***********/
     void computeBoundingBox();
 
+    /***********************************************************************************************
+     * \brief Get the heap memory of the mesh, its data fields and its patches
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+    /***********************************************************************************************
+     * \brief Find all patches whose bounding box contains the given point, by the bounding volume
+     *        hierarchy over the patch bounding boxes. The hierarchy is built at the first call if
+     *        computeBoundingBox was not called before, after that the search is thread safe
+     * \param[in] _P The Cartesian coordinates of the point
+     * \param[in] _offset The patch bounding boxes are enlarged by _offset in each direction, e.g. by
+     *            the maximum projection distance
+     * \param[out] _patchIndices The indices of the patches found in increasing order
+     ***********/
+    void findPatchesContainingPoint(const double* _P, double _offset, std::vector<int>& _patchIndices);
+
     /***********************************************************************************************
      * brief Add a new weak Dirichlet condition to the IGA mesh
      * \param[in] _conditionID The ID of the condition
@@ -382,6 +449,12 @@ public:
         return clampedDirections;
     }
 
+private:
+    /***********************************************************************************************
+     * \brief Get the prefix of the GP data of a condition in the cache of createConditionsGPData
+     * \param[in] _conditionIndex The index of the condition in the conditions given
+     ***********/
+    static std::string getConditionCacheName(int _conditionIndex);
 };
 
 /***********************************************************************************************
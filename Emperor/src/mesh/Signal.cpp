@@ -36,6 +36,8 @@ Signal::Signal(std::string _name, int size0, int size1, int size2) :
     size3D[2] = size2;
     size = size0 * size1 * size2;
     array = new double[size];
+    for (int i = 0; i < DataHistory::NUM_RATES; i++)
+        histories[i] = NULL;
     if (size0 != 1) {
         dimension = EMPIRE_Signal_3D;
     } else {
@@ -53,6 +55,14 @@ Signal::Signal(std::string _name, int size0, int size1, int size2) :
 Signal::~Signal() {
     delete[] size3D;
     delete[] array;
+    for (int i = 0; i < DataHistory::NUM_RATES; i++)
+        delete histories[i];
+}
+
+DataHistory *Signal::getHistory(DataHistory::Rate rate) {
+    if (histories[rate] == NULL)
+        histories[rate] = new DataHistory(size);
+    return histories[rate];
 }
 
 double &Signal::entry(int i, int j, int k) {
@@ -29,6 +29,7 @@
 
 #include <string>
 #include "EMPEROR_Enum.h"
+#include "DataHistory.h"
 
 namespace EMPIRE {
 /********//**
@@ -61,6 +62,12 @@ public:
      * \author Tianyang Wang
      ***********/
     double &entry(int i, int j, int k);
+    /***********************************************************************************************
+     * \brief Get the history of the array taken at the given rate, shared by all its consumers
+     * \param[in] rate the rate of the snapshots
+     * \return the history, created at the first call
+     ***********/
+    DataHistory *getHistory(DataHistory::Rate rate);
     /// name
     std::string name;
     /// 3D array
@@ -70,6 +77,9 @@ public:
     int size;
     /// dimension of the array
     EMPIRE_Signal_dimension dimension;
+private:
+    /// the histories of the array for every rate, NULL until requested
+    DataHistory *histories[DataHistory::NUM_RATES];
 };
 
 /***********************************************************************************************
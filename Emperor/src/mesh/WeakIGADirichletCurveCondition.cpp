@@ -33,6 +33,7 @@
 #include "IGAPatchCurve.h"
 #include "MathLibrary.h"
 #include "Message.h"
+#include "CouplingMatricesCache.h"
 
 using namespace std;
 
@@ -41,7 +42,7 @@ namespace EMPIRE {
 WeakIGADirichletCurveCondition::WeakIGADirichletCurveCondition(int _ID,
                                                                int _patchIndex, int _p, int _uNoKnots, double* _uKnotVector, int _uNoControlPoints, double* _controlPointNet) :
     AbstractCondition(_ID),
-    patchIndex(_patchIndex)
+    patchIndex(_patchIndex), patchBLIndex(-1), patchBLTrCurveIndex(-1)
 {
 
     type = EMPIRE_WeakIGADirichletCurveCondition;
@@ -59,7 +60,8 @@ WeakIGADirichletCurveCondition::WeakIGADirichletCurveCondition(int _ID,
 
 WeakIGADirichletCurveCondition::WeakIGADirichletCurveCondition(int _ID,
                                                                int _patchIndex, IGAPatchCurve* _dirichletCurve) :
-    AbstractCondition(_ID), patchIndex(_patchIndex), dirichletCurve(_dirichletCurve) {
+    AbstractCondition(_ID), patchIndex(_patchIndex), patchBLIndex(-1), patchBLTrCurveIndex(-1),
+    dirichletCurve(_dirichletCurve) {
 
     type = EMPIRE_WeakIGADirichletCurveCondition;
 
@@ -156,7 +158,7 @@ void WeakIGADirichletCurveCondition::createGPData(const std::vector<IGAPatchSurf
     curveGPTangents = new double[curveNumGP*noCoord];
 
     // Create a Gauss quadrature rule
-    MathLibrary::IGAGaussQuadratureOnBiunitInterval* theGPQuadrature = new MathLibrary::IGAGaussQuadratureOnBiunitInterval(numGPPerSection);
+    const MathLibrary::IGAGaussQuadrature* theGPQuadrature = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_BIUNIT_INTERVAL, numGPPerSection);
 
     // Initialize variables
     int noDeriv = 1;
@@ -237,13 +239,13 @@ void WeakIGADirichletCurveCondition::createGPData(const std::vector<IGAPatchSurf
                 }
 
                 // Compute the tangent vector on the physical space
-                MathLibrary::computeDenseVectorMultiplicationScalar(A1, baseVectorCurve[0], noCoord);
-                MathLibrary::computeDenseVectorMultiplicationScalar(A2, baseVectorCurve[1], noCoord);
-                MathLibrary::computeDenseVectorAddition(A1, A2, 1.0, noCoord);
+                MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A1, baseVectorCurve[0]);
+                MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A2, baseVectorCurve[1]);
+                MathLibrary::computeDenseVectorAddition<noCoord>(A1, A2, 1.0);
 
                 // Compute the determinant of the Jacobian of the transformation from the parameter space to the physical space
-                detJ2 = MathLibrary::vector2norm(A1, noCoord);
-                MathLibrary::computeDenseVectorMultiplicationScalar(A1, 1.0/detJ2, noCoord);
+                detJ2 = MathLibrary::vector2norm<noCoord>(A1);
+                MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A1, 1.0/detJ2);
 
                 for(int iCoord = 0; iCoord < noCoord; iCoord++)
                     curveGPTangents[noCoord*counterGP + iCoord] = A1[iCoord];
@@ -259,9 +261,6 @@ void WeakIGADirichletCurveCondition::createGPData(const std::vector<IGAPatchSurf
     // Set the initialized flag to true
     isGPDataInitialized = true;
 
-    // Delete pointers
-    delete theGPQuadrature;
-
 }
 
 void WeakIGADirichletCurveCondition::getCurveGPData(double* _curveGP, double& _curveGPWeight, double* _curveGPTangent, double& _curveGPJacobianProduct, int _iGP) {
@@ -309,6 +308,31 @@ void WeakIGADirichletCurveCondition::getCurveAllGPData(double* _curveGPs, double
     }
 }
 
+void WeakIGADirichletCurveCondition::writeGPDataToCache(CouplingMatricesCache* _cache, const std::string& _prefix) const {
+    assert(isGPDataInitialized);
+    double numGP = curveNumGP;
+    _cache->setVector(_prefix + "numGP", &numGP, 1);
+    _cache->setVector(_prefix + "GPs", curveGPs, curveNumGP * 2);
+    _cache->setVector(_prefix + "GPWeights", curveGPWeights, curveNumGP);
+    _cache->setVector(_prefix + "GPTangents", curveGPTangents, curveNumGP * 3);
+    _cache->setVector(_prefix + "GPJacobianProducts", curveGPJacobianProducts, curveNumGP);
+}
+
+bool WeakIGADirichletCurveCondition::readGPDataFromCache(const CouplingMatricesCache* _cache, const std::string& _prefix) {
+    double numGP;
+    if (!_cache->getVector(_prefix + "numGP", 1, &numGP))
+        return false;
+    const int n = (int) numGP;
+    std::vector<double> GPs(2 * n + 1), GPWeights(n + 1), GPTangents(3 * n + 1), GPJacobianProducts(n + 1);
+    if (!_cache->getVector(_prefix + "GPs", 2 * n, &GPs[0])
+            || !_cache->getVector(_prefix + "GPWeights", n, &GPWeights[0])
+            || !_cache->getVector(_prefix + "GPTangents", 3 * n, &GPTangents[0])
+            || !_cache->getVector(_prefix + "GPJacobianProducts", n, &GPJacobianProducts[0]))
+        return false;
+    addWeakDirichletCurveConditionGPData(n, &GPs[0], &GPWeights[0], &GPTangents[0], &GPJacobianProducts[0]);
+    return true;
+}
+
 WeakIGADirichletCurveCondition::~WeakIGADirichletCurveCondition() {
     if (!isTrimmingCurve)
         delete dirichletCurve;
@@ -130,6 +130,16 @@ public:
      ***********/
     void createGPData(const std::vector<IGAPatchSurface*>& _surfacePatches);
 
+    /***********************************************************************************************
+     * \brief Store the GP data in a cache, see AbstractCondition::writeGPDataToCache
+     ***********/
+    void writeGPDataToCache(CouplingMatricesCache* _cache, const std::string& _prefix) const;
+
+    /***********************************************************************************************
+     * \brief Read the GP data from a cache, see AbstractCondition::readGPDataFromCache
+     ***********/
+    bool readGPDataFromCache(const CouplingMatricesCache* _cache, const std::string& _prefix);
+
     /***********************************************************************************************
      * \brief Destructor
      * \author Andreas Apostolatos, Altug Emiroglu
@@ -144,6 +154,20 @@ public:
         return patchIndex;
     }
 
+    /***********************************************************************************************
+     * \brief get patchBLIndex, -1 if the curve is not a trimming curve
+     ***********/
+    int getPatchBLIndex() const {
+        return patchBLIndex;
+    }
+
+    /***********************************************************************************************
+     * \brief get patchBLTrCurveIndex, -1 if the curve is not a trimming curve
+     ***********/
+    int getPatchBLTrCurveIndex() const {
+        return patchBLTrCurveIndex;
+    }
+
     /***********************************************************************************************
      * \brief get curveNumGP
      * \author Andreas Apostolatos, Altug Emiroglu
@@ -32,8 +32,10 @@
 #include "IGAPatchSurface.h"
 #include "ClipperAdapter.h"
 #include "TriangulatorAdaptor.h"
+#include "MonotonicArena.h"
 #include "MathLibrary.h"
 #include "Message.h"
+#include "CouplingMatricesCache.h"
 
 using namespace std;
 
@@ -86,47 +88,10 @@ void WeakIGADirichletSurfaceCondition::createGPData(const std::vector<IGAPatchSu
 
     // Gauss quadrature for the triangles
     WARNING_OUT("In \"WeakIGADirichletSurfaceCondition::createGPData\", using a default number of 6 GPs per triangle.");
-    MathLibrary::IGAGaussQuadratureOnTriangle* gaussTriangle = new MathLibrary::IGAGaussQuadratureOnTriangle(6);
-
-    /// Make polygons out of knot spans
-    // Get the number of knots in each direction
-    int noUKnots = thePatch->getIGABasis()->getUBSplineBasis1D()->getNoKnots();
-    int noVKnots = thePatch->getIGABasis()->getVBSplineBasis1D()->getNoKnots();
-
-    // Get the knot vectors
-    double* uKnotVector = thePatch->getIGABasis()->getUBSplineBasis1D()->getKnotVector();
-    double* vKnotVector = thePatch->getIGABasis()->getVBSplineBasis1D()->getKnotVector();
-
-    // Count the number of knot spans
-    int noUSpans = 1;
-    for (int iKnot = 0; iKnot < noUKnots; iKnot++)
-        if(uKnotVector[iKnot] != uKnotVector[iKnot+1])
-            noUSpans++;
-
-    int noVSpans = 1;
-    for (int iKnot = 0; iKnot < noVKnots; iKnot++)
-        if(vKnotVector[iKnot] != vKnotVector[iKnot+1])
-            noVSpans++;
-
-    // Initiate a polygon list of knot span windows
-    ListPolygon2D knotSpanPolygonList;
-    // Loop over U knots
-    for (int iU = 0; iU <= noUSpans; iU++) {
-        // Loop over V knots
-        for (int iV = 0; iV <= noVSpans; iV++) {
-            if (uKnotVector[iU] != uKnotVector[iU + 1] && vKnotVector[iV] != vKnotVector[iV + 1]) {
-                // Create the knot span polygon
-                Polygon2D knotSpanPolygon(4);
-                knotSpanPolygon[0] = make_pair(uKnotVector[iU],vKnotVector[iV]);
-                knotSpanPolygon[1] = make_pair(uKnotVector[iU+1],vKnotVector[iV]);
-                knotSpanPolygon[2] = make_pair(uKnotVector[iU+1],vKnotVector[iV+1]);
-                knotSpanPolygon[3] = make_pair(uKnotVector[iU],vKnotVector[iV+1]);
-
-                // Store the knot span polygon
-                knotSpanPolygonList.push_back(knotSpanPolygon);
-            }
-        }
-    }
+    const MathLibrary::IGAGaussQuadrature* gaussTriangle = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_TRIANGLE, 6);
+
+    // The knot spans of the patch clipped by its trimming, computed by IGAMesh::prepareIntegrationCells
+    const std::vector<IGAPatchSurface::IntegrationCell>& integrationCells = thePatch->getIntegrationCells();
 
     /// Create the GP data
     // In case the trimming loop is a boundary loop of a patch set the conditionBoundaryLoop object
@@ -135,20 +100,22 @@ void WeakIGADirichletSurfaceCondition::createGPData(const std::vector<IGAPatchSu
 
     // Initialize variables
     int derivDegree = 1;
-    int uKnotSpan;
-    int vKnotSpan;
     int noLocalBasisFunctions = (p + 1) * (q + 1);
     double localBasisFunctionsAndDerivatives[(derivDegree + 1) * (derivDegree + 2)
             * noLocalBasisFunctions / 2];
     double baseVectors[6];
     std::vector<double> tmpGPData; // temporary vector to store the created GP data
 
-    // Loop over knot span windows
-    for (int iPolygon = 0; iPolygon < knotSpanPolygonList.size(); iPolygon++) {
+    // Loop over the integration cells of the knot spans
+    for (int iCell = 0; iCell < integrationCells.size(); iCell++) {
+
+        // The clipping and triangulation temporaries of the knot span are released at its end
+        MonotonicArena::Scope arenaScope(MonotonicArena::getThreadArena());
 
-        // Clip the knot span windows with the boundary loops of the patch
-        ListPolygon2D trimClippedPolygonList;
-        clipByTrimming(thePatch, knotSpanPolygonList[iPolygon], trimClippedPolygonList);
+        // The knot span window clipped by the boundary loops of the patch
+        const ListPolygon2D& trimClippedPolygonList = integrationCells[iCell].polygons;
+        const int uKnotSpan = integrationCells[iCell].spanU;
+        const int vKnotSpan = integrationCells[iCell].spanV;
 
         for (int iTCW = 0; iTCW < trimClippedPolygonList.size(); iTCW++) {
 
@@ -187,8 +154,6 @@ void WeakIGADirichletSurfaceCondition::createGPData(const std::vector<IGAPatchSu
                         MathLibrary::computeLinearCombination(numNodes, 2, triaUV, shapeFuncs, uvGP);
 
                         // Compute base vectors on GP
-                        uKnotSpan = thePatch->findSpanU(uvGP[0]);
-                        vKnotSpan = thePatch->findSpanV(uvGP[1]);
                         thePatch->getIGABasis()->computeLocalBasisFunctionsAndDerivatives(
                                     localBasisFunctionsAndDerivatives, derivDegree, uvGP[0], uKnotSpan, uvGP[1], vKnotSpan);
                         thePatch->computeBaseVectors(baseVectors, localBasisFunctionsAndDerivatives, uKnotSpan, vKnotSpan);
@@ -224,20 +189,6 @@ void WeakIGADirichletSurfaceCondition::createGPData(const std::vector<IGAPatchSu
     isGPDataInitialized = true;
 }
 
-void WeakIGADirichletSurfaceCondition::clipByTrimming(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygonUV) {
-    ClipperAdapter c;
-    // Fill clipper with trimming clipping curves
-    for(int loop=0;loop<_thePatch->getTrimming().getNumOfLoops();loop++) {
-        const std::vector<double> patchClippingWindow=_thePatch->getTrimming().getLoop(loop).getPolylines();
-        c.addPathClipper(patchClippingWindow);
-    }
-    // Setup filling rule to have for sure clockwise loop as hole and counterclockwise as boundaries
-    c.setFilling(ClipperAdapter::POSITIVE, 0);
-    c.addPathSubject(_polygonUV);
-    c.clip();
-    c.getSolution(_listPolygonUV);
-}
-
 void WeakIGADirichletSurfaceCondition::clipByCondition(const IGAPatchSurfaceTrimmingLoop* _theTrimmingLoop, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygonUV) {
     ClipperAdapter c;
     // Fill clipper with trimming loop to clip with
@@ -251,28 +202,46 @@ void WeakIGADirichletSurfaceCondition::clipByCondition(const IGAPatchSurfaceTrim
 }
 
 WeakIGADirichletSurfaceCondition::ListPolygon2D WeakIGADirichletSurfaceCondition::triangulatePolygon(const Polygon2D& _polygonUV) {
-    // If already easily integrable by quadrature rule, do nothing
-    if(_polygonUV.size()<4)
-        return ListPolygon2D(1,_polygonUV);
-    // Otherwise triangulate polygon
-    TriangulatorAdaptor triangulator;
-    // Fill adapter
-    for(Polygon2D::const_iterator it=_polygonUV.begin();it!=_polygonUV.end();it++)
-        triangulator.addPoint(it->first,it->second,0);
-    // Triangulate
-    int numTriangles = _polygonUV.size() - 2;
-    int triangleIndexes[3 * numTriangles];
-    bool triangulated=triangulator.triangulate(triangleIndexes);
-    if(!triangulated)
-        return ListPolygon2D();
-    // Fill output structure
-    ListPolygon2D out(numTriangles, Polygon2D(3));
-    for(int i = 0; i < numTriangles; i++)
-        for(int j=0;j<3;j++)
-            out[i][j]=_polygonUV[triangleIndexes[3*i + j]];
+    // Triangles are kept, small polygons are split as a fan or by ear clipping, the others by polypartition
+    ListPolygon2D out;
+    TriangulatorAdaptor::triangulatePolygon(_polygonUV, out);
     return out;
 }
 
+void WeakIGADirichletSurfaceCondition::writeGPDataToCache(CouplingMatricesCache* _cache, const std::string& _prefix) const {
+    assert(isGPDataInitialized);
+    double numGP = surfaceNumGP;
+    _cache->setVector(_prefix + "numGP", &numGP, 1);
+    _cache->setVector(_prefix + "GPs", surfaceGPs, surfaceNumGP * 2);
+    _cache->setVector(_prefix + "GPWeights", surfaceGPWeights, surfaceNumGP);
+    _cache->setVector(_prefix + "GPJacobians", surfaceGPJacobians, surfaceNumGP);
+}
+
+bool WeakIGADirichletSurfaceCondition::readGPDataFromCache(const CouplingMatricesCache* _cache, const std::string& _prefix) {
+    if (isGPDataInitialized) assert(false);
+    double numGP;
+    if (!_cache->getVector(_prefix + "numGP", 1, &numGP))
+        return false;
+    const int n = (int) numGP;
+    double* GPs = new double[2 * n + 1];
+    double* GPWeights = new double[n + 1];
+    double* GPJacobians = new double[n + 1];
+    if (!_cache->getVector(_prefix + "GPs", 2 * n, GPs)
+            || !_cache->getVector(_prefix + "GPWeights", n, GPWeights)
+            || !_cache->getVector(_prefix + "GPJacobians", n, GPJacobians)) {
+        delete[] GPs;
+        delete[] GPWeights;
+        delete[] GPJacobians;
+        return false;
+    }
+    surfaceNumGP = n;
+    surfaceGPs = GPs;
+    surfaceGPWeights = GPWeights;
+    surfaceGPJacobians = GPJacobians;
+    isGPDataInitialized = true;
+    return true;
+}
+
 WeakIGADirichletSurfaceCondition::~WeakIGADirichletSurfaceCondition() {
     if (!isBoundaryLoop)
         delete conditionBoundaryLoop;
@@ -96,21 +96,22 @@ public:
                                      int _patchIndex, int _patchBLIndex);
 
     /***********************************************************************************************
-     * \brief Create the GP data for the Dirichlet condition
+     * \brief Create the GP data for the Dirichlet condition on the integration cells of the patch,
+     *        which must be computed by IGAMesh::prepareIntegrationCells before
      * \param[in] _patch The patch on which the boundary loop exists
      * \author Andreas Apostolatos, Altug Emiroglu
      ***********/
     void createGPData(const std::vector<IGAPatchSurface*>& _surfacePatches);
 
     /***********************************************************************************************
-     * \brief Clip the input polygon by the trimming curves of the given patch
-     * This function does the same as in IGAMortarMapper
-     * \param[in] _thePatch 	The patch for which trimming curves are used
-     * \param[in] _polygonUV 	An input polygon defined in parametric (i.e. 2D) space
-     * \param[out] _listPolygon	A set of polygons after application of trimming polygon
-     * \author Altug Emiroglu
+     * \brief Store the GP data in a cache, see AbstractCondition::writeGPDataToCache
+     ***********/
+    void writeGPDataToCache(CouplingMatricesCache* _cache, const std::string& _prefix) const;
+
+    /***********************************************************************************************
+     * \brief Read the GP data from a cache, see AbstractCondition::readGPDataFromCache
      ***********/
-    void clipByTrimming(const IGAPatchSurface* _thePatch, const Polygon2D& _polygonUV, ListPolygon2D& _listPolygonUV);
+    bool readGPDataFromCache(const CouplingMatricesCache* _cache, const std::string& _prefix);
 
     /***********************************************************************************************
      * \brief Clip the input polygon by the trimming window of the given trimming loop
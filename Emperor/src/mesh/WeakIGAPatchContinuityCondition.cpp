@@ -32,6 +32,7 @@
 #include "WeakIGAPatchContinuityCondition.h"
 #include "MathLibrary.h"
 #include "Message.h"
+#include "CouplingMatricesCache.h"
 
 using namespace std;
 
@@ -200,7 +201,7 @@ void WeakIGAPatchContinuityCondition::createGPData(const std::vector<IGAPatchSur
     int numGPPerSection = p+1;
 
     // Create a Gauss quadrature rule
-    MathLibrary::IGAGaussQuadratureOnBiunitInterval* theGPQuadrature = new MathLibrary::IGAGaussQuadratureOnBiunitInterval(numGPPerSection);
+    const MathLibrary::IGAGaussQuadrature* theGPQuadrature = MathLibrary::getIGAGaussQuadrature(MathLibrary::IGA_QUADRATURE_BIUNIT_INTERVAL, numGPPerSection);
 
     // Initialize auxiliary variables
     double GP;
@@ -371,20 +372,20 @@ void WeakIGAPatchContinuityCondition::createGPData(const std::vector<IGAPatchSur
             }
 
             // Compute the tangent vector on the physical space
-            MathLibrary::computeDenseVectorMultiplicationScalar(A1Master, baseVectorTrCurveMaster[0], noCoord);
-            MathLibrary::computeDenseVectorMultiplicationScalar(A2Master, baseVectorTrCurveMaster[1], noCoord);
-            MathLibrary::computeDenseVectorAddition(A1Master, A2Master, 1.0, noCoord);
-            MathLibrary::computeDenseVectorMultiplicationScalar(A1Slave, baseVectorTrCurveSlave[0], noCoord);
-            MathLibrary::computeDenseVectorMultiplicationScalar(A2Slave, baseVectorTrCurveSlave[1], noCoord);
-            MathLibrary::computeDenseVectorAddition(A1Slave, A2Slave, 1.0, noCoord);
+            MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A1Master, baseVectorTrCurveMaster[0]);
+            MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A2Master, baseVectorTrCurveMaster[1]);
+            MathLibrary::computeDenseVectorAddition<noCoord>(A1Master, A2Master, 1.0);
+            MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A1Slave, baseVectorTrCurveSlave[0]);
+            MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A2Slave, baseVectorTrCurveSlave[1]);
+            MathLibrary::computeDenseVectorAddition<noCoord>(A1Slave, A2Slave, 1.0);
 
             // Compute the determinant of the Jacobian of the transformation from the parameter space to the physical space
-            detJ2Master = MathLibrary::vector2norm(A1Master, noCoord);
-            detJ2Slave = MathLibrary::vector2norm(A1Slave, noCoord);
+            detJ2Master = MathLibrary::vector2norm<noCoord>(A1Master);
+            detJ2Slave = MathLibrary::vector2norm<noCoord>(A1Slave);
 
             // Normalize the tangent vectors
-            MathLibrary::computeDenseVectorMultiplicationScalar(A1Master, 1.0/detJ2Master, noCoord);
-            MathLibrary::computeDenseVectorMultiplicationScalar(A1Slave, 1.0/detJ2Slave, noCoord);
+            MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A1Master, 1.0/detJ2Master);
+            MathLibrary::computeDenseVectorMultiplicationScalar<noCoord>(A1Slave, 1.0/detJ2Slave);
 
             for(int iCoord = 0; iCoord < noCoord; iCoord++) {
                 trCurveMasterGPTangents[noCoord*counterGP + iCoord] = A1Master[iCoord];
@@ -405,9 +406,37 @@ void WeakIGAPatchContinuityCondition::createGPData(const std::vector<IGAPatchSur
     // Set the initialized flag to true
     isGPDataInitialized = true;
 
-    // Delete pointers
-    delete theGPQuadrature;
+}
+
+void WeakIGAPatchContinuityCondition::writeGPDataToCache(CouplingMatricesCache* _cache, const std::string& _prefix) const {
+    assert(isGPDataInitialized);
+    double numGP = trCurveNumGP;
+    _cache->setVector(_prefix + "numGP", &numGP, 1);
+    _cache->setVector(_prefix + "masterGPs", trCurveMasterGPs, trCurveNumGP * 2);
+    _cache->setVector(_prefix + "slaveGPs", trCurveSlaveGPs, trCurveNumGP * 2);
+    _cache->setVector(_prefix + "GPWeights", trCurveGPWeights, trCurveNumGP);
+    _cache->setVector(_prefix + "masterGPTangents", trCurveMasterGPTangents, trCurveNumGP * 3);
+    _cache->setVector(_prefix + "slaveGPTangents", trCurveSlaveGPTangents, trCurveNumGP * 3);
+    _cache->setVector(_prefix + "GPJacobianProducts", trCurveGPJacobianProducts, trCurveNumGP);
+}
 
+bool WeakIGAPatchContinuityCondition::readGPDataFromCache(const CouplingMatricesCache* _cache, const std::string& _prefix) {
+    double numGP;
+    if (!_cache->getVector(_prefix + "numGP", 1, &numGP))
+        return false;
+    const int n = (int) numGP;
+    std::vector<double> masterGPs(2 * n + 1), slaveGPs(2 * n + 1), GPWeights(n + 1),
+            masterGPTangents(3 * n + 1), slaveGPTangents(3 * n + 1), GPJacobianProducts(n + 1);
+    if (!_cache->getVector(_prefix + "masterGPs", 2 * n, &masterGPs[0])
+            || !_cache->getVector(_prefix + "slaveGPs", 2 * n, &slaveGPs[0])
+            || !_cache->getVector(_prefix + "GPWeights", n, &GPWeights[0])
+            || !_cache->getVector(_prefix + "masterGPTangents", 3 * n, &masterGPTangents[0])
+            || !_cache->getVector(_prefix + "slaveGPTangents", 3 * n, &slaveGPTangents[0])
+            || !_cache->getVector(_prefix + "GPJacobianProducts", n, &GPJacobianProducts[0]))
+        return false;
+    addWeakContinuityConditionGPData(n, &masterGPs[0], &slaveGPs[0], &GPWeights[0],
+            &masterGPTangents[0], &slaveGPTangents[0], &GPJacobianProducts[0]);
+    return true;
 }
 
 WeakIGAPatchContinuityCondition::~WeakIGAPatchContinuityCondition() {
@@ -166,6 +166,16 @@ public:
      ***********/
     void createGPData(const std::vector<IGAPatchSurface*>& _surfacePatches);
 
+    /***********************************************************************************************
+     * \brief Store the GP data in a cache, see AbstractCondition::writeGPDataToCache
+     ***********/
+    void writeGPDataToCache(CouplingMatricesCache* _cache, const std::string& _prefix) const;
+
+    /***********************************************************************************************
+     * \brief Read the GP data from a cache, see AbstractCondition::readGPDataFromCache
+     ***********/
+    bool readGPDataFromCache(const CouplingMatricesCache* _cache, const std::string& _prefix);
+
     /***********************************************************************************************
      * \brief Destructor
      * \author Andreas Apostolatos, Altug Emiroglu
@@ -0,0 +1,119 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "AsyncOutputWriter.h"
+#include "Message.h"
+#include "BufferPool.h"
+#include <assert.h>
+#include <stdlib.h>
+
+using namespace std;
+
+namespace EMPIRE {
+
+AsyncOutputWriter::AsyncOutputWriter(int _queueDepth) :
+        queueDepth(_queueDepth), busy(false), stopRequested(false) {
+    assert(queueDepth >= 0);
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&taskPushed, NULL);
+    pthread_cond_init(&taskDone, NULL);
+    if (isAsynchronous()) {
+        if (pthread_create(&thread, NULL, threadEntry, this) != 0) {
+            ERROR_OUT() << "Cannot start the output writer thread" << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+AsyncOutputWriter::~AsyncOutputWriter() {
+    if (isAsynchronous()) {
+        pthread_mutex_lock(&mutex);
+        stopRequested = true;
+        pthread_cond_signal(&taskPushed);
+        pthread_mutex_unlock(&mutex);
+        pthread_join(thread, NULL); // the thread executes all remaining tasks before it stops
+    }
+    assert(queue.empty());
+    pthread_cond_destroy(&taskDone);
+    pthread_cond_destroy(&taskPushed);
+    pthread_mutex_destroy(&mutex);
+}
+
+void AsyncOutputWriter::push(AbstractOutputTask *task) {
+    if (!isAsynchronous()) {
+        task->execute();
+        delete task;
+        return;
+    }
+    pthread_mutex_lock(&mutex);
+    while (queue.size() >= queueDepth)
+        pthread_cond_wait(&taskDone, &mutex);
+    queue.push_back(task);
+    pthread_cond_signal(&taskPushed);
+    pthread_mutex_unlock(&mutex);
+}
+
+void AsyncOutputWriter::flush() {
+    if (!isAsynchronous())
+        return;
+    pthread_mutex_lock(&mutex);
+    while (!queue.empty() || busy)
+        pthread_cond_wait(&taskDone, &mutex);
+    pthread_mutex_unlock(&mutex);
+}
+
+double *AsyncOutputWriter::acquireBuffer(int size) {
+    return BufferPool::acquire(size);
+}
+
+void AsyncOutputWriter::releaseBuffer(double *buffer, int size) {
+    BufferPool::release(buffer);
+}
+
+void AsyncOutputWriter::run() {
+    while (true) {
+        pthread_mutex_lock(&mutex);
+        while (queue.empty() && !stopRequested)
+            pthread_cond_wait(&taskPushed, &mutex);
+        if (queue.empty()) { // stop requested and nothing left to do
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+        AbstractOutputTask *task = queue.front();
+        queue.pop_front();
+        busy = true;
+        pthread_mutex_unlock(&mutex);
+
+        task->execute();
+        delete task;
+
+        pthread_mutex_lock(&mutex);
+        busy = false;
+        pthread_cond_broadcast(&taskDone);
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+void *AsyncOutputWriter::threadEntry(void *writer) {
+    static_cast<AsyncOutputWriter*>(writer)->run();
+    return NULL;
+}
+
+} /* namespace EMPIRE */
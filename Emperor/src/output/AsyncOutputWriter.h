@@ -0,0 +1,131 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file AsyncOutputWriter.h
+ * This file holds the class AsyncOutputWriter
+ * \date 10/14/2026
+ **************************************************************************************************/
+#ifndef ASYNCOUTPUTWRITER_H_
+#define ASYNCOUTPUTWRITER_H_
+
+#include <deque>
+#include <pthread.h>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class AbstractOutputTask is a piece of output (formatting and file I/O) executed by an
+ *        AsyncOutputWriter
+ ***********/
+class AbstractOutputTask {
+public:
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~AbstractOutputTask() {
+    }
+    /***********************************************************************************************
+     * \brief Do the output
+     ***********/
+    virtual void execute() = 0;
+};
+
+/********//**
+ * \brief Class AsyncOutputWriter executes output tasks on a dedicated writer thread, such that the
+ *        coupling thread does not wait for the disk. The tasks are executed in the order they are
+ *        pushed. The queue is bounded: push blocks while queueDepth tasks are waiting. With
+ *        queueDepth 0 no thread is started and push executes the task immediately.
+ *        The snapshots of the data are buffers of the BufferPool, so that they are not allocated
+ *        at every output step.
+ ***********/
+class AsyncOutputWriter {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, starts the writer thread
+     * \param[in] _queueDepth maximum number of tasks waiting in the queue
+     ***********/
+    AsyncOutputWriter(int _queueDepth);
+    /***********************************************************************************************
+     * \brief Destructor, executes all pushed tasks and stops the writer thread
+     ***********/
+    virtual ~AsyncOutputWriter();
+    /***********************************************************************************************
+     * \brief Push a task to the queue, blocks while the queue is full
+     * \param[in] task the task, it is deleted after its execution
+     ***********/
+    void push(AbstractOutputTask *task);
+    /***********************************************************************************************
+     * \brief Wait until all pushed tasks are executed
+     ***********/
+    void flush();
+    /***********************************************************************************************
+     * \brief Get a buffer from the BufferPool, thread safe
+     * \param[in] size number of doubles needed
+     * \return a buffer of at least size doubles
+     ***********/
+    double *acquireBuffer(int size);
+    /***********************************************************************************************
+     * \brief Give a buffer back to the BufferPool, thread safe
+     * \param[in] buffer the buffer got by acquireBuffer
+     * \param[in] size the size given to acquireBuffer
+     ***********/
+    void releaseBuffer(double *buffer, int size);
+    /***********************************************************************************************
+     * \brief Whether the tasks are executed by a writer thread
+     * \return false if the queue depth is 0
+     ***********/
+    bool isAsynchronous() const {
+        return queueDepth > 0;
+    }
+
+private:
+    /// maximum number of tasks waiting in the queue
+    const int queueDepth;
+    /// the tasks waiting in the queue
+    std::deque<AbstractOutputTask*> queue;
+    /// whether the writer thread is executing a task
+    bool busy;
+    /// whether the writer thread should stop after the queue is empty
+    bool stopRequested;
+    /// the writer thread
+    pthread_t thread;
+    /// protects queue, busy and stopRequested
+    pthread_mutex_t mutex;
+    /// signaled when a task is pushed or a stop is requested
+    pthread_cond_t taskPushed;
+    /// signaled when a task is executed
+    pthread_cond_t taskDone;
+    /***********************************************************************************************
+     * \brief The loop of the writer thread
+     ***********/
+    void run();
+    /***********************************************************************************************
+     * \brief Entry point of the writer thread
+     * \param[in] writer the AsyncOutputWriter
+     ***********/
+    static void *threadEntry(void *writer);
+    /// disallow copy constructor
+    AsyncOutputWriter(const AsyncOutputWriter&);
+    /// disallow assignment operator
+    AsyncOutputWriter& operator=(const AsyncOutputWriter&);
+};
+
+} /* namespace EMPIRE */
+#endif /* ASYNCOUTPUTWRITER_H_ */
@@ -0,0 +1,129 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <assert.h>
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "BuildProgress.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+double BuildProgress::interval = 60.0;
+std::string BuildProgress::fileName = "";
+
+BuildProgress::BuildProgress(const std::string &_stageName, const std::string &_itemName,
+        long _numItems) :
+        stageName(_stageName), itemName(_itemName), numItems(_numItems), numDone(0),
+        isReported(false), isFinished(false) {
+    startTime = omp_get_wtime();
+    nextReportTime = interval > 0.0 ? startTime + interval : -1.0;
+}
+
+void BuildProgress::add(long _numDone) {
+#pragma omp atomic
+    numDone += _numDone;
+    if (interval <= 0.0)
+        return;
+    double reportTime;
+#pragma omp atomic read
+    reportTime = nextReportTime;
+    // only one thread reports, the others go on
+    double now = omp_get_wtime();
+    if (now < reportTime)
+        return;
+#pragma omp critical (BuildProgress)
+    {
+        if (now >= nextReportTime) {
+#pragma omp atomic write
+            nextReportTime = now + interval;
+            report(now);
+        }
+    }
+}
+
+void BuildProgress::finish() {
+    if (isFinished)
+        return;
+    isFinished = true;
+    if (isReported)
+        report(omp_get_wtime());
+}
+
+long BuildProgress::getNumDone() const {
+    long done;
+#pragma omp atomic read
+    done = numDone;
+    return done;
+}
+
+std::string BuildProgress::formatLine(const std::string &stageName, const std::string &itemName,
+        long numDone, long numItems, double elapsed) {
+    stringstream line;
+    line << fixed << setprecision(1);
+    line << stageName << ": " << numDone << " of " << numItems << " " << itemName;
+    if (numItems > 0)
+        line << " (" << 100.0 * numDone / numItems << "%)";
+    line << ", elapsed " << elapsed << " s";
+    if (numDone >= numItems) {
+        line << ", done";
+    } else if (numDone > 0 && elapsed > 0.0) {
+        double rate = numDone / elapsed;
+        line << ", " << rate << " " << itemName << "/s, remaining about "
+                << (numItems - numDone) / rate << " s";
+    }
+    return line.str();
+}
+
+void BuildProgress::setInterval(double seconds) {
+    interval = seconds;
+}
+
+void BuildProgress::setFile(const std::string &_fileName) {
+    fileName = _fileName;
+}
+
+void BuildProgress::report(double now) {
+    isReported = true;
+    string line = formatLine(stageName, itemName, getNumDone(), numItems, now - startTime);
+    if (Message::isInfoMode()) {
+        // the messages of the worker threads are queued until the end of the parallel region
+        CRITICAL_OUTPUT
+        cout << "EMPIRE_INFO: " << line << endl;
+    }
+    if (fileName.empty())
+        return;
+    // the file is replaced at once, such that it is never read half written
+    string tmpFileName = fileName + ".tmp";
+    {
+        ofstream file(tmpFileName.c_str());
+        file << line << endl;
+    }
+    if (rename(tmpFileName.c_str(), fileName.c_str()) != 0)
+        WARNING_OUT() << "Cannot write the progress file " << fileName << endl;
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,130 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file BuildProgress.h
+ * This file holds the class BuildProgress
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef BUILDPROGRESS_H_
+#define BUILDPROGRESS_H_
+
+#include <string>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class BuildProgress reports the progress of a long stage of a build (e.g. the clipping
+ *        and integration of the elements of a mapper). The items done are counted from any
+ *        thread, the first thread which counts an item after the report interval has passed
+ *        writes a line with the items done, the rate and the estimated remaining time to the
+ *        terminal and, if set, to the progress file. The lines are written directly, not queued
+ *        like the messages of the worker threads, such that they show up while the stage runs.
+ *        The progress file is replaced at every report and holds the last line only.
+ *        A stage which ends before the first report writes nothing.
+ ***********/
+class BuildProgress {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, starts the stage
+     * \param[in] _stageName the name of the stage, e.g. "IGAMortarMapper: clipping and integration"
+     * \param[in] _itemName the name of the items in plural, e.g. "elements"
+     * \param[in] _numItems the number of items of the stage
+     ***********/
+    BuildProgress(const std::string &_stageName, const std::string &_itemName, long _numItems);
+    /***********************************************************************************************
+     * \brief Destructor, ends the stage
+     ***********/
+    ~BuildProgress() {
+        finish();
+    }
+    /***********************************************************************************************
+     * \brief Count items as done, thread safe
+     * \param[in] numDone the number of items done
+     ***********/
+    void add(long numDone = 1);
+    /***********************************************************************************************
+     * \brief End the stage, a final line is written if the stage was reported before
+     ***********/
+    void finish();
+    /***********************************************************************************************
+     * \brief Get the number of items done
+     ***********/
+    long getNumDone() const;
+    /***********************************************************************************************
+     * \brief Get the line of a report
+     * \param[in] stageName the name of the stage
+     * \param[in] itemName the name of the items
+     * \param[in] numDone the number of items done
+     * \param[in] numItems the number of items of the stage
+     * \param[in] elapsed the seconds since the start of the stage
+     * \return the line without newline
+     ***********/
+    static std::string formatLine(const std::string &stageName, const std::string &itemName,
+            long numDone, long numItems, double elapsed);
+    /***********************************************************************************************
+     * \brief Set the seconds between two reports of a stage
+     * \param[in] seconds the interval, 0 or less disables the reports
+     ***********/
+    static void setInterval(double seconds);
+    /***********************************************************************************************
+     * \brief Get the seconds between two reports of a stage
+     ***********/
+    static double getInterval() {
+        return interval;
+    }
+    /***********************************************************************************************
+     * \brief Write every report also to a file, which holds the last line only
+     * \param[in] fileName the name of the file, an empty name disables the file
+     ***********/
+    static void setFile(const std::string &fileName);
+private:
+    /***********************************************************************************************
+     * \brief Write a report
+     * \param[in] now the wall time
+     ***********/
+    void report(double now);
+    /// the name of the stage
+    std::string stageName;
+    /// the name of the items
+    std::string itemName;
+    /// the number of items of the stage
+    long numItems;
+    /// the number of items done
+    long numDone;
+    /// the wall time at the start of the stage
+    double startTime;
+    /// the wall time of the next report
+    double nextReportTime;
+    /// whether a report was written
+    bool isReported;
+    /// whether the stage has ended
+    bool isFinished;
+    /// the seconds between two reports, 0 or less disables the reports
+    static double interval;
+    /// the name of the progress file, empty if there is none
+    static std::string fileName;
+    BuildProgress(const BuildProgress&);
+    BuildProgress& operator=(const BuildProgress&);
+};
+
+} /* namespace EMPIRE */
+
+#endif /* BUILDPROGRESS_H_ */
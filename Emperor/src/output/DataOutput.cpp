@@ -1,297 +1,740 @@
-/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
- *  Stefan Sicklinger, Tianyang Wang, Munich
- *
- *  All rights reserved.
- *
- *  This file is part of EMPIRE.
- *
- *  EMPIRE is free software: you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation, either version 3 of the License, or
- *  (at your option) any later version.
- *
- *  EMPIRE is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
- */
-#include "DataOutput.h"
-#include "Emperor.h"
-#include "MetaDataStructures.h"
-#include "GiDFileIO.h"
-#include "MatlabIGAFileIO.h"
-#include "GiDIGAFileIO.h" //
-#include "AbstractMesh.h"
-#include "FEMesh.h"
-#include "IGAMesh.h"
-#include "DataField.h"
-#include "ClientCode.h"
-#include "Signal.h"
-
-#include <assert.h>
-#include <iostream>
-#include <map>
-#include <fstream>
-
-using namespace std;
-
-namespace EMPIRE {
-
-DataOutput::DataOutput(const structDataOutput &_settingDataOutput,
-        std::map<std::string, ClientCode*> &_nameToClientCodeMap) :
-        settingDataOutput(_settingDataOutput), nameToClientCodeMap(_nameToClientCodeMap) {
-}
-
-DataOutput::~DataOutput() {
-}
-
-void DataOutput::init(std::string rearPart) {
-    dataOutputName = settingDataOutput.name;
-    dataOutputName.append(rearPart);
-    writeMeshes();
-    initDataFieldFiles();
-    initSignalFiles();
-}
-
-void DataOutput::writeCurrentStep(int step) {
-    writeDataFields(step);
-    writeSignals(step);
-}
-
-void DataOutput::writeMeshes() {
-    vector<structDataFieldRef> dataFieldRefs;
-    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
-        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_DataField)
-            dataFieldRefs.push_back(settingDataOutput.connectionIOs[i].dataFieldRef);
-    }
-    // get rid of repeated meshes
-    map<string, AbstractMesh*> meshFileNameToMeshMap;
-    for (int i = 0; i < dataFieldRefs.size(); i++) {
-        const string UNDERSCORE = "_";
-        string clientCodeName = dataFieldRefs[i].clientCodeName;
-        string meshName = dataFieldRefs[i].meshName;
-        string meshFileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE + meshName;
-
-        assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
-        AbstractMesh *mesh = nameToClientCodeMap[clientCodeName]->getMeshByName(meshName);
-        meshFileNameToMeshMap.insert(pair<string, AbstractMesh*>(meshFileName, mesh));
-    }
-    // write meshes
-    for (map<string, AbstractMesh*>::iterator it = meshFileNameToMeshMap.begin();
-            it != meshFileNameToMeshMap.end(); it++) {
-        string meshFileName = it->first;
-        if (it->second->type == EMPIRE_Mesh_FEMesh || it->second->type == EMPIRE_Mesh_SectionMesh) {
-            FEMesh *mesh = dynamic_cast<FEMesh*>(it->second);
-            meshFileName.append(".msh");
-            if (mesh->triangulate() != NULL)
-                mesh = mesh->triangulate();
-            GiDFileIO::writeDotMsh(meshFileName, mesh->numNodes, mesh->numElems, mesh->nodes,
-                    mesh->nodeIDs, mesh->numNodesPerElem, mesh->elems, mesh->elemIDs);
-        } else if (it->second->type == EMPIRE_Mesh_IGAMesh) {
-            IGAMesh* igaMesh = dynamic_cast<IGAMesh*>(it->second);
-            GiDIGAFileIO::writeIGAMesh(meshFileName, igaMesh);
-            //MatlabIGAFileIO::writeIGAMesh(igaMesh);
-        } else
-            ERROR_BLOCK_OUT("DataOutput","writeMeshes","Writer defined only for FEMesh,SectionMesh,IGAMesh");
-    }
-}
-
-void DataOutput::initDataFieldFiles() {
-    vector<structDataFieldRef> dataFieldRefs;
-    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
-        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_DataField)
-            dataFieldRefs.push_back(settingDataOutput.connectionIOs[i].dataFieldRef);
-    }
-    // get rid of repeated data field files (one data field file corresponds to multiple data fields of a single mesh)
-    map<string, FEMesh*> dataFieldFileNameToMeshMap;
-    for (int i = 0; i < dataFieldRefs.size(); i++) {
-        const string UNDERSCORE = "_";
-        string clientCodeName = dataFieldRefs[i].clientCodeName;
-        string meshName = dataFieldRefs[i].meshName;
-        string dataFieldFileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE
-                + meshName;
-
-        assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
-        AbstractMesh *mesh = nameToClientCodeMap[clientCodeName]->getMeshByName(meshName);
-        if (mesh->type == EMPIRE_Mesh_FEMesh || mesh->type == EMPIRE_Mesh_SectionMesh) {
-        	dataFieldFileName.append(".res");
-            FEMesh *feMesh = dynamic_cast<FEMesh*>(mesh);
-            dataFieldFileNameToMeshMap.insert(pair<string, FEMesh*>(dataFieldFileName, feMesh));
-        } else if (mesh->type == EMPIRE_Mesh_IGAMesh) {
-        	GiDIGAFileIO::initDotPostRes(dataFieldFileName);
-        } else
-            assert(0);
-    }
-    for (map<string, FEMesh*>::iterator it = dataFieldFileNameToMeshMap.begin();
-            it != dataFieldFileNameToMeshMap.end(); it++) {
-        string dataFieldFileName = it->first;
-        FEMesh *mesh = it->second;
-
-        GiDFileIO::initDotRes(dataFieldFileName); // TODO enable output write data on element center of hybrid mesh
-    }
-}
-
-void DataOutput::writeDataFields(int step) {
-    int interval = settingDataOutput.interval;
-    if (step % interval == 0) {
-        vector<structDataFieldRef> dataFieldRefs;
-        for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
-            if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_DataField)
-                dataFieldRefs.push_back(settingDataOutput.connectionIOs[i].dataFieldRef);
-        }
-
-        for (int i = 0; i < dataFieldRefs.size(); i++) {
-            const structDataFieldRef &dataFieldRef = dataFieldRefs[i];
-            string clientCodeName = dataFieldRef.clientCodeName;
-            string meshName = dataFieldRef.meshName;
-            string dataFieldName = dataFieldRef.dataFieldName;
-            AbstractMesh *mesh = nameToClientCodeMap[clientCodeName]->getMeshByName(meshName);
-            const string UNDERSCORE = "_";
-            string dataFieldFileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE
-                    + meshName;
-            if (mesh->type == EMPIRE_Mesh_FEMesh || mesh->type == EMPIRE_Mesh_SectionMesh) {
-            	dataFieldFileName.append(".res");
-                FEMesh *feMesh = dynamic_cast<FEMesh*>(mesh);
-                DataField *dataField = feMesh->getDataFieldByName(dataFieldName);
-                bool atNode = (dataField->location == EMPIRE_DataField_atNode ? true : false);
-                int *locationIDs = (atNode ? feMesh->nodeIDs : feMesh->elemIDs);
-                string type;
-                if (dataField->dimension == EMPIRE_DataField_vector) {
-                    type = "Vector";
-                    string tmpdataFieldName = "\"" + dataFieldName + "\"";
-                    if (atNode) {
-                        GiDFileIO::appendNodalDataToDotRes(dataFieldFileName, tmpdataFieldName,
-                                "\"EMPIRE_CoSimulation\"", step, type, dataField->numLocations,
-                                locationIDs, dataField->data);
-                    } else {
-                        if (feMesh->triangulate() == NULL) {
-                            GiDFileIO::appendElementalDataToDotRes(dataFieldFileName,
-                                    tmpdataFieldName, "\"EMPIRE_CoSimulation\"", step, type,
-                                    dataField->numLocations, locationIDs, feMesh->numNodesPerElem,
-                                    dataField->data);
-                        } else {
-                            assert(false); // writing out data field on element certeroid of triangulated mesh is not implemented yet
-                        }
-                    }
-                } else if (dataField->dimension == EMPIRE_DataField_scalar) {
-                    type = "Scalar";
-                    string tmpdataFieldName = "\"" + dataFieldName + "\"";
-                    if (atNode) {
-                        GiDFileIO::appendNodalDataToDotRes(dataFieldFileName, tmpdataFieldName,
-                                "\"EMPIRE_CoSimulation\"", step, type, dataField->numLocations,
-                                locationIDs, dataField->data);
-                    } else {
-                        if (feMesh->triangulate() == NULL) {
-                            GiDFileIO::appendElementalDataToDotRes(dataFieldFileName,
-                                    tmpdataFieldName, "\"EMPIRE_CoSimulation\"", step, type,
-                                    dataField->numLocations, locationIDs, feMesh->numNodesPerElem,
-                                    dataField->data);
-                        } else {
-                            assert(false); // writing out data field on element certeroid of triangulated mesh is not implemented yet
-                        }
-                    }
-                } else if (dataField->dimension == EMPIRE_DataField_doubleVector) {
-                    double *data1 = new double[dataField->numLocations * 3];
-                    double *data2 = new double[dataField->numLocations * 3];
-                    for (int j = 0; j < dataField->numLocations; j++) {
-                        for (int k = 0; k < 3; k++) {
-                            data1[j * 3 + k] = dataField->data[j * 6 + k];
-                            data2[j * 3 + k] = dataField->data[j * 6 + 3 + k];
-                        }
-                    }
-                    type = "Vector";
-                    if (atNode) {
-                        string dataFieldNameDisp = "\"" + dataFieldName + "_disp\"";
-                        GiDFileIO::appendNodalDataToDotRes(dataFieldFileName, dataFieldNameDisp,
-                                "\"EMPIRE_CoSimulation\"", step, type, dataField->numLocations,
-                                locationIDs, data1);
-                        string dataFieldNameRot = "\"" + dataFieldName + "_rot\"";
-                        GiDFileIO::appendNodalDataToDotRes(dataFieldFileName, dataFieldNameRot,
-                                "\"EMPIRE_CoSimulation\"", step, type, dataField->numLocations,
-                                locationIDs, data2);
-                    } else {
-                        assert(false);
-                    }
-                    delete[] data1;
-                    delete[] data2;
-                } else {
-                    assert(false);
-                }
-            } else if (mesh->type == EMPIRE_Mesh_IGAMesh) {
-                DataField *dataField = mesh->getDataFieldByName(dataFieldName);
-                //MatlabIGAFileIO::writeVectorFieldOnCPs(meshName, dataFieldName, step, dataField);
-
-                string type;
-                if (dataField->dimension == EMPIRE_DataField_vector) {type = "vector";}
-                else if (dataField->dimension == EMPIRE_DataField_scalar) {type = "scalar";}
-                else {assert(false);}
-
-				IGAMesh* igaMesh = dynamic_cast<IGAMesh*>(mesh);
-				GiDIGAFileIO::appendCPDataToDotRes(dataFieldFileName, dataFieldName,"\"EMPIRE_CoSimulation\"", step, type, dataField, igaMesh);
-            } else {
-                assert(0);
-            }
-        }
-    }
-}
-
-void DataOutput::initSignalFiles() {
-    vector<structSignalRef> signalRefs;
-    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
-        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_Signal)
-            signalRefs.push_back(settingDataOutput.connectionIOs[i].signalRef);
-    }
-    for (int i = 0; i < signalRefs.size(); i++) {
-        const string UNDERSCORE = "_";
-        string clientCodeName = signalRefs[i].clientCodeName;
-        string signalName = signalRefs[i].signalName;
-        string signalFileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE
-                + signalName + ".csv";
-        fstream signalFile;
-        signalFile.open(signalFileName.c_str(), ios_base::out);
-        assert(!signalFile.fail());
-        assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
-        const Signal *signal = nameToClientCodeMap[clientCodeName]->getSignalByName(signalName);
-
-        signalFile << "Time";
-        for (int j = 0; j < signal->size; j++) {
-            signalFile << '\t' << "signal[" << j << "]";
-        }
-        signalFile << endl;
-
-        signalFile.close();
-    }
-}
-
-void DataOutput::writeSignals(int step) {
-    vector<structSignalRef> signalRefs;
-    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
-        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_Signal)
-            signalRefs.push_back(settingDataOutput.connectionIOs[i].signalRef);
-    }
-    for (int i = 0; i < signalRefs.size(); i++) {
-        const string UNDERSCORE = "_";
-        string clientCodeName = signalRefs[i].clientCodeName;
-        string signalName = signalRefs[i].signalName;
-        string signalFileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE
-                + signalName + ".csv";
-        fstream signalFile;
-        signalFile.open(signalFileName.c_str(), ios_base::out | ios_base::app);
-        assert(!signalFile.fail());
-        assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
-        const Signal *signal = nameToClientCodeMap[clientCodeName]->getSignalByName(signalName);
-
-        signalFile << step;
-        for (int j = 0; j < signal->size; j++) {
-            signalFile << '\t' << signal->array[j];
-        }
-        signalFile << endl;
-
-        signalFile.close();
-    }
-}
-
-} /* namespace EMPIRE */
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "DataOutput.h"
+#include "Emperor.h"
+#include "MetaDataStructures.h"
+#include "GiDFileIO.h"
+#include "BinaryResultFileIO.h"
+#include "HDF5FileIO.h"
+#include "ADIOS2StreamIO.h"
+#include "IGATessellationIO.h"
+#include "MatlabIGAFileIO.h"
+#include "GiDIGAFileIO.h" //
+#include "AbstractMesh.h"
+#include "FEMesh.h"
+#include "IGAMesh.h"
+#include "DataField.h"
+#include "ClientCode.h"
+#include "Signal.h"
+#include "AsyncOutputWriter.h"
+#include "BufferPool.h"
+
+#include <assert.h>
+#include <iostream>
+#include <map>
+#include <set>
+#include <fstream>
+
+using namespace std;
+
+namespace EMPIRE {
+
+/***********************************************************************************************
+ * \brief Append a data field to a BinaryResultFileIO, HDF5FileIO or ADIOS2StreamIO writer, a
+ *        doubleVector field is split into the vectors _disp and _rot
+ ***********/
+template<class ResultWriter>
+static void appendDataFieldToResultFile(ResultWriter *writer, const string &dataFieldName,
+        const DataField *dataField, int numLocations, const double *data, int step) {
+    bool atNode = (dataField->location == EMPIRE_DataField_atNode ? true : false);
+    if (dataField->dimension == EMPIRE_DataField_vector) {
+        writer->appendData(dataFieldName, step, atNode, 3, numLocations, data);
+    } else if (dataField->dimension == EMPIRE_DataField_scalar) {
+        writer->appendData(dataFieldName, step, atNode, 1, numLocations, data);
+    } else if (dataField->dimension == EMPIRE_DataField_doubleVector) {
+        assert(atNode);
+        BufferPool::Buffer data1((size_t) numLocations * 3);
+        BufferPool::Buffer data2((size_t) numLocations * 3);
+        for (int j = 0; j < numLocations; j++) {
+            for (int k = 0; k < 3; k++) {
+                data1[j * 3 + k] = data[j * 6 + k];
+                data2[j * 3 + k] = data[j * 6 + 3 + k];
+            }
+        }
+        writer->appendData(dataFieldName + "_disp", step, atNode, 3, numLocations, data1.data());
+        writer->appendData(dataFieldName + "_rot", step, atNode, 3, numLocations, data2.data());
+    } else {
+        assert(false);
+    }
+}
+
+DataOutput::DataOutput(const structDataOutput &_settingDataOutput,
+        std::map<std::string, ClientCode*> &_nameToClientCodeMap) :
+        settingDataOutput(_settingDataOutput), nameToClientCodeMap(_nameToClientCodeMap) {
+    signalStreamWriter = NULL;
+    asyncWriter = new AsyncOutputWriter(settingDataOutput.asyncQueueDepth);
+}
+
+DataOutput::~DataOutput() {
+    delete asyncWriter; // writes all pending steps
+    closeResultFiles();
+    deleteMeshSubsets();
+}
+
+void DataOutput::init(std::string rearPart) {
+    asyncWriter->flush(); // the files of the previous init are complete before new ones are opened
+    closeResultFiles();
+    dataOutputName = settingDataOutput.name;
+    dataOutputName.append(rearPart);
+    initMeshSubsets();
+    writeMeshes();
+    initDataFieldFiles();
+    initSignalFiles();
+}
+
+void DataOutput::writeCurrentStep(int step) {
+    structStepSnapshot *snapshot = new structStepSnapshot;
+    snapshot->step = step;
+    takeDataFieldSnapshots(*snapshot);
+    takeMeshSnapshots(*snapshot);
+    takeSignalSnapshots(*snapshot);
+    if (snapshot->dataFields.empty() && snapshot->signals.empty()) {
+        delete snapshot;
+        return;
+    }
+    asyncWriter->push(new StepOutputTask(this, snapshot));
+}
+
+void DataOutput::flush() {
+    asyncWriter->flush();
+}
+
+void DataOutput::initMeshSubsets() {
+    deleteMeshSubsets();
+    if (!settingDataOutput.hasRegionBox && settingDataOutput.regionElemIDs.empty()
+            && settingDataOutput.nodeStride == 1)
+        return;
+    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
+        if (settingDataOutput.connectionIOs[i].type != EMPIRE_ConnectionIO_DataField)
+            continue;
+        const structDataFieldRef &dataFieldRef = settingDataOutput.connectionIOs[i].dataFieldRef;
+        const string UNDERSCORE = "_";
+        string meshFileName = dataOutputName + UNDERSCORE + dataFieldRef.clientCodeName
+                + UNDERSCORE + dataFieldRef.meshName;
+        if (meshFileNameToSubsetMap.find(meshFileName) != meshFileNameToSubsetMap.end())
+            continue;
+        assert(nameToClientCodeMap.find(dataFieldRef.clientCodeName) != nameToClientCodeMap.end());
+        AbstractMesh *mesh = nameToClientCodeMap[dataFieldRef.clientCodeName]->getMeshByName(
+                dataFieldRef.meshName);
+        if (mesh->type != EMPIRE_Mesh_FEMesh && mesh->type != EMPIRE_Mesh_SectionMesh)
+            ERROR_BLOCK_OUT("DataOutput","initMeshSubsets","A region or a node stride is defined only for FEMesh,SectionMesh");
+        structMeshSubset subset;
+        subset.mesh = dynamic_cast<FEMesh*>(mesh);
+        selectMeshSubset(subset);
+        INFO_OUT() << "DataOutput " << settingDataOutput.name << " writes "
+                << subset.subMesh->numNodes << " of " << subset.mesh->numNodes << " nodes and "
+                << subset.subMesh->numElems << " of " << subset.mesh->numElems
+                << " elements of mesh " << dataFieldRef.meshName << endl;
+        meshFileNameToSubsetMap.insert(pair<string, structMeshSubset>(meshFileName, subset));
+    }
+}
+
+void DataOutput::selectMeshSubset(structMeshSubset &subset) const {
+    const FEMesh *mesh = subset.mesh;
+    set<int> regionElemIDs(settingDataOutput.regionElemIDs.begin(),
+            settingDataOutput.regionElemIDs.end());
+    map<int, int> nodeIDToPosition;
+    for (int i = 0; i < mesh->numNodes; i++)
+        nodeIDToPosition[mesh->nodeIDs[i]] = i;
+    vector<int> elemOffsets(mesh->numElems + 1, 0);
+    for (int i = 0; i < mesh->numElems; i++)
+        elemOffsets[i + 1] = elemOffsets[i] + mesh->numNodesPerElem[i];
+
+    vector<bool> isNodeOfRegionElem(mesh->numNodes, regionElemIDs.empty());
+    for (int i = 0; i < mesh->numElems; i++) {
+        if (regionElemIDs.find(mesh->elemIDs[i]) == regionElemIDs.end())
+            continue;
+        for (int j = elemOffsets[i]; j < elemOffsets[i + 1]; j++)
+            isNodeOfRegionElem[nodeIDToPosition[mesh->elems[j]]] = true;
+    }
+    vector<bool> isNodeWritten(mesh->numNodes, false);
+    int numSelectedNodes = 0;
+    for (int i = 0; i < mesh->numNodes; i++) {
+        if (!isNodeOfRegionElem[i])
+            continue;
+        if (settingDataOutput.hasRegionBox) {
+            bool isInBox = true;
+            for (int j = 0; j < 3; j++)
+                isInBox = isInBox && mesh->nodes[i * 3 + j] >= settingDataOutput.regionMin[j]
+                        && mesh->nodes[i * 3 + j] <= settingDataOutput.regionMax[j];
+            if (!isInBox)
+                continue;
+        }
+        if (numSelectedNodes++ % settingDataOutput.nodeStride != 0)
+            continue;
+        isNodeWritten[i] = true;
+        subset.nodePositions.push_back(i);
+    }
+    for (int i = 0; i < mesh->numElems; i++) {
+        if (!regionElemIDs.empty() && regionElemIDs.find(mesh->elemIDs[i]) == regionElemIDs.end())
+            continue;
+        bool isElemWritten = true;
+        for (int j = elemOffsets[i]; j < elemOffsets[i + 1]; j++)
+            isElemWritten = isElemWritten && isNodeWritten[nodeIDToPosition[mesh->elems[j]]];
+        if (isElemWritten)
+            subset.elemPositions.push_back(i);
+    }
+
+    int numNodes = subset.nodePositions.size();
+    int numElems = subset.elemPositions.size();
+    FEMesh *subMesh = new FEMesh(mesh->name, numNodes, numElems);
+    for (int i = 0; i < numNodes; i++) {
+        int position = subset.nodePositions[i];
+        subMesh->nodeIDs[i] = mesh->nodeIDs[position];
+        for (int j = 0; j < 3; j++)
+            subMesh->nodes[i * 3 + j] = mesh->nodes[position * 3 + j];
+    }
+    for (int i = 0; i < numElems; i++) {
+        int position = subset.elemPositions[i];
+        subMesh->elemIDs[i] = mesh->elemIDs[position];
+        subMesh->numNodesPerElem[i] = mesh->numNodesPerElem[position];
+    }
+    subMesh->initElems();
+    for (int i = 0, offset = 0; i < numElems; i++) {
+        int position = subset.elemPositions[i];
+        for (int j = elemOffsets[position]; j < elemOffsets[position + 1]; j++)
+            subMesh->elems[offset++] = mesh->elems[j];
+    }
+    subset.subMesh = subMesh;
+}
+
+void DataOutput::deleteMeshSubsets() {
+    for (map<string, structMeshSubset>::iterator it = meshFileNameToSubsetMap.begin();
+            it != meshFileNameToSubsetMap.end(); it++)
+        delete it->second.subMesh;
+    meshFileNameToSubsetMap.clear();
+}
+
+AbstractMesh *DataOutput::getOutputMesh(const string &meshFileName, AbstractMesh *mesh) {
+    map<string, structMeshSubset>::iterator it = meshFileNameToSubsetMap.find(meshFileName);
+    if (it == meshFileNameToSubsetMap.end())
+        return mesh;
+    return it->second.subMesh;
+}
+
+void DataOutput::writeMeshes() {
+    vector<structDataFieldRef> dataFieldRefs;
+    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
+        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_DataField)
+            dataFieldRefs.push_back(settingDataOutput.connectionIOs[i].dataFieldRef);
+    }
+    // get rid of repeated meshes
+    map<string, AbstractMesh*> meshFileNameToMeshMap;
+    for (int i = 0; i < dataFieldRefs.size(); i++) {
+        const string UNDERSCORE = "_";
+        string clientCodeName = dataFieldRefs[i].clientCodeName;
+        string meshName = dataFieldRefs[i].meshName;
+        string meshFileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE + meshName;
+
+        assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
+        AbstractMesh *mesh = nameToClientCodeMap[clientCodeName]->getMeshByName(meshName);
+        meshFileNameToMeshMap.insert(
+                pair<string, AbstractMesh*>(meshFileName, getOutputMesh(meshFileName, mesh)));
+    }
+    // write meshes
+    for (map<string, AbstractMesh*>::iterator it = meshFileNameToMeshMap.begin();
+            it != meshFileNameToMeshMap.end(); it++) {
+        string meshFileName = it->first;
+        if (settingDataOutput.format == EMPIRE_DataOutput_HDF5) {
+            // the mesh and its data fields are in the same file, the original polygons are kept
+            HDF5FileIO::Writer *writer = new HDF5FileIO::Writer(meshFileName,
+                    settingDataOutput.compressionLevel);
+            if (it->second->type == EMPIRE_Mesh_FEMesh
+                    || it->second->type == EMPIRE_Mesh_SectionMesh) {
+                FEMesh *mesh = dynamic_cast<FEMesh*>(it->second);
+                writer->writeFEMesh(mesh->numNodes, mesh->nodes, mesh->nodeIDs, mesh->numElems,
+                        mesh->numNodesPerElem, mesh->elems, mesh->elemIDs);
+            } else if (it->second->type == EMPIRE_Mesh_IGAMesh
+                    && settingDataOutput.igaTessellation > 0) {
+                IGATessellationIO::Tessellation *tessellation = new IGATessellationIO::Tessellation(
+                        dynamic_cast<IGAMesh*>(it->second), settingDataOutput.igaTessellation);
+                meshFileNameToTessellationMap.insert(
+                        pair<string, IGATessellationIO::Tessellation*>(meshFileName, tessellation));
+                writer->writeTessellation(tessellation);
+            } else if (it->second->type == EMPIRE_Mesh_IGAMesh) {
+                writer->writeIGAControlNet(dynamic_cast<IGAMesh*>(it->second));
+            } else
+                ERROR_BLOCK_OUT("DataOutput","writeMeshes","Writer defined only for FEMesh,SectionMesh,IGAMesh");
+            dataFieldFileNameToHDF5WriterMap.insert(
+                    pair<string, HDF5FileIO::Writer*>(meshFileName, writer));
+        } else if (settingDataOutput.format == EMPIRE_DataOutput_ADIOS2) {
+            // the stream publishes the mesh with every step of its data fields
+            if (it->second->type != EMPIRE_Mesh_FEMesh
+                    && it->second->type != EMPIRE_Mesh_SectionMesh)
+                ERROR_BLOCK_OUT("DataOutput","writeMeshes","ADIOS2 streams defined only for FEMesh,SectionMesh");
+            ADIOS2StreamIO::Writer *writer = new ADIOS2StreamIO::Writer(meshFileName,
+                    settingDataOutput.streamEngine, settingDataOutput.asyncQueueDepth);
+            FEMesh *mesh = dynamic_cast<FEMesh*>(it->second);
+            writer->writeFEMesh(mesh->numNodes, mesh->nodes, mesh->nodeIDs, mesh->numElems,
+                    mesh->numNodesPerElem, mesh->elems, mesh->elemIDs);
+            dataFieldFileNameToStreamWriterMap.insert(
+                    pair<string, ADIOS2StreamIO::Writer*>(meshFileName, writer));
+        } else if (it->second->type == EMPIRE_Mesh_FEMesh || it->second->type == EMPIRE_Mesh_SectionMesh) {
+            FEMesh *mesh = dynamic_cast<FEMesh*>(it->second);
+            meshFileName.append(".msh");
+            if (mesh->triangulate() != NULL)
+                mesh = mesh->triangulate();
+            GiDFileIO::writeDotMsh(meshFileName, mesh->numNodes, mesh->numElems, mesh->nodes,
+                    mesh->nodeIDs, mesh->numNodesPerElem, mesh->elems, mesh->elemIDs);
+        } else if (it->second->type == EMPIRE_Mesh_IGAMesh
+                && settingDataOutput.igaTessellation > 0) {
+            // the tessellation is written with the data fields of every step
+            IGATessellationIO::Tessellation *tessellation = new IGATessellationIO::Tessellation(
+                    dynamic_cast<IGAMesh*>(it->second), settingDataOutput.igaTessellation);
+            meshFileNameToTessellationMap.insert(
+                    pair<string, IGATessellationIO::Tessellation*>(meshFileName, tessellation));
+            meshFileNameToVTKWriterMap.insert(
+                    pair<string, IGATessellationIO::VTKWriter*>(meshFileName,
+                            new IGATessellationIO::VTKWriter(meshFileName, tessellation)));
+        } else if (it->second->type == EMPIRE_Mesh_IGAMesh) {
+            IGAMesh* igaMesh = dynamic_cast<IGAMesh*>(it->second);
+            GiDIGAFileIO::writeIGAMesh(meshFileName, igaMesh);
+            //MatlabIGAFileIO::writeIGAMesh(igaMesh);
+        } else
+            ERROR_BLOCK_OUT("DataOutput","writeMeshes","Writer defined only for FEMesh,SectionMesh,IGAMesh");
+    }
+}
+
+void DataOutput::initDataFieldFiles() {
+    if (settingDataOutput.format == EMPIRE_DataOutput_HDF5
+            || settingDataOutput.format == EMPIRE_DataOutput_ADIOS2)
+        return; // the HDF5 files and the ADIOS2 streams are created by writeMeshes
+    vector<structDataFieldRef> dataFieldRefs;
+    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
+        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_DataField)
+            dataFieldRefs.push_back(settingDataOutput.connectionIOs[i].dataFieldRef);
+    }
+    // get rid of repeated data field files (one data field file corresponds to multiple data fields of a single mesh)
+    map<string, FEMesh*> dataFieldFileNameToMeshMap;
+    for (int i = 0; i < dataFieldRefs.size(); i++) {
+        const string UNDERSCORE = "_";
+        string clientCodeName = dataFieldRefs[i].clientCodeName;
+        string meshName = dataFieldRefs[i].meshName;
+        string dataFieldFileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE
+                + meshName;
+
+        assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
+        AbstractMesh *mesh = getOutputMesh(dataFieldFileName,
+                nameToClientCodeMap[clientCodeName]->getMeshByName(meshName));
+        if (mesh->type == EMPIRE_Mesh_FEMesh || mesh->type == EMPIRE_Mesh_SectionMesh) {
+            if (settingDataOutput.format == EMPIRE_DataOutput_binary)
+                dataFieldFileName.append(".bin");
+            else
+                dataFieldFileName.append(".res");
+            FEMesh *feMesh = dynamic_cast<FEMesh*>(mesh);
+            dataFieldFileNameToMeshMap.insert(pair<string, FEMesh*>(dataFieldFileName, feMesh));
+        } else if (mesh->type == EMPIRE_Mesh_IGAMesh) {
+            if (settingDataOutput.igaTessellation == 0)
+                GiDIGAFileIO::initDotPostRes(dataFieldFileName);
+        } else
+            assert(0);
+    }
+    for (map<string, FEMesh*>::iterator it = dataFieldFileNameToMeshMap.begin();
+            it != dataFieldFileNameToMeshMap.end(); it++) {
+        string dataFieldFileName = it->first;
+        FEMesh *mesh = it->second;
+
+        if (settingDataOutput.format == EMPIRE_DataOutput_binary) {
+            BinaryResultFileIO::Writer *writer = new BinaryResultFileIO::Writer(dataFieldFileName,
+                    mesh->numNodes, mesh->nodeIDs, mesh->numElems, mesh->elemIDs,
+                    mesh->numNodesPerElem);
+            dataFieldFileNameToBinaryWriterMap.insert(
+                    pair<string, BinaryResultFileIO::Writer*>(dataFieldFileName, writer));
+        } else {
+            GiDFileIO::initDotRes(dataFieldFileName); // TODO enable output write data on element center of hybrid mesh
+        }
+    }
+}
+
+void DataOutput::takeDataFieldSnapshots(structStepSnapshot &snapshot) {
+    vector<structDataFieldRef> dataFieldRefs;
+    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
+        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_DataField)
+            dataFieldRefs.push_back(settingDataOutput.connectionIOs[i].dataFieldRef);
+    }
+
+    for (int i = 0; i < dataFieldRefs.size(); i++) {
+        const structDataFieldRef &dataFieldRef = dataFieldRefs[i];
+        int interval = (dataFieldRef.outputInterval > 0 ?
+                dataFieldRef.outputInterval : settingDataOutput.interval);
+        if (snapshot.step % interval != 0)
+            continue;
+        string clientCodeName = dataFieldRef.clientCodeName;
+        string meshName = dataFieldRef.meshName;
+        structDataFieldSnapshot dataFieldSnapshot;
+        dataFieldSnapshot.dataFieldName = dataFieldRef.dataFieldName;
+        AbstractMesh *mesh = nameToClientCodeMap[clientCodeName]->getMeshByName(meshName);
+        const string UNDERSCORE = "_";
+        dataFieldSnapshot.fileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE
+                + meshName;
+        dataFieldSnapshot.mesh = getOutputMesh(dataFieldSnapshot.fileName, mesh);
+        const DataField *dataField = mesh->getDataFieldByName(dataFieldSnapshot.dataFieldName);
+        dataFieldSnapshot.dataField = dataField;
+        int dimension = dataField->dimension;
+        map<string, structMeshSubset>::iterator it = meshFileNameToSubsetMap.find(
+                dataFieldSnapshot.fileName);
+        if (it == meshFileNameToSubsetMap.end()) {
+            dataFieldSnapshot.numLocations = dataField->numLocations;
+            dataFieldSnapshot.size = dataFieldSnapshot.numLocations * dimension;
+            dataFieldSnapshot.data = asyncWriter->acquireBuffer(dataFieldSnapshot.size);
+            for (int j = 0; j < dataFieldSnapshot.size; j++)
+                dataFieldSnapshot.data[j] = dataField->data[j];
+        } else { // only the locations of the subset are copied
+            const vector<int> &positions = (
+                    dataField->location == EMPIRE_DataField_atNode ?
+                            it->second.nodePositions : it->second.elemPositions);
+            dataFieldSnapshot.numLocations = positions.size();
+            dataFieldSnapshot.size = dataFieldSnapshot.numLocations * dimension;
+            dataFieldSnapshot.data = asyncWriter->acquireBuffer(dataFieldSnapshot.size);
+            for (int j = 0; j < dataFieldSnapshot.numLocations; j++)
+                for (int k = 0; k < dimension; k++)
+                    dataFieldSnapshot.data[j * dimension + k] = dataField->data[positions[j]
+                            * dimension + k];
+        }
+        snapshot.dataFields.push_back(dataFieldSnapshot);
+    }
+}
+
+void DataOutput::writeDataFieldSnapshot(int step, const structDataFieldSnapshot &snapshot) {
+    AbstractMesh *mesh = snapshot.mesh;
+    string dataFieldName = snapshot.dataFieldName;
+    string dataFieldFileName = snapshot.fileName;
+    const DataField *dataField = snapshot.dataField;
+    int numLocations = snapshot.numLocations;
+    double *data = snapshot.data;
+    if (mesh->type == EMPIRE_Mesh_IGAMesh && settingDataOutput.igaTessellation > 0) {
+        writeTessellatedDataFieldSnapshot(step, snapshot);
+    } else if (settingDataOutput.format == EMPIRE_DataOutput_HDF5) {
+        assert(dataFieldFileNameToHDF5WriterMap.find(dataFieldFileName) != dataFieldFileNameToHDF5WriterMap.end());
+        appendDataFieldToResultFile(dataFieldFileNameToHDF5WriterMap[dataFieldFileName],
+                dataFieldName, dataField, numLocations, data, step);
+    } else if (settingDataOutput.format == EMPIRE_DataOutput_ADIOS2) {
+        assert(dataFieldFileNameToStreamWriterMap.find(dataFieldFileName) != dataFieldFileNameToStreamWriterMap.end());
+        appendDataFieldToResultFile(dataFieldFileNameToStreamWriterMap[dataFieldFileName],
+                dataFieldName, dataField, numLocations, data, step);
+    } else if ((mesh->type == EMPIRE_Mesh_FEMesh || mesh->type == EMPIRE_Mesh_SectionMesh)
+            && settingDataOutput.format == EMPIRE_DataOutput_binary) {
+        dataFieldFileName.append(".bin");
+        assert(dataFieldFileNameToBinaryWriterMap.find(dataFieldFileName) != dataFieldFileNameToBinaryWriterMap.end());
+        FEMesh *feMesh = dynamic_cast<FEMesh*>(mesh);
+        if (feMesh->triangulate() != NULL)
+            assert(dataField->location == EMPIRE_DataField_atNode); // writing out data field on element certeroid of triangulated mesh is not implemented yet
+        appendDataFieldToResultFile(dataFieldFileNameToBinaryWriterMap[dataFieldFileName],
+                dataFieldName, dataField, numLocations, data, step);
+    } else if (mesh->type == EMPIRE_Mesh_FEMesh || mesh->type == EMPIRE_Mesh_SectionMesh) {
+    	dataFieldFileName.append(".res");
+        FEMesh *feMesh = dynamic_cast<FEMesh*>(mesh);
+        bool atNode = (dataField->location == EMPIRE_DataField_atNode ? true : false);
+        int *locationIDs = (atNode ? feMesh->nodeIDs : feMesh->elemIDs);
+        string type;
+        if (dataField->dimension == EMPIRE_DataField_vector) {
+            type = "Vector";
+            string tmpdataFieldName = "\"" + dataFieldName + "\"";
+            if (atNode) {
+                GiDFileIO::appendNodalDataToDotRes(dataFieldFileName, tmpdataFieldName,
+                        "\"EMPIRE_CoSimulation\"", step, type, numLocations,
+                        locationIDs, data);
+            } else {
+                if (feMesh->triangulate() == NULL) {
+                    GiDFileIO::appendElementalDataToDotRes(dataFieldFileName,
+                            tmpdataFieldName, "\"EMPIRE_CoSimulation\"", step, type,
+                            numLocations, locationIDs, feMesh->numNodesPerElem,
+                            data);
+                } else {
+                    assert(false); // writing out data field on element certeroid of triangulated mesh is not implemented yet
+                }
+            }
+        } else if (dataField->dimension == EMPIRE_DataField_scalar) {
+            type = "Scalar";
+            string tmpdataFieldName = "\"" + dataFieldName + "\"";
+            if (atNode) {
+                GiDFileIO::appendNodalDataToDotRes(dataFieldFileName, tmpdataFieldName,
+                        "\"EMPIRE_CoSimulation\"", step, type, numLocations,
+                        locationIDs, data);
+            } else {
+                if (feMesh->triangulate() == NULL) {
+                    GiDFileIO::appendElementalDataToDotRes(dataFieldFileName,
+                            tmpdataFieldName, "\"EMPIRE_CoSimulation\"", step, type,
+                            numLocations, locationIDs, feMesh->numNodesPerElem,
+                            data);
+                } else {
+                    assert(false); // writing out data field on element certeroid of triangulated mesh is not implemented yet
+                }
+            }
+        } else if (dataField->dimension == EMPIRE_DataField_doubleVector) {
+            BufferPool::Buffer data1((size_t) numLocations * 3);
+            BufferPool::Buffer data2((size_t) numLocations * 3);
+            for (int j = 0; j < numLocations; j++) {
+                for (int k = 0; k < 3; k++) {
+                    data1[j * 3 + k] = data[j * 6 + k];
+                    data2[j * 3 + k] = data[j * 6 + 3 + k];
+                }
+            }
+            type = "Vector";
+            if (atNode) {
+                string dataFieldNameDisp = "\"" + dataFieldName + "_disp\"";
+                GiDFileIO::appendNodalDataToDotRes(dataFieldFileName, dataFieldNameDisp,
+                        "\"EMPIRE_CoSimulation\"", step, type, numLocations,
+                        locationIDs, data1.data());
+                string dataFieldNameRot = "\"" + dataFieldName + "_rot\"";
+                GiDFileIO::appendNodalDataToDotRes(dataFieldFileName, dataFieldNameRot,
+                        "\"EMPIRE_CoSimulation\"", step, type, numLocations,
+                        locationIDs, data2.data());
+            } else {
+                assert(false);
+            }
+        } else {
+            assert(false);
+        }
+    } else if (mesh->type == EMPIRE_Mesh_IGAMesh) {
+        //MatlabIGAFileIO::writeVectorFieldOnCPs(meshName, dataFieldName, step, dataField);
+
+        string type;
+        if (dataField->dimension == EMPIRE_DataField_vector) {type = "vector";}
+        else if (dataField->dimension == EMPIRE_DataField_scalar) {type = "scalar";}
+        else {assert(false);}
+
+        // the writer needs a data field, copy the snapshot into a temporary one
+        DataField dataFieldCopy(dataField->name, dataField->location, dataField->numLocations,
+                dataField->dimension, dataField->typeOfQuantity);
+        for (int j = 0; j < snapshot.size; j++)
+            dataFieldCopy.data[j] = data[j];
+				IGAMesh* igaMesh = dynamic_cast<IGAMesh*>(mesh);
+				GiDIGAFileIO::appendCPDataToDotRes(dataFieldFileName, dataFieldName,"\"EMPIRE_CoSimulation\"", step, type, &dataFieldCopy, igaMesh);
+    } else {
+        assert(0);
+    }
+}
+
+void DataOutput::writeTessellatedDataFieldSnapshot(int step,
+        const structDataFieldSnapshot &snapshot) {
+    const DataField *dataField = snapshot.dataField;
+    assert(dataField->location == EMPIRE_DataField_atNode);
+    assert(dataField->dimension == EMPIRE_DataField_vector
+            || dataField->dimension == EMPIRE_DataField_scalar);
+    int numComponents = (dataField->dimension == EMPIRE_DataField_vector ? 3 : 1);
+    if (settingDataOutput.format == EMPIRE_DataOutput_HDF5) {
+        assert(meshFileNameToTessellationMap.find(snapshot.fileName) != meshFileNameToTessellationMap.end());
+        const IGATessellationIO::Tessellation *tessellation =
+                meshFileNameToTessellationMap[snapshot.fileName];
+        int numPoints = tessellation->getNumPoints();
+        if (numPoints == 0)
+            return;
+        vector<double> values(numPoints * numComponents);
+        tessellation->evaluate(numComponents, snapshot.data, &values[0]);
+        dataFieldFileNameToHDF5WriterMap[snapshot.fileName]->appendData(snapshot.dataFieldName,
+                step, true, numComponents, numPoints, &values[0]);
+    } else {
+        assert(meshFileNameToVTKWriterMap.find(snapshot.fileName) != meshFileNameToVTKWriterMap.end());
+        meshFileNameToVTKWriterMap[snapshot.fileName]->appendData(snapshot.dataFieldName,
+                numComponents, snapshot.data);
+    }
+}
+
+void DataOutput::closeResultFiles() {
+    for (map<string, BinaryResultFileIO::Writer*>::iterator it =
+            dataFieldFileNameToBinaryWriterMap.begin();
+            it != dataFieldFileNameToBinaryWriterMap.end(); it++)
+        delete it->second;
+    dataFieldFileNameToBinaryWriterMap.clear();
+    for (map<string, HDF5FileIO::Writer*>::iterator it = dataFieldFileNameToHDF5WriterMap.begin();
+            it != dataFieldFileNameToHDF5WriterMap.end(); it++)
+        delete it->second;
+    dataFieldFileNameToHDF5WriterMap.clear();
+    for (map<string, ADIOS2StreamIO::Writer*>::iterator it =
+            dataFieldFileNameToStreamWriterMap.begin();
+            it != dataFieldFileNameToStreamWriterMap.end(); it++)
+        delete it->second;
+    dataFieldFileNameToStreamWriterMap.clear();
+    delete signalStreamWriter;
+    signalStreamWriter = NULL;
+    for (map<string, IGATessellationIO::VTKWriter*>::iterator it =
+            meshFileNameToVTKWriterMap.begin(); it != meshFileNameToVTKWriterMap.end(); it++)
+        delete it->second;
+    meshFileNameToVTKWriterMap.clear();
+    for (map<string, IGATessellationIO::Tessellation*>::iterator it =
+            meshFileNameToTessellationMap.begin(); it != meshFileNameToTessellationMap.end(); it++)
+        delete it->second;
+    meshFileNameToTessellationMap.clear();
+}
+
+void DataOutput::takeMeshSnapshots(structStepSnapshot &snapshot) {
+    if (settingDataOutput.format != EMPIRE_DataOutput_ADIOS2)
+        return;
+    // the nodes of a moving mesh change, the other data of the mesh are kept by its stream
+    for (int i = 0; i < snapshot.dataFields.size(); i++) {
+        const structDataFieldSnapshot &dataFieldSnapshot = snapshot.dataFields[i];
+        bool isTaken = false;
+        for (int j = 0; j < snapshot.meshes.size(); j++)
+            isTaken = isTaken || (snapshot.meshes[j].fileName == dataFieldSnapshot.fileName);
+        if (isTaken)
+            continue;
+        const FEMesh *mesh = dynamic_cast<const FEMesh*>(dataFieldSnapshot.mesh);
+        assert(mesh != NULL);
+        structMeshSnapshot meshSnapshot;
+        meshSnapshot.fileName = dataFieldSnapshot.fileName;
+        meshSnapshot.size = mesh->numNodes * 3;
+        meshSnapshot.data = asyncWriter->acquireBuffer(meshSnapshot.size);
+        map<string, structMeshSubset>::iterator it = meshFileNameToSubsetMap.find(
+                meshSnapshot.fileName);
+        if (it == meshFileNameToSubsetMap.end()) {
+            for (int j = 0; j < meshSnapshot.size; j++)
+                meshSnapshot.data[j] = mesh->nodes[j];
+        } else { // the nodes of the subset are copied from the moving mesh of the client
+            const vector<int> &nodePositions = it->second.nodePositions;
+            for (int j = 0; j < nodePositions.size(); j++)
+                for (int k = 0; k < 3; k++)
+                    meshSnapshot.data[j * 3 + k] = it->second.mesh->nodes[nodePositions[j] * 3 + k];
+        }
+        snapshot.meshes.push_back(meshSnapshot);
+    }
+}
+
+void DataOutput::initSignalFiles() {
+    vector<structSignalRef> signalRefs;
+    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
+        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_Signal)
+            signalRefs.push_back(settingDataOutput.connectionIOs[i].signalRef);
+    }
+    if (settingDataOutput.format == EMPIRE_DataOutput_ADIOS2) {
+        // all signals are in one stream instead of the signal files
+        if (!signalRefs.empty())
+            signalStreamWriter = new ADIOS2StreamIO::Writer(dataOutputName + "_signals",
+                    settingDataOutput.streamEngine, settingDataOutput.asyncQueueDepth);
+        return;
+    }
+    for (int i = 0; i < signalRefs.size(); i++) {
+        const string UNDERSCORE = "_";
+        string clientCodeName = signalRefs[i].clientCodeName;
+        string signalName = signalRefs[i].signalName;
+        string signalFileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE
+                + signalName + ".csv";
+        fstream signalFile;
+        signalFile.open(signalFileName.c_str(), ios_base::out);
+        assert(!signalFile.fail());
+        assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
+        const Signal *signal = nameToClientCodeMap[clientCodeName]->getSignalByName(signalName);
+
+        signalFile << "Time";
+        for (int j = 0; j < signal->size; j++) {
+            signalFile << '\t' << "signal[" << j << "]";
+        }
+        signalFile << endl;
+
+        signalFile.close();
+    }
+}
+
+void DataOutput::takeSignalSnapshots(structStepSnapshot &snapshot) {
+    vector<structSignalRef> signalRefs;
+    for (int i = 0; i < settingDataOutput.connectionIOs.size(); i++) {
+        if (settingDataOutput.connectionIOs[i].type == EMPIRE_ConnectionIO_Signal)
+            signalRefs.push_back(settingDataOutput.connectionIOs[i].signalRef);
+    }
+    for (int i = 0; i < signalRefs.size(); i++) {
+        const string UNDERSCORE = "_";
+        string clientCodeName = signalRefs[i].clientCodeName;
+        string signalName = signalRefs[i].signalName;
+        structSignalSnapshot signalSnapshot;
+        signalSnapshot.fileName = dataOutputName + UNDERSCORE + clientCodeName + UNDERSCORE
+                + signalName + ".csv";
+        signalSnapshot.signalName = clientCodeName + "/" + signalName;
+        assert(nameToClientCodeMap.find(clientCodeName) != nameToClientCodeMap.end());
+        const Signal *signal = nameToClientCodeMap[clientCodeName]->getSignalByName(signalName);
+        signalSnapshot.size = signal->size;
+        signalSnapshot.data = asyncWriter->acquireBuffer(signalSnapshot.size);
+        for (int j = 0; j < signal->size; j++)
+            signalSnapshot.data[j] = signal->array[j];
+        snapshot.signals.push_back(signalSnapshot);
+    }
+}
+
+void DataOutput::writeSignalSnapshot(int step, const structSignalSnapshot &snapshot) {
+    if (signalStreamWriter != NULL) {
+        signalStreamWriter->appendSignal(snapshot.signalName, snapshot.size, snapshot.data);
+        return;
+    }
+    fstream signalFile;
+    signalFile.open(snapshot.fileName.c_str(), ios_base::out | ios_base::app);
+    assert(!signalFile.fail());
+
+    signalFile << step;
+    for (int j = 0; j < snapshot.size; j++) {
+        signalFile << '\t' << snapshot.data[j];
+    }
+    signalFile << endl;
+
+    signalFile.close();
+}
+
+void DataOutput::writeStepSnapshot(const structStepSnapshot &snapshot) {
+    // a step of an ADIOS2 stream holds the data fields of the mesh or all signals
+    if (!snapshot.dataFields.empty()) {
+        for (map<string, ADIOS2StreamIO::Writer*>::iterator it =
+                dataFieldFileNameToStreamWriterMap.begin();
+                it != dataFieldFileNameToStreamWriterMap.end(); it++)
+            it->second->beginStep(snapshot.step);
+    }
+    for (int i = 0; i < snapshot.meshes.size(); i++)
+        dataFieldFileNameToStreamWriterMap[snapshot.meshes[i].fileName]->updateNodes(
+                snapshot.meshes[i].data);
+    for (int i = 0; i < snapshot.dataFields.size(); i++)
+        writeDataFieldSnapshot(snapshot.step, snapshot.dataFields[i]);
+    for (map<string, IGATessellationIO::VTKWriter*>::iterator it =
+            meshFileNameToVTKWriterMap.begin(); it != meshFileNameToVTKWriterMap.end(); it++)
+        it->second->endStep(snapshot.step);
+    if (!snapshot.dataFields.empty()) {
+        for (map<string, ADIOS2StreamIO::Writer*>::iterator it =
+                dataFieldFileNameToStreamWriterMap.begin();
+                it != dataFieldFileNameToStreamWriterMap.end(); it++)
+            it->second->endStep();
+    }
+    if (signalStreamWriter != NULL && !snapshot.signals.empty())
+        signalStreamWriter->beginStep(snapshot.step);
+    for (int i = 0; i < snapshot.signals.size(); i++)
+        writeSignalSnapshot(snapshot.step, snapshot.signals[i]);
+    if (signalStreamWriter != NULL && !snapshot.signals.empty())
+        signalStreamWriter->endStep();
+}
+
+void DataOutput::releaseStepSnapshot(structStepSnapshot *snapshot) {
+    for (int i = 0; i < snapshot->dataFields.size(); i++)
+        asyncWriter->releaseBuffer(snapshot->dataFields[i].data, snapshot->dataFields[i].size);
+    for (int i = 0; i < snapshot->signals.size(); i++)
+        asyncWriter->releaseBuffer(snapshot->signals[i].data, snapshot->signals[i].size);
+    for (int i = 0; i < snapshot->meshes.size(); i++)
+        asyncWriter->releaseBuffer(snapshot->meshes[i].data, snapshot->meshes[i].size);
+    delete snapshot;
+}
+
+StepOutputTask::StepOutputTask(DataOutput *_dataOutput, DataOutput::structStepSnapshot *_snapshot) :
+        dataOutput(_dataOutput), snapshot(_snapshot) {
+}
+
+StepOutputTask::~StepOutputTask() {
+    dataOutput->releaseStepSnapshot(snapshot);
+}
+
+void StepOutputTask::execute() {
+    dataOutput->writeStepSnapshot(*snapshot);
+}
+
+} /* namespace EMPIRE */
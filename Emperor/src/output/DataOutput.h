@@ -30,13 +30,40 @@
 #include <string>
 #include <vector>
 #include <map>
+#include "AsyncOutputWriter.h"
+
+namespace BinaryResultFileIO {
+class Writer;
+}
+namespace HDF5FileIO {
+class Writer;
+}
+namespace ADIOS2StreamIO {
+class Writer;
+}
 
 namespace EMPIRE {
 
 struct structDataOutput;
 class ClientCode;
+class DataField;
+class AbstractMesh;
+class FEMesh;
+class StepOutputTask;
+namespace IGATessellationIO {
+class Tessellation;
+class VTKWriter;
+}
 /********//**
- * \brief This class can output meshes and dataFields in GiD format
+ * \brief This class can output meshes and dataFields in GiD format. Data fields on FE meshes can
+ *        also be written in the binary result format (see BinaryResultFileIO.h), and meshes with
+ *        their data fields in the HDF5 format (see HDF5FileIO.h). Instead of files, the ADIOS2
+ *        format publishes them to ADIOS2 streams (see ADIOS2StreamIO.h).
+ *        At each output step the data are copied into snapshots, which are formatted and written
+ *        by the writer thread of an AsyncOutputWriter. A region (a box and/or a set of elements)
+ *        and a node stride restrict the output of FE meshes to a subset of their nodes and
+ *        elements, the data fields can be written at their own intervals. IGA meshes are
+ *        written either as control nets or as tessellations (see IGATessellationIO.h).
  ***********/
 class DataOutput {
 public:
@@ -65,14 +92,115 @@ public:
      * \author Tianyang Wang
      ***********/
     void writeCurrentStep(int step);
+    /***********************************************************************************************
+     * \brief Wait until all steps passed to writeCurrentStep are written
+     ***********/
+    void flush();
 private:
+    friend class StepOutputTask;
+    /// copy of a data field taken at an output step
+    struct structDataFieldSnapshot {
+        /// name of the data field file without extension
+        std::string fileName;
+        /// name of the data field
+        std::string dataFieldName;
+        /// the mesh of the data field
+        AbstractMesh *mesh;
+        /// the data field, only its layout is used by the writer thread
+        const DataField *dataField;
+        /// copy of the data, a buffer of the pool of asyncWriter
+        double *data;
+        /// number of doubles in data
+        int size;
+        /// number of locations in data, less than dataField->numLocations for a mesh subset
+        int numLocations;
+    };
+    /// copy of a signal taken at an output step
+    struct structSignalSnapshot {
+        /// name of the signal file
+        std::string fileName;
+        /// name of the signal in the ADIOS2 stream
+        std::string signalName;
+        /// copy of the signal, a buffer of the pool of asyncWriter
+        double *data;
+        /// number of doubles in data
+        int size;
+    };
+    /// copy of the node coordinates of a mesh taken at an output step, only for the ADIOS2 format
+    struct structMeshSnapshot {
+        /// name of the mesh file (the stream) without extension
+        std::string fileName;
+        /// copy of the coordinates, a buffer of the pool of asyncWriter
+        double *data;
+        /// number of doubles in data
+        int size;
+    };
+    /// all data to be written at an output step
+    struct structStepSnapshot {
+        int step;
+        std::vector<structDataFieldSnapshot> dataFields;
+        std::vector<structSignalSnapshot> signals;
+        std::vector<structMeshSnapshot> meshes;
+    };
+    /// the written part of an FE mesh, if a region or a node stride is set
+    struct structMeshSubset {
+        /// the mesh of the client
+        const FEMesh *mesh;
+        /// the written nodes and elements, the IDs are the ones of mesh
+        FEMesh *subMesh;
+        /// positions of the written nodes in mesh
+        std::vector<int> nodePositions;
+        /// positions of the written elements in mesh
+        std::vector<int> elemPositions;
+    };
+
     /// dataOutputName, starting part of outputting files
     std::string dataOutputName;
     /// setting of this DataOutput
     const structDataOutput &settingDataOutput;
     /// a reference to the nameToClientCodeMap of class Emperor
     std::map<std::string, ClientCode*> &nameToClientCodeMap;
+    /// the open binary result files, only used by the binary format
+    std::map<std::string, BinaryResultFileIO::Writer*> dataFieldFileNameToBinaryWriterMap;
+    /// the open HDF5 result files, only used by the HDF5 format
+    std::map<std::string, HDF5FileIO::Writer*> dataFieldFileNameToHDF5WriterMap;
+    /// the open streams of the meshes, only used by the ADIOS2 format
+    std::map<std::string, ADIOS2StreamIO::Writer*> dataFieldFileNameToStreamWriterMap;
+    /// the open stream of the signals, only used by the ADIOS2 format
+    ADIOS2StreamIO::Writer *signalStreamWriter;
+    /// writes the snapshots on its own thread
+    AsyncOutputWriter *asyncWriter;
+    /// the written part of each mesh file, empty if all nodes and elements are written
+    std::map<std::string, structMeshSubset> meshFileNameToSubsetMap;
+    /// the tessellations of the IGA meshes, only used if igaTessellation is set
+    std::map<std::string, IGATessellationIO::Tessellation*> meshFileNameToTessellationMap;
+    /// the VTK files of the tessellations, only used by the GiD and binary formats
+    std::map<std::string, IGATessellationIO::VTKWriter*> meshFileNameToVTKWriterMap;
 
+    /***********************************************************************************************
+     * \brief Select the written nodes and elements of the meshes, if a region or a node stride is
+     *        set. The selection is done once with the coordinates at initialization.
+     ***********/
+    void initMeshSubsets();
+    /***********************************************************************************************
+     * \brief Select the nodes and elements of an FE mesh to be written. A node is selected if it
+     *        is inside the region box and belongs to one of the region elements, of these every
+     *        nodeStride-th node is written. An element is written if it is a region element and
+     *        all its nodes are written.
+     * \param[in/out] subset the subset, mesh must be set, the others are filled
+     ***********/
+    void selectMeshSubset(structMeshSubset &subset) const;
+    /***********************************************************************************************
+     * \brief Delete the mesh subsets
+     ***********/
+    void deleteMeshSubsets();
+    /***********************************************************************************************
+     * \brief Get the mesh written to a mesh file
+     * \param[in] meshFileName name of the mesh file without extension
+     * \param[in] mesh the mesh of the client
+     * \return the subset of the mesh if there is one, otherwise the mesh
+     ***********/
+    AbstractMesh *getOutputMesh(const std::string &meshFileName, AbstractMesh *mesh);
     /***********************************************************************************************
      * \brief Write meshes to mesh files
      * \author Tianyang Wang
@@ -84,22 +212,88 @@ private:
      ***********/
     void initDataFieldFiles();
     /***********************************************************************************************
-     * \brief Write data field of current step to data files
+     * \brief Copy the data fields of the current step, if it is an output step
+     * \param[in/out] snapshot the snapshot of the current step
+     ***********/
+    void takeDataFieldSnapshots(structStepSnapshot &snapshot);
+    /***********************************************************************************************
+     * \brief Write a data field snapshot to its data file
      * \param[in] step the step number
-     * \author Tianyang Wang
+     * \param[in] snapshot the snapshot of the data field
+     ***********/
+    void writeDataFieldSnapshot(int step, const structDataFieldSnapshot &snapshot);
+    /***********************************************************************************************
+     * \brief Write a data field snapshot of an IGA mesh at the points of its tessellation
+     * \param[in] step the step number
+     * \param[in] snapshot the snapshot of the data field on the control points
+     ***********/
+    void writeTessellatedDataFieldSnapshot(int step, const structDataFieldSnapshot &snapshot);
+    /***********************************************************************************************
+     * \brief Copy the node coordinates of the meshes of the data field snapshots, the ADIOS2
+     *        streams publish them with every step
+     * \param[in/out] snapshot the snapshot of the current step
+     ***********/
+    void takeMeshSnapshots(structStepSnapshot &snapshot);
+    /***********************************************************************************************
+     * \brief Close all binary and HDF5 result files, all ADIOS2 streams and all VTK writers
      ***********/
-    void writeDataFields(int step);
+    void closeResultFiles();
     /***********************************************************************************************
      * \brief Initialize all signal files
      * \author Tianyang Wang
      ***********/
     void initSignalFiles();
     /***********************************************************************************************
-     * \brief Write signals of current step to signal files
+     * \brief Copy the signals of the current step
+     * \param[in/out] snapshot the snapshot of the current step
+     ***********/
+    void takeSignalSnapshots(structStepSnapshot &snapshot);
+    /***********************************************************************************************
+     * \brief Write a signal snapshot to its signal file
      * \param[in] step the step number
-     * \author Tianyang Wang
+     * \param[in] snapshot the snapshot of the signal
      ***********/
-    void writeSignals(int step);
+    void writeSignalSnapshot(int step, const structSignalSnapshot &snapshot);
+    /***********************************************************************************************
+     * \brief Write a step snapshot, called on the writer thread
+     * \param[in] snapshot the snapshot
+     ***********/
+    void writeStepSnapshot(const structStepSnapshot &snapshot);
+    /***********************************************************************************************
+     * \brief Give the buffers of a step snapshot back to the pool and delete it
+     * \param[in] snapshot the snapshot
+     ***********/
+    void releaseStepSnapshot(structStepSnapshot *snapshot);
+    /// disallow copy constructor
+    DataOutput(const DataOutput&);
+    /// disallow assignment operator
+    DataOutput& operator=(const DataOutput&);
+};
+
+/********//**
+ * \brief Class StepOutputTask writes the snapshot of an output step of a DataOutput
+ ***********/
+class StepOutputTask: public AbstractOutputTask {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _dataOutput the DataOutput
+     * \param[in] _snapshot the snapshot, released when the task is deleted
+     ***********/
+    StepOutputTask(DataOutput *_dataOutput, DataOutput::structStepSnapshot *_snapshot);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~StepOutputTask();
+    /***********************************************************************************************
+     * \brief Write the snapshot
+     ***********/
+    void execute();
+private:
+    /// the DataOutput
+    DataOutput *dataOutput;
+    /// the snapshot
+    DataOutput::structStepSnapshot *snapshot;
 };
 
 } /* namespace EMPIRE */
@@ -0,0 +1,213 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <vector>
+#ifdef __linux__
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "HardwareCounters.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+bool HardwareCounters::opened = false;
+
+/// the raw event code of the floating point operations, 0 if they are not counted
+static unsigned long long fpOpsEventCode = 0;
+/// whether an event could be opened on the first thread
+static bool isEventAvailable[HardwareCounters::NUM_EVENTS];
+/// the id of a thread <=> the file descriptors of its counters, -1 if not available
+static map<long, vector<int> > threadCounters;
+
+#ifdef __linux__
+/***********************************************************************************************
+ * \brief Open the counter of an event on a thread
+ * \return the file descriptor, -1 if the event is not available
+ ***********/
+static int openCounter(HardwareCounters::Event event, long threadId) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (event) {
+    case HardwareCounters::CYCLES:
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case HardwareCounters::INSTRUCTIONS:
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case HardwareCounters::LLC_MISSES:
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case HardwareCounters::FP_OPS:
+        if (fpOpsEventCode == 0)
+            return -1;
+        attr.type = PERF_TYPE_RAW;
+        attr.config = fpOpsEventCode;
+        break;
+    default:
+        assert(false);
+    }
+    // the counts are scaled if the kernel multiplexes the counters
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // without kernel and hypervisor the counters are allowed for perf_event_paranoid up to 2
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, (pid_t) threadId, -1, -1, 0);
+}
+
+/***********************************************************************************************
+ * \brief Open the counters of the threads which have none yet
+ ***********/
+static void openCountersOfNewThreads() {
+    DIR *taskDir = opendir("/proc/self/task");
+    if (taskDir == NULL)
+        return;
+    struct dirent *entry;
+    while ((entry = readdir(taskDir)) != NULL) {
+        if (entry->d_name[0] == '.')
+            continue;
+        long threadId = atol(entry->d_name);
+        if (threadCounters.find(threadId) != threadCounters.end())
+            continue;
+        vector<int> &counters = threadCounters[threadId];
+        counters.assign(HardwareCounters::NUM_EVENTS, -1);
+        for (int event = 0; event < HardwareCounters::NUM_EVENTS; event++)
+            if (isEventAvailable[event])
+                counters[event] = openCounter((HardwareCounters::Event) event, threadId);
+    }
+    closedir(taskDir);
+}
+#endif
+
+bool HardwareCounters::open(unsigned long long fpOpsRawEvent, int numThreads) {
+    close();
+    fpOpsEventCode = fpOpsRawEvent;
+    bool isAnyEventAvailable = false;
+#ifdef __linux__
+    // the events are probed on the calling thread, the others get the available ones only
+    long threadId = syscall(__NR_gettid);
+    vector<int> &counters = threadCounters[threadId];
+    counters.assign(NUM_EVENTS, -1);
+    for (int event = 0; event < NUM_EVENTS; event++) {
+        counters[event] = openCounter((Event) event, threadId);
+        isEventAvailable[event] = (counters[event] >= 0);
+        isAnyEventAvailable = isAnyEventAvailable || isEventAvailable[event];
+    }
+#endif
+    if (!isAnyEventAvailable) {
+        WARNING_OUT() << "No hardware performance counter is available, see perf_event_paranoid"
+                << endl;
+        close();
+        return false;
+    }
+    for (int event = 0; event < NUM_EVENTS; event++)
+        if (!isEventAvailable[event] && (event != FP_OPS || fpOpsEventCode != 0))
+            WARNING_OUT() << "The hardware performance counter of " << getEventName((Event) event)
+                    << " is not available" << endl;
+    opened = true;
+#ifdef __linux__
+    // the threads of the OpenMP team are started now, such that their counters run from the start,
+    // the barrier keeps the compiler from removing the region
+#pragma omp parallel num_threads(numThreads)
+    {
+#pragma omp barrier
+    }
+    openCountersOfNewThreads();
+#endif
+    return true;
+}
+
+void HardwareCounters::close() {
+#ifdef __linux__
+    for (map<long, vector<int> >::iterator it = threadCounters.begin(); it != threadCounters.end();
+            it++)
+        for (int event = 0; event < NUM_EVENTS; event++)
+            if (it->second[event] >= 0)
+                ::close(it->second[event]);
+#endif
+    threadCounters.clear();
+    for (int event = 0; event < NUM_EVENTS; event++)
+        isEventAvailable[event] = false;
+    opened = false;
+}
+
+bool HardwareCounters::isAvailable(Event event) {
+    assert(event >= 0 && event < NUM_EVENTS);
+    return opened && isEventAvailable[event];
+}
+
+void HardwareCounters::read(double *counts) {
+    for (int event = 0; event < NUM_EVENTS; event++)
+        counts[event] = 0.0;
+    if (!opened)
+        return;
+#ifdef __linux__
+    openCountersOfNewThreads();
+    for (map<long, vector<int> >::const_iterator it = threadCounters.begin();
+            it != threadCounters.end(); it++) {
+        for (int event = 0; event < NUM_EVENTS; event++) {
+            if (it->second[event] < 0)
+                continue;
+            // value, time enabled, time running
+            unsigned long long values[3];
+            if (::read(it->second[event], values, sizeof(values)) != sizeof(values) || values[2] == 0)
+                continue;
+            counts[event] += (double) values[0] * values[1] / values[2];
+        }
+    }
+#endif
+}
+
+const char *HardwareCounters::getEventName(Event event) {
+    switch (event) {
+    case CYCLES:
+        return "cycles";
+    case INSTRUCTIONS:
+        return "instructions";
+    case LLC_MISSES:
+        return "LLC misses";
+    case FP_OPS:
+        return "FP ops";
+    default:
+        assert(false);
+        return "";
+    }
+}
+
+void HardwareCounters::computeMetrics(const double *counts, double time,
+        double &instructionsPerCycle, double &bandwidth, double &bytesPerFlop) {
+    double bytes = counts[LLC_MISSES] * BYTES_PER_CACHE_LINE;
+    instructionsPerCycle = counts[CYCLES] > 0.0 ? counts[INSTRUCTIONS] / counts[CYCLES] : 0.0;
+    bandwidth = time > 0.0 ? bytes / time : 0.0;
+    bytesPerFlop = counts[FP_OPS] > 0.0 ? bytes / counts[FP_OPS] : 0.0;
+}
+
+} /* namespace EMPIRE */
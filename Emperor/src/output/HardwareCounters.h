@@ -0,0 +1,101 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file HardwareCounters.h
+ * This file holds the class HardwareCounters
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef HARDWARECOUNTERS_H_
+#define HARDWARECOUNTERS_H_
+
+#include <string>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class HardwareCounters reads the hardware performance counters of all threads of the
+ *        process by perf_event_open (Linux only): the cycles, the instructions, the misses of the
+ *        last level cache and optionally a raw event counting the floating point operations, which
+ *        is specific to the processor. Every thread has its own counters, open() starts the
+ *        threads of an OpenMP team first. The threads started after open() are added at the next
+ *        read(), their events before are not counted. An event the processor or the kernel
+ *        settings (perf_event_paranoid) do not provide is not available and reads as 0. Multiplexed counters are scaled to the time they were enabled.
+ *        The functions must not be called concurrently.
+ ***********/
+class HardwareCounters {
+public:
+    /// the counted events
+    enum Event {
+        CYCLES, INSTRUCTIONS, LLC_MISSES, FP_OPS, NUM_EVENTS
+    };
+    /// the bytes loaded from the memory per miss of the last level cache
+    static const int BYTES_PER_CACHE_LINE = 64;
+
+    /***********************************************************************************************
+     * \brief Open the counters on all threads of the process
+     * \param[in] fpOpsRawEvent the raw event code (config of PERF_TYPE_RAW) of the floating point
+     *            operations, 0 if they are not counted
+     * \param[in] numThreads the number of threads of the OpenMP team started before
+     * \return whether any event is available
+     ***********/
+    static bool open(unsigned long long fpOpsRawEvent, int numThreads);
+    /***********************************************************************************************
+     * \brief Close the counters
+     ***********/
+    static void close();
+    /***********************************************************************************************
+     * \brief Whether the counters are open
+     ***********/
+    static bool isOpen() {
+        return opened;
+    }
+    /***********************************************************************************************
+     * \brief Whether an event is counted
+     ***********/
+    static bool isAvailable(Event event);
+    /***********************************************************************************************
+     * \brief Read the counts summed over all threads since open()
+     * \param[out] counts the counts of the events, NUM_EVENTS entries
+     ***********/
+    static void read(double *counts);
+    /***********************************************************************************************
+     * \brief Get the name of an event as used in the report
+     ***********/
+    static const char *getEventName(Event event);
+    /***********************************************************************************************
+     * \brief Get the derived metrics of the counts of a scope
+     * \param[in] counts the counts of the events, NUM_EVENTS entries
+     * \param[in] time the wall time of the scope
+     * \param[out] instructionsPerCycle the instructions per cycle, 0 without cycles
+     * \param[out] bandwidth the bytes loaded from the memory per second, by the cache misses
+     * \param[out] bytesPerFlop the bytes loaded from the memory per floating point operation, 0
+     *             without operations
+     ***********/
+    static void computeMetrics(const double *counts, double time, double &instructionsPerCycle,
+            double &bandwidth, double &bytesPerFlop);
+private:
+    /// whether the counters are open
+    static bool opened;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* HARDWARECOUNTERS_H_ */
@@ -0,0 +1,316 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <pthread.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include "LiveMetrics.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Struct MetricFamily is the name, type and help text of a family of the LiveMetrics
+ ***********/
+struct MetricFamily {
+    const char *name;
+    bool isCounter;
+    const char *help;
+};
+
+/// the families in the order of LiveMetrics::Family
+static const MetricFamily families[LiveMetrics::NUM_FAMILIES] = {
+        { "empire_time_step", false, "Current time step of the time step loop" },
+        { "empire_coupling_iterations", true, "Coupling iterations of all time steps" },
+        { "empire_coupling_iteration", false, "Coupling iteration of the current time step" },
+        { "empire_residual_absolute", false, "Absolute residual of the last convergence check" },
+        { "empire_residual_relative", false,
+                "Residual of the last convergence check relative to the first iteration" },
+        { "empire_connection_filter_seconds", true, "Wall time of the filters of a connection" },
+        { "empire_client_wait_seconds", true, "Wall time a transfer of a client was blocked" },
+        { "empire_client_bytes", true, "Bytes transferred from and to a client" } };
+
+/********//**
+ * \brief Struct MetricSample is a sample of the LiveMetrics, the family and the labels do not
+ *        change after the sample is published
+ ***********/
+struct MetricSample {
+    LiveMetrics::Family family;
+    string labels;
+    double value;
+};
+
+/// the number of samples the table holds, further samples are dropped
+static const int MAX_NUM_SAMPLES = 4096;
+/// the samples
+static MetricSample samples[MAX_NUM_SAMPLES];
+/// the number of published samples, a sample is complete before it is counted
+static int numSamples = 0;
+/// serializes the creation of the samples, the updates and reads of the values take no lock
+static pthread_mutex_t samplesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+bool LiveMetrics::enabled = false;
+
+/// the file rewritten every interval, empty for no file
+static string metricsFileName;
+/// the seconds between two writes of the file
+static double metricsInterval = 10.0;
+/// the listening socket, -1 if there is none
+static int listenSocket = -1;
+/// the background thread
+static pthread_t metricsThread;
+/// set to end the background thread
+static volatile bool isStopRequested = false;
+
+/***********************************************************************************************
+ * \brief Find a sample among the samples begin to end
+ * \return the index of the sample, -1 if it is not found
+ ***********/
+static int findSample(LiveMetrics::Family family, const string &labels, int begin, int end) {
+    for (int i = begin; i < end; i++)
+        if (samples[i].family == family && samples[i].labels == labels)
+            return i;
+    return -1;
+}
+
+/***********************************************************************************************
+ * \brief Get the number of published samples
+ ***********/
+static int getNumSamples() {
+    int n;
+#pragma omp atomic read
+    n = numSamples;
+    __sync_synchronize();
+    return n;
+}
+
+void LiveMetrics::update(Family family, const std::string &labels, double value, bool isAdded) {
+    int numPublished = getNumSamples();
+    int i = findSample(family, labels, 0, numPublished);
+    if (i < 0) {
+        pthread_mutex_lock(&samplesMutex);
+        // another thread may have created the sample meanwhile
+        i = findSample(family, labels, numPublished, numSamples);
+        if (i < 0 && numSamples < MAX_NUM_SAMPLES) {
+            i = numSamples;
+            samples[i].family = family;
+            samples[i].labels = labels;
+            samples[i].value = 0.0;
+            __sync_synchronize();
+#pragma omp atomic write
+            numSamples = i + 1;
+        }
+        pthread_mutex_unlock(&samplesMutex);
+        if (i < 0)
+            return;
+    }
+    if (isAdded) {
+#pragma omp atomic
+        samples[i].value += value;
+    } else {
+#pragma omp atomic write
+        samples[i].value = value;
+    }
+}
+
+std::string LiveMetrics::label(const std::string &name, const std::string &value) {
+    string escaped;
+    for (int i = 0; i < value.size(); i++) {
+        if (value[i] == '\\' || value[i] == '"')
+            escaped += '\\';
+        if (value[i] == '\n')
+            escaped += "\\n";
+        else
+            escaped += value[i];
+    }
+    return name + "=\"" + escaped + "\"";
+}
+
+/***********************************************************************************************
+ * \brief Get the resident memory of the process from /proc
+ * \return the bytes, 0 if they cannot be read
+ ***********/
+static double getResidentMemory() {
+    ifstream statm("/proc/self/statm");
+    long numPages, numResidentPages;
+    if (!(statm >> numPages >> numResidentPages))
+        return 0.0;
+    return (double) numResidentPages * sysconf(_SC_PAGESIZE);
+}
+
+std::string LiveMetrics::format() {
+    int n = getNumSamples();
+    stringstream text;
+    text << setprecision(17);
+    for (int f = 0; f < NUM_FAMILIES; f++) {
+        bool isHeaderWritten = false;
+        for (int i = 0; i < n; i++) {
+            if (samples[i].family != f)
+                continue;
+            if (!isHeaderWritten) {
+                text << "# TYPE " << families[f].name << " "
+                        << (families[f].isCounter ? "counter" : "gauge") << "\n";
+                text << "# HELP " << families[f].name << " " << families[f].help << "\n";
+                isHeaderWritten = true;
+            }
+            double value;
+#pragma omp atomic read
+            value = samples[i].value;
+            text << families[f].name << (families[f].isCounter ? "_total" : "");
+            if (!samples[i].labels.empty())
+                text << "{" << samples[i].labels << "}";
+            text << " " << value << "\n";
+        }
+    }
+    text << "# TYPE empire_resident_memory_bytes gauge\n";
+    text << "# HELP empire_resident_memory_bytes Resident memory of the Emperor process\n";
+    text << "empire_resident_memory_bytes " << getResidentMemory() << "\n";
+    text << "# EOF\n";
+    return text.str();
+}
+
+void LiveMetrics::writeFile() {
+    if (metricsFileName.empty())
+        return;
+    // the file is replaced at once, such that it is never read half written
+    string tmpFileName = metricsFileName + ".tmp";
+    {
+        ofstream file(tmpFileName.c_str());
+        file << format();
+    }
+    if (rename(tmpFileName.c_str(), metricsFileName.c_str()) != 0)
+        WARNING_OUT() << "Cannot write the metrics file " << metricsFileName << endl;
+}
+
+void LiveMetrics::answerRequest() {
+    int connection = accept(listenSocket, NULL, NULL);
+    if (connection < 0)
+        return;
+    // every request gets the metrics, the request itself is read until its header ends
+    char buffer[4096];
+    string request;
+    struct pollfd fd = { connection, POLLIN, 0 };
+    while (request.find("\r\n\r\n") == string::npos && request.size() < 65536
+            && poll(&fd, 1, 1000) > 0) {
+        ssize_t size = recv(connection, buffer, sizeof(buffer), 0);
+        if (size <= 0)
+            break;
+        request.append(buffer, size);
+    }
+    string body = format();
+    stringstream response;
+    response << "HTTP/1.1 200 OK\r\n"
+            << "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+            << "Content-Length: " << body.size() << "\r\n" << "Connection: close\r\n\r\n" << body;
+    string text = response.str();
+    for (size_t sent = 0; sent < text.size();) {
+        ssize_t size = send(connection, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+        if (size <= 0)
+            break;
+        sent += size;
+    }
+    close(connection);
+}
+
+void *LiveMetrics::run(void *) {
+    double nextWriteTime = omp_get_wtime();
+    while (!isStopRequested) {
+        double now = omp_get_wtime();
+        if (now >= nextWriteTime) {
+            writeFile();
+            nextWriteTime = now + metricsInterval;
+        }
+        // the stop request is checked at least every 200 ms
+        int timeout = (int) (1000.0 * min(nextWriteTime - now, 0.2)) + 1;
+        if (listenSocket < 0) {
+            usleep(timeout * 1000);
+            continue;
+        }
+        struct pollfd fd = { listenSocket, POLLIN, 0 };
+        if (poll(&fd, 1, timeout) > 0)
+            answerRequest();
+    }
+    return NULL;
+}
+
+void LiveMetrics::start(const std::string &fileName, double interval, int port) {
+    stop();
+    if (fileName.empty() && port == 0)
+        return;
+    metricsFileName = fileName;
+    metricsInterval = interval > 0.0 ? interval : 10.0;
+    if (port != 0) {
+        listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        struct sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (listenSocket < 0
+                || bind(listenSocket, (struct sockaddr*) &address, sizeof(address)) != 0
+                || listen(listenSocket, 8) != 0) {
+            WARNING_OUT() << "Cannot serve the metrics on port " << port << ": "
+                    << strerror(errno) << endl;
+            if (listenSocket >= 0)
+                close(listenSocket);
+            listenSocket = -1;
+        }
+    }
+    if (metricsFileName.empty() && listenSocket < 0)
+        return;
+    isStopRequested = false;
+    enabled = true;
+    pthread_create(&metricsThread, NULL, &LiveMetrics::run, NULL);
+    stringstream message;
+    message << "Live metrics are";
+    if (!metricsFileName.empty())
+        message << " written to " << metricsFileName << " every " << metricsInterval << " s";
+    if (listenSocket >= 0)
+        message << (metricsFileName.empty() ? "" : " and") << " served on port " << port;
+    INFO_OUT() << message.str() << endl;
+}
+
+void LiveMetrics::stop() {
+    if (!enabled)
+        return;
+    isStopRequested = true;
+    pthread_join(metricsThread, NULL);
+    enabled = false;
+    writeFile();
+    if (listenSocket >= 0)
+        close(listenSocket);
+    listenSocket = -1;
+}
+
+} /* namespace EMPIRE */
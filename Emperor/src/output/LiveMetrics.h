@@ -0,0 +1,138 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file LiveMetrics.h
+ * This file holds the class LiveMetrics
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef LIVEMETRICS_H_
+#define LIVEMETRICS_H_
+
+#include <string>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class LiveMetrics exposes the state of a running co-simulation (time step, coupling
+ *        iterations, residuals, filter time of the connections, wait time and bytes of the
+ *        transfers of the clients, resident memory) in the OpenMetrics text format, which
+ *        monitoring systems such as Prometheus read. A background thread rewrites a metrics file
+ *        every interval and, if a port is set, answers every HTTP request on the port with the
+ *        metrics. The samples are created at their first update from any thread and live in a
+ *        fixed table, the background thread reads them without taking a lock. While the metrics
+ *        are disabled an update costs one branch.
+ ***********/
+class LiveMetrics {
+public:
+    /// the metric families, a sample of a family is distinguished by its labels
+    enum Family {
+        /// gauge, the current time step of the time step loop
+        TIME_STEP,
+        /// counter, the coupling iterations of all time steps
+        COUPLING_ITERATIONS,
+        /// gauge, the coupling iteration of the current time step
+        COUPLING_ITERATION,
+        /// gauge, the absolute residual of the last convergence check
+        RESIDUAL_ABSOLUTE,
+        /// gauge, the residual of the last convergence check relative to the first iteration
+        RESIDUAL_RELATIVE,
+        /// counter, the wall time of the filters of a connection
+        CONNECTION_FILTER_SECONDS,
+        /// counter, the wall time a transfer of a client was blocked
+        CLIENT_WAIT_SECONDS,
+        /// counter, the bytes transferred from and to a client
+        CLIENT_BYTES,
+        NUM_FAMILIES
+    };
+    /***********************************************************************************************
+     * \brief Start the background thread, a running thread is stopped before
+     * \param[in] fileName the file rewritten every interval, empty for no file
+     * \param[in] interval the seconds between two writes of the file
+     * \param[in] port the TCP port answering HTTP requests, 0 for no port
+     ***********/
+    static void start(const std::string &fileName, double interval, int port);
+    /***********************************************************************************************
+     * \brief Stop the background thread, the file is written a last time, the samples are kept
+     ***********/
+    static void stop();
+    /***********************************************************************************************
+     * \brief Whether the background thread is running
+     ***********/
+    static bool isEnabled() {
+        return enabled;
+    }
+    /***********************************************************************************************
+     * \brief Add to a counter, thread safe
+     * \param[in] family the family of the counter
+     * \param[in] labels the labels of the sample, e.g. label("client", name), empty for none
+     * \param[in] value the value added
+     ***********/
+    static void add(Family family, const std::string &labels, double value) {
+        if (enabled)
+            update(family, labels, value, true);
+    }
+    /***********************************************************************************************
+     * \brief Set a gauge, thread safe
+     * \param[in] family the family of the gauge
+     * \param[in] labels the labels of the sample, empty for none
+     * \param[in] value the value
+     ***********/
+    static void set(Family family, const std::string &labels, double value) {
+        if (enabled)
+            update(family, labels, value, false);
+    }
+    /***********************************************************************************************
+     * \brief Get a label of a sample with the value escaped
+     * \param[in] name the name of the label
+     * \param[in] value the value of the label
+     * \return the label as name="value"
+     ***********/
+    static std::string label(const std::string &name, const std::string &value);
+    /***********************************************************************************************
+     * \brief Get the metrics in the OpenMetrics text format, without taking a lock
+     * \return the text, ending with "# EOF"
+     ***********/
+    static std::string format();
+
+private:
+    /***********************************************************************************************
+     * \brief Add to a sample or set it, the sample is created at the first update
+     ***********/
+    static void update(Family family, const std::string &labels, double value, bool isAdded);
+    /***********************************************************************************************
+     * \brief Write the metrics to the file, it is replaced at once
+     ***********/
+    static void writeFile();
+    /***********************************************************************************************
+     * \brief Answer the pending HTTP request on the listening socket
+     ***********/
+    static void answerRequest();
+    /***********************************************************************************************
+     * \brief The loop of the background thread
+     ***********/
+    static void *run(void *);
+    /// whether the background thread is running
+    static bool enabled;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* LIVEMETRICS_H_ */
@@ -19,8 +19,11 @@
  *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
  */
 #include "Message.h"
+#include <omp.h>
+#include <pthread.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <vector>
 
 using namespace std;
 
@@ -28,6 +31,81 @@ namespace EMPIRE {
 ///Allocate memory for static member
 Message::OutputLevel Message::userSetOutputLevel = Message::INFO; // give a default value to it
 
+/********//**
+ * \brief Struct ThreadBuffer holds the text written by a thread which is not the sink
+ ***********/
+struct ThreadBuffer {
+    /// the text not yet queued
+    ostringstream text;
+    /// the stream the text is written to
+    ostream *target;
+};
+
+/// the buffer of the thread, created at its first message
+static ThreadBuffer *threadBuffer = NULL;
+#pragma omp threadprivate(threadBuffer)
+/// the thread which writes the messages
+static pthread_t sinkThread = pthread_self();
+/// the OpenMP nesting level of the sink thread, it buffers its messages in deeper levels
+static int sinkLevel = 0;
+/// the text queued by the other threads with the stream it is written to
+static vector<pair<ostream*, string> > queuedText;
+/// the size of queuedText, read by the sink thread without locking
+static int numQueuedText = 0;
+/// serializes the access to queuedText
+static pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/***********************************************************************************************
+ * \brief Whether the calling thread is the sink thread outside of parallel regions nested in its
+ *        level
+ ***********/
+static bool isSinkThread() {
+    return pthread_equal(pthread_self(), sinkThread) && omp_get_level() <= sinkLevel;
+}
+
+/***********************************************************************************************
+ * \brief Queue the text in the buffer of the thread
+ ***********/
+static void queueBufferedText() {
+    if (threadBuffer == NULL || threadBuffer->text.tellp() <= 0)
+        return;
+    pthread_mutex_lock(&queueMutex);
+    queuedText.push_back(make_pair(threadBuffer->target, threadBuffer->text.str()));
+#pragma omp atomic
+    numQueuedText++;
+    pthread_mutex_unlock(&queueMutex);
+    threadBuffer->text.str("");
+}
+
+/***********************************************************************************************
+ * \brief Write the queued text
+ ***********/
+static void writeQueuedText() {
+    int numQueued;
+#pragma omp atomic read
+    numQueued = numQueuedText;
+    if (numQueued == 0)
+        return;
+    vector<pair<ostream*, string> > text;
+    pthread_mutex_lock(&queueMutex);
+    text.swap(queuedText);
+#pragma omp atomic write
+    numQueuedText = 0;
+    pthread_mutex_unlock(&queueMutex);
+    for (int i = 0; i < text.size(); i++)
+        *text[i].first << text[i].second;
+    for (int i = 0; i < text.size(); i++)
+        text[i].first->flush();
+}
+
+/***********************************************************************************************
+ * \brief Write the queued text at exit
+ ***********/
+static void writeQueuedTextAtExit() {
+    queueBufferedText();
+    writeQueuedText();
+}
+
 Message debugOut  (Message::DEBUG, std::cout);
 Message infoOut   (Message::INFO,  std::cout);
 Message warningOut(Message::WARNING, std::cout);
@@ -50,6 +128,8 @@ Message::Message(OutputLevel _outputLevel, std::ostream &_outputStream) :
     //outputStream << std::scientific;
     //outputStream.precision(10);
 
+    if (outputLevel == ERROR)
+        atexit(writeQueuedTextAtExit);
 }
 
 Message::~Message() {
@@ -57,40 +137,81 @@ Message::~Message() {
 
 
 Message& Message::operator()() {
-    if (userSetOutputLevel >= outputLevel){
-        outputStream << "EMPIRE_" << outputLevelString << ": "  ;
+    if (isEnabled()){
+        getStream() << "EMPIRE_" << outputLevelString << ": "  ;
     }
     return (*this);
 }
 
 Message& Message::operator()(std::string title) {
-    if (userSetOutputLevel >= outputLevel){
-        outputStream << "EMPIRE_" << outputLevelString << ": " << title << endl;
+    if (isEnabled()){
+        ostream &stream = getStream();
+        stream << "EMPIRE_" << outputLevelString << ": " << title << endl;
+        endLine(stream);
     }
     return (*this);
 }
 
 Message& Message::operator<<(std::ostream& (*pf)(std::ostream&)) {
-    if (userSetOutputLevel >= outputLevel){
-        outputStream << pf;
+    if (isEnabled()){
+        ostream &stream = getStream();
+        stream << pf;
+        endLine(stream);
     }
     return (*this);
 }
 
 Message& Message::operator<<(std::ios& (*pf)(std::ios&)) {
-    if (userSetOutputLevel >= outputLevel){
-        outputStream << pf;
+    if (isEnabled()){
+        getStream() << pf;
     }
     return (*this);
 }
 
 Message& Message::operator<<(std::ios_base& (*pf)(std::ios_base&)) {
-    if (userSetOutputLevel >= outputLevel){
-        outputStream << pf;
+    if (isEnabled()){
+        getStream() << pf;
     }
     return (*this);
 }
 
+void Message::flush() {
+    if (isSinkThread())
+        writeQueuedText();
+}
+
+void Message::setSinkThread() {
+    queueBufferedText(); // the text written before is written by the new sink
+    sinkThread = pthread_self();
+    sinkLevel = omp_get_level();
+    writeQueuedText();
+}
+
+std::ostream &Message::getStream() {
+    if (isSinkThread()) {
+        writeQueuedText();
+        return outputStream;
+    }
+    if (outputLevel == ERROR)
+        return outputStream;
+    if (threadBuffer == NULL) {
+        threadBuffer = new ThreadBuffer();
+        threadBuffer->target = NULL;
+    }
+    if (threadBuffer->target != &outputStream) {
+        queueBufferedText();
+        threadBuffer->target = &outputStream;
+        threadBuffer->text.flags(outputStream.flags());
+        threadBuffer->text.precision(outputStream.precision());
+    }
+    return threadBuffer->text;
+}
+
+void Message::endLine(const std::ostream &stream) {
+    if (&stream != &outputStream)
+        queueBufferedText();
+}
+
 void Message::writeHeading(int headingLevel, const std::string &className,
         const std::string &info, Message &message) {
     int numSeperationRows;
@@ -172,6 +293,7 @@ void Message::writeWarning(const string &className, const string &functionName,
 
 void Message::writeError(const string &className, const string &functionName,
         const string &message) {
+    flush();
     errorOut() << endl;
     errorOut() << "++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++" << endl;
     errorOut() << "============================================================" << endl;
@@ -31,9 +31,20 @@
 #include <string>
 #include <sstream>
 
+/// the most verbose level compiled in, messages of higher levels are removed by the compiler
+#ifndef EMPIRE_MAX_OUTPUT_LEVEL
+#define EMPIRE_MAX_OUTPUT_LEVEL 3
+#endif
+
 namespace EMPIRE {
 /********//**
- * \brief This manages the output functions for writing to the teminal
+ * \brief This manages the output functions for writing to the teminal.
+ *        The thread which loads EMPIRE is the sink of the messages until another thread calls
+ *        setSinkThread, e.g. the coupling thread in its OpenMP section. The sink writes to the
+ *        streams directly, except in parallel regions nested in its level. Any other thread, e.g.
+ *        in a parallel region or a task pool, writes into an own buffer without locks. Its lines are queued at std::endl or
+ *        std::flush and written by the sink thread before its next message or in flush().
+ *        Errors are written directly.
  **************************************************************************************************/
 class Message {
 public:
@@ -78,8 +89,8 @@ public:
      * \author Tianyang Wang
      ***********/
     template<class T> Message &operator<<(T obj) {
-        if (userSetOutputLevel >= outputLevel)
-            outputStream << obj;
+        if (isEnabled())
+            getStream() << obj;
         return (*this);
     }
     /***********************************************************************************************
@@ -146,16 +157,49 @@ public:
      * \author Fabien Pean
      ***********/
     static bool isDebugMode() {
-    	return userSetOutputLevel >= DEBUG ? true : false;
+    	return isEnabled(DEBUG);
     }
     /***********************************************************************************************
      * \brief To know if Empire is run in info
      * \author Fabien Pean
      ***********/
     static bool isInfoMode() {
-    	return userSetOutputLevel >= INFO ? true : false;
+    	return isEnabled(INFO);
+    }
+    /***********************************************************************************************
+     * \brief Whether messages of a level are written, false if the level is compiled out
+     * \param[in] level the level of the messages
+     ***********/
+    static bool isEnabled(OutputLevel level) {
+        return level <= EMPIRE_MAX_OUTPUT_LEVEL && userSetOutputLevel >= level;
+    }
+    /***********************************************************************************************
+     * \brief Whether the messages of this object are written
+     ***********/
+    bool isEnabled() const {
+        return isEnabled(outputLevel);
     }
+    /***********************************************************************************************
+     * \brief Write the lines queued by the other threads, does nothing unless called by the sink
+     *        thread outside of parallel regions nested in its level
+     ***********/
+    static void flush();
+    /***********************************************************************************************
+     * \brief Make the calling thread the sink of the messages at its current OpenMP nesting level,
+     *        its messages are then written directly at this level and buffered in deeper ones
+     ***********/
+    static void setSinkThread();
 private:
+    /***********************************************************************************************
+     * \brief Get the stream to write to, the output stream for the sink thread and errors, the
+     *        buffer of the thread otherwise
+     ***********/
+    std::ostream &getStream();
+    /***********************************************************************************************
+     * \brief Queue the buffered text if the stream is the buffer of the thread
+     * \param[in] stream the stream just written to
+     ***********/
+    void endLine(const std::ostream &stream);
     /// outputLevel enum
     OutputLevel outputLevel;
     /// outputStream where message is redirected
@@ -174,17 +218,24 @@ extern Message warningOut;
       Is expanded to #pragma omp critical (IOSync);
 ***********/
 #define CRITICAL_OUTPUT _Pragma("omp critical (IOSync)")
+/**************************************************************************************************!
+      Skips the following statement including the evaluation of its arguments if messages of
+      \a level are not written. It is a loop running at most once instead of an if-else, so that
+      an unbraced if in front of the message has no ambiguous else.
+***********/
+#define IF_OUTPUT_LEVEL(level) /*
+ */                for (bool outputEnabled_ = Message::isEnabled(level); outputEnabled_; outputEnabled_ = false)
 /**************************************************************************************************!
   Forwards \a string argument to infoOut(string) Message object;
 ***********/
 #define INFO_OUT(string) /*
- */                CRITICAL_OUTPUT /*
+ */                IF_OUTPUT_LEVEL(Message::INFO) /*
  */                infoOut(string)
 /**************************************************************************************************!
   Forwards \a string argument to debugOut(string) Message object;
 ***********/
 #define DEBUG_OUT(string) /*
- */                CRITICAL_OUTPUT /*
+ */                IF_OUTPUT_LEVEL(Message::DEBUG) /*
  */                debugOut(string)
 /**************************************************************************************************!
   Forwards \a string argument to errorOut(string) Message object;
@@ -196,26 +247,26 @@ extern Message warningOut;
   Forwards \a string argument to warning(string) Message object;
 ***********/
 #define WARNING_OUT(string) /*
- */                CRITICAL_OUTPUT /*
+ */                IF_OUTPUT_LEVEL(Message::WARNING) /*
  */                warningOut(string)
 /**************************************************************************************************!
   Forwards \a headingLevel \a className \a message and \a ioObject arguments to writeHeading
   function
 ***********/
 #define HEADING_OUT(headingLevel, className, message, ioObject) /*
-*/                CRITICAL_OUTPUT /*
+*/                for (bool outputEnabled_ = (ioObject).isEnabled(); outputEnabled_; outputEnabled_ = false) /*
 */Message::writeHeading(headingLevel, className, message, ioObject)
 /**************************************************************************************************!
   Forwards \a numIndents  \a message and \a ioObject arguments to writeTextWithIndent function
 ***********/
 #define INDENT_OUT(numIndents,  message, ioObject) /*
-*/                CRITICAL_OUTPUT /*
+*/                for (bool outputEnabled_ = (ioObject).isEnabled(); outputEnabled_; outputEnabled_ = false) /*
 */Message::writeTextWithIndent(numIndents, message, ioObject)
 /**************************************************************************************************!
   Forwards \a className  \a functionName and \a message arguments to writeWarning function
 ***********/
 #define WARNING_BLOCK_OUT(className,  functionName, message) /*
-*/                CRITICAL_OUTPUT /*
+*/                IF_OUTPUT_LEVEL(Message::WARNING) /*
 */Message::writeWarning(className,  functionName, message)
 /**************************************************************************************************!
   Forwards \a className  \a functionName and \a message arguments to writeWarning function
@@ -227,7 +278,7 @@ extern Message warningOut;
   Prints a ASCII Art Block(thread safe)
 ***********/
 #define ASCIIART_BLOCK() /*
-*/                CRITICAL_OUTPUT /*
+*/                IF_OUTPUT_LEVEL(Message::INFO) /*
 */Message::writeASCIIArt()
 } /* namespace EMPIRE */
 #endif /* MESSAGE_H_ */
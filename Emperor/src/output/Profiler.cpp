@@ -0,0 +1,355 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <pthread.h>
+#include <assert.h>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include "Profiler.h"
+#include "TraceWriter.h"
+#include "HardwareCounters.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Struct ProfilerNode is a timed scope in the tree of the Profiler
+ ***********/
+struct ProfilerNode {
+    /// the name of the scope
+    string name;
+    /// the enclosing scope
+    ProfilerNode *parent;
+    /// the scopes in this scope in the order of their first call
+    vector<ProfilerNode*> children;
+    /// the number of calls
+    int numCalls;
+    /// the accumulated wall time
+    double time;
+    /// the number of calls at the last row written to the CSV file
+    int numCallsWritten;
+    /// the time at the last row written to the CSV file
+    double timeWritten;
+    /// the accumulated counts of the hardware events
+    double counts[HardwareCounters::NUM_EVENTS];
+
+    ProfilerNode(const string &_name, ProfilerNode *_parent) :
+            name(_name), parent(_parent), numCalls(0), time(0.0), numCallsWritten(0), timeWritten(0.0) {
+        for (int event = 0; event < HardwareCounters::NUM_EVENTS; event++)
+            counts[event] = 0.0;
+    }
+    ~ProfilerNode() {
+        for (int i = 0; i < children.size(); i++)
+            delete children[i];
+    }
+    ProfilerNode *getChild(const string &childName) {
+        for (int i = 0; i < children.size(); i++)
+            if (children[i]->name == childName)
+                return children[i];
+        children.push_back(new ProfilerNode(childName, this));
+        return children.back();
+    }
+};
+
+bool Profiler::enabled = false;
+
+/// the root of the tree of timers
+static ProfilerNode rootNode("total", NULL);
+/// the innermost running timer
+static ProfilerNode *currentNode = &rootNode;
+/// the thread on which the timers are recorded
+static pthread_t couplingThread;
+/// the OpenMP nesting level of the coupling thread, timers in deeper levels are not recorded
+static int couplingLevel = 0;
+/// the counters
+static map<string, double> counters;
+/// the monitored values
+static map<string, double> values;
+/// serializes the access to the counters and the monitored values
+static pthread_mutex_t countersMutex = PTHREAD_MUTEX_INITIALIZER;
+/// the CSV file for the rows of the time steps
+static ofstream csvFile;
+/// the track of the timers in the trace
+static int emperorTrack = -1;
+/// the counts of the hardware events at the start of the running timers, one after the other
+static vector<double> startCounts;
+
+void Profiler::ScopedTimer::start(const std::string &name) {
+    if (!pthread_equal(pthread_self(), couplingThread) || omp_get_level() > couplingLevel)
+        return;
+    node = currentNode->getChild(name);
+    currentNode = node;
+    if (HardwareCounters::isOpen()) {
+        startCounts.resize(startCounts.size() + HardwareCounters::NUM_EVENTS);
+        HardwareCounters::read(&startCounts[startCounts.size() - HardwareCounters::NUM_EVENTS]);
+    }
+    startTime = omp_get_wtime();
+}
+
+void Profiler::ScopedTimer::stop() {
+    double endTime = omp_get_wtime();
+    node->time += endTime - startTime;
+    // the counters may have been opened while the timer was running
+    if (HardwareCounters::isOpen() && startCounts.size() >= HardwareCounters::NUM_EVENTS) {
+        double counts[HardwareCounters::NUM_EVENTS];
+        HardwareCounters::read(counts);
+        const double *start = &startCounts[startCounts.size() - HardwareCounters::NUM_EVENTS];
+        for (int event = 0; event < HardwareCounters::NUM_EVENTS; event++)
+            node->counts[event] += counts[event] - start[event];
+        startCounts.resize(startCounts.size() - HardwareCounters::NUM_EVENTS);
+    }
+    if (TraceWriter::isOpen())
+        TraceWriter::addEvent(emperorTrack, node->name, "emperor", startTime, endTime);
+    node->numCalls++;
+    assert(currentNode == node);
+    currentNode = node->parent;
+}
+
+void Profiler::WorkerTimer::start() {
+    startTime = omp_get_wtime();
+}
+
+void Profiler::WorkerTimer::stop() {
+    double endTime = omp_get_wtime();
+    stringstream trackName;
+    trackName << "worker " << omp_get_thread_num();
+    TraceWriter::addEvent(TraceWriter::getTrack(trackName.str()), name, "worker", startTime, endTime);
+}
+
+void Profiler::setEnabled(bool _enabled) {
+    couplingThread = pthread_self();
+    couplingLevel = omp_get_level();
+    enabled = _enabled;
+}
+
+void Profiler::setHardwareCounters(bool _enabled, unsigned long long fpOpsRawEvent,
+        int numThreads) {
+    startCounts.clear();
+    if (_enabled)
+        HardwareCounters::open(fpOpsRawEvent, numThreads);
+    else
+        HardwareCounters::close();
+}
+
+void Profiler::addCount(const std::string &name, double value) {
+    if (!enabled)
+        return;
+    pthread_mutex_lock(&countersMutex);
+    counters[name] += value;
+    pthread_mutex_unlock(&countersMutex);
+}
+
+void Profiler::setValue(const std::string &name, double value) {
+    if (!enabled)
+        return;
+    pthread_mutex_lock(&countersMutex);
+    values[name] = value;
+    pthread_mutex_unlock(&countersMutex);
+}
+
+double Profiler::getValue(const std::string &name) {
+    double value = 0.0;
+    pthread_mutex_lock(&countersMutex);
+    map<string, double>::const_iterator it = values.find(name);
+    if (it != values.end())
+        value = it->second;
+    pthread_mutex_unlock(&countersMutex);
+    return value;
+}
+
+void Profiler::setCSVFile(const std::string &fileName) {
+    if (csvFile.is_open())
+        csvFile.close();
+    if (fileName.empty())
+        return;
+    csvFile.open(fileName.c_str());
+    csvFile << "timeStep,scope,calls,time" << endl;
+}
+
+void Profiler::setTraceFile(const std::string &fileName) {
+    TraceWriter::close();
+    if (fileName.empty())
+        return;
+    TraceWriter::open(fileName);
+    emperorTrack = TraceWriter::getTrack("Emperor");
+}
+
+/***********************************************************************************************
+ * \brief Write the rows of a node and of its children since the last call to the CSV file
+ ***********/
+static void writeRows(int timeStep, ProfilerNode *node, const string &path) {
+    for (int i = 0; i < node->children.size(); i++) {
+        ProfilerNode *child = node->children[i];
+        string childPath = path.empty() ? child->name : path + "/" + child->name;
+        if (child->numCalls > child->numCallsWritten)
+            csvFile << timeStep << ",\"" << childPath << "\"," << child->numCalls - child->numCallsWritten
+                    << "," << child->time - child->timeWritten << "\n";
+        child->numCallsWritten = child->numCalls;
+        child->timeWritten = child->time;
+        writeRows(timeStep, child, childPath);
+    }
+}
+
+void Profiler::writeTimeStep(int timeStep) {
+    if (!enabled || !csvFile.is_open())
+        return;
+    writeRows(timeStep, &rootNode, "");
+    csvFile.flush();
+}
+
+/***********************************************************************************************
+ * \brief Print a node and its children with the share of the time of the parent
+ ***********/
+static void printNode(const ProfilerNode *node, double parentTime, int depth) {
+    stringstream line;
+    line << string(2 * depth, ' ') << left << setw(50 - 2 * depth) << node->name << right << setw(10)
+            << node->numCalls << setw(14) << fixed << setprecision(4) << node->time << setw(8)
+            << setprecision(1) << (parentTime > 0.0 ? 100.0 * node->time / parentTime : 100.0);
+    INFO_OUT() << line.str() << endl;
+    for (int i = 0; i < node->children.size(); i++)
+        printNode(node->children[i], node->time, depth + 1);
+}
+
+/***********************************************************************************************
+ * \brief Add the calls and the time of a node and its children to the totals per scope name, a scope
+ *        nested in a scope of the same name is not counted twice
+ ***********/
+static void addToTotals(const ProfilerNode *node, map<string, pair<int, double> > &totals,
+        map<string, vector<double> > &totalCounts, map<string, int> &openScopes) {
+    bool isOuterScope = (openScopes[node->name]++ == 0);
+    if (isOuterScope) {
+        totals[node->name].first += node->numCalls;
+        totals[node->name].second += node->time;
+        vector<double> &counts = totalCounts[node->name];
+        counts.resize(HardwareCounters::NUM_EVENTS, 0.0);
+        for (int event = 0; event < HardwareCounters::NUM_EVENTS; event++)
+            counts[event] += node->counts[event];
+    }
+    for (int i = 0; i < node->children.size(); i++)
+        addToTotals(node->children[i], totals, totalCounts, openScopes);
+    openScopes[node->name]--;
+}
+
+void Profiler::printSummary() {
+    if (!enabled)
+        return;
+    HEADING_OUT(3, "Profiler", "Wall time of the timed scopes", infoOut);
+    stringstream header;
+    header << left << setw(50) << "scope" << right << setw(10) << "calls" << setw(14) << "time [s]"
+            << setw(8) << "%";
+    INFO_OUT() << header.str() << endl;
+    // the total is the sum of the outermost scopes
+    rootNode.time = 0.0;
+    rootNode.numCalls = 1;
+    for (int i = 0; i < rootNode.children.size(); i++)
+        rootNode.time += rootNode.children[i]->time;
+    printNode(&rootNode, 0.0, 0);
+
+    // the same scope (e.g. "mapping" or "wait for inputs") may be called at many places of the tree
+    HEADING_OUT(3, "Profiler", "Wall time per scope name", infoOut);
+    map<string, pair<int, double> > totals;
+    map<string, vector<double> > totalCounts;
+    map<string, int> openScopes;
+    for (int i = 0; i < rootNode.children.size(); i++)
+        addToTotals(rootNode.children[i], totals, totalCounts, openScopes);
+    stringstream totalsHeader;
+    totalsHeader << left << setw(50) << "scope" << right << setw(10) << "calls" << setw(14)
+            << "time [s]" << setw(16) << "time/call [ms]";
+    INFO_OUT() << totalsHeader.str() << endl;
+    for (map<string, pair<int, double> >::const_iterator it = totals.begin(); it != totals.end();
+            it++) {
+        stringstream line;
+        line << left << setw(50) << it->first << right << setw(10) << it->second.first << setw(14)
+                << fixed << setprecision(4) << it->second.second << setw(16) << setprecision(4)
+                << (it->second.first > 0 ? 1e3 * it->second.second / it->second.first : 0.0);
+        INFO_OUT() << line.str() << endl;
+    }
+
+    // whether a scope is memory-bound shows in a low IPC together with a high bandwidth
+    if (HardwareCounters::isOpen()) {
+        HEADING_OUT(3, "Profiler", "Hardware counters per scope name", infoOut);
+        bool isFPOpsAvailable = HardwareCounters::isAvailable(HardwareCounters::FP_OPS);
+        stringstream countersHeader;
+        countersHeader << left << setw(50) << "scope" << right << setw(12) << "Gcycles" << setw(12)
+                << "Ginstr" << setw(8) << "IPC" << setw(14) << "LLC misses[M]" << setw(10)
+                << "GB/s";
+        if (isFPOpsAvailable)
+            countersHeader << setw(10) << "GFLOP" << setw(10) << "B/flop";
+        INFO_OUT() << countersHeader.str() << endl;
+        for (map<string, pair<int, double> >::const_iterator it = totals.begin();
+                it != totals.end(); it++) {
+            const double *counts = &totalCounts[it->first][0];
+            double instructionsPerCycle, bandwidth, bytesPerFlop;
+            HardwareCounters::computeMetrics(counts, it->second.second, instructionsPerCycle,
+                    bandwidth, bytesPerFlop);
+            stringstream line;
+            line << left << setw(50) << it->first << right << fixed << setprecision(3) << setw(12)
+                    << 1e-9 * counts[HardwareCounters::CYCLES] << setw(12)
+                    << 1e-9 * counts[HardwareCounters::INSTRUCTIONS] << setw(8) << setprecision(2)
+                    << instructionsPerCycle << setw(14) << setprecision(3)
+                    << 1e-6 * counts[HardwareCounters::LLC_MISSES] << setw(10) << setprecision(2)
+                    << 1e-9 * bandwidth;
+            if (isFPOpsAvailable)
+                line << setw(10) << setprecision(3) << 1e-9 * counts[HardwareCounters::FP_OPS]
+                        << setw(10) << setprecision(2) << bytesPerFlop;
+            INFO_OUT() << line.str() << endl;
+        }
+    }
+
+    pthread_mutex_lock(&countersMutex);
+    if (!counters.empty()) {
+        HEADING_OUT(3, "Profiler", "Counters", infoOut);
+        for (map<string, double>::const_iterator it = counters.begin(); it != counters.end(); it++) {
+            stringstream line;
+            line << left << setw(60) << it->first << right << setw(22) << fixed << setprecision(3)
+                    << it->second;
+            INFO_OUT() << line.str() << endl;
+        }
+    }
+    if (!values.empty()) {
+        HEADING_OUT(3, "Profiler", "Monitored values", infoOut);
+        for (map<string, double>::const_iterator it = values.begin(); it != values.end(); it++) {
+            stringstream line;
+            line << left << setw(60) << it->first << right << setw(22) << scientific
+                    << setprecision(6) << it->second;
+            INFO_OUT() << line.str() << endl;
+        }
+    }
+    pthread_mutex_unlock(&countersMutex);
+}
+
+void Profiler::reset() {
+    for (int i = 0; i < rootNode.children.size(); i++)
+        delete rootNode.children[i];
+    rootNode.children.clear();
+    currentNode = &rootNode;
+    pthread_mutex_lock(&countersMutex);
+    counters.clear();
+    values.clear();
+    pthread_mutex_unlock(&countersMutex);
+}
+
+} /* namespace EMPIRE */
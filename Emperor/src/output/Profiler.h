@@ -0,0 +1,236 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file Profiler.h
+ * This file holds the class Profiler
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stddef.h>
+#include <string>
+#include "TraceWriter.h"
+
+namespace EMPIRE {
+struct ProfilerNode;
+
+/********//**
+ * \brief Class Profiler collects the wall time of nested scopes in a tree and named counters.
+ *        Timers are recorded on the coupling thread only (the thread which enabled the profiler,
+ *        outside of OpenMP parallel regions nested in the level it enabled it at, e.g. its section
+ *        of main's parallel region), elsewhere they do nothing. Counters can be added
+ *        from any thread, as well as monitored values, which keep the value set last. While the
+ *        profiler is disabled a timer costs one branch.
+ *        If a trace file is set, every timer is also written as an event of the timeline.
+ ***********/
+class Profiler {
+public:
+    /********//**
+     * \brief Class ScopedTimer adds the time of its lifetime to the child with its name of the
+     *        innermost running timer
+     ***********/
+    class ScopedTimer {
+    public:
+        /***********************************************************************************************
+         * \brief Constructor, starts the timer
+         * \param[in] name the name of the timed scope, should be the same object at every call
+         ***********/
+        explicit ScopedTimer(const std::string &name) :
+                node(NULL), startTime(0.0) {
+            if (enabled)
+                start(name);
+        }
+        /***********************************************************************************************
+         * \brief Destructor, stops the timer
+         ***********/
+        ~ScopedTimer() {
+            if (node != NULL)
+                stop();
+        }
+    private:
+        void start(const std::string &name);
+        void stop();
+        /// the node of the tree, NULL if nothing is recorded
+        ProfilerNode *node;
+        /// the start time
+        double startTime;
+        ScopedTimer(const ScopedTimer&);
+        ScopedTimer& operator=(const ScopedTimer&);
+    };
+
+    /********//**
+     * \brief Class StageTimer times consecutive stages of a function, each stage runs from its call
+     *        of next() to the next call, to stop() or to the end of the enclosing scope
+     ***********/
+    class StageTimer {
+    public:
+        StageTimer() :
+                timer(NULL) {
+        }
+        ~StageTimer() {
+            stop();
+        }
+        /***********************************************************************************************
+         * \brief End the current stage and start the next one
+         * \param[in] name the name of the next stage
+         ***********/
+        void next(const std::string &name) {
+            stop();
+            if (enabled)
+                timer = new ScopedTimer(name);
+        }
+        /***********************************************************************************************
+         * \brief End the current stage
+         ***********/
+        void stop() {
+            delete timer;
+            timer = NULL;
+        }
+    private:
+        /// the timer of the current stage
+        ScopedTimer *timer;
+        StageTimer(const StageTimer&);
+        StageTimer& operator=(const StageTimer&);
+    };
+
+    /********//**
+     * \brief Class WorkerTimer writes its lifetime as an event on the track of the calling OpenMP
+     *        thread ("worker <thread number>") to the trace. Placed in a parallel region around a
+     *        work-sharing loop without barrier, the events show the load balance of the loop.
+     *        It does nothing while no trace file is open.
+     ***********/
+    class WorkerTimer {
+    public:
+        /***********************************************************************************************
+         * \brief Constructor, starts the timer
+         * \param[in] _name the name of the event
+         ***********/
+        explicit WorkerTimer(const char *_name) :
+                name(_name), startTime(-1.0) {
+            if (TraceWriter::isOpen())
+                start();
+        }
+        /***********************************************************************************************
+         * \brief Destructor, writes the event
+         ***********/
+        ~WorkerTimer() {
+            if (startTime >= 0.0)
+                stop();
+        }
+    private:
+        void start();
+        void stop();
+        /// the name of the event
+        const char *name;
+        /// the start time, negative if nothing is recorded
+        double startTime;
+        WorkerTimer(const WorkerTimer&);
+        WorkerTimer& operator=(const WorkerTimer&);
+    };
+
+    /***********************************************************************************************
+     * \brief Enable or disable the profiler, the calling thread becomes the coupling thread at
+     *        its current OpenMP nesting level
+     * \param[in] enabled true to enable
+     ***********/
+    static void setEnabled(bool enabled);
+    /***********************************************************************************************
+     * \brief Whether the profiler is enabled
+     ***********/
+    static bool isEnabled() {
+        return enabled;
+    }
+    /***********************************************************************************************
+     * \brief Count the hardware events (cycles, instructions, cache misses, see HardwareCounters)
+     *        of all threads in every timer, the summary adds the derived metrics per scope name
+     * \param[in] enabled true to count the events
+     * \param[in] fpOpsRawEvent the raw event code of the floating point operations of the
+     *            processor, 0 if they are not counted
+     * \param[in] numThreads the number of threads of the parallel regions, they are counted from
+     *            now on
+     ***********/
+    static void setHardwareCounters(bool enabled, unsigned long long fpOpsRawEvent,
+            int numThreads);
+    /***********************************************************************************************
+     * \brief Add to a counter (e.g. the number of bytes sent), thread safe
+     * \param[in] name the name of the counter
+     * \param[in] value the value added
+     ***********/
+    static void addCount(const std::string &name, double value);
+    /***********************************************************************************************
+     * \brief Set a monitored value (e.g. the virtual work balance of a mapper), which replaces the
+     *        value set before, thread safe
+     * \param[in] name the name of the value
+     * \param[in] value the value
+     ***********/
+    static void setValue(const std::string &name, double value);
+    /***********************************************************************************************
+     * \brief Get a monitored value
+     * \param[in] name the name of the value
+     * \return the value last set, 0 if it was never set
+     ***********/
+    static double getValue(const std::string &name);
+    /***********************************************************************************************
+     * \brief Write the time spent in every scope since the last call as one row per scope to a CSV file
+     * \param[in] fileName the name of the CSV file, an empty name disables the output
+     ***********/
+    static void setCSVFile(const std::string &fileName);
+    /***********************************************************************************************
+     * \brief Write the timers as events of the track "Emperor" and the transfers of the clients on
+     *        their tracks to a trace file (see TraceWriter)
+     * \param[in] fileName the name of the trace file, an empty name closes the trace file
+     ***********/
+    static void setTraceFile(const std::string &fileName);
+    /***********************************************************************************************
+     * \brief Write the rows of a time step to the CSV file, if one is set
+     * \param[in] timeStep the number of the time step
+     ***********/
+    static void writeTimeStep(int timeStep);
+    /***********************************************************************************************
+     * \brief Print the tree of timers, the totals per scope name over the whole tree, the counters
+     *        and the monitored values to infoOut
+     ***********/
+    static void printSummary();
+    /***********************************************************************************************
+     * \brief Delete all timers, counters and monitored values
+     ***********/
+    static void reset();
+
+private:
+    /// whether the profiler is enabled
+    static bool enabled;
+};
+
+} /* namespace EMPIRE */
+
+/**************************************************************************************************!
+  Times the rest of the enclosing scope under \a name
+***********/
+#define PROFILER_SCOPE(name) EMPIRE::Profiler::ScopedTimer PROFILER_SCOPE_NAME(__LINE__)(name)
+/**************************************************************************************************!
+  Writes the part of the enclosing parallel region run by the calling thread to the trace
+***********/
+#define PROFILER_WORKER_SCOPE(name) EMPIRE::Profiler::WorkerTimer PROFILER_SCOPE_NAME(__LINE__)(name)
+#define PROFILER_SCOPE_NAME(line) PROFILER_SCOPE_CONCAT(profilerScopedTimer, line)
+#define PROFILER_SCOPE_CONCAT(a, b) a ## b
+
+#endif /* PROFILER_H_ */
@@ -0,0 +1,137 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <omp.h>
+#include <pthread.h>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include "TraceWriter.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+bool TraceWriter::opened = false;
+
+/// the trace file
+static ofstream traceFile;
+/// the wall time of the start of the timeline
+static double originTime = 0.0;
+/// name of a track <=> its id
+static map<string, int> tracks;
+/// whether no event is written yet, the events are separated by commas
+static bool isFirstEvent = true;
+/// serializes the writing to the trace file
+static pthread_mutex_t traceMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/***********************************************************************************************
+ * \brief Start an event in the trace file
+ ***********/
+static void beginEvent() {
+    if (!isFirstEvent)
+        traceFile << ",\n";
+    isFirstEvent = false;
+}
+
+/***********************************************************************************************
+ * \brief Write a string as a JSON string
+ ***********/
+static void writeJSONString(const string &text) {
+    traceFile << '"';
+    for (unsigned i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c == '"' || c == '\\')
+            traceFile << '\\' << c;
+        else if ((unsigned char) c < 0x20)
+            traceFile << ' ';
+        else
+            traceFile << c;
+    }
+    traceFile << '"';
+}
+
+void TraceWriter::open(const std::string &fileName) {
+    pthread_mutex_lock(&traceMutex);
+    if (traceFile.is_open())
+        traceFile.close();
+    tracks.clear();
+    traceFile.open(fileName.c_str());
+    // the closing bracket is optional in the format, so that the trace of an aborted run is valid
+    traceFile << "[\n";
+    isFirstEvent = true;
+    traceFile << fixed << setprecision(3);
+    originTime = omp_get_wtime();
+    opened = traceFile.is_open();
+    pthread_mutex_unlock(&traceMutex);
+}
+
+void TraceWriter::close() {
+    pthread_mutex_lock(&traceMutex);
+    if (opened) {
+        traceFile << "\n]\n";
+        traceFile.close();
+        opened = false;
+    }
+    pthread_mutex_unlock(&traceMutex);
+}
+
+int TraceWriter::getTrack(const std::string &name) {
+    pthread_mutex_lock(&traceMutex);
+    map<string, int>::iterator it = tracks.find(name);
+    int track;
+    if (it != tracks.end()) {
+        track = it->second;
+    } else {
+        track = tracks.size();
+        tracks[name] = track;
+        if (opened) { // name the thread and keep the tracks in the order of their creation
+            beginEvent();
+            traceFile << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << track
+                    << ",\"args\":{\"name\":";
+            writeJSONString(name);
+            traceFile << "}},\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":0,\"tid\":"
+                    << track << ",\"args\":{\"sort_index\":" << track << "}}";
+        }
+    }
+    pthread_mutex_unlock(&traceMutex);
+    return track;
+}
+
+void TraceWriter::addEvent(int track, const std::string &name, const char *category,
+        double startTime, double endTime, long bytes) {
+    if (!opened)
+        return;
+    pthread_mutex_lock(&traceMutex);
+    if (opened) {
+        beginEvent();
+        traceFile << "{\"name\":";
+        writeJSONString(name);
+        traceFile << ",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << track
+                << ",\"ts\":" << (startTime - originTime) * 1e6 << ",\"dur\":"
+                << (endTime - startTime) * 1e6;
+        if (bytes >= 0)
+            traceFile << ",\"args\":{\"bytes\":" << bytes << "}";
+        traceFile << "}";
+    }
+    pthread_mutex_unlock(&traceMutex);
+}
+
+} /* namespace EMPIRE */
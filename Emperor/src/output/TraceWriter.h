@@ -0,0 +1,81 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file TraceWriter.h
+ * This file holds the class TraceWriter
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef TRACEWRITER_H_
+#define TRACEWRITER_H_
+
+#include <string>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class TraceWriter writes a timeline in the Chrome trace event format (JSON array), which
+ *        can be opened by chrome://tracing or ui.perfetto.dev. Every participant of the coupling
+ *        is a track (a thread in the trace), an event is a named interval on a track. All
+ *        functions are thread safe, times are wall times of omp_get_wtime().
+ ***********/
+class TraceWriter {
+public:
+    /***********************************************************************************************
+     * \brief Open the trace file, the start of the timeline is now
+     * \param[in] fileName the name of the trace file
+     ***********/
+    static void open(const std::string &fileName);
+    /***********************************************************************************************
+     * \brief Close the trace file
+     ***********/
+    static void close();
+    /***********************************************************************************************
+     * \brief Whether a trace file is open
+     ***********/
+    static bool isOpen() {
+        return opened;
+    }
+    /***********************************************************************************************
+     * \brief Get the track with a name, it is created at the first call
+     * \param[in] name the name of the track
+     * \return the id of the track
+     ***********/
+    static int getTrack(const std::string &name);
+    /***********************************************************************************************
+     * \brief Add an interval to a track
+     * \param[in] track the id of the track
+     * \param[in] name the name of the event
+     * \param[in] category the category of the event (e.g. "wait", "transfer", "compute")
+     * \param[in] startTime the start time of the event
+     * \param[in] endTime the end time of the event
+     * \param[in] bytes the number of bytes moved in the event, negative if none
+     ***********/
+    static void addEvent(int track, const std::string &name, const char *category,
+            double startTime, double endTime, long bytes = -1);
+
+private:
+    /// whether a trace file is open
+    static bool opened;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* TRACEWRITER_H_ */
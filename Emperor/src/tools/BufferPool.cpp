@@ -0,0 +1,219 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "BufferPool.h"
+#include <stdlib.h>
+#include <assert.h>
+#include <pthread.h>
+#include <vector>
+
+using namespace std;
+
+namespace EMPIRE {
+
+/// Alignment of the buffers and size of the header in front of them, a cache line
+static const size_t POOL_ALIGNMENT = 64;
+/// Number of entries of the smallest size class
+static const size_t POOL_MIN_CAPACITY = 512;
+/// Number of size classes, the largest one holds POOL_MIN_CAPACITY << (POOL_NUM_CLASSES - 1) entries
+static const int POOL_NUM_CLASSES = 40;
+
+/********//**
+ * \brief The header in front of every buffer
+ ***********/
+struct BufferHeader {
+    /// the size class of the buffer
+    int sizeClass;
+    /// the number of references
+    int numReferences;
+};
+
+/********//**
+ * \brief The state of the pool, the free buffers are freed at the end of the program
+ ***********/
+struct BufferPoolState {
+    BufferPoolState() :
+            maxPooledBytes((size_t) 1024 * 1024 * 1024), pooledBytes(0), numAllocations(0) {
+        pthread_mutex_init(&mutex, NULL);
+    }
+    ~BufferPoolState() {
+        for (int k = 0; k < POOL_NUM_CLASSES; k++)
+            for (int i = 0; i < freeBuffers[k].size(); i++)
+                free(freeBuffers[k][i]);
+        pthread_mutex_destroy(&mutex);
+    }
+    /// the free buffers of every size class, with their headers
+    vector<BufferHeader*> freeBuffers[POOL_NUM_CLASSES];
+    /// the maximum number of bytes of the free buffers
+    size_t maxPooledBytes;
+    /// the number of bytes of the free buffers
+    size_t pooledBytes;
+    /// the number of buffers allocated from the system
+    size_t numAllocations;
+    /// guards the state
+    pthread_mutex_t mutex;
+};
+
+static BufferPoolState poolState;
+
+/***********************************************************************************************
+ * \brief Get the number of bytes of a buffer of a size class with its header
+ ***********/
+static size_t getClassBytes(int sizeClass) {
+    return POOL_ALIGNMENT + (POOL_MIN_CAPACITY << sizeClass) * sizeof(double);
+}
+
+static BufferHeader *getHeader(double *buffer) {
+    return reinterpret_cast<BufferHeader*>(reinterpret_cast<char*>(buffer) - POOL_ALIGNMENT);
+}
+
+double *BufferPool::acquire(size_t size) {
+    int sizeClass = 0;
+    while ((POOL_MIN_CAPACITY << sizeClass) < size)
+        sizeClass++;
+    assert(sizeClass < POOL_NUM_CLASSES);
+    BufferHeader *header = NULL;
+    pthread_mutex_lock(&poolState.mutex);
+    vector<BufferHeader*> &freeBuffers = poolState.freeBuffers[sizeClass];
+    if (!freeBuffers.empty()) {
+        // the latest released one, most likely still in the cache
+        header = freeBuffers.back();
+        freeBuffers.pop_back();
+        poolState.pooledBytes -= getClassBytes(sizeClass);
+    } else {
+        poolState.numAllocations++;
+    }
+    pthread_mutex_unlock(&poolState.mutex);
+    if (header == NULL) {
+        void *memory = NULL;
+        if (posix_memalign(&memory, POOL_ALIGNMENT, getClassBytes(sizeClass)) != 0)
+            memory = NULL;
+        assert(memory != NULL);
+        header = static_cast<BufferHeader*>(memory);
+        header->sizeClass = sizeClass;
+    }
+    header->numReferences = 1;
+    return reinterpret_cast<double*>(reinterpret_cast<char*>(header) + POOL_ALIGNMENT);
+}
+
+void BufferPool::addReference(double *buffer) {
+    BufferHeader *header = getHeader(buffer);
+    pthread_mutex_lock(&poolState.mutex);
+    assert(header->numReferences > 0);
+    header->numReferences++;
+    pthread_mutex_unlock(&poolState.mutex);
+}
+
+void BufferPool::release(double *buffer) {
+    BufferHeader *header = getHeader(buffer);
+    bool isFreed = false;
+    pthread_mutex_lock(&poolState.mutex);
+    assert(header->numReferences > 0);
+    header->numReferences--;
+    if (header->numReferences == 0) {
+        size_t bytes = getClassBytes(header->sizeClass);
+        if (poolState.pooledBytes + bytes <= poolState.maxPooledBytes) {
+            poolState.freeBuffers[header->sizeClass].push_back(header);
+            poolState.pooledBytes += bytes;
+        } else {
+            isFreed = true;
+        }
+    }
+    pthread_mutex_unlock(&poolState.mutex);
+    if (isFreed)
+        free(header);
+}
+
+void BufferPool::setMaxPooledBytes(size_t maxBytes) {
+    pthread_mutex_lock(&poolState.mutex);
+    poolState.maxPooledBytes = maxBytes;
+    // free the largest buffers first until the free buffers fit
+    for (int k = POOL_NUM_CLASSES - 1; k >= 0 && poolState.pooledBytes > maxBytes; k--) {
+        vector<BufferHeader*> &freeBuffers = poolState.freeBuffers[k];
+        while (!freeBuffers.empty() && poolState.pooledBytes > maxBytes) {
+            free(freeBuffers.back());
+            freeBuffers.pop_back();
+            poolState.pooledBytes -= getClassBytes(k);
+        }
+    }
+    pthread_mutex_unlock(&poolState.mutex);
+}
+
+size_t BufferPool::getMaxPooledBytes() {
+    pthread_mutex_lock(&poolState.mutex);
+    size_t maxBytes = poolState.maxPooledBytes;
+    pthread_mutex_unlock(&poolState.mutex);
+    return maxBytes;
+}
+
+size_t BufferPool::getPooledBytes() {
+    pthread_mutex_lock(&poolState.mutex);
+    size_t bytes = poolState.pooledBytes;
+    pthread_mutex_unlock(&poolState.mutex);
+    return bytes;
+}
+
+size_t BufferPool::getNumAllocations() {
+    pthread_mutex_lock(&poolState.mutex);
+    size_t numAllocations = poolState.numAllocations;
+    pthread_mutex_unlock(&poolState.mutex);
+    return numAllocations;
+}
+
+void BufferPool::clear() {
+    pthread_mutex_lock(&poolState.mutex);
+    for (int k = 0; k < POOL_NUM_CLASSES; k++) {
+        for (int i = 0; i < poolState.freeBuffers[k].size(); i++)
+            free(poolState.freeBuffers[k][i]);
+        poolState.freeBuffers[k].clear();
+    }
+    poolState.pooledBytes = 0;
+    pthread_mutex_unlock(&poolState.mutex);
+}
+
+BufferPool::Buffer::Buffer(const Buffer &buffer) :
+        array(buffer.array), numEntries(buffer.numEntries) {
+    if (array != NULL)
+        addReference(array);
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(const Buffer &buffer) {
+    if (buffer.array != NULL)
+        addReference(buffer.array);
+    clear();
+    array = buffer.array;
+    numEntries = buffer.numEntries;
+    return *this;
+}
+
+void BufferPool::Buffer::allocate(size_t size) {
+    clear();
+    array = acquire(size);
+    numEntries = size;
+}
+
+void BufferPool::Buffer::clear() {
+    if (array != NULL)
+        release(array);
+    array = NULL;
+    numEntries = 0;
+}
+
+} /* namespace EMPIRE */
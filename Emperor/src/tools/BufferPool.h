@@ -0,0 +1,140 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file BufferPool.h
+ * This file holds the class BufferPool
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef BUFFERPOOL_H_
+#define BUFFERPOOL_H_
+
+#include <stddef.h>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class BufferPool recycles the temporary double buffers of the coupling (the components of
+ *        the mapped fields, the work vectors of the coupling algorithms, the snapshots of the
+ *        outputs), such that a large temporary of every iteration is not given back to the system
+ *        and page faulted in again. The buffers are sorted in size classes of powers of two and
+ *        aligned to cache lines. A buffer is reference counted, it goes back to the pool when the
+ *        last reference is released. The pool keeps at most getMaxPooledBytes() bytes of free
+ *        buffers, larger ones are freed. All functions are thread safe.
+ ***********/
+class BufferPool {
+public:
+    /********//**
+     * \brief Class Buffer is a handle of a buffer of the pool, copies of it share the buffer
+     ***********/
+    class Buffer {
+    public:
+        Buffer() :
+                array(NULL), numEntries(0) {
+        }
+        /***********************************************************************************************
+         * \brief Constructor, get a buffer from the pool, the entries are not initialized
+         * \param[in] size the number of entries
+         ***********/
+        explicit Buffer(size_t size) :
+                array(NULL), numEntries(0) {
+            allocate(size);
+        }
+        Buffer(const Buffer &buffer);
+        Buffer& operator=(const Buffer &buffer);
+        ~Buffer() {
+            clear();
+        }
+        /***********************************************************************************************
+         * \brief Get a buffer from the pool instead of the current one, the entries are not
+         *        initialized
+         * \param[in] size the number of entries
+         ***********/
+        void allocate(size_t size);
+        /***********************************************************************************************
+         * \brief Release the buffer
+         ***********/
+        void clear();
+        double *data() {
+            return array;
+        }
+        const double *data() const {
+            return array;
+        }
+        double &operator[](size_t i) {
+            return array[i];
+        }
+        const double &operator[](size_t i) const {
+            return array[i];
+        }
+        size_t size() const {
+            return numEntries;
+        }
+        bool empty() const {
+            return numEntries == 0;
+        }
+    private:
+        /// the buffer, NULL if none
+        double *array;
+        /// the number of entries
+        size_t numEntries;
+    };
+
+    /***********************************************************************************************
+     * \brief Get a buffer from the pool, or a new one if there is no free buffer of its size class
+     * \param[in] size the number of entries, the buffer may be larger
+     * \return the buffer with one reference, aligned to a cache line
+     ***********/
+    static double *acquire(size_t size);
+    /***********************************************************************************************
+     * \brief Add a reference to a buffer
+     * \param[in] buffer the buffer got by acquire
+     ***********/
+    static void addReference(double *buffer);
+    /***********************************************************************************************
+     * \brief Release a reference to a buffer, the last one gives it back to the pool
+     * \param[in] buffer the buffer got by acquire
+     ***********/
+    static void release(double *buffer);
+    /***********************************************************************************************
+     * \brief Set the maximum number of bytes of the free buffers kept, free buffers beyond it are
+     *        freed at once
+     * \param[in] maxBytes the number of bytes
+     ***********/
+    static void setMaxPooledBytes(size_t maxBytes);
+    /***********************************************************************************************
+     * \brief Get the maximum number of bytes of the free buffers kept
+     ***********/
+    static size_t getMaxPooledBytes();
+    /***********************************************************************************************
+     * \brief Get the number of bytes of the free buffers in the pool
+     ***********/
+    static size_t getPooledBytes();
+    /***********************************************************************************************
+     * \brief Get the number of buffers allocated from the system so far
+     ***********/
+    static size_t getNumAllocations();
+    /***********************************************************************************************
+     * \brief Free all free buffers of the pool
+     ***********/
+    static void clear();
+};
+
+} /* namespace EMPIRE */
+#endif /* BUFFERPOOL_H_ */
@@ -20,8 +20,11 @@
  */
 
 #include "ClipperAdapter.h"
+#include "MonotonicArena.h"
 #include "Message.h"
 #include "assert.h"
+#include <math.h>
+#include <algorithm>
 
 using namespace ClipperLib;
 using namespace std;
@@ -33,7 +36,8 @@ ClipperAdapter::ClipperAdapter():
 	factor(1e9),
 	operation(ctIntersection),
 	fillingClipWindow(pftNonZero),
-	fillingSubject(pftNonZero) {
+	fillingSubject(pftNonZero),
+	clipWindowType(CLIPWINDOW_UNKNOWN) {
 }
 
 ClipperAdapter::ClipperAdapter(double _accuracy):
@@ -41,26 +45,30 @@ ClipperAdapter::ClipperAdapter(double _accuracy):
 		factor(1/_accuracy),
 		operation(ctIntersection),
 		fillingClipWindow(pftNonZero),
-		fillingSubject(pftNonZero) {
+		fillingSubject(pftNonZero),
+	clipWindowType(CLIPWINDOW_UNKNOWN) {
 }
 
 ClipperAdapter::ClipperAdapter(double _accuracy, Operation _operation):
 	accuracy(_accuracy),
 	factor(1.0/_accuracy),
 	fillingClipWindow(pftNonZero),
-	fillingSubject(pftNonZero) {
+	fillingSubject(pftNonZero),
+	clipWindowType(CLIPWINDOW_UNKNOWN) {
 	setOperation(_operation);
 }
 ClipperAdapter::ClipperAdapter(double _accuracy, Operation _operation, Filling _filling):
 	accuracy(_accuracy),
-	factor(1.0/_accuracy) {
+	factor(1.0/_accuracy),
+	clipWindowType(CLIPWINDOW_UNKNOWN) {
 	setOperation(_operation);
 	setFilling(_filling);
 }
 
 ClipperAdapter::ClipperAdapter(double _accuracy, Operation _operation, Filling _fillingClipWindow, Filling _fillingSubject):
 	accuracy(_accuracy),
-	factor(1.0/_accuracy) {
+	factor(1.0/_accuracy),
+	clipWindowType(CLIPWINDOW_UNKNOWN) {
 	setOperation(_operation);
 	setFilling(_fillingClipWindow, 0);
 	setFilling(_fillingSubject, 1);
@@ -72,6 +80,7 @@ ClipperAdapter::ClipperAdapter(double _accuracy, Operation _operation, Filling _
 void ClipperAdapter::setAccuracy(double _accuracy) {
 		accuracy=_accuracy;
 		factor=1.0/accuracy;
+		clipWindowType=CLIPWINDOW_UNKNOWN;
 }
 
 void ClipperAdapter::setFilling(Filling _filling, int _subject) {
@@ -82,6 +91,7 @@ void ClipperAdapter::setFilling(Filling _filling, int _subject) {
 	case POSITIVE : filling=pftPositive; break;
 	case NEGATIVE : filling=pftNegative; break;
 	}
+	clipWindowType=CLIPWINDOW_UNKNOWN;
 	switch(_subject) {
 	case 0 : fillingClipWindow=filling;break;
 	case 1 : fillingSubject=filling;break;
@@ -90,6 +100,7 @@ void ClipperAdapter::setFilling(Filling _filling, int _subject) {
 }
 
 void ClipperAdapter::setOperation(Operation _operation) {
+	clipWindowType=CLIPWINDOW_UNKNOWN;
 	switch(_operation) {
 	case INTERSECTION : operation=ctIntersection; break;
 	case UNION : operation=ctUnion; break;
@@ -126,6 +137,7 @@ void ClipperAdapter::addPathClipper(const std::vector<double>& _path) {
 		clip<<IntPoint((cInt)(_path[2*p]*factor),(cInt)(_path[2*p+1]*factor));
 	}
 	clipWindow.push_back(clip);
+	clipWindowType=CLIPWINDOW_UNKNOWN;
 }
 
 void ClipperAdapter::addPathClipper(const std::vector<std::pair<double,double> >& _path) {
@@ -134,6 +146,22 @@ void ClipperAdapter::addPathClipper(const std::vector<std::pair<double,double> >
 		clip<<IntPoint((cInt)(_path[p].first*factor),(cInt)(_path[p].second*factor));
 	}
 	clipWindow.push_back(clip);
+	clipWindowType=CLIPWINDOW_UNKNOWN;
+}
+
+void ClipperAdapter::setPathClipper(const std::vector<std::pair<double,double> >& _path) {
+	clipWindow.resize(1);
+	Path& clip = clipWindow[0];
+	clip.resize(_path.size());
+	for(int p=0; p < _path.size(); p++) {
+		clip[p] = IntPoint((cInt)(_path[p].first*factor),(cInt)(_path[p].second*factor));
+	}
+	clipWindowType=CLIPWINDOW_UNKNOWN;
+}
+
+void ClipperAdapter::clearPathsClipper() {
+	clipWindow.clear();
+	clipWindowType=CLIPWINDOW_UNKNOWN;
 }
 
 void ClipperAdapter::addPathSubject(const std::vector<double>& _path) {
@@ -153,11 +181,89 @@ void ClipperAdapter::addPathSubject(const std::vector<std::pair<double,double> >
 }
 
 void ClipperAdapter::clip() {
+	clipper.Clear();
 	assert(clipper.AddPaths(subject, ptSubject, true)==true);
 	assert(clipper.AddPaths(clipWindow, ptClip, true)==true);
 	assert(clipper.Execute(operation, solution, fillingSubject, fillingClipWindow)==true);
 }
 
+/// Whether a polygon of the given orientation is filled by the given filling rule
+static bool isFilled(PolyFillType _filling, bool _isCounterclockwise) {
+	if(_filling == pftPositive)
+		return _isCounterclockwise;
+	if(_filling == pftNegative)
+		return !_isCounterclockwise;
+	return true;
+}
+
+/// Signed area of a polygon, positive if counterclockwise
+static double computeSignedArea(const std::vector<std::pair<double,double> >& _path) {
+	double area = 0.0;
+	for(int p=0, q=_path.size()-1; p < _path.size(); q=p++)
+		area += _path[q].first*_path[p].second - _path[p].first*_path[q].second;
+	return 0.5*area;
+}
+
+void ClipperAdapter::classifyClipWindow() {
+	clipWindowType = CLIPWINDOW_GENERAL;
+	if(operation != ctIntersection || clipWindow.size() != 1)
+		return;
+	// Work on the rounded clipping window, as the clipper does
+	convexClipWindow.resize(clipWindow[0].size());
+	for(int p=0; p < clipWindow[0].size(); p++) {
+		convexClipWindow[p].first  = clipWindow[0][p].X / factor;
+		convexClipWindow[p].second = clipWindow[0][p].Y / factor;
+	}
+	if(!isConvex(convexClipWindow))
+		return;
+	bool isCounterclockwise = computeSignedArea(convexClipWindow) > 0.0;
+	if(!isFilled(fillingClipWindow, isCounterclockwise)) {
+		clipWindowType = CLIPWINDOW_EMPTY;
+		return;
+	}
+	if(!isCounterclockwise)
+		std::reverse(convexClipWindow.begin(), convexClipWindow.end());
+	clipWindowType = CLIPWINDOW_CONVEX;
+}
+
+void ClipperAdapter::clip(const std::vector<std::pair<double,double> >& _subject, std::vector<std::vector<std::pair<double,double> > >& _container) {
+	subject.resize(1);
+	Path& subj = subject[0];
+	subj.resize(_subject.size());
+	for(int p=0; p < _subject.size(); p++) {
+		subj[p] = IntPoint((cInt)(_subject[p].first*factor),(cInt)(_subject[p].second*factor));
+	}
+	if(clipWindowType == CLIPWINDOW_UNKNOWN)
+		classifyClipWindow();
+	if(clipWindowType == CLIPWINDOW_EMPTY) {
+		_container.clear();
+		return;
+	}
+	if(clipWindowType == CLIPWINDOW_CONVEX) {
+		convexSubject.resize(subj.size());
+		for(int p=0; p < subj.size(); p++) {
+			convexSubject[p].first  = subj[p].X / factor;
+			convexSubject[p].second = subj[p].Y / factor;
+		}
+		if(isConvex(convexSubject)) {
+			bool isCounterclockwise = computeSignedArea(convexSubject) > 0.0;
+			_container.resize(1);
+			if(isFilled(fillingSubject, isCounterclockwise))
+				clipConvex(convexSubject, convexClipWindow, _container[0], accuracy);
+			else
+				_container[0].clear();
+			// The outer polygons of the clipper solution are counterclockwise
+			if(_container[0].empty())
+				_container.clear();
+			else if(!isCounterclockwise)
+				std::reverse(_container[0].begin(), _container[0].end());
+			return;
+		}
+	}
+	clip();
+	getSolution(_container);
+}
+
 void ClipperAdapter::clip(int _numNodesPolygonToClip, double* _nodesPolygonToClip, int _numNodesClipper,double* _nodesClipper, int& _numNodesOutputPolygon, double*& _nodesOutputPolygon) {
 	Path subj,clip;
 	Paths solution;
@@ -350,6 +456,104 @@ void ClipperAdapter::reversePolygon(std::vector<std::pair<double,double> >& _pat
 	}
 }
 
+bool ClipperAdapter::isConvex(const std::vector<std::pair<double,double> >& _path) {
+	const int n = _path.size();
+	if(n < 3)
+		return false;
+	// All turns are of the same direction and the polygon winds only once around, that is the
+	// direction of the edges along x changes at most twice
+	int turnSign = 0;
+	int numXFlips = 0;
+	int xSign = 0;
+	int firstXSign = 0;
+	for(int p=0; p < n; p++) {
+		const std::pair<double,double>& p0 = _path[p];
+		const std::pair<double,double>& p1 = _path[(p+1)%n];
+		const std::pair<double,double>& p2 = _path[(p+2)%n];
+		double cross = (p1.first-p0.first)*(p2.second-p1.second) - (p1.second-p0.second)*(p2.first-p1.first);
+		if(cross != 0.0) {
+			int sign = cross > 0.0 ? 1 : -1;
+			if(turnSign == 0)
+				turnSign = sign;
+			else if(sign != turnSign)
+				return false;
+		}
+		double dx = p1.first - p0.first;
+		if(dx != 0.0) {
+			int sign = dx > 0.0 ? 1 : -1;
+			if(xSign == 0)
+				firstXSign = sign;
+			else if(sign != xSign)
+				numXFlips++;
+			xSign = sign;
+		}
+	}
+	// Flip between the last and the first edge along x
+	if(xSign != firstXSign)
+		numXFlips++;
+	return turnSign != 0 && numXFlips <= 2;
+}
+
+void ClipperAdapter::clipConvex(const std::vector<std::pair<double,double> >& _subject, const std::vector<std::pair<double,double> >& _clipWindow, std::vector<std::pair<double,double> >& _output, double _accuracy) {
+	typedef std::pair<double,double> Point2D;
+	typedef std::vector<Point2D, ArenaAllocator<Point2D> > ArenaPolygon2D;
+	const int numEdges = _clipWindow.size();
+	{
+		// The intermediate polygons live in the arena of the thread, a clipped polygon has at most
+		// one vertex more than its input per clipping edge
+		MonotonicArena& arena = MonotonicArena::getThreadArena();
+		MonotonicArena::Scope arenaScope(arena);
+		ArenaPolygon2D input((ArenaAllocator<Point2D>(arena)));
+		ArenaPolygon2D output((ArenaAllocator<Point2D>(arena)));
+		input.reserve(_subject.size() + numEdges);
+		output.reserve(_subject.size() + numEdges);
+		output.assign(_subject.begin(), _subject.end());
+		for(int e=0; e < numEdges && !output.empty(); e++) {
+			const Point2D& a = _clipWindow[e];
+			const Point2D& b = _clipWindow[(e+1)%numEdges];
+			const double nx = -(b.second - a.second);
+			const double ny = b.first - a.first;
+			input.swap(output);
+			output.clear();
+			// Keep the part on the left side of the edge a-b, that is the inner side of the window
+			for(int p=0, q=input.size()-1; p < input.size(); q=p++) {
+				const double dq = nx*(input[q].first-a.first) + ny*(input[q].second-a.second);
+				const double dp = nx*(input[p].first-a.first) + ny*(input[p].second-a.second);
+				if((dq >= 0.0) != (dp >= 0.0)) {
+					const double t = dq / (dq - dp);
+					output.push_back(std::make_pair(input[q].first + t*(input[p].first-input[q].first),
+							input[q].second + t*(input[p].second-input[q].second)));
+				}
+				if(dp >= 0.0)
+					output.push_back(input[p]);
+			}
+		}
+		_output.assign(output.begin(), output.end());
+	}
+	// Remove the repeated and collinear vertices generated by the vertices lying on the window
+	bool isRemoved = true;
+	while(isRemoved && _output.size() >= 3) {
+		isRemoved = false;
+		for(int p=0; p < _output.size() && _output.size() >= 3; p++) {
+			const int n = _output.size();
+			const std::pair<double,double>& p0 = _output[(p+n-1)%n];
+			const std::pair<double,double>& p1 = _output[p];
+			const std::pair<double,double>& p2 = _output[(p+1)%n];
+			const double dx = p2.first - p0.first;
+			const double dy = p2.second - p0.second;
+			const double cross = (p1.first-p0.first)*dy - (p1.second-p0.second)*dx;
+			const double dist = fabs(p1.first-p0.first) + fabs(p1.second-p0.second);
+			if(dist < _accuracy || fabs(cross) <= _accuracy*sqrt(dx*dx + dy*dy)) {
+				_output.erase(_output.begin()+p);
+				isRemoved = true;
+				p--;
+			}
+		}
+	}
+	if(_output.size() < 3 || fabs(computeSignedArea(_output)) <= _accuracy*_accuracy)
+		_output.clear();
+}
+
 void ClipperAdapter::simplifyPolygon(std::vector<std::vector<std::pair<double,double> > >& _paths, double _accuracy) {
 	double factor = 1 / _accuracy;
 	Paths subjs;
@@ -103,11 +103,31 @@ public:
      ***********/
 	void addPathSubject(const std::vector<double>& _path);
 	void addPathSubject(const std::vector<std::pair<double,double> >& _path);
+    /***********************************************************************************************
+     * \brief Replace the whole clipping window by a single polygon. The storage of the inner integer
+     *        path is kept, such that a clipping window can be changed without allocation
+     * \param[in] _path	The polygon forming the new clipping window
+     ***********/
+	void setPathClipper(const std::vector<std::pair<double,double> >& _path);
+    /***********************************************************************************************
+     * \brief Remove all the polygons of the clipping window
+     ***********/
+	void clearPathsClipper();
     /***********************************************************************************************
      * \brief Execute the clipping with the clipping window member on the subject member. Results stored in solution
      * \author Fabien Pean
      ***********/
 	void clip();
+    /***********************************************************************************************
+     * \brief Clip a single subject by the clipping window member, which is kept for further subjects.
+     *        The clipping window is converted to integer paths only once, and if both the clipping
+     *        window and the subject are convex polygons the intersection is computed by
+     *        clipConvex without calling the clipper library
+     * \param[in] _subject	The polygon to be clipped, replacing the subject member
+     * \param[out] _container	The clipped polygons
+     ***********/
+	void clip(const std::vector<std::pair<double,double> >& _subject,
+			  std::vector<std::vector<std::pair<double,double> > >& _container);
     /***********************************************************************************************
      * \brief Execute a standard intersection clipping by providing everything at once : subject/clipping window/solution
      * \author Fabien Pean
@@ -161,8 +181,33 @@ public:
      ***********/
 	static void simplifyPolygon(std::vector<std::vector<std::pair<double,double> > >& _paths, double _accuracy=1e-9);
 
+    /***********************************************************************************************
+     * \brief Check if a polygon is convex, collinear consecutive vertices are allowed
+     * \param[in] _path	The polygon
+     * \return true if the polygon has at least 3 vertices and all its turns are of the same direction
+     ***********/
+	static bool isConvex(const std::vector<std::pair<double,double> >& _path);
+    /***********************************************************************************************
+     * \brief Intersection of a convex polygon with a convex counterclockwise clipping window by
+     *        the Sutherland-Hodgman algorithm
+     * \param[in] _subject	The convex polygon to be clipped
+     * \param[in] _clipWindow	The convex counterclockwise clipping window
+     * \param[out] _output	The intersection, with the orientation of _subject, without repeated
+     *        or collinear vertices. It is empty if the intersection has no area
+     * \param[in] _accuracy	Vertices closer than _accuracy are merged
+     ***********/
+	static void clipConvex(const std::vector<std::pair<double,double> >& _subject,
+			const std::vector<std::pair<double,double> >& _clipWindow,
+			std::vector<std::pair<double,double> >& _output, double _accuracy=1e-9);
+
 	inline double getAccuracy() { return accuracy; }
 private:
+    /***********************************************************************************************
+     * \brief Find out if the clipping window is a single convex polygon, and store it as such
+     ***********/
+	void classifyClipWindow();
+	/// State of the clipping window for the convex clipping
+	typedef enum ClipWindowType{CLIPWINDOW_UNKNOWN=0, CLIPWINDOW_GENERAL, CLIPWINDOW_CONVEX, CLIPWINDOW_EMPTY} ClipWindowType;
 	/// Adaptee
 	ClipperLib::Clipper clipper;
 	/// Inner clipper polygons
@@ -175,6 +220,11 @@ private:
 	ClipperLib::ClipType operation;
 	ClipperLib::PolyFillType fillingSubject;
 	ClipperLib::PolyFillType fillingClipWindow;
+	/// The clipping window as convex counterclockwise polygon, if clipWindowType is CLIPWINDOW_CONVEX
+	ClipWindowType clipWindowType;
+	std::vector<std::pair<double,double> > convexClipWindow;
+	/// Work storage of the convex clipping
+	std::vector<std::pair<double,double> > convexSubject;
 
 };
 
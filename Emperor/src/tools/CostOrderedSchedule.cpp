@@ -0,0 +1,48 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <algorithm>
+#include "CostOrderedSchedule.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+namespace {
+/// compares item indices by descending cost
+struct DescendingCost {
+    const std::vector<double> *costs;
+    DescendingCost(const std::vector<double> &_costs) :
+            costs(&_costs) {
+    }
+    bool operator()(int a, int b) const {
+        return (*costs)[a] > (*costs)[b];
+    }
+};
+}
+
+void CostOrderedSchedule::computeOrder(const std::vector<double> &costs, std::vector<int> &order) {
+    order.resize(costs.size());
+    for (int i = 0; i < order.size(); i++)
+        order[i] = i;
+    stable_sort(order.begin(), order.end(), DescendingCost(costs));
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,52 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file CostOrderedSchedule.h
+ * This file holds the class CostOrderedSchedule
+ * \date 10/15/2026
+ **************************************************************************************************/
+
+#ifndef COSTORDEREDSCHEDULE_H_
+#define COSTORDEREDSCHEDULE_H_
+
+#include <vector>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class CostOrderedSchedule orders the items of a parallel loop by descending estimated
+ *        cost (longest processing time first). A loop over the order with schedule(dynamic, 1)
+ *        starts the expensive items first, such that the cheap items fill the idle threads at the
+ *        end instead of one thread finishing a cluster of expensive items alone.
+ ***********/
+class CostOrderedSchedule {
+public:
+    /***********************************************************************************************
+     * \brief Compute the order of items by descending cost, items of equal cost keep their order
+     * \param[in] costs the estimated cost of each item
+     * \param[out] order order[k] is the index of the k-th item to process
+     ***********/
+    static void computeOrder(const std::vector<double> &costs, std::vector<int> &order);
+};
+
+} /* namespace EMPIRE */
+
+#endif /* COSTORDEREDSCHEDULE_H_ */
@@ -0,0 +1,75 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "IDToIndexMap.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+IDToIndexMap::IDToIndexMap(int _numIDs, const int *IDs) :
+        numIDs(_numIDs), isDense(true), minID(0), mask(0) {
+    if (numIDs == 0)
+        return;
+    minID = IDs[0];
+    int maxID = IDs[0];
+    for (int i = 1; i < numIDs; i++) {
+        if (IDs[i] < minID)
+            minID = IDs[i];
+        if (IDs[i] > maxID)
+            maxID = IDs[i];
+    }
+    long range = (long) maxID - minID + 1;
+    isDense = (range <= (long) DENSE_FACTOR * numIDs);
+
+    if (isDense) {
+        positions.assign(range, -1);
+        for (int i = 0; i < numIDs; i++)
+            if (positions[IDs[i] - minID] == -1)
+                positions[IDs[i] - minID] = i;
+        return;
+    }
+
+    // at most half of the slots are used, so that the probe sequences stay short
+    unsigned numSlots = 1;
+    while (numSlots < 2 * (unsigned) numIDs)
+        numSlots *= 2;
+    mask = numSlots - 1;
+    positions.assign(numSlots, -1);
+    slotIDs.assign(numSlots, 0);
+    for (int i = 0; i < numIDs; i++) {
+        unsigned slot = hash(IDs[i]) & mask;
+        while (positions[slot] != -1 && slotIDs[slot] != IDs[i])
+            slot = (slot + 1) & mask;
+        if (positions[slot] == -1) {
+            positions[slot] = i;
+            slotIDs[slot] = IDs[i];
+        }
+    }
+}
+
+MemoryUsage IDToIndexMap::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add(isDense ? "dense table" : "hash table",
+            MemoryUsage::ofVector(positions) + MemoryUsage::ofVector(slotIDs));
+    return usage;
+}
+
+} /* namespace EMPIRE */
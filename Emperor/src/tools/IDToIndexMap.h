@@ -0,0 +1,128 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file IDToIndexMap.h
+ * This file holds the class IDToIndexMap
+ * \date 10/15/2026
+ **************************************************************************************************/
+
+#ifndef IDTOINDEXMAP_H_
+#define IDTOINDEXMAP_H_
+
+#include <assert.h>
+#include <vector>
+#include "MemoryUsage.h"
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class IDToIndexMap maps the IDs of nodes or elements sent by a client to their positions in
+ *        the arrays. If the IDs are compact (their range is at most DENSE_FACTOR times their number),
+ *        the position is looked up in a table over the range. Otherwise an open addressing hash
+ *        table with linear probing is used. If an ID occurs several times, its first position is kept.
+ ***********/
+class IDToIndexMap {
+public:
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _numIDs number of IDs
+     * \param[in] IDs the IDs, the position of IDs[i] is i
+     ***********/
+    IDToIndexMap(int _numIDs, const int *IDs);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~IDToIndexMap() {
+    }
+    /***********************************************************************************************
+     * \brief Get the position of an ID
+     * \param[in] ID the ID
+     * \return the position, -1 if the ID is not in the map
+     ***********/
+    int find(int ID) const {
+        if (isDense) {
+            long offset = (long) ID - minID;
+            if (offset < 0 || offset >= (long) positions.size())
+                return -1;
+            return positions[offset];
+        }
+        for (unsigned slot = hash(ID) & mask;; slot = (slot + 1) & mask) {
+            if (positions[slot] == -1)
+                return -1;
+            if (slotIDs[slot] == ID)
+                return positions[slot];
+        }
+    }
+    /***********************************************************************************************
+     * \brief Get the position of an ID which is in the map
+     * \param[in] ID the ID
+     * \return the position
+     ***********/
+    int at(int ID) const {
+        int position = find(ID);
+        assert(position != -1);
+        return position;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of IDs
+     ***********/
+    int size() const {
+        return numIDs;
+    }
+    /***********************************************************************************************
+     * \brief Whether the positions are looked up in a table over the range of the IDs
+     ***********/
+    bool isDenseTable() const {
+        return isDense;
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory of the tables
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+    /// the range of the IDs over their number up to which the table over the range is used
+    static const int DENSE_FACTOR = 4;
+
+private:
+    /***********************************************************************************************
+     * \brief Mix the bits of an ID (multiplicative hashing)
+     ***********/
+    static unsigned hash(int ID) {
+        unsigned h = (unsigned) ID * 2654435761u;
+        return h ^ (h >> 16);
+    }
+    /// number of IDs
+    int numIDs;
+    /// whether the table over the range is used
+    bool isDense;
+    /// the smallest ID
+    int minID;
+    /// table over the range: position of ID minID + i, hash table: position of slot i, -1 if empty
+    std::vector<int> positions;
+    /// hash table: ID of slot i
+    std::vector<int> slotIDs;
+    /// hash table: number of slots - 1, the number of slots is a power of two
+    unsigned mask;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* IDTOINDEXMAP_H_ */
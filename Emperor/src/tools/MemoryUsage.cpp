@@ -0,0 +1,73 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Andreas Apostolatos, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <sstream>
+#include <iomanip>
+#include "MemoryUsage.h"
+#include "Message.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+void MemoryUsage::add(const std::string &component, size_t bytes) {
+    for (int i = 0; i < components.size(); i++) {
+        if (components[i].first == component) {
+            components[i].second += bytes;
+            return;
+        }
+    }
+    components.push_back(make_pair(component, bytes));
+}
+
+void MemoryUsage::add(const std::string &prefix, const MemoryUsage &usage) {
+    for (int i = 0; i < usage.components.size(); i++)
+        add(prefix + "/" + usage.components[i].first, usage.components[i].second);
+}
+
+size_t MemoryUsage::getTotal() const {
+    size_t total = 0;
+    for (int i = 0; i < components.size(); i++)
+        total += components[i].second;
+    return total;
+}
+
+size_t MemoryUsage::getBytes(const std::string &component) const {
+    for (int i = 0; i < components.size(); i++)
+        if (components[i].first == component)
+            return components[i].second;
+    return 0;
+}
+
+void MemoryUsage::print(const std::string &title) const {
+    const double MB = 1024.0 * 1024.0;
+    stringstream header;
+    header << "Memory usage of " << title << ": " << fixed << setprecision(2) << getTotal() / MB
+            << " MB";
+    INFO_OUT() << header.str() << endl;
+    for (int i = 0; i < components.size(); i++) {
+        stringstream line;
+        line << "    " << left << setw(50) << components[i].first << right << setw(12) << fixed
+                << setprecision(2) << components[i].second / MB << " MB";
+        INFO_OUT() << line.str() << endl;
+    }
+}
+
+} /* namespace EMPIRE */
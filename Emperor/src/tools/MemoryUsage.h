@@ -0,0 +1,103 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Andreas Apostolatos, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file MemoryUsage.h
+ * This file holds the class MemoryUsage
+ * \date 10/15/2026
+ **************************************************************************************************/
+
+#ifndef MEMORYUSAGE_H_
+#define MEMORYUSAGE_H_
+
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <map>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class MemoryUsage is the heap memory held by an object broken down by its components
+ *        (e.g. the members of a mapper). The sizes are estimates from the sizes and capacities of
+ *        the containers, the overhead of the allocator is not included.
+ ***********/
+class MemoryUsage {
+public:
+    /***********************************************************************************************
+     * \brief Add bytes to a component, the component is created at the first call
+     * \param[in] component the name of the component
+     * \param[in] bytes the number of bytes
+     ***********/
+    void add(const std::string &component, size_t bytes);
+    /***********************************************************************************************
+     * \brief Add the components of another usage as "prefix/component" (e.g. the matrices of a mapper)
+     * \param[in] prefix the prefix of the component names
+     * \param[in] usage the usage of the sub-object
+     ***********/
+    void add(const std::string &prefix, const MemoryUsage &usage);
+    /***********************************************************************************************
+     * \brief Get the sum over all components
+     * \return the number of bytes
+     ***********/
+    size_t getTotal() const;
+    /***********************************************************************************************
+     * \brief Get the bytes of a component
+     * \param[in] component the name of the component
+     * \return the number of bytes, 0 if there is no such component
+     ***********/
+    size_t getBytes(const std::string &component) const;
+    /***********************************************************************************************
+     * \brief Get the components in the order of their first addition
+     ***********/
+    const std::vector<std::pair<std::string, size_t> > &getComponents() const {
+        return components;
+    }
+    /***********************************************************************************************
+     * \brief Print the total and the components to infoOut
+     * \param[in] title the title of the output, e.g. the name of the mapper
+     ***********/
+    void print(const std::string &title) const;
+
+    /***********************************************************************************************
+     * \brief Get the heap memory of the elements of a vector
+     ***********/
+    template<class T>
+    static size_t ofVector(const std::vector<T> &vec) {
+        return vec.capacity() * sizeof(T);
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory of the nodes of a map (without the heap memory of the values)
+     ***********/
+    template<class K, class V>
+    static size_t ofMap(const std::map<K, V> &map) {
+        return map.size() * (sizeof(typename std::map<K, V>::value_type) + MAP_NODE_OVERHEAD);
+    }
+    /// the bytes of a node of a std::map besides its value (color and three pointers)
+    static const size_t MAP_NODE_OVERHEAD = 4 * sizeof(void*);
+
+private:
+    /// name of a component <=> its bytes
+    std::vector<std::pair<std::string, size_t> > components;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* MEMORYUSAGE_H_ */
@@ -0,0 +1,98 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Andreas Apostolatos, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "MonotonicArena.h"
+#include <algorithm>
+
+namespace EMPIRE {
+
+/// Alignment of the allocations, sufficient for double and long double
+static const size_t ARENA_ALIGNMENT = 16;
+
+MonotonicArena::MonotonicArena(size_t _blockSize) :
+        currentBlock(-1), offset(0), blockSize(_blockSize) {
+}
+
+MonotonicArena::~MonotonicArena() {
+    for (int i = 0; i < blocks.size(); i++)
+        delete[] blocks[i];
+}
+
+void* MonotonicArena::allocate(size_t _numBytes) {
+    _numBytes = (_numBytes + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+    if (currentBlock >= 0 && offset + _numBytes <= blockSizes[currentBlock]) {
+        void* p = blocks[currentBlock] + offset;
+        offset += _numBytes;
+        return p;
+    }
+    // Move to the next kept block, or insert a new one large enough
+    currentBlock++;
+    offset = 0;
+    if (currentBlock == blocks.size() || blockSizes[currentBlock] < _numBytes) {
+        size_t size = std::max(blockSize, _numBytes);
+        // operator new[] of char returns memory aligned for any fundamental type
+        blocks.insert(blocks.begin() + currentBlock, new char[size]);
+        blockSizes.insert(blockSizes.begin() + currentBlock, size);
+    }
+    offset = _numBytes;
+    return blocks[currentBlock];
+}
+
+MonotonicArena::Marker MonotonicArena::getMarker() const {
+    Marker marker;
+    marker.block = currentBlock;
+    marker.offset = offset;
+    return marker;
+}
+
+void MonotonicArena::rewind(const Marker& _marker) {
+    currentBlock = _marker.block;
+    offset = _marker.offset;
+}
+
+void MonotonicArena::reset() {
+    currentBlock = -1;
+    offset = 0;
+}
+
+size_t MonotonicArena::getCapacity() const {
+    size_t capacity = 0;
+    for (int i = 0; i < blockSizes.size(); i++)
+        capacity += blockSizes[i];
+    return capacity;
+}
+
+MonotonicArena& MonotonicArena::getThreadArena() {
+    static MonotonicArena* threadArena = NULL;
+#pragma omp threadprivate(threadArena)
+    if (threadArena == NULL)
+        threadArena = new MonotonicArena();
+    return *threadArena;
+}
+
+MonotonicArena& MonotonicArena::getThreadScratchArena() {
+    static MonotonicArena* threadScratchArena = NULL;
+#pragma omp threadprivate(threadScratchArena)
+    if (threadScratchArena == NULL)
+        threadScratchArena = new MonotonicArena();
+    return *threadScratchArena;
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,209 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Andreas Apostolatos, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file MonotonicArena.h
+ * This file holds the class MonotonicArena and the class template ArenaAllocator
+ * \date 10/15/2026
+ **************************************************************************************************/
+
+#ifndef MONOTONICARENA_H_
+#define MONOTONICARENA_H_
+
+#include <stddef.h>
+#include <new>
+#include <vector>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief class MonotonicArena hands out memory by advancing a pointer in large blocks. Nothing is
+ * freed individually, the whole arena is rewound at once and its blocks are kept for the next use.
+ * It serves the short-lived polygon, clipping and triangulation temporaries of the mortar mappers,
+ * which are created and destroyed for every element.
+ ***********/
+class MonotonicArena {
+public:
+    /********//**
+     * \brief class Marker is a position in the arena to which it can be rewound
+     ***********/
+    struct Marker {
+        int block;
+        size_t offset;
+    };
+
+    /********//**
+     * \brief class Scope rewinds the arena at its end to the position it had at its begin.
+     * All memory allocated from the arena within the scope must be dead at its end.
+     ***********/
+    class Scope {
+    public:
+        explicit Scope(MonotonicArena& _arena) :
+                arena(_arena), marker(_arena.getMarker()) {
+        }
+        ~Scope() {
+            arena.rewind(marker);
+        }
+    private:
+        MonotonicArena& arena;
+        Marker marker;
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+    };
+
+    /***********************************************************************************************
+     * \brief Constructor
+     * \param[in] _blockSize The size in bytes of the blocks requested from the heap
+     ***********/
+    explicit MonotonicArena(size_t _blockSize = 64 * 1024);
+    /***********************************************************************************************
+     * \brief Destructor, frees all blocks
+     ***********/
+    ~MonotonicArena();
+    /***********************************************************************************************
+     * \brief Allocate memory aligned for any fundamental type
+     * \param[in] _numBytes The number of bytes
+     * \return Pointer to the memory, valid until the arena is rewound before it
+     ***********/
+    void* allocate(size_t _numBytes);
+    /***********************************************************************************************
+     * \brief Allocate an uninitialized array
+     * \param[in] _num The number of entries
+     ***********/
+    template<class T>
+    T* allocate(size_t _num) {
+        return static_cast<T*>(allocate(_num * sizeof(T)));
+    }
+    /***********************************************************************************************
+     * \brief Get the current position of the arena
+     ***********/
+    Marker getMarker() const;
+    /***********************************************************************************************
+     * \brief Rewind the arena to a position taken before, the blocks stay allocated
+     ***********/
+    void rewind(const Marker& _marker);
+    /***********************************************************************************************
+     * \brief Rewind the arena to its begin, the blocks stay allocated
+     ***********/
+    void reset();
+    /***********************************************************************************************
+     * \brief Get the number of bytes reserved from the heap
+     ***********/
+    size_t getCapacity() const;
+    /***********************************************************************************************
+     * \brief Get the arena of the calling thread. It is created at the first call of a thread and
+     *        lives until the end of the program
+     ***********/
+    static MonotonicArena& getThreadArena();
+    /***********************************************************************************************
+     * \brief Get the scratch arena of the calling thread. It is separate from getThreadArena and
+     *        serves only strictly nested temporaries, see ScratchArray, such that rewinding it never
+     *        releases the memory of containers taken from the other arena
+     ***********/
+    static MonotonicArena& getThreadScratchArena();
+
+private:
+    /// The blocks requested from the heap
+    std::vector<char*> blocks;
+    /// The size of each block
+    std::vector<size_t> blockSizes;
+    /// The block being filled
+    int currentBlock;
+    /// The first free byte in the current block
+    size_t offset;
+    /// The default size of a block
+    size_t blockSize;
+
+    /// Not copyable
+    MonotonicArena(const MonotonicArena&);
+    MonotonicArena& operator=(const MonotonicArena&);
+};
+
+/********//**
+ * \brief class template ArenaAllocator lets the standard containers take their memory from a
+ * MonotonicArena. Deallocation does nothing, the memory is reclaimed when the arena is rewound.
+ ***********/
+template<class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    template<class U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+
+    ArenaAllocator() :
+            arena(&MonotonicArena::getThreadArena()) {
+    }
+    explicit ArenaAllocator(MonotonicArena& _arena) :
+            arena(&_arena) {
+    }
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& _other) :
+            arena(_other.getArena()) {
+    }
+
+    pointer allocate(size_type _num, const void* = 0) {
+        return arena->allocate<T>(_num);
+    }
+    void deallocate(pointer, size_type) {
+    }
+    void construct(pointer _p, const T& _value) {
+        new (static_cast<void*>(_p)) T(_value);
+    }
+    void destroy(pointer _p) {
+        _p->~T();
+    }
+    size_type max_size() const {
+        return size_t(-1) / sizeof(T);
+    }
+    pointer address(reference _x) const {
+        return &_x;
+    }
+    const_pointer address(const_reference _x) const {
+        return &_x;
+    }
+    MonotonicArena* getArena() const {
+        return arena;
+    }
+
+private:
+    MonotonicArena* arena;
+};
+
+template<class T, class U>
+inline bool operator==(const ArenaAllocator<T>& _a, const ArenaAllocator<U>& _b) {
+    return _a.getArena() == _b.getArena();
+}
+
+template<class T, class U>
+inline bool operator!=(const ArenaAllocator<T>& _a, const ArenaAllocator<U>& _b) {
+    return _a.getArena() != _b.getArena();
+}
+
+} /* namespace EMPIRE */
+
+#endif /* MONOTONICARENA_H_ */
@@ -0,0 +1,98 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "NumaMemory.h"
+#include "AuxiliaryParameters.h"
+#include <fstream>
+#include <string>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace EMPIRE {
+namespace NumaMemory {
+
+#ifdef __linux__
+/// the memory policy of mbind interleaving the pages over the nodes (see numaif.h)
+static const int MPOL_INTERLEAVE_POLICY = 3;
+
+/***********************************************************************************************
+ * \brief Get the number of the last online NUMA node, -1 if unknown
+ ***********/
+static int getLastOnlineNode() {
+    // e.g. "0-1" or "0"
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if (!(online >> nodes))
+        return -1;
+    size_t last = nodes.find_last_of("-,");
+    return atoi(nodes.substr(last == std::string::npos ? 0 : last + 1).c_str());
+}
+#endif
+
+void interleave(const void *memory, size_t size) {
+#if defined(__linux__) && defined(SYS_mbind)
+    static const int lastNode = getLastOnlineNode();
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (lastNode < 1 || lastNode >= 8 * (int) sizeof(unsigned long) || size < 4 * pageSize)
+        return;
+    // only the pages lying completely in the array, the neighbouring allocations keep their policy
+    size_t begin = ((size_t) memory + pageSize - 1) / pageSize * pageSize;
+    size_t end = ((size_t) memory + size) / pageSize * pageSize;
+    unsigned long nodeMask = (lastNode == 8 * (int) sizeof(unsigned long) - 1) ?
+            ~0UL : (1UL << (lastNode + 1)) - 1;
+    // a failure leaves the default policy, which is not an error
+    syscall(SYS_mbind, begin, end - begin, MPOL_INTERLEAVE_POLICY, &nodeMask, lastNode + 2, 0);
+#endif
+}
+
+void firstTouch(double *array, size_t size, int numThreads) {
+#pragma omp parallel for num_threads(numThreads > 0 ? numThreads : 1) schedule(static)
+    for (long i = 0; i < (long) size; i++)
+        array[i] = 0.0;
+}
+
+/// alignment of all arrays, a cache line
+static const size_t CACHE_LINE_SIZE = 64;
+/// size of a transparent huge page
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+void *allocate(size_t size) {
+    bool isHuge = AuxiliaryParameters::hugePages && size >= HUGE_PAGE_SIZE;
+    void *memory = NULL;
+    if (posix_memalign(&memory, isHuge ? HUGE_PAGE_SIZE : CACHE_LINE_SIZE, size > 0 ? size : 1) != 0)
+        memory = NULL;
+    assert(memory != NULL);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // a failure (e.g. huge pages disabled by the system) leaves normal pages, which is not an error
+    if (isHuge)
+        madvise(memory, size / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE, MADV_HUGEPAGE);
+#endif
+    return memory;
+}
+
+void deallocate(void *memory) {
+    free(memory);
+}
+
+} /* namespace NumaMemory */
+} /* namespace EMPIRE */
@@ -0,0 +1,176 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file NumaMemory.h
+ * This file holds the class template NumaArray and the functions of the namespace NumaMemory
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef NUMAMEMORY_H_
+#define NUMAMEMORY_H_
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <vector>
+
+namespace EMPIRE {
+/********//**
+ * \brief The placement of memory on the NUMA nodes. A page is placed on the node of the thread
+ *        which touches it first, so an array read by the threads of a kernel is placed best by
+ *        having each thread touch the part it reads later on (first touch).
+ ***********/
+namespace NumaMemory {
+/***********************************************************************************************
+ * \brief Interleave the pages of an allocated, not yet touched, array over all NUMA nodes. This
+ *        is meant for large arrays read by all threads (e.g. the nodes of a mesh), it does nothing
+ *        for arrays smaller than a few pages or on systems without NUMA support.
+ * \param[in] memory the array
+ * \param[in] size the size in bytes
+ ***********/
+void interleave(const void *memory, size_t size);
+/***********************************************************************************************
+ * \brief Zero an array by the threads of a static schedule, such that the kernels with a static
+ *        schedule over the same number of threads read local memory
+ * \param[out] array the array
+ * \param[in] size the number of entries
+ * \param[in] numThreads the number of threads
+ ***********/
+void firstTouch(double *array, size_t size, int numThreads);
+/***********************************************************************************************
+ * \brief Allocate a large numeric array, aligned to a cache line for the vectorized kernels. If
+ *        AuxiliaryParameters::hugePages is set, an array of at least one huge page is aligned to
+ *        a huge page and advised to be backed by transparent huge pages, which saves TLB misses
+ *        when the array is read all over. The memory is not touched.
+ * \param[in] size the size in bytes
+ * \return the memory, to be freed by deallocate
+ ***********/
+void *allocate(size_t size);
+/***********************************************************************************************
+ * \brief Free an array allocated by allocate
+ * \param[in] memory the memory, NULL does nothing
+ ***********/
+void deallocate(void *memory);
+/***********************************************************************************************
+ * \brief Allocate an array of plain values by allocate
+ * \param[in] numEntries the number of entries
+ * \return the array, to be freed by deallocate
+ ***********/
+template<class T>
+T *allocateArray(size_t numEntries) {
+    return static_cast<T*>(allocate(numEntries * sizeof(T)));
+}
+} /* namespace NumaMemory */
+
+/********//**
+ * \brief Class template NumaArray is an array of plain values which is allocated without touching
+ *        its memory, such that its pages are placed by the threads which fill its blocks.
+ ***********/
+template<class T>
+class NumaArray {
+public:
+    NumaArray() :
+            array(NULL), numEntries(0) {
+    }
+    ~NumaArray() {
+        clear();
+    }
+    /***********************************************************************************************
+     * \brief Allocate the array, the entries are not initialized
+     * \param[in] size the number of entries
+     ***********/
+    void allocate(size_t size) {
+        clear();
+        numEntries = size;
+        // at least one entry, so that the array can be passed by its first element
+        array = NumaMemory::allocateArray<T>(size > 0 ? size : 1);
+    }
+    /***********************************************************************************************
+     * \brief Allocate the array and fill the blocks [blockBegins[b], blockBegins[b+1]) by one
+     *        thread each
+     * \param[in] values the values of the entries
+     * \param[in] blockBegins the first entry of every block and the size at the end
+     ***********/
+    void assign(const T *values, const std::vector<size_t> &blockBegins) {
+        allocate(blockBegins.back());
+        int numBlocks = blockBegins.size() - 1;
+#pragma omp parallel for num_threads(numBlocks) schedule(static, 1)
+        for (int b = 0; b < numBlocks; b++)
+            for (size_t i = blockBegins[b]; i < blockBegins[b + 1]; i++)
+                array[i] = values[i];
+    }
+    /***********************************************************************************************
+     * \brief Allocate the array and zero the blocks [blockBegins[b], blockBegins[b+1]) by one
+     *        thread each, the entries are filled later on
+     * \param[in] blockBegins the first entry of every block and the size at the end
+     ***********/
+    void assignZeros(const std::vector<size_t> &blockBegins) {
+        allocate(blockBegins.back());
+        int numBlocks = blockBegins.size() - 1;
+#pragma omp parallel for num_threads(numBlocks) schedule(static, 1)
+        for (int b = 0; b < numBlocks; b++)
+            for (size_t i = blockBegins[b]; i < blockBegins[b + 1]; i++)
+                array[i] = T();
+    }
+    /***********************************************************************************************
+     * \brief Free the array
+     ***********/
+    void clear() {
+        NumaMemory::deallocate(array);
+        array = NULL;
+        numEntries = 0;
+    }
+    T *data() {
+        return array;
+    }
+    const T *data() const {
+        return array;
+    }
+    T &operator[](size_t i) {
+        return array[i];
+    }
+    const T &operator[](size_t i) const {
+        return array[i];
+    }
+    size_t size() const {
+        return numEntries;
+    }
+    bool empty() const {
+        return numEntries == 0;
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory of the entries
+     ***********/
+    size_t getMemoryUsage() const {
+        return array == NULL ? 0 : (numEntries > 0 ? numEntries : 1) * sizeof(T);
+    }
+private:
+    /// the entries
+    T *array;
+    /// the number of entries
+    size_t numEntries;
+    /// disallow copy constructor
+    NumaArray(const NumaArray&);
+    /// disallow assignment operator
+    NumaArray& operator=(const NumaArray&);
+};
+
+} /* namespace EMPIRE */
+#endif /* NUMAMEMORY_H_ */
@@ -0,0 +1,98 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <algorithm>
+#include "SpaceFillingCurve.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+unsigned long long SpaceFillingCurve::getMortonKey(const unsigned *cell) {
+    unsigned long long key = 0;
+    for (int b = BITS - 1; b >= 0; b--)
+        for (int i = 0; i < 3; i++)
+            key = (key << 1) | ((cell[i] >> b) & 1);
+    return key;
+}
+
+unsigned long long SpaceFillingCurve::getHilbertKey(const unsigned *cell) {
+    unsigned x[3] = { cell[0], cell[1], cell[2] };
+    const unsigned M = 1u << (BITS - 1);
+    // 1. inverse undo of the rotations and reflections
+    for (unsigned Q = M; Q > 1; Q >>= 1) {
+        unsigned P = Q - 1;
+        for (int i = 0; i < 3; i++) {
+            if (x[i] & Q) {
+                x[0] ^= P;
+            } else {
+                unsigned t = (x[0] ^ x[i]) & P;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    // 2. Gray encode, the transposed key is in x
+    for (int i = 1; i < 3; i++)
+        x[i] ^= x[i - 1];
+    unsigned t = 0;
+    for (unsigned Q = M; Q > 1; Q >>= 1)
+        if (x[2] & Q)
+            t ^= Q - 1;
+    for (int i = 0; i < 3; i++)
+        x[i] ^= t;
+    return getMortonKey(x);
+}
+
+void SpaceFillingCurve::computeOrder(Type type, int numPoints, const double *points,
+        std::vector<int> &order) {
+    order.resize(numPoints);
+    if (numPoints == 0)
+        return;
+    double min[3], max[3];
+    for (int i = 0; i < 3; i++)
+        min[i] = max[i] = points[i];
+    for (int j = 1; j < numPoints; j++) {
+        for (int i = 0; i < 3; i++) {
+            min[i] = std::min(min[i], points[j * 3 + i]);
+            max[i] = std::max(max[i], points[j * 3 + i]);
+        }
+    }
+    double extent = std::max(max[0] - min[0], std::max(max[1] - min[1], max[2] - min[2]));
+    const unsigned maxCell = (1u << BITS) - 1;
+    double scale = (extent > 0.0) ? (1u << BITS) / extent : 0.0;
+
+    // the index breaks the ties of points in the same cell
+    vector<pair<unsigned long long, int> > keys(numPoints);
+#pragma omp parallel for
+    for (int j = 0; j < numPoints; j++) {
+        unsigned cell[3];
+        for (int i = 0; i < 3; i++)
+            cell[i] = std::min(maxCell, (unsigned) ((points[j * 3 + i] - min[i]) * scale));
+        keys[j].first = (type == MORTON) ? getMortonKey(cell) : getHilbertKey(cell);
+        keys[j].second = j;
+    }
+    sort(keys.begin(), keys.end());
+    for (int j = 0; j < numPoints; j++)
+        order[j] = keys[j].second;
+}
+
+} /* namespace EMPIRE */
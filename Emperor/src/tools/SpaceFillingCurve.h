@@ -0,0 +1,73 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file SpaceFillingCurve.h
+ * This file holds the class SpaceFillingCurve
+ * \date 10/15/2026
+ **************************************************************************************************/
+
+#ifndef SPACEFILLINGCURVE_H_
+#define SPACEFILLINGCURVE_H_
+
+#include <vector>
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Class SpaceFillingCurve orders points along a Morton (Z-order) or a Hilbert curve through
+ *        their bounding box, such that points close in space are close in the order. The points
+ *        are quantized to 2^BITS cells per direction, the cells are cubes.
+ ***********/
+class SpaceFillingCurve {
+public:
+    /// the curves
+    enum Type {
+        MORTON, HILBERT
+    };
+    /***********************************************************************************************
+     * \brief Compute the order of points along a curve
+     * \param[in] type the curve
+     * \param[in] numPoints number of points
+     * \param[in] points x,y,z coordinates of all points
+     * \param[out] order order[k] is the index of the k-th point on the curve
+     ***********/
+    static void computeOrder(Type type, int numPoints, const double *points, std::vector<int> &order);
+    /***********************************************************************************************
+     * \brief Get the Morton key of a cell, the bits of the coordinates interleaved
+     * \param[in] cell the integer coordinates of the cell, less than 2^BITS
+     * \return the key
+     ***********/
+    static unsigned long long getMortonKey(const unsigned *cell);
+    /***********************************************************************************************
+     * \brief Get the Hilbert key of a cell (J. Skilling, Programming the Hilbert curve, AIP
+     *        Conference Proceedings 707, 2004)
+     * \param[in] cell the integer coordinates of the cell, less than 2^BITS
+     * \return the key
+     ***********/
+    static unsigned long long getHilbertKey(const unsigned *cell);
+
+    /// number of bits per coordinate, three coordinates fit into a 64 bit key
+    static const int BITS = 21;
+};
+
+} /* namespace EMPIRE */
+
+#endif /* SPACEFILLINGCURVE_H_ */
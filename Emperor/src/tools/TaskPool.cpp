@@ -0,0 +1,126 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "TaskPool.h"
+#include "Message.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace std;
+
+namespace EMPIRE {
+
+TaskPool::TaskPool(int _numThreads, int numCoresPerThread) :
+        numThreads(_numThreads), numBusy(0), stopRequested(false) {
+    assert(numThreads >= 0);
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&taskPushed, NULL);
+    pthread_cond_init(&taskDone, NULL);
+    threads.resize(numThreads);
+    for (int i = 0; i < numThreads; i++) {
+        if (pthread_create(&threads[i], NULL, threadEntry, this) != 0) {
+            ERROR_OUT() << "Cannot start the worker threads of the task pool" << endl;
+            exit(EXIT_FAILURE);
+        }
+        if (numCoresPerThread > 0)
+            pinThread(threads[i], i * numCoresPerThread, numCoresPerThread);
+    }
+}
+
+TaskPool::~TaskPool() {
+    pthread_mutex_lock(&mutex);
+    stopRequested = true;
+    pthread_cond_broadcast(&taskPushed);
+    pthread_mutex_unlock(&mutex);
+    for (int i = 0; i < numThreads; i++)
+        pthread_join(threads[i], NULL); // the threads execute all remaining tasks before they stop
+    assert(queue.empty());
+    pthread_cond_destroy(&taskDone);
+    pthread_cond_destroy(&taskPushed);
+    pthread_mutex_destroy(&mutex);
+}
+
+void TaskPool::push(AbstractTask *task) {
+    if (numThreads == 0) {
+        task->execute();
+        delete task;
+        return;
+    }
+    pthread_mutex_lock(&mutex);
+    queue.push_back(task);
+    pthread_cond_signal(&taskPushed);
+    pthread_mutex_unlock(&mutex);
+}
+
+void TaskPool::wait() {
+    pthread_mutex_lock(&mutex);
+    while (!queue.empty() || numBusy > 0)
+        pthread_cond_wait(&taskDone, &mutex);
+    pthread_mutex_unlock(&mutex);
+}
+
+void TaskPool::pinThread(pthread_t thread, int firstCore, int numCores) {
+#ifdef __linux__
+    int numOnlineCores = sysconf(_SC_NPROCESSORS_ONLN);
+    cpu_set_t cores;
+    CPU_ZERO(&cores);
+    for (int i = 0; i < numCores; i++)
+        CPU_SET((firstCore + i) % numOnlineCores, &cores);
+    if (pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cores) != 0)
+        WARNING_OUT() << "Cannot pin a worker thread of the task pool" << endl;
+#else
+    WARNING_OUT() << "Pinning of threads is not supported on this platform" << endl;
+#endif
+}
+
+void TaskPool::run() {
+    while (true) {
+        pthread_mutex_lock(&mutex);
+        while (queue.empty() && !stopRequested)
+            pthread_cond_wait(&taskPushed, &mutex);
+        if (queue.empty()) { // stop requested and nothing left to do
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+        AbstractTask *task = queue.front();
+        queue.pop_front();
+        numBusy++;
+        pthread_mutex_unlock(&mutex);
+
+        task->execute();
+        delete task;
+
+        pthread_mutex_lock(&mutex);
+        numBusy--;
+        pthread_cond_broadcast(&taskDone);
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+void *TaskPool::threadEntry(void *pool) {
+    static_cast<TaskPool*>(pool)->run();
+    return NULL;
+}
+
+} /* namespace EMPIRE */
@@ -0,0 +1,128 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file TaskPool.h
+ * This file holds the class TaskPool
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef TASKPOOL_H_
+#define TASKPOOL_H_
+
+#include <deque>
+#include <vector>
+#include <pthread.h>
+
+namespace EMPIRE {
+/********//**
+ * \brief Class AbstractTask is a piece of work executed by a TaskPool
+ ***********/
+class AbstractTask {
+public:
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~AbstractTask() {
+    }
+    /***********************************************************************************************
+     * \brief Do the work
+     ***********/
+    virtual void execute() = 0;
+};
+
+/********//**
+ * \brief Class TaskPool executes tasks on a fixed number of worker threads, in the order they are
+ *        pushed. Every worker thread is a plain thread, so an OpenMP parallel region in a task
+ *        opens its own team. With 0 threads push executes the task immediately.
+ *        The worker threads can be pinned to disjoint sets of cores, the team of an OpenMP parallel
+ *        region in a task inherits the cores of its worker thread, such that concurrent tasks do not
+ *        share cores.
+ ***********/
+class TaskPool {
+public:
+    /***********************************************************************************************
+     * \brief Constructor, starts the worker threads
+     * \param[in] _numThreads the number of worker threads
+     * \param[in] numCoresPerThread if positive, worker thread i is pinned to the cores
+     *            [i*numCoresPerThread, (i+1)*numCoresPerThread) (modulo the number of cores)
+     ***********/
+    TaskPool(int _numThreads, int numCoresPerThread = 0);
+    /***********************************************************************************************
+     * \brief Destructor, executes all pushed tasks and stops the worker threads
+     ***********/
+    virtual ~TaskPool();
+    /***********************************************************************************************
+     * \brief Push a task to the queue
+     * \param[in] task the task, it is deleted after its execution
+     ***********/
+    void push(AbstractTask *task);
+    /***********************************************************************************************
+     * \brief Wait until all pushed tasks are executed
+     ***********/
+    void wait();
+    /***********************************************************************************************
+     * \brief Get the number of worker threads
+     * \return the number of worker threads
+     ***********/
+    int getNumThreads() const {
+        return numThreads;
+    }
+
+private:
+    /// the number of worker threads
+    const int numThreads;
+    /// the tasks waiting in the queue
+    std::deque<AbstractTask*> queue;
+    /// the number of worker threads executing a task
+    int numBusy;
+    /// whether the worker threads should stop after the queue is empty
+    bool stopRequested;
+    /// the worker threads
+    std::vector<pthread_t> threads;
+    /// protects queue, numBusy and stopRequested
+    pthread_mutex_t mutex;
+    /// signaled when a task is pushed or a stop is requested
+    pthread_cond_t taskPushed;
+    /// signaled when a task is executed
+    pthread_cond_t taskDone;
+    /***********************************************************************************************
+     * \brief Pin a worker thread to a set of consecutive cores
+     * \param[in] thread the worker thread
+     * \param[in] firstCore the first core
+     * \param[in] numCores the number of cores
+     ***********/
+    static void pinThread(pthread_t thread, int firstCore, int numCores);
+    /***********************************************************************************************
+     * \brief The loop of a worker thread
+     ***********/
+    void run();
+    /***********************************************************************************************
+     * \brief Entry point of a worker thread
+     * \param[in] pool the TaskPool
+     ***********/
+    static void *threadEntry(void *pool);
+    /// disallow copy constructor
+    TaskPool(const TaskPool&);
+    /// disallow assignment operator
+    TaskPool& operator=(const TaskPool&);
+};
+
+} /* namespace EMPIRE */
+#endif /* TASKPOOL_H_ */
@@ -23,7 +23,9 @@
 #include <assert.h>
 #include <map>
 #include "polypartition.h"
+#include "MonotonicArena.h"
 #include <iostream>
+#include <algorithm>
 
 using namespace std;
 
@@ -33,34 +35,36 @@ TriangulatorAdaptor::TriangulatorAdaptor() {
 }
 
 TriangulatorAdaptor::~TriangulatorAdaptor() {
-    for (int i = 0; i < polygon.size(); i++)
-        delete[] polygon[i];
 }
 
 void TriangulatorAdaptor::addPoint(double x, double y, double z) {
-    double *point = new double[3];
-    point[0] = x;
-    point[1] = y;
-    point[2] = z;
-    polygon.push_back(point);
+    polygon.push_back(x);
+    polygon.push_back(y);
+    polygon.push_back(z);
 }
 
 bool TriangulatorAdaptor::triangulate(int *triangleIndexes) {
     int XX, YY;
     from3DTo2D(XX, YY);
+    const int numPoints = polygon.size() / 3;
 
-    map<pair<double, double> , int> coorToPosMap; // coordinate to position map
-    for (int i = 0; i < polygon.size(); i++) {
+    // The temporaries of the triangulation are released at the end of the scope
+    MonotonicArena& arena = MonotonicArena::getThreadArena();
+    MonotonicArena::Scope arenaScope(arena);
+    typedef pair<const pair<double, double>, int> CoorToPos;
+    map<pair<double, double>, int, less<pair<double, double> >, ArenaAllocator<CoorToPos> > coorToPosMap(
+            (less<pair<double, double> >()), ArenaAllocator<CoorToPos>(arena)); // coordinate to position map
+    for (int i = 0; i < numPoints; i++) {
         coorToPosMap.insert(
                 pair<pair<double, double> , int>(
-                        pair<double, double>(polygon[i][XX], polygon[i][YY]), i));
+                        pair<double, double>(polygon[3 * i + XX], polygon[3 * i + YY]), i));
     }
 
     TPPLPoly poly;
-    poly.Init(polygon.size());
-    for (int i = 0; i < polygon.size(); i++) {
-        poly[i].x = polygon[i][XX];
-        poly[i].y = polygon[i][YY];
+    poly.Init(numPoints);
+    for (int i = 0; i < numPoints; i++) {
+        poly[i].x = polygon[3 * i + XX];
+        poly[i].y = polygon[3 * i + YY];
     }
 
     if (poly.GetOrientation() == TPPL_CW) {
@@ -79,13 +83,13 @@ bool TriangulatorAdaptor::triangulate(int *triangleIndexes) {
     if (success != 1) {
         cout << "Error: polygon cannot be triangulated!" << endl;
         cout << "Polygon:" << endl;
-        for (int i=0; i<polygon.size(); i++) {
-            cout << polygon[i][0] << "   " << polygon[i][1] << "   " << polygon[i][2] << endl;
+        for (int i=0; i<numPoints; i++) {
+            cout << polygon[3*i] << "   " << polygon[3*i+1] << "   " << polygon[3*i+2] << endl;
         }
 		return false;
     }
     //assert(success == 1);
-    assert(triangles.size() +2 == polygon.size());
+    assert(triangles.size() +2 == numPoints);
     int count = 0;
     for (list<TPPLPoly>::iterator it = triangles.begin(); it != triangles.end(); it++) {
         if (!isClockwise) {
@@ -105,20 +109,160 @@ bool TriangulatorAdaptor::triangulate(int *triangleIndexes) {
     return true;
 }
 
+/// The signed area of the triangle a, b, c, twice, positive if counterclockwise
+static inline double cross2D(const pair<double, double>& a, const pair<double, double>& b,
+        const pair<double, double>& c) {
+    return (b.first - a.first) * (c.second - a.second) - (c.first - a.first) * (b.second - a.second);
+}
+
+/***********************************************************************************************
+ * \brief Ear clipping of a counterclockwise polygon with at most MAX_VERTICES_EARCLIPPING vertices
+ * \param[in] _polygon The polygon
+ * \param[in] _order The indices of the vertices of _polygon in counterclockwise order
+ * \param[out] _triangleIndexes The indices of the counterclockwise triangles
+ * \return false if no ear is found, that is for degenerate or self-intersecting polygons
+ ***********/
+static bool clipEars(const vector<pair<double, double> >& _polygon, const int* _order, int* _triangleIndexes) {
+    int remaining[TriangulatorAdaptor::MAX_VERTICES_EARCLIPPING];
+    int numRemaining = _polygon.size();
+    for (int i = 0; i < numRemaining; i++)
+        remaining[i] = _order[i];
+    int numTriangles = 0;
+    while (numRemaining > 3) {
+        bool isEarFound = false;
+        for (int i = 0; i < numRemaining && !isEarFound; i++) {
+            const int prev = remaining[(i + numRemaining - 1) % numRemaining];
+            const int curr = remaining[i];
+            const int next = remaining[(i + 1) % numRemaining];
+            const pair<double, double>& a = _polygon[prev];
+            const pair<double, double>& b = _polygon[curr];
+            const pair<double, double>& c = _polygon[next];
+            // The vertex must be convex
+            if (cross2D(a, b, c) <= 0.0)
+                continue;
+            // No other vertex may lie in the triangle or on its boundary
+            bool isEar = true;
+            for (int j = 0; j < numRemaining && isEar; j++) {
+                const int other = remaining[j];
+                if (other == prev || other == curr || other == next)
+                    continue;
+                const pair<double, double>& p = _polygon[other];
+                if (cross2D(a, b, p) >= 0.0 && cross2D(b, c, p) >= 0.0 && cross2D(c, a, p) >= 0.0)
+                    isEar = false;
+            }
+            if (!isEar)
+                continue;
+            _triangleIndexes[3 * numTriangles] = prev;
+            _triangleIndexes[3 * numTriangles + 1] = curr;
+            _triangleIndexes[3 * numTriangles + 2] = next;
+            numTriangles++;
+            for (int j = i; j < numRemaining - 1; j++)
+                remaining[j] = remaining[j + 1];
+            numRemaining--;
+            isEarFound = true;
+        }
+        if (!isEarFound)
+            return false;
+    }
+    _triangleIndexes[3 * numTriangles] = remaining[0];
+    _triangleIndexes[3 * numTriangles + 1] = remaining[1];
+    _triangleIndexes[3 * numTriangles + 2] = remaining[2];
+    return true;
+}
+
+TriangulatorAdaptor::TriangulationPath TriangulatorAdaptor::triangulatePolygon(
+        const vector<pair<double, double> >& _polygon, vector<vector<pair<double, double> > >& _triangles) {
+    _triangles.clear();
+    const int numPoints = _polygon.size();
+    if (numPoints < 4) {
+        _triangles.push_back(_polygon);
+        return PATH_TRIANGLE;
+    }
+    const int numTriangles = numPoints - 2;
+    TriangulationPath path = PATH_POLYPARTITION;
+    int triangleIndexes[3 * numTriangles];
+
+    if (numPoints <= MAX_VERTICES_EARCLIPPING) {
+        // Orientation, repeated vertices and convexity
+        double area = 0.0;
+        bool hasRepeatedVertex = false;
+        for (int p = 0, q = numPoints - 1; p < numPoints; q = p++) {
+            area += _polygon[q].first * _polygon[p].second - _polygon[p].first * _polygon[q].second;
+            if (_polygon[p] == _polygon[q])
+                hasRepeatedVertex = true;
+        }
+        if (area == 0.0)
+            return PATH_FAILED;
+        const bool isClockwise = area < 0.0;
+        int order[MAX_VERTICES_EARCLIPPING];
+        for (int i = 0; i < numPoints; i++)
+            order[i] = isClockwise ? numPoints - 1 - i : i;
+        bool isConvex = !hasRepeatedVertex && numPoints <= MAX_VERTICES_FAN;
+        for (int i = 0; i < numPoints && isConvex; i++)
+            if (cross2D(_polygon[order[i]], _polygon[order[(i + 1) % numPoints]],
+                    _polygon[order[(i + 2) % numPoints]]) <= 0.0)
+                isConvex = false;
+
+        if (isConvex) {
+            for (int i = 0; i < numTriangles; i++) {
+                triangleIndexes[3 * i] = order[0];
+                triangleIndexes[3 * i + 1] = order[i + 1];
+                triangleIndexes[3 * i + 2] = order[i + 2];
+            }
+            path = PATH_FAN;
+        } else if (!hasRepeatedVertex && clipEars(_polygon, order, triangleIndexes)) {
+            path = PATH_EARCLIPPING;
+        }
+        // Bring the counterclockwise triangles to the orientation of the polygon
+        if (path != PATH_POLYPARTITION && isClockwise)
+            for (int i = 0; i < numTriangles; i++)
+                swap(triangleIndexes[3 * i + 1], triangleIndexes[3 * i + 2]);
+    }
+
+    if (path == PATH_POLYPARTITION) {
+        TriangulatorAdaptor triangulator;
+        for (int i = 0; i < numPoints; i++)
+            triangulator.addPoint(_polygon[i].first, _polygon[i].second, 0);
+        if (!triangulator.triangulate(triangleIndexes))
+            return PATH_FAILED;
+    }
+
+    _triangles.resize(numTriangles, vector<pair<double, double> >(3));
+    for (int i = 0; i < numTriangles; i++)
+        for (int j = 0; j < 3; j++)
+            _triangles[i][j] = _polygon[triangleIndexes[3 * i + j]];
+    return path;
+}
+
+const char* TriangulatorAdaptor::getPathName(TriangulationPath _path) {
+    switch (_path) {
+    case PATH_TRIANGLE:
+        return "triangle";
+    case PATH_FAN:
+        return "convex fan";
+    case PATH_EARCLIPPING:
+        return "ear clipping";
+    case PATH_POLYPARTITION:
+        return "polypartition";
+    default:
+        return "failed";
+    }
+}
+
 void TriangulatorAdaptor::from3DTo2D(int &XX, int &YY) {
-    assert(polygon.size() >= 4);
+    assert(polygon.size() >= 4 * 3);
     // determine whether to project to XY or XZ or YZ plane
     // by checking the size of projected triangle
     // the plane where the size of the projected triangle is the largest, then use that plane
     int flag = 0;
     double areaMax = 0.0;
     { // the 1st triangle
-        double dx1 = polygon[0][0] - polygon[1][0];
-        double dy1 = polygon[0][1] - polygon[1][1];
-        double dz1 = polygon[0][2] - polygon[1][2];
-        double dx2 = polygon[0][0] - polygon[2][0];
-        double dy2 = polygon[0][1] - polygon[2][1];
-        double dz2 = polygon[0][2] - polygon[2][2];
+        double dx1 = polygon[0] - polygon[3];
+        double dy1 = polygon[1] - polygon[4];
+        double dz1 = polygon[2] - polygon[5];
+        double dx2 = polygon[0] - polygon[6];
+        double dy2 = polygon[1] - polygon[7];
+        double dz2 = polygon[2] - polygon[8];
         double areaXY = fabs(dx1*dy2 - dx2*dy1);
         double areaYZ = fabs(dy1*dz2 - dy2*dz1);
         double areaXZ = fabs(dx1*dz2 - dx2*dz1);
@@ -135,12 +279,12 @@ void TriangulatorAdaptor::from3DTo2D(int &XX, int &YY) {
         }
     }
     { // the 2nd triangle
-        double dx1 = polygon[0][0] - polygon[1][0];
-        double dy1 = polygon[0][1] - polygon[1][1];
-        double dz1 = polygon[0][2] - polygon[1][2];
-        double dx2 = polygon[0][0] - polygon[3][0];
-        double dy2 = polygon[0][1] - polygon[3][1];
-        double dz2 = polygon[0][2] - polygon[3][2];
+        double dx1 = polygon[0] - polygon[3];
+        double dy1 = polygon[1] - polygon[4];
+        double dz1 = polygon[2] - polygon[5];
+        double dx2 = polygon[0] - polygon[9];
+        double dy2 = polygon[1] - polygon[10];
+        double dz2 = polygon[2] - polygon[11];
         double areaXY = fabs(dx1*dy2 - dx2*dy1);
         double areaYZ = fabs(dy1*dz2 - dy2*dz1);
         double areaXZ = fabs(dx1*dz2 - dx2*dz1);
@@ -22,18 +22,47 @@
 #define TRIANGULATORADAPTOR_H_
 
 #include <vector>
+#include <utility>
 
 namespace EMPIRE {
 
 class TriangulatorAdaptor {
 public:
+    /***********************************************************************************************
+     * \brief Enum TriangulationPath tells how triangulatePolygon triangulated a polygon
+     ***********/
+    typedef enum TriangulationPath {
+        PATH_FAILED = 0, PATH_TRIANGLE, PATH_FAN, PATH_EARCLIPPING, PATH_POLYPARTITION, NUM_PATHS
+    } TriangulationPath;
+    /// Maximum number of vertices of a convex polygon triangulated as a fan
+    static const int MAX_VERTICES_FAN = 8;
+    /// Maximum number of vertices of a polygon triangulated by ear clipping
+    static const int MAX_VERTICES_EARCLIPPING = 32;
+
     TriangulatorAdaptor();
     virtual ~TriangulatorAdaptor();
     void addPoint(double x, double y, double z);
     bool triangulate(int *triangleIndexes);
+    /***********************************************************************************************
+     * \brief Triangulate a simple 2D polygon. Small convex polygons, such as the FE elements clipped
+     *        by the knot spans, are split as a fan from their first vertex. Other small polygons are
+     *        triangulated by ear clipping. Only large or degenerate polygons, with repeated vertices
+     *        or where no ear is found, are passed to the optimal triangulation of polypartition
+     * \param[in] _polygon The polygon, either clockwise or counterclockwise
+     * \param[out] _triangles The triangles, with the orientation of _polygon. A triangle is copied
+     *        as is, and the list is empty if the triangulation failed
+     * \return The way the polygon was triangulated
+     ***********/
+    static TriangulationPath triangulatePolygon(const std::vector<std::pair<double, double> >& _polygon,
+            std::vector<std::vector<std::pair<double, double> > >& _triangles);
+    /***********************************************************************************************
+     * \brief Get the name of a triangulation path for the output
+     ***********/
+    static const char* getPathName(TriangulationPath _path);
 private:
     bool isClockwise;
-    std::vector<double*> polygon;
+    /// The coordinates of the points, three per point
+    std::vector<double> polygon;
     void from3DTo2D(int &XX, int &YY);
 };
 
@@ -0,0 +1,138 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <algorithm>
+#include "BlockSparseMatrix.h"
+
+using namespace std;
+
+namespace EMPIRE {
+namespace MathLibrary {
+
+/// number of entries of a block
+static const int BLOCK_ENTRIES = BlockSparseMatrix::BLOCK_SIZE * BlockSparseMatrix::BLOCK_SIZE;
+
+BlockSparseMatrix::BlockSparseMatrix(int _numBlockRows, int _numBlockCols, int _numThreads) :
+        numBlockRows(_numBlockRows), numBlockCols(_numBlockCols),
+        numThreads(_numThreads > 0 ? _numThreads : 1), blockRowPtr(_numBlockRows + 1, 0) {
+}
+
+BlockSparseMatrix::~BlockSparseMatrix() {
+}
+
+void BlockSparseMatrix::setCSR(const std::vector<int> &rowPtr, const std::vector<int> &cols,
+        const std::vector<double> &vals) {
+    assert((int) rowPtr.size() == BLOCK_SIZE * numBlockRows + 1);
+    assert(cols.size() == vals.size());
+    blockRowPtr.assign(numBlockRows + 1, 0);
+    blockCols.clear();
+    blockValues.clear();
+    vector<int> rowBlockCols;
+    for (int I = 0; I < numBlockRows; I++) {
+        // the block columns of the three rows, sorted and unique
+        rowBlockCols.clear();
+        for (int k = rowPtr[BLOCK_SIZE * I]; k < rowPtr[BLOCK_SIZE * (I + 1)]; k++)
+            rowBlockCols.push_back(cols[k] / BLOCK_SIZE);
+        sort(rowBlockCols.begin(), rowBlockCols.end());
+        rowBlockCols.erase(unique(rowBlockCols.begin(), rowBlockCols.end()), rowBlockCols.end());
+        size_t first = blockCols.size();
+        blockCols.insert(blockCols.end(), rowBlockCols.begin(), rowBlockCols.end());
+        blockValues.resize(blockCols.size() * BLOCK_ENTRIES, 0.0);
+        for (int r = 0; r < BLOCK_SIZE; r++) {
+            int row = BLOCK_SIZE * I + r;
+            for (int k = rowPtr[row]; k < rowPtr[row + 1]; k++) {
+                int J = cols[k] / BLOCK_SIZE;
+                assert(J < numBlockCols);
+                size_t block = first
+                        + (lower_bound(rowBlockCols.begin(), rowBlockCols.end(), J)
+                                - rowBlockCols.begin());
+                blockValues[block * BLOCK_ENTRIES + r * BLOCK_SIZE + cols[k] % BLOCK_SIZE] += vals[k];
+            }
+        }
+        blockRowPtr[I + 1] = blockCols.size();
+    }
+}
+
+void BlockSparseMatrix::getCSR(std::vector<int> &rowPtr, std::vector<int> &cols,
+        std::vector<double> &vals) const {
+    rowPtr.assign(BLOCK_SIZE * numBlockRows + 1, 0);
+    cols.clear();
+    vals.clear();
+    for (int I = 0; I < numBlockRows; I++) {
+        for (int r = 0; r < BLOCK_SIZE; r++) {
+            for (int b = blockRowPtr[I]; b < blockRowPtr[I + 1]; b++) {
+                const double *block = &blockValues[(size_t) b * BLOCK_ENTRIES];
+                for (int c = 0; c < BLOCK_SIZE; c++) {
+                    if (block[r * BLOCK_SIZE + c] != 0.0) {
+                        cols.push_back(BLOCK_SIZE * blockCols[b] + c);
+                        vals.push_back(block[r * BLOCK_SIZE + c]);
+                    }
+                }
+            }
+            rowPtr[BLOCK_SIZE * I + r + 1] = cols.size();
+        }
+    }
+}
+
+void BlockSparseMatrix::multiply(bool transpose, const double *x, double *y) const {
+    const double *values = blockValues.empty() ? NULL : &blockValues[0];
+    if (!transpose) {
+        // every block row is a gather, the block rows are split over the threads
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+        for (int I = 0; I < numBlockRows; I++) {
+            double y0 = 0.0, y1 = 0.0, y2 = 0.0;
+            for (int b = blockRowPtr[I]; b < blockRowPtr[I + 1]; b++) {
+                const double *block = &values[(size_t) b * BLOCK_ENTRIES];
+                const double *xJ = &x[BLOCK_SIZE * blockCols[b]];
+                y0 += block[0] * xJ[0] + block[1] * xJ[1] + block[2] * xJ[2];
+                y1 += block[3] * xJ[0] + block[4] * xJ[1] + block[5] * xJ[2];
+                y2 += block[6] * xJ[0] + block[7] * xJ[1] + block[8] * xJ[2];
+            }
+            y[BLOCK_SIZE * I] = y0;
+            y[BLOCK_SIZE * I + 1] = y1;
+            y[BLOCK_SIZE * I + 2] = y2;
+        }
+    } else {
+        // the transposed blocks are scattered to the block columns
+        for (int j = 0; j < BLOCK_SIZE * numBlockCols; j++)
+            y[j] = 0.0;
+        for (int I = 0; I < numBlockRows; I++) {
+            const double *xI = &x[BLOCK_SIZE * I];
+            for (int b = blockRowPtr[I]; b < blockRowPtr[I + 1]; b++) {
+                const double *block = &values[(size_t) b * BLOCK_ENTRIES];
+                double *yJ = &y[BLOCK_SIZE * blockCols[b]];
+                yJ[0] += block[0] * xI[0] + block[3] * xI[1] + block[6] * xI[2];
+                yJ[1] += block[1] * xI[0] + block[4] * xI[1] + block[7] * xI[2];
+                yJ[2] += block[2] * xI[0] + block[5] * xI[1] + block[8] * xI[2];
+            }
+        }
+    }
+}
+
+MemoryUsage BlockSparseMatrix::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("block pattern", MemoryUsage::ofVector(blockRowPtr) + MemoryUsage::ofVector(blockCols));
+    usage.add("block values", MemoryUsage::ofVector(blockValues));
+    return usage;
+}
+
+} /* namespace MathLibrary */
+} /* namespace EMPIRE */
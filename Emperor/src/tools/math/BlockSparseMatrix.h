@@ -0,0 +1,130 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file BlockSparseMatrix.h
+ * This file holds the class BlockSparseMatrix
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef BLOCKSPARSEMATRIX_H_
+#define BLOCKSPARSEMATRIX_H_
+
+#include <vector>
+#include "MemoryUsage.h"
+
+namespace EMPIRE {
+namespace MathLibrary {
+
+/********//**
+ * \brief Class BlockSparseMatrix is a sparse matrix of 3x3 blocks in zero-based block CSR (BSR)
+ *        format, e.g. a coupling matrix of vector fields whose three components are interleaved
+ *        (unknown 3 * i + k is component k of node i). One column index is stored per block
+ *        instead of one per entry and the products work on whole blocks.
+ ***********/
+class BlockSparseMatrix {
+public:
+    /// number of rows and columns of a block
+    static const int BLOCK_SIZE = 3;
+    /***********************************************************************************************
+     * \brief Constructor, the matrix is empty
+     * \param[in] _numBlockRows number of block rows
+     * \param[in] _numBlockCols number of block columns
+     * \param[in] _numThreads the number of threads of the products
+     ***********/
+    BlockSparseMatrix(int _numBlockRows, int _numBlockCols, int _numThreads = 1);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~BlockSparseMatrix();
+    /***********************************************************************************************
+     * \brief Fill the matrix with the entries of a scalar matrix, every entry goes to its block and
+     *        a block is stored if any of its entries is
+     * \param[in] rowPtr the entries of scalar row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+     * \param[in] cols the column of each entry
+     * \param[in] vals the value of each entry
+     ***********/
+    void setCSR(const std::vector<int> &rowPtr, const std::vector<int> &cols,
+            const std::vector<double> &vals);
+    /***********************************************************************************************
+     * \brief Copy the stored blocks as scalar matrix in zero-based CSR format, zeros inside the
+     *        blocks are skipped
+     * \param[out] rowPtr the entries of scalar row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+     * \param[out] cols the column of each entry
+     * \param[out] vals the value of each entry
+     ***********/
+    void getCSR(std::vector<int> &rowPtr, std::vector<int> &cols, std::vector<double> &vals) const;
+    /***********************************************************************************************
+     * \brief Compute y = A * x or y = A^T * x
+     * \param[in] transpose whether the transpose is multiplied
+     * \param[in] x the vector of size 3 * numBlockCols (3 * numBlockRows if transposed)
+     * \param[out] y the vector of size 3 * numBlockRows (3 * numBlockCols if transposed)
+     ***********/
+    void multiply(bool transpose, const double *x, double *y) const;
+    /***********************************************************************************************
+     * \brief Get the number of block rows
+     ***********/
+    int getNumBlockRows() const {
+        return numBlockRows;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of block columns
+     ***********/
+    int getNumBlockCols() const {
+        return numBlockCols;
+    }
+    /***********************************************************************************************
+     * \brief Get the block pattern, the blocks of block row I are at the positions blockRowPtr[I]
+     *        to blockRowPtr[I+1]-1
+     ***********/
+    const std::vector<int> &getBlockRowPtr() const {
+        return blockRowPtr;
+    }
+    /***********************************************************************************************
+     * \brief Get the block column of each block
+     ***********/
+    const std::vector<int> &getBlockCols() const {
+        return blockCols;
+    }
+    /***********************************************************************************************
+     * \brief Get the heap memory of the matrix
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+private:
+    /// number of block rows
+    int numBlockRows;
+    /// number of block columns
+    int numBlockCols;
+    /// number of threads
+    int numThreads;
+    /// the blocks of block row I are at the positions blockRowPtr[I] to blockRowPtr[I+1]-1
+    std::vector<int> blockRowPtr;
+    /// the block column of each block
+    std::vector<int> blockCols;
+    /// the entries of each block row major, 9 per block
+    std::vector<double> blockValues;
+    BlockSparseMatrix(const BlockSparseMatrix&);
+    BlockSparseMatrix& operator=(const BlockSparseMatrix&);
+};
+
+} /* namespace MathLibrary */
+} /* namespace EMPIRE */
+
+#endif /* BLOCKSPARSEMATRIX_H_ */
@@ -0,0 +1,525 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <algorithm>
+#include "CSRMatrix.h"
+#ifdef USE_CUDA
+#include <cuda_runtime.h>
+#endif
+
+using namespace std;
+
+namespace EMPIRE {
+namespace MathLibrary {
+
+/// number of products the MKL analysis is optimized for, a mapper is called at every time step
+static const int EXPECTED_NUM_CALLS = 1000;
+#ifdef USE_CUDA
+/// smaller matrices are multiplied on the host, where the product is cheaper than copying the vectors
+static const int MIN_NUM_DEVICE_ENTRIES = 100000;
+
+/***********************************************************************************************
+ * \brief Whether a CUDA device can be used
+ ***********/
+static bool hasDevice() {
+    int numDevices = 0;
+    return cudaGetDeviceCount(&numDevices) == cudaSuccess && numDevices > 0;
+}
+#endif
+
+CSRMatrix::CSRMatrix(int _numRows, int _numCols, const std::vector<int> &_rowPtr,
+        const std::vector<int> &_cols, const std::vector<double> &_values, int _numThreads,
+        bool _isSinglePrecision, Products _products) :
+        numRows(_numRows), numCols(_numCols), numThreads(_numThreads > 0 ? _numThreads : 1),
+        isSinglePrecision(_isSinglePrecision), products(_products), isMKL(false), isCUDA(false) {
+    assert((int) _rowPtr.size() == numRows + 1);
+    assert(_cols.size() == _values.size() && _rowPtr[numRows] == (int) _values.size());
+#ifdef USE_CUDA
+    // the single precision matrix is multiplied by the own kernels as with MKL
+    isCUDA = !isSinglePrecision && _rowPtr[numRows] >= MIN_NUM_DEVICE_ENTRIES && hasDevice();
+    deviceMatrix.description = NULL;
+    deviceTransposeMatrix.description = NULL;
+    deviceX = deviceY = NULL;
+    deviceBuffer = NULL;
+    deviceXSize = deviceYSize = deviceBufferSize = 0;
+    omp_init_lock(&deviceLock);
+    if (isCUDA) {
+        cusparseStatus_t status = cusparseCreate(&cusparseHandle);
+        assert(status == CUSPARSE_STATUS_SUCCESS);
+    }
+#endif
+    // every row block is copied by the thread which multiplies it
+    computeRowBlocks(&_rowPtr[0], numRows, matrix.rowBlocks);
+    vector<size_t> rowPtrBlocks(matrix.rowBlocks.begin(), matrix.rowBlocks.end());
+    rowPtrBlocks.back()++;
+    vector<size_t> entryBlocks = getEntryBlocks(&_rowPtr[0], matrix.rowBlocks);
+    matrix.rowPtr.assign(&_rowPtr[0], rowPtrBlocks);
+    matrix.cols.assign(_cols.data(), entryBlocks);
+    if (isSinglePrecision) {
+        vector<float> floatValues(_values.begin(), _values.end());
+        matrix.floatValues.assign(floatValues.data(), entryBlocks);
+    } else
+        matrix.values.assign(_values.data(), entryBlocks);
+#ifdef USE_INTEL_MKL
+    // MKL multiplies single precision matrices with single precision vectors only, the single
+    // precision matrix is multiplied by the own kernels
+    isMKL = !isSinglePrecision && !isCUDA;
+    if (isMKL) {
+        mklDescription.type = SPARSE_MATRIX_TYPE_GENERAL;
+        mklDescription.mode = SPARSE_FILL_MODE_FULL;
+        mklDescription.diag = SPARSE_DIAG_NON_UNIT;
+        sparse_status_t status = mkl_sparse_d_create_csr(&mklMatrix, SPARSE_INDEX_BASE_ZERO,
+                numRows, numCols, matrix.rowPtr.data(), matrix.rowPtr.data() + 1,
+                matrix.cols.data(), matrix.values.data());
+        assert(status == SPARSE_STATUS_SUCCESS);
+        if (products != TRANSPOSE_PRODUCT)
+            mkl_sparse_set_mv_hint(mklMatrix, SPARSE_OPERATION_NON_TRANSPOSE, mklDescription,
+                    EXPECTED_NUM_CALLS);
+        if (products != MATRIX_PRODUCT)
+            mkl_sparse_set_mv_hint(mklMatrix, SPARSE_OPERATION_TRANSPOSE, mklDescription,
+                    EXPECTED_NUM_CALLS);
+        mkl_sparse_set_memory_hint(mklMatrix, SPARSE_MEMORY_AGGRESSIVE);
+        status = mkl_sparse_optimize(mklMatrix);
+        assert(status == SPARSE_STATUS_SUCCESS);
+        return;
+    }
+#endif
+    if (products == MATRIX_PRODUCT)
+        return;
+    // the transpose by a counting sort of the entries by their columns
+    vector<int> transposeRowPtr(numCols + 1, 0);
+    for (int k = 0; k < _rowPtr[numRows]; k++)
+        transposeRowPtr[matrix.cols[k] + 1]++;
+    for (int j = 0; j < numCols; j++)
+        transposeRowPtr[j + 1] += transposeRowPtr[j];
+    computeRowBlocks(&transposeRowPtr[0], numCols, transposeMatrix.rowBlocks);
+    rowPtrBlocks.assign(transposeMatrix.rowBlocks.begin(), transposeMatrix.rowBlocks.end());
+    rowPtrBlocks.back()++;
+    entryBlocks = getEntryBlocks(&transposeRowPtr[0], transposeMatrix.rowBlocks);
+    transposeMatrix.rowPtr.assign(&transposeRowPtr[0], rowPtrBlocks);
+    // the entries are scattered, their pages are placed by zeroing them first
+    transposeMatrix.cols.assignZeros(entryBlocks);
+    if (isSinglePrecision)
+        transposeMatrix.floatValues.assignZeros(entryBlocks);
+    else
+        transposeMatrix.values.assignZeros(entryBlocks);
+    vector<int> fill(transposeRowPtr.begin(), transposeRowPtr.end() - 1);
+    for (int i = 0; i < numRows; i++) {
+        for (int k = matrix.rowPtr[i]; k < matrix.rowPtr[i + 1]; k++) {
+            int pos = fill[matrix.cols[k]]++;
+            transposeMatrix.cols[pos] = i;
+            if (isSinglePrecision)
+                transposeMatrix.floatValues[pos] = matrix.floatValues[k];
+            else
+                transposeMatrix.values[pos] = matrix.values[k];
+        }
+    }
+    if (products == TRANSPOSE_PRODUCT)
+        matrix.clear();
+#ifdef USE_CUDA
+    // the transpose is stored as a matrix of its own, which cuSPARSE multiplies without atomics
+    if (isCUDA) {
+        if (products != TRANSPOSE_PRODUCT)
+            moveToDevice(numRows, numCols, matrix, deviceMatrix);
+        if (products != MATRIX_PRODUCT)
+            moveToDevice(numCols, numRows, transposeMatrix, deviceTransposeMatrix);
+    }
+#endif
+}
+
+CSRMatrix::~CSRMatrix() {
+#ifdef USE_INTEL_MKL
+    if (isMKL)
+        mkl_sparse_destroy(mklMatrix);
+#endif
+#ifdef USE_CUDA
+    DeviceArrays *deviceArrays[2] = { &deviceMatrix, &deviceTransposeMatrix };
+    for (int i = 0; i < 2; i++) {
+        if (deviceArrays[i]->description == NULL)
+            continue;
+        cusparseDestroySpMat(deviceArrays[i]->description);
+        cudaFree(deviceArrays[i]->rowPtr);
+        cudaFree(deviceArrays[i]->cols);
+        cudaFree(deviceArrays[i]->values);
+    }
+    cudaFree(deviceX);
+    cudaFree(deviceY);
+    cudaFree(deviceBuffer);
+    if (isCUDA)
+        cusparseDestroy(cusparseHandle);
+    omp_destroy_lock(&deviceLock);
+#endif
+}
+
+void CSRMatrix::computeRowBlocks(const int *rowPtr, int rows, std::vector<int> &rowBlocks) const {
+    int numEntries = rowPtr[rows];
+    rowBlocks.resize(numThreads + 1);
+    rowBlocks[0] = 0;
+    int row = 0;
+    for (int t = 1; t < numThreads; t++) {
+        // the first row after the share of entries of the threads before
+        long target = (long) numEntries * t / numThreads;
+        while (row < rows && rowPtr[row] < target)
+            row++;
+        rowBlocks[t] = row;
+    }
+    rowBlocks[numThreads] = rows;
+}
+
+std::vector<size_t> CSRMatrix::getEntryBlocks(const int *rowPtr, const std::vector<int> &rowBlocks) {
+    vector<size_t> entryBlocks(rowBlocks.size());
+    for (size_t t = 0; t < rowBlocks.size(); t++)
+        entryBlocks[t] = rowPtr[rowBlocks[t]];
+    return entryBlocks;
+}
+
+/***********************************************************************************************
+ * \brief Multiply the rows of a row block, the products are accumulated in double precision
+ ***********/
+template<class T>
+static void multiplyRowBlock(int firstRow, int endRow, const int *rowPtr, const int *cols,
+        const T *values, const double *X, double *Y, int numVecs) {
+    for (int i = firstRow; i < endRow; i++) {
+        double *y = &Y[(size_t) i * numVecs];
+        for (int k = 0; k < numVecs; k++)
+            y[k] = 0.0;
+        for (int e = rowPtr[i]; e < rowPtr[i + 1]; e++) {
+            const double value = values[e];
+            const double *x = &X[(size_t) cols[e] * numVecs];
+            for (int k = 0; k < numVecs; k++)
+                y[k] += value * x[k];
+        }
+    }
+}
+
+void CSRMatrix::multiplyRows(const Arrays &arrays, const double *X, double *Y, int numVecs) const {
+    const int *rowPtr = arrays.rowPtr.data();
+    const int *cols = arrays.cols.data();
+    const double *values = arrays.values.data();
+    const float *floatValues = arrays.floatValues.data();
+    // one row block per thread, the blocks hold about the same number of entries
+#pragma omp parallel for num_threads(numThreads) schedule(static, 1)
+    for (int t = 0; t < numThreads; t++) {
+        if (isSinglePrecision)
+            multiplyRowBlock(arrays.rowBlocks[t], arrays.rowBlocks[t + 1], rowPtr, cols,
+                    floatValues, X, Y, numVecs);
+        else
+            multiplyRowBlock(arrays.rowBlocks[t], arrays.rowBlocks[t + 1], rowPtr, cols, values, X,
+                    Y, numVecs);
+    }
+}
+
+#ifdef USE_CUDA
+void CSRMatrix::moveToDevice(int rows, int cols, Arrays &arrays, DeviceArrays &deviceArrays) {
+    const int numEntries = arrays.rowPtr[rows];
+    const size_t rowPtrSize = (rows + 1) * sizeof(int);
+    const size_t colsSize = numEntries * sizeof(int);
+    const size_t valuesSize = numEntries * sizeof(double);
+    cudaError_t error = cudaMalloc((void**) &deviceArrays.rowPtr, rowPtrSize);
+    assert(error == cudaSuccess);
+    error = cudaMalloc((void**) &deviceArrays.cols, colsSize);
+    assert(error == cudaSuccess);
+    error = cudaMalloc((void**) &deviceArrays.values, valuesSize);
+    assert(error == cudaSuccess);
+    cudaMemcpy(deviceArrays.rowPtr, arrays.rowPtr.data(), rowPtrSize, cudaMemcpyHostToDevice);
+    cudaMemcpy(deviceArrays.cols, arrays.cols.data(), colsSize, cudaMemcpyHostToDevice);
+    cudaMemcpy(deviceArrays.values, arrays.values.data(), valuesSize, cudaMemcpyHostToDevice);
+    cusparseStatus_t status = cusparseCreateCsr(&deviceArrays.description, rows, cols, numEntries,
+            deviceArrays.rowPtr, deviceArrays.cols, deviceArrays.values, CUSPARSE_INDEX_32I,
+            CUSPARSE_INDEX_32I, CUSPARSE_INDEX_BASE_ZERO, CUDA_R_64F);
+    assert(status == CUSPARSE_STATUS_SUCCESS);
+    arrays.clear();
+}
+
+void CSRMatrix::reserveDeviceMemory(size_t xSize, size_t ySize, size_t bufferSize) const {
+    if (xSize > deviceXSize) {
+        cudaFree(deviceX);
+        cudaError_t error = cudaMalloc((void**) &deviceX, xSize);
+        assert(error == cudaSuccess);
+        deviceXSize = xSize;
+    }
+    if (ySize > deviceYSize) {
+        cudaFree(deviceY);
+        cudaError_t error = cudaMalloc((void**) &deviceY, ySize);
+        assert(error == cudaSuccess);
+        deviceYSize = ySize;
+    }
+    if (bufferSize > deviceBufferSize) {
+        cudaFree(deviceBuffer);
+        cudaError_t error = cudaMalloc(&deviceBuffer, bufferSize);
+        assert(error == cudaSuccess);
+        deviceBufferSize = bufferSize;
+    }
+}
+
+void CSRMatrix::multiplyOnDevice(bool transpose, const double *X, double *Y, int numVecs) const {
+    const DeviceArrays &deviceArrays = transpose ? deviceTransposeMatrix : deviceMatrix;
+    const int rows = transpose ? numCols : numRows;
+    const int cols = transpose ? numRows : numCols;
+    const size_t xSize = (size_t) cols * numVecs * sizeof(double);
+    const size_t ySize = (size_t) rows * numVecs * sizeof(double);
+    const double alpha = 1.0;
+    const double beta = 0.0;
+    omp_set_lock(&deviceLock);
+    reserveDeviceMemory(xSize, ySize, 0);
+    cudaMemcpy(deviceX, X, xSize, cudaMemcpyHostToDevice);
+    cusparseStatus_t status;
+    if (numVecs == 1) {
+        cusparseDnVecDescr_t xDescription, yDescription;
+        cusparseCreateDnVec(&xDescription, cols, deviceX, CUDA_R_64F);
+        cusparseCreateDnVec(&yDescription, rows, deviceY, CUDA_R_64F);
+        size_t bufferSize = 0;
+        cusparseSpMV_bufferSize(cusparseHandle, CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
+                deviceArrays.description, xDescription, &beta, yDescription, CUDA_R_64F,
+                CUSPARSE_SPMV_ALG_DEFAULT, &bufferSize);
+        reserveDeviceMemory(0, 0, bufferSize);
+        status = cusparseSpMV(cusparseHandle, CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
+                deviceArrays.description, xDescription, &beta, yDescription, CUDA_R_64F,
+                CUSPARSE_SPMV_ALG_DEFAULT, deviceBuffer);
+        cusparseDestroyDnVec(xDescription);
+        cusparseDestroyDnVec(yDescription);
+    } else {
+        // the interleaved vectors are dense matrices in row major order
+        cusparseDnMatDescr_t xDescription, yDescription;
+        cusparseCreateDnMat(&xDescription, cols, numVecs, numVecs, deviceX, CUDA_R_64F,
+                CUSPARSE_ORDER_ROW);
+        cusparseCreateDnMat(&yDescription, rows, numVecs, numVecs, deviceY, CUDA_R_64F,
+                CUSPARSE_ORDER_ROW);
+        size_t bufferSize = 0;
+        cusparseSpMM_bufferSize(cusparseHandle, CUSPARSE_OPERATION_NON_TRANSPOSE,
+                CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha, deviceArrays.description, xDescription,
+                &beta, yDescription, CUDA_R_64F, CUSPARSE_SPMM_ALG_DEFAULT, &bufferSize);
+        reserveDeviceMemory(0, 0, bufferSize);
+        status = cusparseSpMM(cusparseHandle, CUSPARSE_OPERATION_NON_TRANSPOSE,
+                CUSPARSE_OPERATION_NON_TRANSPOSE, &alpha, deviceArrays.description, xDescription,
+                &beta, yDescription, CUDA_R_64F, CUSPARSE_SPMM_ALG_DEFAULT, deviceBuffer);
+        cusparseDestroyDnMat(xDescription);
+        cusparseDestroyDnMat(yDescription);
+    }
+    assert(status == CUSPARSE_STATUS_SUCCESS);
+    // the copy waits for the product
+    cudaMemcpy(Y, deviceY, ySize, cudaMemcpyDeviceToHost);
+    omp_unset_lock(&deviceLock);
+}
+#endif
+
+void CSRMatrix::multiply(bool transpose, const double *x, double *y) const {
+    assert(products == BOTH_PRODUCTS || (products == TRANSPOSE_PRODUCT) == transpose);
+#ifdef USE_CUDA
+    if (isCUDA) {
+        multiplyOnDevice(transpose, x, y, 1);
+        return;
+    }
+#endif
+#ifdef USE_INTEL_MKL
+    if (isMKL) {
+        mkl_sparse_d_mv(transpose ? SPARSE_OPERATION_TRANSPOSE : SPARSE_OPERATION_NON_TRANSPOSE,
+                1.0, mklMatrix, mklDescription, x, 0.0, y);
+        return;
+    }
+#endif
+    multiplyRows(transpose ? transposeMatrix : matrix, x, y, 1);
+}
+
+void CSRMatrix::multiplyBlock(bool transpose, const double *X, double *Y, int numVecs) const {
+    assert(products == BOTH_PRODUCTS || (products == TRANSPOSE_PRODUCT) == transpose);
+#ifdef USE_CUDA
+    if (isCUDA) {
+        multiplyOnDevice(transpose, X, Y, numVecs);
+        return;
+    }
+#endif
+#ifdef USE_INTEL_MKL
+    if (isMKL) {
+        mkl_sparse_d_mm(transpose ? SPARSE_OPERATION_TRANSPOSE : SPARSE_OPERATION_NON_TRANSPOSE,
+                1.0, mklMatrix, mklDescription, SPARSE_LAYOUT_ROW_MAJOR, X, numVecs, numVecs, 0.0,
+                Y, numVecs);
+        return;
+    }
+#endif
+    multiplyRows(transpose ? transposeMatrix : matrix, X, Y, numVecs);
+}
+
+int CSRMatrix::getColumnBound(int endRow) const {
+    assert(isRowRangeProductSupported() && endRow >= 0 && endRow <= numRows);
+    if (endRow == 0)
+        return 0;
+#pragma omp critical (CSRMatrixColumnBounds)
+    if (columnBounds.empty()) {
+        columnBounds.resize(numRows);
+        int bound = 0;
+        for (int i = 0; i < numRows; i++) {
+            for (int k = matrix.rowPtr[i]; k < matrix.rowPtr[i + 1]; k++)
+                bound = max(bound, matrix.cols[k] + 1);
+            columnBounds[i] = bound;
+        }
+    }
+    return columnBounds[endRow - 1];
+}
+
+void CSRMatrix::multiplyRowRange(const double *X, double *Y, int numVecs, int firstRow,
+        int endRow) const {
+    assert(isRowRangeProductSupported());
+    assert(firstRow >= 0 && firstRow <= endRow && endRow <= numRows);
+    const int *rowPtr = matrix.rowPtr.data();
+    const int *cols = matrix.cols.data();
+    const double *values = matrix.values.data();
+    const float *floatValues = matrix.floatValues.data();
+    // a range is short compared to the matrix, so it is split into equal numbers of rows
+    const int rows = endRow - firstRow;
+#pragma omp parallel for num_threads(numThreads) schedule(static, 1)
+    for (int t = 0; t < numThreads; t++) {
+        int begin = firstRow + (int) ((long) rows * t / numThreads);
+        int end = firstRow + (int) ((long) rows * (t + 1) / numThreads);
+        if (isSinglePrecision)
+            multiplyRowBlock(begin, end, rowPtr, cols, floatValues, X, Y, numVecs);
+        else
+            multiplyRowBlock(begin, end, rowPtr, cols, values, X, Y, numVecs);
+    }
+}
+
+/***********************************************************************************************
+ * \brief Multiply the rows of a row block which have an entry in a changed column
+ * \return the number of multiplied rows
+ ***********/
+template<class T>
+static int multiplyChangedRowBlock(int firstRow, int endRow, const int *rowPtr, const int *cols,
+        const T *values, const char *isColumnChanged, const double *X, double *Y, int numVecs) {
+    int numChangedRows = 0;
+    for (int i = firstRow; i < endRow; i++) {
+        bool isRowChanged = false;
+        for (int e = rowPtr[i]; e < rowPtr[i + 1] && !isRowChanged; e++)
+            isRowChanged = isColumnChanged[cols[e]] != 0;
+        if (isRowChanged) {
+            multiplyRowBlock(i, i + 1, rowPtr, cols, values, X, Y, numVecs);
+            numChangedRows++;
+        }
+    }
+    return numChangedRows;
+}
+
+int CSRMatrix::multiplyChangedRows(const double *X, double *Y, int numVecs,
+        const char *isColumnChanged) const {
+    assert(isRowRangeProductSupported());
+    const int *rowPtr = matrix.rowPtr.data();
+    const int *cols = matrix.cols.data();
+    const double *values = matrix.values.data();
+    const float *floatValues = matrix.floatValues.data();
+    int numChangedRows = 0;
+#pragma omp parallel for num_threads(numThreads) schedule(static, 1) reduction(+:numChangedRows)
+    for (int t = 0; t < numThreads; t++) {
+        int begin = (int) ((long) numRows * t / numThreads);
+        int end = (int) ((long) numRows * (t + 1) / numThreads);
+        if (isSinglePrecision)
+            numChangedRows += multiplyChangedRowBlock(begin, end, rowPtr, cols, floatValues,
+                    isColumnChanged, X, Y, numVecs);
+        else
+            numChangedRows += multiplyChangedRowBlock(begin, end, rowPtr, cols, values,
+                    isColumnChanged, X, Y, numVecs);
+    }
+    return numChangedRows;
+}
+
+/***********************************************************************************************
+ * \brief Get the heap memory of the arrays of a matrix
+ ***********/
+size_t CSRMatrix::Arrays::getMemoryUsage() const {
+    return rowPtr.getMemoryUsage() + cols.getMemoryUsage() + values.getMemoryUsage()
+            + floatValues.getMemoryUsage() + MemoryUsage::ofVector(rowBlocks);
+}
+
+void CSRMatrix::Arrays::clear() {
+    rowPtr.clear();
+    cols.clear();
+    values.clear();
+    floatValues.clear();
+    rowBlocks.clear();
+}
+
+void CSRMatrix::getEntries(std::vector<int> &rowPtr, std::vector<int> &cols,
+        std::vector<double> &values) const {
+    // the kept arrays, the transpose has numCols rows
+    bool isTransposed = matrix.rowPtr.empty();
+    int rows = isTransposed ? numCols : numRows;
+    vector<int> keptRowPtr(rows + 1);
+    vector<int> keptCols;
+    vector<double> keptValues;
+#ifdef USE_CUDA
+    if (isCUDA) {
+        const DeviceArrays &deviceArrays =
+                deviceMatrix.description != NULL ? deviceMatrix : deviceTransposeMatrix;
+        isTransposed = deviceMatrix.description == NULL;
+        rows = isTransposed ? numCols : numRows;
+        keptRowPtr.resize(rows + 1);
+        cudaMemcpy(&keptRowPtr[0], deviceArrays.rowPtr, (rows + 1) * sizeof(int),
+                cudaMemcpyDeviceToHost);
+        keptCols.resize(keptRowPtr[rows]);
+        keptValues.resize(keptRowPtr[rows]);
+        if (!keptCols.empty()) {
+            cudaMemcpy(&keptCols[0], deviceArrays.cols, keptCols.size() * sizeof(int),
+                    cudaMemcpyDeviceToHost);
+            cudaMemcpy(&keptValues[0], deviceArrays.values, keptValues.size() * sizeof(double),
+                    cudaMemcpyDeviceToHost);
+        }
+    } else
+#endif
+    {
+        const Arrays &arrays = isTransposed ? transposeMatrix : matrix;
+        keptRowPtr.assign(arrays.rowPtr.data(), arrays.rowPtr.data() + rows + 1);
+        keptCols.assign(arrays.cols.data(), arrays.cols.data() + keptRowPtr[rows]);
+        keptValues.resize(keptRowPtr[rows]);
+        for (int k = 0; k < keptRowPtr[rows]; k++)
+            keptValues[k] = isSinglePrecision ? arrays.floatValues[k] : arrays.values[k];
+    }
+    if (!isTransposed) {
+        rowPtr.swap(keptRowPtr);
+        cols.swap(keptCols);
+        values.swap(keptValues);
+        return;
+    }
+    // the matrix by a counting sort of the entries of the transpose by their columns
+    rowPtr.assign(numRows + 1, 0);
+    for (size_t k = 0; k < keptCols.size(); k++)
+        rowPtr[keptCols[k] + 1]++;
+    for (int i = 0; i < numRows; i++)
+        rowPtr[i + 1] += rowPtr[i];
+    cols.resize(keptCols.size());
+    values.resize(keptCols.size());
+    vector<int> fill(rowPtr.begin(), rowPtr.end() - 1);
+    for (int j = 0; j < numCols; j++) {
+        for (int k = keptRowPtr[j]; k < keptRowPtr[j + 1]; k++) {
+            int pos = fill[keptCols[k]]++;
+            cols[pos] = j;
+            values[pos] = keptValues[k];
+        }
+    }
+}
+
+MemoryUsage CSRMatrix::getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.add("matrix", matrix.getMemoryUsage());
+    usage.add("transpose", transposeMatrix.getMemoryUsage());
+    usage.add("column bounds", MemoryUsage::ofVector(columnBounds));
+    return usage;
+}
+
+} /* namespace MathLibrary */
+} /* namespace EMPIRE */
@@ -0,0 +1,283 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file CSRMatrix.h
+ * This file holds the class CSRMatrix
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef CSRMATRIX_H_
+#define CSRMATRIX_H_
+
+#include <vector>
+#include "MemoryUsage.h"
+#include "NumaMemory.h"
+#ifdef USE_INTEL_MKL
+#include <mkl_spblas.h>
+#endif
+#ifdef USE_CUDA
+#include <omp.h>
+#include <cusparse.h>
+#endif
+
+namespace EMPIRE {
+namespace MathLibrary {
+
+/********//**
+ * \brief Class CSRMatrix is an immutable sparse matrix in zero-based CSR format for the repeated
+ *        products of the mappers. The matrix is analysed once at construction: with MKL it is
+ *        handed to the inspector-executor interface with hints for many products, otherwise the
+ *        rows are split into blocks of equal numbers of entries, one per thread, and the
+ *        transpose is stored, so that both products are gathers without atomics.
+ *        Optionally the values are stored in single precision, which halves the memory traffic of
+ *        the products, e.g. for interpolation weights. The products accumulate in double precision.
+ *        A matrix used in one direction only keeps the arrays of that product.
+ *        The arrays of a row block are first touched by the thread multiplying it, such that the
+ *        products read local memory on NUMA systems.
+ *        With CUDA, large double precision matrices are moved to the GPU once and multiplied by
+ *        cuSPARSE, only the vectors are copied for every product.
+ ***********/
+class CSRMatrix {
+public:
+    /// the products a matrix is built for
+    enum Products {
+        /// A * x and A^T * x
+        BOTH_PRODUCTS,
+        /// A * x only
+        MATRIX_PRODUCT,
+        /// A^T * x only
+        TRANSPOSE_PRODUCT
+    };
+    /***********************************************************************************************
+     * \brief Get the products needed by a mapper whose consistent mapping multiplies with A and
+     *        whose conservative mapping multiplies with A^T
+     * \param[in] consistent whether the consistent mapping is used
+     * \param[in] conservative whether the conservative mapping is used
+     ***********/
+    static Products getProducts(bool consistent, bool conservative) {
+        if (consistent && !conservative)
+            return MATRIX_PRODUCT;
+        if (conservative && !consistent)
+            return TRANSPOSE_PRODUCT;
+        return BOTH_PRODUCTS;
+    }
+    /***********************************************************************************************
+     * \brief Constructor, copies and analyses the matrix
+     * \param[in] _numRows number of rows
+     * \param[in] _numCols number of columns
+     * \param[in] _rowPtr the entries of row i are at the positions _rowPtr[i] to _rowPtr[i+1]-1
+     * \param[in] _cols the column of each entry
+     * \param[in] _values the value of each entry
+     * \param[in] _numThreads the number of threads of the products
+     * \param[in] _isSinglePrecision whether the values are stored in single precision
+     * \param[in] _products the products the matrix is used for, only their arrays are kept
+     ***********/
+    CSRMatrix(int _numRows, int _numCols, const std::vector<int> &_rowPtr,
+            const std::vector<int> &_cols, const std::vector<double> &_values, int _numThreads,
+            bool _isSinglePrecision = false, Products _products = BOTH_PRODUCTS);
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~CSRMatrix();
+    /***********************************************************************************************
+     * \brief Compute y = A * x or y = A^T * x
+     * \param[in] transpose whether the transpose is multiplied
+     * \param[in] x the vector of size numCols (numRows if transposed)
+     * \param[out] y the vector of size numRows (numCols if transposed)
+     ***********/
+    virtual void multiply(bool transpose, const double *x, double *y) const;
+    /***********************************************************************************************
+     * \brief Multiply several vectors at once, Y = A * X or Y = A^T * X
+     * \param[in] transpose whether the transpose is multiplied
+     * \param[in] X interleaved vectors, entry i of vector k is X[i * numVecs + k]
+     * \param[out] Y interleaved result vectors
+     * \param[in] numVecs number of vectors
+     ***********/
+    virtual void multiplyBlock(bool transpose, const double *X, double *Y, int numVecs) const;
+    /***********************************************************************************************
+     * \brief Whether the products of row ranges are supported, which is not the case if the
+     *        matrix is on the device or only its transpose is kept
+     ***********/
+    virtual bool isRowRangeProductSupported() const {
+        return !isCUDA && products != TRANSPOSE_PRODUCT;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of leading entries of x the rows before endRow depend on, i.e. one
+     *        more than their largest column
+     * \param[in] endRow the end of the leading rows
+     ***********/
+    int getColumnBound(int endRow) const;
+    /***********************************************************************************************
+     * \brief Compute the rows firstRow to endRow-1 of Y = A * X, the other rows of Y are untouched
+     * \param[in] X interleaved vectors, only the entries below getColumnBound(endRow) are read
+     * \param[out] Y interleaved result vectors
+     * \param[in] numVecs number of vectors
+     * \param[in] firstRow the first row
+     * \param[in] endRow the end of the rows
+     ***********/
+    void multiplyRowRange(const double *X, double *Y, int numVecs, int firstRow, int endRow) const;
+    /***********************************************************************************************
+     * \brief Compute the rows of Y = A * X which have an entry in a changed column, the other rows
+     *        of Y are untouched
+     * \param[in] X interleaved vectors
+     * \param[in,out] Y interleaved result vectors, holding A * X of the unchanged X before
+     * \param[in] numVecs number of vectors
+     * \param[in] isColumnChanged whether the entries of x of a column have changed
+     * \return the number of computed rows
+     ***********/
+    int multiplyChangedRows(const double *X, double *Y, int numVecs,
+            const char *isColumnChanged) const;
+    /***********************************************************************************************
+     * \brief Get the number of rows
+     ***********/
+    int getNumRows() const {
+        return numRows;
+    }
+    /***********************************************************************************************
+     * \brief Get the number of columns
+     ***********/
+    int getNumCols() const {
+        return numCols;
+    }
+    /***********************************************************************************************
+     * \brief Get a copy of the matrix in CSR format, whichever of the matrix and its transpose is
+     *        kept
+     * \param[out] rowPtr the row pointers, numRows+1 entries
+     * \param[out] cols the column of every entry
+     * \param[out] values the value of every entry
+     ***********/
+    virtual void getEntries(std::vector<int> &rowPtr, std::vector<int> &cols,
+            std::vector<double> &values) const;
+    /***********************************************************************************************
+     * \brief Get the heap memory of the matrix and its transpose
+     ***********/
+    MemoryUsage getMemoryUsage() const;
+
+private:
+    /********//**
+     * \brief The arrays of a matrix in CSR format with its row blocks
+     ***********/
+    struct Arrays {
+        NumaArray<int> rowPtr;
+        NumaArray<int> cols;
+        NumaArray<double> values;
+        /// the values in single precision, used instead of values
+        NumaArray<float> floatValues;
+        /// thread t multiplies the rows rowBlocks[t] to rowBlocks[t+1]-1
+        std::vector<int> rowBlocks;
+        void clear();
+        size_t getMemoryUsage() const;
+    };
+    /***********************************************************************************************
+     * \brief Split the rows into blocks of about equal numbers of entries
+     * \param[in] rowPtr the row pointers of the matrix
+     * \param[in] rows the number of rows
+     * \param[out] rowBlocks the first row of every thread and the number of rows at the end
+     ***********/
+    void computeRowBlocks(const int *rowPtr, int rows, std::vector<int> &rowBlocks) const;
+    /***********************************************************************************************
+     * \brief Get the first entry of every row block and the number of entries at the end
+     ***********/
+    static std::vector<size_t> getEntryBlocks(const int *rowPtr, const std::vector<int> &rowBlocks);
+    /***********************************************************************************************
+     * \brief Multiply the vectors with the matrix in the arrays by the row blocks
+     ***********/
+    void multiplyRows(const Arrays &arrays, const double *X, double *Y, int numVecs) const;
+#ifdef USE_CUDA
+    /********//**
+     * \brief A matrix in CSR format in device memory
+     ***********/
+    struct DeviceArrays {
+        int *rowPtr;
+        int *cols;
+        double *values;
+        /// the cuSPARSE description of the arrays, NULL if the matrix is not on the device
+        cusparseSpMatDescr_t description;
+    };
+    /***********************************************************************************************
+     * \brief Copy the arrays to the device and free them on the host
+     * \param[in] rows the number of rows of the arrays
+     * \param[in] cols the number of columns of the arrays
+     * \param[in,out] arrays the arrays on the host, cleared afterwards
+     * \param[out] deviceArrays the arrays on the device
+     ***********/
+    void moveToDevice(int rows, int cols, Arrays &arrays, DeviceArrays &deviceArrays);
+    /***********************************************************************************************
+     * \brief Multiply the vectors on the device, they are copied from and to the host
+     ***********/
+    void multiplyOnDevice(bool transpose, const double *X, double *Y, int numVecs) const;
+    /***********************************************************************************************
+     * \brief Enlarge the device memory of a product if needed
+     ***********/
+    void reserveDeviceMemory(size_t xSize, size_t ySize, size_t bufferSize) const;
+#endif
+
+    /// number of rows
+    int numRows;
+    /// number of columns
+    int numCols;
+    /// number of threads
+    int numThreads;
+    /// whether the values are stored in single precision
+    bool isSinglePrecision;
+    /// the products the matrix is used for
+    Products products;
+    /// whether the products are done by MKL
+    bool isMKL;
+    /// whether the products are done by cuSPARSE
+    bool isCUDA;
+    /// the matrix, empty if only the transpose is multiplied by the own kernels
+    Arrays matrix;
+    /// the transpose, empty if the products are done by MKL or only the matrix is multiplied
+    Arrays transposeMatrix;
+    /// columnBounds[i] is getColumnBound(i + 1), computed at the first call
+    mutable std::vector<int> columnBounds;
+#ifdef USE_INTEL_MKL
+    /// the handle of the analysed matrix
+    sparse_matrix_t mklMatrix;
+    /// the description of the matrix
+    struct matrix_descr mklDescription;
+#endif
+#ifdef USE_CUDA
+    /// the cuSPARSE context
+    cusparseHandle_t cusparseHandle;
+    /// the matrix on the device
+    DeviceArrays deviceMatrix;
+    /// the transpose on the device
+    DeviceArrays deviceTransposeMatrix;
+    /// the device vectors and work buffer, which are reused by the products
+    mutable double *deviceX;
+    mutable double *deviceY;
+    mutable void *deviceBuffer;
+    /// the capacities of deviceX, deviceY and deviceBuffer in bytes
+    mutable size_t deviceXSize;
+    mutable size_t deviceYSize;
+    mutable size_t deviceBufferSize;
+    /// the products on the device share the device memory
+    mutable omp_lock_t deviceLock;
+#endif
+    CSRMatrix(const CSRMatrix&);
+    CSRMatrix& operator=(const CSRMatrix&);
+};
+
+} /* namespace MathLibrary */
+} /* namespace EMPIRE */
+
+#endif /* CSRMATRIX_H_ */
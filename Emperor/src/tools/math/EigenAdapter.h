@@ -26,6 +26,9 @@
 // Including the Eigen header
 #include <Sparse>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include "Message.h"
 namespace EMPIRE {
 namespace MathLibrary {
 
@@ -40,11 +43,20 @@ class EigenAdapter {
 	// Defining the definition of sparse matrix.
 	typedef Eigen::SparseMatrix<T,Eigen::RowMajor> SpMat; // declares a column-major sparse matrix type of double
 	//typedef Eigen::SparseMatrix<double> SpMat; // declares a column-major sparse matrix type of double
+	// Dense block of vectors stored interleaved, i.e. one row per matrix row and one column per vector
+	typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> DenseBlock;
+	// Dense block of vectors stored one after the other as expected by the solvers
+	typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> DenseColBlock;
 
 #ifdef EIGEN_ITERATIVE
 	typedef Eigen::BiCGSTAB<SpMat> SpCgSolver;
 #else
 	typedef Eigen::SparseQR< SpMat, Eigen::NaturalOrdering<int> > SpSolver;
+	// Column-major copy of a symmetric matrix as expected by the Cholesky solver
+	typedef Eigen::SparseMatrix<T, Eigen::ColMajor> ColSpMat;
+	// LDL^T solver of symmetric positive definite matrices with a fill-reducing ordering, only the
+	// upper triangular part is read
+	typedef Eigen::SimplicialLDLT<ColSpMat, Eigen::Upper, Eigen::AMDOrdering<int> > SpdSolver;
 #endif
 
 private:
@@ -59,28 +71,41 @@ private:
 	// Bool values to save the state
 	bool isFactorized, isAnalyzed, isCompressed;
 
+	// Whether the matrix is symmetric, it is stored full
+	bool isSymmetric;
+
+	// Compressed pattern of the analyzed matrix, used to detect a change of the sparsity pattern
+	std::vector<int> analyzedOuterIndex, analyzedInnerIndex;
+
 #ifdef EIGEN_ITERATIVE
 	SpCgSolver *solver;
 #else
 	// QR Solver for the sparse matrix system.
 	// QR is chosen to accommodate rectangular matrix.
 	SpSolver *solver;
+
+	// Cholesky solver of symmetric matrices, NULL for unsymmetric matrices or if the matrix turned
+	// out not to be positive definite, then the QR solver is used
+	SpdSolver *spdSolver;
 #endif
 
 public:
 	/***********************************************************************************************
-	 * \brief Constructor for unsymmetric matrices
+	 * \brief Constructor
 	 * \param[in] _m is the number of rows
 	 * \param[in] _n is the number of columns
+	 * \param[in] _isSymmetric the matrix is symmetric (and stored full), it is factorized by a sparse
+	 *            Cholesky decomposition instead of QR
 	 * \author Aditya Ghantasala
 	 ***********/
-	EigenAdapter(size_t i_m, size_t i_n):m(i_m),n(i_n){
+	EigenAdapter(size_t i_m, size_t i_n, bool _isSymmetric = false):m(i_m),n(i_n),isSymmetric(_isSymmetric){
 		A = new SpMat(m,n);
 		determineCSR(); // The matrix should be in compressed mode for the solver to initiate.
 #ifdef EIGEN_ITERATIVE
 		solver = new SpCgSolver();
 #else
 		solver = new SpSolver((*A));
+		spdSolver = isSymmetric ? new SpdSolver() : NULL;
 #endif
 		isFactorized = false;
 		isAnalyzed = false;
@@ -94,6 +119,9 @@ public:
     virtual ~EigenAdapter() {
     	delete A;
     	delete solver;
+#ifndef EIGEN_ITERATIVE
+    	delete spdSolver;
+#endif
     }
 
 	/***********************************************************************************************
@@ -112,8 +140,8 @@ public:
 	 * \param[in] j is the number of columns
 	 * \author Aditya Ghantasala
 	 ***********/
-	inline T& operator()(size_t i, size_t j) const {
-		return A->coeffRef(i,j);
+	inline T operator()(size_t i, size_t j) const {
+		return A->coeff(i,j);
 	}
 
 
@@ -128,7 +156,51 @@ public:
 		}
 	}
 
+	/***********************************************************************************************
+	 * \brief Compresses the matrix and releases the reserved but unused storage of the assembly
+	 ***********/
+	void freeze(){
+		A->makeCompressed();
+		A->data().squeeze();
+		isCompressed = true;
+	}
+
+	/***********************************************************************************************
+	 * \brief Mirrors the upper triangular part to the lower one, the entries below the diagonal are
+	 *        replaced
+	 ***********/
+	void mirrorUpperToLower(){
+		SpMat full = A->template selfadjointView<Eigen::Upper>();
+		A->swap(full);
+		isCompressed = false;
+		determineCSR();
+		isFactorized = false;
+	}
+
+
 
+	/***********************************************************************************************
+	 * \brief Copies the entries in zero-based CSR format
+	 * \param[out] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+	 * \param[out] cols the column of each entry
+	 * \param[out] vals the value of each entry
+	 * \param[in] upperOnly copy only the upper triangular part
+	 ***********/
+	void getCSR(std::vector<int>& rowPtr, std::vector<int>& cols, std::vector<T>& vals, bool upperOnly) {
+		determineCSR();
+		rowPtr.assign(1, 0);
+		cols.clear();
+		vals.clear();
+		for (int i = 0; i < m; i++) {
+			for (typename SpMat::InnerIterator it((*A), i); it; ++it) {
+				if (upperOnly && it.col() < i)
+					continue;
+				cols.push_back(it.col());
+				vals.push_back(it.value());
+			}
+			rowPtr.push_back(cols.size());
+		}
+	}
 
 	/***********************************************************************************************
 	 * \brief This function is a fast alternative to the operator overloading alternative
@@ -141,35 +213,89 @@ public:
 	void mulitplyVec(bool transpose, T* vec, T* resultVec, size_t elements) { //Computes resultVec=A*vec
 		assert(elements == m);
 
-		// TODO This is a very naive implementation. Improve it.
-
+		determineCSR();
 		if(transpose == false){
-			Eigen::VectorXd b(n);
-			for(int i=0; i<n; i++){
-				b(i) = vec[i];
-			}
-
-			Eigen::VectorXd y = (*A) * (b);
+			Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1> > b(vec, n);
+			Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1> > y(resultVec, m);
+			y.noalias() = (*A) * b;
+		}else{
+			Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1> > b(vec, m);
+			Eigen::Map<Eigen::Matrix<T, Eigen::Dynamic, 1> > y(resultVec, n);
+			y.noalias() = A->transpose() * b;
+		}
+	}
 
-			for(int i=0; i<m; i++){
-				resultVec[i] = y(i);
-			}
-			return;
+	/***********************************************************************************************
+	 * \brief Multiplies the matrix with several vectors at once, Y = A * X or Y = A^T * X
+	 * \param[in] 	-- transpose 	Bool flag specifying if a transpose of the matrix should be multiplied or not.
+	 * \param[in] 	-- X 			Interleaved vectors to be multiplied, entry i of vector k is X[i * numVecs + k]
+	 * \param[out] 	-- Y 			Interleaved result vectors
+	 * \param[in] 	-- numVecs 		Number of vectors stored in X and Y
+	 ***********/
+	void multiplyBlock(bool transpose, const T* X, T* Y, size_t numVecs) {
+		if(transpose == false){
+			Eigen::Map<const DenseBlock> x(X, n, numVecs);
+			Eigen::Map<DenseBlock> y(Y, m, numVecs);
+			y = (*A) * x;
 		}else{
+			Eigen::Map<const DenseBlock> x(X, m, numVecs);
+			Eigen::Map<DenseBlock> y(Y, n, numVecs);
+			y = A->transpose() * x;
+		}
+	}
 
-			Eigen::VectorXd b(m);
-			for(int i=0; i<m; i++){
-				b(i) = vec[i];
-			}
+    /***********************************************************************************************
+     * \brief Adds the entries of several sorted triplet buffers to the matrix
+     * \param[in] buffers the triplet buffers, duplicated entries are summed up
+     ***********/
+    template<class Triplet>
+    void addTriplets(const std::vector<std::vector<Triplet> >& buffers) {
+    	size_t numTriplets = 0;
+    	for (size_t b = 0; b < buffers.size(); b++)
+    		numTriplets += buffers[b].size();
+    	std::vector<Eigen::Triplet<T> > triplets;
+    	triplets.reserve(numTriplets);
+    	for (size_t b = 0; b < buffers.size(); b++)
+    		for (size_t k = 0; k < buffers[b].size(); k++)
+    			triplets.push_back(Eigen::Triplet<T>(buffers[b][k].row, buffers[b][k].column, buffers[b][k].value));
+    	SpMat B(m, n);
+    	B.setFromTriplets(triplets.begin(), triplets.end());
+    	if (A->nonZeros() == 0)
+    		A->swap(B);
+    	else
+    		*A += B;
+    	isCompressed = false;
+    	isFactorized = false;
+    }
 
-			Eigen::VectorXd y  = SpMat(A->transpose()) * (b);
-			for(int i=0; i<n; i++){
-				resultVec[i] = y(i);
-			}
+    /***********************************************************************************************
+     * \brief Replaces the matrix by the sparsity pattern in zero-based CSR format with all values zero
+     * \param[in] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+     * \param[in] cols the sorted columns of the entries of every row
+     ***********/
+    void setPattern(const std::vector<int>& rowPtr, const std::vector<int>& cols) {
+    	std::vector<T> zeros(cols.size(), 0);
+    	SpMat B = Eigen::Map<const SpMat>(m, n, cols.size(), &rowPtr[0],
+    			cols.empty() ? NULL : &cols[0], zeros.empty() ? NULL : &zeros[0]);
+    	A->swap(B);
+    	isCompressed = true;
+    	isFactorized = false;
+    }
 
-			return;
-		}
-	}
+    /***********************************************************************************************
+     * \brief Returns the value of an existing entry of the compressed matrix, unlike operator() no
+     *        entry is inserted, so that several threads may access the matrix
+     * \param[in] i the row of the entry
+     * \param[in] j the column of the entry
+     ***********/
+    T& getEntry(size_t i, size_t j) {
+    	assert(isCompressed);
+    	const int *first = A->innerIndexPtr() + A->outerIndexPtr()[i];
+    	const int *last = A->innerIndexPtr() + A->outerIndexPtr()[i + 1];
+    	const int *entry = std::lower_bound(first, last, (int)j);
+    	assert(entry != last && *entry == (int)j);
+    	return A->valuePtr()[entry - A->innerIndexPtr()];
+    }
 
     /***********************************************************************************************
      * \brief This function resizes the sparse matrix to given sizes
@@ -276,7 +402,8 @@ public:
     	for(int i=0; i<m; i++)
     		RHS(i) = b[i];
 
-    	Eigen::VectorXd x1 = solver->solve(RHS);
+    	Eigen::VectorXd x1 = (spdSolver != NULL) ? Eigen::VectorXd(spdSolver->solve(RHS))
+    			: Eigen::VectorXd(solver->solve(RHS));
 
     	for(int j=0; j<n; j++)
     		x[j] = x1(j);
@@ -284,6 +411,70 @@ public:
 #endif
     }
 
+    /***********************************************************************************************
+     * \brief This function solves for several right hand sides with one call to the solver, A * X = B
+     * \param[out] 	-- X 			Interleaved solution vectors, entry i of vector k is X[i * numVecs + k]
+     * \param[in]  	-- B 			Interleaved right hand side vectors
+     * \param[in] 	-- numVecs 		Number of right hand sides stored in B
+     ***********/
+	void solveBlock(T* X, const T* B, size_t numVecs) {
+        if(!isCompressed)
+            determineCSR();
+#ifdef EIGEN_ITERATIVE
+        if(!isFactorized) {
+            solver->compute(*A);
+            isFactorized = 1;
+        }
+#else
+        if(!isFactorized)
+            factorize();
+#endif
+        DenseColBlock RHS = Eigen::Map<const DenseBlock>(B, m, numVecs);
+#ifdef EIGEN_ITERATIVE
+        DenseColBlock sol = solver->solve(RHS);
+#else
+        DenseColBlock sol;
+        if (spdSolver != NULL)
+            sol = spdSolver->solve(RHS);
+        else
+            sol = solver->solve(RHS);
+#endif
+        Eigen::Map<DenseBlock>(X, n, numVecs) = sol;
+	}
+
+
+    /***********************************************************************************************
+     * \brief Solve the transposed system A^T * X = B with the factorization of A. With A * P = Q * R
+     *        of the QR solver, X = Q * R^(-T) * P^T * B. A symmetric matrix is its own transpose.
+     * \param[out] 	-- X 			Interleaved solution vectors, entry i of vector k is X[i * numVecs + k]
+     * \param[in]  	-- B 			Interleaved right hand side vectors
+     * \param[in] 	-- numVecs 		Number of right hand sides stored in B
+     ***********/
+	void solveTranspose(T* X, const T* B, size_t numVecs) {
+        assert(m == n);
+        if(!isCompressed)
+            determineCSR();
+        DenseColBlock RHS = Eigen::Map<const DenseBlock>(B, m, numVecs);
+#ifdef EIGEN_ITERATIVE
+        // the iterative solver has no factorization to reuse
+        SpMat transposeA = A->transpose();
+        SpCgSolver transposeSolver(transposeA);
+        DenseColBlock sol = transposeSolver.solve(RHS);
+#else
+        if(!isFactorized)
+            factorize();
+        if (spdSolver != NULL) {
+            DenseColBlock sol = spdSolver->solve(RHS);
+            Eigen::Map<DenseBlock>(X, n, numVecs) = sol;
+            return;
+        }
+        DenseColBlock permuted = solver->colsPermutation().transpose() * RHS;
+        DenseColBlock rInvT = solver->matrixR().topLeftCorner(n, n).transpose().template triangularView<
+                Eigen::Lower>().solve(permuted);
+        DenseColBlock sol = solver->matrixQ() * rInvT;
+#endif
+        Eigen::Map<DenseBlock>(X, n, numVecs) = sol;
+	}
 
     /***********************************************************************************************
      * \brief This function factorizes and prepares for a solution
@@ -292,14 +483,114 @@ public:
     void factorize() {
         if(!isCompressed)
             determineCSR();
-    	// Compute the ordering permutation vector from the structural pattern of A
-    	solver->analyzePattern((*A));
+#ifndef EIGEN_ITERATIVE
+        if (spdSolver != NULL && factorizeSymmetric())
+            return;
+#endif
+    	// Compute the ordering permutation vector from the structural pattern of A, it is kept as
+    	// long as the pattern does not change
+    	if (!isAnalyzed || !isAnalyzedPattern()) {
+    		solver->analyzePattern((*A));
+    		analyzedOuterIndex.assign(A->outerIndexPtr(), A->outerIndexPtr() + m + 1);
+    		analyzedInnerIndex.assign(A->innerIndexPtr(), A->innerIndexPtr() + A->nonZeros());
+    	}
     	// Compute the numerical factorization
     	solver->factorize((*A));
     	isFactorized = true;
     	isAnalyzed = true;
     }
 
+#ifndef EIGEN_ITERATIVE
+    /***********************************************************************************************
+     * \brief Factorizes a symmetric matrix by the Cholesky solver. The fill-reducing ordering and
+     *        the symbolic factorization are kept as long as the pattern does not change. If the
+     *        matrix is not positive definite, the Cholesky solver is dropped for good.
+     * \return true if the matrix is factorized, false if the QR solver has to be used
+     ***********/
+    bool factorizeSymmetric() {
+        ColSpMat colA = (*A);
+        if (!isAnalyzed || !isAnalyzedPattern()) {
+            spdSolver->analyzePattern(colA);
+            analyzedOuterIndex.assign(A->outerIndexPtr(), A->outerIndexPtr() + m + 1);
+            analyzedInnerIndex.assign(A->innerIndexPtr(), A->innerIndexPtr() + A->nonZeros());
+        }
+        spdSolver->factorize(colA);
+        bool isPositiveDefinite = (spdSolver->info() == Eigen::Success);
+        // the pivots of an LDL^T decomposition of a positive definite matrix are positive
+        if (isPositiveDefinite)
+            isPositiveDefinite = (spdSolver->vectorD().array() > 0).all();
+        if (!isPositiveDefinite) {
+            WARNING_OUT() << "EigenAdapter::factorize: the symmetric matrix is not positive "
+                    << "definite, it is factorized by QR" << std::endl;
+            delete spdSolver;
+            spdSolver = NULL;
+            isAnalyzed = false;
+            return false;
+        }
+        isFactorized = true;
+        isAnalyzed = true;
+        return true;
+    }
+#endif
+
+    /***********************************************************************************************
+     * \brief Get the number of stored entries
+     ***********/
+    size_t getNumNonZeros() const {
+        return A->nonZeros();
+    }
+
+    /***********************************************************************************************
+     * \brief Get the heap memory of the compressed matrix
+     * \return the number of bytes
+     ***********/
+    size_t getMatrixMemory() const {
+        return A->nonZeros() * (sizeof(T) + sizeof(int)) + (A->outerSize() + 1) * sizeof(int);
+    }
+
+    /***********************************************************************************************
+     * \brief Get the heap memory of the factorization (the L factor of the Cholesky decomposition,
+     *        the R factor of the QR decomposition or the work vectors of the iterative solver) and of
+     *        the analyzed pattern
+     * \return the number of bytes, 0 if nothing is factorized
+     ***********/
+    size_t getFactorMemory() const {
+        if (!isFactorized)
+            return 0;
+        size_t patternBytes = (analyzedOuterIndex.capacity() + analyzedInnerIndex.capacity()) * sizeof(int);
+#ifdef EIGEN_ITERATIVE
+        return patternBytes + (size_t) n * sizeof(T);
+#else
+        if (spdSolver != NULL) {
+            const ColSpMat &L = spdSolver->matrixL().nestedExpression();
+            return patternBytes + L.nonZeros() * (sizeof(T) + sizeof(int))
+                    + (L.outerSize() + 1) * sizeof(int) + (size_t) n * (sizeof(T) + 2 * sizeof(int));
+        }
+        return patternBytes + solver->matrixR().nonZeros() * (sizeof(T) + sizeof(int))
+                + (solver->matrixR().outerSize() + 1) * sizeof(int);
+#endif
+    }
+
+
+    /***********************************************************************************************
+     * \brief Checks whether the compressed matrix has the sparsity pattern of the last analysis
+     * \return true if the pattern is the same
+     ***********/
+    bool isAnalyzedPattern() const {
+    	if ((int) analyzedOuterIndex.size() != m + 1 || (int) analyzedInnerIndex.size() != A->nonZeros())
+    		return false;
+    	return std::equal(analyzedOuterIndex.begin(), analyzedOuterIndex.end(), A->outerIndexPtr())
+    			&& std::equal(analyzedInnerIndex.begin(), analyzedInnerIndex.end(), A->innerIndexPtr());
+    }
+
+    /***********************************************************************************************
+     * \brief Removes all entries for a new assembly, the analysis of the solver is kept
+     ***********/
+    void resetValues(){
+    	A->setZero();
+    	isCompressed = false;
+    	isFactorized = false;
+    }
 
     void print(){
     	std::cout<<(*A)<<std::endl;
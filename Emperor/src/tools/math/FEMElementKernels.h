@@ -0,0 +1,253 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file FEMElementKernels.h
+ * This file holds the element kernels of the low order finite elements (tri3 and quad4) with the
+ * number of nodes and the number of Gauss points fixed at compile time. The loops over the nodes
+ * and the Gauss points have constant trip counts, such that the compiler unrolls and vectorizes
+ * them. The runtime functions of FEMMath dispatch to these kernels, the mappers call them directly
+ * once the element type is known. The results are the same as the ones of the runtime functions.
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef FEMELEMENTKERNELS_H_
+#define FEMELEMENTKERNELS_H_
+
+#include "ConstantsAndVariables.h"
+#include "GeometryMath.h"
+
+namespace EMPIRE {
+namespace MathLibrary {
+
+/********//**
+ * \brief Gauss rules of the triangle by their number of Gauss points, the Gauss points are given by
+ *        their area coordinates, which are the shape functions of the triangle at them
+ ***********/
+template<int NUM_GPS> struct TriangleGaussRule;
+template<> struct TriangleGaussRule<3> {
+    static const double *getGaussPoints() { return triGaussPoints3; }
+    static const double *getWeights() { return triWeights3; }
+};
+template<> struct TriangleGaussRule<6> {
+    static const double *getGaussPoints() { return triGaussPoints6; }
+    static const double *getWeights() { return triWeights6; }
+};
+template<> struct TriangleGaussRule<7> {
+    static const double *getGaussPoints() { return triGaussPoints7; }
+    static const double *getWeights() { return triWeights7; }
+};
+template<> struct TriangleGaussRule<12> {
+    static const double *getGaussPoints() { return triGaussPoints12; }
+    static const double *getWeights() { return triWeights12; }
+};
+
+/********//**
+ * \brief Gauss rules of the quadrilateral by their number of Gauss points, the Gauss points are
+ *        given by their local coordinates xi, eta
+ ***********/
+template<int NUM_GPS> struct QuadGaussRule;
+template<> struct QuadGaussRule<1> {
+    static const double *getGaussPoints() { return quadGaussPoints1; }
+    static const double *getWeights() { return quadWeights1; }
+};
+template<> struct QuadGaussRule<4> {
+    static const double *getGaussPoints() { return quadGaussPoints4; }
+    static const double *getWeights() { return quadWeights4; }
+};
+template<> struct QuadGaussRule<9> {
+    static const double *getGaussPoints() { return quadGaussPoints9; }
+    static const double *getWeights() { return quadWeights9; }
+};
+
+/********//**
+ * \brief The shape functions of the quadrilateral and their derivatives at the Gauss points of a
+ *        rule, tabulated once at the first use
+ ***********/
+template<int NUM_GPS> struct QuadGaussRuleTable {
+    /// the shape functions, NUM_GPS x 4
+    double shapeFuncs[NUM_GPS * 4];
+    /// the derivatives of the shape functions w.r.t. xi, NUM_GPS x 4
+    double dNdXi[NUM_GPS * 4];
+    /// the derivatives of the shape functions w.r.t. eta, NUM_GPS x 4
+    double dNdEta[NUM_GPS * 4];
+    /***********************************************************************************************
+     * \brief Get the table, it is created at the first call and never changed
+     ***********/
+    static const QuadGaussRuleTable &get() {
+        static const QuadGaussRuleTable table;
+        return table;
+    }
+private:
+    QuadGaussRuleTable() {
+        const double *gaussPoints = QuadGaussRule<NUM_GPS>::getGaussPoints();
+        for (int k = 0; k < NUM_GPS; k++) {
+            const double *xi_eta = &gaussPoints[k * 2];
+            double *N = &shapeFuncs[k * 4];
+            N[0] = 0.25 * (1.0 - xi_eta[0]) * (1.0 - xi_eta[1]);
+            N[1] = 0.25 * (1.0 + xi_eta[0]) * (1.0 - xi_eta[1]);
+            N[2] = 0.25 * (1.0 + xi_eta[0]) * (1.0 + xi_eta[1]);
+            N[3] = 0.25 * (1.0 - xi_eta[0]) * (1.0 + xi_eta[1]);
+            double *d_N_d_xi = &dNdXi[k * 4];
+            d_N_d_xi[0] = -0.25 * (1 - xi_eta[1]);
+            d_N_d_xi[1] = -d_N_d_xi[0];
+            d_N_d_xi[2] = 0.25 * (1 + xi_eta[1]);
+            d_N_d_xi[3] = -d_N_d_xi[2];
+            double *d_N_d_eta = &dNdEta[k * 4];
+            d_N_d_eta[0] = -0.25 * (1 - xi_eta[0]);
+            d_N_d_eta[1] = -0.25 * (1 + xi_eta[0]);
+            d_N_d_eta[2] = -d_N_d_eta[1];
+            d_N_d_eta[3] = -d_N_d_eta[0];
+        }
+    }
+};
+
+/***********************************************************************************************
+ * \brief Compute the low order shape functions, as computeLowOrderShapeFunc
+ * \param[in] _coords the coordinates of the point in the canonical element
+ * \param[out] _shapeFuncs the NUM_NODES shape functions
+ ***********/
+template<int NUM_NODES> inline void computeLowOrderShapeFunc(const double *_coords,
+        double *_shapeFuncs);
+template<> inline void computeLowOrderShapeFunc<3>(const double *_coords, double *_shapeFuncs) {
+    _shapeFuncs[0] = 1 - _coords[0] - _coords[1];
+    _shapeFuncs[1] = _coords[0];
+    _shapeFuncs[2] = _coords[1];
+}
+template<> inline void computeLowOrderShapeFunc<4>(const double *_coords, double *_shapeFuncs) {
+    _shapeFuncs[0] = (1 - _coords[0]) / 2 * (1 - _coords[1]) / 2;
+    _shapeFuncs[1] = (1 + _coords[0]) / 2 * (1 - _coords[1]) / 2;
+    _shapeFuncs[2] = (1 + _coords[0]) / 2 * (1 + _coords[1]) / 2;
+    _shapeFuncs[3] = (1 - _coords[0]) / 2 * (1 + _coords[1]) / 2;
+}
+
+/***********************************************************************************************
+ * \brief Compute the linear combination of nodal values, as computeLinearCombination
+ * \param[in] _values the values on the nodes, NUM_NODES x NUM_VALUES
+ * \param[in] _shapeFuncs the shape functions
+ * \param[out] _returnValue the NUM_VALUES values
+ ***********/
+template<int NUM_NODES, int NUM_VALUES>
+inline void computeLinearCombination(const double *_values, const double *_shapeFuncs,
+        double *_returnValue) {
+    for (int i = 0; i < NUM_VALUES; i++) {
+        _returnValue[i] = 0;
+        for (int j = 0; j < NUM_NODES; j++)
+            _returnValue[i] += _values[j * NUM_VALUES + i] * _shapeFuncs[j];
+    }
+}
+
+/***********************************************************************************************
+ * \brief Compute the determinant of the Jacobian of a quadrilateral at a Gauss point of a rule, as
+ *        computeDetJOfQuad
+ * \param[in] quad the quadrilateral
+ * \param[in] gaussPoint the index of the Gauss point
+ * \return the determinant of the Jacobian
+ ***********/
+template<int NUM_GPS>
+inline double computeDetJOfQuad(const double *quad, int gaussPoint) {
+    const QuadGaussRuleTable<NUM_GPS> &table = QuadGaussRuleTable<NUM_GPS>::get();
+    const double *d_N_d_xi = &table.dNdXi[gaussPoint * 4];
+    const double *d_N_d_eta = &table.dNdEta[gaussPoint * 4];
+    // g1 and g2 are the local basis vectors, and det(J)=||g1 x g2||
+    double g1[3] = { 0, 0, 0 };
+    double g2[3] = { 0, 0, 0 };
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            g1[i] += quad[j * 3 + i] * d_N_d_xi[j];
+            g2[i] += quad[j * 3 + i] * d_N_d_eta[j];
+        }
+    }
+    double crossProduct[3];
+    computeVectorCrossProduct(g1, g2, crossProduct);
+    return computeVectorLength(crossProduct);
+}
+
+/***********************************************************************************************
+ * \brief Compute the mass matrix of a triangle element, as computeMassMatrixOfTrianlge
+ * \param[in] triangle the triangle
+ * \param[in] dual whether dual or not
+ * \param[out] massMatrix mass matrix (3x3)
+ ***********/
+template<int NUM_GPS>
+void computeMassMatrixOfTriangle(const double *triangle, bool dual, double *massMatrix) {
+    const double *gaussPointsLocal = TriangleGaussRule<NUM_GPS>::getGaussPoints();
+    const double *weights = TriangleGaussRule<NUM_GPS>::getWeights();
+    for (int i = 0; i < 9; i++)
+        massMatrix[i] = 0.0;
+    double area = computeAreaOfTriangle(triangle);
+    if (!dual) {
+        // since the mass matrix is symmetric, only calculate the upper part
+        for (int i = 0; i < 3; i++) {
+            for (int j = i; j < 3; j++) {
+                for (int k = 0; k < NUM_GPS; k++)
+                    massMatrix[i * 3 + j] += weights[k] * gaussPointsLocal[k * 3 + i]
+                            * gaussPointsLocal[k * 3 + j];
+                massMatrix[i * 3 + j] *= area;
+            }
+        }
+        // set the lower part
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < i; j++)
+                massMatrix[i * 3 + j] = massMatrix[j * 3 + i];
+    } else {
+        for (int i = 0; i < 3; i++) {
+            for (int k = 0; k < NUM_GPS; k++)
+                massMatrix[i * 3 + i] += weights[k] * gaussPointsLocal[k * 3 + i];
+            massMatrix[i * 3 + i] *= area;
+        }
+    }
+}
+
+/***********************************************************************************************
+ * \brief Compute the mass matrix of a quad element, as computeMassMatrixOfQuad
+ * \param[in] quad the quad
+ * \param[in] dual whether dual or not
+ * \param[out] massMatrix mass matrix (4x4)
+ ***********/
+template<int NUM_GPS>
+void computeMassMatrixOfQuad(const double *quad, bool dual, double *massMatrix) {
+    const double *weights = QuadGaussRule<NUM_GPS>::getWeights();
+    const double *GPShapeFunc = QuadGaussRuleTable<NUM_GPS>::get().shapeFuncs;
+    double detJ[NUM_GPS];
+    for (int k = 0; k < NUM_GPS; k++)
+        detJ[k] = computeDetJOfQuad<NUM_GPS>(quad, k);
+    for (int i = 0; i < 16; i++)
+        massMatrix[i] = 0.0;
+    if (!dual) {
+        // since the mass matrix is symmetric, only calculate the upper part
+        for (int i = 0; i < 4; i++)
+            for (int j = i; j < 4; j++)
+                for (int k = 0; k < NUM_GPS; k++)
+                    massMatrix[i * 4 + j] += weights[k] * detJ[k] * GPShapeFunc[k * 4 + i]
+                            * GPShapeFunc[k * 4 + j];
+        // set the lower part
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < i; j++)
+                massMatrix[i * 4 + j] = massMatrix[j * 4 + i];
+    } else {
+        for (int i = 0; i < 4; i++)
+            for (int k = 0; k < NUM_GPS; k++)
+                massMatrix[i * 4 + i] += weights[k] * detJ[k] * GPShapeFunc[k * 4 + i];
+    }
+}
+
+} /* namespace MathLibrary */
+} /* namespace EMPIRE */
+#endif /* FEMELEMENTKERNELS_H_ */
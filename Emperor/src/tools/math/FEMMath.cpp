@@ -20,6 +20,7 @@
  */
 
 #include "FEMMath.h"
+#include "FEMElementKernels.h"
 #include "ConstantsAndVariables.h"
 #include "GeometryMath.h"
 #include "MatrixVectorMath.h"
@@ -30,112 +31,86 @@ using namespace std;
 namespace EMPIRE {
 namespace MathLibrary {
 
-void computeMassMatrixOfTrianlge(const double *triangle, int numGaussPoints, bool dual,
-        double *massMatrix) {
-    const double *gaussPointsLocal;
-    const double *weights;
-    if (numGaussPoints == 3) {
-        gaussPointsLocal = EMPIRE::MathLibrary::triGaussPoints3;
-        weights = EMPIRE::MathLibrary::triWeights3;
-    } else if (numGaussPoints == 6) {
-        gaussPointsLocal = EMPIRE::MathLibrary::triGaussPoints6;
-        weights = EMPIRE::MathLibrary::triWeights6;
-    } else if (numGaussPoints == 7) {
-        gaussPointsLocal = EMPIRE::MathLibrary::triGaussPoints7;
-        weights = EMPIRE::MathLibrary::triWeights7;
-    } else if (numGaussPoints == 12) {
-        gaussPointsLocal = EMPIRE::MathLibrary::triGaussPoints12;
-        weights = EMPIRE::MathLibrary::triWeights12;
-    } else {
+void getGaussRuleOfTriangle(int numGaussPoints, const double *&gaussPointsLocal, const double *&weights) {
+    switch (numGaussPoints) {
+    case 3:
+        gaussPointsLocal = triGaussPoints3;
+        weights = triWeights3;
+        break;
+    case 6:
+        gaussPointsLocal = triGaussPoints6;
+        weights = triWeights6;
+        break;
+    case 7:
+        gaussPointsLocal = triGaussPoints7;
+        weights = triWeights7;
+        break;
+    case 12:
+        gaussPointsLocal = triGaussPoints12;
+        weights = triWeights12;
+        break;
+    default:
         assert(false);
     }
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            massMatrix[i * 3 + j] = 0.0;
-        }
+}
+
+/***********************************************************************************************
+ * \brief Get the Gauss points (local coordinates) and weights of a rule on the quad
+ ***********/
+static void getGaussRuleOfQuad(int numGaussPoints, const double *&gaussPointsLocal, const double *&weights) {
+    switch (numGaussPoints) {
+    case 1:
+        gaussPointsLocal = quadGaussPoints1;
+        weights = quadWeights1;
+        break;
+    case 4:
+        gaussPointsLocal = quadGaussPoints4;
+        weights = quadWeights4;
+        break;
+    case 9:
+        gaussPointsLocal = quadGaussPoints9;
+        weights = quadWeights9;
+        break;
+    default:
+        assert(false);
     }
-    double area = EMPIRE::MathLibrary::computeAreaOfTriangle(triangle);
-    if (!dual) {
-        // since the mass matrix is symmetric, only calculate the upper part
-        for (int i = 0; i < 3; i++) {
-            for (int j = i; j < 3; j++) {
-                for (int k = 0; k < numGaussPoints; k++) {
-                    massMatrix[i * 3 + j] += weights[k] * gaussPointsLocal[k * 3 + i]
-                            * gaussPointsLocal[k * 3 + j];
-                }
-                massMatrix[i * 3 + j] *= area;
-            }
-        }
-        // set the lower part
-        for (int i = 0; i < 3; i++) {
-            for (int j = 0; j < i; j++) {
-                massMatrix[i * 3 + j] = massMatrix[j * 3 + i];
-            }
-        }
-    } else {
-        for (int i = 0; i < 3; i++) {
-            for (int k = 0; k < numGaussPoints; k++) {
-                massMatrix[i * 3 + i] += weights[k] * gaussPointsLocal[k * 3 + i];
-            }
-            massMatrix[i * 3 + i] *= area;
-        }
+}
+
+void computeMassMatrixOfTrianlge(const double *triangle, int numGaussPoints, bool dual,
+        double *massMatrix) {
+    switch (numGaussPoints) {
+    case 3:
+        computeMassMatrixOfTriangle<3>(triangle, dual, massMatrix);
+        break;
+    case 6:
+        computeMassMatrixOfTriangle<6>(triangle, dual, massMatrix);
+        break;
+    case 7:
+        computeMassMatrixOfTriangle<7>(triangle, dual, massMatrix);
+        break;
+    case 12:
+        computeMassMatrixOfTriangle<12>(triangle, dual, massMatrix);
+        break;
+    default:
+        assert(false);
     }
 }
 
 void computeMassMatrixOfQuad(const double *quad, int numGaussPoints, bool dual,
         double *massMatrix) {
-    const double *gaussPointsLocal;
-    const double *weights;
-    if (numGaussPoints == 1) {
-        gaussPointsLocal = EMPIRE::MathLibrary::quadGaussPoints1;
-        weights = EMPIRE::MathLibrary::quadWeights1;
-    } else if (numGaussPoints == 4) {
-        gaussPointsLocal = EMPIRE::MathLibrary::quadGaussPoints4;
-        weights = EMPIRE::MathLibrary::quadWeights4;
-    } else if (numGaussPoints == 9) {
-        gaussPointsLocal = EMPIRE::MathLibrary::quadGaussPoints9;
-        weights = EMPIRE::MathLibrary::quadWeights9;
-    } else {
+    switch (numGaussPoints) {
+    case 1:
+        computeMassMatrixOfQuad<1>(quad, dual, massMatrix);
+        break;
+    case 4:
+        computeMassMatrixOfQuad<4>(quad, dual, massMatrix);
+        break;
+    case 9:
+        computeMassMatrixOfQuad<9>(quad, dual, massMatrix);
+        break;
+    default:
         assert(false);
     }
-    double GPShapeFunc[numGaussPoints * 4];
-    for (int i = 0; i < numGaussPoints; i++) {
-        for (int j = 0; j < 4; j++) {
-            computeShapeFuncOfQuad(&gaussPointsLocal[i * 2], &GPShapeFunc[i * 4]);
-        }
-    }
-    double detJ[numGaussPoints];
-    for (int i = 0; i < numGaussPoints; i++) {
-        detJ[i] = computeDetJOfQuad(quad, &gaussPointsLocal[i * 2]);
-    }
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            massMatrix[i * 4 + j] = 0.0;
-        }
-    }
-    if (!dual) {
-        // since the mass matrix is symmetric, only calculate the upper part
-        for (int i = 0; i < 4; i++) {
-            for (int j = i; j < 4; j++) {
-                for (int k = 0; k < numGaussPoints; k++) {
-                    massMatrix[i * 4 + j] += weights[k] * detJ[k] * GPShapeFunc[k * 4 + i]
-                            * GPShapeFunc[k * 4 + j];
-                }
-            }
-        }
-        // set the lower part
-        for (int i = 0; i < 4; i++) {
-            for (int j = 0; j < i; j++) {
-                massMatrix[i * 4 + j] = massMatrix[j * 4 + i];
-            }
-        }
-    } else {
-        for (int i = 0; i < 4; i++) {
-            for (int k = 0; k < numGaussPoints; k++) {
-                massMatrix[i * 4 + i] += weights[k] * detJ[k] * GPShapeFunc[k * 4 + i];
-            }
-        }
-    }
 }
 
 void computeShapeFuncOfQuad(const double *xi_eta, double *shapeFuncValues) {
@@ -340,23 +315,111 @@ bool computeLocalCoorInQuad(const double *quad, int planeToProject, const double
     return true;
 }
 
+void computeLocalCoorInTriangles(int num, const double *triangles, const int *planesToProject,
+        const double *points, double *localCoors) {
+    // the closed form of solve3x3LinearSystem, the row of the plane to project is replaced by 1
+#pragma omp simd
+    for (int k = 0; k < num; k++) {
+        int p = planesToProject[k];
+        int XX = (p + 1) % 3;
+        int YY = (p + 2) % 3;
+        double x0 = triangles[XX * num + k], y0 = triangles[YY * num + k];
+        double x1 = triangles[(3 + XX) * num + k], y1 = triangles[(3 + YY) * num + k];
+        double x2 = triangles[(6 + XX) * num + k], y2 = triangles[(6 + YY) * num + k];
+        double bx = points[XX * num + k], by = points[YY * num + k];
+        double detA1A2 = x1 * y2 - y1 * x2;
+        double detA0A2 = x0 * y2 - y0 * x2;
+        double detA0A1 = x0 * y1 - y0 * x1;
+        double detA0b = x0 * by - y0 * bx;
+        double detbA2 = bx * y2 - by * x2;
+        double detA1b = x1 * by - y1 * bx;
+        double detA = detA1A2 - detA0A2 + detA0A1;
+        double det1 = detbA2 - detA0A2 + detA0b;
+        double det2 = detA1b - detA0b + detA0A1;
+        double xi1 = det1 / detA;
+        double xi2 = det2 / detA;
+        localCoors[k] = 1.0 - xi1 - xi2;
+        localCoors[num + k] = xi1;
+        localCoors[2 * num + k] = xi2;
+    }
+}
+
+void computeLocalCoorInQuads(int num, const double *quads, const int *planesToProject,
+        const double *points, double *localCoors) {
+    const double EPS = 1E-13;
+    const int MAX_ITER_NUM = 100;
+    // coefficients of the bilinear map per quadrilateral, see computeLocalCoorInQuad
+    std::vector<double> coefficients(8 * num);
+    double *a1 = &coefficients[0], *b1 = a1 + num, *c1 = b1 + num, *d1 = c1 + num;
+    double *a2 = d1 + num, *b2 = a2 + num, *c2 = b2 + num, *d2 = c2 + num;
+    std::vector<char> active(num, 1);
+    double *xi = localCoors, *eta = localCoors + num;
+#pragma omp simd
+    for (int k = 0; k < num; k++) {
+        int p = planesToProject[k];
+        int x_direc = (p + 1) % 3;
+        int y_direc = (p + 2) % 3;
+        double x[4], y[4];
+        for (int i = 0; i < 4; i++) {
+            x[i] = quads[(i * 3 + x_direc) * num + k];
+            y[i] = quads[(i * 3 + y_direc) * num + k];
+        }
+        a1[k] = x[0] + x[1] + x[2] + x[3] - 4.0 * points[x_direc * num + k];
+        b1[k] = -x[0] + x[1] + x[2] - x[3];
+        c1[k] = -x[0] - x[1] + x[2] + x[3];
+        d1[k] = x[0] - x[1] + x[2] - x[3];
+        a2[k] = y[0] + y[1] + y[2] + y[3] - 4.0 * points[y_direc * num + k];
+        b2[k] = -y[0] + y[1] + y[2] - y[3];
+        c2[k] = -y[0] - y[1] + y[2] + y[3];
+        d2[k] = y[0] - y[1] + y[2] - y[3];
+        xi[k] = 0.0;
+        eta[k] = 0.0;
+    }
+    char *isActive = &active[0];
+    for (int iter = 0; iter < MAX_ITER_NUM; iter++) {
+        int numActive = 0;
+#pragma omp simd reduction(+:numActive)
+        for (int k = 0; k < num; k++) {
+            if (isActive[k]) {
+                // Newton step by solve2x2LinearSystem, -F is kept if the Jacobian is singular
+                double J0 = b1[k] + d1[k] * eta[k];
+                double J2 = c1[k] + d1[k] * xi[k];
+                double J1 = b2[k] + d2[k] * eta[k];
+                double J3 = c2[k] + d2[k] * xi[k];
+                double F0 = -(a1[k] + b1[k] * xi[k] + c1[k] * eta[k] + d1[k] * xi[k] * eta[k]);
+                double F1 = -(a2[k] + b2[k] * xi[k] + c2[k] * eta[k] + d2[k] * xi[k] * eta[k]);
+                double detA = J0 * J3 - J2 * J1;
+                double det0 = J3 * F0 - J2 * F1;
+                double det1 = J0 * F1 - J1 * F0;
+                double v1LengthSquare = J0 * J0 + J1 * J1;
+                double v2LengthSquare = J2 * J2 + J3 * J3;
+                double maxLengthSquare = (v1LengthSquare > v2LengthSquare) ? v1LengthSquare
+                        : v2LengthSquare;
+                bool singular = fabs(detA) < EPS * fabs(det0) || fabs(detA) < EPS * fabs(det1)
+                        || fabs(detA) < 1E-15 * maxLengthSquare;
+                double delta0 = singular ? F0 : det0 / detA;
+                double delta1 = singular ? F1 : det1 / detA;
+                // do not care accuracy if point is far outside the quad
+                bool farOutside = iter >= 10
+                        && (xi[k] > 2.0 || xi[k] < -2.0 || eta[k] > 2.0 || eta[k] < -2.0);
+                bool converged = fabs(delta0) < EPS && fabs(delta1) < EPS;
+                if (farOutside || converged) {
+                    isActive[k] = 0;
+                } else {
+                    xi[k] += delta0;
+                    eta[k] += delta1;
+                    numActive++;
+                }
+            }
+        }
+        if (numActive == 0)
+            break;
+    }
+}
+
 GaussQuadratureOnTriangle::GaussQuadratureOnTriangle(double *_triangle, int _numGaussPoints) :
         triangle(_triangle), numGaussPoints(_numGaussPoints) {
-    if (numGaussPoints == 3) {
-        gaussPointsLocal = EMPIRE::MathLibrary::triGaussPoints3;
-        weights = EMPIRE::MathLibrary::triWeights3;
-    } else if (numGaussPoints == 6) {
-        gaussPointsLocal = EMPIRE::MathLibrary::triGaussPoints6;
-        weights = EMPIRE::MathLibrary::triWeights6;
-    } else if (numGaussPoints == 7) {
-        gaussPointsLocal = EMPIRE::MathLibrary::triGaussPoints7;
-        weights = EMPIRE::MathLibrary::triWeights7;
-    } else if (numGaussPoints == 12) {
-        gaussPointsLocal = EMPIRE::MathLibrary::triGaussPoints12;
-        weights = EMPIRE::MathLibrary::triWeights12;
-    } else {
-        assert(false);
-    }
+    getGaussRuleOfTriangle(numGaussPoints, gaussPointsLocal, weights);
     gaussPointsGlobal = new double[numGaussPoints * 3];
     for (int i = 0; i < numGaussPoints; i++) {
     	EMPIRE::MathLibrary::computeGlobalCoorInTriangle(triangle, &gaussPointsLocal[i * 3], &gaussPointsGlobal[i * 3]);
@@ -382,18 +445,7 @@ double GaussQuadratureOnTriangle::computeIntegral() {
 
 GaussQuadratureOnQuad::GaussQuadratureOnQuad(double *_quad, int _numGaussPoints) :
         quad(_quad), numGaussPoints(_numGaussPoints) {
-    if (numGaussPoints == 1) {
-        gaussPointsLocal = EMPIRE::MathLibrary::quadGaussPoints1;
-        weights = EMPIRE::MathLibrary::quadWeights1;
-    } else if (numGaussPoints == 4) {
-        gaussPointsLocal = EMPIRE::MathLibrary::quadGaussPoints4;
-        weights = EMPIRE::MathLibrary::quadWeights4;
-    } else if (numGaussPoints == 9) {
-        gaussPointsLocal = EMPIRE::MathLibrary::quadGaussPoints9;
-        weights = EMPIRE::MathLibrary::quadWeights9;
-    } else {
-        assert(false);
-    }
+    getGaussRuleOfQuad(numGaussPoints, gaussPointsLocal, weights);
     gaussPointsGlobal = new double[numGaussPoints * 3];
     detJ = new double[numGaussPoints];
     for (int i = 0; i < numGaussPoints; i++) {
@@ -446,14 +498,9 @@ void computeLowOrderShapeFunc(int _nNodes, const double *_coords, double *_shape
     assert(_coords!=NULL);
     assert(_shapeFuncs!=NULL);
     if (_nNodes == 3) {
-        _shapeFuncs[0] = 1 - _coords[0] - _coords[1];
-        _shapeFuncs[1] = _coords[0];
-        _shapeFuncs[2] = _coords[1];
+        computeLowOrderShapeFunc<3>(_coords, _shapeFuncs);
     } else if (_nNodes == 4) {
-        _shapeFuncs[0] = (1 - _coords[0]) / 2 * (1 - _coords[1]) / 2;
-        _shapeFuncs[1] = (1 + _coords[0]) / 2 * (1 - _coords[1]) / 2;
-        _shapeFuncs[2] = (1 + _coords[0]) / 2 * (1 + _coords[1]) / 2;
-        _shapeFuncs[3] = (1 - _coords[0]) / 2 * (1 + _coords[1]) / 2;
+        computeLowOrderShapeFunc<4>(_coords, _shapeFuncs);
     } else {
         ERROR_OUT() << "Low order basis functions are computed for only triangles or quadrilaterals" << endl;
         exit(-1);
@@ -901,5 +948,54 @@ IGAGaussQuadratureOnBiunitQuadrilateral::IGAGaussQuadratureOnBiunitQuadrilateral
     }
 }
 
+/********//**
+ * \brief Class IGAGaussQuadratureRegistry holds one instance of every supported IGA Gauss quadrature
+ *        rule, indexed by the domain and the number of Gauss points
+ ***********/
+class IGAGaussQuadratureRegistry {
+public:
+    /// Maximum number of Gauss points of the rules
+    static const int MAX_NUM_GAUSS_POINTS = 100;
+
+    IGAGaussQuadratureRegistry() {
+        for (int iDomain = 0; iDomain < IGA_QUADRATURE_NUM_DOMAINS; iDomain++)
+            for (int iGP = 0; iGP <= MAX_NUM_GAUSS_POINTS; iGP++)
+                rules[iDomain][iGP] = NULL;
+        const int numGPsTriangle[8] = { 1, 3, 4, 6, 7, 12, 13, 16 };
+        for (int i = 0; i < 8; i++)
+            rules[IGA_QUADRATURE_TRIANGLE][numGPsTriangle[i]] = new IGAGaussQuadratureOnTriangle(numGPsTriangle[i]);
+        for (int n = 1; n <= 10; n++) {
+            rules[IGA_QUADRATURE_TRIANGLE_DEGENERATED_QUADRILATERAL][n * n] =
+                    new IGAGaussQuadratureOnTriangleUsingDegeneratedQuadrilateral(n * n);
+            rules[IGA_QUADRATURE_BIUNIT_QUADRILATERAL][n * n] = new IGAGaussQuadratureOnBiunitQuadrilateral(n * n);
+        }
+        for (int n = 1; n <= 50; n++)
+            rules[IGA_QUADRATURE_BIUNIT_INTERVAL][n] = new IGAGaussQuadratureOnBiunitInterval(n);
+    }
+
+    ~IGAGaussQuadratureRegistry() {
+        for (int iDomain = 0; iDomain < IGA_QUADRATURE_NUM_DOMAINS; iDomain++)
+            for (int iGP = 0; iGP <= MAX_NUM_GAUSS_POINTS; iGP++)
+                delete rules[iDomain][iGP];
+    }
+
+    const IGAGaussQuadrature* getRule(IGAQuadratureDomain _domain, int _numGaussPoints) const {
+        if (_numGaussPoints >= 0 && _numGaussPoints <= MAX_NUM_GAUSS_POINTS && rules[_domain][_numGaussPoints] != NULL)
+            return rules[_domain][_numGaussPoints];
+        ERROR_OUT() << "Selected number of Gauss points = " << _numGaussPoints << " doesn't exist for the quadrature domain "
+                << _domain << "!" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+private:
+    IGAGaussQuadrature* rules[IGA_QUADRATURE_NUM_DOMAINS][MAX_NUM_GAUSS_POINTS + 1];
+};
+
+const IGAGaussQuadrature* getIGAGaussQuadrature(IGAQuadratureDomain _domain, int _numGaussPoints) {
+    // Created at the first call, thread safe
+    static const IGAGaussQuadratureRegistry registry;
+    return registry.getRule(_domain, _numGaussPoints);
+}
+
 }
 }
@@ -114,6 +114,36 @@ bool computeLocalCoorInTriangle(const double *triangle, int planeToProject, cons
 bool computeLocalCoorInQuad(const double *quad, int planeToProject, const double *point,
         double *localCoor);
 
+/***********************************************************************************************
+ * \brief Compute local coordinates of a number of points in a number of triangles, point k in
+ *        triangle k, in SIMD lanes. All arrays are stored as structure of arrays: coordinate j of
+ *        node i of triangle k at (i * 3 + j) * num + k, component j of point k and local
+ *        coordinate j of point k at j * num + k. The result equals computeLocalCoorInTriangle
+ *        triangle by triangle, whether a point is inside is left to the caller.
+ * \param[in] num number of triangles and points
+ * \param[in] triangles the triangles (9 * num)
+ * \param[in] planesToProject plane to project of each triangle (case: {2:x-y ; 0:y-z ;1: z-x} )
+ * \param[in] points the points (3 * num)
+ * \param[out] localCoors local coordinates of the points (3 * num)
+ ***********/
+void computeLocalCoorInTriangles(int num, const double *triangles, const int *planesToProject,
+        const double *points, double *localCoors);
+
+/***********************************************************************************************
+ * \brief Compute local coordinates of a number of points in a number of quadrilaterals, point k
+ *        in quadrilateral k. The Newton iterations run in SIMD lanes until all lanes converged.
+ *        The arrays are stored as in computeLocalCoorInTriangles. The result equals
+ *        computeLocalCoorInQuad quadrilateral by quadrilateral, including stopping the iterations
+ *        of a point far outside, whether a point is inside is left to the caller.
+ * \param[in] num number of quadrilaterals and points
+ * \param[in] quads the quadrilaterals (12 * num)
+ * \param[in] planesToProject plane to project of each quadrilateral
+ * \param[in] points the points (3 * num)
+ * \param[out] localCoors local coordinates of the points (2 * num)
+ ***********/
+void computeLocalCoorInQuads(int num, const double *quads, const int *planesToProject,
+        const double *points, double *localCoors);
+
 /***********************************************************************************************
  * \brief Compute local coordinates of a point in a triangle in a 2D space
  * \param[in] _coordsTriangle, coordinates of the triangle. double[6].
@@ -159,6 +189,16 @@ void computeLowOrderShapeFunc(int _nNodes, const double* _coords, double* _shape
 void computeLinearCombination(int _nNodes, int _nValue, const double * _values,
         const double *_shapeFuncs, double* _returnValue);
 
+/***********************************************************************************************
+ * \brief Get the Gauss points (area coordinates) and weights of a rule on the triangle. The rules
+ *        are static tables, such that a quadrature can be done without allocating.
+ * \param[in] numGaussPoints number of Gauss points (3, 6, 7 or 12)
+ * \param[out] gaussPointsLocal the area coordinates of the Gauss points (3 per point)
+ * \param[out] weights the weights, they sum up to 1, the integral is scaled by the area
+ ***********/
+void getGaussRuleOfTriangle(int numGaussPoints, const double *&gaussPointsLocal,
+        const double *&weights);
+
 /********//**
  * \brief Class IntegrandFunction is the mother class of all integrand functions
  * \author Tianyang Wang
@@ -309,7 +349,7 @@ public:
      * \brief Returns the number of Gauss points
      * \author Andreas Apostolatos
      ***********/
-    double getNumGaussPoints() {
+    double getNumGaussPoints() const {
         return numGaussPoints;
     }
 
@@ -318,7 +358,7 @@ public:
      * \param[in] _index Index to the Gauss point
      * \author Andreas Apostolatos
      ***********/
-    const double* getGaussPoint(int _index) {
+    const double* getGaussPoint(int _index) const {
         return &gaussPoints[_index * numDimensions];
     }
 
@@ -327,10 +367,24 @@ public:
      * \param[in] _index Index to the Gauss weight
      * \author Andreas Apostolatos
      ***********/
-    double getGaussWeight(int _index) {
+    double getGaussWeight(int _index) const {
         return weights[_index];
     }
 
+    /***********************************************************************************************
+     * \brief Returns the coordinates of all Gauss points, numDimensions consecutive values per point
+     ***********/
+    const double* getGaussPoints() const {
+        return gaussPoints;
+    }
+
+    /***********************************************************************************************
+     * \brief Returns the weights of all Gauss points
+     ***********/
+    const double* getGaussWeights() const {
+        return weights;
+    }
+
     /***********************************************************************************************
      * \brief Sets the coordinates of the Gauss points
      * \param[in] _values Pointer to the array with the values
@@ -434,5 +488,25 @@ public:
     }
 };
 
+/// The domains of the shared IGA Gauss quadrature rules
+enum IGAQuadratureDomain {
+    IGA_QUADRATURE_TRIANGLE = 0,
+    IGA_QUADRATURE_TRIANGLE_DEGENERATED_QUADRILATERAL,
+    IGA_QUADRATURE_BIUNIT_INTERVAL,
+    IGA_QUADRATURE_BIUNIT_QUADRILATERAL,
+    IGA_QUADRATURE_NUM_DOMAINS
+};
+
+/***********************************************************************************************
+ * \brief Returns a shared Gauss quadrature rule. All rules are created once, at the first call, and
+ *        live until the end of the program, so the mappers and the conditions refer to the same
+ *        immutable rule instead of creating their own. The returned rule must not be deleted.
+ *        Unsupported numbers of Gauss points end the program with the message of the rule classes.
+ * \param[in] _domain The domain of the quadrature
+ * \param[in] _numGaussPoints The number of Gauss points
+ * \return The quadrature rule
+ ***********/
+const IGAGaussQuadrature* getIGAGaussQuadrature(IGAQuadratureDomain _domain, int _numGaussPoints);
+
 }
 }
@@ -0,0 +1,101 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file FixedSizeVectorMath.h
+ * This file holds the dense vector operations of MatrixVectorMath with the length of the vectors
+ * fixed at compile time. They are meant for the 2D and 3D vectors of the geometry and the CAGD
+ * routines, which call them inside Newton iterations, where the call of a BLAS routine costs more
+ * than the operation itself. The loops have constant trip counts and are unrolled by the compiler.
+ * Long vectors are still handled by the BLAS versions in MatrixVectorMath.
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef FIXEDSIZEVECTORMATH_H_
+#define FIXEDSIZEVECTORMATH_H_
+
+#include <math.h>
+
+namespace EMPIRE {
+namespace MathLibrary {
+
+/***********************************************************************************************
+ * \brief Copy dense vector vec1 <- vec2
+ * \param[in] vec1 the 1st vector
+ * \param[in] vec2 the 2nd vector
+ ***********/
+template<int N>
+inline void copyDenseVector(double *vec1, const double *vec2) {
+    for (int i = 0; i < N; i++)
+        vec1[i] = vec2[i];
+}
+
+/***********************************************************************************************
+ * \brief Compute Euclidean norm of vector
+ * \param[in] vec1 the vector
+ * \return Euclidean norm
+ ***********/
+template<int N>
+inline double vector2norm(const double *vec1) {
+    double squareNorm = 0.0;
+    for (int i = 0; i < N; i++)
+        squareNorm += vec1[i] * vec1[i];
+    return sqrt(squareNorm);
+}
+
+/***********************************************************************************************
+ * \brief Computes a vector-scalar product and adds the result to a vector. vec1 <- a*vec1 + vec2
+ * \param[in] vec1 the 1st vector
+ * \param[in] vec2 the 2nd vector
+ * \param[in] a scalar
+ ***********/
+template<int N>
+inline void computeDenseVectorAddition(double *vec1, const double *vec2, const double a) {
+    for (int i = 0; i < N; i++)
+        vec1[i] = vec1[i] * a + vec2[i];
+}
+
+/***********************************************************************************************
+ * \brief Computes vector scales by scalar vec1 <- vec1*a
+ * \param[in] vec1 the vector
+ * \param[in] a scalar
+ ***********/
+template<int N>
+inline void computeDenseVectorMultiplicationScalar(double *vec1, const double a) {
+    for (int i = 0; i < N; i++)
+        vec1[i] *= a;
+}
+
+/***********************************************************************************************
+ * \brief Compute the dot product between two vectors
+ * \param[in] _vecI the 1st vector
+ * \param[in] _vecJ the 2nd vector
+ * \return the dot product
+ ***********/
+template<int N>
+inline double computeDenseDotProduct(const double *_vecI, const double *_vecJ) {
+    double dotProduct = 0.0;
+    for (int i = 0; i < N; i++)
+        dotProduct += _vecI[i] * _vecJ[i];
+    return dotProduct;
+}
+
+} /* namespace MathLibrary */
+} /* namespace EMPIRE */
+#endif /* FIXEDSIZEVECTORMATH_H_ */
@@ -19,6 +19,7 @@
  *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
  */
 
+#include <algorithm>
 #include "GeometryMath.h"
 #include "ConstantsAndVariables.h"
 #include "DebugMath.h"
@@ -43,17 +44,17 @@ double distancePointSegment(double* _P, double* _P1, double* _P2) {
 	}
 	// Edit Aditya
 	//normP1P2=sqrt(EMPIRE::MathLibrary::square2normVector(3,P1P2));
-	normP1P2=EMPIRE::MathLibrary::vector2norm(P1P2,3);
+	normP1P2=EMPIRE::MathLibrary::vector2norm<3>(P1P2);
 
-    double projP1P = sqrt(EMPIRE::MathLibrary::computeDenseDotProduct(3,P1P,P1P2));
+    double projP1P = sqrt(EMPIRE::MathLibrary::computeDenseDotProduct<3>(P1P,P1P2));
      if ( projP1P <= 0 ){
           //return sqrt(EMPIRE::MathLibrary::square2normVector(3,P1P));
-     	  return EMPIRE::MathLibrary::vector2norm(P1P,3);
+     	  return EMPIRE::MathLibrary::vector2norm<3>(P1P);
      }
 
      if ( normP1P2 <= projP1P ){
          //return sqrt(EMPIRE::MathLibrary::square2normVector(3,PP2));
-         return EMPIRE::MathLibrary::vector2norm(PP2,3);
+         return EMPIRE::MathLibrary::vector2norm<3>(PP2);
      }
 
 	double t = projP1P / normP1P2;
@@ -63,18 +64,18 @@ double distancePointSegment(double* _P, double* _P1, double* _P2) {
 		 tmp[i]= _P[i] - tmp[i];
 	}
     //return sqrt(EMPIRE::MathLibrary::square2normVector(3,tmp));
-    return EMPIRE::MathLibrary::vector2norm(tmp,3);
+    return EMPIRE::MathLibrary::vector2norm<3>(tmp);
 }
 
 double distanceLinePlane(double* Pline,double* Uline, double* Pplane,double* Nplane) {
 
-	double denom=EMPIRE::MathLibrary::computeDenseDotProduct(3,Nplane,Uline);
+	double denom=EMPIRE::MathLibrary::computeDenseDotProduct<3>(Nplane,Uline);
 	if(denom<1e-9) return -1;
 	double PpPl[3];
 	for(int i=0;i<3;i++){
 		PpPl[i]=Pline[i]-Pplane[i];
 	}
-	return EMPIRE::MathLibrary::computeDenseDotProduct(3,PpPl,Nplane)/denom;
+	return EMPIRE::MathLibrary::computeDenseDotProduct<3>(PpPl,Nplane)/denom;
 }
 
 double distanceLineLine(double& _ratioA, double& _ratioB, double* _P1, double* _P2,double* _P3, double* _P4) {
@@ -89,19 +90,19 @@ double distanceLineLine(double& _ratioA, double& _ratioB, double* _P1, double* _
 	}
 	//normP1P2=sqrt(EMPIRE::MathLibrary::square2normVector(3,P1P2));
 	//normP3P4=sqrt(EMPIRE::MathLibrary::square2normVector(3,P3P4));
-	normP1P2=EMPIRE::MathLibrary::vector2norm(P1P2,3);
-	normP3P4=EMPIRE::MathLibrary::vector2norm(P3P4,3);
+	normP1P2=EMPIRE::MathLibrary::vector2norm<3>(P1P2);
+	normP3P4=EMPIRE::MathLibrary::vector2norm<3>(P3P4);
 
 	if(normP3P4 < EPS)
 	    return -1;
 	if(normP1P2 < EPS)
 	    return -1;
 
-	double d13_34=EMPIRE::MathLibrary::computeDenseDotProduct(3,P1P3,P3P4);
-	double d34_12=EMPIRE::MathLibrary::computeDenseDotProduct(3,P3P4,P1P2);
-	double d13_12=EMPIRE::MathLibrary::computeDenseDotProduct(3,P1P3,P1P2);
-	double d34_34=EMPIRE::MathLibrary::computeDenseDotProduct(3,P3P4,P3P4);
-	double d12_12=EMPIRE::MathLibrary::computeDenseDotProduct(3,P1P2,P1P2);
+	double d13_34=EMPIRE::MathLibrary::computeDenseDotProduct<3>(P1P3,P3P4);
+	double d34_12=EMPIRE::MathLibrary::computeDenseDotProduct<3>(P3P4,P1P2);
+	double d13_12=EMPIRE::MathLibrary::computeDenseDotProduct<3>(P1P3,P1P2);
+	double d34_34=EMPIRE::MathLibrary::computeDenseDotProduct<3>(P3P4,P3P4);
+	double d12_12=EMPIRE::MathLibrary::computeDenseDotProduct<3>(P1P2,P1P2);
 
 	double numer,denom;
 	denom = d12_12 * d34_34 - d34_12 * d34_12;
@@ -124,7 +125,49 @@ double distanceLineLine(double& _ratioA, double& _ratioB, double* _P1, double* _
 		PaPb[i]=Pb[i]-Pa[i];
 	}
 	//return sqrt(EMPIRE::MathLibrary::square2normVector(3,PaPb));
-	return EMPIRE::MathLibrary::vector2norm(PaPb,3);
+	return EMPIRE::MathLibrary::vector2norm<3>(PaPb);
+}
+
+double distanceSegmentSegment(double& _ratioA, double& _ratioB, const double* _P1, const double* _P2,
+        const double* _P3, const double* _P4) {
+    // See Ericson, Real-Time Collision Detection, 2005, Section 5.1.9
+    double P1P2[3], P3P4[3], P3P1[3];
+    for (int i = 0; i < 3; i++) {
+        P1P2[i] = _P2[i] - _P1[i];
+        P3P4[i] = _P4[i] - _P3[i];
+        P3P1[i] = _P1[i] - _P3[i];
+    }
+    double a = computeVectorDotProduct(P1P2, P1P2);
+    double e = computeVectorDotProduct(P3P4, P3P4);
+    double f = computeVectorDotProduct(P3P4, P3P1);
+    if (a <= EPS && e <= EPS) {
+        _ratioA = _ratioB = 0.0;
+    } else if (a <= EPS) {
+        _ratioA = 0.0;
+        _ratioB = min(max(f / e, 0.0), 1.0);
+    } else {
+        double c = computeVectorDotProduct(P1P2, P3P1);
+        if (e <= EPS) {
+            _ratioB = 0.0;
+            _ratioA = min(max(-c / a, 0.0), 1.0);
+        } else {
+            double b = computeVectorDotProduct(P1P2, P3P4);
+            double denom = a * e - b * b;
+            _ratioA = denom > 0.0 ? min(max((b * f - c * e) / denom, 0.0), 1.0) : 0.0;
+            _ratioB = (b * _ratioA + f) / e;
+            if (_ratioB < 0.0) {
+                _ratioB = 0.0;
+                _ratioA = min(max(-c / a, 0.0), 1.0);
+            } else if (_ratioB > 1.0) {
+                _ratioB = 1.0;
+                _ratioA = min(max((b - c) / a, 0.0), 1.0);
+            }
+        }
+    }
+    double distance[3];
+    for (int i = 0; i < 3; i++)
+        distance[i] = _P1[i] + _ratioA * P1P2[i] - _P3[i] - _ratioB * P3P4[i];
+    return computeVectorLength(distance);
 }
 
 /***********************************************************************************************
@@ -210,6 +253,25 @@ void projectToPlane(const double *pointOnPlane, const double *unitNormal, const
     }
 }
 
+void projectToPlanes(int num, const double *pointsOnPlanes, const double *unitNormals,
+        const double *points, double *projections) {
+    const double *px = points, *py = points + num, *pz = points + 2 * num;
+    const double *ox = pointsOnPlanes, *oy = pointsOnPlanes + num, *oz = pointsOnPlanes + 2 * num;
+    const double *nx = unitNormals, *ny = unitNormals + num, *nz = unitNormals + 2 * num;
+    double *qx = projections, *qy = projections + num, *qz = projections + 2 * num;
+#pragma omp simd
+    for (int k = 0; k < num; k++) {
+        double distance = nx[k] * (ox[k] - px[k]) + ny[k] * (oy[k] - py[k])
+                + nz[k] * (oz[k] - pz[k]);
+        double x = px[k] + distance * nx[k];
+        double y = py[k] + distance * ny[k];
+        double z = pz[k] + distance * nz[k];
+        qx[k] = x;
+        qy[k] = y;
+        qz[k] = z;
+    }
+}
+
 /***********************************************************************************************
  * \brief Compute the normal vector of a triangle
  * \param[in] triangle the triangle
@@ -601,7 +663,7 @@ void cleanPolygon(std::vector<double>& polygon) {
 		double cProd[3];
 		//double v=computeCrossProduct2D(v1x,v1y,v2x,v2y);
 		crossProduct(cProd, v1, v2);
-		double v= EMPIRE::MathLibrary::vector2norm(cProd,3);
+		double v= EMPIRE::MathLibrary::vector2norm<3>(cProd);
 
 		// Result of cross product only in Z direction
 		bool isColinear=fabs(v)<1e-9?true:false;
@@ -643,7 +705,7 @@ void cleanPolygon(std::vector<pair<double,double> >& polygon) {
 		// Edit Aditya
 		double cProd[3];
 		EMPIRE::MathLibrary::crossProduct(cProd, v1, v2);
-		double v = EMPIRE::MathLibrary::vector2norm(cProd,3);
+		double v = EMPIRE::MathLibrary::vector2norm<3>(cProd);
 		// Result of cross product only in Z direction
 		bool isColinear=fabs(v)<1e-9?true:false;
 		//double n1=v1x*v1x+v1y*v1y;
@@ -683,7 +745,7 @@ void cleanPolygon(std::vector<pair<double,double> >& polygon,std::vector<pair<do
 		// Edit Aditya
 		double cProd[3];
 		EMPIRE::MathLibrary::crossProduct(cProd,v1, v2);
-		double v = EMPIRE::MathLibrary::vector2norm(cProd,3);
+		double v = EMPIRE::MathLibrary::vector2norm<3>(cProd);
 		// Result of cross product only in Z direction
 		bool isColinear=fabs(v)<1e-9?true:false;
 		//double n1=v1x*v1x+v1y*v1y;
@@ -700,7 +762,7 @@ void cleanPolygon(std::vector<pair<double,double> >& polygon,std::vector<pair<do
 	}
 }
 
-bool findIfPointIsInside2DPolygon(int _numVertices, std::vector<double> _polygon, double* _point) {
+bool findIfPointIsInside2DPolygon(int _numVertices, const std::vector<double>& _polygon, const double* _point) {
     /*
      * Returns a flag on whether the given point lies inside the given polygon in 2D.
      *
@@ -1041,6 +1103,71 @@ bool PolygonClipper::clip(const double *polygonToBeClipped, int sizePolygonToBeC
      }*/
 }
 
+bool PolygonClipper::clip(const double *polygonToBeClipped, int sizePolygonToBeClipped,
+        double *polygonResult, int &sizePolygonResult) const {
+    // the same algorithm as above, the input and the output of an edge swap their buffers
+    assert(sizePolygonToBeClipped <= 4);
+    assert(sizePolygonWindow <= 4);
+    double buffers[2][MAX_SIZE_CLIPPED_POLYGON * 3];
+    double *input = buffers[0];
+    double *output = buffers[1];
+    int sizeOutput = sizePolygonToBeClipped;
+    for (int k = 0; k < sizePolygonToBeClipped * 3; k++)
+        output[k] = polygonToBeClipped[k];
+    const double TOL_SQR = EPS1 * EPS1 * longestEdgeLengthSquare(polygonWindow, sizePolygonWindow);
+
+    for (int i = 0; i < sizePolygonWindow; i++) {
+        // i is the edge ID
+        // 1. make the output the new input
+        double *tmp = input;
+        input = output;
+        output = tmp;
+        int sizeInput = sizeOutput;
+        sizeOutput = 0;
+
+        // 2. clip the input by the edge, an intersection is added where the edge is crossed
+        const double *edgeP1 = &polygonWindow[i * 3];
+        const double *edgeP2 = &polygonWindow[(i + 1) % sizePolygonWindow * 3];
+        for (int k = 0; k < sizeInput; k++) {
+            const double *p1 = &input[k * 3];
+            const double *p2 = &input[(k + 1) % sizeInput * 3];
+            bool inside1 = inside(i, p1);
+            bool inside2 = inside(i, p2);
+            if (inside1 != inside2
+                    && intersect(edgeP1, edgeP2, p1, p2, planeToProject, &output[sizeOutput * 3]))
+                sizeOutput++;
+            if (inside2) {
+                copyPoint(p2, &output[sizeOutput * 3]);
+                sizeOutput++;
+            }
+        }
+        assert(sizeOutput <= MAX_SIZE_CLIPPED_POLYGON);
+
+        // 3. remove overlapped points, a point close to its predecessor is removed
+        for (int k = 0; k < sizeOutput; k++) {
+            if (sizeOutput == 1)
+                break;
+            int k2 = (k + 1) % sizeOutput;
+            if (distanceSquare(&output[k * 3], &output[k2 * 3]) < TOL_SQR) {
+                for (int kk = k2; kk < sizeOutput - 1; kk++)
+                    copyPoint(&output[(kk + 1) * 3], &output[kk * 3]);
+                sizeOutput--;
+            }
+        }
+    }
+
+    for (int k = 0; k < sizeOutput * 3; k++)
+        polygonResult[k] = output[k];
+    sizePolygonResult = sizeOutput;
+
+    // judge whether there is really overlapped area or not
+    if (sizeOutput < 3)
+        return false;
+    if (computePolygonArea(output, sizeOutput) < TOL_SQR)
+        return false; // it could happen the points are almost on the same line
+    return true;
+}
+
 /***********************************************************************************************
  * \brief Decides whether a point is on the "inside" side of the i-th edge of the polygon
  * \param[in] edgeID id of the edge
@@ -1048,7 +1175,7 @@ bool PolygonClipper::clip(const double *polygonToBeClipped, int sizePolygonToBeC
  * \return if inside, return true, otherwise, return false
  * \author Tianyang Wang
  ***********/
-bool PolygonClipper::inside(int edgeID, double *point) {
+bool PolygonClipper::inside(int edgeID, const double *point) const {
     const int XX = (planeToProject + 1) % 3;
     const int YY = (planeToProject + 2) % 3;
     int p1_pos = edgeID;
@@ -1062,6 +1189,14 @@ bool PolygonClipper::inside(int edgeID, double *point) {
         return ((y4 - y1) > edgeSlopes[edgeID] * (x4 - x1)) == insideFlag[edgeID];
 }
 
+int PolygonClipper::computeOutsideCode(const double *point) const {
+    int code = 0;
+    for (int i = 0; i < sizePolygonWindow; i++)
+        if (!inside(i, point))
+            code |= 1 << i;
+    return code;
+}
+
 /***********************************************************************************************
  * \brief Compute intersection between two lines. The result is the intersection with tolerance,
  *        which means it may locate outside of both lines. This error should be taken into account
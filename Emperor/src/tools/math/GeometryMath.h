@@ -42,6 +42,14 @@ double distanceLinePlane(double* Pline,double* Uline, double* Pplane,double* Npl
 double distancePointSegment(double* _P, double* _P1, double* _P2);
 // See http://paulbourke.net/geometry/pointlineplane/
 double distanceLineLine(double& _ratioA, double& _ratioB, double* _P1, double* _P2,double* P3, double* P4);
+/***********************************************************************************************
+ * \brief Compute the distance between the segments P1P2 and P3P4 and their closest points
+ * \param[out] _ratioA The closest point on P1P2 is P1 + _ratioA * P1P2, _ratioA in [0,1]
+ * \param[out] _ratioB The closest point on P3P4 is P3 + _ratioB * P3P4, _ratioB in [0,1]
+ * \return The distance between the closest points
+ ***********/
+double distanceSegmentSegment(double& _ratioA, double& _ratioB, const double* _P1, const double* _P2,
+        const double* _P3, const double* _P4);
 
 /***********************************************************************************************
  * \brief project to plane (case: {2:x-y ; 0:y-z ;1: z-x} )
@@ -82,6 +90,19 @@ double computePolygonArea(const double *polygon, int num);
 void projectToPlane(const double *pointOnPlane, const double *unitNormal, const double *points,
         int num, double *projections);
 
+/***********************************************************************************************
+ * \brief Project a number of points to a number of planes, point k to plane k. All arrays are
+ *        stored as structure of arrays, component j of point/plane k at j * num + k, so the
+ *        points are projected in SIMD lanes. The result equals projectToPlane point by point.
+ * \param[in] num number of points and planes
+ * \param[in] pointsOnPlanes a point on each plane (3 * num)
+ * \param[in] unitNormals unit normal of each plane (3 * num)
+ * \param[in] points the points to be projected (3 * num)
+ * \param[out] projections the projections (3 * num), may be the same array as points
+ ***********/
+void projectToPlanes(int num, const double *pointsOnPlanes, const double *unitNormals,
+        const double *points, double *projections);
+
 /***********************************************************************************************
  * \brief Compute the normal vector of a triangle
  * \param[in] triangle the triangle
@@ -243,7 +264,7 @@ void cleanPolygon(std::vector<std::pair<double,double> >& polygon,std::vector<st
  * \return Flag whether the point is inside the given polygon or not
  * \author Andreas Apostolatos
  ***********/
-bool findIfPointIsInside2DPolygon(int _numVertices, std::vector<double> _polygon, double* _point);
+bool findIfPointIsInside2DPolygon(int _numVertices, const std::vector<double>& _polygon, const double* _point);
 
 /***********************************************************************************************
  * \brief Compute the angle between two vectors in 2D
@@ -289,6 +310,23 @@ public:
      ***********/
     bool clip(const double *polygonToBeClipped, int sizePolygonToBeClipped,
             std::vector<double*> *polygonResult);
+    /***********************************************************************************************
+     * \brief Clip a triangle or a quadrilateral by a triangle or a quadrilateral window without
+     *        allocating. The points are kept in fixed-capacity arrays on the stack, the result
+     *        equals the one of the clip above.
+     * \param[in] polygonToBeClipped polygon to be clipped by the window polygon
+     * \param[in] sizePolygonToBeClipped size of the polygon, at most 4
+     * \param[out] polygonResult the points of the clipped polygon, at most
+     *             MAX_SIZE_CLIPPED_POLYGON x 3 entries
+     * \param[out] sizePolygonResult number of points of the clipped polygon
+     * \return if there is a clip, return true, otherwise, return false
+     ***********/
+    bool clip(const double *polygonToBeClipped, int sizePolygonToBeClipped, double *polygonResult,
+            int &sizePolygonResult) const;
+    /// capacity of the polygons clipped without allocating. Two convex quadrilaterals give at most 8
+    /// points, every edge of the window adds at most half of the points of a polygon which is not
+    /// convex, such that 4 points clipped by 4 edges give at most 19 points
+    static const int MAX_SIZE_CLIPPED_POLYGON = 20;
     /***********************************************************************************************
      * \brief Compute intersection between two lines. The result is the intersection with tolerance,
      *        which means it may locate outside of both lines. This error should be taken into account
@@ -304,6 +342,14 @@ public:
      ***********/
     static bool intersect(const double *la0, const double *la1, const double *lb0, const double *lb1,
             int planeToProject, double *intersection);
+    /***********************************************************************************************
+     * \brief Get the edges of the window polygon a point is outside of. A polygon whose points are
+     *        all outside of one common edge does not overlap the window, such that the codes of the
+     *        points shared by several polygons are computed once and the clipping is skipped.
+     * \param[in] point the point
+     * \return bit i is set if the point is outside of the i-th edge
+     ***********/
+    int computeOutsideCode(const double *point) const;
 
 private:
     /// the polygon that clips other polygons
@@ -333,7 +379,7 @@ private:
      * \return if inside, return true, otherwise, return false
      * \author Tianyang Wang
      ***********/
-    bool inside(int edgeID, double *point);
+    bool inside(int edgeID, const double *point) const;
 };
 
 
@@ -23,7 +23,13 @@
 #define SPARSELINEARALGEBRA_HPP_
 
 #include "Message.h"
+#include "LinearSolver.h"
 #include <assert.h>
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <stdlib.h>
+#include <unistd.h>
 
 
 namespace EMPIRE {
@@ -84,6 +90,42 @@ private:
 	int mklSetNumThreads;
 	/// pardiso variable
 	char up;
+	/// true if the reordering and the symbolic factorization are done
+	bool isAnalyzed;
+	/// row index array of the analyzed matrix, used to detect a change of the sparsity pattern
+	std::vector<int> analyzedRowIndex;
+	/// column array of the analyzed matrix, used to detect a change of the sparsity pattern
+	std::vector<int> analyzedColumns;
+	/// the threads, the ordering and the storage of the factors
+	PardisoSettings settings;
+	/// peak memory of the last analysis and factorization in bytes
+	size_t peakFactorMemory;
+	/// the files of the out-of-core factors are named by this prefix
+	std::string outOfCorePrefix;
+
+	/***********************************************************************************************
+	 * \brief Set the parameters of the settings before the analysis
+	 ***********/
+	void applySettings() {
+		pardiso_iparm[1] = settings.ordering;
+		pardiso_iparm[23] = settings.twoLevelFactorization ? 1 : 0;
+		pardiso_iparm[59] = settings.outOfCoreMode;
+		if (settings.outOfCoreMode == PardisoSettings::IN_CORE)
+			return;
+		// the out-of-core files are configured by the environment, which PARDISO reads in the analysis
+		if (outOfCorePrefix.empty()) {
+			static int numAdapters = 0;
+			std::stringstream prefix;
+			prefix << settings.outOfCoreDirectory << "/empire_pardiso_" << getpid() << "_" << numAdapters++;
+			outOfCorePrefix = prefix.str();
+		}
+		setenv("MKL_PARDISO_OOC_PATH", outOfCorePrefix.c_str(), 1);
+		if (settings.outOfCoreMaxCoreSize > 0) {
+			std::stringstream maxCoreSize;
+			maxCoreSize << settings.outOfCoreMaxCoreSize;
+			setenv("MKL_PARDISO_OOC_MAX_CORE_SIZE", maxCoreSize.str().c_str(), 1);
+		}
+	}
 
 
 
@@ -107,6 +149,8 @@ public:
 		pardiso_beta = 0.0;
 		mklSetNumThreads = 1;  /// OpenMP parallelization variable
 		up = 'u';
+		isAnalyzed = false;
+		peakFactorMemory = 0;
 		// Initializing the pardiso
 		if(isSymmetric)
 			pardiso_mtype = 2; // real symmetric matrix
@@ -220,7 +264,7 @@ public:
 		 ***********/
 		void factorize(bool isSymmetric, int m, double *mat_values, int *rowIndex, int* columns){
 
-			pardiso_iparm[2] = 3; //The parallel (OpenMP) version of the nested dissection algorithm
+			applySettings();
 			pardiso_maxfct = 1; // max number of factorizations
 			pardiso_mnum = 1; // which factorization to use
 			pardiso_msglvl = 0; // do NOT print statistical information
@@ -228,7 +272,7 @@ public:
 			pardiso_nrhs = 1; // number of right hand side
 			pardiso_phase = 12; // analysis and factorization
             pardiso_error = 0;
-			mkl_set_num_threads(1);
+			mkl_set_num_threads(settings.numThreads);
 			pardiso(pardiso_pt, &pardiso_maxfct, &pardiso_mnum, &pardiso_mtype, &pardiso_phase,
 					&pardiso_neq, mat_values, rowIndex, columns, &pardiso_idum,
 					&pardiso_nrhs, pardiso_iparm, &pardiso_msglvl, &pardiso_ddum, &pardiso_ddum,
@@ -239,6 +283,99 @@ public:
 						<< std::endl;
 				exit(EXIT_FAILURE);
 			}
+
+			// Keep the analyzed pattern for the next refactorization
+			isAnalyzed = true;
+			analyzedRowIndex.assign(rowIndex, rowIndex + m + 1);
+			analyzedColumns.assign(columns, columns + rowIndex[m] - 1);
+
+			// the peak is the larger of the analysis peak iparm(15) and the permanent memory of the
+			// analysis iparm(16) plus the memory of the factorization iparm(17), all in KB
+			peakFactorMemory = 1024 * std::max((size_t) pardiso_iparm[14],
+					(size_t) pardiso_iparm[15] + (size_t) pardiso_iparm[16]);
+			INFO_OUT() << "PARDISO: factorized a matrix of size " << m << ", peak memory "
+					<< peakFactorMemory / (1024.0 * 1024.0) << " MB (analysis peak "
+					<< pardiso_iparm[14] / 1024.0 << " MB, permanent " << pardiso_iparm[15] / 1024.0
+					<< " MB, factorization " << pardiso_iparm[16] / 1024.0 << " MB"
+					<< (pardiso_iparm[59] != 0 ? ", out-of-core" : "") << ")" << std::endl;
+		}
+
+		/***********************************************************************************************
+		 * \brief Set the threads, the ordering and the storage of the factors, the next
+		 *        factorization analyses the matrix again
+		 * \param[in]  _settings 	-- the settings
+		 ***********/
+		void setSettings(const PardisoSettings &_settings) {
+			settings = _settings;
+			isAnalyzed = false;
+		}
+
+		/***********************************************************************************************
+		 * \brief Get the peak memory of the last analysis and factorization, which is reported
+		 *        after every analysis
+		 * \return the number of bytes, 0 if nothing is factorized
+		 ***********/
+		size_t getPeakFactorMemory() const {
+			return peakFactorMemory;
+		}
+
+		/***********************************************************************************************
+		 * \brief This function factorizes the matrix again after its values changed. If the sparsity
+		 *        pattern is the one of the last analysis, the ordering and the symbolic factorization
+		 *        are reused and only the numerical factorization is done, otherwise it falls back to
+		 *        factorize
+		 * \param[in]  isSymmetric 	-- Flag specifying if the Sparse matrix is symmetric or not.
+	     * \param[in]  m 			-- Number of rows of sparse matrix
+	     * \param[in]  mat_values 	-- Pointer to arrray containing the non-zero values of sparse matrix.
+	     * \param[in]  rowIndex	 	-- Pointer to the integer array of which element j gives the index of the element in the values array that is first non-zero element in a row j.
+	     * \param[in]  columns		-- Pointer to the integer array of which element i is the number of the column that contains the i-th element in the mat_values array.
+		 ***********/
+		void refactorize(bool isSymmetric, int m, double *mat_values, int *rowIndex, int* columns){
+			if (!isAnalyzed || !isAnalyzedPattern(m, rowIndex, columns)) {
+				factorize(isSymmetric, m, mat_values, rowIndex, columns);
+				return;
+			}
+
+			pardiso_phase = 22; // numerical factorization only
+			pardiso_error = 0;
+			mkl_set_num_threads(settings.numThreads);
+			pardiso(pardiso_pt, &pardiso_maxfct, &pardiso_mnum, &pardiso_mtype, &pardiso_phase,
+					&pardiso_neq, mat_values, rowIndex, columns, &pardiso_idum,
+					&pardiso_nrhs, pardiso_iparm, &pardiso_msglvl, &pardiso_ddum, &pardiso_ddum,
+					&pardiso_error);
+
+			if (pardiso_error != 0) {
+				ERROR_OUT() << "Error pardiso numerical factorization failed with error code: " << pardiso_error
+						<< std::endl;
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		/***********************************************************************************************
+		 * \brief Checks whether a matrix has the sparsity pattern of the last analysis
+	     * \param[in]  m 			-- Number of rows of sparse matrix
+	     * \param[in]  rowIndex	 	-- Pointer to the one-based row index array of the matrix
+	     * \param[in]  columns		-- Pointer to the one-based column array of the matrix
+		 * \return true if the pattern is the same
+		 ***********/
+		bool isAnalyzedPattern(int m, const int *rowIndex, const int* columns) const {
+			if ((int) analyzedRowIndex.size() != m + 1)
+				return false;
+			if (!std::equal(rowIndex, rowIndex + m + 1, analyzedRowIndex.begin()))
+				return false;
+			return std::equal(columns, columns + rowIndex[m] - 1, analyzedColumns.begin());
+		}
+
+		/***********************************************************************************************
+		 * \brief Get the memory held by pardiso for the factorization, i.e. the permanent memory of
+		 *        the analysis (iparm(16)) and the memory of the factors (iparm(17)) in KB
+		 * \return the number of bytes, 0 if nothing is factorized
+		 ***********/
+		size_t getFactorMemory() const {
+			if (!isAnalyzed)
+				return 0;
+			return 1024 * ((size_t) pardiso_iparm[15] + (size_t) pardiso_iparm[16])
+					+ (analyzedRowIndex.capacity() + analyzedColumns.capacity()) * sizeof(int);
 		}
 
 
@@ -254,10 +391,12 @@ public:
       * \param[in]  columns		-- Pointer to the integer array of which element i is the number of the column that contains the i-th element in the mat_values array.
 	  * \param[in]  x 			-- Pointer to rhs vector
 	  * \param[out] y 			-- Pointer to solution vector
+	  * \param[in]  nrhs		-- Number of right hand sides stored one after the other in b and x
+	  * \param[in]  transpose	-- Solve A^T * x = b with the factors of A (iparm(12) = 2)
 	  * \return std vector
 	  * \author Aditya Ghantasala
 	  ***********/
-	 void solve(bool isSymmetric, int m, double *mat_values, int *rowIndex, int* columns, double* x, double * b) { //Computes x=A^-1 *b
+	 void solve(bool isSymmetric, int m, double *mat_values, int *rowIndex, int* columns, double* x, double * b, int nrhs = 1, bool transpose = false) { //Computes x=A^-1 *b
 
 		 // Factorizing in L and U
 		 //factorize(isSymmetric, m, mat_values, rowIndex, columns);
@@ -265,10 +404,14 @@ public:
 		 pardiso_phase = 33; // forward and backward substitution
 		 pardiso_error = 0;
 		 pardiso_iparm[5] = 0; // write solution to b if true otherwise to x // TODO 6 for new version of pardiso and 5 for old
-		 mkl_set_num_threads(1); // set number of threads to 1 for mkl call only
+		 pardiso_nrhs = nrhs; // all right hand sides are solved with one forward and backward substitution
+		 pardiso_iparm[11] = transpose ? 2 : 0; // the transposed system reuses the factors of A
+		 mkl_set_num_threads(settings.numThreads); // the threads of the settings for the mkl call only
 		 pardiso(pardiso_pt, &pardiso_maxfct, &pardiso_mnum, &pardiso_mtype, &pardiso_phase,
 				 &pardiso_neq, mat_values, rowIndex, columns, &pardiso_idum,
 				 &pardiso_nrhs, pardiso_iparm, &pardiso_msglvl, b, x, &pardiso_error);
+		 pardiso_nrhs = 1;
+		 pardiso_iparm[11] = 0;
 
 		 // Checking if the solve is successfull or not.
 		 if (pardiso_error != 0) {
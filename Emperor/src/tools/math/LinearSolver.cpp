@@ -0,0 +1,212 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <assert.h>
+#include <cmath>
+#include <unistd.h>
+#include "LinearSolver.h"
+#include "Message.h"
+#ifdef USE_EIGEN
+#include <Eigen/Sparse>
+#include <Eigen/SparseLU>
+#endif
+
+using namespace std;
+
+namespace EMPIRE {
+namespace MathLibrary {
+
+const string LinearSolverRegistry::DIRECT = "direct";
+const string LinearSolverRegistry::AUTOMATIC = "auto";
+const double LinearSolverRegistry::AUTOMATIC_ITERATIVE_TOLERANCE = 1E-10;
+const int LinearSolverRegistry::AUTOMATIC_ITERATIVE_MAX_ITERATIONS = 1000;
+
+#ifdef USE_EIGEN
+/********//**
+ * \brief Class EigenSparseLUSolver factorizes by the supernodal sparse LU decomposition of Eigen
+ *        with COLAMD ordering, which is much faster than the sparse QR decomposition the Eigen
+ *        backend of SparseMatrix uses for unsymmetric matrices. The ordering and the symbolic
+ *        factorization are kept as long as the sparsity pattern does not change. The transpose is
+ *        factorized by the first transposed solve.
+ ***********/
+class EigenSparseLUSolver : public LinearSolver {
+public:
+    typedef Eigen::SparseMatrix<double, Eigen::ColMajor, int> SpMat;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorMatrix;
+
+    EigenSparseLUSolver() :
+            transposeLU(NULL), isAnalyzed(false), isTransposeFactorized(false) {
+    }
+    ~EigenSparseLUSolver() {
+        delete transposeLU;
+    }
+    void factorize(int numRows, const vector<int> &rowPtr, const vector<int> &cols,
+            const vector<double> &values, bool isSymmetric) {
+        vector<Eigen::Triplet<double> > triplets;
+        triplets.reserve(isSymmetric ? 2 * values.size() : values.size());
+        for (int i = 0; i < numRows; i++) {
+            for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                triplets.push_back(Eigen::Triplet<double>(i, cols[k], values[k]));
+                if (isSymmetric && cols[k] != i)
+                    triplets.push_back(Eigen::Triplet<double>(cols[k], i, values[k]));
+            }
+        }
+        A.resize(numRows, numRows);
+        A.setFromTriplets(triplets.begin(), triplets.end());
+        A.makeCompressed();
+
+        if (!isAnalyzed || rowPtr != analyzedRowPtr || cols != analyzedCols) {
+            lu.analyzePattern(A);
+            analyzedRowPtr = rowPtr;
+            analyzedCols = cols;
+            isAnalyzed = true;
+            isTransposeFactorized = false;
+            delete transposeLU;
+            transposeLU = NULL;
+        }
+        lu.factorize(A);
+        if (lu.info() != Eigen::Success) {
+            ERROR_OUT() << "Error eigenSparseLU factorization failed: " << lu.lastErrorMessage()
+                    << endl;
+            exit(EXIT_FAILURE);
+        }
+        // the factors of the transpose are computed again by the next transposed solve
+        isTransposeFactorized = false;
+    }
+    void solve(double *X, const double *B, int numVecs, bool transpose) {
+        const int numRows = A.rows();
+        // the supernodal solve needs column major vectors
+        Eigen::MatrixXd b = Eigen::Map<const RowMajorMatrix>(B, numRows, numVecs);
+        Eigen::MatrixXd x;
+        if (!transpose) {
+            x = lu.solve(b);
+            Eigen::Map<RowMajorMatrix>(X, numRows, numVecs) = x;
+            return;
+        }
+        if (!isTransposeFactorized) {
+            if (transposeLU == NULL) {
+                transposeLU = new Eigen::SparseLU<SpMat, Eigen::COLAMDOrdering<int> >;
+                transposeLU->analyzePattern(SpMat(A.transpose()));
+            }
+            transposeLU->factorize(SpMat(A.transpose()));
+            if (transposeLU->info() != Eigen::Success) {
+                ERROR_OUT() << "Error eigenSparseLU factorization of the transpose failed: "
+                        << transposeLU->lastErrorMessage() << endl;
+                exit(EXIT_FAILURE);
+            }
+            isTransposeFactorized = true;
+        }
+        x = transposeLU->solve(b);
+        Eigen::Map<RowMajorMatrix>(X, numRows, numVecs) = x;
+    }
+    size_t getFactorMemory() const {
+        size_t numFactorEntries = 0;
+        if (isAnalyzed)
+            numFactorEntries += lu.nnzL() + lu.nnzU();
+        if (isTransposeFactorized)
+            numFactorEntries += transposeLU->nnzL() + transposeLU->nnzU();
+        return numFactorEntries * (sizeof(double) + sizeof(int))
+                + A.nonZeros() * (sizeof(double) + sizeof(int))
+                + (analyzedRowPtr.capacity() + analyzedCols.capacity()) * sizeof(int);
+    }
+
+private:
+    /// the full matrix, kept for the factorization of its transpose
+    SpMat A;
+    /// the factorization of A
+    Eigen::SparseLU<SpMat, Eigen::COLAMDOrdering<int> > lu;
+    /// the factorization of A^T, NULL until the first transposed solve
+    Eigen::SparseLU<SpMat, Eigen::COLAMDOrdering<int> > *transposeLU;
+    /// whether lu holds the analysis of the pattern in analyzedRowPtr and analyzedCols
+    bool isAnalyzed;
+    /// whether transposeLU holds the factors of the current values
+    bool isTransposeFactorized;
+    /// the pattern of the analysis
+    vector<int> analyzedRowPtr;
+    vector<int> analyzedCols;
+
+    EigenSparseLUSolver(const EigenSparseLUSolver&);
+    EigenSparseLUSolver& operator=(const EigenSparseLUSolver&);
+};
+
+/***********************************************************************************************
+ * \brief Create an EigenSparseLUSolver
+ ***********/
+static LinearSolver *createEigenSparseLUSolver() {
+    return new EigenSparseLUSolver();
+}
+#endif
+
+map<string, LinearSolverRegistry::Creator> &LinearSolverRegistry::getSolvers() {
+    static map<string, Creator> solvers;
+    static bool isInitialized = false;
+    if (!isInitialized) {
+        isInitialized = true;
+#ifdef USE_EIGEN
+        solvers["eigenSparseLU"] = createEigenSparseLUSolver;
+#endif
+    }
+    return solvers;
+}
+
+void LinearSolverRegistry::registerSolver(const string &name, Creator creator) {
+    assert(name != DIRECT && name != AUTOMATIC);
+    assert(creator != NULL);
+    getSolvers()[name] = creator;
+}
+
+bool LinearSolverRegistry::isKnown(const string &name) {
+    return name == DIRECT || name == AUTOMATIC || isRegistered(name);
+}
+
+bool LinearSolverRegistry::isRegistered(const string &name) {
+    return getSolvers().find(name) != getSolvers().end();
+}
+
+LinearSolver *LinearSolverRegistry::create(const string &name) {
+    map<string, Creator>::const_iterator it = getSolvers().find(name);
+    assert(it != getSolvers().end());
+    return it->second();
+}
+
+string LinearSolverRegistry::getKnownNames() {
+    string names = DIRECT + ", " + AUTOMATIC;
+    for (map<string, Creator>::const_iterator it = getSolvers().begin();
+            it != getSolvers().end(); it++)
+        names += ", " + it->first;
+    return names;
+}
+
+bool LinearSolverRegistry::isDirectFactorizationFeasible(size_t numRows, size_t numEntries) {
+#ifdef _SC_AVPHYS_PAGES
+    long availablePages = sysconf(_SC_AVPHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (availablePages <= 0 || pageSize <= 0)
+        return true;
+    double fillIn = max(1.0, log((double) numRows) / log(2.0));
+    double factorMemory = fillIn * numEntries * (sizeof(double) + sizeof(int));
+    return factorMemory <= 0.5 * (double) availablePages * (double) pageSize;
+#else
+    return true;
+#endif
+}
+
+} /* namespace MathLibrary */
+} /* namespace EMPIRE */
@@ -0,0 +1,176 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file LinearSolver.h
+ * This file holds the class LinearSolver and the class LinearSolverRegistry
+ * \date 10/15/2026
+ **************************************************************************************************/
+#ifndef LINEARSOLVER_H_
+#define LINEARSOLVER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace EMPIRE {
+namespace MathLibrary {
+
+/********//**
+ * \brief The settings of the PARDISO factorization of SparseMatrix, the other solvers ignore them
+ ***********/
+struct PardisoSettings {
+    /// the fill-in reducing orderings, the values of iparm[1]
+    enum Ordering {
+        MINIMUM_DEGREE = 0, NESTED_DISSECTION = 2, PARALLEL_NESTED_DISSECTION = 3
+    };
+    /// where the factors are stored, the values of iparm[59]
+    enum OutOfCoreMode {
+        /// in memory
+        IN_CORE = 0,
+        /// in memory if they fit into outOfCoreMaxCoreSize, otherwise on disk
+        AUTOMATIC_OUT_OF_CORE = 1,
+        /// on disk
+        OUT_OF_CORE = 2
+    };
+    /***********************************************************************************************
+     * \brief Constructor, the settings EMPIRE used before they were configurable
+     ***********/
+    PardisoSettings() :
+            numThreads(1), ordering(NESTED_DISSECTION), outOfCoreMode(IN_CORE),
+            outOfCoreDirectory("."), outOfCoreMaxCoreSize(0), twoLevelFactorization(false) {
+    }
+    /// the number of MKL threads of the factorization and the solves
+    int numThreads;
+    /// the fill-in reducing ordering
+    Ordering ordering;
+    /// where the factors are stored
+    OutOfCoreMode outOfCoreMode;
+    /// the directory of the files of the out-of-core factors
+    std::string outOfCoreDirectory;
+    /// the memory in MB the out-of-core factorization may use, 0 for the default of MKL (2000 MB)
+    int outOfCoreMaxCoreSize;
+    /// whether the two-level factorization is used, which scales better on more than eight threads
+    bool twoLevelFactorization;
+};
+
+/********//**
+ * \brief Class LinearSolver is the interface of a sparse solver a SparseMatrix can use instead of
+ *        the direct solver it is compiled with (PARDISO or Eigen). The matrix is handed over in
+ *        zero-based CSR format when it is factorized, the solver keeps what it needs for the solves.
+ ***********/
+class LinearSolver {
+public:
+    /***********************************************************************************************
+     * \brief Destructor
+     ***********/
+    virtual ~LinearSolver() {
+    }
+    /***********************************************************************************************
+     * \brief Factorize a square matrix, called again whenever the values changed
+     * \param[in] numRows the number of rows and columns
+     * \param[in] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+     * \param[in] cols the column of each entry, ascending in each row
+     * \param[in] values the value of each entry
+     * \param[in] isSymmetric whether only the upper triangular part of a symmetric matrix is given
+     ***********/
+    virtual void factorize(int numRows, const std::vector<int> &rowPtr,
+            const std::vector<int> &cols, const std::vector<double> &values, bool isSymmetric) = 0;
+    /***********************************************************************************************
+     * \brief Solve A * X = B or A^T * X = B with the factorization
+     * \param[out] X interleaved solution vectors, entry i of vector k is X[i * numVecs + k]
+     * \param[in] B interleaved right hand side vectors
+     * \param[in] numVecs the number of right hand sides
+     * \param[in] transpose whether the transposed system is solved
+     ***********/
+    virtual void solve(double *X, const double *B, int numVecs, bool transpose) = 0;
+    /***********************************************************************************************
+     * \brief Get the memory of the factorization in bytes
+     ***********/
+    virtual size_t getFactorMemory() const = 0;
+};
+
+/********//**
+ * \brief Class LinearSolverRegistry holds the solvers which can be selected by name at runtime,
+ *        e.g. by the linearSolver attribute of a mapper in the input file. Besides the registered
+ *        solvers there are two names, DIRECT for the direct solver SparseMatrix is compiled with
+ *        and AUTOMATIC, which takes the direct solver if its factorization fits into the available
+ *        memory and otherwise the conjugate gradient solver of SparseMatrix for symmetric matrices.
+ *        Solvers of further libraries are added by registerSolver before the input is read.
+ ***********/
+class LinearSolverRegistry {
+public:
+    /// creates a new solver of a registered type
+    typedef LinearSolver *(*Creator)();
+    /// the name of the direct solver SparseMatrix is compiled with
+    static const std::string DIRECT;
+    /// the name of the choice between the direct solver and the conjugate gradient solver
+    static const std::string AUTOMATIC;
+    /// the relative residual tolerance of the conjugate gradient solver chosen by AUTOMATIC
+    static const double AUTOMATIC_ITERATIVE_TOLERANCE;
+    /// the maximum number of iterations of the conjugate gradient solver chosen by AUTOMATIC
+    static const int AUTOMATIC_ITERATIVE_MAX_ITERATIONS;
+    /***********************************************************************************************
+     * \brief Register a solver, a solver registered before under the same name is replaced
+     * \param[in] name the name the solver is selected by
+     * \param[in] creator creates a new solver
+     ***********/
+    static void registerSolver(const std::string &name, Creator creator);
+    /***********************************************************************************************
+     * \brief Whether a name is DIRECT, AUTOMATIC or the name of a registered solver
+     ***********/
+    static bool isKnown(const std::string &name);
+    /***********************************************************************************************
+     * \brief Whether a name is the name of a registered solver
+     ***********/
+    static bool isRegistered(const std::string &name);
+    /***********************************************************************************************
+     * \brief Create a new registered solver, owned by the caller
+     * \param[in] name the name of a registered solver
+     * \return the solver
+     ***********/
+    static LinearSolver *create(const std::string &name);
+    /***********************************************************************************************
+     * \brief Get all known names separated by commas, e.g. for error messages
+     ***********/
+    static std::string getKnownNames();
+    /***********************************************************************************************
+     * \brief Whether the factors of a direct solver are expected to fit into the available memory.
+     *        The fill-in of a nested dissection ordering of a mesh matrix is estimated by
+     *        log2(numRows) times the number of entries.
+     * \param[in] numRows the number of rows
+     * \param[in] numEntries the number of stored entries
+     * \return true if the factors take at most half of the available physical memory or the
+     *         available memory is unknown
+     ***********/
+    static bool isDirectFactorizationFeasible(size_t numRows, size_t numEntries);
+
+private:
+    /***********************************************************************************************
+     * \brief Get the registered solvers, the solvers of the compiled libraries are registered by
+     *        the first call
+     ***********/
+    static std::map<std::string, Creator> &getSolvers();
+};
+
+} /* namespace MathLibrary */
+} /* namespace EMPIRE */
+
+#endif /* LINEARSOLVER_H_ */
@@ -27,6 +27,7 @@
 #define MATHLIBRARY_H_
 
 #include "FEMMath.h"
+#include "FEMElementKernels.h"
 #include "MatrixVectorMath.h"
 #include "GeometryMath.h"
 #include "ConstantsAndVariables.h"
@@ -26,6 +26,7 @@
 #include "ConstantsAndVariables.h"
 #include "DebugMath.h"
 #include <iostream>
+#include <omp.h>
 using namespace std;
 
 namespace EMPIRE {
@@ -188,6 +189,222 @@ double computeDenseDotProduct(int _length, double* _vecI, double* _vecJ) {
 #endif
 }
 
+#ifdef __INTEL_COMPILER
+// the compensation of the reproducible sums must not be reassociated away
+#pragma float_control(precise, on, push)
+#endif
+namespace {
+/// number of entries of a block of the reproducible sums, independent of the number of threads
+const int REPRODUCIBLE_BLOCK_SIZE = 4096;
+/// number of interleaved compensated sums in a block, updated as one vector
+const int REPRODUCIBLE_LANES = 8;
+
+/********//**
+ * \brief Compensated (Neumaier) sum, used to add up the lanes and the blocks in a fixed order
+ ***********/
+struct CompensatedSum {
+    double sum;
+    double compensation;
+    CompensatedSum() :
+            sum(0.0), compensation(0.0) {
+    }
+    void add(double x) {
+        double t = sum + x;
+        if (fabs(sum) >= fabs(x))
+            compensation += (sum - t) + x;
+        else
+            compensation += (x - t) + sum;
+        sum = t;
+    }
+    double get() const {
+        return sum + compensation;
+    }
+};
+
+/***********************************************************************************************
+ * \brief Compute Kernel::NUM_SUMS sums over the entries 0 to elements-1. kernel(i, terms) writes
+ *        the terms of entry i. The blocks are processed in parallel, each block by
+ *        REPRODUCIBLE_LANES Kahan sums, and the block sums are added in order.
+ * \param[in] kernel the kernel giving the terms of every entry
+ * \param[in] elements number of entries
+ * \param[out] sums the sums
+ ***********/
+template<class Kernel>
+void computeReproducibleSums(const Kernel &kernel, int elements, double *sums) {
+    const int NUM_SUMS = Kernel::NUM_SUMS;
+    const int numBlocks = (elements + REPRODUCIBLE_BLOCK_SIZE - 1) / REPRODUCIBLE_BLOCK_SIZE;
+    std::vector<double> blockSums(2 * NUM_SUMS * numBlocks);
+#pragma omp parallel for schedule(static) num_threads(EMPIRE::AuxiliaryParameters::mapperSetNumThreads) if (numBlocks > 1)
+    for (int b = 0; b < numBlocks; b++) {
+        double laneSums[NUM_SUMS][REPRODUCIBLE_LANES];
+        double laneCompensations[NUM_SUMS][REPRODUCIBLE_LANES];
+        for (int k = 0; k < NUM_SUMS; k++) {
+            for (int l = 0; l < REPRODUCIBLE_LANES; l++) {
+                laneSums[k][l] = 0.0;
+                laneCompensations[k][l] = 0.0;
+            }
+        }
+        double terms[NUM_SUMS][REPRODUCIBLE_LANES];
+        const int begin = b * REPRODUCIBLE_BLOCK_SIZE;
+        const int end = std::min(begin + REPRODUCIBLE_BLOCK_SIZE, elements);
+        for (int i = begin; i < end; i += REPRODUCIBLE_LANES) {
+            const int numLanes = std::min(REPRODUCIBLE_LANES, end - i);
+            for (int l = 0; l < numLanes; l++)
+                kernel(i + l, terms, l);
+            for (int k = 0; k < NUM_SUMS; k++) {
+#pragma omp simd
+                for (int l = 0; l < numLanes; l++) {
+                    double y = terms[k][l] - laneCompensations[k][l];
+                    double t = laneSums[k][l] + y;
+                    laneCompensations[k][l] = (t - laneSums[k][l]) - y;
+                    laneSums[k][l] = t;
+                }
+            }
+        }
+        for (int k = 0; k < NUM_SUMS; k++) {
+            CompensatedSum blockSum;
+            for (int l = 0; l < REPRODUCIBLE_LANES; l++) {
+                blockSum.add(laneSums[k][l]);
+                blockSum.add(-laneCompensations[k][l]);
+            }
+            blockSums[2 * (b * NUM_SUMS + k)] = blockSum.sum;
+            blockSums[2 * (b * NUM_SUMS + k) + 1] = blockSum.compensation;
+        }
+    }
+    for (int k = 0; k < NUM_SUMS; k++) {
+        CompensatedSum sum;
+        for (int b = 0; b < numBlocks; b++) {
+            sum.add(blockSums[2 * (b * NUM_SUMS + k)]);
+            sum.add(blockSums[2 * (b * NUM_SUMS + k) + 1]);
+        }
+        sums[k] = sum.get();
+    }
+}
+
+/********//**
+ * \brief The terms of the squared norm
+ ***********/
+struct SquaredNormKernel {
+    enum {
+        NUM_SUMS = 1
+    };
+    const double *vec;
+    void operator()(int i, double terms[][REPRODUCIBLE_LANES], int lane) const {
+        terms[0][lane] = vec[i] * vec[i];
+    }
+};
+
+/********//**
+ * \brief Computes an entry of the linear combination and the term of its squared norm
+ ***********/
+struct LinearCombinationKernel {
+    enum {
+        NUM_SUMS = 1
+    };
+    double *result;
+    int numVecs;
+    const double * const *vecs;
+    const double *coefficients;
+    void operator()(int i, double terms[][REPRODUCIBLE_LANES], int lane) const {
+        double entry = 0.0;
+        for (int k = 0; k < numVecs; k++)
+            entry += vecs[k][i] * coefficients[k];
+        result[i] = entry;
+        terms[0][lane] = entry * entry;
+    }
+};
+
+/********//**
+ * \brief The terms of d * d and vecOld * d for d = vecOld - vecNew
+ ***********/
+struct DifferenceProductsKernel {
+    enum {
+        NUM_SUMS = 2
+    };
+    const double *vecNew;
+    const double *vecOld;
+    void operator()(int i, double terms[][REPRODUCIBLE_LANES], int lane) const {
+        double difference = vecOld[i] - vecNew[i];
+        terms[0][lane] = difference * difference;
+        terms[1][lane] = vecOld[i] * difference;
+    }
+};
+
+/********//**
+ * \brief The terms of a * a, a * b and b * b
+ ***********/
+struct DotProductsKernel {
+    enum {
+        NUM_SUMS = 3
+    };
+    const double *a;
+    const double *b;
+    void operator()(int i, double terms[][REPRODUCIBLE_LANES], int lane) const {
+        terms[0][lane] = a[i] * a[i];
+        terms[1][lane] = a[i] * b[i];
+        terms[2][lane] = b[i] * b[i];
+    }
+};
+} /* anonymous namespace */
+#ifdef __INTEL_COMPILER
+#pragma float_control(pop)
+#endif
+
+double computeReproducibleSquaredNorm(const double *vec, int elements) {
+    assert(elements >= 0);
+    SquaredNormKernel kernel;
+    kernel.vec = vec;
+    double squaredNorm;
+    computeReproducibleSums(kernel, elements, &squaredNorm);
+    return squaredNorm;
+}
+
+double computeReproducibleLinearCombination(double *result, int numVecs,
+        const double * const *vecs, const double *coefficients, int elements) {
+    assert(elements >= 0);
+    LinearCombinationKernel kernel;
+    kernel.result = result;
+    kernel.numVecs = numVecs;
+    kernel.vecs = vecs;
+    kernel.coefficients = coefficients;
+    double squaredNorm;
+    computeReproducibleSums(kernel, elements, &squaredNorm);
+    return squaredNorm;
+}
+
+void computeReproducibleDifferenceProducts(const double *vecNew, const double *vecOld,
+        int elements, double *differenceSquaredNorm, double *dotProduct) {
+    assert(elements >= 0);
+    DifferenceProductsKernel kernel;
+    kernel.vecNew = vecNew;
+    kernel.vecOld = vecOld;
+    double sums[2];
+    computeReproducibleSums(kernel, elements, sums);
+    *differenceSquaredNorm = sums[0];
+    *dotProduct = sums[1];
+}
+
+void computeReproducibleDotProducts(const double *a, const double *b, int elements, double *aa,
+        double *ab, double *bb) {
+    assert(elements >= 0);
+    DotProductsKernel kernel;
+    kernel.a = a;
+    kernel.b = b;
+    double sums[3];
+    computeReproducibleSums(kernel, elements, sums);
+    *aa = sums[0];
+    *ab = sums[1];
+    *bb = sums[2];
+}
+
+int getNumAssemblyBuffers(int numThreads, int numItems) {
+    return EMPIRE::AuxiliaryParameters::reproducible ? numItems : numThreads;
+}
+
+int getAssemblyBuffer(int item) {
+    return EMPIRE::AuxiliaryParameters::reproducible ? item : omp_get_thread_num();
+}
+
 /***********************************************************************************************
 * \brief Compute the cross product between two vectors in the 3-D space
 * \param[in/out] _product The product of vector1 and vector 2
@@ -359,6 +576,21 @@ void computeTransposeMatrixProduct(int p, int n, int m, const double *A, const d
         }
 }
 
+void accumulateWeightedProducts(int numPoints, int numA, int numB, const double *A,
+        const double *B, const double *weights, bool isUpper, double *C) {
+    for (int i = 0; i < numA; i++) {
+        const double *a = &A[(size_t) i * numPoints];
+        for (int j = isUpper ? i : 0; j < numB; j++) {
+            const double *b = &B[(size_t) j * numPoints];
+            double sum = 0.0;
+#pragma omp simd reduction(+:sum)
+            for (int g = 0; g < numPoints; g++)
+                sum += weights[g] * a[g] * b[g];
+            C[i * numB + j] += sum;
+        }
+    }
+}
+
 /***********************************************************************************************
  * \brief My own sparse matrix (csr format, non-symmetric) vector multiplication routine (A * x = y).
  *        The interface is simplified and compatible with mkl_dcsrmv.
@@ -437,6 +669,163 @@ void dcsrsymv(int n, const double *A, const int *IA, const int *JA, const double
     }
 }
 
+/***********************************************************************************************
+ * \brief Compute the reverse Cuthill-McKee ordering of a sparse matrix, which reduces the bandwidth
+ *        of the matrix and lets the products and solves access the vectors more contiguously. The
+ *        pattern is symmetrized, every connected component starts from a pseudo-peripheral row.
+ * \param[in] n number of rows and columns of the matrix
+ * \param[in] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1 (zero-based)
+ * \param[in] cols the column of each entry (zero-based)
+ * \param[out] order order[k] is the row/column of the matrix which becomes row/column k
+ ***********/
+void computeReverseCuthillMcKeeOrder(int n, const int *rowPtr, const int *cols,
+        std::vector<int> &order) {
+    // adjacency of A + A^T without the diagonal
+    vector<int> degree(n, 0);
+    for (int i = 0; i < n; i++)
+        for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+            if (cols[k] != i) {
+                degree[i]++;
+                degree[cols[k]]++;
+            }
+    vector<int> adjPtr(n + 1, 0);
+    for (int i = 0; i < n; i++)
+        adjPtr[i + 1] = adjPtr[i] + degree[i];
+    vector<int> adj(adjPtr[n]);
+    vector<int> fill(adjPtr.begin(), adjPtr.end() - 1);
+    for (int i = 0; i < n; i++)
+        for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+            if (cols[k] != i) {
+                adj[fill[i]++] = cols[k];
+                adj[fill[cols[k]]++] = i;
+            }
+    // remove the duplicates of entries stored on both sides of the diagonal
+    for (int i = 0; i < n; i++) {
+        sort(adj.begin() + adjPtr[i], adj.begin() + adjPtr[i + 1]);
+        degree[i] = unique(adj.begin() + adjPtr[i], adj.begin() + adjPtr[i + 1]) - adj.begin()
+                - adjPtr[i];
+    }
+
+    order.clear();
+    order.reserve(n);
+    vector<bool> isNumbered(n, false);
+    vector<int> level(n, -1);
+    vector<int> queue;
+    vector<pair<int, int> > neighbours;
+    for (int seed = 0; seed < n; seed++) {
+        if (isNumbered[seed])
+            continue;
+        // find a pseudo-peripheral row of the component by repeated level structures
+        int start = seed;
+        int eccentricity = -1;
+        while (true) {
+            queue.assign(1, start);
+            level[start] = 0;
+            for (size_t q = 0; q < queue.size(); q++) {
+                int i = queue[q];
+                for (int k = adjPtr[i]; k < adjPtr[i] + degree[i]; k++)
+                    if (level[adj[k]] < 0) {
+                        level[adj[k]] = level[i] + 1;
+                        queue.push_back(adj[k]);
+                    }
+            }
+            int lastLevel = level[queue.back()];
+            int next = queue.back();
+            for (size_t q = 0; q < queue.size(); q++) {
+                if (level[queue[q]] == lastLevel && degree[queue[q]] < degree[next])
+                    next = queue[q];
+                level[queue[q]] = -1;
+            }
+            if (lastLevel <= eccentricity)
+                break;
+            eccentricity = lastLevel;
+            start = next;
+        }
+        // Cuthill-McKee: breadth-first, the neighbours by increasing degree
+        size_t head = order.size();
+        order.push_back(start);
+        isNumbered[start] = true;
+        for (; head < order.size(); head++) {
+            int i = order[head];
+            neighbours.clear();
+            for (int k = adjPtr[i]; k < adjPtr[i] + degree[i]; k++)
+                if (!isNumbered[adj[k]])
+                    neighbours.push_back(make_pair(degree[adj[k]], adj[k]));
+            sort(neighbours.begin(), neighbours.end());
+            for (size_t k = 0; k < neighbours.size(); k++) {
+                order.push_back(neighbours[k].second);
+                isNumbered[neighbours[k].second] = true;
+            }
+        }
+    }
+    reverse(order.begin(), order.end());
+}
+
+/***********************************************************************************************
+ * \brief Compute the sparsity pattern of a matrix assembled from element matrices, the symbolic pass
+ *        of the assembly into the CSR format (see SparseMatrix::setPattern). Entry (i, j) exists if
+ *        an element couples the row i with the column j. The rows are computed in parallel, each one
+ *        from its elements only, so that the pattern does not depend on the number of threads.
+ * \param[in] numRows number of rows of the matrix
+ * \param[in] elemRowPtr the rows of element e are elemRows[elemRowPtr[e]] to elemRows[elemRowPtr[e+1]-1]
+ * \param[in] elemRows the rows of all elements (zero-based)
+ * \param[in] elemColPtr the columns of element e are elemCols[elemColPtr[e]] to elemCols[elemColPtr[e+1]-1]
+ * \param[in] elemCols the columns of all elements (zero-based)
+ * \param[in] upperOnly only the upper triangular part is kept, e.g. for a symmetric matrix
+ * \param[in] numThreads the number of threads
+ * \param[out] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+ * \param[out] cols the sorted columns of the entries of every row
+ ***********/
+void computeSparsityPattern(int numRows, const std::vector<int> &elemRowPtr,
+        const std::vector<int> &elemRows, const std::vector<int> &elemColPtr,
+        const std::vector<int> &elemCols, bool upperOnly, int numThreads, std::vector<int> &rowPtr,
+        std::vector<int> &cols) {
+    assert(elemRowPtr.size() == elemColPtr.size());
+    int numElems = elemRowPtr.size() - 1;
+    // the elements of every row in ascending order
+    vector<int> rowElemPtr(numRows + 1, 0);
+    for (int e = 0; e < numElems; e++)
+        for (int k = elemRowPtr[e]; k < elemRowPtr[e + 1]; k++)
+            rowElemPtr[elemRows[k] + 1]++;
+    for (int i = 0; i < numRows; i++)
+        rowElemPtr[i + 1] += rowElemPtr[i];
+    vector<int> rowElems(rowElemPtr[numRows]);
+    vector<int> fill(rowElemPtr.begin(), rowElemPtr.end() - 1);
+    for (int e = 0; e < numElems; e++)
+        for (int k = elemRowPtr[e]; k < elemRowPtr[e + 1]; k++)
+            rowElems[fill[elemRows[k]]++] = e;
+
+    // the columns of every row are merged twice, first to count them and then to store them
+    rowPtr.assign(numRows + 1, 0);
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            for (int i = 0; i < numRows; i++)
+                rowPtr[i + 1] += rowPtr[i];
+            cols.resize(rowPtr[numRows]);
+        }
+#pragma omp parallel num_threads(numThreads)
+        {
+            vector<int> rowCols;
+#pragma omp for schedule(dynamic, 64)
+            for (int i = 0; i < numRows; i++) {
+                rowCols.clear();
+                for (int k = rowElemPtr[i]; k < rowElemPtr[i + 1]; k++) {
+                    int e = rowElems[k];
+                    for (int l = elemColPtr[e]; l < elemColPtr[e + 1]; l++)
+                        if (!upperOnly || elemCols[l] >= i)
+                            rowCols.push_back(elemCols[l]);
+                }
+                sort(rowCols.begin(), rowCols.end());
+                rowCols.erase(unique(rowCols.begin(), rowCols.end()), rowCols.end());
+                if (pass == 0)
+                    rowPtr[i + 1] = rowCols.size();
+                else
+                    copy(rowCols.begin(), rowCols.end(), cols.begin() + rowPtr[i]);
+            }
+        }
+    }
+}
+
 /***********************************************************************************************
  * \brief Solve 3x3 Linear system, Ax = b
  * \param[in] _A Square 3x3 matirx
@@ -29,8 +29,12 @@
 #include <assert.h>
 #include <typeinfo>
 #include <cmath>
+#include <algorithm>
 #include "Message.h"
 #include "AuxiliaryParameters.h"
+#include "MemoryUsage.h"
+#include "LinearSolver.h"
+#include "FixedSizeVectorMath.h"
 // Including Eigen
 #ifdef USE_EIGEN
 #include "EigenAdapter.h"
@@ -105,6 +109,76 @@ double computeDenseEuclideanNorm(int, double*, double*);
  ***********/
 double computeDenseDotProduct(int, double*, double*);
 
+/***********************************************************************************************
+ * \brief Compute the square of the Euclidean norm of a vector in a single parallel pass.
+ *        The entries are summed by compensated summation in blocks of a fixed size and the
+ *        block sums are added in order, such that the result does not depend on the number of
+ *        threads.
+ * \param[in] vec the vector
+ * \param[in] elements number of elements in vec
+ * \return the square of the Euclidean norm
+ ***********/
+double computeReproducibleSquaredNorm(const double *vec, int elements);
+
+/***********************************************************************************************
+ * \brief Compute the linear combination result = sum_k coefficients[k] * vecs[k] and the square
+ *        of its Euclidean norm in a single parallel pass (reproducible as
+ *        computeReproducibleSquaredNorm)
+ * \param[out] result the linear combination
+ * \param[in] numVecs number of vectors
+ * \param[in] vecs the vectors
+ * \param[in] coefficients the coefficient of every vector
+ * \param[in] elements number of elements of every vector
+ * \return the square of the Euclidean norm of result
+ ***********/
+double computeReproducibleLinearCombination(double *result, int numVecs,
+        const double * const *vecs, const double *coefficients, int elements);
+
+/***********************************************************************************************
+ * \brief Compute for the difference d = vecOld - vecNew the products d * d and vecOld * d in a
+ *        single parallel pass without storing d (reproducible as computeReproducibleSquaredNorm)
+ * \param[in] vecNew the new vector
+ * \param[in] vecOld the old vector
+ * \param[in] elements number of elements of the vectors
+ * \param[out] differenceSquaredNorm d * d
+ * \param[out] dotProduct vecOld * d
+ ***********/
+void computeReproducibleDifferenceProducts(const double *vecNew, const double *vecOld,
+        int elements, double *differenceSquaredNorm, double *dotProduct);
+
+/***********************************************************************************************
+ * \brief Compute the products a * a, a * b and b * b of two vectors in a single parallel pass
+ *        (reproducible as computeReproducibleSquaredNorm)
+ * \param[in] a the first vector
+ * \param[in] b the second vector
+ * \param[in] elements number of elements of the vectors
+ * \param[out] aa a * a
+ * \param[out] ab a * b
+ * \param[out] bb b * b
+ ***********/
+void computeReproducibleDotProducts(const double *a, const double *b, int elements, double *aa,
+        double *ab, double *bb);
+
+/***********************************************************************************************
+ * \brief Get the number of triplet buffers of a parallel assembly over items, e.g. elements. The
+ *        entries are collected in one buffer per thread, or in one buffer per item if
+ *        AuxiliaryParameters::reproducible is set. SparseMatrix::addTriplets merges the buffers in
+ *        their order, with one buffer per item the entries are thus summed in the order of the
+ *        items for any number of threads and any schedule.
+ * \param[in] numThreads number of threads of the assembly
+ * \param[in] numItems number of items of the assembly
+ * \return the number of buffers
+ ***********/
+int getNumAssemblyBuffers(int numThreads, int numItems);
+
+/***********************************************************************************************
+ * \brief Get the buffer an item of a parallel assembly collects its entries in, the buffer of the
+ *        calling thread or of the item, see getNumAssemblyBuffers
+ * \param[in] item the item
+ * \return the buffer
+ ***********/
+int getAssemblyBuffer(int item);
+
 /***********************************************************************************************
 * \brief Compute the cross product between two vectors in the 3-D space
 * \param[in/out] _product The product of vector1 and vector 2
@@ -170,6 +244,22 @@ void computeMatrixProduct(int n, int p, int m, const double *A, double *B, doubl
  ***********/
 void computeTransposeMatrixProduct(int p, int n, int m, const double *A, const double *B, double *C);
 
+/***********************************************************************************************
+ * \brief Accumulate the weighted products of a batch of integration points, i.e.
+ *        C[i][j] += sum_g weights[g] * A[i][g] * B[j][g]. The points are the innermost index of
+ *        the flat arrays, so that the sums over them are vectorized.
+ * \param[in] numPoints the number of integration points
+ * \param[in] numA the number of functions in A
+ * \param[in] numB the number of functions in B
+ * \param[in] A the values of the functions at the points, A[i * numPoints + g]
+ * \param[in] B the values of the functions at the points, B[j * numPoints + g]
+ * \param[in] weights the weight of every point
+ * \param[in] isUpper whether only the upper triangle j >= i is accumulated (A is B)
+ * \param[in,out] C the numA x numB matrix in row major order
+ ***********/
+void accumulateWeightedProducts(int numPoints, int numA, int numB, const double *A,
+        const double *B, const double *weights, bool isUpper, double *C);
+
 /***********************************************************************************************
  * \brief My own sparse matrix (csr format, non-symmetric) vector multiplication routine (A * x = y).
  *        The interface is simplified and compatible with mkl_dcsrmv.
@@ -201,6 +291,38 @@ void dcsrmv(char trans, int numRows, int numCols, const double *A, const int *JA
  ***********/
 void dcsrsymv(int n, const double *A, const int *IA, const int *JA, const double *x, double *y);
 
+/***********************************************************************************************
+ * \brief Compute the reverse Cuthill-McKee ordering of a sparse matrix, which reduces the bandwidth
+ *        of the matrix and lets the products and solves access the vectors more contiguously. The
+ *        pattern is symmetrized, every connected component starts from a pseudo-peripheral row.
+ * \param[in] n number of rows and columns of the matrix
+ * \param[in] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1 (zero-based)
+ * \param[in] cols the column of each entry (zero-based)
+ * \param[out] order order[k] is the row/column of the matrix which becomes row/column k
+ ***********/
+void computeReverseCuthillMcKeeOrder(int n, const int *rowPtr, const int *cols,
+        std::vector<int> &order);
+
+/***********************************************************************************************
+ * \brief Compute the sparsity pattern of a matrix assembled from element matrices, the symbolic pass
+ *        of the assembly into the CSR format (see SparseMatrix::setPattern). Entry (i, j) exists if
+ *        an element couples the row i with the column j. The rows are computed in parallel, each one
+ *        from its elements only, so that the pattern does not depend on the number of threads.
+ * \param[in] numRows number of rows of the matrix
+ * \param[in] elemRowPtr the rows of element e are elemRows[elemRowPtr[e]] to elemRows[elemRowPtr[e+1]-1]
+ * \param[in] elemRows the rows of all elements (zero-based)
+ * \param[in] elemColPtr the columns of element e are elemCols[elemColPtr[e]] to elemCols[elemColPtr[e+1]-1]
+ * \param[in] elemCols the columns of all elements (zero-based)
+ * \param[in] upperOnly only the upper triangular part is kept, e.g. for a symmetric matrix
+ * \param[in] numThreads the number of threads
+ * \param[out] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+ * \param[out] cols the sorted columns of the entries of every row
+ ***********/
+void computeSparsityPattern(int numRows, const std::vector<int> &elemRowPtr,
+        const std::vector<int> &elemRows, const std::vector<int> &elemColPtr,
+        const std::vector<int> &elemCols, bool upperOnly, int numThreads, std::vector<int> &rowPtr,
+        std::vector<int> &cols);
+
 /***********************************************************************************************
  * \brief Solve 3x3 Linear system, Ax = b
  * \param[in] _A Square 3x3 matirx
@@ -219,6 +341,23 @@ bool solve3x3LinearSystem(const double* _A, double* _b, double _EPS);
  ***********/
 double det3x3(const double* _A);
 
+/********//**
+ * \brief One entry of a sparse matrix collected during a parallel assembly, see SparseMatrix::addTriplets
+ **************************************************************************************************/
+template<class T>
+struct SparseMatrixTriplet {
+    SparseMatrixTriplet(size_t _row, size_t _column, T _value) :
+            row(_row), column(_column), value(_value) {
+    }
+    /// row-major ordering of the triplets
+    bool operator<(const SparseMatrixTriplet<T>& other) const {
+        return row < other.row || (row == other.row && column < other.column);
+    }
+    size_t row;
+    size_t column;
+    T value;
+};
+
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 /********//**
  * \brief This is a template class does compressed sparse row matrix computations: CSR Format (3-Array Variation)
@@ -250,6 +389,12 @@ public:
         isSymmetric = _isSymmetric;
         isFactorized = false;
         isDetermined = false;
+        isFrozen = false;
+        isIterative = false;
+        iterativeTolerance = 0;
+        iterativeMaxIterations = 0;
+        linearSolverName = LinearSolverRegistry::DIRECT;
+        linearSolver = NULL;
         if (!((typeid(T) == typeid(double)) || (typeid(T) == typeid(float)))) {
             assert(0);
         }
@@ -259,7 +404,7 @@ public:
         rowIndex = new std::vector<int>(m + 1);
         intelMKL = new PardisoAdapter(isSymmetric);
 #elif USE_EIGEN
-        eigenMat = new EigenAdapter<T>(m,n);
+        eigenMat = new EigenAdapter<T>(m,n,isSymmetric);
         isFull = false;
 #endif
     }
@@ -276,6 +421,12 @@ public:
         isSymmetric = false;
         isDetermined = false;
         isFactorized = false;
+        isFrozen = false;
+        isIterative = false;
+        iterativeTolerance = 0;
+        iterativeMaxIterations = 0;
+        linearSolverName = LinearSolverRegistry::DIRECT;
+        linearSolver = NULL;
 #ifdef USE_INTEL_MKL
         mat = new mat_t(m);
         rowIndex = new std::vector<int>(m + 1);
@@ -289,6 +440,7 @@ public:
      * \author Stefan Sicklinger
      ***********/
     virtual ~SparseMatrix() {
+        delete linearSolver;
 #ifdef USE_INTEL_MKL
     	//std::cout<<"Cleaning Pardiso"<<std::endl;
     	if(clearCount > 0){
@@ -326,6 +478,8 @@ public:
     inline T& operator()(size_t i, size_t j) {
         if (i >= m || j >= n)
             assert(0);
+        // A frozen matrix cannot be modified anymore
+        assert(!isFrozen);
 
 #ifdef USE_INTEL_MKL
         if (i > j && isSymmetric == true)
@@ -335,6 +489,9 @@ public:
         return (*mat)[i][j];
 #elif USE_EIGEN
         isDetermined=false;
+        // the lower triangular part is mirrored again by the next determineCSR
+        if (isSymmetric)
+            isFull = false;
         return (*eigenMat)(i,j);
 #endif
     }
@@ -351,9 +508,17 @@ public:
         if (i > j && isSymmetric == true)
             assert(0);
         //not allowed
-        return (*mat)[i][j];
+        if (isFrozen) {
+            for (int k = (*rowIndex)[i] - 1; k < (*rowIndex)[i + 1] - 1; k++)
+                if (columns[k] - 1 == (int)j)
+                    return values[k];
+            return 0;
+        }
+        typename col_t::const_iterator jj = (*mat)[i].find(j);
+        if (jj == (*mat)[i].end())
+            return 0;
+        return (*jj).second;
 #elif USE_EIGEN
-        isDetermined=false;
         return (*eigenMat)(i,j);
 #endif
     }
@@ -364,8 +529,8 @@ public:
      * \author Stefan Sicklinger
      ***********/
     void determineCSR() {
-    	// Check if this function is already called once.
-    	if(isDetermined)
+    	// Check if this function is already called once. A frozen matrix keeps its CSR arrays.
+    	if(isDetermined || isFrozen)
     		return;
 
 #ifdef USE_INTEL_MKL
@@ -398,6 +563,349 @@ public:
 #endif
     }
 
+    /***********************************************************************************************
+     * \brief Finalizes the assembly. The CSR format is built once and the assembly storage is released,
+     *        all subsequent products, solves and row queries operate directly on the compact arrays.
+     *        Writing into a frozen matrix is not allowed.
+     ***********/
+    void freeze() {
+    	if(isFrozen)
+    		return;
+
+    	determineCSR();
+#ifdef USE_INTEL_MKL
+    	delete mat;
+    	mat = NULL;
+#elif USE_EIGEN
+    	eigenMat->freeze();
+#endif
+    	isFrozen = true;
+    }
+
+    /***********************************************************************************************
+     * \brief Returns the flag on whether the matrix is frozen, see freeze()
+     ***********/
+    inline bool getIsFrozen() { return isFrozen; }
+
+    /***********************************************************************************************
+     * \brief Returns the flag on whether only the upper triangular part is stored
+     ***********/
+    inline bool getIsSymmetric() { return isSymmetric; }
+
+    /***********************************************************************************************
+     * \brief Get the number of stored entries, only the upper triangular part if the matrix is
+     *        symmetric. Determines the CSR format if not done yet
+     ***********/
+    size_t getNumberOfNonZeros() {
+    	determineCSR();
+    	size_t numEntries = 0;
+#ifdef USE_INTEL_MKL
+    	numEntries = values.size();
+#elif USE_EIGEN
+    	numEntries = eigenMat->getNumNonZeros();
+#endif
+    	return numEntries;
+    }
+
+    /***********************************************************************************************
+     * \brief Get the heap memory of the matrix broken down by the assembly storage, the CSR arrays,
+     *        the factorization and the preconditioner
+     ***********/
+    MemoryUsage getMemoryUsage() const {
+        MemoryUsage usage;
+#ifdef USE_INTEL_MKL
+        if (mat != NULL) {
+            size_t mapBytes = MemoryUsage::ofVector(*mat);
+            for (size_t i = 0; i < mat->size(); i++)
+                mapBytes += MemoryUsage::ofMap((*mat)[i]);
+            usage.add("assembly storage", mapBytes);
+        }
+        usage.add("CSR arrays", MemoryUsage::ofVector(values) + MemoryUsage::ofVector(columns)
+                + MemoryUsage::ofVector(*rowIndex));
+        if (intelMKL != NULL)
+            usage.add("factorization", intelMKL->getFactorMemory());
+#elif USE_EIGEN
+        usage.add("CSR arrays", eigenMat->getMatrixMemory());
+        usage.add("factorization", eigenMat->getFactorMemory());
+#endif
+        if (linearSolver != NULL)
+            usage.add("factorization of " + linearSolverName, linearSolver->getFactorMemory());
+        usage.add("Jacobi diagonal", MemoryUsage::ofVector(jacobiDiagonal));
+        return usage;
+    }
+
+    /***********************************************************************************************
+     * \brief Solve with the Jacobi preconditioned conjugate gradient method instead of the direct
+     *        solver, so that no factor has to be stored. The matrix must be symmetric positive
+     *        definite, e.g. a mass matrix, but may be stored unsymmetric. The solution vector passed
+     *        to solve() is the initial guess.
+     * \param[in] _tolerance the iteration stops when the residual norm relative to the norm of the
+     *            right hand side is below _tolerance
+     * \param[in] _maxIterations the maximum number of iterations
+     ***********/
+    void setIterativeSolver(double _tolerance, int _maxIterations) {
+    	assert(isSquare);
+    	assert(_tolerance > 0 && _maxIterations > 0);
+    	isIterative = true;
+    	iterativeTolerance = _tolerance;
+    	iterativeMaxIterations = _maxIterations;
+    	isFactorized = false;
+    }
+
+    /***********************************************************************************************
+     * \brief Change the tolerance of the iterative solver set by setIterativeSolver(), e.g. between
+     *        two solves, the Jacobi preconditioner is kept
+     * \param[in] _tolerance the relative residual tolerance
+     ***********/
+    void setIterativeTolerance(double _tolerance) {
+    	assert(isIterative);
+    	assert(_tolerance > 0);
+    	iterativeTolerance = _tolerance;
+    }
+
+    /***********************************************************************************************
+     * \brief Select the solver by its name in the LinearSolverRegistry: LinearSolverRegistry::DIRECT
+     *        for the direct solver the matrix is compiled with, LinearSolverRegistry::AUTOMATIC for
+     *        the direct solver unless its factors are not expected to fit into the available memory,
+     *        in which case a symmetric matrix is solved by the conjugate gradient method, or the
+     *        name of a registered solver. The iterative solver set by setIterativeSolver() takes
+     *        precedence.
+     * \param[in] name the name of the solver
+     ***********/
+    void setLinearSolver(const std::string &name) {
+    	assert(isSquare);
+    	assert(LinearSolverRegistry::isKnown(name));
+    	delete linearSolver;
+    	linearSolver = NULL;
+    	linearSolverName = name;
+    	if (LinearSolverRegistry::isRegistered(name))
+    		linearSolver = LinearSolverRegistry::create(name);
+    	isFactorized = false;
+    }
+
+    /***********************************************************************************************
+     * \brief Returns the name of the solver selected by setLinearSolver()
+     ***********/
+    inline const std::string &getLinearSolver() { return linearSolverName; }
+
+    /***********************************************************************************************
+     * \brief Set the threads, the ordering and the storage of the factors of PARDISO, the next
+     *        factorization analyses the matrix again. The other solvers ignore the settings.
+     * \param[in] settings the settings
+     ***********/
+    void setPardisoSettings(const PardisoSettings &settings) {
+    	pardisoSettings = settings;
+#ifdef USE_INTEL_MKL
+    	intelMKL->setSettings(settings);
+#endif
+    	isFactorized = false;
+    }
+
+    /***********************************************************************************************
+     * \brief Returns the settings of PARDISO, see setPardisoSettings()
+     ***********/
+    inline const PardisoSettings &getPardisoSettings() { return pardisoSettings; }
+
+    /***********************************************************************************************
+     * \brief Returns the flag on whether the iterative solver is used, see setIterativeSolver()
+     ***********/
+    inline bool getIsIterative() { return isIterative; }
+
+    /***********************************************************************************************
+     * \brief Returns the tolerance and the maximum number of iterations of the iterative solver
+     ***********/
+    inline double getIterativeTolerance() { return iterativeTolerance; }
+    inline int getIterativeMaxIterations() { return iterativeMaxIterations; }
+
+    /***********************************************************************************************
+     * \brief Removes all entries, so that a frozen matrix can be assembled again, e.g. after the
+     *        geometry changed. The analysis of the solver is kept, if the new entries have the same
+     *        sparsity pattern the next factorization only redoes the numerical phase.
+     ***********/
+    void resetValues() {
+#ifdef USE_INTEL_MKL
+    	if (mat == NULL)
+    		mat = new mat_t(m);
+    	else
+    		for (size_t i = 0; i < m; i++)
+    			(*mat)[i].clear();
+    	values.clear();
+    	columns.clear();
+#elif USE_EIGEN
+    	eigenMat->resetValues();
+    	isFull = false;
+#endif
+    	jacobiDiagonal.clear();
+    	isFrozen = false;
+    	isDetermined = false;
+    	isFactorized = false;
+    }
+
+    /***********************************************************************************************
+     * \brief Copies the stored entries in zero-based CSR format, e.g. to write them to a file. For
+     *        symmetric matrices only the upper triangular part is copied.
+     * \param[out] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+     * \param[out] cols the column of each entry
+     * \param[out] vals the value of each entry
+     ***********/
+    void getCSR(std::vector<int>& rowPtr, std::vector<int>& cols, std::vector<T>& vals) {
+    	determineCSR();
+#ifdef USE_INTEL_MKL
+    	rowPtr.resize(m + 1);
+    	for (size_t i = 0; i <= m; i++)
+    		rowPtr[i] = (*rowIndex)[i] - 1;
+    	cols.resize(columns.size());
+    	for (size_t k = 0; k < columns.size(); k++)
+    		cols[k] = columns[k] - 1;
+    	vals = values;
+#elif USE_EIGEN
+    	eigenMat->getCSR(rowPtr, cols, vals, isSymmetric);
+#endif
+    }
+
+    /***********************************************************************************************
+     * \brief Fills an empty matrix with entries in zero-based CSR format (see getCSR) and freezes it
+     * \param[in] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+     * \param[in] cols the column of each entry
+     * \param[in] vals the value of each entry
+     ***********/
+    void setCSR(const std::vector<int>& rowPtr, const std::vector<int>& cols, const std::vector<T>& vals) {
+    	assert(!isFrozen);
+    	assert(rowPtr.size() == m + 1);
+    	assert(cols.size() == vals.size() && rowPtr[m] == (int)vals.size());
+    	std::vector<std::vector<SparseMatrixTriplet<T> > > buffers(1);
+    	buffers[0].reserve(vals.size());
+    	for (size_t i = 0; i < m; i++)
+    		for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+    			buffers[0].push_back(SparseMatrixTriplet<T>(i, cols[k], vals[k]));
+    	addTriplets(buffers);
+    	freeze();
+    }
+
+    /***********************************************************************************************
+     * \brief Adds the entries collected in several buffers (e.g. one per thread) to the matrix. Each
+     *        buffer is sorted and its duplicates are summed up in parallel, afterwards the rows of the
+     *        matrix are filled in parallel. The buffers are cleared on return. A symmetric matrix
+     *        only takes the entries of the upper triangular part, so that the element matrices can
+     *        be added as a whole.
+     * \param[in] buffers the triplet buffers, duplicated entries are summed up
+     * \param[in] numThreads the number of threads used for the merge
+     ***********/
+    void addTriplets(std::vector<std::vector<SparseMatrixTriplet<T> > >& buffers, int numThreads = 1) {
+    	// A frozen matrix cannot be modified anymore
+    	assert(!isFrozen);
+    	const int numBuffers = buffers.size();
+
+    	// Sort the buffers row-major and sum up the duplicated entries
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+    	for (int b = 0; b < numBuffers; b++) {
+    		std::vector<SparseMatrixTriplet<T> >& buffer = buffers[b];
+    		if (isSymmetric) {
+    			size_t numUpper = 0;
+    			for (size_t k = 0; k < buffer.size(); k++)
+    				if (buffer[k].row <= buffer[k].column)
+    					buffer[numUpper++] = buffer[k];
+    			buffer.erase(buffer.begin() + numUpper, buffer.end());
+    		}
+    		if (buffer.empty())
+    			continue;
+    		std::stable_sort(buffer.begin(), buffer.end());
+    		size_t last = 0;
+    		for (size_t k = 1; k < buffer.size(); k++) {
+    			if (buffer[k].row == buffer[last].row && buffer[k].column == buffer[last].column)
+    				buffer[last].value += buffer[k].value;
+    			else
+    				buffer[++last] = buffer[k];
+    		}
+    		buffer.erase(buffer.begin() + last + 1, buffer.end());
+    	}
+
+#ifdef USE_INTEL_MKL
+    	// Every thread fills a contiguous block of rows, the rows are independent maps
+#pragma omp parallel for num_threads(numThreads)
+    	for (int t = 0; t < numThreads; t++) {
+    		const size_t rowStart = (m * t) / numThreads;
+    		const size_t rowEnd = (m * (t + 1)) / numThreads;
+    		const SparseMatrixTriplet<T> first(rowStart, 0, 0);
+    		for (int b = 0; b < numBuffers; b++) {
+    			typename std::vector<SparseMatrixTriplet<T> >::const_iterator it =
+    					std::lower_bound(buffers[b].begin(), buffers[b].end(), first);
+    			for (; it != buffers[b].end() && it->row < rowEnd; it++) {
+    				assert(it->row < m && it->column < n);
+    				assert(!(it->row > it->column && isSymmetric));
+    				(*mat)[it->row][it->column] += it->value;
+    			}
+    		}
+    	}
+#elif USE_EIGEN
+    	eigenMat->addTriplets(buffers);
+    	// the lower triangular part is mirrored again by the next determineCSR
+    	isFull = false;
+#endif
+    	for (int b = 0; b < numBuffers; b++)
+    		std::vector<SparseMatrixTriplet<T> >().swap(buffers[b]);
+    	isDetermined = false;
+    	isFactorized = false;
+    }
+
+
+    /***********************************************************************************************
+     * \brief Symbolic pass of the assembly directly into the CSR format, fixes the sparsity pattern of
+     *        an empty matrix, e.g. computed by computeSparsityPattern, with all values zero. The
+     *        numeric pass adds the values by addToEntry, then the matrix is frozen before it is used.
+     *        Unlike the other assembly functions no entry is inserted into the assembly storage.
+     * \param[in] rowPtr the entries of row i are at the positions rowPtr[i] to rowPtr[i+1]-1
+     * \param[in] cols the sorted columns of the entries of every row, of a symmetric matrix only the
+     *            upper triangular part
+     ***********/
+    void setPattern(const std::vector<int>& rowPtr, const std::vector<int>& cols) {
+    	assert(!isFrozen);
+    	assert(rowPtr.size() == m + 1 && rowPtr[m] == (int)cols.size());
+#ifdef USE_INTEL_MKL
+    	delete mat;
+    	mat = NULL;
+    	for (size_t i = 0; i <= m; i++)
+    		(*rowIndex)[i] = rowPtr[i] + 1;
+    	columns.resize(cols.size());
+    	for (size_t k = 0; k < cols.size(); k++)
+    		columns[k] = cols[k] + 1;
+    	values.assign(cols.size(), 0);
+    	isDetermined = true;
+#elif USE_EIGEN
+    	eigenMat->setPattern(rowPtr, cols);
+    	// the lower triangular part is mirrored by the next determineCSR
+    	isFull = false;
+    	isDetermined = false;
+#endif
+    	isFactorized = false;
+    }
+
+    /***********************************************************************************************
+     * \brief Numeric pass of the assembly directly into the CSR format, adds a value to an entry of
+     *        the pattern fixed by setPattern. Several threads may add to the same entry at once. A
+     *        symmetric matrix only takes the entries of the upper triangular part, so that the
+     *        element matrices can be added as a whole.
+     * \param[in] i the row of the entry
+     * \param[in] j the column of the entry
+     * \param[in] value the value added to the entry
+     ***********/
+    void addToEntry(size_t i, size_t j, T value) {
+    	assert(!isFrozen && i < m && j < n);
+    	if (isSymmetric && i > j)
+    		return;
+#ifdef USE_INTEL_MKL
+    	assert(mat == NULL);
+    	const int *first = &columns[0] + (*rowIndex)[i] - 1;
+    	const int *last = &columns[0] + (*rowIndex)[i + 1] - 1;
+    	const int *entry = std::lower_bound(first, last, (int)j + 1);
+    	assert(entry != last && *entry == (int)j + 1);
+    	T &slot = values[entry - &columns[0]];
+#elif USE_EIGEN
+    	T &slot = eigenMat->getEntry(i, j);
+#endif
+#pragma omp atomic
+    	slot += value;
+    }
 
     /***********************************************************************************************
      * \brief This function is a fast alternative to the operator overloading alternative
@@ -428,6 +936,25 @@ public:
     	row_iter ii;
     	col_iter jj;
 
+    	if (isFrozen && isSymmetric) {
+    		dcsrsymv(m, &values[0], &((*rowIndex)[0]), &columns[0], vec, resultVec);
+    		return;
+    	}
+    	if (isFrozen) {
+    		const int* rowPtr = &((*rowIndex)[0]);
+    		for (ii = 0; ii < m; ii++) {
+    			sum = 0;
+    			for (int k = rowPtr[ii] - 1; k < rowPtr[ii + 1] - 1; k++) {
+    				const size_t col = columns[k] - 1;
+    				sum += values[k] * vec[col];
+    				if ((ii != col) && isSymmetric) //not on the main diagonal
+    					resultVec[col] += values[k] * vec[ii];
+    			}
+    			resultVec[ii] += sum;
+    		}
+    		return;
+    	}
+
     	for (ii = 0; ii < m; ii++) {
     		sum = 0;
     		for (jj = (*mat)[ii].begin(); jj != (*mat)[ii].end(); jj++) {
@@ -437,7 +964,7 @@ public:
     				resultVec[(*jj).first] += (*jj).second * vec[ii];
     			}
     		}
-    		resultVec[ii] = sum;
+    		resultVec[ii] += sum;
     	}
 #elif USE_EIGEN
     	eigenMat->mulitplyVec(false, vec, resultVec, elements);
@@ -475,6 +1002,14 @@ public:
     	row_iter ii;
     	col_iter jj;
 
+    	if (isFrozen) {
+    		const int* rowPtr = &((*rowIndex)[0]);
+    		for (ii = 0; ii < m; ii++)
+    			for (int k = rowPtr[ii] - 1; k < rowPtr[ii + 1] - 1; k++)
+    				y[columns[k] - 1] += values[k] * x[ii];
+    		return;
+    	}
+
     	for (ii = 0; ii < m; ii++)
     		for (jj = (*mat)[ii].begin(); jj != (*mat)[ii].end(); jj++)
     			y[(*jj).first] += (*jj).second * x[ii];
@@ -484,9 +1019,79 @@ public:
 
     }
 
+    /***********************************************************************************************
+     * \brief Multiplies the matrix with several vectors in one pass over the matrix, Y = A * X or Y = A^T * X
+     * \param[in] 	-- transpose 	Bool flag specifying if a transpose of the matrix should be multiplied or not.
+     * \param[in] 	-- X 			Interleaved vectors to be multiplied, entry i of vector k is X[i * numVecs + k]
+     * \param[out] 	-- Y 			Interleaved result vectors
+     * \param[in] 	-- numVecs 		Number of vectors stored in X and Y (e.g. the dimension of a vector field)
+     ***********/
+    void multiplyBlock(bool transpose, const T* X, T* Y, size_t numVecs) {
+
+    	assert(X != NULL);
+    	assert(Y != NULL);
+    	assert(numVecs > 0);
+
+    	// Formulating the vectors of the sparse matrix
+    	determineCSR();
+
+#ifdef USE_INTEL_MKL
+    	size_t numRowsY = (transpose && !isSymmetric) ? n : m;
+    	for (size_t iter = 0; iter < numRowsY * numVecs; iter++)
+    		Y[iter] = 0;
+
+    	row_iter ii;
+    	col_iter jj;
+
+    	if (isFrozen) {
+    		const int* rowPtr = &((*rowIndex)[0]);
+    		for (ii = 0; ii < m; ii++) {
+    			for (int kk = rowPtr[ii] - 1; kk < rowPtr[ii + 1] - 1; kk++) {
+    				const T value = values[kk];
+    				const size_t col = columns[kk] - 1;
+    				if (transpose && !isSymmetric) {
+    					for (size_t k = 0; k < numVecs; k++)
+    						Y[col * numVecs + k] += value * X[ii * numVecs + k];
+    				} else {
+    					for (size_t k = 0; k < numVecs; k++)
+    						Y[ii * numVecs + k] += value * X[col * numVecs + k];
+    					if ((ii != col) && isSymmetric) { //not on the main diagonal
+    						for (size_t k = 0; k < numVecs; k++)
+    							Y[col * numVecs + k] += value * X[ii * numVecs + k];
+    					}
+    				}
+    			}
+    		}
+    		return;
+    	}
+
+    	for (ii = 0; ii < m; ii++) {
+    		for (jj = (*mat)[ii].begin(); jj != (*mat)[ii].end(); jj++) {
+    			const T value = (*jj).second;
+    			const size_t col = (*jj).first;
+    			if (transpose && !isSymmetric) {
+    				for (size_t k = 0; k < numVecs; k++)
+    					Y[col * numVecs + k] += value * X[ii * numVecs + k];
+    			} else {
+    				for (size_t k = 0; k < numVecs; k++)
+    					Y[ii * numVecs + k] += value * X[col * numVecs + k];
+    				if ((ii != col) && isSymmetric) { //not on the main diagonal
+    					for (size_t k = 0; k < numVecs; k++)
+    						Y[col * numVecs + k] += value * X[ii * numVecs + k];
+    				}
+    			}
+    		}
+    	}
+#elif USE_EIGEN
+    	eigenMat->multiplyBlock(transpose, X, Y, numVecs);
+#endif
+    }
+
 
     /***********************************************************************************************
-     * \brief This function returns the sum of a requested row of the sparse matrix
+     * \brief This function returns the sum of a requested row of the sparse matrix.
+     *        For a symmetric matrix the entries left of the diagonal are found in the rows above,
+     *        which takes a search in every row above.
      * \param[in] 	-- row 			Row number of the sparse matrix for which sum should be obtained
      * \param[out] 	-- sum 			Sum of the row'th row.
      * \author Aditya Ghantasala
@@ -500,21 +1105,40 @@ public:
     	determineCSR();
 
 #ifdef USE_INTEL_MKL
-    	if (isSymmetric) {
-    		// TODO Check how to return the right value for a symmetric matrix.
+    	if (isFrozen) {
+    		for (int k = (*rowIndex)[row] - 1; k < (*rowIndex)[row + 1] - 1; k++)
+    			sum += values[k];
+    		// the entries left of the diagonal are stored in the column of the rows above
+    		if (isSymmetric)
+    			for (size_t i = 0; i < row; i++)
+    				sum += static_cast<const SparseMatrix<T>&>(*this)(i, row);
+    		return sum;
     	}
     	col_iter jj;
 
    		for (jj = (*mat)[row].begin(); jj != (*mat)[row].end(); jj++)
     		sum += (*jj).second;
+   		if (isSymmetric)
+   			for (size_t i = 0; i < row; i++) {
+   				jj = (*mat)[i].find(row);
+   				if (jj != (*mat)[i].end())
+   					sum += (*jj).second;
+   			}
 #elif USE_EIGEN
-   		eigenMat->getRowSum(row);
+   		sum = eigenMat->getRowSum(row);
 #endif
    		return sum;
     }
 
+    /***********************************************************************************************
+     * \brief Whether a row holds no entries. For a symmetric matrix only the stored upper triangular
+     *        part of the row is checked.
+     * \param[in] 	-- row 			Row number of the sparse matrix
+     ***********/
     bool isRowEmpty(size_t row) {
 #ifdef USE_INTEL_MKL
+    	if (isFrozen)
+    		return (*rowIndex)[row] == (*rowIndex)[row + 1];
     	if((*mat)[row].begin() == (*mat)[row].end())
     		return true;
 		return false;
@@ -531,6 +1155,8 @@ public:
      * \ edit Altug Emiroglu : when a row is deleted isFactorized flag is set to false
      ***********/
     void deleteRow(size_t row){
+    	// A frozen matrix cannot be modified anymore
+    	assert(!isFrozen);
 #ifdef USE_INTEL_MKL
     	(*mat)[row].clear();
 #elif USE_EIGEN
@@ -575,6 +1201,11 @@ public:
     	if (isSymmetric) {
     		// TODO Check how to return the right value for a symmetric matrix.
     	}
+    	if (isFrozen) {
+    		for (int k = (*rowIndex)[row] - 1; k < (*rowIndex)[row + 1] - 1; k++)
+    			values[k] *= fact;
+    		return;
+    	}
     	col_iter jj;
     	T dum;
    		for (jj = (*mat)[row].begin(); jj != (*mat)[row].end(); jj++){
@@ -600,38 +1231,170 @@ public:
         assert(x != NULL);
         assert(b != NULL);
 
-    	if(!isFactorized){
+    	if(!isFactorized)
+    		factorize();
+
+    	if (isIterative) {
+    		solveIterative(x, b);
+    		return;
+    	}
+    	if (linearSolver != NULL) {
+    		linearSolver->solve(x, b, 1, false);
+    		return;
+    	}
+
+    	// Constructing the sparse matrix entities
+    	determineCSR();
 #ifdef USE_INTEL_MKL
+    	intelMKL->solve(isSymmetric, m, &values[0], &((*rowIndex)[0]), &columns[0], x, b);
+#elif USE_EIGEN
+    	eigenMat->solve(x, b);
+#endif
+    }
+
+    /***********************************************************************************************
+     * \brief This function solves for several right hand sides with one call to the solver, A * X = B
+     * \param[out] 	-- X 			Interleaved solution vectors, entry i of vector k is X[i * numVecs + k]
+     * \param[in]  	-- B 			Interleaved right hand side vectors
+     * \param[in] 	-- numVecs 		Number of right hand sides stored in B (e.g. the dimension of a vector field)
+     ***********/
+    void solveBlock(T* X, const T* B, size_t numVecs) { //Computes X=A^-1 *B
+
+        assert(X != NULL);
+        assert(B != NULL);
+        assert(numVecs > 0);
+
+    	if(!isFactorized)
     		factorize();
+
+    	if (isIterative) {
+    		// Each right hand side is solved on its own, starting from its part of X
+    		std::vector<T> x(m);
+    		std::vector<T> b(m);
+    		for (size_t k = 0; k < numVecs; k++) {
+    			for (size_t i = 0; i < m; i++) {
+    				x[i] = X[i * numVecs + k];
+    				b[i] = B[i * numVecs + k];
+    			}
+    			solveIterative(&x[0], &b[0]);
+    			for (size_t i = 0; i < m; i++)
+    				X[i * numVecs + k] = x[i];
+    		}
+    		return;
+    	}
+    	if (linearSolver != NULL) {
+    		linearSolver->solve(X, B, numVecs, false);
+    		return;
+    	}
+
+    	// Constructing the sparse matrix entities
+    	determineCSR();
+#ifdef USE_INTEL_MKL
+    	// PARDISO expects the right hand sides stored one after the other
+    	std::vector<T> rhs(m * numVecs);
+    	std::vector<T> sol(m * numVecs);
+    	for (size_t i = 0; i < m; i++)
+    		for (size_t k = 0; k < numVecs; k++)
+    			rhs[k * m + i] = B[i * numVecs + k];
+    	intelMKL->solve(isSymmetric, m, &values[0], &((*rowIndex)[0]), &columns[0], &sol[0], &rhs[0], numVecs);
+    	for (size_t i = 0; i < m; i++)
+    		for (size_t k = 0; k < numVecs; k++)
+    			X[i * numVecs + k] = sol[k * m + i];
 #elif USE_EIGEN
-    		eigenMat->factorize();
+    	eigenMat->solveBlock(X, B, numVecs);
 #endif
-    		isFactorized = true;
-        }
+    }
+
+    /***********************************************************************************************
+     * \brief Solve the transposed system A^T * x = b with the factorization of A, so that the
+     *        conservative mapping needs neither an explicit transpose nor a second factorization.
+     *        A symmetric matrix and the conjugate gradient solver (which requires a symmetric
+     *        matrix) solve A * x = b.
+     * \param[in,out] x the solution, the initial guess of the iterative solver on input
+     * \param[in] b the right hand side
+     ***********/
+    void solveTranspose(T* x, T* b) { //Computes x=A^-T *b
+        solveTransposeBlock(x, b, 1);
+    }
+
+    /***********************************************************************************************
+     * \brief Solve A^T * X = B for several right hand sides with the factorization of A
+     * \param[out] 	-- X 			Interleaved solution vectors, entry i of vector k is X[i * numVecs + k]
+     * \param[in]  	-- B 			Interleaved right hand side vectors
+     * \param[in] 	-- numVecs 		Number of right hand sides stored in B
+     ***********/
+    void solveTransposeBlock(T* X, const T* B, size_t numVecs) { //Computes X=A^-T *B
+
+        assert(X != NULL);
+        assert(B != NULL);
+        assert(m == n);
+
+    	if (isSymmetric || isIterative) {
+    		if (numVecs == 1)
+    			solve(X, const_cast<T*>(B));
+    		else
+    			solveBlock(X, B, numVecs);
+    		return;
+    	}
+
+    	if(!isFactorized)
+    		factorize();
+    	if (linearSolver != NULL) {
+    		linearSolver->solve(X, B, numVecs, true);
+    		return;
+    	}
 
     	// Constructing the sparse matrix entities
     	determineCSR();
 #ifdef USE_INTEL_MKL
-    	intelMKL->solve(isSymmetric, m, &values[0], &((*rowIndex)[0]), &columns[0], x, b);
+    	// PARDISO expects the right hand sides stored one after the other
+    	std::vector<T> rhs(m * numVecs);
+    	std::vector<T> sol(m * numVecs);
+    	for (size_t i = 0; i < m; i++)
+    		for (size_t k = 0; k < numVecs; k++)
+    			rhs[k * m + i] = B[i * numVecs + k];
+    	intelMKL->solve(isSymmetric, m, &values[0], &((*rowIndex)[0]), &columns[0], &sol[0], &rhs[0], numVecs, true);
+    	for (size_t i = 0; i < m; i++)
+    		for (size_t k = 0; k < numVecs; k++)
+    			X[i * numVecs + k] = sol[k * m + i];
 #elif USE_EIGEN
-    	eigenMat->solve(x, b);
+    	eigenMat->solveTranspose(X, B, numVecs);
 #endif
     }
 
     /***********************************************************************************************
-     * \brief This function factorizes and prepares for a solution
+     * \brief This function factorizes and prepares for a solution. If the matrix was factorized
+     *        before and its sparsity pattern did not change (see resetValues), only the numerical
+     *        factorization is redone. For the iterative solver only the preconditioner is built, a
+     *        solver selected by setLinearSolver() gets the matrix in zero-based CSR format.
      * \author Stefan Sicklinger
      * \ȩdit Aditya Ghantasala
      ***********/
     void factorize() {
+    	if (linearSolverName == LinearSolverRegistry::AUTOMATIC && !isIterative)
+    		chooseAutomaticSolver();
+    	if (isIterative) {
+    		computeJacobiDiagonal();
+    		isFactorized = true;
+    		return;
+    	}
+    	if (linearSolver != NULL) {
+    		std::vector<int> rowPtr, cols;
+    		std::vector<T> vals;
+    		getCSR(rowPtr, cols, vals);
+    		linearSolver->factorize(m, rowPtr, cols, vals, isSymmetric);
+    		isFactorized = true;
+    		return;
+    	}
     	// Constructing the sparse matrix entities
 #ifdef USE_INTEL_MKL
    	determineCSR();
-  	intelMKL->factorize(isSymmetric, m, &values[0], &((*rowIndex)[0]), &columns[0]);
+  	intelMKL->refactorize(isSymmetric, m, &values[0], &((*rowIndex)[0]), &columns[0]);
 #elif USE_EIGEN
     determineCSR();
   	eigenMat->factorize();
 #endif
+    	isFactorized = true;
 
     }
 
@@ -645,7 +1408,8 @@ public:
      * \author Aditya Ghantasala
      ***********/
     void resize(long int startRow, long int startCol, long int numRows, long int numColumns) {
-    	// Constructing the sparse matrix entities
+    	// A frozen matrix cannot be modified anymore
+    	assert(!isFrozen);
 #ifdef USE_INTEL_MKL
     	for(int i=startRow; i<startRow+numRows; i++){
     		for(int j= startCol; j<startCol+numColumns; j++){
@@ -688,6 +1452,18 @@ public:
         size_t ele_row; //elements in current row
         std::cout << std::scientific;
 
+        if (isFrozen) {
+            for (ii = 0; ii < m; ii++) {
+                for (int k = (*rowIndex)[ii] - 1; k < (*rowIndex)[ii + 1] - 1; k++) {
+                    std::cout << ii << ' ';
+                    std::cout << columns[k] - 1 << ' ';
+                    std::cout << values[k] << std::endl;
+                }
+            }
+            std::cout << std::endl;
+            return;
+        }
+
         for (ii = 0; ii < m; ii++) {
             for (jj = (*mat)[ii].begin(); jj != (*mat)[ii].end(); jj++) {
                 std::cout << ii << ' ';
@@ -733,10 +1509,10 @@ public:
         std::cout << std::scientific;
         for (ii_counter = 0; ii_counter < m; ii_counter++) {
             for (jj_counter = 0; jj_counter < n; jj_counter++) {
-                if ((*mat)[ii_counter].find(jj_counter) != (*mat)[ii_counter].end()) {
-                    std::cout << '\t' << (*mat)[ii_counter].find(jj_counter)->second;
-                } else {
+                if (isSymmetric && ii_counter > jj_counter) {
                     std::cout << '\t' << 0.0;
+                } else {
+                    std::cout << '\t' << static_cast<const SparseMatrix<T>&>(*this)(ii_counter, jj_counter);
                 }
             }
             std::cout << std::endl;
@@ -766,12 +1542,12 @@ public:
             	if(jj_counter!=0) ofs<<" ";
                 if(isSymmetric) {
                     if(ii_counter<=jj_counter) {
-                        ofs<<(this->operator()(ii_counter,jj_counter));
+                        ofs<<(static_cast<const SparseMatrix<T>&>(*this)(ii_counter,jj_counter));
                     } else {
-                        ofs<<(this->operator()(jj_counter,ii_counter));
+                        ofs<<(static_cast<const SparseMatrix<T>&>(*this)(jj_counter,ii_counter));
                     }
                 }else{
-                    ofs<<(this->operator()(ii_counter,jj_counter));
+                    ofs<<(static_cast<const SparseMatrix<T>&>(*this)(ii_counter,jj_counter));
                 }
             }
             ofs<<std::endl;
@@ -792,23 +1568,25 @@ public:
         std::ofstream ofs;
         ofs.open(filename.c_str(), std::ofstream::out);
         ofs << std::scientific;
+        determineCSR();
         for (row_iter ii = 0; ii < m; ii++) {
-            for (col_iter jj = (*mat)[ii].begin(); jj != (*mat)[ii].end(); jj++) {
+            for (int k = (*rowIndex)[ii] - 1; k < (*rowIndex)[ii + 1] - 1; k++) {
+                const size_t col = columns[k] - 1;
                 ofs << ii + offset << ' ';
-                ofs << (*jj).first + offset << ' ';
-                ofs << (*jj).second << std::endl;
-                if(isSymmetric && ii != (*jj).first) {
-                	ofs << (*jj).first + offset << ' ';
+                ofs << col + offset << ' ';
+                ofs << values[k] << std::endl;
+                if(isSymmetric && ii != col) {
+                	ofs << col + offset << ' ';
                 	ofs << ii + offset << ' ';
-                	ofs << (*jj).second << std::endl;
+                	ofs << values[k] << std::endl;
                 }
             }
         }
         // Print last value if zero anyway to get right matrix size exported
-        if((*mat)[m-1][n-1] == 0) {
+        if(static_cast<const SparseMatrix<T>&>(*this)(m-1, n-1) == 0) {
             ofs << m-1 + offset << ' ';
             ofs << n-1 + offset << ' ';
-            ofs << (*mat)[m-1][n-1] << std::endl;
+            ofs << 0.0 << std::endl;
         }
         ofs << std::endl;
         ofs.close();
@@ -826,6 +1604,22 @@ private:
     bool isDetermined;
     /// true if the matrix is factorized by intel
     bool isFactorized;
+    /// true if the assembly is finalized and only the CSR format is kept
+    bool isFrozen;
+    /// true if solve() uses the preconditioned conjugate gradient method, see setIterativeSolver()
+    bool isIterative;
+    /// relative residual tolerance of the iterative solver
+    double iterativeTolerance;
+    /// maximum number of iterations of the iterative solver
+    int iterativeMaxIterations;
+    /// inverse diagonal of the matrix, the Jacobi preconditioner of the iterative solver
+    std::vector<T> jacobiDiagonal;
+    /// the name of the solver selected by setLinearSolver()
+    std::string linearSolverName;
+    /// the registered solver selected by setLinearSolver(), NULL for the compiled direct solver
+    LinearSolver *linearSolver;
+    /// the settings of PARDISO
+    PardisoSettings pardisoSettings;
 
     /// number of rows
     size_t m;
@@ -849,17 +1643,104 @@ private:
     bool isFull;
 #endif
 
-#ifdef USE_EIGEN
-    void makeFullMatrix(){
-    	if(!isFull){
-    	if(isSymmetric){
-    		for(int i=0; i<m; i++){
-    			for(int j=0; j<n; j++){
-    				(*eigenMat)(j,i) = (*eigenMat)(i,j);
-    			}
-    		}
+    /***********************************************************************************************
+     * \brief Switch a symmetric matrix to the conjugate gradient method if the factors of the
+     *        direct solver are not expected to fit into the available memory. The conjugate
+     *        gradient method requires a positive definite matrix, as the mass matrices are.
+     ***********/
+    void chooseAutomaticSolver() {
+    	if (!isSymmetric)
+    		return;
+    	determineCSR();
+#ifdef USE_INTEL_MKL
+    	size_t numEntries = values.size();
+#elif USE_EIGEN
+    	size_t numEntries = eigenMat->getNumNonZeros();
+#endif
+    	if (LinearSolverRegistry::isDirectFactorizationFeasible(m, numEntries))
+    		return;
+    	INFO_OUT() << "SparseMatrix: the factors of the matrix of size " << m
+    			<< " do not fit into the available memory, the conjugate gradient method is used"
+    			<< std::endl;
+    	setIterativeSolver(LinearSolverRegistry::AUTOMATIC_ITERATIVE_TOLERANCE,
+    			LinearSolverRegistry::AUTOMATIC_ITERATIVE_MAX_ITERATIONS);
+    }
+
+    /***********************************************************************************************
+     * \brief Compute the inverse diagonal of the matrix for the Jacobi preconditioner
+     ***********/
+    void computeJacobiDiagonal() {
+    	determineCSR();
+    	const SparseMatrix<T> &constThis = *this;
+    	jacobiDiagonal.resize(m);
+    	for (size_t i = 0; i < m; i++) {
+    		T diagonal = constThis(i, i);
+    		jacobiDiagonal[i] = (diagonal != 0) ? 1 / diagonal : 1;
+    	}
+    }
+
+    /***********************************************************************************************
+     * \brief Solve A * x = b by the Jacobi preconditioned conjugate gradient method
+     * \param[in,out] x the initial guess on input, the solution on output
+     * \param[in] b the right hand side
+     ***********/
+    void solveIterative(T* x, const T* b) {
+    	assert(jacobiDiagonal.size() == m);
+    	std::vector<T> r(m), z(m), p(m), q(m);
+    	double normB = 0;
+    	for (size_t i = 0; i < m; i++)
+    		normB += b[i] * b[i];
+    	normB = sqrt(normB);
+    	if (normB == 0) {
+    		for (size_t i = 0; i < m; i++)
+    			x[i] = 0;
+    		return;
     	}
+
+    	mulitplyVec(false, x, &q[0], m);
+    	double rz = 0;
+    	double normR = 0;
+    	for (size_t i = 0; i < m; i++) {
+    		r[i] = b[i] - q[i];
+    		z[i] = jacobiDiagonal[i] * r[i];
+    		p[i] = z[i];
+    		rz += r[i] * z[i];
+    		normR += r[i] * r[i];
+    	}
+    	normR = sqrt(normR);
+
+    	int iteration = 0;
+    	while (normR > iterativeTolerance * normB && iteration < iterativeMaxIterations) {
+    		mulitplyVec(false, &p[0], &q[0], m);
+    		double pq = 0;
+    		for (size_t i = 0; i < m; i++)
+    			pq += p[i] * q[i];
+    		double alpha = rz / pq;
+    		double rzNew = 0;
+    		normR = 0;
+    		for (size_t i = 0; i < m; i++) {
+    			x[i] += alpha * p[i];
+    			r[i] -= alpha * q[i];
+    			z[i] = jacobiDiagonal[i] * r[i];
+    			rzNew += r[i] * z[i];
+    			normR += r[i] * r[i];
+    		}
+    		normR = sqrt(normR);
+    		double beta = rzNew / rz;
+    		rz = rzNew;
+    		for (size_t i = 0; i < m; i++)
+    			p[i] = z[i] + beta * p[i];
+    		iteration++;
     	}
+    	if (normR > iterativeTolerance * normB)
+    		WARNING_OUT() << "SparseMatrix::solve: conjugate gradient method not converged after "
+    				<< iteration << " iterations, relative residual " << normR / normB << std::endl;
+    }
+
+#ifdef USE_EIGEN
+    void makeFullMatrix(){
+    	if(!isFull && isSymmetric)
+    		eigenMat->mirrorUpperToLower();
     }
 
 #endif
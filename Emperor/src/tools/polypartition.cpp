@@ -29,6 +29,10 @@
 using namespace std;
 
 #include "polypartition.h"
+#include "MonotonicArena.h"
+
+using EMPIRE::MonotonicArena;
+using EMPIRE::ArenaAllocator;
 
 #define TPPL_VERTEXTYPE_REGULAR 0
 #define TPPL_VERTEXTYPE_START 1
@@ -576,14 +580,18 @@ int TPPLPartition::Triangulate_OPT(TPPLPoly *poly, list<TPPLPoly> *triangles) {
 	long bestvertex;
 	tppl_float weight,minweight,d1,d2;
 	Diagonal diagonal,newdiagonal;
-	list<Diagonal> diagonals;
 	TPPLPoly triangle;
 	int ret = 1;
 
+	//the dynamic programming table lives in the arena of the thread, it is released at the end of the scope
+	MonotonicArena& arena = MonotonicArena::getThreadArena();
+	MonotonicArena::Scope arenaScope(arena);
+	list<Diagonal, ArenaAllocator<Diagonal> > diagonals((ArenaAllocator<Diagonal>(arena)));
+
 	n = poly->GetNumPoints();
-	dpstates = new DPState *[n];
+	dpstates = arena.allocate<DPState *>(n);
 	for(i=1;i<n;i++) {
-		dpstates[i] = new DPState[i];
+		dpstates[i] = arena.allocate<DPState>(i);
 	}
 
 	//init states and visibility
@@ -653,11 +661,6 @@ int TPPLPartition::Triangulate_OPT(TPPLPoly *poly, list<TPPLPoly> *triangles) {
 				}
 			}
 			if(bestvertex == -1) {
-				for(i=1;i<n;i++) {
-					delete [] dpstates[i];
-				}
-				delete [] dpstates;
-
 				return 0;
 			}
 			
@@ -691,11 +694,6 @@ int TPPLPartition::Triangulate_OPT(TPPLPoly *poly, list<TPPLPoly> *triangles) {
 		}
 	}
 
-	for(i=1;i<n;i++) {
-		delete [] dpstates[i];
-	}
-	delete [] dpstates;
-
 	return ret;
 }
 
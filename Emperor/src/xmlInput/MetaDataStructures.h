@@ -29,6 +29,7 @@
 #define METADATASTRUCTURES_H_
 
 #include "EMPEROR_Enum.h"
+#include "LinearSolver.h"
 
 namespace EMPIRE {
 /*
@@ -51,6 +52,10 @@ struct structClientCode {
         std::string meshNameToCopyFrom;
         bool sendMeshToClient;
         bool triangulateAll;
+        EMPIRE_Mesh_renumbering renumbering;
+        bool partitioned;
+        std::string conditionGPDataCache;
+        int trimmingLinearizationType;
         std::vector<structDataField> dataFields;
     };
     struct structSignal {
@@ -59,6 +64,7 @@ struct structClientCode {
     };
     std::string name;
     bool isRestart; // Flag mentioning if the code is restarted.
+    std::string inProcessLibrary; // shared library of a client running inside the Emperor process
     std::vector<structMesh> meshes;
     std::vector<std::string> initialDataFields;
     std::vector<structSignal> signals;
@@ -73,6 +79,10 @@ struct structDataFieldRef {
     std::string clientCodeName;
     std::string meshName;
     std::string dataFieldName;
+    EMPIRE_DataField_wireFormat wireFormat; // format of the transfer to or from the client
+    int chunkSize; // number of values of a message of the transfer, 0 to transfer all at once
+    bool skipUnchanged; // whether only a flag is transferred if the values have not changed
+    int outputInterval; // output interval in a dataOutput, 0 for the interval of the dataOutput
 };
 
 struct structSignalRef {
@@ -84,11 +94,28 @@ struct structConnectionIO {
     EMPIRE_ConnectionIO_Type type;
     structSignalRef signalRef;
     structDataFieldRef dataFieldRef;
+    structMeshRef meshRef; // the node coordinates of the mesh, only as input of a connection
 };
 
 struct structDataOutput {
     std::string name;
     int interval;
+    EMPIRE_DataOutput_format format;
+    int asyncQueueDepth;
+    int compressionLevel;
+    /// the ADIOS2 engine of the ADIOS2 format, e.g. SST
+    std::string streamEngine;
+    /// only the nodes inside the box [regionMin, regionMax] are written if hasRegionBox
+    bool hasRegionBox;
+    double regionMin[3];
+    double regionMax[3];
+    /// only the nodes of these elements are written if it is not empty
+    std::vector<int> regionElemIDs;
+    /// only every nodeStride-th node of the region is written
+    int nodeStride;
+    /// IGA meshes are written as tessellations with this number of cells per knot span in each
+    /// direction, 0 writes the control nets
+    int igaTessellation;
     std::vector<structConnectionIO> connectionIOs;
 };
 
@@ -132,6 +159,8 @@ struct structMapper {
             int noGPTriangle;
             bool isAutomaticNoGPQuadrilateral;
             int noGPQuadrilateral;
+            bool isAdaptive;
+            double tolAdaptive;
         } propIntegration;
         struct propWeakCurveDirichletConditions {
                 bool isWeakCurveDirichletConditions;
@@ -168,7 +197,25 @@ struct structMapper {
             bool isDomainError;
             bool isCurveError;
             bool isInterfaceError;
+            bool isCompactStorage;
+            int samplingInterval;
+            bool isAtTimeStepEnd;
+            bool isBackground;
         } propErrorComputation;
+        /// sweep of the projection and integration parameters on a sample of the FE elements
+        struct propTuning {
+            bool isTuning;
+            /// the number of FE elements the trial builds use
+            int sampleSize;
+            /// the least share of the sample nodes which are projected onto the NURBS surface
+            double targetProjectionSuccessRate;
+            /// the largest relative difference of the mapped coordinates to the configured parameters
+            double targetMappingError;
+            /// whether the mapper is built with the suggested parameters instead of the configured ones
+            bool isApplied;
+            /// the suggested elements of the IGAMortarMapper block are written to this file if not empty
+            std::string file;
+        } propTuning;
     };
     struct structIGABarycentricMapper {
         struct propProjection {
@@ -184,8 +231,32 @@ struct structMapper {
     struct structCurveSurfaceMapper {
         EMPIRE_CurveSurfaceMapper_type type;
     };
+    struct structRBFMapper {
+        int numNodesPerPatch;
+    };
     std::string name;
     int writeMode;
+    std::string couplingMatricesCache;
+    double iterativeSolverTolerance;
+    int iterativeSolverMaxIterations;
+    double inexactSolveForcing;
+    double inexactSolveMaxTolerance;
+    std::string linearSolver;
+    MathLibrary::PardisoSettings pardiso;
+    bool compactAfterBuild;
+    bool reorderCouplingMatrices;
+    bool singlePrecisionWeights;
+    bool explicitMappingOperator;
+    std::string meshMotionA;
+    std::string meshMotionB;
+    double meshMotionThreshold;
+    int conservationMonitorInterval;
+    double conservationMonitorTolerance;
+    bool buildStatisticsReport;
+    /// whether a mapper with mesh A and mesh B swapped may share the operators of this one
+    bool shareMirrored;
+    /// the client codes the mapping operator is sent to after the build
+    std::vector<std::string> operatorReceivers;
     structMeshRef meshRefA;
     structMeshRef meshRefB;
     EMPIRE_Mapper_type type;
@@ -193,6 +264,7 @@ struct structMapper {
     structIGAMortarMapper IGAMortarMapper;
     structIGABarycentricMapper IGABarycentricMapper;
     structCurveSurfaceMapper curveSurfaceMapper;
+    structRBFMapper RBFMapper;
 };
 
 struct structCouplingAlgorithm {
@@ -202,6 +274,16 @@ struct structCouplingAlgorithm {
     struct structConstantRelaxation {
         double relaxationFactor;
     };
+    struct structIJCSA {
+        int maxRankOfUpdate;
+        /// the solver of the interface Jacobian in the LinearSolverRegistry
+        std::string linearSolver;
+    };
+    struct structIQNILS {
+        double initialRelaxationFactor;
+        int reuseTimeSteps;
+        double filterTolerance;
+    };
     struct structOutput {
         int index;
         structConnectionIO connectionIO;
@@ -218,6 +300,14 @@ struct structCouplingAlgorithm {
         structConnectionIO interfaceJacobianSignal;
         double coefficient;
     };
+    struct structInterfaceJacobianBlock {
+        unsigned int indexRow;
+        unsigned int indexColumn;
+        std::string clientCodeName;
+        std::string jacobianName;
+        /// whether the block is received at every iteration instead of every time step
+        bool isUpdatedEveryIteration;
+    };
 
     // Properties of GMRES algorithm
     // Aditya Ghantasala.
@@ -226,6 +316,7 @@ struct structCouplingAlgorithm {
     	 int maxOuterItter;
     	 int maxInnerItter;
     	 double residualTolerance;
+    	 int recycleDimension;
          std::vector<structConnectionIO> inputs;
          std::vector<structConnectionIO> outputs;
 /*       unsigned int indexRow;
@@ -245,15 +336,21 @@ struct structCouplingAlgorithm {
     EMPIRE_CouplingAlgorithm_type type;
     std::vector<structOutput> outputs;
     std::vector<structInterfaceJacobian> interfaceJacobians;
+    std::vector<structInterfaceJacobianBlock> interfaceJacobianBlocks;
     std::vector<structResidual> residuals;
     structAitken aitken;
     structConstantRelaxation constantRelaxation;
+    structIJCSA ijcsa;
+    structIQNILS iqnils;
     structGMRES gmres;
 };
 
 struct structFilter {
     struct structMappingFilter {
         std::string mapperName;
+        /// map only the change of the input, skipping it if relatively below incrementTolerance
+        bool incremental;
+        double incrementTolerance;
     };
     struct structScalingFilter {
         double factor;
@@ -263,12 +360,18 @@ struct structFilter {
     };
     struct structCopyFilter {
         int signalOffset;
+        /// whether the output data field shares the storage of the input
+        bool alias;
     };
     struct structSetFilter {
         std::vector<double> value;
     };
     struct structDataFieldIntegrationFilter {
         structMeshRef meshRef;
+        /// whether the row sums of the mass matrix are used
+        bool lumped;
+        /// the solver of the mass matrix in the LinearSolverRegistry
+        std::string linearSolver;
     };
     struct structAdditionFilter {
         double a, b;
@@ -289,11 +392,25 @@ struct structFilter {
 struct structExtrapolator {
     std::string name;
     EMPIRE_Extrapolator_type type;
+    /// degree of the polynomialExtrapolator, order of the adamsBashforthExtrapolator
+    int degree;
+    /// number of previous time steps of the polynomialExtrapolator
+    int historyLength;
     std::vector<structConnectionIO> connectionIOs;
 };
 
 struct structConnection {
     std::string name;
+    /// number of time steps between two transfers
+    int exchangeInterval;
+    /// whether the signals of a client are transferred as one bundle
+    bool bundleSignals;
+    /// whether the filters are skipped while the inputs do not change
+    bool skipUnchangedInputs;
+    /// relative change of an input up to which it is unchanged
+    double changeTolerance;
+    /// whether mapping filters in series with explicit operators are composed into one
+    bool chainMappings;
     std::vector<structFilter> filterSequence;
     std::vector<structConnectionIO> inputs;
     std::vector<structConnectionIO> outputs;
@@ -319,6 +436,7 @@ struct structCouplingLogic {
             double maxNumOfIterations;
             std::vector<structCheckResidual> checkResiduals;
         };
+        EMPIRE_IterativeCouplingLoop_schema couplingSchema;
         structConvergenceChecker convergenceChecker;
         std::vector<std::string> convergenceObservers;
         std::vector<std::string> couplingAlgorithmRefs;
@@ -326,6 +444,8 @@ struct structCouplingLogic {
     };
     struct structOptimizationLoop {
         int maxNumOfIterations;
+        /// whether the coupling logics of the sequence are independent designs run concurrently
+        bool concurrentDesigns;
         std::vector<std::string> convergenceSignalReceivers;
         std::string convergenceSignalSender;
         std::vector<std::string> dataOutputRefs;
@@ -20,6 +20,7 @@
  */
 #include <iostream>
 #include <string.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <sstream>
 
@@ -27,12 +28,82 @@
 #include "ticpp.h"
 #include "Message.h"
 #include "AuxiliaryFunctions.h"
+#include "LinearSolver.h"
 
 using namespace std;
 using namespace ticpp;
 
 namespace EMPIRE {
 
+/***********************************************************************************************
+ * \brief Read the linearSolver attribute of an element, the direct solver if absent
+ * \param[in] xmlElement the element
+ * \param[in] owner the name of the owner for the error message
+ * \return the name of the solver in the LinearSolverRegistry
+ ***********/
+static string readLinearSolver(ticpp::Element *xmlElement, const string &owner) {
+    string linearSolver = MathLibrary::LinearSolverRegistry::DIRECT;
+    if (xmlElement != NULL && xmlElement->HasAttribute("linearSolver"))
+        linearSolver = xmlElement->GetAttribute<string>("linearSolver");
+    if (!MathLibrary::LinearSolverRegistry::isKnown(linearSolver)) {
+        ERROR_OUT() << "linearSolver \"" << linearSolver << "\" of " << owner
+                << " is unknown, known are " << MathLibrary::LinearSolverRegistry::getKnownNames()
+                << endl;
+        exit(EXIT_FAILURE);
+    }
+    return linearSolver;
+}
+
+/***********************************************************************************************
+ * \brief Read the pardiso element of a mapper, the default settings if absent
+ * \param[in] xmlPardiso the element, may be NULL
+ * \param[in] owner the name of the owner for the error message
+ * \return the settings
+ ***********/
+static MathLibrary::PardisoSettings readPardisoSettings(ticpp::Element *xmlPardiso,
+        const string &owner) {
+    MathLibrary::PardisoSettings settings;
+    if (xmlPardiso == NULL)
+        return settings;
+    xmlPardiso->GetAttributeOrDefault<int, int>("numThreads", &settings.numThreads, 1);
+    if (settings.numThreads < 1) {
+        ERROR_OUT() << "numThreads of pardiso of " << owner << " must be positive" << endl;
+        exit(EXIT_FAILURE);
+    }
+    string ordering = xmlPardiso->GetAttribute<string>("ordering", false);
+    if (ordering == "minimumDegree") {
+        settings.ordering = MathLibrary::PardisoSettings::MINIMUM_DEGREE;
+    } else if (ordering == "nestedDissection" || ordering == "") {
+        settings.ordering = MathLibrary::PardisoSettings::NESTED_DISSECTION;
+    } else if (ordering == "parallelNestedDissection") {
+        settings.ordering = MathLibrary::PardisoSettings::PARALLEL_NESTED_DISSECTION;
+    } else {
+        ERROR_OUT() << "ordering \"" << ordering << "\" of pardiso of " << owner
+                << " is unknown, known are minimumDegree, nestedDissection, parallelNestedDissection"
+                << endl;
+        exit(EXIT_FAILURE);
+    }
+    string outOfCore = xmlPardiso->GetAttribute<string>("outOfCore", false);
+    if (outOfCore == "false" || outOfCore == "") {
+        settings.outOfCoreMode = MathLibrary::PardisoSettings::IN_CORE;
+    } else if (outOfCore == "auto") {
+        settings.outOfCoreMode = MathLibrary::PardisoSettings::AUTOMATIC_OUT_OF_CORE;
+    } else if (outOfCore == "true") {
+        settings.outOfCoreMode = MathLibrary::PardisoSettings::OUT_OF_CORE;
+    } else {
+        ERROR_OUT() << "outOfCore \"" << outOfCore << "\" of pardiso of " << owner
+                << " is unknown, known are false, auto, true" << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (xmlPardiso->HasAttribute("outOfCoreDirectory"))
+        settings.outOfCoreDirectory = xmlPardiso->GetAttribute<string>("outOfCoreDirectory");
+    xmlPardiso->GetAttributeOrDefault<int, int>("outOfCoreMaxCoreSize",
+            &settings.outOfCoreMaxCoreSize, 0);
+    settings.twoLevelFactorization = (xmlPardiso->GetAttribute<string>("twoLevelFactorization",
+            false) == "true");
+    return settings;
+}
+
 MetaDatabase *MetaDatabase::metaDatabase = NULL;
 
 void MetaDatabase::init(char *inputFileName) {
@@ -40,13 +111,22 @@ void MetaDatabase::init(char *inputFileName) {
     metaDatabase = new MetaDatabase(inputFileName);
 }
 
+void MetaDatabase::reinit(char *inputFileName) {
+    assert(metaDatabase != NULL);
+    MetaDatabase *oldMetaDatabase = metaDatabase;
+    metaDatabase = new MetaDatabase(inputFileName);
+    delete oldMetaDatabase;
+}
+
 MetaDatabase *MetaDatabase::getSingleton() {
     assert(metaDatabase != NULL);
     return metaDatabase;
 }
 
-MetaDatabase::MetaDatabase() {
-    // do nothing
+MetaDatabase::MetaDatabase() :
+        buildProgressInterval(60.0), metricsInterval(10.0), metricsPort(0), ensembleSize(1), ensembleBatchWindow(0.0),
+        checkpointInterval(0), checkpointDirectory("checkpoint"), checkpointNumKept(2),
+        checkpointQueueDepth(1), restartFromCheckpoint(false), bufferPoolMaxMegaBytes(1024) {
 }
 
 MetaDatabase::MetaDatabase(char *inputFileName) {
@@ -56,6 +136,17 @@ MetaDatabase::MetaDatabase(char *inputFileName) {
         /// Fill up data base
         fillServerPortFile();
         fillVerbosity();
+        fillPersistentDataFieldTransfer();
+        fillSharedMemoryDataFieldTransfer();
+        fillPiggybackConvergenceSignal();
+        fillProgressThread();
+        fillProfiling();
+        fillBuildProgress();
+        fillMetrics();
+        fillThreading();
+        fillEnsemble();
+        fillCheckpoint();
+        fillBufferPool();
         fillSettingClientCodesVec();
         fillSettingDataOutputVec();
         fillSettingMapperVec();
@@ -70,7 +161,8 @@ MetaDatabase::MetaDatabase(char *inputFileName) {
 }
 
 MetaDatabase::~MetaDatabase() {
-    metaDatabase = NULL;
+    if (metaDatabase == this)
+        metaDatabase = NULL;
 }
 
 void MetaDatabase::fillServerPortFile() {
@@ -100,6 +192,187 @@ void MetaDatabase::fillVerbosity() {
 
 }
 
+void MetaDatabase::fillPersistentDataFieldTransfer() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "persistentDataFieldTransfer", false);
+    persistentDataFieldTransfer = false;
+    if (pXMLElement != NULL)
+        persistentDataFieldTransfer = AuxiliaryFunctions::CompareStringInsensitive(
+                pXMLElement->GetText(false), "yes");
+}
+
+void MetaDatabase::fillSharedMemoryDataFieldTransfer() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "sharedMemoryDataFieldTransfer", false);
+    sharedMemoryDataFieldTransfer = false;
+    if (pXMLElement != NULL)
+        sharedMemoryDataFieldTransfer = AuxiliaryFunctions::CompareStringInsensitive(
+                pXMLElement->GetText(false), "yes");
+}
+
+void MetaDatabase::fillPiggybackConvergenceSignal() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "piggybackConvergenceSignal", false);
+    piggybackConvergenceSignal = false;
+    if (pXMLElement != NULL)
+        piggybackConvergenceSignal = AuxiliaryFunctions::CompareStringInsensitive(
+                pXMLElement->GetText(false), "yes");
+}
+
+void MetaDatabase::fillProgressThread() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "progressThread", false);
+    progressThread = false;
+    if (pXMLElement != NULL)
+        progressThread = AuxiliaryFunctions::CompareStringInsensitive(pXMLElement->GetText(false),
+                "yes");
+}
+
+void MetaDatabase::fillProfiling() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "profiling", false);
+    profiling = false;
+    profilingCSVFile = "";
+    profilingTraceFile = "";
+    profilingHardwareCounters = false;
+    profilingFPOpsEvent = 0;
+    if (pXMLElement != NULL) {
+        profiling = AuxiliaryFunctions::CompareStringInsensitive(pXMLElement->GetText(false), "yes");
+        profilingCSVFile = pXMLElement->GetAttribute<string>("csvFile", false);
+        profilingTraceFile = pXMLElement->GetAttribute<string>("traceFile", false);
+        profilingHardwareCounters = (pXMLElement->GetAttribute<string>("hardwareCounters", false)
+                == "true");
+        // the raw event code is usually given in hexadecimal
+        string fpOpsEvent = pXMLElement->GetAttribute<string>("fpOpsEvent", false);
+        if (!fpOpsEvent.empty())
+            profilingFPOpsEvent = strtoull(fpOpsEvent.c_str(), NULL, 0);
+    }
+}
+
+void MetaDatabase::fillBuildProgress() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "buildProgress", false);
+    buildProgressInterval = 60.0;
+    buildProgressFile = "";
+    if (pXMLElement != NULL) {
+        if (pXMLElement->HasAttribute("interval"))
+            buildProgressInterval = pXMLElement->GetAttribute<double>("interval");
+        buildProgressFile = pXMLElement->GetAttribute<string>("file", false);
+    }
+}
+
+void MetaDatabase::fillMetrics() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "metrics", false);
+    metricsFile = "";
+    metricsInterval = 10.0;
+    metricsPort = 0;
+    if (pXMLElement != NULL) {
+        metricsFile = pXMLElement->GetAttribute<string>("file", false);
+        if (pXMLElement->HasAttribute("interval"))
+            metricsInterval = pXMLElement->GetAttribute<double>("interval");
+        if (pXMLElement->HasAttribute("port"))
+            metricsPort = pXMLElement->GetAttribute<int>("port");
+        if (metricsInterval <= 0.0 || metricsPort < 0 || metricsPort > 65535) {
+            ERROR_OUT() << "interval of metrics must be positive and port between 0 and 65535"
+                    << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void MetaDatabase::fillThreading() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "threading", false);
+    numThreads = 1;
+    mklNumThreads = 1;
+    threadPinning = false;
+    numaInterleave = false;
+    hugePages = false;
+    reproducible = false;
+    if (pXMLElement != NULL) {
+        if (pXMLElement->HasAttribute("numThreads"))
+            numThreads = pXMLElement->GetAttribute<int>("numThreads");
+        if (pXMLElement->HasAttribute("mklNumThreads"))
+            mklNumThreads = pXMLElement->GetAttribute<int>("mklNumThreads");
+        threadPinning = (pXMLElement->GetAttribute<string>("pinning", false) == "true");
+        numaInterleave = (pXMLElement->GetAttribute<string>("numaInterleave", false) == "true");
+        hugePages = (pXMLElement->GetAttribute<string>("hugePages", false) == "true");
+        reproducible = (pXMLElement->GetAttribute<string>("reproducible", false) == "true");
+        if (numThreads < 1 || mklNumThreads < 1) {
+            ERROR_OUT() << "numThreads and mklNumThreads of threading must be positive" << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void MetaDatabase::fillEnsemble() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "ensemble", false);
+    ensembleSize = 1;
+    ensembleBatchWindow = 0.01;
+    if (pXMLElement != NULL) {
+        ensembleSize = pXMLElement->GetAttribute<int>("numReplicas");
+        if (pXMLElement->HasAttribute("batchWindow"))
+            ensembleBatchWindow = pXMLElement->GetAttribute<double>("batchWindow");
+        if (ensembleSize < 1 || ensembleBatchWindow < 0.0) {
+            ERROR_OUT() << "numReplicas of ensemble must be positive and batchWindow non-negative"
+                    << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void MetaDatabase::fillCheckpoint() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "checkpoint", false);
+    checkpointInterval = 0;
+    checkpointDirectory = "checkpoint";
+    checkpointNumKept = 2;
+    checkpointQueueDepth = 1;
+    restartFromCheckpoint = false;
+    if (pXMLElement != NULL) {
+        checkpointInterval = pXMLElement->GetAttribute<int>("interval");
+        if (pXMLElement->HasAttribute("directory"))
+            checkpointDirectory = pXMLElement->GetAttribute<string>("directory");
+        if (pXMLElement->HasAttribute("numKept"))
+            checkpointNumKept = pXMLElement->GetAttribute<int>("numKept");
+        if (pXMLElement->HasAttribute("queueDepth"))
+            checkpointQueueDepth = pXMLElement->GetAttribute<int>("queueDepth");
+        restartFromCheckpoint = (pXMLElement->GetAttribute<string>("restart", false) == "true");
+        if (checkpointInterval < 0 || checkpointNumKept < 1 || checkpointQueueDepth < 0
+                || checkpointDirectory.empty()) {
+            ERROR_OUT() << "interval and queueDepth of checkpoint must be non-negative, numKept "
+                    << "positive and directory not empty" << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void MetaDatabase::fillBufferPool() {
+    Element *pXMLElement =
+            inputFile->FirstChildElement()->FirstChildElement("general")->FirstChildElement(
+                    "bufferPool", false);
+    bufferPoolMaxMegaBytes = 1024;
+    if (pXMLElement != NULL) {
+        bufferPoolMaxMegaBytes = pXMLElement->GetAttribute<int>("maxMegaBytes");
+        if (bufferPoolMaxMegaBytes < 0) {
+            ERROR_OUT() << "maxMegaBytes of bufferPool must be non-negative" << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
 bool MetaDatabase::checkForClientCodeName(std::string clientName) {
     for (int i = 0; i < settingClientCodeVec.size(); i++)
         if (settingClientCodeVec[i].name == clientName)
@@ -122,6 +395,7 @@ void MetaDatabase::fillSettingClientCodesVec() {
         	else
         		clientCode.isRestart = false;
         }
+        clientCode.inProcessLibrary = xmlClientCode->GetAttribute<string>("inProcessLibrary", false);
 
         ticpp::Iterator<Element> xmlMesh("mesh");
 
@@ -202,6 +476,45 @@ void MetaDatabase::fillSettingClientCodesVec() {
             } else {
                 mesh.triangulateAll = false;
             }
+            mesh.renumbering = EMPIRE_Mesh_noRenumbering;
+            if (xmlMesh->HasAttribute("renumbering")) {
+                string tmp = xmlMesh->GetAttribute<string>("renumbering");
+                if (tmp == "none") {
+                    mesh.renumbering = EMPIRE_Mesh_noRenumbering;
+                } else if (tmp == "morton") {
+                    mesh.renumbering = EMPIRE_Mesh_mortonRenumbering;
+                } else if (tmp == "hilbert") {
+                    mesh.renumbering = EMPIRE_Mesh_hilbertRenumbering;
+                } else {
+                    assert(false);
+                }
+            }
+            mesh.partitioned = false;
+            if (xmlMesh->HasAttribute("partitioned")) {
+                string tmp = xmlMesh->GetAttribute<string>("partitioned");
+                if (tmp == "true") {
+                    mesh.partitioned = true;
+                } else if (tmp == "false") {
+                    mesh.partitioned = false;
+                } else {
+                    assert(false);
+                }
+                assert(!mesh.partitioned || mesh.type == EMPIRE_Mesh_FEMesh);
+            }
+            mesh.conditionGPDataCache = "";
+            if (xmlMesh->HasAttribute("conditionGPDataCache"))
+                mesh.conditionGPDataCache = xmlMesh->GetAttribute<string>("conditionGPDataCache");
+            mesh.trimmingLinearizationType = 2;
+            if (xmlMesh->HasAttribute("trimmingLinearization")) {
+                string tmp = xmlMesh->GetAttribute<string>("trimmingLinearization");
+                if (tmp == "combined") {
+                    mesh.trimmingLinearizationType = 2;
+                } else if (tmp == "adaptive") {
+                    mesh.trimmingLinearizationType = 3;
+                } else {
+                    assert(false);
+                }
+            }
             ticpp::Iterator<Element> xmlDataField("dataField");
             for (xmlDataField = xmlDataField.begin(xmlMesh.Get());
                     xmlDataField != xmlDataField.end(); xmlDataField++) {
@@ -298,6 +611,63 @@ void MetaDatabase::fillSettingDataOutputVec() {
         structDataOutput dataOutput;
         dataOutput.name = xmlDataOutput->GetAttribute<string>("name");
         dataOutput.interval = xmlDataOutput->GetAttribute<int>("interval");
+        dataOutput.format = EMPIRE_DataOutput_GiD;
+        if (xmlDataOutput->HasAttribute("format")) {
+            string format = xmlDataOutput->GetAttribute<string>("format");
+            if (format == "binary")
+                dataOutput.format = EMPIRE_DataOutput_binary;
+            else if (format == "HDF5")
+                dataOutput.format = EMPIRE_DataOutput_HDF5;
+            else if (format == "ADIOS2")
+                dataOutput.format = EMPIRE_DataOutput_ADIOS2;
+            else
+                assert(format == "GiD");
+        }
+        dataOutput.asyncQueueDepth = 2;
+        if (xmlDataOutput->HasAttribute("asyncQueueDepth")) {
+            dataOutput.asyncQueueDepth = xmlDataOutput->GetAttribute<int>("asyncQueueDepth");
+            assert(dataOutput.asyncQueueDepth >= 0);
+        }
+        dataOutput.compressionLevel = 0;
+        if (xmlDataOutput->HasAttribute("compressionLevel")) {
+            dataOutput.compressionLevel = xmlDataOutput->GetAttribute<int>("compressionLevel");
+            assert(dataOutput.compressionLevel >= 0 && dataOutput.compressionLevel <= 9);
+        }
+        dataOutput.streamEngine = "SST";
+        if (xmlDataOutput->HasAttribute("streamEngine"))
+            dataOutput.streamEngine = xmlDataOutput->GetAttribute<string>("streamEngine");
+        dataOutput.nodeStride = 1;
+        if (xmlDataOutput->HasAttribute("nodeStride")) {
+            dataOutput.nodeStride = xmlDataOutput->GetAttribute<int>("nodeStride");
+            assert(dataOutput.nodeStride >= 1);
+        }
+        dataOutput.igaTessellation = 0;
+        if (xmlDataOutput->HasAttribute("igaTessellation")) {
+            dataOutput.igaTessellation = xmlDataOutput->GetAttribute<int>("igaTessellation");
+            assert(dataOutput.igaTessellation >= 0);
+        }
+        dataOutput.hasRegionBox = false;
+        ticpp::Element *xmlRegion = xmlDataOutput->FirstChildElement("region", false);
+        if (xmlRegion != NULL) {
+            if (xmlRegion->HasAttribute("min") || xmlRegion->HasAttribute("max")) {
+                dataOutput.hasRegionBox = true;
+                stringstream ssMin(xmlRegion->GetAttribute<string>("min"));
+                stringstream ssMax(xmlRegion->GetAttribute<string>("max"));
+                for (int i = 0; i < 3; i++) {
+                    ssMin >> dataOutput.regionMin[i];
+                    ssMax >> dataOutput.regionMax[i];
+                }
+                if (ssMin.fail() || ssMax.fail()) {
+                    ERROR_OUT() << "region of dataOutput " << dataOutput.name
+                            << " needs the three coordinates of min and max" << endl;
+                    exit(-1);
+                }
+            }
+            stringstream ss(xmlRegion->GetAttribute<string>("elemIDs", false));
+            int elemID;
+            while (ss >> elemID)
+                dataOutput.regionElemIDs.push_back(elemID);
+        }
         dataOutput.connectionIOs = parseConnectionIORefs(xmlDataOutput.Get());
 
         settingDataOutputVec.push_back(dataOutput);
@@ -312,6 +682,63 @@ void MetaDatabase::fillSettingMapperVec() {
         structMapper mapper;
         mapper.name = xmlMapper->GetAttribute<string>("name");
         xmlMapper->GetAttributeOrDefault<int,int>("writeMode", &mapper.writeMode, 0);
+        // the coupling matrices of a checkpointed run are cached with the checkpoints, so that
+        // the restart reads them instead of building them again
+        mapper.couplingMatricesCache = "";
+        if (checkpointInterval > 0 || restartFromCheckpoint)
+            mapper.couplingMatricesCache = checkpointDirectory;
+        if (xmlMapper->HasAttribute("couplingMatricesCache"))
+            mapper.couplingMatricesCache = xmlMapper->GetAttribute<string>("couplingMatricesCache");
+        xmlMapper->GetAttributeOrDefault<double,double>("iterativeSolverTolerance",
+                &mapper.iterativeSolverTolerance, 0.0);
+        xmlMapper->GetAttributeOrDefault<int,int>("iterativeSolverMaxIterations",
+                &mapper.iterativeSolverMaxIterations, 1000);
+        xmlMapper->GetAttributeOrDefault<double,double>("inexactSolveForcing",
+                &mapper.inexactSolveForcing, 0.0);
+        xmlMapper->GetAttributeOrDefault<double,double>("inexactSolveMaxTolerance",
+                &mapper.inexactSolveMaxTolerance, 1e-2);
+        mapper.linearSolver = readLinearSolver(xmlMapper, "mapper \"" + mapper.name + "\"");
+        mapper.pardiso = readPardisoSettings(xmlMapper->FirstChildElement("pardiso", false),
+                "mapper \"" + mapper.name + "\"");
+        mapper.compactAfterBuild = false;
+        if (xmlMapper->HasAttribute("compactAfterBuild"))
+            mapper.compactAfterBuild = (xmlMapper->GetAttribute<string>("compactAfterBuild") == "true");
+        mapper.reorderCouplingMatrices = false;
+        if (xmlMapper->HasAttribute("reorderCouplingMatrices"))
+            mapper.reorderCouplingMatrices = (xmlMapper->GetAttribute<string>(
+                    "reorderCouplingMatrices") == "true");
+        mapper.singlePrecisionWeights = false;
+        if (xmlMapper->HasAttribute("singlePrecisionWeights"))
+            mapper.singlePrecisionWeights = (xmlMapper->GetAttribute<string>(
+                    "singlePrecisionWeights") == "true");
+        mapper.explicitMappingOperator = false;
+        if (xmlMapper->HasAttribute("explicitMappingOperator"))
+            mapper.explicitMappingOperator = (xmlMapper->GetAttribute<string>(
+                    "explicitMappingOperator") == "true");
+        mapper.meshMotionA = "";
+        if (xmlMapper->HasAttribute("meshMotionA"))
+            mapper.meshMotionA = xmlMapper->GetAttribute<string>("meshMotionA");
+        mapper.meshMotionB = "";
+        if (xmlMapper->HasAttribute("meshMotionB"))
+            mapper.meshMotionB = xmlMapper->GetAttribute<string>("meshMotionB");
+        xmlMapper->GetAttributeOrDefault<double,double>("meshMotionThreshold",
+                &mapper.meshMotionThreshold, 0.0);
+        xmlMapper->GetAttributeOrDefault<int,int>("conservationMonitorInterval",
+                &mapper.conservationMonitorInterval, 0);
+        xmlMapper->GetAttributeOrDefault<double,double>("conservationMonitorTolerance",
+                &mapper.conservationMonitorTolerance, 1e-6);
+        mapper.buildStatisticsReport = false;
+        if (xmlMapper->HasAttribute("buildStatisticsReport"))
+            mapper.buildStatisticsReport = (xmlMapper->GetAttribute<string>(
+                    "buildStatisticsReport") == "true");
+        mapper.shareMirrored = false;
+        if (xmlMapper->HasAttribute("shareMirrored"))
+            mapper.shareMirrored = (xmlMapper->GetAttribute<string>("shareMirrored") == "true");
+        ticpp::Iterator<Element> xmlOperatorReceiver("operatorReceiver");
+        for (xmlOperatorReceiver = xmlOperatorReceiver.begin(xmlMapper.Get());
+                xmlOperatorReceiver != xmlOperatorReceiver.end(); xmlOperatorReceiver++)
+            mapper.operatorReceivers.push_back(xmlOperatorReceiver->FirstChildElement(
+                    "clientCodeRef")->GetAttribute<string>("clientCodeName"));
         ticpp::Element *xmlMeshRefA = xmlMapper->FirstChildElement("meshA")->FirstChildElement(
                 "meshRef");
         mapper.meshRefA.clientCodeName = xmlMeshRefA->GetAttribute<string>("clientCodeName");
@@ -429,9 +856,19 @@ void MetaDatabase::fillSettingMapperVec() {
                 }
                 else
                     mapper.IGAMortarMapper.propIntegration.isAutomaticNoGPQuadrilateral = true;
+                if (xmlIntegration->HasAttribute("adaptive"))
+                    mapper.IGAMortarMapper.propIntegration.isAdaptive = xmlIntegration->GetAttribute<string>("adaptive") == "true";
+                else
+                    mapper.IGAMortarMapper.propIntegration.isAdaptive = false;
+                if (xmlIntegration->HasAttribute("tolAdaptive"))
+                    mapper.IGAMortarMapper.propIntegration.tolAdaptive = xmlIntegration->GetAttribute<double>("tolAdaptive");
+                else
+                    mapper.IGAMortarMapper.propIntegration.tolAdaptive = 1e-6;
             } else {
                 mapper.IGAMortarMapper.propIntegration.isAutomaticNoGPTriangle = true;
                 mapper.IGAMortarMapper.propIntegration.isAutomaticNoGPQuadrilateral = true;
+                mapper.IGAMortarMapper.propIntegration.isAdaptive = false;
+                mapper.IGAMortarMapper.propIntegration.tolAdaptive = 1e-6;
             }
             ticpp::Element *xmlWeakCurveDirichletConditions = xmlIGAMortar->FirstChildElement("weakCurveDirichletConditions", false);
             if (xmlWeakCurveDirichletConditions != NULL) {
@@ -581,11 +1018,59 @@ void MetaDatabase::fillSettingMapperVec() {
                     mapper.IGAMortarMapper.propErrorComputation.isErrorComputation = true;
                 else
                     mapper.IGAMortarMapper.propErrorComputation.isErrorComputation = false;
+                mapper.IGAMortarMapper.propErrorComputation.isCompactStorage = false;
+                if (xmlErrorComputation->HasAttribute("compactStorage"))
+                    mapper.IGAMortarMapper.propErrorComputation.isCompactStorage =
+                            (xmlErrorComputation->GetAttribute<string>("compactStorage") == "true");
+                xmlErrorComputation->GetAttributeOrDefault<int,int>("samplingInterval",
+                        &mapper.IGAMortarMapper.propErrorComputation.samplingInterval, 1);
+                if (mapper.IGAMortarMapper.propErrorComputation.samplingInterval < 1) {
+                    ERROR_OUT() << "samplingInterval of the errorComputation of mapper "
+                            << mapper.name << " must be positive" << endl;
+                    exit(-1);
+                }
+                mapper.IGAMortarMapper.propErrorComputation.isAtTimeStepEnd =
+                        (xmlErrorComputation->GetAttribute<string>("atTimeStepEnd", false) == "true");
+                mapper.IGAMortarMapper.propErrorComputation.isBackground =
+                        (xmlErrorComputation->GetAttribute<string>("background", false) == "true");
             } else {
                 mapper.IGAMortarMapper.propErrorComputation.isErrorComputation = false;
                 mapper.IGAMortarMapper.propErrorComputation.isDomainError = false;
                 mapper.IGAMortarMapper.propErrorComputation.isCurveError = false;
                 mapper.IGAMortarMapper.propErrorComputation.isInterfaceError = false;
+                mapper.IGAMortarMapper.propErrorComputation.isCompactStorage = false;
+                mapper.IGAMortarMapper.propErrorComputation.samplingInterval = 1;
+                mapper.IGAMortarMapper.propErrorComputation.isAtTimeStepEnd = false;
+                mapper.IGAMortarMapper.propErrorComputation.isBackground = false;
+            }
+            ticpp::Element *xmlTuning = xmlIGAMortar->FirstChildElement("tuning", false);
+            mapper.IGAMortarMapper.propTuning.isTuning = (xmlTuning != NULL);
+            mapper.IGAMortarMapper.propTuning.sampleSize = 1000;
+            mapper.IGAMortarMapper.propTuning.targetProjectionSuccessRate = 1.0;
+            mapper.IGAMortarMapper.propTuning.targetMappingError = 1e-6;
+            mapper.IGAMortarMapper.propTuning.isApplied = false;
+            mapper.IGAMortarMapper.propTuning.file = "";
+            if (xmlTuning != NULL) {
+                xmlTuning->GetAttributeOrDefault<int,int>("sampleSize",
+                        &mapper.IGAMortarMapper.propTuning.sampleSize, 1000);
+                xmlTuning->GetAttributeOrDefault<double,double>("targetProjectionSuccessRate",
+                        &mapper.IGAMortarMapper.propTuning.targetProjectionSuccessRate, 1.0);
+                xmlTuning->GetAttributeOrDefault<double,double>("targetMappingError",
+                        &mapper.IGAMortarMapper.propTuning.targetMappingError, 1e-6);
+                mapper.IGAMortarMapper.propTuning.isApplied =
+                        (xmlTuning->GetAttribute<string>("apply", false) == "true");
+                mapper.IGAMortarMapper.propTuning.file = xmlTuning->GetAttribute<string>("file", false);
+                if (mapper.IGAMortarMapper.propTuning.sampleSize < 1) {
+                    ERROR_OUT() << "sampleSize of the tuning of mapper " << mapper.name
+                            << " must be positive" << endl;
+                    exit(-1);
+                }
+                if (mapper.IGAMortarMapper.propTuning.targetProjectionSuccessRate < 0.0
+                        || mapper.IGAMortarMapper.propTuning.targetProjectionSuccessRate > 1.0) {
+                    ERROR_OUT() << "targetProjectionSuccessRate of the tuning of mapper " << mapper.name
+                            << " must be between 0 and 1" << endl;
+                    exit(-1);
+                }
             }
 	} else if (xmlMapper->GetAttribute<string>("type") == "IGABarycentricMapper") {
             mapper.type = EMPIRE_IGABarycentricMapper;
@@ -630,6 +1115,18 @@ void MetaDatabase::fillSettingMapperVec() {
                 mapper.curveSurfaceMapper.type = EMPIRE_CurveSurfaceMapper_corotate3D;
             else
                 assert(false);
+        } else if (xmlMapper->GetAttribute<string>("type") == "RBFMapper") {
+            mapper.type = EMPIRE_RBFMapper;
+            mapper.RBFMapper.numNodesPerPatch = 30;
+            ticpp::Element *xmlRBFMapper = xmlMapper->FirstChildElement("RBFMapper", false);
+            if (xmlRBFMapper != NULL)
+                xmlRBFMapper->GetAttributeOrDefault<int,int>("numNodesPerPatch",
+                        &mapper.RBFMapper.numNodesPerPatch, 30);
+            if (mapper.RBFMapper.numNodesPerPatch < 1) {
+                ERROR_OUT() << "numNodesPerPatch of RBFMapper \"" << mapper.name
+                        << "\" must be positive" << endl;
+                exit(EXIT_FAILURE);
+            }
         } else {
             assert(false);
         }
@@ -691,6 +1188,15 @@ void MetaDatabase::fillSettingCouplingAlgorithmVec() {
                     "constantRelaxation");
             double tmpDouble = constantRelaxation->GetAttribute<double>("relaxationFactor");
             coupAlg.constantRelaxation.relaxationFactor = tmpDouble;
+        } else if (xmlCoupAlg->GetAttribute<string>("type") == "IQNILS") {
+            coupAlg.type = EMPIRE_IQNILS;
+            ticpp::Element *xmlIQNILS = xmlCoupAlg->FirstChildElement("IQNILS");
+            coupAlg.iqnils.initialRelaxationFactor = xmlIQNILS->GetAttribute<double>(
+                    "initialRelaxationFactor");
+            xmlIQNILS->GetAttributeOrDefault<int, int>("reuseTimeSteps",
+                    &coupAlg.iqnils.reuseTimeSteps, 0);
+            xmlIQNILS->GetAttributeOrDefault<double, double>("filterTolerance",
+                    &coupAlg.iqnils.filterTolerance, 1e-8);
         } else if (xmlCoupAlg->GetAttribute<string>("type") == "IJCSA") {
             { // interfaceJacobian
                 ticpp::Iterator<Element> xmlOutput("interfaceJacobian");
@@ -731,7 +1237,38 @@ void MetaDatabase::fillSettingCouplingAlgorithmVec() {
                     coupAlg.interfaceJacobians.push_back(interfaceJacobian);
                 }
             }
+            { // interfaceJacobianBlock
+                ticpp::Iterator<Element> xmlBlock("interfaceJacobianBlock");
+                for (xmlBlock = xmlBlock.begin(xmlCoupAlg.Get()); xmlBlock != xmlBlock.end();
+                        xmlBlock++) {
+                    structCouplingAlgorithm::structInterfaceJacobianBlock block;
+                    block.indexRow = xmlBlock->GetAttribute<unsigned int>("indexRow");
+                    block.indexColumn = xmlBlock->GetAttribute<unsigned int>("indexColumn");
+                    block.jacobianName = xmlBlock->GetAttribute<string>("name");
+                    block.clientCodeName = xmlBlock->FirstChildElement("clientCodeRef")->GetAttribute<
+                            string>("clientCodeName");
+                    string update = xmlBlock->GetAttribute<string>("update", false);
+                    if (update == "" || update == "timeStep") {
+                        block.isUpdatedEveryIteration = false;
+                    } else if (update == "iteration") {
+                        block.isUpdatedEveryIteration = true;
+                    } else {
+                        ERROR_OUT() << "interfaceJacobianBlock \"" << block.jacobianName
+                                << "\": update \"" << update
+                                << "\" is not timeStep or iteration" << endl;
+                        exit(EXIT_FAILURE);
+                    }
+                    coupAlg.interfaceJacobianBlocks.push_back(block);
+                }
+            }
             coupAlg.type = EMPIRE_IJCSA;
+            coupAlg.ijcsa.maxRankOfUpdate = 0;
+            if (xmlCoupAlg->FirstChildElement("IJCSA", false) != NULL)
+                xmlCoupAlg->FirstChildElement("IJCSA")->GetAttributeOrDefault<int, int>(
+                        "maxRankOfUpdate", &coupAlg.ijcsa.maxRankOfUpdate, 0);
+            coupAlg.ijcsa.linearSolver = readLinearSolver(
+                    xmlCoupAlg->FirstChildElement("IJCSA", false),
+                    "coupling algorithm \"" + coupAlg.name + "\"");
 
         } else if(xmlCoupAlg->GetAttribute<string>("type") == "GMRES"){ // For GMRES Algorithm
         	// TODO : Complete the implementation
@@ -750,6 +1287,10 @@ void MetaDatabase::fillSettingCouplingAlgorithmVec() {
     		ticpp::Element *xmltempresidual= xmlCoupAlg->FirstChildElement("tolerance");
     		double temptolerance = xmltempresidual->GetAttribute<double>("value");
     		coupAlg.gmres.residualTolerance = temptolerance;
+    		// Reading in the number of recycled directions (optional)
+    		coupAlg.gmres.recycleDimension = 0;
+    		if (xmlCoupAlg->FirstChildElement("recycleDimension", false) != NULL)
+    			coupAlg.gmres.recycleDimension = xmlCoupAlg->FirstChildElement("recycleDimension")->GetAttribute<int>("value");
 
     		// Reading the connections
     		ticpp::Iterator<Element> xmlConnection("connection");
@@ -786,8 +1327,21 @@ void MetaDatabase::fillSettingExtrapolatorVec() {
             xmlExtrapolator != xmlExtrapolator.end(); xmlExtrapolator++) {
         structExtrapolator settingExtrapolator;
         settingExtrapolator.name = xmlExtrapolator->GetAttribute<string>("name");
+        settingExtrapolator.degree = 1;
+        settingExtrapolator.historyLength = 2;
         if (xmlExtrapolator->GetAttribute<string>("type") == "linearExtrapolator") {
             settingExtrapolator.type = EMPIRE_LinearExtrapolator;
+        } else if (xmlExtrapolator->GetAttribute<string>("type") == "polynomialExtrapolator") {
+            settingExtrapolator.type = EMPIRE_PolynomialExtrapolator;
+            xmlExtrapolator->GetAttributeOrDefault<int, int>("degree", &settingExtrapolator.degree,
+                    2);
+            xmlExtrapolator->GetAttributeOrDefault<int, int>("historyLength",
+                    &settingExtrapolator.historyLength, settingExtrapolator.degree + 1);
+        } else if (xmlExtrapolator->GetAttribute<string>("type") == "adamsBashforthExtrapolator") {
+            settingExtrapolator.type = EMPIRE_AdamsBashforthExtrapolator;
+            xmlExtrapolator->GetAttributeOrDefault<int, int>("order", &settingExtrapolator.degree,
+                    2);
+            settingExtrapolator.historyLength = settingExtrapolator.degree + 1;
         } else {
             assert(false);
         }
@@ -804,6 +1358,30 @@ void MetaDatabase::fillSettingConnectionVec() {
             xmlConnection++) {
         structConnection connection;
         connection.name = xmlConnection->GetAttribute<string>("name");
+        connection.exchangeInterval = 1;
+        if (xmlConnection->HasAttribute("exchangeInterval")) {
+            connection.exchangeInterval = xmlConnection->GetAttribute<int>("exchangeInterval");
+            assert(connection.exchangeInterval >= 1);
+        }
+        connection.bundleSignals = (xmlConnection->GetAttribute<string>("bundleSignals", false)
+                == "true");
+        connection.skipUnchangedInputs = (xmlConnection->GetAttribute<string>(
+                "skipUnchangedInputs", false) == "true");
+        xmlConnection->GetAttributeOrDefault<double, double>("changeTolerance",
+                &connection.changeTolerance, 0.0);
+        if (connection.changeTolerance < 0.0) {
+            ERROR_OUT() << "changeTolerance of connection " << connection.name
+                    << " must not be negative" << endl;
+            exit(-1);
+        }
+        connection.chainMappings = (xmlConnection->GetAttribute<string>("chainMappings", false)
+                != "false");
+        if (connection.skipUnchangedInputs && connection.exchangeInterval > 1) {
+            // the outputs are interpolated in time between the transfers
+            ERROR_OUT() << "Connection " << connection.name
+                    << " cannot skip unchanged inputs with an exchange interval" << endl;
+            exit(-1);
+        }
         // inputs and outputs
         if (xmlConnection->FirstChildElement("inputAndOutput", false) != NULL) {
             ticpp::Element *xmlIO = xmlConnection->FirstChildElement("inputAndOutput");
@@ -825,6 +1403,12 @@ void MetaDatabase::fillSettingConnectionVec() {
                 connection.outputs.push_back(output);
             }
         }
+        for (int i = 0; i < connection.outputs.size(); i++)
+            if (connection.outputs[i].type == EMPIRE_ConnectionIO_MeshCoordinates) {
+                ERROR_OUT() << "Connection " << connection.name
+                        << " can receive the coordinates of a mesh, but not send them" << endl;
+                exit(-1);
+            }
 
         if (xmlConnection->FirstChildElement("sequence", false) != NULL) {
             ticpp::Element *xmlFilters = xmlConnection->FirstChildElement("sequence");
@@ -855,9 +1439,21 @@ void MetaDatabase::fillSettingConnectionVec() {
                 // filter type
                 if (xmlFilter->GetAttribute<string>("type") == "mappingFilter") {
                     filter.type = EMPIRE_MappingFilter;
-                    filter.mappingFilter.mapperName =
-                            xmlFilter->FirstChildElement("mappingFilter")->FirstChildElement(
-                                    "mapperRef")->GetAttribute<string>("mapperName");
+                    ticpp::Element *xmlMappingFilter = xmlFilter->FirstChildElement(
+                            "mappingFilter");
+                    filter.mappingFilter.mapperName = xmlMappingFilter->FirstChildElement(
+                            "mapperRef")->GetAttribute<string>("mapperName");
+                    filter.mappingFilter.incremental = (xmlMappingFilter->GetAttribute<string>(
+                            "incremental", false) == "true");
+                    filter.mappingFilter.incrementTolerance = 0.0;
+                    if (xmlMappingFilter->HasAttribute("incrementTolerance"))
+                        filter.mappingFilter.incrementTolerance =
+                                xmlMappingFilter->GetAttribute<double>("incrementTolerance");
+                    if (filter.mappingFilter.incrementTolerance < 0.0) {
+                        ERROR_OUT() << "incrementTolerance of a mapping filter must not be negative"
+                                << endl;
+                        exit(-1);
+                    }
                 } else if (xmlFilter->GetAttribute<string>("type") == "locationFilter") {
                     filter.type = EMPIRE_LocationFilter;
                 } else if (xmlFilter->GetAttribute<string>("type") == "scalingFilter") {
@@ -882,17 +1478,28 @@ void MetaDatabase::fillSettingConnectionVec() {
                 } else if (xmlFilter->GetAttribute<string>("type") == "copyFilter") {
                     filter.type = EMPIRE_CopyFilter;
                     filter.copyFilter.signalOffset = 0;
+                    filter.copyFilter.alias = false;
                     ticpp::Element *pXMLElement = xmlFilter->FirstChildElement("copyFilter", false);
                     if (pXMLElement != NULL) {
-                        filter.copyFilter.signalOffset = pXMLElement->GetAttribute<int>(
-                                "signalOffset");
+                        if (pXMLElement->HasAttribute("signalOffset"))
+                            filter.copyFilter.signalOffset = pXMLElement->GetAttribute<int>(
+                                    "signalOffset");
+                        filter.copyFilter.alias = (pXMLElement->GetAttribute<string>("alias",
+                                false) == "true");
                     }
 
                 } else if (xmlFilter->GetAttribute<string>("type")
                         == "dataFieldIntegrationFilter") {
                     filter.type = EMPIRE_DataFieldIntegrationFilter;
-                    ticpp::Element *xmlMeshRef = xmlFilter->FirstChildElement(
-                            "dataFieldIntegrationFilter")->FirstChildElement("meshRef");
+                    ticpp::Element *xmlDataFieldIntegrationFilter = xmlFilter->FirstChildElement(
+                            "dataFieldIntegrationFilter");
+                    filter.dataFieldIntegrationFilter.lumped =
+                            (xmlDataFieldIntegrationFilter->GetAttribute<string>("lumped", false)
+                                    == "true");
+                    filter.dataFieldIntegrationFilter.linearSolver = readLinearSolver(
+                            xmlDataFieldIntegrationFilter, "dataFieldIntegrationFilter");
+                    ticpp::Element *xmlMeshRef = xmlDataFieldIntegrationFilter->FirstChildElement(
+                            "meshRef");
                     filter.dataFieldIntegrationFilter.meshRef.clientCodeName =
                             xmlMeshRef->GetAttribute<string>("clientCodeName");
                     filter.dataFieldIntegrationFilter.meshRef.meshName = xmlMeshRef->GetAttribute<
@@ -948,6 +1555,15 @@ void parseCouplingLogicBlock(ticpp::Iterator<Element> &xmlCouplingLogicIn,
         couplingLogicIn.type = EMPIRE_IterativeCouplingLoop;
         ticpp::Element *xmlIterativeCouplingLoop = xmlCouplingLogicIn->FirstChildElement(
                 "iterativeCouplingLoop");
+        { // coupling schema
+            string schema = xmlIterativeCouplingLoop->GetAttribute<string>("couplingSchema", false);
+            if (schema.empty() || schema == "GaussSeidel")
+                couplingLogicIn.iterativeCouplingLoop.couplingSchema = EMPIRE_GaussSeidel;
+            else if (schema == "Jacobi")
+                couplingLogicIn.iterativeCouplingLoop.couplingSchema = EMPIRE_Jacobi;
+            else
+                assert(false);
+        }
         { // add convergence checker
             ticpp::Element *xmlConvergenceChecker = xmlIterativeCouplingLoop->FirstChildElement(
                     "convergenceChecker");
@@ -1022,12 +1638,16 @@ void parseCouplingLogicBlock(ticpp::Iterator<Element> &xmlCouplingLogicIn,
         couplingLogicIn.type = EMPIRE_connection;
         couplingLogicIn.connectionRef.connectionName = xmlCouplingLogicIn->FirstChildElement(
                 "connectionRef")->GetAttribute<string>("connectionName");
+    } else if (xmlCouplingLogicIn->GetAttribute<string>("type") == "sequence") {
+        couplingLogicIn.type = EMPIRE_CouplingLogicSequence;
     } else if (xmlCouplingLogicIn->GetAttribute<string>("type") == "optimizationLoop") {
         couplingLogicIn.type = EMPIRE_OptimizationLoop;
         ticpp::Element *xmlOptimizationLoop = xmlCouplingLogicIn->FirstChildElement(
                 "optimizationLoop");
         couplingLogicIn.optimizationLoop.maxNumOfIterations =
                 xmlOptimizationLoop->GetAttribute<int>("maxNumOfIterations");
+        couplingLogicIn.optimizationLoop.concurrentDesigns = (xmlOptimizationLoop->GetAttribute<
+                string>("concurrentDesigns", false) == "true");
         { // add convergence signal sender
             ticpp::Element *xmlConvergenceSignalSender = xmlOptimizationLoop->FirstChildElement(
                     "convergenceSignalSender");
@@ -1096,6 +1716,7 @@ void MetaDatabase::fillSettingCouplingLogic() {
 structConnectionIO MetaDatabase::parseConnectionIORef(ticpp::Element *xmlElement) {
     ticpp::Element *xmlDataFieldRef = xmlElement->FirstChildElement("dataFieldRef", false);
     ticpp::Element *xmlSignalRef = xmlElement->FirstChildElement("signalRef", false);
+    ticpp::Element *xmlMeshRef = xmlElement->FirstChildElement("meshRef", false);
     structConnectionIO settingConnectionIO;
     if (xmlDataFieldRef != NULL) {
         settingConnectionIO.type = EMPIRE_ConnectionIO_DataField;
@@ -1105,17 +1726,75 @@ structConnectionIO MetaDatabase::parseConnectionIORef(ticpp::Element *xmlElement
                 "meshName");
         settingConnectionIO.dataFieldRef.dataFieldName = xmlDataFieldRef->GetAttribute<string>(
                 "dataFieldName");
+        settingConnectionIO.dataFieldRef.wireFormat = parseWireFormat(xmlDataFieldRef);
+        settingConnectionIO.dataFieldRef.chunkSize = parseChunkSize(xmlDataFieldRef,
+                settingConnectionIO.dataFieldRef.wireFormat);
+        settingConnectionIO.dataFieldRef.skipUnchanged = parseSkipUnchanged(xmlDataFieldRef,
+                settingConnectionIO.dataFieldRef);
+        xmlDataFieldRef->GetAttributeOrDefault<int, int>("outputInterval",
+                &settingConnectionIO.dataFieldRef.outputInterval, 0);
     } else if (xmlSignalRef != NULL) {
         settingConnectionIO.type = EMPIRE_ConnectionIO_Signal;
         settingConnectionIO.signalRef.clientCodeName = xmlSignalRef->GetAttribute<string>(
                 "clientCodeName");
         settingConnectionIO.signalRef.signalName = xmlSignalRef->GetAttribute<string>("signalName");
+    } else if (xmlMeshRef != NULL) {
+        settingConnectionIO.type = EMPIRE_ConnectionIO_MeshCoordinates;
+        settingConnectionIO.meshRef.clientCodeName = xmlMeshRef->GetAttribute<string>(
+                "clientCodeName");
+        settingConnectionIO.meshRef.meshName = xmlMeshRef->GetAttribute<string>("meshName");
     } else {
         assert(false);
     }
     return settingConnectionIO;
 }
 
+EMPIRE_DataField_wireFormat MetaDatabase::parseWireFormat(ticpp::Element *xmlDataFieldRef) {
+    string wireFormat = xmlDataFieldRef->GetAttribute<string>("wireFormat", false);
+    if (wireFormat.empty() || wireFormat == "float64")
+        return EMPIRE_DataField_float64;
+    else if (wireFormat == "float32")
+        return EMPIRE_DataField_float32;
+    else if (wireFormat == "lossless")
+        return EMPIRE_DataField_lossless;
+    else if (wireFormat == "deltaLossless")
+        return EMPIRE_DataField_deltaLossless;
+    else
+        assert(false);
+    return EMPIRE_DataField_float64;
+}
+
+int MetaDatabase::parseChunkSize(ticpp::Element *xmlDataFieldRef,
+        EMPIRE_DataField_wireFormat wireFormat) {
+    int chunkSize = 0;
+    xmlDataFieldRef->GetAttributeOrDefault<int, int>("chunkSize", &chunkSize, 0);
+    if (chunkSize < 0) {
+        ERROR_OUT() << "chunkSize of data field "
+                << xmlDataFieldRef->GetAttribute<string>("dataFieldName") << " must not be negative"
+                << endl;
+        exit(-1);
+    }
+    if (chunkSize > 0 && wireFormat != EMPIRE_DataField_float64) {
+        ERROR_OUT() << "Data field " << xmlDataFieldRef->GetAttribute<string>("dataFieldName")
+                << " cannot be transferred both encoded and in chunks" << endl;
+        exit(-1);
+    }
+    return chunkSize;
+}
+
+bool MetaDatabase::parseSkipUnchanged(ticpp::Element *xmlDataFieldRef,
+        const structDataFieldRef &dataFieldRef) {
+    if (xmlDataFieldRef->GetAttribute<string>("skipUnchanged", false) != "true")
+        return false;
+    if (dataFieldRef.wireFormat != EMPIRE_DataField_float64 || dataFieldRef.chunkSize > 0) {
+        ERROR_OUT() << "Data field " << dataFieldRef.dataFieldName
+                << " cannot skip unchanged values if it is encoded or transferred in chunks"
+                << endl;
+        exit(-1);
+    }
+    return true;
+}
+
 std::vector<structConnectionIO> MetaDatabase::parseConnectionIORefs(ticpp::Element *xmlElement) {
     ticpp::Iterator<Element> xmlDataFieldRef("dataFieldRef");
     std::vector<structConnectionIO> settingConnectionIOs;
@@ -1126,6 +1805,13 @@ std::vector<structConnectionIO> MetaDatabase::parseConnectionIORefs(ticpp::Eleme
         io.dataFieldRef.clientCodeName = xmlDataFieldRef->GetAttribute<string>("clientCodeName");
         io.dataFieldRef.meshName = xmlDataFieldRef->GetAttribute<string>("meshName");
         io.dataFieldRef.dataFieldName = xmlDataFieldRef->GetAttribute<string>("dataFieldName");
+        io.dataFieldRef.wireFormat = parseWireFormat(xmlDataFieldRef.Get());
+        io.dataFieldRef.chunkSize = parseChunkSize(xmlDataFieldRef.Get(),
+                io.dataFieldRef.wireFormat);
+        io.dataFieldRef.skipUnchanged = parseSkipUnchanged(xmlDataFieldRef.Get(), io.dataFieldRef);
+        xmlDataFieldRef->GetAttributeOrDefault<int, int>("outputInterval",
+                &io.dataFieldRef.outputInterval, 0);
+        assert(io.dataFieldRef.outputInterval >= 0);
         settingConnectionIOs.push_back(io);
     }
     ticpp::Iterator<Element> xmlSignalRef("signalRef");
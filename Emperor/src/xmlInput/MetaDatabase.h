@@ -50,6 +50,12 @@ public:
      * \author Tianyang Wang
      ***********/
     static void init(char *inputFileName);
+    /***********************************************************************************************
+     * \brief Replace the singleton by the settings of another input file, e.g. of the next session
+     *        of the Emperor daemon. The new input file is parsed before the singleton is replaced.
+     * \param[in] inputFileName name of the input file
+     ***********/
+    static void reinit(char *inputFileName);
     /***********************************************************************************************
      * \brief return the singleton
      * \return the singleton
@@ -73,6 +79,62 @@ public:
     std::string serverPortFile;
     /// verbosity
     std::string verbosity;
+    /// whether data fields are transferred by persistent requests after the first transfer
+    bool persistentDataFieldTransfer;
+    /// whether data fields are transferred through shared memory with clients on the same node
+    bool sharedMemoryDataFieldTransfer;
+    /// whether non-convergence signals are sent in the size headers of the next data fields
+    bool piggybackConvergenceSignal;
+    /// whether the pending non-blocking transfers are completed by a thread of their own
+    bool progressThread;
+    /// whether the wall time of the coupling is profiled
+    bool profiling;
+    /// the CSV file receiving the profile of every time step, empty if not written
+    std::string profilingCSVFile;
+    /// the trace file receiving the timeline of the coupling, empty if not written
+    std::string profilingTraceFile;
+    /// whether the hardware performance counters are read in every profiled scope
+    bool profilingHardwareCounters;
+    /// the raw event code of the floating point operations of the processor, 0 if not counted
+    unsigned long long profilingFPOpsEvent;
+    /// seconds between two progress reports of a long stage of a mapper build, 0 for none
+    double buildProgressInterval;
+    /// the file receiving the last progress report, empty if not written
+    std::string buildProgressFile;
+    /// the file the live metrics are rewritten to, empty if not written
+    std::string metricsFile;
+    /// seconds between two writes of the metrics file
+    double metricsInterval;
+    /// the TCP port serving the live metrics over HTTP, 0 if not served
+    int metricsPort;
+    /// the number of threads shared by the mappers, filters and outputs
+    int numThreads;
+    /// the number of threads of the MKL routines
+    int mklNumThreads;
+    /// whether the worker threads are pinned to disjoint sets of cores
+    bool threadPinning;
+    /// whether the large shared read-only arrays are interleaved over the NUMA nodes
+    bool numaInterleave;
+    /// whether the large numeric arrays are backed by transparent huge pages
+    bool hugePages;
+    /// whether the parallel assemblies give the same matrices for any number of threads
+    bool reproducible;
+    /// number of replicas of the co-simulation which share the mappers, 1 without ensemble
+    int ensembleSize;
+    /// seconds the first mapping of an ensemble waits for the other replicas
+    double ensembleBatchWindow;
+    /// a checkpoint of the coupling state is written every checkpointInterval time steps, 0 for none
+    int checkpointInterval;
+    /// the directory of the checkpoint files
+    std::string checkpointDirectory;
+    /// number of checkpoint files kept
+    int checkpointNumKept;
+    /// queue depth of the writer of the checkpoint files, 0 to write synchronously
+    int checkpointQueueDepth;
+    /// whether the coupling restarts from the last checkpoint in checkpointDirectory
+    bool restartFromCheckpoint;
+    /// maximum number of megabytes of the free buffers kept by the BufferPool
+    int bufferPoolMaxMegaBytes;
     /// setting of client codes in XML input file
     std::vector<structClientCode> settingClientCodeVec;
     /// setting of data outputs in XML input file
@@ -119,6 +181,52 @@ private:
      * \author Stefan Sicklinger
      ***********/
     void fillVerbosity();
+    /***********************************************************************************************
+     * \brief Fill persistentDataFieldTransfer, which is disabled if not given
+     ***********/
+    void fillPersistentDataFieldTransfer();
+    /***********************************************************************************************
+     * \brief Fill sharedMemoryDataFieldTransfer, which is disabled if not given
+     ***********/
+    void fillSharedMemoryDataFieldTransfer();
+    /***********************************************************************************************
+     * \brief Fill piggybackConvergenceSignal, which is disabled if not given
+     ***********/
+    void fillPiggybackConvergenceSignal();
+    /***********************************************************************************************
+     * \brief Fill progressThread, which is disabled if not given
+     ***********/
+    void fillProgressThread();
+    /***********************************************************************************************
+     * \brief Fill profiling and its output files, profiling is disabled if not given
+     ***********/
+    void fillProfiling();
+    /***********************************************************************************************
+     * \brief Fill the progress reports of the mapper builds, every 60 seconds without file if not
+     *        given
+     ***********/
+    void fillBuildProgress();
+    /***********************************************************************************************
+     * \brief Fill the live metrics, neither written nor served if not given
+     ***********/
+    void fillMetrics();
+    /***********************************************************************************************
+     * \brief Fill the threading settings, one thread without pinning, interleaving and huge pages if
+     *        not given
+     ***********/
+    void fillThreading();
+    /***********************************************************************************************
+     * \brief Fill the ensemble settings, a single replica if not given
+     ***********/
+    void fillEnsemble();
+    /***********************************************************************************************
+     * \brief Fill the checkpoint settings, no checkpoint and no restart if not given
+     ***********/
+    void fillCheckpoint();
+    /***********************************************************************************************
+     * \brief Fill the size of the buffer pool, 1024 megabytes if not given
+     ***********/
+    void fillBufferPool();
     /***********************************************************************************************
      * \brief Fill client code setting by parsing XML input file
      * \author Tianyang Wang
@@ -155,7 +263,7 @@ private:
      ***********/
     void fillSettingCouplingLogic();
     /***********************************************************************************************
-     * \brief Parse DataFieldRef or SignalRef
+     * \brief Parse DataFieldRef, SignalRef or MeshRef
      * \param[in] xmlElement xml element
      * \return the setting after parsing
      * \author Tianyang Wang
@@ -168,6 +276,28 @@ private:
      * \author Tianyang Wang
      ***********/
     std::vector<structConnectionIO> parseConnectionIORefs(ticpp::Element *xmlElement);
+    /***********************************************************************************************
+     * \brief Parse the optional wire format of a DataFieldRef, float64 by default
+     * \param[in] xmlDataFieldRef xml element of the DataFieldRef
+     * \return the wire format
+     ***********/
+    EMPIRE_DataField_wireFormat parseWireFormat(ticpp::Element *xmlDataFieldRef);
+    /***********************************************************************************************
+     * \brief Parse the chunk size of a data field reference, 0 if not given
+     * \param[in] xmlDataFieldRef the data field reference
+     * \param[in] wireFormat the wire format of the reference, chunks are sent as float64 only
+     * \return the chunk size
+     ***********/
+    int parseChunkSize(ticpp::Element *xmlDataFieldRef, EMPIRE_DataField_wireFormat wireFormat);
+    /***********************************************************************************************
+     * \brief Parse whether the unchanged values of a data field reference are skipped
+     * \param[in] xmlDataFieldRef the data field reference
+     * \param[in] dataFieldRef the reference with its wire format and chunk size, the values are
+     *            only skipped if they are sent as float64 at once
+     * \return true if the unchanged values are skipped
+     ***********/
+    bool parseSkipUnchanged(ticpp::Element *xmlDataFieldRef,
+            const structDataFieldRef &dataFieldRef);
 
     /// The singleton of this class
     static MetaDatabase* metaDatabase;
@@ -19,9 +19,116 @@
  *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
  */
 #include "TestMapper.h"
+#include <fstream>
+#include <algorithm>
+#include <omp.h>
+#include "TaskPool.h"
+#include "AsyncOutputWriter.h"
 
 namespace EMPIRE {
 
+/********//**
+ * \brief Class StreamingReadTask reads a batch of steps of a streaming mapping from the .res file.
+ *        It runs on the reader thread while the previous batch is mapped, the steps are read one
+ *        after another from the same stream.
+ ***********/
+class StreamingReadTask: public AbstractTask {
+public:
+    StreamingReadTask(ifstream *_dotResFile,
+            const TestMapper::StructMapper::StructStreamingMapping *_setting, int _firstStep,
+            int _numSteps, int _numNodes, const int *_nodeIDs, double *_data) :
+            dotResFile(_dotResFile), setting(_setting), firstStep(_firstStep), numSteps(_numSteps),
+            numNodes(_numNodes), nodeIDs(_nodeIDs), data(_data) {
+    }
+    void execute() {
+        for (int s = 0; s < numSteps; s++)
+            GiDFileIO::readNodalDataFromDotResFast(*dotResFile, setting->file, setting->resultName,
+                    setting->analysisName, firstStep + s * setting->stepInterval, "vector",
+                    numNodes, nodeIDs, &data[(size_t) s * numNodes * 3]);
+    }
+private:
+    /// the stream of the .res file
+    ifstream *dotResFile;
+    /// the setting of the streaming mapping
+    const TestMapper::StructMapper::StructStreamingMapping *setting;
+    /// the first step of the batch
+    int firstStep;
+    /// the number of steps of the batch
+    int numSteps;
+    /// the number of nodes
+    int numNodes;
+    /// the IDs of the nodes
+    const int *nodeIDs;
+    /// the vector field of every step one after another
+    double *data;
+};
+
+/********//**
+ * \brief Class StreamingWriteTask appends a batch of mapped steps to the .res file on the writer
+ *        thread
+ ***********/
+class StreamingWriteTask: public AbstractOutputTask {
+public:
+    StreamingWriteTask(AsyncOutputWriter *_writer, string _resultFile, string _resultName,
+            int _firstStep, int _stepInterval, int _numSteps, int _numNodes, const int *_nodeIDs,
+            double *_data) :
+            writer(_writer), resultFile(_resultFile), resultName(_resultName),
+            firstStep(_firstStep), stepInterval(_stepInterval), numSteps(_numSteps),
+            numNodes(_numNodes), nodeIDs(_nodeIDs), data(_data) {
+    }
+    virtual ~StreamingWriteTask() {
+        writer->releaseBuffer(data, numSteps * numNodes * 3);
+    }
+    void execute() {
+        for (int s = 0; s < numSteps; s++)
+            GiDFileIO::appendNodalDataToDotRes(resultFile, resultName, "\"testMapper\"",
+                    firstStep + s * stepInterval, "Vector", numNodes, nodeIDs,
+                    &data[(size_t) s * numNodes * 3]);
+    }
+private:
+    /// the writer, which owns the buffer
+    AsyncOutputWriter *writer;
+    /// the .res file
+    string resultFile;
+    /// the name of the result
+    string resultName;
+    /// the first step of the batch
+    int firstStep;
+    /// the step interval
+    int stepInterval;
+    /// the number of steps of the batch
+    int numSteps;
+    /// the number of nodes
+    int numNodes;
+    /// the IDs of the nodes
+    const int *nodeIDs;
+    /// the vector field of every step one after another
+    double *data;
+};
+
+/***********************************************************************************************
+ * \brief Integrate or deIntegrate the x, y and z components of a vector field
+ * \param[in] DFI the integration of the mesh
+ * \param[in] integrate true to integrate, false to deIntegrate
+ * \param[in] numNodes the number of nodes
+ * \param[in,out] dataField the vector field
+ ***********/
+static void convertVectorField(DataFieldIntegration *DFI, bool integrate, int numNodes,
+        double *dataField) {
+    vector<double> dataField_j(numNodes);
+    vector<double> tmpDF(numNodes);
+    for (int j = 0; j < 3; j++) { // x,y,z
+        for (int k = 0; k < numNodes; k++)
+            dataField_j[k] = dataField[k * 3 + j];
+        if (integrate)
+            DFI->integrate(&dataField_j[0], &tmpDF[0]);
+        else
+            DFI->deIntegrate(&dataField_j[0], &tmpDF[0]);
+        for (int k = 0; k < numNodes; k++)
+            dataField[k * 3 + j] = tmpDF[k];
+    }
+}
+
 TestMapper::TestMapper() {
 }
 
@@ -143,6 +250,39 @@ void TestMapper::parseInputFile(char *fileName) {
             } else {
                 mapper.settingConservativeMapping.doConservativeMapping = false;
             }
+            // set streaming mapping
+            ticpp::Element *xmlStreamingMapping = xmlMapper->FirstChildElement("streamingMapping",
+                    false);
+            if (xmlStreamingMapping != NULL) {
+                StructMapper::StructStreamingMapping &streamingMapping =
+                        mapper.settingStreamingMapping;
+                streamingMapping.doStreamingMapping = true;
+                if (xmlStreamingMapping->GetAttribute<string>("direction") == "consistent")
+                    streamingMapping.isConsistent = true;
+                else if (xmlStreamingMapping->GetAttribute<string>("direction") == "conservative")
+                    streamingMapping.isConsistent = false;
+                else
+                    assert(false);
+                streamingMapping.dataFieldInTypeOfQuantity =
+                        xmlStreamingMapping->GetAttribute<string>("dataFieldInTypeOfQuantity");
+                streamingMapping.dataFieldOutTypeOfQuantity =
+                        xmlStreamingMapping->GetAttribute<string>("dataFieldOutTypeOfQuantity");
+                xmlStreamingMapping->GetAttributeOrDefault<int, int>("batchSize",
+                        &streamingMapping.batchSize, 8);
+                assert(streamingMapping.batchSize > 0);
+
+                ticpp::Element *xmlGiDResult = xmlStreamingMapping->FirstChildElement("GiDResult");
+                streamingMapping.file = xmlGiDResult->GetAttribute<string>("file");
+                streamingMapping.resultName = xmlGiDResult->GetAttribute<string>("resultName");
+                streamingMapping.analysisName = xmlGiDResult->GetAttribute<string>("analysisName");
+                streamingMapping.firstStep = xmlGiDResult->GetAttribute<int>("firstStep");
+                streamingMapping.lastStep = xmlGiDResult->GetAttribute<int>("lastStep");
+                xmlGiDResult->GetAttributeOrDefault<int, int>("stepInterval",
+                        &streamingMapping.stepInterval, 1);
+                assert(streamingMapping.stepInterval > 0);
+            } else {
+                mapper.settingStreamingMapping.doStreamingMapping = false;
+            }
             settingMappers.push_back(mapper);
         }
 
@@ -250,6 +390,25 @@ void TestMapper::outputSettingToShell() {
             }
             cout << "\t" << "}" << endl;
         }
+        if (settingMappers[i].settingStreamingMapping.doStreamingMapping) {
+            StructMapper::StructStreamingMapping &streamingMapping =
+                    settingMappers[i].settingStreamingMapping;
+            cout << "\t" << "streamingMapping {" << endl;
+            cout << "\t" << "\t" << "direction: "
+                    << (streamingMapping.isConsistent ? "consistent" : "conservative") << endl;
+            cout << "\t" << "\t" << "dataFieldInTypeOfQuantity: "
+                    << streamingMapping.dataFieldInTypeOfQuantity << endl;
+            cout << "\t" << "\t" << "dataFieldOutTypeOfQuantity: "
+                    << streamingMapping.dataFieldOutTypeOfQuantity << endl;
+            cout << "\t" << "\t" << "batchSize: " << streamingMapping.batchSize << endl;
+            cout << "\t" << "\t" << "file: " << streamingMapping.file << endl;
+            cout << "\t" << "\t" << "resultName: " << streamingMapping.resultName << endl;
+            cout << "\t" << "\t" << "analysisName: " << streamingMapping.analysisName << endl;
+            cout << "\t" << "\t" << "steps: " << streamingMapping.firstStep << " to "
+                    << streamingMapping.lastStep << " every " << streamingMapping.stepInterval
+                    << endl;
+            cout << "\t" << "}" << endl;
+        }
         cout << "}" << endl;
     }
 
@@ -552,6 +711,11 @@ void TestMapper::doMapping() {
             delete[] dataFieldB;
         }
 
+        // *. streaming mapping
+        if (settingMappers[i].settingStreamingMapping.doStreamingMapping)
+            doStreamingMapping(settingMappers[i], mapper, DFI_A, DFI_B, numNodesA, nodeIDsA,
+                    numNodesB, nodeIDsB, resultFileA, resultFileB);
+
         delete[] numNodesPerElemA;
         delete[] nodeCoorsA;
         delete[] nodeIDsA;
@@ -755,6 +919,128 @@ void TestMapper::doConservationAnalysis() {
     }
 }
 
+void TestMapper::doStreamingMapping(StructMapper &settingMapper, AbstractMapper *mapper,
+        DataFieldIntegration *DFI_A, DataFieldIntegration *DFI_B, int numNodesA, int *nodeIDsA,
+        int numNodesB, int *nodeIDsB, string resultFileA, string resultFileB) {
+    const StructMapper::StructStreamingMapping &setting = settingMapper.settingStreamingMapping;
+    cout << '\t' << "do streaming mapping ... " << endl;
+    // consistent mapping from A to B, conservative mapping from B to A
+    const bool isConsistent = setting.isConsistent;
+    const int numNodesIn = isConsistent ? numNodesA : numNodesB;
+    const int *nodeIDsIn = isConsistent ? nodeIDsA : nodeIDsB;
+    DataFieldIntegration *DFI_In = isConsistent ? DFI_A : DFI_B;
+    const int numNodesOut = isConsistent ? numNodesB : numNodesA;
+    const int *nodeIDsOut = isConsistent ? nodeIDsB : nodeIDsA;
+    DataFieldIntegration *DFI_Out = isConsistent ? DFI_B : DFI_A;
+    const string resultFileOut = isConsistent ? resultFileB : resultFileA;
+    // the consistent mapping maps fields, the conservative mapping maps field integrals
+    assert(setting.dataFieldInTypeOfQuantity == "field"
+            || setting.dataFieldInTypeOfQuantity == "fieldIntegral");
+    assert(setting.dataFieldOutTypeOfQuantity == "field"
+            || setting.dataFieldOutTypeOfQuantity == "fieldIntegral");
+    const bool convertIn = (setting.dataFieldInTypeOfQuantity
+            == (isConsistent ? "fieldIntegral" : "field"));
+    const bool convertOut = (setting.dataFieldOutTypeOfQuantity
+            == (isConsistent ? "fieldIntegral" : "field"));
+    string resultName = setting.resultName;
+    if (resultName[0] != '\"')
+        resultName = "\"" + resultName + "\"";
+
+    assert(setting.lastStep >= setting.firstStep);
+    const int numSteps = (setting.lastStep - setting.firstStep) / setting.stepInterval + 1;
+    const int batchSize = min(setting.batchSize, numSteps);
+    const int numBatches = (numSteps + batchSize - 1) / batchSize;
+    ifstream dotResFile(setting.file.c_str());
+    if (!dotResFile) {
+        cerr << "Cannot open " << setting.file << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // reader thread, mapping by the OpenMP threads of the mapper and writer thread, the reader
+    // fills one input batch while the other one is mapped
+    TaskPool reader(1);
+    AsyncOutputWriter writer(2);
+    vector<double> inBatches[2];
+    for (int b = 0; b < 2; b++)
+        inBatches[b].resize((size_t) batchSize * numNodesIn * 3);
+    // all steps of a batch are mapped as one multi-component field, the previous batch is the
+    // initial guess of an iterative solver
+    const bool isBlockMapping = mapper->isBlockMappingSupported();
+    vector<double> blockIn, blockOut;
+    if (isBlockMapping) {
+        blockIn.resize((size_t) batchSize * numNodesIn * 3);
+        blockOut.resize((size_t) batchSize * numNodesOut * 3, 0.0);
+    }
+    double startTime = omp_get_wtime();
+    reader.push(new StreamingReadTask(&dotResFile, &setting, setting.firstStep, batchSize,
+            numNodesIn, nodeIDsIn, &inBatches[0][0]));
+    for (int b = 0; b < numBatches; b++) {
+        reader.wait();
+        const int numStepsInBatch = min(batchSize, numSteps - b * batchSize);
+        const int firstStepInBatch = setting.firstStep + b * batchSize * setting.stepInterval;
+        if (b + 1 < numBatches)
+            reader.push(new StreamingReadTask(&dotResFile, &setting,
+                    firstStepInBatch + batchSize * setting.stepInterval,
+                    min(batchSize, numSteps - (b + 1) * batchSize), numNodesIn, nodeIDsIn,
+                    &inBatches[(b + 1) % 2][0]));
+
+        double *in = &inBatches[b % 2][0];
+        if (convertIn)
+            for (int s = 0; s < numStepsInBatch; s++)
+                convertVectorField(DFI_In, !isConsistent, numNodesIn,
+                        &in[(size_t) s * numNodesIn * 3]);
+        double *out = writer.acquireBuffer(numStepsInBatch * numNodesOut * 3);
+        if (isBlockMapping) {
+            const int numComponents = numStepsInBatch * 3;
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < numNodesIn; i++)
+                for (int s = 0; s < numStepsInBatch; s++)
+                    for (int j = 0; j < 3; j++)
+                        blockIn[(size_t) i * numComponents + s * 3 + j] =
+                                in[((size_t) s * numNodesIn + i) * 3 + j];
+            if (isConsistent)
+                mapper->consistentBlockMapping(&blockIn[0], &blockOut[0], numComponents);
+            else
+                mapper->conservativeBlockMapping(&blockIn[0], &blockOut[0], numComponents);
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < numNodesOut; i++)
+                for (int s = 0; s < numStepsInBatch; s++)
+                    for (int j = 0; j < 3; j++)
+                        out[((size_t) s * numNodesOut + i) * 3 + j] =
+                                blockOut[(size_t) i * numComponents + s * 3 + j];
+        } else {
+            vector<double> dataFieldIn_j(numNodesIn);
+            vector<double> dataFieldOut_j(numNodesOut);
+            for (int s = 0; s < numStepsInBatch; s++) {
+                for (int j = 0; j < 3; j++) { // x,y,z
+                    for (int k = 0; k < numNodesIn; k++)
+                        dataFieldIn_j[k] = in[((size_t) s * numNodesIn + k) * 3 + j];
+                    if (isConsistent)
+                        mapper->consistentMapping(&dataFieldIn_j[0], &dataFieldOut_j[0]);
+                    else
+                        mapper->conservativeMapping(&dataFieldIn_j[0], &dataFieldOut_j[0]);
+                    for (int k = 0; k < numNodesOut; k++)
+                        out[((size_t) s * numNodesOut + k) * 3 + j] = dataFieldOut_j[k];
+                }
+            }
+        }
+        if (convertOut)
+            for (int s = 0; s < numStepsInBatch; s++)
+                convertVectorField(DFI_Out, isConsistent, numNodesOut,
+                        &out[(size_t) s * numNodesOut * 3]);
+        writer.push(new StreamingWriteTask(&writer, resultFileOut, resultName, firstStepInBatch,
+                setting.stepInterval, numStepsInBatch, numNodesOut, nodeIDsOut, out));
+    }
+    writer.flush();
+    double time = omp_get_wtime() - startTime;
+    double megaBytesRead = (double) dotResFile.tellg() / (1024.0 * 1024.0);
+    cout << '\t' << '\t' << "Mapped " << numSteps << " steps in " << numBatches << " batches in "
+            << time << " s: " << numSteps / time << " steps/s";
+    if (megaBytesRead > 0.0)
+        cout << ", " << megaBytesRead / time << " MB/s read";
+    cout << endl;
+}
+
 void TestMapper::parseXMLDataField(ticpp::Element *xmlDataField, StructDataField &structDataField) {
     structDataField.format = xmlDataField->GetAttribute<string>("format");
     if (structDataField.format == "GiDResult") {
@@ -87,6 +87,19 @@ public:
             bool doErrorCalculation;
             StructDataField dataFieldARef;
         } settingConservativeMapping;
+        struct StructStreamingMapping {
+            bool doStreamingMapping;
+            bool isConsistent; // consistent from A to B, or conservative from B to A
+            string dataFieldInTypeOfQuantity;
+            string dataFieldOutTypeOfQuantity;
+            string file; // .res file of the mesh the field is mapped from
+            string resultName;
+            string analysisName;
+            int firstStep;
+            int lastStep;
+            int stepInterval;
+            int batchSize; // number of steps mapped at once
+        } settingStreamingMapping;
     };
     struct StructConservationAnalysis {
         string name;
@@ -113,6 +126,9 @@ private:
     void initDataField(StructDataField &structDataField, int numNodes, int numElems,
             double *nodeCoors, int *nodeIDs, int* numNodesPerElem, int *elemTable, int *elemIDs,
             double *dataField);
+    void doStreamingMapping(StructMapper &settingMapper, AbstractMapper *mapper,
+            DataFieldIntegration *DFI_A, DataFieldIntegration *DFI_B, int numNodesA,
+            int *nodeIDsA, int numNodesB, int *nodeIDsB, string resultFileA, string resultFileB);
 };
 
 } /* namespace EMPIRE */
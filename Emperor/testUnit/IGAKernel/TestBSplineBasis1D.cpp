@@ -122,6 +122,48 @@ public:
         CPPUNIT_ASSERT(bSplineBasis1D->findKnotSpan(u)==CorrectknotSpan);
     }
 
+    /***********************************************************************************************
+     * \brief Test case: Test the hinted, the uniform and the batched knot span lookups against a linear search
+     ***********/
+    void testBSpline1DKnotSpanLookups() {
+        // A uniform knot vector
+        double* uniformKnotVector = new double[13];
+        for (int i = 0; i < 3; i++) {
+            uniformKnotVector[i] = 0.0;
+            uniformKnotVector[12 - i] = 1.0;
+        }
+        for (int i = 3; i < 10; i++)
+            uniformKnotVector[i] = (i - 2) / 8.0;
+        BSplineBasis1D uniformBasis(2, 2, 13, uniformKnotVector);
+        delete[] uniformKnotVector;
+
+        BSplineBasis1D* bases[2] = { bSplineBasis1D, &uniformBasis };
+        for (int b = 0; b < 2; b++) {
+            const BSplineBasis1D* basis = bases[b];
+            const double* knots = basis->getKnotVector();
+            int p = basis->getPolynomialDegree();
+            int n = basis->computeNoBasisFunctions();
+            int noParameters = 801;
+            double* u = new double[noParameters];
+            int* spans = new int[noParameters];
+            for (int k = 0; k < noParameters; k++)
+                u[k] = basis->getFirstKnot()
+                        + (basis->getLastKnot() - basis->getFirstKnot()) * k / (noParameters - 1);
+            basis->findKnotSpans(noParameters, u, spans);
+            for (int k = 0; k < noParameters; k++) {
+                int span = p;
+                while (span < n - 1 && u[k] >= knots[span + 1])
+                    span++;
+                CPPUNIT_ASSERT(basis->findKnotSpan(u[k]) == span);
+                CPPUNIT_ASSERT(spans[k] == span);
+                for (int hint = p - 1; hint <= n; hint++)
+                    CPPUNIT_ASSERT(basis->findKnotSpan(u[k], hint) == span);
+            }
+            delete[] u;
+            delete[] spans;
+        }
+    }
+
     /***********************************************************************************************
      * \brief Test case: Test the computation of the local basis functions
      ***********/
@@ -170,6 +212,39 @@ public:
         delete[] localBasisFunctionsAndDerivatives;
     }
 
+    /***********************************************************************************************
+     * \brief Test case: The basis functions by the Bezier extraction operators agree with the recursion
+     * on knots of all multiplicities and for a higher polynomial degree on a non-uniform knot vector
+     ***********/
+    void testBSpline1DBasisFunctionsByExtraction() {
+        double knotVectorQuintic[] = { 0, 0, 0, 0, 0, 0, 0.1, 0.35, 0.35, 0.7, 0.8, 0.8, 0.8, 1, 1, 1, 1, 1, 1 };
+        BSplineBasis1D quintic(2, 5, 19, knotVectorQuintic);
+        BSplineBasis1D* bases[] = { bSplineBasis1D, &quintic };
+        for (int b = 0; b < 2; b++) {
+            BSplineBasis1D* basis = bases[b];
+            int n = basis->getPolynomialDegree() + 1;
+            double* recursion = new double[2 * n];
+            double* extraction = new double[2 * n];
+            double first = basis->getFirstKnot();
+            double last = basis->getLastKnot();
+            for (int k = 0; k <= 200; k++) {
+                double u = first + (last - first) * k / 200.0;
+                int knotSpan = basis->findKnotSpan(u);
+                basis->computeLocalBasisFunctionsAndDerivatives(recursion, 1, u, knotSpan);
+                basis->computeLocalBasisFunctionsAndFirstDerivativesByExtraction(extraction, u, knotSpan);
+                double sum = 0.0;
+                for (int i = 0; i < n; i++) {
+                    sum += extraction[i];
+                    CPPUNIT_ASSERT(fabs(recursion[i] - extraction[i]) <= 1e-13);
+                    CPPUNIT_ASSERT(fabs(recursion[n + i] - extraction[n + i]) <= 1e-11 * (1.0 + fabs(recursion[n + i])));
+                }
+                CPPUNIT_ASSERT(fabs(sum - 1.0) <= 1e-14);
+            }
+            delete[] recursion;
+            delete[] extraction;
+        }
+    }
+
     /***********************************************************************************************
      * \brief Test case: Test the computation of the B-Spline basis functions for memory leakage
      ***********/
@@ -218,8 +293,10 @@ public:
 CPPUNIT_TEST_SUITE(TestBSplineBasis1D);
     CPPUNIT_TEST(testConstructor);
     CPPUNIT_TEST(testBSpline1DKnotSpan);
+    CPPUNIT_TEST(testBSpline1DKnotSpanLookups);
     CPPUNIT_TEST(testBSpline1DBasisFunctions);
     CPPUNIT_TEST(testBSpline1DBasisFunctionsAndDerivatives);
+    CPPUNIT_TEST(testBSpline1DBasisFunctionsByExtraction);
 
     // Make the tests for leakage
     // CPPUNIT_TEST(testBSpline1DBasisFunctions4Leakage);
@@ -27,6 +27,7 @@
 #include <math.h>
 #include <cstdlib>
 #include <iomanip>
+#include <algorithm>
 
 // Inclusion of user-defined libraries
 #include "IGAPatchSurface.h"
@@ -278,6 +279,63 @@ public:
         delete[] baseVectorAndDerivatives;
     }
 
+    /***********************************************************************************************
+     * \brief Test case: Test that the adaptive linearization stays within the tolerance of the curve
+     * and refines with the tolerance
+     ***********/
+    void testLinearizeAdaptive() {
+        theIGAPatchCurve->linearize(3, true);
+        const std::vector<double>& polyline = *theIGAPatchCurve->getPolyline();
+        const std::vector<double>& knots = *theIGAPatchCurve->getPolylineKnots();
+        const int noVertices = knots.size();
+        CPPUNIT_ASSERT(polyline.size() == 2 * noVertices);
+        CPPUNIT_ASSERT(knots.front() == 0.0);
+        CPPUNIT_ASSERT(knots.back() == 1.0);
+
+        // The extent of the control polygon
+        double xMin = 1e10, xMax = -1e10, yMin = 1e10, yMax = -1e10;
+        for (int i = 0; i < theIGAPatchCurve->getNoControlPoints(); i++) {
+            xMin = std::min(xMin, theIGAPatchCurve->getControlPointNet()[i].getX());
+            xMax = std::max(xMax, theIGAPatchCurve->getControlPointNet()[i].getX());
+            yMin = std::min(yMin, theIGAPatchCurve->getControlPointNet()[i].getY());
+            yMax = std::max(yMax, theIGAPatchCurve->getControlPointNet()[i].getY());
+        }
+        double tol = IGAPatchCurve::TOL_ADAPTIVE_LINEARIZATION
+                * sqrt((xMax - xMin) * (xMax - xMin) + (yMax - yMin) * (yMax - yMin));
+
+        // The midpoints of the segments deviate from the chords by no more than the tolerance
+        double point[2];
+        for (int i = 0; i < noVertices - 1; i++) {
+            CPPUNIT_ASSERT(knots[i] < knots[i + 1]);
+            theIGAPatchCurve->computeCartesianCoordinates(point, 0.5 * (knots[i] + knots[i + 1]));
+            double chord[2] = {polyline[2 * i + 2] - polyline[2 * i], polyline[2 * i + 3] - polyline[2 * i + 1]};
+            double distance = fabs(chord[0] * (point[1] - polyline[2 * i + 1])
+                    - chord[1] * (point[0] - polyline[2 * i])) / sqrt(chord[0] * chord[0] + chord[1] * chord[1]);
+            CPPUNIT_ASSERT(distance <= tol);
+        }
+
+        // A tighter tolerance refines the linearization
+        const BSplineBasis1D* basis = theIGAPatchCurve->getIGABasis();
+        std::vector<double> knotVector(basis->getKnotVector(), basis->getKnotVector() + basis->getNoKnots());
+        std::vector<double> controlPointCoords;
+        for (int i = 0; i < theIGAPatchCurve->getNoControlPoints(); i++) {
+            controlPointCoords.push_back(theIGAPatchCurve->getControlPointNet()[i].getX());
+            controlPointCoords.push_back(theIGAPatchCurve->getControlPointNet()[i].getY());
+            controlPointCoords.push_back(theIGAPatchCurve->getControlPointNet()[i].getZ());
+            controlPointCoords.push_back(theIGAPatchCurve->getControlPointNet()[i].getW());
+        }
+        IGAPatchCurve* curve = new IGAPatchCurve(0, basis->getPolynomialDegree(), basis->getNoKnots(),
+                &knotVector[0], theIGAPatchCurve->getNoControlPoints(), &controlPointCoords[0]);
+        double defaultTol = IGAPatchCurve::TOL_ADAPTIVE_LINEARIZATION;
+        IGAPatchCurve::TOL_ADAPTIVE_LINEARIZATION = defaultTol * 1e-2;
+        curve->linearize(3, false);
+        IGAPatchCurve::TOL_ADAPTIVE_LINEARIZATION = defaultTol;
+        CPPUNIT_ASSERT(curve->getPolylineKnots()->size() > noVertices);
+        CPPUNIT_ASSERT(curve->getPolylineKnots()->front() == 1.0);
+        CPPUNIT_ASSERT(curve->getPolylineKnots()->back() == 0.0);
+        delete curve;
+    }
+
     /***********************************************************************************************
      * \brief Test case: Test the projection on a 2D curve for the first initial guess
      ***********/
@@ -424,6 +482,7 @@ CPPUNIT_TEST_SUITE(TestIGAPatchCurve);
     CPPUNIT_TEST(testComputeBaseVectorAndDerivatives);
     CPPUNIT_TEST(testComputePointProjectionOn2DCurve1);
     CPPUNIT_TEST(testComputePointProjectionOn2DCurve2);
+    CPPUNIT_TEST(testLinearizeAdaptive);
 
 // Make the tests for leakage
     // CPPUNIT_TEST(testComputeBaseVectorAndDerivatives4Leakage);
@@ -27,9 +27,11 @@
 #include <math.h>
 #include <cstdlib>
 #include <iomanip>
+#include <algorithm>
 
 // Inclusion of user-defined libraries
 #include "IGAPatchSurface.h"
+#include "MathLibrary.h"
 
 using namespace std;
 
@@ -854,6 +856,264 @@ public:
 		delete[] localBasisFunctionsAndDerivatives;
 	}
 
+	/***********************************************************************************************
+	 * \brief Test case: Test the kernel specialized on the polynomial degrees (p=4, q=3) against the generic evaluation
+	 ***********/
+	void testIGAPatchSurfaceFixedDegreeKernel() {
+
+		// The parameters on the IGA surface and their knot span indices
+		double u = 2.222122;
+		double v = -3.3339333;
+		int uKnotSpan =
+				theIGAPatchSurface->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(
+						u);
+		int vKnotSpan =
+				theIGAPatchSurface->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(
+						v);
+
+		// Modify the Control Point net for getting some curvature into the structure
+		theIGAPatchSurface->getControlPointNet()[theIGAPatchSurface->getVNoControlPoints()
+				+ 4]->setZ(102.78054 * 4.500000000000000);
+		theIGAPatchSurface->getControlPointNet()[4
+				* theIGAPatchSurface->getVNoControlPoints()]->setZ(
+				102.78054 * 4.500000000000000 / 1.5672);
+
+		// Compute the Cartesian coordinates from the generic basis functions
+		int noLocalBasisFunctions =
+				(theIGAPatchSurface->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree() + 1)
+						* (theIGAPatchSurface->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree()
+								+ 1);
+		double* localBasisFunctions = new double[noLocalBasisFunctions];
+		theIGAPatchSurface->getIGABasis()->computeLocalBasisFunctions(localBasisFunctions, u,
+				uKnotSpan, v, vKnotSpan);
+		double correctCoords[3];
+		theIGAPatchSurface->computeCartesianCoordinates(correctCoords, localBasisFunctions,
+				uKnotSpan, vKnotSpan);
+
+		// Values provided by MATLAB
+		double correctBaseVectors[] = {-3.438137561383751e-03,
+		                               3.670146188906259e-02,
+		                               1.424647671570531e+01,
+		                               1.849566126177724e-02,
+		                               2.642578782315075e-02,
+		                               -1.876668817294945e+01};
+		double correctNormal[3];
+		EMPIRE::MathLibrary::computeVectorCrossProduct(&correctBaseVectors[0],
+				&correctBaseVectors[3], correctNormal);
+
+		// Compute the Cartesian coordinates, the base vectors and the normal vector through the specialized kernel
+		double coords[3];
+		double baseVectors[6];
+		double normal[3];
+		theIGAPatchSurface->computeCartesianCoordinates(coords, u, uKnotSpan, v, vKnotSpan);
+		theIGAPatchSurface->computeBaseVectors(baseVectors, u, uKnotSpan, v, vKnotSpan);
+		for (int i = 0; i < 3; i++)
+			CPPUNIT_ASSERT( fabs(coords[i]-correctCoords[i]) <= relTol * fabs(correctCoords[i]));
+		for (int i = 0; i < 6; i++)
+			CPPUNIT_ASSERT( fabs(baseVectors[i]-correctBaseVectors[i]) <= TolDeriv);
+
+		theIGAPatchSurface->computeCartesianCoordinatesAndNormalVector(coords, normal, u, v,
+				uKnotSpan, vKnotSpan);
+		for (int i = 0; i < 3; i++) {
+			CPPUNIT_ASSERT( fabs(coords[i]-correctCoords[i]) <= relTol * fabs(correctCoords[i]));
+			CPPUNIT_ASSERT( fabs(normal[i]-correctNormal[i]) <= TolDeriv);
+		}
+
+		// Free the memory from the heap
+		delete[] localBasisFunctions;
+	}
+
+	/***********************************************************************************************
+	 * \brief Test case: Test the classification of the knot spans by a rectangular trimming loop
+	 ***********/
+	void testIGAPatchSurfaceKnotSpanTrimming() {
+		// The trimming loop u in [-5,10] and v in [-12,0.5], counterclockwise
+		double corners[4][2] = {{-5.0, -12.0}, {10.0, -12.0}, {10.0, 0.5}, {-5.0, 0.5}};
+		double knotVector[4] = {0.0, 0.0, 1.0, 1.0};
+		theIGAPatchSurface->addTrimLoop(0, 4);
+		for (int i = 0; i < 4; i++) {
+			double controlPoints[8] = {corners[i][0], corners[i][1], 0.0, 1.0,
+					corners[(i + 1) % 4][0], corners[(i + 1) % 4][1], 0.0, 1.0};
+			theIGAPatchSurface->addTrimCurve(1, 1, 4, knotVector, 2, controlPoints);
+		}
+		theIGAPatchSurface->linearizeTrimming();
+
+		// The knot spans are u in [-4,5], [5,11], [11,21] and v in [-11,-0.1], [-0.1,0], [0,1]
+		int spansU[3] = {4, 6, 9};
+		int spansV[3] = {3, 6, 8};
+		IGAPatchSurface::KnotSpanTrimming correctStates[3][3] = {
+				{IGAPatchSurface::KNOTSPAN_UNTRIMMED, IGAPatchSurface::KNOTSPAN_UNTRIMMED, IGAPatchSurface::KNOTSPAN_CUT},
+				{IGAPatchSurface::KNOTSPAN_CUT, IGAPatchSurface::KNOTSPAN_CUT, IGAPatchSurface::KNOTSPAN_CUT},
+				{IGAPatchSurface::KNOTSPAN_TRIMMED, IGAPatchSurface::KNOTSPAN_TRIMMED, IGAPatchSurface::KNOTSPAN_TRIMMED}};
+		double correctAreas[3][3] = {{9.0 * 10.9, 9.0 * 0.1, 9.0 * 0.5}, {5.0 * 10.9, 5.0 * 0.1, 5.0 * 0.5}, {0.0, 0.0, 0.0}};
+		const double* uKnotVector = theIGAPatchSurface->getIGABasis()->getUBSplineBasis1D()->getKnotVector();
+		const double* vKnotVector = theIGAPatchSurface->getIGABasis()->getVBSplineBasis1D()->getKnotVector();
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				CPPUNIT_ASSERT(theIGAPatchSurface->getKnotSpanTrimming(spansU[i], spansV[j]) == correctStates[i][j]);
+
+				// Clip the whole knot span
+				std::vector<std::pair<double,double> > knotSpan(4);
+				knotSpan[0] = std::make_pair(uKnotVector[spansU[i]], vKnotVector[spansV[j]]);
+				knotSpan[1] = std::make_pair(uKnotVector[spansU[i] + 1], vKnotVector[spansV[j]]);
+				knotSpan[2] = std::make_pair(uKnotVector[spansU[i] + 1], vKnotVector[spansV[j] + 1]);
+				knotSpan[3] = std::make_pair(uKnotVector[spansU[i]], vKnotVector[spansV[j] + 1]);
+				std::vector<std::vector<std::pair<double,double> > > trimmedPolygons;
+				theIGAPatchSurface->clipByKnotSpanTrimming(spansU[i], spansV[j], knotSpan, trimmedPolygons);
+				double area = 0.0;
+				for (int k = 0; k < trimmedPolygons.size(); k++)
+					for (int l = 0; l < trimmedPolygons[k].size(); l++) {
+						const std::pair<double,double>& p1 = trimmedPolygons[k][l];
+						const std::pair<double,double>& p2 = trimmedPolygons[k][(l + 1) % trimmedPolygons[k].size()];
+						area += 0.5 * (p1.first * p2.second - p2.first * p1.second);
+					}
+				CPPUNIT_ASSERT(fabs(area - correctAreas[i][j]) <= 1e-6);
+			}
+		}
+	}
+
+	/***********************************************************************************************
+	 * \brief Test case: Test the integration cells of the knot spans of a rectangular trimming loop
+	 ***********/
+	void testIGAPatchSurfaceIntegrationCells() {
+		// The trimming loop u in [-5,10] and v in [-12,0.5], counterclockwise
+		double corners[4][2] = {{-5.0, -12.0}, {10.0, -12.0}, {10.0, 0.5}, {-5.0, 0.5}};
+		double knotVector[4] = {0.0, 0.0, 1.0, 1.0};
+		theIGAPatchSurface->addTrimLoop(0, 4);
+		for (int i = 0; i < 4; i++) {
+			double controlPoints[8] = {corners[i][0], corners[i][1], 0.0, 1.0,
+					corners[(i + 1) % 4][0], corners[(i + 1) % 4][1], 0.0, 1.0};
+			theIGAPatchSurface->addTrimCurve(1, 1, 4, knotVector, 2, controlPoints);
+		}
+		theIGAPatchSurface->linearizeTrimming();
+		theIGAPatchSurface->computeIntegrationCells(2);
+		const std::vector<IGAPatchSurface::IntegrationCell>& cells = theIGAPatchSurface->getIntegrationCells();
+		CPPUNIT_ASSERT(!cells.empty());
+
+		// The parts and the triangles of every cell cover the same area, no cell is trimmed away
+		double totalArea = 0.0;
+		for (int i = 0; i < cells.size(); i++) {
+			CPPUNIT_ASSERT(theIGAPatchSurface->getKnotSpanTrimming(cells[i].spanU, cells[i].spanV)
+					!= IGAPatchSurface::KNOTSPAN_TRIMMED);
+			CPPUNIT_ASSERT(cells[i].triangulationPaths.size() == cells[i].polygons.size());
+			double areas[2] = {0.0, 0.0};
+			for (int m = 0; m < 2; m++) {
+				const std::vector<std::vector<std::pair<double,double> > >& polygons =
+						m == 0 ? cells[i].polygons : cells[i].triangles;
+				for (int k = 0; k < polygons.size(); k++)
+					for (int l = 0; l < polygons[k].size(); l++) {
+						const std::pair<double,double>& p1 = polygons[k][l];
+						const std::pair<double,double>& p2 = polygons[k][(l + 1) % polygons[k].size()];
+						areas[m] += 0.5 * (p1.first * p2.second - p2.first * p1.second);
+					}
+			}
+			CPPUNIT_ASSERT(fabs(areas[0] - areas[1]) <= 1e-6);
+			totalArea += areas[0];
+		}
+
+		// The cells cover the trimmed parameter space
+		const BSplineBasis1D* uBasis = theIGAPatchSurface->getIGABasis()->getUBSplineBasis1D();
+		const BSplineBasis1D* vBasis = theIGAPatchSurface->getIGABasis()->getVBSplineBasis1D();
+		double correctArea = (std::min(10.0, uBasis->getLastKnot()) - std::max(-5.0, uBasis->getFirstKnot()))
+				* (std::min(0.5, vBasis->getLastKnot()) - std::max(-12.0, vBasis->getFirstKnot()));
+		CPPUNIT_ASSERT(fabs(totalArea - correctArea) <= 1e-6);
+
+		// The cells are discarded with the linearized trimming and computed again
+		const int numCells = cells.size();
+		theIGAPatchSurface->linearizeTrimming();
+		theIGAPatchSurface->computeIntegrationCells(1);
+		CPPUNIT_ASSERT(theIGAPatchSurface->getIntegrationCells().size() == numCells);
+	}
+
+	/***********************************************************************************************
+	 * \brief Test case: Test the batched evaluation of the patch against the point-wise evaluation
+	 ***********/
+	void testIGAPatchSurfaceBatchedEvaluation() {
+
+		// Surface parameters in several knot spans, given in no particular order
+		const int noPoints = 5;
+		double uv[] = {2.222122, -3.3339333,
+		               9.0012100121, -1.00010001,
+		               2.5, -3.1,
+		               -3.9, -10.9,
+		               20.5, 0.5};
+
+		double coords[3 * noPoints];
+		double baseVectors[6 * noPoints];
+		double normals[3 * noPoints];
+		theIGAPatchSurface->computeCartesianCoordinatesAndNormalVectors(noPoints, uv, coords,
+				baseVectors, normals);
+
+		for (int iPoint = 0; iPoint < noPoints; iPoint++) {
+			int uKnotSpan =
+					theIGAPatchSurface->getIGABasis()->getUBSplineBasis1D()->findKnotSpan(
+							uv[2 * iPoint]);
+			int vKnotSpan =
+					theIGAPatchSurface->getIGABasis()->getVBSplineBasis1D()->findKnotSpan(
+							uv[2 * iPoint + 1]);
+			double correctCoords[3];
+			double correctBaseVectors[6];
+			double correctNormal[3];
+			theIGAPatchSurface->computeCartesianCoordinatesAndNormalVector(correctCoords,
+					correctNormal, uv[2 * iPoint], uv[2 * iPoint + 1], uKnotSpan, vKnotSpan);
+			theIGAPatchSurface->computeBaseVectors(correctBaseVectors, uv[2 * iPoint], uKnotSpan,
+					uv[2 * iPoint + 1], vKnotSpan);
+
+			for (int i = 0; i < 3; i++) {
+				CPPUNIT_ASSERT( fabs(coords[3 * iPoint + i]-correctCoords[i]) <= relTol * (1.0 + fabs(correctCoords[i])));
+				CPPUNIT_ASSERT( fabs(normals[3 * iPoint + i]-correctNormal[i]) <= TolDeriv * (1.0 + fabs(correctNormal[i])));
+			}
+			for (int i = 0; i < 6; i++)
+				CPPUNIT_ASSERT( fabs(baseVectors[6 * iPoint + i]-correctBaseVectors[i]) <= TolDeriv * (1.0 + fabs(correctBaseVectors[i])));
+		}
+	}
+
+	/***********************************************************************************************
+	 * \brief Test case: Test that the packed Control Point coordinates follow the Control Points
+	 ***********/
+	void testIGAPatchSurfaceControlPointCoordinates() {
+		const double* packed = theIGAPatchSurface->getControlPointCoordinates();
+		IGAControlPoint** cpNet = theIGAPatchSurface->getControlPointNet();
+		for (int i = 0; i < theIGAPatchSurface->getNoControlPoints(); i++) {
+			CPPUNIT_ASSERT(packed[4 * i + 0] == cpNet[i]->getX());
+			CPPUNIT_ASSERT(packed[4 * i + 1] == cpNet[i]->getY());
+			CPPUNIT_ASSERT(packed[4 * i + 2] == cpNet[i]->getZ());
+			CPPUNIT_ASSERT(packed[4 * i + 3] == cpNet[i]->getW());
+		}
+
+		// Moving a Control Point moves the surface evaluated by the kernels
+		double u = 2.222122;
+		double v = -3.3339333;
+		int uKnotSpan = theIGAPatchSurface->findSpanU(u);
+		int vKnotSpan = theIGAPatchSurface->findSpanV(v);
+		int CPindex = (vKnotSpan - 1) * theIGAPatchSurface->getUNoControlPoints() + uKnotSpan - 2;
+		cpNet[CPindex]->setZ(cpNet[CPindex]->getZ() + 10.0);
+		CPPUNIT_ASSERT(packed[4 * CPindex + 2] == cpNet[CPindex]->getZ());
+
+		int noLocalBasisFunctions =
+				(theIGAPatchSurface->getIGABasis()->getUBSplineBasis1D()->getPolynomialDegree() + 1)
+						* (theIGAPatchSurface->getIGABasis()->getVBSplineBasis1D()->getPolynomialDegree()
+								+ 1);
+		double* localBasisFunctions = new double[noLocalBasisFunctions];
+		theIGAPatchSurface->getIGABasis()->computeLocalBasisFunctions(localBasisFunctions, u,
+				uKnotSpan, v, vKnotSpan);
+		double correctCoords[3] = { 0.0, 0.0, 0.0 };
+		int counterBasis = 0;
+		for (int j = 0; j <= 3; j++)
+			for (int i = 0; i <= 4; i++, counterBasis++) {
+				IGAControlPoint* CP = cpNet[(vKnotSpan - 3 + j)
+						* theIGAPatchSurface->getUNoControlPoints() + uKnotSpan - 4 + i];
+				correctCoords[0] += localBasisFunctions[counterBasis] * CP->getX();
+				correctCoords[1] += localBasisFunctions[counterBasis] * CP->getY();
+				correctCoords[2] += localBasisFunctions[counterBasis] * CP->getZ();
+			}
+		double coords[3];
+		theIGAPatchSurface->computeCartesianCoordinates(coords, u, uKnotSpan, v, vKnotSpan);
+		for (int i = 0; i < 3; i++)
+			CPPUNIT_ASSERT(fabs(coords[i] - correctCoords[i]) <= 1e-12 * (1.0 + fabs(correctCoords[i])));
+		delete[] localBasisFunctions;
+	}
+
 	/***********************************************************************************************
 	 * \brief Test case: Test the computation of the base vectors and their derivatives for the surface patch
 	 ***********/
@@ -1342,6 +1602,11 @@ CPPUNIT_TEST_SUITE(TestIGAPatchSurface);
 	CPPUNIT_TEST(testIGAPatchSurfacePointOnSurface);
 	CPPUNIT_TEST(testIGAPatchSurfacePointOnSurfaceMethod2);
 	CPPUNIT_TEST(testIGAPatchSurfaceBaseVectors);
+	CPPUNIT_TEST(testIGAPatchSurfaceFixedDegreeKernel);
+	CPPUNIT_TEST(testIGAPatchSurfaceKnotSpanTrimming);
+	CPPUNIT_TEST(testIGAPatchSurfaceIntegrationCells);
+	CPPUNIT_TEST(testIGAPatchSurfaceBatchedEvaluation);
+	CPPUNIT_TEST(testIGAPatchSurfaceControlPointCoordinates);
 	CPPUNIT_TEST(testIGAPatchSurfaceBaseVectorsAndDerivatives);
 	CPPUNIT_TEST(testProjectionOnIGAPatch);
 	//CPPUNIT_TEST(testIGAPatchSurfaceFindNearestKnotIntersection);  can't find the correct solution from MATLAB yet, do it later
@@ -29,6 +29,7 @@
 
 // Inclusion of user-defined libraries
 #include "IGAPatchSurface.h"
+#include "MathLibrary.h"
 
 using namespace std;
 
@@ -293,6 +294,42 @@ public:
 
 	}
 
+	/***********************************************************************************************
+	 * \brief Test case: Test the searching grid of the linearized loop against a search over all vertices
+	 ***********/
+	void testSearchGridOfLinearizedLoop() {
+		const IGAPatchSurfaceTrimmingLoop& theLoop = theIGAPatchSurfaceTrimming->getFirstLoop();
+		const std::vector<double>& polylines = theLoop.getPolylines();
+		const int numVertices = polylines.size() / 2;
+
+		// Locate points on a lattice over the bounding box of the curve
+		const int numPoints = 60;
+		for (int i = 0; i <= numPoints; i++) {
+			for (int j = 0; j <= numPoints; j++) {
+				double uv[2] = {-1.0 + 3.0 * i / numPoints + 1e-7, -2.0 + 3.2 * j / numPoints + 1e-7};
+				CPPUNIT_ASSERT(theLoop.isPointInside(uv) == MathLibrary::findIfPointIsInside2DPolygon(numVertices, polylines, uv));
+			}
+		}
+
+		// A box far away is outside, a box around the whole curve is crossed
+		double farBox[4] = {5.0, 6.0, 5.0, 6.0};
+		CPPUNIT_ASSERT(theLoop.locateBox(farBox) == IGAPatchSurfaceTrimmingLoop::BOX_OUTSIDE);
+		double wholeBox[4] = {-2.0, 3.0, -3.0, 2.0};
+		CPPUNIT_ASSERT(theLoop.locateBox(wholeBox) == IGAPatchSurfaceTrimmingLoop::BOX_CROSSED);
+
+		// Inside a box, the loop clipped by the box has the same points inside
+		double box[4] = {0.3, 0.6, -0.2, 0.3};
+		std::vector<double> clippedPolylines;
+		theLoop.clipByBox(box, clippedPolylines);
+		CPPUNIT_ASSERT(clippedPolylines.size() < polylines.size());
+		for (int i = 1; i < numPoints; i++) {
+			for (int j = 1; j < numPoints; j++) {
+				double uv[2] = {box[0] + (box[1] - box[0]) * i / numPoints + 1e-7, box[2] + (box[3] - box[2]) * j / numPoints + 1e-7};
+				CPPUNIT_ASSERT(theLoop.isPointInside(uv) == MathLibrary::findIfPointIsInside2DPolygon(clippedPolylines.size() / 2, clippedPolylines, uv));
+			}
+		}
+	}
+
     void test4Leakage() {
         for (int i = 0; i < 100000000; i++) {
             testComputeTrimmingCurveIntersectionsWithKnotBisection();
@@ -302,6 +339,7 @@ public:
 	// Make the tests
 	CPPUNIT_TEST_SUITE(TestIGAPatchSurfaceTrimming);
 	CPPUNIT_TEST(testComputeTrimmingCurveIntersectionsWithKnotBisection);
+	CPPUNIT_TEST(testSearchGridOfLinearizedLoop);
 //    CPPUNIT_TEST(test4Leakage);
 	CPPUNIT_TEST_SUITE_END();
 }
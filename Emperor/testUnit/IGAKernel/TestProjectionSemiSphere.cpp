@@ -134,9 +134,49 @@ public:
 
     }
 
+    /***********************************************************************************************
+     * \brief Test case: Test the closest point projection from a poor initial guess and of points whose
+     *        closest point lies on the boundary of the patch
+     ***********/
+    void testClosestPointProjectionOnIGAPatch() {
+        theIGAPatchSurface->computeBoundingBox();
+
+        // The point of the orthogonal projection test from a distant initial guess
+        double u = 0.05;
+        double v = 0.05;
+        double vertex[] = { 0.0946463, -0.0608348, 0.992555 };
+        CPPUNIT_ASSERT(theIGAPatchSurface->computeClosestPointProjectionOnPatch(u, v, vertex, 40, 1e-9));
+        CPPUNIT_ASSERT(fabs(u - 9.21928587677731e-01) < 1e-8);
+        CPPUNIT_ASSERT(fabs(v - 6.29734882836685e-01) < 1e-8);
+
+        // Points whose closest points lie on an edge and at a corner of the patch
+        double points[2][3] = { { 0.5, -1.5, 0.5 }, { 1.5, 0.2, -0.5 } };
+        for (int i = 0; i < 2; i++) {
+            double P[3] = { points[i][0], points[i][1], points[i][2] };
+            u = 0.5;
+            v = 0.5;
+            CPPUNIT_ASSERT(theIGAPatchSurface->computeClosestPointProjectionOnPatch(u, v, P, 40, 1e-9));
+            double distance = sqrt((P[0] - points[i][0]) * (P[0] - points[i][0]) + (P[1] - points[i][1]) * (P[1] - points[i][1])
+                    + (P[2] - points[i][2]) * (P[2] - points[i][2]));
+
+            // No sample of the patch is closer
+            int noSamples = 200;
+            for (int j = 0; j <= noSamples; j++)
+                for (int k = 0; k <= noSamples; k++) {
+                    double uv[2] = { (double) j / noSamples, (double) k / noSamples };
+                    double S[3];
+                    theIGAPatchSurface->computeCartesianCoordinates(S, uv);
+                    double sampleDistance = sqrt((S[0] - points[i][0]) * (S[0] - points[i][0]) + (S[1] - points[i][1]) * (S[1] - points[i][1])
+                            + (S[2] - points[i][2]) * (S[2] - points[i][2]));
+                    CPPUNIT_ASSERT(distance <= sampleDistance + 1e-12);
+                }
+        }
+    }
+
 // Make the tests
     CPPUNIT_TEST_SUITE (TestProjectionSemiSphere);
     CPPUNIT_TEST (testProjectionOnIGAPatch);
+    CPPUNIT_TEST (testClosestPointProjectionOnIGAPatch);
     CPPUNIT_TEST_SUITE_END()
     ;
 }
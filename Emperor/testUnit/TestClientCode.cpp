@@ -88,10 +88,80 @@ public:
         CPPUNIT_ASSERT(client->getSignalByName(signal1->name)== signal1);
         CPPUNIT_ASSERT(client->getSignalByName(signal2->name)== signal2);*/
     }
+    /***********************************************************************************************
+     * \brief Test case: Merge the partitions of two processes, one quad each, which share the
+     *        nodes 2 and 5
+     ***********/
+    void testMergeMeshPartitions() {
+        ClientCode::PendingMeshTransfer transfer;
+        transfer.renumbering = EMPIRE_Mesh_noRenumbering;
+        transfer.triangulateAll = false;
+        transfer.partitions.resize(2);
+        const int nodeIDs[2][4] = { { 1, 2, 5, 4 }, { 2, 3, 6, 5 } };
+        for (int r = 0; r < 2; r++) {
+            ClientCode::MeshPartition &partition = transfer.partitions[r];
+            partition.meshInfo[0] = 4;
+            partition.meshInfo[1] = 1;
+            partition.meshInfo[2] = 4;
+            for (int i = 0; i < 4; i++) {
+                int id = nodeIDs[r][i];
+                partition.nodeIDs.push_back(id);
+                partition.nodes.push_back((id - 1) % 3);
+                partition.nodes.push_back((id - 1) / 3);
+                partition.nodes.push_back(0.0);
+                partition.elems.push_back(id);
+            }
+            partition.numNodesPerElem.push_back(4);
+        }
+        client->mergeMeshPartitions("partitioned", transfer);
+        FEMesh *mesh = transfer.mesh;
+        CPPUNIT_ASSERT(mesh->numNodes == 6);
+        CPPUNIT_ASSERT(mesh->numElems == 2);
+        CPPUNIT_ASSERT(transfer.elems.size() == 8);
+        CPPUNIT_ASSERT(transfer.partitions.empty());
+        const int mergedNodeIDs[6] = { 1, 2, 5, 4, 3, 6 };
+        for (int i = 0; i < 6; i++) {
+            CPPUNIT_ASSERT(mesh->nodeIDs[i] == mergedNodeIDs[i]);
+            CPPUNIT_ASSERT(mesh->nodes[i * 3] == (mergedNodeIDs[i] - 1) % 3);
+            CPPUNIT_ASSERT(mesh->nodes[i * 3 + 1] == (mergedNodeIDs[i] - 1) / 3);
+        }
+        const ClientCode::MeshPartitions &partitions = client->partitionedMeshes["partitioned"];
+        const int positions[4] = { 1, 4, 5, 2 };
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(partitions.nodePositions[1][i] == positions[i]);
+        // the shared nodes are owned by the first process
+        const int owners[6] = { 0, 0, 0, 0, 1, 1 };
+        for (int i = 0; i < 6; i++)
+            CPPUNIT_ASSERT(partitions.nodeOwners[i] == owners[i]);
+        CPPUNIT_ASSERT(partitions.elemOffsets[1] == 1);
+        CPPUNIT_ASSERT(partitions.elemOffsets[2] == 2);
+        delete mesh;
+    }
+    /***********************************************************************************************
+     * \brief Test case: Release a mesh and replace a received mesh by it, the data fields of the
+     *        received mesh are moved to the released one
+     ***********/
+    void testReplaceMesh() {
+        mesh1->addDataField("old", EMPIRE_DataField_atNode, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        CPPUNIT_ASSERT(client->releaseMesh("dummy1") == mesh1);
+        CPPUNIT_ASSERT(client->nameToMeshMap.find("dummy1") == client->nameToMeshMap.end());
+        FEMesh *received = new FEMesh("dummy1", 3, 1);
+        received->addDataField("new", EMPIRE_DataField_atNode, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        DataField *newField = received->getDataFieldByName("new");
+        client->nameToMeshMap.insert(pair<string, AbstractMesh*>(received->name, received));
+        client->replaceMesh("dummy1", mesh1);
+        CPPUNIT_ASSERT(client->getMeshByName("dummy1") == mesh1);
+        CPPUNIT_ASSERT(mesh1->nameToDataFieldMap.size() == 1);
+        CPPUNIT_ASSERT(mesh1->getDataFieldByName("new") == newField);
+    }
 
 CPPUNIT_TEST_SUITE( TestClientCode );
         CPPUNIT_TEST( testName);
         CPPUNIT_TEST( testMesh);
+        CPPUNIT_TEST( testMergeMeshPartitions);
+        CPPUNIT_TEST( testReplaceMesh);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -26,6 +26,8 @@
 #include "DataField.h"
 #include "Connection.h"
 #include "CopyFilter.h"
+#include "ScalingFilter.h"
+#include "AdditionFilter.h"
 #include "Signal.h"
 #include "ConnectionIO.h"
 #include "ConnectionIOSetup.h"
@@ -76,10 +78,173 @@ public:
         CPPUNIT_ASSERT(connection->filterVec.at(1) == filter2);
         CPPUNIT_ASSERT(connection->filterVec.at(2) == filter3);
     }
+    /***********************************************************************************************
+     * \brief Test case: Test that consecutive elementwise filters are fused into one stage which
+     *        gives the same result as running them one after the other
+     ***********/
+    void testFusedFilterPipeline() {
+        delete filter1;
+        delete filter2;
+        delete filter3;
+        int numLocations = 1000; // more entries than one block of a fused stage
+        DataField *x = new DataField("", EMPIRE_DataField_atNode, numLocations, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        DataField *y = new DataField("", EMPIRE_DataField_atNode, numLocations, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        int n = numLocations * EMPIRE_DataField_vector;
+        for (int i = 0; i < n; i++) {
+            x->data[i] = i;
+            y->data[i] = -1.0;
+        }
+        // y = x, y = 2*y, y = x + y, y = 0.5*y
+        AbstractFilter *copy = new CopyFilter(0);
+        ConnectionIOSetup::setupIOForFilter(copy, NULL, x, NULL, y);
+        AbstractFilter *scaling1 = new ScalingFilter(2.0);
+        ConnectionIOSetup::setupIOForFilter(scaling1, NULL, y, NULL, y);
+        AbstractFilter *addition = new AdditionFilter(1.0, 1.0);
+        addition->addInput(ConnectionIOSetup::constructDummyConnectionIO(x));
+        addition->addInput(ConnectionIOSetup::constructDummyConnectionIO(y));
+        addition->addOutput(ConnectionIOSetup::constructDummyConnectionIO(y));
+        addition->init();
+        AbstractFilter *scaling2 = new ScalingFilter(0.5);
+        ConnectionIOSetup::setupIOForFilter(scaling2, NULL, y, NULL, y);
+        connection->addFilter(copy);
+        connection->addFilter(scaling1);
+        connection->addFilter(addition);
+        connection->addFilter(scaling2);
+
+        connection->filterAndStartSend();
+        connection->finishSend();
+
+        CPPUNIT_ASSERT(connection->filterPipeline.size() == 1);
+        CPPUNIT_ASSERT(connection->filterPipeline[0].isFused);
+        CPPUNIT_ASSERT(connection->filterPipeline[0].filters.size() == 4);
+        for (int i = 0; i < n; i++)
+            CPPUNIT_ASSERT(y->data[i] == 1.5 * i);
+        delete x;
+        delete y;
+    }
+    /***********************************************************************************************
+     * \brief Test case: Test the dependency analysis and the concurrent filtering of connections
+     ***********/
+    void testConcurrentConnections() {
+        delete filter1;
+        delete filter2;
+        delete filter3;
+        int numLocations = 10;
+        DataField *x = new DataField("", EMPIRE_DataField_atNode, numLocations, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        DataField *y = new DataField("", EMPIRE_DataField_atNode, numLocations, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        DataField *z = new DataField("", EMPIRE_DataField_atNode, numLocations, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        int n = numLocations * EMPIRE_DataField_vector;
+        for (int i = 0; i < n; i++) {
+            x->data[i] = i;
+            y->data[i] = -1.0;
+            z->data[i] = 1.0;
+        }
+        // connection: y = x, connection2: z = 3*z, connection3: x = 2*x
+        AbstractFilter *copy = new CopyFilter(0);
+        ConnectionIOSetup::setupIOForFilter(copy, NULL, x, NULL, y);
+        connection->addFilter(copy);
+        Connection *connection2 = new Connection("connection2");
+        AbstractFilter *scaling2 = new ScalingFilter(3.0);
+        ConnectionIOSetup::setupIOForFilter(scaling2, NULL, z, NULL, z);
+        connection2->addFilter(scaling2);
+        Connection *connection3 = new Connection("connection3");
+        AbstractFilter *scaling3 = new ScalingFilter(2.0);
+        ConnectionIOSetup::setupIOForFilter(scaling3, NULL, x, NULL, x);
+        connection3->addFilter(scaling3);
+
+        CPPUNIT_ASSERT(!connection2->dependsOn(connection));
+        CPPUNIT_ASSERT(connection3->dependsOn(connection));
+        CPPUNIT_ASSERT(!connection3->dependsOn(connection2));
+
+        std::vector<Connection*> connections;
+        connections.push_back(connection);
+        connections.push_back(connection2);
+        Connection::filterConcurrently(connections);
+        for (int i = 0; i < n; i++) {
+            CPPUNIT_ASSERT(y->data[i] == i);
+            CPPUNIT_ASSERT(z->data[i] == 3.0);
+        }
+        delete connection2;
+        delete connection3;
+        delete x;
+        delete y;
+        delete z;
+    }
+
+    /***********************************************************************************************
+     * \brief Test case: Test that the filters are skipped while the inputs do not change by more
+     *        than the tolerance
+     ***********/
+    void testChangeDetection() {
+        delete filter1;
+        delete filter2;
+        delete filter3;
+        int numLocations = 10;
+        DataField *x = new DataField("", EMPIRE_DataField_atNode, numLocations, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        DataField *y = new DataField("", EMPIRE_DataField_atNode, numLocations, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        for (int i = 0; i < numLocations; i++)
+            x->data[i] = 1.0;
+        // y = x
+        connection->addInput(ConnectionIOSetup::constructDummyConnectionIO(x));
+        AbstractFilter *copy = new CopyFilter(0);
+        ConnectionIOSetup::setupIOForFilter(copy, NULL, x, NULL, y);
+        connection->addFilter(copy);
+        connection->setChangeDetection(true, 1e-3);
+
+        connection->filter();
+        CPPUNIT_ASSERT(y->data[0] == 1.0);
+        y->data[0] = -1.0;
+        connection->filter();
+        CPPUNIT_ASSERT(y->data[0] == -1.0);
+        x->data[0] = 1.001; // relative change of the norm below the tolerance
+        connection->filter();
+        CPPUNIT_ASSERT(y->data[0] == -1.0);
+        x->data[0] = 2.0;
+        connection->filter();
+        CPPUNIT_ASSERT(y->data[0] == 2.0);
+        delete x;
+        delete y;
+    }
+
+    /***********************************************************************************************
+     * \brief Test case: Test that the signals of a client are bundled at its first signal
+     ***********/
+    void testSignalBundles() {
+        ClientCode clientA("clientA");
+        ClientCode clientB("clientB");
+        Signal signal1("signal1", 1, 1, 1);
+        Signal signal2("signal2", 3, 1, 1);
+        Signal signal3("signal3", 2, 1, 1);
+        std::vector<ConnectionIO*> ios;
+        ios.push_back(new ConnectionIO(&clientA, &signal1));
+        ios.push_back(new ConnectionIO(&clientB, &signal2));
+        ios.push_back(new ConnectionIO(&clientA, &signal3));
+        std::vector<std::string> signalNames;
+        CPPUNIT_ASSERT(Connection::getSignalBundle(ios, 0, signalNames));
+        CPPUNIT_ASSERT(signalNames.size() == 2);
+        CPPUNIT_ASSERT(signalNames[0] == "signal1" && signalNames[1] == "signal3");
+        CPPUNIT_ASSERT(Connection::getSignalBundle(ios, 1, signalNames));
+        CPPUNIT_ASSERT(signalNames.size() == 1 && signalNames[0] == "signal2");
+        CPPUNIT_ASSERT(!Connection::getSignalBundle(ios, 2, signalNames));
+        CPPUNIT_ASSERT(signalNames.size() == 2);
+        for (unsigned i = 0; i < ios.size(); i++)
+            delete ios[i];
+    }
 
 CPPUNIT_TEST_SUITE( TestConnection );
         CPPUNIT_TEST( testInitialization);
         CPPUNIT_TEST( testFilterSequence);
+        CPPUNIT_TEST( testFusedFilterPipeline);
+        CPPUNIT_TEST( testConcurrentConnections);
+        CPPUNIT_TEST( testChangeDetection);
+        CPPUNIT_TEST( testSignalBundles);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -23,6 +23,7 @@
 #include "cppunit/extensions/HelperMacros.h"
 #include "DataField.h"
 #include <string>
+#include <math.h>
 
 namespace EMPIRE {
 /********//**
@@ -64,9 +65,81 @@ public:
             for (int j = 0; j < df->dimension; j++)
                 CPPUNIT_ASSERT(df->data[i*3+j] == i / 10.0);
     }
+    /***********************************************************************************************
+     * \brief Test case: Test the interpolation in time between the stored time levels
+     ***********/
+    void testHistory() {
+        const int size = 9;
+        df->setHistoryLength(2);
+        CPPUNIT_ASSERT(df->getHistoryLength() == 2);
+        for (int i = 0; i < size; i++)
+            df->data[i] = i;
+        df->storeHistory(4.0);
+        // one time level is copied
+        df->interpolateHistory(2.0);
+        for (int i = 0; i < size; i++)
+            CPPUNIT_ASSERT(df->data[i] == i);
+        // the latest time level is replaced at the same time
+        for (int i = 0; i < size; i++)
+            df->data[i] = 2.0 * i;
+        df->storeHistory(4.0);
+        for (int i = 0; i < size; i++)
+            df->data[i] = 4.0 * i;
+        df->storeHistory(8.0);
+        df->interpolateHistory(5.0);
+        for (int i = 0; i < size; i++)
+            CPPUNIT_ASSERT(fabs(df->data[i] - 2.5 * i) < 1e-12);
+        // the oldest time level is replaced
+        for (int i = 0; i < size; i++)
+            df->data[i] = 0.0;
+        df->storeHistory(12.0);
+        df->interpolateHistory(11.0);
+        for (int i = 0; i < size; i++)
+            CPPUNIT_ASSERT(fabs(df->data[i] - i) < 1e-12);
+    }
+    /***********************************************************************************************
+     * \brief Test case: Test the sharing of the snapshots of a history by their tags
+     ***********/
+    void testSharedHistory() {
+        const int size = 9;
+        DataHistory *history = df->getHistory(DataHistory::ITERATION);
+        CPPUNIT_ASSERT(history == df->getHistory(DataHistory::ITERATION));
+        CPPUNIT_ASSERT(history != df->getHistory(DataHistory::TIME_STEP));
+        // two consumers of one snapshot each
+        history->reserve(1);
+        history->reserve(1);
+        CPPUNIT_ASSERT(history->getCapacity() == 2);
+        for (int i = 0; i < size; i++)
+            df->data[i] = i;
+        long long tag0 = DataHistory::newTag();
+        const double *snapshot0 = history->snapshot(df->data, tag0);
+        CPPUNIT_ASSERT((size_t) snapshot0 % 64 == 0);
+        // the second consumer shares the snapshot of the same tag
+        df->data[0] = -1.0;
+        CPPUNIT_ASSERT(history->snapshot(df->data, tag0) == snapshot0);
+        CPPUNIT_ASSERT(history->getNumSnapshots() == 1);
+        CPPUNIT_ASSERT(snapshot0[0] == 0.0);
+        // a new tag takes the next snapshot, the next one overwrites the oldest
+        long long tag1 = DataHistory::newTag();
+        const double *snapshot1 = history->snapshot(df->data, tag1);
+        CPPUNIT_ASSERT(snapshot1 != snapshot0);
+        CPPUNIT_ASSERT((size_t) snapshot1 % 64 == 0);
+        CPPUNIT_ASSERT(snapshot1[0] == -1.0);
+        long long tag2 = DataHistory::newTag();
+        CPPUNIT_ASSERT(history->snapshot(df->data, tag2) == snapshot0);
+        CPPUNIT_ASSERT(history->find(tag0) == NULL);
+        CPPUNIT_ASSERT(history->find(tag1) == snapshot1);
+        // the snapshot is refreshed in place
+        df->data[1] = 5.0;
+        CPPUNIT_ASSERT(history->replace(df->data, tag1) == snapshot1);
+        for (int i = 0; i < size; i++)
+            CPPUNIT_ASSERT(snapshot1[i] == df->data[i]);
+    }
 CPPUNIT_TEST_SUITE( TestDataField );
         CPPUNIT_TEST( testConstructor);
         CPPUNIT_TEST( testData);
+        CPPUNIT_TEST( testHistory);
+        CPPUNIT_TEST( testSharedHistory);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -0,0 +1,102 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+#include "DataFieldCodec.h"
+#include "EMPEROR_Enum.h"
+#include <math.h>
+#include <vector>
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the class DataFieldCodec
+ ***********/
+class TestDataFieldCodec: public CppUnit::TestFixture {
+private:
+    static const int SIZE = 301;
+    std::vector<double> data;
+public:
+    void setUp() {
+        data.resize(SIZE);
+        for (int i = 0; i < SIZE; i++)
+            data[i] = sin(0.01 * i) * 1e-3;
+        data[7] = 0.0;
+        data[8] = -1e300;
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: float32 is exact to single precision
+     ***********/
+    void testFloat32() {
+        std::vector<unsigned char> encoded(
+                DataFieldCodec::getMaxEncodedSize(EMPIRE_DataField_float32, SIZE));
+        std::vector<double> decoded(SIZE);
+        int numBytes = DataFieldCodec::encode(EMPIRE_DataField_float32, SIZE, &data[0], NULL,
+                &encoded[0]);
+        CPPUNIT_ASSERT(numBytes == SIZE * 4);
+        DataFieldCodec::decode(EMPIRE_DataField_float32, SIZE, &encoded[0], numBytes, NULL,
+                &decoded[0]);
+        for (int i = 0; i < SIZE; i++)
+            if (i != 8)
+                CPPUNIT_ASSERT(decoded[i] == (double) (float) data[i]);
+    }
+    /***********************************************************************************************
+     * \brief Test case: lossless and deltaLossless reproduce all bits, and deltaLossless shrinks a
+     *        slowly changing field
+     ***********/
+    void testLossless() {
+        EMPIRE_DataField_wireFormat formats[2] = { EMPIRE_DataField_lossless,
+                EMPIRE_DataField_deltaLossless };
+        for (int f = 0; f < 2; f++) {
+            std::vector<unsigned char> encoded(DataFieldCodec::getMaxEncodedSize(formats[f], SIZE));
+            std::vector<double> sendHistory(SIZE, 0.0);
+            std::vector<double> recvHistory(SIZE, 0.0);
+            std::vector<double> decoded(SIZE);
+            int numBytesOfUnchanged = 0;
+            for (int step = 0; step < 3; step++) {
+                if (step == 1)
+                    data[3] *= 1.0 + 1e-12;
+                int numBytes = DataFieldCodec::encode(formats[f], SIZE, &data[0], &sendHistory[0],
+                        &encoded[0]);
+                CPPUNIT_ASSERT(numBytes <= (int) encoded.size());
+                DataFieldCodec::decode(formats[f], SIZE, &encoded[0], numBytes, &recvHistory[0],
+                        &decoded[0]);
+                for (int i = 0; i < SIZE; i++)
+                    CPPUNIT_ASSERT(decoded[i] == data[i]);
+                if (step == 2)
+                    numBytesOfUnchanged = numBytes;
+            }
+            if (formats[f] == EMPIRE_DataField_deltaLossless) // only the byte counts are left
+                CPPUNIT_ASSERT(numBytesOfUnchanged == (SIZE + 1) / 2);
+        }
+    }
+
+    CPPUNIT_TEST_SUITE( TestDataFieldCodec );
+        CPPUNIT_TEST( testFloat32);
+        CPPUNIT_TEST( testLossless);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestDataFieldCodec);
@@ -99,6 +99,12 @@ public:
         // set up dummy dataOutput
         structDataOutput settingDataOutput;
         settingDataOutput.name = STRING_DUMMY;
+        settingDataOutput.format = EMPIRE_DataOutput_GiD;
+        settingDataOutput.asyncQueueDepth = 0;
+        settingDataOutput.compressionLevel = 0;
+        settingDataOutput.hasRegionBox = false;
+        settingDataOutput.nodeStride = 1;
+        settingDataOutput.igaTessellation = 0;
         DataOutput *dataOutput = new DataOutput(settingDataOutput, emperor->nameToClientCodeMap);
         emperor->nameToDataOutputMap.insert(pair<string, DataOutput *>(STRING_DUMMY, dataOutput));
 
@@ -160,6 +166,7 @@ public:
         structCouplingLogic optimizationLoop;
         optimizationLoop.type = EMPIRE_OptimizationLoop;
         optimizationLoop.optimizationLoop.maxNumOfIterations = INTY;
+        optimizationLoop.optimizationLoop.concurrentDesigns = false;
         optimizationLoop.optimizationLoop.convergenceSignalSender = STRING_CLIENT_A;
         optimizationLoop.optimizationLoop.convergenceSignalReceivers.push_back(STRING_CLIENT_B);
         optimizationLoop.sequence.push_back(timeStepLoop);
@@ -22,9 +22,14 @@
 #include "cppunit/TestAssert.h"
 #include "cppunit/extensions/HelperMacros.h"
 #include "FEMesh.h"
+#include "FEMeshSpatialIndex.h"
+#include "FEMeshConnectivity.h"
+#include "FEMeshGeometry.h"
+#include "IDToIndexMap.h"
 #include "DataField.h"
 #include "Message.h"
 #include <iostream>
+#include <math.h>
 
 using namespace std;
 
@@ -442,6 +447,329 @@ public:
         //infoOut << *mesh;
         delete mesh;
     }
+    /***********************************************************************************************
+     * \brief Test the spatial index, the connectivity and the node index over a strip of quads,
+     *        [i, i+1] x [0, 1] is the i-th element
+     ***********/
+    void testSpatialIndex() {
+        const int numElems = 10;
+        const int numNodes = 2 * (numElems + 1);
+        FEMesh *mesh = new FEMesh("strip", numNodes, numElems);
+        for (int i = 0; i < numElems + 1; i++) {
+            for (int j = 0; j < 2; j++) {
+                mesh->nodeIDs[i * 2 + j] = 100 + i * 2 + j;
+                mesh->nodes[(i * 2 + j) * 3 + 0] = i;
+                mesh->nodes[(i * 2 + j) * 3 + 1] = j;
+                mesh->nodes[(i * 2 + j) * 3 + 2] = 0.0;
+            }
+        }
+        for (int i = 0; i < numElems; i++)
+            mesh->numNodesPerElem[i] = 4;
+        mesh->initElems();
+        for (int i = 0; i < numElems; i++) {
+            mesh->elems[i * 4 + 0] = 100 + i * 2;
+            mesh->elems[i * 4 + 1] = 100 + i * 2 + 2;
+            mesh->elems[i * 4 + 2] = 100 + i * 2 + 3;
+            mesh->elems[i * 4 + 3] = 100 + i * 2 + 1;
+        }
+
+        FEMeshSpatialIndex *index = mesh->getSpatialIndex();
+        CPPUNIT_ASSERT(index == mesh->getSpatialIndex());
+
+        const double *centroids = index->getElemCentroids();
+        const double *boxes = index->getElemBoundingBoxes();
+        for (int i = 0; i < numElems; i++) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(i + 0.5, centroids[i * 3 + 0], 1E-12);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, centroids[i * 3 + 1], 1E-12);
+            CPPUNIT_ASSERT(boxes[i * 6 + 0] == i);
+            CPPUNIT_ASSERT(boxes[i * 6 + 1] == i + 1);
+            CPPUNIT_ASSERT(boxes[i * 6 + 2] == 0.0);
+            CPPUNIT_ASSERT(boxes[i * 6 + 3] == 1.0);
+        }
+
+        std::vector<int> elems;
+        double point[3] = { 3.5, 0.2, 0.0 };
+        index->findElemsContainingPoint(point, 0.0, elems);
+        CPPUNIT_ASSERT(elems.size() == 1);
+        CPPUNIT_ASSERT(elems[0] == 3);
+        point[0] = 7.0; // on the common edge of elements 6 and 7
+        index->findElemsContainingPoint(point, 0.0, elems);
+        CPPUNIT_ASSERT(elems.size() == 2);
+        CPPUNIT_ASSERT((elems[0] == 6 && elems[1] == 7) || (elems[0] == 7 && elems[1] == 6));
+        point[2] = 0.5; // out of plane
+        index->findElemsContainingPoint(point, 0.0, elems);
+        CPPUNIT_ASSERT(elems.empty());
+        index->findElemsContainingPoint(point, 0.6, elems);
+        CPPUNIT_ASSERT(elems.size() == 2);
+
+        double box[6] = { 1.5, 4.5, -1.0, 2.0, -1.0, 1.0 };
+        index->findElemsIntersectingBox(box, 0.0, elems);
+        CPPUNIT_ASSERT(elems.size() == 4);
+
+        const FEMeshConnectivity *connectivity = mesh->getConnectivity();
+        CPPUNIT_ASSERT(connectivity == mesh->getConnectivity());
+        CPPUNIT_ASSERT(connectivity->getElemOffsets()[numElems] == 4 * numElems);
+        CPPUNIT_ASSERT(connectivity->getNumNodesOfElem(3) == 4);
+        CPPUNIT_ASSERT(connectivity->getElemNodes(3)[0] == 6);
+        CPPUNIT_ASSERT(connectivity->getElemNodes(3)[1] == 8);
+        CPPUNIT_ASSERT(connectivity->getElemNodes(3)[2] == 9);
+        CPPUNIT_ASSERT(connectivity->getElemNodes(3)[3] == 7);
+        CPPUNIT_ASSERT(connectivity->getNodeOffsets()[numNodes] == 4 * numElems);
+        CPPUNIT_ASSERT(connectivity->getNumElemsOfNode(0) == 1);
+        CPPUNIT_ASSERT(connectivity->getNodeElems(0)[0] == 0);
+        CPPUNIT_ASSERT(connectivity->getNumElemsOfNode(5) == 2);
+        CPPUNIT_ASSERT(connectivity->getNodeElems(5)[0] == 1);
+        CPPUNIT_ASSERT(connectivity->getNodeElems(5)[1] == 2);
+        CPPUNIT_ASSERT(connectivity->getNumElemsOfNode(numNodes - 1) == 1);
+        CPPUNIT_ASSERT(connectivity->getNodeElems(numNodes - 1)[0] == numElems - 1);
+
+        const IDToIndexMap *nodeIndex = mesh->getNodeIndex();
+        CPPUNIT_ASSERT(nodeIndex == mesh->getNodeIndex());
+        CPPUNIT_ASSERT(nodeIndex->isDenseTable());
+        CPPUNIT_ASSERT(nodeIndex->at(100) == 0);
+        CPPUNIT_ASSERT(nodeIndex->at(105) == 5);
+        CPPUNIT_ASSERT(nodeIndex->find(99) == -1);
+
+        mesh->invalidateSpatialIndex();
+        CPPUNIT_ASSERT(mesh->getSpatialIndex() != NULL);
+
+        delete mesh;
+    }
+
+    /***********************************************************************************************
+     * \brief Test the element geometry of a triangle, a quad and a pentagon in the plane z = 1
+     ***********/
+    void testElemGeometry() {
+        FEMesh *mesh = new FEMesh("polygons", 8, 3);
+        const double nodes[8 * 2] = { 0, 0, 2, 0, 2, 1, 0, 1, 3, 0, 3, 2, 2, 3, 1, 2 };
+        for (int i = 0; i < 8; i++) {
+            mesh->nodeIDs[i] = i + 1;
+            mesh->nodes[i * 3 + 0] = nodes[i * 2 + 0];
+            mesh->nodes[i * 3 + 1] = nodes[i * 2 + 1];
+            mesh->nodes[i * 3 + 2] = 1.0;
+        }
+        mesh->numNodesPerElem[0] = 3;
+        mesh->numNodesPerElem[1] = 4;
+        mesh->numNodesPerElem[2] = 5;
+        mesh->initElems();
+        const int elems[12] = { 1, 2, 4, 1, 2, 3, 4, 2, 5, 6, 7, 8 };
+        for (int i = 0; i < 12; i++)
+            mesh->elems[i] = elems[i];
+
+        const FEMeshGeometry *geometry = mesh->getElemGeometry();
+        CPPUNIT_ASSERT(geometry == mesh->getElemGeometry());
+        for (int i = 0; i < 3; i++) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, geometry->getNormal(i)[0], 1E-12);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, geometry->getNormal(i)[1], 1E-12);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, geometry->getNormal(i)[2], 1E-12);
+            CPPUNIT_ASSERT(geometry->getPlaneToProject(i) == 2);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, geometry->getCentroid(i)[2], 1E-12);
+        }
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, geometry->getArea(0), 1E-12);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, geometry->getArea(1), 1E-12);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, geometry->getCentroid(1)[0], 1E-12);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, geometry->getCentroid(1)[1], 1E-12);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, geometry->getArea(2), 1E-12);
+        CPPUNIT_ASSERT(geometry->getCentroids() == mesh->getSpatialIndex()->getElemCentroids());
+
+        // the geometry is computed again after the nodes have been moved
+        for (int i = 0; i < 8; i++)
+            mesh->nodes[i * 3 + 2] = mesh->nodes[i * 3 + 0];
+        mesh->invalidateSpatialIndex();
+        geometry = mesh->getElemGeometry();
+        for (int i = 0; i < 3; i++) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(-sqrt(0.5), geometry->getNormal(i)[0], 1E-12);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(sqrt(0.5), geometry->getNormal(i)[2], 1E-12);
+        }
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0 * sqrt(2.0), geometry->getArea(1), 1E-12);
+
+        delete mesh;
+    }
+    /***********************************************************************************************
+     * \brief Test the preparation of a long strip of quads which are all triangulated, it must give
+     *        the same results as the steps done one by one
+     ***********/
+    void testPrepare() {
+        const int numElems = 1000;
+        const int numNodes = 2 * (numElems + 1);
+        FEMesh *mesh = new FEMesh("strip", numNodes, numElems, true);
+        for (int i = 0; i < numElems + 1; i++) {
+            for (int j = 0; j < 2; j++) {
+                mesh->nodeIDs[i * 2 + j] = 100 + i * 2 + j;
+                mesh->nodes[(i * 2 + j) * 3 + 0] = i;
+                mesh->nodes[(i * 2 + j) * 3 + 1] = j;
+                mesh->nodes[(i * 2 + j) * 3 + 2] = -0.5 * j;
+            }
+        }
+        for (int i = 0; i < numElems; i++)
+            mesh->numNodesPerElem[i] = 4;
+        mesh->initElems();
+        for (int i = 0; i < numElems; i++) {
+            mesh->elems[i * 4 + 0] = 100 + i * 2;
+            mesh->elems[i * 4 + 1] = 100 + i * 2 + 2;
+            mesh->elems[i * 4 + 2] = 100 + i * 2 + 3;
+            mesh->elems[i * 4 + 3] = 100 + i * 2 + 1;
+        }
+        mesh->prepare();
+
+        CPPUNIT_ASSERT(mesh->boundingBox.isComputed());
+        CPPUNIT_ASSERT(mesh->boundingBox.getXmin() == 0.0);
+        CPPUNIT_ASSERT(mesh->boundingBox.getXmax() == numElems);
+        CPPUNIT_ASSERT(mesh->boundingBox.getYmin() == 0.0);
+        CPPUNIT_ASSERT(mesh->boundingBox.getYmax() == 1.0);
+        CPPUNIT_ASSERT(mesh->boundingBox.getZmin() == -0.5);
+        CPPUNIT_ASSERT(mesh->boundingBox.getZmax() == 0.0);
+
+        const FEMeshConnectivity *connectivity = mesh->getConnectivity();
+        for (int i = 0; i < numElems; i++)
+            CPPUNIT_ASSERT(connectivity->getElemNodes(i)[1] == i * 2 + 2);
+        const double *boxes = mesh->getSpatialIndex()->getElemBoundingBoxes();
+        for (int i = 0; i < numElems; i++) {
+            CPPUNIT_ASSERT(boxes[i * 6 + 0] == i);
+            CPPUNIT_ASSERT(boxes[i * 6 + 1] == i + 1);
+        }
+
+        FEMesh *triangulated = mesh->triangulate();
+        CPPUNIT_ASSERT(triangulated != NULL);
+        CPPUNIT_ASSERT(triangulated->numElems == 2 * numElems);
+        CPPUNIT_ASSERT(triangulated->boundingBox.isComputed());
+        const double *triangleBoxes = triangulated->getSpatialIndex()->getElemBoundingBoxes();
+        for (int i = 0; i < numElems; i++) {
+            CPPUNIT_ASSERT(triangulated->numNodesPerElem[2 * i] == 3);
+            CPPUNIT_ASSERT(triangulated->numNodesPerElem[2 * i + 1] == 3);
+            // the triangles of a quad lie in it and cover it together
+            CPPUNIT_ASSERT(min(triangleBoxes[2 * i * 6 + 0], triangleBoxes[(2 * i + 1) * 6 + 0]) == i);
+            CPPUNIT_ASSERT(max(triangleBoxes[2 * i * 6 + 1], triangleBoxes[(2 * i + 1) * 6 + 1]) == i + 1);
+            for (int j = 0; j < 6; j++) {
+                int nodeID = triangulated->elems[6 * i + j];
+                CPPUNIT_ASSERT(nodeID >= 100 + i * 2 && nodeID <= 100 + i * 2 + 3);
+            }
+        }
+        CPPUNIT_ASSERT(triangulated->getConnectivity()->getElemOffsets()[2 * numElems] == 6 * numElems);
+
+        delete mesh;
+    }
+
+    /***********************************************************************************************
+     * \brief Test the renumbering of a strip with the nodes and the elements in a scrambled order
+     ***********/
+    void testRenumber() {
+        const int numElems = 16;
+        const int numNodes = 2 * (numElems + 1);
+        FEMesh *mesh = new FEMesh("strip", numNodes, numElems);
+        // client node k is the node (pos / 2, pos % 2) of the strip, visited with a stride
+        for (int k = 0; k < numNodes; k++) {
+            int pos = (k * 7) % numNodes;
+            mesh->nodeIDs[k] = 100 + pos;
+            mesh->nodes[k * 3 + 0] = pos / 2;
+            mesh->nodes[k * 3 + 1] = pos % 2;
+            mesh->nodes[k * 3 + 2] = 0.0;
+        }
+        for (int i = 0; i < numElems; i++)
+            mesh->numNodesPerElem[i] = (i % 2 == 0) ? 4 : 3;
+        mesh->initElems();
+        // client element e covers the cell (e * 5) % numElems, odd ones as a triangle
+        int count = 0;
+        for (int e = 0; e < numElems; e++) {
+            int cell = (e * 5) % numElems;
+            mesh->elems[count++] = 100 + cell * 2;
+            mesh->elems[count++] = 100 + cell * 2 + 2;
+            mesh->elems[count++] = 100 + cell * 2 + 3;
+            if (mesh->numNodesPerElem[e] == 4)
+                mesh->elems[count++] = 100 + cell * 2 + 1;
+        }
+        std::vector<int> clientElems(mesh->elems, mesh->elems + mesh->elemsArraySize);
+        CPPUNIT_ASSERT(!mesh->isRenumbered());
+        mesh->renumber(EMPIRE_Mesh_hilbertRenumbering);
+        CPPUNIT_ASSERT(mesh->isRenumbered());
+
+        // the node IDs stay with their coordinates, the elements with their IDs
+        for (int i = 0; i < numNodes; i++) {
+            int pos = mesh->nodeIDs[i] - 100;
+            CPPUNIT_ASSERT(mesh->nodes[i * 3 + 0] == pos / 2);
+            CPPUNIT_ASSERT(mesh->nodes[i * 3 + 1] == pos % 2);
+        }
+        count = 0;
+        for (int i = 0; i < numElems; i++) {
+            int e = mesh->elemIDs[i] - 1;
+            CPPUNIT_ASSERT(mesh->numNodesPerElem[i] == ((e % 2 == 0) ? 4 : 3));
+            int cell = (e * 5) % numElems;
+            CPPUNIT_ASSERT(mesh->elems[count] == 100 + cell * 2);
+            count += mesh->numNodesPerElem[i];
+        }
+        CPPUNIT_ASSERT(count == mesh->elemsArraySize);
+        // the nodes follow the strip instead of jumping along it
+        CPPUNIT_ASSERT(mesh->getNodeIndex()->at(mesh->nodeIDs[0]) == 0);
+        double clientPathLength = 0.0, pathLength = 0.0;
+        for (int i = 1; i < numNodes; i++) {
+            clientPathLength += abs((i * 7) % numNodes / 2 - ((i - 1) * 7) % numNodes / 2);
+            pathLength += fabs(mesh->nodes[i * 3] - mesh->nodes[(i - 1) * 3]);
+        }
+        CPPUNIT_ASSERT(pathLength < 0.5 * clientPathLength);
+        mesh->getConnectivity();
+
+        // data in the order of the client
+        std::vector<double> clientData(numNodes * 3), data(numNodes * 3), back(numNodes * 3);
+        for (int k = 0; k < numNodes * 3; k++)
+            clientData[k] = k;
+        mesh->fromClientOrder(EMPIRE_DataField_atNode, 3, &clientData[0], &data[0]);
+        for (int i = 0; i < numNodes; i++) {
+            int k = -1;
+            for (int l = 0; l < numNodes; l++)
+                if ((l * 7) % numNodes == mesh->nodeIDs[i] - 100)
+                    k = l;
+            CPPUNIT_ASSERT(data[i * 3 + 2] == k * 3 + 2);
+        }
+        mesh->toClientOrder(EMPIRE_DataField_atNode, 3, &data[0], &back[0]);
+        CPPUNIT_ASSERT(back == clientData);
+        std::vector<double> clientElemData(numElems), elemData(numElems);
+        for (int e = 0; e < numElems; e++)
+            clientElemData[e] = e + 1;
+        mesh->fromClientOrder(EMPIRE_DataField_atElemCentroid, 1, &clientElemData[0], &elemData[0]);
+        for (int i = 0; i < numElems; i++)
+            CPPUNIT_ASSERT(elemData[i] == mesh->elemIDs[i]);
+
+        delete mesh;
+    }
+    /***********************************************************************************************
+     * \brief Test case: equal meshes have equal content hashes, the hash of a changed mesh changes
+     *        when it is updated
+     ***********/
+    void testContentHash() {
+        FEMesh *meshes[2];
+        double nodes[] = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+        for (int m = 0; m < 2; m++) {
+            meshes[m] = new FEMesh("quad" + string(m == 0 ? "A" : "B"), 4, 1);
+            for (int i = 0; i < 12; i++)
+                meshes[m]->nodes[i] = nodes[i];
+            for (int i = 0; i < 4; i++)
+                meshes[m]->nodeIDs[i] = i + 1;
+            meshes[m]->numNodesPerElem[0] = 4;
+            meshes[m]->initElems();
+            for (int i = 0; i < 4; i++)
+                meshes[m]->elems[i] = i + 1;
+        }
+        // the names and data fields are not part of the content
+        meshes[1]->addDataField("displacements", EMPIRE_DataField_atNode, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        uint64_t hash = meshes[0]->getContentHash();
+        CPPUNIT_ASSERT(meshes[1]->getContentHash() == hash);
+
+        meshes[1]->elems[3] = 1;
+        meshes[1]->elems[0] = 4;
+        CPPUNIT_ASSERT(meshes[1]->getContentHash() == hash);
+        meshes[1]->updateContentHash();
+        CPPUNIT_ASSERT(meshes[1]->getContentHash() != hash);
+
+        meshes[0]->nodes[2] = 1e-12;
+        meshes[0]->updateContentHash();
+        CPPUNIT_ASSERT(meshes[0]->getContentHash() != hash);
+        meshes[0]->nodes[2] = 0.0;
+        meshes[0]->updateContentHash();
+        CPPUNIT_ASSERT(meshes[0]->getContentHash() == hash);
+        delete meshes[0];
+        delete meshes[1];
+    }
 
     CPPUNIT_TEST_SUITE(TestFEMesh);
     CPPUNIT_TEST(testMeshCreation);
@@ -449,7 +777,13 @@ public:
     CPPUNIT_TEST(testRevertSurfaceNormal);
     CPPUNIT_TEST(testTriangulation);
     CPPUNIT_TEST(testTriangulation2);
-    CPPUNIT_TEST(testBoundingBox);CPPUNIT_TEST_SUITE_END();
+    CPPUNIT_TEST(testBoundingBox);
+    CPPUNIT_TEST(testSpatialIndex);
+    CPPUNIT_TEST(testPrepare);
+    CPPUNIT_TEST(testElemGeometry);
+    CPPUNIT_TEST(testRenumber);
+    CPPUNIT_TEST(testContentHash);
+    CPPUNIT_TEST_SUITE_END();
 };
 
 } /* namespace EMPIRE */
@@ -75,6 +75,7 @@ public:
             CPPUNIT_ASSERT(settingClientCodesVec.size() == 3);
             structClientCode client0 = settingClientCodesVec[0];
             CPPUNIT_ASSERT(client0.name == "meshClientA");
+            CPPUNIT_ASSERT(client0.inProcessLibrary.empty());
             CPPUNIT_ASSERT(client0.meshes.size() == 2);
             CPPUNIT_ASSERT(client0.meshes[0].name == "myMesh");
             CPPUNIT_ASSERT(client0.meshes[0].triangulateAll == true);
@@ -118,6 +119,7 @@ public:
 
             structClientCode client3 = settingClientCodesVec[2];
             CPPUNIT_ASSERT(client3.name == "optimizer");
+            CPPUNIT_ASSERT(client3.inProcessLibrary == "libOptimizer.so");
             CPPUNIT_ASSERT(client3.meshes.size() == 0);
             CPPUNIT_ASSERT(client3.signals.size() == 2);
         }
@@ -127,6 +129,15 @@ public:
                 structDataOutput dataOutput = settingDataOutputVec[0];
                 CPPUNIT_ASSERT(dataOutput.name=="dataOutput1");
                 CPPUNIT_ASSERT(dataOutput.interval==5);
+                CPPUNIT_ASSERT(dataOutput.format==EMPIRE_DataOutput_GiD);
+                CPPUNIT_ASSERT(dataOutput.asyncQueueDepth==2);
+                CPPUNIT_ASSERT(dataOutput.compressionLevel==0);
+                CPPUNIT_ASSERT(dataOutput.streamEngine=="SST");
+                CPPUNIT_ASSERT(!dataOutput.hasRegionBox);
+                CPPUNIT_ASSERT(dataOutput.regionElemIDs.size()==0);
+                CPPUNIT_ASSERT(dataOutput.nodeStride==1);
+                CPPUNIT_ASSERT(dataOutput.igaTessellation==0);
+                CPPUNIT_ASSERT(dataOutput.connectionIOs[0].dataFieldRef.outputInterval==0);
                 CPPUNIT_ASSERT(dataOutput.connectionIOs.size()==4);
                 CPPUNIT_ASSERT(dataOutput.connectionIOs[0].type==EMPIRE_ConnectionIO_DataField);
                 CPPUNIT_ASSERT(dataOutput.connectionIOs[1].type==EMPIRE_ConnectionIO_DataField);
@@ -150,6 +161,19 @@ public:
                 structDataOutput dataOutput = settingDataOutputVec[1];
                 CPPUNIT_ASSERT(dataOutput.name=="dataOutput2");
                 CPPUNIT_ASSERT(dataOutput.interval==1);
+                CPPUNIT_ASSERT(dataOutput.format==EMPIRE_DataOutput_binary);
+                CPPUNIT_ASSERT(dataOutput.asyncQueueDepth==0);
+                CPPUNIT_ASSERT(dataOutput.nodeStride==4);
+                CPPUNIT_ASSERT(dataOutput.igaTessellation==8);
+                CPPUNIT_ASSERT(dataOutput.hasRegionBox);
+                CPPUNIT_ASSERT(dataOutput.regionMin[0]==-1.0);
+                CPPUNIT_ASSERT(dataOutput.regionMin[2]==0.5);
+                CPPUNIT_ASSERT(dataOutput.regionMax[1]==3.0);
+                CPPUNIT_ASSERT(dataOutput.regionMax[2]==4.5);
+                CPPUNIT_ASSERT(dataOutput.regionElemIDs.size()==3);
+                CPPUNIT_ASSERT(dataOutput.regionElemIDs[2]==7);
+                CPPUNIT_ASSERT(dataOutput.connectionIOs[0].dataFieldRef.outputInterval==0);
+                CPPUNIT_ASSERT(dataOutput.connectionIOs[1].dataFieldRef.outputInterval==10);
                 CPPUNIT_ASSERT(dataOutput.connectionIOs.size()==4);
                 CPPUNIT_ASSERT(dataOutput.connectionIOs[0].type==EMPIRE_ConnectionIO_DataField);
                 CPPUNIT_ASSERT(dataOutput.connectionIOs[1].type==EMPIRE_ConnectionIO_DataField);
@@ -183,10 +207,37 @@ public:
                 CPPUNIT_ASSERT(settingMapper.mortarMapper.oppositeSurfaceNormal == false);
                 CPPUNIT_ASSERT(settingMapper.mortarMapper.dual == true);
                 CPPUNIT_ASSERT(settingMapper.mortarMapper.enforceConsistency == true);
+                CPPUNIT_ASSERT(settingMapper.couplingMatricesCache == "couplingMatricesCache");
+                CPPUNIT_ASSERT(settingMapper.iterativeSolverTolerance == 1e-8);
+                CPPUNIT_ASSERT(settingMapper.iterativeSolverMaxIterations == 200);
+                CPPUNIT_ASSERT(settingMapper.inexactSolveForcing == 0.1);
+                CPPUNIT_ASSERT(settingMapper.inexactSolveMaxTolerance == 1e-2);
+                CPPUNIT_ASSERT(settingMapper.linearSolver == "auto");
+                CPPUNIT_ASSERT(settingMapper.pardiso.numThreads == 4);
+                CPPUNIT_ASSERT(settingMapper.pardiso.ordering == MathLibrary::PardisoSettings::PARALLEL_NESTED_DISSECTION);
+                CPPUNIT_ASSERT(settingMapper.pardiso.outOfCoreMode == MathLibrary::PardisoSettings::AUTOMATIC_OUT_OF_CORE);
+                CPPUNIT_ASSERT(settingMapper.pardiso.outOfCoreDirectory == "/tmp");
+                CPPUNIT_ASSERT(settingMapper.pardiso.outOfCoreMaxCoreSize == 1000);
+                CPPUNIT_ASSERT(settingMapper.pardiso.twoLevelFactorization);
+                CPPUNIT_ASSERT(settingMapper.compactAfterBuild);
+                CPPUNIT_ASSERT(settingMapper.conservationMonitorInterval == 5);
+                CPPUNIT_ASSERT(settingMapper.conservationMonitorTolerance == 1e-8);
+                CPPUNIT_ASSERT(settingMapper.buildStatisticsReport);
             }
             { // 2nd mapper
                 structMapper settingMapper = settingMapperVec[1];
                 CPPUNIT_ASSERT(settingMapper.name == "nn");
+                // cached with the checkpoints
+                CPPUNIT_ASSERT(settingMapper.couplingMatricesCache == "restartFiles");
+                CPPUNIT_ASSERT(settingMapper.iterativeSolverTolerance == 0.0);
+                CPPUNIT_ASSERT(settingMapper.iterativeSolverMaxIterations == 1000);
+                CPPUNIT_ASSERT(settingMapper.inexactSolveForcing == 0.0);
+                CPPUNIT_ASSERT(settingMapper.linearSolver == "direct");
+                CPPUNIT_ASSERT(settingMapper.pardiso.numThreads == 1);
+                CPPUNIT_ASSERT(settingMapper.pardiso.outOfCoreMode == MathLibrary::PardisoSettings::IN_CORE);
+                CPPUNIT_ASSERT(!settingMapper.compactAfterBuild);
+                CPPUNIT_ASSERT(settingMapper.conservationMonitorInterval == 0);
+                CPPUNIT_ASSERT(!settingMapper.buildStatisticsReport);
                 CPPUNIT_ASSERT(settingMapper.meshRefA.clientCodeName == "meshClientA");
                 CPPUNIT_ASSERT(settingMapper.meshRefB.clientCodeName == "meshClientB");
                 CPPUNIT_ASSERT(settingMapper.meshRefA.meshName == "myMesh");
@@ -248,7 +299,7 @@ public:
             CPPUNIT_ASSERT(settingCoupAlg.outputs[0].index == 1);
         }
         { // check block extrapolators
-            CPPUNIT_ASSERT(settingExtrapolatorVec.size() == 1);
+            CPPUNIT_ASSERT(settingExtrapolatorVec.size() == 2);
             structExtrapolator settingExtrapolator = settingExtrapolatorVec[0];
             CPPUNIT_ASSERT(settingExtrapolator.type == EMPIRE_LinearExtrapolator);
             CPPUNIT_ASSERT(settingExtrapolator.name == "extrapolate displacement");
@@ -260,12 +311,25 @@ public:
             CPPUNIT_ASSERT(settingExtrapolator.connectionIOs[0].dataFieldRef.meshName == "myMesh");
             CPPUNIT_ASSERT(
                     settingExtrapolator.connectionIOs[0].dataFieldRef.dataFieldName == "displacements");
+            settingExtrapolator = settingExtrapolatorVec[1];
+            CPPUNIT_ASSERT(settingExtrapolator.type == EMPIRE_PolynomialExtrapolator);
+            CPPUNIT_ASSERT(settingExtrapolator.name == "extrapolate signal");
+            CPPUNIT_ASSERT(settingExtrapolator.degree == 2);
+            CPPUNIT_ASSERT(settingExtrapolator.historyLength == 4);
+            CPPUNIT_ASSERT(settingExtrapolator.connectionIOs.size() == 1);
+            CPPUNIT_ASSERT(
+                    settingExtrapolator.connectionIOs[0].type == EMPIRE_ConnectionIO_Signal);
+            CPPUNIT_ASSERT(settingExtrapolator.connectionIOs[0].signalRef.signalName == "signal");
         }
         { // check block connections
             CPPUNIT_ASSERT(settingConnectionVec.size() == 3);
             {
                 structConnection settingConnection = settingConnectionVec[0];
                 CPPUNIT_ASSERT(settingConnection.name == "transfer displacements");
+                CPPUNIT_ASSERT(settingConnection.exchangeInterval == 1);
+                CPPUNIT_ASSERT(!settingConnection.bundleSignals);
+                CPPUNIT_ASSERT(!settingConnection.skipUnchangedInputs);
+                CPPUNIT_ASSERT(settingConnection.changeTolerance == 0.0);
                 CPPUNIT_ASSERT(settingConnection.inputs.size() == 1);
                 CPPUNIT_ASSERT(settingConnection.inputs[0].type == EMPIRE_ConnectionIO_DataField);
                 CPPUNIT_ASSERT(
@@ -273,6 +337,10 @@ public:
                 CPPUNIT_ASSERT(settingConnection.inputs[0].dataFieldRef.meshName == "myMesh");
                 CPPUNIT_ASSERT(
                         settingConnection.inputs[0].dataFieldRef.dataFieldName == "displacements");
+                CPPUNIT_ASSERT(
+                        settingConnection.inputs[0].dataFieldRef.wireFormat == EMPIRE_DataField_float32);
+                CPPUNIT_ASSERT(settingConnection.inputs[0].dataFieldRef.chunkSize == 0);
+                CPPUNIT_ASSERT(!settingConnection.inputs[0].dataFieldRef.skipUnchanged);
                 CPPUNIT_ASSERT(settingConnection.outputs.size() == 1);
                 CPPUNIT_ASSERT(settingConnection.outputs[0].type == EMPIRE_ConnectionIO_DataField);
                 CPPUNIT_ASSERT(
@@ -280,11 +348,16 @@ public:
                 CPPUNIT_ASSERT(settingConnection.outputs[0].dataFieldRef.meshName == "myMesh");
                 CPPUNIT_ASSERT(
                         settingConnection.outputs[0].dataFieldRef.dataFieldName == "displacements");
+                CPPUNIT_ASSERT(
+                        settingConnection.outputs[0].dataFieldRef.wireFormat == EMPIRE_DataField_float64);
+                CPPUNIT_ASSERT(settingConnection.outputs[0].dataFieldRef.chunkSize == 4096);
                 CPPUNIT_ASSERT(settingConnection.filterSequence.size() == 1);
                 {
                     structFilter &settingfilter = settingConnection.filterSequence[0];
                     CPPUNIT_ASSERT(settingfilter.type == EMPIRE_MappingFilter);
                     CPPUNIT_ASSERT(settingfilter.mappingFilter.mapperName == "mortar1");
+                    CPPUNIT_ASSERT(settingfilter.mappingFilter.incremental);
+                    CPPUNIT_ASSERT(settingfilter.mappingFilter.incrementTolerance == 1e-10);
                     CPPUNIT_ASSERT(settingfilter.inputs.size() == 1);
                     CPPUNIT_ASSERT(settingfilter.inputs[0].type == EMPIRE_ConnectionIO_DataField);
                     CPPUNIT_ASSERT(
@@ -342,6 +415,7 @@ public:
                     structFilter &settingfilter = settingConnection.filterSequence[1];
                     CPPUNIT_ASSERT(settingfilter.type == EMPIRE_MappingFilter);
                     CPPUNIT_ASSERT(settingfilter.mappingFilter.mapperName == "mortar1");
+                    CPPUNIT_ASSERT(!settingfilter.mappingFilter.incremental);
                     CPPUNIT_ASSERT(settingfilter.inputs.size() == 1);
                     CPPUNIT_ASSERT(settingfilter.inputs[0].type == EMPIRE_ConnectionIO_DataField);
                     CPPUNIT_ASSERT(
@@ -361,6 +435,9 @@ public:
             {
                 structConnection &settingConnection = settingConnectionVec[2];
                 CPPUNIT_ASSERT(settingConnection.name == "transfer signal");
+                CPPUNIT_ASSERT(settingConnection.bundleSignals);
+                CPPUNIT_ASSERT(settingConnection.skipUnchangedInputs);
+                CPPUNIT_ASSERT(settingConnection.changeTolerance == 1e-6);
                 CPPUNIT_ASSERT(settingConnection.inputs.size() == 1);
                 CPPUNIT_ASSERT(settingConnection.inputs[0].type == EMPIRE_ConnectionIO_Signal);
                 CPPUNIT_ASSERT(
@@ -430,6 +507,8 @@ public:
                 CPPUNIT_ASSERT(settingICL.type == EMPIRE_IterativeCouplingLoop);
                 CPPUNIT_ASSERT(
                         settingICL.iterativeCouplingLoop.convergenceChecker.maxNumOfIterations==100);
+                CPPUNIT_ASSERT(
+                        settingICL.iterativeCouplingLoop.couplingSchema==EMPIRE_GaussSeidel);
                 CPPUNIT_ASSERT(
                         settingICL.iterativeCouplingLoop.convergenceChecker.checkResiduals.size()==1);
                 CPPUNIT_ASSERT(
@@ -469,6 +548,24 @@ public:
         /// Test CompareStringInsensitive
         CPPUNIT_ASSERT(Message::userSetOutputLevel==Message::DEBUG);
         CPPUNIT_ASSERT(MetaDatabase::getSingleton()->serverPortFile == "server.port");
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->persistentDataFieldTransfer);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->sharedMemoryDataFieldTransfer);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->profiling);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->profilingHardwareCounters);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->profilingFPOpsEvent == 0x1c7);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->buildProgressInterval == 30.0);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->buildProgressFile == "progress.txt");
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->numThreads == 4);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->mklNumThreads == 1);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->threadPinning);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->hugePages);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->reproducible);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->checkpointInterval == 10);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->checkpointDirectory == "restartFiles");
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->checkpointNumKept == 2);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->checkpointQueueDepth == 1);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->restartFromCheckpoint);
+        CPPUNIT_ASSERT(MetaDatabase::getSingleton()->bufferPoolMaxMegaBytes == 256);
     }
 
 CPPUNIT_TEST_SUITE( TestMetaDatabase );
@@ -0,0 +1,189 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include <string>
+#include <math.h>
+#include <iostream>
+#include <stdio.h>
+
+#include "IJCSA.h"
+#include "Signal.h"
+#include "EMPEROR_Enum.h"
+#include "Message.h"
+#include "ConnectionIO.h"
+#include "ConnectionIOSetup.h"
+#include "Residual.h"
+
+namespace EMPIRE {
+
+using namespace std;
+
+class TestIJCSA: public CppUnit::TestFixture {
+private:
+    Signal *fIn;
+    Signal *fOut;
+    std::vector<ConnectionIO*> autoDiffIOs;
+
+    /***********************************************************************************************
+     * \brief Create an IJCSA on the residual out - in, in is the output. The interface Jacobian
+     *        has constant entries and entries determined from fIn and fOut.
+     ***********/
+    IJCSA *createIJCSA(Signal *in, Signal *out, int maxRankOfUpdate) {
+        Residual *residual = new Residual(1);
+        residual->addComponent(-1.0, "iterationBeginning",
+                ConnectionIOSetup::constructDummyConnectionIO(in));
+        residual->addComponent(1.0, "iterationEnd",
+                ConnectionIOSetup::constructDummyConnectionIO(out));
+        residual->init();
+        IJCSA *ijcsa = new IJCSA("");
+        ijcsa->addResidual(residual, 1);
+        ijcsa->addOutput(ConnectionIOSetup::constructDummyConnectionIO(in), 1);
+        ijcsa->addInterfaceJacobianEntry(1, 1, 4.0);
+        ijcsa->addInterfaceJacobianEntry(2, 3, 1.0);
+        ijcsa->addInterfaceJacobianEntry(3, 3, 6.0);
+        for (int k = 0; k < 2; k++) {
+            autoDiffIOs.push_back(ConnectionIOSetup::constructDummyConnectionIO(fIn));
+            autoDiffIOs.push_back(ConnectionIOSetup::constructDummyConnectionIO(fOut));
+        }
+        int n = autoDiffIOs.size();
+        ijcsa->addInterfaceJacobianEntry(2, 2, autoDiffIOs[n - 4], autoDiffIOs[n - 3], 1.0);
+        ijcsa->addInterfaceJacobianEntry(1, 3, autoDiffIOs[n - 2], autoDiffIOs[n - 1], 0.5);
+        ijcsa->setMaxRankOfUpdate(maxRankOfUpdate);
+        ijcsa->init();
+        return ijcsa;
+    }
+
+public:
+    void setUp() {
+        fIn = new Signal("fIn", 1, 1, 1);
+        fOut = new Signal("fOut", 1, 1, 1);
+    }
+    void tearDown() {
+        delete fIn;
+        delete fOut;
+        for (int i = 0; i < autoDiffIOs.size(); i++)
+            delete autoDiffIOs[i];
+        autoDiffIOs.clear();
+        remove("automaticDifferentiation.log"); // written by IJCSA::init
+    }
+    /*
+     * Test case:
+     * The corrector from the low-rank corrected factorization equals the one from factorizing the
+     * interface Jacobian in every iteration
+     */
+    void testLowRankUpdate() {
+        const double EPS = 1E-10;
+        Signal *in[2];
+        Signal *out[2];
+        IJCSA *ijcsa[2];
+        for (int k = 0; k < 2; k++) {
+            in[k] = new Signal("in", 3, 1, 1);
+            out[k] = new Signal("out", 3, 1, 1);
+            ijcsa[k] = createIJCSA(in[k], out[k], k == 0 ? 0 : 4);
+        }
+        for (int timeStep = 0; timeStep < 2; timeStep++) {
+            for (int i = 0; i < 5; i++) {
+                fIn->array[0] = 1.0 + i + 0.1 * i * i;
+                fOut->array[0] = 2.0 + sin(double(i + timeStep));
+                for (int k = 0; k < 2; k++) {
+                    ijcsa[k]->updateAtIterationBeginning();
+                    for (int j = 0; j < 3; j++)
+                        out[k]->array[j] = 0.5 * in[k]->array[j] + j + 1.0 + timeStep;
+                    ijcsa[k]->updateAtIterationEnd();
+                    if (i == 0)
+                        ijcsa[k]->setNewTimeStep();
+                    ijcsa[k]->calcNewValue();
+                }
+                for (int j = 0; j < 3; j++)
+                    CPPUNIT_ASSERT(fabs(in[0]->array[j] - in[1]->array[j]) < EPS);
+            }
+        }
+        for (int k = 0; k < 2; k++) {
+            delete ijcsa[k];
+            delete in[k];
+            delete out[k];
+        }
+    }
+
+    /*
+     * Test case:
+     * A CSR block of the interface Jacobian is assembled at its offset, its lower triangular part is
+     * left out, and new values of the block are taken in place by the solve
+     */
+    void testInterfaceJacobianBlock() {
+        const double EPS = 1E-10;
+        Signal *in = new Signal("in", 3, 1, 1);
+        Signal *out = new Signal("out", 3, 1, 1);
+        Residual *residual = new Residual(1);
+        residual->addComponent(-1.0, "iterationBeginning",
+                ConnectionIOSetup::constructDummyConnectionIO(in));
+        residual->addComponent(1.0, "iterationEnd",
+                ConnectionIOSetup::constructDummyConnectionIO(out));
+        residual->init();
+        IJCSA *ijcsa = new IJCSA("");
+        ijcsa->addResidual(residual, 1);
+        ijcsa->addOutput(ConnectionIOSetup::constructDummyConnectionIO(in), 1);
+        ijcsa->addInterfaceJacobianEntry(1, 1, 2.0);
+        ijcsa->addInterfaceJacobianBlock(2, 2, NULL, "compliance", false);
+        ijcsa->init();
+
+        // the symmetric block [4 1; 1 3] at (2, 2)
+        ClientCode::InterfaceJacobian block;
+        block.numRows = 2;
+        block.numColumns = 2;
+        int rowPointers[] = { 0, 2, 4 };
+        int columnIndices[] = { 0, 1, 0, 1 };
+        block.rowPointers.assign(rowPointers, rowPointers + 3);
+        block.columnIndices.assign(columnIndices, columnIndices + 4);
+        double values[2][4] = { { 4.0, 1.0, 1.0, 3.0 }, { 5.0, -1.0, -1.0, 2.0 } };
+        for (int i = 0; i < 2; i++) {
+            block.values.assign(values[i], values[i] + 4);
+            ijcsa->setInterfaceJacobianBlock(ijcsa->interfaceJacobianBlocks[0], block);
+            CPPUNIT_ASSERT(ijcsa->interfaceJacobianBlocks[0].values.size() == 3);
+            ijcsa->updateAtIterationBeginning();
+            for (int j = 0; j < 3; j++)
+                out->array[j] = 0.5 * in->array[j] + j + 1.0;
+            ijcsa->updateAtIterationEnd();
+            ijcsa->calcNewValue();
+            // J * corrector = residual
+            double *x = ijcsa->correctorVec;
+            double *r = ijcsa->globalResidual;
+            CPPUNIT_ASSERT(fabs(2.0 * x[0] - r[0]) < EPS);
+            CPPUNIT_ASSERT(fabs(values[i][0] * x[1] + values[i][1] * x[2] - r[1]) < EPS);
+            CPPUNIT_ASSERT(fabs(values[i][2] * x[1] + values[i][3] * x[2] - r[2]) < EPS);
+        }
+        delete ijcsa;
+        delete in;
+        delete out;
+    }
+
+CPPUNIT_TEST_SUITE( TestIJCSA );
+        CPPUNIT_TEST( testLowRankUpdate);
+        CPPUNIT_TEST( testInterfaceJacobianBlock);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestIJCSA);
@@ -0,0 +1,151 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include <string>
+#include <math.h>
+#include <iostream>
+
+#include "IQNILS.h"
+#include "DataField.h"
+#include "Signal.h"
+#include "EMPEROR_Enum.h"
+#include "Message.h"
+#include "ConnectionIO.h"
+#include "ConnectionIOSetup.h"
+#include "Residual.h"
+
+namespace EMPIRE {
+
+using namespace std;
+
+class TestIQNILS: public CppUnit::TestFixture {
+private:
+    DataField *dfIn;
+    DataField *dfOut;
+    int size;
+
+    /***********************************************************************************************
+     * \brief Create an IQN-ILS on the residual dfOut - dfIn, dfIn is the output
+     ***********/
+    IQNILS *createIQNILS(int reuseTimeSteps) {
+        Residual *residual = new Residual(1);
+        residual->addComponent(-1.0, "iterationBeginning",
+                ConnectionIOSetup::constructDummyConnectionIO(dfIn));
+        residual->addComponent(1.0, "iterationEnd",
+                ConnectionIOSetup::constructDummyConnectionIO(dfOut));
+        residual->init();
+        IQNILS *iqnils = new IQNILS("", 0.1, reuseTimeSteps, 1e-8);
+        iqnils->addResidual(residual, 1);
+        iqnils->addOutput(ConnectionIOSetup::constructDummyConnectionIO(dfIn), 1);
+        iqnils->init();
+        return iqnils;
+    }
+
+    /***********************************************************************************************
+     * \brief The solver dfOut = A * dfIn + b, the plain fixed-point iteration diverges since A has
+     *        eigenvalues below -1
+     ***********/
+    void solve(double bScale) {
+        for (int i = 0; i < size; i++) {
+            double sum = bScale * (1.0 + i);
+            for (int j = 0; j < size; j++)
+                sum += (i == j ? -1.5 + 0.3 * i : 0.1 / (1.0 + i + j)) * dfIn->data[j];
+            dfOut->data[i] = sum;
+        }
+    }
+
+    /***********************************************************************************************
+     * \brief Iterate one time step until the residual vanishes
+     * \return the number of iterations
+     ***********/
+    int iterateTimeStep(IQNILS *iqnils, double bScale) {
+        const double EPS = 1E-10;
+        for (int j = 0; j < size; j++)
+            dfIn->data[j] = 0.0;
+        for (int i = 0; i < 100; i++) {
+            iqnils->updateAtIterationBeginning();
+            solve(bScale);
+            iqnils->updateAtIterationEnd();
+            iqnils->calcCurrentResidual();
+            double norm = 0.0;
+            for (int j = 0; j < size; j++)
+                norm += (dfOut->data[j] - dfIn->data[j]) * (dfOut->data[j] - dfIn->data[j]);
+            if (sqrt(norm) < EPS)
+                return i + 1;
+            if (i == 0)
+                iqnils->setNewTimeStep();
+            iqnils->calcNewValue();
+        }
+        return 100;
+    }
+
+public:
+    void setUp() {
+        dfIn = new DataField("input", EMPIRE_DataField_atNode, 2, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        dfOut = new DataField("output", EMPIRE_DataField_atNode, 2, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        size = dfIn->dimension * dfIn->numLocations;
+    }
+    void tearDown() {
+        delete dfIn;
+        delete dfOut;
+    }
+    /*
+     * Test case:
+     * The secant model of a linear problem is exact after size iterations, so IQN-ILS converges
+     * although the fixed-point iteration diverges
+     */
+    void testLinearProblem() {
+        IQNILS *iqnils = createIQNILS(0);
+        for (int timeStep = 0; timeStep < 2; timeStep++) {
+            int numIterations = iterateTimeStep(iqnils, 1.0 + timeStep);
+            CPPUNIT_ASSERT(numIterations <= size + 2);
+        }
+        delete iqnils;
+    }
+    /*
+     * Test case:
+     * Reusing the model of the previous time step, the linear problem converges after the first
+     * quasi-Newton update
+     */
+    void testReuse() {
+        IQNILS *iqnils = createIQNILS(1);
+        int numIterations = iterateTimeStep(iqnils, 1.0);
+        CPPUNIT_ASSERT(numIterations <= size + 2);
+        CPPUNIT_ASSERT(iqnils->getNumColumns() == size);
+        numIterations = iterateTimeStep(iqnils, 2.0);
+        CPPUNIT_ASSERT(numIterations == 2);
+        delete iqnils;
+    }
+
+CPPUNIT_TEST_SUITE( TestIQNILS );
+        CPPUNIT_TEST( testLinearProblem);
+        CPPUNIT_TEST( testReuse);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestIQNILS);
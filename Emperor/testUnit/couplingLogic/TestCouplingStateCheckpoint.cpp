@@ -0,0 +1,160 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "CouplingStateCheckpoint.h"
+#include "CheckpointArchive.h"
+#include "LinearExtrapolator.h"
+#include "DataField.h"
+#include "ConnectionIOSetup.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <fstream>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the class CouplingStateCheckpoint and the class CheckpointArchive
+ ***********/
+class TestCouplingStateCheckpoint: public CppUnit::TestFixture {
+private:
+    /// the directory of the checkpoint files
+    string directory;
+public:
+    void setUp() {
+        directory = "checkpointOfTestCouplingStateCheckpoint";
+    }
+    void tearDown() {
+        CouplingStateCheckpoint checkpoint(directory, 0, 1, 0);
+        for (int timeStep = 1; timeStep <= 4; timeStep++)
+            remove(checkpoint.getFileName(timeStep).c_str());
+        remove(checkpoint.getLatestFileName().c_str());
+        rmdir(directory.c_str());
+    }
+    /***********************************************************************************************
+     * \brief Test case: the values and arrays written to an archive are read back
+     ***********/
+    void testArchive() {
+        double array[3] = { 1.5, -2.0, 3.25 };
+        vector<double> values(2, 7.0);
+        deque<vector<double> > vectors(2);
+        vectors[1].assign(array, array + 3);
+
+        CheckpointArchive archiveOut("archive");
+        archiveOut.write(42);
+        archiveOut.write(0.125);
+        archiveOut.write(true);
+        archiveOut.write(array, 3);
+        archiveOut.write(values);
+        archiveOut.write(vectors);
+
+        CheckpointArchive archiveIn("archive", archiveOut.getBuffer());
+        int intValue;
+        double doubleValue;
+        bool boolValue;
+        double arrayIn[3];
+        vector<double> valuesIn;
+        deque<vector<double> > vectorsIn;
+        archiveIn.read(intValue);
+        archiveIn.read(doubleValue);
+        archiveIn.read(boolValue);
+        archiveIn.read(arrayIn, 3);
+        archiveIn.read(valuesIn);
+        archiveIn.read(vectorsIn);
+        CPPUNIT_ASSERT(archiveIn.isAtEnd());
+        CPPUNIT_ASSERT(intValue == 42);
+        CPPUNIT_ASSERT(doubleValue == 0.125);
+        CPPUNIT_ASSERT(boolValue);
+        for (int i = 0; i < 3; i++)
+            CPPUNIT_ASSERT(arrayIn[i] == array[i]);
+        CPPUNIT_ASSERT(valuesIn == values);
+        CPPUNIT_ASSERT(vectorsIn.size() == 2);
+        CPPUNIT_ASSERT(vectorsIn[0].empty());
+        CPPUNIT_ASSERT(vectorsIn[1] == vectors[1]);
+    }
+    /***********************************************************************************************
+     * \brief Test case: an extrapolator restarted from a checkpoint continues like the original one,
+     *        and only the last numKept checkpoint files are kept
+     ***********/
+    void testRestart() {
+        DataField *df = new DataField("dummy", EMPIRE_DataField_atNode, 4,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        LinearExtrapolator *extrapolator = new LinearExtrapolator("linear");
+        extrapolator->addConnectionIO(ConnectionIOSetup::constructDummyConnectionIO(df));
+        extrapolator->init();
+        int size = df->dimension * df->numLocations;
+        {
+            CouplingStateCheckpoint checkpoint(directory, 1, 2, 1);
+            checkpoint.addObject("extrapolator linear", extrapolator);
+            for (int timeStep = 1; timeStep <= 3; timeStep++) {
+                extrapolator->extrapolate();
+                // the client sends timeStep squared
+                for (int j = 0; j < size; j++)
+                    df->data[j] = timeStep * timeStep + j;
+                checkpoint.writeTimeStep(timeStep);
+            }
+            checkpoint.flush();
+            CPPUNIT_ASSERT(!ifstream(checkpoint.getFileName(1).c_str()));
+            CPPUNIT_ASSERT(ifstream(checkpoint.getFileName(2).c_str()));
+            CPPUNIT_ASSERT(ifstream(checkpoint.getFileName(3).c_str()));
+        }
+
+        DataField *dfRestarted = new DataField("dummy", EMPIRE_DataField_atNode, 4,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        LinearExtrapolator *extrapolatorRestarted = new LinearExtrapolator("linear");
+        extrapolatorRestarted->addConnectionIO(
+                ConnectionIOSetup::constructDummyConnectionIO(dfRestarted));
+        extrapolatorRestarted->init();
+        {
+            CouplingStateCheckpoint checkpoint(directory, 1, 2, 0);
+            checkpoint.addObject("extrapolator linear", extrapolatorRestarted);
+            CPPUNIT_ASSERT(checkpoint.restart() == 3);
+        }
+        for (int j = 0; j < size; j++)
+            CPPUNIT_ASSERT(dfRestarted->data[j] == df->data[j]);
+
+        // time step 4 extrapolates 2 x 9 - 4 = 14 in both
+        extrapolator->extrapolate();
+        extrapolatorRestarted->extrapolate();
+        for (int j = 0; j < size; j++) {
+            CPPUNIT_ASSERT(df->data[j] == 14.0 + j);
+            CPPUNIT_ASSERT(dfRestarted->data[j] == df->data[j]);
+        }
+
+        delete extrapolator;
+        delete extrapolatorRestarted;
+        delete df;
+        delete dfRestarted;
+    }
+
+CPPUNIT_TEST_SUITE( TestCouplingStateCheckpoint );
+        CPPUNIT_TEST( testArchive);
+        CPPUNIT_TEST( testRestart);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestCouplingStateCheckpoint);
@@ -24,6 +24,8 @@
 
 #include "AbstractExtrapolator.h"
 #include "LinearExtrapolator.h"
+#include "PolynomialExtrapolator.h"
+#include "AdamsBashforthExtrapolator.h"
 #include "DataField.h"
 #include "Signal.h"
 #include "ConnectionIOSetup.h"
@@ -135,8 +137,87 @@ public:
         }
     }
 
+    /***********************************************************************************************
+     * \brief Test case: Test the polynomial extarpolator. The data f(t)=t*t is set at the first
+     *        three time steps, afterwards it is predicted by the quadratic extrapolation and kept.
+     *        The least squares fit of degree 1 over 4 time steps is compared with the formula.
+     ***********/
+    void testPolynomialExtrapolator() {
+        { // quadratic
+            DataField *df = new DataField("dummy", EMPIRE_DataField_atNode, 10,
+                    EMPIRE_DataField_vector, EMPIRE_DataField_field);
+            PolynomialExtrapolator *extrapolator = new PolynomialExtrapolator("", 2, 3);
+            extrapolator->unitTest = true;
+            extrapolator->addConnectionIO(ConnectionIOSetup::constructDummyConnectionIO(df));
+            extrapolator->init();
+
+            int size = df->dimension * df->numLocations;
+            for (int i = 1; i <= 8; i++) {
+                extrapolator->extrapolate();
+                if (i <= 3) {
+                    for (int j = 0; j < size; j++)
+                        df->data[j] = double(i * i + j);
+                }
+                for (int j = 0; j < size; j++)
+                    CPPUNIT_ASSERT(fabs(df->data[j] - double(i * i + j)) < 1e-10);
+            }
+            delete df;
+            delete extrapolator;
+        }
+        { // linear least squares over 4 time steps, new = d0 + 1/2 x d00 - 1/2 x d0000
+            Signal *signal = new Signal("dummy", 1, 1, 1);
+            PolynomialExtrapolator *extrapolator = new PolynomialExtrapolator("", 1, 4);
+            extrapolator->unitTest = true;
+            extrapolator->addConnectionIO(ConnectionIOSetup::constructDummyConnectionIO(signal));
+            extrapolator->init();
+
+            double values[6] = { 1.0, 3.0, 2.0, 5.0, 4.0, 7.0 };
+            for (int i = 0; i < 6; i++) {
+                extrapolator->extrapolate();
+                signal->array[0] = values[i];
+            }
+            extrapolator->extrapolate();
+            double expected = 7.0 + 0.5 * 4.0 - 0.5 * 2.0;
+            CPPUNIT_ASSERT(fabs(signal->array[0] - expected) < 1e-10);
+            delete signal;
+            delete extrapolator;
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test case: Test the Adams-Bashforth extarpolator of order 2, which gives
+     *        "new = 5/2 x data0 - 2 x data00 + 1/2 x data000". With only two previous time steps,
+     *        it falls back to the linear extrapolation.
+     ***********/
+    void testAdamsBashforthExtrapolator() {
+        Signal *signal = new Signal("dummy", 2, 1, 1);
+        AdamsBashforthExtrapolator *extrapolator = new AdamsBashforthExtrapolator("", 2);
+        extrapolator->unitTest = true;
+        extrapolator->addConnectionIO(ConnectionIOSetup::constructDummyConnectionIO(signal));
+        extrapolator->init();
+
+        extrapolator->extrapolate();
+        signal->array[0] = 1.0;
+        signal->array[1] = -1.0;
+        extrapolator->extrapolate();
+        CPPUNIT_ASSERT(fabs(signal->array[0] - 1.0) < 1e-10);
+        signal->array[0] = 2.0;
+        signal->array[1] = -2.0;
+        extrapolator->extrapolate();
+        CPPUNIT_ASSERT(fabs(signal->array[0] - 3.0) < 1e-10);
+        CPPUNIT_ASSERT(fabs(signal->array[1] + 3.0) < 1e-10);
+        signal->array[0] = 6.0;
+        signal->array[1] = -6.0;
+        extrapolator->extrapolate();
+        CPPUNIT_ASSERT(fabs(signal->array[0] - (2.5 * 6.0 - 2.0 * 2.0 + 0.5 * 1.0)) < 1e-10);
+        CPPUNIT_ASSERT(fabs(signal->array[1] + (2.5 * 6.0 - 2.0 * 2.0 + 0.5 * 1.0)) < 1e-10);
+        delete signal;
+        delete extrapolator;
+    }
+
 CPPUNIT_TEST_SUITE( TestExtrapolator );
         CPPUNIT_TEST( testLinearExtrapolator);
+        CPPUNIT_TEST( testPolynomialExtrapolator);
+        CPPUNIT_TEST( testAdamsBashforthExtrapolator);
     CPPUNIT_TEST_SUITE_END();
 };
 
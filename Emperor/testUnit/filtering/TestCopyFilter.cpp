@@ -155,9 +155,39 @@ public:
             delete out;
         }
     }
+    /********//**
+     ***********************************************************************************************
+     * \brief Test case: Test the aliasing filter, the output shares the storage of the input
+     ***********/
+    void testAliasing() {
+        CopyFilter *filter = new CopyFilter(0, true);
+        filter->unitTest = true;
+        DataField *in = new DataField("", EMPIRE_DataField_atNode, 2, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        DataField *out = new DataField("", EMPIRE_DataField_atNode, 2, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        ConnectionIOSetup::setupIOForFilter(filter, NULL, in, NULL, out);
+        CPPUNIT_ASSERT(filter->isAliasing());
+        filter->aliasOutput();
+        CPPUNIT_ASSERT(out->isAlias());
+        CPPUNIT_ASSERT(!in->isAlias());
+        CPPUNIT_ASSERT(out->data == in->data);
+
+        for (int i = 0; i < in->numLocations * EMPIRE_DataField_vector; i++)
+            in->data[i] = 0.1 * i;
+        filter->filtering();
+        filter->filterEntries(0, filter->getNumEntries());
+        for (int i = 0; i < out->numLocations * EMPIRE_DataField_vector; i++)
+            CPPUNIT_ASSERT(out->data[i] == 0.1 * i);
+        // the alias does not release the storage of the input
+        delete filter;
+        delete out;
+        delete in;
+    }
 CPPUNIT_TEST_SUITE( TestCopyFilter );
         CPPUNIT_TEST( testFilter1);
         CPPUNIT_TEST( testFilter2);
+        CPPUNIT_TEST( testAliasing);
     CPPUNIT_TEST_SUITE_END();
 };
 
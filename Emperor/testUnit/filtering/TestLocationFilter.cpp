@@ -21,6 +21,7 @@
 #include <string>
 #include <iostream>
 #include <stdlib.h>
+#include <math.h>
 
 #include "cppunit/TestFixture.h"
 #include "cppunit/TestAssert.h"
@@ -157,9 +158,39 @@ public:
         delete filterScalar;
         delete filterVector;
     }
+    /********//**
+     ***********************************************************************************************
+     * \brief Test case: the value at a node is the average of the elements containing it
+     ***********/
+    void testFilteringAverage() {
+        atElemCentroidScalar->data[0] = 1.0;
+        atElemCentroidScalar->data[1] = 2.0;
+        atElemCentroidScalar->data[2] = 4.0;
+        for (int i = 0; i < mesh->numElems; i++)
+            atElemCentroidVector->data[i * EMPIRE_DataField_vector + 1] =
+                    atElemCentroidScalar->data[i];
+        LocationFilter *filterScalar = new LocationFilter();
+        ConnectionIOSetup::setupIOForFilter(filterScalar, mesh, atElemCentroidScalar, mesh,
+                atNodeScalar);
+        LocationFilter *filterVector = new LocationFilter();
+        ConnectionIOSetup::setupIOForFilter(filterVector, mesh, atElemCentroidVector, mesh,
+                atNodeVector);
+        filterScalar->filtering();
+        filterVector->filtering();
+        const double ref[] = { 1.0, 1.5, 3.0, 4.0, 7.0 / 3.0, 1.0 };
+        for (int i = 0; i < mesh->numNodes; i++) {
+            CPPUNIT_ASSERT(fabs(atNodeScalar->data[i] - ref[i]) < 1E-12);
+            CPPUNIT_ASSERT(atNodeVector->data[i * EMPIRE_DataField_vector + 0] == 1.0);
+            CPPUNIT_ASSERT(fabs(atNodeVector->data[i * EMPIRE_DataField_vector + 1] - ref[i]) < 1E-12);
+            CPPUNIT_ASSERT(atNodeVector->data[i * EMPIRE_DataField_vector + 2] == 2.0);
+        }
+        delete filterScalar;
+        delete filterVector;
+    }
 
 CPPUNIT_TEST_SUITE( TestLocationFilter );
         CPPUNIT_TEST( testFiltering);
+        CPPUNIT_TEST( testFilteringAverage);
     CPPUNIT_TEST_SUITE_END();
 };
 
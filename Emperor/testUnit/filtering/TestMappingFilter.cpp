@@ -24,6 +24,8 @@
 #include "cppunit/extensions/HelperMacros.h"
 
 #include "MappingFilter.h"
+#include "ScalingFilter.h"
+#include "Connection.h"
 #include "DataField.h"
 #include "FEMesh.h"
 #include "ConnectionIO.h"
@@ -202,8 +204,116 @@ public:
             delete mapper;
         }
     }
+    /***********************************************************************************************
+     * \brief Test case: Test the incremental mapping, which maps only the nodes of B depending on
+     *        changed nodes of A and skips the mapping of small changes
+     ***********/
+    void testIncrementalMapping() {
+        MapperAdapter *mapper = new MapperAdapter("testNearestElement", meshA, meshB);
+        mapper->initNearestElementMapper();
+        MappingFilter *filter = new MappingFilter(mapper);
+        filter->setIncrementalMapping(1E-3);
+        ConnectionIOSetup::setupIOForFilter(filter, meshA, a1, meshB, b1);
+        DataField *b1Full = new DataField("b1Full", EMPIRE_DataField_atNode, meshB->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+
+        for (int i = 0; i < meshA->numNodes; i++)
+            a1->data[i] = meshA->nodes[i * 3 + 0];
+        filter->filtering();
+        for (int i = 0; i < meshB->numNodes; i++)
+            CPPUNIT_ASSERT(fabs(b1->data[i] - meshB->nodes[i * 3 + 0]) < EPS);
+        // a changed node is mapped exactly
+        a1->data[1] = 4.0;
+        filter->filtering();
+        mapper->consistentMapping(a1, b1Full);
+        for (int i = 0; i < meshB->numNodes; i++)
+            CPPUNIT_ASSERT(fabs(b1->data[i] - b1Full->data[i]) < EPS);
+        // a small change keeps the output
+        for (int i = 0; i < meshB->numNodes; i++)
+            b1Full->data[i] = b1->data[i];
+        a1->data[2] += 1E-4;
+        for (int i = 0; i < meshB->numNodes; i++)
+            b1->data[i] = 0.0;
+        filter->filtering();
+        for (int i = 0; i < meshB->numNodes; i++)
+            CPPUNIT_ASSERT(b1->data[i] == b1Full->data[i]);
+        delete b1Full;
+        delete filter;
+        delete mapper;
+    }
+    /***********************************************************************************************
+     * \brief Test case: Test that the mappings A->B and B->A in series are composed into one
+     *        operator by a connection, which does not write the data field in between
+     ***********/
+    void testChainedMappings() {
+        MapperAdapter *mapperAB = new MapperAdapter("testAB", meshA, meshB);
+        mapperAB->initNearestElementMapper();
+        MapperAdapter *mapperBA = new MapperAdapter("testBA", meshB, meshA);
+        mapperBA->initNearestElementMapper();
+        DataField *a3 = new DataField("a3", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        // a linear field is mapped exactly in both directions
+        for (int i = 0; i < meshA->numNodes; i++)
+            a1->data[i] = meshA->nodes[i * 3 + 0] + 2.0 * meshA->nodes[i * 3 + 1];
+        for (int i = 0; i < meshB->numNodes; i++)
+            b1->data[i] = -1.0;
+
+        for (int k = 0; k < 2; k++) {
+            bool isChained = (k == 0);
+            // b1 = H_AB * a1, b1 = 2 * b1, a3 = H_BA * b1
+            Connection *connection = new Connection("testChain");
+            MappingFilter *filterAB = new MappingFilter(mapperAB);
+            ConnectionIOSetup::setupIOForFilter(filterAB, meshA, a1, meshB, b1);
+            AbstractFilter *scaling = new ScalingFilter(2.0);
+            ConnectionIOSetup::setupIOForFilter(scaling, meshB, b1, meshB, b1);
+            MappingFilter *filterBA = new MappingFilter(mapperBA);
+            ConnectionIOSetup::setupIOForFilter(filterBA, meshB, b1, meshA, a3);
+            connection->addFilter(filterAB);
+            connection->addFilter(scaling);
+            connection->addFilter(filterBA);
+            connection->setMappingChaining(isChained);
+            CPPUNIT_ASSERT(filterAB->isExplicitOperatorSupported());
+            CPPUNIT_ASSERT(filterBA->isExplicitOperatorSupported());
+
+            connection->filter();
+            for (int i = 0; i < meshA->numNodes; i++)
+                CPPUNIT_ASSERT(fabs(a3->data[i] - 2.0 * a1->data[i]) < EPS);
+            for (int i = 0; i < meshB->numNodes; i++) {
+                double b = meshB->nodes[i * 3 + 0] + 2.0 * meshB->nodes[i * 3 + 1];
+                if (isChained)
+                    CPPUNIT_ASSERT(b1->data[i] == -1.0);
+                else
+                    CPPUNIT_ASSERT(fabs(b1->data[i] - 2.0 * b) < EPS);
+            }
+            delete connection;
+        }
+        // a data field read outside of the connection is written
+        Connection *connection = new Connection("testChain");
+        MappingFilter *filterAB = new MappingFilter(mapperAB);
+        ConnectionIOSetup::setupIOForFilter(filterAB, meshA, a1, meshB, b1);
+        MappingFilter *filterBA = new MappingFilter(mapperBA);
+        ConnectionIOSetup::setupIOForFilter(filterBA, meshB, b1, meshA, a3);
+        connection->addFilter(filterAB);
+        connection->addFilter(filterBA);
+        connection->setMappingChaining(true);
+        connection->keepDataField(b1);
+        for (int i = 0; i < meshB->numNodes; i++)
+            b1->data[i] = -1.0;
+        connection->filter();
+        for (int i = 0; i < meshB->numNodes; i++)
+            CPPUNIT_ASSERT(
+                    fabs(b1->data[i] - meshB->nodes[i * 3 + 0] - 2.0 * meshB->nodes[i * 3 + 1]) < EPS);
+        for (int i = 0; i < meshA->numNodes; i++)
+            CPPUNIT_ASSERT(fabs(a3->data[i] - a1->data[i]) < EPS);
+        delete connection;
+        delete a3;
+        delete mapperAB;
+        delete mapperBA;
+    }
 CPPUNIT_TEST_SUITE( TestMappingFilter );
         CPPUNIT_TEST( testMappers);
+        CPPUNIT_TEST( testIncrementalMapping);
+        CPPUNIT_TEST( testChainedMappings);
     CPPUNIT_TEST_SUITE_END();
 };
 
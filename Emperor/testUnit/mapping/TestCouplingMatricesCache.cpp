@@ -0,0 +1,248 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "CouplingMatricesCache.h"
+#include "FEMesh.h"
+#include "MatrixVectorMath.h"
+#include "WeakIGADirichletCurveCondition.h"
+
+#include <string>
+#include <fstream>
+#include <stdio.h>
+
+using namespace std;
+
+namespace EMPIRE {
+using namespace MathLibrary;
+/********//**
+ * \brief Test writing and reading the coupling matrices cache
+ ***********/
+class TestCouplingMatricesCache: public CppUnit::TestFixture {
+private:
+    FEMesh *mesh;
+    string directory;
+public:
+    void setUp() {
+        mesh = new FEMesh("quad", 4, 1);
+        double nodes[] = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+        for (int i = 0; i < 12; i++)
+            mesh->nodes[i] = nodes[i];
+        for (int i = 0; i < 4; i++)
+            mesh->nodeIDs[i] = i + 1;
+        mesh->numNodesPerElem[0] = 4;
+        mesh->initElems();
+        for (int i = 0; i < 4; i++)
+            mesh->elems[i] = i + 1;
+        directory = ".";
+    }
+    void tearDown() {
+        delete mesh;
+    }
+    /***********************************************************************************************
+     * \brief Create a cache of the mesh and a parameter
+     ***********/
+    CouplingMatricesCache *createCache(bool parameter,
+            string mapperName = "CouplingMatricesCache_unittest") {
+        CouplingMatricesCache *cache = new CouplingMatricesCache(directory, mapperName);
+        cache->addToKey(string("mortarMapper"));
+        cache->addMeshToKey(mesh);
+        cache->addToKey(parameter);
+        return cache;
+    }
+    /***********************************************************************************************
+     * \brief Test case: write matrices and a vector, read them from a new cache of the same key
+     ***********/
+    void testSaveAndLoad() {
+        SparseMatrix<double> symmetric(3, true);
+        symmetric(0, 0) = 2.0;
+        symmetric(0, 2) = -1.0;
+        symmetric(1, 1) = 3.0;
+        symmetric(2, 2) = 4.0;
+        SparseMatrix<double> rectangular((size_t) 2, (size_t) 3);
+        rectangular(0, 1) = 1.5;
+        rectangular(1, 0) = -0.5;
+        rectangular(1, 2) = 7.0;
+        double vec[] = { 1.0, 2.0, 3.0 };
+
+        CouplingMatricesCache *cache = createCache(true);
+        string fileName = cache->getFileName();
+        cache->setMatrix("symmetric", &symmetric);
+        cache->setMatrix("rectangular", &rectangular);
+        cache->setVector("vec", vec, 3);
+        cache->save();
+        delete cache;
+
+        cache = createCache(true);
+        CPPUNIT_ASSERT(cache->getFileName() == fileName);
+        CPPUNIT_ASSERT(cache->load());
+        SparseMatrix<double> symmetricRead(3, true);
+        SparseMatrix<double> rectangularRead((size_t) 2, (size_t) 3);
+        SparseMatrix<double> wrongSize((size_t) 3, (size_t) 3);
+        SparseMatrix<double> wrongSymmetry(3, false);
+        CPPUNIT_ASSERT(cache->hasMatrix("symmetric", &symmetricRead));
+        CPPUNIT_ASSERT(cache->hasMatrix("rectangular", &rectangularRead));
+        CPPUNIT_ASSERT(!cache->hasMatrix("rectangular", &wrongSize));
+        CPPUNIT_ASSERT(!cache->hasMatrix("symmetric", &wrongSymmetry));
+        CPPUNIT_ASSERT(!cache->hasMatrix("missing", &symmetricRead));
+        cache->getMatrix("symmetric", &symmetricRead);
+        cache->getMatrix("rectangular", &rectangularRead);
+        double vecRead[3];
+        CPPUNIT_ASSERT(!cache->getVector("vec", 2, vecRead));
+        CPPUNIT_ASSERT(cache->getVector("vec", 3, vecRead));
+        delete cache;
+
+        double x[] = { 1.0, -2.0, 0.5 };
+        double y[3], yRead[3];
+        symmetric.mulitplyVec(false, x, y, 3);
+        symmetricRead.mulitplyVec(false, x, yRead, 3);
+        for (int i = 0; i < 3; i++) {
+            CPPUNIT_ASSERT(y[i] == yRead[i]);
+            CPPUNIT_ASSERT(vec[i] == vecRead[i]);
+        }
+        rectangular.mulitplyVec(false, x, y, 2);
+        rectangularRead.mulitplyVec(false, x, yRead, 2);
+        for (int i = 0; i < 2; i++)
+            CPPUNIT_ASSERT(y[i] == yRead[i]);
+        remove(fileName.c_str());
+    }
+    /***********************************************************************************************
+     * \brief Test case: the key depends on the mesh and the parameters, invalid files are rejected
+     ***********/
+    void testKey() {
+        CouplingMatricesCache *cache = createCache(true);
+        string fileName = cache->getFileName();
+        delete cache;
+        cache = createCache(false);
+        CPPUNIT_ASSERT(cache->getFileName() != fileName);
+        delete cache;
+        mesh->nodes[0] = 1e-3;
+        mesh->updateContentHash();
+        cache = createCache(true);
+        CPPUNIT_ASSERT(cache->getFileName() != fileName);
+        CPPUNIT_ASSERT(!cache->load());
+        {
+            ofstream file(cache->getFileName().c_str());
+            file << "not a cache file";
+        }
+        CPPUNIT_ASSERT(!cache->load());
+        remove(cache->getFileName().c_str());
+        delete cache;
+    }
+    /***********************************************************************************************
+     * \brief Test case: a mapper reads the file of another mapper with the same key
+     ***********/
+    void testOtherMapper() {
+        double vec[] = { 1.0, 2.0, 3.0 };
+        CouplingMatricesCache *cache = createCache(true, "CouplingMatricesCache_unittest_design1");
+        string fileName = cache->getFileName();
+        cache->setVector("vec", vec, 3);
+        cache->save();
+        delete cache;
+
+        cache = createCache(true, "CouplingMatricesCache_unittest_design2");
+        CPPUNIT_ASSERT(cache->getFileName() != fileName);
+        CPPUNIT_ASSERT(cache->load());
+        double vecRead[3];
+        CPPUNIT_ASSERT(cache->getVector("vec", 3, vecRead));
+        for (int i = 0; i < 3; i++)
+            CPPUNIT_ASSERT(vec[i] == vecRead[i]);
+        delete cache;
+        cache = createCache(false, "CouplingMatricesCache_unittest_design2");
+        CPPUNIT_ASSERT(!cache->load());
+        delete cache;
+        remove(fileName.c_str());
+    }
+    /***********************************************************************************************
+     * \brief Test case: a file of a given name, as written by saveMapper, is read with its key only
+     ***********/
+    void testSaveFileAndLoadFile() {
+        double vec[] = { 1.0, 2.0, 3.0 };
+        string fileName = "CouplingMatricesCache_unittest.mapper";
+        CouplingMatricesCache *cache = createCache(true);
+        cache->setVector("vec", vec, 3);
+        CPPUNIT_ASSERT(cache->saveFile(fileName));
+        delete cache;
+
+        cache = createCache(true, "CouplingMatricesCache_unittest_other");
+        CPPUNIT_ASSERT(cache->loadFile(fileName));
+        double vecRead[3];
+        CPPUNIT_ASSERT(cache->getVector("vec", 3, vecRead));
+        for (int i = 0; i < 3; i++)
+            CPPUNIT_ASSERT(vec[i] == vecRead[i]);
+        delete cache;
+        cache = createCache(false);
+        CPPUNIT_ASSERT(!cache->loadFile(fileName));
+        CPPUNIT_ASSERT(!cache->getVector("vec", 3, vecRead));
+        CPPUNIT_ASSERT(!cache->loadFile("CouplingMatricesCache_unittest.missing"));
+        delete cache;
+        remove(fileName.c_str());
+    }
+
+    /***********************************************************************************************
+     * \brief Test case: the GP data of a weak condition are read by a condition of the next run
+     ***********/
+    void testConditionGPData() {
+        double GPs[] = { 0.1, 0.0, 0.5, 0.0, 0.9, 0.0 };
+        double GPWeights[] = { 0.3, 0.4, 0.3 };
+        double GPTangents[] = { 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0 };
+        double GPJacobianProducts[] = { 0.5, 0.5, 0.5 };
+        WeakIGADirichletCurveCondition condition(0, 0, 0, 1);
+        condition.addWeakDirichletCurveConditionGPData(3, GPs, GPWeights, GPTangents, GPJacobianProducts);
+        CouplingMatricesCache *cache = createCache(true, "conditionGPData");
+        string fileName = cache->getFileName();
+        condition.writeGPDataToCache(cache, "condition0_");
+        cache->save();
+        delete cache;
+
+        cache = createCache(true, "conditionGPData");
+        CPPUNIT_ASSERT(cache->load());
+        WeakIGADirichletCurveCondition conditionRead(0, 0, 0, 1);
+        WeakIGADirichletCurveCondition conditionMissing(1, 0, 0, 2);
+        CPPUNIT_ASSERT(!conditionMissing.readGPDataFromCache(cache, "condition1_"));
+        CPPUNIT_ASSERT(conditionRead.readGPDataFromCache(cache, "condition0_"));
+        delete cache;
+        CPPUNIT_ASSERT(conditionRead.getCurveNumGP() == 3);
+        for (int i = 0; i < 3; i++) {
+            CPPUNIT_ASSERT(conditionRead.getCurveGPs()[2 * i] == GPs[2 * i]);
+            CPPUNIT_ASSERT(conditionRead.getCurveGPs()[2 * i + 1] == GPs[2 * i + 1]);
+            CPPUNIT_ASSERT(conditionRead.getCurveGPWeights()[i] == GPWeights[i]);
+            for (int j = 0; j < 3; j++)
+                CPPUNIT_ASSERT(conditionRead.getCurveGPTangents()[3 * i + j] == GPTangents[3 * i + j]);
+            CPPUNIT_ASSERT(conditionRead.getCurveGPJacobianProducts()[i] == GPJacobianProducts[i]);
+        }
+        remove(fileName.c_str());
+    }
+
+CPPUNIT_TEST_SUITE( TestCouplingMatricesCache );
+        CPPUNIT_TEST( testSaveAndLoad);
+        CPPUNIT_TEST( testKey);
+        CPPUNIT_TEST( testOtherMapper);
+        CPPUNIT_TEST( testSaveFileAndLoadFile);
+        CPPUNIT_TEST( testConditionGPData);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestCouplingMatricesCache);
@@ -309,6 +309,75 @@ public:
         delete mapper;
     }
 
+    /***********************************************************************************************
+     * \brief Test rebuilding the sections after the nodes moved against a new mapper
+     ***********/
+    void testUpdateGeometry() {
+        const double TOL = 1E-10;
+        int curveNumNodes = 3;
+        int curveNumElements = 2;
+        double curveNodeCoors[] = { 1.0, 0.0, 0.0, 0.0, 0.0, 0.0, 3.0, 1.0, 0.0 };
+        int curveNodeIDs[] = { 100, 10, 1000 };
+        int curveElems[] = { 100, 10, 1000, 100 };
+        int surfaceNumNodes = 10;
+        double surfaceNodeCoors[] = { 3.0, 0.1, 0.0, 3.0, -0.5, 0.0, 5.0 / 3.0, -0.5, 0.0, 2.0
+                / 3.0, -0.5, 0.0, 0.0, -0.5, 0.0, 0.0, 0.1, 0.0, 0.0, 0.5, 0.0, 2.0 / 3.0, 0.5, 0.0,
+                5.0 / 3.0, 1.5, 0.0, 3.0, 1.5, 0.0, };
+        int surfaceNumSections = 4;
+
+        KinematicMotion KM_O_Q;
+        double axis[] = { 1.0, 1.0, 1.0 };
+        KM_O_Q.addRotation(axis, false, M_PI / 2.0);
+        for (int i = 0; i < curveNumNodes; i++)
+            KM_O_Q.move(&curveNodeCoors[i * 3]);
+        for (int i = 0; i < surfaceNumNodes; i++)
+            KM_O_Q.move(&surfaceNodeCoors[i * 3]);
+
+        // the mapper is constructed on a stretched and sheared configuration
+        double movedCurveNodeCoors[3 * 3];
+        double movedSurfaceNodeCoors[10 * 3];
+        for (int i = 0; i < curveNumNodes * 3; i++)
+            movedCurveNodeCoors[i] = 2.0 * curveNodeCoors[i] + 0.1 * (i % 3);
+        for (int i = 0; i < surfaceNumNodes * 3; i++)
+            movedSurfaceNodeCoors[i] = 2.0 * surfaceNodeCoors[i] + 0.1 * (i % 3);
+        CurveSurfaceMapper *mapper = new CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_linear,
+                curveNumNodes, curveNumElements, movedCurveNodeCoors, curveNodeIDs, curveElems,
+                surfaceNumNodes, movedSurfaceNodeCoors, surfaceNumSections, 3, 2, 3,
+                KM_O_Q.getRotationMatrix(), KM_O_Q.getTranslationVector());
+
+        // move the nodes back and rebuild
+        for (int i = 0; i < curveNumNodes * 3; i++)
+            movedCurveNodeCoors[i] = curveNodeCoors[i];
+        for (int i = 0; i < surfaceNumNodes * 3; i++)
+            movedSurfaceNodeCoors[i] = surfaceNodeCoors[i];
+        mapper->updateGeometry();
+
+        CurveSurfaceMapper *mapperRef = new CurveSurfaceMapper(EMPIRE_CurveSurfaceMapper_linear,
+                curveNumNodes, curveNumElements, curveNodeCoors, curveNodeIDs, curveElems,
+                surfaceNumNodes, surfaceNodeCoors, surfaceNumSections, 3, 2, 3,
+                KM_O_Q.getRotationMatrix(), KM_O_Q.getTranslationVector());
+
+        for (int i = 0; i < surfaceNumNodes; i++)
+            CPPUNIT_ASSERT(mapper->sortedPosToUnsortedPos[i] == mapperRef->sortedPosToUnsortedPos[i]);
+        for (int i = 0; i < surfaceNumSections; i++)
+            CPPUNIT_ASSERT(mapper->sectionToCurveElem[i] == mapperRef->sectionToCurveElem[i]);
+        for (int i = 0; i < surfaceNumSections * 3; i++)
+            CPPUNIT_ASSERT(fabs(mapper->sectionP[i] - mapperRef->sectionP[i]) < TOL);
+        for (int i = 0; i < surfaceNumSections * 10; i++)
+            CPPUNIT_ASSERT(fabs(mapper->shapeFuncOfSection[i] - mapperRef->shapeFuncOfSection[i]) < TOL);
+        for (int i = 0; i < curveNumElements; i++) {
+            double axisInLocal[] = { 1.0, 0.0, 0.0 };
+            double axisInLocalRef[] = { 1.0, 0.0, 0.0 };
+            mapper->ROT_O_ELEM[i]->move(axisInLocal);
+            mapperRef->ROT_O_ELEM[i]->move(axisInLocalRef);
+            for (int j = 0; j < 3; j++)
+                CPPUNIT_ASSERT(fabs(axisInLocal[j] - axisInLocalRef[j]) < TOL);
+        }
+
+        delete mapper;
+        delete mapperRef;
+    }
+
     /***********************************************************************************************
      * \brief Test bending with specific parabolic deformation
      ***********/
@@ -956,6 +1025,7 @@ public:
 
     CPPUNIT_TEST_SUITE (TestCurveSurfaceMapper);
     CPPUNIT_TEST (testConstructor);
+    CPPUNIT_TEST (testUpdateGeometry);
     CPPUNIT_TEST (testParabolicMapping);
     CPPUNIT_TEST (testCircleConsistent);
     CPPUNIT_TEST (testCircleConservative);
@@ -0,0 +1,124 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "DataFieldIntegration.h"
+#include <math.h>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the class DataFieldIntegration with a consistent and a lumped mass matrix
+ ***********/
+class TestDataFieldIntegration: public CppUnit::TestFixture {
+private:
+    /// number of nodes
+    static const int numNodes = 6;
+    /// number of elements
+    static const int numElems = 2;
+    /// nodes per element
+    int numNodesPerElem[numElems];
+    /// coordinates of the nodes
+    double nodes[numNodes * 3];
+    /// IDs of the nodes
+    int nodeIDs[numNodes];
+    /// element table
+    int elems[8];
+
+public:
+    void setUp() {
+        /*
+         * 4---5---6
+         * |   |   |  two unit squares
+         * 1---2---3
+         */
+        for (int i = 0; i < numNodes; i++) {
+            nodeIDs[i] = i + 1;
+            nodes[i * 3 + 0] = i % 3;
+            nodes[i * 3 + 1] = i / 3;
+            nodes[i * 3 + 2] = 0.0;
+        }
+        numNodesPerElem[0] = 4;
+        numNodesPerElem[1] = 4;
+        const int elemTable[] = { 1, 2, 5, 4, 2, 3, 6, 5 };
+        for (int i = 0; i < 8; i++)
+            elems[i] = elemTable[i];
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief A constant traction integrates to the area of the nodes, deintegration reverses it
+     ***********/
+    void testConsistent() {
+        DataFieldIntegration integration(numNodes, numElems, numNodesPerElem, nodes, nodeIDs,
+                elems);
+        const double refForces[] = { 0.25, 0.5, 0.25, 0.25, 0.5, 0.25 };
+        double tractions[numNodes];
+        double forces[numNodes];
+        for (int i = 0; i < numNodes; i++)
+            tractions[i] = 2.0;
+        integration.integrate(tractions, forces);
+        for (int i = 0; i < numNodes; i++)
+            CPPUNIT_ASSERT(fabs(forces[i] - 2.0 * refForces[i]) < 1E-10);
+
+        // a non-constant traction, twice to reuse the factorization
+        for (int k = 0; k < 2; k++) {
+            for (int i = 0; i < numNodes; i++)
+                tractions[i] = i + k;
+            integration.integrate(tractions, forces);
+            double deIntegrated[numNodes];
+            integration.deIntegrate(forces, deIntegrated);
+            for (int i = 0; i < numNodes; i++)
+                CPPUNIT_ASSERT(fabs(deIntegrated[i] - tractions[i]) < 1E-10);
+        }
+    }
+    /***********************************************************************************************
+     * \brief The lumped mass matrix is the diagonal of the row sums
+     ***********/
+    void testLumped() {
+        DataFieldIntegration integration(numNodes, numElems, numNodesPerElem, nodes, nodeIDs,
+                elems, true);
+        const double refForces[] = { 0.25, 0.5, 0.25, 0.25, 0.5, 0.25 };
+        double tractions[numNodes];
+        double forces[numNodes];
+        for (int i = 0; i < numNodes; i++)
+            tractions[i] = i + 1.0;
+        integration.integrate(tractions, forces);
+        for (int i = 0; i < numNodes; i++)
+            CPPUNIT_ASSERT(fabs(forces[i] - (i + 1.0) * refForces[i]) < 1E-10);
+        double deIntegrated[numNodes];
+        integration.deIntegrate(forces, deIntegrated);
+        for (int i = 0; i < numNodes; i++)
+            CPPUNIT_ASSERT(fabs(deIntegrated[i] - tractions[i]) < 1E-10);
+    }
+
+    CPPUNIT_TEST_SUITE (TestDataFieldIntegration);
+    CPPUNIT_TEST (testConsistent);
+    CPPUNIT_TEST (testLumped);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION (EMPIRE::TestDataFieldIntegration);
@@ -0,0 +1,199 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <pthread.h>
+#include <vector>
+
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "DataField.h"
+#include "FEMesh.h"
+#include "MapperAdapter.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/********//**
+ * \brief The mapping a replica asks the shared mapper for on its thread
+ ***********/
+struct ReplicaMapping {
+    MapperAdapter *mapper;
+    bool consistent;
+    DataField *input;
+    DataField *output;
+    double outputFactor;
+};
+
+static void *mapOnReplicaThread(void *replicaMapping) {
+    ReplicaMapping *mapping = static_cast<ReplicaMapping*>(replicaMapping);
+    if (mapping->consistent)
+        mapping->mapper->consistentMapping(mapping->input, mapping->output, mapping->outputFactor);
+    else
+        mapping->mapper->conservativeMapping(mapping->input, mapping->output,
+                mapping->outputFactor);
+    return NULL;
+}
+
+/********//**
+ * \brief Test the class EnsembleMappingBatch: the fields of several replicas mapped together by a
+ *        shared mapper equal the fields mapped one by one
+ ***********/
+class TestEnsembleMappingBatch: public CppUnit::TestFixture {
+private:
+    FEMesh *meshA;
+    FEMesh *meshB;
+    static const int NUM_REPLICAS = 3;
+
+public:
+    void setUp() {
+        /*
+         * 4-------3
+         * |       | mesh A
+         * 1-------2
+         */
+        meshA = new FEMesh("", 4, 1);
+        meshA->numNodesPerElem[0] = 4;
+        meshA->initElems();
+        double nodesA[] = { 0, 0, 0, 2, 0, 0, 2, 1, 0, 0, 1, 0 };
+        for (int i = 0; i < 4; i++) {
+            meshA->nodeIDs[i] = i + 1;
+            meshA->elems[i] = i + 1;
+        }
+        for (int i = 0; i < 12; i++)
+            meshA->nodes[i] = nodesA[i];
+        /*
+         * 6---5---4
+         * |   |   | mesh B
+         * 1---2---3
+         */
+        meshB = new FEMesh("", 6, 2);
+        meshB->numNodesPerElem[0] = 4;
+        meshB->numNodesPerElem[1] = 4;
+        meshB->initElems();
+        double nodesB[] = { 0, 0, 0, 1, 0, 0, 2, 0, 0, 2, 1, 0, 1, 1, 0, 0, 1, 0 };
+        int elemsB[] = { 1, 2, 5, 6, 2, 3, 4, 5 };
+        for (int i = 0; i < 6; i++)
+            meshB->nodeIDs[i] = i + 1;
+        for (int i = 0; i < 18; i++)
+            meshB->nodes[i] = nodesB[i];
+        for (int i = 0; i < 8; i++)
+            meshB->elems[i] = elemsB[i];
+    }
+    void tearDown() {
+        delete meshA;
+        delete meshB;
+    }
+    /***********************************************************************************************
+     * \brief Map the vector fields of the replicas on concurrent threads in both directions and
+     *        compare them with the fields mapped one by one without ensemble
+     ***********/
+    void testBatchEqualsSingleMappings() {
+        for (int m = 0; m < 2; m++) {
+            MapperAdapter *mapper = new MapperAdapter("", meshA, meshB);
+            if (m == 0)
+                mapper->initNearestNeighborMapper();
+            else
+                mapper->initBarycentricInterpolationMapper();
+            for (int direction = 0; direction < 2; direction++) {
+                bool consistent = (direction == 0);
+                FEMesh *inMesh = consistent ? meshA : meshB;
+                FEMesh *outMesh = consistent ? meshB : meshA;
+                vector<DataField*> inputs, outputs, references;
+                for (int k = 0; k < NUM_REPLICAS; k++) {
+                    inputs.push_back(new DataField("", EMPIRE_DataField_atNode, inMesh->numNodes,
+                            EMPIRE_DataField_vector, EMPIRE_DataField_field));
+                    outputs.push_back(new DataField("", EMPIRE_DataField_atNode, outMesh->numNodes,
+                            EMPIRE_DataField_vector, EMPIRE_DataField_field));
+                    references.push_back(new DataField("", EMPIRE_DataField_atNode,
+                            outMesh->numNodes, EMPIRE_DataField_vector, EMPIRE_DataField_field));
+                    for (int i = 0; i < inMesh->numNodes * 3; i++)
+                        inputs[k]->data[i] = (i * 7 + k) % 5 + 0.5 * i - k;
+                }
+                double factor[NUM_REPLICAS] = { 1.0, -2.0, 0.5 };
+                for (int k = 0; k < NUM_REPLICAS; k++) {
+                    if (consistent)
+                        mapper->consistentMapping(inputs[k], references[k], factor[k]);
+                    else
+                        mapper->conservativeMapping(inputs[k], references[k], factor[k]);
+                }
+
+                // the window is long enough for all replicas to join one batch
+                mapper->setEnsemble(NUM_REPLICAS, 10.0);
+                ReplicaMapping mappings[NUM_REPLICAS];
+                pthread_t threads[NUM_REPLICAS];
+                for (int k = 0; k < NUM_REPLICAS; k++) {
+                    ReplicaMapping mapping = { mapper, consistent, inputs[k], outputs[k],
+                            factor[k] };
+                    mappings[k] = mapping;
+                    pthread_create(&threads[k], NULL, &mapOnReplicaThread, &mappings[k]);
+                }
+                for (int k = 0; k < NUM_REPLICAS; k++)
+                    pthread_join(threads[k], NULL);
+                mapper->setEnsemble(1, 0.0);
+
+                const double EPS = 1e-12;
+                for (int k = 0; k < NUM_REPLICAS; k++) {
+                    for (int i = 0; i < outMesh->numNodes * 3; i++)
+                        CPPUNIT_ASSERT(fabs(outputs[k]->data[i] - references[k]->data[i]) < EPS);
+                    delete inputs[k];
+                    delete outputs[k];
+                    delete references[k];
+                }
+            }
+            delete mapper;
+        }
+    }
+    /***********************************************************************************************
+     * \brief A batch does not wait for replicas which have finished their co-simulation
+     ***********/
+    void testFinishedReplicas() {
+        MapperAdapter *mapper = new MapperAdapter("", meshA, meshB);
+        mapper->initNearestNeighborMapper();
+        // the test would hang for the window if the finished replicas were waited for
+        mapper->setEnsemble(NUM_REPLICAS, 1000.0);
+        for (int k = 1; k < NUM_REPLICAS; k++)
+            mapper->replicaFinished();
+        DataField *fieldA = new DataField("", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        DataField *fieldB = new DataField("", EMPIRE_DataField_atNode, meshB->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        for (int i = 0; i < meshA->numNodes; i++)
+            fieldA->data[i] = 1.0;
+        mapper->consistentMapping(fieldA, fieldB, 2.0);
+        for (int i = 0; i < meshB->numNodes; i++)
+            CPPUNIT_ASSERT(fabs(fieldB->data[i] - 2.0) < 1e-12);
+        delete fieldA;
+        delete fieldB;
+        delete mapper;
+    }
+
+CPPUNIT_TEST_SUITE( TestEnsembleMappingBatch );
+        CPPUNIT_TEST( testBatchEqualsSingleMappings);
+        CPPUNIT_TEST( testFinishedReplicas);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestEnsembleMappingBatch);
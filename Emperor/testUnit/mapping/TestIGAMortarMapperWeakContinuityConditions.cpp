@@ -30,12 +30,14 @@
 #include "cppunit/extensions/HelperMacros.h"
 #include "WeakIGAPatchContinuityCondition.h"
 #include "IGAMortarMapper.h"
+#include "IGAMortarMapperTuning.h"
 #include "FEMesh.h"
 #include "IGAPatchSurface.h"
 #include "IGAMesh.h"
 #include "DataField.h"
 #include "MathLibrary.h"
 #include <iostream>
+#include <sstream>
 #include <math.h>
 
 using namespace std;
@@ -1545,6 +1547,107 @@ public:
         delete[] weakPatchContinuityAlphaSecondaryTwistingIJ;
     }
 
+    /***********************************************************************************************
+     * \brief Test case: the build statistics count the projections, the Newton-Raphson iterations,
+     *        the clipped polygons, the Gauss points and the entries of Cnn and Cnr of the build
+     ***********/
+
+    void testBuildStatistics() {
+
+        // Build the coupling matrices
+        theMapper->buildCouplingMatrices();
+        MapperBuildStatistics statistics = theMapper->getBuildStatistics();
+
+        // Every node of the finite element mesh is projected once
+        long numProjections = 0;
+        for (int kind = 0; kind < MapperBuildStatistics::PROJECTION_FAILED; kind++)
+            numProjections += statistics.getNumProjections((MapperBuildStatistics::ProjectionKind) kind);
+        CPPUNIT_ASSERT(numProjections == theFEMesh->numNodes);
+        CPPUNIT_ASSERT(statistics.getNumProjections(MapperBuildStatistics::PROJECTION_FAILED) == 0);
+        long numNewtonProjections = 0;
+        for (int i = 0; i < statistics.getNewtonIterationHistogram().size(); i++)
+            numNewtonProjections += statistics.getNewtonIterationHistogram()[i];
+        CPPUNIT_ASSERT(numNewtonProjections >= statistics.getNumProjections(MapperBuildStatistics::PROJECTION_DIRECT));
+
+        // Every element is clipped into at least one polygon
+        CPPUNIT_ASSERT(statistics.getNumClippedPolygons() >= theFEMesh->numElems);
+        CPPUNIT_ASSERT(statistics.getNumClippedPolygonVertices() >= 3 * statistics.getNumClippedPolygons());
+        CPPUNIT_ASSERT(statistics.getNumGaussPoints() > 0);
+
+        // The sizes of the coupling matrices
+        CPPUNIT_ASSERT(statistics.getMatrixNumNonZeros("Cnn") > 0);
+        CPPUNIT_ASSERT(statistics.getMatrixNumNonZeros("Cnr") > 0);
+        CPPUNIT_ASSERT(statistics.getMatrixFill("Cnr") > 0.0 && statistics.getMatrixFill("Cnr") <= 1.0);
+        CPPUNIT_ASSERT(statistics.getStageTime("12. clipping and integration") > 0.0);
+    }
+
+    /***********************************************************************************************
+     * \brief Test case: tune the build parameters of the mapper on a sample of the FE elements
+     ***********/
+
+    void testTuning() {
+
+        // The parameters of the mapper of setUp with a fixed quadrature
+        IGAMortarMapperTuning::Parameters configured;
+        configured.maxProjectionDistance = 0.05;
+        configured.noInitialGuess = 2;
+        configured.maxProjectionDistanceOnDifferentPatches = 1e-3;
+        configured.noIterationsNewtonRaphson = 10;
+        configured.tolProjectionNewtonRaphson = 1e-6;
+        configured.noIterationsNewtonRaphsonBoundary = 0;
+        configured.tolProjectionNewtonRaphsonBoundary = 1e-6;
+        configured.noIterationsBisection = 100;
+        configured.tolProjectionBisection = 1e-6;
+        configured.isAutomaticNoGPTriangle = false;
+        configured.noGPTriangle = 16;
+        configured.isAutomaticNoGPQuadrilateral = false;
+        configured.noGPQuadrilateral = 25;
+        configured.isAdaptiveIntegration = false;
+        configured.tolAdaptiveIntegration = 1e-6;
+
+        const double targetMappingError = 1e-6;
+        IGAMortarMapperTuning tuning("Test IGA Mortar Mapper", theIGAMesh, theFEMesh, theFEMesh->numElems / 2,
+                1.0, targetMappingError, 1);
+        CPPUNIT_ASSERT(tuning.getNumSampleElems() > 0 && tuning.getNumSampleElems() <= theFEMesh->numElems / 2);
+        IGAMortarMapperTuning::Parameters suggested = tuning.tune(configured);
+
+        // The configured parameters are the reference
+        const std::vector<IGAMortarMapperTuning::Trial> &trials = tuning.getTrials();
+        CPPUNIT_ASSERT(trials.size() > 1);
+        CPPUNIT_ASSERT(trials[0].isAccepted);
+        CPPUNIT_ASSERT(trials[0].projectionSuccessRate == 1.0);
+        CPPUNIT_ASSERT(trials[0].mappingError == 0.0);
+
+        // The accepted trials reach the targets
+        for (int i = 0; i < trials.size(); i++)
+            if (trials[i].isAccepted) {
+                CPPUNIT_ASSERT(trials[i].projectionSuccessRate >= 1.0);
+                CPPUNIT_ASSERT(trials[i].mappingError <= targetMappingError);
+            }
+
+        // The suggested parameters are not more expensive than the configured ones
+        CPPUNIT_ASSERT(suggested.noInitialGuess <= configured.noInitialGuess);
+        CPPUNIT_ASSERT(suggested.noIterationsNewtonRaphson <= configured.noIterationsNewtonRaphson);
+        CPPUNIT_ASSERT(suggested.noIterationsNewtonRaphsonBoundary == configured.noIterationsNewtonRaphsonBoundary);
+        CPPUNIT_ASSERT(suggested.noIterationsBisection <= configured.noIterationsBisection);
+        CPPUNIT_ASSERT(suggested.noGPTriangle <= configured.noGPTriangle);
+        CPPUNIT_ASSERT(suggested.noGPQuadrilateral <= configured.noGPQuadrilateral);
+        CPPUNIT_ASSERT(suggested.maxProjectionDistance == configured.maxProjectionDistance);
+        bool isChanged = suggested.noInitialGuess != configured.noInitialGuess
+                || suggested.noIterationsNewtonRaphson != configured.noIterationsNewtonRaphson
+                || suggested.noIterationsBisection != configured.noIterationsBisection
+                || suggested.noGPTriangle != configured.noGPTriangle
+                || suggested.noGPQuadrilateral != configured.noGPQuadrilateral;
+        if (isChanged)
+            CPPUNIT_ASSERT(trials.back().description == "combined" && trials.back().isAccepted);
+
+        // The suggestion is written as the elements of the input file
+        std::stringstream xml;
+        IGAMortarMapperTuning::writeXML(xml, suggested);
+        CPPUNIT_ASSERT(xml.str().find("<surfaceProjection maxProjectionDistance=\"0.05\"") == 0);
+        CPPUNIT_ASSERT(xml.str().find("<integration noGPTriangle=") != std::string::npos);
+    }
+
     /***********************************************************************************************
      * \brief Test case: testCreateWeakContinuityConditionGPData
      ***********/
@@ -2011,6 +2114,8 @@ public:
     CPPUNIT_TEST (testComputeBOperatorMatricesIGAPatchContinuityConditions);
     CPPUNIT_TEST (testComputePenaltyFactorsIGAPatchContinuityConditions);
     CPPUNIT_TEST (testCreateWeakContinuityConditionGPData);
+    CPPUNIT_TEST (testBuildStatistics);
+    CPPUNIT_TEST (testTuning);
 
     // Make the tests for memory leakage
     //    CPPUNIT_TEST (testComputeBOperatorMatricesIGAPatchContinuityConditions4Leakage);
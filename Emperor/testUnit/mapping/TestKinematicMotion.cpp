@@ -234,13 +234,56 @@ public:
             CPPUNIT_ASSERT(fabs(rotVec[2] - sqrt(3.0)/3.0*M_PI) < TOL);
         }
     }
+    /***********************************************************************************************
+     * \brief Test moving many points at once against moving them one by one
+     ***********/
+    void testMoveBatch() {
+        const double TOL = 1E-12;
+        KinematicMotion km;
+        double axis[] = { 1.0, 2.0, 3.0 };
+        double translationVec[] = { 2.0, -1.0, 0.5 };
+        km.addRotation(axis, false, 0.7);
+        km.addTranslation(translationVec);
+
+        const int n = 101;
+        double *points = new double[n * 3];
+        double *ref = new double[n * 3];
+        double *moved = new double[n * 3];
+        for (int i = 0; i < n * 3; i++)
+            points[i] = ref[i] = sin(i * 0.37) * 10.0;
+        for (int i = 0; i < n; i++)
+            km.move(&ref[i * 3]);
+
+        for (int numThreads = 1; numThreads <= 4; numThreads += 3) {
+            km.moveBatch(points, moved, n, numThreads);
+            for (int i = 0; i < n * 3; i++)
+                CPPUNIT_ASSERT(fabs(moved[i] - ref[i]) < TOL);
+        }
+        // in place
+        km.moveBatch(points, points, n);
+        for (int i = 0; i < n * 3; i++)
+            CPPUNIT_ASSERT(fabs(points[i] - ref[i]) < TOL);
+
+        double affine[12];
+        km.getAffineMatrix(affine);
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++)
+                CPPUNIT_ASSERT(affine[i * 4 + j] == km.getRotationMatrix()[i * 3 + j]);
+            CPPUNIT_ASSERT(affine[i * 4 + 3] == km.getTranslationVector()[i]);
+        }
+
+        delete[] points;
+        delete[] ref;
+        delete[] moved;
+    }
 
     CPPUNIT_TEST_SUITE (TestKinematicMotion);
     CPPUNIT_TEST (testConstructor);
     CPPUNIT_TEST (testMotionAndCoorTransformation);
     CPPUNIT_TEST (testAddMotion);
     CPPUNIT_TEST (testAddRotation);
-    CPPUNIT_TEST (testRotationVector);CPPUNIT_TEST_SUITE_END();
+    CPPUNIT_TEST (testRotationVector);
+    CPPUNIT_TEST (testMoveBatch);CPPUNIT_TEST_SUITE_END();
 };
 
 } /* namespace EMPIRE */
@@ -0,0 +1,149 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "MapperBuildStatistics.h"
+
+#include <string>
+#include <sstream>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the build statistics of the mappers
+ ***********/
+class TestMapperBuildStatistics: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: the counters are increased from several threads at once
+     ***********/
+    void testCounters() {
+        MapperBuildStatistics statistics;
+        const int numNodes = 1000;
+#pragma omp parallel for num_threads(4)
+        for (int i = 0; i < numNodes; i++) {
+            statistics.addProjection(
+                    i % 10 == 0 ? MapperBuildStatistics::PROJECTION_PRUNED : MapperBuildStatistics::PROJECTION_DIRECT);
+            statistics.addNewtonIterations(i % 4);
+            statistics.addClippedPolygon(3 + i % 2);
+            statistics.addGaussPoints(7);
+        }
+        statistics.addProjections(MapperBuildStatistics::PROJECTION_FAILED, 2);
+        statistics.addNewtonIterations(MapperBuildStatistics::MAX_HISTOGRAM_ITERATIONS + 10);
+        CPPUNIT_ASSERT(statistics.getNumProjections(MapperBuildStatistics::PROJECTION_DIRECT) == 900);
+        CPPUNIT_ASSERT(statistics.getNumProjections(MapperBuildStatistics::PROJECTION_PRUNED) == 100);
+        CPPUNIT_ASSERT(statistics.getNumProjections(MapperBuildStatistics::PROJECTION_RELAXED) == 0);
+        CPPUNIT_ASSERT(statistics.getNumProjections(MapperBuildStatistics::PROJECTION_FAILED) == 2);
+        const vector<long> &histogram = statistics.getNewtonIterationHistogram();
+        CPPUNIT_ASSERT(histogram.size() == MapperBuildStatistics::MAX_HISTOGRAM_ITERATIONS + 1);
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(histogram[i] == numNodes / 4);
+        CPPUNIT_ASSERT(histogram[MapperBuildStatistics::MAX_HISTOGRAM_ITERATIONS] == 1);
+        CPPUNIT_ASSERT(statistics.getNumClippedPolygons() == numNodes);
+        CPPUNIT_ASSERT(statistics.getNumClippedPolygonVertices() == 3500);
+        CPPUNIT_ASSERT(statistics.getNumGaussPoints() == 7 * numNodes);
+
+        statistics.reset();
+        CPPUNIT_ASSERT(statistics.getNumProjections(MapperBuildStatistics::PROJECTION_DIRECT) == 0);
+        CPPUNIT_ASSERT(statistics.getNewtonIterationHistogram()[0] == 0);
+        CPPUNIT_ASSERT(statistics.getNumGaussPoints() == 0);
+    }
+    /***********************************************************************************************
+     * \brief Test case: the fill of a matrix refers to its stored part
+     ***********/
+    void testMatrices() {
+        MapperBuildStatistics statistics;
+        statistics.setMatrix("Cnn", 4, 4, 5, true);
+        statistics.setMatrix("Cnr", 4, 10, 20, false);
+        CPPUNIT_ASSERT(statistics.getMatrixNumNonZeros("Cnn") == 5);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, statistics.getMatrixFill("Cnn"), 1e-15);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, statistics.getMatrixFill("Cnr"), 1e-15);
+        // a matrix set again is replaced
+        statistics.setMatrix("Cnr", 4, 10, 10, false);
+        CPPUNIT_ASSERT(statistics.getMatrixNumNonZeros("Cnr") == 10);
+        CPPUNIT_ASSERT(statistics.getMatrixNumNonZeros("none") == 0);
+        CPPUNIT_ASSERT(statistics.getMatrixFill("none") == 0.0);
+    }
+    /***********************************************************************************************
+     * \brief Test case: the stage timer adds the time of every stage
+     ***********/
+    void testStages() {
+        MapperBuildStatistics statistics;
+        {
+            MapperBuildStatistics::StageTimer stages(statistics);
+            stages.next("1. projection");
+            stages.next("2. integration");
+        }
+        statistics.addStageTime("2. integration", 1.0);
+        CPPUNIT_ASSERT(statistics.getStageTime("1. projection") >= 0.0);
+        CPPUNIT_ASSERT(statistics.getStageTime("2. integration") >= 1.0);
+        CPPUNIT_ASSERT(statistics.getStageTime("none") == 0.0);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(statistics.getStageTime("1. projection") + statistics.getStageTime("2. integration"),
+                statistics.getTotalTime(), 1e-12);
+    }
+    /***********************************************************************************************
+     * \brief Test case: the JSON report holds all statistics
+     ***********/
+    void testJSON() {
+        MapperBuildStatistics statistics;
+        statistics.addProjections(MapperBuildStatistics::PROJECTION_DIRECT, 12);
+        statistics.addProjection(MapperBuildStatistics::PROJECTION_RELAXED);
+        statistics.addNewtonIterations(2);
+        statistics.addNewtonIterations(3);
+        statistics.addClippedPolygon(4);
+        statistics.addGaussPoints(16);
+        statistics.setMatrix("Cnn", 4, 4, 5, true);
+        statistics.addStageTime("7. projection", 0.5);
+        string json = statistics.toJSON("mapper \"1\"");
+        CPPUNIT_ASSERT(json.find("\"mapper\": \"mapper \\\"1\\\"\"") != string::npos);
+        CPPUNIT_ASSERT(json.find("\"direct\": 12") != string::npos);
+        CPPUNIT_ASSERT(json.find("\"relaxed\": 1") != string::npos);
+        CPPUNIT_ASSERT(json.find("\"sampled\": 0") != string::npos);
+        // the histogram ends at the last non-empty bin
+        CPPUNIT_ASSERT(json.find("\"newtonIterationHistogram\": [0, 0, 1, 1]") != string::npos);
+        CPPUNIT_ASSERT(json.find("\"clippedPolygons\": {\"count\": 1, \"vertices\": 4}") != string::npos);
+        CPPUNIT_ASSERT(json.find("\"gaussPoints\": 16") != string::npos);
+        CPPUNIT_ASSERT(json.find("{\"name\": \"Cnn\", \"rows\": 4, \"columns\": 4, \"nonZeros\": 5, \"symmetric\": true, \"fill\": 0.5}") != string::npos);
+        CPPUNIT_ASSERT(json.find("{\"name\": \"7. projection\", \"seconds\": 0.500000}") != string::npos);
+        CPPUNIT_ASSERT(json.find("\"totalSeconds\": 0.500000") != string::npos);
+        stringstream out;
+        statistics.writeJSON(out, "mapper \"1\"");
+        CPPUNIT_ASSERT(out.str() == json);
+    }
+
+CPPUNIT_TEST_SUITE( TestMapperBuildStatistics );
+        CPPUNIT_TEST( testCounters);
+        CPPUNIT_TEST( testMatrices);
+        CPPUNIT_TEST( testStages);
+        CPPUNIT_TEST( testJSON);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestMapperBuildStatistics);
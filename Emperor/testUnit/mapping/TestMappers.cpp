@@ -39,6 +39,7 @@
 #include "ConnectionIOSetup.h"
 #include "Message.h"
 #include "GiDFileIO.h"
+#include "Profiler.h"
 
 using namespace std;
 
@@ -492,10 +493,199 @@ public:
         delete f_B;
     }
 
+    /***********************************************************************************************
+     * \brief Test case: mapping a vector field in one go gives the same result as mapping each
+     *        component separately
+     ***********/
+    void testVectorFieldMapping() {
+        const int numDOFs = 3;
+        DataField *d_A = new DataField("d_A", EMPIRE_DataField_atNode, meshQuadA->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *d_B = new DataField("d_B", EMPIRE_DataField_atNode, meshQuadB->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *f_A = new DataField("f_A", EMPIRE_DataField_atNode, meshQuadA->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_fieldIntegral);
+        DataField *f_B = new DataField("f_B", EMPIRE_DataField_atNode, meshQuadB->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_fieldIntegral);
+        DataField *d_AScalar = new DataField("d_AScalar", EMPIRE_DataField_atNode,
+                meshQuadA->numNodes, EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        DataField *d_BScalar = new DataField("d_BScalar", EMPIRE_DataField_atNode,
+                meshQuadB->numNodes, EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        DataField *f_AScalar = new DataField("f_AScalar", EMPIRE_DataField_atNode,
+                meshQuadA->numNodes, EMPIRE_DataField_scalar, EMPIRE_DataField_fieldIntegral);
+        DataField *f_BScalar = new DataField("f_BScalar", EMPIRE_DataField_atNode,
+                meshQuadB->numNodes, EMPIRE_DataField_scalar, EMPIRE_DataField_fieldIntegral);
+
+        for (int i = 0; i < meshQuadA->numNodes * numDOFs; i++)
+            d_A->data[i] = (i * 7) % 5 + 0.5 * i;
+        for (int i = 0; i < meshQuadB->numNodes * numDOFs; i++)
+            f_B->data[i] = (i * 3) % 4 - 0.25 * i;
+
+        vector<MapperAdapter *> mappers;
+        { // NearestNeighborMapper
+            MapperAdapter *mapper = new MapperAdapter("", meshQuadA, meshQuadB);
+            mapper->initNearestNeighborMapper();
+            mappers.push_back(mapper);
+        }
+        { // BarycentricInterpolationMapper
+            MapperAdapter *mapper = new MapperAdapter("", meshQuadA, meshQuadB);
+            mapper->initBarycentricInterpolationMapper();
+            mappers.push_back(mapper);
+        }
+        { // NearestElementMapper
+            MapperAdapter *mapper = new MapperAdapter("", meshQuadA, meshQuadB);
+            mapper->initNearestElementMapper();
+            mappers.push_back(mapper);
+        }
+        { // MortarMapper normal
+#ifdef USE_INTEL_MKL
+        MapperAdapter *mapper = new MapperAdapter("", meshQuadA, meshQuadB);
+        mapper->initMortarMapper(false, false, false);
+        mappers.push_back(mapper);
+#endif
+        }
+
+        const double EPS = 1e-10;
+        for (int i = 0; i < mappers.size(); i++) {
+            mappers[i]->consistentMapping(d_A, d_B);
+            mappers[i]->conservativeMapping(f_B, f_A);
+            for (int k = 0; k < numDOFs; k++) {
+                for (int j = 0; j < meshQuadA->numNodes; j++)
+                    d_AScalar->data[j] = d_A->data[j * numDOFs + k];
+                for (int j = 0; j < meshQuadB->numNodes; j++)
+                    f_BScalar->data[j] = f_B->data[j * numDOFs + k];
+                mappers[i]->consistentMapping(d_AScalar, d_BScalar);
+                mappers[i]->conservativeMapping(f_BScalar, f_AScalar);
+                for (int j = 0; j < meshQuadB->numNodes; j++)
+                    CPPUNIT_ASSERT(fabs(d_B->data[j * numDOFs + k] - d_BScalar->data[j]) < EPS);
+                for (int j = 0; j < meshQuadA->numNodes; j++)
+                    CPPUNIT_ASSERT(fabs(f_A->data[j * numDOFs + k] - f_AScalar->data[j]) < EPS);
+            }
+        }
+        for (int i = 0; i < mappers.size(); i++) {
+            delete mappers[i];
+        }
+
+        delete d_A;
+        delete d_B;
+        delete f_A;
+        delete f_B;
+        delete d_AScalar;
+        delete d_BScalar;
+        delete f_AScalar;
+        delete f_BScalar;
+    }
+
+    /***********************************************************************************************
+     * \brief Test NearestElementMapper on strongly anisotropic elements, where the centroid of the
+     *        element containing a node of B is further away than the centroids of many other elements
+     ***********/
+    void testNearestElementMapperAnisotropicElements() {
+        /*
+         * a long quad [0, 100] x [0, 1] followed by 20 unit quads [100 + i, 101 + i] x [0, 1]
+         */
+        const int numElemsA = 21;
+        const int numNodesA = 2 * (numElemsA + 1);
+        double nodesA[numNodesA * 3];
+        int nodeIDsA[numNodesA];
+        int numNodesPerElemA[numElemsA];
+        int elemsA[numElemsA * 4];
+        for (int i = 0; i < numElemsA + 1; i++) {
+            double x = (i == 0) ? 0.0 : 99.0 + i;
+            for (int j = 0; j < 2; j++) { // node i is at the bottom, node numElemsA + 1 + i at the top
+                int pos = j * (numElemsA + 1) + i;
+                nodeIDsA[pos] = pos + 1;
+                nodesA[pos * 3 + 0] = x;
+                nodesA[pos * 3 + 1] = j;
+                nodesA[pos * 3 + 2] = 0.0;
+            }
+        }
+        for (int i = 0; i < numElemsA; i++) {
+            numNodesPerElemA[i] = 4;
+            elemsA[i * 4 + 0] = nodeIDsA[i];
+            elemsA[i * 4 + 1] = nodeIDsA[i + 1];
+            elemsA[i * 4 + 2] = nodeIDsA[numElemsA + 2 + i];
+            elemsA[i * 4 + 3] = nodeIDsA[numElemsA + 1 + i];
+        }
+
+        const int numNodesB = 3;
+        double nodesB[numNodesB * 3] = { 99.5, 0.5, 0.0, 50.0, 0.5, 0.2, 105.5, 0.3, 0.0 };
+        int nodeIDsB[numNodesB] = { 1, 2, 3 };
+
+        NearestElementMapper *mapper = new NearestElementMapper(numNodesA, numElemsA,
+                numNodesPerElemA, nodesA, nodeIDsA, elemsA, numNodesB, 0, NULL, nodesB, nodeIDsB,
+                NULL);
+        mapper->buildCouplingMatrices();
+
+        double fieldA[numNodesA];
+        for (int i = 0; i < numNodesA; i++)
+            fieldA[i] = nodesA[i * 3 + 0];
+        double fieldB[numNodesB];
+        mapper->consistentMapping(fieldA, fieldB);
+        const double EPS = 1e-10;
+        CPPUNIT_ASSERT(fabs(fieldB[0] - 99.5) < EPS);
+        CPPUNIT_ASSERT(fabs(fieldB[1] - 50.0) < EPS);
+        CPPUNIT_ASSERT(fabs(fieldB[2] - 105.5) < EPS);
+        delete mapper;
+    }
+
+    /***********************************************************************************************
+     * \brief Test case: the conservation monitor samples the virtual work of every second
+     *        conservative mapping, which is equal on both meshes
+     ***********/
+    void testConservationMonitor() {
+        DataField *d_A = new DataField("d_A", EMPIRE_DataField_atNode, meshQuadA->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        DataField *d_B = new DataField("d_B", EMPIRE_DataField_atNode, meshQuadB->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        DataField *f_A = new DataField("f_A", EMPIRE_DataField_atNode, meshQuadA->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_fieldIntegral);
+        DataField *f_B = new DataField("f_B", EMPIRE_DataField_atNode, meshQuadB->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_fieldIntegral);
+        for (int i = 0; i < meshQuadA->numNodes; i++)
+            d_A->data[i] = 1.0 + 2.0 * i;
+        for (int i = 0; i < meshQuadB->numNodes; i++)
+            f_B->data[i] = 3.0 - i;
+
+        Profiler::reset();
+        Profiler::setEnabled(true);
+        MapperAdapter *mapper = new MapperAdapter("monitored", meshQuadA, meshQuadB);
+        mapper->initBarycentricInterpolationMapper();
+        mapper->setConservationMonitor(2, 1e-10);
+        mapper->consistentMapping(d_A, d_B);
+        mapper->conservativeMapping(f_B, f_A);
+        // the first conservative mapping is not sampled
+        CPPUNIT_ASSERT(Profiler::getValue("mapper \"monitored\": virtual work A") == 0.0);
+        mapper->conservativeMapping(f_B, f_A);
+
+        double workA = 0.0;
+        for (int i = 0; i < meshQuadA->numNodes; i++)
+            workA += f_A->data[i] * d_A->data[i];
+        double squaredNormB = 0.0;
+        for (int i = 0; i < meshQuadB->numNodes; i++)
+            squaredNormB += f_B->data[i] * f_B->data[i];
+        const double EPS = 1e-10;
+        CPPUNIT_ASSERT(fabs(Profiler::getValue("mapper \"monitored\": virtual work A") - workA) < EPS);
+        CPPUNIT_ASSERT(fabs(Profiler::getValue("mapper \"monitored\": virtual work B") - workA) < EPS);
+        CPPUNIT_ASSERT(Profiler::getValue("mapper \"monitored\": relative virtual work difference") < EPS);
+        CPPUNIT_ASSERT(fabs(Profiler::getValue("mapper \"monitored\": norm of forces B") - sqrt(squaredNormB)) < EPS);
+        Profiler::setEnabled(false);
+        Profiler::reset();
+
+        delete mapper;
+        delete d_A;
+        delete d_B;
+        delete f_A;
+        delete f_B;
+    }
+
 CPPUNIT_TEST_SUITE( TestMappers );
         CPPUNIT_TEST( testMappingOnMatchingMeshes);
         CPPUNIT_TEST( testConsistency);
         CPPUNIT_TEST( testConservation);
+        CPPUNIT_TEST( testVectorFieldMapping);
+        CPPUNIT_TEST( testNearestElementMapperAnisotropicElements);
+        CPPUNIT_TEST( testConservationMonitor);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -31,7 +31,9 @@
 #include "MapperAdapter.h"
 #include "MapperAdapter.h"
 #include "Message.h"
+#include "AuxiliaryParameters.h"
 #include <math.h>
+#include <vector>
 #include <iostream>
 
 using namespace std;
@@ -154,6 +156,262 @@ public:
         delete a1;
         delete b1;
     }
+    /***********************************************************************************************
+     * \brief Create a mesh of n x n quads on the unit square
+     ***********/
+    FEMesh *createSquareMesh(int n) {
+        FEMesh *mesh = new FEMesh("", (n + 1) * (n + 1), n * n);
+        for (int i = 0; i < n * n; i++)
+            mesh->numNodesPerElem[i] = 4;
+        mesh->initElems();
+        for (int j = 0; j <= n; j++) {
+            for (int i = 0; i <= n; i++) {
+                int node = j * (n + 1) + i;
+                mesh->nodeIDs[node] = node + 1;
+                mesh->nodes[node * 3 + 0] = (double) i / n;
+                mesh->nodes[node * 3 + 1] = (double) j / n;
+                mesh->nodes[node * 3 + 2] = 0.0;
+            }
+        }
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < n; i++) {
+                int elem = j * n + i;
+                mesh->elems[elem * 4 + 0] = j * (n + 1) + i + 1;
+                mesh->elems[elem * 4 + 1] = j * (n + 1) + i + 2;
+                mesh->elems[elem * 4 + 2] = (j + 1) * (n + 1) + i + 2;
+                mesh->elems[elem * 4 + 3] = (j + 1) * (n + 1) + i + 1;
+            }
+        }
+        return mesh;
+    }
+    /***********************************************************************************************
+     * \brief Move the nodes of a mesh by an affine map, the moved mesh stays planar
+     ***********/
+    void moveMesh(FEMesh *mesh) {
+        for (int i = 0; i < mesh->numNodes; i++) {
+            double x = mesh->nodes[i * 3 + 0];
+            double y = mesh->nodes[i * 3 + 1];
+            mesh->nodes[i * 3 + 0] = 1.5 * x + 0.2 * y + 0.3;
+            mesh->nodes[i * 3 + 1] = 0.8 * y - 0.1;
+            mesh->nodes[i * 3 + 2] = 0.1 * x;
+        }
+    }
+    /***********************************************************************************************
+     * \brief A linear field must be mapped exactly before and after the meshes moved
+     ***********/
+    void testUpdateGeometry() {
+        static const double EPS = 1E-10;
+        FEMesh *meshA = createSquareMesh(2);
+        FEMesh *meshB = createSquareMesh(3);
+        DataField *a1 = new DataField("a1", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        DataField *b1 = new DataField("b1", EMPIRE_DataField_atNode, meshB->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+
+        bool oppositeSurfaceNormal = false;
+        bool dual = false;
+        bool enforceConsistency = false;
+        MapperAdapter *mapper = new MapperAdapter("testMortarUpdateGeometry", meshA, meshB);
+        mapper->initMortarMapper(oppositeSurfaceNormal, dual, enforceConsistency);
+
+        for (int step = 0; step < 2; step++) {
+            if (step == 1) {
+                moveMesh(meshA);
+                moveMesh(meshB);
+                mapper->updateGeometry();
+            }
+            for (int i = 0; i < meshA->numNodes; i++)
+                a1->data[i] = 1.0 + 2.0 * meshA->nodes[i * 3 + 0] + 3.0 * meshA->nodes[i * 3 + 1];
+            mapper->consistentMapping(a1, b1);
+            for (int i = 0; i < meshB->numNodes; i++)
+                CPPUNIT_ASSERT(fabs(b1->data[i] - (1.0 + 2.0 * meshB->nodes[i * 3 + 0]
+                        + 3.0 * meshB->nodes[i * 3 + 1])) < EPS);
+        }
+
+        delete mapper;
+        delete meshA;
+        delete meshB;
+        delete a1;
+        delete b1;
+    }
+    /***********************************************************************************************
+     * \brief Test the conjugate gradient solver of C_BB against the direct solver. The second
+     *        mapping is warm started from the result of the first.
+     ***********/
+    void testIterativeSolver() {
+        static const double EPS = 1E-8;
+        FEMesh *meshA = createSquareMesh(3);
+        FEMesh *meshB = createSquareMesh(4);
+        DataField *a = new DataField("a", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *bDirect = new DataField("bDirect", EMPIRE_DataField_atNode, meshB->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *bIterative = new DataField("bIterative", EMPIRE_DataField_atNode,
+                meshB->numNodes, EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *aDirect = new DataField("aDirect", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *aIterative = new DataField("aIterative", EMPIRE_DataField_atNode,
+                meshA->numNodes, EMPIRE_DataField_vector, EMPIRE_DataField_field);
+
+        MapperAdapter *direct = new MapperAdapter("testMortarDirect", meshA, meshB);
+        direct->initMortarMapper(false, false, false);
+        MapperAdapter *iterative = new MapperAdapter("testMortarIterative", meshA, meshB);
+        iterative->setIterativeSolver(1E-12, 100);
+        iterative->initMortarMapper(false, false, false);
+
+        for (int step = 0; step < 2; step++) {
+            for (int i = 0; i < meshA->numNodes; i++) {
+                double x = meshA->nodes[i * 3 + 0];
+                double y = meshA->nodes[i * 3 + 1];
+                a->data[i * 3 + 0] = sin(x + step) * y;
+                a->data[i * 3 + 1] = x * x + step;
+                a->data[i * 3 + 2] = cos(y) * step;
+            }
+            direct->consistentMapping(a, bDirect);
+            iterative->consistentMapping(a, bIterative);
+            for (int i = 0; i < meshB->numNodes * 3; i++)
+                CPPUNIT_ASSERT(fabs(bDirect->data[i] - bIterative->data[i]) < EPS);
+
+            direct->conservativeMapping(bDirect, aDirect);
+            iterative->conservativeMapping(bDirect, aIterative);
+            for (int i = 0; i < meshA->numNodes * 3; i++)
+                CPPUNIT_ASSERT(fabs(aDirect->data[i] - aIterative->data[i]) < EPS);
+        }
+
+        delete direct;
+        delete iterative;
+        delete meshA;
+        delete meshB;
+        delete a;
+        delete bDirect;
+        delete bIterative;
+        delete aDirect;
+        delete aIterative;
+    }
+    /***********************************************************************************************
+     * \brief Test the precomputed operator H of the dual mortar mapper against the mapping by C_BA
+     *        and C_BB
+     ***********/
+    void testExplicitMappingOperator() {
+        static const double EPS = 1E-12;
+        FEMesh *meshA = createSquareMesh(3);
+        FEMesh *meshB = createSquareMesh(4);
+        moveMesh(meshB);
+        DataField *a = new DataField("a", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *bCoupling = new DataField("bCoupling", EMPIRE_DataField_atNode, meshB->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *bExplicit = new DataField("bExplicit", EMPIRE_DataField_atNode, meshB->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *aCoupling = new DataField("aCoupling", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+        DataField *aExplicit = new DataField("aExplicit", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_vector, EMPIRE_DataField_field);
+
+        MapperAdapter *coupling = new MapperAdapter("testMortarCoupling", meshA, meshB);
+        coupling->initMortarMapper(false, true, true);
+        MapperAdapter *explicitOperator = new MapperAdapter("testMortarExplicit", meshA, meshB);
+        explicitOperator->setExplicitMappingOperator(true);
+        explicitOperator->initMortarMapper(false, true, true);
+
+        for (int i = 0; i < meshA->numNodes; i++) {
+            double x = meshA->nodes[i * 3 + 0];
+            double y = meshA->nodes[i * 3 + 1];
+            a->data[i * 3 + 0] = sin(x) * y;
+            a->data[i * 3 + 1] = x * x;
+            a->data[i * 3 + 2] = cos(y);
+        }
+        coupling->consistentMapping(a, bCoupling);
+        explicitOperator->consistentMapping(a, bExplicit);
+        for (int i = 0; i < meshB->numNodes * 3; i++)
+            CPPUNIT_ASSERT(fabs(bCoupling->data[i] - bExplicit->data[i]) < EPS);
+
+        coupling->conservativeMapping(bCoupling, aCoupling);
+        explicitOperator->conservativeMapping(bCoupling, aExplicit);
+        for (int i = 0; i < meshA->numNodes * 3; i++)
+            CPPUNIT_ASSERT(fabs(aCoupling->data[i] - aExplicit->data[i]) < EPS);
+
+        delete coupling;
+        delete explicitOperator;
+        delete meshA;
+        delete meshB;
+        delete a;
+        delete bCoupling;
+        delete bExplicit;
+        delete aCoupling;
+        delete aExplicit;
+    }
+    /***********************************************************************************************
+     * \brief A linear field must be mapped exactly if the elements of one mesh are much larger than
+     *        the ones of the other mesh, i.e. all overlapping elements must be found
+     ***********/
+    void testDifferentElementSizes() {
+        static const double EPS = 1E-10;
+        for (int k = 0; k < 4; k++) {
+            bool isCoarseA = (k % 2 == 0);
+            bool dual = (k >= 2);
+            FEMesh *meshA = createSquareMesh(isCoarseA ? 1 : 12);
+            FEMesh *meshB = createSquareMesh(isCoarseA ? 12 : 1);
+            DataField *a1 = new DataField("a1", EMPIRE_DataField_atNode, meshA->numNodes,
+                    EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+            DataField *b1 = new DataField("b1", EMPIRE_DataField_atNode, meshB->numNodes,
+                    EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+            MapperAdapter *mapper = new MapperAdapter("testMortarElementSizes", meshA, meshB);
+            mapper->initMortarMapper(false, dual, false);
+
+            for (int i = 0; i < meshA->numNodes; i++)
+                a1->data[i] = 1.0 + 2.0 * meshA->nodes[i * 3 + 0] + 3.0 * meshA->nodes[i * 3 + 1];
+            mapper->consistentMapping(a1, b1);
+            for (int i = 0; i < meshB->numNodes; i++)
+                CPPUNIT_ASSERT(fabs(b1->data[i] - (1.0 + 2.0 * meshB->nodes[i * 3 + 0]
+                        + 3.0 * meshB->nodes[i * 3 + 1])) < EPS);
+
+            delete mapper;
+            delete meshA;
+            delete meshB;
+            delete a1;
+            delete b1;
+        }
+    }
+    /***********************************************************************************************
+     * \brief In the reproducible mode the mapped fields must be bitwise identical for any number of
+     *        threads, with the standard and the dual mortar mapper
+     ***********/
+    void testReproducibleAssembly() {
+        const int numThreadsBefore = AuxiliaryParameters::mapperSetNumThreads;
+        const bool reproducibleBefore = AuxiliaryParameters::reproducible;
+        AuxiliaryParameters::reproducible = true;
+        FEMesh *meshA = createSquareMesh(7);
+        FEMesh *meshB = createSquareMesh(9);
+        moveMesh(meshB);
+        DataField *a = new DataField("a", EMPIRE_DataField_atNode, meshA->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        DataField *b = new DataField("b", EMPIRE_DataField_atNode, meshB->numNodes,
+                EMPIRE_DataField_scalar, EMPIRE_DataField_field);
+        for (int i = 0; i < meshA->numNodes; i++)
+            a->data[i] = sin(3.0 * meshA->nodes[i * 3 + 0]) * cos(2.0 * meshA->nodes[i * 3 + 1]);
+        for (int dual = 0; dual < 2; dual++) {
+            vector<double> bOneThread;
+            for (int numThreads = 1; numThreads <= 4; numThreads += 3) {
+                AuxiliaryParameters::mapperSetNumThreads = numThreads;
+                MapperAdapter *mapper = new MapperAdapter("testMortarReproducible", meshA, meshB);
+                mapper->initMortarMapper(false, dual == 1, dual == 1);
+                mapper->consistentMapping(a, b);
+                if (numThreads == 1)
+                    bOneThread.assign(b->data, b->data + meshB->numNodes);
+                else
+                    for (int i = 0; i < meshB->numNodes; i++)
+                        CPPUNIT_ASSERT(b->data[i] == bOneThread[i]);
+                delete mapper;
+            }
+        }
+        AuxiliaryParameters::mapperSetNumThreads = numThreadsBefore;
+        AuxiliaryParameters::reproducible = reproducibleBefore;
+        delete meshA;
+        delete meshB;
+        delete a;
+        delete b;
+    }
     /***********************************************************************************************
      * \brief Test the memory leak of the constructor by calling it 1,000,000 times
      *        This function should not be put into the test suite except when you really want to check
@@ -241,6 +499,11 @@ public:
 CPPUNIT_TEST_SUITE( TestMortarMapper );
         CPPUNIT_TEST( compareC_BBandC_BA);
         CPPUNIT_TEST( problem1);
+        CPPUNIT_TEST( testUpdateGeometry);
+        CPPUNIT_TEST( testIterativeSolver);
+        CPPUNIT_TEST( testExplicitMappingOperator);
+        CPPUNIT_TEST( testDifferentElementSizes);
+        CPPUNIT_TEST( testReproducibleAssembly);
         //CPPUNIT_TEST( testMemoryLeakOfConstructor); // test memory leak, comment it except when checking memory leak
     CPPUNIT_TEST_SUITE_END();
 };
@@ -572,6 +572,23 @@ public:
             //EMPIRE::MathLibrary::printElem(tmp, polygonResult.size());
             CPPUNIT_ASSERT(fabs(EMPIRE::MathLibrary::computePolygonArea(tmp, polygonResult.size())-0.0)<EPS);
         }
+        { // all points of the triangle are outside of the right edge of the window
+            double window[] = { 0, 0, 0, 2, 0, 0, 2, 2, 0, 0, 2, 0 };
+            double triangle[] = { 3, 1, 0, 4, 1, 0, 3, 3, 0 };
+            PolygonClipper clipper(window, 4, 2);
+            double inner[] = { 1, 1, 0 };
+            CPPUNIT_ASSERT(clipper.computeOutsideCode(inner) == 0);
+            CPPUNIT_ASSERT(clipper.computeOutsideCode(&triangle[0]) == 2);
+            CPPUNIT_ASSERT(clipper.computeOutsideCode(&triangle[6]) == 6);
+            int commonOutsideCode = ~0;
+            for (int i = 0; i < 3; i++)
+                commonOutsideCode &= clipper.computeOutsideCode(&triangle[i * 3]);
+            CPPUNIT_ASSERT(commonOutsideCode == 2);
+            vector<double*> polygonResult;
+            CPPUNIT_ASSERT(!clipper.clip(triangle, 3, &polygonResult));
+            for (int i = 0; i < polygonResult.size(); i++)
+                delete[] polygonResult[i];
+        }
         /*{ // test memory leak, comment it except when checking memory leak
          for (int i = 0; i < 10000000; i++) {
          double window[] = { 2.0 / 30.0, 0, 0, 0.1, 0, 0, 0.1, 0, 0.1, 2.0 / 30.0, 0, 0.1 };
@@ -588,6 +605,47 @@ public:
          }
          }*/
     }
+    void testClippingWithoutAllocation() {
+        // windows and polygons overlapping partly, fully, touching at a point and not at all
+        const int NUM = 5;
+        double windows[NUM][12] = { { 0, 0, 0, 2, 0, 0, 2, 2, 0, 0, 2, 0 }, //
+                { 0, 0, 0, 2, 0, 0, 2, 2, 0, 0, 2, 0 }, //
+                { 0, 0, 0, 2, 0, 0, 1, 2, 0 }, //
+                { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 }, //
+                { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 } };
+        int sizeWindows[NUM] = { 4, 4, 3, 4, 4 };
+        double polygons[NUM][12] = { { 1, 1, 0, 3, 1, 0, 1, 3, 0 }, //
+                { -1, 1, 0, 1, -1, 0, 3, 1, 0, 1, 3, 0 }, //
+                { -1, 0.5, 0, 3, 0.5, 0, 3, 1.5, 0, -1, 1.5, 0 }, //
+                { 1, 1, 0, 2, 1, 0, 2, 2, 0, 1, 2, 0 }, //
+                { 3, 3, 0, 4, 3, 0, 4, 4, 0 } };
+        int sizePolygons[NUM] = { 3, 4, 4, 4, 3 };
+        for (int k = 0; k < NUM; k++) {
+            PolygonClipper clipper(windows[k], sizeWindows[k], 2);
+            vector<double*> polygonResult;
+            bool overlap = clipper.clip(polygons[k], sizePolygons[k], &polygonResult);
+            double fixedResult[PolygonClipper::MAX_SIZE_CLIPPED_POLYGON * 3];
+            int sizeFixedResult;
+            bool fixedOverlap = clipper.clip(polygons[k], sizePolygons[k], fixedResult,
+                    sizeFixedResult);
+            CPPUNIT_ASSERT(overlap == fixedOverlap);
+            CPPUNIT_ASSERT(sizeFixedResult == (int) polygonResult.size());
+            for (int i = 0; i < sizeFixedResult; i++)
+                for (int j = 0; j < 3; j++)
+                    CPPUNIT_ASSERT(fixedResult[i * 3 + j] == polygonResult[i][j]);
+            for (int i = 0; i < polygonResult.size(); i++)
+                delete[] polygonResult[i];
+        }
+        // two quadrilaterals rotated against each other give an octagon
+        double window[] = { 0, 0, 0, 2, 0, 0, 2, 2, 0, 0, 2, 0 };
+        double diamond[] = { 1, -0.4, 0, 2.4, 1, 0, 1, 2.4, 0, -0.4, 1, 0 };
+        PolygonClipper clipper(window, 4, 2);
+        double fixedResult[PolygonClipper::MAX_SIZE_CLIPPED_POLYGON * 3];
+        int sizeFixedResult;
+        CPPUNIT_ASSERT(clipper.clip(diamond, 4, fixedResult, sizeFixedResult));
+        CPPUNIT_ASSERT(sizeFixedResult == 8);
+        CPPUNIT_ASSERT(fabs(computePolygonArea(fixedResult, 8) - (4.0 - 4 * 0.5 * 0.6 * 0.6)) < 1e-10);
+    }
     void testComputeLocalCoorInQuad() { // data come from some big test
         double quad[12] = { 0.587856, 0.249597, 0.768143, 0.587862, 0.65312, 0.474549, 0.866025,
                 0.404234, 0.293715, 0.866025, 0.154482, 0.475424 };
@@ -616,6 +674,7 @@ CPPUNIT_TEST_SUITE( TestMortarMath );
         CPPUNIT_TEST(testComputeElemNormal);
         CPPUNIT_TEST(testLinearAlgebra);
         CPPUNIT_TEST(testClipping);
+        CPPUNIT_TEST(testClippingWithoutAllocation);
         //CPPUNIT_TEST(testComputeLocalCoorInQuad);
     CPPUNIT_TEST_SUITE_END();
 };
@@ -0,0 +1,153 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "flann/flann.hpp"
+#include "MultilevelNeighborSearch.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Stores the distances of the neighbors found by MultilevelNeighborSearch
+ ***********/
+class DistanceVisitor : public MultilevelNeighborSearch::Visitor {
+public:
+    DistanceVisitor(const double *_nodesA, const double *_points, int _numNeighbors,
+            int numPoints) :
+            nodesA(_nodesA), points(_points), numNeighbors(_numNeighbors),
+            distances(numPoints * _numNeighbors, -1.0) {
+    }
+    void visit(int point, const int *neighbors, int _numNeighbors) {
+        CPPUNIT_ASSERT(_numNeighbors == numNeighbors);
+        for (int j = 0; j < numNeighbors; j++) {
+            double d = 0.0;
+            for (int k = 0; k < 3; k++)
+                d += (nodesA[neighbors[j] * 3 + k] - points[point * 3 + k])
+                        * (nodesA[neighbors[j] * 3 + k] - points[point * 3 + k]);
+            distances[point * numNeighbors + j] = d;
+        }
+    }
+    const double *nodesA;
+    const double *points;
+    int numNeighbors;
+    vector<double> distances;
+};
+
+/********//**
+ * \brief Test the class MultilevelNeighborSearch against searching every point by brute force
+ ***********/
+class TestMultilevelNeighborSearch: public CppUnit::TestFixture {
+private:
+    /***********************************************************************************************
+     * \brief Create points scattered on a curved surface over the square [0, 1]^2
+     ***********/
+    static vector<double> createPoints(int numPoints, double seed) {
+        vector<double> points(numPoints * 3);
+        for (int i = 0; i < numPoints; i++) {
+            double x = fmod(i * 0.6180339887 + seed, 1.0);
+            double y = fmod(i * 0.7548776662 + 0.5 * seed, 1.0);
+            points[i * 3 + 0] = x;
+            points[i * 3 + 1] = y;
+            points[i * 3 + 2] = 0.2 * sin(3.0 * x) * y;
+        }
+        return points;
+    }
+    /***********************************************************************************************
+     * \brief Search every second point and compare the distances to the ones of a brute force search
+     ***********/
+    static void compare(const vector<double> &nodesA, const vector<double> &points,
+            int numNeighbors) {
+        int numNodesA = nodesA.size() / 3;
+        int numPoints = points.size() / 3;
+        flann::Matrix<double> nodesAFlann(const_cast<double*>(&nodesA[0]), numNodesA, 3);
+        flann::Index<flann::L2<double> > treeA(nodesAFlann, flann::KDTreeSingleIndexParams(1));
+        treeA.buildIndex();
+        vector<int> queries;
+        for (int i = 0; i < numPoints; i += 2)
+            queries.push_back(i);
+
+        MultilevelNeighborSearch search(numNodesA, &nodesA[0], &treeA);
+        DistanceVisitor visitor(&nodesA[0], &points[0], numNeighbors, numPoints);
+        search.search(&points[0], queries, numNeighbors, 2, visitor);
+
+        vector<double> distances(numNodesA);
+        for (int i = 0; i < numPoints; i++) {
+            if (i % 2 == 1) { // not searched
+                CPPUNIT_ASSERT(visitor.distances[i * numNeighbors] == -1.0);
+                continue;
+            }
+            for (int j = 0; j < numNodesA; j++) {
+                distances[j] = 0.0;
+                for (int k = 0; k < 3; k++)
+                    distances[j] += (nodesA[j * 3 + k] - points[i * 3 + k])
+                            * (nodesA[j * 3 + k] - points[i * 3 + k]);
+            }
+            sort(distances.begin(), distances.end());
+            for (int j = 0; j < numNeighbors; j++)
+                CPPUNIT_ASSERT(fabs(visitor.distances[i * numNeighbors + j] - distances[j]) < 1E-14);
+        }
+    }
+
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Many points searching few nodes
+     ***********/
+    void testFinePoints() {
+        compare(createPoints(50, 0.1), createPoints(3000, 0.3), 10);
+    }
+    /***********************************************************************************************
+     * \brief Few points searching many nodes, the clusters are refined
+     ***********/
+    void testCoarsePoints() {
+        compare(createPoints(3000, 0.1), createPoints(400, 0.3), 10);
+    }
+    /***********************************************************************************************
+     * \brief All nodes are neighbors, and coinciding points
+     ***********/
+    void testAllNodes() {
+        compare(createPoints(7, 0.1), createPoints(500, 0.3), 7);
+        vector<double> nodesA(6 * 3, 0.5);
+        vector<double> points(40 * 3, 0.5);
+        compare(nodesA, points, 3);
+    }
+
+CPPUNIT_TEST_SUITE( TestMultilevelNeighborSearch );
+        CPPUNIT_TEST( testFinePoints);
+        CPPUNIT_TEST( testCoarsePoints);
+        CPPUNIT_TEST( testAllNodes);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestMultilevelNeighborSearch);
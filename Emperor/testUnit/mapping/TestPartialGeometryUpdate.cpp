@@ -0,0 +1,235 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <vector>
+
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "DataField.h"
+#include "FEMesh.h"
+#include "MapperAdapter.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Test the partial update of the nearest neighbor, barycentric interpolation and nearest
+ *        element mappers after some nodes moved: the mapping equals the one of a mapper built on
+ *        the moved meshes
+ ***********/
+class TestPartialGeometryUpdate: public CppUnit::TestFixture {
+private:
+    FEMesh *meshA;
+    FEMesh *meshB;
+    /***********************************************************************************************
+     * \brief Create a mesh of n x n quads on the square [x0, x1]^2 at height z, the nodes are
+     *        slightly disturbed to avoid ties in the searches
+     ***********/
+    static FEMesh *createGrid(int n, double x0, double x1, double z) {
+        FEMesh *mesh = new FEMesh("", (n + 1) * (n + 1), n * n);
+        for (int i = 0; i < n * n; i++)
+            mesh->numNodesPerElem[i] = 4;
+        mesh->initElems();
+        double h = (x1 - x0) / n;
+        for (int j = 0; j <= n; j++) {
+            for (int i = 0; i <= n; i++) {
+                int node = j * (n + 1) + i;
+                mesh->nodeIDs[node] = node + 1;
+                mesh->nodes[node * 3 + 0] = x0 + i * h + 0.01 * h * sin(node * 1.3);
+                mesh->nodes[node * 3 + 1] = x0 + j * h + 0.01 * h * cos(node * 0.7);
+                mesh->nodes[node * 3 + 2] = z;
+            }
+        }
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < n; i++) {
+                int *elem = &(mesh->elems[(j * n + i) * 4]);
+                elem[0] = j * (n + 1) + i + 1;
+                elem[1] = elem[0] + 1;
+                elem[2] = elem[1] + n + 1;
+                elem[3] = elem[0] + n + 1;
+            }
+        }
+        return mesh;
+    }
+    /***********************************************************************************************
+     * \brief Copy a mesh with other nodes
+     ***********/
+    static FEMesh *copyWithNodes(const FEMesh *mesh, const vector<double> &nodes) {
+        FEMesh *copy = new FEMesh("", mesh->numNodes, mesh->numElems);
+        for (int i = 0; i < mesh->numElems; i++)
+            copy->numNodesPerElem[i] = mesh->numNodesPerElem[i];
+        copy->initElems();
+        for (int i = 0; i < mesh->numNodes; i++)
+            copy->nodeIDs[i] = mesh->nodeIDs[i];
+        for (int i = 0; i < mesh->numNodes * 3; i++)
+            copy->nodes[i] = nodes[i];
+        for (int i = 0; i < mesh->elemsArraySize; i++)
+            copy->elems[i] = mesh->elems[i];
+        return copy;
+    }
+    /***********************************************************************************************
+     * \brief Move the nodes within radius of a center by a smooth bump
+     ***********/
+    static vector<double> moveBump(const FEMesh *mesh, double cx, double cy, double radius,
+            double amplitude) {
+        vector<double> nodes(mesh->nodes, mesh->nodes + mesh->numNodes * 3);
+        for (int i = 0; i < mesh->numNodes; i++) {
+            double dx = nodes[i * 3] - cx;
+            double dy = nodes[i * 3 + 1] - cy;
+            double r = sqrt(dx * dx + dy * dy) / radius;
+            if (r >= 1.0)
+                continue;
+            double bump = amplitude * (1.0 - r * r);
+            nodes[i * 3 + 0] += bump * dy;
+            nodes[i * 3 + 1] -= bump * dx;
+            nodes[i * 3 + 2] += 0.5 * bump;
+        }
+        return nodes;
+    }
+    /***********************************************************************************************
+     * \brief Initialize a mapper of the given type
+     ***********/
+    static MapperAdapter *createMapper(int type, FEMesh *a, FEMesh *b) {
+        MapperAdapter *mapper = new MapperAdapter("", a, b);
+        if (type == 0)
+            mapper->initNearestNeighborMapper();
+        else if (type == 1)
+            mapper->initBarycentricInterpolationMapper();
+        else
+            mapper->initNearestElementMapper();
+        return mapper;
+    }
+    /***********************************************************************************************
+     * \brief Compare the consistent and the conservative mapping of two mappers
+     ***********/
+    static void assertSameMapping(MapperAdapter *mapper, MapperAdapter *reference, int numNodesA,
+            int numNodesB) {
+        DataField fieldA("", EMPIRE_DataField_atNode, numNodesA, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        DataField fieldB("", EMPIRE_DataField_atNode, numNodesB, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        DataField referenceA("", EMPIRE_DataField_atNode, numNodesA, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        DataField referenceB("", EMPIRE_DataField_atNode, numNodesB, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        for (int i = 0; i < numNodesA; i++)
+            fieldA.data[i] = sin(i * 0.1) + i;
+        mapper->consistentMapping(&fieldA, &fieldB);
+        reference->consistentMapping(&fieldA, &referenceB);
+        for (int i = 0; i < numNodesB; i++)
+            CPPUNIT_ASSERT(fabs(fieldB.data[i] - referenceB.data[i]) < 1e-10);
+        for (int i = 0; i < numNodesB; i++)
+            fieldB.data[i] = cos(i * 0.3) + 2.0 * i;
+        mapper->conservativeMapping(&fieldB, &fieldA);
+        reference->conservativeMapping(&fieldB, &referenceA);
+        for (int i = 0; i < numNodesA; i++)
+            CPPUNIT_ASSERT(fabs(fieldA.data[i] - referenceA.data[i]) < 1e-10);
+    }
+
+public:
+    void setUp() {
+        meshA = createGrid(12, 0.0, 1.0, 0.0);
+        meshB = createGrid(9, 0.03, 0.97, 0.02);
+    }
+    void tearDown() {
+        delete meshA;
+        delete meshB;
+    }
+    /***********************************************************************************************
+     * \brief Move parts of both meshes, update the mappers and compare them with new mappers
+     ***********/
+    void testUpdateEqualsRebuild() {
+        for (int type = 0; type < 3; type++) {
+            tearDown();
+            setUp();
+            MapperAdapter *mapper = createMapper(type, meshA, meshB);
+            for (int step = 1; step <= 2; step++) {
+                vector<double> nodesA = moveBump(meshA, 0.3, 0.35, 0.25, 0.2 * step);
+                vector<double> nodesB = moveBump(meshB, 0.7, 0.6, 0.2, -0.15 * step);
+                CPPUNIT_ASSERT(mapper->updateGeometry(&nodesA[0], &nodesB[0]));
+                for (int i = 0; i < meshA->numNodes * 3; i++)
+                    CPPUNIT_ASSERT(meshA->nodes[i] == nodesA[i]);
+
+                FEMesh *movedA = copyWithNodes(meshA, nodesA);
+                FEMesh *movedB = copyWithNodes(meshB, nodesB);
+                MapperAdapter *reference = createMapper(type, movedA, movedB);
+                assertSameMapping(mapper, reference, meshA->numNodes, meshB->numNodes);
+                delete reference;
+                delete movedA;
+                delete movedB;
+            }
+            // nothing moved
+            vector<double> nodesA(meshA->nodes, meshA->nodes + meshA->numNodes * 3);
+            CPPUNIT_ASSERT(!mapper->updateGeometry(&nodesA[0], NULL));
+            delete mapper;
+        }
+    }
+    /***********************************************************************************************
+     * \brief Move mesh A by a displacement field, the mapper is updated once the nodes moved
+     *        further than the threshold
+     ***********/
+    void testMeshMotion() {
+        meshA->addDataField("displacements", EMPIRE_DataField_atNode, EMPIRE_DataField_vector,
+                EMPIRE_DataField_field);
+        DataField *displacements = meshA->getDataFieldByName("displacements");
+        vector<double> referenceNodes(meshA->nodes, meshA->nodes + meshA->numNodes * 3);
+        MapperAdapter *mapper = createMapper(0, meshA, meshB);
+        mapper->setMeshMotion("displacements", "", 0.01);
+
+        DataField fieldA("", EMPIRE_DataField_atNode, meshA->numNodes, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        DataField fieldB("", EMPIRE_DataField_atNode, meshB->numNodes, EMPIRE_DataField_scalar,
+                EMPIRE_DataField_field);
+        // below the threshold the mesh is moved, but the mapper is not updated
+        for (int i = 0; i < meshA->numNodes * 3; i++)
+            displacements->data[i] = 0.005;
+        mapper->consistentMapping(&fieldA, &fieldB);
+        for (int i = 0; i < meshA->numNodes * 3; i++)
+            CPPUNIT_ASSERT(meshA->nodes[i] == referenceNodes[i]);
+
+        vector<double> nodesA = moveBump(meshA, 0.5, 0.5, 0.3, 0.3);
+        for (int i = 0; i < meshA->numNodes * 3; i++)
+            displacements->data[i] = nodesA[i] - referenceNodes[i];
+        mapper->consistentMapping(&fieldA, &fieldB);
+        for (int i = 0; i < meshA->numNodes * 3; i++)
+            CPPUNIT_ASSERT(fabs(meshA->nodes[i] - nodesA[i]) < 1e-14);
+
+        FEMesh *movedA = copyWithNodes(meshA, vector<double>(meshA->nodes,
+                meshA->nodes + meshA->numNodes * 3));
+        MapperAdapter *reference = createMapper(0, movedA, meshB);
+        assertSameMapping(mapper, reference, meshA->numNodes, meshB->numNodes);
+        delete reference;
+        delete movedA;
+        delete mapper;
+    }
+
+CPPUNIT_TEST_SUITE( TestPartialGeometryUpdate );
+        CPPUNIT_TEST( testUpdateEqualsRebuild);
+        CPPUNIT_TEST( testMeshMotion);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestPartialGeometryUpdate);
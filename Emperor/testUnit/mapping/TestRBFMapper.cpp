@@ -0,0 +1,149 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <vector>
+
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "RBFMapper.h"
+
+using namespace std;
+
+namespace EMPIRE {
+
+/********//**
+ * \brief Test the class RBFMapper on two non-matching grids of a slightly curved surface
+ ***********/
+class TestRBFMapper: public CppUnit::TestFixture {
+private:
+    vector<double> nodesA;
+    vector<double> nodesB;
+    /***********************************************************************************************
+     * \brief Create the nodes of an (n+1) x (n+1) grid on the square [x0, x1]^2, the nodes are
+     *        slightly disturbed and lie on a curved surface lifted by z
+     ***********/
+    static vector<double> createGrid(int n, double x0, double x1, double z) {
+        vector<double> nodes;
+        double h = (x1 - x0) / n;
+        for (int j = 0; j <= n; j++) {
+            for (int i = 0; i <= n; i++) {
+                int node = j * (n + 1) + i;
+                double x = x0 + i * h + 0.05 * h * sin(node * 1.3);
+                double y = x0 + j * h + 0.05 * h * cos(node * 0.7);
+                nodes.push_back(x);
+                nodes.push_back(y);
+                nodes.push_back(z + 0.1 * x * y);
+            }
+        }
+        return nodes;
+    }
+    /***********************************************************************************************
+     * \brief A smooth field
+     ***********/
+    static double smoothField(const double *x) {
+        return sin(2.0 * x[0]) + cos(3.0 * x[1]) + x[2];
+    }
+
+public:
+    void setUp() {
+        nodesA = createGrid(20, 0.0, 1.0, 0.0);
+        nodesB = createGrid(13, 0.02, 0.98, 0.005);
+        RBFMapper::mapperSetNumThreads = 2;
+    }
+    void tearDown() {
+        RBFMapper::mapperSetNumThreads = 1;
+    }
+    /***********************************************************************************************
+     * \brief Constant fields are mapped exactly and conservative mapping keeps the sum
+     ***********/
+    void testConsistencyAndConservation() {
+        int numNodesA = nodesA.size() / 3;
+        int numNodesB = nodesB.size() / 3;
+        RBFMapper mapper(numNodesA, &nodesA[0], numNodesB, &nodesB[0], 20);
+        mapper.buildCouplingMatrices();
+        CPPUNIT_ASSERT(mapper.getNumPatches() > 1);
+        CPPUNIT_ASSERT(mapper.getNumPatches() < numNodesA);
+
+        vector<double> fieldA(numNodesA, 3.0);
+        vector<double> fieldB(numNodesB);
+        mapper.consistentMapping(&fieldA[0], &fieldB[0]);
+        for (int i = 0; i < numNodesB; i++)
+            CPPUNIT_ASSERT(fabs(fieldB[i] - 3.0) < 1e-10);
+
+        double sumB = 0.0;
+        for (int i = 0; i < numNodesB; i++) {
+            fieldB[i] = sin(i * 0.3) + 2.0;
+            sumB += fieldB[i];
+        }
+        mapper.conservativeMapping(&fieldB[0], &fieldA[0]);
+        double sumA = 0.0;
+        for (int i = 0; i < numNodesA; i++)
+            sumA += fieldA[i];
+        CPPUNIT_ASSERT(fabs(sumA - sumB) < 1e-10 * fabs(sumB));
+    }
+    /***********************************************************************************************
+     * \brief A smooth field is interpolated accurately, also by the block mapping
+     ***********/
+    void testSmoothField() {
+        int numNodesA = nodesA.size() / 3;
+        int numNodesB = nodesB.size() / 3;
+        RBFMapper mapper(numNodesA, &nodesA[0], numNodesB, &nodesB[0], 20);
+        mapper.buildCouplingMatrices();
+        vector<double> fieldA(numNodesA * 2);
+        for (int i = 0; i < numNodesA; i++) {
+            fieldA[i * 2] = smoothField(&nodesA[i * 3]);
+            fieldA[i * 2 + 1] = -fieldA[i * 2];
+        }
+        vector<double> fieldB(numNodesB * 2);
+        mapper.consistentBlockMapping(&fieldA[0], &fieldB[0], 2);
+        for (int i = 0; i < numNodesB; i++) {
+            CPPUNIT_ASSERT(fabs(fieldB[i * 2] - smoothField(&nodesB[i * 3])) < 2e-2);
+            CPPUNIT_ASSERT(fabs(fieldB[i * 2 + 1] + fieldB[i * 2]) < 1e-14);
+        }
+    }
+    /***********************************************************************************************
+     * \brief Fewer nodes of A than nodes per patch give a single patch
+     ***********/
+    void testFewNodes() {
+        double fewNodesA[] = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+        int numNodesB = nodesB.size() / 3;
+        RBFMapper mapper(4, fewNodesA, numNodesB, &nodesB[0], 20);
+        mapper.buildCouplingMatrices();
+        CPPUNIT_ASSERT(mapper.getNumPatches() == 1);
+        double fieldA[] = { -1.5, -1.5, -1.5, -1.5 };
+        vector<double> fieldB(numNodesB);
+        mapper.consistentMapping(fieldA, &fieldB[0]);
+        for (int i = 0; i < numNodesB; i++)
+            CPPUNIT_ASSERT(fabs(fieldB[i] + 1.5) < 1e-10);
+    }
+
+CPPUNIT_TEST_SUITE( TestRBFMapper );
+        CPPUNIT_TEST( testConsistencyAndConservation);
+        CPPUNIT_TEST( testSmoothField);
+        CPPUNIT_TEST( testFewNodes);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestRBFMapper);
@@ -0,0 +1,104 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifdef USE_ADIOS2
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "ADIOS2StreamIO.h"
+#include <adios2.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the ADIOS2 result stream
+ ***********/
+class TestADIOS2StreamIO: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: write steps of a mesh with nodal data by the BP5 file engine, which is
+     *        read like an SST stream, and read them back step by step
+     ***********/
+    void writeRead() {
+        const int numNodes = 4;
+        const double nodes[] = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0 };
+        const int nodeIDs[] = { 1, 2, 3, 5 };
+        const int numElems = 1;
+        const int numNodesPerElem[] = { 4 };
+        const int elems[] = { 1, 2, 3, 5 };
+        const int elemIDs[] = { 1 };
+        const int numSteps = 3;
+        string streamName("ADIOS2StreamIO_unittest_output.bp");
+        {
+            ADIOS2StreamIO::Writer writer(streamName, "BP5", 1);
+            writer.writeFEMesh(numNodes, nodes, nodeIDs, numElems, numNodesPerElem, elems,
+                    elemIDs);
+            for (int step = 1; step <= numSteps; step++) {
+                writer.beginStep(step);
+                double nodalData[numNodes];
+                for (int i = 0; i < numNodes; i++)
+                    nodalData[i] = step * 100.0 + i;
+                writer.appendData("nodal data", step, true, 1, numNodes, nodalData);
+                writer.endStep();
+            }
+        }
+        adios2::ADIOS adios;
+        adios2::IO io = adios.DeclareIO("reader");
+        io.SetEngine("BP5");
+        adios2::Engine reader = io.Open(streamName, adios2::Mode::Read);
+        int numReadSteps = 0;
+        while (reader.BeginStep() == adios2::StepStatus::OK) {
+            numReadSteps++;
+            int step = 0;
+            reader.Get(io.InquireVariable<int>("step"), step, adios2::Mode::Sync);
+            CPPUNIT_ASSERT(step == numReadSteps);
+            vector<double> nodalData;
+            reader.Get(io.InquireVariable<double>("results/nodal data"), nodalData,
+                    adios2::Mode::Sync);
+            CPPUNIT_ASSERT(nodalData.size() == numNodes);
+            CPPUNIT_ASSERT(nodalData[3] == step * 100.0 + 3);
+            vector<int> elemNodePositions;
+            reader.Get(io.InquireVariable<int>("mesh/elems"), elemNodePositions,
+                    adios2::Mode::Sync);
+            CPPUNIT_ASSERT(elemNodePositions.size() == 4 && elemNodePositions[3] == 3);
+            reader.EndStep();
+        }
+        reader.Close();
+        CPPUNIT_ASSERT(numReadSteps == numSteps);
+    }
+
+CPPUNIT_TEST_SUITE( TestADIOS2StreamIO );
+        CPPUNIT_TEST( writeRead);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestADIOS2StreamIO);
+#endif /* USE_ADIOS2 */
@@ -0,0 +1,114 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "AsyncOutputWriter.h"
+
+#include <vector>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Output task which records the order of execution
+ ***********/
+class RecordingOutputTask: public AbstractOutputTask {
+public:
+    RecordingOutputTask(vector<int> &_executed, int _id) :
+            executed(_executed), id(_id) {
+    }
+    void execute() {
+        executed.push_back(id);
+    }
+private:
+    vector<int> &executed;
+    int id;
+};
+
+/********//**
+ * \brief Test the class AsyncOutputWriter
+ ***********/
+class TestAsyncOutputWriter: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: all tasks are executed in the order they are pushed, for different queue
+     *        depths (0 is synchronous)
+     ***********/
+    void testOrderAndFlush() {
+        const int NUM_TASKS = 100;
+        const int depths[] = { 0, 1, 4 };
+        for (int d = 0; d < 3; d++) {
+            vector<int> executed;
+            AsyncOutputWriter writer(depths[d]);
+            CPPUNIT_ASSERT(writer.isAsynchronous() == (depths[d] > 0));
+            for (int i = 0; i < NUM_TASKS; i++)
+                writer.push(new RecordingOutputTask(executed, i));
+            writer.flush();
+            CPPUNIT_ASSERT(executed.size() == NUM_TASKS);
+            for (int i = 0; i < NUM_TASKS; i++)
+                CPPUNIT_ASSERT(executed[i] == i);
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test case: the destructor executes the pending tasks
+     ***********/
+    void testFlushAtDestruction() {
+        vector<int> executed;
+        {
+            AsyncOutputWriter writer(8);
+            for (int i = 0; i < 5; i++)
+                writer.push(new RecordingOutputTask(executed, i));
+        }
+        CPPUNIT_ASSERT(executed.size() == 5);
+    }
+    /***********************************************************************************************
+     * \brief Test case: released buffers are reused
+     ***********/
+    void testBufferPool() {
+        AsyncOutputWriter writer(1);
+        double *buffer1 = writer.acquireBuffer(10);
+        double *buffer2 = writer.acquireBuffer(10);
+        CPPUNIT_ASSERT(buffer1 != buffer2);
+        writer.releaseBuffer(buffer1, 10);
+        CPPUNIT_ASSERT(writer.acquireBuffer(10) == buffer1);
+        double *buffer3 = writer.acquireBuffer(20);
+        CPPUNIT_ASSERT(buffer3 != buffer1 && buffer3 != buffer2);
+        writer.releaseBuffer(buffer1, 10);
+        writer.releaseBuffer(buffer2, 10);
+        writer.releaseBuffer(buffer3, 20);
+    }
+
+CPPUNIT_TEST_SUITE( TestAsyncOutputWriter );
+        CPPUNIT_TEST( testOrderAndFlush);
+        CPPUNIT_TEST( testFlushAtDestruction);
+        CPPUNIT_TEST( testBufferPool);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestAsyncOutputWriter);
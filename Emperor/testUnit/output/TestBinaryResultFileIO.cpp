@@ -0,0 +1,109 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "BinaryResultFileIO.h"
+#include "GiDFileIO.h"
+
+#include <string>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the binary result file format
+ ***********/
+class TestBinaryResultFileIO: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: write a binary result file, read it back and convert it to GiD .res
+     ***********/
+    void writeReadConvert() {
+        const int numNodes = 5;
+        const int nodeIDs[] = { 1, 2, 3, 5, 6 };
+        const int numElems = 2;
+        const int elemIDs[] = { 1, 2 };
+        const int numNodesPerElem[] = { 4, 3 };
+        const int numSteps = 3;
+        string binFileName("BinaryResultFileIO_unittest_output.bin");
+        {
+            BinaryResultFileIO::Writer writer(binFileName, numNodes, nodeIDs, numElems, elemIDs,
+                    numNodesPerElem);
+            for (int step = 1; step <= numSteps; step++) {
+                double nodalData[numNodes * 3];
+                for (int i = 0; i < numNodes * 3; i++)
+                    nodalData[i] = step * 100.0 + i;
+                writer.appendData("nodal data", step, true, 3, numNodes, nodalData);
+                double elementalData[numElems];
+                for (int i = 0; i < numElems; i++)
+                    elementalData[i] = step * 10.0 + elemIDs[i];
+                writer.appendData("elemental data", step, false, 1, numElems, elementalData);
+            }
+        }
+        { // check read
+            BinaryResultFileIO::Reader reader(binFileName);
+            CPPUNIT_ASSERT(reader.nodeIDs.size() == numNodes);
+            CPPUNIT_ASSERT(reader.elemIDs.size() == numElems);
+            for (int i = 0; i < numNodes; i++)
+                CPPUNIT_ASSERT(reader.nodeIDs[i] == nodeIDs[i]);
+            for (int i = 0; i < numElems; i++) {
+                CPPUNIT_ASSERT(reader.elemIDs[i] == elemIDs[i]);
+                CPPUNIT_ASSERT(reader.numNodesPerElem[i] == numNodesPerElem[i]);
+            }
+            CPPUNIT_ASSERT(reader.records.size() == 2 * numSteps);
+            const BinaryResultFileIO::Record &record = reader.records[2];
+            CPPUNIT_ASSERT(record.resultName == "nodal data");
+            CPPUNIT_ASSERT(record.stepNum == 2);
+            CPPUNIT_ASSERT(record.atNode);
+            CPPUNIT_ASSERT(record.numComponents == 3);
+            CPPUNIT_ASSERT(record.numLocations == numNodes);
+            double nodalData[numNodes * 3];
+            reader.readData(record, nodalData);
+            for (int i = 0; i < numNodes * 3; i++)
+                CPPUNIT_ASSERT(nodalData[i] == 200.0 + i);
+            CPPUNIT_ASSERT(!reader.records[5].atNode);
+            CPPUNIT_ASSERT(reader.records[5].numComponents == 1);
+        }
+        { // check conversion
+            string resFileName("BinaryResultFileIO_unittest_output.res");
+            BinaryResultFileIO::convertToDotRes(binFileName, resFileName);
+            double nodalData[numNodes * 3];
+            GiDFileIO::readNodalDataFromDotRes(resFileName, "\"nodal data\"",
+                    "\"EMPIRE_CoSimulation\"", 3, "vector", numNodes, nodeIDs, nodalData);
+            for (int i = 0; i < numNodes * 3; i++)
+                CPPUNIT_ASSERT(nodalData[i] == 300.0 + i);
+        }
+    }
+
+CPPUNIT_TEST_SUITE( TestBinaryResultFileIO );
+        CPPUNIT_TEST( writeReadConvert);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestBinaryResultFileIO);
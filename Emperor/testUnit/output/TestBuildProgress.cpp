@@ -0,0 +1,114 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "BuildProgress.h"
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief Test the class BuildProgress
+ ***********/
+class TestBuildProgress: public CppUnit::TestFixture {
+private:
+    /// the name of the progress file
+    string fileName;
+public:
+    void setUp() {
+        fileName = "TestBuildProgress.txt";
+    }
+    void tearDown() {
+        BuildProgress::setInterval(60.0);
+        BuildProgress::setFile("");
+        remove(fileName.c_str());
+    }
+    /***********************************************************************************************
+     * \brief Test the line of a report
+     ***********/
+    void testFormatLine() {
+        CPPUNIT_ASSERT(BuildProgress::formatLine("stage", "elements", 25, 100, 10.0)
+                == "stage: 25 of 100 elements (25.0%), elapsed 10.0 s, 2.5 elements/s, remaining about 30.0 s");
+        CPPUNIT_ASSERT(BuildProgress::formatLine("stage", "elements", 0, 100, 10.0)
+                == "stage: 0 of 100 elements (0.0%), elapsed 10.0 s");
+        CPPUNIT_ASSERT(BuildProgress::formatLine("stage", "elements", 100, 100, 40.0)
+                == "stage: 100 of 100 elements (100.0%), elapsed 40.0 s, done");
+    }
+    /***********************************************************************************************
+     * \brief Test the reports of items counted by several threads
+     ***********/
+    void testReports() {
+        BuildProgress::setInterval(1e-9);
+        BuildProgress::setFile(fileName);
+        stringstream buffer;
+        streambuf *old = cout.rdbuf(buffer.rdbuf());
+        const int numItems = 1000;
+        {
+            BuildProgress progress("stage", "elements", numItems);
+#pragma omp parallel for num_threads(4)
+            for (int i = 0; i < numItems; i++)
+                progress.add();
+            CPPUNIT_ASSERT(progress.getNumDone() == numItems);
+        }
+        cout.rdbuf(old);
+        CPPUNIT_ASSERT(buffer.str().find("EMPIRE_INFO: stage: ") == 0);
+        // the file holds the final line only
+        ifstream file(fileName.c_str());
+        string line;
+        getline(file, line);
+        CPPUNIT_ASSERT(line.find("stage: 1000 of 1000 elements (100.0%)") == 0);
+        CPPUNIT_ASSERT(line.find(", done") != string::npos);
+        CPPUNIT_ASSERT(!getline(file, line));
+    }
+    /***********************************************************************************************
+     * \brief Test that a stage ending before the first report writes nothing
+     ***********/
+    void testShortStage() {
+        BuildProgress::setFile(fileName);
+        stringstream buffer;
+        streambuf *old = cout.rdbuf(buffer.rdbuf());
+        {
+            BuildProgress progress("stage", "elements", 10);
+            progress.add(10);
+            progress.finish();
+        }
+        cout.rdbuf(old);
+        CPPUNIT_ASSERT(buffer.str().empty());
+        CPPUNIT_ASSERT(!ifstream(fileName.c_str()).good());
+    }
+
+CPPUNIT_TEST_SUITE( TestBuildProgress );
+        CPPUNIT_TEST( testFormatLine);
+        CPPUNIT_TEST( testReports);
+        CPPUNIT_TEST( testShortStage);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestBuildProgress);
@@ -142,8 +142,156 @@ public:
     system("rm GmshFileIO_unit_output_mesh.msh");
   }
 
+  /***********************************************************************************************
+   * \brief Test case: Test read/write for Gmsh mesh in the binary .msh format 4.1. The input has
+   *        geometric entities, a point element and unsorted nodes with parametric coordinates.
+   ***********/
+  void readWriteTestBinaryMsh() {
+    const int XYZ = 3;
+    { // generate input test mesh in the binary .msh format
+      ofstream fout("GmshFileIO_unit_input_mesh_binary.msh", ios::binary);
+      CPPUNIT_ASSERT(fout);
+      fout << "$MeshFormat\n4.1 1 8\n";
+      writeBinary(fout, (int) 1);
+      fout << "\n$EndMeshFormat\n";
+      fout << "$PhysicalNames\n1\n2 1 \"surface\"\n$EndPhysicalNames\n";
+      fout << "$Entities\n";
+      const size_t numEntities[] = {1, 0, 1, 0};
+      for (int i = 0; i < 4; i++)
+        writeBinary(fout, numEntities[i]);
+      writeBinary(fout, (int) 1); // point
+      for (int i = 0; i < 3; i++)
+        writeBinary(fout, 1000.);
+      writeBinary(fout, (size_t) 0);
+      writeBinary(fout, (int) 1); // surface
+      for (int i = 0; i < 6; i++)
+        writeBinary(fout, 0.);
+      writeBinary(fout, (size_t) 1);
+      writeBinary(fout, (int) 1);
+      writeBinary(fout, (size_t) 0);
+      fout << "\n$EndEntities\n";
+      fout << "$Nodes\n";
+      const size_t nodesHeader[] = {2, 6, 1, 6};
+      for (int i = 0; i < 4; i++)
+        writeBinary(fout, nodesHeader[i]);
+      const int pointBlock[] = {0, 1, 0};
+      for (int i = 0; i < 3; i++)
+        writeBinary(fout, pointBlock[i]);
+      writeBinary(fout, (size_t) 1);
+      writeBinary(fout, (size_t) 4);
+      for (int i = 0; i < 3; i++)
+        writeBinary(fout, 1000.);
+      const int surfaceBlock[] = {2, 1, 1}; // parametric
+      for (int i = 0; i < 3; i++)
+        writeBinary(fout, surfaceBlock[i]);
+      writeBinary(fout, (size_t) 5);
+      const size_t nodeTags[] = {6, 1, 2, 3, 5};
+      for (int i = 0; i < 5; i++)
+        writeBinary(fout, nodeTags[i]);
+      const double nodeValues[] = {0.5, 1.5, 0., -1., -1., 0., 0., 0., -1., -1., 1., 0., 0., -1., -1.,
+                                   1., 1., 0., -1., -1., 0., 1., 0., -1., -1.};
+      for (int i = 0; i < 25; i++)
+        writeBinary(fout, nodeValues[i]);
+      fout << "\n$EndNodes\n";
+      fout << "$Elements\n";
+      const size_t elementsHeader[] = {3, 3, 1, 10};
+      for (int i = 0; i < 4; i++)
+        writeBinary(fout, elementsHeader[i]);
+      const int blockHeaders[][3] = {{0, 1, 15}, {2, 1, 3}, {2, 1, 2}};
+      const size_t blockValues[][5] = {{10, 4}, {1, 2, 1, 3, 5}, {2, 3, 5, 6}};
+      const int numValues[] = {2, 5, 4};
+      for (int b = 0; b < 3; b++) {
+        for (int i = 0; i < 3; i++)
+          writeBinary(fout, blockHeaders[b][i]);
+        writeBinary(fout, (size_t) 1);
+        for (int i = 0; i < numValues[b]; i++)
+          writeBinary(fout, blockValues[b][i]);
+      }
+      fout << "\n$EndElements\n";
+      fout.close();
+    }
+    { // check read
+      string inputMeshFile("GmshFileIO_unit_input_mesh_binary.msh");
+      int numNodes, numElems;
+      double *nodeCoors;
+      int *nodeIDs, *numNodesPerElem, *elemTable, *elemIDs;
+
+      GmshFileIO::readDotMsh(inputMeshFile, numNodes, numElems, nodeCoors, nodeIDs, numNodesPerElem, elemTable, elemIDs);
+
+      const int nodeIDsRef[] = {1, 2, 3, 5, 6};
+      const double nodeCoorsRef[] = {0., 0., 0., 1., 0., 0., 1., 1., 0., 0., 1., 0., 0.5, 1.5, 0.};
+      const int numNodesPerElemRef[] = {4, 3};
+      const int elemTableRef[] = { 2, 1, 3, 5, 3, 5, 6 };
+      const int elemIDsRef[] = {1, 2};
+
+      CPPUNIT_ASSERT((numNodes == 5));
+      CPPUNIT_ASSERT((numElems == 2));
+      for (int i=0; i<numNodes; i++)
+        CPPUNIT_ASSERT((nodeIDs[i] == nodeIDsRef[i]));
+      for (int i=0; i<numNodes*XYZ; i++)
+        CPPUNIT_ASSERT((nodeCoors[i] == nodeCoorsRef[i]));
+      for (int i=0; i<numElems; i++)
+        CPPUNIT_ASSERT((elemIDs[i] == elemIDsRef[i]));
+      for (int i=0; i<numElems; i++)
+        CPPUNIT_ASSERT((numNodesPerElem[i] == numNodesPerElemRef[i]));
+      for (int i=0; i<7; i++)
+        CPPUNIT_ASSERT((elemTable[i] == elemTableRef[i]));
+
+      string outputMeshFile("GmshFileIO_unit_output_mesh_binary.msh");
+      GmshFileIO::writeDotMsh(outputMeshFile, numNodes, numElems, nodeCoors, nodeIDs, numNodesPerElem, elemTable, elemIDs, true);
+      delete[] nodeCoors;
+      delete[] nodeIDs;
+      delete[] numNodesPerElem;
+      delete[] elemTable;
+      delete[] elemIDs;
+    }
+    { // check write
+      string inputMeshFile("GmshFileIO_unit_output_mesh_binary.msh");
+      int numNodes, numElems;
+      double *nodeCoors;
+      int *nodeIDs, *numNodesPerElem, *elemTable, *elemIDs;
+
+      GmshFileIO::readDotMsh(inputMeshFile, numNodes, numElems, nodeCoors, nodeIDs, numNodesPerElem, elemTable, elemIDs);
+
+      const int nodeIDsRef[] = {1, 2, 3, 5, 6};
+      const double nodeCoorsRef[] = {0., 0., 0., 1., 0., 0., 1., 1., 0., 0., 1., 0., 0.5, 1.5, 0.};
+      const int numNodesPerElemRef[] = {3, 4};
+      const int elemTableRef[] = { 3, 5, 6, 2, 1, 3, 5 };
+      const int elemIDsRef[] = {2, 1};
+
+      CPPUNIT_ASSERT((numNodes == 5));
+      CPPUNIT_ASSERT((numElems == 2));
+      for (int i=0; i<numNodes; i++)
+        CPPUNIT_ASSERT((nodeIDs[i] == nodeIDsRef[i]));
+      for (int i=0; i<numNodes*XYZ; i++)
+        CPPUNIT_ASSERT((nodeCoors[i] == nodeCoorsRef[i]));
+      for (int i=0; i<numElems; i++)
+        CPPUNIT_ASSERT((elemIDs[i] == elemIDsRef[i]));
+      for (int i=0; i<numElems; i++)
+        CPPUNIT_ASSERT((numNodesPerElem[i] == numNodesPerElemRef[i]));
+      for (int i=0; i<7; i++)
+        CPPUNIT_ASSERT((elemTable[i] == elemTableRef[i]));
+      delete[] nodeCoors;
+      delete[] nodeIDs;
+      delete[] numNodesPerElem;
+      delete[] elemTable;
+      delete[] elemIDs;
+    }
+
+    system("rm GmshFileIO_unit_input_mesh_binary.msh");
+    system("rm GmshFileIO_unit_output_mesh_binary.msh");
+  }
+  /***********************************************************************************************
+   * \brief Write the bytes of a value to a binary file
+   ***********/
+  template<typename T>
+  static void writeBinary(ofstream &fout, const T &value) {
+    fout.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
   CPPUNIT_TEST_SUITE( TestGmshFileIO );
   CPPUNIT_TEST( readWriteTestMsh );
+  CPPUNIT_TEST( readWriteTestBinaryMsh );
   CPPUNIT_TEST_SUITE_END();
 };
 
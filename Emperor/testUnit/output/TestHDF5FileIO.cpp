@@ -0,0 +1,93 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#ifdef USE_HDF5
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "HDF5FileIO.h"
+
+#include <string>
+#include <fstream>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the HDF5 result file format
+ ***********/
+class TestHDF5FileIO: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: write a mesh with nodal and elemental data, read the data back selectively
+     ***********/
+    void writeRead() {
+        const int numNodes = 5;
+        const double nodes[] = { 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 2, 0.5, 0 };
+        const int nodeIDs[] = { 1, 2, 3, 5, 6 };
+        const int numElems = 2;
+        const int numNodesPerElem[] = { 4, 3 };
+        const int elems[] = { 1, 2, 3, 5, 2, 6, 3 };
+        const int elemIDs[] = { 1, 2 };
+        const int numSteps = 3;
+        string fileName("HDF5FileIO_unittest_output");
+        {
+            HDF5FileIO::Writer writer(fileName, 4);
+            writer.writeFEMesh(numNodes, nodes, nodeIDs, numElems, numNodesPerElem, elems,
+                    elemIDs);
+            for (int step = 1; step <= numSteps; step++) {
+                double nodalData[numNodes * 3];
+                for (int i = 0; i < numNodes * 3; i++)
+                    nodalData[i] = step * 100.0 + i;
+                writer.appendData("nodal data", step, true, 3, numNodes, nodalData);
+                double elementalData[numElems];
+                for (int i = 0; i < numElems; i++)
+                    elementalData[i] = step * 10.0 + i;
+                writer.appendData("elemental data", step, false, 1, numElems, elementalData);
+            }
+        }
+        double nodalData[numNodes * 3];
+        CPPUNIT_ASSERT(HDF5FileIO::readData(fileName, "nodal data", 2, numNodes * 3, nodalData));
+        for (int i = 0; i < numNodes * 3; i++)
+            CPPUNIT_ASSERT(nodalData[i] == 200.0 + i);
+        double elementalData[numElems];
+        CPPUNIT_ASSERT(HDF5FileIO::readData(fileName, "elemental data", 3, numElems, elementalData));
+        CPPUNIT_ASSERT(elementalData[0] == 30.0 && elementalData[1] == 31.0);
+        CPPUNIT_ASSERT(!HDF5FileIO::readData(fileName, "nodal data", 4, numNodes * 3, nodalData));
+        CPPUNIT_ASSERT(!HDF5FileIO::readData(fileName, "no data", 1, numNodes * 3, nodalData));
+
+        ifstream xdmfFile((fileName + ".xdmf").c_str());
+        CPPUNIT_ASSERT(!xdmfFile.fail());
+    }
+
+CPPUNIT_TEST_SUITE( TestHDF5FileIO );
+        CPPUNIT_TEST( writeRead);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestHDF5FileIO);
+#endif /* USE_HDF5 */
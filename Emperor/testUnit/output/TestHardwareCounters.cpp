@@ -0,0 +1,101 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "HardwareCounters.h"
+#include <math.h>
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief Test the class HardwareCounters
+ ***********/
+class TestHardwareCounters: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+        HardwareCounters::close();
+    }
+    /***********************************************************************************************
+     * \brief Test the derived metrics
+     ***********/
+    void testComputeMetrics() {
+        double counts[HardwareCounters::NUM_EVENTS];
+        counts[HardwareCounters::CYCLES] = 4e9;
+        counts[HardwareCounters::INSTRUCTIONS] = 6e9;
+        counts[HardwareCounters::LLC_MISSES] = 1e8;
+        counts[HardwareCounters::FP_OPS] = 3.2e9;
+        double instructionsPerCycle, bandwidth, bytesPerFlop;
+        HardwareCounters::computeMetrics(counts, 2.0, instructionsPerCycle, bandwidth, bytesPerFlop);
+        CPPUNIT_ASSERT(fabs(instructionsPerCycle - 1.5) < 1e-12);
+        CPPUNIT_ASSERT(fabs(bandwidth - 3.2e9) < 1e-3);
+        CPPUNIT_ASSERT(fabs(bytesPerFlop - 2.0) < 1e-12);
+        // no division by zero without cycles, time and operations
+        counts[HardwareCounters::CYCLES] = 0.0;
+        counts[HardwareCounters::FP_OPS] = 0.0;
+        HardwareCounters::computeMetrics(counts, 0.0, instructionsPerCycle, bandwidth, bytesPerFlop);
+        CPPUNIT_ASSERT(instructionsPerCycle == 0.0);
+        CPPUNIT_ASSERT(bandwidth == 0.0);
+        CPPUNIT_ASSERT(bytesPerFlop == 0.0);
+    }
+    /***********************************************************************************************
+     * \brief Test reading the counters, where the machine provides them
+     ***********/
+    void testRead() {
+        double before[HardwareCounters::NUM_EVENTS];
+        double after[HardwareCounters::NUM_EVENTS];
+        bool isOpen = HardwareCounters::open(0, 2);
+        CPPUNIT_ASSERT(isOpen == HardwareCounters::isOpen());
+        // without raw event code the floating point operations are not counted
+        CPPUNIT_ASSERT(!HardwareCounters::isAvailable(HardwareCounters::FP_OPS));
+        HardwareCounters::read(before);
+        volatile double sum = 0.0;
+        for (int i = 0; i < 1000000; i++)
+            sum += sqrt((double) i);
+        HardwareCounters::read(after);
+        for (int event = 0; event < HardwareCounters::NUM_EVENTS; event++) {
+            if (HardwareCounters::isAvailable((HardwareCounters::Event) event))
+                CPPUNIT_ASSERT(after[event] >= before[event]);
+            else
+                CPPUNIT_ASSERT(after[event] == 0.0);
+        }
+        if (HardwareCounters::isAvailable(HardwareCounters::INSTRUCTIONS))
+            CPPUNIT_ASSERT(after[HardwareCounters::INSTRUCTIONS] - before[HardwareCounters::INSTRUCTIONS] > 1e6);
+        HardwareCounters::close();
+        CPPUNIT_ASSERT(!HardwareCounters::isOpen());
+        HardwareCounters::read(after);
+        for (int event = 0; event < HardwareCounters::NUM_EVENTS; event++)
+            CPPUNIT_ASSERT(after[event] == 0.0);
+    }
+
+CPPUNIT_TEST_SUITE( TestHardwareCounters );
+        CPPUNIT_TEST( testComputeMetrics);
+        CPPUNIT_TEST( testRead);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestHardwareCounters);
@@ -0,0 +1,143 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "IGATessellationIO.h"
+#include "IGAMesh.h"
+
+#include <string>
+#include <fstream>
+#include <math.h>
+#include <stdio.h>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the tessellation of IGA meshes and its VTK output
+ ***********/
+class TestIGATessellationIO: public CppUnit::TestFixture {
+private:
+    IGAMesh *theIGAMesh;
+public:
+    void setUp() {
+        // a bilinear plane patch with 3 x 2 control points at (i, j, 0)
+        theIGAMesh = new IGAMesh("IGATessellationMesh", 6);
+        double uKnotVector[] = { 0.0, 0.0, 0.5, 1.0, 1.0 };
+        double vKnotVector[] = { 0.0, 0.0, 1.0, 1.0 };
+        double controlPoints[6 * 4];
+        int dofIndexNet[6];
+        for (int j = 0; j < 2; j++) {
+            for (int i = 0; i < 3; i++) {
+                double *controlPoint = &controlPoints[(j * 3 + i) * 4];
+                controlPoint[0] = i;
+                controlPoint[1] = j;
+                controlPoint[2] = 0.0;
+                controlPoint[3] = 1.0;
+                dofIndexNet[j * 3 + i] = j * 3 + i;
+            }
+        }
+        theIGAMesh->addPatch(1, 5, uKnotVector, 1, 4, vKnotVector, 3, 2, controlPoints,
+                dofIndexNet);
+        theIGAMesh->preparePatches();
+    }
+    void tearDown() {
+        delete theIGAMesh;
+    }
+    /***********************************************************************************************
+     * \brief Test case: tessellate the patch and evaluate fields, which are linear on the patch
+     ***********/
+    void testTessellation() {
+        IGATessellationIO::Tessellation tessellation(theIGAMesh, 2);
+        // u: 0, 0.25, 0.5, 0.75, 1 and v: 0, 0.5, 1
+        CPPUNIT_ASSERT(tessellation.getNumPoints() == 15);
+        CPPUNIT_ASSERT(tessellation.getNumQuads() == 8);
+        const vector<double> &points = tessellation.getPoints();
+        for (int i = 0; i < tessellation.getNumQuads() * 4; i++)
+            CPPUNIT_ASSERT(tessellation.getQuads()[i] >= 0 && tessellation.getQuads()[i] < 15);
+
+        double scalarOnCPs[6];
+        double vectorOnCPs[6 * 3];
+        for (int j = 0; j < 2; j++) {
+            for (int i = 0; i < 3; i++) {
+                scalarOnCPs[j * 3 + i] = i;
+                vectorOnCPs[(j * 3 + i) * 3 + 0] = 2.0 * j;
+                vectorOnCPs[(j * 3 + i) * 3 + 1] = i + j;
+                vectorOnCPs[(j * 3 + i) * 3 + 2] = 1.0;
+            }
+        }
+        double scalar[15];
+        double vectorValues[15 * 3];
+        tessellation.evaluate(1, scalarOnCPs, scalar);
+        tessellation.evaluate(3, vectorOnCPs, vectorValues);
+        for (int i = 0; i < 15; i++) {
+            double x = points[i * 3];
+            double y = points[i * 3 + 1];
+            CPPUNIT_ASSERT(fabs(points[i * 3 + 2]) < 1e-14);
+            CPPUNIT_ASSERT(fabs(scalar[i] - x) < 1e-14);
+            CPPUNIT_ASSERT(fabs(vectorValues[i * 3 + 0] - 2.0 * y) < 1e-14);
+            CPPUNIT_ASSERT(fabs(vectorValues[i * 3 + 1] - x - y) < 1e-14);
+            CPPUNIT_ASSERT(fabs(vectorValues[i * 3 + 2] - 1.0) < 1e-14);
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test case: write a step as binary VTK file
+     ***********/
+    void testVTKWriter() {
+        IGATessellationIO::Tessellation tessellation(theIGAMesh, 1);
+        CPPUNIT_ASSERT(tessellation.getNumPoints() == 6);
+        string fileName("IGATessellationIO_unittest_output");
+        double scalarOnCPs[6] = { 0.0, 1.0, 2.0, 3.0, 4.0, 5.0 };
+        IGATessellationIO::VTKWriter writer(fileName, &tessellation);
+        writer.endStep(1); // no data field, no file
+        writer.appendData("scalar", 1, scalarOnCPs);
+        writer.endStep(2);
+        CPPUNIT_ASSERT(!ifstream((fileName + "_1.vtk").c_str()).good());
+        ifstream file((fileName + "_2.vtk").c_str(), ios_base::binary);
+        CPPUNIT_ASSERT(file.good());
+        string line;
+        getline(file, line);
+        CPPUNIT_ASSERT(line == "# vtk DataFile Version 3.0");
+        getline(file, line);
+        getline(file, line);
+        CPPUNIT_ASSERT(line == "BINARY");
+        getline(file, line);
+        CPPUNIT_ASSERT(line == "DATASET UNSTRUCTURED_GRID");
+        getline(file, line);
+        CPPUNIT_ASSERT(line == "POINTS 6 double");
+        // the first point is (0, 0, 0), the second one (1, 0, 0) in big endian
+        unsigned char bytes[6 * 3 * 8];
+        file.read((char*) bytes, sizeof(bytes));
+        CPPUNIT_ASSERT(bytes[24] == 0x3f && bytes[25] == 0xf0);
+        file.close();
+        remove((fileName + "_2.vtk").c_str());
+    }
+
+    CPPUNIT_TEST_SUITE( TestIGATessellationIO);
+    CPPUNIT_TEST( testTessellation);
+    CPPUNIT_TEST( testVTKWriter);
+    CPPUNIT_TEST_SUITE_END();
+};
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestIGATessellationIO);
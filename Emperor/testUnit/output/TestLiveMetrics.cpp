@@ -0,0 +1,104 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "LiveMetrics.h"
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief Test the class LiveMetrics
+ ***********/
+class TestLiveMetrics: public CppUnit::TestFixture {
+private:
+    /// the name of the metrics file
+    string fileName;
+public:
+    void setUp() {
+        fileName = "TestLiveMetrics.txt";
+    }
+    void tearDown() {
+        LiveMetrics::stop();
+        remove(fileName.c_str());
+    }
+    /***********************************************************************************************
+     * \brief Test the escaping of the labels
+     ***********/
+    void testLabel() {
+        CPPUNIT_ASSERT(LiveMetrics::label("client", "fluid") == "client=\"fluid\"");
+        CPPUNIT_ASSERT(LiveMetrics::label("client", "a\"b\\c") == "client=\"a\\\"b\\\\c\"");
+    }
+    /***********************************************************************************************
+     * \brief Test that nothing is recorded while the metrics are disabled
+     ***********/
+    void testDisabled() {
+        CPPUNIT_ASSERT(!LiveMetrics::isEnabled());
+        LiveMetrics::add(LiveMetrics::CLIENT_BYTES, LiveMetrics::label("client", "disabled"), 1.0);
+        CPPUNIT_ASSERT(LiveMetrics::format().find("disabled") == string::npos);
+    }
+    /***********************************************************************************************
+     * \brief Test counters added by several threads and gauges written to the file
+     ***********/
+    void testFile() {
+        LiveMetrics::start(fileName, 1000.0, 0);
+        CPPUNIT_ASSERT(LiveMetrics::isEnabled());
+        string labels = LiveMetrics::label("client", "structure") + ","
+                + LiveMetrics::label("direction", "send");
+#pragma omp parallel for num_threads(4)
+        for (int i = 0; i < 1000; i++)
+            LiveMetrics::add(LiveMetrics::CLIENT_BYTES, labels, 8.0);
+        LiveMetrics::set(LiveMetrics::TIME_STEP, "", 3.0);
+        LiveMetrics::set(LiveMetrics::TIME_STEP, "", 4.0);
+        LiveMetrics::stop();
+        CPPUNIT_ASSERT(!LiveMetrics::isEnabled());
+        // the file is written a last time at the stop
+        ifstream file(fileName.c_str());
+        stringstream text;
+        text << file.rdbuf();
+        CPPUNIT_ASSERT(text.str() == LiveMetrics::format());
+        CPPUNIT_ASSERT(text.str().find("# TYPE empire_client_bytes counter\n") != string::npos);
+        CPPUNIT_ASSERT(text.str().find(
+                "empire_client_bytes_total{client=\"structure\",direction=\"send\"} 8000\n")
+                != string::npos);
+        CPPUNIT_ASSERT(text.str().find("# TYPE empire_time_step gauge\n") != string::npos);
+        CPPUNIT_ASSERT(text.str().find("empire_time_step 4\n") != string::npos);
+        CPPUNIT_ASSERT(text.str().find("empire_resident_memory_bytes ") != string::npos);
+        CPPUNIT_ASSERT(text.str().rfind("# EOF\n") == text.str().size() - 6);
+    }
+
+CPPUNIT_TEST_SUITE( TestLiveMetrics );
+        CPPUNIT_TEST( testLabel);
+        CPPUNIT_TEST( testDisabled);
+        CPPUNIT_TEST( testFile);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestLiveMetrics);
@@ -23,6 +23,7 @@
 #include "cppunit/extensions/HelperMacros.h"
 
 #include "Message.h"
+#include <omp.h>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -91,8 +92,46 @@ public:
         //cout << testString2 << endl;
         CPPUNIT_ASSERT((testString2.compare("EMPIRE_INFO: Test integer text 10 TestString2\n") == 0 ) );
     }
+    /***********************************************************************************************
+     * \brief Test a sink thread in a section of a parallel region, as the coupling thread
+     ***********/
+    void testSinkThreadInSection() {
+        stringstream buffer;
+        streambuf * old = infoOut.rdbuf(buffer.rdbuf());
+        string textAtOnce, textInNestedRegion, textAfterFlush;
+#pragma omp parallel num_threads(2)
+        {
+#pragma omp sections
+            {
+#pragma omp section
+                {
+                }
+#pragma omp section
+                {
+                    Message::setSinkThread();
+                    infoOut() << "TestString3" << endl;
+                    textAtOnce = buffer.str();
+                    // a region nested in the level of the sink is buffered until the next flush
+#pragma omp parallel num_threads(1)
+                    {
+                        infoOut() << "TestString4" << endl;
+                    }
+                    textInNestedRegion = buffer.str();
+                    Message::flush();
+                    textAfterFlush = buffer.str();
+                }
+            }
+        }
+        Message::setSinkThread();
+        infoOut.rdbuf(old);
+
+        CPPUNIT_ASSERT(textAtOnce == "EMPIRE_INFO: TestString3\n");
+        CPPUNIT_ASSERT(textInNestedRegion == textAtOnce);
+        CPPUNIT_ASSERT(textAfterFlush == "EMPIRE_INFO: TestString3\nEMPIRE_INFO: TestString4\n");
+    }
     CPPUNIT_TEST_SUITE( TestMessage );
     CPPUNIT_TEST(testMessage);
+    CPPUNIT_TEST(testSinkThreadInSection);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -0,0 +1,180 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "Profiler.h"
+#include "HardwareCounters.h"
+#include "Message.h"
+#include <omp.h>
+#include <math.h>
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace EMPIRE {
+using namespace std;
+
+/// the scope timed by the coupling thread
+static const string sectionScope("section scope");
+/// the scope timed in a parallel region nested in the one of the coupling thread
+static const string nestedScope("nested scope");
+
+/***********************************************************************************************
+ * \brief Enable the profiler and time the scopes in a section of a parallel region, as the
+ *        coupling thread does in main
+ * \param[in] countHardwareEvents true to count the hardware events in the timers
+ ***********/
+static void timeScopesInSection(bool countHardwareEvents = false) {
+#pragma omp parallel num_threads(2)
+    {
+#pragma omp sections
+        {
+#pragma omp section
+            {
+            }
+#pragma omp section
+            {
+                Profiler::setEnabled(true);
+                if (countHardwareEvents)
+                    Profiler::setHardwareCounters(true, 0, 2);
+                PROFILER_SCOPE(sectionScope);
+                volatile double sum = 0.0;
+                for (int i = 0; i < 1000000; i++)
+                    sum += sqrt((double) i);
+#pragma omp parallel num_threads(1)
+                {
+                    PROFILER_SCOPE(nestedScope);
+                }
+            }
+        }
+    }
+}
+
+/********//**
+ * \brief Test the class Profiler
+ ***********/
+class TestProfiler: public CppUnit::TestFixture {
+private:
+    /// the name of the CSV file
+    string csvFileName;
+    /// the name of the trace file
+    string traceFileName;
+public:
+    void setUp() {
+        csvFileName = "TestProfiler.csv";
+        traceFileName = "TestProfiler.json";
+        Profiler::reset();
+    }
+    void tearDown() {
+        Profiler::setCSVFile("");
+        Profiler::setTraceFile("");
+        Profiler::setHardwareCounters(false, 0, 0);
+        Profiler::setEnabled(false);
+        Profiler::reset();
+        remove(csvFileName.c_str());
+        remove(traceFileName.c_str());
+    }
+    /***********************************************************************************************
+     * \brief Test the timers of a coupling thread which runs in a section of a parallel region
+     ***********/
+    void testTimerInSection() {
+        timeScopesInSection();
+
+        stringstream buffer;
+        streambuf * old = infoOut.rdbuf(buffer.rdbuf());
+        Profiler::printSummary();
+        infoOut.rdbuf(old);
+        CPPUNIT_ASSERT(buffer.str().find(sectionScope) != string::npos);
+        CPPUNIT_ASSERT(buffer.str().find(nestedScope) == string::npos);
+    }
+    /***********************************************************************************************
+     * \brief Test the CSV rows of the timers of a coupling thread in a section
+     ***********/
+    void testCSVFileInSection() {
+        Profiler::setCSVFile(csvFileName);
+        timeScopesInSection();
+        Profiler::writeTimeStep(1);
+        Profiler::writeTimeStep(2); // nothing has been timed since the last row
+        Profiler::setCSVFile("");
+
+        ifstream csvFile(csvFileName.c_str());
+        string line;
+        getline(csvFile, line);
+        CPPUNIT_ASSERT(line == "timeStep,scope,calls,time");
+        getline(csvFile, line);
+        CPPUNIT_ASSERT(line.find("1,\"section scope\",1,") == 0);
+        CPPUNIT_ASSERT(!getline(csvFile, line));
+    }
+    /***********************************************************************************************
+     * \brief Test the trace events of the timers of a coupling thread in a section
+     ***********/
+    void testTraceFileInSection() {
+        Profiler::setTraceFile(traceFileName);
+        timeScopesInSection();
+        Profiler::setTraceFile("");
+
+        ifstream traceFile(traceFileName.c_str());
+        stringstream trace;
+        trace << traceFile.rdbuf();
+        CPPUNIT_ASSERT(trace.str().find("{\"name\":\"section scope\",\"cat\":\"emperor\"")
+                != string::npos);
+        CPPUNIT_ASSERT(trace.str().find(nestedScope) == string::npos);
+    }
+    /***********************************************************************************************
+     * \brief Test the hardware events counted in the timers of a coupling thread in a section,
+     *        where the machine provides the counters
+     ***********/
+    void testHardwareCountersInSection() {
+        timeScopesInSection(true);
+        if (!HardwareCounters::isAvailable(HardwareCounters::INSTRUCTIONS))
+            return;
+
+        stringstream buffer;
+        streambuf * old = infoOut.rdbuf(buffer.rdbuf());
+        Profiler::printSummary();
+        infoOut.rdbuf(old);
+        // the row of the scope in the table of the counters: name, Gcycles, Ginstr, ...
+        string summary = buffer.str();
+        size_t table = summary.find("Hardware counters per scope name");
+        CPPUNIT_ASSERT(table != string::npos);
+        size_t row = summary.find(sectionScope, table);
+        CPPUNIT_ASSERT(row != string::npos);
+        stringstream line(summary.substr(row + sectionScope.size()));
+        double gigaCycles, gigaInstructions;
+        line >> gigaCycles >> gigaInstructions;
+        CPPUNIT_ASSERT(gigaInstructions > 0.0);
+    }
+
+    CPPUNIT_TEST_SUITE( TestProfiler);
+        CPPUNIT_TEST( testTimerInSection);
+        CPPUNIT_TEST( testCSVFileInSection);
+        CPPUNIT_TEST( testTraceFileInSection);
+        CPPUNIT_TEST( testHardwareCountersInSection);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestProfiler);
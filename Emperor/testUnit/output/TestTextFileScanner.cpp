@@ -0,0 +1,129 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "TextFileScanner.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the scanners used to parse GiD files
+ ***********/
+class TestTextFileScanner: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: read integers
+     ***********/
+    void testScanInt() {
+        string text(" 12\t-345 +6 x");
+        const char *end = text.c_str() + text.size();
+        int value;
+        const char *p = TextFileScanner::scanInt(text.c_str(), end, value);
+        CPPUNIT_ASSERT(p != NULL && value == 12);
+        p = TextFileScanner::scanInt(p, end, value);
+        CPPUNIT_ASSERT(p != NULL && value == -345);
+        p = TextFileScanner::scanInt(p, end, value);
+        CPPUNIT_ASSERT(p != NULL && value == 6);
+        CPPUNIT_ASSERT(TextFileScanner::scanInt(p, end, value) == NULL);
+    }
+    /***********************************************************************************************
+     * \brief Test case: read doubles, the values must be identical to the ones of strtod
+     ***********/
+    void testScanDouble() {
+        const char *numbers[] = { "0", "-0.0", "1", "0.5", "1.5e3", "-2.25E-2", "3.14159265358979",
+                "1.7976931348623157e308", "4.9e-324", "2.2250738585072014e-308",
+                "0.1000000000000000055511151231257827", "123456789012345678901234567890",
+                "1e-400", "1e400", "9007199254740993", "-.75", "5." };
+        int numNumbers = sizeof(numbers) / sizeof(numbers[0]);
+        for (int i = 0; i < numNumbers; i++) {
+            string text(numbers[i]);
+            text.append(" 1\n");
+            const char *end = text.c_str() + text.size();
+            double value;
+            const char *p = TextFileScanner::scanDouble(text.c_str(), end, value);
+            CPPUNIT_ASSERT(p != NULL && *p == ' ');
+            double reference = strtod(numbers[i], NULL);
+            CPPUNIT_ASSERT(memcmp(&value, &reference, sizeof(double)) == 0);
+        }
+        srand(1);
+        for (int i = 0; i < 10000; i++) {
+            char text[64];
+            double number = (rand() - RAND_MAX / 2) * 1e-6 * (rand() % 1000);
+            sprintf(text, (i % 2 == 0) ? "%.17g" : "%.6e", number);
+            double value;
+            CPPUNIT_ASSERT(TextFileScanner::scanDouble(text, text + strlen(text), value) != NULL);
+            double reference = strtod(text, NULL);
+            CPPUNIT_ASSERT(value == reference);
+        }
+        string text("  end");
+        double value;
+        CPPUNIT_ASSERT(TextFileScanner::scanDouble(text.c_str(), text.c_str() + text.size(), value) == NULL);
+    }
+    /***********************************************************************************************
+     * \brief Test case: map a file, split it into lines and compare keywords
+     ***********/
+    void testMappedFile() {
+        string fileName("TextFileScanner_unittest_output.txt");
+        {
+            ofstream file(fileName.c_str());
+            file << "MESH dimension 3\n  End Coordinates\r\nmeshes\nlast";
+        }
+        {
+            TextFileScanner::MappedFile file(fileName);
+            CPPUNIT_ASSERT(file.isOpen());
+            vector<const char*> lineBegins;
+            TextFileScanner::splitLines(file.begin(), file.end(), lineBegins);
+            CPPUNIT_ASSERT(lineBegins.size() == 4);
+            CPPUNIT_ASSERT(TextFileScanner::wordEquals(lineBegins[0], file.end(), "mesh"));
+            CPPUNIT_ASSERT(TextFileScanner::wordEquals(lineBegins[1], file.end(), "end"));
+            CPPUNIT_ASSERT(!TextFileScanner::wordEquals(lineBegins[2], file.end(), "mesh"));
+            CPPUNIT_ASSERT(TextFileScanner::wordEquals(lineBegins[3], file.end(), "last"));
+            CPPUNIT_ASSERT(TextFileScanner::endOfLine(lineBegins[3], file.end()) == file.end());
+        }
+        remove(fileName.c_str());
+        TextFileScanner::MappedFile missingFile("TextFileScanner_unittest_missing.txt");
+        CPPUNIT_ASSERT(!missingFile.isOpen());
+    }
+
+CPPUNIT_TEST_SUITE( TestTextFileScanner );
+        CPPUNIT_TEST( testScanInt);
+        CPPUNIT_TEST( testScanDouble);
+        CPPUNIT_TEST( testMappedFile);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestTextFileScanner);
@@ -0,0 +1,116 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <vector>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "BlockSparseMatrix.h"
+
+namespace EMPIRE {
+using namespace std;
+using namespace MathLibrary;
+
+/********//**
+ * \brief This class manages tests of the BlockSparseMatrix
+ **************************************************************************************************/
+class TestBlockSparseMatrix: public CppUnit::TestFixture {
+public:
+    void setUp() {
+        // a 9 x 12 scalar matrix, the block (1, *) is empty and some blocks are partly filled
+        dense.assign(NUM_ROWS * NUM_COLS, 0.0);
+        rowPtr.assign(1, 0);
+        cols.clear();
+        vals.clear();
+        for (int i = 0; i < NUM_ROWS; i++) {
+            for (int j = 0; j < NUM_COLS; j++) {
+                if (i / 3 != 1 && (2 * i + j) % 5 < 2) {
+                    dense[i * NUM_COLS + j] = 0.5 + i - 0.25 * j;
+                    cols.push_back(j);
+                    vals.push_back(dense[i * NUM_COLS + j]);
+                }
+            }
+            rowPtr.push_back(cols.size());
+        }
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Compare the products with the products of the dense matrix
+     ***********/
+    void testMultiply() {
+        BlockSparseMatrix matrix(NUM_ROWS / 3, NUM_COLS / 3, 2);
+        matrix.setCSR(rowPtr, cols, vals);
+        CPPUNIT_ASSERT(matrix.getBlockRowPtr()[2] - matrix.getBlockRowPtr()[1] == 0);
+        double x[NUM_COLS], y[NUM_ROWS];
+        for (int j = 0; j < NUM_COLS; j++)
+            x[j] = cos(1.0 + j);
+        matrix.multiply(false, x, y);
+        for (int i = 0; i < NUM_ROWS; i++) {
+            double ref = 0.0;
+            for (int j = 0; j < NUM_COLS; j++)
+                ref += dense[i * NUM_COLS + j] * x[j];
+            CPPUNIT_ASSERT(fabs(y[i] - ref) < 1E-12);
+        }
+        double xT[NUM_ROWS], yT[NUM_COLS];
+        for (int i = 0; i < NUM_ROWS; i++)
+            xT[i] = 1.0 - 0.3 * i;
+        matrix.multiply(true, xT, yT);
+        for (int j = 0; j < NUM_COLS; j++) {
+            double ref = 0.0;
+            for (int i = 0; i < NUM_ROWS; i++)
+                ref += dense[i * NUM_COLS + j] * xT[i];
+            CPPUNIT_ASSERT(fabs(yT[j] - ref) < 1E-12);
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test that the scalar matrix is recovered from the blocks
+     ***********/
+    void testGetCSR() {
+        BlockSparseMatrix matrix(NUM_ROWS / 3, NUM_COLS / 3);
+        matrix.setCSR(rowPtr, cols, vals);
+        vector<int> rowPtr2, cols2;
+        vector<double> vals2;
+        matrix.getCSR(rowPtr2, cols2, vals2);
+        CPPUNIT_ASSERT(rowPtr2 == rowPtr);
+        CPPUNIT_ASSERT(cols2 == cols);
+        CPPUNIT_ASSERT(vals2 == vals);
+    }
+
+    CPPUNIT_TEST_SUITE( TestBlockSparseMatrix );
+    CPPUNIT_TEST( testMultiply);
+    CPPUNIT_TEST( testGetCSR);
+    CPPUNIT_TEST_SUITE_END();
+private:
+    static const int NUM_ROWS = 9;
+    static const int NUM_COLS = 12;
+    /// the matrix as dense row major array
+    vector<double> dense;
+    /// the matrix in CSR format
+    vector<int> rowPtr;
+    vector<int> cols;
+    vector<double> vals;
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestBlockSparseMatrix);
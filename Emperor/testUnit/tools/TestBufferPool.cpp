@@ -0,0 +1,107 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "BufferPool.h"
+
+namespace EMPIRE {
+
+/********//**
+ * \brief This class manages tests of the BufferPool
+ **************************************************************************************************/
+class TestBufferPool: public CppUnit::TestFixture {
+public:
+    void setUp() {
+        BufferPool::clear();
+        BufferPool::setMaxPooledBytes((size_t) 64 * 1024 * 1024);
+    }
+    void tearDown() {
+        BufferPool::clear();
+    }
+    /***********************************************************************************************
+     * \brief Test that a released buffer is reused for a buffer of the same size class
+     ***********/
+    void testReuse() {
+        double *buffer;
+        size_t numAllocations = BufferPool::getNumAllocations();
+        {
+            BufferPool::Buffer first(100000);
+            CPPUNIT_ASSERT(first.size() == 100000);
+            CPPUNIT_ASSERT((size_t) first.data() % 64 == 0);
+            first[99999] = 1.0;
+            buffer = first.data();
+        }
+        CPPUNIT_ASSERT(BufferPool::getPooledBytes() > 100000 * sizeof(double));
+        // a slightly different size of the same class
+        BufferPool::Buffer second(90000);
+        CPPUNIT_ASSERT(second.data() == buffer);
+        CPPUNIT_ASSERT(BufferPool::getPooledBytes() == 0);
+        CPPUNIT_ASSERT(BufferPool::getNumAllocations() == numAllocations + 1);
+        // a larger class needs a new buffer
+        BufferPool::Buffer third(200000);
+        CPPUNIT_ASSERT(third.data() != buffer);
+        CPPUNIT_ASSERT(BufferPool::getNumAllocations() == numAllocations + 2);
+    }
+    /***********************************************************************************************
+     * \brief Test that the copies of a handle share the buffer until the last one is released
+     ***********/
+    void testReferences() {
+        BufferPool::Buffer first(1000);
+        double *buffer = first.data();
+        {
+            BufferPool::Buffer copy(first);
+            CPPUNIT_ASSERT(copy.data() == buffer);
+            first.clear();
+            CPPUNIT_ASSERT(BufferPool::getPooledBytes() == 0);
+            copy[0] = 2.0;
+        }
+        CPPUNIT_ASSERT(BufferPool::getPooledBytes() > 0);
+        BufferPool::Buffer other;
+        other = BufferPool::Buffer(1000);
+        CPPUNIT_ASSERT(other.data() == buffer);
+    }
+    /***********************************************************************************************
+     * \brief Test that no more than the maximum of free buffers is kept
+     ***********/
+    void testCap() {
+        BufferPool::setMaxPooledBytes(1024 * 1024);
+        {
+            BufferPool::Buffer small(1000);
+            BufferPool::Buffer large(1000000);
+        }
+        CPPUNIT_ASSERT(BufferPool::getPooledBytes() > 0);
+        CPPUNIT_ASSERT(BufferPool::getPooledBytes() <= 1024 * 1024);
+        BufferPool::setMaxPooledBytes(0);
+        CPPUNIT_ASSERT(BufferPool::getPooledBytes() == 0);
+    }
+
+CPPUNIT_TEST_SUITE( TestBufferPool );
+        CPPUNIT_TEST( testReuse);
+        CPPUNIT_TEST( testReferences);
+        CPPUNIT_TEST( testCap);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestBufferPool);
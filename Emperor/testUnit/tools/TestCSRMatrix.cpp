@@ -0,0 +1,240 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "CSRMatrix.h"
+
+namespace EMPIRE {
+using namespace std;
+using namespace MathLibrary;
+
+/********//**
+ * \brief This class manages tests of the CSRMatrix
+ **************************************************************************************************/
+class TestCSRMatrix: public CppUnit::TestFixture {
+public:
+    void setUp() {
+        // a 7 x 5 matrix with an empty row and rows of different lengths
+        dense.assign(NUM_ROWS * NUM_COLS, 0.0);
+        rowPtr.assign(1, 0);
+        cols.clear();
+        values.clear();
+        for (int i = 0; i < NUM_ROWS; i++) {
+            for (int j = 0; j < NUM_COLS; j++) {
+                if (i != 3 && (i * j + i + j) % 3 != 0) {
+                    dense[i * NUM_COLS + j] = 1.0 + i - 0.5 * j;
+                    cols.push_back(j);
+                    values.push_back(dense[i * NUM_COLS + j]);
+                }
+            }
+            rowPtr.push_back(cols.size());
+        }
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Compare the products with the products of the dense matrix for several thread counts
+     ***********/
+    void testMultiply() {
+        for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+            CSRMatrix matrix(NUM_ROWS, NUM_COLS, rowPtr, cols, values, numThreads);
+            double x[NUM_COLS], y[NUM_ROWS];
+            for (int j = 0; j < NUM_COLS; j++)
+                x[j] = 0.3 * j - 1.0;
+            matrix.multiply(false, x, y);
+            for (int i = 0; i < NUM_ROWS; i++) {
+                double ref = 0.0;
+                for (int j = 0; j < NUM_COLS; j++)
+                    ref += dense[i * NUM_COLS + j] * x[j];
+                CPPUNIT_ASSERT(fabs(y[i] - ref) < 1E-12);
+            }
+            double xT[NUM_ROWS], yT[NUM_COLS];
+            for (int i = 0; i < NUM_ROWS; i++)
+                xT[i] = 2.0 - 0.7 * i;
+            matrix.multiply(true, xT, yT);
+            for (int j = 0; j < NUM_COLS; j++) {
+                double ref = 0.0;
+                for (int i = 0; i < NUM_ROWS; i++)
+                    ref += dense[i * NUM_COLS + j] * xT[i];
+                CPPUNIT_ASSERT(fabs(yT[j] - ref) < 1E-12);
+            }
+        }
+    }
+    /***********************************************************************************************
+     * \brief Compare the block products with the single products
+     ***********/
+    void testMultiplyBlock() {
+        const int NUM_VECS = 3;
+        CSRMatrix matrix(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 3);
+        double X[NUM_ROWS * NUM_VECS], Y[NUM_ROWS * NUM_VECS];
+        for (int i = 0; i < NUM_ROWS * NUM_VECS; i++)
+            X[i] = sin(1.0 + i);
+        for (int transpose = 0; transpose < 2; transpose++) {
+            int numIn = transpose ? NUM_ROWS : NUM_COLS;
+            int numOut = transpose ? NUM_COLS : NUM_ROWS;
+            matrix.multiplyBlock(transpose, X, Y, NUM_VECS);
+            for (int k = 0; k < NUM_VECS; k++) {
+                double x[NUM_ROWS], y[NUM_ROWS];
+                for (int i = 0; i < numIn; i++)
+                    x[i] = X[i * NUM_VECS + k];
+                matrix.multiply(transpose, x, y);
+                for (int i = 0; i < numOut; i++)
+                    CPPUNIT_ASSERT(fabs(Y[i * NUM_VECS + k] - y[i]) < 1E-12);
+            }
+        }
+    }
+    /***********************************************************************************************
+     * \brief A matrix built for one product gives the same results with less memory
+     ***********/
+    void testOneProduct() {
+        CSRMatrix matrix(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 2);
+        CSRMatrix matrixOnly(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 2, false,
+                CSRMatrix::getProducts(true, false));
+        CSRMatrix transposeOnly(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 2, false,
+                CSRMatrix::getProducts(false, true));
+        CPPUNIT_ASSERT(CSRMatrix::getProducts(true, true) == CSRMatrix::BOTH_PRODUCTS);
+        CPPUNIT_ASSERT(matrixOnly.getMemoryUsage().getTotal() < matrix.getMemoryUsage().getTotal());
+        CPPUNIT_ASSERT(transposeOnly.getMemoryUsage().getTotal() < matrix.getMemoryUsage().getTotal());
+        double x[NUM_ROWS], y[NUM_ROWS], oneY[NUM_ROWS];
+        for (int i = 0; i < NUM_ROWS; i++)
+            x[i] = 0.5 + i;
+        matrix.multiply(false, x, y);
+        matrixOnly.multiply(false, x, oneY);
+        for (int i = 0; i < NUM_ROWS; i++)
+            CPPUNIT_ASSERT(y[i] == oneY[i]);
+        matrix.multiply(true, x, y);
+        transposeOnly.multiply(true, x, oneY);
+        for (int j = 0; j < NUM_COLS; j++)
+            CPPUNIT_ASSERT(y[j] == oneY[j]);
+    }
+    /***********************************************************************************************
+     * \brief Compare the products of the single precision matrix with the double precision ones
+     ***********/
+    void testSinglePrecision() {
+        CSRMatrix matrix(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 1);
+        CSRMatrix singleMatrix(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 2, true);
+        CPPUNIT_ASSERT(singleMatrix.getMemoryUsage().getTotal() < matrix.getMemoryUsage().getTotal());
+        double X[NUM_ROWS * 2], Y[NUM_ROWS * 2], singleY[NUM_ROWS * 2];
+        for (int i = 0; i < NUM_ROWS * 2; i++)
+            X[i] = 1.0 / 3.0 + i;
+        for (int transpose = 0; transpose < 2; transpose++) {
+            matrix.multiplyBlock(transpose, X, Y, 2);
+            singleMatrix.multiplyBlock(transpose, X, singleY, 2);
+            for (int i = 0; i < (transpose ? NUM_COLS : NUM_ROWS) * 2; i++)
+                CPPUNIT_ASSERT(fabs(singleY[i] - Y[i]) <= 1E-6 * (1.0 + fabs(Y[i])));
+        }
+    }
+    /***********************************************************************************************
+     * \brief The products of consecutive row ranges give the product of the matrix, and each range
+     *        reads the entries of x below the column bound only
+     ***********/
+    void testRowRanges() {
+        const int NUM_VECS = 2;
+        CSRMatrix matrix(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 3);
+        CSRMatrix transposeOnly(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 3, false,
+                CSRMatrix::TRANSPOSE_PRODUCT);
+        CPPUNIT_ASSERT(matrix.isRowRangeProductSupported());
+        CPPUNIT_ASSERT(!transposeOnly.isRowRangeProductSupported());
+        CPPUNIT_ASSERT(matrix.getColumnBound(0) == 0);
+        for (int end = 1; end <= NUM_ROWS; end++) {
+            int bound = 0;
+            for (int k = 0; k < rowPtr[end]; k++)
+                bound = max(bound, cols[k] + 1);
+            CPPUNIT_ASSERT(matrix.getColumnBound(end) == bound);
+        }
+        double X[NUM_COLS * NUM_VECS], Y[NUM_ROWS * NUM_VECS], rangeY[NUM_ROWS * NUM_VECS];
+        for (int i = 0; i < NUM_COLS * NUM_VECS; i++)
+            X[i] = cos(0.5 + i);
+        matrix.multiplyBlock(false, X, Y, NUM_VECS);
+        const int ends[] = { 2, 2, 5, NUM_ROWS };
+        int first = 0;
+        for (int r = 0; r < 4; r++) {
+            // the entries of x the range must not read
+            double rangeX[NUM_COLS * NUM_VECS];
+            for (int i = 0; i < NUM_COLS * NUM_VECS; i++)
+                rangeX[i] = i < matrix.getColumnBound(ends[r]) * NUM_VECS ? X[i] : NAN;
+            matrix.multiplyRowRange(rangeX, rangeY, NUM_VECS, first, ends[r]);
+            first = ends[r];
+        }
+        for (int i = 0; i < NUM_ROWS * NUM_VECS; i++)
+            CPPUNIT_ASSERT(rangeY[i] == Y[i]);
+    }
+    /***********************************************************************************************
+     * \brief Test a matrix without entries
+     ***********/
+    void testEmpty() {
+        vector<int> emptyRowPtr(3, 0);
+        vector<int> emptyCols;
+        vector<double> emptyValues;
+        CSRMatrix matrix(2, 4, emptyRowPtr, emptyCols, emptyValues, 4);
+        double x[4] = { 1.0, 2.0, 3.0, 4.0 };
+        double y[4] = { 1.0, 1.0, 1.0, 1.0 };
+        matrix.multiply(false, x, y);
+        CPPUNIT_ASSERT(y[0] == 0.0 && y[1] == 0.0);
+        matrix.multiply(true, x, y);
+        for (int j = 0; j < 4; j++)
+            CPPUNIT_ASSERT(y[j] == 0.0);
+    }
+    /***********************************************************************************************
+     * \brief The entries are given back whichever of the matrix and its transpose is kept
+     ***********/
+    void testGetEntries() {
+        for (int transposeOnly = 0; transposeOnly < 2; transposeOnly++) {
+            CSRMatrix matrix(NUM_ROWS, NUM_COLS, rowPtr, cols, values, 3, false,
+                    CSRMatrix::getProducts(!transposeOnly, true));
+            vector<int> entriesRowPtr;
+            vector<int> entriesCols;
+            vector<double> entriesValues;
+            matrix.getEntries(entriesRowPtr, entriesCols, entriesValues);
+            CPPUNIT_ASSERT(entriesRowPtr == rowPtr);
+            CPPUNIT_ASSERT(entriesCols == cols);
+            CPPUNIT_ASSERT(entriesValues == values);
+        }
+    }
+
+    CPPUNIT_TEST_SUITE( TestCSRMatrix );
+    CPPUNIT_TEST( testMultiply);
+    CPPUNIT_TEST( testMultiplyBlock);
+    CPPUNIT_TEST( testOneProduct);
+    CPPUNIT_TEST( testSinglePrecision);
+    CPPUNIT_TEST( testRowRanges);
+    CPPUNIT_TEST( testEmpty);
+    CPPUNIT_TEST( testGetEntries);
+    CPPUNIT_TEST_SUITE_END();
+private:
+    static const int NUM_ROWS = 7;
+    static const int NUM_COLS = 5;
+    /// the matrix as dense row major array
+    vector<double> dense;
+    /// the matrix in CSR format
+    vector<int> rowPtr;
+    vector<int> cols;
+    vector<double> values;
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestCSRMatrix);
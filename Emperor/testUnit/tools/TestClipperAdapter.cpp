@@ -0,0 +1,171 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "ClipperAdapter.h"
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief This class manages tests of the clipping of convex polygons of the ClipperAdapter
+ **************************************************************************************************/
+class TestClipperAdapter: public CppUnit::TestFixture {
+private:
+    typedef std::vector<std::pair<double, double> > Polygon2D;
+    typedef std::vector<Polygon2D> ListPolygon2D;
+
+    double computeArea(const Polygon2D &_polygon) {
+        double area = 0.0;
+        for (int p = 0, q = _polygon.size() - 1; p < _polygon.size(); q = p++)
+            area += _polygon[q].first * _polygon[p].second - _polygon[p].first * _polygon[q].second;
+        return 0.5 * area;
+    }
+
+    Polygon2D makeRectangle(double _u0, double _v0, double _u1, double _v1) {
+        Polygon2D rectangle(4);
+        rectangle[0] = make_pair(_u0, _v0);
+        rectangle[1] = make_pair(_u1, _v0);
+        rectangle[2] = make_pair(_u1, _v1);
+        rectangle[3] = make_pair(_u0, _v1);
+        return rectangle;
+    }
+
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test the convexity check
+     ***********/
+    void testIsConvex() {
+        Polygon2D rectangle = makeRectangle(0.0, 0.0, 2.0, 1.0);
+        CPPUNIT_ASSERT(ClipperAdapter::isConvex(rectangle));
+        // Collinear vertices and clockwise orientation are allowed
+        Polygon2D clockwise(5);
+        clockwise[0] = make_pair(0.0, 0.0);
+        clockwise[1] = make_pair(0.0, 1.0);
+        clockwise[2] = make_pair(1.0, 1.0);
+        clockwise[3] = make_pair(1.0, 0.0);
+        clockwise[4] = make_pair(0.5, 0.0);
+        CPPUNIT_ASSERT(ClipperAdapter::isConvex(clockwise));
+        // L-shape
+        Polygon2D lShape(6);
+        lShape[0] = make_pair(0.0, 0.0);
+        lShape[1] = make_pair(2.0, 0.0);
+        lShape[2] = make_pair(2.0, 1.0);
+        lShape[3] = make_pair(1.0, 1.0);
+        lShape[4] = make_pair(1.0, 2.0);
+        lShape[5] = make_pair(0.0, 2.0);
+        CPPUNIT_ASSERT(!ClipperAdapter::isConvex(lShape));
+        // Pentagram, all turns are of the same direction but it winds twice around
+        Polygon2D pentagram(5);
+        for (int i = 0; i < 5; i++)
+            pentagram[i] = make_pair(cos(0.3 + 4.0 * M_PI * i / 5.0), sin(0.3 + 4.0 * M_PI * i / 5.0));
+        CPPUNIT_ASSERT(!ClipperAdapter::isConvex(pentagram));
+        CPPUNIT_ASSERT(!ClipperAdapter::isConvex(Polygon2D(2, make_pair(0.0, 0.0))));
+    }
+    /***********************************************************************************************
+     * \brief Test the Sutherland-Hodgman clipping of a triangle by a knot span window
+     ***********/
+    void testClipConvex() {
+        const double EPS = 1e-12;
+        Polygon2D window = makeRectangle(0.0, 0.0, 1.0, 1.0);
+        Polygon2D triangle(3);
+        triangle[0] = make_pair(0.25, 0.25);
+        triangle[1] = make_pair(1.25, 0.25);
+        triangle[2] = make_pair(0.25, 1.25);
+        Polygon2D output;
+        ClipperAdapter::clipConvex(triangle, window, output);
+        CPPUNIT_ASSERT(output.size() == 5);
+        CPPUNIT_ASSERT(fabs(computeArea(output) - 0.4375) < EPS);
+        // The orientation of the subject is kept
+        reverse(triangle.begin(), triangle.end());
+        ClipperAdapter::clipConvex(triangle, window, output);
+        CPPUNIT_ASSERT(fabs(computeArea(output) + 0.4375) < EPS);
+        // Window inside of the subject
+        ClipperAdapter::clipConvex(makeRectangle(-1.0, -1.0, 2.0, 2.0), window, output);
+        CPPUNIT_ASSERT(output.size() == 4);
+        CPPUNIT_ASSERT(fabs(computeArea(output) - 1.0) < EPS);
+        // Subject sharing an edge with the window gives no repeated vertices
+        ClipperAdapter::clipConvex(makeRectangle(0.0, 0.0, 1.0, 0.5), window, output);
+        CPPUNIT_ASSERT(output.size() == 4);
+        CPPUNIT_ASSERT(fabs(computeArea(output) - 0.5) < EPS);
+        // Subject touching the window only along an edge
+        ClipperAdapter::clipConvex(makeRectangle(1.0, 0.0, 2.0, 1.0), window, output);
+        CPPUNIT_ASSERT(output.empty());
+        // Disjoint subject
+        ClipperAdapter::clipConvex(makeRectangle(3.0, 3.0, 4.0, 4.0), window, output);
+        CPPUNIT_ASSERT(output.empty());
+    }
+    /***********************************************************************************************
+     * \brief Test the clipping of many subjects by the same convex clipping window
+     ***********/
+    void testClipSubjectsByConvexWindow() {
+        const double EPS = 1e-8;
+        ClipperAdapter c;
+        ListPolygon2D solution;
+        // Clockwise knot span window, the clockwise subjects are given back counterclockwise
+        Polygon2D window = makeRectangle(0.0, 0.0, 1.0, 1.0);
+        reverse(window.begin(), window.end());
+        c.setPathClipper(window);
+        for (int i = 0; i < 3; i++) {
+            Polygon2D triangle(3);
+            triangle[0] = make_pair(0.25 * i, -0.5);
+            triangle[1] = make_pair(0.25 * i, 0.5);
+            triangle[2] = make_pair(0.25 * i + 1.0, 0.5);
+            c.clip(triangle, solution);
+            CPPUNIT_ASSERT(solution.size() == 1);
+            CPPUNIT_ASSERT(computeArea(solution[0]) > 0.0);
+            // The part of the triangle above v = 0, from which the corner beyond u = 1 is cut
+            double area = 0.5 * 0.5 * 0.5 + 0.5 * 0.5 - 0.5 * (0.25 * i) * (0.25 * i);
+            CPPUNIT_ASSERT(fabs(computeArea(solution[0]) - area) < EPS);
+        }
+        // Moving the window to the next knot span
+        c.setPathClipper(makeRectangle(1.0, 0.0, 2.0, 1.0));
+        c.clip(makeRectangle(0.5, 0.5, 1.5, 2.0), solution);
+        CPPUNIT_ASSERT(solution.size() == 1);
+        CPPUNIT_ASSERT(fabs(computeArea(solution[0]) - 0.25) < EPS);
+        c.clip(makeRectangle(-1.0, 0.0, 0.0, 1.0), solution);
+        CPPUNIT_ASSERT(solution.empty());
+        // With the positive filling rule a clockwise clipping window is empty
+        c.setFilling(ClipperAdapter::POSITIVE, 0);
+        c.setPathClipper(window);
+        c.clip(makeRectangle(0.0, 0.0, 0.5, 0.5), solution);
+        CPPUNIT_ASSERT(solution.empty());
+    }
+
+    CPPUNIT_TEST_SUITE( TestClipperAdapter );
+    CPPUNIT_TEST( testIsConvex);
+    CPPUNIT_TEST( testClipConvex);
+    CPPUNIT_TEST( testClipSubjectsByConvexWindow);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestClipperAdapter);
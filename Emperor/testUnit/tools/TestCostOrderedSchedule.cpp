@@ -0,0 +1,64 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <vector>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "CostOrderedSchedule.h"
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief This class manages tests of the CostOrderedSchedule
+ **************************************************************************************************/
+class TestCostOrderedSchedule: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test that the items are ordered by descending cost and equal costs keep their order
+     ***********/
+    void testOrder() {
+        const double costArray[] = { 1.0, 50.0, 1.0, 5.0, 50.0, 0.01 };
+        vector<double> costs(costArray, costArray + 6);
+        vector<int> order;
+        CostOrderedSchedule::computeOrder(costs, order);
+        const int orderRef[] = { 1, 4, 3, 0, 2, 5 };
+        CPPUNIT_ASSERT(order.size() == 6);
+        for (int k = 0; k < 6; k++)
+            CPPUNIT_ASSERT(order[k] == orderRef[k]);
+        costs.clear();
+        CostOrderedSchedule::computeOrder(costs, order);
+        CPPUNIT_ASSERT(order.empty());
+    }
+
+    CPPUNIT_TEST_SUITE( TestCostOrderedSchedule );
+    CPPUNIT_TEST( testOrder);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestCostOrderedSchedule);
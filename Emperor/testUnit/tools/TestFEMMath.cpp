@@ -225,6 +225,36 @@ public:
         }
     }
 
+    /***********************************************************************************************
+     * \brief Test that the shared quadrature rules are created once and equal the rules created apart
+     ***********/
+    void testIGAGaussQuadratureRegistry() {
+        const IGAGaussQuadrature* triangleRule = getIGAGaussQuadrature(IGA_QUADRATURE_TRIANGLE, 16);
+        CPPUNIT_ASSERT(triangleRule == getIGAGaussQuadrature(IGA_QUADRATURE_TRIANGLE, 16));
+        IGAGaussQuadratureOnTriangle theTriangleRule(16);
+        CPPUNIT_ASSERT(triangleRule->getNumGaussPoints() == 16);
+        CPPUNIT_ASSERT(triangleRule->getGaussPoints() == theTriangleRule.getGaussPoints());
+        CPPUNIT_ASSERT(triangleRule->getGaussWeights() == theTriangleRule.getGaussWeights());
+
+        // The weights of all rules sum up to the measure of the domain
+        const int noGPsTriangle[8] = { 1, 3, 4, 6, 7, 12, 13, 16 };
+        const double measure[IGA_QUADRATURE_NUM_DOMAINS] = { 0.5, 0.5, 2.0, 4.0 };
+        for (int iDomain = 0; iDomain < IGA_QUADRATURE_NUM_DOMAINS; iDomain++) {
+            for (int i = 0; i < 8; i++) {
+                int noGPs = i + 1;
+                if (iDomain == IGA_QUADRATURE_TRIANGLE)
+                    noGPs = noGPsTriangle[i];
+                else if (iDomain != IGA_QUADRATURE_BIUNIT_INTERVAL)
+                    noGPs = (i + 1) * (i + 1);
+                const IGAGaussQuadrature* theRule = getIGAGaussQuadrature((IGAQuadratureDomain) iDomain, noGPs);
+                double sumWeights = 0.0;
+                for (int j = 0; j < noGPs; j++)
+                    sumWeights += theRule->getGaussWeights()[j];
+                CPPUNIT_ASSERT(fabs(sumWeights - measure[iDomain]) < 1e-8);
+            }
+        }
+    }
+
     /***********************************************************************************************
      * \brief Tests the class IGAGaussQuadratureOnBiunitInterval for memory leakage
      * \author Andreas Apostolatos
@@ -307,12 +337,163 @@ public:
             }
     }
 
+    /***********************************************************************************************
+     * \brief Tests the batched local coordinates in triangles and quads against the functions
+     *        computing them one element at a time
+     ***********/
+    void testBatchedLocalCoorInElements() {
+        const int NUM = 6;
+        // elements in the three planes to project, the points are inside, outside, far outside
+        // and off the plane of the element
+        const double triangles[NUM * 9] = {0, 0, 0, 1, 0, 0, 0, 1, 0, //
+                0, 0, 0, 0, 2, 0, 0, 0, 1, //
+                0, 0, 0, 0, 0, 1, 1, 0.1, 0, //
+                1, 1, 1, 2, 1, 1.1, 1, 2, 1.2, //
+                0, 0, 0, 1, 0, 0, 0, 1, 0, //
+                -1, 0, 0, 0, 1, 0, 0, 0, 3};
+        const double quads[NUM * 12] = {-1, -1, 0, 1, -1, 0, 1, 1, 0, -1, 1, 0, //
+                0, -1, -1, 0, 1, -1, 0, 1, 1, 0, -1, 1, //
+                -1, 0, -1, -1, 0.1, 1, 1, 0, 1, 1, 0.05, -1, //
+                0, 0, 0, 2, 0, 0.1, 2.5, 2, 0, 0, 1, 0.2, //
+                -1, -1, 0, 1, -1, 0, 1, 1, 0, -1, 1, 0, //
+                -1, -1, 0, 1, -1, 0, 1, 1, 0, -1, 1, 0};
+        const double points[NUM * 3] = {0.2, 0.3, 1.0, //
+                0.5, 0.5, 0.2, //
+                0.4, 0.7, 0.3, //
+                1.3, 1.4, 0.0, //
+                -2.0, 0.5, 0.1, //
+                30.0, -40.0, 5.0};
+
+        double trianglesSoA[NUM * 9], quadsSoA[NUM * 12], pointsSoA[NUM * 3];
+        double normalsSoA[NUM * 3], quadNormalsSoA[NUM * 3], centroidsSoA[NUM * 3];
+        int planes[NUM], quadPlanes[NUM];
+        for (int k = 0; k < NUM; k++) {
+            double normal[3];
+            computeNormalOfTriangle(&triangles[k * 9], true, normal);
+            planes[k] = computePlaneToProject(normal);
+            double quadNormal[3], centroid[3];
+            computeNormalOfQuad(&quads[k * 12], true, quadNormal);
+            quadPlanes[k] = computePlaneToProject(quadNormal);
+            computePolygonCenter(&quads[k * 12], 4, centroid);
+            for (int j = 0; j < 3; j++) {
+                for (int i = 0; i < 3; i++)
+                    trianglesSoA[(i * 3 + j) * NUM + k] = triangles[k * 9 + i * 3 + j];
+                for (int i = 0; i < 4; i++)
+                    quadsSoA[(i * 3 + j) * NUM + k] = quads[k * 12 + i * 3 + j];
+                pointsSoA[j * NUM + k] = points[k * 3 + j];
+                normalsSoA[j * NUM + k] = normal[j];
+                quadNormalsSoA[j * NUM + k] = quadNormal[j];
+                centroidsSoA[j * NUM + k] = centroid[j];
+            }
+        }
+
+        double projectionsSoA[NUM * 3], localCoorsSoA[NUM * 3];
+        projectToPlanes(NUM, trianglesSoA, normalsSoA, pointsSoA, projectionsSoA);
+        computeLocalCoorInTriangles(NUM, trianglesSoA, planes, projectionsSoA, localCoorsSoA);
+        for (int k = 0; k < NUM; k++) {
+            double normal[3], projection[3], localCoor[3];
+            computeNormalOfTriangle(&triangles[k * 9], true, normal);
+            projectToPlane(&triangles[k * 9], normal, &points[k * 3], 1, projection);
+            computeLocalCoorInTriangle(&triangles[k * 9], planes[k], projection, localCoor);
+            for (int j = 0; j < 3; j++) {
+                CPPUNIT_ASSERT(fabs(projectionsSoA[j * NUM + k] - projection[j]) < 1e-14);
+                CPPUNIT_ASSERT(fabs(localCoorsSoA[j * NUM + k] - localCoor[j]) < 1e-14);
+            }
+        }
+
+        for (int i = 0; i < 4; i++)
+            projectToPlanes(NUM, centroidsSoA, quadNormalsSoA, &quadsSoA[i * 3 * NUM],
+                    &quadsSoA[i * 3 * NUM]);
+        projectToPlanes(NUM, quadsSoA, quadNormalsSoA, pointsSoA, projectionsSoA);
+        computeLocalCoorInQuads(NUM, quadsSoA, quadPlanes, projectionsSoA, localCoorsSoA);
+        for (int k = 0; k < NUM; k++) {
+            double normal[3], centroid[3], quad[12], projection[3], localCoor[2];
+            computeNormalOfQuad(&quads[k * 12], true, normal);
+            computePolygonCenter(&quads[k * 12], 4, centroid);
+            projectToPlane(centroid, normal, &quads[k * 12], 4, quad);
+            projectToPlane(quad, normal, &points[k * 3], 1, projection);
+            computeLocalCoorInQuad(quad, quadPlanes[k], projection, localCoor);
+            for (int j = 0; j < 2; j++)
+                CPPUNIT_ASSERT(fabs(localCoorsSoA[j * NUM + k] - localCoor[j]) < 1e-12);
+        }
+    }
+
+    /***********************************************************************************************
+     * \brief Tests the element kernels with the number of Gauss points fixed at compile time against
+     *        the analytical mass matrices and the runtime functions
+     ***********/
+    void testElementKernels() {
+        // the triangle has the area 3
+        const double triangle[9] = {0, 0, 1, 3, 0, 1, 0, 2, 1};
+        const double area = 3.0;
+        double M[9], MRuntime[9];
+        computeMassMatrixOfTriangle<6>(triangle, false, M);
+        computeMassMatrixOfTrianlge(triangle, 6, false, MRuntime);
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) {
+                double exact = (i == j) ? area / 6.0 : area / 12.0;
+                CPPUNIT_ASSERT(fabs(M[i * 3 + j] - exact) < 1e-12);
+                CPPUNIT_ASSERT(M[i * 3 + j] == MRuntime[i * 3 + j]);
+            }
+        computeMassMatrixOfTriangle<7>(triangle, true, M);
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++)
+                CPPUNIT_ASSERT(fabs(M[i * 3 + j] - ((i == j) ? area / 3.0 : 0.0)) < 1e-12);
+
+        // the rectangle is 2 x 3 in the y-z plane
+        const double quad[12] = {1, 0, 0, 1, 2, 0, 1, 2, 3, 1, 0, 3};
+        const double quadArea = 6.0;
+        double MQuad[16], MQuadRuntime[16];
+        computeMassMatrixOfQuad<4>(quad, false, MQuad);
+        computeMassMatrixOfQuad(quad, 4, false, MQuadRuntime);
+        // the nodes i and j share an edge if they are neighbors in the node order
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++) {
+                double exact = quadArea / 36.0;
+                if (i == j)
+                    exact *= 4.0;
+                else if ((i + j) % 2 == 1)
+                    exact *= 2.0;
+                CPPUNIT_ASSERT(fabs(MQuad[i * 4 + j] - exact) < 1e-12);
+                CPPUNIT_ASSERT(MQuad[i * 4 + j] == MQuadRuntime[i * 4 + j]);
+            }
+        computeMassMatrixOfQuad<9>(quad, true, MQuad);
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(fabs(MQuad[i * 4 + i] - quadArea / 4.0) < 1e-12);
+        const double xi_eta[2] = {0.3, -0.6};
+        CPPUNIT_ASSERT(fabs(computeDetJOfQuad<1>(quad, 0) - computeDetJOfQuad(quad, xi_eta)) < 1e-14);
+        CPPUNIT_ASSERT(fabs(computeDetJOfQuad<1>(quad, 0) - quadArea / 4.0) < 1e-14);
+
+        // the shape functions interpolate the nodes of the canonical elements
+        const double coords[2] = {0.25, -0.5};
+        double N[4], NRuntime[4], x[2];
+        const double nodesTri[6] = {0, 0, 1, 0, 0, 1};
+        computeLowOrderShapeFunc<3>(coords, N);
+        computeLowOrderShapeFunc(3, coords, NRuntime);
+        computeLinearCombination<3, 2>(nodesTri, N, x);
+        for (int i = 0; i < 3; i++)
+            CPPUNIT_ASSERT(N[i] == NRuntime[i]);
+        for (int i = 0; i < 2; i++)
+            CPPUNIT_ASSERT(fabs(x[i] - coords[i]) < 1e-15);
+        const double nodesQuad[8] = {-1, -1, 1, -1, 1, 1, -1, 1};
+        computeLowOrderShapeFunc<4>(coords, N);
+        computeLowOrderShapeFunc(4, coords, NRuntime);
+        computeLinearCombination<4, 2>(nodesQuad, N, x);
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(N[i] == NRuntime[i]);
+        for (int i = 0; i < 2; i++)
+            CPPUNIT_ASSERT(fabs(x[i] - coords[i]) < 1e-15);
+    }
+
     CPPUNIT_TEST_SUITE( TestFEMMath );
     // Make the tests
     CPPUNIT_TEST(testIGAGaussQuadratureOnBiunitInterval);
     CPPUNIT_TEST(testIGAGaussQuadratureOnBiunitQuadrilateral);
     CPPUNIT_TEST(testIGAGaussQuadratureOnCanonicalTriangleUsingTheSymmetricRule);
     CPPUNIT_TEST(testIGAGaussQuadratureOnCanonicalTriangleUsingTheDegeneratedQuadrilateral);
+    CPPUNIT_TEST(testIGAGaussQuadratureRegistry);
+    CPPUNIT_TEST(testBatchedLocalCoorInElements);
+    CPPUNIT_TEST(testElementKernels);
 
     // Make the tests for memory leakage
     // CPPUNIT_TEST(testIGAGaussQuadratureOnBiunitInterval4Leakage);
@@ -0,0 +1,94 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <vector>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "IDToIndexMap.h"
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief This class manages tests of the IDToIndexMap
+ **************************************************************************************************/
+class TestIDToIndexMap: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test compact IDs, which are looked up in the table over their range
+     ***********/
+    void testDense() {
+        const int IDs[6] = { 7, 3, 4, 8, 5, 3 };
+        IDToIndexMap map(6, IDs);
+        CPPUNIT_ASSERT(map.isDenseTable());
+        CPPUNIT_ASSERT(map.size() == 6);
+        CPPUNIT_ASSERT(map.at(7) == 0);
+        CPPUNIT_ASSERT(map.at(4) == 2);
+        CPPUNIT_ASSERT(map.at(8) == 3);
+        // the first position of a repeated ID is kept
+        CPPUNIT_ASSERT(map.at(3) == 1);
+        CPPUNIT_ASSERT(map.find(6) == -1);
+        CPPUNIT_ASSERT(map.find(2) == -1);
+        CPPUNIT_ASSERT(map.find(9) == -1);
+        CPPUNIT_ASSERT(map.find(-2147483647 - 1) == -1);
+    }
+    /***********************************************************************************************
+     * \brief Test scattered IDs, which are looked up in the hash table
+     ***********/
+    void testHash() {
+        vector<int> IDs;
+        for (int i = 0; i < 1000; i++)
+            IDs.push_back(-1000000 + i * 7919 * (i % 2 == 0 ? 1 : -1));
+        IDs.push_back(2147483647);
+        IDs.push_back(IDs[10]);
+        IDToIndexMap map(IDs.size(), &IDs[0]);
+        CPPUNIT_ASSERT(!map.isDenseTable());
+        for (int i = 0; i < 1001; i++)
+            CPPUNIT_ASSERT(map.at(IDs[i]) == i);
+        CPPUNIT_ASSERT(map.at(IDs[1001]) == 10);
+        CPPUNIT_ASSERT(map.find(-1000001) == -1);
+        CPPUNIT_ASSERT(map.find(0) == -1);
+    }
+    /***********************************************************************************************
+     * \brief Test the map without IDs
+     ***********/
+    void testEmpty() {
+        IDToIndexMap map(0, NULL);
+        CPPUNIT_ASSERT(map.size() == 0);
+        CPPUNIT_ASSERT(map.find(0) == -1);
+        CPPUNIT_ASSERT(map.find(1) == -1);
+    }
+
+    CPPUNIT_TEST_SUITE( TestIDToIndexMap );
+    CPPUNIT_TEST( testDense);
+    CPPUNIT_TEST( testHash);
+    CPPUNIT_TEST( testEmpty);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestIDToIndexMap);
@@ -31,6 +31,69 @@ namespace EMPIRE {
 using namespace std;
 using namespace MathLibrary;
 
+/********//**
+ * \brief A dense Gaussian elimination registered as a LinearSolver in the tests
+ ***********/
+class DenseTestSolver: public LinearSolver {
+public:
+    void factorize(int numRows, const std::vector<int> &rowPtr, const std::vector<int> &cols,
+            const std::vector<double> &values, bool isSymmetric) {
+        n = numRows;
+        A.assign(n * n, 0.0);
+        for (int i = 0; i < n; i++) {
+            for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++) {
+                A[i * n + cols[k]] = values[k];
+                if (isSymmetric)
+                    A[cols[k] * n + i] = values[k];
+            }
+        }
+        numFactorizations++;
+    }
+    void solve(double *X, const double *B, int numVecs, bool transpose) {
+        for (int v = 0; v < numVecs; v++) {
+            vector<double> M(n * n);
+            vector<double> x(n);
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++)
+                    M[i * n + j] = transpose ? A[j * n + i] : A[i * n + j];
+                x[i] = B[i * numVecs + v];
+            }
+            for (int k = 0; k < n; k++) {
+                int pivot = k;
+                for (int i = k + 1; i < n; i++)
+                    if (fabs(M[i * n + k]) > fabs(M[pivot * n + k]))
+                        pivot = i;
+                for (int j = 0; j < n; j++)
+                    swap(M[k * n + j], M[pivot * n + j]);
+                swap(x[k], x[pivot]);
+                for (int i = k + 1; i < n; i++) {
+                    double factor = M[i * n + k] / M[k * n + k];
+                    for (int j = k; j < n; j++)
+                        M[i * n + j] -= factor * M[k * n + j];
+                    x[i] -= factor * x[k];
+                }
+            }
+            for (int i = n - 1; i >= 0; i--) {
+                for (int j = i + 1; j < n; j++)
+                    x[i] -= M[i * n + j] * x[j];
+                x[i] /= M[i * n + i];
+                X[i * numVecs + v] = x[i];
+            }
+        }
+    }
+    size_t getFactorMemory() const {
+        return A.capacity() * sizeof(double);
+    }
+    static LinearSolver *create() {
+        return new DenseTestSolver();
+    }
+    static int numFactorizations;
+private:
+    int n;
+    vector<double> A;
+};
+int DenseTestSolver::numFactorizations = 0;
+
 /********//**
  * \brief This class manages tests the MathLibrary of EMPIRE
  **************************************************************************************************/
@@ -123,6 +186,167 @@ public:
         CPPUNIT_ASSERT(fabs(result2[2] - 3.00300000e+06) < 100000*AuxiliaryParameters::machineEpsilon);
         CPPUNIT_ASSERT(fabs(result2[3] - 6.60000000e+03) < 1000000*AuxiliaryParameters::machineEpsilon);
     }
+    /***********************************************************************************************
+     * \brief Test that a frozen sparse matrix gives the same products and solution as before freezing
+     ***********/
+    void testFrozenSparseMatrix() {
+
+        double result[4];
+        double resultFrozen[4];
+        double solution[4];
+        double solutionFrozen[4];
+        (*sparseMat).mulitplyVec(false,vecA,result,4);
+        (*sparseMat).solve(solution,vecA);
+        (*sparseMat).freeze();
+        CPPUNIT_ASSERT((*sparseMat).getIsFrozen());
+        (*sparseMat).mulitplyVec(false,vecA,resultFrozen,4);
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(fabs(result[i] - resultFrozen[i]) < 100000*AuxiliaryParameters::machineEpsilon);
+
+        (*sparseMat).transposeMulitplyVec(vecA,resultFrozen,4);
+        CPPUNIT_ASSERT(fabs(resultFrozen[3] - (1.8E2 * 1.1 + 1.5E3 * 4.4)) < 100000*AuxiliaryParameters::machineEpsilon);
+        CPPUNIT_ASSERT(fabs((*sparseMat).getRowSum(0) - (1.38E2 + 1.8E2)) < 1000*AuxiliaryParameters::machineEpsilon);
+        CPPUNIT_ASSERT(!(*sparseMat).isRowEmpty(3));
+
+        (*sparseMat).solve(solutionFrozen,vecA);
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(fabs(solution[i] - solutionFrozen[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+    }
+    /***********************************************************************************************
+     * \brief Test that assembling from several triplet buffers sums up all duplicated entries
+     ***********/
+    void testSparseMatrixTripletAssembly() {
+
+        SparseMatrix<double> assembled(4,false);
+        std::vector<std::vector<SparseMatrixTriplet<double> > > buffers(2);
+        buffers[0].push_back(SparseMatrixTriplet<double>(3,3,1.0E3));
+        buffers[0].push_back(SparseMatrixTriplet<double>(0,0,1.38E2));
+        buffers[0].push_back(SparseMatrixTriplet<double>(2,2,9.1E5));
+        buffers[1].push_back(SparseMatrixTriplet<double>(1,2,8.36E1));
+        buffers[1].push_back(SparseMatrixTriplet<double>(3,3,5.0E2));
+        buffers[1].push_back(SparseMatrixTriplet<double>(1,1,1.3E1));
+        buffers[1].push_back(SparseMatrixTriplet<double>(0,3,1.8E2));
+        assembled.addTriplets(buffers, 2);
+        CPPUNIT_ASSERT(buffers[0].empty() && buffers[1].empty());
+
+        double result[4];
+        double resultAssembled[4];
+        (*sparseMat).mulitplyVec(false,vecA,result,4);
+        assembled.mulitplyVec(false,vecA,resultAssembled,4);
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(fabs(result[i] - resultAssembled[i]) < 100000*AuxiliaryParameters::machineEpsilon);
+    }
+    /***********************************************************************************************
+     * \brief Test that a symmetric matrix takes the upper triangular part of full element matrices
+     *        and is solved like the matrix assembled by entries
+     ***********/
+    void testSymmetricTripletAssembly() {
+
+        SparseMatrix<double> assembled(4,true);
+        std::vector<std::vector<SparseMatrixTriplet<double> > > buffers(2);
+        buffers[0].push_back(SparseMatrixTriplet<double>(0,0,1.38E2));
+        buffers[0].push_back(SparseMatrixTriplet<double>(0,3,1.8E2));
+        buffers[0].push_back(SparseMatrixTriplet<double>(3,0,1.8E2));
+        buffers[0].push_back(SparseMatrixTriplet<double>(3,3,1.5E3));
+        buffers[1].push_back(SparseMatrixTriplet<double>(1,1,1.3E1));
+        buffers[1].push_back(SparseMatrixTriplet<double>(2,1,8.36E1));
+        buffers[1].push_back(SparseMatrixTriplet<double>(1,2,8.36E1));
+        buffers[1].push_back(SparseMatrixTriplet<double>(2,2,9.1E5));
+        assembled.addTriplets(buffers, 2);
+        assembled.freeze();
+
+        double solution[4];
+        double solutionAssembled[4];
+        double solutionTranspose[4];
+        (*sparseMatSymm).solve(solution,vecA);
+        assembled.solve(solutionAssembled,vecA);
+        assembled.solveTranspose(solutionTranspose,vecA);
+        for (int i = 0; i < 4; i++) {
+            CPPUNIT_ASSERT(fabs(solution[i] - solutionAssembled[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+            CPPUNIT_ASSERT(fabs(solution[i] - solutionTranspose[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test the assembly of element matrices directly into the CSR format, the symbolic pass
+     *        computes the pattern from the nodes of the elements and the numeric pass adds the values
+     ***********/
+    void testPatternAssembly() {
+        // the nodes 0 and 3 are shared by two elements, which split the values
+        const int elemPtrArray[] = {0, 2, 4, 6};
+        const int elemNodesArray[] = {0, 3, 1, 2, 3, 0};
+        const double elemMatrices[3][4] = {{0.69E2, 0.9E2, 0.9E2, 0.75E3}, {1.3E1, 8.36E1, 8.36E1, 9.1E5},
+                {0.75E3, 0.9E2, 0.9E2, 0.69E2}};
+        std::vector<int> elemPtr(elemPtrArray, elemPtrArray + 4);
+        std::vector<int> elemNodes(elemNodesArray, elemNodesArray + 6);
+        std::vector<int> rowPtr, cols;
+        computeSparsityPattern(4, elemPtr, elemNodes, elemPtr, elemNodes, true, 2, rowPtr, cols);
+        const int expectedRowPtr[] = {0, 2, 4, 5, 6};
+        const int expectedCols[] = {0, 3, 1, 2, 2, 3};
+        CPPUNIT_ASSERT(rowPtr == std::vector<int>(expectedRowPtr, expectedRowPtr + 5));
+        CPPUNIT_ASSERT(cols == std::vector<int>(expectedCols, expectedCols + 6));
+
+        SparseMatrix<double> assembled(4,true);
+        assembled.setPattern(rowPtr, cols);
+#pragma omp parallel for num_threads(2)
+        for (int e = 0; e < 3; e++)
+            for (int j = 0; j < 2; j++)
+                for (int k = 0; k < 2; k++)
+                    assembled.addToEntry(elemNodes[elemPtr[e] + j], elemNodes[elemPtr[e] + k],
+                            elemMatrices[e][j * 2 + k]);
+        assembled.freeze();
+
+        double solution[4];
+        double solutionAssembled[4];
+        (*sparseMatSymm).solve(solution,vecA);
+        assembled.solve(solutionAssembled,vecA);
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(fabs(solution[i] - solutionAssembled[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+    }
+    /***********************************************************************************************
+     * \brief Test that a registered solver selected at runtime solves like the compiled solver
+     ***********/
+    void testRegisteredLinearSolver() {
+        CPPUNIT_ASSERT(LinearSolverRegistry::isKnown(LinearSolverRegistry::DIRECT));
+        CPPUNIT_ASSERT(LinearSolverRegistry::isKnown(LinearSolverRegistry::AUTOMATIC));
+        LinearSolverRegistry::registerSolver("denseTest", DenseTestSolver::create);
+        CPPUNIT_ASSERT(LinearSolverRegistry::isRegistered("denseTest"));
+
+        std::vector<std::string> names;
+        names.push_back("denseTest");
+        names.push_back(LinearSolverRegistry::AUTOMATIC);
+#ifdef USE_EIGEN
+        names.push_back("eigenSparseLU");
+#endif
+        for (size_t s = 0; s < names.size(); s++) {
+            SparseMatrix<double> *matrices[2] = {sparseMatSymm, sparseMat};
+            for (int k = 0; k < 2; k++) {
+                double expected[4];
+                double expectedTranspose[4];
+                matrices[k]->solve(expected,vecA);
+                matrices[k]->solveTranspose(expectedTranspose,vecA);
+                matrices[k]->setLinearSolver(names[s]);
+                CPPUNIT_ASSERT(matrices[k]->getLinearSolver() == names[s]);
+                double solution[4];
+                double solutionTranspose[4];
+                matrices[k]->solve(solution,vecA);
+                matrices[k]->solveTranspose(solutionTranspose,vecA);
+                for (int i = 0; i < 4; i++) {
+                    CPPUNIT_ASSERT(fabs(solution[i] - expected[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+                    CPPUNIT_ASSERT(fabs(solutionTranspose[i] - expectedTranspose[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+                }
+                matrices[k]->setLinearSolver(LinearSolverRegistry::DIRECT);
+            }
+        }
+
+        // the matrix is factorized once for several solves
+        int numFactorizations = DenseTestSolver::numFactorizations;
+        sparseMat->setLinearSolver("denseTest");
+        double solution[4];
+        sparseMat->solve(solution,vecA);
+        sparseMat->solve(solution,vecB);
+        CPPUNIT_ASSERT(DenseTestSolver::numFactorizations == numFactorizations + 1);
+        CPPUNIT_ASSERT(sparseMat->getMemoryUsage().getTotal() > 16 * sizeof(double));
+    }
     /***********************************************************************************************
      * \brief Test sparse matrix direct solver
      * \author Stefan Sicklinger
@@ -151,6 +375,35 @@ public:
 
     }
 
+    /***********************************************************************************************
+     * \brief Test the transposed solve with the factorization of the unsymmetric matrix
+     ***********/
+    void testSparseTransposeSolver() {
+
+        double solutionA[4];
+        double solutionB[4];
+        double product[4];
+        (*sparseMat).solve(solutionA,vecA);
+        (*sparseMat).solveTranspose(solutionA,vecA);
+        (*sparseMat).transposeMulitplyVec(solutionA,product,4);
+        for (int i = 0; i < 4; i++)
+            CPPUNIT_ASSERT(fabs(product[i] - vecA[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+        (*sparseMat).solveTranspose(solutionB,vecB);
+
+        // two interleaved right hand sides
+        double rhs[8];
+        double solutions[8];
+        for (int i = 0; i < 4; i++) {
+            rhs[2 * i] = vecA[i];
+            rhs[2 * i + 1] = vecB[i];
+        }
+        (*sparseMat).solveTransposeBlock(solutions,rhs,2);
+        for (int i = 0; i < 4; i++) {
+            CPPUNIT_ASSERT(fabs(solutions[2 * i] - solutionA[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+            CPPUNIT_ASSERT(fabs(solutions[2 * i + 1] - solutionB[i]) < 1000*AuxiliaryParameters::machineEpsilon);
+        }
+    }
+
     void testSparseDirectSolver4Leakage() {
 
         (*sparseMatSymm).factorize();
@@ -184,6 +437,12 @@ public:
     CPPUNIT_TEST(testDenseDotProduct);
     CPPUNIT_TEST(testSparseMatrixVectorProduct);
     CPPUNIT_TEST(testSparseDirectSolver);
+    CPPUNIT_TEST(testFrozenSparseMatrix);
+    CPPUNIT_TEST(testSparseTransposeSolver);
+    CPPUNIT_TEST(testSparseMatrixTripletAssembly);
+    CPPUNIT_TEST(testSymmetricTripletAssembly);
+    CPPUNIT_TEST(testPatternAssembly);
+    CPPUNIT_TEST(testRegisteredLinearSolver);
 //    CPPUNIT_TEST(testSparseDirectSolver4Leakage);
     CPPUNIT_TEST_SUITE_END();
 };
@@ -19,6 +19,8 @@
  *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
  */
 #include <math.h>
+#include <stdlib.h>
+#include <vector>
 #include "cppunit/TestFixture.h"
 #include "cppunit/TestAssert.h"
 #include "cppunit/extensions/HelperMacros.h"
@@ -289,9 +291,150 @@ public:
     }
 
 
+    /***********************************************************************************************
+     * \brief Test that reverse Cuthill-McKee restores the bandwidth of scrambled chains
+     ***********/
+    void testReverseCuthillMcKee() {
+        // two chains of 10 and 7 rows, row i is the node (i * 7) % 17 of the chains 0-...-9, 10-...-16
+        const int size = 17;
+        vector<int> scrambledOfNode(size);
+        for (int i = 0; i < size; i++)
+            scrambledOfNode[(i * 7) % size] = i;
+        vector<int> rowPtr(1, 0), cols;
+        for (int i = 0; i < size; i++) {
+            int node = (i * 7) % size;
+            // the pattern is given unsymmetric, only the upper neighbour and the diagonal
+            cols.push_back(i);
+            if (node != 9 && node != 16)
+                cols.push_back(scrambledOfNode[node + 1]);
+            rowPtr.push_back(cols.size());
+        }
+        vector<int> order;
+        computeReverseCuthillMcKeeOrder(size, &rowPtr[0], &cols[0], order);
+        CPPUNIT_ASSERT(order.size() == size);
+        vector<int> newPosition(size, -1);
+        for (int k = 0; k < size; k++)
+            newPosition[order[k]] = k;
+        for (int i = 0; i < size; i++)
+            CPPUNIT_ASSERT(newPosition[i] >= 0);
+        for (int i = 0; i < size; i++)
+            for (int k = rowPtr[i]; k < rowPtr[i + 1]; k++)
+                CPPUNIT_ASSERT(abs(newPosition[i] - newPosition[cols[k]]) <= 1);
+    }
+
+
+    /***********************************************************************************************
+     * \brief Test the fused reductions, which must not depend on the number of threads
+     ***********/
+    void testReproducibleReductions() {
+        // several blocks of very different magnitudes which a plain sum loses
+        const int size = 20001;
+        vector<double> u(size), v(size), w(size);
+        for (int i = 0; i < size; i++) {
+            u[i] = (i % 2 == 0 ? 1E8 : 1E-4) * (1.0 + 1E-3 * (i % 7));
+            v[i] = 0.5 * u[i] + 1E-3 * (i % 5);
+        }
+        const double * const vecs[] = { &u[0], &v[0] };
+        const double coefficients[] = { 1.0, -0.5 };
+
+        int numThreadsBefore = AuxiliaryParameters::mapperSetNumThreads;
+        double squaredNorm[2], combinationNorm[2], differenceNorm[2], dotProduct[2];
+        double dotProducts[2][3];
+        for (int k = 0; k < 2; k++) {
+            AuxiliaryParameters::mapperSetNumThreads = 1 + 3 * k;
+            squaredNorm[k] = computeReproducibleSquaredNorm(&u[0], size);
+            combinationNorm[k] = computeReproducibleLinearCombination(&w[0], 2, vecs,
+                    coefficients, size);
+            computeReproducibleDifferenceProducts(&v[0], &u[0], size, &differenceNorm[k],
+                    &dotProduct[k]);
+            computeReproducibleDotProducts(&u[0], &v[0], size, &dotProducts[k][0],
+                    &dotProducts[k][1], &dotProducts[k][2]);
+        }
+        AuxiliaryParameters::mapperSetNumThreads = numThreadsBefore;
+        CPPUNIT_ASSERT(squaredNorm[0] == squaredNorm[1]);
+        CPPUNIT_ASSERT(combinationNorm[0] == combinationNorm[1]);
+        CPPUNIT_ASSERT(differenceNorm[0] == differenceNorm[1]);
+        CPPUNIT_ASSERT(dotProduct[0] == dotProduct[1]);
+        for (int j = 0; j < 3; j++)
+            CPPUNIT_ASSERT(dotProducts[0][j] == dotProducts[1][j]);
+        CPPUNIT_ASSERT(dotProducts[0][0] == squaredNorm[0]);
+
+        // compare to sums in extended precision
+        long double refSquaredNorm = 0.0, refCombinationNorm = 0.0, refDifferenceNorm = 0.0;
+        for (int i = 0; i < size; i++) {
+            CPPUNIT_ASSERT(w[i] == u[i] - 0.5 * v[i]);
+            refSquaredNorm += (long double) u[i] * u[i];
+            refCombinationNorm += (long double) w[i] * w[i];
+            refDifferenceNorm += (long double) (u[i] - v[i]) * (u[i] - v[i]);
+        }
+        CPPUNIT_ASSERT(fabs(squaredNorm[0] - refSquaredNorm) <= 1E-15 * refSquaredNorm);
+        CPPUNIT_ASSERT(fabs(combinationNorm[0] - refCombinationNorm) <= 1E-15 * refCombinationNorm);
+        CPPUNIT_ASSERT(fabs(differenceNorm[0] - refDifferenceNorm) <= 1E-15 * refDifferenceNorm);
+    }
+    /***********************************************************************************************
+     * \brief Test the batched products of the mortar integration against the products at every point
+     ***********/
+    void testWeightedProducts() {
+        const int numPoints = 13, numA = 4, numB = 3;
+        double A[numA * numPoints], B[numB * numPoints], weights[numPoints];
+        for (int g = 0; g < numPoints; g++) {
+            weights[g] = 0.1 + 0.05 * g;
+            for (int i = 0; i < numA; i++)
+                A[i * numPoints + g] = sin(1.0 + i + 0.3 * g);
+            for (int j = 0; j < numB; j++)
+                B[j * numPoints + g] = cos(2.0 * j - 0.7 * g);
+        }
+        double C[numA * numB], CAA[numA * numA];
+        for (int k = 0; k < numA * numB; k++)
+            C[k] = 1.0;
+        for (int k = 0; k < numA * numA; k++)
+            CAA[k] = 0.0;
+        accumulateWeightedProducts(numPoints, numA, numB, A, B, weights, false, C);
+        accumulateWeightedProducts(numPoints, numA, numA, A, A, weights, true, CAA);
+        for (int i = 0; i < numA; i++) {
+            for (int j = 0; j < numB; j++) {
+                double ref = 1.0;
+                for (int g = 0; g < numPoints; g++)
+                    ref += A[i * numPoints + g] * B[j * numPoints + g] * weights[g];
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(ref, C[i * numB + j], 1E-14);
+            }
+            for (int j = 0; j < numA; j++) {
+                double ref = 0.0;
+                for (int g = 0; g < numPoints && j >= i; g++)
+                    ref += A[i * numPoints + g] * A[j * numPoints + g] * weights[g];
+                CPPUNIT_ASSERT_DOUBLES_EQUAL(ref, CAA[i * numA + j], 1E-14);
+            }
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test the fixed size vector operations against the ones with the length at runtime
+     ***********/
+    void testFixedSizeVectorOperations() {
+        double a[3] = {1.5, -2.0, 0.25};
+        double b[3] = {-0.5, 3.0, 4.0};
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(computeDenseDotProduct(3, a, b),
+                computeDenseDotProduct<3>(a, b), 1E-15);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(vector2norm(a, 3), vector2norm<3>(a), 1E-15);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL(vector2norm(b, 2), vector2norm<2>(b), 1E-15);
+        double c[3], d[3];
+        copyDenseVector<3>(c, a);
+        copyDenseVector(d, a, 3);
+        computeDenseVectorAddition<3>(c, b, 2.0);
+        computeDenseVectorAddition(d, b, 2.0, 3);
+        for (int i = 0; i < 3; i++)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(d[i], c[i], 1E-15);
+        computeDenseVectorMultiplicationScalar<3>(c, -3.0);
+        computeDenseVectorMultiplicationScalar(d, -3.0, 3);
+        for (int i = 0; i < 3; i++)
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(d[i], c[i], 1E-15);
+    }
     CPPUNIT_TEST_SUITE(TestMatrixVectorMath);
     CPPUNIT_TEST(testMatrixProduct);
     CPPUNIT_TEST(testTransposeMatrixProduct);
+    CPPUNIT_TEST(testReverseCuthillMcKee);
+    CPPUNIT_TEST(testReproducibleReductions);
+    CPPUNIT_TEST(testWeightedProducts);
+    CPPUNIT_TEST(testFixedSizeVectorOperations);
 //    CPPUNIT_TEST(testMatrixProducts4Leakage);
     CPPUNIT_TEST_SUITE_END();
 };
@@ -0,0 +1,99 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <vector>
+#include <map>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "MemoryUsage.h"
+#include "MatrixVectorMath.h"
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief This class manages tests of the MemoryUsage
+ **************************************************************************************************/
+class TestMemoryUsage: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test that components of the same name are merged and the nested usages are prefixed
+     ***********/
+    void testComponents() {
+        MemoryUsage matrix;
+        matrix.add("values", 100);
+        matrix.add("indices", 50);
+        matrix.add("values", 20);
+        CPPUNIT_ASSERT(matrix.getComponents().size() == 2);
+        CPPUNIT_ASSERT(matrix.getBytes("values") == 120);
+        CPPUNIT_ASSERT(matrix.getBytes("unknown") == 0);
+        CPPUNIT_ASSERT(matrix.getTotal() == 170);
+
+        MemoryUsage mapper;
+        mapper.add("table", 30);
+        mapper.add("matrix", matrix);
+        mapper.add("matrix", matrix);
+        CPPUNIT_ASSERT(mapper.getComponents().size() == 3);
+        CPPUNIT_ASSERT(mapper.getComponents()[1].first == "matrix/values");
+        CPPUNIT_ASSERT(mapper.getBytes("matrix/indices") == 100);
+        CPPUNIT_ASSERT(mapper.getTotal() == 30 + 2 * 170);
+    }
+    /***********************************************************************************************
+     * \brief Test the estimates of the containers
+     ***********/
+    void testContainers() {
+        vector<double> vec;
+        vec.reserve(10);
+        CPPUNIT_ASSERT(MemoryUsage::ofVector(vec) == 10 * sizeof(double));
+        map<int, double> m;
+        m[1] = 1.0;
+        m[2] = 2.0;
+        CPPUNIT_ASSERT(
+                MemoryUsage::ofMap(m) == 2 * (sizeof(pair<const int, double>) + MemoryUsage::MAP_NODE_OVERHEAD));
+    }
+    /***********************************************************************************************
+     * \brief Test that the CSR arrays of a sparse matrix are accounted
+     ***********/
+    void testSparseMatrix() {
+        MathLibrary::SparseMatrix<double> A((size_t) 10, (size_t) 10);
+        for (int i = 0; i < 10; i++)
+            A(i, i) = 1.0;
+        A.freeze();
+        MemoryUsage usage = A.getMemoryUsage();
+        CPPUNIT_ASSERT(usage.getBytes("CSR arrays") >= 10 * (sizeof(double) + sizeof(int)));
+        CPPUNIT_ASSERT(usage.getTotal() >= usage.getBytes("CSR arrays"));
+    }
+
+    CPPUNIT_TEST_SUITE( TestMemoryUsage );
+    CPPUNIT_TEST( testComponents);
+    CPPUNIT_TEST( testContainers);
+    CPPUNIT_TEST( testSparseMatrix);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestMemoryUsage);
@@ -0,0 +1,166 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <vector>
+#include <map>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "MonotonicArena.h"
+#include "TriangulatorAdaptor.h"
+#include "ScratchArray.h"
+#include "BSplineBasis1D.h"
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief This class manages tests of the MonotonicArena and of its allocator
+ **************************************************************************************************/
+class TestMonotonicArena: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test that rewinding the arena reuses its blocks
+     ***********/
+    void testRewind() {
+        MonotonicArena arena(1024);
+        double* first = arena.allocate<double>(10);
+        MonotonicArena::Marker marker = arena.getMarker();
+        double* second = arena.allocate<double>(10);
+        CPPUNIT_ASSERT(second >= first + 10);
+        // Allocations larger than a block get their own block
+        double* large = arena.allocate<double>(1000);
+        large[999] = 1.0;
+        size_t capacity = arena.getCapacity();
+        arena.rewind(marker);
+        CPPUNIT_ASSERT(arena.allocate<double>(10) == second);
+        CPPUNIT_ASSERT(arena.allocate<double>(1000) == large);
+        CPPUNIT_ASSERT(arena.getCapacity() == capacity);
+        arena.reset();
+        CPPUNIT_ASSERT(arena.allocate<double>(10) == first);
+        CPPUNIT_ASSERT(arena.getCapacity() == capacity);
+    }
+    /***********************************************************************************************
+     * \brief Test the standard containers on the arena within scopes
+     ***********/
+    void testContainersInScope() {
+        MonotonicArena arena(256);
+        size_t capacity = 0;
+        for (int i = 0; i < 3; i++) {
+            MonotonicArena::Scope arenaScope(arena);
+            vector<int, ArenaAllocator<int> > v((ArenaAllocator<int>(arena)));
+            for (int j = 0; j < 100; j++)
+                v.push_back(j);
+            map<int, int, less<int>, ArenaAllocator<pair<const int, int> > > m((less<int>()),
+                    ArenaAllocator<pair<const int, int> >(arena));
+            for (int j = 0; j < 100; j++)
+                m[j] = v[99 - j];
+            CPPUNIT_ASSERT(m[10] == 89);
+            // The memory of the former scopes is reused
+            if (i == 0)
+                capacity = arena.getCapacity();
+            CPPUNIT_ASSERT(arena.getCapacity() == capacity);
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test the triangulation, which takes its temporaries from the arena of the thread
+     ***********/
+    void testTriangulation() {
+        TriangulatorAdaptor triangulator;
+        const double points[5][2] = { { 0.0, 0.0 }, { 2.0, 0.0 }, { 2.0, 1.0 }, { 1.0, 0.5 }, { 0.0, 1.0 } };
+        for (int i = 0; i < 5; i++)
+            triangulator.addPoint(points[i][0], points[i][1], 0.0);
+        MonotonicArena::Marker marker = MonotonicArena::getThreadArena().getMarker();
+        int triangleIndexes[9];
+        CPPUNIT_ASSERT(triangulator.triangulate(triangleIndexes));
+        // The arena is back at its position
+        MonotonicArena::Marker markerAfter = MonotonicArena::getThreadArena().getMarker();
+        CPPUNIT_ASSERT(marker.block == markerAfter.block && marker.offset == markerAfter.offset);
+        double area = 0.0;
+        for (int i = 0; i < 3; i++) {
+            const double* a = points[triangleIndexes[3 * i]];
+            const double* b = points[triangleIndexes[3 * i + 1]];
+            const double* c = points[triangleIndexes[3 * i + 2]];
+            double triangleArea = 0.5 * ((b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]));
+            CPPUNIT_ASSERT(triangleArea > 0.0);
+            area += triangleArea;
+        }
+        CPPUNIT_ASSERT(fabs(area - 1.5) < 1e-12);
+    }
+
+    /***********************************************************************************************
+     * \brief Test that the scratch arrays which do not fit on the stack take their memory from
+     *        the scratch arena of the thread, which is reused by the next evaluations
+     ***********/
+    void testScratchArrays() {
+        MonotonicArena& arena = MonotonicArena::getThreadScratchArena();
+        MonotonicArena::Marker marker = arena.getMarker();
+        {
+            ScratchArray<double, 4> onStack(4);
+            ScratchArray<double, 4> outer(100);
+            ScratchArray<int, 4> inner(1000);
+            for (int i = 0; i < 100; i++)
+                outer[i] = i;
+            for (int i = 0; i < 1000; i++)
+                inner[i] = -i;
+            CPPUNIT_ASSERT(outer[99] == 99.0 && inner[999] == -999);
+        }
+        MonotonicArena::Marker markerAfter = arena.getMarker();
+        CPPUNIT_ASSERT(marker.block == markerAfter.block && marker.offset == markerAfter.offset);
+
+        // the basis functions of a degree above SCRATCH_MAX_DEGREE use the arena
+        const int p = SCRATCH_MAX_DEGREE + 2;
+        double knots[2 * (p + 1) + 1];
+        for (int i = 0; i <= p; i++) {
+            knots[i] = 0.0;
+            knots[p + 2 + i] = 1.0;
+        }
+        knots[p + 1] = 0.5;
+        BSplineBasis1D basis(0, p, 2 * (p + 1) + 1, knots);
+        double basisFcts[(p + 1) * 2];
+        basis.computeLocalBasisFunctionsAndDerivatives(basisFcts, 1, 0.3, basis.findKnotSpan(0.3));
+        size_t capacity = arena.getCapacity();
+        for (int k = 0; k < 10; k++)
+            basis.computeLocalBasisFunctionsAndDerivatives(basisFcts, 1, 0.1 * k,
+                    basis.findKnotSpan(0.1 * k));
+        CPPUNIT_ASSERT(arena.getCapacity() == capacity);
+        double sum = 0.0;
+        for (int i = 0; i <= p; i++)
+            sum += basisFcts[i];
+        CPPUNIT_ASSERT(fabs(sum - 1.0) < 1e-12);
+    }
+
+    CPPUNIT_TEST_SUITE( TestMonotonicArena );
+    CPPUNIT_TEST( testRewind);
+    CPPUNIT_TEST( testContainersInScope);
+    CPPUNIT_TEST( testTriangulation);
+    CPPUNIT_TEST( testScratchArrays);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestMonotonicArena);
@@ -0,0 +1,107 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "NumaMemory.h"
+#include "AuxiliaryParameters.h"
+
+#include <vector>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Test the class template NumaArray and the functions of NumaMemory
+ ***********/
+class TestNumaMemory: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: the blocks filled by different threads hold the values
+     ***********/
+    void testAssign() {
+        vector<double> values(100);
+        for (int i = 0; i < 100; i++)
+            values[i] = 0.5 * i;
+        vector<size_t> blockBegins;
+        blockBegins.push_back(0);
+        blockBegins.push_back(10);
+        blockBegins.push_back(10);
+        blockBegins.push_back(100);
+        NumaArray<double> array;
+        array.assign(&values[0], blockBegins);
+        CPPUNIT_ASSERT(array.size() == 100);
+        CPPUNIT_ASSERT(array.getMemoryUsage() == 100 * sizeof(double));
+        for (int i = 0; i < 100; i++)
+            CPPUNIT_ASSERT(array[i] == values[i]);
+        array.assignZeros(blockBegins);
+        for (int i = 0; i < 100; i++)
+            CPPUNIT_ASSERT(array[i] == 0.0);
+        array.clear();
+        CPPUNIT_ASSERT(array.empty() && array.data() == NULL);
+    }
+    /***********************************************************************************************
+     * \brief Test case: the first touch zeroes, an interleaved array is usable
+     ***********/
+    void testFirstTouchAndInterleave() {
+        const int SIZE = 1 << 16;
+        double *array = new double[SIZE];
+        NumaMemory::interleave(array, SIZE * sizeof(double));
+        NumaMemory::firstTouch(array, SIZE, 3);
+        for (int i = 0; i < SIZE; i++)
+            CPPUNIT_ASSERT(array[i] == 0.0);
+        delete[] array;
+    }
+    /***********************************************************************************************
+     * \brief Test case: the arrays are aligned to cache lines, large arrays to huge pages if enabled
+     ***********/
+    void testAlignedAllocate() {
+        double *small = NumaMemory::allocateArray<double>(3);
+        CPPUNIT_ASSERT((size_t) small % 64 == 0);
+        NumaMemory::deallocate(small);
+        bool hugePages = AuxiliaryParameters::hugePages;
+        AuxiliaryParameters::hugePages = true;
+        const size_t SIZE = (1 << 21) / sizeof(double);
+        double *large = NumaMemory::allocateArray<double>(SIZE);
+        CPPUNIT_ASSERT((size_t) large % (1 << 21) == 0);
+        large[0] = large[SIZE - 1] = 1.0;
+        NumaMemory::deallocate(large);
+        AuxiliaryParameters::hugePages = hugePages;
+        NumaArray<double> array;
+        array.allocate(5);
+        CPPUNIT_ASSERT((size_t) array.data() % 64 == 0);
+    }
+
+CPPUNIT_TEST_SUITE( TestNumaMemory );
+        CPPUNIT_TEST( testAssign);
+        CPPUNIT_TEST( testFirstTouchAndInterleave);
+        CPPUNIT_TEST( testAlignedAllocate);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestNumaMemory);
@@ -0,0 +1,131 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "SpaceFillingCurve.h"
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief This class manages tests of the SpaceFillingCurve
+ **************************************************************************************************/
+class TestSpaceFillingCurve: public CppUnit::TestFixture {
+public:
+    void setUp() {
+        const int N = 4;
+        points.clear();
+        // the grid is visited backwards, so that the order has to be computed
+        for (int i = N * N * N - 1; i >= 0; i--) {
+            points.push_back(i % N);
+            points.push_back((i / N) % N);
+            points.push_back(i / (N * N));
+        }
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test the keys of single cells
+     ***********/
+    void testKeys() {
+        unsigned cell[3] = { 1, 0, 0 };
+        CPPUNIT_ASSERT(SpaceFillingCurve::getMortonKey(cell) == 4);
+        cell[0] = 0;
+        cell[2] = 1;
+        CPPUNIT_ASSERT(SpaceFillingCurve::getMortonKey(cell) == 1);
+        cell[0] = cell[1] = cell[2] = 0;
+        CPPUNIT_ASSERT(SpaceFillingCurve::getHilbertKey(cell) == 0);
+        // the keys are a bijection of the cells
+        vector<unsigned long long> keys;
+        for (unsigned i = 0; i < 64; i++) {
+            unsigned c[3] = { i % 4, (i / 4) % 4, i / 16 };
+            keys.push_back(SpaceFillingCurve::getHilbertKey(c));
+        }
+        sort(keys.begin(), keys.end());
+        CPPUNIT_ASSERT(unique(keys.begin(), keys.end()) == keys.end());
+    }
+    /***********************************************************************************************
+     * \brief Test that the Hilbert curve steps from a grid point to a neighbour only
+     ***********/
+    void testHilbertOrder() {
+        vector<int> order;
+        SpaceFillingCurve::computeOrder(SpaceFillingCurve::HILBERT, 64, &points[0], order);
+        CPPUNIT_ASSERT(order.size() == 64);
+        for (int k = 1; k < 64; k++) {
+            double distance = 0.0;
+            for (int i = 0; i < 3; i++)
+                distance += fabs(points[order[k] * 3 + i] - points[order[k - 1] * 3 + i]);
+            CPPUNIT_ASSERT(distance == 1.0);
+        }
+        vector<int> sorted(order);
+        sort(sorted.begin(), sorted.end());
+        for (int k = 0; k < 64; k++)
+            CPPUNIT_ASSERT(sorted[k] == k);
+    }
+    /***********************************************************************************************
+     * \brief Test that the Morton curve visits the octants one after the other
+     ***********/
+    void testMortonOrder() {
+        vector<int> order;
+        SpaceFillingCurve::computeOrder(SpaceFillingCurve::MORTON, 64, &points[0], order);
+        for (int k = 0; k < 64; k += 8) {
+            int octant = -1;
+            for (int l = k; l < k + 8; l++) {
+                const double *point = &points[order[l] * 3];
+                int thisOctant = (point[0] >= 2) * 4 + (point[1] >= 2) * 2 + (point[2] >= 2);
+                CPPUNIT_ASSERT(octant == -1 || octant == thisOctant);
+                octant = thisOctant;
+            }
+            CPPUNIT_ASSERT(octant == k / 8);
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test coincident points and no points
+     ***********/
+    void testDegenerate() {
+        double samePoints[6] = { 1.0, 2.0, 3.0, 1.0, 2.0, 3.0 };
+        vector<int> order;
+        SpaceFillingCurve::computeOrder(SpaceFillingCurve::HILBERT, 2, samePoints, order);
+        CPPUNIT_ASSERT(order.size() == 2);
+        CPPUNIT_ASSERT(order[0] == 0 && order[1] == 1);
+        SpaceFillingCurve::computeOrder(SpaceFillingCurve::MORTON, 0, NULL, order);
+        CPPUNIT_ASSERT(order.empty());
+    }
+
+    CPPUNIT_TEST_SUITE( TestSpaceFillingCurve );
+    CPPUNIT_TEST( testKeys);
+    CPPUNIT_TEST( testHilbertOrder);
+    CPPUNIT_TEST( testMortonOrder);
+    CPPUNIT_TEST( testDegenerate);
+    CPPUNIT_TEST_SUITE_END();
+private:
+    /// the points of a 4x4x4 grid
+    vector<double> points;
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestSpaceFillingCurve);
@@ -0,0 +1,110 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "TaskPool.h"
+
+#include <vector>
+
+using namespace std;
+
+namespace EMPIRE {
+/********//**
+ * \brief Task which marks its slot as executed, the slots of different tasks are different
+ ***********/
+class MarkingTask: public AbstractTask {
+public:
+    MarkingTask(vector<int> &_executed, int _id) :
+            executed(_executed), id(_id) {
+    }
+    void execute() {
+        executed[id]++;
+    }
+private:
+    vector<int> &executed;
+    int id;
+};
+
+/********//**
+ * \brief Test the class TaskPool
+ ***********/
+class TestTaskPool: public CppUnit::TestFixture {
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test case: every task is executed once, for different numbers of threads (0 executes
+     *        the tasks at push)
+     ***********/
+    void testWait() {
+        const int NUM_TASKS = 100;
+        const int numThreads[] = { 0, 1, 4 };
+        for (int t = 0; t < 3; t++) {
+            vector<int> executed(NUM_TASKS, 0);
+            TaskPool pool(numThreads[t]);
+            CPPUNIT_ASSERT(pool.getNumThreads() == numThreads[t]);
+            for (int i = 0; i < NUM_TASKS; i++)
+                pool.push(new MarkingTask(executed, i));
+            pool.wait();
+            for (int i = 0; i < NUM_TASKS; i++)
+                CPPUNIT_ASSERT(executed[i] == 1);
+        }
+    }
+    /***********************************************************************************************
+     * \brief Test case: pinned worker threads execute every task once
+     ***********/
+    void testPinning() {
+        vector<int> executed(10, 0);
+        TaskPool pool(2, 1);
+        for (int i = 0; i < 10; i++)
+            pool.push(new MarkingTask(executed, i));
+        pool.wait();
+        for (int i = 0; i < 10; i++)
+            CPPUNIT_ASSERT(executed[i] == 1);
+    }
+    /***********************************************************************************************
+     * \brief Test case: the destructor executes the pending tasks
+     ***********/
+    void testWaitAtDestruction() {
+        vector<int> executed(5, 0);
+        {
+            TaskPool pool(3);
+            for (int i = 0; i < 5; i++)
+                pool.push(new MarkingTask(executed, i));
+        }
+        for (int i = 0; i < 5; i++)
+            CPPUNIT_ASSERT(executed[i] == 1);
+    }
+
+CPPUNIT_TEST_SUITE( TestTaskPool );
+        CPPUNIT_TEST( testWait);
+        CPPUNIT_TEST( testPinning);
+        CPPUNIT_TEST( testWaitAtDestruction);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestTaskPool);
@@ -0,0 +1,136 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+#include <math.h>
+#include <vector>
+#include "cppunit/TestFixture.h"
+#include "cppunit/TestAssert.h"
+#include "cppunit/extensions/HelperMacros.h"
+
+#include "TriangulatorAdaptor.h"
+
+namespace EMPIRE {
+using namespace std;
+
+/********//**
+ * \brief This class manages tests of the triangulation paths of the TriangulatorAdaptor
+ **************************************************************************************************/
+class TestTriangulatorAdaptor: public CppUnit::TestFixture {
+private:
+    typedef std::vector<std::pair<double, double> > Polygon2D;
+    typedef std::vector<Polygon2D> ListPolygon2D;
+
+    double computeArea(const Polygon2D &_polygon) {
+        double area = 0.0;
+        for (int p = 0, q = _polygon.size() - 1; p < _polygon.size(); q = p++)
+            area += _polygon[q].first * _polygon[p].second - _polygon[p].first * _polygon[q].second;
+        return 0.5 * area;
+    }
+
+    /// Check that all triangles have the orientation of the polygon and together its area
+    void checkTriangulation(const Polygon2D &_polygon, const ListPolygon2D &_triangles) {
+        CPPUNIT_ASSERT(_triangles.size() == _polygon.size() - 2);
+        double area = computeArea(_polygon);
+        double sumArea = 0.0;
+        for (int i = 0; i < _triangles.size(); i++) {
+            CPPUNIT_ASSERT(_triangles[i].size() == 3);
+            double triangleArea = computeArea(_triangles[i]);
+            CPPUNIT_ASSERT(triangleArea * area > 0.0);
+            sumArea += triangleArea;
+        }
+        CPPUNIT_ASSERT(fabs(sumArea - area) < EPS);
+    }
+
+    static const double EPS;
+
+public:
+    void setUp() {
+    }
+    void tearDown() {
+    }
+    /***********************************************************************************************
+     * \brief Test the fan triangulation of convex polygons in both orientations
+     ***********/
+    void testConvex() {
+        Polygon2D hexagon(6);
+        for (int i = 0; i < 6; i++)
+            hexagon[i] = make_pair(cos(M_PI * i / 3.0), sin(M_PI * i / 3.0));
+        ListPolygon2D triangles;
+        CPPUNIT_ASSERT(TriangulatorAdaptor::triangulatePolygon(hexagon, triangles) == TriangulatorAdaptor::PATH_FAN);
+        checkTriangulation(hexagon, triangles);
+        Polygon2D clockwise(hexagon.rbegin(), hexagon.rend());
+        CPPUNIT_ASSERT(TriangulatorAdaptor::triangulatePolygon(clockwise, triangles) == TriangulatorAdaptor::PATH_FAN);
+        checkTriangulation(clockwise, triangles);
+        // A triangle is kept as is
+        Polygon2D triangle(hexagon.begin(), hexagon.begin() + 3);
+        CPPUNIT_ASSERT(TriangulatorAdaptor::triangulatePolygon(triangle, triangles) == TriangulatorAdaptor::PATH_TRIANGLE);
+        CPPUNIT_ASSERT(triangles.size() == 1 && triangles[0] == triangle);
+    }
+    /***********************************************************************************************
+     * \brief Test the ear clipping of non convex polygons and the fallback to polypartition
+     ***********/
+    void testNonConvex() {
+        Polygon2D lShape(6);
+        lShape[0] = make_pair(0.0, 0.0);
+        lShape[1] = make_pair(2.0, 0.0);
+        lShape[2] = make_pair(2.0, 1.0);
+        lShape[3] = make_pair(1.0, 1.0);
+        lShape[4] = make_pair(1.0, 2.0);
+        lShape[5] = make_pair(0.0, 2.0);
+        ListPolygon2D triangles;
+        CPPUNIT_ASSERT(TriangulatorAdaptor::triangulatePolygon(lShape, triangles) == TriangulatorAdaptor::PATH_EARCLIPPING);
+        checkTriangulation(lShape, triangles);
+        Polygon2D clockwise(lShape.rbegin(), lShape.rend());
+        CPPUNIT_ASSERT(TriangulatorAdaptor::triangulatePolygon(clockwise, triangles) == TriangulatorAdaptor::PATH_EARCLIPPING);
+        checkTriangulation(clockwise, triangles);
+        // A square with a collinear vertex is not split as a fan
+        Polygon2D square(5);
+        square[0] = make_pair(0.0, 0.0);
+        square[1] = make_pair(0.5, 0.0);
+        square[2] = make_pair(1.0, 0.0);
+        square[3] = make_pair(1.0, 1.0);
+        square[4] = make_pair(0.0, 1.0);
+        CPPUNIT_ASSERT(TriangulatorAdaptor::triangulatePolygon(square, triangles) == TriangulatorAdaptor::PATH_EARCLIPPING);
+        checkTriangulation(square, triangles);
+        // Large polygons go to polypartition
+        Polygon2D circle(TriangulatorAdaptor::MAX_VERTICES_EARCLIPPING + 1);
+        for (int i = 0; i < circle.size(); i++)
+            circle[i] = make_pair(cos(2.0 * M_PI * i / circle.size()), sin(2.0 * M_PI * i / circle.size()));
+        CPPUNIT_ASSERT(TriangulatorAdaptor::triangulatePolygon(circle, triangles) == TriangulatorAdaptor::PATH_POLYPARTITION);
+        checkTriangulation(circle, triangles);
+        // A polygon without area cannot be triangulated
+        Polygon2D line(4);
+        for (int i = 0; i < 4; i++)
+            line[i] = make_pair(i, i);
+        CPPUNIT_ASSERT(TriangulatorAdaptor::triangulatePolygon(line, triangles) == TriangulatorAdaptor::PATH_FAILED);
+        CPPUNIT_ASSERT(triangles.empty());
+    }
+
+    CPPUNIT_TEST_SUITE( TestTriangulatorAdaptor );
+    CPPUNIT_TEST( testConvex);
+    CPPUNIT_TEST( testNonConvex);
+    CPPUNIT_TEST_SUITE_END();
+};
+
+const double TestTriangulatorAdaptor::EPS = 1e-12;
+
+} /* namespace EMPIRE */
+
+CPPUNIT_TEST_SUITE_REGISTRATION( EMPIRE::TestTriangulatorAdaptor);
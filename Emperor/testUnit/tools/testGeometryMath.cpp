@@ -79,8 +79,29 @@ public:
         CPPUNIT_ASSERT(!isInsideNodeOutside);
     }
 
+    /***********************************************************************************************
+     * \brief Test the distance between segments for crossing, parallel and end point configurations
+     ***********/
+    void testDistanceSegmentSegment() {
+        double ratioA, ratioB;
+        // Skew segments whose closest points are interior
+        double P1[3] = { 0.0, 0.0, 0.0 }, P2[3] = { 2.0, 0.0, 0.0 };
+        double P3[3] = { 1.0, -1.0, 1.0 }, P4[3] = { 1.0, 1.0, 1.0 };
+        CPPUNIT_ASSERT(fabs(distanceSegmentSegment(ratioA, ratioB, P1, P2, P3, P4) - 1.0) < 1e-14);
+        CPPUNIT_ASSERT(fabs(ratioA - 0.5) < 1e-14);
+        CPPUNIT_ASSERT(fabs(ratioB - 0.5) < 1e-14);
+        // The closest point of the second segment is its end point
+        double P5[3] = { 3.0, 1.0, 0.0 }, P6[3] = { 5.0, 1.0, 0.0 };
+        CPPUNIT_ASSERT(fabs(distanceSegmentSegment(ratioA, ratioB, P1, P2, P5, P6) - sqrt(2.0)) < 1e-14);
+        CPPUNIT_ASSERT(ratioA == 1.0 && ratioB == 0.0);
+        // Parallel segments
+        double P7[3] = { 1.0, 2.0, 0.0 }, P8[3] = { 4.0, 2.0, 0.0 };
+        CPPUNIT_ASSERT(fabs(distanceSegmentSegment(ratioA, ratioB, P1, P2, P7, P8) - 2.0) < 1e-14);
+    }
+
     CPPUNIT_TEST_SUITE( TestGeometryMath );
     CPPUNIT_TEST(testFindIfPointIsInside2DPolygon);
+    CPPUNIT_TEST(testDistanceSegmentSegment);
     CPPUNIT_TEST_SUITE_END();
 };
 
@@ -17,7 +17,7 @@ MODULE m_empire_api
   IMPLICIT NONE
 
   PRIVATE
-  PUBLIC :: EMPIRE_API_Connect, EMPIRE_API_sendMesh, &
+  PUBLIC :: EMPIRE_API_Connect, EMPIRE_API_sendMesh, EMPIRE_API_sendMeshCoordinates, &
             EMPIRE_API_sendDataField, EMPIRE_API_recvDataField, &
             EMPIRE_API_sendSignal_double, EMPIRE_API_recvSignal_double, &
             EMPIRE_API_recvConvergenceSignal, EMPIRE_API_printDataField, &
@@ -60,6 +60,16 @@ MODULE m_empire_api
        INTEGER(c_int), DIMENSION(*), INTENT(in) :: elems !< Elements IDs.
      END SUBROUTINE EMPIRE_API_sendMesh_c
 
+     !--------------------------------------------------------------
+     !> C-Binding: EMPIRE_API_sendMeshCoordinates
+     SUBROUTINE EMPIRE_API_sendMeshCoordinates_c(mesh_name, num_nodes, nodes) &
+       BIND(C, name="EMPIRE_API_sendMeshCoordinates")
+       USE iso_c_binding, ONLY : c_char, c_int, c_double
+       CHARACTER(c_char), DIMENSION(*), INTENT(in) :: mesh_name !< Mesh name.
+       INTEGER(c_int), VALUE, INTENT(in) :: num_nodes !< Number of nodes.
+       REAL(c_double), DIMENSION(*), INTENT(in) :: nodes !< Node coordinates.
+     END SUBROUTINE EMPIRE_API_sendMeshCoordinates_c
+
      !-------------------------------------------------------------
      !> C-Binding: EMPIRE_API_sendDataField
      SUBROUTINE EMPIRE_API_sendDataField_c(data_name, size, data_field) &
@@ -171,6 +181,17 @@ CONTAINS
          node_ids, num_nodes_per_elem, elems)
   END SUBROUTINE EMPIRE_API_sendMesh
 
+  !-----------------------------------------------------------------
+  !> Wrapper: EMPIRE_API_sendMeshCoordinates
+  SUBROUTINE EMPIRE_API_sendMeshCoordinates(mesh_name, num_nodes, nodes)
+    USE iso_c_binding, ONLY : c_char, c_null_char
+    CHARACTER(len=*), INTENT(in) :: mesh_name !< Mesh name.
+    INTEGER, INTENT(in) :: num_nodes !< Number of nodes.
+    REAL(8), DIMENSION(:), INTENT(in) :: nodes !< Node coordinates.
+
+    CALL EMPIRE_API_sendMeshCoordinates_c(mesh_name//c_null_char, num_nodes, nodes)
+  END SUBROUTINE EMPIRE_API_sendMeshCoordinates
+
   !-------------------------------------------------------------
   !> Wrapper: EMPIRE_API_sendDataField
   SUBROUTINE EMPIRE_API_sendDataField(data_name, size, data_field)
@@ -0,0 +1,174 @@
+!> \file m_empire_api_iso_c.f90
+
+!-----------------------------------------------------------------------
+!> \brief The Fortran EMPIRE API interface module for the transfer of
+!> data fields in the time loop without temporaries.
+!> The name of every data field is registered once before the time
+!> loop, the transfers take the returned handle. A data field can also
+!> be registered with the array of the solver it is always transferred
+!> from and into, the transfers then take the handle only. The arrays are
+!> contiguous assumed-shape arguments, which are passed to libempire_api
+!> by their address, their size is taken from the array. Thus a transfer
+!> neither handles strings nor copies arrays. The module is used
+!> together with m_empire_api, which provides the connection, the mesh
+!> and the signals.
+!
+!> \date 10/15/2026
+!> \comment CONTIGUOUS is part of FORTRAN 2008, an actual argument which
+!>          is not contiguous is still copied by the caller
+!-----------------------------------------------------------------------
+MODULE m_empire_api_iso_c
+
+  USE iso_c_binding, ONLY : c_char, c_int, c_double, c_null_char
+
+  IMPLICIT NONE
+
+  PRIVATE
+  PUBLIC :: EMPIRE_API_registerDataField, &
+            EMPIRE_API_sendDataFieldByHandle, EMPIRE_API_recvDataFieldByHandle, &
+            EMPIRE_API_registerDataFieldBuffer, &
+            EMPIRE_API_sendRegisteredDataField, EMPIRE_API_recvRegisteredDataField, &
+            EMPIRE_API_recvMeshInPlace
+
+  INTERFACE
+
+     !--------------------------------------------------------------
+     !> C-Binding: EMPIRE_API_registerDataField
+     FUNCTION EMPIRE_API_registerDataField_c(data_name) &
+       BIND(C, name="EMPIRE_API_registerDataField")
+       USE iso_c_binding, ONLY : c_char, c_int
+       INTEGER(c_int) EMPIRE_API_registerDataField_c !< Data field handle.
+       CHARACTER(c_char), DIMENSION(*), INTENT(in) :: data_name !< Data name.
+     END FUNCTION EMPIRE_API_registerDataField_c
+
+     !--------------------------------------------------------------
+     !> C-Binding: EMPIRE_API_sendDataFieldByHandle
+     SUBROUTINE EMPIRE_API_sendDataFieldByHandle_c(handle, size, data_field) &
+       BIND(C, name="EMPIRE_API_sendDataFieldByHandle")
+       USE iso_c_binding, ONLY : c_int, c_double
+       INTEGER(c_int), VALUE, INTENT(in) :: handle !< Data field handle.
+       INTEGER(c_int), VALUE, INTENT(in) :: size !< Data array size.
+       REAL(c_double), DIMENSION(*), INTENT(in) :: data_field !< Data array.
+     END SUBROUTINE EMPIRE_API_sendDataFieldByHandle_c
+
+     !--------------------------------------------------------------
+     !> C-Binding: EMPIRE_API_recvDataFieldByHandle
+     SUBROUTINE EMPIRE_API_recvDataFieldByHandle_c(handle, size, data_field) &
+       BIND(C, name="EMPIRE_API_recvDataFieldByHandle")
+       USE iso_c_binding, ONLY : c_int, c_double
+       INTEGER(c_int), VALUE, INTENT(in) :: handle !< Data field handle.
+       INTEGER(c_int), VALUE, INTENT(in) :: size !< Data array size.
+       REAL(c_double), DIMENSION(*), INTENT(out) :: data_field !< Data array.
+     END SUBROUTINE EMPIRE_API_recvDataFieldByHandle_c
+
+     !--------------------------------------------------------------
+     !> C-Binding: EMPIRE_API_registerDataFieldBuffer
+     FUNCTION EMPIRE_API_registerDataFieldBuffer_c(data_name, size, data_field) &
+       BIND(C, name="EMPIRE_API_registerDataFieldBuffer")
+       USE iso_c_binding, ONLY : c_char, c_int, c_double
+       INTEGER(c_int) EMPIRE_API_registerDataFieldBuffer_c !< Data field handle.
+       CHARACTER(c_char), DIMENSION(*), INTENT(in) :: data_name !< Data name.
+       INTEGER(c_int), VALUE, INTENT(in) :: size !< Data array size.
+       REAL(c_double), DIMENSION(*), INTENT(in) :: data_field !< Data array.
+     END FUNCTION EMPIRE_API_registerDataFieldBuffer_c
+
+     !--------------------------------------------------------------
+     !> C-Binding: EMPIRE_API_sendRegisteredDataField
+     SUBROUTINE EMPIRE_API_sendRegisteredDataField(handle) &
+       BIND(C, name="EMPIRE_API_sendRegisteredDataField")
+       USE iso_c_binding, ONLY : c_int
+       INTEGER(c_int), VALUE, INTENT(in) :: handle !< Data field handle.
+     END SUBROUTINE EMPIRE_API_sendRegisteredDataField
+
+     !--------------------------------------------------------------
+     !> C-Binding: EMPIRE_API_recvRegisteredDataField
+     SUBROUTINE EMPIRE_API_recvRegisteredDataField(handle) &
+       BIND(C, name="EMPIRE_API_recvRegisteredDataField")
+       USE iso_c_binding, ONLY : c_int
+       INTEGER(c_int), VALUE, INTENT(in) :: handle !< Data field handle.
+     END SUBROUTINE EMPIRE_API_recvRegisteredDataField
+
+     !--------------------------------------------------------------
+     !> C-Binding: EMPIRE_API_recvMeshInPlace
+     SUBROUTINE EMPIRE_API_recvMeshInPlace_c(mesh_name, max_num_nodes, max_num_elems, &
+          max_size_of_elems, num_nodes, num_elems, nodes, node_ids, num_nodes_per_elem, elems) &
+       BIND(C, name="EMPIRE_API_recvMeshInPlace")
+       USE iso_c_binding, ONLY : c_char, c_int, c_double
+       CHARACTER(c_char), DIMENSION(*), INTENT(in) :: mesh_name !< Mesh name.
+       INTEGER(c_int), VALUE, INTENT(in) :: max_num_nodes !< Capacity of node_ids.
+       INTEGER(c_int), VALUE, INTENT(in) :: max_num_elems !< Capacity of num_nodes_per_elem.
+       INTEGER(c_int), VALUE, INTENT(in) :: max_size_of_elems !< Capacity of elems.
+       INTEGER(c_int), INTENT(out) :: num_nodes !< Number of nodes.
+       INTEGER(c_int), INTENT(out) :: num_elems !< Number of elements.
+       REAL(c_double), DIMENSION(*), INTENT(out) :: nodes !< Node coordinates.
+       INTEGER(c_int), DIMENSION(*), INTENT(out) :: node_ids !< Node IDs.
+       INTEGER(c_int), DIMENSION(*), INTENT(out) :: num_nodes_per_elem !< number of nodes at each element.
+       INTEGER(c_int), DIMENSION(*), INTENT(out) :: elems !< Elements IDs.
+     END SUBROUTINE EMPIRE_API_recvMeshInPlace_c
+
+  END INTERFACE
+
+CONTAINS
+
+  !--------------------------------------------------------------
+  !> Wrapper: EMPIRE_API_registerDataField, called once per data
+  !> field before the time loop
+  FUNCTION EMPIRE_API_registerDataField(data_name) RESULT(handle)
+    CHARACTER(len=*), INTENT(in) :: data_name !< Data name.
+    INTEGER(c_int) :: handle !< Data field handle.
+
+    handle = EMPIRE_API_registerDataField_c(TRIM(data_name)//c_null_char)
+  END FUNCTION EMPIRE_API_registerDataField
+
+  !--------------------------------------------------------------
+  !> Wrapper: EMPIRE_API_sendDataFieldByHandle
+  SUBROUTINE EMPIRE_API_sendDataFieldByHandle(handle, data_field)
+    INTEGER(c_int), INTENT(in) :: handle !< Data field handle.
+    REAL(c_double), DIMENSION(:), CONTIGUOUS, INTENT(in) :: data_field !< Data array.
+
+    CALL EMPIRE_API_sendDataFieldByHandle_c(handle, INT(SIZE(data_field), c_int), data_field)
+  END SUBROUTINE EMPIRE_API_sendDataFieldByHandle
+
+  !--------------------------------------------------------------
+  !> Wrapper: EMPIRE_API_recvDataFieldByHandle
+  SUBROUTINE EMPIRE_API_recvDataFieldByHandle(handle, data_field)
+    INTEGER(c_int), INTENT(in) :: handle !< Data field handle.
+    REAL(c_double), DIMENSION(:), CONTIGUOUS, INTENT(out) :: data_field !< Data array.
+
+    CALL EMPIRE_API_recvDataFieldByHandle_c(handle, INT(SIZE(data_field), c_int), data_field)
+  END SUBROUTINE EMPIRE_API_recvDataFieldByHandle
+
+  !--------------------------------------------------------------
+  !> Wrapper: EMPIRE_API_registerDataFieldBuffer, called once per data
+  !> field before the time loop. The array is transferred by its
+  !> address later on, thus it must be declared TARGET, such that the
+  !> compiler expects its change by EMPIRE_API_recvRegisteredDataField,
+  !> and must not be deallocated while the data field is transferred
+  FUNCTION EMPIRE_API_registerDataFieldBuffer(data_name, data_field) RESULT(handle)
+    CHARACTER(len=*), INTENT(in) :: data_name !< Data name.
+    REAL(c_double), DIMENSION(:), CONTIGUOUS, TARGET, INTENT(in) :: data_field !< Data array.
+    INTEGER(c_int) :: handle !< Data field handle.
+
+    handle = EMPIRE_API_registerDataFieldBuffer_c(TRIM(data_name)//c_null_char, &
+         INT(SIZE(data_field), c_int), data_field)
+  END FUNCTION EMPIRE_API_registerDataFieldBuffer
+
+  !--------------------------------------------------------------
+  !> Wrapper: EMPIRE_API_recvMeshInPlace, the capacities are the sizes
+  !> of the arrays
+  SUBROUTINE EMPIRE_API_recvMeshInPlace(mesh_name, num_nodes, num_elems, nodes, &
+       node_ids, num_nodes_per_elem, elems)
+    CHARACTER(len=*), INTENT(in) :: mesh_name !< Mesh name.
+    INTEGER(c_int), INTENT(out) :: num_nodes !< Number of nodes.
+    INTEGER(c_int), INTENT(out) :: num_elems !< Number of elements.
+    REAL(c_double), DIMENSION(:), CONTIGUOUS, INTENT(out) :: nodes !< Node coordinates.
+    INTEGER(c_int), DIMENSION(:), CONTIGUOUS, INTENT(out) :: node_ids !< Node IDs.
+    INTEGER(c_int), DIMENSION(:), CONTIGUOUS, INTENT(out) :: num_nodes_per_elem !< number of nodes at each element.
+    INTEGER(c_int), DIMENSION(:), CONTIGUOUS, INTENT(out) :: elems !< Elements IDs.
+
+    CALL EMPIRE_API_recvMeshInPlace_c(TRIM(mesh_name)//c_null_char, &
+         INT(MIN(SIZE(node_ids), SIZE(nodes) / 3), c_int), INT(SIZE(num_nodes_per_elem), c_int), &
+         INT(SIZE(elems), c_int), num_nodes, num_elems, nodes, node_ids, num_nodes_per_elem, elems)
+  END SUBROUTINE EMPIRE_API_recvMeshInPlace
+
+END MODULE m_empire_api_iso_c
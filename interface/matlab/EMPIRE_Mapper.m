@@ -0,0 +1,58 @@
+classdef EMPIRE_Mapper < handle
+    % EMPIRE_Mapper keeps a mapper of the EMPIRE mapper library alive between calls.
+    % The meshes and coupling matrices are built once in the constructor, every mapping afterwards
+    % passes the data to the MEX function EMPIRE_MapperLib without copying.
+    %
+    %   meshA = struct('nodes', nodes, 'nodeIDs', nodeIDs, 'numNodesPerElem', numNodesPerElem, 'elems', elems);
+    %   mapper = EMPIRE_Mapper('mortar', 'myMapper', meshA, meshB, [0 0 1]);
+    %   dispB = mapper.consistentMapping(dispA, 3);   % each column of dispA is mapped
+    %   forceA = mapper.conservativeMapping(forceB, 3);
+    %
+    % nodes is 3 x numNodes, the mortar mapper takes [oppositeSurfaceNormal dual enforceConsistency].
+
+    properties (SetAccess = private)
+        name       % name of the mapper in the mapper library
+        numNodesA  % number of nodes of mesh A
+        numNodesB  % number of nodes of mesh B
+    end
+
+    properties (Access = private)
+        handle     % handle of the mapper in the mapper library
+    end
+
+    methods
+        function obj = EMPIRE_Mapper(type, name, meshA, meshB, mortarFlags)
+            obj.name = name;
+            obj.numNodesA = numel(meshA.nodeIDs);
+            obj.numNodesB = numel(meshB.nodeIDs);
+            EMPIRE_MapperLib('initFEMesh', [name '_A'], meshA.nodes, meshA.nodeIDs, ...
+                meshA.numNodesPerElem, meshA.elems);
+            EMPIRE_MapperLib('initFEMesh', [name '_B'], meshB.nodes, meshB.nodeIDs, ...
+                meshB.numNodesPerElem, meshB.elems);
+            if strcmp(type, 'mortar')
+                obj.handle = EMPIRE_MapperLib('initMapper', type, name, [name '_A'], [name '_B'], ...
+                    mortarFlags(1), mortarFlags(2), mortarFlags(3));
+            else
+                obj.handle = EMPIRE_MapperLib('initMapper', type, name, [name '_A'], [name '_B']);
+            end
+        end
+
+        function dataB = consistentMapping(obj, dataA, dimension)
+            % map the columns of dataA (dimension values per node of mesh A) to mesh B
+            dataB = EMPIRE_MapperLib('consistentMapping', obj.handle, dimension, dataA, ...
+                dimension * obj.numNodesB);
+        end
+
+        function dataA = conservativeMapping(obj, dataB, dimension)
+            % map the columns of dataB (dimension values per node of mesh B) to mesh A
+            dataA = EMPIRE_MapperLib('conservativeMapping', obj.handle, dimension, dataB, ...
+                dimension * obj.numNodesA);
+        end
+
+        function delete(obj)
+            EMPIRE_MapperLib('deleteMapper', obj.name);
+            EMPIRE_MapperLib('deleteMesh', [obj.name '_A']);
+            EMPIRE_MapperLib('deleteMesh', [obj.name '_B']);
+        end
+    end
+end
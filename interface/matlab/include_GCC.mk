@@ -16,6 +16,10 @@ INCLUDES += -I./GiDFileIO
 LIBS      = $(EMPIRE_API_LIBSO_ON_MACHINE)
 LIBS     += -Wl,-whole-archive GiDFileIO/GiDFileIO.a -Wl,-no-whole-archive
 
+# EMPIRE mapper library
+INCLUDES += -I$(EMPIRE_MAPPER_LIB_INC_ON_MACHINE)
+LIBS     += $(EMPIRE_MAPPER_LIBSO_ON_MACHINE)
+
 
 # LINK MATLIB INTERFACE LIBRARIES
 @echo "Set MATLIB_HOME in the include file to your MATLAB installation"
@@ -0,0 +1,185 @@
+#include "matrix.h"
+#include "mex.h"
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+#include "MapperLib.h"
+#include "HelperFunctions.h"
+
+/*
+ * One MEX function for all calls of the mapper library, the first argument is the command:
+ *   EMPIRE_MapperLib('initFEMesh', meshName, nodes, nodeIDs, numNodesPerElem, elems)
+ *   handle = EMPIRE_MapperLib('initMapper', type, mapperName, meshNameA, meshNameB)
+ *            type is 'nearestNeighbor', 'nearestElement', 'barycentricInterpolation' or 'mortar',
+ *            the mortar mapper takes oppositeSurfaceNormal, dual, enforceConsistency as further arguments
+ *   dataB = EMPIRE_MapperLib('consistentMapping', handle, dimension, dataA, sizeB)
+ *   dataA = EMPIRE_MapperLib('conservativeMapping', handle, dimension, dataB, sizeA)
+ *   EMPIRE_MapperLib('deleteMapper', mapperName)
+ *   EMPIRE_MapperLib('deleteMesh', meshName)
+ * Each column of dataA or dataB is one field, all columns are mapped in one call. The meshes and
+ * mappers stay in the mapper library between calls, the MEX file is locked as long as one exists.
+ * The handle class EMPIRE_Mapper wraps these calls.
+ */
+
+/// maximum length of the names and commands
+#define NAME_LENGTH 80
+
+/// number of meshes and mappers alive, the MEX file must not be cleared while there are any
+static int numObjects = 0;
+
+static void addObject() {
+    if (numObjects++ == 0)
+        mexLock();
+}
+
+static void removeObject() {
+    if (numObjects > 0 && --numObjects == 0)
+        mexUnlock();
+}
+
+static mxArray *handleToMxArray(mapper_handle *handle) {
+    mxArray *array = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+    *static_cast<uint64_t*>(mxGetData(array)) = (uint64_t) (uintptr_t) handle;
+    return array;
+}
+
+static mapper_handle *mxArrayToHandle(const mxArray *array) {
+    if (!mxIsUint64(array) || mxGetNumberOfElements(array) != 1)
+        mexErrMsgTxt("The mapper handle must be a uint64 scalar");
+    return (mapper_handle*) (uintptr_t) *static_cast<uint64_t*>(mxGetData(array));
+}
+
+static int mxArrayToInt(const mxArray *array) {
+    assert(mxIsDouble(array));
+    assert(mxGetNumberOfElements(array) == 1);
+    return (int) mxGetScalar(array);
+}
+
+static void initFEMesh(int nrhs, const mxArray *prhs[]) {
+    assert(nrhs == 6);
+    char meshName[NAME_LENGTH];
+    mxGetString(prhs[1], meshName, NAME_LENGTH);
+
+    int numNodes = mxGetNumberOfElements(prhs[3]);
+    int numElems = mxGetNumberOfElements(prhs[4]);
+    assert(mxIsDouble(prhs[2]) && mxGetNumberOfElements(prhs[2]) == 3 * numNodes);
+    assert(mxIsDouble(prhs[3]) && mxIsDouble(prhs[4]) && mxIsDouble(prhs[5]));
+
+    int *nodeIDs = doubleArrayToIntArray(mxGetPr(prhs[3]), numNodes);
+    int *numNodesPerElem = doubleArrayToIntArray(mxGetPr(prhs[4]), numElems);
+    int *elems = doubleArrayToIntArray(mxGetPr(prhs[5]), mxGetNumberOfElements(prhs[5]));
+
+    ::initFEMesh(meshName, numNodes, numElems, false);
+    setNodesToFEMesh(meshName, nodeIDs, mxGetPr(prhs[2]));
+    setElementsToFEMesh(meshName, numNodesPerElem, elems);
+    addObject();
+
+    delete[] nodeIDs;
+    delete[] numNodesPerElem;
+    delete[] elems;
+}
+
+static mxArray *initMapper(int nrhs, const mxArray *prhs[]) {
+    assert(nrhs >= 5);
+    char type[NAME_LENGTH];
+    char mapperName[NAME_LENGTH];
+    char meshNameA[NAME_LENGTH];
+    char meshNameB[NAME_LENGTH];
+    mxGetString(prhs[1], type, NAME_LENGTH);
+    mxGetString(prhs[2], mapperName, NAME_LENGTH);
+    mxGetString(prhs[3], meshNameA, NAME_LENGTH);
+    mxGetString(prhs[4], meshNameB, NAME_LENGTH);
+
+    if (strcmp(type, "nearestNeighbor") == 0) {
+        initFEMNearestNeighborMapper(mapperName, meshNameA, meshNameB);
+    } else if (strcmp(type, "nearestElement") == 0) {
+        initFEMNearestElementMapper(mapperName, meshNameA, meshNameB);
+    } else if (strcmp(type, "barycentricInterpolation") == 0) {
+        initFEMBarycentricInterpolationMapper(mapperName, meshNameA, meshNameB);
+    } else if (strcmp(type, "mortar") == 0) {
+        assert(nrhs == 8);
+        initFEMMortarMapper(mapperName, meshNameA, meshNameB, mxArrayToInt(prhs[5]),
+                mxArrayToInt(prhs[6]), mxArrayToInt(prhs[7]));
+    } else {
+        mexErrMsgTxt("Unknown mapper type");
+    }
+
+    mapper_handle *handle = getMapperHandle(mapperName);
+    if (handle == NULL)
+        mexErrMsgTxt("The mapper could not be generated");
+    buildCouplingMatrices(mapperName);
+    addObject();
+    return handleToMxArray(handle);
+}
+
+static mxArray *consistentMapping(int nrhs, const mxArray *prhs[]) {
+    assert(nrhs == 5);
+    mapper_handle *handle = mxArrayToHandle(prhs[1]);
+    int dimension = mxArrayToInt(prhs[2]);
+    const mxArray *dataA = prhs[3];
+    int sizeB = mxArrayToInt(prhs[4]);
+    assert(mxIsDouble(dataA));
+
+    // the columns are the fields, they lie one after the other in memory
+    int sizeA = mxGetM(dataA);
+    int numFields = mxGetN(dataA);
+    mxArray *dataB = mxCreateDoubleMatrix(sizeB, numFields, mxREAL);
+    if (numFields == 1)
+        doConsistentMappingByHandle(handle, dimension, sizeA, mxGetPr(dataA), sizeB, mxGetPr(dataB));
+    else if (numFields > 1)
+        doConsistentMappingBatch(handle, dimension, numFields, sizeA, mxGetPr(dataA), sizeB, mxGetPr(dataB));
+    return dataB;
+}
+
+static mxArray *conservativeMapping(int nrhs, const mxArray *prhs[]) {
+    assert(nrhs == 5);
+    mapper_handle *handle = mxArrayToHandle(prhs[1]);
+    int dimension = mxArrayToInt(prhs[2]);
+    const mxArray *dataB = prhs[3];
+    int sizeA = mxArrayToInt(prhs[4]);
+    assert(mxIsDouble(dataB));
+
+    int sizeB = mxGetM(dataB);
+    int numFields = mxGetN(dataB);
+    mxArray *dataA = mxCreateDoubleMatrix(sizeA, numFields, mxREAL);
+    for (int i = 0; i < numFields; i++)
+        doConservativeMappingByHandle(handle, dimension, sizeB, mxGetPr(dataB) + i * sizeB, sizeA,
+                mxGetPr(dataA) + i * sizeA);
+    return dataA;
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
+    assert(nrhs >= 2);
+    assert(mxIsChar(prhs[0]));
+
+#define COMMAND_IN prhs[0]
+#define RESULT_OUT plhs[0]
+
+    char command[NAME_LENGTH];
+    mxGetString(COMMAND_IN, command, NAME_LENGTH);
+
+    if (strcmp(command, "initFEMesh") == 0) {
+        initFEMesh(nrhs, prhs);
+    } else if (strcmp(command, "initMapper") == 0) {
+        RESULT_OUT = initMapper(nrhs, prhs);
+    } else if (strcmp(command, "consistentMapping") == 0) {
+        RESULT_OUT = consistentMapping(nrhs, prhs);
+    } else if (strcmp(command, "conservativeMapping") == 0) {
+        RESULT_OUT = conservativeMapping(nrhs, prhs);
+    } else if (strcmp(command, "deleteMapper") == 0) {
+        char mapperName[NAME_LENGTH];
+        mxGetString(prhs[1], mapperName, NAME_LENGTH);
+        deleteMapper(mapperName);
+        removeObject();
+    } else if (strcmp(command, "deleteMesh") == 0) {
+        char meshName[NAME_LENGTH];
+        mxGetString(prhs[1], meshName, NAME_LENGTH);
+        deleteMesh(meshName);
+        removeObject();
+    } else {
+        mexErrMsgTxt("Unknown command");
+    }
+
+#undef COMMAND_IN
+#undef RESULT_OUT
+}
@@ -1,8 +1,10 @@
 #include "mex.h"
 #include "matrix.h"
 #include <assert.h>
+#include <string.h>
 #include "EMPIRE_API.h"
 #include "GiDFileIO.h"
+#include "HelperFunctions.h"
 
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
     assert(nrhs==1);
@@ -36,23 +38,17 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
 
     // nodeCoors
     NODES_OUT = mxCreateDoubleMatrix(3, numNodes, mxREAL);
-    for (int i=0; i<numNodes * 3; i++) {
-        mxGetPr(NODES_OUT)[i] = nodeCoors[i];
-    }
+    memcpy(mxGetPr(NODES_OUT), nodeCoors, numNodes * 3 * sizeof(double));
     delete[] nodeCoors;
 
     // nodeIDs
     NODE_IDS_OUT = mxCreateDoubleMatrix(1, numNodes, mxREAL);
-    for (int i=0; i<numNodes; i++) {
-        mxGetPr(NODE_IDS_OUT)[i] = (double) nodeIDs[i];
-    }
+    intArrayToDoubleArray(nodeIDs, mxGetPr(NODE_IDS_OUT), numNodes);
     delete[] nodeIDs;
 
     // numNodesPerElem
     NUM_NODES_PER_ELEMENT_OUT = mxCreateDoubleMatrix(1, numElems, mxREAL);
-    for (int i=0; i<numElems; i++) {
-        mxGetPr(NUM_NODES_PER_ELEMENT_OUT)[i] = (double) numNodesPerElem[i];
-    }
+    intArrayToDoubleArray(numNodesPerElem, mxGetPr(NUM_NODES_PER_ELEMENT_OUT), numElems);
     int elemsArrayLength = 0;
     for (int i = 0; i < numElems; i++)
         elemsArrayLength += numNodesPerElem[i];
@@ -60,16 +56,12 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
 
     // elemTable
     ELEMENT_TABLE_OUT = mxCreateDoubleMatrix(1, elemsArrayLength, mxREAL);
-    for (int i=0; i<elemsArrayLength; i++) {
-        mxGetPr(ELEMENT_TABLE_OUT)[i] = (double) elemTable[i];
-    }
+    intArrayToDoubleArray(elemTable, mxGetPr(ELEMENT_TABLE_OUT), elemsArrayLength);
     delete[] elemTable;
 
     // elemIDs
     ELEMENT_IDS_OUT = mxCreateDoubleMatrix(1, numElems, mxREAL);
-    for (int i=0; i<numElems; i++) {
-        mxGetPr(ELEMENT_IDS_OUT)[i] = (double) elemIDs[i];
-    }
+    intArrayToDoubleArray(elemIDs, mxGetPr(ELEMENT_IDS_OUT), numElems);
     delete[] elemIDs;
 
 #undef FILE_NAME_IN
@@ -8,6 +8,11 @@ int *doubleArrayToIntArray(double *arrayDouble, int size) {
     return arrayInt;
 }
 
+void intArrayToDoubleArray(const int *arrayInt, double *arrayDouble, int size) {
+    for (int i=0; i<size; i++)
+        arrayDouble[i] = (double) arrayInt[i];
+}
+
 
 
 #endif /* HELPERFUNCTIONS_H_ */
@@ -0,0 +1,440 @@
+/*  Copyright &copy; 2013, TU Muenchen, Chair of Structural Analysis,
+ *  Stefan Sicklinger, Tianyang Wang, Andreas Apostolatos, Altug Emiroglu Munich
+ *
+ *  All rights reserved.
+ *
+ *  This file is part of EMPIRE.
+ *
+ *  EMPIRE is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  EMPIRE is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with EMPIRE.  If not, see http://www.gnu.org/licenses/.
+ */
+/***********************************************************************************************//**
+ * \file EMPIRE_MapperLib.cpp
+ * This file wraps the C API of the mapper library in a Python extension module. Arrays are passed
+ * through the buffer protocol, so NumPy arrays are read and written in place without copying. The
+ * fields to be written by a mapping are allocated by the caller, e.g. with numpy.empty.
+ * \date 10/15/2026
+ **************************************************************************************************/
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "MapperLib.h"
+
+/// name of the capsules holding a mapper_handle
+#define MAPPER_HANDLE_CAPSULE "EMPIRE_MapperLib.mapper_handle"
+
+/********//**
+ * \brief Class ArrayView holds a C contiguous buffer of a Python object (e.g. a NumPy array) of doubles
+ *        or 32 bit integers and releases it at its end
+ ***********/
+class ArrayView {
+public:
+    ArrayView() :
+            isValid(false) {
+    }
+    ~ArrayView() {
+        if (isValid)
+            PyBuffer_Release(&view);
+    }
+    /***********************************************************************************************
+     * \brief Get the buffer of an object, sets a Python exception on failure
+     * \param[in] object the Python object
+     * \param[in] format 'd' for double or 'i' for int
+     * \param[in] writable whether the buffer is written
+     * \param[in] name the name of the argument for the error message
+     * \return false if the object has no fitting buffer
+     ***********/
+    bool get(PyObject *object, char format, bool writable, const char *name) {
+        int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+        if (PyObject_GetBuffer(object, &view, flags) != 0)
+            return false;
+        isValid = true;
+        // the byte order prefixes of the native formats are skipped
+        const char *f = view.format;
+        while (*f == '@' || *f == '=' || *f == '<')
+            f++;
+        size_t itemSize = (format == 'd') ? sizeof(double) : sizeof(int);
+        if (f[0] != format || f[1] != '\0' || (size_t) view.itemsize != itemSize) {
+            PyErr_Format(PyExc_TypeError, "%s must be a contiguous array of %s", name,
+                    (format == 'd') ? "float64" : "int32");
+            return false;
+        }
+        return true;
+    }
+    /// the number of entries
+    int size() const {
+        return (int) (view.len / view.itemsize);
+    }
+    /// the number of rows of a two dimensional array, 1 otherwise
+    int numRows() const {
+        return (view.ndim == 2) ? (int) view.shape[0] : 1;
+    }
+    double *doubles() const {
+        return static_cast<double*>(view.buf);
+    }
+    int *ints() const {
+        return static_cast<int*>(view.buf);
+    }
+private:
+    Py_buffer view;
+    bool isValid;
+};
+
+/***********************************************************************************************
+ * \brief Get the handle of a mapper given as capsule or as name, sets a Python exception on failure
+ ***********/
+static mapper_handle *toMapperHandle(PyObject *mapper) {
+    if (PyCapsule_CheckExact(mapper))
+        return static_cast<mapper_handle*>(PyCapsule_GetPointer(mapper, MAPPER_HANDLE_CAPSULE));
+    const char *mapperName = PyUnicode_AsUTF8(mapper);
+    if (mapperName == NULL)
+        return NULL;
+    mapper_handle *handle = getMapperHandle(const_cast<char*>(mapperName));
+    if (handle == NULL)
+        PyErr_Format(PyExc_KeyError, "mapper \"%s\" does not exist", mapperName);
+    return handle;
+}
+
+static PyObject *py_initFEMesh(PyObject *self, PyObject *args) {
+    const char *meshName;
+    int numNodes, numElems, triangulateAll = 0;
+    if (!PyArg_ParseTuple(args, "sii|p", &meshName, &numNodes, &numElems, &triangulateAll))
+        return NULL;
+    initFEMesh(const_cast<char*>(meshName), numNodes, numElems, triangulateAll != 0);
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_setNodesToFEMesh(PyObject *self, PyObject *args) {
+    const char *meshName;
+    PyObject *nodeIDsObject, *nodesObject;
+    if (!PyArg_ParseTuple(args, "sOO", &meshName, &nodeIDsObject, &nodesObject))
+        return NULL;
+    ArrayView nodeIDs, nodes;
+    if (!nodeIDs.get(nodeIDsObject, 'i', false, "nodeIDs") || !nodes.get(nodesObject, 'd', false, "nodes"))
+        return NULL;
+    if (nodes.size() != 3 * nodeIDs.size()) {
+        PyErr_SetString(PyExc_ValueError, "nodes must hold three coordinates per node ID");
+        return NULL;
+    }
+    setNodesToFEMesh(const_cast<char*>(meshName), nodeIDs.ints(), nodes.doubles());
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_setElementsToFEMesh(PyObject *self, PyObject *args) {
+    const char *meshName;
+    PyObject *numNodesPerElemObject, *elemsObject;
+    if (!PyArg_ParseTuple(args, "sOO", &meshName, &numNodesPerElemObject, &elemsObject))
+        return NULL;
+    ArrayView numNodesPerElem, elems;
+    if (!numNodesPerElem.get(numNodesPerElemObject, 'i', false, "numNodesPerElem")
+            || !elems.get(elemsObject, 'i', false, "elems"))
+        return NULL;
+    setElementsToFEMesh(const_cast<char*>(meshName), numNodesPerElem.ints(), elems.ints());
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_initIGAMesh(PyObject *self, PyObject *args) {
+    const char *meshName;
+    if (!PyArg_ParseTuple(args, "s", &meshName))
+        return NULL;
+    initIGAMesh(const_cast<char*>(meshName));
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_addPatchToIGAMesh(PyObject *self, PyObject *args) {
+    const char *meshName;
+    int pDegree, qDegree, uNoControlPoints, vNoControlPoints;
+    PyObject *uKnotVectorObject, *vKnotVectorObject, *controlPointNetObject, *dofIndexNetObject;
+    if (!PyArg_ParseTuple(args, "siOiOiiOO", &meshName, &pDegree, &uKnotVectorObject, &qDegree,
+            &vKnotVectorObject, &uNoControlPoints, &vNoControlPoints, &controlPointNetObject,
+            &dofIndexNetObject))
+        return NULL;
+    ArrayView uKnotVector, vKnotVector, controlPointNet, dofIndexNet;
+    if (!uKnotVector.get(uKnotVectorObject, 'd', false, "uKnotVector")
+            || !vKnotVector.get(vKnotVectorObject, 'd', false, "vKnotVector")
+            || !controlPointNet.get(controlPointNetObject, 'd', false, "controlPointNet")
+            || !dofIndexNet.get(dofIndexNetObject, 'i', false, "dofIndexNet"))
+        return NULL;
+    if (controlPointNet.size() != 4 * uNoControlPoints * vNoControlPoints
+            || dofIndexNet.size() != uNoControlPoints * vNoControlPoints) {
+        PyErr_SetString(PyExc_ValueError,
+                "controlPointNet must hold (x,y,z,w) and dofIndexNet one index per control point");
+        return NULL;
+    }
+    addPatchToIGAMesh(const_cast<char*>(meshName), pDegree, uKnotVector.size(), uKnotVector.doubles(),
+            qDegree, vKnotVector.size(), vKnotVector.doubles(), uNoControlPoints, vNoControlPoints,
+            controlPointNet.doubles(), dofIndexNet.ints());
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_addTrimmingLoopToPatch(PyObject *self, PyObject *args) {
+    const char *meshName;
+    int patchIndex, inner, numCurves;
+    if (!PyArg_ParseTuple(args, "siii", &meshName, &patchIndex, &inner, &numCurves))
+        return NULL;
+    addTrimmingLoopToPatch(const_cast<char*>(meshName), patchIndex, inner, numCurves);
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_addTrimmingCurveToTrimmingLoop(PyObject *self, PyObject *args) {
+    const char *meshName;
+    int patchIndex, direction, pDegree, uNoControlPoints;
+    PyObject *uKnotVectorObject, *controlPointsObject;
+    if (!PyArg_ParseTuple(args, "siiiOiO", &meshName, &patchIndex, &direction, &pDegree,
+            &uKnotVectorObject, &uNoControlPoints, &controlPointsObject))
+        return NULL;
+    ArrayView uKnotVector, controlPoints;
+    if (!uKnotVector.get(uKnotVectorObject, 'd', false, "uKnotVector")
+            || !controlPoints.get(controlPointsObject, 'd', false, "controlPoints"))
+        return NULL;
+    addTrimmingCurveToTrimmingLoop(const_cast<char*>(meshName), patchIndex, direction, pDegree,
+            uKnotVector.size(), uKnotVector.doubles(), uNoControlPoints, controlPoints.doubles());
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_linearizeTrimmingLoops(PyObject *self, PyObject *args) {
+    const char *meshName;
+    int patchIndex;
+    if (!PyArg_ParseTuple(args, "si", &meshName, &patchIndex))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS
+    linearizeTrimmingLoops(const_cast<char*>(meshName), patchIndex);
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+/***********************************************************************************************
+ * \brief Shared wrapper of the init functions of the mappers taking the names of mapper and meshes
+ ***********/
+static PyObject *initMapper(PyObject *args, void (*init)(char*, char*, char*)) {
+    const char *mapperName, *meshNameA, *meshNameB;
+    if (!PyArg_ParseTuple(args, "sss", &mapperName, &meshNameA, &meshNameB))
+        return NULL;
+    init(const_cast<char*>(mapperName), const_cast<char*>(meshNameA), const_cast<char*>(meshNameB));
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_initFEMNearestNeighborMapper(PyObject *self, PyObject *args) {
+    return initMapper(args, initFEMNearestNeighborMapper);
+}
+
+static PyObject *py_initFEMNearestElementMapper(PyObject *self, PyObject *args) {
+    return initMapper(args, initFEMNearestElementMapper);
+}
+
+static PyObject *py_initFEMBarycentricInterpolationMapper(PyObject *self, PyObject *args) {
+    return initMapper(args, initFEMBarycentricInterpolationMapper);
+}
+
+static PyObject *py_initIGAMortarMapper(PyObject *self, PyObject *args) {
+    return initMapper(args, initIGAMortarMapper);
+}
+
+static PyObject *py_initFEMMortarMapper(PyObject *self, PyObject *args) {
+    const char *mapperName, *meshNameA, *meshNameB;
+    int oppositeSurfaceNormal, dual, enforceConsistency;
+    if (!PyArg_ParseTuple(args, "sssppp", &mapperName, &meshNameA, &meshNameB, &oppositeSurfaceNormal,
+            &dual, &enforceConsistency))
+        return NULL;
+    initFEMMortarMapper(const_cast<char*>(mapperName), const_cast<char*>(meshNameA),
+            const_cast<char*>(meshNameB), oppositeSurfaceNormal, dual, enforceConsistency);
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_setParametersIntegration(PyObject *self, PyObject *args) {
+    const char *mapperName;
+    int numGPTriangle = 16, numGPQuad = 25;
+    if (!PyArg_ParseTuple(args, "s|ii", &mapperName, &numGPTriangle, &numGPQuad))
+        return NULL;
+    setParametersIntegration(const_cast<char*>(mapperName), numGPTriangle, numGPQuad);
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_initialize(PyObject *self, PyObject *args) {
+    const char *mapperName;
+    if (!PyArg_ParseTuple(args, "s", &mapperName))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS
+    initialize(const_cast<char*>(mapperName));
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_buildCouplingMatrices(PyObject *self, PyObject *args) {
+    const char *mapperName;
+    if (!PyArg_ParseTuple(args, "s", &mapperName))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS
+    buildCouplingMatrices(const_cast<char*>(mapperName));
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_getMapperHandle(PyObject *self, PyObject *args) {
+    const char *mapperName;
+    if (!PyArg_ParseTuple(args, "s", &mapperName))
+        return NULL;
+    mapper_handle *handle = getMapperHandle(const_cast<char*>(mapperName));
+    if (handle == NULL) {
+        PyErr_Format(PyExc_KeyError, "mapper \"%s\" does not exist", mapperName);
+        return NULL;
+    }
+    return PyCapsule_New(handle, MAPPER_HANDLE_CAPSULE, NULL);
+}
+
+static PyObject *py_doConsistentMapping(PyObject *self, PyObject *args) {
+    PyObject *mapper, *dataAObject, *dataBObject;
+    int dimension;
+    if (!PyArg_ParseTuple(args, "OiOO", &mapper, &dimension, &dataAObject, &dataBObject))
+        return NULL;
+    mapper_handle *handle = toMapperHandle(mapper);
+    ArrayView dataA, dataB;
+    if (handle == NULL || !dataA.get(dataAObject, 'd', false, "dataA")
+            || !dataB.get(dataBObject, 'd', true, "dataB"))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS
+    doConsistentMappingByHandle(handle, dimension, dataA.size(), dataA.doubles(), dataB.size(),
+            dataB.doubles());
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_doConservativeMapping(PyObject *self, PyObject *args) {
+    PyObject *mapper, *dataBObject, *dataAObject;
+    int dimension;
+    if (!PyArg_ParseTuple(args, "OiOO", &mapper, &dimension, &dataBObject, &dataAObject))
+        return NULL;
+    mapper_handle *handle = toMapperHandle(mapper);
+    ArrayView dataB, dataA;
+    if (handle == NULL || !dataB.get(dataBObject, 'd', false, "dataB")
+            || !dataA.get(dataAObject, 'd', true, "dataA"))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS
+    doConservativeMappingByHandle(handle, dimension, dataB.size(), dataB.doubles(), dataA.size(),
+            dataA.doubles());
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_doConsistentMappingBatch(PyObject *self, PyObject *args) {
+    PyObject *mapper, *dataAObject, *dataBObject;
+    int dimension;
+    if (!PyArg_ParseTuple(args, "OiOO", &mapper, &dimension, &dataAObject, &dataBObject))
+        return NULL;
+    mapper_handle *handle = toMapperHandle(mapper);
+    ArrayView dataA, dataB;
+    if (handle == NULL || !dataA.get(dataAObject, 'd', false, "dataA")
+            || !dataB.get(dataBObject, 'd', true, "dataB"))
+        return NULL;
+    // one field per row
+    int numFields = dataA.numRows();
+    if (dataB.numRows() != numFields) {
+        PyErr_SetString(PyExc_ValueError, "dataA and dataB must have the same number of rows");
+        return NULL;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    doConsistentMappingBatch(handle, dimension, numFields, dataA.size() / numFields, dataA.doubles(),
+            dataB.size() / numFields, dataB.doubles());
+    Py_END_ALLOW_THREADS
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_printMesh(PyObject *self, PyObject *args) {
+    const char *meshName;
+    if (!PyArg_ParseTuple(args, "s", &meshName))
+        return NULL;
+    printMesh(const_cast<char*>(meshName));
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_deleteMesh(PyObject *self, PyObject *args) {
+    const char *meshName;
+    if (!PyArg_ParseTuple(args, "s", &meshName))
+        return NULL;
+    deleteMesh(const_cast<char*>(meshName));
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_deleteMapper(PyObject *self, PyObject *args) {
+    const char *mapperName;
+    if (!PyArg_ParseTuple(args, "s", &mapperName))
+        return NULL;
+    deleteMapper(const_cast<char*>(mapperName));
+    Py_RETURN_NONE;
+}
+
+static PyObject *py_deleteAllMappers(PyObject *self, PyObject *args) {
+    deleteAllMappers();
+    Py_RETURN_NONE;
+}
+
+/// the functions of the module, named as in MapperLib.h
+static PyMethodDef methods[] = {
+    {"initFEMesh", py_initFEMesh, METH_VARARGS,
+     "initFEMesh(meshName, numNodes, numElems, triangulateAll=False)"},
+    {"setNodesToFEMesh", py_setNodesToFEMesh, METH_VARARGS,
+     "setNodesToFEMesh(meshName, nodeIDs[int32], nodes[float64, 3 per node])"},
+    {"setElementsToFEMesh", py_setElementsToFEMesh, METH_VARARGS,
+     "setElementsToFEMesh(meshName, numNodesPerElem[int32], elems[int32])"},
+    {"initIGAMesh", py_initIGAMesh, METH_VARARGS, "initIGAMesh(meshName)"},
+    {"addPatchToIGAMesh", py_addPatchToIGAMesh, METH_VARARGS,
+     "addPatchToIGAMesh(meshName, pDegree, uKnotVector, qDegree, vKnotVector, uNoControlPoints, "
+     "vNoControlPoints, controlPointNet, dofIndexNet[int32])"},
+    {"addTrimmingLoopToPatch", py_addTrimmingLoopToPatch, METH_VARARGS,
+     "addTrimmingLoopToPatch(meshName, patchIndex, inner, numCurves)"},
+    {"addTrimmingCurveToTrimmingLoop", py_addTrimmingCurveToTrimmingLoop, METH_VARARGS,
+     "addTrimmingCurveToTrimmingLoop(meshName, patchIndex, direction, pDegree, uKnotVector, "
+     "uNoControlPoints, controlPoints)"},
+    {"linearizeTrimmingLoops", py_linearizeTrimmingLoops, METH_VARARGS,
+     "linearizeTrimmingLoops(meshName, patchIndex)"},
+    {"initFEMNearestNeighborMapper", py_initFEMNearestNeighborMapper, METH_VARARGS,
+     "initFEMNearestNeighborMapper(mapperName, meshNameA, meshNameB)"},
+    {"initFEMNearestElementMapper", py_initFEMNearestElementMapper, METH_VARARGS,
+     "initFEMNearestElementMapper(mapperName, meshNameA, meshNameB)"},
+    {"initFEMBarycentricInterpolationMapper", py_initFEMBarycentricInterpolationMapper, METH_VARARGS,
+     "initFEMBarycentricInterpolationMapper(mapperName, meshNameA, meshNameB)"},
+    {"initFEMMortarMapper", py_initFEMMortarMapper, METH_VARARGS,
+     "initFEMMortarMapper(mapperName, meshNameA, meshNameB, oppositeSurfaceNormal, dual, "
+     "enforceConsistency)"},
+    {"initIGAMortarMapper", py_initIGAMortarMapper, METH_VARARGS,
+     "initIGAMortarMapper(mapperName, meshNameA, meshNameB)"},
+    {"setParametersIntegration", py_setParametersIntegration, METH_VARARGS,
+     "setParametersIntegration(mapperName, numGPTriangle=16, numGPQuad=25)"},
+    {"initialize", py_initialize, METH_VARARGS, "initialize(mapperName), releases the GIL"},
+    {"buildCouplingMatrices", py_buildCouplingMatrices, METH_VARARGS,
+     "buildCouplingMatrices(mapperName), releases the GIL"},
+    {"getMapperHandle", py_getMapperHandle, METH_VARARGS,
+     "getMapperHandle(mapperName) -> handle, invalid once the mapper is deleted"},
+    {"doConsistentMapping", py_doConsistentMapping, METH_VARARGS,
+     "doConsistentMapping(handle or mapperName, dimension, dataA, dataB), writes dataB in place "
+     "and releases the GIL"},
+    {"doConservativeMapping", py_doConservativeMapping, METH_VARARGS,
+     "doConservativeMapping(handle or mapperName, dimension, dataB, dataA), writes dataA in place "
+     "and releases the GIL"},
+    {"doConsistentMappingBatch", py_doConsistentMappingBatch, METH_VARARGS,
+     "doConsistentMappingBatch(handle or mapperName, dimension, dataA, dataB), maps each row of the "
+     "two dimensional array dataA to the same row of dataB and releases the GIL"},
+    {"printMesh", py_printMesh, METH_VARARGS, "printMesh(meshName)"},
+    {"deleteMesh", py_deleteMesh, METH_VARARGS, "deleteMesh(meshName)"},
+    {"deleteMapper", py_deleteMapper, METH_VARARGS, "deleteMapper(mapperName)"},
+    {"deleteAllMappers", py_deleteAllMappers, METH_NOARGS, "deleteAllMappers()"},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef module = {
+    PyModuleDef_HEAD_INIT, "EMPIRE_MapperLib", "Python interface of the EMPIRE mapper library", -1, methods
+};
+
+PyMODINIT_FUNC PyInit_EMPIRE_MapperLib(void) {
+    return PyModule_Create(&module);
+}